@@ -0,0 +1,254 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__ALLOCATOR__HUGE_PAGE_ALLOCATOR_HPP_
+#define RCLCPP__ALLOCATOR__HUGE_PAGE_ALLOCATOR_HPP_
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace allocator
+{
+
+/// Kind of huge pages backing the large allocations of a HugePageAllocator.
+enum class HugePagePolicy
+{
+  /// Transparent huge pages, requested for the mapping, which the kernel may not grant.
+  Transparent,
+  /// Huge pages reserved by the system, or transparent ones if none is available.
+  Explicit,
+};
+
+/// Options of a HugePageAllocator.
+struct HugePageOptions
+{
+  /// Minimum number of bytes of the allocations backed by huge pages.
+  /**
+   * The smaller ones are allocated with the base allocator.
+   */
+  size_t threshold = 1024u * 1024u;
+
+  /// Kind of huge pages.
+  HugePagePolicy policy = HugePagePolicy::Transparent;
+
+  /// Whether the memory is preferably allocated on the NUMA node of the allocating thread.
+  /**
+   * Otherwise, the pages are allocated on the node of the thread first writing to them,
+   * which may be the one of a subscription taking an intra-process message.
+   */
+  bool numa_local = true;
+};
+
+/// Map memory backed by huge pages, for the large allocations of a HugePageAllocator.
+/**
+ * The mapping is aligned on a huge page, and on Linux only.
+ *
+ * \param[in] size number of bytes to map.
+ * \param[in] options options of the mapping.
+ * \param[out] mapped_size number of bytes mapped, to unmap the memory.
+ * \return the address of the mapping, or nullptr if it failed or isn't supported.
+ */
+RCLCPP_PUBLIC
+void *
+map_huge_pages(size_t size, const HugePageOptions & options, size_t & mapped_size) noexcept;
+
+/// Unmap memory mapped by map_huge_pages().
+RCLCPP_PUBLIC
+void
+unmap_huge_pages(void * address, size_t mapped_size) noexcept;
+
+/// Allocator backing the large allocations, like the ones of big messages, with huge pages.
+/**
+ * Messages of several megabytes, such as images or point clouds with fixed size arrays,
+ * cause many TLB misses when backed by regular pages, and traffic between the sockets
+ * when they are allocated on another NUMA node than the one of the publishing thread.
+ * The allocations of at least HugePageOptions::threshold bytes are therefore mapped with
+ * huge pages, preferably on the NUMA node of the allocating thread, and the other ones
+ * are made with the base allocator, as when huge pages can't be mapped.
+ *
+ * It is used like the other allocators of publishers and subscriptions, for example:
+ *
+ * ```cpp
+ * using Allocator = rclcpp::allocator::HugePageAllocator<void>;
+ * rclcpp::PublisherOptionsWithAllocator<Allocator> options;
+ * rclcpp::allocator::HugePageOptions huge_page_options;
+ * huge_page_options.policy = rclcpp::allocator::HugePagePolicy::Explicit;
+ * options.allocator = std::make_shared<Allocator>(huge_page_options);
+ * auto publisher = node->create_publisher<MessageT>("topic", 10, options);
+ * ```
+ *
+ * Each block is prefixed with its size, so that it is deallocated correctly when the size
+ * given to deallocate() is wrong, as with the rcl allocators made from it.
+ *
+ * \tparam T type of the allocated objects.
+ * \tparam BaseAllocatorT allocator which the small allocations are made with.
+ */
+template<typename T, typename BaseAllocatorT = std::allocator<T>>
+class HugePageAllocator
+{
+  using BaseAllocatorTraits = std::allocator_traits<BaseAllocatorT>;
+  using Block = std::max_align_t;
+  using BlockAllocator = typename BaseAllocatorTraits::template rebind_alloc<Block>;
+  using BlockAllocatorTraits = std::allocator_traits<BlockAllocator>;
+
+  template<typename U, typename BaseAllocatorU>
+  friend class HugePageAllocator;
+
+  // Stored in the first block of each allocation
+  struct Header
+  {
+    size_t bytes;
+    // 0 if allocated with the base allocator
+    size_t mapped_size;
+  };
+  static_assert(sizeof(Header) <= sizeof(Block), "the header must fit in a block");
+
+public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  template<typename U>
+  struct rebind
+  {
+    using other =
+      HugePageAllocator<U, typename BaseAllocatorTraits::template rebind_alloc<U>>;
+  };
+
+  /// Constructor.
+  /**
+   * \param[in] options options of the allocations backed by huge pages.
+   * \param[in] base_allocator allocator which the small allocations are made with.
+   */
+  explicit HugePageAllocator(
+    const HugePageOptions & options = HugePageOptions(),
+    const BaseAllocatorT & base_allocator = BaseAllocatorT())
+  : options_(options), base_allocator_(base_allocator)
+  {
+  }
+
+  template<typename U, typename BaseAllocatorU>
+  HugePageAllocator(const HugePageAllocator<U, BaseAllocatorU> & other) noexcept  // NOLINT
+  : options_(other.options_), base_allocator_(other.base_allocator_)
+  {
+  }
+
+  T *
+  allocate(size_t size)
+  {
+    static_assert(
+      alignof(T) <= alignof(Block), "huge page allocators don't support over-aligned types");
+    if (size > (std::numeric_limits<size_t>::max() - sizeof(Block)) / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+    const size_t bytes = size * sizeof(T);
+    Block * block = nullptr;
+    size_t mapped_size = 0;
+    if (bytes >= options_.threshold) {
+      block = static_cast<Block *>(map_huge_pages(sizeof(Block) + bytes, options_, mapped_size));
+    }
+    if (!block) {
+      BlockAllocator block_allocator(base_allocator_);
+      block = BlockAllocatorTraits::allocate(block_allocator, get_number_of_blocks(bytes));
+      mapped_size = 0;
+    }
+    new (block) Header{bytes, mapped_size};
+    return reinterpret_cast<T *>(block + 1);
+  }
+
+  void
+  deallocate(T * pointer, size_t size) noexcept
+  {
+    (void)size;
+    if (!pointer) {
+      return;
+    }
+    Block * block = reinterpret_cast<Block *>(pointer) - 1;
+    const Header header = *reinterpret_cast<Header *>(block);
+    if (header.mapped_size != 0) {
+      unmap_huge_pages(block, header.mapped_size);
+      return;
+    }
+    BlockAllocator block_allocator(base_allocator_);
+    BlockAllocatorTraits::deallocate(block_allocator, block, get_number_of_blocks(header.bytes));
+  }
+
+  /// Return true if memory allocated by a huge page allocator was mapped with huge pages.
+  /**
+   * With transparent huge pages, the kernel may still back the mapping with regular pages.
+   */
+  static bool
+  is_mapped(const T * pointer) noexcept
+  {
+    if (!pointer) {
+      return false;
+    }
+    const Block * block = reinterpret_cast<const Block *>(pointer) - 1;
+    return reinterpret_cast<const Header *>(block)->mapped_size != 0;
+  }
+
+  /// Return the options of the allocations backed by huge pages.
+  const HugePageOptions &
+  get_options() const noexcept
+  {
+    return options_;
+  }
+
+  /// Return the allocator which the small allocations are made with.
+  const BaseAllocatorT &
+  get_base_allocator() const noexcept
+  {
+    return base_allocator_;
+  }
+
+  /// Huge page allocators are equal if their base allocators are, whatever their options.
+  template<typename U, typename BaseAllocatorU>
+  bool
+  operator==(const HugePageAllocator<U, BaseAllocatorU> & other) const noexcept
+  {
+    return BlockAllocator(base_allocator_) == BlockAllocator(other.base_allocator_);
+  }
+
+  template<typename U, typename BaseAllocatorU>
+  bool
+  operator!=(const HugePageAllocator<U, BaseAllocatorU> & other) const noexcept
+  {
+    return !(*this == other);
+  }
+
+private:
+  static size_t
+  get_number_of_blocks(size_t bytes) noexcept
+  {
+    // One more block for the header
+    return 1u + (bytes + sizeof(Block) - 1u) / sizeof(Block);
+  }
+
+  HugePageOptions options_;
+  BaseAllocatorT base_allocator_;
+};
+
+}  // namespace allocator
+}  // namespace rclcpp
+
+#endif  // RCLCPP__ALLOCATOR__HUGE_PAGE_ALLOCATOR_HPP_
@@ -0,0 +1,268 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__ALLOCATOR__MEMORY_POOL_HPP_
+#define RCLCPP__ALLOCATOR__MEMORY_POOL_HPP_
+
+#include <cstddef>
+#include <memory_resource>  // NOLINT
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#include "rclcpp/macros.hpp"
+
+namespace rclcpp
+{
+namespace allocator
+{
+
+/// Thread-safe memory resource allocating fixed-size blocks from preallocated memory.
+/**
+ * The blocks are sorted into size classes, each a power of two from the alignment of
+ * std::max_align_t up to the maximum block size, and each class is filled with the given
+ * number of blocks when the pool is constructed.
+ * An allocation then takes the first free block of the smallest class it fits in, and a
+ * deallocation gives it back, in constant time and without calling the upstream resource,
+ * so that entities using the pool don't allocate once it's sized for their steady state.
+ *
+ * When a class has no free block, the pool either allocates as many blocks again from its
+ * upstream resource, or throws std::bad_alloc if its growth is disabled.
+ * The allocations bigger than the maximum block size, or more aligned than std::max_align_t,
+ * are always forwarded to the upstream resource.
+ *
+ * Each class has its own lock, so that threads allocating different sizes don't contend.
+ * The memory of the pool is only given back to the upstream resource when it's destroyed,
+ * which the memory allocated from it mustn't outlive.
+ */
+class MemoryPool : public std::pmr::memory_resource
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(MemoryPool)
+
+  /// Constructor.
+  /**
+   * \param[in] max_block_size size of the biggest blocks, rounded up to a power of two.
+   * \param[in] blocks_per_size_class number of blocks of each size class, preallocated
+   *   and then allocated at once when a class runs out of free blocks.
+   * \param[in] allow_growth whether more blocks are allocated when a class has none free;
+   *   otherwise std::bad_alloc is thrown.
+   * \param[in] upstream resource which the memory of the pool is allocated from.
+   * \throws std::invalid_argument if max_block_size or blocks_per_size_class is 0, or
+   *   upstream is nullptr.
+   */
+  explicit MemoryPool(
+    size_t max_block_size = 4096u,
+    size_t blocks_per_size_class = 64u,
+    bool allow_growth = true,
+    std::pmr::memory_resource * upstream = std::pmr::new_delete_resource())
+  : blocks_per_size_class_(blocks_per_size_class), allow_growth_(allow_growth),
+    upstream_(upstream)
+  {
+    if (max_block_size == 0u) {
+      throw std::invalid_argument("the maximum block size of a memory pool can't be 0");
+    }
+    if (blocks_per_size_class == 0u) {
+      throw std::invalid_argument("the size classes of a memory pool can't be empty");
+    }
+    if (!upstream) {
+      throw std::invalid_argument("the upstream resource of a memory pool can't be null");
+    }
+    size_t block_size = min_block_size;
+    while (block_size < max_block_size) {
+      block_size *= 2u;
+    }
+    max_block_size_ = block_size;
+    size_classes_ = std::vector<SizeClass>(get_size_class_index(max_block_size_) + 1u);
+    try {
+      for (size_t index = 0; index < size_classes_.size(); ++index) {
+        add_blocks(size_classes_[index], min_block_size << index);
+      }
+    } catch (...) {
+      release();
+      throw;
+    }
+  }
+
+  ~MemoryPool() override
+  {
+    release();
+  }
+
+  /// Return the size of the biggest blocks of the pool.
+  size_t
+  get_max_block_size() const noexcept
+  {
+    return max_block_size_;
+  }
+
+  /// Return the number of free blocks of the size class which an allocation would use.
+  /**
+   * \param[in] bytes size of the allocation.
+   * \return the number of free blocks, or 0 if the allocation is bigger than the blocks.
+   */
+  size_t
+  get_number_of_free_blocks(size_t bytes) const
+  {
+    if (bytes > max_block_size_) {
+      return 0u;
+    }
+    const SizeClass & size_class = size_classes_[get_size_class_index(bytes)];
+    std::lock_guard<std::mutex> lock(size_class.mutex);
+    return size_class.number_of_free_blocks;
+  }
+
+  /// Return the number of times memory was allocated from the upstream resource.
+  /**
+   * It includes the blocks preallocated by the constructor, so that it only changes when
+   * the pool grows or forwards an allocation.
+   */
+  size_t
+  get_number_of_upstream_allocations() const
+  {
+    std::lock_guard<std::mutex> lock(chunks_mutex_);
+    return number_of_upstream_allocations_;
+  }
+
+protected:
+  void *
+  do_allocate(size_t bytes, size_t alignment) override
+  {
+    if (bytes > max_block_size_ || alignment > alignof(std::max_align_t)) {
+      void * pointer = upstream_->allocate(bytes, alignment);
+      std::lock_guard<std::mutex> lock(chunks_mutex_);
+      ++number_of_upstream_allocations_;
+      return pointer;
+    }
+    const size_t index = get_size_class_index(bytes);
+    SizeClass & size_class = size_classes_[index];
+    std::lock_guard<std::mutex> lock(size_class.mutex);
+    if (!size_class.free_blocks) {
+      if (!allow_growth_) {
+        throw std::bad_alloc();
+      }
+      add_blocks(size_class, min_block_size << index);
+    }
+    FreeBlock * block = size_class.free_blocks;
+    size_class.free_blocks = block->next;
+    --size_class.number_of_free_blocks;
+    return block;
+  }
+
+  void
+  do_deallocate(void * pointer, size_t bytes, size_t alignment) override
+  {
+    if (bytes > max_block_size_ || alignment > alignof(std::max_align_t)) {
+      upstream_->deallocate(pointer, bytes, alignment);
+      return;
+    }
+    SizeClass & size_class = size_classes_[get_size_class_index(bytes)];
+    std::lock_guard<std::mutex> lock(size_class.mutex);
+    size_class.free_blocks = new (pointer) FreeBlock{size_class.free_blocks};
+    ++size_class.number_of_free_blocks;
+  }
+
+  bool
+  do_is_equal(const std::pmr::memory_resource & other) const noexcept override
+  {
+    return this == &other;
+  }
+
+private:
+  RCLCPP_DISABLE_COPY(MemoryPool)
+
+  static constexpr size_t min_block_size = alignof(std::max_align_t);
+
+  struct FreeBlock
+  {
+    FreeBlock * next;
+  };
+
+  struct SizeClass
+  {
+    mutable std::mutex mutex;
+    FreeBlock * free_blocks = nullptr;
+    size_t number_of_free_blocks = 0;
+  };
+
+  struct Chunk
+  {
+    void * pointer;
+    size_t bytes;
+  };
+
+  static size_t
+  get_size_class_index(size_t bytes) noexcept
+  {
+    size_t index = 0;
+    for (size_t block_size = min_block_size; block_size < bytes; block_size *= 2u) {
+      ++index;
+    }
+    return index;
+  }
+
+  // Called with the lock of the size class held, or by the constructor
+  void
+  add_blocks(SizeClass & size_class, size_t block_size)
+  {
+    if (blocks_per_size_class_ > static_cast<size_t>(-1) / block_size) {
+      throw std::bad_alloc();
+    }
+    const size_t bytes = blocks_per_size_class_ * block_size;
+    auto data = static_cast<unsigned char *>(
+      upstream_->allocate(bytes, alignof(std::max_align_t)));
+    {
+      std::lock_guard<std::mutex> lock(chunks_mutex_);
+      try {
+        chunks_.push_back({data, bytes});
+      } catch (...) {
+        upstream_->deallocate(data, bytes, alignof(std::max_align_t));
+        throw;
+      }
+      ++number_of_upstream_allocations_;
+    }
+    for (size_t i = blocks_per_size_class_; i > 0u; --i) {
+      size_class.free_blocks = new (data + (i - 1u) * block_size) FreeBlock{
+        size_class.free_blocks};
+    }
+    size_class.number_of_free_blocks += blocks_per_size_class_;
+  }
+
+  void
+  release() noexcept
+  {
+    for (const Chunk & chunk : chunks_) {
+      upstream_->deallocate(chunk.pointer, chunk.bytes, alignof(std::max_align_t));
+    }
+    chunks_.clear();
+  }
+
+  size_t max_block_size_ = 0;
+  const size_t blocks_per_size_class_;
+  const bool allow_growth_;
+  std::pmr::memory_resource * const upstream_;
+
+  std::vector<SizeClass> size_classes_;
+
+  mutable std::mutex chunks_mutex_;
+  std::vector<Chunk> chunks_;
+  size_t number_of_upstream_allocations_ = 0;
+};
+
+}  // namespace allocator
+}  // namespace rclcpp
+
+#endif  // RCLCPP__ALLOCATOR__MEMORY_POOL_HPP_
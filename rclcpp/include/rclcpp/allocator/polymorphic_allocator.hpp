@@ -0,0 +1,182 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__ALLOCATOR__POLYMORPHIC_ALLOCATOR_HPP_
+#define RCLCPP__ALLOCATOR__POLYMORPHIC_ALLOCATOR_HPP_
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <memory_resource>  // NOLINT
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace rclcpp
+{
+namespace allocator
+{
+
+/// Allocator allocating its memory from a std::pmr::memory_resource.
+/**
+ * Unlike std::pmr::polymorphic_allocator, it can be used for void, as the allocators of
+ * the publishers, subscriptions and memory strategies are, and it keeps the resource alive
+ * when the resource is given as a shared pointer, so that the memory allocated by an entity
+ * remains valid as long as the entity.
+ * Its copies and rebound copies allocate from the same resource, for example:
+ *
+ * ```cpp
+ * auto pool = std::make_shared<rclcpp::allocator::MemoryPool>();
+ * using Allocator = rclcpp::allocator::PolymorphicAllocator<void>;
+ * auto allocator = std::make_shared<Allocator>(pool);
+ *
+ * rclcpp::PublisherOptionsWithAllocator<Allocator> publisher_options;
+ * publisher_options.allocator = allocator;
+ * auto publisher = node->create_publisher<MessageT>("topic", 10, publisher_options);
+ *
+ * rclcpp::SubscriptionOptionsWithAllocator<Allocator> subscription_options;
+ * subscription_options.allocator = allocator;
+ * auto msg_mem_strat = std::make_shared<
+ *   rclcpp::message_memory_strategy::MessageMemoryStrategy<MessageT, Allocator>>(allocator);
+ * auto subscription = node->create_subscription<MessageT>(
+ *   "topic", 10, callback, subscription_options, msg_mem_strat);
+ *
+ * rclcpp::ExecutorOptions executor_options;
+ * executor_options.memory_strategy =
+ *   std::make_shared<rclcpp::memory_strategies::allocator_memory_strategy::
+ *   AllocatorMemoryStrategy<Allocator>>(allocator);
+ * ```
+ *
+ * The allocators constructed by default, as some containers of the memory strategies are,
+ * use the default resource, which std::pmr::set_default_resource() can set to a pool too.
+ *
+ * Each block is prefixed with its size, so that the resource is given the right size when
+ * the size given to deallocate() is wrong, as with the rcl allocators made from it.
+ *
+ * \tparam T type of the allocated objects.
+ */
+template<typename T>
+class PolymorphicAllocator
+{
+  using Block = std::max_align_t;
+
+  template<typename U>
+  friend class PolymorphicAllocator;
+
+public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  template<typename U>
+  struct rebind
+  {
+    using other = PolymorphicAllocator<U>;
+  };
+
+  /// Constructor, using the default resource as of its construction.
+  PolymorphicAllocator() noexcept
+  : resource_(std::shared_ptr<void>(), std::pmr::get_default_resource())
+  {
+  }
+
+  /// Constructor, using a resource which has to outlive the allocator and its copies.
+  /**
+   * \param[in] resource resource which the memory is allocated from.
+   * \throws std::invalid_argument if resource is nullptr.
+   */
+  explicit PolymorphicAllocator(std::pmr::memory_resource * resource)
+  : resource_(std::shared_ptr<void>(), resource)
+  {
+    if (!resource_) {
+      throw std::invalid_argument("the resource of a polymorphic allocator can't be null");
+    }
+  }
+
+  /// Constructor, sharing the ownership of a resource with the allocator copies.
+  /**
+   * \param[in] resource resource which the memory is allocated from.
+   * \throws std::invalid_argument if resource is nullptr.
+   */
+  explicit PolymorphicAllocator(std::shared_ptr<std::pmr::memory_resource> resource)
+  : resource_(std::move(resource))
+  {
+    if (!resource_) {
+      throw std::invalid_argument("the resource of a polymorphic allocator can't be null");
+    }
+  }
+
+  template<typename U>
+  PolymorphicAllocator(const PolymorphicAllocator<U> & other) noexcept  // NOLINT
+  : resource_(other.resource_)
+  {
+  }
+
+  T *
+  allocate(size_t size)
+  {
+    static_assert(
+      alignof(T) <= alignof(Block), "polymorphic allocators don't support over-aligned types");
+    if (size > (std::numeric_limits<size_t>::max() - sizeof(Block)) / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+    const size_t bytes = size * sizeof(T) + sizeof(Block);
+    void * block = resource_->allocate(bytes, alignof(Block));
+    new (block) size_t(bytes);
+    return reinterpret_cast<T *>(static_cast<Block *>(block) + 1);
+  }
+
+  void
+  deallocate(T * pointer, size_t size) noexcept
+  {
+    (void)size;
+    if (!pointer) {
+      return;
+    }
+    Block * block = reinterpret_cast<Block *>(pointer) - 1;
+    resource_->deallocate(block, *reinterpret_cast<size_t *>(block), alignof(Block));
+  }
+
+  /// Return the resource which the memory is allocated from.
+  std::pmr::memory_resource *
+  resource() const noexcept
+  {
+    return resource_.get();
+  }
+
+  template<typename U>
+  bool
+  operator==(const PolymorphicAllocator<U> & other) const noexcept
+  {
+    return resource_ == other.resource_ || resource_->is_equal(*other.resource_);
+  }
+
+  template<typename U>
+  bool
+  operator!=(const PolymorphicAllocator<U> & other) const noexcept
+  {
+    return !(*this == other);
+  }
+
+private:
+  std::shared_ptr<std::pmr::memory_resource> resource_;
+};
+
+}  // namespace allocator
+}  // namespace rclcpp
+
+#endif  // RCLCPP__ALLOCATOR__POLYMORPHIC_ALLOCATOR_HPP_
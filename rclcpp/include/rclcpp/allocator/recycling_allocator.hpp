@@ -0,0 +1,316 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__ALLOCATOR__RECYCLING_ALLOCATOR_HPP_
+#define RCLCPP__ALLOCATOR__RECYCLING_ALLOCATOR_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "rclcpp/macros.hpp"
+
+namespace rclcpp
+{
+namespace allocator
+{
+
+/// Messages recycled by the recycling allocators sharing them.
+/**
+ * All the messages are constructed when the pool is created, and they are only destroyed
+ * with it, so that the sequences of a message keep their capacity while it's recycled.
+ *
+ * Taking and giving back messages is thread-safe.
+ */
+template<typename MessageT>
+class RecycledMessagePool
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(RecycledMessagePool<MessageT>)
+
+  /// Constructor.
+  /**
+   * \param[in] size number of messages of the pool.
+   */
+  explicit RecycledMessagePool(size_t size)
+  : messages_(new MessageT[size]), size_(size)
+  {
+    available_messages_.reserve(size);
+    for (size_t i = size; i > 0; --i) {
+      available_messages_.push_back(&messages_[i - 1]);
+    }
+  }
+
+  /// Take a message which isn't used anymore, or return nullptr if they are all used.
+  MessageT *
+  take_message()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (available_messages_.empty()) {
+      return nullptr;
+    }
+    MessageT * message = available_messages_.back();
+    available_messages_.pop_back();
+    return message;
+  }
+
+  /// Give back a message taken from this pool, without resetting it.
+  void
+  return_message(MessageT * message)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    available_messages_.push_back(message);
+  }
+
+  /// Return true if the message belongs to this pool.
+  bool
+  owns(const MessageT * message) const
+  {
+    std::less_equal<const MessageT *> less_equal;
+    return less_equal(messages_.get(), message) &&
+           std::less<const MessageT *>()(message, messages_.get() + size_);
+  }
+
+  /// Return the number of messages of the pool.
+  size_t
+  size() const
+  {
+    return size_;
+  }
+
+  /// Return the number of messages of the pool which are not used.
+  size_t
+  get_number_of_available_messages() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return available_messages_.size();
+  }
+
+private:
+  RCLCPP_DISABLE_COPY(RecycledMessagePool)
+
+  std::unique_ptr<MessageT[]> messages_;
+  const size_t size_;
+  mutable std::mutex mutex_;
+  std::vector<MessageT *> available_messages_;
+};
+
+/// Allocator recycling the messages of a type instead of deallocating them.
+/**
+ * The messages allocated one at a time are taken from a pool of messages, shared by the
+ * copies and rebound copies of the allocator, and given back to it when they are deallocated.
+ * They are never destroyed, so that their sequences keep the memory they allocated: a message
+ * copied into a recycled one is copy assigned, and a recycled message constructed without
+ * arguments keeps the contents it had, which have to be overwritten.
+ * The other allocations, and those made while all the messages are used, are made with the
+ * global operator new.
+ *
+ * When a publisher and its intra-process subscriptions use the same allocator, the messages
+ * they exchange, like the ones returned by Publisher::borrow_message() and their copies for
+ * the subscriptions taking ownership, are given back to the pool once the last subscription
+ * releases them, so that a steady-state pipeline doesn't allocate, for example:
+ *
+ * ```cpp
+ * using Allocator = rclcpp::allocator::RecyclingAllocator<void, MessageT>;
+ * auto allocator = std::make_shared<Allocator>(16);
+ * rclcpp::PublisherOptionsWithAllocator<Allocator> publisher_options;
+ * publisher_options.allocator = allocator;
+ * auto publisher = node->create_publisher<MessageT>("topic", 10, publisher_options);
+ * rclcpp::SubscriptionOptionsWithAllocator<Allocator> subscription_options;
+ * subscription_options.allocator = allocator;
+ * auto subscription = node->create_subscription<MessageT>(
+ *   "topic", 10, callback, subscription_options);
+ *
+ * auto message = publisher->borrow_message();
+ * message->data.resize(size);
+ * publisher->publish(std::move(message));
+ * ```
+ *
+ * The messages shared by several subscriptions are copied into memory allocated with the
+ * shared pointer holding them, so they aren't recycled.
+ *
+ * \tparam T type of the allocated objects.
+ * \tparam MessageT type of the recycled messages.
+ */
+template<typename T, typename MessageT>
+class RecyclingAllocator
+{
+  template<typename U, typename MessageU>
+  friend class RecyclingAllocator;
+
+public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  template<typename U>
+  struct rebind
+  {
+    using other = RecyclingAllocator<U, MessageT>;
+  };
+
+  /// Constructor, with a new pool.
+  /**
+   * \param[in] pool_size number of recycled messages.
+   * \throws std::invalid_argument if pool_size is 0.
+   */
+  explicit RecyclingAllocator(size_t pool_size = 16u)
+  : pool_(make_pool(pool_size))
+  {
+  }
+
+  /// Constructor, sharing a pool.
+  /**
+   * \param[in] pool pool of the recycled messages.
+   * \throws std::invalid_argument if pool is nullptr.
+   */
+  explicit RecyclingAllocator(std::shared_ptr<RecycledMessagePool<MessageT>> pool)
+  : pool_(std::move(pool))
+  {
+    if (!pool_) {
+      throw std::invalid_argument("the pool of a recycling allocator can't be null");
+    }
+  }
+
+  template<typename U>
+  RecyclingAllocator(const RecyclingAllocator<U, MessageT> & other) noexcept  // NOLINT
+  : pool_(other.pool_)
+  {
+  }
+
+  T *
+  allocate(size_t size)
+  {
+    static_assert(
+      alignof(T) <= alignof(std::max_align_t),
+      "recycling allocators don't support over-aligned types");
+    if constexpr (std::is_same_v<T, MessageT>) {
+      if (size == 1u) {
+        MessageT * message = pool_->take_message();
+        if (message) {
+          return message;
+        }
+      }
+    }
+    if (size > static_cast<size_t>(-1) / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T *>(::operator new(size * sizeof(T)));
+  }
+
+  /// Deallocate memory, the size being ignored as it's wrong with the rcl allocators.
+  void
+  deallocate(T * pointer, size_t size) noexcept
+  {
+    (void)size;
+    if constexpr (std::is_same_v<T, MessageT>) {
+      if (pool_->owns(pointer)) {
+        pool_->return_message(pointer);
+        return;
+      }
+    }
+    ::operator delete(pointer);
+  }
+
+  template<typename U, typename ... Args>
+  void
+  construct(U * pointer, Args && ... args)
+  {
+    if constexpr (std::is_same_v<U, MessageT>) {
+      if (pool_->owns(pointer)) {
+        assign(*pointer, std::forward<Args>(args)...);
+        return;
+      }
+    }
+    ::new (static_cast<void *>(pointer)) U(std::forward<Args>(args)...);
+  }
+
+  template<typename U>
+  void
+  destroy(U * pointer)
+  {
+    if constexpr (std::is_same_v<U, MessageT>) {
+      if (pool_->owns(pointer)) {
+        // Destroyed with the pool.
+        return;
+      }
+    }
+    pointer->~U();
+  }
+
+  /// Return the pool of the recycled messages.
+  const std::shared_ptr<RecycledMessagePool<MessageT>> &
+  get_pool() const noexcept
+  {
+    return pool_;
+  }
+
+  template<typename U>
+  bool
+  operator==(const RecyclingAllocator<U, MessageT> & other) const noexcept
+  {
+    return pool_ == other.pool_;
+  }
+
+  template<typename U>
+  bool
+  operator!=(const RecyclingAllocator<U, MessageT> & other) const noexcept
+  {
+    return !(*this == other);
+  }
+
+private:
+  static
+  std::shared_ptr<RecycledMessagePool<MessageT>>
+  make_pool(size_t pool_size)
+  {
+    if (pool_size == 0u) {
+      throw std::invalid_argument("the pool of a recycling allocator can't be empty");
+    }
+    return std::make_shared<RecycledMessagePool<MessageT>>(pool_size);
+  }
+
+  /// Construct a recycled message, copy or move assigning it to keep the memory of its sequences.
+  template<typename ... Args>
+  static
+  void
+  assign(MessageT & message, Args && ... args)
+  {
+    if constexpr (sizeof...(Args) == 0) {
+      // The contents are kept, as they will be overwritten.
+      (void)message;
+    } else if constexpr (  // NOLINT
+      sizeof...(Args) == 1 && std::conjunction_v<std::is_same<std::decay_t<Args>, MessageT>...>)
+    {
+      message = (std::forward<Args>(args), ...);
+    } else {
+      message = MessageT(std::forward<Args>(args)...);
+    }
+  }
+
+  std::shared_ptr<RecycledMessagePool<MessageT>> pool_;
+};
+
+}  // namespace allocator
+}  // namespace rclcpp
+
+#endif  // RCLCPP__ALLOCATOR__RECYCLING_ALLOCATOR_HPP_
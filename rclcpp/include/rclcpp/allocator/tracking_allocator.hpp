@@ -0,0 +1,261 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__ALLOCATOR__TRACKING_ALLOCATOR_HPP_
+#define RCLCPP__ALLOCATOR__TRACKING_ALLOCATOR_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace rclcpp
+{
+namespace allocator
+{
+
+/// Snapshot of the counters of an AllocationStatistics.
+struct AllocationCounters
+{
+  /// Number of allocations.
+  size_t number_of_allocations = 0;
+  /// Number of deallocations.
+  size_t number_of_deallocations = 0;
+  /// Number of bytes allocated, in total.
+  size_t bytes_allocated = 0;
+  /// Number of bytes allocated and not deallocated yet.
+  size_t bytes_in_use = 0;
+  /// Highest number of bytes in use.
+  size_t peak_bytes_in_use = 0;
+};
+
+/// Thread-safe counters of the allocations made through tracking allocators.
+class AllocationStatistics
+{
+public:
+  /// Record an allocation of the given number of bytes.
+  void
+  record_allocation(size_t bytes) noexcept
+  {
+    number_of_allocations_.fetch_add(1u, std::memory_order_relaxed);
+    bytes_allocated_.fetch_add(bytes, std::memory_order_relaxed);
+    const size_t bytes_in_use = bytes_in_use_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    size_t peak_bytes_in_use = peak_bytes_in_use_.load(std::memory_order_relaxed);
+    while (peak_bytes_in_use < bytes_in_use &&
+      !peak_bytes_in_use_.compare_exchange_weak(
+        peak_bytes_in_use, bytes_in_use, std::memory_order_relaxed))
+    {
+    }
+  }
+
+  /// Record a deallocation of the given number of bytes.
+  void
+  record_deallocation(size_t bytes) noexcept
+  {
+    number_of_deallocations_.fetch_add(1u, std::memory_order_relaxed);
+    bytes_in_use_.fetch_sub(bytes, std::memory_order_relaxed);
+  }
+
+  /// Return the current values of the counters.
+  /**
+   * The counters are read one after the other, so they may not be consistent with each
+   * other while allocations are made concurrently.
+   */
+  AllocationCounters
+  get_counters() const noexcept
+  {
+    AllocationCounters counters;
+    counters.number_of_allocations = number_of_allocations_.load(std::memory_order_relaxed);
+    counters.number_of_deallocations = number_of_deallocations_.load(std::memory_order_relaxed);
+    counters.bytes_allocated = bytes_allocated_.load(std::memory_order_relaxed);
+    counters.bytes_in_use = bytes_in_use_.load(std::memory_order_relaxed);
+    counters.peak_bytes_in_use = peak_bytes_in_use_.load(std::memory_order_relaxed);
+    return counters;
+  }
+
+  /// Reset the counters, except for the bytes in use, which become the peak.
+  /**
+   * This is meant to be called once an entity reached its steady state, so that
+   * the counters only reflect the allocations made afterwards.
+   */
+  void
+  reset() noexcept
+  {
+    number_of_allocations_.store(0u, std::memory_order_relaxed);
+    number_of_deallocations_.store(0u, std::memory_order_relaxed);
+    bytes_allocated_.store(0u, std::memory_order_relaxed);
+    peak_bytes_in_use_.store(
+      bytes_in_use_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<size_t> number_of_allocations_{0u};
+  std::atomic<size_t> number_of_deallocations_{0u};
+  std::atomic<size_t> bytes_allocated_{0u};
+  std::atomic<size_t> bytes_in_use_{0u};
+  std::atomic<size_t> peak_bytes_in_use_{0u};
+};
+
+/// Allocator adaptor counting the allocations made through another allocator.
+/**
+ * The copies and rebound copies of a tracking allocator share its statistics, so that
+ * an entity created with it, like a publisher or a subscription, counts all the allocations
+ * it makes with its allocator, which can be retrieved from it, for example:
+ *
+ * ```cpp
+ * using Allocator = rclcpp::allocator::TrackingAllocator<void>;
+ * rclcpp::PublisherOptionsWithAllocator<Allocator> options;
+ * options.allocator = std::make_shared<Allocator>();
+ * auto publisher = node->create_publisher<MessageT>("topic", 10, options);
+ * auto counters = publisher->get_published_type_allocator().get_statistics()->get_counters();
+ * ```
+ *
+ * Each block is prefixed with its size, so that the bytes in use are also tracked when
+ * the size given to deallocate() is wrong, as with the rcl allocators made from it.
+ *
+ * \tparam T type of the allocated objects.
+ * \tparam BaseAllocatorT allocator which the memory is allocated with.
+ */
+template<typename T, typename BaseAllocatorT = std::allocator<T>>
+class TrackingAllocator
+{
+  using BaseAllocatorTraits = std::allocator_traits<BaseAllocatorT>;
+  using Block = std::max_align_t;
+  using BlockAllocator = typename BaseAllocatorTraits::template rebind_alloc<Block>;
+  using BlockAllocatorTraits = std::allocator_traits<BlockAllocator>;
+
+  template<typename U, typename BaseAllocatorU>
+  friend class TrackingAllocator;
+
+public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  template<typename U>
+  struct rebind
+  {
+    using other =
+      TrackingAllocator<U, typename BaseAllocatorTraits::template rebind_alloc<U>>;
+  };
+
+  /// Constructor, with new statistics.
+  TrackingAllocator()
+  : statistics_(std::make_shared<AllocationStatistics>())
+  {
+  }
+
+  /// Constructor, sharing statistics.
+  /**
+   * \param[in] statistics statistics which the allocations are recorded into.
+   * \param[in] base_allocator allocator which the memory is allocated with.
+   * \throws std::invalid_argument if statistics is nullptr.
+   */
+  explicit TrackingAllocator(
+    std::shared_ptr<AllocationStatistics> statistics,
+    const BaseAllocatorT & base_allocator = BaseAllocatorT())
+  : statistics_(std::move(statistics)), base_allocator_(base_allocator)
+  {
+    if (!statistics_) {
+      throw std::invalid_argument("the statistics of a tracking allocator can't be null");
+    }
+  }
+
+  template<typename U, typename BaseAllocatorU>
+  TrackingAllocator(const TrackingAllocator<U, BaseAllocatorU> & other) noexcept  // NOLINT
+  : statistics_(other.statistics_), base_allocator_(other.base_allocator_)
+  {
+  }
+
+  T *
+  allocate(size_t size)
+  {
+    static_assert(
+      alignof(T) <= alignof(Block), "tracking allocators don't support over-aligned types");
+    if (size > (std::numeric_limits<size_t>::max() - sizeof(Block)) / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+    const size_t bytes = size * sizeof(T);
+    BlockAllocator block_allocator(base_allocator_);
+    Block * block = BlockAllocatorTraits::allocate(block_allocator, get_number_of_blocks(bytes));
+    new (block) size_t(bytes);
+    statistics_->record_allocation(bytes);
+    return reinterpret_cast<T *>(block + 1);
+  }
+
+  void
+  deallocate(T * pointer, size_t size) noexcept
+  {
+    (void)size;
+    if (!pointer) {
+      return;
+    }
+    Block * block = reinterpret_cast<Block *>(pointer) - 1;
+    const size_t bytes = *reinterpret_cast<size_t *>(block);
+    BlockAllocator block_allocator(base_allocator_);
+    BlockAllocatorTraits::deallocate(block_allocator, block, get_number_of_blocks(bytes));
+    statistics_->record_deallocation(bytes);
+  }
+
+  /// Return the statistics shared by the copies of this allocator.
+  const std::shared_ptr<AllocationStatistics> &
+  get_statistics() const noexcept
+  {
+    return statistics_;
+  }
+
+  /// Return the allocator which the memory is allocated with.
+  const BaseAllocatorT &
+  get_base_allocator() const noexcept
+  {
+    return base_allocator_;
+  }
+
+  template<typename U, typename BaseAllocatorU>
+  bool
+  operator==(const TrackingAllocator<U, BaseAllocatorU> & other) const noexcept
+  {
+    return statistics_ == other.statistics_ &&
+           BlockAllocator(base_allocator_) == BlockAllocator(other.base_allocator_);
+  }
+
+  template<typename U, typename BaseAllocatorU>
+  bool
+  operator!=(const TrackingAllocator<U, BaseAllocatorU> & other) const noexcept
+  {
+    return !(*this == other);
+  }
+
+private:
+  static size_t
+  get_number_of_blocks(size_t bytes) noexcept
+  {
+    // One more block for the size
+    return 1u + (bytes + sizeof(Block) - 1u) / sizeof(Block);
+  }
+
+  std::shared_ptr<AllocationStatistics> statistics_;
+  BaseAllocatorT base_allocator_;
+};
+
+}  // namespace allocator
+}  // namespace rclcpp
+
+#endif  // RCLCPP__ALLOCATOR__TRACKING_ALLOCATOR_HPP_
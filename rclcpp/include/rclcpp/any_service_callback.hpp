@@ -149,12 +149,18 @@ public:
     }
   }
 
+  /// Call the callback, returning the response or nullptr if it is deferred.
+  /**
+   * \param[in] response default constructed response given to the callback,
+   *   one is allocated if it is nullptr and the response isn't deferred.
+   */
   // template<typename Allocator = std::allocator<typename ServiceT::Response>>
   std::shared_ptr<typename ServiceT::Response>
   dispatch(
     const std::shared_ptr<rclcpp::Service<ServiceT>> & service_handle,
     const std::shared_ptr<rmw_request_id_t> & request_header,
-    std::shared_ptr<typename ServiceT::Request> request)
+    std::shared_ptr<typename ServiceT::Request> request,
+    std::shared_ptr<typename ServiceT::Response> response = nullptr)
   {
     TRACEPOINT(callback_start, static_cast<const void *>(this), false);
     if (std::holds_alternative<std::monostate>(callback_)) {
@@ -172,8 +178,10 @@ public:
       cb(service_handle, request_header, std::move(request));
       return nullptr;
     }
-    // auto response = allocate_shared<typename ServiceT::Response, Allocator>();
-    auto response = std::make_shared<typename ServiceT::Response>();
+    if (!response) {
+      // response = allocate_shared<typename ServiceT::Response, Allocator>();
+      response = std::make_shared<typename ServiceT::Response>();
+    }
     if (std::holds_alternative<SharedPtrCallback>(callback_)) {
       (void)request_header;
       const auto & cb = std::get<SharedPtrCallback>(callback_);
@@ -186,6 +194,14 @@ public:
     return response;
   }
 
+  /// Return true if the callback sends its responses itself, later.
+  bool
+  is_deferred() const
+  {
+    return std::holds_alternative<SharedPtrDeferResponseCallback>(callback_) ||
+           std::holds_alternative<SharedPtrDeferResponseCallbackWithServiceHandle>(callback_);
+  }
+
   void register_callback_for_tracing()
   {
 #ifndef TRACETOOLS_DISABLED
@@ -21,6 +21,7 @@
 #include <type_traits>
 #include <utility>
 #include <variant>  // NOLINT[build/include_order]
+#include <vector>
 
 #include "rosidl_runtime_cpp/traits.hpp"
 #include "tracetools/tracetools.h"
@@ -152,6 +153,14 @@ struct AnySubscriptionCallbackPossibleTypes
     std::function<void (std::shared_ptr<rclcpp::SerializedMessage>)>;
   using SharedPtrSerializedMessageWithInfoCallback =
     std::function<void (std::shared_ptr<rclcpp::SerializedMessage>, const rclcpp::MessageInfo &)>;
+
+  // The messages taken at once with SubscriptionOptionsBase::max_messages_per_wakeup.
+  using BatchROSMessageCallback =
+    std::function<void (const std::vector<std::shared_ptr<const ROSMessageType>> &)>;
+  using BatchWithInfoROSMessageCallback =
+    std::function<void (
+        const std::vector<std::shared_ptr<const ROSMessageType>> &,
+        const std::vector<rclcpp::MessageInfo> &)>;
 };
 
 /// Template helper to select the variant type based on whether or not MessageT is a TypeAdapter.
@@ -188,7 +197,9 @@ struct AnySubscriptionCallbackHelper<MessageT, AllocatorT, false>
     typename CallbackTypes::SharedPtrCallback,
     typename CallbackTypes::SharedPtrWithInfoCallback,
     typename CallbackTypes::SharedPtrSerializedMessageCallback,
-    typename CallbackTypes::SharedPtrSerializedMessageWithInfoCallback
+    typename CallbackTypes::SharedPtrSerializedMessageWithInfoCallback,
+    typename CallbackTypes::BatchROSMessageCallback,
+    typename CallbackTypes::BatchWithInfoROSMessageCallback
   >;
 };
 
@@ -228,7 +239,9 @@ struct AnySubscriptionCallbackHelper<MessageT, AllocatorT, true>
     typename CallbackTypes::SharedPtrWithInfoCallback,
     typename CallbackTypes::SharedPtrWithInfoROSMessageCallback,
     typename CallbackTypes::SharedPtrSerializedMessageCallback,
-    typename CallbackTypes::SharedPtrSerializedMessageWithInfoCallback
+    typename CallbackTypes::SharedPtrSerializedMessageWithInfoCallback,
+    typename CallbackTypes::BatchROSMessageCallback,
+    typename CallbackTypes::BatchWithInfoROSMessageCallback
   >;
 };
 
@@ -329,6 +342,10 @@ private:
     typename CallbackTypes::SharedPtrSerializedMessageCallback;
   using SharedPtrSerializedMessageWithInfoCallback =
     typename CallbackTypes::SharedPtrSerializedMessageWithInfoCallback;
+  using BatchROSMessageCallback =
+    typename CallbackTypes::BatchROSMessageCallback;
+  using BatchWithInfoROSMessageCallback =
+    typename CallbackTypes::BatchWithInfoROSMessageCallback;
 
   template<typename T>
   struct NotNull
@@ -384,6 +401,10 @@ public:
       std::function<void(std::shared_ptr<MessageT>, const rclcpp::MessageInfo &)>
       >::value;
 
+    ros_message_callback_.reset();
+    ros_message_dispatcher_ = nullptr;
+    ros_message_callback_registrar_ = nullptr;
+
     // Use the discovered type to force the type of callback when assigning
     // into the variant.
     if constexpr (is_deprecated) {
@@ -391,7 +412,7 @@ public:
       set_deprecated(static_cast<typename scbth::callback_type>(callback));
     } else {
       // Otherwise just assign it.
-      callback_variant_ = static_cast<typename scbth::callback_type>(callback);
+      set_callback<typename scbth::callback_type>(std::move(callback));
     }
 
     // Return copy of self for easier testing, normally will be compiled out.
@@ -500,6 +521,12 @@ public:
         throw std::runtime_error("dispatch called on an unset AnySubscriptionCallback");
       }
     }
+    // Fast path, calling the callback with its own type, without visiting the variant.
+    if (ros_message_dispatcher_) {
+      ros_message_dispatcher_(ros_message_callback_.get(), *this, message, message_info);
+      TRACEPOINT(callback_end, static_cast<const void *>(this));
+      return;
+    }
     // Dispatch.
     std::visit(
       [&message, &message_info, this](auto && callback) {
@@ -561,6 +588,12 @@ public:
         {
           callback(message, message_info);
         }
+        // conditions for a batch of one ros message
+        else if constexpr (std::is_same_v<T, BatchROSMessageCallback>) {  // NOLINT
+          callback({message});
+        } else if constexpr (std::is_same_v<T, BatchWithInfoROSMessageCallback>) {
+          callback({message}, {message_info});
+        }
         // condition to catch SerializedMessage types
         else if constexpr (  // NOLINT[readability/braces]
           std::is_same_v<T, ConstRefSerializedMessageCallback>||
@@ -652,7 +685,9 @@ public:
           std::is_same_v<T, SharedPtrCallback>||
           std::is_same_v<T, SharedPtrROSMessageCallback>||
           std::is_same_v<T, SharedPtrWithInfoCallback>||
-          std::is_same_v<T, SharedPtrWithInfoROSMessageCallback>)
+          std::is_same_v<T, SharedPtrWithInfoROSMessageCallback>||
+          std::is_same_v<T, BatchROSMessageCallback>||
+          std::is_same_v<T, BatchWithInfoROSMessageCallback>)
         {
           throw std::runtime_error(
             "cannot dispatch rclcpp::SerializedMessage to "
@@ -771,6 +806,23 @@ public:
             callback(message, message_info);
           }
         }
+        // conditions for a batch of one ros message
+        else if constexpr (  // NOLINT[readability/braces]
+          std::is_same_v<T, BatchROSMessageCallback>||
+          std::is_same_v<T, BatchWithInfoROSMessageCallback>)
+        {
+          std::shared_ptr<const ROSMessageType> ros_message;
+          if constexpr (is_ta) {
+            ros_message = convert_custom_type_to_ros_message_unique_ptr(*message);
+          } else {
+            ros_message = message;
+          }
+          if constexpr (std::is_same_v<T, BatchROSMessageCallback>) {
+            callback({std::move(ros_message)});
+          } else {
+            callback({std::move(ros_message)}, {message_info});
+          }
+        }
         // condition to catch SerializedMessage types
         else if constexpr (  // NOLINT[readability/braces]
           std::is_same_v<T, ConstRefSerializedMessageCallback>||
@@ -905,6 +957,23 @@ public:
             callback(std::move(message), message_info);
           }
         }
+        // conditions for a batch of one ros message
+        else if constexpr (  // NOLINT[readability/braces]
+          std::is_same_v<T, BatchROSMessageCallback>||
+          std::is_same_v<T, BatchWithInfoROSMessageCallback>)
+        {
+          std::shared_ptr<const ROSMessageType> ros_message;
+          if constexpr (is_ta) {
+            ros_message = convert_custom_type_to_ros_message_unique_ptr(*message);
+          } else {
+            ros_message = std::move(message);
+          }
+          if constexpr (std::is_same_v<T, BatchROSMessageCallback>) {
+            callback({std::move(ros_message)});
+          } else {
+            callback({std::move(ros_message)}, {message_info});
+          }
+        }
         // condition to catch SerializedMessage types
         else if constexpr (  // NOLINT[readability/braces]
           std::is_same_v<T, ConstRefSerializedMessageCallback>||
@@ -934,11 +1003,52 @@ public:
   bool
   use_take_shared_method() const
   {
+    // The const reference callbacks don't take ownership of the message, so they are
+    // given a shared message too instead of a copy of their own.
     return
+      std::holds_alternative<ConstRefCallback>(callback_variant_) ||
+      std::holds_alternative<ConstRefROSMessageCallback>(callback_variant_) ||
+      std::holds_alternative<ConstRefWithInfoCallback>(callback_variant_) ||
+      std::holds_alternative<ConstRefWithInfoROSMessageCallback>(callback_variant_) ||
       std::holds_alternative<SharedConstPtrCallback>(callback_variant_) ||
       std::holds_alternative<SharedConstPtrWithInfoCallback>(callback_variant_) ||
       std::holds_alternative<ConstRefSharedConstPtrCallback>(callback_variant_) ||
-      std::holds_alternative<ConstRefSharedConstPtrWithInfoCallback>(callback_variant_);
+      std::holds_alternative<ConstRefSharedConstPtrWithInfoCallback>(callback_variant_) ||
+      is_batch_callback();
+  }
+
+  /// Return true if the callback takes the messages taken at once as a batch.
+  constexpr
+  bool
+  is_batch_callback() const
+  {
+    return
+      std::holds_alternative<BatchROSMessageCallback>(callback_variant_) ||
+      std::holds_alternative<BatchWithInfoROSMessageCallback>(callback_variant_);
+  }
+
+  /// Dispatch the ros messages taken at once to a batch callback, in a single call.
+  /**
+   * \param[in] messages the messages, in the order they were received.
+   * \param[in] message_infos the infos of the messages, at the same indexes.
+   * \throws std::runtime_error if the callback doesn't take batches, see is_batch_callback().
+   */
+  void
+  dispatch_batch(
+    const std::vector<std::shared_ptr<const ROSMessageType>> & messages,
+    const std::vector<rclcpp::MessageInfo> & message_infos)
+  {
+    TRACEPOINT(callback_start, static_cast<const void *>(this), false);
+    if (std::holds_alternative<BatchROSMessageCallback>(callback_variant_)) {
+      std::get<BatchROSMessageCallback>(callback_variant_)(messages);
+    } else if (std::holds_alternative<BatchWithInfoROSMessageCallback>(callback_variant_)) {
+      std::get<BatchWithInfoROSMessageCallback>(callback_variant_)(messages, message_infos);
+    } else {
+      throw std::runtime_error(
+              "dispatch_batch called on an AnySubscriptionCallback "
+              "without a batch callback");
+    }
+    TRACEPOINT(callback_end, static_cast<const void *>(this));
   }
 
   constexpr
@@ -963,6 +1073,10 @@ public:
   register_callback_for_tracing()
   {
 #ifndef TRACETOOLS_DISABLED
+    if (ros_message_callback_registrar_) {
+      ros_message_callback_registrar_(ros_message_callback_.get(), this);
+      return;
+    }
     std::visit(
       [this](auto && callback) {
         TRACEPOINT(
@@ -973,9 +1087,17 @@ public:
 #endif  // TRACETOOLS_DISABLED
   }
 
+  /// Return the variant of the callback, which may be modified.
+  /**
+   * The callback is then always dispatched through the variant, even if it could be called
+   * with its own type, since the variant may not hold it anymore.
+   */
   typename HelperT::variant_type &
   get_variant()
   {
+    ros_message_callback_.reset();
+    ros_message_dispatcher_ = nullptr;
+    ros_message_callback_registrar_ = nullptr;
     return callback_variant_;
   }
 
@@ -986,6 +1108,93 @@ public:
   }
 
 private:
+  using ROSMessageDispatcher = void (*)(
+    void * callback,
+    AnySubscriptionCallback & self,
+    const std::shared_ptr<ROSMessageType> & message,
+    const rclcpp::MessageInfo & message_info);
+  using ROSMessageCallbackRegistrar = void (*)(const void * callback, const void * self);
+
+  /// Assign the callback into the variant, keeping it with its own type if it takes a ROS message.
+  /**
+   * The ROS messages taken by the subscription are then dispatched with a single call
+   * of the dispatcher, in which small callbacks can be inlined, instead of visiting the
+   * variant and calling its std::function.
+   * The std::function in the variant calls the same callback object, so that the state of
+   * the callback is the same whichever way the messages are dispatched.
+   */
+  template<typename CallbackTypeT, typename CallbackT>
+  void
+  set_callback(CallbackT callback)
+  {
+    if constexpr (  // NOLINT[readability/braces]
+      std::is_same_v<CallbackTypeT, ConstRefROSMessageCallback>||
+      std::is_same_v<CallbackTypeT, ConstRefWithInfoROSMessageCallback>||
+      std::is_same_v<CallbackTypeT, UniquePtrROSMessageCallback>||
+      std::is_same_v<CallbackTypeT, UniquePtrWithInfoROSMessageCallback>||
+      std::is_same_v<CallbackTypeT, SharedConstPtrROSMessageCallback>||
+      std::is_same_v<CallbackTypeT, SharedConstPtrWithInfoROSMessageCallback>||
+      std::is_same_v<CallbackTypeT, ConstRefSharedConstPtrROSMessageCallback>||
+      std::is_same_v<CallbackTypeT, ConstRefSharedConstPtrWithInfoROSMessageCallback>)
+    {
+      auto shared_callback = std::make_shared<CallbackT>(std::move(callback));
+      callback_variant_ = CallbackTypeT(
+        [shared_callback](auto &&... args) {
+          std::invoke(*shared_callback, std::forward<decltype(args)>(args)...);
+        });
+      ros_message_callback_ = std::move(shared_callback);
+      ros_message_dispatcher_ = &dispatch_ros_message<CallbackTypeT, CallbackT>;
+      ros_message_callback_registrar_ =
+        &register_ros_message_callback_for_tracing<CallbackTypeT, CallbackT>;
+    } else {
+      callback_variant_ = static_cast<CallbackTypeT>(callback);
+    }
+  }
+
+  template<typename CallbackTypeT, typename CallbackT>
+  static void
+  dispatch_ros_message(
+    void * callback_pointer,
+    AnySubscriptionCallback & self,
+    const std::shared_ptr<ROSMessageType> & message,
+    const rclcpp::MessageInfo & message_info)
+  {
+    (void)self;
+    (void)message_info;
+    auto & callback = *static_cast<CallbackT *>(callback_pointer);
+    if constexpr (std::is_same_v<CallbackTypeT, ConstRefROSMessageCallback>) {
+      std::invoke(callback, std::as_const(*message));
+    } else if constexpr (std::is_same_v<CallbackTypeT, ConstRefWithInfoROSMessageCallback>) {
+      std::invoke(callback, std::as_const(*message), message_info);
+    } else if constexpr (std::is_same_v<CallbackTypeT, UniquePtrROSMessageCallback>) {
+      std::invoke(callback, self.create_ros_unique_ptr_from_ros_shared_ptr_message(message));
+    } else if constexpr (std::is_same_v<CallbackTypeT, UniquePtrWithInfoROSMessageCallback>) {
+      std::invoke(
+        callback, self.create_ros_unique_ptr_from_ros_shared_ptr_message(message), message_info);
+    } else if constexpr (  // NOLINT[readability/braces]
+      std::is_same_v<CallbackTypeT, SharedConstPtrROSMessageCallback>||
+      std::is_same_v<CallbackTypeT, ConstRefSharedConstPtrROSMessageCallback>)
+    {
+      std::invoke(callback, std::shared_ptr<const ROSMessageType>(message));
+    } else {
+      std::invoke(callback, std::shared_ptr<const ROSMessageType>(message), message_info);
+    }
+  }
+
+  /// Register the symbol of the callback itself rather than of the std::function calling it.
+  template<typename CallbackTypeT, typename CallbackT>
+  static void
+  register_ros_message_callback_for_tracing(const void * callback_pointer, const void * self)
+  {
+    (void)callback_pointer;
+    (void)self;
+    TRACEPOINT(
+      rclcpp_callback_register,
+      self,
+      tracetools::get_symbol(
+        static_cast<CallbackTypeT>(*static_cast<const CallbackT *>(callback_pointer))));
+  }
+
   // TODO(wjwwood): switch to inheriting from std::variant (i.e. HelperT::variant_type) once
   // inheriting from std::variant is realistic (maybe C++23?), see:
   //   http://www.open-std.org/jtc1/sc22/wg21/docs/papers/2020/p2162r0.html
@@ -998,6 +1207,12 @@ private:
   ROSMessageTypeDeleter ros_message_type_deleter_;
   SerializedMessageAllocator serialized_message_allocator_;
   SerializedMessageDeleter serialized_message_deleter_;
+
+  // The callback with its own type, shared by the copies and by the std::function in the
+  // variant, and the function calling it.
+  std::shared_ptr<void> ros_message_callback_;
+  ROSMessageDispatcher ros_message_dispatcher_ = nullptr;
+  ROSMessageCallbackRegistrar ros_message_callback_registrar_ = nullptr;
 };
 
 }  // namespace rclcpp
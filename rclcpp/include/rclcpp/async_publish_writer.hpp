@@ -0,0 +1,107 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__ASYNC_PUBLISH_WRITER_HPP_
+#define RCLCPP__ASYNC_PUBLISH_WRITER_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Thread publishing to the middleware the messages queued by publishers, instead of them.
+/**
+ * A publisher given a writer with PublisherOptionsBase::async_publish_writer queues its
+ * messages in a lock-free queue, and the writer calls rcl_publish() for them, so that
+ * Publisher::publish() doesn't serialize the messages, nor wait for the locks and system
+ * calls of the middleware.
+ * Waking up the writer takes a mutex which the writer only holds to check whether it has
+ * to wait, and happens at most once for all the messages queued before it wakes up.
+ *
+ * A writer can be shared by the publishers of any number of nodes, which are published in
+ * the order they were added to the writer.
+ */
+class AsyncPublishWriter
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(AsyncPublishWriter)
+
+  /// Messages of a publisher, published by the writer.
+  class QueueBase
+  {
+  public:
+    RCLCPP_PUBLIC
+    virtual ~QueueBase() = default;
+
+    /// Publish the queued messages, returning their number.
+    virtual
+    size_t
+    publish_queued() = 0;
+  };
+
+  /// Constructor, starting the thread.
+  RCLCPP_PUBLIC
+  AsyncPublishWriter();
+
+  /// Destructor, publishing the messages queued before and joining the thread.
+  RCLCPP_PUBLIC
+  ~AsyncPublishWriter();
+
+  /// Add the queue of a publisher.
+  /**
+   * \throws std::invalid_argument if the queue is null.
+   */
+  RCLCPP_PUBLIC
+  void
+  add_queue(std::shared_ptr<QueueBase> queue);
+
+  /// Remove the queue of a publisher, waiting until the writer isn't publishing its messages.
+  RCLCPP_PUBLIC
+  void
+  remove_queue(const QueueBase * queue);
+
+  /// Wake up the writer to publish the messages just queued.
+  RCLCPP_PUBLIC
+  void
+  notify();
+
+private:
+  RCLCPP_DISABLE_COPY(AsyncPublishWriter)
+
+  void
+  run();
+
+  // Held while the messages are published, so that the queues can be removed safely.
+  std::mutex queues_mutex_;
+  std::vector<std::shared_ptr<QueueBase>> queues_;
+
+  std::atomic<bool> notified_{false};
+  std::mutex wake_mutex_;
+  std::condition_variable wake_condition_;
+  bool stopped_ = false;
+  std::thread thread_;
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__ASYNC_PUBLISH_WRITER_HPP_
@@ -0,0 +1,110 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__CALLBACK_ATTRIBUTION_HPP_
+#define RCLCPP__CALLBACK_ATTRIBUTION_HPP_
+
+#include <string>
+
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+/// Opt-in hooks attributing the time of the callbacks to their entities in sampling profilers.
+/**
+ * Once enabled, the executors rename their threads to the name of the entity whose callback
+ * they execute, e.g. the end of a topic name, so that the samples of `perf record` and the
+ * flame graphs made from them are grouped by entity, and restore the name afterwards.
+ * The threads of the multi-threaded executor are also named after their number.
+ * On Linux, the `rclcpp:callback_start` and `rclcpp:callback_end` USDT probes are also fired,
+ * with the address and the name of the entity as arguments, when `sys/sdt.h` was available.
+ *
+ * Renaming a thread is a system call, so this is disabled by default.
+ * It's enabled by setting the `RCLCPP_CALLBACK_ATTRIBUTION` environment variable to 1,
+ * or with enable().
+ * Thread names are only set on Linux.
+ */
+namespace callback_attribution
+{
+
+/// Start attributing the callbacks executed from now on.
+RCLCPP_PUBLIC
+void
+enable();
+
+/// Stop attributing the callbacks.
+RCLCPP_PUBLIC
+void
+disable();
+
+/// Return true if the callbacks are attributed.
+RCLCPP_PUBLIC
+bool
+is_enabled() noexcept;
+
+/// Set the name of the calling thread, which is truncated to its last 15 characters.
+/**
+ * The name is restored after each attributed callback.
+ */
+RCLCPP_PUBLIC
+void
+set_thread_name(const std::string & name) noexcept;
+
+/// Attribute the execution of a callback while in scope, if enabled.
+class ScopedCallback
+{
+public:
+  /// Constructor.
+  /**
+   * \param[in] entity address of the entity whose callback is executed.
+   * \param[in] name name of the entity, e.g. its topic name.
+   */
+  ScopedCallback(const void * entity, const char * name) noexcept
+  : entity_(entity), name_(name), started_(is_enabled())
+  {
+    if (started_) {
+      start();
+    }
+  }
+
+  ~ScopedCallback()
+  {
+    if (started_) {
+      end();
+    }
+  }
+
+  ScopedCallback(const ScopedCallback &) = delete;
+  ScopedCallback & operator=(const ScopedCallback &) = delete;
+
+private:
+  RCLCPP_PUBLIC
+  void
+  start() noexcept;
+
+  RCLCPP_PUBLIC
+  void
+  end() noexcept;
+
+  const void * const entity_;
+  const char * const name_;
+  const bool started_;
+  // Name of the thread before the callback, restored afterwards
+  char previous_thread_name_[16];
+};
+
+}  // namespace callback_attribution
+}  // namespace rclcpp
+
+#endif  // RCLCPP__CALLBACK_ATTRIBUTION_HPP_
@@ -16,6 +16,8 @@
 #define RCLCPP__CALLBACK_GROUP_HPP_
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -49,6 +51,34 @@ enum class CallbackGroupType
   Reentrant
 };
 
+/// Immutable copy of the entities of a callback group at one of its generations.
+/**
+ * The entities are weak pointers, as the group doesn't keep them alive.
+ */
+struct CallbackGroupEntities
+{
+  /// Generation of the group the entities were copied at.
+  uint64_t generation = 0u;
+  std::vector<rclcpp::SubscriptionBase::WeakPtr> subscriptions;
+  std::vector<rclcpp::TimerBase::WeakPtr> timers;
+  std::vector<rclcpp::ServiceBase::WeakPtr> services;
+  std::vector<rclcpp::ClientBase::WeakPtr> clients;
+  std::vector<rclcpp::Waitable::WeakPtr> waitables;
+};
+
+/// CPU time spent executing the callbacks of a callback group.
+struct CallbackGroupCpuStatistics
+{
+  /// Number of callbacks executed.
+  uint64_t executions = 0u;
+  /// Total thread CPU time of the executions.
+  std::chrono::nanoseconds cpu_time{0};
+  /// Longest thread CPU time of an execution.
+  std::chrono::nanoseconds max_cpu_time{0};
+  /// Number of executions which used more CPU time than the budget.
+  uint64_t overruns = 0u;
+};
+
 class CallbackGroup
 {
   friend class rclcpp::node_interfaces::NodeServices;
@@ -106,35 +136,36 @@ public:
   rclcpp::SubscriptionBase::SharedPtr
   find_subscription_ptrs_if(Function func) const
   {
-    return _find_ptrs_if_impl<rclcpp::SubscriptionBase, Function>(func, subscription_ptrs_);
+    return _find_ptrs_if_impl<rclcpp::SubscriptionBase, Function>(
+      func, get_entities()->subscriptions);
   }
 
   template<typename Function>
   rclcpp::TimerBase::SharedPtr
   find_timer_ptrs_if(Function func) const
   {
-    return _find_ptrs_if_impl<rclcpp::TimerBase, Function>(func, timer_ptrs_);
+    return _find_ptrs_if_impl<rclcpp::TimerBase, Function>(func, get_entities()->timers);
   }
 
   template<typename Function>
   rclcpp::ServiceBase::SharedPtr
   find_service_ptrs_if(Function func) const
   {
-    return _find_ptrs_if_impl<rclcpp::ServiceBase, Function>(func, service_ptrs_);
+    return _find_ptrs_if_impl<rclcpp::ServiceBase, Function>(func, get_entities()->services);
   }
 
   template<typename Function>
   rclcpp::ClientBase::SharedPtr
   find_client_ptrs_if(Function func) const
   {
-    return _find_ptrs_if_impl<rclcpp::ClientBase, Function>(func, client_ptrs_);
+    return _find_ptrs_if_impl<rclcpp::ClientBase, Function>(func, get_entities()->clients);
   }
 
   template<typename Function>
   rclcpp::Waitable::SharedPtr
   find_waitable_ptrs_if(Function func) const
   {
-    return _find_ptrs_if_impl<rclcpp::Waitable, Function>(func, waitable_ptrs_);
+    return _find_ptrs_if_impl<rclcpp::Waitable, Function>(func, get_entities()->waitables);
   }
 
   RCLCPP_PUBLIC
@@ -153,6 +184,17 @@ public:
     std::function<void(const rclcpp::TimerBase::SharedPtr &)> timer_func,
     std::function<void(const rclcpp::Waitable::SharedPtr &)> waitable_func) const;
 
+  /// Return the entities of this group at its current generation.
+  /**
+   * The copy is made once per generation, without the expired entities, and then shared
+   * by the executors without locking the mutex of the group, which only protects its
+   * modifications.
+   * collect_all_ptrs() and the find_*_ptrs_if() functions iterate this copy.
+   */
+  RCLCPP_PUBLIC
+  std::shared_ptr<const CallbackGroupEntities>
+  get_entities() const;
+
   /// Return a reference to the 'associated with executor' atomic boolean.
   /**
    * When a callback group is added to an executor this boolean is checked
@@ -178,6 +220,144 @@ public:
   bool
   automatically_add_to_executor_with_node() const;
 
+  /// Set the priority of this callback group.
+  /**
+   * Executors using the ExecutorSchedulingPolicy::Priority policy execute the
+   * ready entities of the groups with the highest priority first.
+   * The default priority is 0.
+   *
+   * \param[in] priority the new priority, higher values are executed first.
+   */
+  RCLCPP_PUBLIC
+  void
+  set_priority(int priority);
+
+  /// Return the priority of this callback group.
+  RCLCPP_PUBLIC
+  int
+  get_priority() const;
+
+  /// Set the relative deadline of the callbacks of this callback group.
+  /**
+   * Executors using the ExecutorSchedulingPolicy::EarliestDeadlineFirst policy
+   * execute the ready entity with the earliest deadline first, the deadline of
+   * an entity being the time at which it was found ready plus this duration.
+   * Groups without a deadline, the default, are executed after all the others.
+   *
+   * \param[in] deadline the new deadline, zero or negative to remove it.
+   */
+  RCLCPP_PUBLIC
+  void
+  set_deadline(std::chrono::nanoseconds deadline);
+
+  /// Return the relative deadline of this callback group, zero if it has none.
+  RCLCPP_PUBLIC
+  std::chrono::nanoseconds
+  get_deadline() const;
+
+  /// Start accounting the thread CPU time used by the callbacks of this callback group.
+  /**
+   * Executors then measure the CPU time of the calling thread around each execution of
+   * an entity of the group, with CLOCK_THREAD_CPUTIME_ID, which costs two clock reads
+   * per execution.
+   * An execution using more CPU time than the budget is counted as an overrun.
+   * The time is only measured on POSIX systems, it's zero on the others.
+   *
+   * \param[in] budget CPU time allowed for one execution, zero for no budget.
+   * \throws std::invalid_argument if the budget is negative.
+   */
+  RCLCPP_PUBLIC
+  void
+  enable_cpu_accounting(std::chrono::nanoseconds budget = std::chrono::nanoseconds::zero());
+
+  /// Stop accounting the CPU time of the callbacks, the statistics are kept.
+  RCLCPP_PUBLIC
+  void
+  disable_cpu_accounting();
+
+  /// Return true if the CPU time of the callbacks of this group is accounted.
+  RCLCPP_PUBLIC
+  bool
+  is_cpu_accounting_enabled() const;
+
+  /// Return the CPU time budget of one execution, zero if there is none.
+  RCLCPP_PUBLIC
+  std::chrono::nanoseconds
+  get_cpu_budget() const;
+
+  /// Return the CPU time accounted since the group was created or last reset.
+  RCLCPP_PUBLIC
+  CallbackGroupCpuStatistics
+  get_cpu_statistics() const;
+
+  /// Reset the accounted CPU time.
+  RCLCPP_PUBLIC
+  void
+  reset_cpu_statistics();
+
+  /// Account the CPU time of one execution, called by the executors.
+  RCLCPP_PUBLIC
+  void
+  record_cpu_time(std::chrono::nanoseconds cpu_time);
+
+  /// Count an execution of an entity of the group as in progress, called by the executors.
+  RCLCPP_PUBLIC
+  void
+  begin_execution();
+
+  /// Count an execution of an entity of the group as done, called by the executors.
+  RCLCPP_PUBLIC
+  void
+  end_execution();
+
+  /// Wait until no entity of the group is being executed.
+  /**
+   * The executions are counted by the executors executing through
+   * rclcpp::Executor::execute_any_executable, and a mutually exclusive group is also
+   * waited for until it can be taken from again.
+   * Removing the group from its executor first ensures no new execution starts, except for
+   * the ones of a reentrant group already taken by another thread but not started yet.
+   * It must not be called from a callback of the group, which would wait for itself.
+   *
+   * \param[in] timeout maximum time to wait, negative to wait without a timeout.
+   * \return true if the group is idle, false if the timeout elapsed first.
+   */
+  RCLCPP_PUBLIC
+  bool
+  wait_for_idle(std::chrono::nanoseconds timeout) const;
+
+  /// Enable or disable the entities of this callback group.
+  /**
+   * Executors don't wait on the entities of a disabled group, so they aren't woken up by
+   * them, and the messages, requests and responses they receive stay queued until the
+   * group is enabled again.
+   * The executors of the group are notified of the change through its notify guard
+   * condition, but the static executors only wait on the notify guard conditions of
+   * nodes, so the node of the group also has to be notified for them.
+   * Groups are enabled by default.
+   *
+   * \param[in] enabled true to enable the group, false to disable it.
+   * \return true if this changed the state of the group.
+   */
+  RCLCPP_PUBLIC
+  bool
+  set_enabled(bool enabled);
+
+  /// Return true if the entities of this callback group are waited on by executors.
+  RCLCPP_PUBLIC
+  bool
+  is_enabled() const;
+
+  /// Return a counter incremented every time an entity is added to or removed from this group.
+  /**
+   * This allows caching the entities of the group until it changes.
+   * Entities that are destroyed without being removed don't change the generation,
+   * so their weak pointers must still be checked.
+   */
+  RCLCPP_PUBLIC
+  uint64_t
+  get_generation() const;
+
   /// Defer creating the notify guard condition and return it.
   RCLCPP_PUBLIC
   rclcpp::GuardCondition::SharedPtr
@@ -229,7 +409,20 @@ protected:
   std::vector<rclcpp::ClientBase::WeakPtr> client_ptrs_;
   std::vector<rclcpp::Waitable::WeakPtr> waitable_ptrs_;
   std::atomic_bool can_be_taken_from_;
+  std::atomic_bool enabled_{true};
   const bool automatically_add_to_executor_with_node_;
+  std::atomic<int> priority_{0};
+  std::atomic<int64_t> deadline_ns_{0};
+  std::atomic_bool cpu_accounting_enabled_{false};
+  std::atomic<int64_t> cpu_budget_ns_{0};
+  std::atomic<uint64_t> cpu_executions_{0};
+  std::atomic<int64_t> cpu_time_ns_{0};
+  std::atomic<int64_t> max_cpu_time_ns_{0};
+  std::atomic<uint64_t> cpu_overruns_{0};
+  std::atomic<size_t> executions_in_progress_{0};
+  std::atomic<uint64_t> generation_{0};
+  // Copy of the entities at a generation, accessed with the atomic functions of shared_ptr
+  mutable std::shared_ptr<const CallbackGroupEntities> entities_;
   // defer the creation of the guard condition
   std::shared_ptr<rclcpp::GuardCondition> notify_guard_condition_ = nullptr;
   std::recursive_mutex notify_guard_condition_mutex_;
@@ -239,7 +432,6 @@ private:
   typename TypeT::SharedPtr _find_ptrs_if_impl(
     Function func, const std::vector<typename TypeT::WeakPtr> & vect_ptrs) const
   {
-    std::lock_guard<std::mutex> lock(mutex_);
     for (auto & weak_ptr : vect_ptrs) {
       auto ref_ptr = weak_ptr.lock();
       if (ref_ptr && func(ref_ptr)) {
@@ -0,0 +1,180 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__CALLBACK_GROUP_MIGRATION_HPP_
+#define RCLCPP__CALLBACK_GROUP_MIGRATION_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "rclcpp/callback_group.hpp"
+#include "rclcpp/executor.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/node_interfaces/node_base_interface.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Move a callback group from an executor to another one, while they may be spinning.
+/**
+ * The group is removed from the source executor, then its executions in progress are
+ * waited for with rclcpp::CallbackGroup::wait_for_idle(), and it's added to the target
+ * executor, so a mutually exclusive group is never executed by both executors at the same
+ * time.
+ * The messages, requests and responses received in between stay queued, and are taken by
+ * the target executor.
+ * Their executions are waited for with the executors executing through
+ * rclcpp::Executor::execute_any_executable and the rclcpp::executors::EventsExecutor, the
+ * static and time triggered executors aren't supported.
+ *
+ * Only the groups added with rclcpp::Executor::add_callback_group() can be moved, so the
+ * group must be created with automatically_add_to_executor_with_node set to false.
+ * It must not be called from a callback of the group, which would wait for itself.
+ *
+ * \param[in] group the callback group to move.
+ * \param[in] node the node the group belongs to.
+ * \param[in] source the executor the group was added to.
+ * \param[in] target the executor the group is added to.
+ * \param[in] timeout maximum time to wait for the group to be idle, negative to wait
+ *   without a timeout.
+ * \return true if the group was moved, false if the timeout elapsed first, then the group is
+ *   added back to the source executor.
+ * \throws std::invalid_argument if group or node is nullptr, or source and target are the
+ *   same executor.
+ * \throws std::runtime_error if the group wasn't added to the source executor.
+ */
+RCLCPP_PUBLIC
+bool
+move_callback_group(
+  rclcpp::CallbackGroup::SharedPtr group,
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node,
+  rclcpp::Executor & source,
+  rclcpp::Executor & target,
+  std::chrono::nanoseconds timeout = std::chrono::nanoseconds(-1));
+
+/// Options of a CallbackGroupBalancer.
+struct CallbackGroupBalancerOptions
+{
+  /// Minimum difference between the busiest and the idlest executor to move a group.
+  /**
+   * It's a ratio of the CPU time used by the busiest executor since the last rebalance,
+   * from 0 to 1.
+   */
+  double min_imbalance_ratio = 0.25;
+
+  /// Maximum time to wait for a group to be idle when moving it, negative for no timeout.
+  std::chrono::nanoseconds move_timeout{std::chrono::milliseconds(100)};
+};
+
+/// Balancer of the CPU time used by callback groups over several executors.
+/**
+ * The CPU time of the groups added to the balancer is accounted with
+ * rclcpp::CallbackGroup::enable_cpu_accounting(), and each call to rebalance() moves at
+ * most one group from the executor whose groups used the most CPU time since the previous
+ * call to the one whose groups used the least, when their difference is large enough.
+ * The group moved is the one getting the two executors the closest to each other.
+ *
+ * The executors are typically spun in threads of their own, and rebalance() called from
+ * a timer of another executor, or from a thread of the application.
+ * Only the executors accounting the CPU time, which are the ones executing through
+ * rclcpp::Executor::execute_any_executable, can be balanced.
+ * \sa rclcpp::move_callback_group
+ */
+class CallbackGroupBalancer
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(CallbackGroupBalancer)
+
+  /// Construct a balancer of the callback groups over the given executors.
+  /**
+   * \param[in] executors the executors the groups are balanced over.
+   * \param[in] options options of the balancer.
+   * \throws std::invalid_argument if there are no executors, one of them is nullptr, or
+   *   the imbalance ratio isn't between 0 and 1.
+   */
+  RCLCPP_PUBLIC
+  explicit CallbackGroupBalancer(
+    std::vector<rclcpp::Executor::SharedPtr> executors,
+    const CallbackGroupBalancerOptions & options = CallbackGroupBalancerOptions());
+
+  /// Add a callback group to one of the executors and balance it from now on.
+  /**
+   * The CPU time of the group is accounted, if it wasn't already.
+   *
+   * \param[in] group the callback group, not added to any executor yet.
+   * \param[in] node the node the group belongs to.
+   * \param[in] executor_index index of the executor the group is added to.
+   * \throws std::invalid_argument if group or node is nullptr, the group is already
+   *   balanced or the index is out of range.
+   */
+  RCLCPP_PUBLIC
+  void
+  add_callback_group(
+    rclcpp::CallbackGroup::SharedPtr group,
+    rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node,
+    size_t executor_index);
+
+  /// Remove a callback group from its executor and stop balancing it.
+  /**
+   * \param[in] group the callback group.
+   * \throws std::invalid_argument if the group isn't balanced.
+   */
+  RCLCPP_PUBLIC
+  void
+  remove_callback_group(rclcpp::CallbackGroup::SharedPtr group);
+
+  /// Return the index of the executor a callback group is currently added to.
+  /**
+   * \param[in] group the callback group.
+   * \throws std::invalid_argument if the group isn't balanced.
+   */
+  RCLCPP_PUBLIC
+  size_t
+  get_executor_index(rclcpp::CallbackGroup::SharedPtr group) const;
+
+  /// Move a group from the busiest executor to the idlest one, if they are imbalanced.
+  /**
+   * The CPU time is the one used by the groups since the previous call, or since they were
+   * added.
+   * It must not be called from a callback of a balanced group.
+   *
+   * \return true if a group was moved.
+   */
+  RCLCPP_PUBLIC
+  bool
+  rebalance();
+
+private:
+  struct BalancedCallbackGroup
+  {
+    rclcpp::CallbackGroup::WeakPtr group;
+    rclcpp::node_interfaces::NodeBaseInterface::WeakPtr node;
+    size_t executor_index;
+    std::chrono::nanoseconds last_cpu_time;
+  };
+
+  std::vector<rclcpp::Executor::SharedPtr> executors_;
+  const CallbackGroupBalancerOptions options_;
+  mutable std::mutex mutex_;
+  std::vector<BalancedCallbackGroup> groups_;
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__CALLBACK_GROUP_MIGRATION_HPP_
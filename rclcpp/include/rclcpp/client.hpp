@@ -16,14 +16,18 @@
 #define RCLCPP__CLIENT_HPP_
 
 #include <atomic>
+#include <chrono>
+#include <functional>
 #include <future>
-#include <unordered_map>
 #include <memory>
 #include <mutex>
 #include <optional>  // NOLINT, cpplint doesn't think this is a cpp std header
+#include <queue>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <variant>  // NOLINT
 #include <vector>
@@ -34,8 +38,11 @@
 #include "rcl/wait.h"
 
 #include "rclcpp/detail/cpp_callback_trampoline.hpp"
+#include "rclcpp/detail/future_waiters.hpp"
+#include "rclcpp/detail/pending_request_table.hpp"
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/expand_topic_or_service_name.hpp"
+#include "rclcpp/experimental/intra_process_services.hpp"
 #include "rclcpp/function_traits.hpp"
 #include "rclcpp/logging.hpp"
 #include "rclcpp/macros.hpp"
@@ -54,6 +61,16 @@ namespace rclcpp
 
 namespace detail
 {
+/// True if CallbackT has the arguments of SignatureT, and isn't a request timeout.
+/**
+ * The timeout is checked first, as function_traits can't be instantiated for a duration.
+ */
+template<typename CallbackT, typename SignatureT>
+struct is_client_callback : std::conjunction<
+    std::negation<std::is_convertible<std::decay_t<CallbackT>, std::chrono::nanoseconds>>,
+    rclcpp::function_traits::same_arguments<CallbackT, SignatureT>>
+{};
+
 template<typename FutureT>
 struct FutureAndRequestId
 {
@@ -130,7 +147,7 @@ public:
     rclcpp::node_interfaces::NodeGraphInterface::SharedPtr node_graph);
 
   RCLCPP_PUBLIC
-  virtual ~ClientBase() = default;
+  virtual ~ClientBase();
 
   /// Take the next response for this client as a type erased pointer.
   /**
@@ -177,6 +194,27 @@ public:
   std::shared_ptr<const rcl_client_t>
   get_client_handle() const;
 
+  /// Send the requests to the intra-process services of the context, when there is one.
+  /**
+   * The requests are then handed over to the service without being serialized,
+   * and the responses come back through the waitable returned by
+   * get_intra_process_waitable(), which has to be added to the callback group of the client.
+   * This is done by rclcpp::create_client() when the node uses intra-process
+   * communications.
+   *
+   * \param[in] self shared pointer to this client, the responses aren't handled anymore
+   *   once it is destroyed.
+   * \return false if the client doesn't have a type support to match the services with.
+   */
+  RCLCPP_PUBLIC
+  bool
+  setup_intra_process(const std::shared_ptr<ClientBase> & self);
+
+  /// Return the waitable handling the intra-process responses, or nullptr if not set up.
+  RCLCPP_PUBLIC
+  rclcpp::Waitable::SharedPtr
+  get_intra_process_waitable() const;
+
   /// Return if the service is ready.
   /**
    * \return `true` if the service is ready, `false` otherwise
@@ -200,6 +238,26 @@ public:
     );
   }
 
+  /// Get notified once the service is available, without blocking nor polling.
+  /**
+   * The availability of the service is checked once now, then once on each
+   * graph change notified by the graph listener, instead of periodically, so
+   * that waiting for many services doesn't load the middleware.
+   * Unlike wait_for_service(), it relies on the middleware notifying a graph change
+   * once the service is available.
+   *
+   * The callback, if any, is called once the service is available, from the
+   * graph listener thread or from this thread if it already is, so it must not block.
+   * Once the returned future completed, the next call waits again.
+   *
+   * \param[in] callback called once the service is available.
+   * \return a future completed once the service is available.
+   * \throws InvalidNodeError if the node of the client was destroyed.
+   */
+  RCLCPP_PUBLIC
+  std::shared_future<void>
+  async_wait_for_service(std::function<void()> callback = nullptr);
+
   virtual std::shared_ptr<void> create_response() = 0;
   virtual std::shared_ptr<rmw_request_id_t> create_request_header() = 0;
   virtual void handle_response(
@@ -355,6 +413,19 @@ protected:
   void
   set_on_new_response_callback(rcl_event_callback_t callback, const void * user_data);
 
+  /// Return the type support of the service, used to match the intra-process services.
+  virtual
+  const rosidl_service_type_support_t *
+  get_intra_process_type_support() const
+  {
+    return nullptr;
+  }
+
+  /// Return the request queue of an intra-process service, or nullptr if there is none.
+  RCLCPP_PUBLIC
+  experimental::IntraProcessServiceQueue::SharedPtr
+  get_intra_process_service_queue() const;
+
   rclcpp::node_interfaces::NodeGraphInterface::WeakPtr node_graph_;
   std::shared_ptr<rcl_node_t> node_handle_;
   std::shared_ptr<rclcpp::Context> context_;
@@ -366,6 +437,15 @@ protected:
 
   std::recursive_mutex callback_mutex_;
   std::function<void(size_t)> on_new_response_callback_{nullptr};
+
+  experimental::IntraProcessServices::SharedPtr intra_process_services_;
+  experimental::IntraProcessServiceQueue::SharedPtr intra_process_queue_;
+  uint64_t intra_process_client_id_{0};
+
+  struct ServiceAvailability;
+  std::mutex service_availability_mutex_;
+  /// Shared by the async_wait_for_service() calls until the service is available.
+  std::shared_ptr<ServiceAvailability> service_availability_;
 };
 
 template<typename ServiceT>
@@ -390,6 +470,7 @@ public:
 
   using CallbackType = std::function<void (SharedFuture)>;
   using CallbackWithRequestType = std::function<void (SharedFutureWithRequest)>;
+  using ResponseCallbackType = std::function<void (SharedResponse)>;
 
   RCLCPP_SMART_PTR_DEFINITIONS(Client)
 
@@ -451,6 +532,22 @@ public:
     >::FutureAndRequestId;
   };
 
+  using Responses = std::vector<SharedResponse>;
+  using SharedFutureResponses = std::shared_future<Responses>;
+
+  /// The future of a batch of requests sent with async_send_requests(), and their ids.
+  /**
+   * Public members:
+   * - future: a std::shared_future<Responses>, holding the responses in the order of
+   *   the requests, nullptr for the ones not received yet when it completed.
+   * - request_ids: the ids of the requests, in the same order.
+   */
+  struct BatchFutureAndRequestIds
+  {
+    SharedFutureResponses future;
+    std::vector<int64_t> request_ids;
+  };
+
   /// Default constructor.
   /**
    * The constructor for a Client is almost never called directly.
@@ -559,13 +656,18 @@ public:
     if (std::holds_alternative<Promise>(value)) {
       auto & promise = std::get<Promise>(value);
       promise.set_value(std::move(typed_response));
+      rclcpp::detail::notify_future_waiters();
     } else if (std::holds_alternative<CallbackTypeValueVariant>(value)) {
       auto & inner = std::get<CallbackTypeValueVariant>(value);
       const auto & callback = std::get<CallbackType>(inner);
       auto & promise = std::get<Promise>(inner);
       auto & future = std::get<SharedFuture>(inner);
       promise.set_value(std::move(typed_response));
+      rclcpp::detail::notify_future_waiters();
       callback(std::move(future));
+    } else if (std::holds_alternative<ResponseCallbackType>(value)) {
+      const auto & callback = std::get<ResponseCallbackType>(value);
+      callback(std::move(typed_response));
     } else if (std::holds_alternative<CallbackWithRequestTypeValueVariant>(value)) {
       auto & inner = std::get<CallbackWithRequestTypeValueVariant>(value);
       const auto & callback = std::get<CallbackWithRequestType>(inner);
@@ -573,6 +675,7 @@ public:
       auto & future = std::get<SharedFutureWithRequest>(inner);
       auto & request = std::get<SharedRequest>(inner);
       promise.set_value(std::make_pair(std::move(request), std::move(typed_response)));
+      rclcpp::detail::notify_future_waiters();
       callback(std::move(future));
     }
   }
@@ -607,12 +710,31 @@ public:
    */
   FutureAndRequestId
   async_send_request(SharedRequest request)
+  {
+    return async_send_request(std::move(request), no_request_timeout);
+  }
+
+  /// Send a request to the service server, which times out if no response is received.
+  /**
+   * Once the timeout expired, the request is removed and its future completed with
+   * a rclcpp::exceptions::RequestTimeoutError exception, thrown by its get() method.
+   * It's done by expire_timed_out_requests(), usually called by the timer returned by
+   * rclcpp::create_request_timeout_timer(), so that the request doesn't have to be removed.
+   *
+   * \param[in] request request to be send.
+   * \param[in] timeout time after which the request is given up, negative for no timeout.
+   * \return a FutureAndRequestId instance.
+   */
+  FutureAndRequestId
+  async_send_request(SharedRequest request, std::chrono::nanoseconds timeout)
   {
     Promise promise;
     auto future = promise.get_future();
     auto req_id = async_send_request_impl(
       *request,
-      std::move(promise));
+      std::move(promise),
+      request,
+      timeout);
     return FutureAndRequestId(std::move(future), req_id);
   }
 
@@ -627,21 +749,28 @@ public:
    * In this case, it's convenient to setup a timer to cleanup the pending requests.
    * See for example the `examples_rclcpp_async_client` package in https://github.com/ros2/examples.
    *
+   * If a timeout is given, the callback is called with a future holding a
+   * rclcpp::exceptions::RequestTimeoutError exception once it expired, as with
+   * async_send_request(SharedRequest, std::chrono::nanoseconds).
+   *
    * \param[in] request request to be send.
    * \param[in] cb callback that will be called when we get a response for this request.
+   * \param[in] timeout time after which the request is given up, negative for no timeout.
    * \return the request id representing the request just sent.
    */
   template<
     typename CallbackT,
     typename std::enable_if<
-      rclcpp::function_traits::same_arguments<
+      detail::is_client_callback<
         CallbackT,
         CallbackType
       >::value
     >::type * = nullptr
   >
   SharedFutureAndRequestId
-  async_send_request(SharedRequest request, CallbackT && cb)
+  async_send_request(
+    SharedRequest request, CallbackT && cb,
+    std::chrono::nanoseconds timeout = no_request_timeout)
   {
     Promise promise;
     auto shared_future = promise.get_future().share();
@@ -650,7 +779,9 @@ public:
       std::make_tuple(
         CallbackType{std::forward<CallbackT>(cb)},
         shared_future,
-        std::move(promise)));
+        std::move(promise)),
+      request,
+      timeout);
     return SharedFutureAndRequestId{std::move(shared_future), req_id};
   }
 
@@ -660,19 +791,22 @@ public:
    *
    * \param[in] request request to be send.
    * \param[in] cb callback that will be called when we get a response for this request.
+   * \param[in] timeout time after which the request is given up, negative for no timeout.
    * \return the request id representing the request just sent.
    */
   template<
     typename CallbackT,
     typename std::enable_if<
-      rclcpp::function_traits::same_arguments<
+      detail::is_client_callback<
         CallbackT,
         CallbackWithRequestType
       >::value
     >::type * = nullptr
   >
   SharedFutureWithRequestAndRequestId
-  async_send_request(SharedRequest request, CallbackT && cb)
+  async_send_request(
+    SharedRequest request, CallbackT && cb,
+    std::chrono::nanoseconds timeout = no_request_timeout)
   {
     PromiseWithRequest promise;
     auto shared_future = promise.get_future().share();
@@ -682,10 +816,163 @@ public:
         CallbackWithRequestType{std::forward<CallbackT>(cb)},
         request,
         shared_future,
-        std::move(promise)));
+        std::move(promise)),
+      request,
+      timeout);
     return SharedFutureWithRequestAndRequestId{std::move(shared_future), req_id};
   }
 
+  /// Send a request to the service server and call a callback with the response.
+  /**
+   * Unlike the overloads taking a callback with a future, no promise is
+   * created, so sending the request doesn't allocate memory, except for a
+   * callback too large to be stored inline by std::function.
+   *
+   * As with the other overloads, the request has to be removed with
+   * remove_pending_request() or pruned if no response is ever received,
+   * unless a timeout is given, the callback being then called with nullptr once it expired.
+   *
+   * \param[in] request request to be send.
+   * \param[in] cb callback called with the response, from the executor.
+   * \param[in] timeout time after which the request is given up, negative for no timeout.
+   * \return the request id representing the request just sent.
+   */
+  template<
+    typename CallbackT,
+    typename std::enable_if<
+      detail::is_client_callback<
+        CallbackT,
+        ResponseCallbackType
+      >::value
+    >::type * = nullptr
+  >
+  int64_t
+  async_send_request(
+    const Request & request, CallbackT && cb,
+    std::chrono::nanoseconds timeout = no_request_timeout)
+  {
+    return async_send_request_impl(
+      request,
+      ResponseCallbackType{std::forward<CallbackT>(cb)},
+      nullptr,
+      timeout);
+  }
+
+  /// Send a request to the service server and call a callback with the response.
+  /**
+   * Convenient overload, same as:
+   *
+   * `Client::async_send_request(*request, cb, timeout)`.
+   */
+  template<
+    typename CallbackT,
+    typename std::enable_if<
+      detail::is_client_callback<
+        CallbackT,
+        ResponseCallbackType
+      >::value
+    >::type * = nullptr
+  >
+  int64_t
+  async_send_request(
+    SharedRequest request, CallbackT && cb,
+    std::chrono::nanoseconds timeout = no_request_timeout)
+  {
+    return async_send_request_impl(
+      *request,
+      ResponseCallbackType{std::forward<CallbackT>(cb)},
+      request,
+      timeout);
+  }
+
+  /// Send a batch of requests, with a single future for their responses.
+  /**
+   * Instead of spinning until the future of each request completes, the future of
+   * the batch is spun on once, e.g. with Executor::spin_until_future_complete().
+   * It completes once the given number of responses arrived, the number of requests
+   * to wait for all of them or 1 for any of them.
+   *
+   * The callback, if any, is called with the index of each request in the batch
+   * and its response as they arrive, including the ones arriving after the future completed.
+   *
+   * The requests which never got a response have to be removed with
+   * remove_pending_requests() or pruned with prune_requests_older_than(),
+   * unless a timeout is given, the requests timing out counting as responses set to nullptr.
+   *
+   * ```cpp
+   * auto batch = client->async_send_requests(requests, requests.size());
+   * if (
+   *   rclcpp::FutureReturnCode::TIMEOUT ==
+   *   executor->spin_until_future_complete(batch.future, timeout))
+   * {
+   *   client->remove_pending_requests(batch);
+   * }
+   * ```
+   *
+   * \param[in] requests requests to be sent.
+   * \param[in] number_of_responses number of responses completing the future.
+   * \param[in] on_response callback called with the index of the request and its response.
+   * \param[in] timeout time after which each request is given up, negative for no timeout.
+   * \return the future of the batch and the ids of its requests.
+   * \throws std::invalid_argument if more responses than requests are awaited.
+   * \throws rclcpp::exceptions::RCLError if sending a request fails, the requests
+   *   already sent being removed.
+   */
+  BatchFutureAndRequestIds
+  async_send_requests(
+    const std::vector<SharedRequest> & requests,
+    size_t number_of_responses,
+    std::function<void(size_t, SharedResponse)> on_response = nullptr,
+    std::chrono::nanoseconds timeout = no_request_timeout)
+  {
+    if (number_of_responses > requests.size()) {
+      throw std::invalid_argument("a batch can't await more responses than it has requests");
+    }
+    auto batch = std::make_shared<Batch>(
+      requests.size(), number_of_responses, std::move(on_response));
+    BatchFutureAndRequestIds result;
+    result.future = batch->promise.get_future().share();
+    if (number_of_responses == 0) {
+      batch->promise.set_value(Responses(requests.size()));
+    }
+    result.request_ids.reserve(requests.size());
+    try {
+      for (size_t i = 0; i < requests.size(); ++i) {
+        result.request_ids.push_back(
+          async_send_request_impl(
+            *requests[i],
+            ResponseCallbackType{
+              [batch, i](SharedResponse response) {
+                batch->add_response(i, std::move(response));
+              }},
+            requests[i],
+            timeout));
+      }
+    } catch (...) {
+      remove_pending_requests(result);
+      throw;
+    }
+    return result;
+  }
+
+  /// Cleanup the pending requests of a batch.
+  /**
+   * \param[in] batch future and request ids returned by async_send_requests().
+   * \return number of pending requests that were removed.
+   */
+  size_t
+  remove_pending_requests(const BatchFutureAndRequestIds & batch)
+  {
+    std::lock_guard guard(pending_requests_mutex_);
+    size_t removed = 0;
+    for (int64_t request_id : batch.request_ids) {
+      if (pending_requests_.erase(request_id)) {
+        removed++;
+      }
+    }
+    return removed;
+  }
+
   /// Cleanup a pending request.
   /**
    * This notifies the client that we have waited long enough for a response from the server
@@ -701,7 +988,7 @@ public:
   remove_pending_request(int64_t request_id)
   {
     std::lock_guard guard(pending_requests_mutex_);
-    return pending_requests_.erase(request_id) != 0u;
+    return pending_requests_.erase(request_id);
   }
 
   /// Cleanup a pending request.
@@ -748,9 +1035,8 @@ public:
   prune_pending_requests()
   {
     std::lock_guard guard(pending_requests_mutex_);
-    auto ret = pending_requests_.size();
-    pending_requests_.clear();
-    return ret;
+    request_deadlines_ = RequestDeadlines();
+    return pending_requests_.clear();
   }
 
   /// Clean all pending requests older than a time_point.
@@ -767,21 +1053,54 @@ public:
     std::vector<int64_t, AllocatorT> * pruned_requests = nullptr)
   {
     std::lock_guard guard(pending_requests_mutex_);
-    auto old_size = pending_requests_.size();
-    for (auto it = pending_requests_.begin(), last = pending_requests_.end(); it != last; ) {
-      if (it->second.first < time_point) {
+    return pending_requests_.erase_if(
+      [time_point, pruned_requests](
+        int64_t request_id, std::chrono::time_point<std::chrono::system_clock> request_time) {
+        if (request_time >= time_point) {
+          return false;
+        }
         if (pruned_requests) {
-          pruned_requests->push_back(it->first);
+          pruned_requests->push_back(request_id);
+        }
+        return true;
+      });
+  }
+
+  /// Complete the requests whose timeout expired, see async_send_request().
+  /**
+   * The requests are kept ordered by deadline, so that each expired request is found
+   * in logarithmic time, and nothing is done until the earliest deadline is reached.
+   * This is usually called by the timer returned by rclcpp::create_request_timeout_timer().
+   *
+   * \return number of requests which timed out.
+   */
+  size_t
+  expire_timed_out_requests()
+  {
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<CallbackInfoVariant> timed_out_requests;
+    {
+      std::lock_guard guard(pending_requests_mutex_);
+      while (!request_deadlines_.empty() && request_deadlines_.top().first <= now) {
+        // The requests which got their response since are gone from the pending requests.
+        auto value = pending_requests_.take(request_deadlines_.top().second);
+        request_deadlines_.pop();
+        if (value) {
+          timed_out_requests.push_back(std::move(*value));
         }
-        it = pending_requests_.erase(it);
-      } else {
-        ++it;
       }
     }
-    return old_size - pending_requests_.size();
+    // The callbacks are called without the lock, as they may send new requests.
+    for (auto & value : timed_out_requests) {
+      complete_timed_out_request(value);
+    }
+    return timed_out_requests.size();
   }
 
 protected:
+  /// Timeout of the requests which are never given up.
+  static constexpr std::chrono::nanoseconds no_request_timeout{-1};
+
   using CallbackTypeValueVariant = std::tuple<CallbackType, SharedFuture, Promise>;
   using CallbackWithRequestTypeValueVariant = std::tuple<
     CallbackWithRequestType, SharedRequest, SharedFutureWithRequest, PromiseWithRequest>;
@@ -789,20 +1108,67 @@ protected:
   using CallbackInfoVariant = std::variant<
     std::promise<SharedResponse>,
     CallbackTypeValueVariant,
-    CallbackWithRequestTypeValueVariant>;
+    CallbackWithRequestTypeValueVariant,
+    ResponseCallbackType>;
 
+  const rosidl_service_type_support_t *
+  get_intra_process_type_support() const override
+  {
+    return rosidl_typesupport_cpp::get_service_type_support_handle<ServiceT>();
+  }
+
+  /// Send a request, the shared one being handed over to an intra-process service if given.
   int64_t
-  async_send_request_impl(const Request & request, CallbackInfoVariant value)
+  async_send_request_impl(
+    const Request & request,
+    CallbackInfoVariant value,
+    SharedRequest shared_request = nullptr,
+    std::chrono::nanoseconds timeout = no_request_timeout)
   {
+    if (intra_process_queue_) {
+      auto service_queue = get_intra_process_service_queue();
+      if (service_queue) {
+        return async_send_intra_process_request(
+          service_queue, request, std::move(value), std::move(shared_request), timeout);
+      }
+    }
     int64_t sequence_number;
     std::lock_guard<std::mutex> lock(pending_requests_mutex_);
     rcl_ret_t ret = rcl_send_request(get_client_handle().get(), &request, &sequence_number);
     if (RCL_RET_OK != ret) {
       rclcpp::exceptions::throw_from_rcl_error(ret, "failed to send request");
     }
-    pending_requests_.try_emplace(
-      sequence_number,
-      std::make_pair(std::chrono::system_clock::now(), std::move(value)));
+    pending_requests_.emplace(
+      sequence_number, std::chrono::system_clock::now(), std::move(value));
+    add_request_deadline(sequence_number, timeout);
+    return sequence_number;
+  }
+
+  int64_t
+  async_send_intra_process_request(
+    const experimental::IntraProcessServiceQueue::SharedPtr & service_queue,
+    const Request & request,
+    CallbackInfoVariant value,
+    SharedRequest shared_request,
+    std::chrono::nanoseconds timeout)
+  {
+    if (!shared_request) {
+      shared_request = std::make_shared<Request>(request);
+    }
+    int64_t sequence_number;
+    {
+      std::lock_guard<std::mutex> lock(pending_requests_mutex_);
+      // Negative, so they never collide with the sequence numbers of the middleware.
+      sequence_number = next_intra_process_sequence_number_--;
+      pending_requests_.emplace(
+        sequence_number, std::chrono::system_clock::now(), std::move(value));
+      add_request_deadline(sequence_number, timeout);
+    }
+    // Pushed once pending, as the response may come back before this returns.
+    service_queue->push(
+      experimental::IntraProcessServices::make_request_id(
+        intra_process_client_id_, sequence_number),
+      std::move(shared_request));
     return sequence_number;
   }
 
@@ -810,27 +1176,98 @@ protected:
   get_and_erase_pending_request(int64_t request_number)
   {
     std::unique_lock<std::mutex> lock(pending_requests_mutex_);
-    auto it = this->pending_requests_.find(request_number);
-    if (it == this->pending_requests_.end()) {
+    auto value = this->pending_requests_.take(request_number);
+    if (!value) {
       RCUTILS_LOG_DEBUG_NAMED(
         "rclcpp",
         "Received invalid sequence number. Ignoring...");
-      return std::nullopt;
     }
-    auto value = std::move(it->second.second);
-    this->pending_requests_.erase(request_number);
     return value;
   }
 
+  /// Add the deadline of a request, with pending_requests_mutex_ locked.
+  void
+  add_request_deadline(int64_t sequence_number, std::chrono::nanoseconds timeout)
+  {
+    if (timeout >= std::chrono::nanoseconds::zero()) {
+      request_deadlines_.emplace(std::chrono::steady_clock::now() + timeout, sequence_number);
+    }
+  }
+
+  /// Complete a request which timed out, as handle_response() does with a response.
+  void
+  complete_timed_out_request(CallbackInfoVariant & value)
+  {
+    auto make_error = []() {
+        return std::make_exception_ptr(
+          rclcpp::exceptions::RequestTimeoutError("the service request timed out"));
+      };
+    if (std::holds_alternative<Promise>(value)) {
+      std::get<Promise>(value).set_exception(make_error());
+      rclcpp::detail::notify_future_waiters();
+    } else if (std::holds_alternative<CallbackTypeValueVariant>(value)) {
+      auto & inner = std::get<CallbackTypeValueVariant>(value);
+      std::get<Promise>(inner).set_exception(make_error());
+      rclcpp::detail::notify_future_waiters();
+      std::get<CallbackType>(inner)(std::move(std::get<SharedFuture>(inner)));
+    } else if (std::holds_alternative<ResponseCallbackType>(value)) {
+      std::get<ResponseCallbackType>(value)(nullptr);
+    } else if (std::holds_alternative<CallbackWithRequestTypeValueVariant>(value)) {
+      auto & inner = std::get<CallbackWithRequestTypeValueVariant>(value);
+      std::get<PromiseWithRequest>(inner).set_exception(make_error());
+      rclcpp::detail::notify_future_waiters();
+      std::get<CallbackWithRequestType>(inner)(
+        std::move(std::get<SharedFutureWithRequest>(inner)));
+    }
+  }
+
+  /// Responses of a batch of requests, shared by the callbacks of its requests.
+  struct Batch
+  {
+    Batch(
+      size_t number_of_requests,
+      size_t number_of_responses,
+      std::function<void(size_t, SharedResponse)> on_response)
+    : responses(number_of_requests),
+      remaining(number_of_responses),
+      on_response(std::move(on_response))
+    {}
+
+    void
+    add_response(size_t index, SharedResponse response)
+    {
+      if (on_response) {
+        on_response(index, response);
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      responses[index] = std::move(response);
+      if (remaining > 0 && --remaining == 0) {
+        promise.set_value(responses);
+      }
+    }
+
+    std::mutex mutex;
+    Responses responses;
+    size_t remaining;
+    std::promise<Responses> promise;
+    std::function<void(size_t, SharedResponse)> on_response;
+  };
+
   RCLCPP_DISABLE_COPY(Client)
 
-  std::unordered_map<
-    int64_t,
-    std::pair<
-      std::chrono::time_point<std::chrono::system_clock>,
-      CallbackInfoVariant>>
-  pending_requests_;
+  /// The sequence numbers increase, so the slots of the answered requests are reused.
+  detail::PendingRequestTable<CallbackInfoVariant> pending_requests_;
   std::mutex pending_requests_mutex_;
+
+  /// Deadlines of the requests sent with a timeout, the earliest one first.
+  /**
+   * The deadlines of the requests answered before are only removed once reached.
+   */
+  using RequestDeadline = std::pair<std::chrono::steady_clock::time_point, int64_t>;
+  using RequestDeadlines = std::priority_queue<
+    RequestDeadline, std::vector<RequestDeadline>, std::greater<RequestDeadline>>;
+  RequestDeadlines request_deadlines_;
+  int64_t next_intra_process_sequence_number_{-1};
 };
 
 }  // namespace rclcpp
@@ -0,0 +1,133 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__CONTEXTS__CONTEXT_SHARDS_HPP_
+#define RCLCPP__CONTEXTS__CONTEXT_SHARDS_HPP_
+
+#include <string>
+#include <vector>
+
+#include "rclcpp/context.hpp"
+#include "rclcpp/init_options.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/node_options.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace contexts
+{
+
+/// Contexts the nodes of a process are spread over, so that they use several participants.
+/**
+ * Each context has its own middleware participant, with its own receive threads and
+ * discovery database, so spreading many nodes over a few contexts lets the middleware
+ * receive their messages in parallel.
+ * The contexts share the intra process manager of their domain, so the publishers and
+ * subscriptions using intra process communication still exchange their messages without
+ * copies across contexts, see rclcpp::InitOptions::share_intra_process_manager().
+ * The other entities of nodes in different contexts communicate through the middleware.
+ *
+ * The context of a node is chosen from its name and namespace, so a node always gets the
+ * same one, and the options to construct it are given by node_options(), for example:
+ *
+ * ```cpp
+ * auto shards = std::make_shared<rclcpp::contexts::ContextShards>(4, argc, argv);
+ * auto node = std::make_shared<rclcpp::Node>(
+ *   "talker", "/demo", shards->node_options("talker", "/demo"));
+ * ```
+ *
+ * An executor can spin nodes of different contexts, but it stops when the context it was
+ * constructed with is shut down.
+ * The contexts are shut down when the shards are destroyed.
+ */
+class ContextShards
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(ContextShards)
+
+  /// Create and initialize the contexts.
+  /**
+   * \param[in] number_of_shards number of contexts, or 0 to use one per hardware thread.
+   * \param[in] argc number of command-line arguments, given to all the contexts.
+   * \param[in] argv command-line arguments, given to all the contexts.
+   * \param[in] init_options initialization options of all the contexts, which always share
+   *   their intra process manager.
+   * \throws anything rclcpp::Context::init() can throw.
+   */
+  RCLCPP_PUBLIC
+  ContextShards(
+    size_t number_of_shards,
+    int argc,
+    char const * const * argv,
+    const rclcpp::InitOptions & init_options = rclcpp::InitOptions());
+
+  RCLCPP_PUBLIC
+  ~ContextShards();
+
+  /// Return the number of contexts.
+  RCLCPP_PUBLIC
+  size_t
+  size() const;
+
+  /// Return the contexts.
+  RCLCPP_PUBLIC
+  const std::vector<rclcpp::Context::SharedPtr> &
+  get_contexts() const;
+
+  /// Return a context.
+  /**
+   * \throws std::out_of_range if the index isn't less than size().
+   */
+  RCLCPP_PUBLIC
+  rclcpp::Context::SharedPtr
+  get_context(size_t index) const;
+
+  /// Return the context of a node, chosen from its name and namespace.
+  RCLCPP_PUBLIC
+  rclcpp::Context::SharedPtr
+  get_context_for_node(const std::string & node_name, const std::string & namespace_ = "") const;
+
+  /// Return options to construct a node in its context.
+  /**
+   * \param[in] node_name name of the node.
+   * \param[in] namespace_ namespace of the node.
+   * \param[in] options options of the node, whose context is replaced.
+   */
+  RCLCPP_PUBLIC
+  rclcpp::NodeOptions
+  node_options(
+    const std::string & node_name,
+    const std::string & namespace_ = "",
+    rclcpp::NodeOptions options = rclcpp::NodeOptions()) const;
+
+  /// Shut down all the contexts.
+  /**
+   * \return true if all the contexts were shut down by this call.
+   */
+  RCLCPP_PUBLIC
+  bool
+  shutdown(const std::string & reason);
+
+private:
+  RCLCPP_DISABLE_COPY(ContextShards)
+
+  std::vector<rclcpp::Context::SharedPtr> contexts_;
+};
+
+}  // namespace contexts
+}  // namespace rclcpp
+
+#endif  // RCLCPP__CONTEXTS__CONTEXT_SHARDS_HPP_
@@ -15,11 +15,19 @@
 #ifndef RCLCPP__CREATE_CLIENT_HPP_
 #define RCLCPP__CREATE_CLIENT_HPP_
 
+#include <chrono>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <utility>
 
+#include "rclcpp/client.hpp"
+#include "rclcpp/create_timer.hpp"
+#include "rclcpp/node_interfaces/get_node_base_interface.hpp"
+#include "rclcpp/node_interfaces/get_node_timers_interface.hpp"
 #include "rclcpp/node_interfaces/node_base_interface.hpp"
 #include "rclcpp/node_interfaces/node_services_interface.hpp"
+#include "rclcpp/node_interfaces/node_timers_interface.hpp"
 #include "rclcpp/qos.hpp"
 #include "rmw/rmw.h"
 
@@ -81,6 +89,66 @@ create_client(
   return cli;
 }
 
+/// Create a timer completing the requests of a client once their timeout expired.
+/**
+ * The requests sent with a timeout are then completed by the executor, the timer calling
+ * Client::expire_timed_out_requests() until the client is destroyed.
+ * The timer has to be kept alive, as for the other timers of a node.
+ *
+ * \param[in] node_base NodeBaseInterface implementation of the node of the client.
+ * \param[in] node_timers NodeTimersInterface implementation of the node of the client.
+ * \param[in] client the client.
+ * \param[in] resolution period of the timer, the delay after which a request is
+ *   given up being at most this long after its timeout.
+ * \param[in] group Callback group of the timer, usually the one of the client.
+ * \return Shared pointer to the created timer.
+ */
+template<typename ServiceT>
+rclcpp::TimerBase::SharedPtr
+create_request_timeout_timer(
+  std::shared_ptr<node_interfaces::NodeBaseInterface> node_base,
+  std::shared_ptr<node_interfaces::NodeTimersInterface> node_timers,
+  typename rclcpp::Client<ServiceT>::SharedPtr client,
+  std::chrono::nanoseconds resolution = std::chrono::milliseconds(10),
+  rclcpp::CallbackGroup::SharedPtr group = nullptr)
+{
+  if (!client) {
+    throw std::invalid_argument("the client of a request timeout timer can't be null");
+  }
+  std::weak_ptr<rclcpp::Client<ServiceT>> weak_client = client;
+  return rclcpp::create_wall_timer(
+    resolution,
+    [weak_client]() {
+      auto client = weak_client.lock();
+      if (client) {
+        client->expire_timed_out_requests();
+      }
+    },
+    group,
+    node_base.get(),
+    node_timers.get());
+}
+
+/// Create a timer completing the requests of a client once their timeout expired.
+/**
+ * Convenient overload taking a node, see the one taking its interfaces.
+ */
+template<typename ServiceT, typename NodeT>
+rclcpp::TimerBase::SharedPtr
+create_request_timeout_timer(
+  NodeT node,
+  typename rclcpp::Client<ServiceT>::SharedPtr client,
+  std::chrono::nanoseconds resolution = std::chrono::milliseconds(10),
+  rclcpp::CallbackGroup::SharedPtr group = nullptr)
+{
+  return create_request_timeout_timer<ServiceT>(
+    rclcpp::node_interfaces::get_node_base_interface(node),
+    rclcpp::node_interfaces::get_node_timers_interface(node),
+    std::move(client),
+    resolution,
+    group);
+}
+
 }  // namespace rclcpp
 
 #endif  // RCLCPP__CREATE_CLIENT_HPP_
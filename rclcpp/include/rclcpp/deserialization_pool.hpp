@@ -0,0 +1,90 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__DESERIALIZATION_POOL_HPP_
+#define RCLCPP__DESERIALIZATION_POOL_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Threads deserializing the large messages of subscriptions, instead of their executor.
+/**
+ * A subscription given a pool with SubscriptionOptionsBase::deserialization_pool still
+ * takes its messages on the thread of its executor, serialized, and the pool deserializes
+ * them.
+ * The callback is then called by the executor, in its callback group, once the message is
+ * deserialized, and the messages of a subscription are given to it in the order they were
+ * taken.
+ * This keeps the executor from being blocked by the deserialization of large messages,
+ * such as point clouds, while it has small messages with latency-critical callbacks.
+ *
+ * A pool can be shared by the subscriptions of any number of nodes and executors.
+ * The tasks are executed in the order they were submitted, by the first thread available.
+ */
+class DeserializationPool
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(DeserializationPool)
+
+  /// Constructor, starting the threads.
+  /**
+   * \param[in] number_of_threads number of threads, or 0 for one per hardware thread.
+   */
+  RCLCPP_PUBLIC
+  explicit DeserializationPool(size_t number_of_threads = 0);
+
+  /// Destructor, executing the tasks submitted before and joining the threads.
+  RCLCPP_PUBLIC
+  ~DeserializationPool();
+
+  /// Queue a task, executed by one of the threads.
+  /**
+   * \throws std::invalid_argument if the task is empty.
+   */
+  RCLCPP_PUBLIC
+  void
+  submit(std::function<void()> task);
+
+  /// Return the number of threads.
+  RCLCPP_PUBLIC
+  size_t
+  get_number_of_threads() const;
+
+private:
+  RCLCPP_DISABLE_COPY(DeserializationPool)
+
+  void
+  run();
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<std::function<void()>> tasks_;
+  bool stopped_ = false;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DESERIALIZATION_POOL_HPP_
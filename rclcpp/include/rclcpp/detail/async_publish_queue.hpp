@@ -0,0 +1,115 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__DETAIL__ASYNC_PUBLISH_QUEUE_HPP_
+#define RCLCPP__DETAIL__ASYNC_PUBLISH_QUEUE_HPP_
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "rclcpp/async_publish_writer.hpp"
+#include "rclcpp/experimental/buffers/buffer_implementation_base.hpp"
+#include "rclcpp/experimental/buffers/lock_free_ring_buffer_implementation.hpp"
+#include "rclcpp/macros.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Lock-free queue of the messages of a publisher, published by an AsyncPublishWriter.
+/**
+ * The messages are either owned by the queue, or shared with the intra-process
+ * subscriptions.
+ * When the queue is full, the oldest message is dropped by the thread queuing a new one.
+ *
+ * \tparam MessageT the ROS message type of the publisher
+ * \tparam DeleterT the deleter of the messages allocated by the publisher
+ */
+template<typename MessageT, typename DeleterT>
+class AsyncPublishQueue : public rclcpp::AsyncPublishWriter::QueueBase
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(AsyncPublishQueue)
+
+  using PublishFunction = std::function<void (const MessageT &)>;
+
+  /// Constructor.
+  /**
+   * \param[in] capacity maximum number of queued messages.
+   * \param[in] publish function publishing a message to the middleware.
+   * \throws std::invalid_argument if the capacity is 0.
+   */
+  AsyncPublishQueue(size_t capacity, PublishFunction publish)
+  : capacity_(capacity), buffer_(capacity), publish_(std::move(publish))
+  {}
+
+  /// Queue a message owned by the queue.
+  void
+  push(std::unique_ptr<MessageT, DeleterT> message)
+  {
+    buffer_.enqueue(Item{std::move(message), nullptr});
+  }
+
+  /// Queue a message shared with the intra-process subscriptions.
+  void
+  push(std::shared_ptr<const MessageT> message)
+  {
+    buffer_.enqueue(Item{nullptr, std::move(message)});
+  }
+
+  size_t
+  publish_queued() override
+  {
+    // At most one lap, so that the other queues of the writer aren't delayed indefinitely.
+    size_t number_of_messages = 0;
+    while (number_of_messages < capacity_ && buffer_.has_data()) {
+      Item item = buffer_.dequeue();
+      ++number_of_messages;
+      if (item.owned_message) {
+        publish_(*item.owned_message);
+      } else if (item.shared_message) {
+        publish_(*item.shared_message);
+      }
+    }
+    return number_of_messages;
+  }
+
+  /// Get the occupancy of the queue, and the number of messages dropped when it was full.
+  rclcpp::experimental::buffers::BufferCounters
+  get_counters() const
+  {
+    return buffer_.get_counters();
+  }
+
+private:
+  RCLCPP_DISABLE_COPY(AsyncPublishQueue)
+
+  struct Item
+  {
+    std::unique_ptr<MessageT, DeleterT> owned_message;
+    std::shared_ptr<const MessageT> shared_message;
+  };
+
+  const size_t capacity_;
+  rclcpp::experimental::buffers::LockFreeRingBufferImplementation<Item, true> buffer_;
+  PublishFunction publish_;
+};
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__ASYNC_PUBLISH_QUEUE_HPP_
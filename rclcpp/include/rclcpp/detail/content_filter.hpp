@@ -0,0 +1,113 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__DETAIL__CONTENT_FILTER_HPP_
+#define RCLCPP__DETAIL__CONTENT_FILTER_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rcl/types.h"
+#include "rosidl_runtime_c/message_type_support_struct.h"
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Content filter expression compiled for a message type, evaluated on ROS messages.
+/**
+ * It evaluates the expressions of the content filtered topics in the process, for the
+ * messages which don't go through the middleware.
+ * The expressions are compiled once, and they are made of the following subset of the DDS
+ * filter grammar, whose keywords aren't case-sensitive:
+ *
+ * - the conditions `NOT`, `AND` and `OR`, by decreasing precedence, and parentheses,
+ * - the comparisons `=`, `<>`, `!=`, `<`, `<=`, `>`, `>=` and `LIKE`, whose patterns
+ *   match any characters with `%` and one character with `_`,
+ * - `BETWEEN` and `NOT BETWEEN` followed by two values separated by `AND`,
+ * - the fields of the message, of its nested messages, and the elements of their arrays,
+ *   such as `header.frame_id` or `points[0].x`,
+ * - integers, floating point numbers, strings between single quotes, `TRUE` and `FALSE`,
+ *   and the expression parameters `%0` to `%99`, which are parsed as such values.
+ *
+ * A comparison with an element past the end of a sequence is false.
+ *
+ * The expressions whose fields are only preceded by fields of fixed size, such as numbers
+ * and arrays of numbers, can also be evaluated on the messages serialized with plain CDR,
+ * which is the encoding of the messages of the ROS 2 middlewares, without deserializing them.
+ */
+class ContentFilter
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(ContentFilter)
+
+  /// Compile a filter expression.
+  /**
+   * \param[in] type_support type support of the messages, from which their introspection
+   *   type support is loaded.
+   * \param[in] filter_expression filter expression.
+   * \param[in] expression_parameters values of the parameters of the expression.
+   * \throws std::invalid_argument if the expression isn't supported or doesn't match the
+   *   message type, or if the introspection type support of the messages isn't available.
+   */
+  RCLCPP_PUBLIC
+  ContentFilter(
+    const rosidl_message_type_support_t & type_support,
+    const std::string & filter_expression,
+    const std::vector<std::string> & expression_parameters);
+
+  RCLCPP_PUBLIC
+  ~ContentFilter();
+
+  /// Return true if a ROS message of the type of the filter matches it.
+  RCLCPP_PUBLIC
+  bool
+  evaluate(const void * ros_message) const;
+
+  /// Return true if the fields of the expression have fixed offsets in the serialized messages.
+  RCLCPP_PUBLIC
+  bool
+  can_evaluate_serialized() const;
+
+  /// Evaluate the expression on a serialized message of the type of the filter.
+  /**
+   * \param[in] serialized_message message serialized with plain CDR.
+   * \param[out] matches true if the message matches the filter.
+   * \return false if the message has to be deserialized to be evaluated, because the
+   *   fields of the expression don't have fixed offsets or it has another encoding.
+   */
+  RCLCPP_PUBLIC
+  bool
+  evaluate_serialized(const rcl_serialized_message_t & serialized_message, bool & matches) const;
+
+  struct Condition;
+
+private:
+  RCLCPP_DISABLE_COPY(ContentFilter)
+
+  std::unique_ptr<const Condition> condition_;
+  bool can_evaluate_serialized_ = false;
+  size_t min_serialized_size_ = 0;
+};
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__CONTENT_FILTER_HPP_
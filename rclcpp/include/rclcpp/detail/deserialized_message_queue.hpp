@@ -0,0 +1,160 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__DETAIL__DESERIALIZED_MESSAGE_QUEUE_HPP_
+#define RCLCPP__DETAIL__DESERIALIZED_MESSAGE_QUEUE_HPP_
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "rcl/wait.h"
+
+#include "rclcpp/context.hpp"
+#include "rclcpp/guard_condition.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/message_info.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/visibility_control.hpp"
+#include "rclcpp/waitable.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Messages of a subscription being deserialized by a DeserializationPool, in the order taken.
+/**
+ * The messages are handled by the executor of the subscription, through this waitable
+ * added to its callback group, once the messages taken before them are handled too.
+ * \sa rclcpp::DeserializationPool
+ */
+class DeserializedMessageQueue : public rclcpp::Waitable
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(DeserializedMessageQueue)
+
+  enum class EntityType : std::size_t
+  {
+    Queue,
+  };
+
+  /// A message taken serialized, with the message it's deserialized into.
+  struct Entry
+  {
+    rclcpp::SerializedMessage serialized_message;
+    rclcpp::MessageInfo message_info;
+    std::shared_ptr<void> message;
+    // False if the content filter of the subscription still has to be evaluated
+    bool content_filter_evaluated = true;
+    // Set by the thread deserializing the message, before the entry is ready
+    bool deserialized = false;
+    // Guarded by the mutex of the queue
+    bool ready = false;
+  };
+
+  using Handler = std::function<void (Entry &)>;
+
+  RCLCPP_PUBLIC
+  DeserializedMessageQueue(rclcpp::Context::SharedPtr context, Handler handler);
+
+  RCLCPP_PUBLIC
+  ~DeserializedMessageQueue() override = default;
+
+  /// Return an entry to take a message into, reusing the buffer of a handled one if possible.
+  RCLCPP_PUBLIC
+  std::shared_ptr<Entry>
+  create_entry();
+
+  /// Give back an entry which wasn't pushed, or was handled, so that it can be reused.
+  RCLCPP_PUBLIC
+  void
+  recycle_entry(std::shared_ptr<Entry> entry);
+
+  /// Queue an entry, handled once it's ready and the entries pushed before are handled.
+  RCLCPP_PUBLIC
+  void
+  push(std::shared_ptr<Entry> entry);
+
+  /// Mark an entry as ready, waking up the executor if it's the oldest one.
+  RCLCPP_PUBLIC
+  void
+  set_ready(const std::shared_ptr<Entry> & entry);
+
+  /// Return true if no entry is queued.
+  RCLCPP_PUBLIC
+  bool
+  empty() const;
+
+  RCLCPP_PUBLIC
+  size_t
+  get_number_of_ready_guard_conditions() override {return 1;}
+
+  RCLCPP_PUBLIC
+  void
+  add_to_wait_set(rcl_wait_set_t * wait_set) override;
+
+  RCLCPP_PUBLIC
+  bool
+  is_ready(rcl_wait_set_t * wait_set) override;
+
+  RCLCPP_PUBLIC
+  std::shared_ptr<void>
+  take_data() override;
+
+  RCLCPP_PUBLIC
+  std::shared_ptr<void>
+  take_data_by_entity_id(size_t id) override;
+
+  RCLCPP_PUBLIC
+  void
+  execute(std::shared_ptr<void> & data) override;
+
+  /// Set a callback to be called for each entry becoming ready to be handled.
+  /**
+   * \sa rclcpp::experimental::SubscriptionIntraProcessBase::set_on_ready_callback
+   */
+  RCLCPP_PUBLIC
+  void
+  set_on_ready_callback(std::function<void(size_t, int)> callback) override;
+
+  RCLCPP_PUBLIC
+  void
+  clear_on_ready_callback() override;
+
+private:
+  // The entries kept for reuse, with the buffers of their serialized messages
+  static constexpr size_t kMaxRecycledEntries = 4;
+
+  Handler handler_;
+  rclcpp::GuardCondition gc_;
+
+  mutable std::mutex queue_mutex_;
+  std::deque<std::shared_ptr<Entry>> queue_;
+  // Number of ready entries at the front of the queue the executor was woken up for
+  size_t signaled_count_{0};
+  std::vector<std::shared_ptr<Entry>> recycled_entries_;
+
+  std::recursive_mutex callback_mutex_;
+  std::function<void(size_t)> on_ready_callback_{nullptr};
+  size_t unread_count_{0};
+};
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__DESERIALIZED_MESSAGE_QUEUE_HPP_
@@ -0,0 +1,62 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__DETAIL__FUTURE_WAITERS_HPP_
+#define RCLCPP__DETAIL__FUTURE_WAITERS_HPP_
+
+#include "rclcpp/guard_condition.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Wake up the executors waiting for a future in other threads.
+/**
+ * The service and action clients call it after completing the promise of a future,
+ * which an Executor::spin_until_future_complete() of another thread may be waiting for,
+ * so that it checks its future right away instead of at its next wake up.
+ * It only checks an atomic counter when no executor is waiting.
+ */
+RCLCPP_PUBLIC
+void
+notify_future_waiters();
+
+/// Registration of a guard condition triggered by notify_future_waiters().
+/**
+ * The guard condition is registered for the thread constructing the waiter, and is only
+ * triggered by the other threads, until the waiter is destroyed.
+ */
+class FutureWaiter
+{
+public:
+  RCLCPP_PUBLIC
+  explicit FutureWaiter(rclcpp::GuardCondition & guard_condition);
+
+  RCLCPP_PUBLIC
+  ~FutureWaiter();
+
+private:
+  RCLCPP_DISABLE_COPY(FutureWaiter)
+
+  rclcpp::GuardCondition & guard_condition_;
+};
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__FUTURE_WAITERS_HPP_
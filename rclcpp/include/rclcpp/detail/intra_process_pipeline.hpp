@@ -0,0 +1,80 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__DETAIL__INTRA_PROCESS_PIPELINE_HPP_
+#define RCLCPP__DETAIL__INTRA_PROCESS_PIPELINE_HPP_
+
+#include <deque>
+#include <memory>
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+class SubscriptionIntraProcessBase;
+}  // namespace experimental
+
+namespace detail
+{
+
+/// Intra-process subscriptions which received a message during a callback of the thread.
+/**
+ * While a pipeline is constructed, the intra-process manager queues in it the subscriptions
+ * which a message is published to by the thread, so that the executor can execute them
+ * right after the callback publishing, on the same thread, instead of waiting for them.
+ * There is at most one pipeline per thread, which the subscriptions queued while
+ * executing the ones of the pipeline are also queued in.
+ */
+class IntraProcessPipeline
+{
+public:
+  /// Start queueing the subscriptions published to by the thread.
+  /**
+   * \throws std::logic_error if the thread already has a pipeline.
+   */
+  RCLCPP_PUBLIC
+  IntraProcessPipeline();
+
+  RCLCPP_PUBLIC
+  ~IntraProcessPipeline();
+
+  /// Return true if the calling thread has a pipeline.
+  RCLCPP_PUBLIC
+  static bool
+  is_active();
+
+  /// Queue a subscription in the pipeline of the calling thread, if it has one.
+  RCLCPP_PUBLIC
+  static void
+  enqueue(std::shared_ptr<rclcpp::experimental::SubscriptionIntraProcessBase> subscription);
+
+  /// Remove and return the oldest subscription of the pipeline, or nullptr if it's empty.
+  RCLCPP_PUBLIC
+  std::shared_ptr<rclcpp::experimental::SubscriptionIntraProcessBase>
+  pop();
+
+private:
+  RCLCPP_DISABLE_COPY(IntraProcessPipeline)
+
+  std::deque<std::shared_ptr<rclcpp::experimental::SubscriptionIntraProcessBase>> subscriptions_;
+};
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__INTRA_PROCESS_PIPELINE_HPP_
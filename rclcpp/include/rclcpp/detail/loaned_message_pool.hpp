@@ -0,0 +1,104 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__DETAIL__LOANED_MESSAGE_POOL_HPP_
+#define RCLCPP__DETAIL__LOANED_MESSAGE_POOL_HPP_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "rclcpp/macros.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Preallocated messages loaned by publishers when the middleware can't loan messages.
+/**
+ * All the messages are allocated when the pool is created.
+ * A message given back to the pool is reset to a default constructed message, which doesn't
+ * allocate memory for messages of a fixed size.
+ *
+ * Borrowing and giving back messages is thread-safe.
+ */
+template<typename MessageT>
+class LoanedMessagePool
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(LoanedMessagePool<MessageT>)
+
+  explicit LoanedMessagePool(size_t size)
+  : messages_(new MessageT[size]), size_(size)
+  {
+    available_messages_.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+      available_messages_.push_back(&messages_[i]);
+    }
+  }
+
+  /// Borrow a message, returning nullptr if all of them are borrowed.
+  MessageT *
+  borrow_message()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (available_messages_.empty()) {
+      return nullptr;
+    }
+    MessageT * message = available_messages_.back();
+    available_messages_.pop_back();
+    return message;
+  }
+
+  /// Give back a message borrowed from this pool.
+  void
+  return_message(MessageT * message)
+  {
+    *message = MessageT();
+    std::lock_guard<std::mutex> lock(mutex_);
+    available_messages_.push_back(message);
+  }
+
+  /// Return true if the message belongs to this pool.
+  bool
+  owns(const MessageT * message) const
+  {
+    std::less_equal<const MessageT *> less_equal;
+    return less_equal(messages_.get(), message) &&
+           std::less<const MessageT *>()(message, messages_.get() + size_);
+  }
+
+  /// Return the number of messages of the pool which are not borrowed.
+  size_t
+  get_number_of_available_messages() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return available_messages_.size();
+  }
+
+private:
+  RCLCPP_DISABLE_COPY(LoanedMessagePool)
+
+  std::unique_ptr<MessageT[]> messages_;
+  const size_t size_;
+  mutable std::mutex mutex_;
+  std::vector<MessageT *> available_messages_;
+};
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__LOANED_MESSAGE_POOL_HPP_
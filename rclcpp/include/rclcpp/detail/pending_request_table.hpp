@@ -0,0 +1,250 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__DETAIL__PENDING_REQUEST_TABLE_HPP_
+#define RCLCPP__DETAIL__PENDING_REQUEST_TABLE_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <optional>  // NOLINT, cpplint doesn't think this is a cpp std header
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Requests waiting for a response, indexed by their sequence number.
+/**
+ * The requests are stored in an array of slots, the slot of a request being
+ * its sequence number modulo the number of slots.
+ * As the sequence numbers of a client increase, the slots of the requests
+ * which got their response are reused by the next requests, so that adding
+ * and removing requests doesn't allocate memory once the array is large enough
+ * for the requests pending at the same time.
+ * When the slot of a new request is still used, the array doubles in size if
+ * at least half of the slots are used, and otherwise the request already in the
+ * slot, which is older, is moved to a map of the requests not fitting in the array.
+ * The array then only grows with the number of requests pending at the same time,
+ * and not with the range of their sequence numbers, e.g. when a request never gets
+ * a response, or with the intra-process requests of a client, whose sequence numbers
+ * are negative.
+ *
+ * It isn't thread-safe.
+ */
+template<typename ValueT>
+class PendingRequestTable
+{
+public:
+  using TimePoint = std::chrono::time_point<std::chrono::system_clock>;
+
+  /// Constructor.
+  /**
+   * \param[in] capacity initial number of slots, rounded up to a power of two
+   */
+  explicit PendingRequestTable(size_t capacity = 16)
+  {
+    size_t size = 1;
+    while (size < capacity) {
+      size *= 2;
+    }
+    slots_.resize(size);
+  }
+
+  /// Add a request, returning false if a request with the same sequence number is pending.
+  bool
+  emplace(int64_t sequence_number, TimePoint time, ValueT value)
+  {
+    Slot * slot = &get_slot(sequence_number);
+    if (slot->value && slot->sequence_number == sequence_number) {
+      return false;
+    }
+    if (overflow_.count(sequence_number) != 0) {
+      return false;
+    }
+    if (slot->value) {
+      if (2 * (size_ + 1) > slots_.size()) {
+        grow();
+        slot = &get_slot(sequence_number);
+      }
+      if (slot->value) {
+        overflow_.emplace(slot->sequence_number, std::move(*slot));
+        slot->value.reset();
+      }
+    }
+    slot->sequence_number = sequence_number;
+    slot->time = time;
+    slot->value.emplace(std::move(value));
+    ++size_;
+    return true;
+  }
+
+  /// Remove a request and return its value, or std::nullopt if it isn't pending.
+  std::optional<ValueT>
+  take(int64_t sequence_number)
+  {
+    Slot & slot = get_slot(sequence_number);
+    if (!slot.value || slot.sequence_number != sequence_number) {
+      auto it = overflow_.find(sequence_number);
+      if (it == overflow_.end()) {
+        return std::nullopt;
+      }
+      std::optional<ValueT> value = std::move(it->second.value);
+      overflow_.erase(it);
+      --size_;
+      return value;
+    }
+    std::optional<ValueT> value = std::move(slot.value);
+    slot.value.reset();
+    --size_;
+    return value;
+  }
+
+  /// Remove a request, returning false if it isn't pending.
+  bool
+  erase(int64_t sequence_number)
+  {
+    Slot & slot = get_slot(sequence_number);
+    if (!slot.value || slot.sequence_number != sequence_number) {
+      if (overflow_.erase(sequence_number) == 0) {
+        return false;
+      }
+      --size_;
+      return true;
+    }
+    slot.value.reset();
+    --size_;
+    return true;
+  }
+
+  /// Remove the requests for which a predicate, given the sequence number and time, is true.
+  /**
+   * \return the number of requests removed
+   */
+  template<typename PredicateT>
+  size_t
+  erase_if(PredicateT && predicate)
+  {
+    size_t erased = 0;
+    for (Slot & slot : slots_) {
+      if (slot.value && predicate(slot.sequence_number, slot.time)) {
+        slot.value.reset();
+        ++erased;
+      }
+    }
+    for (auto it = overflow_.begin(); it != overflow_.end(); ) {
+      if (predicate(it->second.sequence_number, it->second.time)) {
+        it = overflow_.erase(it);
+        ++erased;
+      } else {
+        ++it;
+      }
+    }
+    size_ -= erased;
+    return erased;
+  }
+
+  /// Remove all the requests, returning how many there were.
+  size_t
+  clear()
+  {
+    for (Slot & slot : slots_) {
+      slot.value.reset();
+    }
+    overflow_.clear();
+    size_t erased = size_;
+    size_ = 0;
+    return erased;
+  }
+
+  /// Return the number of pending requests.
+  size_t
+  size() const
+  {
+    return size_;
+  }
+
+  /// Return the number of slots, which doesn't include the requests not fitting in them.
+  size_t
+  capacity() const
+  {
+    return slots_.size();
+  }
+
+private:
+  struct Slot
+  {
+    int64_t sequence_number{0};
+    TimePoint time;
+    std::optional<ValueT> value;
+  };
+
+  static
+  size_t
+  get_index(int64_t sequence_number, size_t number_of_slots)
+  {
+    // The number of slots is a power of two.
+    return static_cast<size_t>(static_cast<uint64_t>(sequence_number) & (number_of_slots - 1));
+  }
+
+  Slot &
+  get_slot(int64_t sequence_number)
+  {
+    return slots_[get_index(sequence_number, slots_.size())];
+  }
+
+  /// Double the number of slots, moving the requests not fitting in the array to it if they can.
+  void
+  grow()
+  {
+    std::vector<Slot> new_slots(slots_.size() * 2);
+    auto insert = [&new_slots, this](Slot && slot) {
+        Slot & new_slot = new_slots[get_index(slot.sequence_number, new_slots.size())];
+        if (!new_slot.value) {
+          new_slot = std::move(slot);
+          return true;
+        }
+        if (new_slot.time < slot.time) {
+          // The older request is the one kept out of the array.
+          std::swap(new_slot, slot);
+        }
+        return false;
+      };
+    std::unordered_map<int64_t, Slot> new_overflow;
+    for (Slot & slot : slots_) {
+      if (slot.value && !insert(std::move(slot))) {
+        new_overflow.emplace(slot.sequence_number, std::move(slot));
+      }
+    }
+    for (auto & entry : overflow_) {
+      if (!insert(std::move(entry.second))) {
+        new_overflow.emplace(entry.second.sequence_number, std::move(entry.second));
+      }
+    }
+    slots_ = std::move(new_slots);
+    overflow_ = std::move(new_overflow);
+  }
+
+  std::vector<Slot> slots_;
+  // The requests whose slot is used by a newer request.
+  std::unordered_map<int64_t, Slot> overflow_;
+  size_t size_{0};
+};
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__PENDING_REQUEST_TABLE_HPP_
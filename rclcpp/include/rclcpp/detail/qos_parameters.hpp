@@ -104,6 +104,32 @@ declare_parameter_or_get(
   }
 }
 
+/// \internal Return the value a parameter would have if declared, without declaring it.
+inline
+rclcpp::ParameterValue
+get_parameter_or_override(
+  rclcpp::node_interfaces::NodeParametersInterface & parameters_interface,
+  const std::string & param_name,
+  rclcpp::ParameterValue param_value)
+{
+  if (parameters_interface.has_parameter(param_name)) {
+    return parameters_interface.get_parameter(param_name).get_parameter_value();
+  }
+  const auto & overrides = parameters_interface.get_parameter_overrides();
+  auto it = overrides.find(param_name);
+  if (it == overrides.end()) {
+    return param_value;
+  }
+  // Declaring the parameter would fail, as its type is inferred from the default value
+  if (it->second.get_type() != param_value.get_type()) {
+    throw rclcpp::exceptions::InvalidParameterTypeException{
+            param_name,
+            "the override is of type {" + rclcpp::to_string(it->second.get_type()) +
+            "} instead of {" + rclcpp::to_string(param_value.get_type()) + "}"};
+  }
+  return it->second;
+}
+
 #ifdef DOXYGEN_ONLY
 /// \internal Declare QoS parameters for the given entity.
 /**
@@ -112,6 +138,7 @@ declare_parameter_or_get(
  *  `allowed_policies()`. See `PublisherQosParametersTraits` and `SubscriptionQosParametersTraits`.
  * \param options User provided options that indicate if QoS parameter overrides should be
  *  declared or not, which policy can have overrides, and optionally a callback to validate the profile.
+ *  If they don't declare the parameters, the overrides are only read.
  * \param node Parameters will be declared using this node.
  * \param topic_name Name of the topic of the entity.
  * \param default_qos User provided qos. It will be used as a default for the parameters declared.
@@ -170,6 +197,12 @@ declare_qos_parameters(
     {
       std::ostringstream param_name{param_prefix, std::ios::ate};
       param_name << qos_policy_kind_to_cstr(policy);
+      if (!options.get_declare_parameters()) {
+        auto value = get_parameter_or_override(
+          parameters_interface, param_name.str(), get_default_qos_param_value(policy, qos));
+        ::rclcpp::detail::apply_qos_override(policy, value, qos);
+        continue;
+      }
       std::ostringstream param_desciption{"qos policy {", std::ios::ate};
       param_desciption << qos_policy_kind_to_cstr(policy) << param_description_suffix;
       rcl_interfaces::msg::ParameterDescriptor descriptor{};
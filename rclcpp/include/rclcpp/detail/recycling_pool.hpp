@@ -0,0 +1,165 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__DETAIL__RECYCLING_POOL_HPP_
+#define RCLCPP__DETAIL__RECYCLING_POOL_HPP_
+
+#include <atomic>
+#include <memory>
+
+#include "rclcpp/macros.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Objects handed out as shared pointers, and reused once only the pool references them.
+/**
+ * The pool holds up to a maximum number of objects, which are only created when all the
+ * ones of the pool are in use.
+ * An object is reused once all the shared pointers to it that were handed out are released,
+ * so nothing has to be given back to the pool, and the users may keep the objects they get.
+ *
+ * This is the storage of the pools of messages, which decide how their messages are created
+ * and prepared to be reused, and what to do when the pool is full.
+ *
+ * Borrowing objects is lock-free and thread-safe.
+ */
+template<typename T>
+class RecyclingPool
+{
+public:
+  /// Constructor.
+  /**
+   * \param[in] max_size maximum number of objects kept by the pool.
+   */
+  explicit RecyclingPool(size_t max_size)
+  : slots_(new Slot[max_size]), max_size_(max_size)
+  {
+  }
+
+  /// Borrow an object which isn't used anymore, creating it if there is none.
+  /**
+   * \param[in] create function returning a new std::shared_ptr<T>, which may throw.
+   * \param[in] reuse function called with an object before it's reused.
+   * \return the object, or nullptr if all the objects of a full pool are in use.
+   */
+  template<typename CreateT, typename ReuseT>
+  std::shared_ptr<T>
+  borrow(CreateT && create, ReuseT && reuse)
+  {
+    for (size_t i = 0; i < max_size_; ++i) {
+      Slot & slot = slots_[i];
+      bool expected = false;
+      if (!slot.in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+        continue;
+      }
+      std::shared_ptr<T> object;
+      try {
+        if (!slot.object) {
+          object = create_object(slot, create);
+        } else if (slot.object.use_count() == 1) {
+          // Nobody else can get a new reference to the object if the pool has the only one.
+          // Synchronizes with the release of the last reference by another thread.
+          std::atomic_thread_fence(std::memory_order_acquire);
+          object = slot.object;
+          reuse(*object);
+        }
+      } catch (...) {
+        slot.in_use.store(false, std::memory_order_release);
+        throw;
+      }
+      slot.in_use.store(false, std::memory_order_release);
+      if (object) {
+        return object;
+      }
+    }
+    return nullptr;
+  }
+
+  /// Create objects of the pool up front, so that the first ones borrowed don't allocate.
+  /**
+   * \param[in] number_of_objects number of objects of the pool created, at most.
+   * \param[in] create function returning a new std::shared_ptr<T>, which may throw.
+   * \return the number of objects of the pool, including the ones created before.
+   */
+  template<typename CreateT>
+  size_t
+  preallocate(size_t number_of_objects, CreateT && create)
+  {
+    for (size_t i = 0; i < max_size_ && number_of_objects > 0; ++i) {
+      Slot & slot = slots_[i];
+      bool expected = false;
+      if (!slot.in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+        continue;
+      }
+      try {
+        if (!slot.object) {
+          create_object(slot, create);
+          --number_of_objects;
+        }
+      } catch (...) {
+        slot.in_use.store(false, std::memory_order_release);
+        throw;
+      }
+      slot.in_use.store(false, std::memory_order_release);
+    }
+    return size();
+  }
+
+  /// Return the number of objects created by the pool.
+  size_t
+  size() const
+  {
+    return size_.load(std::memory_order_relaxed);
+  }
+
+  /// Return the maximum number of objects kept by the pool.
+  size_t
+  max_size() const
+  {
+    return max_size_;
+  }
+
+private:
+  RCLCPP_DISABLE_COPY(RecyclingPool)
+
+  struct Slot
+  {
+    std::atomic_bool in_use{false};
+    /// Only accessed by the thread which set in_use.
+    std::shared_ptr<T> object;
+  };
+
+  /// Called with in_use set.
+  template<typename CreateT>
+  std::shared_ptr<T>
+  create_object(Slot & slot, CreateT & create)
+  {
+    slot.object = create();
+    size_.fetch_add(1, std::memory_order_relaxed);
+    return slot.object;
+  }
+
+  std::unique_ptr<Slot[]> slots_;
+  const size_t max_size_;
+  std::atomic_size_t size_{0};
+};
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__RECYCLING_POOL_HPP_
@@ -0,0 +1,106 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__DETAIL__RESOLVED_NAME_CACHE_HPP_
+#define RCLCPP__DETAIL__RESOLVED_NAME_CACHE_HPP_
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "rclcpp/macros.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Names of the topics and services of a node, as they were expanded or resolved.
+/**
+ * The expansion and remapping rules of a node don't change once it's created, so the
+ * results of resolving a name are reused for the next entities with this name.
+ * The names failing to resolve aren't cached, so that they throw again.
+ * When full, the cache is cleared, so that nodes creating entities with unique names
+ * don't keep them all.
+ *
+ * It is thread-safe.
+ */
+class ResolvedNameCache
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(ResolvedNameCache)
+
+  /// Constructor.
+  /**
+   * \param[in] max_size maximum number of names kept.
+   */
+  explicit ResolvedNameCache(size_t max_size = 1024u)
+  : max_size_(max_size)
+  {
+  }
+
+  /// Return the resolved name, resolving it with a callable on the first call.
+  /**
+   * The name is resolved without holding the lock of the cache, so concurrent calls
+   * may resolve it more than once.
+   * \param[in] name name to resolve.
+   * \param[in] kind kind of resolution, different flags giving different names.
+   * \param[in] resolve callable returning the resolved name, or throwing.
+   */
+  template<typename ResolveT>
+  std::string
+  get(const std::string & name, char kind, ResolveT && resolve)
+  {
+    std::string key;
+    key.reserve(name.size() + 1u);
+    key.append(name).push_back(kind);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = names_.find(key);
+      if (it != names_.end()) {
+        return it->second;
+      }
+    }
+    std::string resolved_name = std::forward<ResolveT>(resolve)();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (names_.size() >= max_size_) {
+      names_.clear();
+    }
+    names_.emplace(std::move(key), resolved_name);
+    return resolved_name;
+  }
+
+  /// Return the number of names kept.
+  size_t
+  size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return names_.size();
+  }
+
+private:
+  RCLCPP_DISABLE_COPY(ResolvedNameCache)
+
+  const size_t max_size_;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::string> names_;
+};
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__RESOLVED_NAME_CACHE_HPP_
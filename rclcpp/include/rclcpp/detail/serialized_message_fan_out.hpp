@@ -0,0 +1,102 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__DETAIL__SERIALIZED_MESSAGE_FAN_OUT_HPP_
+#define RCLCPP__DETAIL__SERIALIZED_MESSAGE_FAN_OUT_HPP_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "rmw/types.h"
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Serialized messages taken by the generic subscriptions of a context, shared between them.
+/**
+ * Each subscription takes its own copy of a message from the middleware, which is then
+ * replaced by the copy of the first subscription which took the same message, identified
+ * by the gid of its publisher and its sequence number.
+ * This way, the subscriptions of a topic keeping the messages they receive, for instance
+ * to record them, keep only one copy of each, and their callbacks get the same message.
+ *
+ * The messages are only referenced weakly, so that they are shared as long as a
+ * subscription holds them, and only the most recent ones of each topic are remembered.
+ * It is used as a sub context of rclcpp::Context, and is thread-safe.
+ */
+class SerializedMessageFanOut
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(SerializedMessageFanOut)
+
+  /// Constructor.
+  /**
+   * \param[in] max_messages_per_topic Number of recent messages remembered for each topic.
+   * \throws std::invalid_argument if max_messages_per_topic is 0.
+   */
+  RCLCPP_PUBLIC
+  explicit SerializedMessageFanOut(size_t max_messages_per_topic = 64);
+
+  /// Return the message already shared with the same publisher and sequence number, if any.
+  /**
+   * Otherwise, the message is shared and returned.
+   * The messages of middlewares not supporting sequence numbers are never shared.
+   *
+   * \param[in] topic_name fully qualified name of the topic of the message.
+   * \param[in] message_info information of the message, as taken from the middleware.
+   * \param[in] message the message taken by a subscription.
+   */
+  RCLCPP_PUBLIC
+  std::shared_ptr<const rclcpp::SerializedMessage>
+  share(
+    const std::string & topic_name,
+    const rmw_message_info_t & message_info,
+    std::shared_ptr<const rclcpp::SerializedMessage> message);
+
+  /// Return the number of messages remembered, including the ones not held anymore.
+  RCLCPP_PUBLIC
+  size_t
+  size() const;
+
+private:
+  RCLCPP_DISABLE_COPY(SerializedMessageFanOut)
+
+  struct SharedMessage
+  {
+    rmw_gid_t publisher_gid;
+    uint64_t sequence_number;
+    std::weak_ptr<const rclcpp::SerializedMessage> message;
+  };
+
+  const size_t max_messages_per_topic_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::deque<SharedMessage>> topics_;
+};
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__SERIALIZED_MESSAGE_FAN_OUT_HPP_
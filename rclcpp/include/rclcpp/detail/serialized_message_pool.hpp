@@ -0,0 +1,97 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__DETAIL__SERIALIZED_MESSAGE_POOL_HPP_
+#define RCLCPP__DETAIL__SERIALIZED_MESSAGE_POOL_HPP_
+
+#include <atomic>
+#include <memory>
+
+#include "rcl/allocator.h"
+
+#include "rclcpp/detail/recycling_pool.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Pool of serialized messages reused once they aren't used anymore.
+/**
+ * The pool holds up to a maximum number of messages, which are only allocated when all the
+ * ones of the pool are in use.
+ * A message is reused once the pool has the only reference to it, so callbacks may keep the
+ * messages they receive, see rclcpp::detail::RecyclingPool.
+ * The buffers of the reused messages keep their capacity, and new messages are created with
+ * the largest size returned so far, so their buffers don't grow while taking messages.
+ *
+ * Borrowing and returning messages is lock-free and thread-safe.
+ */
+class SerializedMessagePool
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(SerializedMessagePool)
+
+  /// Constructor.
+  /**
+   * \param[in] max_size Maximum number of messages kept by the pool.
+   * \param[in] allocator Allocator used for the buffers of the messages.
+   * \throws std::invalid_argument if max_size is 0.
+   */
+  RCLCPP_PUBLIC
+  explicit SerializedMessagePool(
+    size_t max_size,
+    const rcl_allocator_t & allocator = rcl_get_default_allocator());
+
+  RCLCPP_PUBLIC
+  ~SerializedMessagePool();
+
+  /// Borrow a message of the pool which isn't used anymore, allocating it if needed.
+  /**
+   * \param[in] capacity Minimum capacity of the buffer of the message.
+   */
+  RCLCPP_PUBLIC
+  std::shared_ptr<rclcpp::SerializedMessage>
+  borrow_message(size_t capacity = 0);
+
+  /// Return a message, recording its size, it is reused once all the other references are released.
+  RCLCPP_PUBLIC
+  void
+  return_message(std::shared_ptr<rclcpp::SerializedMessage> & message);
+
+  /// Return the largest size of the messages returned so far.
+  RCLCPP_PUBLIC
+  size_t
+  get_high_water_mark() const;
+
+  /// Return the number of messages allocated by the pool.
+  RCLCPP_PUBLIC
+  size_t
+  get_number_of_pooled_messages() const;
+
+private:
+  RCLCPP_DISABLE_COPY(SerializedMessagePool)
+
+  RecyclingPool<rclcpp::SerializedMessage> pool_;
+  const rcl_allocator_t allocator_;
+  std::atomic_size_t high_water_mark_{0};
+};
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__SERIALIZED_MESSAGE_POOL_HPP_
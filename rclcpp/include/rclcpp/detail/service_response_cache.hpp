@@ -0,0 +1,163 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__DETAIL__SERVICE_RESPONSE_CACHE_HPP_
+#define RCLCPP__DETAIL__SERVICE_RESPONSE_CACHE_HPP_
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/serializer.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Responses of an idempotent service, keyed on the serialized bytes of their requests.
+/**
+ * A response is answered again to identical requests until its time to live expires
+ * or the cache is cleared.
+ * When the cache is full, the expired responses are removed, and then the oldest one
+ * if none expired.
+ *
+ * It is thread-safe.
+ */
+template<typename RequestT, typename ResponseT>
+class ServiceResponseCache
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(ServiceResponseCache)
+
+  using Clock = std::chrono::steady_clock;
+
+  /// Constructor.
+  /**
+   * \param[in] time_to_live how long a response is answered to identical requests.
+   * \param[in] max_size maximum number of responses kept.
+   * \throws std::invalid_argument if max_size is 0 or time_to_live is negative.
+   */
+  ServiceResponseCache(std::chrono::nanoseconds time_to_live, size_t max_size)
+  : time_to_live_(time_to_live), max_size_(max_size)
+  {
+    if (max_size == 0) {
+      throw std::invalid_argument("the response cache of a service can't be empty");
+    }
+    if (time_to_live < std::chrono::nanoseconds::zero()) {
+      throw std::invalid_argument("the time to live of cached responses can't be negative");
+    }
+  }
+
+  /// Return the cached response of a request, or nullptr if there is none.
+  /**
+   * \param[in] request the request.
+   * \param[out] key the key of the request, to insert its response if there is none.
+   */
+  std::shared_ptr<const ResponseT>
+  find(const RequestT & request, std::string & key)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The serialized message is reused, so that only the key is allocated.
+    const auto & rcl_serialized_request =
+      serializer_.serialize_message(request).get_rcl_serialized_message();
+    key.assign(
+      reinterpret_cast<const char *>(rcl_serialized_request.buffer),
+      rcl_serialized_request.buffer_length);
+
+    auto it = responses_.find(key);
+    if (it == responses_.end()) {
+      return nullptr;
+    }
+    if (Clock::now() - it->second.time > time_to_live_) {
+      responses_.erase(it);
+      return nullptr;
+    }
+    return it->second.response;
+  }
+
+  /// Cache the response of a request, given the key returned by find().
+  void
+  insert(std::string key, std::shared_ptr<const ResponseT> response)
+  {
+    const auto now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (responses_.size() >= max_size_ && responses_.find(key) == responses_.end()) {
+      remove_expired_or_oldest(now);
+    }
+    responses_[std::move(key)] = Entry{std::move(response), now};
+  }
+
+  /// Remove all the cached responses.
+  void
+  clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    responses_.clear();
+  }
+
+  /// Return the number of cached responses, including the expired ones not removed yet.
+  size_t
+  size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return responses_.size();
+  }
+
+private:
+  RCLCPP_DISABLE_COPY(ServiceResponseCache)
+
+  struct Entry
+  {
+    std::shared_ptr<const ResponseT> response;
+    Clock::time_point time;
+  };
+
+  void
+  remove_expired_or_oldest(Clock::time_point now)
+  {
+    auto oldest = responses_.end();
+    for (auto it = responses_.begin(); it != responses_.end(); ) {
+      if (now - it->second.time > time_to_live_) {
+        it = responses_.erase(it);
+        continue;
+      }
+      if (oldest == responses_.end() || it->second.time < oldest->second.time) {
+        oldest = it;
+      }
+      ++it;
+    }
+    if (responses_.size() >= max_size_ && oldest != responses_.end()) {
+      responses_.erase(oldest);
+    }
+  }
+
+  const std::chrono::nanoseconds time_to_live_;
+  const size_t max_size_;
+
+  mutable std::mutex mutex_;
+  rclcpp::Serializer<RequestT> serializer_;
+  std::unordered_map<std::string, Entry> responses_;
+};
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__SERVICE_RESPONSE_CACHE_HPP_
@@ -0,0 +1,202 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__DETAIL__SHARED_MEMORY_TOPIC_HPP_
+#define RCLCPP__DETAIL__SHARED_MEMORY_TOPIC_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Shared memory segment of a topic, shared by its publishers and subscriptions on a host.
+/**
+ * The segment has a slot for each subscription, in any process, with a ring of the given
+ * depth of message cells.
+ * A publisher writes a message into the ring of each subscription, and its readers are
+ * notified with a datagram, on an abstract Unix socket bound by each subscription.
+ *
+ * The cells are claimed by the writers with an atomic sequence number, which is odd while
+ * they are written, so that several writers of the same or other processes write
+ * concurrently without locks, and a reader detects a message overwritten while it read it.
+ * When a ring is full, the oldest messages are overwritten.
+ *
+ * The segment is created by the first entity of the topic, which sets its geometry, and it is
+ * removed by the last one, using file locks.
+ * The slots of the subscriptions of processes which died are reused, so the processes must
+ * share their pid namespace.
+ *
+ * This is only supported on Linux.
+ */
+class SharedMemoryTopic
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(SharedMemoryTopic)
+
+  /// Open the segment of a topic, creating it if it doesn't exist.
+  /**
+   * \param[in] segment_name name of the segment, as returned by get_segment_name().
+   * \param[in] type_name name of the type of the messages, with their encoding.
+   * \param[in] max_subscriptions maximum number of subscriptions of the topic.
+   * \param[in] depth number of messages kept for each subscription.
+   * \param[in] max_message_size maximum size of the messages.
+   * \throws std::invalid_argument if max_subscriptions, depth or max_message_size is 0.
+   * \throws std::runtime_error if the segment can't be opened, if it's used with another
+   *   type or geometry, or on other platforms than Linux.
+   */
+  RCLCPP_PUBLIC
+  SharedMemoryTopic(
+    const std::string & segment_name,
+    const std::string & type_name,
+    size_t max_subscriptions,
+    size_t depth,
+    size_t max_message_size);
+
+  RCLCPP_PUBLIC
+  ~SharedMemoryTopic();
+
+  /// Return the name of the segment of a topic, in a domain.
+  RCLCPP_PUBLIC
+  static
+  std::string
+  get_segment_name(size_t domain_id, const std::string & topic_name);
+
+  /// Write a message for all the subscriptions and notify them.
+  /**
+   * \param[in] data data of the message.
+   * \param[in] size size of the message.
+   * \return the number of subscriptions the message was written for.
+   * \throws std::invalid_argument if the message is bigger than the maximum message size.
+   */
+  RCLCPP_PUBLIC
+  size_t
+  write(const void * data, size_t size);
+
+  /// Return the number of subscriptions of the topic, in all the processes.
+  RCLCPP_PUBLIC
+  size_t
+  get_subscription_count() const;
+
+  /// Return the maximum size of the messages.
+  RCLCPP_PUBLIC
+  size_t
+  get_max_message_size() const;
+
+  /// Return the name of the segment.
+  RCLCPP_PUBLIC
+  const std::string &
+  get_segment_name() const;
+
+private:
+  RCLCPP_DISABLE_COPY(SharedMemoryTopic)
+
+  friend class SharedMemoryTopicReader;
+
+  struct SlotHeader;
+  struct CellHeader;
+
+  SlotHeader &
+  get_slot(size_t index) const;
+
+  CellHeader &
+  get_cell(const SlotHeader & slot, uint64_t ticket) const;
+
+  /// Send a notification to the subscription of a slot, unless it wasn't read yet.
+  void
+  notify(size_t index, uint32_t generation) const;
+
+  std::string segment_name_;
+  size_t max_subscriptions_ = 0;
+  size_t depth_ = 0;
+  size_t max_message_size_ = 0;
+  size_t slot_size_ = 0;
+  size_t cell_size_ = 0;
+  size_t mapping_size_ = 0;
+  unsigned char * mapping_ = nullptr;
+  int fd_ = -1;
+  int notification_fd_ = -1;
+};
+
+/// Subscription reading the messages written into its slot of a shared memory topic.
+/**
+ * It mustn't be used by several threads at once.
+ */
+class SharedMemoryTopicReader
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(SharedMemoryTopicReader)
+
+  /// Take a slot of the topic, only the messages written afterwards are read.
+  /**
+   * \param[in] topic topic of the subscription.
+   * \throws std::invalid_argument if topic is nullptr.
+   * \throws std::runtime_error if the topic has no free slot, or its notifications can't be
+   *   received.
+   */
+  RCLCPP_PUBLIC
+  explicit SharedMemoryTopicReader(std::shared_ptr<SharedMemoryTopic> topic);
+
+  /// Give the slot back.
+  RCLCPP_PUBLIC
+  ~SharedMemoryTopicReader();
+
+  /// Return the file descriptor which is readable when messages were written.
+  RCLCPP_PUBLIC
+  int
+  get_file_descriptor() const;
+
+  /// Discard the notifications received, before the messages are read.
+  RCLCPP_PUBLIC
+  void
+  clear_notifications();
+
+  /// Read the oldest message not read yet.
+  /**
+   * \param[out] buffer buffer receiving the message, of the maximum message size.
+   * \param[out] size size of the message.
+   * \return true if a message was read, false if there is none.
+   */
+  RCLCPP_PUBLIC
+  bool
+  read(void * buffer, size_t & size);
+
+  /// Return the number of messages overwritten before they were read.
+  RCLCPP_PUBLIC
+  uint64_t
+  get_number_of_dropped_messages() const;
+
+private:
+  RCLCPP_DISABLE_COPY(SharedMemoryTopicReader)
+
+  std::shared_ptr<SharedMemoryTopic> topic_;
+  size_t index_ = 0;
+  uint64_t state_ = 0;
+  uint64_t next_ticket_ = 0;
+  uint64_t number_of_dropped_messages_ = 0;
+  int fd_ = -1;
+};
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__SHARED_MEMORY_TOPIC_HPP_
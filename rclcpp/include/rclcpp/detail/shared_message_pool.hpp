@@ -0,0 +1,87 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__DETAIL__SHARED_MESSAGE_POOL_HPP_
+#define RCLCPP__DETAIL__SHARED_MESSAGE_POOL_HPP_
+
+#include <memory>
+
+#include "rclcpp/detail/recycling_pool.hpp"
+#include "rclcpp/macros.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Messages handed out as shared pointers, and reused once only the pool references them.
+/**
+ * Nothing has to be given back to the pool, see rclcpp::detail::RecyclingPool.
+ * When all the messages of a full pool are in use, messages are allocated without being
+ * pooled.
+ *
+ * Borrowing messages is lock-free and thread-safe.
+ */
+template<typename MessageT>
+class SharedMessagePool
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(SharedMessagePool<MessageT>)
+
+  /// Constructor.
+  /**
+   * \param[in] max_size maximum number of messages kept by the pool.
+   */
+  explicit SharedMessagePool(size_t max_size)
+  : pool_(max_size)
+  {
+  }
+
+  /// Borrow a message which isn't used anymore, allocating it if there is none.
+  /**
+   * \param[in] reset if true, a reused message is reset to a default constructed message.
+   */
+  std::shared_ptr<MessageT>
+  borrow_message(bool reset)
+  {
+    auto message = pool_.borrow(
+      []() {return std::make_shared<MessageT>();},
+      [reset](MessageT & reused_message) {
+        if (reset) {
+          reused_message = MessageT();
+        }
+      });
+    if (!message) {
+      message = std::make_shared<MessageT>();
+    }
+    return message;
+  }
+
+  /// Return the number of messages allocated by the pool.
+  size_t
+  get_number_of_pooled_messages() const
+  {
+    return pool_.size();
+  }
+
+private:
+  RCLCPP_DISABLE_COPY(SharedMessagePool)
+
+  RecyclingPool<MessageT> pool_;
+};
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__SHARED_MESSAGE_POOL_HPP_
@@ -0,0 +1,133 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__DETAIL__TAKEN_DATA_SLOT_HPP_
+#define RCLCPP__DETAIL__TAKEN_DATA_SLOT_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Preallocated storage of the data taken by a waitable, until it's executed.
+/**
+ * Waitable::take_data() returns a std::shared_ptr<void>, which make_shared() would allocate
+ * for each event. The data made by a slot are instead constructed in it, with their control
+ * block, and it's free again once the executor releases them, so that a waitable executed
+ * one event at a time doesn't allocate.
+ * When the slot is still in use, by an executor executing the same waitable on several
+ * threads, the data are allocated as with make_shared().
+ * The data may outlive the waitable owning the slot.
+ *
+ * \tparam T type of the data.
+ */
+template<typename T>
+class TakenDataSlot
+{
+public:
+  TakenDataSlot()
+  : storage_(std::make_shared<Storage>())
+  {}
+
+  /// Construct data in the slot if it's free, or allocate them otherwise.
+  template<typename ... Args>
+  std::shared_ptr<T>
+  make(Args && ... args)
+  {
+    return std::allocate_shared<T>(Allocator<T>(storage_), std::forward<Args>(args)...);
+  }
+
+  /// Return true if data made by the slot are constructed in it and not released yet.
+  bool
+  in_use() const
+  {
+    return storage_->in_use.load(std::memory_order_acquire);
+  }
+
+private:
+  // Enough for the data and the control block of std::allocate_shared() in usual libraries.
+  static constexpr size_t kSize = sizeof(T) + 8 * sizeof(void *);
+
+  struct Storage
+  {
+    alignas(std::max_align_t) unsigned char buffer[kSize];
+    std::atomic<bool> in_use{false};
+  };
+
+  template<typename U>
+  struct Allocator
+  {
+    using value_type = U;
+
+    explicit Allocator(std::shared_ptr<Storage> storage)
+    : storage(std::move(storage))
+    {}
+
+    template<typename V>
+    Allocator(const Allocator<V> & other)  // NOLINT(runtime/explicit)
+    : storage(other.storage)
+    {}
+
+    U *
+    allocate(size_t n)
+    {
+      if (sizeof(U) * n <= kSize && alignof(U) <= alignof(std::max_align_t) &&
+        !storage->in_use.exchange(true, std::memory_order_acquire))
+      {
+        return reinterpret_cast<U *>(storage->buffer);
+      }
+      return std::allocator<U>().allocate(n);
+    }
+
+    void
+    deallocate(U * p, size_t n)
+    {
+      if (reinterpret_cast<unsigned char *>(p) == storage->buffer) {
+        storage->in_use.store(false, std::memory_order_release);
+        return;
+      }
+      std::allocator<U>().deallocate(p, n);
+    }
+
+    template<typename V>
+    bool
+    operator==(const Allocator<V> & other) const
+    {
+      return storage == other.storage;
+    }
+
+    template<typename V>
+    bool
+    operator!=(const Allocator<V> & other) const
+    {
+      return storage != other.storage;
+    }
+
+    std::shared_ptr<Storage> storage;
+  };
+
+  std::shared_ptr<Storage> storage_;
+};
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__TAKEN_DATA_SLOT_HPP_
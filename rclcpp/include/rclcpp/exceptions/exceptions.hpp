@@ -328,6 +328,13 @@ class QoSCheckCompatibleException : public std::runtime_error
   using std::runtime_error::runtime_error;
 };
 
+/// Set on the future of a service request which got no response before its timeout.
+class RequestTimeoutError : public std::runtime_error
+{
+  // Inherit constructors from runtime_error.
+  using std::runtime_error::runtime_error;
+};
+
 }  // namespace exceptions
 }  // namespace rclcpp
 
@@ -16,6 +16,7 @@
 #define RCLCPP__EXECUTOR_HPP_
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <cstdlib>
@@ -33,6 +34,8 @@
 
 #include "rclcpp/context.hpp"
 #include "rclcpp/contexts/default_context.hpp"
+#include "rclcpp/detail/future_waiters.hpp"
+#include "rclcpp/detail/intra_process_pipeline.hpp"
 #include "rclcpp/guard_condition.hpp"
 #include "rclcpp/executor_options.hpp"
 #include "rclcpp/future_return_code.hpp"
@@ -327,6 +330,8 @@ public:
    *   `-1` is block forever, `0` is non-blocking.
    *   If the time spent inside the blocking loop exceeds this timeout, return a TIMEOUT return
    *   code.
+   * The futures of the service and action clients wake up the executor when they complete,
+   * even if their clients are executed by another thread, so that it then returns right away.
    * \return The return code, one of `SUCCESS`, `INTERRUPTED`, or `TIMEOUT`.
    */
   template<typename FutureT, typename TimeRepT = int64_t, typename TimeT = std::milli>
@@ -357,6 +362,8 @@ public:
       throw std::runtime_error("spin_until_future_complete() called while already spinning");
     }
     RCPPUTILS_SCOPE_EXIT(this->spinning.store(false); );
+    // The clients executed by other threads interrupt the wait when they complete a future.
+    rclcpp::detail::FutureWaiter future_waiter(interrupt_guard_condition_);
     while (rclcpp::ok(this->context_) && spinning.load()) {
       // Do one item of work.
       spin_once_impl(timeout_left);
@@ -386,10 +393,11 @@ public:
   /// Cancel any running spin* function, causing it to return.
   /**
    * This function can be called asynchonously from any thread.
+   * Executors overriding it to wake their own threads must call it too.
    * \throws std::runtime_error if there is an issue triggering the guard condition
    */
   RCLCPP_PUBLIC
-  void
+  virtual void
   cancel();
 
   /// Support dynamic switching of the memory strategy.
@@ -433,6 +441,14 @@ protected:
   void
   execute_any_executable(AnyExecutable & any_exec);
 
+  /// Execute the intra-process subscriptions queued in a pipeline, until it's empty.
+  /**
+   * \sa ExecutorOptions::run_intra_process_consumers_inline
+   */
+  RCLCPP_PUBLIC
+  void
+  execute_pipelined_subscriptions(rclcpp::detail::IntraProcessPipeline & pipeline);
+
   RCLCPP_PUBLIC
   static void
   execute_subscription(
@@ -554,6 +570,18 @@ protected:
   /// The context associated with this executor.
   std::shared_ptr<rclcpp::Context> context_;
 
+  /// Order in which ready entities are executed.
+  const rclcpp::ExecutorSchedulingPolicy scheduling_policy_;
+
+  /// Whether the intra-process subscriptions are executed right after their publishers.
+  const bool run_intra_process_consumers_inline_;
+
+  /// Collector of the latency statistics, null if they are not collected.
+  const rclcpp::ExecutorStatistics::SharedPtr statistics_;
+
+  /// Time at which rcl_wait() last returned, only updated when collecting statistics.
+  std::atomic<std::chrono::steady_clock::rep> last_wait_end_{0};
+
   RCLCPP_DISABLE_COPY(Executor)
 
   RCLCPP_PUBLIC
@@ -585,6 +613,21 @@ protected:
   std::list<rclcpp::node_interfaces::NodeBaseInterface::WeakPtr>
   weak_nodes_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
 
+  typedef std::map<rclcpp::node_interfaces::NodeBaseInterface::WeakPtr,
+      size_t,
+      std::owner_less<rclcpp::node_interfaces::NodeBaseInterface::WeakPtr>>
+    WeakNodesToNumberOfCallbackGroupsMap;
+
+  /// number of callback groups of each node in the executor, instead of searching the maps
+  WeakNodesToNumberOfCallbackGroupsMap
+  weak_nodes_to_number_of_callback_groups_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+
+  /// Count one callback group less for a node, returning true if it has some left.
+  bool
+  remove_callback_group_of_node(
+    const rclcpp::node_interfaces::NodeBaseInterface::WeakPtr & weak_node_ptr)
+  RCPPUTILS_TSA_REQUIRES(mutex_);
+
   /// shutdown callback handle registered to Context
   rclcpp::OnShutdownCallbackHandle shutdown_callback_handle_;
 };
@@ -15,15 +15,35 @@
 #ifndef RCLCPP__EXECUTOR_OPTIONS_HPP_
 #define RCLCPP__EXECUTOR_OPTIONS_HPP_
 
+#include <chrono>
+#include <vector>
+
 #include "rclcpp/context.hpp"
 #include "rclcpp/contexts/default_context.hpp"
+#include "rclcpp/executor_statistics.hpp"
 #include "rclcpp/memory_strategies.hpp"
 #include "rclcpp/memory_strategy.hpp"
+#include "rclcpp/thread_attributes.hpp"
 #include "rclcpp/visibility_control.hpp"
 
 namespace rclcpp
 {
 
+/// Order in which an executor runs the entities which are ready at the same time.
+enum class ExecutorSchedulingPolicy
+{
+  /// Timers, then subscriptions, services, clients and waitables, in the order they were added.
+  FixedOrder,
+  /// The entities of the callback groups with the highest CallbackGroup::get_priority() first.
+  Priority,
+  /// The entities of the callback groups with the earliest CallbackGroup::get_deadline() first.
+  /**
+   * As the executor finds all the ready entities at once, this is the group
+   * with the shortest relative deadline, using the priority to break ties.
+   */
+  EarliestDeadlineFirst,
+};
+
 /// Options to be passed to the executor constructor.
 struct ExecutorOptions
 {
@@ -36,6 +56,44 @@ struct ExecutorOptions
   rclcpp::memory_strategy::MemoryStrategy::SharedPtr memory_strategy;
   rclcpp::Context::SharedPtr context;
   size_t max_conditions;
+
+  /// Attributes of the threads of multi-threaded executors, indexed by thread number.
+  /**
+   * Threads without an entry keep the default attributes.
+   */
+  std::vector<rclcpp::ThreadAttributes> thread_attributes;
+
+  /// Order in which the ready entities are executed.
+  /**
+   * Only used by the executors built on Executor::get_next_ready_executable().
+   */
+  ExecutorSchedulingPolicy scheduling_policy = ExecutorSchedulingPolicy::FixedOrder;
+
+  /// Execute the intra-process subscriptions right after the callbacks publishing to them.
+  /**
+   * The subscriptions of the callback groups of the executor which receive an intra-process
+   * message from a callback are then executed by the same thread as soon as it returns,
+   * instead of when the executor waits again, cutting the latency of the pipelines of nodes.
+   * A subscription of a mutually exclusive group executing on another thread is left to the
+   * wait, and the executor doesn't wait while the subscriptions publish to each other.
+   * Only used by the executors built on Executor::execute_any_executable().
+   */
+  bool run_intra_process_consumers_inline = false;
+
+  /// Collector of the latency statistics of the executor, none are collected if null.
+  rclcpp::ExecutorStatistics::SharedPtr statistics;
+
+  /// How long spin() keeps polling the entities after the last one was ready, 0 to never poll.
+  /**
+   * When positive, the executor doesn't block waiting for the entities while some were ready
+   * within this duration, it checks them again and again without a timeout instead, which
+   * cuts the wake up latency but keeps a core busy.
+   * Once idle for this duration, it blocks waiting as usual until an entity is ready.
+   * The thread calling spin() is then given the first thread_attributes, if any, to pin it
+   * to a dedicated core for example.
+   * Only used by rclcpp::executors::StaticSingleThreadedExecutor.
+   */
+  std::chrono::nanoseconds busy_polling_duration{0};
 };
 
 }  // namespace rclcpp
@@ -0,0 +1,314 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXECUTOR_STATISTICS_HPP_
+#define RCLCPP__EXECUTOR_STATISTICS_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "libstatistics_collector/moving_average_statistics/types.hpp"
+
+#include "rclcpp/any_executable.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/shared_memory_counters.hpp"
+#include "rclcpp/topic_statistics/percentile_histogram.hpp"
+#include "rclcpp/topic_statistics/statistics_accumulator.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Copy of the content of a LatencyHistogram.
+struct LatencyHistogramSnapshot
+{
+  /// Number of buckets, the first one counts durations under 1 microsecond.
+  /**
+   * Bucket i > 0 counts durations in [2^(i - 1), 2^i) microseconds, except
+   * the last one which also counts all the longer durations.
+   */
+  static constexpr size_t number_of_buckets = 32;
+
+  uint64_t count = 0;
+  std::chrono::nanoseconds total{0};
+  std::chrono::nanoseconds max{0};
+  std::array<uint64_t, number_of_buckets> buckets{};
+
+  /// Get the average of the recorded durations, or 0 if there are none.
+  RCLCPP_PUBLIC
+  std::chrono::nanoseconds
+  mean() const;
+
+  /// Get an upper bound of the given percentile, with the resolution of the buckets.
+  /**
+   * \param[in] percentile in [0, 100]
+   * \return the upper bound of the bucket containing the percentile, or max
+   *   if it is in the last bucket
+   */
+  RCLCPP_PUBLIC
+  std::chrono::nanoseconds
+  percentile(double percentile) const;
+};
+
+/// Histogram of durations, which can be recorded concurrently without locking.
+class LatencyHistogram
+{
+public:
+  RCLCPP_PUBLIC
+  void
+  record(std::chrono::nanoseconds duration);
+
+  RCLCPP_PUBLIC
+  LatencyHistogramSnapshot
+  get_snapshot() const;
+
+  RCLCPP_PUBLIC
+  void
+  reset();
+
+private:
+  std::atomic<uint64_t> count_{0};
+  std::atomic<int64_t> total_ns_{0};
+  std::atomic<int64_t> max_ns_{0};
+  std::array<std::atomic<uint64_t>, LatencyHistogramSnapshot::number_of_buckets> buckets_{};
+};
+
+/// Statistics of an entity, or of all the entities of a callback group.
+struct ExecutableStatisticsSnapshot
+{
+  /// Kind and name of the entity, or "callback_group" for callback groups.
+  std::string description;
+
+  /// Time between the executor waking up on the entity being ready and the callback starting.
+  /**
+   * This includes the time spent running the other callbacks which were ready
+   * at the same time, or waiting for a thread to be available.
+   */
+  LatencyHistogramSnapshot dispatch_latency;
+
+  /// Time spent executing the callback.
+  LatencyHistogramSnapshot callback_duration;
+};
+
+/// Statistics of the loop of an executor over a window of time.
+struct ExecutorLoopStatistics
+{
+  using StatisticData = libstatistics_collector::moving_average_statistics::StatisticData;
+
+  /// Duration of the window.
+  std::chrono::nanoseconds window_duration{0};
+
+  /// Number of entities in the wait set, for each wait.
+  StatisticData wait_set_size;
+
+  /// Time spent in rcl_wait() in milliseconds, whose sample count is the number of wakeups.
+  StatisticData wait_duration;
+
+  /// Time spent collecting the entities and filling the wait set in milliseconds.
+  StatisticData collection_duration;
+
+  /// Time spent executing each callback in milliseconds.
+  StatisticData execution_duration;
+
+  /// Percentiles of the time spent executing each callback in milliseconds.
+  topic_statistics::PercentileStatistics execution_duration_percentiles;
+
+  /// Fraction of the window each thread spent in rcl_wait(), one sample per thread.
+  /**
+   * Only the threads which waited or executed a callback during the window are counted.
+   */
+  StatisticData idle_ratio;
+
+  /// Number of threads of the executor at the end of the window, 0 if it doesn't report it.
+  size_t thread_pool_size = 0;
+
+  /// Get the number of wakeups per second during the window, or 0 if it is empty.
+  double
+  wakeups_per_second() const
+  {
+    if (window_duration <= std::chrono::nanoseconds::zero()) {
+      return 0.;
+    }
+    const double seconds = std::chrono::duration<double>(window_duration).count();
+    return static_cast<double>(wait_duration.sample_count) / seconds;
+  }
+};
+
+/// Latency statistics collected by an executor.
+/**
+ * Pass an instance through rclcpp::ExecutorOptions::statistics to collect
+ * the statistics of the executors built on Executor::execute_any_executable().
+ * Nothing is measured when no instance is given.
+ *
+ * Entities are identified by the address of their rclcpp object, e.g.
+ * `subscription.get()` for a rclcpp::SubscriptionBase::SharedPtr, and callback
+ * groups by `callback_group.get()`.
+ * Recording is thread-safe, an exclusive lock is only taken when an entity or
+ * a thread is seen for the first time.
+ *
+ * Besides the cumulative latency statistics, the health of the loop of the executor
+ * is accumulated over windows, which take_loop_statistics() returns.
+ */
+class ExecutorStatistics
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(ExecutorStatistics)
+
+  RCLCPP_PUBLIC
+  ExecutorStatistics();
+
+  /// Record the time an executor spent collecting its entities into a wait set.
+  RCLCPP_PUBLIC
+  void
+  record_collection(std::chrono::nanoseconds duration, size_t wait_set_size);
+
+  /// Record the time the calling thread of an executor was blocked waiting for work.
+  RCLCPP_PUBLIC
+  void
+  record_wait(std::chrono::nanoseconds duration);
+
+  /// Record the execution of the callback of an AnyExecutable.
+  RCLCPP_PUBLIC
+  void
+  record_execution(
+    const rclcpp::AnyExecutable & any_exec,
+    std::chrono::nanoseconds dispatch_latency,
+    std::chrono::nanoseconds callback_duration);
+
+  /// Record the number of threads the executor currently runs.
+  RCLCPP_PUBLIC
+  void
+  record_thread_pool_size(size_t size);
+
+  /// Get the number of threads last recorded by record_thread_pool_size(), 0 if none.
+  RCLCPP_PUBLIC
+  size_t
+  get_thread_pool_size() const;
+
+  /// Get the distribution of the time spent waiting for work.
+  RCLCPP_PUBLIC
+  LatencyHistogramSnapshot
+  get_wait_time() const;
+
+  /// Get the statistics of the entities executed so far, indexed by entity address.
+  RCLCPP_PUBLIC
+  std::unordered_map<const void *, ExecutableStatisticsSnapshot>
+  get_entity_statistics() const;
+
+  /// Get the statistics of the callback groups executed so far, indexed by group address.
+  RCLCPP_PUBLIC
+  std::unordered_map<const void *, ExecutableStatisticsSnapshot>
+  get_callback_group_statistics() const;
+
+  /// Get the statistics of the loop since the previous call, and start a new window.
+  RCLCPP_PUBLIC
+  ExecutorLoopStatistics
+  take_loop_statistics();
+
+  /// Clear all the recorded statistics.
+  RCLCPP_PUBLIC
+  void
+  reset();
+
+  /// Also export the loop counters of the executor to shared memory counters.
+  /**
+   * The counters are named after the prefix: `<prefix>.wakeups`, `<prefix>.wait_ns`,
+   * `<prefix>.collection_ns`, `<prefix>.wait_set_size`, which is the size of the last
+   * wait set, `<prefix>.executions`, `<prefix>.execution_ns` and `<prefix>.thread_pool_size`.
+   * The durations are cumulative, in nanoseconds.
+   *
+   * This must be called before the executor spins, and only once.
+   * \param[in] counters shared memory counters to add the counters to.
+   * \param[in] prefix prefix of the names of the counters, e.g. the name of the executor.
+   * \throws std::invalid_argument if counters is null.
+   * \throws std::runtime_error if the counters are already exported.
+   */
+  RCLCPP_PUBLIC
+  void
+  export_counters(
+    rclcpp::SharedMemoryCounters::SharedPtr counters,
+    const std::string & prefix = "executor");
+
+private:
+  RCLCPP_DISABLE_COPY(ExecutorStatistics)
+
+  struct ExecutableStatistics
+  {
+    std::string description;
+    LatencyHistogram dispatch_latency;
+    LatencyHistogram callback_duration;
+  };
+
+  using ExecutableStatisticsMap =
+    std::unordered_map<const void *, std::unique_ptr<ExecutableStatistics>>;
+
+  struct ThreadStatistics
+  {
+    std::atomic<int64_t> idle_ns{0};
+    std::atomic<int64_t> busy_ns{0};
+  };
+
+  ThreadStatistics &
+  get_thread_statistics();
+
+  struct ExportedCounters
+  {
+    rclcpp::SharedMemoryCounters::SharedPtr counters;
+    std::atomic<uint64_t> * wakeups;
+    std::atomic<uint64_t> * wait_ns;
+    std::atomic<uint64_t> * collection_ns;
+    std::atomic<uint64_t> * wait_set_size;
+    std::atomic<uint64_t> * executions;
+    std::atomic<uint64_t> * execution_ns;
+    std::atomic<uint64_t> * thread_pool_size;
+  };
+
+  ExecutableStatistics &
+  get_executable_statistics(
+    ExecutableStatisticsMap & map,
+    const void * key,
+    const char * kind,
+    const char * name);
+
+  static
+  std::unordered_map<const void *, ExecutableStatisticsSnapshot>
+  get_snapshots(const ExecutableStatisticsMap & map);
+
+  LatencyHistogram wait_time_;
+
+  topic_statistics::StatisticsAccumulator wait_set_size_;
+  topic_statistics::StatisticsAccumulator wait_duration_;
+  topic_statistics::StatisticsAccumulator collection_duration_;
+  topic_statistics::StatisticsAccumulator execution_duration_;
+  std::atomic<std::chrono::steady_clock::rep> loop_window_start_;
+  std::atomic<size_t> thread_pool_size_{0};
+  std::unique_ptr<ExportedCounters> exported_counters_;
+
+  // Protects the maps, not the statistics they point to.
+  mutable std::shared_timed_mutex mutex_;
+  ExecutableStatisticsMap entities_;
+  ExecutableStatisticsMap callback_groups_;
+  std::unordered_map<std::thread::id, std::unique_ptr<ThreadStatistics>> threads_;
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXECUTOR_STATISTICS_HPP_
@@ -0,0 +1,188 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXECUTOR_STATISTICS_PUBLISHER_HPP_
+#define RCLCPP__EXECUTOR_STATISTICS_PUBLISHER_HPP_
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rclcpp/callback_group.hpp"
+#include "rclcpp/create_publisher.hpp"
+#include "rclcpp/create_timer.hpp"
+#include "rclcpp/executor_statistics.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/node_interfaces/get_node_topics_interface.hpp"
+#include "rclcpp/publisher.hpp"
+#include "rclcpp/qos.hpp"
+#include "rclcpp/time.hpp"
+#include "rclcpp/timer.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+#include "statistics_msgs/msg/metrics_message.hpp"
+
+namespace rclcpp
+{
+
+constexpr const char kExecutorWaitSetSizeStatName[]{"executor_wait_set_size"};
+constexpr const char kExecutorWakeupsStatName[]{"executor_wakeups"};
+constexpr const char kExecutorWaitDurationStatName[]{"executor_wait_duration"};
+constexpr const char kExecutorCollectionDurationStatName[]{"executor_collection_duration"};
+constexpr const char kExecutorExecutionDurationStatName[]{"executor_execution_duration"};
+constexpr const char kExecutorIdleRatioStatName[]{"executor_idle_ratio"};
+constexpr const char kCallbackGroupCpuUsageStatName[]{"callback_group_cpu_usage"};
+constexpr const char kCallbackGroupExecutionsStatName[]{"callback_group_executions"};
+constexpr const char kCallbackGroupOverrunsStatName[]{"callback_group_overruns"};
+
+/// Publisher of the loop statistics of an executor, as statistics_msgs/msg/MetricsMessage.
+/**
+ * Each window of ExecutorStatistics::take_loop_statistics() is published as one message
+ * per metric: the size of the wait set, the wakeups per second, the durations of the waits,
+ * of the collections and of the executions, and the idle ratio of the threads.
+ * The CPU time of the callback groups added with add_callback_group() is also published
+ * for each window: the ratio of the window the group used the CPU, its number of
+ * executions and its number of overruns.
+ *
+ * Use create_executor_statistics_publisher() to publish them periodically.
+ */
+class ExecutorStatisticsPublisher
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(ExecutorStatisticsPublisher)
+
+  using StatisticsPublisher =
+    rclcpp::Publisher<statistics_msgs::msg::MetricsMessage, std::allocator<void>>;
+
+  /// Construct an ExecutorStatisticsPublisher object.
+  /**
+   * \param source_name the name the statistics are published with, e.g. the node name
+   * \param statistics statistics collected by the executor
+   * \param publisher publisher used to publish the statistics data, which this class owns
+   * \throws std::invalid_argument if statistics or publisher is nullptr
+   */
+  RCLCPP_PUBLIC
+  ExecutorStatisticsPublisher(
+    const std::string & source_name,
+    rclcpp::ExecutorStatistics::SharedPtr statistics,
+    std::shared_ptr<StatisticsPublisher> publisher);
+
+  RCLCPP_PUBLIC
+  virtual ~ExecutorStatisticsPublisher();
+
+  /// Set the timer used to publish statistics messages.
+  RCLCPP_PUBLIC
+  void
+  set_publisher_timer(rclcpp::TimerBase::SharedPtr publisher_timer);
+
+  /// Also publish the CPU time accounting of a callback group.
+  /**
+   * Its statistics are published with the source name followed by "/" and the name
+   * of the group, while it lives.
+   * The CPU accounting of the group must be enabled.
+   *
+   * \param name name of the group in the statistics
+   * \param callback_group the group
+   * \throws std::invalid_argument if the group is nullptr
+   */
+  RCLCPP_PUBLIC
+  void
+  add_callback_group(const std::string & name, rclcpp::CallbackGroup::SharedPtr callback_group);
+
+  /// Publish the loop statistics measured since the previous call.
+  RCLCPP_PUBLIC
+  virtual
+  void
+  publish_message_and_reset_measurements();
+
+private:
+  struct CallbackGroupEntry
+  {
+    std::string source_name;
+    rclcpp::CallbackGroup::WeakPtr callback_group;
+    // Totals at the start of the window
+    rclcpp::CallbackGroupCpuStatistics previous_statistics;
+  };
+
+  void
+  publish_callback_groups(const rclcpp::Time & window_end);
+
+  const std::string source_name_;
+  const rclcpp::ExecutorStatistics::SharedPtr statistics_;
+  std::shared_ptr<StatisticsPublisher> publisher_;
+  rclcpp::TimerBase::SharedPtr publisher_timer_;
+  rclcpp::Time window_start_;
+  std::mutex callback_groups_mutex_;
+  std::vector<CallbackGroupEntry> callback_groups_;
+};
+
+/// Periodically publish the loop statistics of an executor on a topic of a node.
+/**
+ * The executor must have been constructed with the statistics in its ExecutorOptions.
+ * The statistics are published as long as the returned object and the node live, and
+ * when the node is spun.
+ *
+ * \param[in] node node publishing the statistics, with its name as source name
+ * \param[in] statistics statistics collected by the executor
+ * \param[in] publish_period period at which the statistics are published
+ * \param[in] publish_topic topic the statistics are published on
+ * \throws std::invalid_argument if the publish period isn't positive
+ */
+template<typename NodeT>
+ExecutorStatisticsPublisher::SharedPtr
+create_executor_statistics_publisher(
+  NodeT && node,
+  rclcpp::ExecutorStatistics::SharedPtr statistics,
+  std::chrono::milliseconds publish_period = std::chrono::seconds(1),
+  const std::string & publish_topic = "/statistics")
+{
+  if (publish_period <= std::chrono::milliseconds(0)) {
+    throw std::invalid_argument(
+            "the publish period of executor statistics must be greater than 0, "
+            "specified value of " + std::to_string(publish_period.count()) + " ms");
+  }
+  auto node_topics = rclcpp::node_interfaces::get_node_topics_interface(node);
+
+  auto statistics_publisher = rclcpp::create_publisher<statistics_msgs::msg::MetricsMessage>(
+    node, publish_topic, rclcpp::QoS(10));
+  auto executor_statistics_publisher = std::make_shared<ExecutorStatisticsPublisher>(
+    node_topics->get_node_base_interface()->get_name(),
+    std::move(statistics),
+    statistics_publisher);
+
+  std::weak_ptr<ExecutorStatisticsPublisher> weak_executor_statistics_publisher(
+    executor_statistics_publisher);
+  auto timer = rclcpp::create_wall_timer(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(publish_period),
+    [weak_executor_statistics_publisher]() {
+      auto executor_statistics_publisher = weak_executor_statistics_publisher.lock();
+      if (executor_statistics_publisher) {
+        executor_statistics_publisher->publish_message_and_reset_measurements();
+      }
+    },
+    nullptr,
+    node_topics->get_node_base_interface(),
+    node_topics->get_node_timers_interface());
+  executor_statistics_publisher->set_publisher_timer(timer);
+
+  return executor_statistics_publisher;
+}
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXECUTOR_STATISTICS_PUBLISHER_HPP_
@@ -18,9 +18,15 @@
 #include <future>
 #include <memory>
 
+#include "rclcpp/executors/compile_time_executor.hpp"
+#include "rclcpp/executors/events_executor.hpp"
 #include "rclcpp/executors/multi_threaded_executor.hpp"
+#include "rclcpp/executors/simulation_executor.hpp"
 #include "rclcpp/executors/single_threaded_executor.hpp"
+#include "rclcpp/executors/static_multi_threaded_executor.hpp"
 #include "rclcpp/executors/static_single_threaded_executor.hpp"
+#include "rclcpp/executors/time_triggered_executor.hpp"
+#include "rclcpp/executors/work_stealing_multi_threaded_executor.hpp"
 #include "rclcpp/node.hpp"
 #include "rclcpp/utilities.hpp"
 #include "rclcpp/visibility_control.hpp"
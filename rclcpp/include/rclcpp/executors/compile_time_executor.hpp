@@ -0,0 +1,356 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__EXECUTORS__COMPILE_TIME_EXECUTOR_HPP_
+#define RCLCPP__EXECUTORS__COMPILE_TIME_EXECUTOR_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "rcl/wait.h"
+#include "rcpputils/scope_exit.hpp"
+
+#include "rclcpp/context.hpp"
+#include "rclcpp/contexts/default_context.hpp"
+#include "rclcpp/guard_condition.hpp"
+#include "rclcpp/logging.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/message_info.hpp"
+#include "rclcpp/subscription.hpp"
+#include "rclcpp/timer.hpp"
+#include "rclcpp/utilities.hpp"
+#include "rclcpp/wait_set.hpp"
+
+namespace rclcpp
+{
+namespace executors
+{
+
+/// Subscription executed by a CompileTimeExecutor, with a callback of any callable type.
+/**
+ * The messages are taken into a message owned by the handler, which is reused,
+ * and passed to the callback as `callback(message)` or `callback(message, message_info)`.
+ * The callback the subscription was created with is never called, nor is the
+ * intra process communication handled, so it should be disabled.
+ */
+template<typename SubscriptionT, typename CallbackT>
+class CompileTimeSubscription
+{
+public:
+  using MessageT = typename SubscriptionT::ROSMessageType;
+  static constexpr bool is_timer = false;
+
+  CompileTimeSubscription(std::shared_ptr<SubscriptionT> subscription, CallbackT callback)
+  : subscription_(std::move(subscription)), callback_(std::move(callback))
+  {
+    if (!subscription_) {
+      throw std::invalid_argument("the subscription of a compile time executor is null");
+    }
+  }
+
+  const std::shared_ptr<SubscriptionT> &
+  get_subscription() const
+  {
+    return subscription_;
+  }
+
+  /// Take a message and call the callback with it, returning false if none was taken.
+  bool
+  execute()
+  {
+    if (!subscription_->take(message_, message_info_)) {
+      return false;
+    }
+    if constexpr (std::is_invocable_v<CallbackT &, const MessageT &, const rclcpp::MessageInfo &>) {
+      callback_(message_, message_info_);
+    } else {
+      callback_(message_);
+    }
+    return true;
+  }
+
+private:
+  std::shared_ptr<SubscriptionT> subscription_;
+  CallbackT callback_;
+  MessageT message_;
+  rclcpp::MessageInfo message_info_;
+};
+
+/// Wall timer executed by a CompileTimeExecutor, with a callback of any callable type.
+template<typename CallbackT>
+class CompileTimeTimer
+{
+public:
+  using TimerT = rclcpp::WallTimer<rclcpp::VoidCallbackType>;
+  static constexpr bool is_timer = true;
+
+  /// Create a wall timer calling the callback with no argument at the given period.
+  CompileTimeTimer(
+    std::chrono::nanoseconds period,
+    CallbackT callback,
+    rclcpp::Context::SharedPtr context = rclcpp::contexts::get_global_default_context())
+  : timer_(std::make_shared<TimerT>(period, []() {}, std::move(context))),
+    callback_(std::move(callback))
+  {}
+
+  const std::shared_ptr<TimerT> &
+  get_timer() const
+  {
+    return timer_;
+  }
+
+  /// Call the callback if the timer wasn't canceled, returning false otherwise.
+  bool
+  execute()
+  {
+    // The qualified call isn't dispatched through the vtable
+    if (!timer_->TimerT::call()) {
+      return false;
+    }
+    callback_();
+    return true;
+  }
+
+private:
+  std::shared_ptr<TimerT> timer_;
+  CallbackT callback_;
+};
+
+namespace detail
+{
+
+/// Return the position of a handler among the handlers of the same kind.
+template<typename ... HandlerTs>
+constexpr size_t
+get_index_in_kind(size_t handler_index)
+{
+  const bool is_timer[] = {HandlerTs::is_timer ...};
+  size_t index = 0;
+  for (size_t i = 0; i < handler_index; ++i) {
+    if (is_timer[i] == is_timer[handler_index]) {
+      ++index;
+    }
+  }
+  return index;
+}
+
+/// Return the position of the nth timer, or of the nth subscription, among the handlers.
+template<typename ... HandlerTs>
+constexpr size_t
+get_handler_index(bool timer, size_t n)
+{
+  const bool is_timer[] = {HandlerTs::is_timer ...};
+  for (size_t i = 0; i < sizeof...(HandlerTs); ++i) {
+    if (is_timer[i] == timer && n-- == 0) {
+      return i;
+    }
+  }
+  return sizeof...(HandlerTs);
+}
+
+}  // namespace detail
+
+/// Executor of a set of subscriptions and timers fixed at compile time.
+/**
+ * The handlers are the CompileTimeSubscription and CompileTimeTimer given to the
+ * constructor, and their types are template parameters of the executor.
+ * They're waited on with a rclcpp::StaticWaitSet, and the ready ones are executed in
+ * the order they were given, with inlined calls: there is no std::function, virtual
+ * call, weak pointer locking or allocation between waking up and calling a callback.
+ *
+ * The entities of the handlers mustn't be added to another executor.
+ * Spinning isn't thread-safe, only cancel() can be called concurrently.
+ *
+ * ```cpp
+ * auto subscription = node->create_subscription<MessageT>(
+ *   "topic", 10, [](MessageT::ConstSharedPtr) {});
+ * rclcpp::executors::CompileTimeExecutor executor(
+ *   node->get_node_base_interface()->get_context(),
+ *   rclcpp::executors::CompileTimeSubscription(subscription, [](const MessageT & msg) {...}),
+ *   rclcpp::executors::CompileTimeTimer(10ms, []() {...}));
+ * executor.spin();
+ * ```
+ */
+template<typename ... HandlerTs>
+class CompileTimeExecutor
+{
+public:
+  static constexpr size_t number_of_timers = (size_t(0) + ... + size_t(HandlerTs::is_timer));
+  static constexpr size_t number_of_subscriptions = sizeof...(HandlerTs) - number_of_timers;
+
+  using WaitSetT = rclcpp::StaticWaitSet<number_of_subscriptions, 1, number_of_timers, 0, 0, 0>;
+
+  /// Constructor.
+  /**
+   * \param[in] context context of the entities, which interrupts spinning on shutdown.
+   * \param[in] handlers handlers of the entities to execute.
+   */
+  explicit CompileTimeExecutor(rclcpp::Context::SharedPtr context, HandlerTs ... handlers)
+  : CompileTimeExecutor(
+      std::move(context),
+      std::make_index_sequence<number_of_subscriptions>(),
+      std::make_index_sequence<number_of_timers>(),
+      std::move(handlers)...)
+  {}
+
+  ~CompileTimeExecutor()
+  {
+    if (!context_->remove_on_shutdown_callback(shutdown_callback_handle_)) {
+      RCLCPP_ERROR(
+        rclcpp::get_logger("rclcpp"),
+        "failed to remove the on_shutdown callback of a compile time executor");
+    }
+  }
+
+  /// Execute the handlers as they become ready, until canceled or shut down.
+  /**
+   * \throws std::runtime_error if called while already spinning.
+   */
+  void
+  spin()
+  {
+    if (spinning_.exchange(true)) {
+      throw std::runtime_error("spin() called while already spinning");
+    }
+    RCPPUTILS_SCOPE_EXIT(this->spinning_.store(false); );
+    while (rclcpp::ok(context_) && spinning_.load()) {
+      execute_ready_handlers(std::chrono::nanoseconds(-1));
+    }
+  }
+
+  /// Wait once for handlers to be ready, and execute them.
+  /**
+   * \param[in] timeout how long to wait, forever if negative.
+   * \return the number of callbacks called.
+   */
+  size_t
+  spin_once(std::chrono::nanoseconds timeout = std::chrono::nanoseconds(-1))
+  {
+    return execute_ready_handlers(timeout);
+  }
+
+  /// Stop spin() and interrupt the current wait, if any.
+  void
+  cancel()
+  {
+    spinning_.store(false);
+    guard_condition_->trigger();
+  }
+
+  /// Get a handler, by its position in the handlers given to the constructor.
+  template<size_t I>
+  auto &
+  get_handler()
+  {
+    return std::get<I>(handlers_);
+  }
+
+private:
+  RCLCPP_DISABLE_COPY(CompileTimeExecutor)
+
+  template<size_t ... SubscriptionIs, size_t ... TimerIs>
+  CompileTimeExecutor(
+    rclcpp::Context::SharedPtr context,
+    std::index_sequence<SubscriptionIs...>,
+    std::index_sequence<TimerIs...>,
+    HandlerTs && ... handlers)
+  : context_(std::move(context)),
+    handlers_(std::move(handlers)...),
+    guard_condition_(std::make_shared<rclcpp::GuardCondition>(context_)),
+    wait_set_(
+      {{get_handler_entity<detail::get_handler_index<HandlerTs...>(false, SubscriptionIs)>()...}},
+      {{guard_condition_}},
+      {{get_handler_entity<detail::get_handler_index<HandlerTs...>(true, TimerIs)>()...}},
+      {}, {}, {},
+      context_)
+  {
+    shutdown_callback_handle_ = context_->add_on_shutdown_callback(
+      [weak_gc = std::weak_ptr<rclcpp::GuardCondition>{guard_condition_}]() {
+        auto strong_gc = weak_gc.lock();
+        if (strong_gc) {
+          strong_gc->trigger();
+        }
+      });
+  }
+
+  template<size_t I>
+  auto
+  get_handler_entity() const
+  {
+    const auto & handler = std::get<I>(handlers_);
+    if constexpr (std::tuple_element_t<I, std::tuple<HandlerTs...>>::is_timer) {
+      return std::static_pointer_cast<rclcpp::TimerBase>(handler.get_timer());
+    } else {
+      return std::static_pointer_cast<rclcpp::SubscriptionBase>(handler.get_subscription());
+    }
+  }
+
+  size_t
+  execute_ready_handlers(std::chrono::nanoseconds timeout)
+  {
+    auto wait_result = wait_set_.wait(timeout);
+    if (wait_result.kind() != rclcpp::WaitResultKind::Ready) {
+      return 0u;
+    }
+    return execute_ready_handlers(
+      wait_set_.get_rcl_wait_set(), std::index_sequence_for<HandlerTs...>());
+  }
+
+  template<size_t ... Is>
+  size_t
+  execute_ready_handlers(const rcl_wait_set_t & rcl_wait_set, std::index_sequence<Is...>)
+  {
+    size_t number_of_callbacks = 0u;
+    // The comma fold executes them in order
+    ((number_of_callbacks += execute_if_ready<Is>(rcl_wait_set)), ...);
+    (void)rcl_wait_set;
+    return number_of_callbacks;
+  }
+
+  template<size_t I>
+  size_t
+  execute_if_ready(const rcl_wait_set_t & rcl_wait_set)
+  {
+    constexpr size_t index = detail::get_index_in_kind<HandlerTs...>(I);
+    if constexpr (std::tuple_element_t<I, std::tuple<HandlerTs...>>::is_timer) {
+      if (!rcl_wait_set.timers[index]) {
+        return 0u;
+      }
+    } else {
+      if (!rcl_wait_set.subscriptions[index]) {
+        return 0u;
+      }
+    }
+    return std::get<I>(handlers_).execute() ? 1u : 0u;
+  }
+
+  rclcpp::Context::SharedPtr context_;
+  std::tuple<HandlerTs...> handlers_;
+  std::shared_ptr<rclcpp::GuardCondition> guard_condition_;
+  WaitSetT wait_set_;
+  rclcpp::OnShutdownCallbackHandle shutdown_callback_handle_;
+  std::atomic_bool spinning_{false};
+};
+
+}  // namespace executors
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXECUTORS__COMPILE_TIME_EXECUTOR_HPP_
@@ -0,0 +1,260 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXECUTORS__EVENTS_EXECUTOR_HPP_
+#define RCLCPP__EXECUTORS__EVENTS_EXECUTOR_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "rclcpp/executor.hpp"
+#include "rclcpp/executors/events_executor_event_types.hpp"
+#include "rclcpp/experimental/buffers/events_queue.hpp"
+#include "rclcpp/experimental/buffers/simple_events_queue.hpp"
+#include "rclcpp/experimental/timers_manager.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/node.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace executors
+{
+
+/// Single-threaded executor driven by the "on ready" callbacks of the entities.
+/**
+ * Instead of collecting all the entities and rebuilding a wait set every time
+ * it waits for work, this executor registers a callback on every entity
+ * (subscriptions, services, clients, waitables and, through a TimersManager,
+ * timers).
+ * The callbacks push an ExecutorEvent into an EventsQueue, which the executor
+ * thread drains, so the cost of an iteration depends on the number of ready
+ * events rather than on the number of entities.
+ *
+ * The set of entities is only rebuilt when it may have changed, i.e. when a
+ * node or callback group is added or removed, or when the notify guard
+ * condition of an associated node or callback group is triggered.
+ *
+ * With a rclcpp::experimental::buffers::PollableEventsQueue, the executor can
+ * be driven by an external event loop instead of spin(), by calling
+ * spin_some() when the file descriptor of the queue is readable or when
+ * get_time_until_next_timer() elapsed.
+ *
+ * Waitables which do not implement rclcpp::Waitable::set_on_ready_callback()
+ * can't be used with this executor and are ignored with a warning.
+ *
+ * To run this executor instead of SingleThreadedExecutor replace:
+ * rclcpp::executors::SingleThreadedExecutor exec;
+ * by
+ * rclcpp::executors::EventsExecutor exec;
+ */
+class EventsExecutor : public rclcpp::Executor
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(EventsExecutor)
+
+  /// Default constructor. See the default constructor for Executor.
+  /**
+   * \param[in] events_queue the queue used to store the ready events, a
+   *   SimpleEventsQueue is used by default
+   * \param[in] options options used to configure the executor
+   * \throws std::invalid_argument if events_queue is nullptr
+   */
+  RCLCPP_PUBLIC
+  explicit EventsExecutor(
+    rclcpp::experimental::buffers::EventsQueue::UniquePtr events_queue = std::make_unique<
+      rclcpp::experimental::buffers::SimpleEventsQueue>(),
+    const rclcpp::ExecutorOptions & options = rclcpp::ExecutorOptions());
+
+  /// Default destructor.
+  RCLCPP_PUBLIC
+  virtual ~EventsExecutor();
+
+  /// Events executor implementation of spin.
+  /**
+   * This function will block until work comes in, execute it, and keep blocking.
+   * It will only be interrupted by a call to cancel() or by ctrl-c.
+   * \throws std::runtime_error when spin() called while already spinning
+   */
+  RCLCPP_PUBLIC
+  void
+  spin() override;
+
+  /// Events executor implementation of spin some.
+  /**
+   * This non-blocking function will execute the events that were already
+   * pending when it was called, until max_duration elapsed or no more of those
+   * events are available.
+   * \sa rclcpp::Executor::spin_some
+   */
+  RCLCPP_PUBLIC
+  void
+  spin_some(std::chrono::nanoseconds max_duration = std::chrono::nanoseconds(0)) override;
+
+  /// Events executor implementation of spin all.
+  /**
+   * This non-blocking function will execute events until max_duration elapsed
+   * or no more events are available, including the ones that became ready
+   * while executing.
+   * \sa rclcpp::Executor::spin_all
+   */
+  RCLCPP_PUBLIC
+  void
+  spin_all(std::chrono::nanoseconds max_duration) override;
+
+  /// Return the time until the next timer is ready.
+  /**
+   * Meant to be used as the timeout of an external event loop calling
+   * spin_some(), e.g. when the executor uses a PollableEventsQueue, as the
+   * timers are only monitored by a thread while spin() is running.
+   *
+   * \return the time until the closest timer is ready, which may be negative
+   *   if a timer is already overdue, or std::chrono::nanoseconds::max() if
+   *   there's no timer
+   */
+  RCLCPP_PUBLIC
+  std::chrono::nanoseconds
+  get_time_until_next_timer();
+
+  /// \sa rclcpp::Executor::add_callback_group
+  RCLCPP_PUBLIC
+  void
+  add_callback_group(
+    rclcpp::CallbackGroup::SharedPtr group_ptr,
+    rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_ptr,
+    bool notify = true) override;
+
+  /// \sa rclcpp::Executor::remove_callback_group
+  /**
+   * Returns once the event being executed, if any, is done, so the callbacks of the group
+   * aren't executed by this executor anymore.
+   */
+  RCLCPP_PUBLIC
+  void
+  remove_callback_group(
+    rclcpp::CallbackGroup::SharedPtr group_ptr,
+    bool notify = true) override;
+
+  /// \sa rclcpp::Executor::add_node
+  RCLCPP_PUBLIC
+  void
+  add_node(
+    rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_ptr,
+    bool notify = true) override;
+
+  /// \sa rclcpp::EventsExecutor::add_node
+  RCLCPP_PUBLIC
+  void
+  add_node(std::shared_ptr<rclcpp::Node> node_ptr, bool notify = true) override;
+
+  /// \sa rclcpp::Executor::remove_node
+  RCLCPP_PUBLIC
+  void
+  remove_node(
+    rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_ptr,
+    bool notify = true) override;
+
+  /// \sa rclcpp::Executor::remove_node
+  RCLCPP_PUBLIC
+  void
+  remove_node(std::shared_ptr<rclcpp::Node> node_ptr, bool notify = true) override;
+
+protected:
+  RCLCPP_PUBLIC
+  void
+  spin_once_impl(std::chrono::nanoseconds timeout) override;
+
+  RCLCPP_PUBLIC
+  void
+  spin_some_impl(std::chrono::nanoseconds max_duration, bool exhaustive);
+
+  /// Execute the entity that produced the event.
+  RCLCPP_PUBLIC
+  void
+  execute_event(const ExecutorEvent & event);
+
+  /// Register the callbacks of new entities and unregister the ones of removed entities.
+  RCLCPP_PUBLIC
+  void
+  refresh_entities();
+
+private:
+  RCLCPP_DISABLE_COPY(EventsExecutor)
+
+  template<typename EntityT>
+  using EntitiesMap = std::unordered_map<const void *, std::weak_ptr<EntityT>>;
+
+  /// Unregister the callbacks of every entity, requires mutex_.
+  void
+  clear_entities() RCPPUTILS_TSA_REQUIRES(mutex_);
+
+  std::function<void(size_t)>
+  create_entity_callback(const void * entity_key, ExecutorEventType type);
+
+  std::function<void(size_t, int)>
+  create_waitable_callback(const rclcpp::Waitable * waitable);
+
+  /// Callback requesting a refresh of the entities, multiple requests are coalesced.
+  std::function<void(size_t)>
+  create_notify_callback();
+
+  template<typename EntityT>
+  typename EntityT::SharedPtr
+  retrieve_entity(const void * entity_key, EntitiesMap<EntityT> & entities)
+  {
+    std::lock_guard<std::mutex> guard{mutex_};
+    auto it = entities.find(entity_key);
+    if (it == entities.end()) {
+      return nullptr;
+    }
+    auto entity = it->second.lock();
+    if (!entity) {
+      entities.erase(it);
+    }
+    return entity;
+  }
+
+  /// Queue storing the events, filled by the entities callbacks.
+  rclcpp::experimental::buffers::EventsQueue::UniquePtr events_queue_;
+
+  /// Monitors the timers in place of the middleware.
+  rclcpp::experimental::TimersManager::SharedPtr timers_manager_;
+
+  EntitiesMap<rclcpp::SubscriptionBase> subscriptions_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+  EntitiesMap<rclcpp::ServiceBase> services_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+  EntitiesMap<rclcpp::ClientBase> clients_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+  EntitiesMap<rclcpp::TimerBase> timers_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+  EntitiesMap<rclcpp::Waitable> waitables_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+
+  /// Nodes and callback group guard conditions whose notifications trigger a refresh.
+  EntitiesMap<rclcpp::node_interfaces::NodeBaseInterface> notify_nodes_
+  RCPPUTILS_TSA_GUARDED_BY(mutex_);
+  EntitiesMap<rclcpp::GuardCondition> notify_guard_conditions_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+
+  /// True when an ENTITIES_CHANGED_EVENT is pending in the queue.
+  std::atomic_bool entities_need_refresh_{false};
+
+  /// Held while an event is executed, so removing a callback group waits for its execution.
+  std::recursive_mutex execution_mutex_;
+};
+
+}  // namespace executors
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXECUTORS__EVENTS_EXECUTOR_HPP_
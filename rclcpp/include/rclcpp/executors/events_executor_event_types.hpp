@@ -0,0 +1,52 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXECUTORS__EVENTS_EXECUTOR_EVENT_TYPES_HPP_
+#define RCLCPP__EXECUTORS__EVENTS_EXECUTOR_EVENT_TYPES_HPP_
+
+#include <cstddef>
+
+namespace rclcpp
+{
+namespace executors
+{
+
+/// Kind of entity that produced an ExecutorEvent.
+enum class ExecutorEventType
+{
+  CLIENT_EVENT,
+  SUBSCRIPTION_EVENT,
+  SERVICE_EVENT,
+  TIMER_EVENT,
+  WAITABLE_EVENT,
+  /// The set of entities associated with the executor may have changed, or it was interrupted.
+  ENTITIES_CHANGED_EVENT
+};
+
+/// Event pushed by an entity into the queue of an EventsExecutor when it becomes ready.
+struct ExecutorEvent
+{
+  /// Opaque identifier of the entity, i.e. the address of the rclcpp entity object.
+  const void * exec_entity_id;
+  /// Identifier of the sub-entity within a waitable, as given to its on ready callback.
+  int gen_entity_id;
+  ExecutorEventType type;
+  /// Number of times the entity became ready since the last event.
+  size_t num_events;
+};
+
+}  // namespace executors
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXECUTORS__EVENTS_EXECUTOR_EVENT_TYPES_HPP_
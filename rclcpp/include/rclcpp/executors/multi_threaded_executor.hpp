@@ -15,16 +15,20 @@
 #ifndef RCLCPP__EXECUTORS__MULTI_THREADED_EXECUTOR_HPP_
 #define RCLCPP__EXECUTORS__MULTI_THREADED_EXECUTOR_HPP_
 
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <mutex>
 #include <set>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "rclcpp/executor.hpp"
+#include "rclcpp/executors/single_threaded_executor.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/memory_strategies.hpp"
+#include "rclcpp/thread_attributes.hpp"
 #include "rclcpp/visibility_control.hpp"
 
 namespace rclcpp
@@ -45,6 +49,12 @@ public:
    * This is useful for reproducing some bugs related to taking work more than
    * once.
    *
+   * The attributes in options.thread_attributes are applied to the threads
+   * with the same number.
+   * When there are any, all the threads are created by the executor and the
+   * thread calling spin() only waits for them, so its own attributes are left
+   * unchanged.
+   *
    * \param options common options for all executors
    * \param number_of_threads number of threads to have in the thread pool,
    *   the default 0 will use the number of cpu cores found (minimum of 2)
@@ -69,22 +79,105 @@ public:
   void
   spin() override;
 
+  /// Get the number of threads given to the constructor, the minimum of an elastic pool.
   RCLCPP_PUBLIC
   size_t
   get_number_of_threads();
 
+  /// Let the thread pool grow under load, up to the given number of threads.
+  /**
+   * When all the threads executing the callbacks have been busy for longer than
+   * grow_after, e.g. blocked in long callbacks, one thread is added, and so on
+   * until there are max_number_of_threads.
+   * The added threads exit once they got no work for longer than shrink_after, so
+   * the pool shrinks back to get_number_of_threads() when idle.
+   * The threads dedicated to callback groups count in both numbers.
+   *
+   * The thread calling spin() then watches the load instead of executing callbacks.
+   * The current number of threads is recorded in rclcpp::ExecutorOptions::statistics,
+   * if given, and the added threads get the thread_attributes of their number.
+   *
+   * \param[in] max_number_of_threads maximum number of threads of the pool
+   * \param[in] grow_after how long all the threads have to be busy for one to be added
+   * \param[in] shrink_after how long an added thread has to be idle to exit
+   * \throws std::invalid_argument if max_number_of_threads is lower than
+   *   get_number_of_threads(), or if a duration isn't positive
+   * \throws std::runtime_error if called while spinning
+   */
+  RCLCPP_PUBLIC
+  void
+  set_elastic_thread_pool(
+    size_t max_number_of_threads,
+    std::chrono::nanoseconds grow_after = std::chrono::milliseconds(10),
+    std::chrono::nanoseconds shrink_after = std::chrono::seconds(1));
+
+  /// Dedicate a thread of the pool to the execution of the given callback group.
+  /**
+   * A thread with callback groups assigned only executes those, which keeps
+   * their data hot in the cache of the CPU the thread is pinned to through
+   * rclcpp::ExecutorOptions::thread_attributes.
+   * Several callback groups can be assigned to the same thread.
+   *
+   * If the callback group was added to this executor, it is moved to the
+   * thread, otherwise it must not already be added to an executor.
+   *
+   * \param[in] group_ptr the callback group to assign
+   * \param[in] node_ptr the node the callback group belongs to
+   * \param[in] thread_number the number of the thread, lower than get_number_of_threads()
+   * \throws std::invalid_argument if thread_number is out of range, or if the
+   *   thread is the last one not dedicated to callback groups
+   * \throws std::runtime_error if called while spinning, or if the callback group
+   *   was added to another executor
+   */
+  RCLCPP_PUBLIC
+  void
+  add_callback_group_to_thread(
+    rclcpp::CallbackGroup::SharedPtr group_ptr,
+    rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_ptr,
+    size_t thread_number);
+
 protected:
   RCLCPP_PUBLIC
   void
   run(size_t this_thread_number);
 
+  /// Spin the executor of the callback groups assigned to the thread.
+  RCLCPP_PUBLIC
+  void
+  run_dedicated(
+    size_t this_thread_number,
+    rclcpp::executors::SingleThreadedExecutor::SharedPtr executor);
+
 private:
   RCLCPP_DISABLE_COPY(MultiThreadedExecutor)
 
+  /// Apply the configured attributes to the calling thread, logging failures.
+  void
+  apply_attributes_to_thread(size_t this_thread_number);
+
+  /// Add threads to the pool while all its threads are busy, until spinning stops.
+  void
+  grow_elastic_thread_pool();
+
+  /// Record the size of the pool in the statistics, if they are collected.
+  void
+  record_thread_pool_size(size_t number_of_running_threads);
+
   std::mutex wait_mutex_;
   size_t number_of_threads_;
   bool yield_before_execute_;
   std::chrono::nanoseconds next_exec_timeout_;
+  std::vector<rclcpp::ThreadAttributes> thread_attributes_;
+  /// Executors of the callback groups assigned to threads, by thread number.
+  std::unordered_map<size_t, rclcpp::executors::SingleThreadedExecutor::SharedPtr>
+  dedicated_executors_;
+  /// Maximum number of threads of an elastic pool, 0 if the pool isn't elastic.
+  size_t max_number_of_threads_ = 0;
+  std::chrono::nanoseconds grow_after_{0};
+  std::chrono::nanoseconds shrink_after_{0};
+  /// Number of threads in run(), and how many of them are executing a callback.
+  std::atomic<size_t> number_of_running_threads_{0};
+  std::atomic<size_t> number_of_busy_threads_{0};
 };
 
 }  // namespace executors
@@ -0,0 +1,109 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__EXECUTORS__SIMULATION_EXECUTOR_HPP_
+#define RCLCPP__EXECUTORS__SIMULATION_EXECUTOR_HPP_
+
+#include <functional>
+#include <mutex>
+
+#include "rclcpp/clock.hpp"
+#include "rclcpp/executor_options.hpp"
+#include "rclcpp/executors/single_threaded_executor.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/time.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace executors
+{
+
+/// Executor stepping in lockstep with a simulation, through the time of a clock.
+/**
+ * Instead of relying on rcl_wait() timeouts, which are measured on the wall clock,
+ * the executor executes all the work ready until there is none left, including the
+ * timers due up to the current time of the clock, and then reports being idle at
+ * that time through the idle callback.
+ * The simulator can then advance the time right away, e.g. by publishing the next
+ * /clock message once all the participants are idle at the time of the previous one,
+ * so that the simulation runs as fast as the callbacks allow and deterministically.
+ *
+ * The clock is usually the one of a node using `use_sim_time`, whose /clock
+ * subscription must then be executed by this executor, e.g. by adding the node.
+ */
+class SimulationExecutor : public SingleThreadedExecutor
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(SimulationExecutor)
+
+  using IdleCallback = std::function<void (const rclcpp::Time & time)>;
+
+  /// Constructor.
+  /**
+   * \param[in] clock clock the simulation advances, usually using ROS time.
+   * \param[in] options options of the executor.
+   * \throws std::invalid_argument if the clock is null.
+   */
+  RCLCPP_PUBLIC
+  explicit SimulationExecutor(
+    rclcpp::Clock::SharedPtr clock,
+    const rclcpp::ExecutorOptions & options = rclcpp::ExecutorOptions());
+
+  RCLCPP_PUBLIC
+  virtual ~SimulationExecutor();
+
+  /// Set the callback called, by the spinning thread, when the executor is idle at a new time.
+  RCLCPP_PUBLIC
+  void
+  set_idle_callback(IdleCallback callback);
+
+  /// Execute the work until none is ready, reporting being idle each time the time changed.
+  /**
+   * The executor blocks between the steps until more work is ready, such as the
+   * subscription of the clock when it advances, and spins until canceled or shut down.
+   * \throws std::runtime_error when spin() called while already spinning
+   */
+  RCLCPP_PUBLIC
+  void
+  spin() override;
+
+  /// Execute the work until none is ready at the current time of the clock, without blocking.
+  /**
+   * The idle callback isn't called.
+   * \return the time of the clock when the executor became idle.
+   * \throws std::runtime_error when called while already spinning
+   */
+  RCLCPP_PUBLIC
+  rclcpp::Time
+  spin_until_idle();
+
+private:
+  RCLCPP_DISABLE_COPY(SimulationExecutor)
+
+  /// Execute the ready work until none is left and the time of the clock didn't change.
+  rclcpp::Time
+  execute_until_idle();
+
+  const rclcpp::Clock::SharedPtr clock_;
+
+  std::mutex idle_callback_mutex_;
+  IdleCallback idle_callback_;
+};
+
+}  // namespace executors
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXECUTORS__SIMULATION_EXECUTOR_HPP_
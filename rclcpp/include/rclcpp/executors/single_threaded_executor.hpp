@@ -38,6 +38,14 @@ namespace executors
 /// Single-threaded executor implementation.
 /**
  * This is the default executor created by rclcpp::spin.
+ *
+ * Once the entities were collected by a first call to spin_some(), spin_once() or spin(),
+ * waiting for and executing timers doesn't allocate memory in rclcpp, as long as no entity
+ * is added to or removed from the executor.
+ * Subscriptions, services and clients allocate their messages with their message memory
+ * strategy, see rclcpp::strategies::message_pool_memory_strategy::MessagePoolMemoryStrategy
+ * to avoid it for subscriptions.
+ * The rmw implementation may still allocate memory while waiting or taking messages.
  */
 class SingleThreadedExecutor : public rclcpp::Executor
 {
@@ -0,0 +1,140 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXECUTORS__STATIC_MULTI_THREADED_EXECUTOR_HPP_
+#define RCLCPP__EXECUTORS__STATIC_MULTI_THREADED_EXECUTOR_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "rclcpp/callback_group.hpp"
+#include "rclcpp/executors/static_single_threaded_executor.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace executors
+{
+
+/// Multi-threaded version of the static executor
+/**
+ * Like StaticSingleThreadedExecutor, the entities and the wait set are only
+ * rebuilt when the entities collector notifies that an entity was added or
+ * removed.
+ * The thread calling spin() waits on the wait set, then executes the ready
+ * entities with a pool of threads, and waits again once all of them have
+ * been executed.
+ *
+ * The ready entities of a mutually exclusive callback group are executed one
+ * after the other by the same thread, while the ones of reentrant groups can
+ * all be executed in parallel.
+ *
+ * Only spin() uses multiple threads, spin_some(), spin_all() and spin_once()
+ * behave as in StaticSingleThreadedExecutor.
+ */
+class StaticMultiThreadedExecutor : public StaticSingleThreadedExecutor
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(StaticMultiThreadedExecutor)
+
+  /// Constructor for StaticMultiThreadedExecutor.
+  /**
+   * \param options common options for all executors
+   * \param number_of_threads number of threads executing the work, including
+   *   the thread calling spin(), the default 0 will use the number of cpu cores
+   *   found (minimum of 2)
+   */
+  RCLCPP_PUBLIC
+  explicit StaticMultiThreadedExecutor(
+    const rclcpp::ExecutorOptions & options = rclcpp::ExecutorOptions(),
+    size_t number_of_threads = 0);
+
+  RCLCPP_PUBLIC
+  virtual ~StaticMultiThreadedExecutor();
+
+  /**
+   * \sa rclcpp::Executor:spin() for more details
+   * \throws std::runtime_error when spin() called while already spinning
+   */
+  RCLCPP_PUBLIC
+  void
+  spin() override;
+
+  RCLCPP_PUBLIC
+  size_t
+  get_number_of_threads();
+
+protected:
+  /// Queue the work of the ready entities.
+  /**
+   * \return true if the entities collector is ready, meaning that the entities
+   *   must be collected again once the work is done
+   */
+  RCLCPP_PUBLIC
+  bool
+  dispatch_ready_executables();
+
+  /// Execute queued work until the queue is empty and all the work was executed.
+  RCLCPP_PUBLIC
+  void
+  execute_work_until_done();
+
+  /// Execute queued work until the executor stops.
+  RCLCPP_PUBLIC
+  void
+  run();
+
+private:
+  RCLCPP_DISABLE_COPY(StaticMultiThreadedExecutor)
+
+  using Work = std::function<void ()>;
+
+  /// Cache the callback group of each entity, so the work can be split by group.
+  void
+  update_entity_groups();
+
+  /// Add the work of an entity, to run after the one of the same mutually exclusive group.
+  void
+  add_work(const void * entity, Work work);
+
+  /// Take work from the queue, returning false if the executor stopped.
+  bool
+  take_work(Work & work, bool wait);
+
+  size_t number_of_threads_;
+
+  std::unordered_map<const void *, rclcpp::CallbackGroup::WeakPtr> entity_groups_;
+
+  /// Work of the mutually exclusive groups being dispatched, indexed by group.
+  std::unordered_map<const rclcpp::CallbackGroup *, std::vector<Work>> exclusive_work_;
+
+  std::mutex work_mutex_;
+  std::deque<Work> work_queue_;
+  /// Number of queued or executing work items.
+  size_t outstanding_work_{0};
+  bool workers_running_{false};
+  std::condition_variable work_available_cv_;
+  std::condition_variable work_done_cv_;
+};
+
+}  // namespace executors
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXECUTORS__STATIC_MULTI_THREADED_EXECUTOR_HPP_
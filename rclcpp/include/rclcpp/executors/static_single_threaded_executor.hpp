@@ -73,7 +73,10 @@ public:
   /**
    * This function will block until work comes in, execute it, and keep blocking.
    * It will only be interrupted by a CTRL-C (managed by the global signal handler).
+   * With a positive rclcpp::ExecutorOptions::busy_polling_duration, it polls instead of
+   * blocking until no work came in for this duration.
    * \throws std::runtime_error when spin() called while already spinning
+   * \throws std::runtime_error if the thread attributes of busy polling can't be applied
    */
   RCLCPP_PUBLIC
   void
@@ -211,10 +214,13 @@ protected:
   void
   spin_once_impl(std::chrono::nanoseconds timeout) override;
 
+  StaticExecutorEntitiesCollector::SharedPtr entities_collector_;
+
 private:
   RCLCPP_DISABLE_COPY(StaticSingleThreadedExecutor)
 
-  StaticExecutorEntitiesCollector::SharedPtr entities_collector_;
+  const std::chrono::nanoseconds busy_polling_duration_;
+  const std::vector<rclcpp::ThreadAttributes> thread_attributes_;
 };
 
 }  // namespace executors
@@ -0,0 +1,154 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__EXECUTORS__TIME_TRIGGERED_EXECUTOR_HPP_
+#define RCLCPP__EXECUTORS__TIME_TRIGGERED_EXECUTOR_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "rclcpp/callback_group.hpp"
+#include "rclcpp/executor_options.hpp"
+#include "rclcpp/executors/static_single_threaded_executor.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace executors
+{
+
+/// Executor running a static schedule of callback groups at fixed times of a cycle.
+/**
+ * The schedule is a list of slots, each one executing the ready entities of a callback
+ * group at its offset from the start of each cycle, in this order: subscriptions, timers,
+ * services, clients and waitables.
+ * The cycles start at absolute times, every period from the start of the spin, so that
+ * they don't drift with the execution times.
+ *
+ * A slot overruns when it's still executing at the offset of the next slot, or at the end
+ * of the cycle for the last one.
+ * The next slot then starts late, and the overrun is counted and reported to the overrun
+ * callback; the cycles which were entirely missed are skipped.
+ *
+ * Only the entities of the callback groups of the schedule are executed, and the groups
+ * must be added to the executor, directly or with their node, like those of the
+ * StaticSingleThreadedExecutor whose entities collector it uses.
+ * Between the slots, the executor sleeps with the context, so that it wakes up on shutdown,
+ * while cancel() takes effect at the start of the next slot.
+ */
+class TimeTriggeredExecutor : public StaticSingleThreadedExecutor
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(TimeTriggeredExecutor)
+
+  /// Report of a slot of the schedule which overran.
+  struct Overrun
+  {
+    /// Index of the slot, in the order of their offsets.
+    size_t slot;
+    /// Number of the cycle, starting at 0 for the first cycle of the spin.
+    uint64_t cycle;
+    /// Time by which the slot exceeded its end.
+    std::chrono::nanoseconds lateness;
+  };
+
+  using OverrunCallback = std::function<void (const Overrun &)>;
+
+  /// Constructor.
+  /**
+   * \param[in] cycle_period The period of the cycles of the schedule.
+   * \param[in] options The options of the executor.
+   * \throws std::invalid_argument if the period isn't positive.
+   */
+  RCLCPP_PUBLIC
+  explicit TimeTriggeredExecutor(
+    std::chrono::nanoseconds cycle_period,
+    const rclcpp::ExecutorOptions & options = rclcpp::ExecutorOptions());
+
+  RCLCPP_PUBLIC
+  virtual ~TimeTriggeredExecutor();
+
+  /// Add a slot executing a callback group at an offset of each cycle.
+  /**
+   * The slots are ordered by their offsets, and a group can have several slots.
+   * \param[in] group The callback group of the slot, which the schedule refers to weakly.
+   * \param[in] offset The time of the slot from the start of each cycle.
+   * \throws std::invalid_argument if the group is null, or if the offset is negative or
+   *   not less than the cycle period.
+   * \throws std::runtime_error if the executor is spinning.
+   */
+  RCLCPP_PUBLIC
+  void
+  add_slot(rclcpp::CallbackGroup::SharedPtr group, std::chrono::nanoseconds offset);
+
+  /// Set the callback called, by the spinning thread, when a slot overruns.
+  RCLCPP_PUBLIC
+  void
+  set_overrun_callback(OverrunCallback callback);
+
+  /// Return the number of overruns since the executor was constructed.
+  RCLCPP_PUBLIC
+  uint64_t
+  get_number_of_overruns() const;
+
+  /// Execute the schedule until the executor is canceled or the context shut down.
+  RCLCPP_PUBLIC
+  void
+  spin() override;
+
+  /// Execute a number of cycles of the schedule, the first one starting now.
+  /**
+   * \param[in] number_of_cycles The number of cycles to execute.
+   * \throws std::runtime_error if the executor is already spinning.
+   */
+  RCLCPP_PUBLIC
+  void
+  spin_cycles(uint64_t number_of_cycles);
+
+private:
+  RCLCPP_DISABLE_COPY(TimeTriggeredExecutor)
+
+  struct Slot
+  {
+    rclcpp::CallbackGroup::WeakPtr group;
+    std::chrono::nanoseconds offset;
+  };
+
+  void
+  spin_schedule(uint64_t number_of_cycles);
+
+  void
+  execute_slot(const Slot & slot);
+
+  void
+  report_overrun(size_t slot, uint64_t cycle, std::chrono::nanoseconds lateness);
+
+  const std::chrono::nanoseconds cycle_period_;
+
+  std::mutex schedule_mutex_;
+  std::vector<Slot> slots_;
+  OverrunCallback overrun_callback_;
+  std::atomic<uint64_t> number_of_overruns_{0};
+};
+
+}  // namespace executors
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXECUTORS__TIME_TRIGGERED_EXECUTOR_HPP_
@@ -0,0 +1,138 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXECUTORS__WORK_STEALING_MULTI_THREADED_EXECUTOR_HPP_
+#define RCLCPP__EXECUTORS__WORK_STEALING_MULTI_THREADED_EXECUTOR_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "rclcpp/any_executable.hpp"
+#include "rclcpp/executor.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace executors
+{
+
+/// Multi-threaded executor where a single thread waits and dispatches the work.
+/**
+ * Unlike MultiThreadedExecutor, the threads of the pool don't take turns
+ * waiting on the wait set behind a shared mutex.
+ * The thread calling spin() is the only one owning the wait set: it collects
+ * the ready executables and distributes them round-robin to a run queue per
+ * worker thread.
+ * Workers execute the work from the front of their own queue and, when it is
+ * empty, steal from the back of the queues of the other workers.
+ *
+ * Mutually exclusive callback groups keep their semantics, as an executable
+ * is only dispatched when its group can be taken from, and the group is
+ * released once the executable has been executed or discarded.
+ */
+class WorkStealingMultiThreadedExecutor : public rclcpp::Executor
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(WorkStealingMultiThreadedExecutor)
+
+  /// Constructor for WorkStealingMultiThreadedExecutor.
+  /**
+   * \param options common options for all executors
+   * \param number_of_threads number of worker threads, in addition to the
+   *   thread calling spin(), the default 0 will use the number of cpu cores
+   *   found (minimum of 2)
+   * \param timeout maximum time to wait
+   */
+  RCLCPP_PUBLIC
+  explicit WorkStealingMultiThreadedExecutor(
+    const rclcpp::ExecutorOptions & options = rclcpp::ExecutorOptions(),
+    size_t number_of_threads = 0,
+    std::chrono::nanoseconds timeout = std::chrono::nanoseconds(-1));
+
+  RCLCPP_PUBLIC
+  virtual ~WorkStealingMultiThreadedExecutor();
+
+  /**
+   * \sa rclcpp::Executor:spin() for more details
+   * \throws std::runtime_error when spin() called while already spinning
+   */
+  RCLCPP_PUBLIC
+  void
+  spin() override;
+
+  /// Cancel spin(), waking the thread dispatching the work if it waits for the workers.
+  /**
+   * \sa rclcpp::Executor::cancel()
+   */
+  RCLCPP_PUBLIC
+  void
+  cancel() override;
+
+  RCLCPP_PUBLIC
+  size_t
+  get_number_of_threads();
+
+protected:
+  /// Wait for work and distribute it to the run queues until the executor stops spinning.
+  RCLCPP_PUBLIC
+  void
+  dispatch();
+
+  /// Execute the work of the run queue of this thread, or the one stolen from the others.
+  RCLCPP_PUBLIC
+  void
+  run(size_t this_thread_number);
+
+private:
+  RCLCPP_DISABLE_COPY(WorkStealingMultiThreadedExecutor)
+
+  /// AnyExecutable releases its callback group on destruction, so it is never copied around.
+  using AnyExecutableSharedPtr = std::shared_ptr<rclcpp::AnyExecutable>;
+
+  struct RunQueue
+  {
+    std::mutex mutex;
+    std::deque<AnyExecutableSharedPtr> executables;
+  };
+
+  /// Pop from the front of the own run queue or steal from the back of another one.
+  AnyExecutableSharedPtr
+  take_work(size_t this_thread_number);
+
+  size_t number_of_threads_;
+  std::chrono::nanoseconds next_exec_timeout_;
+
+  std::vector<std::unique_ptr<RunQueue>> run_queues_;
+  size_t next_run_queue_{0};
+
+  /// Number of executables in the run queues.
+  std::atomic<size_t> pending_work_{0};
+  std::atomic_bool workers_running_{false};
+  std::mutex idle_mutex_;
+  /// Notified when work is pushed to a run queue.
+  std::condition_variable work_available_cv_;
+  /// Notified when the run queues have been emptied, and on cancel().
+  std::condition_variable work_taken_cv_;
+};
+
+}  // namespace executors
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXECUTORS__WORK_STEALING_MULTI_THREADED_EXECUTOR_HPP_
@@ -0,0 +1,285 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXPERIMENTAL__BATCHING_PUBLISHER_HPP_
+#define RCLCPP__EXPERIMENTAL__BATCHING_PUBLISHER_HPP_
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "rclcpp/create_publisher.hpp"
+#include "rclcpp/create_subscription.hpp"
+#include "rclcpp/create_timer.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/publisher.hpp"
+#include "rclcpp/publisher_options.hpp"
+#include "rclcpp/qos.hpp"
+#include "rclcpp/subscription_options.hpp"
+#include "rclcpp/timer.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+
+/// Options of a rclcpp::experimental::BatchingPublisher.
+struct BatchingOptions
+{
+  /// Number of messages after which a batch is published right away.
+  size_t max_batch_size = 100u;
+  /// Maximum time a message waits in a batch before it is published.
+  std::chrono::nanoseconds max_delay = std::chrono::milliseconds(1);
+};
+
+/// Publisher coalescing the messages published within a short time into one envelope.
+/**
+ * Instead of publishing each message by itself, the messages are added to a sequence
+ * of an envelope message, like a `my_msgs/msg/JointStateBatch` with a
+ * `sensor_msgs/JointState[] messages` field, which is published when it has
+ * BatchingOptions::max_batch_size messages, or at the latest after
+ * BatchingOptions::max_delay, so that the middleware writes once for all of them.
+ * The envelopes are received, and their messages given one at a time to a callback,
+ * by a subscription created with create_batched_subscription().
+ *
+ * The envelope is published by a timer of the node, so the node has to be spun for
+ * the messages to be published after their delay.
+ * Publishing is thread-safe, and the messages are published in order.
+ *
+ * \tparam EnvelopeT type of the published envelope.
+ * \tparam MessageSequenceT type of the sequence of the envelope holding the messages.
+ */
+template<
+  typename EnvelopeT,
+  typename MessageSequenceT,
+  typename AllocatorT = std::allocator<void>>
+class BatchingPublisher
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(BatchingPublisher)
+
+  using MessageT = typename MessageSequenceT::value_type;
+  using MessageSequenceMember = MessageSequenceT EnvelopeT::*;
+  using PublisherT = rclcpp::Publisher<EnvelopeT, AllocatorT>;
+
+  /// Constructor.
+  /**
+   * \param[in] node node creating the publisher of the envelopes and their timer.
+   * \param[in] topic_name name of the topic of the envelopes.
+   * \param[in] qos %QoS of the publisher of the envelopes.
+   * \param[in] messages member of the envelope holding the messages.
+   * \param[in] batching_options size and delay of the batches.
+   * \param[in] options options of the publisher of the envelopes.
+   * \throws std::invalid_argument if the size of the batches or their delay is 0.
+   */
+  template<typename NodeT>
+  BatchingPublisher(
+    NodeT & node,
+    const std::string & topic_name,
+    const rclcpp::QoS & qos,
+    MessageSequenceMember messages,
+    const BatchingOptions & batching_options = BatchingOptions(),
+    const rclcpp::PublisherOptionsWithAllocator<AllocatorT> & options = (
+      rclcpp::PublisherOptionsWithAllocator<AllocatorT>()))
+  : batch_(std::make_shared<Batch>())
+  {
+    if (batching_options.max_batch_size == 0u) {
+      throw std::invalid_argument("the batches of a batching publisher can't be empty");
+    }
+    if (batching_options.max_delay <= std::chrono::nanoseconds::zero()) {
+      throw std::invalid_argument("the delay of the batches of a publisher must be positive");
+    }
+    batch_->publisher = rclcpp::create_publisher<EnvelopeT>(node, topic_name, qos, options);
+    batch_->messages = messages;
+    batch_->max_batch_size = batching_options.max_batch_size;
+    (batch_->envelope.*messages).reserve(batching_options.max_batch_size);
+
+    // The timer doesn't keep the batch alive, since it may outlive the publisher.
+    std::weak_ptr<Batch> weak_batch = batch_;
+    timer_ = rclcpp::create_wall_timer(
+      batching_options.max_delay,
+      [weak_batch]() {
+        if (auto batch = weak_batch.lock()) {
+          std::lock_guard<std::mutex> lock(batch->mutex);
+          batch->publish_if_not_empty();
+        }
+      },
+      options.callback_group,
+      rclcpp::node_interfaces::get_node_base_interface(node).get(),
+      rclcpp::node_interfaces::get_node_timers_interface(node).get());
+  }
+
+  /// Destructor, publishing the messages of the last batch.
+  ~BatchingPublisher()
+  {
+    timer_->cancel();
+    try {
+      flush();
+    } catch (...) {
+      // The context may already be shut down.
+    }
+  }
+
+  /// Add a message to the batch, publishing it if it's full.
+  void
+  publish(const MessageT & message)
+  {
+    std::lock_guard<std::mutex> lock(batch_->mutex);
+    (batch_->envelope.*(batch_->messages)).push_back(message);
+    batch_->publish_if_full();
+  }
+
+  /// Add a message to the batch, moving it, and publish the batch if it's full.
+  void
+  publish(std::unique_ptr<MessageT> message)
+  {
+    if (!message) {
+      throw std::invalid_argument("the message published by a batching publisher is null");
+    }
+    std::lock_guard<std::mutex> lock(batch_->mutex);
+    (batch_->envelope.*(batch_->messages)).push_back(std::move(*message));
+    batch_->publish_if_full();
+  }
+
+  /// Publish the messages of the batch right away, if there are any.
+  void
+  flush()
+  {
+    std::lock_guard<std::mutex> lock(batch_->mutex);
+    batch_->publish_if_not_empty();
+  }
+
+  /// Return the number of messages in the batch, which aren't published yet.
+  size_t
+  get_number_of_pending_messages() const
+  {
+    std::lock_guard<std::mutex> lock(batch_->mutex);
+    return (batch_->envelope.*(batch_->messages)).size();
+  }
+
+  /// Return the publisher of the envelopes.
+  std::shared_ptr<PublisherT>
+  get_publisher() const
+  {
+    return batch_->publisher;
+  }
+
+private:
+  RCLCPP_DISABLE_COPY(BatchingPublisher)
+
+  struct Batch
+  {
+    void
+    publish_if_full()
+    {
+      if ((envelope.*messages).size() >= max_batch_size) {
+        publish_if_not_empty();
+      }
+    }
+
+    void
+    publish_if_not_empty()
+    {
+      if ((envelope.*messages).empty()) {
+        return;
+      }
+      // The envelope is reused, so that its sequence keeps its capacity.
+      publisher->publish(envelope);
+      (envelope.*messages).clear();
+    }
+
+    std::mutex mutex;
+    std::shared_ptr<PublisherT> publisher;
+    MessageSequenceMember messages = nullptr;
+    size_t max_batch_size = 0u;
+    EnvelopeT envelope;
+  };
+
+  std::shared_ptr<Batch> batch_;
+  rclcpp::TimerBase::SharedPtr timer_;
+};
+
+/// Create a publisher batching messages into envelopes.
+/**
+ * The types of the envelope and of its messages are deduced from the member of the
+ * envelope holding the messages, for example:
+ *
+ * ```cpp
+ * auto publisher = rclcpp::experimental::create_batching_publisher(
+ *   node, "joint_states", rclcpp::QoS(10), &my_msgs::msg::JointStateBatch::messages);
+ * publisher->publish(joint_state);
+ * ```
+ *
+ * \sa rclcpp::experimental::BatchingPublisher
+ */
+template<
+  typename EnvelopeT,
+  typename MessageSequenceT,
+  typename AllocatorT = std::allocator<void>,
+  typename NodeT>
+typename BatchingPublisher<EnvelopeT, MessageSequenceT, AllocatorT>::SharedPtr
+create_batching_publisher(
+  NodeT & node,
+  const std::string & topic_name,
+  const rclcpp::QoS & qos,
+  MessageSequenceT EnvelopeT::* messages,
+  const BatchingOptions & batching_options = BatchingOptions(),
+  const rclcpp::PublisherOptionsWithAllocator<AllocatorT> & options = (
+    rclcpp::PublisherOptionsWithAllocator<AllocatorT>()))
+{
+  return std::make_shared<BatchingPublisher<EnvelopeT, MessageSequenceT, AllocatorT>>(
+    node, topic_name, qos, messages, batching_options, options);
+}
+
+/// Create a subscription to the envelopes of a batching publisher.
+/**
+ * The messages of each envelope are given to the callback one at a time, in order.
+ *
+ * \param[in] callback callable taking a const reference to a message of the envelopes.
+ * \sa rclcpp::experimental::BatchingPublisher
+ */
+template<
+  typename EnvelopeT,
+  typename MessageSequenceT,
+  typename CallbackT,
+  typename AllocatorT = std::allocator<void>,
+  typename NodeT>
+typename rclcpp::Subscription<EnvelopeT, AllocatorT>::SharedPtr
+create_batched_subscription(
+  NodeT & node,
+  const std::string & topic_name,
+  const rclcpp::QoS & qos,
+  MessageSequenceT EnvelopeT::* messages,
+  CallbackT && callback,
+  const rclcpp::SubscriptionOptionsWithAllocator<AllocatorT> & options = (
+    rclcpp::SubscriptionOptionsWithAllocator<AllocatorT>()))
+{
+  return rclcpp::create_subscription<EnvelopeT>(
+    node, topic_name, qos,
+    [messages, callback = std::forward<CallbackT>(callback)](const EnvelopeT & envelope) mutable
+    {
+      for (const auto & message : envelope.*messages) {
+        callback(message);
+      }
+    },
+    options);
+}
+
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXPERIMENTAL__BATCHING_PUBLISHER_HPP_
@@ -15,6 +15,9 @@
 #ifndef RCLCPP__EXPERIMENTAL__BUFFERS__BUFFER_IMPLEMENTATION_BASE_HPP_
 #define RCLCPP__EXPERIMENTAL__BUFFERS__BUFFER_IMPLEMENTATION_BASE_HPP_
 
+#include <cstddef>
+#include <cstdint>
+
 namespace rclcpp
 {
 namespace experimental
@@ -22,6 +25,21 @@ namespace experimental
 namespace buffers
 {
 
+/// Occupancy of a buffer, to size it under load.
+struct BufferCounters
+{
+  /// Maximum number of elements, 0 if it isn't known.
+  size_t capacity = 0;
+  /// Number of elements currently stored.
+  size_t depth = 0;
+  /// Maximum number of elements stored at once since the buffer was created.
+  size_t high_water_mark = 0;
+  /// Number of elements overwritten or dropped since the buffer was created, as it was full.
+  uint64_t dropped = 0;
+  /// Number of changes of the capacity since the buffer was created, for the adaptive buffers.
+  uint64_t resizes = 0;
+};
+
 template<typename BufferT>
 class BufferImplementationBase
 {
@@ -33,6 +51,12 @@ public:
 
   virtual void clear() = 0;
   virtual bool has_data() const = 0;
+
+  /// Get the occupancy of the buffer, which is unknown unless implemented.
+  virtual BufferCounters get_counters() const
+  {
+    return BufferCounters();
+  }
 };
 
 }  // namespace buffers
@@ -0,0 +1,79 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXPERIMENTAL__BUFFERS__EVENTS_QUEUE_HPP_
+#define RCLCPP__EXPERIMENTAL__BUFFERS__EVENTS_QUEUE_HPP_
+
+#include <chrono>
+
+#include "rclcpp/executors/events_executor_event_types.hpp"
+#include "rclcpp/macros.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+namespace buffers
+{
+
+/// Interface of the queue used by the EventsExecutor to store ready events.
+/**
+ * Implementations must be thread-safe: events are enqueued from middleware
+ * and timer threads while the executor thread dequeues them.
+ */
+class EventsQueue
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(EventsQueue)
+
+  EventsQueue() = default;
+
+  virtual ~EventsQueue() = default;
+
+  /// Push an event into the queue and notify any waiting consumer.
+  virtual
+  void
+  enqueue(const rclcpp::executors::ExecutorEvent & event) = 0;
+
+  /// Extract the next event from the queue, waiting up to timeout for one to arrive.
+  /**
+   * \param[out] event the extracted event, only valid if true is returned
+   * \param[in] timeout maximum time to wait, std::chrono::nanoseconds::max() waits forever
+   * \return true if an event was extracted, false if the timeout expired first
+   */
+  virtual
+  bool
+  dequeue(
+    rclcpp::executors::ExecutorEvent & event,
+    std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) = 0;
+
+  /// Return true if the queue holds no event.
+  virtual
+  bool
+  empty() const = 0;
+
+  /// Return the number of events held by the queue.
+  virtual
+  size_t
+  size() const = 0;
+
+private:
+  RCLCPP_DISABLE_COPY(EventsQueue)
+};
+
+}  // namespace buffers
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXPERIMENTAL__BUFFERS__EVENTS_QUEUE_HPP_
@@ -43,6 +43,11 @@ public:
 
   virtual bool has_data() const = 0;
   virtual bool use_take_shared_method() const = 0;
+
+  virtual BufferCounters get_counters() const
+  {
+    return BufferCounters();
+  }
 };
 
 template<
@@ -128,6 +133,11 @@ public:
     return buffer_->has_data();
   }
 
+  BufferCounters get_counters() const override
+  {
+    return buffer_->get_counters();
+  }
+
   void clear() override
   {
     buffer_->clear();
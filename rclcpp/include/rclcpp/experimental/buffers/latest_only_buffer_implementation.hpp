@@ -0,0 +1,144 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__EXPERIMENTAL__BUFFERS__LATEST_ONLY_BUFFER_IMPLEMENTATION_HPP_
+#define RCLCPP__EXPERIMENTAL__BUFFERS__LATEST_ONLY_BUFFER_IMPLEMENTATION_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+#include "rclcpp/experimental/buffers/buffer_implementation_base.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+namespace buffers
+{
+
+/// Store only the latest element, replacing it with a single atomic exchange
+/**
+ * The element is kept in a box which is swapped in and out of the slot, so that
+ * enqueue() and dequeue() each exchange a pointer and never wait for each other,
+ * whatever the number of producers and consumers.
+ * The box of a dequeued or replaced element is kept as a spare for the next enqueue(),
+ * which only allocates one when its spare was taken by a concurrent producer.
+ *
+ * \tparam BufferT the type of the stored element
+ */
+template<typename BufferT>
+class LatestOnlyBufferImplementation : public BufferImplementationBase<BufferT>
+{
+public:
+  LatestOnlyBufferImplementation() = default;
+
+  virtual ~LatestOnlyBufferImplementation()
+  {
+    delete slot_.exchange(nullptr, std::memory_order_acquire);
+    delete spare_.exchange(nullptr, std::memory_order_acquire);
+  }
+
+  /// Replace the stored element, if any, with a new one
+  /**
+   * This member function is lock-free and thread-safe.
+   *
+   * \param request the element to be stored
+   */
+  void enqueue(BufferT request)
+  {
+    Box * box = spare_.exchange(nullptr, std::memory_order_acquire);
+    if (!box) {
+      box = new Box;
+    }
+    box->data = std::move(request);
+    Box * replaced = slot_.exchange(box, std::memory_order_acq_rel);
+    has_stored_.store(true, std::memory_order_relaxed);
+    if (replaced) {
+      dropped_.fetch_add(1u, std::memory_order_relaxed);
+      recycle(replaced);
+    }
+  }
+
+  /// Remove the stored element
+  /**
+   * This member function is lock-free and thread-safe.
+   *
+   * \return the stored element, or a default constructed one if there is none
+   */
+  BufferT dequeue()
+  {
+    Box * box = slot_.exchange(nullptr, std::memory_order_acq_rel);
+    if (!box) {
+      return BufferT();
+    }
+    BufferT request = std::move(box->data);
+    recycle(box);
+    return request;
+  }
+
+  /// Get if an element is stored
+  /**
+   * This member function is lock-free and thread-safe.
+   */
+  inline bool has_data() const
+  {
+    return slot_.load(std::memory_order_acquire) != nullptr;
+  }
+
+  void clear()
+  {
+    Box * box = slot_.exchange(nullptr, std::memory_order_acq_rel);
+    if (box) {
+      recycle(box);
+    }
+  }
+
+  /// Get the occupancy of the buffer, whose capacity is one element
+  BufferCounters get_counters() const
+  {
+    BufferCounters counters;
+    counters.capacity = 1u;
+    counters.depth = has_data() ? 1u : 0u;
+    counters.high_water_mark = has_stored_.load(std::memory_order_relaxed) ? 1u : 0u;
+    counters.dropped = dropped_.load(std::memory_order_relaxed);
+    return counters;
+  }
+
+private:
+  struct Box
+  {
+    BufferT data;
+  };
+
+  /// Destroy the element of a box taken from the slot, and keep the box as spare.
+  void recycle(Box * box)
+  {
+    box->data = BufferT();
+    delete spare_.exchange(box, std::memory_order_acq_rel);
+  }
+
+  // On separate cache lines, as the slot is written by the producers and the consumers.
+  alignas(64) std::atomic<Box *> slot_{nullptr};
+  alignas(64) std::atomic<Box *> spare_{nullptr};
+  std::atomic<bool> has_stored_{false};
+  std::atomic<uint64_t> dropped_{0};
+};
+
+}  // namespace buffers
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXPERIMENTAL__BUFFERS__LATEST_ONLY_BUFFER_IMPLEMENTATION_HPP_
@@ -0,0 +1,252 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXPERIMENTAL__BUFFERS__LOCK_FREE_RING_BUFFER_IMPLEMENTATION_HPP_
+#define RCLCPP__EXPERIMENTAL__BUFFERS__LOCK_FREE_RING_BUFFER_IMPLEMENTATION_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "rclcpp/experimental/buffers/buffer_implementation_base.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+namespace buffers
+{
+
+/// Store elements in a fixed-size, FIFO buffer without using locks
+/**
+ * Like RingBufferImplementation, the oldest element is dropped when adding to
+ * a full buffer.
+ *
+ * Each slot has a sequence number telling whether it can be written or read
+ * in the current lap, so producers and consumers only synchronize through
+ * atomic operations.
+ * As a producer finding the buffer full removes the oldest element itself,
+ * there can always be multiple consumers.
+ *
+ * \tparam BufferT the type of the stored elements
+ * \tparam MultipleProducers if false there must be a single thread calling
+ *   enqueue() at a time, which avoids a compare-and-swap for each insertion
+ */
+template<typename BufferT, bool MultipleProducers = false>
+class LockFreeRingBufferImplementation : public BufferImplementationBase<BufferT>
+{
+public:
+  explicit LockFreeRingBufferImplementation(size_t capacity)
+  : capacity_(capacity)
+  {
+    if (capacity == 0) {
+      throw std::invalid_argument("capacity must be a positive, non-zero value");
+    }
+    slots_ = std::make_unique<Slot[]>(capacity_);
+    for (size_t i = 0; i < capacity_; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  virtual ~LockFreeRingBufferImplementation() {}
+
+  /// Add a new element to store in the ring buffer
+  /**
+   * This member function is lock-free, see MultipleProducers for concurrent calls.
+   *
+   * \param request the element to be stored in the ring buffer
+   */
+  void enqueue(BufferT request)
+  {
+    while (!try_enqueue(request)) {
+      // Full, drop the oldest element to make room.
+      BufferT dropped;
+      if (try_dequeue(dropped)) {
+        dropped_.fetch_add(1u, std::memory_order_relaxed);
+      }
+    }
+    const size_t depth = get_depth();
+    size_t high_water_mark = high_water_mark_.load(std::memory_order_relaxed);
+    while (depth > high_water_mark &&
+      !high_water_mark_.compare_exchange_weak(
+        high_water_mark, depth, std::memory_order_relaxed))
+    {
+    }
+  }
+
+  /// Remove the oldest element from ring buffer
+  /**
+   * This member function is lock-free and thread-safe.
+   *
+   * \return the element that is being removed from the ring buffer, or a
+   *   default constructed one if it is empty
+   */
+  BufferT dequeue()
+  {
+    BufferT request;
+    try_dequeue(request);
+    return request;
+  }
+
+  /// Get if the ring buffer has at least one element stored
+  /**
+   * This member function is lock-free and thread-safe.
+   *
+   * \return `true` if there is data and `false` otherwise
+   */
+  inline bool has_data() const
+  {
+    const size_t position = dequeue_position_.load(std::memory_order_relaxed);
+    const Slot & slot = slots_[position % capacity_];
+    return slot.sequence.load(std::memory_order_acquire) == position + 1;
+  }
+
+  /// Get if the size of the buffer is equal to its capacity
+  /**
+   * This member function is lock-free and thread-safe.
+   *
+   * \return `true` if the size of the buffer is equal is capacity
+   * and `false` otherwise
+   */
+  inline bool is_full() const
+  {
+    const size_t position = enqueue_position_.load(std::memory_order_relaxed);
+    const Slot & slot = slots_[position % capacity_];
+    return slot.sequence.load(std::memory_order_acquire) != position;
+  }
+
+  void clear()
+  {
+    BufferT request;
+    while (try_dequeue(request)) {
+      request = BufferT();
+    }
+  }
+
+  /// Get the occupancy of the buffer
+  /**
+   * This member function is lock-free and thread-safe, the depth is approximate
+   * while elements are being added or removed concurrently.
+   *
+   * \return the capacity, size, maximum size and number of dropped elements
+   */
+  BufferCounters get_counters() const
+  {
+    BufferCounters counters;
+    counters.capacity = capacity_;
+    counters.depth = get_depth();
+    counters.high_water_mark = high_water_mark_.load(std::memory_order_relaxed);
+    counters.dropped = dropped_.load(std::memory_order_relaxed);
+    return counters;
+  }
+
+private:
+  struct Slot
+  {
+    /// Position which can write the slot, or position + 1 once it can be read.
+    std::atomic<size_t> sequence;
+    BufferT data;
+  };
+
+  /// Get the number of stored elements, including the ones being added or removed.
+  size_t get_depth() const
+  {
+    const size_t dequeue_position = dequeue_position_.load(std::memory_order_relaxed);
+    const size_t enqueue_position = enqueue_position_.load(std::memory_order_relaxed);
+    if (enqueue_position <= dequeue_position) {
+      return 0;
+    }
+    return std::min(enqueue_position - dequeue_position, capacity_);
+  }
+
+  /// Store the element if not full, request is left untouched otherwise.
+  bool try_enqueue(BufferT & request)
+  {
+    size_t position = enqueue_position_.load(std::memory_order_relaxed);
+    Slot * slot;
+    while (true) {
+      slot = &slots_[position % capacity_];
+      const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      const auto diff =
+        static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+      if (diff == 0) {
+        if (!MultipleProducers) {
+          enqueue_position_.store(position + 1, std::memory_order_relaxed);
+          break;
+        }
+        if (enqueue_position_.compare_exchange_weak(
+            position, position + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      } else if (diff < 0) {
+        // The slot still holds the element from the previous lap.
+        return false;
+      } else {
+        position = enqueue_position_.load(std::memory_order_relaxed);
+      }
+    }
+    slot->data = std::move(request);
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Take the oldest element if not empty.
+  bool try_dequeue(BufferT & request)
+  {
+    size_t position = dequeue_position_.load(std::memory_order_relaxed);
+    Slot * slot;
+    while (true) {
+      slot = &slots_[position % capacity_];
+      const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      const auto diff =
+        static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+      if (diff == 0) {
+        if (dequeue_position_.compare_exchange_weak(
+            position, position + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      } else if (diff < 0) {
+        // The slot was not written in this lap yet.
+        return false;
+      } else {
+        position = dequeue_position_.load(std::memory_order_relaxed);
+      }
+    }
+    request = std::move(slot->data);
+    slot->data = BufferT();
+    slot->sequence.store(position + capacity_, std::memory_order_release);
+    return true;
+  }
+
+  const size_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+
+  // On separate cache lines, as they are written by different threads.
+  alignas(64) std::atomic<size_t> enqueue_position_{0};
+  alignas(64) std::atomic<size_t> dequeue_position_{0};
+  alignas(64) std::atomic<size_t> high_water_mark_{0};
+  std::atomic<uint64_t> dropped_{0};
+};
+
+}  // namespace buffers
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXPERIMENTAL__BUFFERS__LOCK_FREE_RING_BUFFER_IMPLEMENTATION_HPP_
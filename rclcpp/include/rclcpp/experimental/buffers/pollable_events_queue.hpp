@@ -0,0 +1,119 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXPERIMENTAL__BUFFERS__POLLABLE_EVENTS_QUEUE_HPP_
+#define RCLCPP__EXPERIMENTAL__BUFFERS__POLLABLE_EVENTS_QUEUE_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+
+#include "rclcpp/experimental/buffers/events_queue.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+namespace buffers
+{
+
+/// Unbounded FIFO events queue with a file descriptor readable while it holds events.
+/**
+ * The file descriptor can be monitored by an external event loop, e.g. with
+ * epoll, to run an EventsExecutor without dedicating a thread to spin():
+ *
+ * ```cpp
+ * auto queue = std::make_unique<rclcpp::experimental::buffers::PollableEventsQueue>();
+ * int fd = queue->get_fd();
+ * rclcpp::executors::EventsExecutor executor(std::move(queue));
+ * // When fd is readable, or after executor.get_time_until_next_timer():
+ * executor.spin_some();
+ * ```
+ *
+ * The file descriptor must not be read from nor written to, it becomes
+ * readable when the first event is enqueued and stops being readable once
+ * the last one is dequeued, so that it is only signaled once per burst of
+ * events.
+ *
+ * This is an eventfd on Linux and a pipe on the other POSIX platforms.
+ * Other platforms are not supported.
+ */
+class PollableEventsQueue : public EventsQueue
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(PollableEventsQueue)
+
+  /// Constructor.
+  /**
+   * \throws std::system_error if the file descriptor can't be created.
+   * \throws std::runtime_error if the platform isn't supported.
+   */
+  RCLCPP_PUBLIC
+  PollableEventsQueue();
+
+  RCLCPP_PUBLIC
+  ~PollableEventsQueue() override;
+
+  RCLCPP_PUBLIC
+  void
+  enqueue(const rclcpp::executors::ExecutorEvent & event) override;
+
+  RCLCPP_PUBLIC
+  bool
+  dequeue(
+    rclcpp::executors::ExecutorEvent & event,
+    std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) override;
+
+  RCLCPP_PUBLIC
+  bool
+  empty() const override;
+
+  RCLCPP_PUBLIC
+  size_t
+  size() const override;
+
+  /// Return the file descriptor readable while the queue holds events.
+  /**
+   * It is owned by the queue and closed when the queue is destroyed.
+   */
+  RCLCPP_PUBLIC
+  int
+  get_fd() const;
+
+private:
+  /// Make the file descriptor readable, requires mutex_.
+  void
+  signal();
+
+  /// Make the file descriptor not readable anymore, requires mutex_.
+  void
+  clear_signal();
+
+  std::queue<rclcpp::executors::ExecutorEvent> event_queue_;
+  mutable std::mutex mutex_;
+  std::condition_variable events_queue_cv_;
+
+  /// End read by the external event loop.
+  int read_fd_ = -1;
+  /// End written to, the same as read_fd_ for an eventfd.
+  int write_fd_ = -1;
+};
+
+}  // namespace buffers
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXPERIMENTAL__BUFFERS__POLLABLE_EVENTS_QUEUE_HPP_
@@ -15,6 +15,8 @@
 #ifndef RCLCPP__EXPERIMENTAL__BUFFERS__RING_BUFFER_IMPLEMENTATION_HPP_
 #define RCLCPP__EXPERIMENTAL__BUFFERS__RING_BUFFER_IMPLEMENTATION_HPP_
 
+#include <algorithm>
+#include <cstdint>
 #include <mutex>
 #include <stdexcept>
 #include <utility>
@@ -33,16 +35,30 @@ namespace experimental
 namespace buffers
 {
 
-/// Store elements in a fixed-size, FIFO buffer
+/// Store elements in a FIFO buffer, of a fixed size unless it adapts it
 /**
+ * When a maximum capacity greater than the capacity is given, the buffer adapts its
+ * capacity to the load: instead of overwriting the oldest element when it's full, it
+ * doubles its capacity, up to the maximum, and it halves it, down to the initial capacity,
+ * when no more than a quarter of it was used while enqueuing four times its capacity.
+ *
  * All public member functions are thread-safe.
  */
 template<typename BufferT>
 class RingBufferImplementation : public BufferImplementationBase<BufferT>
 {
 public:
-  explicit RingBufferImplementation(size_t capacity)
+  /// Constructor.
+  /**
+   * \param capacity the number of elements the buffer can store
+   * \param max_capacity the capacity the buffer can grow up to, no larger than capacity
+   *   to keep it fixed
+   * \throws std::invalid_argument if capacity is 0
+   */
+  explicit RingBufferImplementation(size_t capacity, size_t max_capacity = 0)
   : capacity_(capacity),
+    initial_capacity_(capacity),
+    max_capacity_(std::max(capacity, max_capacity)),
     ring_buffer_(capacity),
     write_index_(capacity_ - 1),
     read_index_(0),
@@ -65,13 +81,23 @@ public:
   {
     std::lock_guard<std::mutex> lock(mutex_);
 
+    if (is_full_() && capacity_ < max_capacity_) {
+      resize_(std::min(capacity_ * 2, max_capacity_));
+    }
+
     write_index_ = next_(write_index_);
     ring_buffer_[write_index_] = std::move(request);
 
     if (is_full_()) {
       read_index_ = next_(read_index_);
+      dropped_++;
     } else {
       size_++;
+      high_water_mark_ = std::max(high_water_mark_, size_);
+    }
+
+    if (capacity_ > initial_capacity_) {
+      shrink_if_underused_();
     }
   }
 
@@ -137,6 +163,25 @@ public:
 
   void clear() {}
 
+  /// Get the occupancy of the buffer
+  /**
+   * This member function is thread-safe.
+   *
+   * \return the capacity, size, maximum size, number of overwritten elements and
+   * number of changes of the capacity
+   */
+  BufferCounters get_counters() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    BufferCounters counters;
+    counters.capacity = capacity_;
+    counters.depth = size_;
+    counters.high_water_mark = high_water_mark_;
+    counters.dropped = dropped_;
+    counters.resizes = resizes_;
+    return counters;
+  }
+
 private:
   /// Get the next index value for the ring buffer
   /**
@@ -173,13 +218,60 @@ private:
     return size_ == capacity_;
   }
 
+  /// Change the capacity of the buffer, keeping its elements
+  /**
+   * This member function is not thread-safe.
+   *
+   * \param capacity the new capacity, no smaller than the size of the buffer
+   */
+  void resize_(size_t capacity)
+  {
+    std::vector<BufferT> ring_buffer(capacity);
+    for (size_t i = 0; i < size_; ++i) {
+      ring_buffer[i] = std::move(ring_buffer_[read_index_]);
+      read_index_ = next_(read_index_);
+    }
+    ring_buffer_ = std::move(ring_buffer);
+    capacity_ = capacity;
+    read_index_ = 0;
+    write_index_ = size_ == 0 ? capacity_ - 1 : size_ - 1;
+    resizes_++;
+    enqueued_in_window_ = 0;
+    window_max_size_ = size_;
+  }
+
+  /// Halve the capacity if no more than a quarter of it was used for a while
+  /**
+   * This member function is not thread-safe.
+   */
+  void shrink_if_underused_()
+  {
+    window_max_size_ = std::max(window_max_size_, size_);
+    if (++enqueued_in_window_ < capacity_ * 4) {
+      return;
+    }
+    if (window_max_size_ <= capacity_ / 4) {
+      resize_(std::max(capacity_ / 2, initial_capacity_));
+    } else {
+      enqueued_in_window_ = 0;
+      window_max_size_ = size_;
+    }
+  }
+
   size_t capacity_;
+  const size_t initial_capacity_;
+  const size_t max_capacity_;
 
   std::vector<BufferT> ring_buffer_;
 
   size_t write_index_;
   size_t read_index_;
   size_t size_;
+  size_t high_water_mark_ = 0;
+  uint64_t dropped_ = 0;
+  uint64_t resizes_ = 0;
+  size_t enqueued_in_window_ = 0;
+  size_t window_max_size_ = 0;
 
   mutable std::mutex mutex_;
 };
@@ -0,0 +1,92 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXPERIMENTAL__BUFFERS__SIMPLE_EVENTS_QUEUE_HPP_
+#define RCLCPP__EXPERIMENTAL__BUFFERS__SIMPLE_EVENTS_QUEUE_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+
+#include "rclcpp/experimental/buffers/events_queue.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+namespace buffers
+{
+
+/// Unbounded FIFO events queue protected by a mutex.
+class SimpleEventsQueue : public EventsQueue
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(SimpleEventsQueue)
+
+  void
+  enqueue(const rclcpp::executors::ExecutorEvent & event) override
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      event_queue_.push(event);
+    }
+    events_queue_cv_.notify_one();
+  }
+
+  bool
+  dequeue(
+    rclcpp::executors::ExecutorEvent & event,
+    std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) override
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    auto has_data_predicate = [this]() {return !event_queue_.empty();};
+    if (timeout == std::chrono::nanoseconds::max()) {
+      // Avoid overflowing the clock arithmetic of wait_for.
+      events_queue_cv_.wait(lock, has_data_predicate);
+    } else if (!events_queue_cv_.wait_for(lock, timeout, has_data_predicate)) {
+      return false;
+    }
+
+    event = event_queue_.front();
+    event_queue_.pop();
+    return true;
+  }
+
+  bool
+  empty() const override
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return event_queue_.empty();
+  }
+
+  size_t
+  size() const override
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return event_queue_.size();
+  }
+
+private:
+  std::queue<rclcpp::executors::ExecutorEvent> event_queue_;
+  mutable std::mutex mutex_;
+  std::condition_variable events_queue_cv_;
+};
+
+}  // namespace buffers
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXPERIMENTAL__BUFFERS__SIMPLE_EVENTS_QUEUE_HPP_
@@ -0,0 +1,349 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__EXPERIMENTAL__COROUTINES_HPP_
+#define RCLCPP__EXPERIMENTAL__COROUTINES_HPP_
+
+// The coroutines need C++20, while rclcpp itself is built with C++17.
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <chrono>
+#include <coroutine>  // NOLINT, cpplint doesn't think this is a cpp std header
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>  // NOLINT, cpplint doesn't think this is a cpp std header
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "rclcpp/client.hpp"
+#include "rclcpp/create_subscription.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/qos.hpp"
+#include "rclcpp/subscription.hpp"
+#include "rclcpp/timer.hpp"
+
+#define RCLCPP_HAS_COROUTINES 1
+
+namespace rclcpp
+{
+namespace experimental
+{
+
+/// Return type of the coroutines started by the user, which run until they are done.
+/**
+ * A coroutine returning a Task starts right away, and runs until its first `co_await` which
+ * has to wait, as suspending it returns to the caller.
+ * The awaitables of this file resume it from the callback completing them, which is executed
+ * by the executor of the node of their entity, so that the coroutine then runs on that
+ * executor without blocking one of its threads while it waits.
+ * Its frame is destroyed when it returns, and an exception thrown out of it terminates the
+ * process, as there is no caller to handle it.
+ *
+ * ```cpp
+ * rclcpp::experimental::Task
+ * call_then_sleep(rclcpp::Node::SharedPtr node, rclcpp::Client<ServiceT>::SharedPtr client)
+ * {
+ *   auto response = co_await rclcpp::experimental::async_send_request(client, request);
+ *   co_await rclcpp::experimental::sleep_for(node, std::chrono::seconds(1));
+ * }
+ * ```
+ *
+ * A coroutine waiting for an entity which is destroyed, or for a node which isn't spun
+ * anymore, is never resumed, and its frame isn't freed.
+ */
+class Task
+{
+public:
+  struct promise_type
+  {
+    Task
+    get_return_object() noexcept
+    {
+      return Task{};
+    }
+
+    std::suspend_never
+    initial_suspend() noexcept
+    {
+      return {};
+    }
+
+    std::suspend_never
+    final_suspend() noexcept
+    {
+      return {};
+    }
+
+    void
+    return_void() noexcept
+    {}
+
+    void
+    unhandled_exception() noexcept
+    {
+      std::terminate();
+    }
+  };
+};
+
+/// Awaitable of a value given to a callback, which resumes the coroutine waiting for it.
+/**
+ * The callback may be called before the coroutine awaits, in which case it doesn't wait,
+ * and by any thread.
+ * It is the building block of the other awaitables, and can be used for other callbacks:
+ *
+ * ```cpp
+ * rclcpp::experimental::CallbackAwaiter<int> awaiter;
+ * start_operation([completer = awaiter.get_completer()](int value) {completer(value);});
+ * int value = co_await awaiter;
+ * ```
+ */
+template<typename T>
+class CallbackAwaiter
+{
+  struct State
+  {
+    std::mutex mutex;
+    std::optional<T> value;
+    std::coroutine_handle<> handle;
+  };
+
+public:
+  /// Callable completing the awaiter with a value, which must only be called once.
+  class Completer
+  {
+public:
+    void
+    operator()(T value) const
+    {
+      std::coroutine_handle<> handle;
+      {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->value.emplace(std::move(value));
+        handle = state_->handle;
+      }
+      // Resumed out of the lock, since it may destroy the awaiter.
+      if (handle) {
+        handle.resume();
+      }
+    }
+
+private:
+    friend class CallbackAwaiter;
+
+    explicit Completer(std::shared_ptr<State> state)
+    : state_(std::move(state))
+    {}
+
+    std::shared_ptr<State> state_;
+  };
+
+  CallbackAwaiter()
+  : state_(std::make_shared<State>())
+  {}
+
+  /// Return the callable completing the awaiter, which keeps its state alive.
+  Completer
+  get_completer() const
+  {
+    return Completer(state_);
+  }
+
+  /// Keep an object alive until the awaiter is destroyed, such as the entity completing it.
+  void
+  keep_alive(std::shared_ptr<void> object)
+  {
+    keep_alive_ = std::move(object);
+  }
+
+  bool
+  await_ready() const
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->value.has_value();
+  }
+
+  bool
+  await_suspend(std::coroutine_handle<> handle)
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    if (state_->value.has_value()) {
+      // Completed since await_ready(), so the coroutine goes on.
+      return false;
+    }
+    state_->handle = handle;
+    return true;
+  }
+
+  T
+  await_resume()
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return std::move(*state_->value);
+  }
+
+private:
+  std::shared_ptr<State> state_;
+  std::shared_ptr<void> keep_alive_;
+};
+
+/// Send a request, returning an awaitable of its response.
+/**
+ * The coroutine is resumed by the executor of the client when the response is received.
+ */
+template<typename ServiceT>
+CallbackAwaiter<typename rclcpp::Client<ServiceT>::SharedResponse>
+async_send_request(
+  const typename rclcpp::Client<ServiceT>::SharedPtr & client,
+  typename rclcpp::Client<ServiceT>::SharedRequest request)
+{
+  using SharedResponse = typename rclcpp::Client<ServiceT>::SharedResponse;
+  CallbackAwaiter<SharedResponse> awaiter;
+  client->async_send_request(
+    std::move(request),
+    [completer = awaiter.get_completer()](typename rclcpp::Client<ServiceT>::SharedFuture future) {
+      completer(future.get());
+    });
+  return awaiter;
+}
+
+/// Awaitable of a duration, resuming the coroutine with the executor of a node.
+class SleepAwaiter : public CallbackAwaiter<bool>
+{
+public:
+  void
+  await_resume()
+  {
+    CallbackAwaiter<bool>::await_resume();
+  }
+};
+
+/// Return an awaitable resuming the coroutine after a duration, with a one-shot wall timer.
+/**
+ * \param[in] node The node creating the timer, whose executor resumes the coroutine.
+ * \param[in] duration The duration of the sleep.
+ */
+template<typename NodeT, typename DurationRepT, typename DurationT>
+SleepAwaiter
+sleep_for(NodeT && node, std::chrono::duration<DurationRepT, DurationT> duration)
+{
+  SleepAwaiter awaiter;
+  awaiter.keep_alive(
+    node->create_wall_timer(
+      duration,
+      [completer = awaiter.get_completer()](rclcpp::TimerBase & timer) {
+        timer.cancel();
+        completer(true);
+      }));
+  return awaiter;
+}
+
+/// Subscription whose messages are awaited by a coroutine, one at a time.
+/**
+ * The messages received while no coroutine awaits are queued, up to the depth of the
+ * history of the subscription, dropping the oldest ones.
+ */
+template<typename MessageT>
+class MessageStream
+{
+  struct Queue
+  {
+    std::mutex mutex;
+    size_t depth;
+    std::deque<std::shared_ptr<const MessageT>> messages;
+    std::optional<
+      typename CallbackAwaiter<std::shared_ptr<const MessageT>>::Completer> waiting;
+  };
+
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(MessageStream)
+
+  /// Constructor.
+  /**
+   * \param[in] node The node creating the subscription, whose executor resumes the coroutine.
+   * \param[in] topic The topic of the subscription.
+   * \param[in] qos The QoS of the subscription, whose depth bounds the queue.
+   */
+  template<typename NodeT>
+  MessageStream(NodeT && node, const std::string & topic, const rclcpp::QoS & qos)
+  : queue_(std::make_shared<Queue>())
+  {
+    queue_->depth = qos.depth() == 0 ? 1 : qos.depth();
+    subscription_ = rclcpp::create_subscription<MessageT>(
+      std::forward<NodeT>(node), topic, qos,
+      [queue = queue_](std::shared_ptr<const MessageT> message) {
+        std::optional<typename CallbackAwaiter<std::shared_ptr<const MessageT>>::Completer>
+        waiting;
+        {
+          std::lock_guard<std::mutex> lock(queue->mutex);
+          if (!queue->waiting) {
+            if (queue->messages.size() >= queue->depth) {
+              queue->messages.pop_front();
+            }
+            queue->messages.push_back(std::move(message));
+            return;
+          }
+          waiting.swap(queue->waiting);
+        }
+        (*waiting)(std::move(message));
+      });
+  }
+
+  /// Return an awaitable of the next message.
+  /**
+   * \throws std::logic_error if a coroutine is already awaiting a message.
+   */
+  CallbackAwaiter<std::shared_ptr<const MessageT>>
+  next()
+  {
+    CallbackAwaiter<std::shared_ptr<const MessageT>> awaiter;
+    std::shared_ptr<const MessageT> message;
+    {
+      std::lock_guard<std::mutex> lock(queue_->mutex);
+      if (queue_->waiting) {
+        throw std::logic_error("a coroutine is already awaiting the next message");
+      }
+      if (queue_->messages.empty()) {
+        queue_->waiting.emplace(awaiter.get_completer());
+        return awaiter;
+      }
+      message = std::move(queue_->messages.front());
+      queue_->messages.pop_front();
+    }
+    awaiter.get_completer()(std::move(message));
+    return awaiter;
+  }
+
+  /// Return the subscription of the stream.
+  typename rclcpp::Subscription<MessageT>::SharedPtr
+  get_subscription() const
+  {
+    return subscription_;
+  }
+
+private:
+  std::shared_ptr<Queue> queue_;
+  typename rclcpp::Subscription<MessageT>::SharedPtr subscription_;
+};
+
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#endif  // RCLCPP__EXPERIMENTAL__COROUTINES_HPP_
@@ -19,8 +19,12 @@
 #include <stdexcept>
 #include <utility>
 
+#include "rclcpp/experimental/buffers/buffer_implementation_base.hpp"
 #include "rclcpp/experimental/buffers/intra_process_buffer.hpp"
+#include "rclcpp/experimental/buffers/latest_only_buffer_implementation.hpp"
+#include "rclcpp/experimental/buffers/lock_free_ring_buffer_implementation.hpp"
 #include "rclcpp/experimental/buffers/ring_buffer_implementation.hpp"
+#include "rclcpp/intra_process_buffer_implementation.hpp"
 #include "rclcpp/intra_process_buffer_type.hpp"
 #include "rclcpp/qos.hpp"
 
@@ -29,6 +33,31 @@ namespace rclcpp
 namespace experimental
 {
 
+template<typename BufferT>
+std::unique_ptr<rclcpp::experimental::buffers::BufferImplementationBase<BufferT>>
+create_intra_process_buffer_implementation(
+  IntraProcessBufferImplementation buffer_implementation,
+  size_t buffer_size,
+  size_t max_buffer_size = 0)
+{
+  using rclcpp::experimental::buffers::LatestOnlyBufferImplementation;
+  using rclcpp::experimental::buffers::LockFreeRingBufferImplementation;
+  using rclcpp::experimental::buffers::RingBufferImplementation;
+
+  switch (buffer_implementation) {
+    case IntraProcessBufferImplementation::RingBuffer:
+      return std::make_unique<RingBufferImplementation<BufferT>>(buffer_size, max_buffer_size);
+    case IntraProcessBufferImplementation::LockFreeSingleProducer:
+      return std::make_unique<LockFreeRingBufferImplementation<BufferT, false>>(buffer_size);
+    case IntraProcessBufferImplementation::LockFreeMultiProducer:
+      return std::make_unique<LockFreeRingBufferImplementation<BufferT, true>>(buffer_size);
+    case IntraProcessBufferImplementation::LatestOnly:
+      return std::make_unique<LatestOnlyBufferImplementation<BufferT>>();
+    default:
+      throw std::runtime_error("Unrecognized IntraProcessBufferImplementation value");
+  }
+}
+
 template<
   typename MessageT,
   typename Alloc = std::allocator<void>,
@@ -37,7 +66,10 @@ typename rclcpp::experimental::buffers::IntraProcessBuffer<MessageT, Alloc, Dele
 create_intra_process_buffer(
   IntraProcessBufferType buffer_type,
   const rclcpp::QoS & qos,
-  std::shared_ptr<Alloc> allocator)
+  std::shared_ptr<Alloc> allocator,
+  IntraProcessBufferImplementation buffer_implementation =
+  IntraProcessBufferImplementation::RingBuffer,
+  size_t max_buffer_size = 0)
 {
   using MessageSharedPtr = std::shared_ptr<const MessageT>;
   using MessageUniquePtr = std::unique_ptr<MessageT, Deleter>;
@@ -52,15 +84,14 @@ create_intra_process_buffer(
       {
         using BufferT = MessageSharedPtr;
 
-        auto buffer_implementation =
-          std::make_unique<rclcpp::experimental::buffers::RingBufferImplementation<BufferT>>(
-          buffer_size);
+        auto buffer_impl = create_intra_process_buffer_implementation<BufferT>(
+          buffer_implementation, buffer_size, max_buffer_size);
 
         // Construct the intra_process_buffer
         buffer =
           std::make_unique<rclcpp::experimental::buffers::TypedIntraProcessBuffer<MessageT, Alloc,
             Deleter, BufferT>>(
-          std::move(buffer_implementation),
+          std::move(buffer_impl),
           allocator);
 
         break;
@@ -69,15 +100,14 @@ create_intra_process_buffer(
       {
         using BufferT = MessageUniquePtr;
 
-        auto buffer_implementation =
-          std::make_unique<rclcpp::experimental::buffers::RingBufferImplementation<BufferT>>(
-          buffer_size);
+        auto buffer_impl = create_intra_process_buffer_implementation<BufferT>(
+          buffer_implementation, buffer_size, max_buffer_size);
 
         // Construct the intra_process_buffer
         buffer =
           std::make_unique<rclcpp::experimental::buffers::TypedIntraProcessBuffer<MessageT, Alloc,
             Deleter, BufferT>>(
-          std::move(buffer_implementation),
+          std::move(buffer_impl),
           allocator);
 
         break;
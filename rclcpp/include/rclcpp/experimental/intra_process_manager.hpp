@@ -19,23 +19,30 @@
 
 #include <shared_mutex>
 
+#include <deque>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 #include <typeinfo>
 
 #include "rclcpp/allocator/allocator_deleter.hpp"
+#include "rclcpp/context.hpp"
+#include "rclcpp/detail/intra_process_pipeline.hpp"
 #include "rclcpp/experimental/ros_message_intra_process_buffer.hpp"
 #include "rclcpp/experimental/subscription_intra_process.hpp"
 #include "rclcpp/experimental/subscription_intra_process_base.hpp"
 #include "rclcpp/experimental/subscription_intra_process_buffer.hpp"
+#include "rclcpp/experimental/subscription_serialized_intra_process.hpp"
 #include "rclcpp/logger.hpp"
 #include "rclcpp/logging.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/publisher_base.hpp"
+#include "rclcpp/serialized_message.hpp"
 #include "rclcpp/type_adapter.hpp"
 #include "rclcpp/visibility_control.hpp"
 
@@ -51,7 +58,9 @@ namespace experimental
  * A singleton instance of this class is owned by a rclcpp::Context and a
  * rclcpp::Node can use an associated Context to get an instance of this class.
  * Nodes which do not have a common Context will not exchange intra process
- * messages because they do not share access to the same instance of this class.
+ * messages because they do not share access to the same instance of this class,
+ * unless their contexts share the instance of their domain, see
+ * rclcpp::InitOptions::share_intra_process_manager().
  *
  * When a Node creates a subscription, it can also create a helper class,
  * called SubscriptionIntraProcess, meant to receive intra process messages.
@@ -86,6 +95,19 @@ namespace experimental
  * This information allows this class to operate efficiently by performing the
  * fewest number of copies of the message required.
  *
+ * The transient local publishers keep their last messages, as many as the depth of
+ * their history, and give them to the transient local subscriptions added later,
+ * sharing them like the published messages.
+ *
+ * Publishers of serialized messages, like rclcpp::GenericPublisher, only communicate
+ * with the subscriptions of serialized messages, SubscriptionSerializedIntraProcess,
+ * which all share the published message.
+ * The other ones keep communicating with them through the middleware.
+ *
+ * The publishers and subscriptions may use different allocator types: the subscriptions
+ * not requesting ownership then share the published message too, while the other ones
+ * get a copy made with their own allocator.
+ *
  * This class is neither CopyConstructable nor CopyAssignable.
  */
 class IntraProcessManager
@@ -134,11 +156,12 @@ public:
    * In addition this generates a unique intra process id for the publisher.
    *
    * \param publisher publisher to be registered with the manager.
+   * \param is_serialized true if the publisher publishes serialized messages.
    * \return an unsigned 64-bit integer which is the publisher's unique id.
    */
   RCLCPP_PUBLIC
   uint64_t
-  add_publisher(rclcpp::PublisherBase::SharedPtr publisher);
+  add_publisher(rclcpp::PublisherBase::SharedPtr publisher, bool is_serialized = false);
 
   /// Unregister a publisher using the publisher's unique id.
   /**
@@ -199,41 +222,42 @@ public:
         "Calling do_intra_process_publish for invalid or no longer existing publisher id");
       return;
     }
-    const auto & sub_ids = publisher_it->second;
+    if (publisher_it->second.history) {
+      // The history keeps the message, so it's shared anyway.
+      this->template publish_and_return_shared<MessageT, Alloc, Deleter, ROSMessageType>(
+        publisher_it->second, std::move(message), allocator);
+      return;
+    }
+    const auto dispatch_table =
+      this->template get_dispatch_table<MessageT, Alloc, Deleter, ROSMessageType>(
+      publisher_it->second);
 
-    if (sub_ids.take_ownership_subscriptions.empty()) {
+    if (dispatch_table->take_ownership_subscriptions.empty()) {
       // None of the buffers require ownership, so we promote the pointer
       std::shared_ptr<MessageT> msg = std::move(message);
 
       this->template add_shared_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
-        msg, sub_ids.take_shared_subscriptions);
-    } else if (!sub_ids.take_ownership_subscriptions.empty() && // NOLINT
-      sub_ids.take_shared_subscriptions.size() <= 1)
+        msg, dispatch_table->take_shared_subscriptions);
+    } else if (!dispatch_table->take_ownership_subscriptions.empty() && // NOLINT
+      dispatch_table->take_shared_subscriptions.size() <= 1)
     {
       // There is at maximum 1 buffer that does not require ownership.
       // So this case is equivalent to all the buffers requiring ownership
-
-      // Merge the two vector of ids into a unique one
-      std::vector<uint64_t> concatenated_vector(sub_ids.take_shared_subscriptions);
-      concatenated_vector.insert(
-        concatenated_vector.end(),
-        sub_ids.take_ownership_subscriptions.begin(),
-        sub_ids.take_ownership_subscriptions.end());
       this->template add_owned_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
         std::move(message),
-        concatenated_vector,
+        dispatch_table->all_subscriptions,
         allocator);
-    } else if (!sub_ids.take_ownership_subscriptions.empty() && // NOLINT
-      sub_ids.take_shared_subscriptions.size() > 1)
+    } else if (!dispatch_table->take_ownership_subscriptions.empty() && // NOLINT
+      dispatch_table->take_shared_subscriptions.size() > 1)
     {
       // Construct a new shared pointer from the message
       // for the buffers that do not require ownership
       auto shared_msg = std::allocate_shared<MessageT, MessageAllocatorT>(allocator, *message);
 
       this->template add_shared_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
-        shared_msg, sub_ids.take_shared_subscriptions);
+        shared_msg, dispatch_table->take_shared_subscriptions);
       this->template add_owned_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
-        std::move(message), sub_ids.take_ownership_subscriptions, allocator);
+        std::move(message), dispatch_table->take_ownership_subscriptions, allocator);
     }
   }
 
@@ -249,9 +273,6 @@ public:
     std::unique_ptr<MessageT, Deleter> message,
     typename allocator::AllocRebind<MessageT, Alloc>::allocator_type & allocator)
   {
-    using MessageAllocTraits = allocator::AllocRebind<MessageT, Alloc>;
-    using MessageAllocatorT = typename MessageAllocTraits::allocator_type;
-
     std::shared_lock<std::shared_timed_mutex> lock(mutex_);
 
     auto publisher_it = pub_to_subs_.find(intra_process_publisher_id);
@@ -262,40 +283,32 @@ public:
         "Calling do_intra_process_publish for invalid or no longer existing publisher id");
       return nullptr;
     }
-    const auto & sub_ids = publisher_it->second;
-
-    if (sub_ids.take_ownership_subscriptions.empty()) {
-      // If there are no owning, just convert to shared.
-      std::shared_ptr<MessageT> shared_msg = std::move(message);
-      if (!sub_ids.take_shared_subscriptions.empty()) {
-        this->template add_shared_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
-          shared_msg, sub_ids.take_shared_subscriptions);
-      }
-      return shared_msg;
-    } else {
-      // Construct a new shared pointer from the message for the buffers that
-      // do not require ownership and to return.
-      auto shared_msg = std::allocate_shared<MessageT, MessageAllocatorT>(allocator, *message);
-
-      if (!sub_ids.take_shared_subscriptions.empty()) {
-        this->template add_shared_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
-          shared_msg,
-          sub_ids.take_shared_subscriptions);
-      }
-      if (!sub_ids.take_ownership_subscriptions.empty()) {
-        this->template add_owned_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
-          std::move(message),
-          sub_ids.take_ownership_subscriptions,
-          allocator);
-      }
-      return shared_msg;
-    }
+    return this->template publish_and_return_shared<MessageT, Alloc, Deleter, ROSMessageType>(
+      publisher_it->second, std::move(message), allocator);
   }
 
+  /// Publishes an intra-process serialized message, shared by all the subscriptions.
+  /**
+   * The subscriptions of a publisher registered with is_serialized are all
+   * SubscriptionSerializedIntraProcess, which store the message without copying it.
+   *
+   * \param intra_process_publisher_id the id of the publisher of this message.
+   * \param message the serialized message that is being stored.
+   */
+  RCLCPP_PUBLIC
+  void
+  do_serialized_intra_process_publish(
+    uint64_t intra_process_publisher_id,
+    std::shared_ptr<const rclcpp::SerializedMessage> message);
+
   /// Return true if the given rmw_gid_t matches any stored Publishers.
+  /**
+   * Only the publishers of serialized messages are matched if is_serialized is true,
+   * and only the other ones otherwise.
+   */
   RCLCPP_PUBLIC
   bool
-  matches_any_publishers(const rmw_gid_t * id) const;
+  matches_any_publishers(const rmw_gid_t * id, bool is_serialized = false) const;
 
   /// Return the number of intraprocess subscriptions that are matched with a given publisher id.
   RCLCPP_PUBLIC
@@ -306,11 +319,92 @@ public:
   rclcpp::experimental::SubscriptionIntraProcessBase::SharedPtr
   get_subscription_intra_process(uint64_t intra_process_subscription_id);
 
+  /// Return the publishers added to the intra process manager which still exist.
+  RCLCPP_PUBLIC
+  std::vector<rclcpp::PublisherBase::SharedPtr>
+  get_publishers() const;
+
 private:
+  /// Type-erased base of DispatchTable.
+  struct DispatchTableBase
+  {
+    virtual ~DispatchTableBase() = default;
+
+    /// Identifies the DispatchTable instantiation, so it can be cast back without RTTI.
+    const void * type_tag = nullptr;
+  };
+
+  /// Subscriptions of a publisher, resolved to the buffer types used to publish to them.
+  template<
+    typename MessageT,
+    typename Alloc,
+    typename Deleter,
+    typename ROSMessageType>
+  struct DispatchTable : public DispatchTableBase
+  {
+    using ROSMessageTypeAllocatorTraits = allocator::AllocRebind<ROSMessageType, Alloc>;
+    using ROSMessageTypeAllocator = typename ROSMessageTypeAllocatorTraits::allocator_type;
+    using ROSMessageTypeDeleter = allocator::Deleter<ROSMessageTypeAllocator, ROSMessageType>;
+
+    using PublishedType = typename rclcpp::TypeAdapter<MessageT>::custom_type;
+    using PublishedTypeAllocatorTraits = allocator::AllocRebind<PublishedType, Alloc>;
+    using PublishedTypeAllocator = typename PublishedTypeAllocatorTraits::allocator_type;
+    using PublishedTypeDeleter = allocator::Deleter<PublishedTypeAllocator, PublishedType>;
+
+    using SubscriptionT = rclcpp::experimental::SubscriptionIntraProcessBuffer<PublishedType,
+        PublishedTypeAllocator, PublishedTypeDeleter, ROSMessageType>;
+    using ROSMessageSubscriptionT = rclcpp::experimental::SubscriptionROSMsgIntraProcessBuffer<
+      ROSMessageType, ROSMessageTypeAllocator, ROSMessageTypeDeleter>;
+    /// Subscription whose allocator type differs from the one of the publisher.
+    using BridgedSubscriptionT =
+      rclcpp::experimental::SubscriptionROSMsgIntraProcessBufferBase<ROSMessageType>;
+
+    /// Only one of the three pointers is set.
+    struct Entry
+    {
+      std::shared_ptr<SubscriptionT> subscription;
+      std::shared_ptr<ROSMessageSubscriptionT> ros_message_subscription;
+      std::shared_ptr<BridgedSubscriptionT> bridged_subscription;
+    };
+
+    std::vector<Entry> take_shared_subscriptions;
+    std::vector<Entry> take_ownership_subscriptions;
+    /// The take_shared_subscriptions followed by the take_ownership_subscriptions.
+    std::vector<Entry> all_subscriptions;
+  };
+
+  /// Last messages of a transient local publisher, given to the subscriptions joining later.
+  struct TransientLocalHistory
+  {
+    using ReplayFunction = void (*)(
+      IntraProcessManager &,
+      const std::shared_ptr<const void> &,
+      const rclcpp::experimental::SubscriptionIntraProcessBase::SharedPtr &);
+
+    /// A message, with the function giving it to a subscription, as its type is erased.
+    struct Entry
+    {
+      std::shared_ptr<const void> message;
+      ReplayFunction replay;
+    };
+
+    explicit TransientLocalHistory(size_t depth)
+    : depth(depth)
+    {}
+
+    const size_t depth;
+    std::mutex mutex;
+    std::deque<Entry> messages;
+  };
+
   struct SplittedSubscriptions
   {
     std::vector<uint64_t> take_shared_subscriptions;
     std::vector<uint64_t> take_ownership_subscriptions;
+    /// Built on publish and reset when the subscriptions change, only accessed atomically.
+    std::shared_ptr<const DispatchTableBase> dispatch_table;
+    /// Set for the transient local publishers of ROS messages.
+    std::shared_ptr<TransientLocalHistory> history;
   };
 
   using SubscriptionMap =
@@ -331,69 +425,249 @@ private:
   void
   insert_sub_id_for_pub(uint64_t sub_id, uint64_t pub_id, bool use_take_shared_method);
 
+  /// Give the messages of the history of a publisher to a subscription, oldest first.
+  RCLCPP_PUBLIC
+  void
+  replay_history(
+    TransientLocalHistory & history,
+    const rclcpp::experimental::SubscriptionIntraProcessBase::SharedPtr & subscription);
+
   RCLCPP_PUBLIC
   bool
   can_communicate(
     rclcpp::PublisherBase::SharedPtr pub,
+    bool pub_is_serialized,
     rclcpp::experimental::SubscriptionIntraProcessBase::SharedPtr sub) const;
 
+  template<typename TableT>
+  static
+  const void *
+  get_dispatch_table_tag()
+  {
+    static const char tag = 0;
+    return &tag;
+  }
+
+  /// Get the dispatch table of a publisher, building it if the subscriptions changed.
+  /**
+   * This must be called holding mutex_, at least in shared mode.
+   */
   template<
     typename MessageT,
     typename Alloc,
     typename Deleter,
     typename ROSMessageType>
-  void
-  add_shared_msg_to_buffers(
-    std::shared_ptr<const MessageT> message,
-    std::vector<uint64_t> subscription_ids)
+  std::shared_ptr<const DispatchTable<MessageT, Alloc, Deleter, ROSMessageType>>
+  get_dispatch_table(SplittedSubscriptions & sub_ids) const
   {
-    using ROSMessageTypeAllocatorTraits = allocator::AllocRebind<ROSMessageType, Alloc>;
-    using ROSMessageTypeAllocator = typename ROSMessageTypeAllocatorTraits::allocator_type;
-    using ROSMessageTypeDeleter = allocator::Deleter<ROSMessageTypeAllocator, ROSMessageType>;
+    using TableT = DispatchTable<MessageT, Alloc, Deleter, ROSMessageType>;
+    const void * type_tag = get_dispatch_table_tag<TableT>();
 
-    using PublishedType = typename rclcpp::TypeAdapter<MessageT>::custom_type;
-    using PublishedTypeAllocatorTraits = allocator::AllocRebind<PublishedType, Alloc>;
-    using PublishedTypeAllocator = typename PublishedTypeAllocatorTraits::allocator_type;
-    using PublishedTypeDeleter = allocator::Deleter<PublishedTypeAllocator, PublishedType>;
+    auto dispatch_table = std::atomic_load(&sub_ids.dispatch_table);
+    if (dispatch_table && dispatch_table->type_tag == type_tag) {
+      return std::static_pointer_cast<const TableT>(dispatch_table);
+    }
+
+    // Concurrent publishers may build it at the same time, which is harmless.
+    auto new_dispatch_table = std::make_shared<TableT>();
+    new_dispatch_table->type_tag = type_tag;
+
+    auto resolve_subscriptions =
+      [this](
+      const std::vector<uint64_t> & subscription_ids,
+      std::vector<typename TableT::Entry> & entries)
+      {
+        for (auto id : subscription_ids) {
+          auto subscription_it = subscriptions_.find(id);
+          if (subscription_it == subscriptions_.end()) {
+            throw std::runtime_error("subscription has unexpectedly gone out of scope");
+          }
+          auto subscription_base = subscription_it->second.lock();
+          if (subscription_base == nullptr) {
+            continue;
+          }
+          entries.push_back(make_dispatch_entry<TableT>(subscription_base));
+        }
+      };
+    resolve_subscriptions(
+      sub_ids.take_shared_subscriptions, new_dispatch_table->take_shared_subscriptions);
+    resolve_subscriptions(
+      sub_ids.take_ownership_subscriptions, new_dispatch_table->take_ownership_subscriptions);
+    new_dispatch_table->all_subscriptions = new_dispatch_table->take_shared_subscriptions;
+    new_dispatch_table->all_subscriptions.insert(
+      new_dispatch_table->all_subscriptions.end(),
+      new_dispatch_table->take_ownership_subscriptions.begin(),
+      new_dispatch_table->take_ownership_subscriptions.end());
+
+    std::atomic_store(
+      &sub_ids.dispatch_table,
+      std::shared_ptr<const DispatchTableBase>(new_dispatch_table));
+    return new_dispatch_table;
+  }
+
+  /// Publish a message to the subscriptions of a publisher, returning it as a shared message.
+  /**
+   * The message is also kept in the history of the publisher, if it has one.
+   * This must be called holding mutex_, at least in shared mode.
+   */
+  template<
+    typename MessageT,
+    typename Alloc,
+    typename Deleter,
+    typename ROSMessageType>
+  std::shared_ptr<const MessageT>
+  publish_and_return_shared(
+    SplittedSubscriptions & sub_ids,
+    std::unique_ptr<MessageT, Deleter> message,
+    typename allocator::AllocRebind<MessageT, Alloc>::allocator_type & allocator)
+  {
+    using MessageAllocTraits = allocator::AllocRebind<MessageT, Alloc>;
+    using MessageAllocatorT = typename MessageAllocTraits::allocator_type;
+
+    const auto dispatch_table =
+      this->template get_dispatch_table<MessageT, Alloc, Deleter, ROSMessageType>(sub_ids);
 
-    for (auto id : subscription_ids) {
-      auto subscription_it = subscriptions_.find(id);
-      if (subscription_it == subscriptions_.end()) {
-        throw std::runtime_error("subscription has unexpectedly gone out of scope");
+    std::shared_ptr<const MessageT> shared_msg;
+    if (dispatch_table->take_ownership_subscriptions.empty()) {
+      // If there are no owning, just convert to shared.
+      shared_msg = std::move(message);
+      if (!dispatch_table->take_shared_subscriptions.empty()) {
+        this->template add_shared_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
+          shared_msg, dispatch_table->take_shared_subscriptions);
       }
-      auto subscription_base = subscription_it->second.lock();
-      if (subscription_base == nullptr) {
-        subscriptions_.erase(id);
-        continue;
+    } else {
+      // Construct a new shared pointer from the message for the buffers that
+      // do not require ownership and to return.
+      shared_msg = std::allocate_shared<MessageT, MessageAllocatorT>(allocator, *message);
+
+      if (!dispatch_table->take_shared_subscriptions.empty()) {
+        this->template add_shared_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
+          shared_msg,
+          dispatch_table->take_shared_subscriptions);
       }
+      this->template add_owned_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
+        std::move(message),
+        dispatch_table->take_ownership_subscriptions,
+        allocator);
+    }
 
-      auto subscription = std::dynamic_pointer_cast<
-        rclcpp::experimental::SubscriptionIntraProcessBuffer<PublishedType,
-        PublishedTypeAllocator, PublishedTypeDeleter, ROSMessageType>
-        >(subscription_base);
-      if (subscription != nullptr) {
-        subscription->provide_intra_process_data(message);
-        continue;
+    if (sub_ids.history) {
+      auto & history = *sub_ids.history;
+      const auto replay = &IntraProcessManager::replay_message<
+        MessageT, Alloc, Deleter, ROSMessageType>;
+      std::lock_guard<std::mutex> history_lock(history.mutex);
+      history.messages.push_back({shared_msg, replay});
+      if (history.messages.size() > history.depth) {
+        history.messages.pop_front();
       }
+    }
+    return shared_msg;
+  }
 
-      auto ros_message_subscription = std::dynamic_pointer_cast<
-        rclcpp::experimental::SubscriptionROSMsgIntraProcessBuffer<ROSMessageType,
-        ROSMessageTypeAllocator, ROSMessageTypeDeleter>
-        >(subscription_base);
-      if (nullptr == ros_message_subscription) {
+  /// Give a message of the history of a publisher to a transient local subscription.
+  template<
+    typename MessageT,
+    typename Alloc,
+    typename Deleter,
+    typename ROSMessageType>
+  static
+  void
+  replay_message(
+    IntraProcessManager & ipm,
+    const std::shared_ptr<const void> & message,
+    const rclcpp::experimental::SubscriptionIntraProcessBase::SharedPtr & subscription)
+  {
+    using TableT = DispatchTable<MessageT, Alloc, Deleter, ROSMessageType>;
+    std::vector<typename TableT::Entry> entries{make_dispatch_entry<TableT>(subscription)};
+    ipm.template add_shared_msg_to_buffers<MessageT, Alloc, Deleter, ROSMessageType>(
+      std::static_pointer_cast<const MessageT>(message), entries);
+  }
+
+  /// Resolve a subscription to the buffer type used to publish to it.
+  template<typename TableT>
+  static
+  typename TableT::Entry
+  make_dispatch_entry(
+    const rclcpp::experimental::SubscriptionIntraProcessBase::SharedPtr & subscription_base)
+  {
+    typename TableT::Entry entry;
+    entry.subscription =
+      std::dynamic_pointer_cast<typename TableT::SubscriptionT>(subscription_base);
+    if (entry.subscription == nullptr) {
+      entry.ros_message_subscription = std::dynamic_pointer_cast<
+        typename TableT::ROSMessageSubscriptionT>(subscription_base);
+    }
+    if (entry.subscription == nullptr && entry.ros_message_subscription == nullptr) {
+      // The publisher and the subscription use different allocator types.
+      entry.bridged_subscription = std::dynamic_pointer_cast<
+        typename TableT::BridgedSubscriptionT>(subscription_base);
+      if (nullptr == entry.bridged_subscription) {
         throw std::runtime_error(
                 "failed to dynamic cast SubscriptionIntraProcessBase to "
                 "SubscriptionIntraProcessBuffer<MessageT, Alloc, Deleter>, or to "
-                "SubscriptionROSMsgIntraProcessBuffer<ROSMessageType,ROSMessageTypeAllocator,"
-                "ROSMessageTypeDeleter> which can happen when the publisher and "
-                "subscription use different allocator types, which is not supported");
+                "SubscriptionROSMsgIntraProcessBufferBase<ROSMessageType>, which can happen "
+                "when the publisher and subscription use different message types");
+      }
+    }
+    return entry;
+  }
+
+  /// Queue a subscription in the pipeline of the thread, if it has one.
+  /**
+   * \sa rclcpp::ExecutorOptions::run_intra_process_consumers_inline
+   */
+  template<typename EntryT>
+  static
+  void
+  add_to_pipeline(const EntryT & entry)
+  {
+    if (!rclcpp::detail::IntraProcessPipeline::is_active()) {
+      return;
+    }
+    if (entry.subscription != nullptr) {
+      rclcpp::detail::IntraProcessPipeline::enqueue(entry.subscription);
+    } else if (entry.ros_message_subscription != nullptr) {
+      rclcpp::detail::IntraProcessPipeline::enqueue(entry.ros_message_subscription);
+    } else {
+      rclcpp::detail::IntraProcessPipeline::enqueue(entry.bridged_subscription);
+    }
+  }
+
+  template<
+    typename MessageT,
+    typename Alloc,
+    typename Deleter,
+    typename ROSMessageType>
+  void
+  add_shared_msg_to_buffers(
+    std::shared_ptr<const MessageT> message,
+    const std::vector<typename DispatchTable<MessageT, Alloc, Deleter, ROSMessageType>::Entry> &
+    subscriptions)
+  {
+    using TableT = DispatchTable<MessageT, Alloc, Deleter, ROSMessageType>;
+    using BridgedSubscriptionT = typename TableT::BridgedSubscriptionT;
+
+    // Converted on demand, at most once, and shared by all the ROS message subscriptions.
+    std::shared_ptr<ROSMessageType> ros_msg;
+
+    for (const auto & entry : subscriptions) {
+      add_to_pipeline(entry);
+      if (entry.subscription != nullptr) {
+        entry.subscription->provide_intra_process_data(message);
+        continue;
       }
 
+      // The shared messages don't depend on the allocator type of the subscription.
+      BridgedSubscriptionT * ros_message_subscription = entry.bridged_subscription.get();
+      if (entry.ros_message_subscription != nullptr) {
+        ros_message_subscription = entry.ros_message_subscription.get();
+      }
       if constexpr (rclcpp::TypeAdapter<MessageT>::is_specialized::value) {
-        ROSMessageType ros_msg;
-        rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(*message, ros_msg);
-        ros_message_subscription->provide_intra_process_message(
-          std::make_shared<ROSMessageType>(ros_msg));
+        if (!ros_msg) {
+          ros_msg = std::make_shared<ROSMessageType>();
+          rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(*message, *ros_msg);
+        }
+        ros_message_subscription->provide_intra_process_message(ros_msg);
       } else {
         if constexpr (std::is_same<MessageT, ROSMessageType>::value) {
           ros_message_subscription->provide_intra_process_message(message);
@@ -401,11 +675,12 @@ private:
           if constexpr (std::is_same<typename rclcpp::TypeAdapter<MessageT,
             ROSMessageType>::ros_message_type, ROSMessageType>::value)
           {
-            ROSMessageType ros_msg;
-            rclcpp::TypeAdapter<MessageT, ROSMessageType>::convert_to_ros_message(
-              *message, ros_msg);
-            ros_message_subscription->provide_intra_process_message(
-              std::make_shared<ROSMessageType>(ros_msg));
+            if (!ros_msg) {
+              ros_msg = std::make_shared<ROSMessageType>();
+              rclcpp::TypeAdapter<MessageT, ROSMessageType>::convert_to_ros_message(
+                *message, *ros_msg);
+            }
+            ros_message_subscription->provide_intra_process_message(ros_msg);
           }
         }
       }
@@ -420,38 +695,22 @@ private:
   void
   add_owned_msg_to_buffers(
     std::unique_ptr<MessageT, Deleter> message,
-    std::vector<uint64_t> subscription_ids,
+    const std::vector<typename DispatchTable<MessageT, Alloc, Deleter, ROSMessageType>::Entry> &
+    subscriptions,
     typename allocator::AllocRebind<MessageT, Alloc>::allocator_type & allocator)
   {
     using MessageAllocTraits = allocator::AllocRebind<MessageT, Alloc>;
     using MessageUniquePtr = std::unique_ptr<MessageT, Deleter>;
 
-    using ROSMessageTypeAllocatorTraits = allocator::AllocRebind<ROSMessageType, Alloc>;
-    using ROSMessageTypeAllocator = typename ROSMessageTypeAllocatorTraits::allocator_type;
-    using ROSMessageTypeDeleter = allocator::Deleter<ROSMessageTypeAllocator, ROSMessageType>;
-
-    using PublishedType = typename rclcpp::TypeAdapter<MessageT>::custom_type;
-    using PublishedTypeAllocatorTraits = allocator::AllocRebind<PublishedType, Alloc>;
-    using PublishedTypeAllocator = typename PublishedTypeAllocatorTraits::allocator_type;
-    using PublishedTypeDeleter = allocator::Deleter<PublishedTypeAllocator, PublishedType>;
-
-    for (auto it = subscription_ids.begin(); it != subscription_ids.end(); it++) {
-      auto subscription_it = subscriptions_.find(*it);
-      if (subscription_it == subscriptions_.end()) {
-        throw std::runtime_error("subscription has unexpectedly gone out of scope");
-      }
-      auto subscription_base = subscription_it->second.lock();
-      if (subscription_base == nullptr) {
-        subscriptions_.erase(subscription_it);
-        continue;
-      }
+    using TableT = DispatchTable<MessageT, Alloc, Deleter, ROSMessageType>;
+    using ROSMessageTypeAllocator = typename TableT::ROSMessageTypeAllocator;
+    using ROSMessageTypeDeleter = typename TableT::ROSMessageTypeDeleter;
 
-      auto subscription = std::dynamic_pointer_cast<
-        rclcpp::experimental::SubscriptionIntraProcessBuffer<PublishedType,
-        PublishedTypeAllocator, PublishedTypeDeleter, ROSMessageType>
-        >(subscription_base);
+    for (auto it = subscriptions.begin(); it != subscriptions.end(); it++) {
+      add_to_pipeline(*it);
+      const auto & subscription = it->subscription;
       if (subscription != nullptr) {
-        if (std::next(it) == subscription_ids.end()) {
+        if (std::next(it) == subscriptions.end()) {
           // If this is the last subscription, give up ownership
           subscription->provide_intra_process_data(std::move(message));
         } else {
@@ -466,19 +725,22 @@ private:
         continue;
       }
 
-      auto ros_message_subscription = std::dynamic_pointer_cast<
-        rclcpp::experimental::SubscriptionROSMsgIntraProcessBuffer<ROSMessageType,
-        ROSMessageTypeAllocator, ROSMessageTypeDeleter>
-        >(subscription_base);
-      if (nullptr == ros_message_subscription) {
-        throw std::runtime_error(
-                "failed to dynamic cast SubscriptionIntraProcessBase to "
-                "SubscriptionIntraProcessBuffer<MessageT, Alloc, Deleter>, or to "
-                "SubscriptionROSMsgIntraProcessBuffer<ROSMessageType,ROSMessageTypeAllocator,"
-                "ROSMessageTypeDeleter> which can happen when the publisher and "
-                "subscription use different allocator types, which is not supported");
+      const auto & bridged_subscription = it->bridged_subscription;
+      if (bridged_subscription != nullptr) {
+        // The message is copied with the allocator of the subscription, whose type differs.
+        if constexpr (rclcpp::TypeAdapter<MessageT>::is_specialized::value) {
+          ROSMessageType ros_msg;
+          rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(*message, ros_msg);
+          bridged_subscription->provide_intra_process_message_copy(ros_msg);
+        } else {
+          if constexpr (std::is_same<MessageT, ROSMessageType>::value) {
+            bridged_subscription->provide_intra_process_message_copy(*message);
+          }
+        }
+        continue;
       }
 
+      const auto & ros_message_subscription = it->ros_message_subscription;
       if constexpr (rclcpp::TypeAdapter<MessageT>::is_specialized::value) {
         ROSMessageTypeAllocator ros_message_alloc(allocator);
         auto ptr = ros_message_alloc.allocate(1);
@@ -490,7 +752,7 @@ private:
         ros_message_subscription->provide_intra_process_message(std::move(ros_msg));
       } else {
         if constexpr (std::is_same<MessageT, ROSMessageType>::value) {
-          if (std::next(it) == subscription_ids.end()) {
+          if (std::next(it) == subscriptions.end()) {
             // If this is the last subscription, give up ownership
             ros_message_subscription->provide_intra_process_message(std::move(message));
           } else {
@@ -511,10 +773,24 @@ private:
   PublisherToSubscriptionIdsMap pub_to_subs_;
   SubscriptionMap subscriptions_;
   PublisherMap publishers_;
+  /// Ids of the publishers of serialized messages.
+  std::unordered_set<uint64_t> serialized_publishers_;
 
   mutable std::shared_timed_mutex mutex_;
 };
 
+/// Return the intra process manager used by the publishers and subscriptions of a context.
+/**
+ * It's the instance of the context, or the instance shared with the other contexts of the
+ * same domain if rclcpp::InitOptions::share_intra_process_manager() is set.
+ *
+ * \param[in] context the context, which must be initialized to share the instance.
+ * \throws anything rclcpp::Context::get_domain_id() can throw.
+ */
+RCLCPP_PUBLIC
+IntraProcessManager::SharedPtr
+get_intra_process_manager(rclcpp::Context & context);
+
 }  // namespace experimental
 }  // namespace rclcpp
 
@@ -0,0 +1,198 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXPERIMENTAL__INTRA_PROCESS_SERVICES_HPP_
+#define RCLCPP__EXPERIMENTAL__INTRA_PROCESS_SERVICES_HPP_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "rcl/wait.h"
+#include "rmw/types.h"
+
+#include "rclcpp/context.hpp"
+#include "rclcpp/guard_condition.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+#include "rclcpp/waitable.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+
+/// Queue of the requests of an intra-process service, or of the responses of a client.
+/**
+ * The requests and responses are handed over as shared pointers, so they are never copied
+ * nor serialized.
+ * Pushing to the queue triggers its guard condition, and the executor of the
+ * service or client calls the handler of the queue with each of them.
+ */
+class IntraProcessServiceQueue : public rclcpp::Waitable
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(IntraProcessServiceQueue)
+
+  enum class EntityType : std::size_t
+  {
+    Queue,
+  };
+
+  using Handler = std::function<void (std::shared_ptr<rmw_request_id_t>, std::shared_ptr<void>)>;
+
+  RCLCPP_PUBLIC
+  IntraProcessServiceQueue(rclcpp::Context::SharedPtr context, Handler handler);
+
+  RCLCPP_PUBLIC
+  ~IntraProcessServiceQueue() override = default;
+
+  /// Queue a request or a response, and wake up the executor.
+  RCLCPP_PUBLIC
+  void
+  push(const rmw_request_id_t & request_id, std::shared_ptr<void> data);
+
+  RCLCPP_PUBLIC
+  size_t
+  get_number_of_ready_guard_conditions() override {return 1;}
+
+  RCLCPP_PUBLIC
+  void
+  add_to_wait_set(rcl_wait_set_t * wait_set) override;
+
+  RCLCPP_PUBLIC
+  bool
+  is_ready(rcl_wait_set_t * wait_set) override;
+
+  RCLCPP_PUBLIC
+  std::shared_ptr<void>
+  take_data() override;
+
+  RCLCPP_PUBLIC
+  std::shared_ptr<void>
+  take_data_by_entity_id(size_t id) override;
+
+  RCLCPP_PUBLIC
+  void
+  execute(std::shared_ptr<void> & data) override;
+
+  /// Set a callback to be called for each request or response pushed to the queue.
+  /**
+   * \sa rclcpp::experimental::SubscriptionIntraProcessBase::set_on_ready_callback
+   */
+  RCLCPP_PUBLIC
+  void
+  set_on_ready_callback(std::function<void(size_t, int)> callback) override;
+
+  RCLCPP_PUBLIC
+  void
+  clear_on_ready_callback() override;
+
+private:
+  struct Item
+  {
+    std::shared_ptr<rmw_request_id_t> request_id;
+    std::shared_ptr<void> data;
+  };
+
+  Handler handler_;
+  rclcpp::GuardCondition gc_;
+
+  std::mutex queue_mutex_;
+  std::deque<Item> queue_;
+
+  std::recursive_mutex callback_mutex_;
+  std::function<void(size_t)> on_ready_callback_{nullptr};
+  size_t unread_count_{0};
+};
+
+/// Intra-process services and clients of a context.
+/**
+ * Obtained with rclcpp::Context::get_sub_context().
+ * The services are found by their name and type support, the clients by the id
+ * written in the header of their intra-process requests.
+ */
+class IntraProcessServices
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(IntraProcessServices)
+
+  RCLCPP_PUBLIC
+  IntraProcessServices() = default;
+
+  /// Register the request queue of a service, returning its id.
+  RCLCPP_PUBLIC
+  uint64_t
+  add_service(
+    const std::string & service_name,
+    const void * type_support,
+    IntraProcessServiceQueue::WeakPtr queue);
+
+  RCLCPP_PUBLIC
+  void
+  remove_service(uint64_t service_id);
+
+  /// Return the request queue of a service with this name and type, or nullptr if none.
+  RCLCPP_PUBLIC
+  IntraProcessServiceQueue::SharedPtr
+  get_service(const std::string & service_name, const void * type_support) const;
+
+  /// Register the response queue of a client, returning its id.
+  RCLCPP_PUBLIC
+  uint64_t
+  add_client(IntraProcessServiceQueue::WeakPtr queue);
+
+  RCLCPP_PUBLIC
+  void
+  remove_client(uint64_t client_id);
+
+  /// Return the response queue of a client, or nullptr if it was removed.
+  RCLCPP_PUBLIC
+  IntraProcessServiceQueue::SharedPtr
+  get_client(uint64_t client_id) const;
+
+  /// Return a request header identifying an intra-process request of a client.
+  RCLCPP_PUBLIC
+  static
+  rmw_request_id_t
+  make_request_id(uint64_t client_id, int64_t sequence_number);
+
+  /// Return true if the header is the one of an intra-process request, and get its client.
+  RCLCPP_PUBLIC
+  static
+  bool
+  get_client_id(const rmw_request_id_t & request_id, uint64_t & client_id);
+
+private:
+  struct ServiceInfo
+  {
+    uint64_t id;
+    const void * type_support;
+    IntraProcessServiceQueue::WeakPtr queue;
+  };
+
+  mutable std::mutex mutex_;
+  uint64_t next_id_{1};
+  std::unordered_multimap<std::string, ServiceInfo> services_;
+  std::unordered_map<uint64_t, IntraProcessServiceQueue::WeakPtr> clients_;
+};
+
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXPERIMENTAL__INTRA_PROCESS_SERVICES_HPP_
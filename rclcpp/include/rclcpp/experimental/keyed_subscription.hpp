@@ -0,0 +1,332 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__EXPERIMENTAL__KEYED_SUBSCRIPTION_HPP_
+#define RCLCPP__EXPERIMENTAL__KEYED_SUBSCRIPTION_HPP_
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "rcl/wait.h"
+#include "rcpputils/scope_exit.hpp"
+
+#include "rclcpp/callback_group.hpp"
+#include "rclcpp/context.hpp"
+#include "rclcpp/create_subscription.hpp"
+#include "rclcpp/detail/add_guard_condition_to_rcl_wait_set.hpp"
+#include "rclcpp/guard_condition.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/node_interfaces/get_node_base_interface.hpp"
+#include "rclcpp/node_interfaces/get_node_waitables_interface.hpp"
+#include "rclcpp/qos.hpp"
+#include "rclcpp/subscription.hpp"
+#include "rclcpp/subscription_options.hpp"
+#include "rclcpp/waitable.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+
+/// Subscription whose messages are executed in parallel, in order for each key.
+/**
+ * The messages are given to the callback in the order they were received for each key
+ * returned by the key extractor, one at a time, while the messages of different keys
+ * may be executed at the same time by the threads of a multi-threaded executor.
+ *
+ * The subscription only queues the messages: it stays in its callback group, which must be
+ * mutually exclusive for their order to be kept, the default group of the node by default.
+ * They are then executed by this waitable, in a reentrant callback group of its own which
+ * is added to the executors of the node.
+ * The messages of a key are kept until the ones before have been executed, so a key with a
+ * slow callback accumulates them.
+ *
+ * Use create_keyed_subscription() to create it.
+ */
+template<typename MessageT, typename KeyT, typename HashT = std::hash<KeyT>>
+class KeyedSubscription : public rclcpp::Waitable
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(KeyedSubscription)
+
+  using ConstMessageSharedPtr = std::shared_ptr<const MessageT>;
+  using KeyExtractor = std::function<KeyT(const MessageT &)>;
+  using Callback = std::function<void (ConstMessageSharedPtr)>;
+  using SubscriptionT = rclcpp::Subscription<MessageT>;
+
+  /// Constructor, which doesn't create the subscription.
+  /**
+   * \param[in] context context of the subscription.
+   * \param[in] key_extractor function returning the key of a message.
+   * \param[in] callback function executing the messages.
+   * \throws std::invalid_argument if the key extractor or the callback is empty.
+   */
+  KeyedSubscription(
+    rclcpp::Context::SharedPtr context,
+    KeyExtractor key_extractor,
+    Callback callback)
+  : gc_(std::move(context)),
+    key_extractor_(std::move(key_extractor)),
+    callback_(std::move(callback))
+  {
+    if (!key_extractor_) {
+      throw std::invalid_argument("the key extractor of a keyed subscription is empty");
+    }
+    if (!callback_) {
+      throw std::invalid_argument("the callback of a keyed subscription is empty");
+    }
+  }
+
+  ~KeyedSubscription() override = default;
+
+  /// Create a keyed subscription, its subscription and its callback group.
+  /**
+   * \sa rclcpp::experimental::create_keyed_subscription()
+   */
+  template<typename NodeT>
+  static
+  SharedPtr
+  create(
+    NodeT && node,
+    const std::string & topic_name,
+    const rclcpp::QoS & qos,
+    KeyExtractor key_extractor,
+    Callback callback,
+    const rclcpp::SubscriptionOptions & options)
+  {
+    if (options.callback_group &&
+      options.callback_group->type() != rclcpp::CallbackGroupType::MutuallyExclusive)
+    {
+      throw std::invalid_argument(
+              "the callback group of a keyed subscription must be mutually exclusive");
+    }
+    auto node_base = rclcpp::node_interfaces::get_node_base_interface(node);
+    auto keyed_subscription = std::make_shared<KeyedSubscription>(
+      node_base->get_context(), std::move(key_extractor), std::move(callback));
+
+    std::weak_ptr<KeyedSubscription> weak_keyed_subscription(keyed_subscription);
+    keyed_subscription->subscription_ = rclcpp::create_subscription<MessageT>(
+      node, topic_name, qos,
+      [weak_keyed_subscription](ConstMessageSharedPtr message) {
+        auto keyed_subscription = weak_keyed_subscription.lock();
+        if (keyed_subscription) {
+          keyed_subscription->enqueue(std::move(message));
+        }
+      },
+      options);
+
+    keyed_subscription->callback_group_ =
+      node_base->create_callback_group(rclcpp::CallbackGroupType::Reentrant);
+    rclcpp::node_interfaces::get_node_waitables_interface(node)->add_waitable(
+      keyed_subscription, keyed_subscription->callback_group_);
+    return keyed_subscription;
+  }
+
+  /// Return the subscription queueing the messages.
+  typename SubscriptionT::SharedPtr
+  get_subscription() const
+  {
+    return subscription_;
+  }
+
+  /// Return the callback group the messages are executed in.
+  rclcpp::CallbackGroup::SharedPtr
+  get_callback_group() const
+  {
+    return callback_group_;
+  }
+
+  /// Return the number of messages received and not executed yet.
+  size_t
+  get_number_of_pending_messages() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return number_of_pending_messages_;
+  }
+
+  /// Queue a message after the other ones of its key, as the subscription does.
+  void
+  enqueue(ConstMessageSharedPtr message)
+  {
+    KeyT key = key_extractor_(*message);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto & queue = queues_[key];
+      queue.messages.push_back(std::move(message));
+      ++number_of_pending_messages_;
+      if (queue.executing || queue.messages.size() > 1u) {
+        // Its key is already ready, or executing and set ready again after.
+        return;
+      }
+      ready_keys_.push_back(std::move(key));
+    }
+    gc_.trigger();
+  }
+
+  // -------------
+  // Waitables API
+
+  /// \internal
+  size_t
+  get_number_of_ready_guard_conditions() override
+  {
+    return 1u;
+  }
+
+  /// \internal
+  void
+  add_to_wait_set(rcl_wait_set_t * wait_set) override
+  {
+    rclcpp::detail::add_guard_condition_to_rcl_wait_set(*wait_set, gc_);
+  }
+
+  /// Return true if a key has a message to execute.
+  /// \internal
+  bool
+  is_ready(rcl_wait_set_t * wait_set) override
+  {
+    (void)wait_set;
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !ready_keys_.empty();
+  }
+
+  /// Take the oldest message of the key ready first, which is executing until it's executed.
+  /// \internal
+  std::shared_ptr<void>
+  take_data() override
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ready_keys_.empty()) {
+      return nullptr;
+    }
+    auto data = std::make_shared<TakenData>();
+    data->key = std::move(ready_keys_.front());
+    ready_keys_.pop_front();
+    auto & queue = queues_.at(data->key);
+    queue.executing = true;
+    data->message = std::move(queue.messages.front());
+    queue.messages.pop_front();
+    if (!ready_keys_.empty()) {
+      // The other ready keys are taken by the next wait, from other threads.
+      gc_.trigger();
+    }
+    return data;
+  }
+
+  /// Execute a message taken by take_data(), and then set its key ready again if needed.
+  /// \internal
+  void
+  execute(std::shared_ptr<void> & data) override
+  {
+    if (!data) {
+      return;
+    }
+    auto taken_data = std::static_pointer_cast<TakenData>(data);
+    RCPPUTILS_SCOPE_EXIT(finish(taken_data->key); );
+    callback_(std::move(taken_data->message));
+  }
+
+  // End Waitables API
+  // -----------------
+
+private:
+  RCLCPP_DISABLE_COPY(KeyedSubscription)
+
+  struct KeyQueue
+  {
+    std::deque<ConstMessageSharedPtr> messages;
+    bool executing = false;
+  };
+
+  struct TakenData
+  {
+    KeyT key;
+    ConstMessageSharedPtr message;
+  };
+
+  void
+  finish(const KeyT & key)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --number_of_pending_messages_;
+      auto it = queues_.find(key);
+      it->second.executing = false;
+      if (it->second.messages.empty()) {
+        queues_.erase(it);
+        return;
+      }
+      ready_keys_.push_back(key);
+    }
+    gc_.trigger();
+  }
+
+  rclcpp::GuardCondition gc_;
+  const KeyExtractor key_extractor_;
+  const Callback callback_;
+  typename SubscriptionT::SharedPtr subscription_;
+  rclcpp::CallbackGroup::SharedPtr callback_group_;
+
+  mutable std::mutex mutex_;
+  // Only the keys with messages, which are removed once they are all executed
+  std::unordered_map<KeyT, KeyQueue, HashT> queues_;
+  // Keys with messages and not executing, in the order they became ready
+  std::deque<KeyT> ready_keys_;
+  size_t number_of_pending_messages_ = 0u;
+};
+
+/// Create a subscription whose messages are executed in parallel, in order for each key.
+/**
+ * \param[in] node node of the subscription.
+ * \param[in] topic_name topic of the subscription.
+ * \param[in] qos quality of service of the subscription.
+ * \param[in] key_extractor function returning the key of a message, called by the thread
+ *   receiving it.
+ * \param[in] callback function executing the messages.
+ * \param[in] options options of the subscription, whose callback group must be mutually
+ *   exclusive.
+ * \throws std::invalid_argument if the key extractor or the callback is empty, or if the
+ *   callback group of the options is reentrant.
+ * \sa rclcpp::experimental::KeyedSubscription
+ */
+template<
+  typename MessageT,
+  typename KeyT,
+  typename HashT = std::hash<KeyT>,
+  typename NodeT>
+typename KeyedSubscription<MessageT, KeyT, HashT>::SharedPtr
+create_keyed_subscription(
+  NodeT && node,
+  const std::string & topic_name,
+  const rclcpp::QoS & qos,
+  typename KeyedSubscription<MessageT, KeyT, HashT>::KeyExtractor key_extractor,
+  typename KeyedSubscription<MessageT, KeyT, HashT>::Callback callback,
+  const rclcpp::SubscriptionOptions & options = rclcpp::SubscriptionOptions())
+{
+  return KeyedSubscription<MessageT, KeyT, HashT>::create(
+    std::forward<NodeT>(node), topic_name, qos, std::move(key_extractor), std::move(callback),
+    options);
+}
+
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXPERIMENTAL__KEYED_SUBSCRIPTION_HPP_
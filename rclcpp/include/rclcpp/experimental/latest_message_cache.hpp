@@ -0,0 +1,208 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__EXPERIMENTAL__LATEST_MESSAGE_CACHE_HPP_
+#define RCLCPP__EXPERIMENTAL__LATEST_MESSAGE_CACHE_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "rclcpp/callback_group.hpp"
+#include "rclcpp/create_subscription.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/qos.hpp"
+#include "rclcpp/subscription.hpp"
+#include "rclcpp/subscription_options.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+
+/// Latest message received on a topic, which a thread without executor polls without locks.
+/**
+ * The messages are received by a subscription executed as usual by an executor, with
+ * intra-process communication or not, and copied into a triple buffer: the executor writes
+ * into a slot of its own, which is then exchanged with the middle one, and get_latest()
+ * exchanges the middle slot with its own one if a message was written since it was called.
+ * So neither thread waits for the other, and polling makes no system call.
+ * The slots are assigned to, so once their messages have grown to the size of the received
+ * ones, copying them doesn't allocate memory.
+ *
+ * The cache has one writer and one reader: the callback group of the subscription must be
+ * mutually exclusive, the default group of the node by default, and get_latest() must be
+ * called by only one thread, the real-time one.
+ *
+ * Use create_latest_message_cache() to create it.
+ */
+template<typename MessageT>
+class LatestMessageCache
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(LatestMessageCache)
+
+  using SubscriptionT = rclcpp::Subscription<MessageT>;
+
+  /// Latest message returned by get_latest().
+  struct Latest
+  {
+    /// Latest message, or nullptr if none was received.
+    /**
+     * It's valid until the next call to get_latest().
+     */
+    const MessageT * message = nullptr;
+    /// Number of messages received until this one, 0 if none was received.
+    uint64_t sequence = 0;
+  };
+
+  static_assert(
+    std::atomic<uint8_t>::is_always_lock_free,
+    "the slots of the latest message cache must be exchanged without locks");
+
+  /// Constructor, which doesn't create the subscription.
+  LatestMessageCache() = default;
+
+  ~LatestMessageCache() = default;
+
+  /// Create a latest message cache and its subscription.
+  /**
+   * \sa rclcpp::experimental::create_latest_message_cache()
+   */
+  template<typename NodeT>
+  static
+  SharedPtr
+  create(
+    NodeT && node,
+    const std::string & topic_name,
+    const rclcpp::QoS & qos,
+    const rclcpp::SubscriptionOptions & options)
+  {
+    if (options.callback_group &&
+      options.callback_group->type() != rclcpp::CallbackGroupType::MutuallyExclusive)
+    {
+      throw std::invalid_argument(
+              "the callback group of a latest message cache must be mutually exclusive");
+    }
+    auto cache = std::make_shared<LatestMessageCache>();
+    std::weak_ptr<LatestMessageCache> weak_cache(cache);
+    cache->subscription_ = rclcpp::create_subscription<MessageT>(
+      std::forward<NodeT>(node), topic_name, qos,
+      [weak_cache](const MessageT & message) {
+        auto cache = weak_cache.lock();
+        if (cache) {
+          cache->store(message);
+        }
+      },
+      options);
+    return cache;
+  }
+
+  /// Return the subscription storing the messages, or nullptr if it wasn't created.
+  typename SubscriptionT::SharedPtr
+  get_subscription() const
+  {
+    return subscription_;
+  }
+
+  /// Store a message as the latest one.
+  /**
+   * It's called by the subscription, and mustn't be called by several threads at once.
+   * It doesn't wait for the reader.
+   */
+  void
+  store(const MessageT & message)
+  {
+    Slot & slot = slots_[back_];
+    slot.message = message;
+    slot.sequence = ++sequence_;
+    back_ = middle_.exchange(
+      static_cast<uint8_t>(back_ | kFresh), std::memory_order_acq_rel) & kIndexMask;
+  }
+
+  /// Return the latest message and its sequence number.
+  /**
+   * It's wait-free, it mustn't be called by several threads at once, and the message it
+   * returns is valid until it's called again.
+   * The sequence number only changes when a new message was received.
+   */
+  Latest
+  get_latest()
+  {
+    if (middle_.load(std::memory_order_relaxed) & kFresh) {
+      front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+    }
+    const Slot & slot = slots_[front_];
+    if (slot.sequence == 0) {
+      return Latest();
+    }
+    return Latest{&slot.message, slot.sequence};
+  }
+
+private:
+  RCLCPP_DISABLE_COPY(LatestMessageCache)
+
+  struct Slot
+  {
+    MessageT message;
+    uint64_t sequence = 0;
+  };
+
+  static constexpr uint8_t kIndexMask = 0x3;
+  // Set in the middle index when its slot was written and not read yet
+  static constexpr uint8_t kFresh = 0x4;
+  static constexpr uint8_t kMiddleIndex = 2;
+
+  std::array<Slot, 3> slots_;
+  // Only used by the writer
+  uint8_t back_ = 0;
+  uint64_t sequence_ = 0;
+  // Only used by the reader
+  uint8_t front_ = 1;
+  std::atomic<uint8_t> middle_{kMiddleIndex};
+
+  typename SubscriptionT::SharedPtr subscription_;
+};
+
+/// Create a subscription whose latest message is polled without locks.
+/**
+ * \param[in] node node of the subscription.
+ * \param[in] topic_name name of the topic.
+ * \param[in] qos quality of service of the subscription.
+ * \param[in] options options of the subscription, whose callback group must be mutually
+ *   exclusive.
+ * \throws std::invalid_argument if the callback group of the options is reentrant.
+ * \sa rclcpp::experimental::LatestMessageCache
+ */
+template<typename MessageT, typename NodeT>
+typename LatestMessageCache<MessageT>::SharedPtr
+create_latest_message_cache(
+  NodeT && node,
+  const std::string & topic_name,
+  const rclcpp::QoS & qos,
+  const rclcpp::SubscriptionOptions & options = rclcpp::SubscriptionOptions())
+{
+  return LatestMessageCache<MessageT>::create(
+    std::forward<NodeT>(node), topic_name, qos, options);
+}
+
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXPERIMENTAL__LATEST_MESSAGE_CACHE_HPP_
@@ -30,12 +30,43 @@ namespace rclcpp
 namespace experimental
 {
 
+/// Intra-process subscription of ROS messages, whatever the type of its allocator.
+/**
+ * The intra-process manager gives the messages of the publishers using another allocator
+ * type through it: the subscriptions not requesting ownership share them as they are, and
+ * the other ones copy them with their own allocator.
+ */
+template<typename RosMessageT>
+class SubscriptionROSMsgIntraProcessBufferBase : public SubscriptionIntraProcessBase
+{
+public:
+  using ConstMessageSharedPtr = std::shared_ptr<const RosMessageT>;
+
+  SubscriptionROSMsgIntraProcessBufferBase(
+    rclcpp::Context::SharedPtr context,
+    const std::string & topic_name,
+    const rclcpp::QoS & qos_profile)
+  : SubscriptionIntraProcessBase(context, topic_name, qos_profile)
+  {}
+
+  virtual ~SubscriptionROSMsgIntraProcessBufferBase()
+  {}
+
+  virtual void
+  provide_intra_process_message(ConstMessageSharedPtr message) = 0;
+
+  /// Give a copy of a message, allocated with the allocator of the subscription.
+  virtual void
+  provide_intra_process_message_copy(const RosMessageT & message) = 0;
+};
+
 template<
   typename RosMessageT,
   typename Alloc = std::allocator<void>,
   typename Deleter = std::default_delete<void>
 >
-class SubscriptionROSMsgIntraProcessBuffer : public SubscriptionIntraProcessBase
+class SubscriptionROSMsgIntraProcessBuffer
+  : public SubscriptionROSMsgIntraProcessBufferBase<RosMessageT>
 {
 public:
   using ROSMessageTypeAllocatorTraits = allocator::AllocRebind<RosMessageT, Alloc>;
@@ -49,14 +80,13 @@ public:
     rclcpp::Context::SharedPtr context,
     const std::string & topic_name,
     const rclcpp::QoS & qos_profile)
-  : SubscriptionIntraProcessBase(context, topic_name, qos_profile)
+  : SubscriptionROSMsgIntraProcessBufferBase<RosMessageT>(context, topic_name, qos_profile)
   {}
 
   virtual ~SubscriptionROSMsgIntraProcessBuffer()
   {}
 
-  virtual void
-  provide_intra_process_message(ConstMessageSharedPtr message) = 0;
+  using SubscriptionROSMsgIntraProcessBufferBase<RosMessageT>::provide_intra_process_message;
 
   virtual void
   provide_intra_process_message(MessageUniquePtr message) = 0;
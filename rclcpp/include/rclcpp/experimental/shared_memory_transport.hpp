@@ -0,0 +1,381 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__EXPERIMENTAL__SHARED_MEMORY_TRANSPORT_HPP_
+#define RCLCPP__EXPERIMENTAL__SHARED_MEMORY_TRANSPORT_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "rclcpp/callback_group.hpp"
+#include "rclcpp/context.hpp"
+#include "rclcpp/detail/shared_memory_topic.hpp"
+#include "rclcpp/file_descriptor_waitable.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/node_interfaces/get_node_topics_interface.hpp"
+#include "rclcpp/serialization.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/visibility_control.hpp"
+#include "rclcpp/waitable.hpp"
+
+#include "rosidl_runtime_cpp/traits.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+
+/// Options of the shared memory segment of a topic.
+/**
+ * They are set by the first publisher or subscription of the topic on the host, and the
+ * other ones must use the same.
+ */
+struct SharedMemoryTransportOptions
+{
+  /// Maximum number of subscriptions of the topic, in all the processes of the host.
+  size_t max_subscriptions = 8;
+  /// Number of messages kept for each subscription, the oldest ones are dropped when full.
+  size_t depth = 10;
+  /// Maximum size of the serialized messages, the plain-old-data messages use their size.
+  size_t max_message_size = 64 * 1024;
+};
+
+namespace detail
+{
+
+/// Messages which are copied as is instead of being serialized.
+template<typename MessageT>
+using is_plain_old_data = std::is_trivially_copyable<MessageT>;
+
+/// Return the type name of the messages of a shared memory topic, with their encoding.
+template<typename MessageT>
+std::string
+get_shared_memory_type_name()
+{
+  return std::string(is_plain_old_data<MessageT>::value ? "pod:" : "cdr:") +
+         rosidl_generator_traits::name<MessageT>();
+}
+
+template<typename MessageT>
+size_t
+get_shared_memory_message_size(const SharedMemoryTransportOptions & options)
+{
+  return is_plain_old_data<MessageT>::value ? sizeof(MessageT) : options.max_message_size;
+}
+
+}  // namespace detail
+
+/// Publisher writing its messages into the shared memory segment of a topic.
+/**
+ * The messages are written directly into the ring of each subscription of the topic on the
+ * host, in any process, without going through the middleware.
+ * The messages which are trivially copyable, i.e. which only have fields of fixed size, are
+ * copied as is, and the other ones are serialized.
+ *
+ * It doesn't communicate with the publishers and subscriptions of the middleware.
+ * Publishing is thread-safe.
+ * \sa rclcpp::experimental::create_shared_memory_publisher()
+ */
+template<typename MessageT>
+class SharedMemoryPublisher
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(SharedMemoryPublisher)
+
+  /// Constructor.
+  /**
+   * \param[in] context context whose domain the topic belongs to.
+   * \param[in] topic_name fully qualified name of the topic.
+   * \param[in] options options of the shared memory segment.
+   * \throws std::runtime_error if the shared memory segment can't be opened, or if it's used
+   *   with another type or other options.
+   */
+  SharedMemoryPublisher(
+    rclcpp::Context::SharedPtr context,
+    const std::string & topic_name,
+    const SharedMemoryTransportOptions & options = SharedMemoryTransportOptions())
+  : topic_name_(topic_name),
+    topic_(
+      std::make_shared<rclcpp::detail::SharedMemoryTopic>(
+        rclcpp::detail::SharedMemoryTopic::get_segment_name(context->get_domain_id(), topic_name),
+        detail::get_shared_memory_type_name<MessageT>(), options.max_subscriptions,
+        options.depth, detail::get_shared_memory_message_size<MessageT>(options)))
+  {
+  }
+
+  /// Publish a message to the subscriptions of the host.
+  /**
+   * \throws std::invalid_argument if the serialized message is bigger than the maximum
+   *   message size.
+   */
+  void
+  publish(const MessageT & msg)
+  {
+    if (detail::is_plain_old_data<MessageT>::value) {
+      topic_->write(&msg, sizeof(MessageT));
+      return;
+    }
+    std::lock_guard<std::mutex> lock(serialization_mutex_);
+    serialization_.serialize_message(&msg, &serialized_msg_);
+    const auto & rcl_serialized_msg = serialized_msg_.get_rcl_serialized_message();
+    topic_->write(rcl_serialized_msg.buffer, rcl_serialized_msg.buffer_length);
+  }
+
+  /// Return the number of subscriptions of the topic, in all the processes of the host.
+  size_t
+  get_subscription_count() const
+  {
+    return topic_->get_subscription_count();
+  }
+
+  /// Return the fully qualified name of the topic.
+  const std::string &
+  get_topic_name() const
+  {
+    return topic_name_;
+  }
+
+private:
+  RCLCPP_DISABLE_COPY(SharedMemoryPublisher)
+
+  const std::string topic_name_;
+  std::shared_ptr<rclcpp::detail::SharedMemoryTopic> topic_;
+  std::mutex serialization_mutex_;
+  rclcpp::Serialization<MessageT> serialization_;
+  rclcpp::SerializedMessage serialized_msg_;
+};
+
+/// Waitable reading the messages of its slot of the shared memory segment of a topic.
+/**
+ * It is woken up by a rclcpp::FileDescriptorWaitable on the notification socket of its slot,
+ * and reads all the messages written since, which it gives to handle_message().
+ *
+ * This is only supported on Linux.
+ */
+class SharedMemorySubscriptionBase : public rclcpp::Waitable
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(SharedMemorySubscriptionBase)
+
+  /// Constructor.
+  /**
+   * \param[in] context context whose domain the topic belongs to.
+   * \param[in] topic_name fully qualified name of the topic.
+   * \param[in] type_name name of the type of the messages, with their encoding.
+   * \param[in] options options of the shared memory segment.
+   * \param[in] max_message_size maximum size of the messages.
+   * \throws std::runtime_error if the shared memory segment can't be opened, if it's used
+   *   with another type or other options, if it has no free slot, or on other platforms.
+   */
+  RCLCPP_PUBLIC
+  SharedMemorySubscriptionBase(
+    rclcpp::Context::SharedPtr context,
+    const std::string & topic_name,
+    const std::string & type_name,
+    const SharedMemoryTransportOptions & options,
+    size_t max_message_size);
+
+  RCLCPP_PUBLIC
+  ~SharedMemorySubscriptionBase() override;
+
+  /// Return the fully qualified name of the topic.
+  RCLCPP_PUBLIC
+  const std::string &
+  get_topic_name() const;
+
+  /// Return the number of messages overwritten before they were read.
+  RCLCPP_PUBLIC
+  uint64_t
+  get_number_of_dropped_messages() const;
+
+  /// \internal
+  RCLCPP_PUBLIC
+  size_t
+  get_number_of_ready_guard_conditions() override;
+
+  /// \internal
+  RCLCPP_PUBLIC
+  void
+  add_to_wait_set(rcl_wait_set_t * wait_set) override;
+
+  /// \internal
+  RCLCPP_PUBLIC
+  bool
+  is_ready(rcl_wait_set_t * wait_set) override;
+
+  /// \internal
+  RCLCPP_PUBLIC
+  std::shared_ptr<void>
+  take_data() override;
+
+  /// \internal
+  RCLCPP_PUBLIC
+  std::shared_ptr<void>
+  take_data_by_entity_id(size_t id) override;
+
+  /// Read the messages written since the last execution, and handle them.
+  /// \internal
+  RCLCPP_PUBLIC
+  void
+  execute(std::shared_ptr<void> & data) override;
+
+protected:
+  /// Handle a message read from the shared memory segment.
+  virtual
+  void
+  handle_message(const rclcpp::SerializedMessage & message) = 0;
+
+private:
+  RCLCPP_DISABLE_COPY(SharedMemorySubscriptionBase)
+
+  void
+  read_messages();
+
+  const std::string topic_name_;
+  std::unique_ptr<rclcpp::detail::SharedMemoryTopicReader> reader_;
+  std::shared_ptr<rclcpp::FileDescriptorWaitable> waitable_;
+  // Held while reading, since the waitable can be executed by several threads at once
+  std::mutex mutex_;
+  rclcpp::SerializedMessage buffer_;
+  std::atomic<uint64_t> number_of_dropped_messages_{0};
+};
+
+/// Subscription receiving the messages of shared memory publishers of the host.
+/**
+ * It's a waitable, which has to be added to a node or a wait set, and its callback is
+ * executed with each message, in the order they were published.
+ * \sa rclcpp::experimental::create_shared_memory_subscription()
+ */
+template<typename MessageT>
+class SharedMemorySubscription : public SharedMemorySubscriptionBase
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(SharedMemorySubscription)
+
+  using CallbackType = std::function<void (std::shared_ptr<MessageT>)>;
+
+  /// Constructor.
+  /**
+   * \param[in] context context whose domain the topic belongs to.
+   * \param[in] topic_name fully qualified name of the topic.
+   * \param[in] callback callback executed with each message.
+   * \param[in] options options of the shared memory segment.
+   * \throws std::invalid_argument if the callback is empty.
+   * \throws std::runtime_error if the shared memory segment can't be opened, if it's used
+   *   with another type or other options, if it has no free slot, or on other platforms.
+   */
+  SharedMemorySubscription(
+    rclcpp::Context::SharedPtr context,
+    const std::string & topic_name,
+    CallbackType callback,
+    const SharedMemoryTransportOptions & options = SharedMemoryTransportOptions())
+  : SharedMemorySubscriptionBase(
+      std::move(context), topic_name, detail::get_shared_memory_type_name<MessageT>(), options,
+      detail::get_shared_memory_message_size<MessageT>(options)),
+    callback_(std::move(callback))
+  {
+    if (!callback_) {
+      throw std::invalid_argument("the callback of a shared memory subscription is empty");
+    }
+  }
+
+protected:
+  void
+  handle_message(const rclcpp::SerializedMessage & message) override
+  {
+    auto msg = std::make_shared<MessageT>();
+    if (detail::is_plain_old_data<MessageT>::value) {
+      if (message.size() != sizeof(MessageT)) {
+        return;
+      }
+      std::memcpy(
+        static_cast<void *>(msg.get()), message.get_rcl_serialized_message().buffer,
+        sizeof(MessageT));
+    } else {
+      serialization_.deserialize_message(&message, msg.get());
+    }
+    callback_(std::move(msg));
+  }
+
+private:
+  CallbackType callback_;
+  rclcpp::Serialization<MessageT> serialization_;
+};
+
+/// Create a publisher writing into the shared memory segment of a topic.
+/**
+ * \param[in] node node whose namespace and context the topic is resolved with.
+ * \param[in] topic_name name of the topic.
+ * \param[in] options options of the shared memory segment.
+ * \throws std::runtime_error if the shared memory segment can't be opened, or if it's used
+ *   with another type or other options.
+ * \sa rclcpp::experimental::SharedMemoryPublisher
+ */
+template<typename MessageT, typename NodeT>
+typename SharedMemoryPublisher<MessageT>::SharedPtr
+create_shared_memory_publisher(
+  NodeT && node,
+  const std::string & topic_name,
+  const SharedMemoryTransportOptions & options = SharedMemoryTransportOptions())
+{
+  auto node_topics = rclcpp::node_interfaces::get_node_topics_interface(node);
+  return std::make_shared<SharedMemoryPublisher<MessageT>>(
+    node_topics->get_node_base_interface()->get_context(),
+    node_topics->resolve_topic_name(topic_name), options);
+}
+
+/// Create a subscription reading the shared memory segment of a topic, added to a node.
+/**
+ * \param[in] node node whose namespace and context the topic is resolved with, and which the
+ *   subscription is added to.
+ * \param[in] topic_name name of the topic.
+ * \param[in] callback callback executed with each message.
+ * \param[in] options options of the shared memory segment.
+ * \param[in] group callback group of the subscription, the default one of the node if null.
+ * \throws std::invalid_argument if the callback is empty.
+ * \throws std::runtime_error if the shared memory segment can't be opened, if it's used
+ *   with another type or other options, if it has no free slot, or on other platforms.
+ * \sa rclcpp::experimental::SharedMemorySubscription
+ */
+template<typename MessageT, typename NodeT>
+typename SharedMemorySubscription<MessageT>::SharedPtr
+create_shared_memory_subscription(
+  NodeT && node,
+  const std::string & topic_name,
+  typename SharedMemorySubscription<MessageT>::CallbackType callback,
+  const SharedMemoryTransportOptions & options = SharedMemoryTransportOptions(),
+  rclcpp::CallbackGroup::SharedPtr group = nullptr)
+{
+  auto node_topics = rclcpp::node_interfaces::get_node_topics_interface(node);
+  auto subscription = std::make_shared<SharedMemorySubscription<MessageT>>(
+    node_topics->get_node_base_interface()->get_context(),
+    node_topics->resolve_topic_name(topic_name), std::move(callback), options);
+  node->get_node_waitables_interface()->add_waitable(subscription, group);
+  return subscription;
+}
+
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXPERIMENTAL__SHARED_MEMORY_TRANSPORT_HPP_
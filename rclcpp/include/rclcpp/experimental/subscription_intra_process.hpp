@@ -27,6 +27,7 @@
 
 #include "rclcpp/any_subscription_callback.hpp"
 #include "rclcpp/context.hpp"
+#include "rclcpp/detail/taken_data_slot.hpp"
 #include "rclcpp/experimental/buffers/intra_process_buffer.hpp"
 #include "rclcpp/experimental/subscription_intra_process_buffer.hpp"
 #include "rclcpp/qos.hpp"
@@ -77,14 +78,19 @@ public:
     rclcpp::Context::SharedPtr context,
     const std::string & topic_name,
     const rclcpp::QoS & qos_profile,
-    rclcpp::IntraProcessBufferType buffer_type)
+    rclcpp::IntraProcessBufferType buffer_type,
+    rclcpp::IntraProcessBufferImplementation buffer_implementation =
+    rclcpp::IntraProcessBufferImplementation::RingBuffer,
+    size_t max_buffer_depth = 0)
   : SubscriptionIntraProcessBuffer<SubscribedType, SubscribedTypeAlloc,
       SubscribedTypeDeleter, ROSMessageType>(
       std::make_shared<SubscribedTypeAlloc>(*allocator),
       context,
       topic_name,
       qos_profile,
-      buffer_type),
+      buffer_type,
+      buffer_implementation,
+      max_buffer_depth),
     any_callback_(callback)
   {
     TRACEPOINT(
@@ -118,11 +124,7 @@ public:
         return nullptr;
       }
     }
-    return std::static_pointer_cast<void>(
-      std::make_shared<std::pair<ConstMessageSharedPtr, MessageUniquePtr>>(
-        std::pair<ConstMessageSharedPtr, MessageUniquePtr>(
-          shared_msg, std::move(unique_msg)))
-    );
+    return taken_data_slot_.make(std::move(shared_msg), std::move(unique_msg));
   }
 
   void execute(std::shared_ptr<void> & data) override
@@ -153,9 +155,10 @@ protected:
 
     auto shared_ptr = std::static_pointer_cast<std::pair<ConstMessageSharedPtr, MessageUniquePtr>>(
       data);
+    this->received_counters_.record(sizeof(SubscribedType));
 
     if (any_callback_.use_take_shared_method()) {
-      ConstMessageSharedPtr shared_msg = shared_ptr->first;
+      ConstMessageSharedPtr shared_msg = std::move(shared_ptr->first);
       any_callback_.dispatch_intra_process(shared_msg, msg_info);
     } else {
       MessageUniquePtr unique_msg = std::move(shared_ptr->second);
@@ -165,6 +168,9 @@ protected:
   }
 
   AnySubscriptionCallback<MessageT, Alloc> any_callback_;
+  // The message taken is given to execute() without allocating
+  rclcpp::detail::TakenDataSlot<std::pair<ConstMessageSharedPtr, MessageUniquePtr>>
+  taken_data_slot_;
 };
 
 }  // namespace experimental
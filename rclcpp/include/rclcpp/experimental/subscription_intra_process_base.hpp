@@ -16,6 +16,7 @@
 #define RCLCPP__EXPERIMENTAL__SUBSCRIPTION_INTRA_PROCESS_BASE_HPP_
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -23,7 +24,10 @@
 #include "rcl/wait.h"
 #include "rmw/impl/cpp/demangle.hpp"
 
+#include "rclcpp/detail/content_filter.hpp"
+#include "rclcpp/experimental/buffers/buffer_implementation_base.hpp"
 #include "rclcpp/guard_condition.hpp"
+#include "rclcpp/intra_process_counters.hpp"
 #include "rclcpp/logging.hpp"
 #include "rclcpp/qos.hpp"
 #include "rclcpp/waitable.hpp"
@@ -65,6 +69,14 @@ public:
   bool
   is_ready(rcl_wait_set_t * wait_set) override = 0;
 
+  /// Return true if the buffer of the subscription has a message.
+  /**
+   * Unlike is_ready(), it doesn't use a wait set, so it can be called by any thread.
+   */
+  virtual
+  bool
+  has_data() const = 0;
+
   std::shared_ptr<void>
   take_data() override = 0;
 
@@ -82,6 +94,35 @@ public:
   bool
   use_take_shared_method() const = 0;
 
+  /// Return true if the subscription receives serialized messages.
+  /**
+   * Serialized subscriptions only communicate with publishers of serialized messages.
+   */
+  virtual
+  bool
+  is_serialized() const
+  {
+    return false;
+  }
+
+  /// Get the occupancy of the buffer of the subscription.
+  /**
+   * The counters are all 0 if the buffer doesn't count them.
+   */
+  virtual
+  buffers::BufferCounters
+  get_buffer_counters() const
+  {
+    return buffers::BufferCounters();
+  }
+
+  /// Return the messages given to the callback of the subscription.
+  rclcpp::IntraProcessCounters
+  get_received_counters() const
+  {
+    return received_counters_.get();
+  }
+
   RCLCPP_PUBLIC
   const char *
   get_topic_name() const;
@@ -90,6 +131,15 @@ public:
   QoS
   get_actual_qos() const;
 
+  /// Set the content filter of the intra-process messages, or remove it with nullptr.
+  /**
+   * The messages not matching it aren't added to the buffer of the subscription.
+   * It's thread-safe.
+   */
+  RCLCPP_PUBLIC
+  void
+  set_content_filter(std::shared_ptr<const rclcpp::detail::ContentFilter> content_filter);
+
   /// Set a callback to be called when each new message arrives.
   /**
    * The callback receives a size_t which is the number of messages received
@@ -176,10 +226,16 @@ protected:
   std::function<void(size_t)> on_new_message_callback_ {nullptr};
   size_t unread_count_{0};
   rclcpp::GuardCondition gc_;
+  rclcpp::detail::AtomicIntraProcessCounters received_counters_;
 
   virtual void
   trigger_guard_condition() = 0;
 
+  /// Return true if a ROS message matches the content filter of the subscription, if any.
+  RCLCPP_PUBLIC
+  bool
+  matches_content_filter(const void * ros_message) const;
+
   void
   invoke_on_new_message()
   {
@@ -194,6 +250,10 @@ protected:
 private:
   std::string topic_name_;
   QoS qos_profile_;
+
+  // Checked first, so that the subscriptions without filter don't load it atomically
+  std::atomic<bool> has_content_filter_{false};
+  std::shared_ptr<const rclcpp::detail::ContentFilter> content_filter_;
 };
 
 }  // namespace experimental
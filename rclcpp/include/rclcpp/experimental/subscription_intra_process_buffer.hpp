@@ -77,7 +77,10 @@ public:
     rclcpp::Context::SharedPtr context,
     const std::string & topic_name,
     const rclcpp::QoS & qos_profile,
-    rclcpp::IntraProcessBufferType buffer_type)
+    rclcpp::IntraProcessBufferType buffer_type,
+    rclcpp::IntraProcessBufferImplementation buffer_implementation =
+    rclcpp::IntraProcessBufferImplementation::RingBuffer,
+    size_t max_buffer_depth = 0)
   : SubscriptionROSMsgIntraProcessBuffer<ROSMessageType, ROSMessageTypeAllocator,
       ROSMessageTypeDeleter>(
       context, topic_name, qos_profile),
@@ -90,7 +93,9 @@ public:
         SubscribedTypeDeleter>(
       buffer_type,
       qos_profile,
-      std::make_shared<Alloc>(subscribed_type_allocator_));
+      std::make_shared<Alloc>(subscribed_type_allocator_),
+      buffer_implementation,
+      max_buffer_depth);
   }
 
   bool
@@ -100,6 +105,18 @@ public:
     return buffer_->has_data();
   }
 
+  bool
+  has_data() const override
+  {
+    return buffer_->has_data();
+  }
+
+  buffers::BufferCounters
+  get_buffer_counters() const override
+  {
+    return buffer_->get_counters();
+  }
+
   SubscribedTypeUniquePtr
   convert_ros_message_to_subscribed_type_unique_ptr(const ROSMessageType & msg)
   {
@@ -118,6 +135,9 @@ public:
   void
   provide_intra_process_message(ConstMessageSharedPtr message) override
   {
+    if (!this->matches_content_filter(message.get())) {
+      return;
+    }
     if constexpr (std::is_same<SubscribedType, ROSMessageType>::value) {
       buffer_->add_shared(std::move(message));
       trigger_guard_condition();
@@ -131,6 +151,9 @@ public:
   void
   provide_intra_process_message(MessageUniquePtr message) override
   {
+    if (!this->matches_content_filter(message.get())) {
+      return;
+    }
     if constexpr (std::is_same<SubscribedType, ROSMessageType>::value) {
       buffer_->add_unique(std::move(message));
       trigger_guard_condition();
@@ -141,9 +164,29 @@ public:
     this->invoke_on_new_message();
   }
 
+  void
+  provide_intra_process_message_copy(const ROSMessageType & message) override
+  {
+    if (!this->matches_content_filter(&message)) {
+      return;
+    }
+    if constexpr (std::is_same<SubscribedType, ROSMessageType>::value) {
+      auto ptr = SubscribedTypeAllocatorTraits::allocate(subscribed_type_allocator_, 1);
+      SubscribedTypeAllocatorTraits::construct(subscribed_type_allocator_, ptr, message);
+      buffer_->add_unique(SubscribedTypeUniquePtr(ptr, subscribed_type_deleter_));
+    } else {
+      buffer_->add_unique(convert_ros_message_to_subscribed_type_unique_ptr(message));
+    }
+    trigger_guard_condition();
+    this->invoke_on_new_message();
+  }
+
   void
   provide_intra_process_data(ConstDataSharedPtr message)
   {
+    if (!matches_content_filter_of_data(*message)) {
+      return;
+    }
     buffer_->add_shared(std::move(message));
     trigger_guard_condition();
     this->invoke_on_new_message();
@@ -152,6 +195,9 @@ public:
   void
   provide_intra_process_data(SubscribedTypeUniquePtr message)
   {
+    if (!matches_content_filter_of_data(*message)) {
+      return;
+    }
     buffer_->add_unique(std::move(message));
     trigger_guard_condition();
     this->invoke_on_new_message();
@@ -170,6 +216,21 @@ protected:
     this->gc_.trigger();
   }
 
+  /// Return true if a message matches the content filter, which is evaluated on ROS messages.
+  /**
+   * The messages of the adapted types aren't converted to be filtered, so they all match.
+   */
+  bool
+  matches_content_filter_of_data(const SubscribedType & message) const
+  {
+    if constexpr (std::is_same<SubscribedType, ROSMessageType>::value) {
+      return this->matches_content_filter(&message);
+    } else {
+      (void)message;
+      return true;
+    }
+  }
+
   BufferUniquePtr buffer_;
   SubscribedTypeAllocator subscribed_type_allocator_;
   SubscribedTypeDeleter subscribed_type_deleter_;
@@ -0,0 +1,116 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXPERIMENTAL__SUBSCRIPTION_SERIALIZED_INTRA_PROCESS_HPP_
+#define RCLCPP__EXPERIMENTAL__SUBSCRIPTION_SERIALIZED_INTRA_PROCESS_HPP_
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "rcl/wait.h"
+
+#include "rclcpp/context.hpp"
+#include "rclcpp/detail/taken_data_slot.hpp"
+#include "rclcpp/experimental/buffers/intra_process_buffer.hpp"
+#include "rclcpp/experimental/subscription_intra_process_base.hpp"
+#include "rclcpp/intra_process_buffer_implementation.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/qos.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+
+/// Intra-process subscription of serialized messages, used by rclcpp::GenericSubscription.
+/**
+ * It only receives the messages of the publishers of serialized messages, the
+ * rclcpp::GenericPublisher, which are shared by all the subscriptions without being copied.
+ */
+class SubscriptionSerializedIntraProcess : public SubscriptionIntraProcessBase
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(SubscriptionSerializedIntraProcess)
+
+  using ConstMessageSharedPtr = std::shared_ptr<const rclcpp::SerializedMessage>;
+  using CallbackT = std::function<void (ConstMessageSharedPtr)>;
+
+  RCLCPP_PUBLIC
+  SubscriptionSerializedIntraProcess(
+    CallbackT callback,
+    rclcpp::Context::SharedPtr context,
+    const std::string & topic_name,
+    const rclcpp::QoS & qos_profile,
+    rclcpp::IntraProcessBufferImplementation buffer_implementation =
+    rclcpp::IntraProcessBufferImplementation::RingBuffer,
+    size_t max_buffer_depth = 0);
+
+  RCLCPP_PUBLIC
+  virtual ~SubscriptionSerializedIntraProcess();
+
+  RCLCPP_PUBLIC
+  bool
+  is_ready(rcl_wait_set_t * wait_set) override;
+
+  RCLCPP_PUBLIC
+  bool
+  has_data() const override;
+
+  RCLCPP_PUBLIC
+  std::shared_ptr<void>
+  take_data() override;
+
+  RCLCPP_PUBLIC
+  void
+  execute(std::shared_ptr<void> & data) override;
+
+  /// The messages are shared with the other subscriptions, so it is always true.
+  RCLCPP_PUBLIC
+  bool
+  use_take_shared_method() const override;
+
+  RCLCPP_PUBLIC
+  bool
+  is_serialized() const override;
+
+  RCLCPP_PUBLIC
+  buffers::BufferCounters
+  get_buffer_counters() const override;
+
+  /// Store a message published intra-process, without copying it.
+  RCLCPP_PUBLIC
+  void
+  provide_intra_process_message(ConstMessageSharedPtr message);
+
+protected:
+  RCLCPP_PUBLIC
+  void
+  trigger_guard_condition() override;
+
+private:
+  RCLCPP_DISABLE_COPY(SubscriptionSerializedIntraProcess)
+
+  CallbackT callback_;
+  buffers::IntraProcessBuffer<rclcpp::SerializedMessage>::UniquePtr buffer_;
+  // The message taken is given to execute() without allocating
+  rclcpp::detail::TakenDataSlot<ConstMessageSharedPtr> taken_data_slot_;
+};
+
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXPERIMENTAL__SUBSCRIPTION_SERIALIZED_INTRA_PROCESS_HPP_
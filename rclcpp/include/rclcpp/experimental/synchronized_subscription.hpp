@@ -0,0 +1,371 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__EXPERIMENTAL__SYNCHRONIZED_SUBSCRIPTION_HPP_
+#define RCLCPP__EXPERIMENTAL__SYNCHRONIZED_SUBSCRIPTION_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "rclcpp/callback_group.hpp"
+#include "rclcpp/create_subscription.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/qos.hpp"
+#include "rclcpp/subscription.hpp"
+#include "rclcpp/subscription_options.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+
+/// Stamp of the messages synchronized by a SynchronizedSubscription, in nanoseconds.
+/**
+ * It's the stamp of their header by default, and it can be specialized for the messages
+ * which have no header.
+ */
+template<typename MessageT>
+struct MessageStamp
+{
+  static int64_t
+  get(const MessageT & message)
+  {
+    return static_cast<int64_t>(message.header.stamp.sec) * 1000000000LL +
+           static_cast<int64_t>(message.header.stamp.nanosec);
+  }
+};
+
+namespace detail
+{
+
+/// Ring buffer of the messages of a topic, in the order of their stamps.
+template<typename MessageT>
+class StampedMessageRing
+{
+public:
+  using ConstMessageSharedPtr = std::shared_ptr<const MessageT>;
+
+  explicit StampedMessageRing(size_t capacity)
+  : entries_(capacity)
+  {}
+
+  bool
+  empty() const
+  {
+    return size_ == 0u;
+  }
+
+  size_t
+  size() const
+  {
+    return size_;
+  }
+
+  int64_t
+  front_stamp() const
+  {
+    return entries_[head_].stamp;
+  }
+
+  /// Return false if the message is older than the last one, and isn't added.
+  bool
+  push_back(int64_t stamp, ConstMessageSharedPtr message, size_t & number_of_dropped_messages)
+  {
+    if (stamp < last_stamp_) {
+      return false;
+    }
+    last_stamp_ = stamp;
+    if (size_ == entries_.size()) {
+      pop_front();
+      ++number_of_dropped_messages;
+    }
+    entries_[(head_ + size_) % entries_.size()] = Entry{stamp, std::move(message)};
+    ++size_;
+    return true;
+  }
+
+  ConstMessageSharedPtr
+  pop_front()
+  {
+    ConstMessageSharedPtr message = std::move(entries_[head_].message);
+    head_ = (head_ + 1u) % entries_.size();
+    --size_;
+    return message;
+  }
+
+private:
+  struct Entry
+  {
+    int64_t stamp = 0;
+    ConstMessageSharedPtr message;
+  };
+
+  std::vector<Entry> entries_;
+  size_t head_ = 0u;
+  size_t size_ = 0u;
+  int64_t last_stamp_ = std::numeric_limits<int64_t>::min();
+};
+
+}  // namespace detail
+
+/// Subscriptions to several topics whose messages are given together to one callback.
+/**
+ * The messages of each topic are kept in a ring buffer, in the order of their stamps
+ * given by rclcpp::experimental::MessageStamp, and the callback is called with one
+ * message of each topic once their stamps are at most the maximum interval apart:
+ * they are matched exactly with an interval of 0, and approximately otherwise.
+ * The matched messages are shared with the subscriptions, including the intra-process
+ * ones, so that they aren't copied.
+ *
+ * When the oldest messages of the topics are too far apart for the oldest one to be
+ * matched, it's dropped, as it couldn't be matched with the later ones.
+ * The messages older than the last one of their topic, and the oldest messages of a full
+ * ring buffer, are dropped as well.
+ *
+ * The callback is called by the subscription receiving the message which completes the
+ * matched messages, so that it's only executed once each time.
+ * The subscriptions are in the callback group of the options, which must be mutually
+ * exclusive for the callbacks to be called in order.
+ *
+ * Use create_synchronized_subscription() to create it.
+ */
+template<typename ... MessageTs>
+class SynchronizedSubscription
+  : public std::enable_shared_from_this<SynchronizedSubscription<MessageTs...>>
+{
+  static_assert(sizeof...(MessageTs) >= 2u, "at least two topics are synchronized");
+
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(SynchronizedSubscription)
+
+  static constexpr size_t number_of_topics = sizeof...(MessageTs);
+
+  using Callback = std::function<void (std::shared_ptr<const MessageTs>...)>;
+  using TopicNames = std::array<std::string, sizeof...(MessageTs)>;
+
+  /// Constructor, which doesn't create the subscriptions.
+  /**
+   * \param[in] queue_size maximum number of messages kept for each topic.
+   * \param[in] max_interval maximum interval between the stamps of matched messages.
+   * \param[in] callback function called with the matched messages.
+   * \throws std::invalid_argument if the queue size is 0, if the maximum interval is
+   *   negative, or if the callback is empty.
+   */
+  SynchronizedSubscription(
+    size_t queue_size,
+    std::chrono::nanoseconds max_interval,
+    Callback callback)
+  : max_interval_(max_interval.count()),
+    callback_(std::move(callback)),
+    queues_(detail::StampedMessageRing<MessageTs>(queue_size)...)
+  {
+    if (queue_size == 0u) {
+      throw std::invalid_argument("the queue size of a synchronized subscription can't be 0");
+    }
+    if (max_interval < std::chrono::nanoseconds::zero()) {
+      throw std::invalid_argument(
+              "the maximum interval of a synchronized subscription can't be negative");
+    }
+    if (!callback_) {
+      throw std::invalid_argument("the callback of a synchronized subscription is empty");
+    }
+  }
+
+  /// Create a synchronized subscription and its subscriptions.
+  /**
+   * \sa rclcpp::experimental::create_synchronized_subscription()
+   */
+  template<typename NodeT>
+  static
+  SharedPtr
+  create(
+    NodeT && node,
+    const TopicNames & topic_names,
+    const rclcpp::QoS & qos,
+    size_t queue_size,
+    std::chrono::nanoseconds max_interval,
+    Callback callback,
+    const rclcpp::SubscriptionOptions & options)
+  {
+    if (options.callback_group &&
+      options.callback_group->type() != rclcpp::CallbackGroupType::MutuallyExclusive)
+    {
+      throw std::invalid_argument(
+              "the callback group of a synchronized subscription must be mutually exclusive");
+    }
+    auto synchronized_subscription =
+      std::make_shared<SynchronizedSubscription>(queue_size, max_interval, std::move(callback));
+    synchronized_subscription->create_subscriptions(
+      node, topic_names, qos, options, std::index_sequence_for<MessageTs...>());
+    return synchronized_subscription;
+  }
+
+  /// Return the subscription to the topic of index I.
+  template<size_t I>
+  auto
+  get_subscription() const
+  {
+    return std::get<I>(subscriptions_);
+  }
+
+  /// Add a message of the topic of index I, and call the callback if it's matched.
+  /**
+   * It's called by the subscriptions, and can be called directly to give messages
+   * received otherwise.
+   */
+  template<size_t I>
+  void
+  add_message(std::shared_ptr<const std::tuple_element_t<I, std::tuple<MessageTs...>>> message)
+  {
+    using MessageT = std::tuple_element_t<I, std::tuple<MessageTs...>>;
+    const int64_t stamp = MessageStamp<MessageT>::get(*message);
+    std::vector<MatchedMessages> matched_messages;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!std::get<I>(queues_).push_back(stamp, std::move(message), number_of_dropped_messages_))
+      {
+        ++number_of_dropped_messages_;
+        return;
+      }
+      match(matched_messages, std::index_sequence_for<MessageTs...>());
+    }
+    for (auto & messages : matched_messages) {
+      std::apply(callback_, std::move(messages));
+    }
+  }
+
+  /// Return the number of messages dropped without being matched.
+  size_t
+  get_number_of_dropped_messages() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return number_of_dropped_messages_;
+  }
+
+  /// Return the number of messages kept until they are matched or dropped.
+  size_t
+  get_number_of_pending_messages() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::apply(
+      [](const auto & ... queues) {return (queues.size() + ...);}, queues_);
+  }
+
+private:
+  RCLCPP_DISABLE_COPY(SynchronizedSubscription)
+
+  using MatchedMessages = std::tuple<std::shared_ptr<const MessageTs>...>;
+
+  template<typename NodeT, size_t ... Is>
+  void
+  create_subscriptions(
+    NodeT && node,
+    const TopicNames & topic_names,
+    const rclcpp::QoS & qos,
+    const rclcpp::SubscriptionOptions & options,
+    std::index_sequence<Is...>)
+  {
+    std::weak_ptr<SynchronizedSubscription> weak_this(this->shared_from_this());
+    subscriptions_ = std::make_tuple(
+      rclcpp::create_subscription<MessageTs>(
+        node, topic_names[Is], qos,
+        [weak_this](std::shared_ptr<const MessageTs> message) {
+          auto synchronized_subscription = weak_this.lock();
+          if (synchronized_subscription) {
+            synchronized_subscription->template add_message<Is>(std::move(message));
+          }
+        },
+        options)...);
+  }
+
+  /// Remove the matched oldest messages, and the ones which can't be matched anymore.
+  template<size_t ... Is>
+  void
+  match(std::vector<MatchedMessages> & matched_messages, std::index_sequence<Is...>)
+  {
+    while ((!std::get<Is>(queues_).empty() && ...)) {
+      const std::array<int64_t, sizeof...(MessageTs)> stamps{
+        std::get<Is>(queues_).front_stamp()...};
+      size_t oldest = 0u;
+      size_t newest = 0u;
+      for (size_t i = 1u; i < stamps.size(); ++i) {
+        oldest = stamps[i] < stamps[oldest] ? i : oldest;
+        newest = stamps[i] > stamps[newest] ? i : newest;
+      }
+      if (stamps[newest] - stamps[oldest] <= max_interval_) {
+        // The braced initialization pops the rings in order.
+        matched_messages.push_back(MatchedMessages{std::get<Is>(queues_).pop_front()...});
+        continue;
+      }
+      // The later messages of the topic of the newest one are even further apart.
+      ((Is == oldest ? (std::get<Is>(queues_).pop_front(), 0) : 0), ...);
+      ++number_of_dropped_messages_;
+    }
+  }
+
+  const int64_t max_interval_;
+  const Callback callback_;
+  std::tuple<typename rclcpp::Subscription<MessageTs>::SharedPtr...> subscriptions_;
+
+  mutable std::mutex mutex_;
+  std::tuple<detail::StampedMessageRing<MessageTs>...> queues_;
+  size_t number_of_dropped_messages_ = 0u;
+};
+
+/// Create subscriptions to several topics whose messages are given together to one callback.
+/**
+ * \param[in] node node of the subscriptions.
+ * \param[in] topic_names topics of the subscriptions, in the order of the message types.
+ * \param[in] qos quality of service of the subscriptions.
+ * \param[in] queue_size maximum number of messages kept for each topic.
+ * \param[in] max_interval maximum interval between the stamps of matched messages, 0 to
+ *   only match the messages with the same stamp.
+ * \param[in] callback function called with the matched messages.
+ * \param[in] options options of the subscriptions, whose callback group must be mutually
+ *   exclusive.
+ * \throws std::invalid_argument if the queue size is 0, if the maximum interval is negative,
+ *   if the callback is empty, or if the callback group of the options is reentrant.
+ * \sa rclcpp::experimental::SynchronizedSubscription
+ */
+template<typename ... MessageTs, typename NodeT>
+typename SynchronizedSubscription<MessageTs...>::SharedPtr
+create_synchronized_subscription(
+  NodeT && node,
+  const typename SynchronizedSubscription<MessageTs...>::TopicNames & topic_names,
+  const rclcpp::QoS & qos,
+  size_t queue_size,
+  std::chrono::nanoseconds max_interval,
+  typename SynchronizedSubscription<MessageTs...>::Callback callback,
+  const rclcpp::SubscriptionOptions & options = rclcpp::SubscriptionOptions())
+{
+  return SynchronizedSubscription<MessageTs...>::create(
+    std::forward<NodeT>(node), topic_names, qos, queue_size, max_interval, std::move(callback),
+    options);
+}
+
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXPERIMENTAL__SYNCHRONIZED_SUBSCRIPTION_HPP_
@@ -0,0 +1,223 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXPERIMENTAL__TIMERS_MANAGER_HPP_
+#define RCLCPP__EXPERIMENTAL__TIMERS_MANAGER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "rclcpp/context.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/timer.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+
+/// Keep track of a set of timers and notify when they become ready.
+/**
+ * Timers do not have a middleware-level "on ready" callback like subscriptions,
+ * services and clients, so this class provides one.
+ * When a timer becomes ready, the timers manager marks it as called, through
+ * rclcpp::TimerBase::call(), and then invokes the on ready callback given at
+ * construction with the timer as argument.
+ * Executing the timer callback is left to the consumer of the notification.
+ *
+ * The timers can be monitored either by a dedicated thread, started with
+ * start() and stopped with stop(), or on demand with trigger_ready_timers().
+ * The two must not be used at the same time.
+ *
+ * The timers using a steady clock are kept in a min-heap ordered by their
+ * next deadline, so only the timers that are due are checked, and the timers
+ * using the other clocks, whose time may jump, are checked every time.
+ * The heap is ordered by the latest time each timer may be notified, which is
+ * its deadline delayed by its slack, see rclcpp::TimerBase::set_slack(), and
+ * the timers whose deadline passed are notified along with the ones which are
+ * due, so that the monitoring thread wakes up once for both.
+ * The deadlines are cached, a timer reset with rclcpp::TimerBase::reset()
+ * notifies the timers manager through its on reset callback, which is set
+ * while the timer is monitored, and a canceled timer is found as such once
+ * its previous deadline is passed.
+ */
+class TimersManager
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(TimersManager)
+
+  /// Construct a new TimersManager.
+  /**
+   * \param[in] context the context the timers belong to, the monitoring thread
+   *   returns when it is shut down
+   * \param[in] on_ready_callback called every time a timer becomes ready, it
+   *   must be fast and not blocking
+   */
+  RCLCPP_PUBLIC
+  TimersManager(
+    rclcpp::Context::SharedPtr context,
+    std::function<void(const rclcpp::TimerBase *)> on_ready_callback);
+
+  /// Stop the monitoring thread, if running, and stop monitoring the timers.
+  RCLCPP_PUBLIC
+  ~TimersManager();
+
+  /// Add a timer to be monitored, does nothing if the timer is already monitored.
+  RCLCPP_PUBLIC
+  void
+  add_timer(rclcpp::TimerBase::SharedPtr timer);
+
+  /// Stop monitoring a timer.
+  RCLCPP_PUBLIC
+  void
+  remove_timer(rclcpp::TimerBase::SharedPtr timer);
+
+  /// Stop monitoring all the timers.
+  RCLCPP_PUBLIC
+  void
+  clear();
+
+  /// Start a thread that monitors the timers and notifies them as they become ready.
+  /**
+   * \throws std::runtime_error if the thread is already running
+   */
+  RCLCPP_PUBLIC
+  void
+  start();
+
+  /// Stop the monitoring thread and wait for it to return, does nothing if not running.
+  RCLCPP_PUBLIC
+  void
+  stop();
+
+  /// Notify all the timers that are ready now, from the calling thread.
+  /**
+   * \return the number of timers that were ready
+   */
+  RCLCPP_PUBLIC
+  size_t
+  trigger_ready_timers();
+
+  /// Return the time until the next timer becomes ready.
+  /**
+   * \return the time until the closest timer is ready, which may be negative
+   *   if a timer is already overdue, or std::chrono::nanoseconds::max() if no
+   *   timer is monitored or all of them are canceled
+   */
+  RCLCPP_PUBLIC
+  std::chrono::nanoseconds
+  get_head_timeout();
+
+  /// Return the number of timers monitored.
+  RCLCPP_PUBLIC
+  size_t
+  size() const;
+
+private:
+  RCLCPP_DISABLE_COPY(TimersManager)
+
+  /// Body of the monitoring thread.
+  void
+  run_timers();
+
+  using Deadline = std::chrono::steady_clock::time_point;
+
+  /// Entry of the heap of the steady timers.
+  struct HeapEntry
+  {
+    rclcpp::TimerBase::WeakPtr timer;
+    const rclcpp::TimerBase * timer_key;
+    /// Next deadline of the timer delayed by its slack, Deadline::max() if it was canceled.
+    Deadline deadline;
+    /// Entries whose generation isn't the one of the timer are outdated.
+    uint64_t generation;
+
+    bool
+    operator>(const HeapEntry & other) const
+    {
+      return deadline > other.deadline;
+    }
+  };
+
+  struct TimerInfo
+  {
+    rclcpp::TimerBase::WeakPtr timer;
+    /// Generation of the current heap entry, or 0 for a timer not using a steady clock.
+    uint64_t generation;
+  };
+
+  /// Return the deadline of a timer delayed by its slack, requires timers_mutex_.
+  Deadline
+  get_deadline(Deadline now, const rclcpp::TimerBase::SharedPtr & timer);
+
+  /// Push a new heap entry for a timer, outdating the previous one, requires timers_mutex_.
+  void
+  push_heap_entry(const rclcpp::TimerBase::SharedPtr & timer, TimerInfo & info, Deadline now);
+
+  /// Remove the outdated heap entries if they are most of the heap, requires timers_mutex_.
+  void
+  compact_heap();
+
+  /// Stop monitoring the timers and return the ones still alive, requires timers_mutex_.
+  std::vector<rclcpp::TimerBase::SharedPtr>
+  take_all_timers();
+
+  /// Called when a monitored timer is reset.
+  void
+  on_timer_reset(const rclcpp::TimerBase * timer_key);
+
+  /// Notify the ready timers and return the time until the next one, requires timers_mutex_.
+  std::chrono::nanoseconds
+  trigger_ready_timers_unsafe(size_t & ready_timers);
+
+  /// Return the time until the next timer is ready, requires timers_mutex_.
+  std::chrono::nanoseconds
+  get_head_timeout_unsafe();
+
+  rclcpp::Context::SharedPtr context_;
+  std::function<void(const rclcpp::TimerBase *)> on_ready_callback_;
+
+  std::thread timers_thread_;
+  std::atomic<bool> running_{false};
+
+  mutable std::mutex timers_mutex_;
+  std::condition_variable timers_cv_;
+  /// Set when the timers changed and the monitoring thread must recompute its timeout.
+  bool timers_updated_{false};
+  /// Monitored timers, by address.
+  std::unordered_map<const rclcpp::TimerBase *, TimerInfo> timers_;
+  /// Min-heap of the deadlines of the steady timers, with outdated entries.
+  std::vector<HeapEntry> timers_heap_;
+  /// Timers not using a steady clock, their deadline isn't used.
+  std::vector<HeapEntry> unsteady_timers_;
+  uint64_t next_generation_{1};
+  /// Largest slack of the steady timers, the timers are checked this early.
+  std::chrono::nanoseconds max_slack_{0};
+  /// Entries of the timers that were due, kept to reuse its capacity.
+  std::vector<HeapEntry> due_timers_;
+};
+
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXPERIMENTAL__TIMERS_MANAGER_HPP_
@@ -0,0 +1,144 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__FILE_DESCRIPTOR_WAITABLE_HPP_
+#define RCLCPP__FILE_DESCRIPTOR_WAITABLE_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "rclcpp/context.hpp"
+#include "rclcpp/contexts/default_context.hpp"
+#include "rclcpp/guard_condition.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+#include "rclcpp/waitable.hpp"
+
+namespace rclcpp
+{
+
+namespace detail
+{
+class FileDescriptorWatcher;
+}  // namespace detail
+
+/// Waitable executing a handler when a file descriptor is ready, e.g. a socket or a device.
+/**
+ * The file descriptor is polled directly by the executor, right before it waits and after
+ * it woke up, so that, while the file descriptor keeps being ready, its handler is executed
+ * in the loop of the executor without another thread.
+ * Only when the file descriptor isn't ready before the executor waits, a watcher thread,
+ * shared by all the file descriptor waitables of the process, wakes up the executor when it
+ * becomes ready, with a guard condition.
+ *
+ * The handler is given the file descriptor and its events, as returned by poll(), and it
+ * should read all the available data, since it's executed at most once per wait.
+ * The waitable doesn't own the file descriptor, which must stay open as long as the
+ * waitable exists.
+ *
+ * This is only supported on Linux.
+ */
+class FileDescriptorWaitable : public rclcpp::Waitable
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(FileDescriptorWaitable)
+
+  using HandlerType = std::function<void (int fd, int revents)>;
+
+  /// Constructor.
+  /**
+   * \param[in] fd file descriptor to wait on.
+   * \param[in] handler handler executed when the file descriptor is ready.
+   * \param[in] events events to wait for, as for poll(), e.g. `POLLIN`.
+   * \param[in] context context of the guard condition waking up the executor.
+   * \throws std::invalid_argument if fd is negative, the handler is empty, or there are no
+   *   events.
+   * \throws std::runtime_error if the file descriptor can't be watched, or on other platforms
+   *   than Linux.
+   */
+  RCLCPP_PUBLIC
+  FileDescriptorWaitable(
+    int fd,
+    HandlerType handler,
+    int events,
+    rclcpp::Context::SharedPtr context = rclcpp::contexts::get_global_default_context());
+
+  RCLCPP_PUBLIC
+  ~FileDescriptorWaitable() override;
+
+  /// Return the file descriptor.
+  RCLCPP_PUBLIC
+  int
+  get_file_descriptor() const;
+
+  /// \internal
+  RCLCPP_PUBLIC
+  size_t
+  get_number_of_ready_guard_conditions() override;
+
+  /// Poll the file descriptor and add the guard condition to a wait set.
+  /**
+   * If the file descriptor is already ready, the guard condition is triggered, so that the
+   * wait returns immediately, otherwise the watcher thread triggers it when it's ready.
+   * \internal
+   */
+  RCLCPP_PUBLIC
+  void
+  add_to_wait_set(rcl_wait_set_t * wait_set) override;
+
+  /// Return true if the file descriptor is ready, polling it.
+  /// \internal
+  RCLCPP_PUBLIC
+  bool
+  is_ready(rcl_wait_set_t * wait_set) override;
+
+  /// Take the events of the file descriptor.
+  /// \internal
+  RCLCPP_PUBLIC
+  std::shared_ptr<void>
+  take_data() override;
+
+  /// \internal
+  RCLCPP_PUBLIC
+  std::shared_ptr<void>
+  take_data_by_entity_id(size_t id) override;
+
+  /// Execute the handler with the events taken by take_data().
+  /// \internal
+  RCLCPP_PUBLIC
+  void
+  execute(std::shared_ptr<void> & data) override;
+
+private:
+  RCLCPP_DISABLE_COPY(FileDescriptorWaitable)
+
+  /// Return the events of the file descriptor, without blocking.
+  int
+  poll_file_descriptor() const;
+
+  const int fd_;
+  const int events_;
+  HandlerType handler_;
+  std::shared_ptr<rclcpp::GuardCondition> gc_;
+  std::shared_ptr<detail::FileDescriptorWatcher> watcher_;
+  uint64_t watch_id_ = 0;
+  std::atomic<int> revents_{0};
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__FILE_DESCRIPTOR_WAITABLE_HPP_
@@ -22,10 +22,13 @@
 #include "rcpputils/shared_library.hpp"
 
 #include "rclcpp/callback_group.hpp"
+#include "rclcpp/context.hpp"
+#include "rclcpp/detail/resolve_use_intra_process.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/node_interfaces/node_base_interface.hpp"
 #include "rclcpp/node_interfaces/node_topics_interface.hpp"
 #include "rclcpp/publisher_base.hpp"
+#include "rclcpp/publisher_options.hpp"
 #include "rclcpp/qos.hpp"
 #include "rclcpp/serialized_message.hpp"
 #include "rclcpp/typesupport_helpers.hpp"
@@ -41,7 +44,9 @@ namespace rclcpp
  * Since the type is not known at compile time, this is not a template, and the dynamic library
  * containing type support information has to be identified and loaded based on the type name.
  *
- * It does not support intra-process handling.
+ * With intra-process communication, the published messages are shared without being copied
+ * by the rclcpp::GenericSubscription instances of the same context, while the other
+ * subscriptions, including the typed ones, receive them through the middleware.
  */
 class GenericPublisher : public rclcpp::PublisherBase
 {
@@ -64,7 +69,8 @@ public:
    * \param qos %QoS settings
    * \param options %Publisher options.
    * Not all publisher options are currently respected, the only relevant options for this
-   * publisher are `event_callbacks`, `use_default_callbacks`, and `%callback_group`.
+   * publisher are `event_callbacks`, `use_default_callbacks`, `use_intra_process_comm`
+   * and `%callback_group`.
    */
   template<typename AllocatorT = std::allocator<void>>
   GenericPublisher(
@@ -83,15 +89,69 @@ public:
       options.event_callbacks,
       options.use_default_callbacks),
     ts_lib_(ts_lib)
-  {}
+  {
+    event_handler_group_ = options.event_handler_group;
+  }
 
   RCLCPP_PUBLIC
   virtual ~GenericPublisher() = default;
 
+  /// Called post construction, so that construction may continue after shared_from_this() works.
+  /**
+   * Intra-process communication is only used if the %QoS allows it, keep last history
+   * with a non zero depth and volatile durability, as the middleware is used otherwise.
+   *
+   * \throws std::invalid_argument if intra-process communication is explicitly enabled
+   *   with an incompatible %QoS.
+   */
+  template<typename AllocatorT = std::allocator<void>>
+  void
+  post_init_setup(
+    rclcpp::node_interfaces::NodeBaseInterface * node_base,
+    const rclcpp::PublisherOptionsWithAllocator<AllocatorT> & options)
+  {
+    if (rclcpp::detail::resolve_use_intra_process(options, *node_base)) {
+      setup_serialized_intra_process(
+        node_base->get_context(),
+        options.use_intra_process_comm == rclcpp::IntraProcessSetting::Enable);
+    }
+  }
+
   /// Publish a rclcpp::SerializedMessage.
+  /**
+   * The message is copied once if it is published intra-process, to be shared by the
+   * subscriptions.
+   */
   RCLCPP_PUBLIC
   void publish(const rclcpp::SerializedMessage & message);
 
+  /// Publish a rclcpp::SerializedMessage, giving its ownership to rclcpp.
+  /**
+   * This signature allows to share the message with the intra-process subscriptions
+   * without copying it.
+   */
+  RCLCPP_PUBLIC
+  void publish(std::unique_ptr<rclcpp::SerializedMessage> message);
+
+  /// Publish a serialized message whose buffer isn't owned by a rclcpp::SerializedMessage.
+  /**
+   * The buffer may be any memory, for example a record of a memory-mapped file, as it's
+   * only read while publishing, and it can be released once this returns:
+   *
+   * ```cpp
+   * rcl_serialized_message_t view = rmw_get_zero_initialized_serialized_message();
+   * view.buffer = record_data;
+   * view.buffer_length = record_size;
+   * view.buffer_capacity = record_size;
+   * publisher->publish(view);
+   * ```
+   *
+   * The message is published by the middleware without being copied.
+   * It is copied once if it is published intra-process, to be shared by the subscriptions.
+   */
+  RCLCPP_PUBLIC
+  void publish(const rcl_serialized_message_t & message);
+
   /**
    * Publish a rclcpp::SerializedMessage via loaned message after de-serialization.
    *
@@ -105,6 +165,8 @@ private:
   // The type support library should stay loaded, so it is stored in the GenericPublisher
   std::shared_ptr<rcpputils::SharedLibrary> ts_lib_;
 
+  void setup_serialized_intra_process(rclcpp::Context::SharedPtr context, bool required);
+  void do_inter_process_publish(const rcl_serialized_message_t & message);
   void * borrow_loaned_message();
   void deserialize_message(
     const rmw_serialized_message_t & serialized_message,
@@ -23,11 +23,16 @@
 #include "rcpputils/shared_library.hpp"
 
 #include "rclcpp/callback_group.hpp"
+#include "rclcpp/context.hpp"
+#include "rclcpp/detail/resolve_use_intra_process.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/node_interfaces/node_base_interface.hpp"
 #include "rclcpp/node_interfaces/node_topics_interface.hpp"
 #include "rclcpp/qos.hpp"
+#include "rclcpp/detail/serialized_message_fan_out.hpp"
+#include "rclcpp/detail/serialized_message_pool.hpp"
 #include "rclcpp/serialized_message.hpp"
+#include "rclcpp/serialized_message_field.hpp"
 #include "rclcpp/subscription_base.hpp"
 #include "rclcpp/typesupport_helpers.hpp"
 #include "rclcpp/visibility_control.hpp"
@@ -40,7 +45,13 @@ namespace rclcpp
  * Since the type is not known at compile time, this is not a template, and the dynamic library
  * containing type support information has to be identified and loaded based on the type name.
  *
- * It does not support intra-process handling.
+ * With intra-process communication, it receives the messages of the rclcpp::GenericPublisher
+ * instances of the same context without them being copied, as they are shared by all the
+ * subscriptions, so the callback must not modify them.
+ * The messages of the other publishers, including the typed ones, are received through the
+ * middleware.
+ * With the `share_serialized_messages` subscription option, the generic subscriptions of
+ * a topic also share the messages they take from the middleware.
  */
 class GenericSubscription : public rclcpp::SubscriptionBase
 {
@@ -64,8 +75,15 @@ public:
    * \param callback Callback for new messages of serialized form
    * \param options %Subscription options.
    * Not all subscription options are currently respected, the only relevant options for this
-   * subscription are `event_callbacks`, `use_default_callbacks`, `ignore_local_publications`, and
-   * `%callback_group`.
+   * subscription are `event_callbacks`, `use_default_callbacks`, `ignore_local_publications`,
+   * `message_pool_size`, `share_serialized_messages`, `use_intra_process_comm`,
+   * `intra_process_buffer_implementation` and `%callback_group`.
+   * Intra-process communication is only used if the %QoS allows it, keep last history
+   * with a non zero depth and volatile durability, as the middleware is used otherwise.
+   * As the callback may modify the messages, an intra-process message still held by another
+   * subscription or by the publisher is given to it as a copy.
+   * \throws std::invalid_argument if intra-process communication is explicitly enabled
+   *   with an incompatible %QoS.
    */
   template<typename AllocatorT = std::allocator<void>>
   GenericSubscription(
@@ -87,7 +105,20 @@ public:
       true),
     callback_(callback),
     ts_lib_(ts_lib)
-  {}
+  {
+    event_handler_group_ = options.event_handler_group;
+    if (options.message_pool_size > 0) {
+      serialized_message_pool_ =
+        std::make_shared<rclcpp::detail::SerializedMessagePool>(options.message_pool_size);
+    }
+    if (options.share_serialized_messages) {
+      serialized_message_fan_out_ =
+        node_base->get_context()->get_sub_context<rclcpp::detail::SerializedMessageFanOut>();
+    }
+    if (rclcpp::detail::resolve_use_intra_process(options, *node_base)) {
+      setup_serialized_intra_process(node_base->get_context(), options);
+    }
+  }
 
   RCLCPP_PUBLIC
   virtual ~GenericSubscription() = default;
@@ -123,12 +154,33 @@ public:
   RCLCPP_PUBLIC
   void return_serialized_message(std::shared_ptr<rclcpp::SerializedMessage> & message) override;
 
+  /// Compile the path of a field of the messages, to read it without deserializing them.
+  /**
+   * \param[in] field_path the path of the field, e.g. "header.stamp".
+   * \return the field, which can be read from the messages received by the callback.
+   * \throws std::invalid_argument if the messages have no such field, or it can't be read.
+   * \sa rclcpp::SerializedMessageField
+   */
+  RCLCPP_PUBLIC
+  SerializedMessageField::SharedPtr
+  create_field(const std::string & field_path) const;
+
 private:
   RCLCPP_DISABLE_COPY(GenericSubscription)
 
+  RCLCPP_PUBLIC
+  void
+  setup_serialized_intra_process(
+    rclcpp::Context::SharedPtr context,
+    const rclcpp::SubscriptionOptionsBase & options);
+
   std::function<void(std::shared_ptr<rclcpp::SerializedMessage>)> callback_;
   // The type support library should stay loaded, so it is stored in the GenericSubscription
   std::shared_ptr<rcpputils::SharedLibrary> ts_lib_;
+  /// Pool of the taken messages, null unless enabled by the subscription options.
+  rclcpp::detail::SerializedMessagePool::SharedPtr serialized_message_pool_;
+  /// Messages shared with the other subscriptions, null unless enabled by the options.
+  rclcpp::detail::SerializedMessageFanOut::SharedPtr serialized_message_fan_out_;
 };
 
 }  // namespace rclcpp
@@ -63,6 +63,94 @@ public:
   InitOptions &
   auto_initialize_logging(bool initialize_logging);
 
+  /// Return `true` if the log messages are output asynchronously.
+  RCLCPP_PUBLIC
+  bool
+  asynchronous_logging() const;
+
+  /// Set flag indicating if the log messages are output asynchronously or not.
+  /**
+   * When the logging is initialized by the context, each thread then queues its log messages,
+   * without locking, and a background thread outputs them to the console, rosout and file.
+   * The messages logged while the queue of their thread is full are dropped, and their number
+   * is logged instead.
+   * Fatal messages and messages longer than 511 characters are still output synchronously.
+   *
+   * The logging is global, so only the options of the first context initializing it are used.
+   */
+  RCLCPP_PUBLIC
+  InitOptions &
+  asynchronous_logging(bool asynchronous_logging);
+
+  /// Return the number of log messages each thread queues with the asynchronous logging.
+  RCLCPP_PUBLIC
+  size_t
+  asynchronous_logging_queue_size() const;
+
+  /// Set the number of log messages each thread queues with the asynchronous logging.
+  /**
+   * \throws std::invalid_argument if queue_size is 0.
+   */
+  RCLCPP_PUBLIC
+  InitOptions &
+  asynchronous_logging_queue_size(size_t queue_size);
+
+  /// Return the number of threads calling the on shutdown callbacks of the context.
+  RCLCPP_PUBLIC
+  size_t
+  shutdown_callback_threads() const;
+
+  /// Set the number of threads calling the on shutdown callbacks of the context.
+  /**
+   * By default, the callbacks are called one after the other by the thread shutting down
+   * the context.
+   * With several threads, they are called concurrently, which speeds up the shutdown of
+   * processes with many executors or callbacks blocking for a while, so all the on shutdown
+   * callbacks of the context must then be thread-safe.
+   * The callbacks registered by rclcpp itself are thread-safe.
+   *
+   * \param[in] number_of_threads number of threads, including the one shutting down the
+   *   context, or 0 to use one thread per hardware thread.
+   */
+  RCLCPP_PUBLIC
+  InitOptions &
+  shutdown_callback_threads(size_t number_of_threads);
+
+  /// Return `true` if the intra process manager is shared with the other contexts.
+  RCLCPP_PUBLIC
+  bool
+  share_intra_process_manager() const;
+
+  /// Set flag indicating if the intra process manager is shared with the other contexts.
+  /**
+   * By default, each context has its own intra process manager, so the nodes of different
+   * contexts of a process always communicate through the middleware.
+   * When set, the context uses the intra process manager of the process for its domain id,
+   * which is shared with all the other contexts of this domain also setting this flag,
+   * so their publishers and subscriptions using intra process communication exchange their
+   * messages without copies, even if the contexts are shut down separately.
+   */
+  RCLCPP_PUBLIC
+  InitOptions &
+  share_intra_process_manager(bool share_intra_process_manager);
+
+  /// Return `true` if the nodes of the context share one publisher on /rosout.
+  RCLCPP_PUBLIC
+  bool
+  share_rosout_publisher() const;
+
+  /// Set flag indicating if the nodes of the context share one publisher on /rosout.
+  /**
+   * By default, rcl creates a /rosout publisher for each node with rosout enabled, which
+   * all have their own discovery and history.
+   * When set, the log messages of these nodes are published by a single publisher of a
+   * hidden node of the context instead, with the QoS of the first node created.
+   * The log messages still have the name of the logger of their node.
+   */
+  RCLCPP_PUBLIC
+  InitOptions &
+  share_rosout_publisher(bool share_rosout_publisher);
+
   /// Assignment operator.
   RCLCPP_PUBLIC
   InitOptions &
@@ -107,6 +195,11 @@ private:
   mutable std::mutex init_options_mutex_;
   std::unique_ptr<rcl_init_options_t> init_options_;
   bool initialize_logging_{true};
+  bool asynchronous_logging_{false};
+  size_t asynchronous_logging_queue_size_{256u};
+  size_t shutdown_callback_threads_{1u};
+  bool share_intra_process_manager_{false};
+  bool share_rosout_publisher_{false};
 };
 
 }  // namespace rclcpp
@@ -0,0 +1,37 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__INTRA_PROCESS_BUFFER_IMPLEMENTATION_HPP_
+#define RCLCPP__INTRA_PROCESS_BUFFER_IMPLEMENTATION_HPP_
+
+namespace rclcpp
+{
+
+/// Used as argument in create_subscriber when intra-process communication is enabled
+/// to select how the intra-process buffer stores the messages
+enum class IntraProcessBufferImplementation
+{
+  /// Ring buffer protected by a mutex
+  RingBuffer,
+  /// Lock-free ring buffer, messages must be published from a single thread at a time
+  LockFreeSingleProducer,
+  /// Lock-free ring buffer, messages can be published from multiple threads
+  LockFreeMultiProducer,
+  /// Only the latest message, replaced with an atomic exchange, whatever the depth of the QoS
+  LatestOnly
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__INTRA_PROCESS_BUFFER_IMPLEMENTATION_HPP_
@@ -0,0 +1,72 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__INTRA_PROCESS_COUNTERS_HPP_
+#define RCLCPP__INTRA_PROCESS_COUNTERS_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace rclcpp
+{
+
+/// Messages passed within the process, by a publisher or to a subscription.
+struct IntraProcessCounters
+{
+  /// Number of messages.
+  uint64_t messages = 0u;
+  /// Number of bytes of the messages.
+  /**
+   * It's the size of the serialized messages, and the size of the structure of the other
+   * messages, without the memory their sequences and strings point to.
+   */
+  uint64_t bytes = 0u;
+};
+
+namespace detail
+{
+
+/// Thread-safe IntraProcessCounters, updated for each message.
+class AtomicIntraProcessCounters
+{
+public:
+  /// Count a message of the given number of bytes.
+  void
+  record(size_t bytes) noexcept
+  {
+    messages_.fetch_add(1u, std::memory_order_relaxed);
+    bytes_.fetch_add(bytes, std::memory_order_relaxed);
+  }
+
+  /// Return the current values of the counters.
+  IntraProcessCounters
+  get() const noexcept
+  {
+    IntraProcessCounters counters;
+    counters.messages = messages_.load(std::memory_order_relaxed);
+    counters.bytes = bytes_.load(std::memory_order_relaxed);
+    return counters;
+  }
+
+private:
+  std::atomic<uint64_t> messages_{0u};
+  std::atomic<uint64_t> bytes_{0u};
+};
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__INTRA_PROCESS_COUNTERS_HPP_
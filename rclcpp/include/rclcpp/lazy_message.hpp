@@ -0,0 +1,142 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__LAZY_MESSAGE_HPP_
+#define RCLCPP__LAZY_MESSAGE_HPP_
+
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "rclcpp/message_info.hpp"
+#include "rclcpp/serialization.hpp"
+#include "rclcpp/serialized_message.hpp"
+
+namespace rclcpp
+{
+
+/// Message received by a subscription, only deserialized when it's accessed
+/**
+ * It holds the serialized message taken by the subscription, which can be inspected
+ * before deciding to deserialize it, so that the messages discarded by a callback
+ * aren't deserialized at all.
+ * The message is deserialized once by get(), and shared by the copies of the handle.
+ *
+ * It's given to the callbacks created by make_lazy_message_callback().
+ */
+template<typename MessageT>
+class LazyMessage
+{
+public:
+  /// Constructor.
+  /**
+   * \param[in] serialized_message the serialized message, which mustn't change anymore.
+   * \throws std::invalid_argument if the serialized message is null.
+   */
+  explicit LazyMessage(std::shared_ptr<const rclcpp::SerializedMessage> serialized_message)
+  : state_(std::make_shared<State>())
+  {
+    if (!serialized_message) {
+      throw std::invalid_argument("the serialized message of a lazy message is null");
+    }
+    state_->serialized_message = std::move(serialized_message);
+  }
+
+  /// Return the serialized message, which is never deserialized by this.
+  const rclcpp::SerializedMessage &
+  get_serialized_message() const
+  {
+    return *state_->serialized_message;
+  }
+
+  /// Return the deserialized message, deserializing it the first time.
+  /**
+   * \throws rclcpp::exceptions::RCLError if the message can't be deserialized.
+   */
+  std::shared_ptr<const MessageT>
+  get() const
+  {
+    if (!state_->message) {
+      auto message = std::make_shared<MessageT>();
+      deserialize(*message);
+      state_->message = std::move(message);
+    }
+    return state_->message;
+  }
+
+  /// Deserialize the message into a message of the caller, which may be reused.
+  /**
+   * This doesn't keep the deserialized message, it's deserialized again by get().
+   * \throws rclcpp::exceptions::RCLError if the message can't be deserialized.
+   */
+  void
+  deserialize(MessageT & message) const
+  {
+    rclcpp::Serialization<MessageT>().deserialize_message(
+      state_->serialized_message.get(), &message);
+  }
+
+  /// Return true if the message was deserialized by get().
+  bool
+  is_deserialized() const
+  {
+    return static_cast<bool>(state_->message);
+  }
+
+private:
+  struct State
+  {
+    std::shared_ptr<const rclcpp::SerializedMessage> serialized_message;
+    std::shared_ptr<const MessageT> message;
+  };
+
+  std::shared_ptr<State> state_;
+};
+
+/// Create a subscription callback giving the messages to a callback as lazy messages.
+/**
+ * The subscription, created with this callback and MessageT, takes the serialized
+ * messages from the middleware, which are then only deserialized if the callback
+ * accesses them:
+ *
+ * ```cpp
+ * auto subscription = node->create_subscription<MessageT>(
+ *   "topic", qos, rclcpp::make_lazy_message_callback<MessageT>(
+ *     [](const rclcpp::LazyMessage<MessageT> & message, const rclcpp::MessageInfo &) {
+ *       if (is_interesting(message.get_serialized_message())) {
+ *         process(*message.get());
+ *       }
+ *     }));
+ * ```
+ *
+ * \param[in] callback callable taking a rclcpp::LazyMessage<MessageT> and the
+ *   rclcpp::MessageInfo of the message.
+ */
+template<typename MessageT, typename CallbackT>
+std::function<void(std::shared_ptr<const rclcpp::SerializedMessage>, const rclcpp::MessageInfo &)>
+make_lazy_message_callback(CallbackT && callback)
+{
+  return
+    [callback = std::forward<CallbackT>(callback)](
+    std::shared_ptr<const rclcpp::SerializedMessage> serialized_message,
+    const rclcpp::MessageInfo & message_info) mutable
+    {
+      callback(LazyMessage<MessageT>(std::move(serialized_message)), message_info);
+    };
+}
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__LAZY_MESSAGE_HPP_
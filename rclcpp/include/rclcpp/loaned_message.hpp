@@ -19,6 +19,7 @@
 #include <utility>
 
 #include "rclcpp/allocator/allocator_common.hpp"
+#include "rclcpp/detail/loaned_message_pool.hpp"
 #include "rclcpp/logging.hpp"
 #include "rclcpp/publisher_base.hpp"
 
@@ -52,16 +53,22 @@ public:
    * However, this user code is ought to be usable even when dynamically linked against
    * a middleware which doesn't support message loaning in which case the allocator will be used.
    *
+   * When a message pool is given, its messages are used before falling back to the
+   * allocator, so no memory is allocated as long as they are not all loaned.
+   *
    * \param[in] pub rclcpp::Publisher instance to which the memory belongs
    * \param[in] allocator Allocator instance in case middleware can not allocate messages
+   * \param[in] message_pool Optional pool of messages in case middleware can not allocate messages
    * \throws anything rclcpp::exceptions::throw_from_rcl_error can throw.
    */
   LoanedMessage(
     const rclcpp::PublisherBase & pub,
-    std::allocator<MessageT> allocator)
+    std::allocator<MessageT> allocator,
+    typename rclcpp::detail::LoanedMessagePool<MessageT>::SharedPtr message_pool = nullptr)
   : pub_(pub),
     message_(nullptr),
-    message_allocator_(std::move(allocator))
+    message_allocator_(std::move(allocator)),
+    message_pool_(std::move(message_pool))
   {
     if (pub_.can_loan_messages()) {
       void * message_ptr = nullptr;
@@ -74,6 +81,12 @@ public:
       }
       message_ = static_cast<MessageT *>(message_ptr);
     } else {
+      if (message_pool_) {
+        message_ = message_pool_->borrow_message();
+        if (message_) {
+          return;
+        }
+      }
       RCLCPP_INFO_ONCE(
         rclcpp::get_logger("rclcpp"),
         "Currently used middleware can't loan messages. Local allocator will be used.");
@@ -116,7 +129,8 @@ public:
   LoanedMessage(LoanedMessage<MessageT> && other)
   : pub_(std::move(other.pub_)),
     message_(std::move(other.message_)),
-    message_allocator_(std::move(other.message_allocator_))
+    message_allocator_(std::move(other.message_allocator_)),
+    message_pool_(std::move(other.message_pool_))
   {
     other.message_ = nullptr;
   }
@@ -150,6 +164,8 @@ public:
           error_logger, "rcl_deallocate_loaned_message failed: %s", rcl_get_error_string().str);
         rcl_reset_error();
       }
+    } else if (message_pool_ && message_pool_->owns(message_)) {
+      message_pool_->return_message(message_);
     } else {
       // call destructor before deallocating
       message_->~MessageT();
@@ -205,6 +221,14 @@ public:
       return std::unique_ptr<MessageT, std::function<void(MessageT *)>>(msg, [](MessageT *) {});
     }
 
+    if (message_pool_ && message_pool_->owns(msg)) {
+      return std::unique_ptr<MessageT, std::function<void(MessageT *)>>(
+        msg,
+        [message_pool = message_pool_](MessageT * msg_ptr) {
+          message_pool->return_message(msg_ptr);
+        });
+    }
+
     return std::unique_ptr<MessageT, std::function<void(MessageT *)>>(
       msg,
       [allocator = message_allocator_](MessageT * msg_ptr) mutable {
@@ -221,6 +245,8 @@ protected:
 
   MessageAllocator message_allocator_;
 
+  typename rclcpp::detail::LoanedMessagePool<MessageT>::SharedPtr message_pool_;
+
   /// Deleted copy constructor to preserve memory integrity.
   LoanedMessage(const LoanedMessage<MessageT> & other) = delete;
 };
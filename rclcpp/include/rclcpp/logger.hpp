@@ -15,6 +15,8 @@
 #ifndef RCLCPP__LOGGER_HPP_
 #define RCLCPP__LOGGER_HPP_
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -49,6 +51,28 @@ class NodeLogging;
 
 class Logger;
 
+namespace detail
+{
+
+/// Incremented whenever rclcpp changes the level of a logger, invalidating the cached levels.
+RCLCPP_PUBLIC
+extern std::atomic<uint64_t> g_logger_levels_generation;
+
+/// Name of a logger and its effective level, shared by the copies of the logger.
+struct LoggerState
+{
+  explicit LoggerState(const std::string & logger_name)
+  : name(logger_name) {}
+
+  const std::string name;
+  // The generation and the default level the effective level was looked up with, 0 if never
+  std::atomic<uint64_t> generation{0};
+  std::atomic<int> default_level{0};
+  std::atomic<int> effective_level{0};
+};
+
+}  // namespace detail
+
 /// Return a named logger.
 /**
  * The returned logger's name will include any naming conventions, such as a
@@ -112,16 +136,21 @@ private:
    * This cannot be called directly, see `rclcpp::get_logger` instead.
    */
   Logger()
-  : name_(nullptr) {}
+  : state_(nullptr) {}
 
   /// Constructor of a named logger.
   /**
    * This cannot be called directly, see `rclcpp::get_logger` instead.
    */
   explicit Logger(const std::string & name)
-  : name_(new std::string(name)) {}
+  : state_(std::make_shared<detail::LoggerState>(name)) {}
 
-  std::shared_ptr<const std::string> name_;
+  /// Look up the effective level of the logger with rcutils and cache it.
+  RCLCPP_PUBLIC
+  bool
+  is_enabled_for_uncached(Level severity, uint64_t generation) const;
+
+  std::shared_ptr<detail::LoggerState> state_;
 
 public:
   RCLCPP_PUBLIC
@@ -137,10 +166,10 @@ public:
   const char *
   get_name() const
   {
-    if (!name_) {
+    if (!state_) {
       return nullptr;
     }
-    return name_->c_str();
+    return state_->name.c_str();
   }
 
   /// Return a logger that is a descendant of this logger.
@@ -159,10 +188,10 @@ public:
   Logger
   get_child(const std::string & suffix)
   {
-    if (!name_) {
+    if (!state_) {
       return Logger();
     }
-    return Logger(*name_ + "." + suffix);
+    return Logger(state_->name + "." + suffix);
   }
 
   /// Set level for current logger.
@@ -174,6 +203,44 @@ public:
   RCLCPP_PUBLIC
   void
   set_level(Level level);
+
+  /// Return true if messages of a severity are logged by this logger.
+  /**
+   * The effective level of the logger is cached, so that while the levels don't change,
+   * checking it only costs a few loads and comparisons instead of a lookup of the logger
+   * hierarchy by name.
+   * The cache of each logger is invalidated when rclcpp changes the level of any logger,
+   * with set_level() or when initializing a context, and when the default level of
+   * rcutils changes.
+   * After changing the level of a logger with rcutils directly, invalidate_cached_levels()
+   * has to be called.
+   *
+   * The logging macros check it before formatting the message.
+   *
+   * \param[in] severity the severity of the messages
+   */
+  bool
+  is_enabled_for(Level severity) const
+  {
+    if (!state_) {
+      return rcutils_logging_logger_is_enabled_for(nullptr, static_cast<int>(severity));
+    }
+    const uint64_t generation = detail::g_logger_levels_generation.load(std::memory_order_acquire);
+    if (!g_rcutils_logging_initialized ||
+      state_->generation.load(std::memory_order_acquire) != generation ||
+      state_->default_level.load(std::memory_order_relaxed) !=
+      g_rcutils_logging_default_logger_level)
+    {
+      return is_enabled_for_uncached(severity, generation);
+    }
+    return static_cast<int>(severity) >= state_->effective_level.load(std::memory_order_relaxed);
+  }
+
+  /// Invalidate the levels cached by all the loggers.
+  RCLCPP_PUBLIC
+  static
+  void
+  invalidate_cached_levels();
 };
 
 }  // namespace rclcpp
@@ -15,6 +15,7 @@
 #ifndef RCLCPP__MEMORY_STRATEGY_HPP_
 #define RCLCPP__MEMORY_STRATEGY_HPP_
 
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
@@ -47,6 +48,10 @@ public:
       rclcpp::node_interfaces::NodeBaseInterface::WeakPtr,
       std::owner_less<rclcpp::CallbackGroup::WeakPtr>>;
 
+  /// Return true if the first callback group must be executed before the second one.
+  using CallbackGroupPrecedence =
+    std::function<bool (const rclcpp::CallbackGroup &, const rclcpp::CallbackGroup &)>;
+
   virtual ~MemoryStrategy() = default;
 
   virtual bool collect_entities(const WeakCallbackGroupsToNodesMap & weak_groups_to_nodes) = 0;
@@ -95,6 +100,24 @@ public:
     rclcpp::AnyExecutable & any_exec,
     const WeakCallbackGroupsToNodesMap & weak_groups_to_nodes) = 0;
 
+  /// Get the ready entity of the callback group with the highest precedence.
+  /**
+   * Entities of groups with the same precedence are taken in the order of the
+   * other get_next_*() functions, trying timers, subscriptions, services,
+   * clients and then waitables.
+   * The default implementation ignores the precedence and just follows this
+   * order.
+   *
+   * \param[out] any_exec set to the next entity to execute, if any.
+   * \param[in] weak_groups_to_nodes the callback groups to take entities from.
+   * \param[in] has_precedence order of the callback groups.
+   */
+  virtual void
+  get_next_executable_by_precedence(
+    rclcpp::AnyExecutable & any_exec,
+    const WeakCallbackGroupsToNodesMap & weak_groups_to_nodes,
+    const CallbackGroupPrecedence & has_precedence);
+
   virtual rcl_allocator_t
   get_allocator() = 0;
 
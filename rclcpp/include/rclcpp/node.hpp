@@ -59,6 +59,7 @@
 #include "rclcpp/node_interfaces/node_waitables_interface.hpp"
 #include "rclcpp/node_options.hpp"
 #include "rclcpp/parameter.hpp"
+#include "rclcpp/parameter_handle.hpp"
 #include "rclcpp/publisher.hpp"
 #include "rclcpp/publisher_options.hpp"
 #include "rclcpp/qos.hpp"
@@ -565,6 +566,40 @@ public:
     > & parameters,
     bool ignore_overrides = false);
 
+  /// Declare and initialize several parameters at once, from a table of declarations.
+  /**
+   * Each parameter is declared with its value as default value and with its
+   * descriptor, like with declare_parameter().
+   * A parameter with no value, which isn't dynamically typed, gets the type of
+   * its descriptor, like with the declare_parameter() overload taking a type.
+   *
+   * Unlike repeated calls to declare_parameter(), all the declarations are checked
+   * first, once, then the callbacks registered with `add_on_set_parameters_callback`
+   * and `add_post_set_parameters_callback` are called once with all the initial
+   * values, and a single parameter event is published.
+   * Either all the parameters are declared, or none if an exception is thrown.
+   *
+   * This method will _not_ result in any callbacks registered with
+   * `add_pre_set_parameters_callback` to be called.
+   *
+   * \param[in] parameters The parameters to declare, with their descriptors.
+   * \param[in] ignore_overrides When `true`, the parameters overrides are ignored.
+   * \return The values of the parameters, in the same order.
+   * \throws rclcpp::exceptions::ParameterAlreadyDeclaredException if a parameter
+   *   has already been declared, or is declared twice.
+   * \throws rclcpp::exceptions::InvalidParametersException if a parameter
+   *   name is invalid.
+   * \throws rclcpp::exceptions::InvalidParameterTypeException if a statically
+   *   typed parameter has no type, or if its initial value has another type.
+   * \throws rclcpp::exceptions::InvalidParameterValueException if an initial
+   *   value is out of range, or the initial values are rejected by a callback.
+   */
+  RCLCPP_PUBLIC
+  std::vector<rclcpp::ParameterValue>
+  declare_parameters_bulk(
+    const rclcpp::node_interfaces::NodeParametersInterface::ParameterDeclarations & parameters,
+    bool ignore_overrides = false);
+
   /// Undeclare a previously declared parameter.
   /**
    * This method will _not_ cause a callback registered with any of the
@@ -836,6 +871,27 @@ public:
     const std::string & name,
     const ParameterT & alternative_value) const;
 
+  /// Return a handle caching the value of a parameter, which can be read without locking.
+  /**
+   * Reading the value of a parameter with get_parameter() locks the
+   * parameters of the node, looks the parameter up and copies it, while the
+   * handle is updated every time the parameter is set, so that reading it is
+   * a single atomic load.
+   * This is meant for parameters read often, e.g. in every iteration of a
+   * control loop.
+   *
+   * \sa rclcpp::ParameterHandle
+   * \param[in] name The name of the parameter.
+   * \return The handle of the parameter.
+   * \throws rclcpp::exceptions::ParameterNotDeclaredException if the
+   *   parameter has not been declared and undeclared parameters are not allowed.
+   * \throws rclcpp::ParameterTypeException if the parameter doesn't have the
+   *   requested type.
+   */
+  template<typename ParameterT>
+  typename rclcpp::ParameterHandle<ParameterT>::SharedPtr
+  get_parameter_handle(const std::string & name) const;
+
   /// Return the parameters by the given parameter names.
   /**
    * Like get_parameter(const std::string &), this method may throw the
@@ -373,6 +373,15 @@ Node::get_parameter_or(
   return parameter;
 }
 
+template<typename ParameterT>
+typename rclcpp::ParameterHandle<ParameterT>::SharedPtr
+Node::get_parameter_handle(const std::string & name) const
+{
+  std::string sub_name = extend_name_with_sub_namespace(name, this->get_sub_namespace());
+
+  return std::make_shared<rclcpp::ParameterHandle<ParameterT>>(node_parameters_, sub_name);
+}
+
 // this is a partially-specialized version of get_parameter above,
 // where our concrete type for ParameterT is std::map, but the to-be-determined
 // type is the value in the map.
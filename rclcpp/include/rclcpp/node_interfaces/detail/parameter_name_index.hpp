@@ -0,0 +1,107 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__NODE_INTERFACES__DETAIL__PARAMETER_NAME_INDEX_HPP_
+#define RCLCPP__NODE_INTERFACES__DETAIL__PARAMETER_NAME_INDEX_HPP_
+
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace node_interfaces
+{
+namespace detail
+{
+
+/// Prefix tree of parameter names, split in '.' separated segments.
+/**
+ * Finding the names with a given prefix only visits the names which are
+ * found, rather than all the names.
+ * This class isn't thread-safe.
+ */
+class ParameterNameIndex
+{
+public:
+  /// Number of segments meaning that there's no limit.
+  static constexpr size_t unlimited_segments = std::numeric_limits<size_t>::max();
+
+  RCLCPP_PUBLIC
+  ParameterNameIndex();
+
+  RCLCPP_PUBLIC
+  ~ParameterNameIndex();
+
+  /// Add a name, does nothing if it is already indexed.
+  RCLCPP_PUBLIC
+  void
+  insert(const std::string & name);
+
+  /// Remove a name, does nothing if it isn't indexed.
+  RCLCPP_PUBLIC
+  void
+  erase(const std::string & name);
+
+  /// Append the names made of at most max_segments segments.
+  RCLCPP_PUBLIC
+  void
+  collect(size_t max_segments, std::vector<std::string> & names) const;
+
+  /// Append the names which start with the segments of prefix, followed by some more segments.
+  /**
+   * \param[in] prefix the first segments of the names, a name equal to the
+   *   prefix has no more segments
+   * \param[in] min_more_segments the minimum number of segments following the prefix
+   * \param[in] max_more_segments the maximum number of segments following the prefix
+   * \param[out] names the names found, in no particular order
+   */
+  RCLCPP_PUBLIC
+  void
+  collect(
+    const std::string & prefix,
+    size_t min_more_segments,
+    size_t max_more_segments,
+    std::vector<std::string> & names) const;
+
+private:
+  struct Node
+  {
+    std::map<std::string, std::unique_ptr<Node>> children;
+    /// Set if the segments leading to this node are a name.
+    bool is_name = false;
+    std::string name;
+  };
+
+  static
+  void
+  collect(
+    const Node & node,
+    size_t depth,
+    size_t min_depth,
+    size_t max_depth,
+    std::vector<std::string> & names);
+
+  Node root_;
+};
+
+}  // namespace detail
+}  // namespace node_interfaces
+}  // namespace rclcpp
+
+#endif  // RCLCPP__NODE_INTERFACES__DETAIL__PARAMETER_NAME_INDEX_HPP_
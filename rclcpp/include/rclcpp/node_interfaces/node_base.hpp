@@ -24,6 +24,7 @@
 #include "rcl/node.h"
 #include "rclcpp/callback_group.hpp"
 #include "rclcpp/context.hpp"
+#include "rclcpp/detail/resolved_name_cache.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/node_interfaces/node_base_interface.hpp"
 #include "rclcpp/visibility_control.hpp"
@@ -125,6 +126,18 @@ public:
   rclcpp::GuardCondition &
   get_notify_guard_condition() override;
 
+  RCLCPP_PUBLIC
+  void
+  trigger_notify_guard_condition(rclcpp::CallbackGroup::SharedPtr group) override;
+
+  RCLCPP_PUBLIC
+  void
+  begin_batch_modification() override;
+
+  RCLCPP_PUBLIC
+  void
+  end_batch_modification() override;
+
   RCLCPP_PUBLIC
   bool
   get_use_intra_process_default() const override;
@@ -155,6 +168,13 @@ private:
   mutable std::recursive_mutex notify_guard_condition_mutex_;
   rclcpp::GuardCondition notify_guard_condition_;
   bool notify_guard_condition_is_valid_;
+  // Notifications deferred by the batch modifications, also protected by the mutex above
+  size_t batch_modification_depth_ = 0u;
+  bool batch_notify_pending_ = false;
+  std::vector<rclcpp::CallbackGroup::WeakPtr> batch_callback_groups_;
+
+  /// Names resolved by resolve_topic_or_service_name(), which only depend on their flags.
+  mutable rclcpp::detail::ResolvedNameCache resolved_names_;
 };
 
 }  // namespace node_interfaces
@@ -155,6 +155,41 @@ public:
   rclcpp::GuardCondition &
   get_notify_guard_condition() = 0;
 
+  /// Notify the executors of the node, and of a callback group, of a change of their entities.
+  /**
+   * During a batch modification, the notifications are deferred to its end.
+   *
+   * \param[in] group the callback group of the entity which changed, or nullptr.
+   * \throws std::runtime_error if the notify guard condition is invalid.
+   * \throws rclcpp::exceptions::RCLError if a guard condition can't be triggered.
+   */
+  RCLCPP_PUBLIC
+  virtual
+  void
+  trigger_notify_guard_condition(rclcpp::CallbackGroup::SharedPtr group) = 0;
+
+  /// Start a batch modification of the entities of the node, which may be nested.
+  /**
+   * Until the matching end_batch_modification(), the notifications of
+   * trigger_notify_guard_condition() are coalesced, so that the executors spinning the
+   * node are only woken up once to collect its new entities.
+   * Prefer the BatchModification guard, which ends the batch modification when leaving scope.
+   */
+  RCLCPP_PUBLIC
+  virtual
+  void
+  begin_batch_modification() = 0;
+
+  /// End a batch modification, notifying the executors once if the entities changed.
+  /**
+   * \throws std::runtime_error if no batch modification was started.
+   * \throws rclcpp::exceptions::RCLError if a guard condition can't be triggered.
+   */
+  RCLCPP_PUBLIC
+  virtual
+  void
+  end_batch_modification() = 0;
+
   /// Return the default preference for using intra process communication.
   RCLCPP_PUBLIC
   virtual
@@ -175,6 +210,40 @@ public:
     const std::string & name, bool is_service, bool only_expand = false) const = 0;
 };
 
+/// Batch modification of the entities of a node while in scope.
+/**
+ * For example, to create many entities with a single wakeup of the executor of a node:
+ *
+ * ```cpp
+ * {
+ *   rclcpp::node_interfaces::BatchModification batch(node->get_node_base_interface());
+ *   for (auto & topic : topics) {
+ *     subscriptions.push_back(node->create_subscription<MsgT>(topic, 10, callback));
+ *   }
+ * }
+ * ```
+ */
+class BatchModification
+{
+public:
+  /// Start a batch modification of the entities of a node.
+  /**
+   * \throws std::invalid_argument if node_base is nullptr.
+   */
+  RCLCPP_PUBLIC
+  explicit BatchModification(std::shared_ptr<NodeBaseInterface> node_base);
+
+  /// End the batch modification, logging the errors of the notification.
+  RCLCPP_PUBLIC
+  ~BatchModification();
+
+  BatchModification(const BatchModification &) = delete;
+  BatchModification & operator=(const BatchModification &) = delete;
+
+private:
+  std::shared_ptr<NodeBaseInterface> node_base_;
+};
+
 }  // namespace node_interfaces
 }  // namespace rclcpp
 
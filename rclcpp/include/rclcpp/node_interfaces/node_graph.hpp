@@ -18,6 +18,8 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -28,6 +30,7 @@
 
 #include "rcl/guard_condition.h"
 
+#include "rclcpp/detail/resolved_name_cache.hpp"
 #include "rclcpp/event.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/node_interfaces/node_base_interface.hpp"
@@ -52,8 +55,18 @@ class NodeGraph : public NodeGraphInterface
 public:
   RCLCPP_SMART_PTR_ALIASES_ONLY(NodeGraph)
 
+  /// Constructor.
+  /**
+   * \param[in] node_base base interface of the node.
+   * \param[in] cache_graph_queries if true, the results of the topic, service and
+   *   node names queries and of the publisher and subscriber counts are cached
+   *   until the graph listener notifies a graph change.
+   *   So, the graph changes are seen once the graph listener thread has been notified of them.
+   */
   RCLCPP_PUBLIC
-  explicit NodeGraph(rclcpp::node_interfaces::NodeBaseInterface * node_base);
+  explicit NodeGraph(
+    rclcpp::node_interfaces::NodeBaseInterface * node_base,
+    bool cache_graph_queries = false);
 
   RCLCPP_PUBLIC
   virtual
@@ -129,6 +142,10 @@ public:
   rclcpp::Event::SharedPtr
   get_graph_event() override;
 
+  RCLCPP_PUBLIC
+  rclcpp::Event::SharedPtr
+  get_filtered_graph_event(std::function<bool()> filter) override;
+
   RCLCPP_PUBLIC
   void
   wait_for_graph_change(
@@ -139,6 +156,15 @@ public:
   size_t
   count_graph_users() const override;
 
+  /// Return the number of graph changes notified so far.
+  /**
+   * Only increases while the graph is monitored by the graph listener, i.e.
+   * while there are graph users or if the graph queries are cached.
+   */
+  RCLCPP_PUBLIC
+  uint64_t
+  get_graph_version() const;
+
   RCLCPP_PUBLIC
   std::vector<rclcpp::TopicEndpointInfo>
   get_publishers_info_by_topic(
@@ -151,9 +177,42 @@ public:
     const std::string & topic_name,
     bool no_mangle = false) const override;
 
+  /// Get the publishers and subscriptions of many topics into caller-provided storage.
+  /**
+   * The names are resolved once per topic, and the rcl endpoint arrays are copied
+   * into the existing elements of `endpoints_info`, reusing their memory.
+   */
+  RCLCPP_PUBLIC
+  void
+  get_endpoints_info_by_topics(
+    const std::vector<std::string> & topic_names,
+    std::vector<rclcpp::TopicEndpointsInfo> & endpoints_info,
+    bool no_mangle = false) const override;
+
 private:
   RCLCPP_DISABLE_COPY(NodeGraph)
 
+  struct GraphCache;
+
+  /// Lock the graph cache, clearing it if the graph changed since it was filled.
+  GraphCache &
+  lock_graph_cache(std::unique_lock<std::mutex> & lock) const;
+
+  std::map<std::string, std::vector<std::string>>
+  query_topic_names_and_types(bool no_demangle) const;
+
+  std::map<std::string, std::vector<std::string>>
+  query_service_names_and_types() const;
+
+  std::vector<std::pair<std::string, std::string>>
+  query_node_names_and_namespaces() const;
+
+  size_t
+  query_count_publishers(const std::string & topic_name) const;
+
+  size_t
+  query_count_subscribers(const std::string & topic_name) const;
+
   /// Handle to the NodeBaseInterface given in the constructor.
   rclcpp::node_interfaces::NodeBaseInterface * node_base_;
 
@@ -168,9 +227,20 @@ private:
   std::condition_variable graph_cv_;
   /// Weak references to graph events out on loan.
   std::vector<rclcpp::Event::WeakPtr> graph_events_;
+  /// Weak references to filtered graph events out on loan, with their filter.
+  std::vector<std::pair<rclcpp::Event::WeakPtr, std::function<bool()>>> filtered_graph_events_;
   /// Number of graph events out on loan, used to determine if the graph should be monitored.
   /** graph_users_count_ is atomic so that it can be accessed without acquiring the graph_mutex_ */
   std::atomic_size_t graph_users_count_;
+
+  /// Incremented on each graph change notified by the graph listener.
+  std::atomic<uint64_t> graph_version_{0};
+  /// Results of the graph queries, if they are cached.
+  std::unique_ptr<GraphCache> graph_cache_;
+  /// Graph event keeping the graph monitored while the queries are cached.
+  rclcpp::Event::SharedPtr graph_cache_event_;
+  /// Topic names expanded, and possibly remapped, by the queries of the node.
+  mutable rclcpp::detail::ResolvedNameCache resolved_topic_names_;
 };
 
 }  // namespace node_interfaces
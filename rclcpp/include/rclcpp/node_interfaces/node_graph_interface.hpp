@@ -18,7 +18,9 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <functional>
 #include <map>
+#include <memory>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -131,6 +133,16 @@ private:
   rclcpp::QoS qos_profile_;
 };
 
+/// Publishers and subscriptions of a topic, filled by a bulk query.
+/**
+ * \sa rclcpp::node_interfaces::NodeGraphInterface::get_endpoints_info_by_topics
+ */
+struct TopicEndpointsInfo
+{
+  std::vector<rclcpp::TopicEndpointInfo> publishers;
+  std::vector<rclcpp::TopicEndpointInfo> subscriptions;
+};
+
 namespace node_interfaces
 {
 
@@ -331,6 +343,50 @@ public:
   rclcpp::Event::SharedPtr
   get_graph_event() = 0;
 
+  /// Return a graph event, which is only set by the graph changes passing a filter.
+  /**
+   * The filter is called by the graph listener thread on each graph change,
+   * to check for the changes the event is about, such as a service becoming
+   * available, so that the threads waiting on the event with wait_for_graph_change()
+   * aren't woken up by unrelated changes.
+   * It must not block, and a filter throwing is considered passed.
+   *
+   * The default implementation doesn't filter, returning get_graph_event().
+   *
+   * \param[in] filter returns true if the graph change is relevant to the event.
+   */
+  RCLCPP_PUBLIC
+  virtual
+  rclcpp::Event::SharedPtr
+  get_filtered_graph_event(std::function<bool()> filter)
+  {
+    (void)filter;
+    return get_graph_event();
+  }
+
+  /// Return a graph event set when the number of publishers or subscriptions of a topic changes.
+  /**
+   * \sa get_filtered_graph_event()
+   * \param[in] topic_name name of the topic, expanded as by count_publishers().
+   */
+  RCLCPP_PUBLIC
+  rclcpp::Event::SharedPtr
+  get_topic_graph_event(const std::string & topic_name)
+  {
+    auto counts = std::make_shared<std::pair<size_t, size_t>>(
+      count_publishers(topic_name), count_subscribers(topic_name));
+    return get_filtered_graph_event(
+      [this, topic_name, counts]() {
+        std::pair<size_t, size_t> new_counts(
+          count_publishers(topic_name), count_subscribers(topic_name));
+        if (new_counts == *counts) {
+          return false;
+        }
+        *counts = new_counts;
+        return true;
+      });
+  }
+
   /// Wait for a graph event to occur by waiting on an Event to become set.
   /**
    * The given Event must be acquire through the get_graph_event() method.
@@ -378,6 +434,38 @@ public:
   virtual
   std::vector<rclcpp::TopicEndpointInfo>
   get_subscriptions_info_by_topic(const std::string & topic_name, bool no_mangle = false) const = 0;
+
+  /// Get the publishers and subscriptions of many topics into caller-provided storage.
+  /**
+   * After the call, `endpoints_info[i]` holds the endpoints of `topic_names[i]`.
+   * The storage is meant to be reused across calls: `endpoints_info` only grows, and the
+   * existing endpoint information objects, and the memory of their strings, are
+   * overwritten instead of being allocated again.
+   * Extra elements of `endpoints_info`, beyond the number of topics, are left untouched.
+   *
+   * The default implementation calls get_publishers_info_by_topic() and
+   * get_subscriptions_info_by_topic() for each topic.
+   *
+   * \param[in] topic_names the names of the topics, as in get_publishers_info_by_topic().
+   * \param[inout] endpoints_info the endpoints of each topic.
+   * \param[in] no_mangle as in get_publishers_info_by_topic().
+   */
+  RCLCPP_PUBLIC
+  virtual
+  void
+  get_endpoints_info_by_topics(
+    const std::vector<std::string> & topic_names,
+    std::vector<rclcpp::TopicEndpointsInfo> & endpoints_info,
+    bool no_mangle = false) const
+  {
+    if (endpoints_info.size() < topic_names.size()) {
+      endpoints_info.resize(topic_names.size());
+    }
+    for (size_t i = 0; i < topic_names.size(); ++i) {
+      endpoints_info[i].publishers = get_publishers_info_by_topic(topic_names[i], no_mangle);
+      endpoints_info[i].subscriptions = get_subscriptions_info_by_topic(topic_names[i], no_mangle);
+    }
+  }
 };
 
 }  // namespace node_interfaces
@@ -20,6 +20,8 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "rcutils/macros.h"
@@ -30,6 +32,7 @@
 #include "rcl_interfaces/msg/set_parameters_result.hpp"
 
 #include "rclcpp/macros.hpp"
+#include "rclcpp/node_interfaces/detail/parameter_name_index.hpp"
 #include "rclcpp/node_interfaces/node_base_interface.hpp"
 #include "rclcpp/node_interfaces/node_logging_interface.hpp"
 #include "rclcpp/node_interfaces/node_parameters_interface.hpp"
@@ -55,6 +58,77 @@ struct ParameterInfo
   rcl_interfaces::msg::ParameterDescriptor descriptor;
 };
 
+// Internal storage of the parameter infos, indexed by name and by '.' separated prefix.
+class ParameterInfos
+{
+public:
+  using Map = std::unordered_map<std::string, ParameterInfo>;
+  using iterator = Map::iterator;
+  using const_iterator = Map::const_iterator;
+
+  iterator
+  begin() {return infos_.begin();}
+
+  const_iterator
+  begin() const {return infos_.begin();}
+
+  iterator
+  end() {return infos_.end();}
+
+  const_iterator
+  end() const {return infos_.end();}
+
+  const_iterator
+  cend() const {return infos_.cend();}
+
+  iterator
+  find(const std::string & name) {return infos_.find(name);}
+
+  const_iterator
+  find(const std::string & name) const {return infos_.find(name);}
+
+  ParameterInfo &
+  at(const std::string & name) {return infos_.at(name);}
+
+  const ParameterInfo &
+  at(const std::string & name) const {return infos_.at(name);}
+
+  /// Return the info of a parameter, adding it if needed.
+  ParameterInfo &
+  operator[](const std::string & name)
+  {
+    auto it = infos_.find(name);
+    if (infos_.end() != it) {
+      return it->second;
+    }
+    it = infos_.emplace(name, ParameterInfo()).first;
+    try {
+      name_index_.insert(name);
+    } catch (...) {
+      infos_.erase(it);
+      throw;
+    }
+    return it->second;
+  }
+
+  iterator
+  erase(iterator it)
+  {
+    name_index_.erase(it->first);
+    return infos_.erase(it);
+  }
+
+  size_t
+  size() const {return infos_.size();}
+
+  const detail::ParameterNameIndex &
+  get_name_index() const {return name_index_;}
+
+private:
+  Map infos_;
+  detail::ParameterNameIndex name_index_;
+};
+
 // Internal RAII-style guard for mutation recursion
 class ParameterMutationRecursionGuard
 {
@@ -132,6 +206,16 @@ public:
     rcl_interfaces::msg::ParameterDescriptor(),
     bool ignore_override = false) override;
 
+  /// Declare several parameters with a single check of their values and call of the callbacks.
+  /**
+   * \sa rclcpp::Node::declare_parameters_bulk
+   */
+  RCLCPP_PUBLIC
+  std::vector<rclcpp::ParameterValue>
+  declare_parameters_bulk(
+    const ParameterDeclarations & parameters,
+    bool ignore_overrides = false) override;
+
   RCLCPP_PUBLIC
   void
   undeclare_parameter(const std::string & name) override;
@@ -214,6 +298,14 @@ public:
   const std::map<std::string, rclcpp::ParameterValue> &
   get_parameter_overrides() const override;
 
+  RCLCPP_PUBLIC
+  void
+  begin_parameter_event_batch() override;
+
+  RCLCPP_PUBLIC
+  void
+  end_parameter_event_batch() override;
+
   using PreSetCallbacksHandleContainer = std::list<PreSetParametersCallbackHandle::WeakPtr>;
   using OnSetCallbacksHandleContainer = std::list<OnSetParametersCallbackHandle::WeakPtr>;
   using PostSetCallbacksHandleContainer = std::list<PostSetParametersCallbackHandle::WeakPtr>;
@@ -228,6 +320,23 @@ protected:
 private:
   RCLCPP_DISABLE_COPY(NodeParameters)
 
+  /// Publish a parameter event, or merge it into the pending one during a batch.
+  void
+  publish_parameter_event(rcl_interfaces::msg::ParameterEvent & parameter_event);
+
+  enum class ParameterChange
+  {
+    New,
+    Changed,
+    Deleted,
+  };
+
+  /// Merge the change of a parameter into the pending changes of the batch.
+  void
+  add_pending_parameter_change(
+    ParameterChange change,
+    const rcl_interfaces::msg::Parameter & parameter);
+
   mutable std::recursive_mutex mutex_;
 
   // There are times when we don't want to allow modifications to parameters
@@ -241,7 +350,7 @@ private:
 
   PostSetCallbacksHandleContainer post_set_parameters_callback_container_;
 
-  std::map<std::string, ParameterInfo> parameters_;
+  ParameterInfos parameters_;
 
   std::map<std::string, rclcpp::ParameterValue> parameter_overrides_;
 
@@ -249,6 +358,17 @@ private:
 
   Publisher<rcl_interfaces::msg::ParameterEvent>::SharedPtr events_publisher_;
 
+  /// Number of parameter event batches which didn't end yet.
+  size_t parameter_event_batch_depth_{0};
+
+  /// Changes of the parameters during the batch, merged by parameter name.
+  std::unordered_map<
+    std::string, std::pair<ParameterChange, rcl_interfaces::msg::Parameter>>
+  pending_parameter_changes_;
+
+  /// Names of the changed parameters, in the order of their first change.
+  std::vector<std::string> pending_parameter_names_;
+
   std::shared_ptr<ParameterService> parameter_service_;
 
   std::string combined_name_;
@@ -15,15 +15,18 @@
 #ifndef RCLCPP__NODE_INTERFACES__NODE_PARAMETERS_INTERFACE_HPP_
 #define RCLCPP__NODE_INTERFACES__NODE_PARAMETERS_INTERFACE_HPP_
 
+#include <exception>
 #include <functional>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "rcl_interfaces/msg/list_parameters_result.hpp"
 #include "rcl_interfaces/msg/parameter_descriptor.hpp"
 #include "rcl_interfaces/msg/set_parameters_result.hpp"
 
+#include "rclcpp/logging.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/node_interfaces/detail/node_interfaces_helpers.hpp"
 #include "rclcpp/parameter.hpp"
@@ -74,6 +77,10 @@ class NodeParametersInterface
 public:
   RCLCPP_SMART_PTR_ALIASES_ONLY(NodeParametersInterface)
 
+  /// Parameters to declare, with their default values and descriptors.
+  using ParameterDeclarations =
+    std::vector<std::pair<rclcpp::Parameter, rcl_interfaces::msg::ParameterDescriptor>>;
+
   RCLCPP_PUBLIC
   virtual
   ~NodeParametersInterface() = default;
@@ -106,6 +113,46 @@ public:
     rcl_interfaces::msg::ParameterDescriptor(),
     bool ignore_override = false) = 0;
 
+  /// Declare and initialize several parameters at once.
+  /**
+   * The default implementation declares them one at a time, in a parameter event batch.
+   *
+   * \sa rclcpp::Node::declare_parameters_bulk
+   */
+  RCLCPP_PUBLIC
+  virtual
+  std::vector<rclcpp::ParameterValue>
+  declare_parameters_bulk(
+    const ParameterDeclarations & parameters,
+    bool ignore_overrides = false)
+  {
+    std::vector<rclcpp::ParameterValue> values;
+    values.reserve(parameters.size());
+    begin_parameter_event_batch();
+    try {
+      for (const auto & parameter_and_descriptor : parameters) {
+        const rclcpp::Parameter & parameter = parameter_and_descriptor.first;
+        const auto & descriptor = parameter_and_descriptor.second;
+        if (rclcpp::PARAMETER_NOT_SET == parameter.get_type() && !descriptor.dynamic_typing) {
+          values.push_back(
+            declare_parameter(
+              parameter.get_name(), static_cast<rclcpp::ParameterType>(descriptor.type),
+              descriptor, ignore_overrides));
+        } else {
+          values.push_back(
+            declare_parameter(
+              parameter.get_name(), parameter.get_parameter_value(), descriptor,
+              ignore_overrides));
+        }
+      }
+    } catch (...) {
+      end_parameter_event_batch();
+      throw;
+    }
+    end_parameter_event_batch();
+    return values;
+  }
+
   /// Undeclare a parameter.
   /**
    * \sa rclcpp::Node::undeclare_parameter
@@ -272,6 +319,59 @@ public:
   virtual
   const std::map<std::string, rclcpp::ParameterValue> &
   get_parameter_overrides() const = 0;
+
+  /// Start coalescing the parameter events of the node.
+  /**
+   * Until the matching call to end_parameter_event_batch(), the parameters
+   * which are declared, set or undeclared are merged into a single parameter
+   * event, which is published when the batch ends.
+   * Batches can be nested, the event is only published when the outermost
+   * one ends.
+   *
+   * The default implementation doesn't coalesce the events.
+   *
+   * \sa rclcpp::node_interfaces::ParameterEventBatch
+   */
+  RCLCPP_PUBLIC
+  virtual
+  void
+  begin_parameter_event_batch() {}
+
+  /// End a batch started by begin_parameter_event_batch().
+  /**
+   * \throws std::runtime_error if no batch was started
+   */
+  RCLCPP_PUBLIC
+  virtual
+  void
+  end_parameter_event_batch() {}
+};
+
+/// Coalesce the parameter events of a node for as long as this object exists.
+class ParameterEventBatch
+{
+public:
+  explicit ParameterEventBatch(NodeParametersInterface & node_parameters)
+  : node_parameters_(node_parameters)
+  {
+    node_parameters_.begin_parameter_event_batch();
+  }
+
+  ~ParameterEventBatch()
+  {
+    try {
+      node_parameters_.end_parameter_event_batch();
+    } catch (const std::exception & exception) {
+      RCLCPP_ERROR(
+        rclcpp::get_logger("rclcpp"),
+        "failed to publish the coalesced parameter event: %s", exception.what());
+    }
+  }
+
+private:
+  RCLCPP_DISABLE_COPY(ParameterEventBatch)
+
+  NodeParametersInterface & node_parameters_;
 };
 
 }  // namespace node_interfaces
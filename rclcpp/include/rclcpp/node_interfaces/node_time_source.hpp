@@ -49,7 +49,8 @@ public:
     rclcpp::node_interfaces::NodeClockInterface::SharedPtr node_clock,
     rclcpp::node_interfaces::NodeParametersInterface::SharedPtr node_parameters,
     const rclcpp::QoS & qos = rclcpp::ClockQoS(),
-    bool use_clock_thread = true
+    bool use_clock_thread = true,
+    bool use_shared_clock_subscription = false
   );
 
   RCLCPP_PUBLIC
@@ -50,6 +50,8 @@ public:
    *   - clock_type = RCL_ROS_TIME
    *   - clock_qos = rclcpp::ClockQoS()
    *   - use_clock_thread = true
+   *   - use_shared_clock_subscription = false
+   *   - cache_graph_queries = false
    *   - rosout_qos = rclcpp::RosoutQoS()
    *   - parameter_event_qos = rclcpp::ParameterEventQoS
    *     - with history setting and depth from rmw_qos_profile_parameter_events
@@ -63,6 +65,26 @@ public:
   RCLCPP_PUBLIC
   explicit NodeOptions(rcl_allocator_t allocator = rcl_get_default_allocator());
 
+  /// Return the options of a minimal node, which is faster to create.
+  /**
+   * Minimal nodes are meant for lightweight helper nodes, which don't need to be
+   * introspected remotely, so they are created without the entities of the
+   * default options which aren't needed locally:
+   *
+   *   - start_parameter_services = false, saving six services
+   *   - start_parameter_event_publisher = false
+   *   - enable_rosout = false, the logs are still written to the console and log files
+   *
+   * Their parameters still work locally, and each of these entities can be enabled
+   * again on the returned options.
+   *
+   * \param[in] allocator allocator to use in construction of NodeOptions.
+   */
+  RCLCPP_PUBLIC
+  static
+  NodeOptions
+  minimal(rcl_allocator_t allocator = rcl_get_default_allocator());
+
   /// Destructor.
   RCLCPP_PUBLIC
   virtual
@@ -288,6 +310,41 @@ public:
   NodeOptions &
   use_clock_thread(bool use_clock_thread);
 
+  /// Return the use_shared_clock_subscription flag.
+  RCLCPP_PUBLIC
+  bool
+  use_shared_clock_subscription() const;
+
+  /// Set the use_shared_clock_subscription flag, return this for parameter idiom.
+  /**
+   * If true, the time source of the node uses a subscription to the "/clock"
+   * topic shared by all the nodes of the context with this flag set, which is
+   * spun by a single thread, instead of a subscription of its own.
+   * The shared subscription uses rclcpp::ClockQoS(), the clock_qos and the QoS
+   * overrides of the node aren't used.
+   */
+  RCLCPP_PUBLIC
+  NodeOptions &
+  use_shared_clock_subscription(bool use_shared_clock_subscription);
+
+  /// Return the cache_graph_queries flag.
+  RCLCPP_PUBLIC
+  bool
+  cache_graph_queries() const;
+
+  /// Set the cache_graph_queries flag, return this for parameter idiom.
+  /**
+   * If true, the topic, service and node names of the graph and the publisher
+   * and subscriber counts queried through the node are cached until the graph
+   * changes, so that polling them doesn't query the middleware while the graph
+   * is unchanged.
+   * The graph is then monitored by the graph listener for the whole life of
+   * the node, and changes are seen once the graph listener was notified of them.
+   */
+  RCLCPP_PUBLIC
+  NodeOptions &
+  cache_graph_queries(bool cache_graph_queries);
+
   /// Return a reference to the parameter_event_qos QoS.
   RCLCPP_PUBLIC
   const rclcpp::QoS &
@@ -421,6 +478,10 @@ private:
 
   bool use_clock_thread_ {true};
 
+  bool use_shared_clock_subscription_ {false};
+
+  bool cache_graph_queries_ {false};
+
   rclcpp::QoS parameter_event_qos_ = rclcpp::ParameterEventsQoS(
     rclcpp::QoSInitialization::from_rmw(rmw_qos_profile_parameter_events)
   );
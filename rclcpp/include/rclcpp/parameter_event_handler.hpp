@@ -19,7 +19,6 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
-#include <utility>
 #include <vector>
 
 #include "rclcpp/create_subscription.hpp"
@@ -30,6 +29,8 @@
 #include "rclcpp/parameter.hpp"
 #include "rclcpp/qos.hpp"
 #include "rclcpp/subscription.hpp"
+#include "rclcpp/subscription_content_filter_options.hpp"
+#include "rclcpp/subscription_options.hpp"
 #include "rclcpp/visibility_control.hpp"
 #include "rcl_interfaces/msg/parameter_event.hpp"
 
@@ -167,25 +168,40 @@ class ParameterEventHandler
 public:
   /// Construct a parameter events monitor.
   /**
+   * If filter_by_node is true, the subscription uses a content filter on
+   * the node of the events, so that the middleware only delivers the events
+   * of this node and of the nodes which have parameter callbacks.
+   * The parameter event callbacks then only receive these events too.
+   * The filter is updated when parameter callbacks are added or removed, and
+   * isn't used if the middleware doesn't support content filtering.
+   *
    * \param[in] node The node to use to create any required subscribers.
    * \param[in] qos The QoS settings to use for any subscriptions.
+   * \param[in] filter_by_node Whether to filter the events by node in the middleware.
    */
   template<typename NodeT>
   explicit ParameterEventHandler(
     NodeT node,
     const rclcpp::QoS & qos =
-    rclcpp::QoS(rclcpp::QoSInitialization::from_rmw(rmw_qos_profile_parameter_events)))
+    rclcpp::QoS(rclcpp::QoSInitialization::from_rmw(rmw_qos_profile_parameter_events)),
+    bool filter_by_node = false)
   : node_base_(rclcpp::node_interfaces::get_node_base_interface(node))
   {
     auto node_topics = rclcpp::node_interfaces::get_node_topics_interface(node);
 
     callbacks_ = std::make_shared<Callbacks>();
 
+    rclcpp::SubscriptionOptions options;
+    if (filter_by_node) {
+      options.content_filter_options = get_node_content_filter({});
+    }
     event_subscription_ = rclcpp::create_subscription<rcl_interfaces::msg::ParameterEvent>(
       node_topics, "/parameter_events", qos,
       [callbacks = callbacks_](const rcl_interfaces::msg::ParameterEvent & event) {
         callbacks->event_callback(event);
-      });
+      },
+      options);
+    filter_by_node_ = filter_by_node && event_subscription_->is_cft_enabled();
   }
 
   using ParameterEventCallbackType =
@@ -305,38 +321,15 @@ public:
   using CallbacksContainerType = std::list<ParameterCallbackHandle::WeakPtr>;
 
 protected:
-  // *INDENT-OFF* Uncrustify doesn't handle indented public/private labels
-  // Hash function for string pair required in std::unordered_map
-  // See: https://stackoverflow.com/questions/35985960/c-why-is-boosthash-combine-the-best-way-to-combine-hash-values
-  class StringPairHash
-  {
-  public:
-    template<typename T>
-    inline void hash_combine(std::size_t & seed, const T & v) const
-    {
-      std::hash<T> hasher;
-      seed ^= hasher(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-    }
-
-    inline size_t operator()(const std::pair<std::string, std::string> & s) const
-    {
-      size_t seed = 0;
-      hash_combine(seed, s.first);
-      hash_combine(seed, s.second);
-      return seed;
-    }
-  };
-  // *INDENT-ON*
-
   struct Callbacks
   {
     std::recursive_mutex mutex_;
 
-    // Map container for registered parameters
+    // Registered parameter callbacks, by node name and then by parameter name, so that the
+    // events of the nodes without callbacks are rejected with a single lookup.
     std::unordered_map<
-      std::pair<std::string, std::string>,
-      CallbacksContainerType,
-      StringPairHash
+      std::string,
+      std::unordered_map<std::string, CallbacksContainerType>
     > parameter_callbacks_;
 
     std::list<ParameterEventCallbackHandle::WeakPtr> event_callbacks_;
@@ -352,10 +345,21 @@ protected:
   // Utility function for resolving node path.
   std::string resolve_path(const std::string & path);
 
+  // Content filter accepting the events of this node and of the nodes with parameter callbacks.
+  RCLCPP_PUBLIC
+  rclcpp::ContentFilterOptions
+  get_node_content_filter(const std::vector<std::string> & node_names);
+
+  // Update the content filter of the subscription with the nodes which have parameter callbacks.
+  void update_node_content_filter();
+
   // Node interface used for base functionality
   std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> node_base_;
 
   rclcpp::Subscription<rcl_interfaces::msg::ParameterEvent>::SharedPtr event_subscription_;
+
+  // Whether the subscription filters the events by node.
+  bool filter_by_node_{false};
 };
 
 }  // namespace rclcpp
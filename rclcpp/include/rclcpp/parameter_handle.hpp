@@ -0,0 +1,195 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__PARAMETER_HANDLE_HPP_
+#define RCLCPP__PARAMETER_HANDLE_HPP_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/node_interfaces/node_parameters_interface.hpp"
+#include "rclcpp/parameter.hpp"
+#include "rclcpp/parameter_value.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Latest value of a parameter, stored in a std::shared_ptr swapped atomically.
+template<typename ParameterT, typename Enable = void>
+class ParameterSnapshot
+{
+public:
+  using ValueType = std::shared_ptr<const ParameterT>;
+
+  ValueType
+  load() const
+  {
+    return std::atomic_load_explicit(&value_, std::memory_order_acquire);
+  }
+
+  void
+  store(ParameterT value)
+  {
+    std::atomic_store_explicit(
+      &value_, std::make_shared<const ParameterT>(std::move(value)), std::memory_order_release);
+  }
+
+private:
+  ValueType value_;
+};
+
+/// Latest value of an arithmetic parameter, stored in a std::atomic.
+template<typename ParameterT>
+class ParameterSnapshot<ParameterT, std::enable_if_t<std::is_arithmetic<ParameterT>::value>>
+{
+public:
+  using ValueType = ParameterT;
+
+  ValueType
+  load() const
+  {
+    return value_.load(std::memory_order_acquire);
+  }
+
+  void
+  store(ParameterT value)
+  {
+    value_.store(value, std::memory_order_release);
+  }
+
+private:
+  std::atomic<ParameterT> value_{};
+};
+
+}  // namespace detail
+
+/// Cached value of a parameter, which can be read without locking.
+/**
+ * The value is updated by a post set parameters callback every time the
+ * parameter is set, so that get() doesn't lock the parameters of the node,
+ * look the parameter up, nor copy it.
+ * For arithmetic types, i.e. bool, integers and floating point numbers,
+ * get() is a single atomic load and returns the value.
+ * For the other types, e.g. std::string or std::vector<double>, get()
+ * atomically loads and returns a std::shared_ptr to the immutable value,
+ * which stays valid after the parameter changes.
+ *
+ * If the type of the parameter changes, which is only possible when it is
+ * dynamically typed, or if it is undeclared, the handle keeps the last
+ * value of the type it was created for.
+ *
+ * The handle must not be destroyed from within a parameters callback of the
+ * node.
+ */
+template<typename ParameterT>
+class ParameterHandle
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(ParameterHandle)
+
+  using ValueType = typename detail::ParameterSnapshot<ParameterT>::ValueType;
+
+  /// Construct a handle of a declared parameter.
+  /**
+   * \param[in] node_parameters the parameters interface of the node
+   * \param[in] name the name of the parameter
+   * \throws rclcpp::exceptions::ParameterNotDeclaredException if the parameter
+   *   has not been declared and undeclared parameters are not allowed.
+   * \throws rclcpp::ParameterTypeException if the parameter doesn't have the
+   *   type of the handle.
+   */
+  ParameterHandle(
+    rclcpp::node_interfaces::NodeParametersInterface::SharedPtr node_parameters,
+    const std::string & name)
+  : node_parameters_(std::move(node_parameters)), name_(name)
+  {
+    // Registered first, so that a value set while reading the current one isn't missed.
+    callback_handle_ = node_parameters_->add_post_set_parameters_callback(
+      [this](const std::vector<rclcpp::Parameter> & parameters) {
+        for (const auto & parameter : parameters) {
+          if (parameter.get_name() == name_) {
+            this->update(parameter);
+          }
+        }
+      });
+    try {
+      ParameterT value = node_parameters_->get_parameter(name_).template get_value<ParameterT>();
+      std::lock_guard<std::mutex> lock(update_mutex_);
+      if (!updated_) {
+        snapshot_.store(std::move(value));
+      }
+    } catch (...) {
+      node_parameters_->remove_post_set_parameters_callback(callback_handle_.get());
+      throw;
+    }
+  }
+
+  ~ParameterHandle()
+  {
+    node_parameters_->remove_post_set_parameters_callback(callback_handle_.get());
+  }
+
+  /// Return the latest value of the parameter, without locking.
+  ValueType
+  get() const
+  {
+    return snapshot_.load();
+  }
+
+  /// Return the name of the parameter.
+  const std::string &
+  get_name() const
+  {
+    return name_;
+  }
+
+private:
+  RCLCPP_DISABLE_COPY(ParameterHandle)
+
+  void
+  update(const rclcpp::Parameter & parameter)
+  {
+    ParameterT value;
+    try {
+      value = parameter.get_value<ParameterT>();
+    } catch (const rclcpp::ParameterTypeException &) {
+      // Dynamically typed parameter whose type changed.
+      return;
+    }
+    std::lock_guard<std::mutex> lock(update_mutex_);
+    snapshot_.store(std::move(value));
+    updated_ = true;
+  }
+
+  rclcpp::node_interfaces::NodeParametersInterface::SharedPtr node_parameters_;
+  const std::string name_;
+  rclcpp::node_interfaces::PostSetParametersCallbackHandle::SharedPtr callback_handle_;
+
+  detail::ParameterSnapshot<ParameterT> snapshot_;
+  /// Serializes the updates with the initialization, the readers don't lock it.
+  std::mutex update_mutex_;
+  bool updated_{false};
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__PARAMETER_HANDLE_HPP_
@@ -60,6 +60,48 @@ RCLCPP_PUBLIC
 ParameterMap
 parameter_map_from_yaml_file(const std::string & yaml_filename, const char * node_fqn = nullptr);
 
+/// Save a ParameterMap to a binary snapshot file.
+/**
+ * The snapshot can be loaded with parameter_map_from_snapshot_file() much faster than
+ * a yaml file is parsed, for example to start again a node with the parameters it
+ * resolved before:
+ *
+ * ```cpp
+ * rclcpp::ParameterMap map;
+ * map[node->get_fully_qualified_name()] =
+ *   node->get_parameters(node->list_parameters({}, 0).names);
+ * rclcpp::parameter_map_to_snapshot_file(map, "node.snapshot");
+ * ...
+ * auto options = rclcpp::NodeOptions().parameter_overrides(
+ *   rclcpp::parameters_from_map(
+ *     rclcpp::parameter_map_from_snapshot_file("node.snapshot"), "/ns/node"));
+ * ```
+ *
+ * The snapshot is written in the byte order of the host, and can only be loaded on
+ * hosts with the same one.
+ * \param[in] parameter_map a parameter map.
+ * \param[in] snapshot_filename full name of the snapshot file, which is overwritten.
+ * \throws InvalidParametersException if the file can't be written.
+ */
+RCLCPP_PUBLIC
+void
+parameter_map_to_snapshot_file(
+  const ParameterMap & parameter_map, const std::string & snapshot_filename);
+
+/// Get the ParameterMap from a binary snapshot file saved by parameter_map_to_snapshot_file().
+/**
+ * The file is memory-mapped where possible, and the values are read from it directly.
+ * \param[in] snapshot_filename full name of the snapshot file.
+ * \param[in] node_fqn a Fully Qualified Name of node, default value is nullptr.
+ *   If it's not nullptr, return the relative node parameters belonging to this node_fqn.
+ * \returns an instance of a parameter map
+ * \throws InvalidParametersException if the file can't be read, or isn't a valid snapshot.
+ */
+RCLCPP_PUBLIC
+ParameterMap
+parameter_map_from_snapshot_file(
+  const std::string & snapshot_filename, const char * node_fqn = nullptr);
+
 /// Get the Parameters from ParameterMap.
 /// \param[in] parameter_map a parameter map.
 /// \param[in] node_fqn a Fully Qualified Name of node, default value is nullptr.
@@ -0,0 +1,141 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__PARAMETER_SERVICE_MULTIPLEXER_HPP_
+#define RCLCPP__PARAMETER_SERVICE_MULTIPLEXER_HPP_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "rcl_interfaces/srv/describe_parameters.hpp"
+#include "rcl_interfaces/srv/get_parameter_types.hpp"
+#include "rcl_interfaces/srv/get_parameters.hpp"
+#include "rcl_interfaces/srv/list_parameters.hpp"
+#include "rcl_interfaces/srv/set_parameters.hpp"
+#include "rcl_interfaces/srv/set_parameters_atomically.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/node_interfaces/node_base_interface.hpp"
+#include "rclcpp/node_interfaces/node_parameters_interface.hpp"
+#include "rclcpp/node_interfaces/node_services_interface.hpp"
+#include "rclcpp/qos.hpp"
+#include "rclcpp/service.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Parameter services serving the parameters of several nodes of a process.
+/**
+ * Instead of the six parameter services of each node, the multiplexer creates one set
+ * of parameter services, with the names of the parameter services of its host node,
+ * and routes the requests to the nodes which are added to it.
+ * The parameters are named after their node in the requests and the responses, as
+ * `<fully qualified node name>:<parameter name>`, see make_parameter_name(), e.g.
+ * `/ns/node:parameter`, so that the usual parameter clients can be used on the host
+ * node, e.g. `rclcpp::SyncParametersClient(node, "/ns/host")`.
+ *
+ * It is meant to be created once per context, with the nodes of the context created
+ * with start_parameter_services(false), including the host node, since the services
+ * of the multiplexer have the same names as its parameter services.
+ * The parameters which aren't named after an added node are handled like undeclared
+ * parameters.
+ * Setting parameters atomically is only supported for the parameters of one node.
+ *
+ * Adding and removing nodes is thread-safe.
+ */
+class ParameterServiceMultiplexer
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(ParameterServiceMultiplexer)
+
+  /// Create the parameter services on the host node.
+  /**
+   * \param[in] node_base base interface of the host node.
+   * \param[in] node_services services interface of the host node.
+   * \param[in] qos_profile quality of service of the parameter services.
+   */
+  RCLCPP_PUBLIC
+  ParameterServiceMultiplexer(
+    const std::shared_ptr<node_interfaces::NodeBaseInterface> node_base,
+    const std::shared_ptr<node_interfaces::NodeServicesInterface> node_services,
+    const rclcpp::QoS & qos_profile = rclcpp::ParametersQoS());
+
+  /// Serve the parameters of a node, until it's removed or destroyed.
+  /**
+   * \param[in] node_base base interface of the node.
+   * \param[in] node_parameters parameters interface of the node.
+   * \throws std::invalid_argument if an interface is nullptr, or if a node with the
+   *   same fully qualified name was already added.
+   */
+  RCLCPP_PUBLIC
+  void
+  add_node(
+    const std::shared_ptr<node_interfaces::NodeBaseInterface> node_base,
+    const std::shared_ptr<node_interfaces::NodeParametersInterface> node_parameters);
+
+  /// Serve the parameters of a node, until it's removed or destroyed.
+  template<typename NodeT>
+  void
+  add_node(NodeT && node)
+  {
+    add_node(node->get_node_base_interface(), node->get_node_parameters_interface());
+  }
+
+  /// Stop serving the parameters of a node.
+  /**
+   * \param[in] fully_qualified_name fully qualified name of the node.
+   * \return true if the node was added.
+   */
+  RCLCPP_PUBLIC
+  bool
+  remove_node(const std::string & fully_qualified_name);
+
+  /// Return the name of a parameter of a node in the requests and responses.
+  RCLCPP_PUBLIC
+  static
+  std::string
+  make_parameter_name(
+    const std::string & fully_qualified_node_name,
+    const std::string & parameter_name);
+
+private:
+  RCLCPP_DISABLE_COPY(ParameterServiceMultiplexer)
+
+  /// Return the parameters interface of the node of a parameter, and its name in the node.
+  /**
+   * \return the parameters interface, or nullptr if the node of the parameter isn't served.
+   */
+  std::shared_ptr<node_interfaces::NodeParametersInterface>
+  resolve(const std::string & name, std::string & node_name, std::string & parameter_name) const;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::weak_ptr<node_interfaces::NodeParametersInterface>> nodes_;
+
+  rclcpp::Service<rcl_interfaces::srv::GetParameters>::SharedPtr get_parameters_service_;
+  rclcpp::Service<rcl_interfaces::srv::GetParameterTypes>::SharedPtr
+    get_parameter_types_service_;
+  rclcpp::Service<rcl_interfaces::srv::SetParameters>::SharedPtr set_parameters_service_;
+  rclcpp::Service<rcl_interfaces::srv::SetParametersAtomically>::SharedPtr
+    set_parameters_atomically_service_;
+  rclcpp::Service<rcl_interfaces::srv::DescribeParameters>::SharedPtr
+    describe_parameters_service_;
+  rclcpp::Service<rcl_interfaces::srv::ListParameters>::SharedPtr list_parameters_service_;
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__PARAMETER_SERVICE_MULTIPLEXER_HPP_
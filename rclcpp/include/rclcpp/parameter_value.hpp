@@ -17,9 +17,11 @@
 
 #include <exception>
 #include <iostream>
+#include <memory>
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <variant>  // NOLINT
 #include <vector>
 
 #include "rcl_interfaces/msg/parameter_type.hpp"
@@ -68,6 +70,11 @@ public:
 };
 
 /// Store the type and value of a parameter.
+/**
+ * The scalar values are stored inline, and the strings and arrays in immutable storage
+ * shared by the copies of the value, so that copying it is cheap whatever its type.
+ * The value is only converted to a message by to_value_msg().
+ */
 class ParameterValue
 {
 public:
@@ -147,10 +154,10 @@ public:
   typename std::enable_if<type == ParameterType::PARAMETER_BOOL, const bool &>::type
   get() const
   {
-    if (value_.type != rcl_interfaces::msg::ParameterType::PARAMETER_BOOL) {
+    if (get_type() != ParameterType::PARAMETER_BOOL) {
       throw ParameterTypeException(ParameterType::PARAMETER_BOOL, get_type());
     }
-    return value_.bool_value;
+    return std::get<ParameterType::PARAMETER_BOOL>(value_);
   }
 
   template<ParameterType type>
@@ -158,10 +165,10 @@ public:
   typename std::enable_if<type == ParameterType::PARAMETER_INTEGER, const int64_t &>::type
   get() const
   {
-    if (value_.type != rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER) {
+    if (get_type() != ParameterType::PARAMETER_INTEGER) {
       throw ParameterTypeException(ParameterType::PARAMETER_INTEGER, get_type());
     }
-    return value_.integer_value;
+    return std::get<ParameterType::PARAMETER_INTEGER>(value_);
   }
 
   template<ParameterType type>
@@ -169,10 +176,10 @@ public:
   typename std::enable_if<type == ParameterType::PARAMETER_DOUBLE, const double &>::type
   get() const
   {
-    if (value_.type != rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE) {
+    if (get_type() != ParameterType::PARAMETER_DOUBLE) {
       throw ParameterTypeException(ParameterType::PARAMETER_DOUBLE, get_type());
     }
-    return value_.double_value;
+    return std::get<ParameterType::PARAMETER_DOUBLE>(value_);
   }
 
   template<ParameterType type>
@@ -180,10 +187,10 @@ public:
   typename std::enable_if<type == ParameterType::PARAMETER_STRING, const std::string &>::type
   get() const
   {
-    if (value_.type != rcl_interfaces::msg::ParameterType::PARAMETER_STRING) {
+    if (get_type() != ParameterType::PARAMETER_STRING) {
       throw ParameterTypeException(ParameterType::PARAMETER_STRING, get_type());
     }
-    return value_.string_value;
+    return *std::get<ParameterType::PARAMETER_STRING>(value_);
   }
 
   template<ParameterType type>
@@ -192,10 +199,10 @@ public:
     type == ParameterType::PARAMETER_BYTE_ARRAY, const std::vector<uint8_t> &>::type
   get() const
   {
-    if (value_.type != rcl_interfaces::msg::ParameterType::PARAMETER_BYTE_ARRAY) {
+    if (get_type() != ParameterType::PARAMETER_BYTE_ARRAY) {
       throw ParameterTypeException(ParameterType::PARAMETER_BYTE_ARRAY, get_type());
     }
-    return value_.byte_array_value;
+    return *std::get<ParameterType::PARAMETER_BYTE_ARRAY>(value_);
   }
 
   template<ParameterType type>
@@ -204,10 +211,10 @@ public:
     type == ParameterType::PARAMETER_BOOL_ARRAY, const std::vector<bool> &>::type
   get() const
   {
-    if (value_.type != rcl_interfaces::msg::ParameterType::PARAMETER_BOOL_ARRAY) {
+    if (get_type() != ParameterType::PARAMETER_BOOL_ARRAY) {
       throw ParameterTypeException(ParameterType::PARAMETER_BOOL_ARRAY, get_type());
     }
-    return value_.bool_array_value;
+    return *std::get<ParameterType::PARAMETER_BOOL_ARRAY>(value_);
   }
 
   template<ParameterType type>
@@ -216,10 +223,10 @@ public:
     type == ParameterType::PARAMETER_INTEGER_ARRAY, const std::vector<int64_t> &>::type
   get() const
   {
-    if (value_.type != rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER_ARRAY) {
+    if (get_type() != ParameterType::PARAMETER_INTEGER_ARRAY) {
       throw ParameterTypeException(ParameterType::PARAMETER_INTEGER_ARRAY, get_type());
     }
-    return value_.integer_array_value;
+    return *std::get<ParameterType::PARAMETER_INTEGER_ARRAY>(value_);
   }
 
   template<ParameterType type>
@@ -228,10 +235,10 @@ public:
     type == ParameterType::PARAMETER_DOUBLE_ARRAY, const std::vector<double> &>::type
   get() const
   {
-    if (value_.type != rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE_ARRAY) {
+    if (get_type() != ParameterType::PARAMETER_DOUBLE_ARRAY) {
       throw ParameterTypeException(ParameterType::PARAMETER_DOUBLE_ARRAY, get_type());
     }
-    return value_.double_array_value;
+    return *std::get<ParameterType::PARAMETER_DOUBLE_ARRAY>(value_);
   }
 
   template<ParameterType type>
@@ -240,10 +247,10 @@ public:
     type == ParameterType::PARAMETER_STRING_ARRAY, const std::vector<std::string> &>::type
   get() const
   {
-    if (value_.type != rcl_interfaces::msg::ParameterType::PARAMETER_STRING_ARRAY) {
+    if (get_type() != ParameterType::PARAMETER_STRING_ARRAY) {
       throw ParameterTypeException(ParameterType::PARAMETER_STRING_ARRAY, get_type());
     }
-    return value_.string_array_value;
+    return *std::get<ParameterType::PARAMETER_STRING_ARRAY>(value_);
   }
 
   // The following get() variants allow the use of primitive types
@@ -352,7 +359,20 @@ public:
   }
 
 private:
-  rcl_interfaces::msg::ParameterValue value_;
+  // The alternatives are in the order of the parameter types, so that the index is the type.
+  using Storage = std::variant<
+    std::monostate,
+    bool,
+    int64_t,
+    double,
+    std::shared_ptr<const std::string>,
+    std::shared_ptr<const std::vector<uint8_t>>,
+    std::shared_ptr<const std::vector<bool>>,
+    std::shared_ptr<const std::vector<int64_t>>,
+    std::shared_ptr<const std::vector<double>>,
+    std::shared_ptr<const std::vector<std::string>>>;
+
+  Storage value_;
 };
 
 /// Return the value of a parameter as a string
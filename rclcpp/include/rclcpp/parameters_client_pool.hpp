@@ -0,0 +1,231 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__PARAMETERS_CLIENT_POOL_HPP_
+#define RCLCPP__PARAMETERS_CLIENT_POOL_HPP_
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "rcl_interfaces/msg/list_parameters_result.hpp"
+#include "rcl_interfaces/msg/parameter_descriptor.hpp"
+#include "rcl_interfaces/msg/set_parameters_result.hpp"
+#include "rcl_interfaces/srv/describe_parameters.hpp"
+#include "rcl_interfaces/srv/get_parameter_types.hpp"
+#include "rcl_interfaces/srv/get_parameters.hpp"
+#include "rcl_interfaces/srv/list_parameters.hpp"
+#include "rcl_interfaces/srv/set_parameters.hpp"
+#include "rcl_interfaces/srv/set_parameters_atomically.hpp"
+#include "rclcpp/callback_group.hpp"
+#include "rclcpp/client.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/node_interfaces/node_base_interface.hpp"
+#include "rclcpp/node_interfaces/node_graph_interface.hpp"
+#include "rclcpp/node_interfaces/node_services_interface.hpp"
+#include "rclcpp/parameter.hpp"
+#include "rclcpp/qos.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Parameter clients of many remote nodes, sharing the node and the executor they're used with.
+/**
+ * Unlike an AsyncParametersClient, which creates the clients of the six parameter services of
+ * its remote node when constructed, the pool only creates the client of a service of a remote
+ * node when a request is first sent to it, and then reuses it.
+ * The clients are added to the given callback group of the node, so the responses are handled
+ * by the executor spinning the node, which completes the returned futures and calls the
+ * callbacks; the pool never spins an executor by itself.
+ *
+ * With many remote nodes this avoids both the clients of the unused services, and the executor
+ * of each SyncParametersClient.
+ * Sending requests and removing remote nodes is thread-safe.
+ */
+class ParametersClientPool
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(ParametersClientPool)
+
+  /// Constructor.
+  /**
+   * \param[in] node_base_interface The node base interface of the node the clients are added to.
+   * \param[in] node_graph_interface The node graph interface of that node.
+   * \param[in] node_services_interface The node services interface of that node.
+   * \param[in] qos_profile (optional) The qos profile of the clients.
+   * \param[in] group (optional) The callback group the clients are added to.
+   */
+  RCLCPP_PUBLIC
+  ParametersClientPool(
+    rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base_interface,
+    rclcpp::node_interfaces::NodeGraphInterface::SharedPtr node_graph_interface,
+    rclcpp::node_interfaces::NodeServicesInterface::SharedPtr node_services_interface,
+    const rclcpp::QoS & qos_profile = rclcpp::ParametersQoS(),
+    rclcpp::CallbackGroup::SharedPtr group = nullptr);
+
+  /// Constructor.
+  /**
+   * \param[in] node The node the clients are added to.
+   * \param[in] qos_profile (optional) The qos profile of the clients.
+   * \param[in] group (optional) The callback group the clients are added to.
+   */
+  template<typename NodeT>
+  explicit ParametersClientPool(
+    const std::shared_ptr<NodeT> & node,
+    const rclcpp::QoS & qos_profile = rclcpp::ParametersQoS(),
+    rclcpp::CallbackGroup::SharedPtr group = nullptr)
+  : ParametersClientPool(
+      node->get_node_base_interface(),
+      node->get_node_graph_interface(),
+      node->get_node_services_interface(),
+      qos_profile,
+      group)
+  {}
+
+  /// Get parameters of a remote node, like AsyncParametersClient::get_parameters().
+  /**
+   * \param[in] remote_node_name Fully qualified name of the remote node.
+   */
+  RCLCPP_PUBLIC
+  std::shared_future<std::vector<rclcpp::Parameter>>
+  get_parameters(
+    const std::string & remote_node_name,
+    const std::vector<std::string> & names,
+    std::function<
+      void(std::shared_future<std::vector<rclcpp::Parameter>>)
+    > callback = nullptr);
+
+  /// Describe parameters of a remote node, like AsyncParametersClient::describe_parameters().
+  RCLCPP_PUBLIC
+  std::shared_future<std::vector<rcl_interfaces::msg::ParameterDescriptor>>
+  describe_parameters(
+    const std::string & remote_node_name,
+    const std::vector<std::string> & names,
+    std::function<
+      void(std::shared_future<std::vector<rcl_interfaces::msg::ParameterDescriptor>>)
+    > callback = nullptr);
+
+  /// Get parameter types of a remote node, like AsyncParametersClient::get_parameter_types().
+  RCLCPP_PUBLIC
+  std::shared_future<std::vector<rclcpp::ParameterType>>
+  get_parameter_types(
+    const std::string & remote_node_name,
+    const std::vector<std::string> & names,
+    std::function<
+      void(std::shared_future<std::vector<rclcpp::ParameterType>>)
+    > callback = nullptr);
+
+  /// Set parameters of a remote node, like AsyncParametersClient::set_parameters().
+  RCLCPP_PUBLIC
+  std::shared_future<std::vector<rcl_interfaces::msg::SetParametersResult>>
+  set_parameters(
+    const std::string & remote_node_name,
+    const std::vector<rclcpp::Parameter> & parameters,
+    std::function<
+      void(std::shared_future<std::vector<rcl_interfaces::msg::SetParametersResult>>)
+    > callback = nullptr);
+
+  /// Set parameters of a remote node atomically.
+  /**
+   * Like AsyncParametersClient::set_parameters_atomically().
+   */
+  RCLCPP_PUBLIC
+  std::shared_future<rcl_interfaces::msg::SetParametersResult>
+  set_parameters_atomically(
+    const std::string & remote_node_name,
+    const std::vector<rclcpp::Parameter> & parameters,
+    std::function<
+      void(std::shared_future<rcl_interfaces::msg::SetParametersResult>)
+    > callback = nullptr);
+
+  /// List parameters of a remote node, like AsyncParametersClient::list_parameters().
+  RCLCPP_PUBLIC
+  std::shared_future<rcl_interfaces::msg::ListParametersResult>
+  list_parameters(
+    const std::string & remote_node_name,
+    const std::vector<std::string> & prefixes,
+    uint64_t depth,
+    std::function<
+      void(std::shared_future<rcl_interfaces::msg::ListParametersResult>)
+    > callback = nullptr);
+
+  /// Remove the clients of a remote node from the pool, which destroys them.
+  /**
+   * The callback group only refers weakly to the clients, so they aren't waited on anymore,
+   * and the futures of their pending requests are never completed.
+   * \return true if the pool had clients of the remote node.
+   */
+  RCLCPP_PUBLIC
+  bool
+  remove(const std::string & remote_node_name);
+
+  /// Return the number of remote nodes the pool has clients of.
+  RCLCPP_PUBLIC
+  size_t
+  size() const;
+
+  /// Return the number of clients created by the pool, for all the remote nodes.
+  RCLCPP_PUBLIC
+  size_t
+  get_number_of_clients() const;
+
+private:
+  RCLCPP_DISABLE_COPY(ParametersClientPool)
+
+  // Clients of a remote node, created on their first request
+  struct RemoteNode
+  {
+    rclcpp::Client<rcl_interfaces::srv::GetParameters>::SharedPtr get_parameters;
+    rclcpp::Client<rcl_interfaces::srv::GetParameterTypes>::SharedPtr get_parameter_types;
+    rclcpp::Client<rcl_interfaces::srv::SetParameters>::SharedPtr set_parameters;
+    rclcpp::Client<rcl_interfaces::srv::SetParametersAtomically>::SharedPtr
+      set_parameters_atomically;
+    rclcpp::Client<rcl_interfaces::srv::ListParameters>::SharedPtr list_parameters;
+    rclcpp::Client<rcl_interfaces::srv::DescribeParameters>::SharedPtr describe_parameters;
+  };
+
+  template<typename ServiceT>
+  typename rclcpp::Client<ServiceT>::SharedPtr
+  get_client(
+    const std::string & remote_node_name,
+    typename rclcpp::Client<ServiceT>::SharedPtr RemoteNode::* client_member,
+    const char * service_name);
+
+  template<typename ServiceT, typename ResultT, typename ConvertT>
+  std::shared_future<ResultT>
+  send_request(
+    const typename rclcpp::Client<ServiceT>::SharedPtr & client,
+    typename ServiceT::Request::SharedPtr request,
+    ConvertT convert,
+    std::function<void(std::shared_future<ResultT>)> callback);
+
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base_interface_;
+  rclcpp::node_interfaces::NodeGraphInterface::SharedPtr node_graph_interface_;
+  rclcpp::node_interfaces::NodeServicesInterface::SharedPtr node_services_interface_;
+  rcl_client_options_t client_options_;
+  rclcpp::CallbackGroup::SharedPtr group_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, RemoteNode> remote_nodes_;
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__PARAMETERS_CLIENT_POOL_HPP_
@@ -18,6 +18,7 @@
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <type_traits>
@@ -31,15 +32,22 @@
 
 #include "rclcpp/allocator/allocator_common.hpp"
 #include "rclcpp/allocator/allocator_deleter.hpp"
+#include "rclcpp/async_publish_writer.hpp"
+#include "rclcpp/detail/async_publish_queue.hpp"
+#include "rclcpp/detail/loaned_message_pool.hpp"
 #include "rclcpp/detail/resolve_use_intra_process.hpp"
 #include "rclcpp/experimental/intra_process_manager.hpp"
 #include "rclcpp/get_message_type_support_handle.hpp"
 #include "rclcpp/is_ros_compatible_type.hpp"
 #include "rclcpp/loaned_message.hpp"
+#include "rclcpp/logging.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/node_interfaces/node_base_interface.hpp"
 #include "rclcpp/publisher_base.hpp"
 #include "rclcpp/publisher_options.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/topic_statistics/publisher_topic_statistics.hpp"
+#include "rclcpp/trace_recorder.hpp"
 #include "rclcpp/type_adapter.hpp"
 #include "rclcpp/type_support_decl.hpp"
 #include "rclcpp/visibility_control.hpp"
@@ -139,8 +147,24 @@ public:
     published_type_allocator_(*options.get_allocator()),
     ros_message_type_allocator_(*options.get_allocator())
   {
+    event_handler_group_ = options.event_handler_group;
     allocator::set_allocator_for_deleter(&published_type_deleter_, &published_type_allocator_);
     allocator::set_allocator_for_deleter(&ros_message_type_deleter_, &ros_message_type_allocator_);
+    if (options.loaned_message_pool_size > 0 && !this->can_loan_messages()) {
+      loaned_message_pool_ = std::make_shared<rclcpp::detail::LoanedMessagePool<ROSMessageType>>(
+        options.loaned_message_pool_size);
+    }
+    // The messages published before are received by the late subscriptions otherwise.
+    skip_publish_without_subscriptions_ = options.skip_publish_without_subscriptions &&
+      this->get_actual_qos().durability() == rclcpp::DurabilityPolicy::Volatile;
+    if (options.async_publish_writer) {
+      // The queue is removed from the writer by the destructor, before the publisher is gone.
+      async_publish_queue_ = std::make_shared<AsyncPublishQueue>(
+        options.async_publish_queue_size,
+        [this](const ROSMessageType & msg) {this->do_middleware_publish(msg);});
+      async_publish_writer_ = options.async_publish_writer;
+      async_publish_writer_->add_queue(async_publish_queue_);
+    }
     // Setup continues in the post construction method, post_init_setup().
   }
 
@@ -161,7 +185,7 @@ public:
     if (rclcpp::detail::resolve_use_intra_process(options_, *node_base)) {
       auto context = node_base->get_context();
       // Get the intra process manager instance for this context.
-      auto ipm = context->get_sub_context<rclcpp::experimental::IntraProcessManager>();
+      auto ipm = rclcpp::experimental::get_intra_process_manager(*context);
       // Register the publisher with the intra process manager.
       if (qos.history() != rclcpp::HistoryPolicy::KeepLast) {
         throw std::invalid_argument(
@@ -171,10 +195,6 @@ public:
         throw std::invalid_argument(
                 "intraprocess communication is not allowed with a zero qos history depth value");
       }
-      if (qos.durability() != rclcpp::DurabilityPolicy::Volatile) {
-        throw std::invalid_argument(
-                "intraprocess communication allowed only with volatile durability");
-      }
       uint64_t intra_process_publisher_id = ipm->add_publisher(this->shared_from_this());
       this->setup_intra_process(
         intra_process_publisher_id,
@@ -183,13 +203,28 @@ public:
   }
 
   virtual ~Publisher()
-  {}
+  {
+    if (async_publish_writer_) {
+      async_publish_writer_->remove_queue(async_publish_queue_.get());
+      // The messages still queued are published before the publisher is gone.
+      try {
+        async_publish_queue_->publish_queued();
+      } catch (const std::exception & exception) {
+        RCLCPP_ERROR(
+          rclcpp::get_logger("rclcpp"),
+          "failed to publish the queued messages of the publisher on topic '%s': %s",
+          this->get_topic_name(), exception.what());
+      }
+    }
+  }
 
   /// Borrow a loaned ROS message from the middleware.
   /**
    * If the middleware is capable of loaning memory for a ROS message instance,
    * the loaned message will be directly allocated in the middleware.
-   * If not, the message allocator of this rclcpp::Publisher instance is being used.
+   * If not, the messages of the pool sized by PublisherOptions::loaned_message_pool_size are
+   * used, and once they are all loaned the message allocator of this rclcpp::Publisher
+   * instance is being used.
    *
    * With a call to \sa `publish` the LoanedMessage instance is being returned to the middleware
    * or free'd accordingly to the allocator.
@@ -205,7 +240,24 @@ public:
   {
     return rclcpp::LoanedMessage<ROSMessageType, AllocatorT>(
       *this,
-      this->get_ros_message_type_allocator());
+      this->get_ros_message_type_allocator(),
+      loaned_message_pool_);
+  }
+
+  /// Return a message allocated with the allocator of the publisher, to be published.
+  /**
+   * Publishing it with publish(std::unique_ptr<T, ROSMessageTypeDeleter>) hands it over
+   * to the intra-process subscriptions, which release it with the same allocator.
+   * With a rclcpp::allocator::RecyclingAllocator, the message is taken from its pool, with
+   * the contents it had when it was released, and given back to the pool by the last
+   * subscription, so that publishing doesn't allocate messages in steady state.
+   *
+   * \return the message, default constructed unless the allocator recycles it.
+   */
+  std::unique_ptr<ROSMessageType, ROSMessageTypeDeleter>
+  borrow_message()
+  {
+    return create_ros_message_unique_ptr();
   }
 
   /// Publish a message on the topic.
@@ -226,7 +278,14 @@ public:
   >
   publish(std::unique_ptr<T, ROSMessageTypeDeleter> msg)
   {
+    if (this->skip_publish()) {
+      return;
+    }
+    topic_statistics::PublishMeasurement measurement(publisher_topic_statistics_.get());
     if (!intra_process_is_enabled_) {
+      if (async_publish_queue_) {
+        return this->queue_for_async_publish(std::move(msg));
+      }
       this->do_inter_process_publish(*msg);
       return;
     }
@@ -242,6 +301,9 @@ public:
     if (inter_process_publish_needed) {
       auto shared_msg =
         this->do_intra_process_ros_message_publish_and_return_shared(std::move(msg));
+      if (async_publish_queue_) {
+        return this->queue_for_async_publish(std::move(shared_msg));
+      }
       this->do_inter_process_publish(*shared_msg);
     } else {
       this->do_intra_process_ros_message_publish(std::move(msg));
@@ -267,6 +329,10 @@ public:
   >
   publish(const T & msg)
   {
+    if (this->skip_publish()) {
+      return;
+    }
+    topic_statistics::PublishMeasurement measurement(publisher_topic_statistics_.get());
     // Avoid allocating when not using intra process.
     if (!intra_process_is_enabled_) {
       // In this case we're not using intra process.
@@ -297,17 +363,42 @@ public:
   >
   publish(std::unique_ptr<T, PublishedTypeDeleter> msg)
   {
+    if (this->skip_publish()) {
+      return;
+    }
+    topic_statistics::PublishMeasurement measurement(publisher_topic_statistics_.get());
     // Avoid allocating when not using intra process.
     if (!intra_process_is_enabled_) {
       // In this case we're not using intra process.
-      ROSMessageType ros_msg;
-      rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(*msg, ros_msg);
-      return this->do_inter_process_publish(ros_msg);
+      return this->do_type_adapted_inter_process_publish(*msg);
     }
 
     bool inter_process_publish_needed =
       get_subscription_count() > get_intra_process_subscription_count();
 
+    if (inter_process_publish_needed && this->can_publish_type_adapted_into_loan()) {
+      // The message is converted before its ownership is given to the intra-process manager.
+      auto loaned_msg = this->borrow_loaned_message();
+      rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(*msg, loaned_msg.get());
+      this->do_intra_process_publish(std::move(msg));
+      this->do_loaned_message_publish(loaned_msg.release());
+      return;
+    }
+
+    if constexpr (rclcpp::detail::has_convert_to_serialized_message<
+        rclcpp::TypeAdapter<MessageT>>::value)
+    {
+      if (inter_process_publish_needed) {
+        // The message is serialized before its ownership is given to the intra-process manager.
+        std::lock_guard<std::mutex> lock(serialized_message_mutex_);
+        rclcpp::TypeAdapter<MessageT>::convert_to_serialized_message(*msg, serialized_message_);
+        this->do_intra_process_publish(std::move(msg));
+        this->do_serialized_inter_process_publish(
+          &serialized_message_.get_rcl_serialized_message());
+        return;
+      }
+    }
+
     if (inter_process_publish_needed) {
       ROSMessageType ros_msg;
       // TODO(clalancette): This is unnecessarily doing an additional conversion
@@ -339,13 +430,14 @@ public:
   >
   publish(const T & msg)
   {
+    if (this->skip_publish()) {
+      return;
+    }
+    topic_statistics::PublishMeasurement measurement(publisher_topic_statistics_.get());
     // Avoid double allocating when not using intra process.
     if (!intra_process_is_enabled_) {
-      // Convert to the ROS message equivalent and publish it.
-      ROSMessageType ros_msg;
-      rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(msg, ros_msg);
       // In this case we're not using intra process.
-      return this->do_inter_process_publish(ros_msg);
+      return this->do_type_adapted_inter_process_publish(msg);
     }
 
     // Otherwise we have to allocate memory in a unique_ptr and pass it along.
@@ -355,6 +447,11 @@ public:
     this->publish(std::move(unique_msg));
   }
 
+  /// Publish a serialized message, whose buffer may be owned by anything.
+  /**
+   * The buffer is only read while publishing, without being copied, so it may for example
+   * be a record of a memory-mapped file.
+   */
   void
   publish(const rcl_serialized_message_t & serialized_msg)
   {
@@ -373,6 +470,12 @@ public:
    * after being published.
    * The instance of the loaned message is no longer valid after this call.
    *
+   * With intra process enabled, the messages allocated by the publisher are given to the
+   * intra-process subscriptions without a copy, like with publish(std::unique_ptr).
+   * The messages loaned by the middleware or taken from the pool of the publisher have
+   * to be returned to them, so the intra-process subscriptions are given a copy, while
+   * the loans of the middleware are still published without one.
+   *
    * \param loaned_msg The LoanedMessage instance to be published.
    */
   void
@@ -381,9 +484,27 @@ public:
     if (!loaned_msg.is_valid()) {
       throw std::runtime_error("loaned message is not valid");
     }
+    if (intra_process_is_enabled_ && !this->can_loan_messages() &&
+      !(loaned_message_pool_ && loaned_message_pool_->owns(&loaned_msg.get())))
+    {
+      // Allocated like the messages of the publisher, so it's owned by the unique_ptr.
+      auto msg = loaned_msg.release();
+      this->publish(
+        std::unique_ptr<ROSMessageType, ROSMessageTypeDeleter>(
+          msg.release(), ros_message_type_deleter_));
+      return;
+    }
+    topic_statistics::PublishMeasurement measurement(publisher_topic_statistics_.get());
+
     if (intra_process_is_enabled_) {
-      // TODO(Karsten1987): support loaned message passed by intraprocess
-      throw std::runtime_error("storing loaned messages in intra process is not supported yet");
+      if (get_intra_process_subscription_count() > 0) {
+        this->do_intra_process_ros_message_publish(
+          this->duplicate_ros_message_as_unique_ptr(loaned_msg.get()));
+      }
+      if (get_subscription_count() <= get_intra_process_subscription_count()) {
+        // The destructor of the rclcpp::LoanedMessage instance returns the message.
+        return;
+      }
     }
 
     // verify that publisher supports loaned messages
@@ -402,6 +523,20 @@ public:
     }
   }
 
+  /// Get the occupancy of the queue of the messages published by the async publish writer.
+  /**
+   * \sa PublisherOptionsBase::async_publish_writer
+   * \return the counters of the queue, all zero if the messages are published right away.
+   */
+  rclcpp::experimental::buffers::BufferCounters
+  get_async_publish_queue_counters() const
+  {
+    if (!async_publish_queue_) {
+      return rclcpp::experimental::buffers::BufferCounters();
+    }
+    return async_publish_queue_->get_counters();
+  }
+
   [[deprecated("use get_published_type_allocator() or get_ros_message_type_allocator() instead")]]
   std::shared_ptr<PublishedTypeAllocator>
   get_allocator() const
@@ -422,8 +557,34 @@ public:
   }
 
 protected:
+  /// Return true if the message mustn't be published, since no subscription would receive it.
+  bool
+  skip_publish() const
+  {
+    return this->skip_publish_without_subscriptions_ && !this->has_subscriptions();
+  }
+
   void
   do_inter_process_publish(const ROSMessageType & msg)
+  {
+    if (async_publish_queue_) {
+      // The writer publishes it after it's gone, so it's copied.
+      return this->queue_for_async_publish(this->duplicate_ros_message_as_unique_ptr(msg));
+    }
+    this->do_middleware_publish(msg);
+  }
+
+  /// Queue a message published to the middleware by the async publish writer.
+  template<typename MessagePtrT>
+  void
+  queue_for_async_publish(MessagePtrT msg)
+  {
+    async_publish_queue_->push(std::move(msg));
+    async_publish_writer_->notify();
+  }
+
+  void
+  do_middleware_publish(const ROSMessageType & msg)
   {
     TRACEPOINT(rclcpp_publish, nullptr, static_cast<const void *>(&msg));
     auto status = rcl_publish(publisher_handle_.get(), &msg, nullptr);
@@ -441,6 +602,10 @@ protected:
     if (RCL_RET_OK != status) {
       rclcpp::exceptions::throw_from_rcl_error(status, "failed to publish message");
     }
+    RCLCPP_TRACE_RECORD(Publish, this, this->get_topic_name());
+    if (publisher_topic_statistics_) {
+      publisher_topic_statistics_->handle_inter_process_publish();
+    }
   }
 
   void
@@ -450,10 +615,67 @@ protected:
       // TODO(Karsten1987): support serialized message passed by intraprocess
       throw std::runtime_error("storing serialized messages in intra process is not supported yet");
     }
+    if (this->skip_publish()) {
+      return;
+    }
+    topic_statistics::PublishMeasurement measurement(publisher_topic_statistics_.get());
+    this->do_serialized_inter_process_publish(serialized_msg);
+  }
+
+  void
+  do_serialized_inter_process_publish(const rcl_serialized_message_t * serialized_msg)
+  {
     auto status = rcl_publish_serialized_message(publisher_handle_.get(), serialized_msg, nullptr);
     if (RCL_RET_OK != status) {
       rclcpp::exceptions::throw_from_rcl_error(status, "failed to publish serialized message");
     }
+    RCLCPP_TRACE_RECORD(Publish, this, this->get_topic_name());
+    if (publisher_topic_statistics_) {
+      publisher_topic_statistics_->handle_inter_process_publish(serialized_msg->buffer_length);
+    }
+  }
+
+  /// Whether a custom type is converted directly into a message loaned by the middleware.
+  /**
+   * The messages queued for the async publish writer are copied anyway, so they don't use
+   * the loans of the middleware.
+   */
+  bool
+  can_publish_type_adapted_into_loan() const
+  {
+    return !async_publish_queue_ && this->can_loan_messages();
+  }
+
+  /// Publish a custom type to the middleware, without copying it after its conversion.
+  /**
+   * When the middleware can loan messages, the custom type is converted into a loaned
+   * ROS message, which is published without a copy.
+   * Otherwise it's serialized directly if the adapter can, or converted into a ROS message
+   * which the middleware copies.
+   */
+  void
+  do_type_adapted_inter_process_publish(const PublishedType & msg)
+  {
+    if (this->can_publish_type_adapted_into_loan()) {
+      // The destructor of the rclcpp::LoanedMessage returns the loan if the conversion throws.
+      auto loaned_msg = this->borrow_loaned_message();
+      rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(msg, loaned_msg.get());
+      this->do_loaned_message_publish(loaned_msg.release());
+      return;
+    }
+    if constexpr (rclcpp::detail::has_convert_to_serialized_message<
+        rclcpp::TypeAdapter<MessageT>>::value)
+    {
+      // The serialized message is reused, so that its buffer is only allocated once.
+      std::lock_guard<std::mutex> lock(serialized_message_mutex_);
+      rclcpp::TypeAdapter<MessageT>::convert_to_serialized_message(msg, serialized_message_);
+      this->do_serialized_inter_process_publish(
+        &serialized_message_.get_rcl_serialized_message());
+    } else {
+      ROSMessageType ros_msg;
+      rclcpp::TypeAdapter<MessageT>::convert_to_ros_message(msg, ros_msg);
+      this->do_inter_process_publish(ros_msg);
+    }
   }
 
   void
@@ -475,6 +697,10 @@ protected:
     if (RCL_RET_OK != status) {
       rclcpp::exceptions::throw_from_rcl_error(status, "failed to publish message");
     }
+    RCLCPP_TRACE_RECORD(Publish, this, this->get_topic_name());
+    if (publisher_topic_statistics_) {
+      publisher_topic_statistics_->handle_inter_process_publish();
+    }
   }
 
   void
@@ -493,6 +719,11 @@ protected:
       intra_process_publisher_id_,
       std::move(msg),
       published_type_allocator_);
+    this->intra_process_publish_counters_.record(sizeof(PublishedType));
+    RCLCPP_TRACE_RECORD(Publish, this, this->get_topic_name());
+    if (publisher_topic_statistics_) {
+      publisher_topic_statistics_->handle_intra_process_publish();
+    }
   }
 
   void
@@ -511,6 +742,11 @@ protected:
       intra_process_publisher_id_,
       std::move(msg),
       ros_message_type_allocator_);
+    this->intra_process_publish_counters_.record(sizeof(ROSMessageType));
+    RCLCPP_TRACE_RECORD(Publish, this, this->get_topic_name());
+    if (publisher_topic_statistics_) {
+      publisher_topic_statistics_->handle_intra_process_publish();
+    }
   }
 
   std::shared_ptr<const ROSMessageType>
@@ -526,11 +762,17 @@ protected:
       throw std::runtime_error("cannot publish msg which is a null pointer");
     }
 
-    return ipm->template do_intra_process_publish_and_return_shared<ROSMessageType, ROSMessageType,
-             AllocatorT>(
+    auto shared_msg = ipm->template do_intra_process_publish_and_return_shared<ROSMessageType,
+        ROSMessageType, AllocatorT>(
       intra_process_publisher_id_,
       std::move(msg),
       ros_message_type_allocator_);
+    this->intra_process_publish_counters_.record(sizeof(ROSMessageType));
+    RCLCPP_TRACE_RECORD(Publish, this, this->get_topic_name());
+    if (publisher_topic_statistics_) {
+      publisher_topic_statistics_->handle_intra_process_publish();
+    }
+    return shared_msg;
   }
 
 
@@ -572,6 +814,20 @@ protected:
   PublishedTypeDeleter published_type_deleter_;
   ROSMessageTypeAllocator ros_message_type_allocator_;
   ROSMessageTypeDeleter ros_message_type_deleter_;
+
+  /// Messages loaned when the middleware can't loan messages, null if there is no pool.
+  typename rclcpp::detail::LoanedMessagePool<ROSMessageType>::SharedPtr loaned_message_pool_;
+
+  using AsyncPublishQueue =
+    rclcpp::detail::AsyncPublishQueue<ROSMessageType, ROSMessageTypeDeleter>;
+
+  /// Messages published by the async publish writer, null if they're published right away.
+  typename AsyncPublishQueue::SharedPtr async_publish_queue_;
+  rclcpp::AsyncPublishWriter::SharedPtr async_publish_writer_;
+
+  /// Buffer of the custom types serialized by their TypeAdapter, unused otherwise.
+  std::mutex serialized_message_mutex_;
+  rclcpp::SerializedMessage serialized_message_;
 };
 
 }  // namespace rclcpp
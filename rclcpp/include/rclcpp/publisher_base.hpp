@@ -30,6 +30,7 @@
 
 #include "rcl/publisher.h"
 
+#include "rclcpp/intra_process_counters.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/network_flow_endpoint.hpp"
 #include "rclcpp/qos.hpp"
@@ -57,6 +58,13 @@ namespace experimental
 class IntraProcessManager;
 }  // namespace experimental
 
+class QOSEventHandlerGroup;
+
+namespace topic_statistics
+{
+class PublisherTopicStatistics;
+}  // namespace topic_statistics
+
 class PublisherBase : public std::enable_shared_from_this<PublisherBase>
 {
   friend ::rclcpp::node_interfaces::NodeTopicsInterface;
@@ -127,6 +135,12 @@ public:
   std::unordered_map<rcl_publisher_event_type_t, std::shared_ptr<rclcpp::QOSEventHandlerBase>> &
   get_event_handlers() const;
 
+  /// Get the group the QoS event handlers are added to, if any.
+  /** \return The group given with the options, or nullptr. */
+  RCLCPP_PUBLIC
+  std::shared_ptr<rclcpp::QOSEventHandlerGroup>
+  get_event_handler_group() const;
+
   /// Get subscription count
   /** \return The number of subscriptions. */
   RCLCPP_PUBLIC
@@ -139,6 +153,26 @@ public:
   size_t
   get_intra_process_subscription_count() const;
 
+  /// Return true if a subscription is matched, intra-process or by the middleware.
+  /**
+   * The intra-process subscriptions are checked first, since they are known without
+   * asking the middleware, so this is cheaper than getting the subscription count.
+   * It can be used to skip building messages nobody would receive.
+   */
+  RCLCPP_PUBLIC
+  bool
+  has_subscriptions() const;
+
+  /// Return the messages published within the process since the publisher was created.
+  RCLCPP_PUBLIC
+  rclcpp::IntraProcessCounters
+  get_intra_process_publish_counters() const;
+
+  /// Return the rcl handle of the node the publisher was created by.
+  RCLCPP_PUBLIC
+  std::shared_ptr<const rcl_node_t>
+  get_rcl_node_handle() const;
+
   /// Manually assert that this Publisher is alive (for RMW_QOS_POLICY_LIVELINESS_MANUAL_BY_TOPIC).
   /**
    * If the rmw Liveliness policy is set to RMW_QOS_POLICY_LIVELINESS_MANUAL_BY_TOPIC, the creator
@@ -215,6 +249,16 @@ public:
   std::vector<rclcpp::NetworkFlowEndpoint>
   get_network_flow_endpoints() const;
 
+  /// Set the statistics measuring the publications, or nullptr to stop measuring them.
+  /**
+   * This mustn't be called while messages are published.
+   * It's called by rclcpp::create_publisher() when topic statistics are enabled.
+   */
+  RCLCPP_PUBLIC
+  void
+  set_topic_statistics(
+    std::shared_ptr<rclcpp::topic_statistics::PublisherTopicStatistics> topic_statistics);
+
   /// Wait until all published messages are acknowledged or until the specified timeout elapses.
   /**
    * This method waits until all published messages are acknowledged by all matching
@@ -345,12 +389,17 @@ protected:
 
   std::unordered_map<rcl_publisher_event_type_t,
     std::shared_ptr<rclcpp::QOSEventHandlerBase>> event_handlers_;
+  std::shared_ptr<rclcpp::QOSEventHandlerGroup> event_handler_group_;
 
   using IntraProcessManagerWeakPtr =
     std::weak_ptr<rclcpp::experimental::IntraProcessManager>;
   bool intra_process_is_enabled_;
   IntraProcessManagerWeakPtr weak_ipm_;
+  bool skip_publish_without_subscriptions_ = false;
   uint64_t intra_process_publisher_id_;
+  rclcpp::detail::AtomicIntraProcessCounters intra_process_publish_counters_;
+
+  std::shared_ptr<rclcpp::topic_statistics::PublisherTopicStatistics> publisher_topic_statistics_;
 
   rmw_gid_t rmw_gid_;
 
@@ -15,6 +15,7 @@
 #ifndef RCLCPP__PUBLISHER_OPTIONS_HPP_
 #define RCLCPP__PUBLISHER_OPTIONS_HPP_
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -28,11 +29,14 @@
 #include "rclcpp/qos.hpp"
 #include "rclcpp/qos_event.hpp"
 #include "rclcpp/qos_overriding_options.hpp"
+#include "rclcpp/topic_statistics_state.hpp"
 
 namespace rclcpp
 {
 
+class AsyncPublishWriter;
 class CallbackGroup;
+class QOSEventHandlerGroup;
 
 /// Non-templated part of PublisherOptionsWithAllocator<Allocator>.
 struct PublisherOptionsBase
@@ -46,6 +50,14 @@ struct PublisherOptionsBase
   /// Whether or not to use default callbacks when user doesn't supply any in event_callbacks
   bool use_default_callbacks = true;
 
+  /// Group the QoS event handlers are added to, instead of being waited on individually.
+  /**
+   * The group must be added to a callback group of the node, and then the callback group
+   * of the publisher isn't used for its events.
+   * \sa rclcpp::QOSEventHandlerGroup
+   */
+  std::shared_ptr<rclcpp::QOSEventHandlerGroup> event_handler_group = nullptr;
+
   /// Require middleware to generate unique network flow endpoints
   /// Disabled by default
   rmw_unique_network_flow_endpoints_requirement_t require_unique_network_flow_endpoints =
@@ -59,6 +71,65 @@ struct PublisherOptionsBase
   rmw_implementation_payload = nullptr;
 
   QosOverridingOptions qos_overriding_options;
+
+  /// Number of messages preallocated for borrow_loaned_message(), 0 to disable it.
+  /**
+   * When the middleware can't loan messages, the messages returned by
+   * Publisher::borrow_loaned_message() are taken from a pool of this size,
+   * and once it is empty allocated with the allocator of the publisher.
+   * Messages returned to the pool are reset to default constructed messages.
+   * The pool isn't created if the middleware can loan messages.
+   */
+  size_t loaned_message_pool_size = 0;
+
+  /// Whether the messages are dropped right away when no subscription is matched.
+  /**
+   * Publisher::publish() then returns before converting the messages of a TypeAdapter,
+   * copying them for intra-process communication, or calling rcl_publish().
+   * It's ignored for non volatile durabilities, for which the messages published before
+   * are received by the subscriptions matched later.
+   * \sa PublisherBase::has_subscriptions()
+   */
+  bool skip_publish_without_subscriptions = false;
+
+  /// Thread publishing the messages to the middleware, instead of the one calling publish().
+  /**
+   * When set, Publisher::publish() queues the messages in a lock-free queue of
+   * async_publish_queue_size messages, dropping the oldest one when it's full, and the
+   * writer calls rcl_publish() for them, which bounds the cost of publishing from
+   * real-time threads.
+   * The intra-process subscriptions still receive the messages right away.
+   * The messages given by reference are copied, so publishing messages returned by
+   * Publisher::borrow_message() avoids allocating for them.
+   * The serialized messages, and the messages loaned by the middleware, are still published
+   * right away.
+   * \sa rclcpp::AsyncPublishWriter
+   */
+  std::shared_ptr<rclcpp::AsyncPublishWriter> async_publish_writer = nullptr;
+
+  /// Maximum number of messages queued for the async publish writer.
+  size_t async_publish_queue_size = 16;
+
+  // Options to configure topic statistics collector in the publisher.
+  struct TopicStatisticsOptions
+  {
+    // Enable and disable topic statistics calculation and publication. Defaults to disabled,
+    // so that enabling the statistics of the node only enables those of the subscriptions.
+    TopicStatisticsState state = TopicStatisticsState::Disable;
+
+    // Topic to which topic statistics get published when enabled. Defaults to /statistics.
+    std::string publish_topic = "/statistics";
+
+    // Topic statistics publication period in ms. Defaults to one second.
+    // Only values greater than zero are allowed.
+    std::chrono::milliseconds publish_period{std::chrono::seconds(1)};
+  };
+
+  /// Options of the statistics of the publications and their durations.
+  /**
+   * \sa rclcpp::topic_statistics::PublisherTopicStatistics
+   */
+  TopicStatisticsOptions topic_stats_options;
 };
 
 /// Structure containing optional configuration for Publishers.
@@ -29,6 +29,7 @@
 #include "rcutils/logging_macros.h"
 
 #include "rclcpp/detail/cpp_callback_trampoline.hpp"
+#include "rclcpp/detail/taken_data_slot.hpp"
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/function_traits.hpp"
 #include "rclcpp/logging.hpp"
@@ -257,7 +258,7 @@ public:
         "Couldn't take event info: %s", rcl_get_error_string().str);
       return nullptr;
     }
-    return std::static_pointer_cast<void>(std::make_shared<EventCallbackInfoT>(callback_info));
+    return taken_data_slot_.make(callback_info);
   }
 
   std::shared_ptr<void>
@@ -285,6 +286,8 @@ private:
 
   ParentHandleT parent_handle_;
   EventCallbackT event_callback_;
+  // The event taken is given to execute() without allocating
+  rclcpp::detail::TakenDataSlot<EventCallbackInfoT> taken_data_slot_;
 };
 
 }  // namespace rclcpp
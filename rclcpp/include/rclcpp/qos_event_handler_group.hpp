@@ -0,0 +1,168 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__QOS_EVENT_HANDLER_GROUP_HPP_
+#define RCLCPP__QOS_EVENT_HANDLER_GROUP_HPP_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "rclcpp/context.hpp"
+#include "rclcpp/contexts/default_context.hpp"
+#include "rclcpp/guard_condition.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/qos_event.hpp"
+#include "rclcpp/visibility_control.hpp"
+#include "rclcpp/waitable.hpp"
+
+namespace rclcpp
+{
+
+/// Waitable grouping QoS event handlers, so that they add a single entity to the wait sets.
+/**
+ * Instead of adding the rcl event of each handler to the wait set, the group only adds
+ * one guard condition.
+ * The handlers report their events with their on ready callbacks, which the group sets,
+ * and it executes these events one at a time, in order, with the callback of each handler.
+ *
+ * The group is given to the publishers and subscriptions with their options, and must be
+ * added once to a callback group of their node, for example:
+ *
+ * ```cpp
+ * auto group = std::make_shared<rclcpp::QOSEventHandlerGroup>(context);
+ * node->get_node_waitables_interface()->add_waitable(group, nullptr);
+ * rclcpp::SubscriptionOptions options;
+ * options.event_handler_group = group;
+ * auto subscription = node->create_subscription<MessageT>("topic", 10, callback, options);
+ * ```
+ *
+ * The group doesn't keep its handlers alive, they are removed when their publisher or
+ * subscription is destroyed.
+ * It uses the on ready callbacks of its handlers, so it can't be used with an executor
+ * calling them, nor with set_on_new_qos_event_callback(), and it has no on ready callback
+ * itself.
+ * Adding and removing handlers is thread-safe.
+ */
+class QOSEventHandlerGroup : public Waitable
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(QOSEventHandlerGroup)
+
+  /// Constructor.
+  /**
+   * \param[in] context context of the publishers and subscriptions of the handlers.
+   */
+  RCLCPP_PUBLIC
+  explicit QOSEventHandlerGroup(
+    rclcpp::Context::SharedPtr context = rclcpp::contexts::get_global_default_context());
+
+  RCLCPP_PUBLIC
+  ~QOSEventHandlerGroup() override;
+
+  /// Add a QoS event handler to the group.
+  /**
+   * \param[in] handler handler, which mustn't be added to a callback group by itself.
+   * \throws std::invalid_argument if the handler is null or already in the group.
+   */
+  RCLCPP_PUBLIC
+  void
+  add(const std::shared_ptr<QOSEventHandlerBase> & handler);
+
+  /// Remove a QoS event handler from the group, discarding its pending events.
+  /**
+   * \return true if the handler was in the group.
+   */
+  RCLCPP_PUBLIC
+  bool
+  remove(const std::shared_ptr<QOSEventHandlerBase> & handler);
+
+  /// Return the number of handlers in the group, including the destroyed ones not removed yet.
+  RCLCPP_PUBLIC
+  size_t
+  size() const;
+
+  // -------------
+  // Waitables API
+
+  /// \internal
+  RCLCPP_PUBLIC
+  size_t
+  get_number_of_ready_guard_conditions() override;
+
+  /// Add the guard condition of the group to a wait set.
+  /// \internal
+  RCLCPP_PUBLIC
+  void
+  add_to_wait_set(rcl_wait_set_t * wait_set) override;
+
+  /// Return true if a handler of the group has an event.
+  /// \internal
+  RCLCPP_PUBLIC
+  bool
+  is_ready(rcl_wait_set_t * wait_set) override;
+
+  /// Take the oldest event of the handlers.
+  /// \internal
+  RCLCPP_PUBLIC
+  std::shared_ptr<void>
+  take_data() override;
+
+  /// \internal
+  RCLCPP_PUBLIC
+  std::shared_ptr<void>
+  take_data_by_entity_id(size_t id) override;
+
+  /// Execute the event taken by take_data() with the handler it belongs to.
+  /// \internal
+  RCLCPP_PUBLIC
+  void
+  execute(std::shared_ptr<void> & data) override;
+
+  // End Waitables API
+  // -----------------
+
+private:
+  RCLCPP_DISABLE_COPY(QOSEventHandlerGroup)
+
+  // Events of a handler, in the order they were reported
+  struct ReadyHandler
+  {
+    uint64_t member_id;
+    size_t number_of_events;
+  };
+
+  struct TakenData
+  {
+    std::shared_ptr<QOSEventHandlerBase> handler;
+    std::shared_ptr<void> data;
+  };
+
+  void
+  on_ready(uint64_t member_id, size_t number_of_events);
+
+  rclcpp::GuardCondition gc_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<uint64_t, std::weak_ptr<QOSEventHandlerBase>> members_;
+  uint64_t next_member_id_ = 0;
+  std::deque<ReadyHandler> ready_handlers_;
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__QOS_EVENT_HANDLER_GROUP_HPP_
@@ -70,6 +70,8 @@ class QosParameters;
  * - An optional callback, that will be called to validate the final qos profile.
  * - An optional id. In the case that different qos are desired for two publishers/subscriptions in
  *   the same topic, this id will allow disambiguating them.
+ * - Whether the parameters are declared, so that they can be listed, or only read from the
+ *   parameter overrides of the node, which is faster when a node has many topics.
  *
  * Example parameter file:
  *
@@ -129,6 +131,24 @@ public:
   const QosCallback &
   get_validation_callback() const;
 
+  /// Set whether the parameters of the policies are declared, which is the default.
+  /**
+   * If not, the overrides of the policies are read from the parameter overrides of the node,
+   * or from the parameters if they were already declared, with the same semantics.
+   * No parameter is declared, so creating the entity sends no parameter event, but the
+   * policies of the entity can't be listed with the parameters of the node.
+   *
+   * \param declare_parameters true to declare the parameters.
+   * \return a reference to these options.
+   */
+  RCLCPP_PUBLIC
+  QosOverridingOptions &
+  declare_parameters(bool declare_parameters);
+
+  RCLCPP_PUBLIC
+  bool
+  get_declare_parameters() const;
+
   /// Construct passing a list of QoS policies and a verification callback.
   /**
    * Same as `QosOverridingOptions` constructor, but only declares the default policies:
@@ -147,6 +167,8 @@ private:
   std::vector<QosPolicyKind> policy_kinds_;
   /// \internal Validation callback that will be called to verify the profile.
   QosCallback validation_callback_;
+  /// \internal Whether the parameters are declared, or only read from the overrides.
+  bool declare_parameters_ = true;
 };
 
 }  // namespace rclcpp
@@ -19,7 +19,11 @@
 #include <memory>
 #include <thread>
 
+#include "rclcpp/clock.hpp"
+#include "rclcpp/context.hpp"
+#include "rclcpp/duration.hpp"
 #include "rclcpp/macros.hpp"
+#include "rclcpp/time.hpp"
 #include "rclcpp/utilities.hpp"
 #include "rclcpp/visibility_control.hpp"
 
@@ -115,6 +119,123 @@ private:
 using Rate = GenericRate<std::chrono::system_clock>;
 using WallRate = GenericRate<std::chrono::steady_clock>;
 
+/// Rate sleeping until absolute deadlines of a rclcpp::Clock.
+/**
+ * The deadlines are the ones of a fixed period from the construction or the
+ * last reset(), so that the jitter of the wake ups doesn't accumulate.
+ *
+ * With a steady clock on Linux, the sleep is done with clock_nanosleep() on
+ * CLOCK_MONOTONIC with an absolute deadline, the time of the steady clock of rcl.
+ * Otherwise it is done with rclcpp::Clock::sleep_until(), so that, with a ROS
+ * clock, the same loop follows the simulated time when it is used.
+ *
+ * Statistics on the lateness, the time between a deadline and the return of
+ * sleep(), are kept, as well as the number of overruns, which are the calls to
+ * sleep() made after the deadline.
+ */
+class DeadlineRate : public RateBase
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(DeadlineRate)
+
+  /// Statistics of the deadlines since the construction or reset_statistics().
+  struct Statistics
+  {
+    /// Number of calls to sleep().
+    size_t number_of_deadlines{0};
+    /// Number of calls to sleep() made after their deadline.
+    size_t number_of_overruns{0};
+    /// Number of deadlines skipped because a whole period was missed.
+    size_t number_of_missed_periods{0};
+    /// Lateness of the last deadline.
+    std::chrono::nanoseconds last_lateness{0};
+    /// Largest lateness.
+    std::chrono::nanoseconds max_lateness{0};
+    /// Sum of the lateness of all the deadlines, to compute their mean.
+    std::chrono::nanoseconds total_lateness{0};
+  };
+
+  /// Constructor.
+  /**
+   * \param[in] period the interval between two deadlines
+   * \param[in] clock the clock of the deadlines, a steady clock by default
+   * \param[in] context the context whose shutdown interrupts the sleep
+   * \throws std::invalid_argument if the period isn't positive or the clock is nullptr
+   */
+  RCLCPP_PUBLIC
+  explicit DeadlineRate(
+    std::chrono::nanoseconds period,
+    rclcpp::Clock::SharedPtr clock = std::make_shared<rclcpp::Clock>(RCL_STEADY_TIME),
+    rclcpp::Context::SharedPtr context = rclcpp::contexts::get_global_default_context());
+
+  /// Constructor, given the frequency of the deadlines in Hz.
+  RCLCPP_PUBLIC
+  explicit DeadlineRate(
+    double rate,
+    rclcpp::Clock::SharedPtr clock = std::make_shared<rclcpp::Clock>(RCL_STEADY_TIME),
+    rclcpp::Context::SharedPtr context = rclcpp::contexts::get_global_default_context());
+
+  RCLCPP_PUBLIC
+  virtual ~DeadlineRate();
+
+  /// Sleep until the next deadline.
+  /**
+   * If the deadline already passed, it doesn't sleep and, if whole periods
+   * were missed, their deadlines are skipped, keeping the phase of the deadlines.
+   * The deadlines also restart from now if the time jumped backward, or if the
+   * sleep was interrupted by a change of time source.
+   *
+   * \return true if the deadline was reached by sleeping, false if it had
+   *   already passed or the sleep was interrupted
+   */
+  RCLCPP_PUBLIC
+  bool
+  sleep() override;
+
+  RCLCPP_PUBLIC
+  bool
+  is_steady() const override;
+
+  /// Restart the deadlines from now.
+  RCLCPP_PUBLIC
+  void
+  reset() override;
+
+  RCLCPP_PUBLIC
+  std::chrono::nanoseconds
+  period() const;
+
+  /// Return the next deadline.
+  RCLCPP_PUBLIC
+  rclcpp::Time
+  get_next_deadline() const;
+
+  RCLCPP_PUBLIC
+  const Statistics &
+  get_statistics() const;
+
+  RCLCPP_PUBLIC
+  void
+  reset_statistics();
+
+private:
+  RCLCPP_DISABLE_COPY(DeadlineRate)
+
+  /// Sleep until the deadline, returning false if interrupted.
+  bool
+  sleep_until(const rclcpp::Time & deadline);
+
+  /// Update the statistics once a deadline is handled, at the given time.
+  void
+  record_lateness(const rclcpp::Time & deadline, const rclcpp::Time & now);
+
+  rclcpp::Duration period_;
+  rclcpp::Clock::SharedPtr clock_;
+  rclcpp::Context::SharedPtr context_;
+  rclcpp::Time next_deadline_;
+  Statistics statistics_;
+};
+
 }  // namespace rclcpp
 
 #endif  // RCLCPP__RATE_HPP_
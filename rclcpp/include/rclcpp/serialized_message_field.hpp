@@ -0,0 +1,200 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__SERIALIZED_MESSAGE_FIELD_HPP_
+#define RCLCPP__SERIALIZED_MESSAGE_FIELD_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "rcl/types.h"
+#include "rcpputils/shared_library.hpp"
+#include "rosidl_runtime_c/message_type_support_struct.h"
+#include "rosidl_runtime_cpp/traits.hpp"
+#include "rosidl_typesupport_cpp/message_type_support.hpp"
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Field of serialized messages, read without deserializing the rest of the messages.
+/**
+ * The path of the field, such as `header.stamp` or `points[2].x`, is compiled once with the
+ * introspection type support of the messages into the steps skipping the fields before it
+ * in the messages serialized with plain CDR, which is the encoding of the messages of
+ * the ROS 2 middlewares.
+ * The fields of fixed size before it are skipped at once, and only the strings and the
+ * sequences among them are walked through for each message.
+ *
+ * The fields can be numbers, booleans, strings, elements of arrays or nested messages,
+ * which are read into their C++ message type, for example:
+ *
+ * ```cpp
+ * rclcpp::SerializedMessageField stamp("sensor_msgs/msg/Image", "header.stamp");
+ * builtin_interfaces::msg::Time time;
+ * if (stamp.read(serialized_message, time)) {
+ *   // ...
+ * }
+ * ```
+ *
+ * The wide characters, the wide strings and the long doubles aren't serialized the same
+ * by all the middlewares, so the fields can't be preceded by nor contain them.
+ * A compiled field is immutable, and can be read from several threads.
+ */
+class SerializedMessageField
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(SerializedMessageField)
+
+  /// Compile the path of a field of a message type.
+  /**
+   * The introspection type support library of the type is loaded with
+   * rclcpp::get_typesupport_library(), and stays loaded as long as the field exists.
+   *
+   * \param[in] type the type of the messages, e.g. "std_msgs/msg/Header".
+   * \param[in] field_path the path of the field, e.g. "stamp.sec".
+   * \throws std::runtime_error if the introspection type support library isn't found.
+   * \throws std::invalid_argument if the messages have no such field, or it can't be read
+   *   from serialized messages.
+   */
+  RCLCPP_PUBLIC
+  SerializedMessageField(const std::string & type, const std::string & field_path);
+
+  /// Compile the path of a field of the messages of a type support.
+  /**
+   * \param[in] type_support a type support of the messages, from which their introspection
+   *   type support is loaded, which must stay loaded as long as the field exists.
+   * \param[in] field_path the path of the field.
+   * \throws std::invalid_argument if the introspection type support isn't available, if the
+   *   messages have no such field, or if it can't be read from serialized messages.
+   */
+  RCLCPP_PUBLIC
+  SerializedMessageField(
+    const rosidl_message_type_support_t & type_support,
+    const std::string & field_path);
+
+  RCLCPP_PUBLIC
+  ~SerializedMessageField();
+
+  /// Return the path of the field.
+  RCLCPP_PUBLIC
+  const std::string &
+  get_path() const;
+
+  /// Return the introspection type id of the field, e.g. ROS_TYPE_MESSAGE for a message.
+  RCLCPP_PUBLIC
+  uint8_t
+  get_type_id() const;
+
+  /// Read a number or a boolean field, converted to the type of the value.
+  /**
+   * \param[in] message a message serialized with plain CDR.
+   * \param[out] value the value of the field.
+   * \return false if the message doesn't have the field, because it has another encoding,
+   *   is truncated, or its sequence with the field has fewer elements.
+   * \throws std::invalid_argument if the field isn't a number nor a boolean.
+   */
+  template<typename T>
+  std::enable_if_t<std::is_arithmetic<T>::value, bool>
+  read(const rclcpp::SerializedMessage & message, T & value) const
+  {
+    Number number;
+    if (!read_number(message.get_rcl_serialized_message(), number)) {
+      return false;
+    }
+    switch (number.kind) {
+      case Number::Kind::Signed:
+        value = static_cast<T>(number.signed_value);
+        break;
+      case Number::Kind::Unsigned:
+        value = static_cast<T>(number.unsigned_value);
+        break;
+      default:
+        value = static_cast<T>(number.float_value);
+        break;
+    }
+    return true;
+  }
+
+  /// Read a string field.
+  /**
+   * \return false if the message doesn't have the field.
+   * \throws std::invalid_argument if the field isn't a string.
+   */
+  RCLCPP_PUBLIC
+  bool
+  read(const rclcpp::SerializedMessage & message, std::string & value) const;
+
+  /// Read a message field into its C++ message type.
+  /**
+   * \return false if the message doesn't have the field.
+   * \throws std::invalid_argument if the field isn't a message of this type.
+   */
+  template<typename MessageT>
+  std::enable_if_t<rosidl_generator_traits::is_message<MessageT>::value, bool>
+  read(const rclcpp::SerializedMessage & message, MessageT & value) const
+  {
+    return read_message(
+      message.get_rcl_serialized_message(),
+      *rosidl_typesupport_cpp::get_message_type_support_handle<MessageT>(), &value);
+  }
+
+  struct Step;
+
+private:
+  struct Number
+  {
+    enum class Kind {Signed, Unsigned, Float};
+
+    Kind kind = Kind::Signed;
+    int64_t signed_value = 0;
+    uint64_t unsigned_value = 0;
+    double float_value = 0.;
+  };
+
+  void
+  compile(const rosidl_message_type_support_t & type_support);
+
+  RCLCPP_PUBLIC
+  bool
+  read_number(const rcl_serialized_message_t & message, Number & number) const;
+
+  RCLCPP_PUBLIC
+  bool
+  read_message(
+    const rcl_serialized_message_t & message,
+    const rosidl_message_type_support_t & type_support,
+    void * ros_message) const;
+
+  const std::string path_;
+  // Keeps the introspection type support loaded, if it was loaded for the field
+  std::shared_ptr<rcpputils::SharedLibrary> library_;
+  uint8_t type_id_ = 0;
+  // The introspection members of a message field, null for the other fields
+  const void * members_ = nullptr;
+  // Offset of the first step in the payload, after the fields of fixed size at its start
+  size_t fixed_offset_ = 0;
+  std::vector<Step> steps_;
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__SERIALIZED_MESSAGE_FIELD_HPP_
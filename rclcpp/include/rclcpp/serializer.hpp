@@ -0,0 +1,133 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__SERIALIZER_HPP_
+#define RCLCPP__SERIALIZER_HPP_
+
+#include "rcl/allocator.h"
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/serialization.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+#include "rosidl_runtime_c/message_type_support_struct.h"
+
+#include "rosidl_typesupport_cpp/message_type_support.hpp"
+
+namespace rclcpp
+{
+
+/// Serialize messages into a serialized message reused by all the serializations
+/**
+ * Unlike SerializationBase::serialize_message(), which serializes into the serialized
+ * message it's given, the serializer keeps its own one, so that its buffer is only
+ * allocated once for messages of similar sizes.
+ * When a message doesn't fit in the buffer, it's grown to fit it with some headroom,
+ * so that slightly larger messages don't reallocate it again.
+ *
+ * The serialized message is overwritten by the next serialization.
+ * It is not thread-safe.
+ */
+class RCLCPP_PUBLIC_TYPE SerializerBase
+{
+public:
+  /// Constructor of SerializerBase
+  /**
+   * \param[in] type_support handle for the message type support
+   * to be used for serialization.
+   * \param[in] initial_capacity initial capacity of the buffer, for example an estimate
+   * of the size of the messages.
+   * \param[in] allocator The allocator to be used for the buffer.
+   */
+  explicit SerializerBase(
+    const rosidl_message_type_support_t * type_support,
+    size_t initial_capacity = 0u,
+    const rcl_allocator_t & allocator = rcl_get_default_allocator());
+
+  /// Destructor of SerializerBase
+  virtual ~SerializerBase() = default;
+
+  /// Serialize a ROS2 message into the serialized message of the serializer
+  /**
+   * \param[in] ros_message The ROS2 message which is read and serialized by rmw.
+   * \return The serialized message, valid until the next serialization.
+   */
+  const SerializedMessage &
+  serialize_message(const void * ros_message);
+
+  /// Return the serialized message of the last serialization.
+  const SerializedMessage &
+  get_serialized_message() const;
+
+  /// Grow the buffer so that messages up to the given size are serialized without allocation.
+  void
+  reserve(size_t capacity);
+
+  /// Return the capacity of the buffer.
+  size_t
+  capacity() const;
+
+  /// Return the number of times the buffer was allocated while serializing messages.
+  size_t
+  get_number_of_allocations() const;
+
+private:
+  RCLCPP_DISABLE_COPY(SerializerBase)
+
+  SerializationBase serialization_;
+  SerializedMessage serialized_message_;
+  size_t number_of_allocations_ = 0u;
+};
+
+/// Default implementation to serialize messages into a reused buffer by using rmw_serialize
+template<typename MessageT>
+class Serializer : public SerializerBase
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(Serializer)
+
+  /// Constructor of Serializer
+  /**
+   * \param[in] initial_capacity initial capacity of the buffer, for example an estimate
+   * of the size of the messages.
+   * \param[in] allocator The allocator to be used for the buffer.
+   */
+  explicit Serializer(
+    size_t initial_capacity = 0u,
+    const rcl_allocator_t & allocator = rcl_get_default_allocator())
+  : SerializerBase(
+      rosidl_typesupport_cpp::get_message_type_support_handle<MessageT>(),
+      initial_capacity, allocator)
+  {
+    static_assert(
+      !serialization_traits::is_serialized_message_class<MessageT>::value,
+      "Serialization of serialized message to serialized message is not possible.");
+  }
+
+  /// Serialize a ROS2 message into the serialized message of the serializer
+  /**
+   * \param[in] message The ROS2 message which is read and serialized by rmw.
+   * \return The serialized message, valid until the next serialization.
+   */
+  const SerializedMessage &
+  serialize_message(const MessageT & message)
+  {
+    return SerializerBase::serialize_message(&message);
+  }
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__SERIALIZER_HPP_
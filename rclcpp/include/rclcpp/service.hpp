@@ -16,12 +16,16 @@
 #define RCLCPP__SERVICE_HPP_
 
 #include <atomic>
+#include <chrono>
+#include <exception>
 #include <functional>
 #include <iostream>
 #include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "rcl/error_handling.h"
 #include "rcl/event_callback.h"
@@ -35,8 +39,11 @@
 
 #include "rclcpp/any_service_callback.hpp"
 #include "rclcpp/detail/cpp_callback_trampoline.hpp"
+#include "rclcpp/detail/service_response_cache.hpp"
+#include "rclcpp/detail/shared_message_pool.hpp"
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/expand_topic_or_service_name.hpp"
+#include "rclcpp/experimental/intra_process_services.hpp"
 #include "rclcpp/logging.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/qos.hpp"
@@ -55,7 +62,7 @@ public:
   explicit ServiceBase(std::shared_ptr<rcl_node_t> node_handle);
 
   RCLCPP_PUBLIC
-  virtual ~ServiceBase() = default;
+  virtual ~ServiceBase();
 
   /// Return the name of the service.
   /** \return The name of the service. */
@@ -114,6 +121,31 @@ public:
     std::shared_ptr<rmw_request_id_t> request_header,
     std::shared_ptr<void> request) = 0;
 
+  /// Receive the requests of the intra-process clients of the context.
+  /**
+   * The requests of the clients created by nodes using intra-process
+   * communications are then handed over to the service without being serialized,
+   * by the waitable returned by get_intra_process_waitable(), which has to be
+   * added to the callback group of the service.
+   * This is done by rclcpp::create_service() when the node uses intra-process
+   * communications.
+   *
+   * \param[in] self shared pointer to this service, the requests aren't handled anymore
+   *   once it is destroyed.
+   * \param[in] context context of the intra-process clients.
+   * \return false if the service doesn't have a type support to match the clients with.
+   */
+  RCLCPP_PUBLIC
+  bool
+  setup_intra_process(
+    const std::shared_ptr<ServiceBase> & self,
+    rclcpp::Context::SharedPtr context);
+
+  /// Return the waitable handling the intra-process requests, or nullptr if not set up.
+  RCLCPP_PUBLIC
+  rclcpp::Waitable::SharedPtr
+  get_intra_process_waitable() const;
+
   /// Exchange the "in use by wait set" state for this service.
   /**
    * This is used to ensure this service is not used by multiple
@@ -261,6 +293,28 @@ protected:
   void
   set_on_new_request_callback(rcl_event_callback_t callback, const void * user_data);
 
+  /// Return the type support of the service, used to match the intra-process clients.
+  virtual
+  const rosidl_service_type_support_t *
+  get_intra_process_type_support() const
+  {
+    return nullptr;
+  }
+
+  /// Return true if the request was sent by an intra-process client.
+  bool
+  is_intra_process_request(const rmw_request_id_t & request_id) const
+  {
+    uint64_t client_id;
+    return intra_process_queue_ &&
+           experimental::IntraProcessServices::get_client_id(request_id, client_id);
+  }
+
+  /// Hand the response over to the intra-process client which sent the request.
+  RCLCPP_PUBLIC
+  void
+  send_intra_process_response(const rmw_request_id_t & request_id, std::shared_ptr<void> response);
+
   std::shared_ptr<rcl_node_t> node_handle_;
 
   std::shared_ptr<rcl_service_t> service_handle_;
@@ -272,6 +326,10 @@ protected:
 
   std::recursive_mutex callback_mutex_;
   std::function<void(size_t)> on_new_request_callback_{nullptr};
+
+  experimental::IntraProcessServices::SharedPtr intra_process_services_;
+  experimental::IntraProcessServiceQueue::SharedPtr intra_process_queue_;
+  uint64_t intra_process_service_id_{0};
 };
 
 template<typename ServiceT>
@@ -453,12 +511,108 @@ public:
     return this->take_type_erased_request(&request_out, request_id_out);
   }
 
+  /// Reuse the requests and responses of the service once they aren't referenced anymore.
+  /**
+   * Up to max_size requests and as many responses are kept, and reused once
+   * neither the callbacks nor the pending deferred responses hold them, so that a
+   * service answering a steady number of requests doesn't allocate them.
+   * A reused request is overwritten by the next request taken, while a reused
+   * response is reset to a default constructed response before being given to the callback.
+   *
+   * It has to be called before the service is used by an executor.
+   *
+   * \param[in] max_size maximum number of requests and of responses kept,
+   *   0 to allocate them for each request.
+   */
+  void
+  set_message_pool_size(size_t max_size)
+  {
+    if (max_size == 0) {
+      request_pool_.reset();
+      response_pool_.reset();
+      return;
+    }
+    request_pool_ = std::make_shared<detail::SharedMessagePool<typename ServiceT::Request>>(
+      max_size);
+    response_pool_ = std::make_shared<detail::SharedMessagePool<typename ServiceT::Response>>(
+      max_size);
+  }
+
   std::shared_ptr<void>
   create_request() override
   {
+    if (request_pool_) {
+      return request_pool_->borrow_message(false);
+    }
     return std::make_shared<typename ServiceT::Request>();
   }
 
+  /// Return a default constructed response, from the pool when it is enabled.
+  /**
+   * Meant for the deferred response callbacks, to answer their requests
+   * without allocating responses.
+   * \sa set_message_pool_size()
+   */
+  std::shared_ptr<typename ServiceT::Response>
+  borrow_response()
+  {
+    if (response_pool_) {
+      return response_pool_->borrow_message(true);
+    }
+    return std::make_shared<typename ServiceT::Response>();
+  }
+
+  /// Answer identical requests with the same response, without calling the callback again.
+  /**
+   * Meant for idempotent services, whose response only depends on the request.
+   * Requests are identical when their serialized bytes are.
+   * A response is answered again until its time to live expires, or until
+   * invalidate_response_cache() is called, for instance when the state the
+   * responses depend on changes.
+   *
+   * The responses of deferred response callbacks aren't cached.
+   *
+   * It has to be called before the service is used by an executor.
+   *
+   * \param[in] time_to_live how long a response is answered to identical requests.
+   * \param[in] max_size maximum number of cached responses.
+   * \throws std::invalid_argument if max_size is 0 or time_to_live is negative.
+   */
+  void
+  enable_response_cache(std::chrono::nanoseconds time_to_live, size_t max_size = 64)
+  {
+    response_cache_ = std::make_shared<ResponseCache>(time_to_live, max_size);
+  }
+
+  /// Call the callback for every request again.
+  /**
+   * It has to be called before the service is used by an executor.
+   */
+  void
+  disable_response_cache()
+  {
+    response_cache_.reset();
+  }
+
+  /// Remove the cached responses, so that the next requests are answered by the callback.
+  /**
+   * It can be called from any thread, including from the callback of the service.
+   */
+  void
+  invalidate_response_cache()
+  {
+    if (response_cache_) {
+      response_cache_->clear();
+    }
+  }
+
+  /// Return the number of cached responses, 0 if the cache isn't enabled.
+  size_t
+  get_number_of_cached_responses() const
+  {
+    return response_cache_ ? response_cache_->size() : 0u;
+  }
+
   std::shared_ptr<rmw_request_id_t>
   create_request_header() override
   {
@@ -471,15 +625,46 @@ public:
     std::shared_ptr<void> request) override
   {
     auto typed_request = std::static_pointer_cast<typename ServiceT::Request>(request);
-    auto response = any_callback_.dispatch(this->shared_from_this(), request_header, typed_request);
-    if (response) {
-      send_response(*request_header, *response);
+    std::string cache_key;
+    const bool use_cache = response_cache_ && !any_callback_.is_deferred();
+    if (use_cache) {
+      auto cached_response = response_cache_->find(*typed_request, cache_key);
+      if (cached_response) {
+        send_cached_response(*request_header, *cached_response);
+        return;
+      }
     }
+    std::shared_ptr<typename ServiceT::Response> response;
+    if (response_pool_ && !any_callback_.is_deferred()) {
+      response = response_pool_->borrow_message(true);
+    }
+    response = any_callback_.dispatch(
+      this->shared_from_this(), request_header, std::move(typed_request), std::move(response));
+    if (!response) {
+      return;
+    }
+    if (use_cache) {
+      // Copied, as the response may be reused by the pool or handed over to a client.
+      response_cache_->insert(
+        std::move(cache_key), std::make_shared<const typename ServiceT::Response>(*response));
+    }
+    if (is_intra_process_request(*request_header)) {
+      // The client gets the response given to the callback, without copying it.
+      send_intra_process_response(*request_header, std::move(response));
+      return;
+    }
+    send_response(*request_header, *response);
   }
 
   void
   send_response(rmw_request_id_t & req_id, typename ServiceT::Response & response)
   {
+    if (is_intra_process_request(req_id)) {
+      // Deferred responses are references, which may be reused by the caller.
+      send_intra_process_response(
+        req_id, std::make_shared<typename ServiceT::Response>(response));
+      return;
+    }
     rcl_ret_t ret = rcl_send_response(get_service_handle().get(), &req_id, &response);
 
     if (ret != RCL_RET_OK) {
@@ -487,10 +672,87 @@ public:
     }
   }
 
+  /// Send a response, which is handed over to an intra-process client without being copied.
+  void
+  send_response(
+    rmw_request_id_t & req_id,
+    std::shared_ptr<typename ServiceT::Response> response)
+  {
+    if (is_intra_process_request(req_id)) {
+      send_intra_process_response(req_id, std::move(response));
+      return;
+    }
+    send_response(req_id, *response);
+  }
+
+  /// Answer a batch of deferred requests.
+  /**
+   * A deferred response callback can keep the headers of its requests and
+   * answer them all at once later, for instance from a timer looking up the
+   * requests received during a cycle together.
+   *
+   * Every response is sent even if sending one of them fails.
+   *
+   * \param[in] responses headers of the requests with their responses.
+   * \throws rclcpp::exceptions::RCLError the first error, once all the
+   *   responses were sent.
+   */
+  void
+  send_responses(
+    const std::vector<std::pair<
+      std::shared_ptr<rmw_request_id_t>, std::shared_ptr<typename ServiceT::Response>>> & responses)
+  {
+    std::exception_ptr first_error;
+    for (const auto & header_and_response : responses) {
+      try {
+        send_response(*header_and_response.first, header_and_response.second);
+      } catch (...) {
+        if (!first_error) {
+          first_error = std::current_exception();
+        }
+      }
+    }
+    if (first_error) {
+      std::rethrow_exception(first_error);
+    }
+  }
+
+protected:
+  const rosidl_service_type_support_t *
+  get_intra_process_type_support() const override
+  {
+    return rosidl_typesupport_cpp::get_service_type_support_handle<ServiceT>();
+  }
+
 private:
   RCLCPP_DISABLE_COPY(Service)
 
+  using ResponseCache =
+    detail::ServiceResponseCache<typename ServiceT::Request, typename ServiceT::Response>;
+
+  void
+  send_cached_response(rmw_request_id_t & req_id, const typename ServiceT::Response & response)
+  {
+    if (is_intra_process_request(req_id)) {
+      // The cached response is shared by the requests, so each client gets its own copy.
+      send_intra_process_response(
+        req_id, std::make_shared<typename ServiceT::Response>(response));
+      return;
+    }
+    // rcl only reads the response.
+    rcl_ret_t ret = rcl_send_response(
+      get_service_handle().get(), &req_id,
+      const_cast<typename ServiceT::Response *>(&response));
+    if (ret != RCL_RET_OK) {
+      rclcpp::exceptions::throw_from_rcl_error(ret, "failed to send response");
+    }
+  }
+
   AnyServiceCallback<ServiceT> any_callback_;
+
+  std::shared_ptr<detail::SharedMessagePool<typename ServiceT::Request>> request_pool_;
+  std::shared_ptr<detail::SharedMessagePool<typename ServiceT::Response>> response_pool_;
+  std::shared_ptr<ResponseCache> response_cache_;
 };
 
 }  // namespace rclcpp
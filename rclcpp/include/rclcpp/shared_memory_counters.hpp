@@ -0,0 +1,132 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__SHARED_MEMORY_COUNTERS_HPP_
+#define RCLCPP__SHARED_MEMORY_COUNTERS_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Header at the start of a shared memory counters segment.
+/**
+ * The layout of the segment is stable for a given version: this header, followed by
+ * `capacity` slots of SharedMemoryCounterSlot.
+ * Only the first `size` slots are valid, a reader loads `size` with acquire ordering
+ * before reading their names.
+ */
+struct SharedMemoryCountersHeader
+{
+  static constexpr uint32_t expected_magic = 0x52434c43;  // "RCLC"
+  static constexpr uint32_t current_version = 1;
+
+  uint32_t magic;
+  uint32_t version;
+  uint32_t capacity;
+  std::atomic<uint32_t> size;
+  uint64_t pid;
+};
+
+/// Slot of a counter in a shared memory counters segment.
+struct SharedMemoryCounterSlot
+{
+  static constexpr size_t name_size = 56;
+
+  /// Name of the counter, null-terminated.
+  char name[name_size];
+  /// Value of the counter, updated with relaxed atomic operations.
+  std::atomic<uint64_t> value;
+};
+
+static_assert(sizeof(SharedMemoryCountersHeader) == 24, "the layout of the header changed");
+static_assert(sizeof(SharedMemoryCounterSlot) == 64, "the layout of the slots changed");
+static_assert(
+  std::atomic<uint64_t>::is_always_lock_free,
+  "the counters must be lock-free to be shared between processes");
+
+/// Counters of a process, which other processes can read from a shared memory segment.
+/**
+ * The counters are updated in place by the threads of the process, so that an external
+ * monitor can read them at any frequency, without any involvement of this process.
+ * By default the segment is named "/rclcpp_counters_<pid>", and it is removed when this
+ * object is destroyed.
+ *
+ * Shared memory segments are only supported on POSIX systems.
+ */
+class SharedMemoryCounters
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(SharedMemoryCounters)
+
+  /// Create the shared memory segment.
+  /**
+   * \param[in] segment_name name of the segment, the default one if empty.
+   * \param[in] capacity maximum number of counters.
+   * \throws std::invalid_argument if the capacity is 0.
+   * \throws std::runtime_error if the segment can't be created.
+   */
+  RCLCPP_PUBLIC
+  explicit SharedMemoryCounters(const std::string & segment_name = "", size_t capacity = 256);
+
+  RCLCPP_PUBLIC
+  ~SharedMemoryCounters();
+
+  /// Add a counter, initialized to 0, and return it.
+  /**
+   * The returned counter is valid as long as this object.
+   * \param[in] name name of the counter, shorter than SharedMemoryCounterSlot::name_size.
+   * \throws std::invalid_argument if the name is empty or too long.
+   * \throws std::runtime_error if the segment is full.
+   */
+  RCLCPP_PUBLIC
+  std::atomic<uint64_t> &
+  add_counter(const std::string & name);
+
+  /// Get the name of the segment.
+  RCLCPP_PUBLIC
+  const std::string &
+  get_segment_name() const;
+
+  /// Get the number of counters added.
+  RCLCPP_PUBLIC
+  size_t
+  size() const;
+
+  /// Get the maximum number of counters.
+  RCLCPP_PUBLIC
+  size_t
+  capacity() const;
+
+private:
+  RCLCPP_DISABLE_COPY(SharedMemoryCounters)
+
+  std::string segment_name_;
+  size_t mapping_size_ = 0;
+  void * mapping_ = nullptr;
+  SharedMemoryCountersHeader * header_ = nullptr;
+  SharedMemoryCounterSlot * slots_ = nullptr;
+  std::mutex mutex_;
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__SHARED_MEMORY_COUNTERS_HPP_
@@ -15,7 +15,10 @@
 #ifndef RCLCPP__STRATEGIES__ALLOCATOR_MEMORY_STRATEGY_HPP_
 #define RCLCPP__STRATEGIES__ALLOCATOR_MEMORY_STRATEGY_HPP_
 
+#include <cstdint>
 #include <memory>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "rcl/allocator.h"
@@ -154,6 +157,7 @@ public:
   bool collect_entities(const WeakCallbackGroupsToNodesMap & weak_groups_to_nodes) override
   {
     bool has_invalid_weak_groups_or_nodes = false;
+    ++collection_count_;
     for (const auto & pair : weak_groups_to_nodes) {
       auto group = pair.first.lock();
       auto node = pair.second.lock();
@@ -161,26 +165,36 @@ public:
         has_invalid_weak_groups_or_nodes = true;
         continue;
       }
-      if (!group || !group->can_be_taken_from().load()) {
+      // Keep the cache of the groups that can't be taken from or are disabled for now.
+      auto & cache = group_caches_[group.get()];
+      cache.collection_count = collection_count_;
+      if (!group->can_be_taken_from().load() || !group->is_enabled()) {
         continue;
       }
 
-      group->collect_all_ptrs(
-        [this](const rclcpp::SubscriptionBase::SharedPtr & subscription) {
-          subscription_handles_.push_back(subscription->get_subscription_handle());
-        },
-        [this](const rclcpp::ServiceBase::SharedPtr & service) {
-          service_handles_.push_back(service->get_service_handle());
-        },
-        [this](const rclcpp::ClientBase::SharedPtr & client) {
-          client_handles_.push_back(client->get_client_handle());
-        },
-        [this](const rclcpp::TimerBase::SharedPtr & timer) {
-          timer_handles_.push_back(timer->get_timer_handle());
-        },
-        [this](const rclcpp::Waitable::SharedPtr & waitable) {
-          waitable_handles_.push_back(waitable);
-        });
+      // Only walk the entities of the groups that changed since the last collection.
+      if (!is_group_cache_valid(cache, group)) {
+        update_group_cache(cache, group);
+      }
+      // The cache only holds weak pointers, so destroyed entities aren't kept alive.
+      bool has_expired_entities = false;
+      has_expired_entities |= add_cached_handles(cache.subscriptions, subscription_handles_);
+      has_expired_entities |= add_cached_handles(cache.services, service_handles_);
+      has_expired_entities |= add_cached_handles(cache.clients, client_handles_);
+      has_expired_entities |= add_cached_handles(cache.timers, timer_handles_);
+      has_expired_entities |= add_cached_handles(cache.waitables, waitable_handles_);
+      if (has_expired_entities) {
+        cache.group.reset();
+      }
+    }
+
+    // Forget the groups which are not collected anymore.
+    for (auto it = group_caches_.begin(); it != group_caches_.end(); ) {
+      if (it->second.collection_count != collection_count_) {
+        it = group_caches_.erase(it);
+      } else {
+        ++it;
+      }
     }
 
     return has_invalid_weak_groups_or_nodes;
@@ -422,6 +436,117 @@ public:
     }
   }
 
+  void
+  get_next_executable_by_precedence(
+    rclcpp::AnyExecutable & any_exec,
+    const WeakCallbackGroupsToNodesMap & weak_groups_to_nodes,
+    const CallbackGroupPrecedence & has_precedence) override
+  {
+    while (true) {
+      // Find the ready entity with the best group, ties are kept in the fixed order.
+      rclcpp::CallbackGroup::SharedPtr best_group;
+      size_t best_index = 0;
+      rclcpp::TimerBase::SharedPtr timer;
+      rclcpp::SubscriptionBase::SharedPtr subscription;
+      rclcpp::ServiceBase::SharedPtr service;
+      rclcpp::ClientBase::SharedPtr client;
+      rclcpp::Waitable::SharedPtr waitable;
+      auto is_better =
+        [&best_group, &has_precedence](const rclcpp::CallbackGroup::SharedPtr & group) {
+          return group && group->can_be_taken_from().load() &&
+                 (!best_group || has_precedence(*group, *best_group));
+        };
+      auto select = [&](const rclcpp::CallbackGroup::SharedPtr & group, size_t index) {
+          best_group = group;
+          best_index = index;
+          timer.reset();
+          subscription.reset();
+          service.reset();
+          client.reset();
+          waitable.reset();
+        };
+
+      for (size_t i = 0; i < timer_handles_.size(); ++i) {
+        auto candidate = get_timer_by_handle(timer_handles_[i], weak_groups_to_nodes);
+        if (candidate) {
+          auto group = get_group_by_timer(candidate, weak_groups_to_nodes);
+          if (is_better(group)) {
+            select(group, i);
+            timer = candidate;
+          }
+        }
+      }
+      for (size_t i = 0; i < subscription_handles_.size(); ++i) {
+        auto candidate =
+          get_subscription_by_handle(subscription_handles_[i], weak_groups_to_nodes);
+        if (candidate) {
+          auto group = get_group_by_subscription(candidate, weak_groups_to_nodes);
+          if (is_better(group)) {
+            select(group, i);
+            subscription = candidate;
+          }
+        }
+      }
+      for (size_t i = 0; i < service_handles_.size(); ++i) {
+        auto candidate = get_service_by_handle(service_handles_[i], weak_groups_to_nodes);
+        if (candidate) {
+          auto group = get_group_by_service(candidate, weak_groups_to_nodes);
+          if (is_better(group)) {
+            select(group, i);
+            service = candidate;
+          }
+        }
+      }
+      for (size_t i = 0; i < client_handles_.size(); ++i) {
+        auto candidate = get_client_by_handle(client_handles_[i], weak_groups_to_nodes);
+        if (candidate) {
+          auto group = get_group_by_client(candidate, weak_groups_to_nodes);
+          if (is_better(group)) {
+            select(group, i);
+            client = candidate;
+          }
+        }
+      }
+      for (size_t i = 0; i < waitable_handles_.size(); ++i) {
+        const auto & candidate = waitable_handles_[i];
+        if (candidate) {
+          auto group = get_group_by_waitable(candidate, weak_groups_to_nodes);
+          if (is_better(group)) {
+            select(group, i);
+            waitable = candidate;
+          }
+        }
+      }
+
+      if (!best_group) {
+        return;
+      }
+      if (timer) {
+        timer_handles_.erase(timer_handles_.begin() + best_index);
+        if (!timer->call()) {
+          // timer was cancelled, look for another entity.
+          continue;
+        }
+        any_exec.timer = timer;
+      } else if (subscription) {
+        subscription_handles_.erase(subscription_handles_.begin() + best_index);
+        any_exec.subscription = subscription;
+      } else if (service) {
+        service_handles_.erase(service_handles_.begin() + best_index);
+        any_exec.service = service;
+      } else if (client) {
+        client_handles_.erase(client_handles_.begin() + best_index);
+        any_exec.client = client;
+      } else {
+        waitable_handles_.erase(waitable_handles_.begin() + best_index);
+        any_exec.waitable = waitable;
+      }
+      any_exec.callback_group = best_group;
+      any_exec.node_base = get_node_by_group(best_group, weak_groups_to_nodes);
+      return;
+    }
+  }
+
   rcl_allocator_t get_allocator() override
   {
     return rclcpp::allocator::get_rcl_allocator<void *, VoidAlloc>(*allocator_.get());
@@ -499,6 +624,81 @@ private:
   VectorRebind<std::shared_ptr<const rcl_timer_t>> timer_handles_;
   VectorRebind<std::shared_ptr<Waitable>> waitable_handles_;
 
+  template<typename T>
+  using CachedHandles = VectorRebind<std::weak_ptr<T>>;
+
+  /// Handles of the entities of a callback group, as of a generation of the group.
+  struct GroupEntitiesCache
+  {
+    rclcpp::CallbackGroup::WeakPtr group;
+    uint64_t generation = 0;
+    uint64_t collection_count = 0;
+    CachedHandles<const rcl_subscription_t> subscriptions;
+    CachedHandles<const rcl_service_t> services;
+    CachedHandles<const rcl_client_t> clients;
+    CachedHandles<const rcl_timer_t> timers;
+    CachedHandles<Waitable> waitables;
+  };
+
+  static bool
+  is_group_cache_valid(
+    const GroupEntitiesCache & cache,
+    const rclcpp::CallbackGroup::SharedPtr & group)
+  {
+    // An expired group means the cache is new or invalidated, or that the group
+    // was destroyed and another one was created at the same address.
+    return !cache.group.expired() && cache.generation == group->get_generation();
+  }
+
+  static void
+  update_group_cache(GroupEntitiesCache & cache, const rclcpp::CallbackGroup::SharedPtr & group)
+  {
+    cache.group = group;
+    // Read before collecting, so changes made while collecting invalidate the cache.
+    cache.generation = group->get_generation();
+    cache.subscriptions.clear();
+    cache.services.clear();
+    cache.clients.clear();
+    cache.timers.clear();
+    cache.waitables.clear();
+    group->collect_all_ptrs(
+      [&cache](const rclcpp::SubscriptionBase::SharedPtr & subscription) {
+        cache.subscriptions.push_back(subscription->get_subscription_handle());
+      },
+      [&cache](const rclcpp::ServiceBase::SharedPtr & service) {
+        cache.services.push_back(service->get_service_handle());
+      },
+      [&cache](const rclcpp::ClientBase::SharedPtr & client) {
+        cache.clients.push_back(client->get_client_handle());
+      },
+      [&cache](const rclcpp::TimerBase::SharedPtr & timer) {
+        cache.timers.push_back(timer->get_timer_handle());
+      },
+      [&cache](const rclcpp::Waitable::SharedPtr & waitable) {
+        cache.waitables.push_back(waitable);
+      });
+  }
+
+  /// Add the cached handles still alive, returning true if some of them expired.
+  template<typename CachedHandlesT, typename HandlesT>
+  static bool
+  add_cached_handles(const CachedHandlesT & cached_handles, HandlesT & handles)
+  {
+    bool has_expired_handles = false;
+    for (const auto & weak_handle : cached_handles) {
+      auto handle = weak_handle.lock();
+      if (handle) {
+        handles.push_back(std::move(handle));
+      } else {
+        has_expired_handles = true;
+      }
+    }
+    return has_expired_handles;
+  }
+
+  std::unordered_map<const rclcpp::CallbackGroup *, GroupEntitiesCache> group_caches_;
+  uint64_t collection_count_ = 0;
+
   std::shared_ptr<VoidAlloc> allocator_;
 };
 
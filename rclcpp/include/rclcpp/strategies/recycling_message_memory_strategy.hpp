@@ -0,0 +1,174 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__STRATEGIES__RECYCLING_MESSAGE_MEMORY_STRATEGY_HPP_
+#define RCLCPP__STRATEGIES__RECYCLING_MESSAGE_MEMORY_STRATEGY_HPP_
+
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "rclcpp/detail/recycling_pool.hpp"
+#include "rclcpp/detail/serialized_message_pool.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/message_memory_strategy.hpp"
+
+namespace rclcpp
+{
+namespace strategies
+{
+namespace recycling_message_memory_strategy
+{
+
+/// Memory strategy reusing the messages once they aren't used anymore.
+/**
+ * The pool holds up to a maximum number of messages, which are only allocated when all the
+ * ones of the pool are in use, so it grows up to the number of messages used at the same time,
+ * for instance by callbacks keeping a shared pointer to them, see
+ * rclcpp::detail::RecyclingPool.
+ * When the pool is full, messages are allocated as with the default memory strategy.
+ *
+ * The messages aren't reset before being reused, as taking a message overwrites all of its
+ * fields, but the memory of their sequences and strings is kept, so that messages of a steady
+ * size don't allocate once reused.
+ * To avoid growing them while the first messages are taken too, the pool can initialize the
+ * messages it allocates, for instance reserving the expected capacity of their sequences:
+ *
+ * ```cpp
+ * using Strategy = RecyclingMessageMemoryStrategy<sensor_msgs::msg::PointCloud2>;
+ * auto strategy = std::make_shared<Strategy>(
+ *   4, [](sensor_msgs::msg::PointCloud2 & msg) {msg.data.reserve(4 * 1024 * 1024);});
+ * strategy->preallocate(4);
+ * ```
+ *
+ * This only helps with the typesupports resizing the sequences when messages are taken,
+ * which keeps their capacity, rather than assigning new ones.
+ *
+ * Serialized messages are recycled the same way, by a rclcpp::detail::SerializedMessagePool.
+ *
+ * Borrowing and returning messages is lock-free and thread-safe.
+ */
+template<typename MessageT, typename Alloc = std::allocator<void>>
+class RecyclingMessageMemoryStrategy
+  : public message_memory_strategy::MessageMemoryStrategy<MessageT, Alloc>
+{
+  using Base = message_memory_strategy::MessageMemoryStrategy<MessageT, Alloc>;
+
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(RecyclingMessageMemoryStrategy)
+
+  using MessageInitializer = std::function<void (MessageT &)>;
+
+  /// Constructor.
+  /**
+   * \param[in] max_size Maximum number of messages kept by the pool.
+   * \param[in] allocator Allocator used for the messages.
+   * \throws std::invalid_argument if max_size is 0.
+   */
+  explicit RecyclingMessageMemoryStrategy(
+    size_t max_size,
+    std::shared_ptr<Alloc> allocator = std::make_shared<Alloc>())
+  : RecyclingMessageMemoryStrategy(max_size, MessageInitializer(), std::move(allocator))
+  {
+  }
+
+  /// Constructor, with a function initializing the messages allocated by the pool.
+  /**
+   * \param[in] max_size Maximum number of messages kept by the pool.
+   * \param[in] initialize_message Function called once with each message allocated by
+   *   the pool, before it's first borrowed, which may be empty.
+   * \param[in] allocator Allocator used for the messages.
+   * \throws std::invalid_argument if max_size is 0.
+   */
+  RecyclingMessageMemoryStrategy(
+    size_t max_size,
+    MessageInitializer initialize_message,
+    std::shared_ptr<Alloc> allocator = std::make_shared<Alloc>())
+  : Base(allocator), pool_(max_size),
+    initialize_message_(std::move(initialize_message)), serialized_message_pool_(max_size)
+  {
+    if (max_size == 0) {
+      throw std::invalid_argument("the pool of a RecyclingMessageMemoryStrategy can't be empty");
+    }
+  }
+
+  /// Allocate messages of the pool up front, so that the first ones taken don't allocate.
+  /**
+   * \param[in] number_of_messages number of messages of the pool allocated, at most.
+   * \return the number of messages allocated by the pool, including the ones before.
+   */
+  size_t preallocate(size_t number_of_messages)
+  {
+    return pool_.preallocate(number_of_messages, [this]() {return allocate_message();});
+  }
+
+  /// Borrow a message of the pool which isn't used anymore, allocating it if needed.
+  std::shared_ptr<MessageT> borrow_message() override
+  {
+    // The messages aren't reset, as taking a message overwrites all of its fields.
+    auto message = pool_.borrow([this]() {return allocate_message();}, [](MessageT &) {});
+    if (!message) {
+      return Base::borrow_message();
+    }
+    return message;
+  }
+
+  /// Return a message to the pool, it is reused once all the other references are released.
+  void return_message(std::shared_ptr<MessageT> & msg) override
+  {
+    msg.reset();
+  }
+
+  using Base::borrow_serialized_message;
+
+  /// Borrow a serialized message of the pool, its buffer has at least the given capacity.
+  std::shared_ptr<rclcpp::SerializedMessage> borrow_serialized_message(size_t capacity) override
+  {
+    return serialized_message_pool_.borrow_message(capacity);
+  }
+
+  /// Return a serialized message to the pool.
+  void return_serialized_message(
+    std::shared_ptr<rclcpp::SerializedMessage> & serialized_msg) override
+  {
+    serialized_message_pool_.return_message(serialized_msg);
+  }
+
+  /// Return the number of messages allocated by the pool.
+  size_t get_number_of_pooled_messages() const
+  {
+    return pool_.size();
+  }
+
+private:
+  std::shared_ptr<MessageT> allocate_message()
+  {
+    auto message = Base::borrow_message();
+    if (initialize_message_) {
+      initialize_message_(*message);
+    }
+    return message;
+  }
+
+  rclcpp::detail::RecyclingPool<MessageT> pool_;
+  const MessageInitializer initialize_message_;
+  rclcpp::detail::SerializedMessagePool serialized_message_pool_;
+};
+
+}  // namespace recycling_message_memory_strategy
+}  // namespace strategies
+}  // namespace rclcpp
+
+#endif  // RCLCPP__STRATEGIES__RECYCLING_MESSAGE_MEMORY_STRATEGY_HPP_
@@ -24,7 +24,9 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <typeinfo>
 #include <utility>
+#include <vector>
 
 #include "rcl/error_handling.h"
 #include "rcl/subscription.h"
@@ -41,6 +43,7 @@
 #include "rclcpp/message_info.hpp"
 #include "rclcpp/message_memory_strategy.hpp"
 #include "rclcpp/node_interfaces/node_base_interface.hpp"
+#include "rclcpp/strategies/recycling_message_memory_strategy.hpp"
 #include "rclcpp/subscription_base.hpp"
 #include "rclcpp/subscription_options.hpp"
 #include "rclcpp/subscription_traits.hpp"
@@ -124,8 +127,8 @@ public:
    * \param[in] message_memory_strategy The memory strategy to be used for managing message memory.
    * \param[in] subscription_topic_statistics Optional pointer to a topic statistics subcription.
    * \throws std::invalid_argument if the QoS is uncompatible with intra-process (if one
-   *   of the following conditions are true: qos_profile.history == RMW_QOS_POLICY_HISTORY_KEEP_ALL,
-   *   qos_profile.depth == 0 or qos_profile.durability != RMW_QOS_POLICY_DURABILITY_VOLATILE).
+   *   of the following conditions are true: qos_profile.history == RMW_QOS_POLICY_HISTORY_KEEP_ALL
+   *   or qos_profile.depth == 0).
    */
   Subscription(
     rclcpp::node_interfaces::NodeBaseInterface * node_base,
@@ -149,6 +152,32 @@ public:
     options_(options),
     message_memory_strategy_(message_memory_strategy)
   {
+    event_handler_group_ = options.event_handler_group;
+    if (options_.max_messages_per_wakeup == 0) {
+      throw std::invalid_argument("max_messages_per_wakeup must be at least 1");
+    }
+    max_messages_per_wakeup_ = options_.max_messages_per_wakeup;
+    batch_callback_ = any_callback_.is_batch_callback();
+    take_only_latest_ = options_.take_only_latest;
+
+    if (options_.content_filter_options.filter_in_process_if_unsupported) {
+      this->enable_local_content_filter(options_.content_filter_options);
+    }
+
+    if (options_.message_pool_size > 0) {
+      using DefaultMessageMemoryStrategy =
+        message_memory_strategy::MessageMemoryStrategy<ROSMessageType, AllocatorT>;
+      if (message_memory_strategy_ &&
+        typeid(*message_memory_strategy_) != typeid(DefaultMessageMemoryStrategy))
+      {
+        throw std::invalid_argument(
+                "message_pool_size can't be used with a custom message memory strategy");
+      }
+      message_memory_strategy_ = std::make_shared<
+        strategies::recycling_message_memory_strategy::RecyclingMessageMemoryStrategy<
+          ROSMessageType, AllocatorT>>(options_.message_pool_size, options_.get_allocator());
+    }
+
     // Setup intra process publishing if requested.
     if (rclcpp::detail::resolve_use_intra_process(options_, *node_base)) {
       using rclcpp::detail::resolve_intra_process_buffer_type;
@@ -163,9 +192,10 @@ public:
         throw std::invalid_argument(
                 "intraprocess communication is not allowed with 0 depth qos policy");
       }
-      if (qos_profile.durability() != rclcpp::DurabilityPolicy::Volatile) {
-        throw std::invalid_argument(
-                "intraprocess communication allowed only with volatile durability");
+
+      if (options_.take_only_latest) {
+        // The buffer only keeps the newest message.
+        qos_profile.keep_last(1);
       }
 
       using SubscriptionIntraProcessT = rclcpp::experimental::SubscriptionIntraProcess<
@@ -184,21 +214,30 @@ public:
         context,
         this->get_topic_name(),  // important to get like this, as it has the fully-qualified name
         qos_profile,
-        resolve_intra_process_buffer_type(options_.intra_process_buffer_type, callback));
+        resolve_intra_process_buffer_type(options_.intra_process_buffer_type, callback),
+        options_.intra_process_buffer_implementation,
+        options_.take_only_latest ? 0 : options_.intra_process_buffer_max_depth);
+      // Before it's added to the manager, which may give it the history of the publishers.
+      this->set_intra_process_content_filter(
+        options_.content_filter_options.filter_expression,
+        options_.content_filter_options.expression_parameters);
       TRACEPOINT(
         rclcpp_subscription_init,
         static_cast<const void *>(get_subscription_handle().get()),
         static_cast<const void *>(subscription_intra_process_.get()));
 
       // Add it to the intra process manager.
-      using rclcpp::experimental::IntraProcessManager;
-      auto ipm = context->get_sub_context<IntraProcessManager>();
+      auto ipm = rclcpp::experimental::get_intra_process_manager(*context);
       uint64_t intra_process_subscription_id = ipm->add_subscription(subscription_intra_process_);
       this->setup_intra_process(intra_process_subscription_id, ipm);
     }
 
     if (subscription_topic_statistics != nullptr) {
       this->subscription_topic_statistics_ = std::move(subscription_topic_statistics);
+      if (subscription_intra_process_) {
+        this->subscription_topic_statistics_->set_intra_process_subscription(
+          subscription_intra_process_);
+      }
     }
 
     TRACEPOINT(
@@ -226,7 +265,10 @@ public:
   {
     (void)node_base;
     (void)qos;
-    (void)options;
+    if (options.deserialization_pool && !this->is_serialized()) {
+      this->enable_deserialization_pool(
+        options.deserialization_pool, options.deserialization_pool_min_size);
+    }
   }
 
   /// Take the next message from the inter-process subscription.
@@ -317,6 +359,54 @@ public:
       const auto nanos = std::chrono::time_point_cast<std::chrono::nanoseconds>(now);
       const auto time = rclcpp::Time(nanos.time_since_epoch().count());
       subscription_topic_statistics_->handle_message(*typed_message, time);
+      subscription_topic_statistics_->handle_message_info(message_info, time);
+    }
+  }
+
+  void
+  handle_messages(
+    std::vector<std::shared_ptr<void>> & messages,
+    const std::vector<rclcpp::MessageInfo> & message_infos) override
+  {
+    if (!any_callback_.is_batch_callback()) {
+      SubscriptionBase::handle_messages(messages, message_infos);
+      return;
+    }
+    std::vector<std::shared_ptr<const ROSMessageType>> typed_messages;
+    std::vector<rclcpp::MessageInfo> typed_message_infos;
+    typed_messages.reserve(messages.size());
+    typed_message_infos.reserve(messages.size());
+    for (size_t i = 0; i < messages.size(); ++i) {
+      if (matches_any_intra_process_publishers(
+          &message_infos[i].get_rmw_message_info().publisher_gid))
+      {
+        // In this case, the message will be delivered via intra process and
+        // we should ignore this copy of the message.
+        continue;
+      }
+      typed_messages.push_back(std::static_pointer_cast<const ROSMessageType>(messages[i]));
+      typed_message_infos.push_back(message_infos[i]);
+    }
+    if (typed_messages.empty()) {
+      return;
+    }
+
+    std::chrono::time_point<std::chrono::system_clock> now;
+    if (subscription_topic_statistics_) {
+      // get current time before executing callback to
+      // exclude callback duration from topic statistics result.
+      now = std::chrono::system_clock::now();
+    }
+
+    any_callback_.dispatch_batch(typed_messages, typed_message_infos);
+
+    if (subscription_topic_statistics_) {
+      const auto nanos = std::chrono::time_point_cast<std::chrono::nanoseconds>(now);
+      const auto time = rclcpp::Time(nanos.time_since_epoch().count());
+      for (size_t i = 0; i < typed_messages.size(); ++i) {
+        subscription_topic_statistics_->handle_message(*typed_messages[i], time);
+        subscription_topic_statistics_->handle_message_info(typed_message_infos[i], time);
+      }
     }
   }
 
@@ -358,6 +448,7 @@ public:
       const auto nanos = std::chrono::time_point_cast<std::chrono::nanoseconds>(now);
       const auto time = rclcpp::Time(nanos.time_since_epoch().count());
       subscription_topic_statistics_->handle_message(*typed_message, time);
+      subscription_topic_statistics_->handle_message_info(message_info, time);
     }
   }
 
@@ -369,6 +460,8 @@ public:
   return_message(std::shared_ptr<void> & message) override
   {
     auto typed_message = std::static_pointer_cast<ROSMessageType>(message);
+    // Released, so the memory strategy may reuse the message once it has the only reference.
+    message.reset();
     message_memory_strategy_->return_message(typed_message);
   }
 
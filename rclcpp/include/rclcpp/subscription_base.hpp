@@ -31,6 +31,7 @@
 
 #include "rclcpp/any_subscription_callback.hpp"
 #include "rclcpp/detail/cpp_callback_trampoline.hpp"
+#include "rclcpp/detail/deserialized_message_queue.hpp"
 #include "rclcpp/experimental/intra_process_manager.hpp"
 #include "rclcpp/experimental/subscription_intra_process_base.hpp"
 #include "rclcpp/macros.hpp"
@@ -51,6 +52,11 @@ namespace node_interfaces
 class NodeBaseInterface;
 }  // namespace node_interfaces
 
+namespace detail
+{
+class ContentFilter;
+}  // namespace detail
+
 namespace experimental
 {
 /**
@@ -60,6 +66,9 @@ namespace experimental
 class IntraProcessManager;
 }  // namespace experimental
 
+class DeserializationPool;
+class QOSEventHandlerGroup;
+
 /// Virtual base class for subscriptions. This pattern allows us to iterate over different template
 /// specializations of Subscription, among other things.
 class SubscriptionBase : public std::enable_shared_from_this<SubscriptionBase>
@@ -118,6 +127,12 @@ public:
   std::unordered_map<rcl_subscription_event_type_t, std::shared_ptr<rclcpp::QOSEventHandlerBase>> &
   get_event_handlers() const;
 
+  /// Get the group the QoS event handlers are added to, if any.
+  /** \return The group given with the options, or nullptr. */
+  RCLCPP_PUBLIC
+  std::shared_ptr<rclcpp::QOSEventHandlerGroup>
+  get_event_handler_group() const;
+
   /// Get the actual QoS settings, after the defaults have been determined.
   /**
    * The actual configuration applied when using RMW_QOS_POLICY_*_SYSTEM_DEFAULT
@@ -150,11 +165,33 @@ public:
    * \param[out] message_info_out The message info for the taken message.
    * \returns true if data was taken and is valid, otherwise false
    * \throws any rcl errors from rcl_take, \sa rclcpp::exceptions::throw_from_rcl_error()
+   * \sa ContentFilterOptions::filter_in_process_if_unsupported
+   * \sa SubscriptionOptionsBase::take_only_latest
    */
   RCLCPP_PUBLIC
   bool
   take_type_erased(void * message_out, rclcpp::MessageInfo & message_info_out);
 
+  /// Take up to as many inter-process messages as given, at once, as type erased pointers.
+  /**
+   * The messages are taken with rcl_take_sequence(), or one at a time with
+   * take_type_erased() if the middleware doesn't support it, or if the subscription
+   * filters the messages in the process or only takes the newest one.
+   * The intra-process messages received from the middleware are skipped, as with
+   * take_type_erased().
+   *
+   * \param[inout] messages The messages created with create_message() into which take
+   *   will copy the data, the ones left unused are returned and removed.
+   * \param[out] message_infos The message infos of the taken messages, at the same indexes.
+   * \returns true if at least one message was taken, otherwise false
+   * \throws any rcl errors from rcl_take_sequence, \sa rclcpp::exceptions::throw_from_rcl_error()
+   */
+  RCLCPP_PUBLIC
+  bool
+  take_type_erased_sequence(
+    std::vector<std::shared_ptr<void>> & messages,
+    std::vector<rclcpp::MessageInfo> & message_infos);
+
   /// Take the next inter-process message, in its serialized form, from the subscription.
   /**
    * For now, if data is taken (written) into the message_out and
@@ -197,6 +234,20 @@ public:
   void
   handle_message(std::shared_ptr<void> & message, const rclcpp::MessageInfo & message_info) = 0;
 
+  /// Handle the messages taken at once, calling a batch callback a single time.
+  /**
+   * By default, each of the messages is handled with handle_message().
+   *
+   * \param[in] messages Shared pointers to the messages to handle.
+   * \param[in] message_infos Metadata associated with the messages, at the same indexes.
+   */
+  RCLCPP_PUBLIC
+  virtual
+  void
+  handle_messages(
+    std::vector<std::shared_ptr<void>> & messages,
+    const std::vector<rclcpp::MessageInfo> & message_infos);
+
   RCLCPP_PUBLIC
   virtual
   void
@@ -245,6 +296,8 @@ public:
   /**
    * Depending on the middleware and the message type, this will return true if the middleware
    * can allocate a ROS message instance.
+   * It's false when the subscription filters the messages in the process, only takes
+   * the newest one, or deserializes them in a pool.
    *
    * \return boolean flag indicating if middleware can loan messages.
    */
@@ -252,6 +305,24 @@ public:
   bool
   can_loan_messages() const;
 
+  /// Get the maximum number of messages taken per wake up of the executor.
+  /**
+   * \sa rclcpp::SubscriptionOptionsBase::max_messages_per_wakeup
+   * \return the maximum number of messages taken by executors at once.
+   */
+  RCLCPP_PUBLIC
+  size_t
+  get_max_messages_per_wakeup() const;
+
+  /// Return true if the callback takes the messages taken at once as a batch.
+  /**
+   * The executors then take up to get_max_messages_per_wakeup() messages with
+   * take_type_erased_sequence() and handle them with handle_messages().
+   */
+  RCLCPP_PUBLIC
+  bool
+  has_batch_callback() const;
+
   using IntraProcessManagerWeakPtr =
     std::weak_ptr<rclcpp::experimental::IntraProcessManager>;
 
@@ -271,6 +342,63 @@ public:
   rclcpp::Waitable::SharedPtr
   get_intra_process_waitable() const;
 
+  /// Return true if the messages are deserialized by a deserialization pool.
+  /**
+   * \sa rclcpp::SubscriptionOptionsBase::deserialization_pool
+   */
+  RCLCPP_PUBLIC
+  bool
+  uses_deserialization_pool() const;
+
+  /// Return the waitable handling the messages deserialized by the pool, or nullptr if none.
+  /**
+   * It has to be added to the callback group of the subscription.
+   */
+  RCLCPP_PUBLIC
+  rclcpp::Waitable::SharedPtr
+  get_deserialization_waitable() const;
+
+  /// Take the next inter-process message serialized, to deserialize it in the pool.
+  /**
+   * The messages smaller than SubscriptionOptionsBase::deserialization_pool_min_size are
+   * deserialized right away, and returned to be handled, unless older messages are still
+   * being deserialized.
+   * The other ones are handled later, by the waitable returned by
+   * get_deserialization_waitable().
+   *
+   * \param[out] message_out The message to handle, or nullptr if it's handled later
+   *   or doesn't match the content filter.
+   * \param[out] message_info_out The message info of the message to handle.
+   * \returns true if a message was taken, otherwise false
+   * \throws any rcl errors from rcl_take_serialized_message or rmw_deserialize,
+   *   \sa rclcpp::exceptions::throw_from_rcl_error()
+   */
+  RCLCPP_PUBLIC
+  bool
+  take_for_deserialization_pool(
+    std::shared_ptr<void> & message_out,
+    rclcpp::MessageInfo & message_info_out);
+
+  /// Get the occupancy of the intra-process buffer of the subscription.
+  /**
+   * The current depth, the maximum depth and the number of messages dropped because
+   * the buffer was full can be used to size the queue of the subscription.
+   *
+   * \return the counters of the buffer, all 0 if intra-process is not setup.
+   */
+  RCLCPP_PUBLIC
+  rclcpp::experimental::buffers::BufferCounters
+  get_intra_process_buffer_counters() const;
+
+  /// Return the messages received within the process since the subscription was created.
+  /**
+   * \return the counters of the messages given to the callback, all 0 if intra-process is
+   *   not setup.
+   */
+  RCLCPP_PUBLIC
+  rclcpp::IntraProcessCounters
+  get_intra_process_receive_counters() const;
+
   /// Exchange state of whether or not a part of the subscription is used by a wait set.
   /**
    * Used to ensure parts of the subscription are not used with multiple wait
@@ -511,6 +639,12 @@ public:
 
   /// Set the filter expression and expression parameters for the subscription.
   /**
+   * The filter is also applied to the intra-process messages, if it's supported.
+   * If the middleware doesn't support content filtered topics and the subscription filters
+   * the messages in the process instead, only the filter of the subscription is set.
+   * \sa rclcpp::detail::ContentFilter
+   * \sa ContentFilterOptions::filter_in_process_if_unsupported
+   *
    * \param[in] filter_expression A filter expression to set.
    *   \sa ContentFilterOptions::filter_expression
    *   An empty string ("") will clear the content filter setting of the subscription.
@@ -518,6 +652,8 @@ public:
    *   \sa ContentFilterOptions::expression_parameters
    * \throws RCLBadAlloc if memory cannot be allocated
    * \throws RCLError if an unexpect error occurs
+   * \throws std::invalid_argument if the messages are filtered in the process and the
+   *   expression isn't supported
    */
   RCLCPP_PUBLIC
   void
@@ -563,6 +699,38 @@ protected:
   void
   set_on_new_message_callback(rcl_event_callback_t callback, const void * user_data);
 
+  /// Apply a filter expression to the intra-process messages, or remove it if it's empty.
+  /**
+   * If the expression isn't supported in the process, a warning is logged and all the
+   * intra-process messages are received.
+   */
+  RCLCPP_PUBLIC
+  void
+  set_intra_process_content_filter(
+    const std::string & filter_expression,
+    const std::vector<std::string> & expression_parameters);
+
+  /// Filter the messages taken from the middleware in the process, if it doesn't support it.
+  /**
+   * If the expression isn't supported in the process, a warning is logged and all the
+   * messages are received.
+   * \sa ContentFilterOptions::filter_in_process_if_unsupported
+   */
+  RCLCPP_PUBLIC
+  void
+  enable_local_content_filter(const rclcpp::ContentFilterOptions & content_filter_options);
+
+  /// Deserialize the messages of at least min_size bytes in the pool.
+  /**
+   * It's called once the subscription is owned by a shared pointer.
+   * \sa SubscriptionOptionsBase::deserialization_pool
+   */
+  RCLCPP_PUBLIC
+  void
+  enable_deserialization_pool(
+    std::shared_ptr<rclcpp::DeserializationPool> deserialization_pool,
+    size_t min_size);
+
   rclcpp::node_interfaces::NodeBaseInterface * const node_base_;
 
   std::shared_ptr<rcl_node_t> node_handle_;
@@ -572,6 +740,7 @@ protected:
 
   std::unordered_map<rcl_subscription_event_type_t,
     std::shared_ptr<rclcpp::QOSEventHandlerBase>> event_handlers_;
+  std::shared_ptr<rclcpp::QOSEventHandlerGroup> event_handler_group_;
 
   bool use_intra_process_;
   IntraProcessManagerWeakPtr weak_ipm_;
@@ -580,11 +749,61 @@ protected:
 
   const SubscriptionEventCallbacks event_callbacks_;
 
+  size_t max_messages_per_wakeup_ = 1;
+  bool batch_callback_ = false;
+  bool take_only_latest_ = false;
+
 private:
   RCLCPP_DISABLE_COPY(SubscriptionBase)
 
+  struct LocalContentFilter;
+
+  void
+  set_local_content_filter(
+    const std::string & filter_expression,
+    const std::vector<std::string> & expression_parameters);
+
+  /// Take the next message, skipping the intra-process ones and the ones not matching.
+  /**
+   * \param[out] evaluated true if the filter was evaluated on the serialized message.
+   */
+  bool
+  take_next_serialized_message(
+    rcl_serialized_message_t & message_out,
+    rmw_message_info_t & message_info_out,
+    const rclcpp::detail::ContentFilter * content_filter,
+    bool & evaluated);
+
+  /// Replace a message taken by the newer ones, until none is left.
+  void
+  take_newer_serialized_messages(
+    rcl_serialized_message_t & message,
+    rmw_message_info_t & message_info,
+    const rclcpp::detail::ContentFilter * content_filter,
+    bool & evaluated);
+
+  bool
+  take_and_deserialize(
+    void * message_out,
+    rclcpp::MessageInfo & message_info_out,
+    const rclcpp::detail::ContentFilter * content_filter);
+
+  /// Handle a message deserialized by the pool, in the callback group of the subscription.
+  void
+  handle_deserialized_message(rclcpp::detail::DeserializedMessageQueue::Entry & entry);
+
   rosidl_message_type_support_t type_support_;
   bool is_serialized_;
+  // Cleared once the middleware returned that it doesn't support rcl_take_sequence().
+  std::atomic_bool take_sequence_supported_{true};
+
+  bool local_content_filter_enabled_ = false;
+  // Replaced atomically, as it's read by the threads taking the messages.
+  std::shared_ptr<const LocalContentFilter> local_content_filter_;
+
+  std::shared_ptr<rclcpp::DeserializationPool> deserialization_pool_;
+  size_t deserialization_pool_min_size_ = 0;
+  rclcpp::detail::DeserializedMessageQueue::SharedPtr deserialized_message_queue_;
 
   std::atomic<bool> subscription_in_use_by_wait_set_{false};
   std::atomic<bool> intra_process_subscription_waitable_in_use_by_wait_set_{false};
@@ -31,6 +31,17 @@ struct ContentFilterOptions
    * in the filter_expression. The maximum expression_parameters size is 100.
    */
   std::vector<std::string> expression_parameters;
+
+  /// Filter the messages in the process when the middleware doesn't support it.
+  /**
+   * When the middleware doesn't support content filtered topics, which
+   * SubscriptionBase::is_cft_enabled() tells, the subscription filters the messages it takes
+   * instead of giving them all to the callback.
+   * The messages are read before being deserialized if the expression can be evaluated on
+   * the serialized messages, so that the messages not matching it aren't deserialized.
+   * \sa rclcpp::detail::ContentFilter for the supported expressions.
+   */
+  bool filter_in_process_if_unsupported = false;
 };
 
 }  // namespace rclcpp
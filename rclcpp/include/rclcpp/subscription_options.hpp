@@ -23,6 +23,7 @@
 
 #include "rclcpp/callback_group.hpp"
 #include "rclcpp/detail/rmw_implementation_specific_subscription_payload.hpp"
+#include "rclcpp/intra_process_buffer_implementation.hpp"
 #include "rclcpp/intra_process_buffer_type.hpp"
 #include "rclcpp/intra_process_setting.hpp"
 #include "rclcpp/qos.hpp"
@@ -35,6 +36,9 @@
 namespace rclcpp
 {
 
+class DeserializationPool;
+class QOSEventHandlerGroup;
+
 /// Non-template base class for subscription options.
 struct SubscriptionOptionsBase
 {
@@ -44,6 +48,14 @@ struct SubscriptionOptionsBase
   /// Whether or not to use default callbacks when user doesn't supply any in event_callbacks
   bool use_default_callbacks = true;
 
+  /// Group the QoS event handlers are added to, instead of being waited on individually.
+  /**
+   * The group must be added to a callback group of the node, and then the callback group
+   * of the subscription isn't used for its events.
+   * \sa rclcpp::QOSEventHandlerGroup
+   */
+  std::shared_ptr<rclcpp::QOSEventHandlerGroup> event_handler_group = nullptr;
+
   /// True to ignore local publications.
   bool ignore_local_publications = false;
 
@@ -61,6 +73,92 @@ struct SubscriptionOptionsBase
   /// Setting the data-type stored in the intraprocess buffer
   IntraProcessBufferType intra_process_buffer_type = IntraProcessBufferType::CallbackDefault;
 
+  /// Setting the implementation of the intraprocess buffer
+  IntraProcessBufferImplementation intra_process_buffer_implementation =
+    IntraProcessBufferImplementation::RingBuffer;
+
+  /// Depth the intraprocess buffer can grow up to, 0 to keep the depth of the QoS.
+  /**
+   * When greater than the depth of the QoS, the buffer doubles its depth instead of
+   * dropping the oldest message when it's full, up to this depth, and halves it back,
+   * down to the depth of the QoS, once it has been consistently underused.
+   * The depth of the buffer and the number of changes of it are in its counters.
+   * It's ignored by the implementations of the buffer other than the ring buffer, and
+   * with take_only_latest.
+   */
+  size_t intra_process_buffer_max_depth = 0;
+
+  /// Take up to this many messages from the middleware per wake up of the executor.
+  /**
+   * Taking the messages already queued in the same wake up avoids a round trip through
+   * the wait set for each of them.
+   *
+   * With a batch callback, taking
+   * `const std::vector<std::shared_ptr<const MessageT>> &` and optionally
+   * `const std::vector<rclcpp::MessageInfo> &`, the messages are taken at once with
+   * rcl_take_sequence(), and given to the callback in a single call.
+   * They are taken one at a time if the middleware doesn't support it, and the loaned and
+   * intra-process messages are given to the batch callback as batches of one message.
+   *
+   * With the other callbacks, the executor takes the messages one at a time, until this
+   * many were taken or none is available anymore, and calls the callback for each of them.
+   * Must be at least 1.
+   */
+  size_t max_messages_per_wakeup = 1;
+
+  /// Only give the newest message to the callback each time the subscription is executed.
+  /**
+   * The messages queued by the middleware are all taken, serialized so that the older ones
+   * are dropped without being deserialized, and only the newest one is deserialized and
+   * given to the callback.
+   * This bounds the latency of a slow callback after it fell behind, at the cost of
+   * the messages received in between.
+   * The intra-process messages are kept in a buffer of one message instead.
+   * The loaned messages aren't used then.
+   */
+  bool take_only_latest = false;
+
+  /// Maximum number of messages reused by the subscription, 0 to allocate each message.
+  /**
+   * When enabled, the messages taken from the middleware are kept in a pool,
+   * which grows as needed up to this size, and are reused once the callbacks don't
+   * hold any reference to them anymore.
+   * This avoids allocating each message, and the memory for their sequences and strings,
+   * or the buffers of serialized messages, which are also used by GenericSubscription.
+   * It can't be used together with a custom message memory strategy.
+   * \sa rclcpp::strategies::recycling_message_memory_strategy::RecyclingMessageMemoryStrategy
+   */
+  size_t message_pool_size = 0;
+
+  /// Share the messages of a GenericSubscription with the other ones of the same topic.
+  /**
+   * When enabled, the serialized messages taken from the middleware are deduplicated by
+   * the gid of their publisher and their sequence number with the ones taken by the other
+   * generic subscriptions of the context to the same topic enabling it.
+   * Their callbacks then receive the same message, which they must not modify, and only
+   * one copy of it is kept while any of them holds it.
+   * It is ignored by the other subscriptions, and with middlewares not providing the
+   * sequence numbers of the messages.
+   */
+  bool share_serialized_messages = false;
+
+  /// Pool deserializing the large messages taken from the middleware, instead of the executor.
+  /**
+   * When set, the messages are taken serialized by the executor, and the ones of at least
+   * deserialization_pool_min_size bytes are deserialized by the pool.
+   * The callback is then called by the executor, in the callback group of the
+   * subscription, with the messages in the order they were taken.
+   * This keeps the deserialization of large messages from delaying the other callbacks of
+   * the executor, for one more wake up of the executor for each of them.
+   * The loaned messages aren't used then, and it's ignored by the subscriptions to
+   * serialized messages.
+   * \sa rclcpp::DeserializationPool
+   */
+  std::shared_ptr<rclcpp::DeserializationPool> deserialization_pool = nullptr;
+
+  /// Minimum size, in bytes, of the serialized messages deserialized by the pool.
+  size_t deserialization_pool_min_size = 64 * 1024;
+
   /// Optional RMW implementation specific payload to be used during creation of the subscription.
   std::shared_ptr<rclcpp::detail::RMWImplementationSpecificSubscriptionPayload>
   rmw_implementation_payload = nullptr;
@@ -77,6 +175,14 @@ struct SubscriptionOptionsBase
     // Topic statistics publication period in ms. Defaults to one second.
     // Only values greater than zero are allowed.
     std::chrono::milliseconds publish_period{std::chrono::seconds(1)};
+
+    // Also publish the latency of the messages, from their source timestamp given by the
+    // middleware to their reception, in ms. Defaults to false.
+    bool publish_message_latency = false;
+
+    // Also publish the 50th, 90th, 99th and 99.9th percentiles of the statistics, with the
+    // data types of rclcpp/topic_statistics/percentile_histogram.hpp. Defaults to false.
+    bool publish_percentiles = false;
   };
 
   TopicStatisticsOptions topic_stats_options;
@@ -0,0 +1,57 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__THREAD_ATTRIBUTES_HPP_
+#define RCLCPP__THREAD_ATTRIBUTES_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Scheduling attributes of a thread created by an executor.
+struct ThreadAttributes
+{
+  /// CPUs the thread is pinned to, the thread is not pinned if empty.
+  std::vector<size_t> cpu_affinity;
+
+  /// NUMA node whose CPUs the thread is pinned to, ignored if negative.
+  /**
+   * When cpu_affinity is not empty too, the thread is pinned to the CPUs of
+   * cpu_affinity which belong to this NUMA node.
+   */
+  int numa_node = -1;
+
+  /// Priority of the thread with the SCHED_FIFO policy, the policy is left unchanged if 0.
+  int realtime_priority = 0;
+};
+
+/// Apply the given attributes to the calling thread.
+/**
+ * Only supported on Linux, where setting a real-time priority usually
+ * requires the CAP_SYS_NICE capability or an adequate RLIMIT_RTPRIO.
+ *
+ * \param[in] attributes the attributes to apply
+ * \throws std::runtime_error if the attributes could not be applied
+ */
+RCLCPP_PUBLIC
+void
+apply_thread_attributes(const ThreadAttributes & attributes);
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__THREAD_ATTRIBUTES_HPP_
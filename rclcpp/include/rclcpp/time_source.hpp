@@ -142,6 +142,23 @@ public:
   RCLCPP_PUBLIC
   bool clock_thread_is_joinable();
 
+  /// Get whether the clock subscription shared by the nodes of the context is used or not
+  RCLCPP_PUBLIC
+  bool get_use_shared_clock_subscription();
+
+  /// Set whether to use the clock subscription shared by the nodes of the context or not
+  /**
+   * If true, the time source doesn't create a subscription to "/clock" with
+   * the attached node, it is instead updated by a single subscription of the
+   * context of the node, spun by a thread of its own, which updates all the
+   * time sources using it.
+   * The shared subscription uses rclcpp::ClockQoS(), the QoS given to the
+   * time source and the QoS overrides of the node aren't used.
+   * It must be set before attaching the node to be taken into account.
+   */
+  RCLCPP_PUBLIC
+  void set_use_shared_clock_subscription(bool use_shared_clock_subscription);
+
   /// TimeSource Destructor
   RCLCPP_PUBLIC
   ~TimeSource();
@@ -19,6 +19,7 @@
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <thread>
 #include <type_traits>
@@ -43,6 +44,15 @@
 namespace rclcpp
 {
 
+/// What a timer does when the deadlines of several of its periods passed before it was called.
+enum class MissedPeriodsPolicy
+{
+  /// The callback is called once for all the missed periods, this is the default.
+  CallOnce,
+  /// The late call is skipped, the callback is next called at the next deadline.
+  Skip,
+};
+
 class TimerBase
 {
 public:
@@ -91,12 +101,77 @@ public:
   void
   reset();
 
+  /// Set a callback called every time the timer is reset with reset().
+  /**
+   * It is called from the thread resetting the timer, after the timer was
+   * reset, and must be fast and not blocking.
+   * Only one callback can be set, setting one replaces the previous callback.
+   *
+   * \param[in] callback the callback, or nullptr to remove it
+   */
+  RCLCPP_PUBLIC
+  void
+  set_on_reset_callback(std::function<void()> callback);
+
+  /// Remove the callback set by set_on_reset_callback(), waiting for it to return if running.
+  RCLCPP_PUBLIC
+  void
+  clear_on_reset_callback();
+
+  /// Set what the timer does when it is called after the deadlines of several periods.
+  /**
+   * Whatever the policy is, the timer isn't called once per missed period,
+   * its next deadline is the first one still to come, so that it doesn't drift.
+   *
+   * \param[in] policy the policy, MissedPeriodsPolicy::CallOnce by default
+   */
+  RCLCPP_PUBLIC
+  void
+  set_missed_periods_policy(MissedPeriodsPolicy policy);
+
+  /// Return what the timer does when it is called after the deadlines of several periods.
+  RCLCPP_PUBLIC
+  MissedPeriodsPolicy
+  get_missed_periods_policy() const;
+
+  /// Return the number of periods missed before the last call of the timer.
+  /**
+   * It is the number of deadlines which passed between the one the timer was
+   * last called for and the call, so 0 when the timer was called in time.
+   * A callback taking the timer as argument can use it to catch up with the
+   * missed periods at once.
+   */
+  RCLCPP_PUBLIC
+  size_t
+  get_number_of_missed_periods() const;
+
+  /// Set how late the timer may be notified, so that it can share a wake up with other timers.
+  /**
+   * A timer whose deadline passed less than its slack before another timer
+   * is notified is notified at the same time, instead of waking up the thread
+   * waiting for the timers once more.
+   * Only the timers manager used by the rclcpp::executors::EventsExecutor
+   * uses it, the other executors wake up at the deadline of each timer.
+   *
+   * \param[in] slack the maximum delay, 0 by default
+   * \throws std::invalid_argument if the slack is negative
+   */
+  RCLCPP_PUBLIC
+  void
+  set_slack(std::chrono::nanoseconds slack);
+
+  /// Return how late the timer may be notified.
+  RCLCPP_PUBLIC
+  std::chrono::nanoseconds
+  get_slack() const;
+
   /// Indicate that we're about to execute the callback.
   /**
    * The multithreaded executor takes advantage of this to avoid scheduling
    * the callback multiple times.
    *
-   * \return `true` if the callback should be executed, `false` if the timer was canceled.
+   * \return `true` if the callback should be executed, `false` if the timer was canceled or
+   *   if the call was skipped because of the missed periods policy.
    */
   RCLCPP_PUBLIC
   virtual bool
@@ -150,10 +225,25 @@ public:
   exchange_in_use_by_wait_set_state(bool in_use_state);
 
 protected:
+  /// Update the number of missed periods, before the timer is called.
+  /**
+   * \return true if the call must be skipped because of the missed periods policy
+   */
+  RCLCPP_PUBLIC
+  bool
+  update_missed_periods();
+
   Clock::SharedPtr clock_;
   std::shared_ptr<rcl_timer_t> timer_handle_;
 
+  std::atomic<MissedPeriodsPolicy> missed_periods_policy_{MissedPeriodsPolicy::CallOnce};
+  std::atomic_size_t number_of_missed_periods_{0};
+  std::atomic<int64_t> slack_{0};
+
   std::atomic<bool> in_use_by_wait_set_{false};
+
+  std::mutex on_reset_callback_mutex_;
+  std::function<void()> on_reset_callback_{nullptr};
 };
 
 
@@ -210,6 +300,7 @@ public:
   bool
   call() override
   {
+    const bool skip_call = update_missed_periods();
     rcl_ret_t ret = rcl_timer_call(timer_handle_.get());
     if (ret == RCL_RET_TIMER_CANCELED) {
       return false;
@@ -217,7 +308,8 @@ public:
     if (ret != RCL_RET_OK) {
       throw std::runtime_error("Failed to notify timer that callback occurred");
     }
-    return true;
+    // The timer was called anyway, so that its next deadline is the next one to come.
+    return !skip_call;
   }
 
   /**
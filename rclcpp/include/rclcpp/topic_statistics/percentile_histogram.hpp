@@ -0,0 +1,204 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__TOPIC_STATISTICS__PERCENTILE_HISTOGRAM_HPP_
+#define RCLCPP__TOPIC_STATISTICS__PERCENTILE_HISTOGRAM_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include "statistics_msgs/msg/metrics_message.hpp"
+#include "statistics_msgs/msg/statistic_data_point.hpp"
+
+namespace rclcpp
+{
+namespace topic_statistics
+{
+
+/// Data types of the percentiles in the statistics of a MetricsMessage.
+/**
+ * They follow the types of statistics_msgs/msg/StatisticDataType, leaving room for new ones.
+ */
+constexpr const uint8_t kStatisticsDataTypePercentile50{100};
+constexpr const uint8_t kStatisticsDataTypePercentile90{101};
+constexpr const uint8_t kStatisticsDataTypePercentile99{102};
+constexpr const uint8_t kStatisticsDataTypePercentile999{103};
+
+/// Percentiles of the samples of a window, NaN if it has no samples.
+struct PercentileStatistics
+{
+  double p50 = std::numeric_limits<double>::quiet_NaN();
+  double p90 = std::numeric_limits<double>::quiet_NaN();
+  double p99 = std::numeric_limits<double>::quiet_NaN();
+  double p999 = std::numeric_limits<double>::quiet_NaN();
+};
+
+/// Histogram of non-negative samples, with buckets of a bounded relative width.
+/**
+ * As with HDR histograms, each power of two is split into linear sub-buckets, so that
+ * a percentile is known within 1/32 of its value, from about a nanosecond to hours when
+ * the samples are durations in milliseconds.
+ * The samples above this range are counted in the last bucket, and the ones below it
+ * in the first one.
+ *
+ * Adding samples doesn't lock nor allocate, and can be done concurrently.
+ */
+class PercentileHistogram
+{
+public:
+  /// Number of linear sub-buckets of each power of two.
+  static constexpr size_t kNumberOfSubBuckets = 16u;
+  /// Exponents, as given by std::frexp(), of the smallest and largest samples told apart.
+  static constexpr int kMinExponent = -20;
+  static constexpr int kMaxExponent = 24;
+  /// The first bucket counts the samples below the smallest power of two.
+  static constexpr size_t kNumberOfBuckets =
+    1u + static_cast<size_t>(kMaxExponent - kMinExponent + 1) * kNumberOfSubBuckets;
+
+  /// Add a sample, the negative ones being counted as 0.
+  void
+  add_sample(double sample) noexcept
+  {
+    buckets_[get_bucket_index(sample)].fetch_add(1u, std::memory_order_relaxed);
+    count_.fetch_add(1u, std::memory_order_relaxed);
+  }
+
+  /// Return the given percentile of the samples, in [0, 100], or NaN if there are none.
+  /**
+   * The value returned is the middle of the bucket of the percentile.
+   */
+  double
+  get_percentile(double percentile) const noexcept
+  {
+    const uint64_t count = count_.load(std::memory_order_relaxed);
+    if (0u == count) {
+      return std::numeric_limits<double>::quiet_NaN();
+    }
+    const double clamped_percentile = std::min(std::max(percentile, 0.), 100.);
+    const uint64_t rank = std::max<uint64_t>(
+      1u, static_cast<uint64_t>(std::ceil(clamped_percentile / 100. * static_cast<double>(count))));
+    uint64_t cumulative_count = 0u;
+    for (size_t i = 0; i < kNumberOfBuckets; ++i) {
+      cumulative_count += buckets_[i].load(std::memory_order_relaxed);
+      if (cumulative_count >= rank) {
+        return get_bucket_value(i);
+      }
+    }
+    // The samples being added concurrently may be missing from the buckets.
+    return get_bucket_value(kNumberOfBuckets - 1u);
+  }
+
+  /// Return the 50th, 90th, 99th and 99.9th percentiles of the samples.
+  PercentileStatistics
+  get_percentiles() const noexcept
+  {
+    PercentileStatistics percentiles;
+    percentiles.p50 = get_percentile(50.);
+    percentiles.p90 = get_percentile(90.);
+    percentiles.p99 = get_percentile(99.);
+    percentiles.p999 = get_percentile(99.9);
+    return percentiles;
+  }
+
+  /// Return the number of samples.
+  uint64_t
+  get_sample_count() const noexcept
+  {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  /// Remove all the samples.
+  void
+  clear() noexcept
+  {
+    for (auto & bucket : buckets_) {
+      bucket.store(0u, std::memory_order_relaxed);
+    }
+    count_.store(0u, std::memory_order_relaxed);
+  }
+
+private:
+  static
+  size_t
+  get_bucket_index(double sample) noexcept
+  {
+    if (!(sample > 0.)) {
+      return 0u;
+    }
+    int exponent = 0;
+    const double mantissa = std::frexp(sample, &exponent);
+    if (exponent < kMinExponent) {
+      return 0u;
+    }
+    if (exponent > kMaxExponent) {
+      return kNumberOfBuckets - 1u;
+    }
+    // The mantissa is in [0.5, 1).
+    const auto sub_bucket = std::min(
+      kNumberOfSubBuckets - 1u,
+      static_cast<size_t>((mantissa * 2. - 1.) * static_cast<double>(kNumberOfSubBuckets)));
+    return 1u + static_cast<size_t>(exponent - kMinExponent) * kNumberOfSubBuckets + sub_bucket;
+  }
+
+  static
+  double
+  get_bucket_value(size_t index) noexcept
+  {
+    if (0u == index) {
+      return 0.;
+    }
+    const int exponent = kMinExponent + static_cast<int>((index - 1u) / kNumberOfSubBuckets);
+    const auto sub_bucket = static_cast<double>((index - 1u) % kNumberOfSubBuckets);
+    const double mantissa =
+      0.5 + (sub_bucket + 0.5) / (2. * static_cast<double>(kNumberOfSubBuckets));
+    return std::ldexp(mantissa, exponent);
+  }
+
+  std::array<std::atomic<uint32_t>, kNumberOfBuckets> buckets_{};
+  std::atomic<uint64_t> count_{0u};
+};
+
+/// Append the percentiles to the statistics of a message, unless there were no samples.
+inline
+void
+add_percentiles_to_message(
+  statistics_msgs::msg::MetricsMessage & message,
+  const PercentileStatistics & percentiles)
+{
+  if (std::isnan(percentiles.p50)) {
+    return;
+  }
+  for (const auto & type_and_value : {
+      std::make_pair(kStatisticsDataTypePercentile50, percentiles.p50),
+      std::make_pair(kStatisticsDataTypePercentile90, percentiles.p90),
+      std::make_pair(kStatisticsDataTypePercentile99, percentiles.p99),
+      std::make_pair(kStatisticsDataTypePercentile999, percentiles.p999)})
+  {
+    statistics_msgs::msg::StatisticDataPoint data_point;
+    data_point.data_type = type_and_value.first;
+    data_point.data = type_and_value.second;
+    message.statistics.push_back(data_point);
+  }
+}
+
+}  // namespace topic_statistics
+}  // namespace rclcpp
+
+#endif  // RCLCPP__TOPIC_STATISTICS__PERCENTILE_HISTOGRAM_HPP_
@@ -0,0 +1,187 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__TOPIC_STATISTICS__PUBLISHER_TOPIC_STATISTICS_HPP_
+#define RCLCPP__TOPIC_STATISTICS__PUBLISHER_TOPIC_STATISTICS_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "libstatistics_collector/moving_average_statistics/types.hpp"
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/time.hpp"
+#include "rclcpp/timer.hpp"
+#include "rclcpp/topic_statistics/statistics_accumulator.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+#include "statistics_msgs/msg/metrics_message.hpp"
+
+namespace rclcpp
+{
+
+template<typename MessageT, typename AllocatorT>
+class Publisher;
+
+namespace topic_statistics
+{
+
+constexpr const char kPublishPeriodStatName[]{"publish_period"};
+constexpr const char kPublishDurationStatName[]{"publish_duration"};
+constexpr const char kPublishedMessageSizeStatName[]{"published_message_size"};
+constexpr const char kIntraProcessPublishStatName[]{"intra_process_publish"};
+constexpr const char kInterProcessPublishStatName[]{"inter_process_publish"};
+
+/// Class used to collect, measure, and publish the statistics of a publisher.
+/**
+ * The statistics are the period between the publications and the duration of the calls
+ * to Publisher::publish(), in milliseconds, the size in bytes of the serialized messages
+ * published to the middleware, which is only known when they are published serialized,
+ * and the counts of the deliveries to the intra-process and inter-process subscriptions,
+ * which are the sample counts of their statistics, whose values are all 1.
+ *
+ * The measurements are accumulated without locking, and only turned into statistics
+ * messages when they are published.
+ */
+class PublisherTopicStatistics
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(PublisherTopicStatistics)
+
+  using StatisticsPublisher =
+    rclcpp::Publisher<statistics_msgs::msg::MetricsMessage, std::allocator<void>>;
+  using StatisticData = libstatistics_collector::moving_average_statistics::StatisticData;
+
+  /// Construct a PublisherTopicStatistics object.
+  /**
+   * \param node_name the name of the node which created the measured publisher,
+   * in order to denote topic source
+   * \param publisher publisher used to publish the statistics data, which this class owns
+   * \throws std::invalid_argument if publisher pointer is nullptr
+   */
+  RCLCPP_PUBLIC
+  PublisherTopicStatistics(
+    const std::string & node_name,
+    std::shared_ptr<StatisticsPublisher> publisher);
+
+  RCLCPP_PUBLIC
+  virtual ~PublisherTopicStatistics();
+
+  /// Handle a call to Publisher::publish(), which started at the given time and lasted duration.
+  RCLCPP_PUBLIC
+  void
+  handle_publish(
+    std::chrono::steady_clock::time_point start,
+    std::chrono::nanoseconds duration) noexcept;
+
+  /// Handle a message delivered to the intra-process subscriptions.
+  RCLCPP_PUBLIC
+  void
+  handle_intra_process_publish() noexcept;
+
+  /// Handle a message published to the middleware.
+  /**
+   * \param serialized_size size of the serialized message, or 0 if it isn't known
+   */
+  RCLCPP_PUBLIC
+  void
+  handle_inter_process_publish(size_t serialized_size = 0u) noexcept;
+
+  /// Set the timer used to publish statistics messages.
+  RCLCPP_PUBLIC
+  void
+  set_publisher_timer(rclcpp::TimerBase::SharedPtr publisher_timer);
+
+  /// Publish the statistics measured since the previous call.
+  RCLCPP_PUBLIC
+  virtual
+  void
+  publish_message_and_reset_measurements();
+
+protected:
+  /// Return the statistics currently measured.
+  /**
+   * \return the statistics of the publish periods, publish durations, published message
+   * sizes, intra-process publications and inter-process publications, in that order
+   */
+  RCLCPP_PUBLIC
+  std::vector<StatisticData>
+  get_current_collector_data() const;
+
+private:
+  static constexpr int64_t kNoPublishTime = std::numeric_limits<int64_t>::min();
+
+  const std::string node_name_;
+  std::shared_ptr<StatisticsPublisher> publisher_;
+  rclcpp::TimerBase::SharedPtr publisher_timer_;
+  rclcpp::Time window_start_;
+
+  StatisticsAccumulator publish_period_;
+  StatisticsAccumulator publish_duration_;
+  StatisticsAccumulator published_message_size_;
+  StatisticsAccumulator intra_process_publish_;
+  StatisticsAccumulator inter_process_publish_;
+  std::atomic<int64_t> last_publish_time_{kNoPublishTime};
+};
+
+/// Measurement of the duration of a call to Publisher::publish().
+/**
+ * Nothing is measured without statistics, and only the outermost measurement of
+ * a thread is handled, as some publish() overloads call others.
+ */
+class PublishMeasurement
+{
+public:
+  explicit PublishMeasurement(PublisherTopicStatistics * statistics)
+  : statistics_(statistics && enter() ? statistics : nullptr)
+  {
+    if (statistics_) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~PublishMeasurement()
+  {
+    if (statistics_) {
+      statistics_->handle_publish(start_, std::chrono::steady_clock::now() - start_);
+      exit();
+    }
+  }
+
+private:
+  RCLCPP_DISABLE_COPY(PublishMeasurement)
+
+  /// Return true if no measurement is in progress in the calling thread.
+  RCLCPP_PUBLIC
+  static bool
+  enter() noexcept;
+
+  RCLCPP_PUBLIC
+  static void
+  exit() noexcept;
+
+  PublisherTopicStatistics * statistics_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace topic_statistics
+}  // namespace rclcpp
+
+#endif  // RCLCPP__TOPIC_STATISTICS__PUBLISHER_TOPIC_STATISTICS_HPP_
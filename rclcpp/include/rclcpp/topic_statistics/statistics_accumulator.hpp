@@ -0,0 +1,226 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__TOPIC_STATISTICS__STATISTICS_ACCUMULATOR_HPP_
+#define RCLCPP__TOPIC_STATISTICS__STATISTICS_ACCUMULATOR_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "libstatistics_collector/moving_average_statistics/types.hpp"
+
+#include "rclcpp/topic_statistics/percentile_histogram.hpp"
+
+namespace rclcpp
+{
+namespace topic_statistics
+{
+
+/// Statistics of samples, accumulated without locking.
+/**
+ * The samples are accumulated into one of two windows, with atomic operations only.
+ * Taking the statistics switches to the other window, and then waits for the samples
+ * being added to the previous one, so that its statistics are consistent.
+ * The windows can also record the samples in a PercentileHistogram, to take their percentiles.
+ */
+class StatisticsAccumulator
+{
+public:
+  using StatisticData = libstatistics_collector::moving_average_statistics::StatisticData;
+
+  /// Constructor.
+  /**
+   * \param[in] collect_percentiles whether the percentiles of the samples are collected too.
+   */
+  explicit StatisticsAccumulator(bool collect_percentiles = false)
+  {
+    if (collect_percentiles) {
+      for (auto & window : windows_) {
+        window.histogram = std::make_unique<PercentileHistogram>();
+      }
+    }
+  }
+
+  /// Return true if the percentiles of the samples are collected.
+  bool
+  collects_percentiles() const noexcept
+  {
+    return nullptr != windows_[0].histogram;
+  }
+
+  /// Add a sample to the current window.
+  void
+  add_sample(double sample) noexcept
+  {
+    while (true) {
+      const size_t index = current_window_.load();
+      Window & window = windows_[index];
+      window.number_of_writers.fetch_add(1u);
+      if (current_window_.load() == index) {
+        window.add_sample(sample);
+        window.number_of_writers.fetch_sub(1u, std::memory_order_release);
+        return;
+      }
+      // The window was switched in the meantime, and may be read.
+      window.number_of_writers.fetch_sub(1u, std::memory_order_release);
+    }
+  }
+
+  /// Return the statistics of the current window, which may miss the samples being added.
+  StatisticData
+  get_statistics() const noexcept
+  {
+    return windows_[current_window_.load()].get_statistics();
+  }
+
+  /// Return the statistics of the current window, and start a new one.
+  StatisticData
+  take_statistics()
+  {
+    PercentileStatistics percentiles;
+    return take_statistics(percentiles);
+  }
+
+  /// Return the statistics and the percentiles of the current window, and start a new one.
+  /**
+   * \param[out] percentiles the percentiles of the samples, NaN if they aren't collected.
+   */
+  StatisticData
+  take_statistics(PercentileStatistics & percentiles)
+  {
+    std::lock_guard<std::mutex> lock(take_mutex_);
+    const size_t index = current_window_.load();
+    current_window_.store(1u - index);
+    Window & window = windows_[index];
+    while (window.number_of_writers.load(std::memory_order_acquire) != 0u) {
+      std::this_thread::yield();
+    }
+    const StatisticData statistics = window.get_statistics();
+    percentiles = window.get_percentiles(statistics);
+    window.clear();
+    return statistics;
+  }
+
+private:
+  struct Window
+  {
+    void
+    add_sample(double sample) noexcept
+    {
+      add(sum, sample);
+      add(sum_of_squares, sample * sample);
+      double current_min = min.load(std::memory_order_relaxed);
+      while (sample < current_min &&
+        !min.compare_exchange_weak(current_min, sample, std::memory_order_relaxed))
+      {
+      }
+      double current_max = max.load(std::memory_order_relaxed);
+      while (sample > current_max &&
+        !max.compare_exchange_weak(current_max, sample, std::memory_order_relaxed))
+      {
+      }
+      sample_count.fetch_add(1u, std::memory_order_relaxed);
+      if (histogram) {
+        histogram->add_sample(sample);
+      }
+    }
+
+    StatisticData
+    get_statistics() const noexcept
+    {
+      // The statistics of an empty window are NaN, as with the moving average statistics.
+      StatisticData statistics;
+      const uint64_t count = sample_count.load(std::memory_order_relaxed);
+      if (0u == count) {
+        return statistics;
+      }
+      const double average = sum.load(std::memory_order_relaxed) / static_cast<double>(count);
+      const double variance =
+        sum_of_squares.load(std::memory_order_relaxed) / static_cast<double>(count) -
+        average * average;
+      statistics.average = average;
+      statistics.min = min.load(std::memory_order_relaxed);
+      statistics.max = max.load(std::memory_order_relaxed);
+      statistics.standard_deviation = std::sqrt(std::max(variance, 0.));
+      statistics.sample_count = count;
+      return statistics;
+    }
+
+    PercentileStatistics
+    get_percentiles(const StatisticData & statistics) const noexcept
+    {
+      if (!histogram || 0u == statistics.sample_count) {
+        return PercentileStatistics();
+      }
+      // The middle of a bucket may be out of the range of its samples.
+      auto clamp = [&statistics](double value) {
+          return std::min(std::max(value, statistics.min), statistics.max);
+        };
+      PercentileStatistics percentiles = histogram->get_percentiles();
+      percentiles.p50 = clamp(percentiles.p50);
+      percentiles.p90 = clamp(percentiles.p90);
+      percentiles.p99 = clamp(percentiles.p99);
+      percentiles.p999 = clamp(percentiles.p999);
+      return percentiles;
+    }
+
+    void
+    clear() noexcept
+    {
+      if (histogram) {
+        histogram->clear();
+      }
+      sample_count.store(0u, std::memory_order_relaxed);
+      sum.store(0., std::memory_order_relaxed);
+      sum_of_squares.store(0., std::memory_order_relaxed);
+      min.store(std::numeric_limits<double>::infinity(), std::memory_order_relaxed);
+      max.store(-std::numeric_limits<double>::infinity(), std::memory_order_relaxed);
+    }
+
+    static void
+    add(std::atomic<double> & value, double increment) noexcept
+    {
+      double current = value.load(std::memory_order_relaxed);
+      while (!value.compare_exchange_weak(
+          current, current + increment, std::memory_order_relaxed))
+      {
+      }
+    }
+
+    std::atomic<size_t> number_of_writers{0u};
+    std::atomic<uint64_t> sample_count{0u};
+    std::atomic<double> sum{0.};
+    std::atomic<double> sum_of_squares{0.};
+    std::atomic<double> min{std::numeric_limits<double>::infinity()};
+    std::atomic<double> max{-std::numeric_limits<double>::infinity()};
+    std::unique_ptr<PercentileHistogram> histogram;
+  };
+
+  std::array<Window, 2> windows_;
+  std::atomic<size_t> current_window_{0u};
+  std::mutex take_mutex_;
+};
+
+}  // namespace topic_statistics
+}  // namespace rclcpp
+
+#endif  // RCLCPP__TOPIC_STATISTICS__STATISTICS_ACCUMULATOR_HPP_
@@ -15,6 +15,10 @@
 #ifndef RCLCPP__TOPIC_STATISTICS__SUBSCRIPTION_TOPIC_STATISTICS_HPP_
 #define RCLCPP__TOPIC_STATISTICS__SUBSCRIPTION_TOPIC_STATISTICS_HPP_
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
@@ -24,12 +28,15 @@
 #include "libstatistics_collector/moving_average_statistics/types.hpp"
 #include "libstatistics_collector/topic_statistics_collector/constants.hpp"
 #include "libstatistics_collector/topic_statistics_collector/received_message_age.hpp"
-#include "libstatistics_collector/topic_statistics_collector/received_message_period.hpp"
 
 #include "rcl/time.h"
+#include "rclcpp/experimental/subscription_intra_process_base.hpp"
+#include "rclcpp/message_info.hpp"
 #include "rclcpp/time.hpp"
 #include "rclcpp/publisher.hpp"
 #include "rclcpp/timer.hpp"
+#include "rclcpp/topic_statistics/percentile_histogram.hpp"
+#include "rclcpp/topic_statistics/statistics_accumulator.hpp"
 
 #include "statistics_msgs/msg/metrics_message.hpp"
 
@@ -40,6 +47,11 @@ namespace topic_statistics
 
 constexpr const char kDefaultPublishTopicName[]{"/statistics"};
 constexpr const std::chrono::milliseconds kDefaultPublishingPeriod{std::chrono::seconds(1)};
+constexpr const char kMessageLatencyStatName[]{"message_latency"};
+constexpr const char kIntraProcessBufferDepthStatName[]{"intra_process_buffer_depth"};
+constexpr const char kIntraProcessBufferHighWaterMarkStatName[]{
+  "intra_process_buffer_high_water_mark"};
+constexpr const char kIntraProcessDroppedMessagesStatName[]{"intra_process_dropped_messages"};
 
 using libstatistics_collector::collector::GenerateStatisticMessage;
 using statistics_msgs::msg::MetricsMessage;
@@ -48,21 +60,19 @@ using libstatistics_collector::moving_average_statistics::StatisticData;
 /**
  * Class used to collect, measure, and publish topic statistics data. Current statistics
  * supported for subscribers are received message age and received message period.
+ * With intra-process communication, the occupancy of the buffer of the subscription
+ * is published as well.
+ *
+ * The measurements are accumulated without locking, and only turned into statistics
+ * messages when they are published.
  *
  * \tparam CallbackMessageT the subscribed message type
  */
 template<typename CallbackMessageT>
 class SubscriptionTopicStatistics
 {
-  using TopicStatsCollector =
-    libstatistics_collector::topic_statistics_collector::TopicStatisticsCollector<
-    CallbackMessageT>;
-  using ReceivedMessageAge =
-    libstatistics_collector::topic_statistics_collector::ReceivedMessageAgeCollector<
-    CallbackMessageT>;
-  using ReceivedMessagePeriod =
-    libstatistics_collector::topic_statistics_collector::ReceivedMessagePeriodCollector<
-    CallbackMessageT>;
+  using TimeStamp =
+    libstatistics_collector::topic_statistics_collector::TimeStamp<CallbackMessageT>;
 
 public:
   /// Construct a SubscriptionTopicStatistics object.
@@ -75,13 +85,23 @@ public:
    * topic source
    * \param publisher instance constructed by the node in order to publish statistics data.
    * This class owns the publisher.
+   * \param publish_message_latency whether the latency of the messages, between their
+   * source timestamp and their reception, is published as well.
+   * \param publish_percentiles whether the 50th, 90th, 99th and 99.9th percentiles of the
+   * measurements are added to their messages.
    * \throws std::invalid_argument if publisher pointer is nullptr
    */
   SubscriptionTopicStatistics(
     const std::string & node_name,
-    rclcpp::Publisher<statistics_msgs::msg::MetricsMessage>::SharedPtr publisher)
-  : node_name_(node_name),
-    publisher_(std::move(publisher))
+    rclcpp::Publisher<statistics_msgs::msg::MetricsMessage>::SharedPtr publisher,
+    bool publish_message_latency = false,
+    bool publish_percentiles = false)
+  : message_age_(publish_percentiles),
+    message_period_(publish_percentiles),
+    message_latency_(publish_percentiles),
+    node_name_(node_name),
+    publisher_(std::move(publisher)),
+    publish_message_latency_(publish_message_latency)
   {
     // TODO(dbbonnie): ros-tooling/aws-roadmap/issues/226, received message age
 
@@ -99,7 +119,7 @@ public:
 
   /// Handle a message received by the subscription to collect statistics.
   /**
-   * This method acquires a lock to prevent race conditions to collectors list.
+   * This method doesn't lock, and can be called concurrently.
    *
    * \param received_message the message received by the subscription
    * \param now_nanoseconds current time in nanoseconds
@@ -108,9 +128,41 @@ public:
     const CallbackMessageT & received_message,
     const rclcpp::Time now_nanoseconds) const
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto & collector : subscriber_statistics_collectors_) {
-      collector->OnMessageReceived(received_message, now_nanoseconds.nanoseconds());
+    const int64_t now = now_nanoseconds.nanoseconds();
+
+    const auto timestamp_from_header = TimeStamp::value(received_message);
+    if (timestamp_from_header.first && timestamp_from_header.second != 0) {
+      const std::chrono::nanoseconds age{now - timestamp_from_header.second};
+      message_age_.add_sample(std::chrono::duration<double, std::milli>(age).count());
+    }
+
+    const int64_t last_time = last_message_time_.exchange(now);
+    if (last_time != kNoMessageTime) {
+      const std::chrono::nanoseconds period{now - last_time};
+      message_period_.add_sample(std::chrono::duration<double, std::milli>(period).count());
+    }
+  }
+
+  /// Handle the information of a message received by the subscription to collect statistics.
+  /**
+   * This method doesn't lock, and can be called concurrently.
+   * The latency is only measured if the middleware gives the source timestamps.
+   *
+   * \param message_info the information of the message received by the subscription
+   * \param now_nanoseconds current time in nanoseconds
+   */
+  virtual void handle_message_info(
+    const rclcpp::MessageInfo & message_info,
+    const rclcpp::Time now_nanoseconds) const
+  {
+    if (!publish_message_latency_) {
+      return;
+    }
+    const rmw_time_point_value_t source_timestamp =
+      message_info.get_rmw_message_info().source_timestamp;
+    if (source_timestamp != 0) {
+      const std::chrono::nanoseconds latency{now_nanoseconds.nanoseconds() - source_timestamp};
+      message_latency_.add_sample(std::chrono::duration<double, std::milli>(latency).count());
     }
   }
 
@@ -123,34 +175,57 @@ public:
     publisher_timer_ = publisher_timer;
   }
 
+  /// Set the intra-process subscription whose buffer occupancy is published.
+  /**
+   * Its depth when publishing, the maximum depth and the number of messages dropped during
+   * the window are then published, as single samples.
+   *
+   * \param subscription_intra_process the intra-process subscription, owned by the subscription
+   */
+  void set_intra_process_subscription(
+    std::weak_ptr<const rclcpp::experimental::SubscriptionIntraProcessBase>
+    subscription_intra_process)
+  {
+    subscription_intra_process_ = std::move(subscription_intra_process);
+  }
+
   /// Publish a populated MetricsStatisticsMessage.
   /**
-   * This method acquires a lock to prevent race conditions to collectors list.
+   * The measurements accumulated since the previous call are merged into the messages.
    */
   virtual void publish_message_and_reset_measurements()
   {
-    std::vector<MetricsMessage> msgs;
-    rclcpp::Time window_end{get_current_nanoseconds_since_epoch()};
+    using libstatistics_collector::topic_statistics_collector::topic_statistics_constants::
+      kMillisecondUnitName;
+    using libstatistics_collector::topic_statistics_collector::topic_statistics_constants::
+      kMsgAgeStatName;
+    using libstatistics_collector::topic_statistics_collector::topic_statistics_constants::
+      kMsgPeriodStatName;
 
-    {
-      std::lock_guard<std::mutex> lock(mutex_);
-      for (auto & collector : subscriber_statistics_collectors_) {
-        const auto collected_stats = collector->GetStatisticsResults();
-        collector->ClearCurrentMeasurements();
-
-        auto message = libstatistics_collector::collector::GenerateStatisticMessage(
-          node_name_,
-          collector->GetMetricName(),
-          collector->GetMetricUnit(),
-          window_start_,
-          window_end,
-          collected_stats);
-        msgs.push_back(message);
-      }
+    rclcpp::Time window_end{get_current_nanoseconds_since_epoch()};
+    publish_statistics(message_age_, kMsgAgeStatName, kMillisecondUnitName, window_end);
+    publish_statistics(message_period_, kMsgPeriodStatName, kMillisecondUnitName, window_end);
+    if (publish_message_latency_) {
+      publish_statistics(
+        message_latency_, kMessageLatencyStatName, kMillisecondUnitName, window_end);
     }
-
-    for (auto & msg : msgs) {
-      publisher_->publish(msg);
+    auto subscription_intra_process = subscription_intra_process_.lock();
+    if (subscription_intra_process) {
+      const auto counters = subscription_intra_process->get_buffer_counters();
+      publisher_->publish(
+        libstatistics_collector::collector::GenerateStatisticMessage(
+          node_name_, kIntraProcessBufferDepthStatName, kCountUnitName, window_start_,
+          window_end, get_single_sample(static_cast<double>(counters.depth))));
+      publisher_->publish(
+        libstatistics_collector::collector::GenerateStatisticMessage(
+          node_name_, kIntraProcessBufferHighWaterMarkStatName, kCountUnitName, window_start_,
+          window_end, get_single_sample(static_cast<double>(counters.high_water_mark))));
+      publisher_->publish(
+        libstatistics_collector::collector::GenerateStatisticMessage(
+          node_name_, kIntraProcessDroppedMessagesStatName, kCountUnitName, window_start_,
+          window_end,
+          get_single_sample(static_cast<double>(counters.dropped - last_dropped_messages_))));
+      last_dropped_messages_ = counters.dropped;
     }
     window_start_ = window_end;
   }
@@ -158,56 +233,29 @@ public:
 protected:
   /// Return a vector of all the currently collected data.
   /**
-   * This method acquires a lock to prevent race conditions to collectors list.
-   *
-   * \return a vector of all the collected data
+   * \return a vector of all the collected data, for the message age, the period and then
+   * the latency if it's published
    */
   std::vector<StatisticData> get_current_collector_data() const
   {
-    std::vector<StatisticData> data;
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto & collector : subscriber_statistics_collectors_) {
-      data.push_back(collector->GetStatisticsResults());
+    std::vector<StatisticData> data{
+      message_age_.get_statistics(), message_period_.get_statistics()};
+    if (publish_message_latency_) {
+      data.push_back(message_latency_.get_statistics());
     }
     return data;
   }
 
 private:
-  /// Construct and start all collectors and set window_start_.
-  /**
-   * This method acquires a lock to prevent race conditions to collectors list.
-   */
+  /// Set window_start_.
   void bring_up()
   {
-    auto received_message_age = std::make_unique<ReceivedMessageAge>();
-    received_message_age->Start();
-    subscriber_statistics_collectors_.emplace_back(std::move(received_message_age));
-
-    auto received_message_period = std::make_unique<ReceivedMessagePeriod>();
-    received_message_period->Start();
-    {
-      std::lock_guard<std::mutex> lock(mutex_);
-      subscriber_statistics_collectors_.emplace_back(std::move(received_message_period));
-    }
-
     window_start_ = rclcpp::Time(get_current_nanoseconds_since_epoch());
   }
 
-  /// Stop all collectors, clear measurements, stop publishing timer, and reset publisher.
-  /**
-   * This method acquires a lock to prevent race conditions to collectors list.
-   */
+  /// Stop publishing timer, and reset publisher.
   void tear_down()
   {
-    {
-      std::lock_guard<std::mutex> lock(mutex_);
-      for (auto & collector : subscriber_statistics_collectors_) {
-        collector->Stop();
-      }
-
-      subscriber_statistics_collectors_.clear();
-    }
-
     if (publisher_timer_) {
       publisher_timer_->cancel();
       publisher_timer_.reset();
@@ -216,6 +264,21 @@ private:
     publisher_.reset();
   }
 
+  /// Publish the statistics of a window of measurements, and their percentiles if collected.
+  void publish_statistics(
+    StatisticsAccumulator & accumulator,
+    const std::string & metric_name,
+    const std::string & unit,
+    const rclcpp::Time & window_end)
+  {
+    PercentileStatistics percentiles;
+    const auto statistics = accumulator.take_statistics(percentiles);
+    auto message = libstatistics_collector::collector::GenerateStatisticMessage(
+      node_name_, metric_name, unit, window_start_, window_end, statistics);
+    add_percentiles_to_message(message, percentiles);
+    publisher_->publish(message);
+  }
+
   /// Return the current nanoseconds (count) since epoch.
   /**
    * \return the current nanoseconds (count) since epoch
@@ -226,18 +289,44 @@ private:
     return std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
   }
 
-  /// Mutex to protect the subsequence vectors
-  mutable std::mutex mutex_;
-  /// Collection of statistics collectors
-  std::vector<std::unique_ptr<TopicStatsCollector>> subscriber_statistics_collectors_{};
+  /// Return the statistics of a single sample.
+  static StatisticData get_single_sample(double value)
+  {
+    StatisticData data;
+    data.average = value;
+    data.min = value;
+    data.max = value;
+    data.standard_deviation = 0.;
+    data.sample_count = 1u;
+    return data;
+  }
+
+  static constexpr int64_t kNoMessageTime = std::numeric_limits<int64_t>::min();
+  static constexpr const char kCountUnitName[]{"count"};
+
+  /// Ages of the received messages with a header, in milliseconds
+  mutable StatisticsAccumulator message_age_;
+  /// Periods between the received messages, in milliseconds
+  mutable StatisticsAccumulator message_period_;
+  /// Time at which the last message was received
+  mutable std::atomic<int64_t> last_message_time_{kNoMessageTime};
+  /// Latencies of the received messages, in milliseconds
+  mutable StatisticsAccumulator message_latency_;
   /// Node name used to generate topic statistics messages to be published
   const std::string node_name_;
   /// Publisher, created by the node, used to publish topic statistics messages
   rclcpp::Publisher<statistics_msgs::msg::MetricsMessage>::SharedPtr publisher_;
+  /// Whether the latencies are measured and published
+  const bool publish_message_latency_;
   /// Timer which fires the publisher
   rclcpp::TimerBase::SharedPtr publisher_timer_;
   /// The start of the collection window, used in the published topic statistics message
   rclcpp::Time window_start_;
+  /// Intra-process subscription whose buffer occupancy is published, if any
+  std::weak_ptr<const rclcpp::experimental::SubscriptionIntraProcessBase>
+  subscription_intra_process_;
+  /// Number of messages dropped by the intra-process buffer until the previous window
+  uint64_t last_dropped_messages_{0};
 };
 }  // namespace topic_statistics
 }  // namespace rclcpp
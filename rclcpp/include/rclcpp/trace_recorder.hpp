@@ -0,0 +1,122 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__TRACE_RECORDER_HPP_
+#define RCLCPP__TRACE_RECORDER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+/// Built-in recorder of timestamped events, which doesn't need tracetools or LTTng.
+/**
+ * Once enabled, the events of rclcpp, such as publications, takes, callbacks and waits,
+ * are recorded in a ring buffer per thread, which keeps the latest events.
+ * Recording an event doesn't lock or allocate, and when disabled it only costs the check
+ * of a flag.
+ * The events can then be dumped to a file in the Chrome trace format, which is displayed
+ * by chrome://tracing or Perfetto.
+ *
+ * ```cpp
+ * rclcpp::trace_recorder::enable();
+ * executor.spin_some();
+ * rclcpp::trace_recorder::disable();
+ * rclcpp::trace_recorder::dump("trace.json");
+ * ```
+ */
+namespace trace_recorder
+{
+
+/// Kind of an event.
+enum class EventType : uint8_t
+{
+  Publish,
+  Take,
+  CallbackStart,
+  CallbackEnd,
+  WaitStart,
+  WaitEnd,
+};
+
+/// Start recording events.
+/**
+ * \param[in] events_per_thread size of the ring buffer of each thread, the older events are
+ *   overwritten once full.
+ *   It only applies to the ring buffers created after the next clear().
+ * \throws std::invalid_argument if events_per_thread is 0.
+ */
+RCLCPP_PUBLIC
+void
+enable(size_t events_per_thread = 1u << 16);
+
+/// Stop recording events, the recorded ones are kept until clear().
+RCLCPP_PUBLIC
+void
+disable();
+
+/// Return true if events are being recorded.
+RCLCPP_PUBLIC
+bool
+is_enabled() noexcept;
+
+/// Record an event of the calling thread, if enabled.
+/**
+ * \param[in] type kind of the event.
+ * \param[in] entity address identifying the entity of the event, e.g. the publisher.
+ * \param[in] name name of the entity, e.g. the topic name, which is copied and truncated,
+ *   or nullptr.
+ */
+RCLCPP_PUBLIC
+void
+record(EventType type, const void * entity, const char * name) noexcept;
+
+/// Write the recorded events to a file in the Chrome trace event format.
+/**
+ * The timestamps are in microseconds of the steady clock, and the threads are numbered
+ * in the order they first recorded an event.
+ * Events recorded while dumping may be missing or partially written, so the recording
+ * should be disabled first.
+ *
+ * \param[in] path path of the file, which is overwritten.
+ * \throws std::runtime_error if the file can't be written.
+ */
+RCLCPP_PUBLIC
+void
+dump(const std::string & path);
+
+/// Remove the recorded events and the ring buffers of the threads.
+/**
+ * The events recorded while clearing may be lost.
+ */
+RCLCPP_PUBLIC
+void
+clear();
+
+}  // namespace trace_recorder
+}  // namespace rclcpp
+
+/// Record an event with rclcpp::trace_recorder, only checking a flag when it's disabled.
+#define RCLCPP_TRACE_RECORD(type, entity, name) \
+  do { \
+    if (rclcpp::trace_recorder::is_enabled()) { \
+      rclcpp::trace_recorder::record( \
+        rclcpp::trace_recorder::EventType::type, static_cast<const void *>(entity), name); \
+    } \
+  } while (0)
+
+#endif  // RCLCPP__TRACE_RECORDER_HPP_
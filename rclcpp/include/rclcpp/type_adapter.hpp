@@ -16,10 +16,13 @@
 #define RCLCPP__TYPE_ADAPTER_HPP_
 
 #include <type_traits>
+#include <utility>
 
 namespace rclcpp
 {
 
+class SerializedMessage;
+
 /// Template structure used to adapt custom, user-defined types to ROS types.
 /**
  * Adapting a custom, user-defined type to a ROS type allows that custom type
@@ -38,6 +41,15 @@ namespace rclcpp
  *
  * The convert functions must convert from one type to the other.
  *
+ * The specialization may also provide a static function serializing the custom type
+ * straight into a serialized message of the ROS type, with the signature:
+ *
+ *   - static void convert_to_serialized_message(
+ *       const custom_type &, rclcpp::SerializedMessage &)
+ *
+ * It's then used instead of convert_to_ros_message() when a custom type is published
+ * to subscriptions in other processes, which saves building a ROS message first.
+ *
  * For example, here is a theoretical example for adapting `std::string` to the
  * `std_msgs::msg::String` ROS message type:
  *
@@ -128,6 +140,18 @@ struct assert_type_pair_is_specialized_type_adapter
     "No type adapter for this custom type/ros message type pair");
 };
 
+/// Whether a TypeAdapter serializes its custom type by itself, false specialization.
+template<typename TypeAdapterT, typename = void>
+struct has_convert_to_serialized_message : std::false_type {};
+
+/// Whether a TypeAdapter serializes its custom type by itself, true specialization.
+template<typename TypeAdapterT>
+struct has_convert_to_serialized_message<
+  TypeAdapterT,
+  std::void_t<decltype(TypeAdapterT::convert_to_serialized_message(
+    std::declval<const typename TypeAdapterT::custom_type &>(),
+    std::declval<rclcpp::SerializedMessage &>()))>>: std::true_type {};
+
 }  // namespace detail
 
 /// Template metafunction that can make the type being adapted explicit.
@@ -29,6 +29,8 @@ namespace rclcpp
 {
 /// Load the type support library for the given type.
 /**
+ * The library of each package is only loaded once for the process, and stays loaded.
+ *
  * \param[in] type The topic type, e.g. "std_msgs/msg/String"
  * \param[in] typesupport_identifier Type support identifier, typically "rosidl_typesupport_cpp"
  * \return A shared library
@@ -40,6 +42,7 @@ get_typesupport_library(const std::string & type, const std::string & typesuppor
 /// Extract the type support handle from the library.
 /**
  * The library needs to match the topic type. The shared library must stay loaded for the lifetime of the result.
+ * The handles found in the libraries returned by get_typesupport_library() are cached.
  * \param[in] type The topic type, e.g. "std_msgs/msg/String"
  * \param[in] typesupport_identifier Type support identifier, typically "rosidl_typesupport_cpp"
  * \param[in] library The shared type support library
@@ -15,21 +15,131 @@
 #ifndef RCLCPP__WAIT_FOR_MESSAGE_HPP_
 #define RCLCPP__WAIT_FOR_MESSAGE_HPP_
 
+#include <chrono>
 #include <memory>
 #include <string>
+#include <utility>
 
-#include "rcpputils/scope_exit.hpp"
-
+#include "rclcpp/macros.hpp"
 #include "rclcpp/node.hpp"
 #include "rclcpp/visibility_control.hpp"
 #include "rclcpp/wait_set.hpp"
 
 namespace rclcpp
 {
+/// Subscription and wait set kept to wait for the messages of a topic, one at a time.
+/**
+ * Unlike wait_for_message(), the wait set, and the subscription when it's created for the
+ * node, are only set up once, so waiting for each message doesn't discover the topic again.
+ * The messages received between two waits are kept as the history of the subscription allows.
+ *
+ * It isn't thread-safe.
+ */
+template<class MsgT>
+class MessageSampler
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(MessageSampler)
+
+  /// Constructor, given an already initialized subscription.
+  /**
+   * \param[in] subscription shared pointer to a previously initialized subscription.
+   * \param[in] context shared pointer to a context to watch for SIGINT requests.
+   */
+  MessageSampler(
+    std::shared_ptr<rclcpp::Subscription<MsgT>> subscription,
+    std::shared_ptr<rclcpp::Context> context)
+  : subscription_(std::move(subscription)),
+    context_(std::move(context)),
+    gc_(std::make_shared<rclcpp::GuardCondition>(context_))
+  {
+    shutdown_callback_handle_ = context_->add_on_shutdown_callback(
+      [weak_gc = std::weak_ptr<rclcpp::GuardCondition>{gc_}]() {
+        auto strong_gc = weak_gc.lock();
+        if (strong_gc) {
+          strong_gc->trigger();
+        }
+      });
+    wait_set_.add_subscription(subscription_);
+    wait_set_.add_guard_condition(gc_);
+  }
+
+  /// Constructor, creating a subscription to a topic for the node.
+  /**
+   * \param[in] node the node pointer to initialize the subscription on.
+   * \param[in] topic the topic to wait for messages.
+   * \param[in] qos QoS profile of the subscription.
+   */
+  MessageSampler(
+    rclcpp::Node::SharedPtr node,
+    const std::string & topic,
+    const rclcpp::QoS & qos = rclcpp::QoS(1))
+  : MessageSampler(
+      node->create_subscription<MsgT>(topic, qos, [](const std::shared_ptr<const MsgT>) {}),
+      node->get_node_options().context())
+  {}
+
+  ~MessageSampler()
+  {
+    context_->remove_on_shutdown_callback(shutdown_callback_handle_);
+    wait_set_.remove_guard_condition(gc_);
+    wait_set_.remove_subscription(subscription_);
+  }
+
+  /// Wait for the next incoming message.
+  /**
+   * \param[out] out is the message to be filled when a new message is arriving.
+   * \param[in] time_to_wait parameter specifying the timeout before returning.
+   * \return true if a message was successfully received, false if message could not
+   * be obtained or the context was shut down.
+   */
+  template<class Rep = int64_t, class Period = std::milli>
+  bool
+  wait_for_next(
+    MsgT & out,
+    std::chrono::duration<Rep, Period> time_to_wait = std::chrono::duration<Rep, Period>(-1))
+  {
+    // The guard condition is only triggered once, by the shutdown.
+    if (!context_->is_valid()) {
+      return false;
+    }
+    auto ret = wait_set_.wait(time_to_wait);
+    if (ret.kind() != rclcpp::WaitResultKind::Ready) {
+      return false;
+    }
+
+    if (wait_set_.get_rcl_wait_set().guard_conditions[0]) {
+      return false;
+    }
+
+    rclcpp::MessageInfo info;
+    if (!subscription_->take(out, info)) {
+      return false;
+    }
+
+    return true;
+  }
+
+  /// Return the subscription the messages are taken from.
+  std::shared_ptr<rclcpp::Subscription<MsgT>>
+  get_subscription() const
+  {
+    return subscription_;
+  }
+
+private:
+  std::shared_ptr<rclcpp::Subscription<MsgT>> subscription_;
+  std::shared_ptr<rclcpp::Context> context_;
+  std::shared_ptr<rclcpp::GuardCondition> gc_;
+  rclcpp::OnShutdownCallbackHandle shutdown_callback_handle_;
+  rclcpp::WaitSet wait_set_;
+};
+
 /// Wait for the next incoming message.
 /**
  * Given an already initialized subscription,
  * wait for the next incoming message to arrive before the specified timeout.
+ * To wait for several messages, a MessageSampler avoids setting up a wait set each time.
  *
  * \param[out] out is the message to be filled when a new message is arriving.
  * \param[in] subscription shared pointer to a previously initialized subscription.
@@ -45,39 +155,14 @@ bool wait_for_message(
   std::shared_ptr<rclcpp::Context> context,
   std::chrono::duration<Rep, Period> time_to_wait = std::chrono::duration<Rep, Period>(-1))
 {
-  auto gc = std::make_shared<rclcpp::GuardCondition>(context);
-  auto shutdown_callback_handle = context->add_on_shutdown_callback(
-    [weak_gc = std::weak_ptr<rclcpp::GuardCondition>{gc}]() {
-      auto strong_gc = weak_gc.lock();
-      if (strong_gc) {
-        strong_gc->trigger();
-      }
-    });
-
-  rclcpp::WaitSet wait_set;
-  wait_set.add_subscription(subscription);
-  RCPPUTILS_SCOPE_EXIT(wait_set.remove_subscription(subscription); );
-  wait_set.add_guard_condition(gc);
-  auto ret = wait_set.wait(time_to_wait);
-  if (ret.kind() != rclcpp::WaitResultKind::Ready) {
-    return false;
-  }
-
-  if (wait_set.get_rcl_wait_set().guard_conditions[0]) {
-    return false;
-  }
-
-  rclcpp::MessageInfo info;
-  if (!subscription->take(out, info)) {
-    return false;
-  }
-
-  return true;
+  MessageSampler<MsgT> sampler(std::move(subscription), std::move(context));
+  return sampler.wait_for_next(out, time_to_wait);
 }
 
 /// Wait for the next incoming message.
 /**
  * Wait for the next incoming message to arrive on a specified topic before the specified timeout.
+ * The subscription is created for each call, a MessageSampler keeps it instead.
  *
  * \param[out] out is the message to be filled when a new message is arriving.
  * \param[in] node the node pointer to initialize the subscription on.
@@ -23,6 +23,7 @@
 
 #include "rclcpp/macros.hpp"
 #include "rclcpp/wait_result_kind.hpp"
+#include "rclcpp/wait_set_ready_entities.hpp"
 
 namespace rclcpp
 {
@@ -122,6 +123,24 @@ public:
     return *wait_set_pointer_;
   }
 
+  /// Return the entities of the wait set which are ready.
+  /**
+   * The ready entities are collected once per wait, in one pass over the wait set,
+   * and then returned by each call, so iterating them only costs the number of ready
+   * entities.
+   * Waitable::is_ready() is called on each waitable of the wait set while collecting.
+   * They are valid as long as this result, during which the ThreadSafeSynchronization
+   * policy prevents modifying the entities of the wait set.
+   *
+   * \return the ready entities, by kind, in the order they were added to the wait set.
+   * \throws std::runtime_error if the result was not ready
+   */
+  const WaitSetReadyEntities &
+  get_ready_entities()
+  {
+    return this->get_wait_set().get_ready_entities();
+  }
+
   WaitResult(WaitResult && other) noexcept
   : wait_result_kind_(other.wait_result_kind_),
     wait_set_pointer_(std::exchange(other.wait_set_pointer_, nullptr))
@@ -25,6 +25,7 @@
 #include "rclcpp/logging.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/visibility_control.hpp"
+#include "rclcpp/wait_set_ready_entities.hpp"
 #include "rclcpp/waitable.hpp"
 
 namespace rclcpp
@@ -175,6 +176,8 @@ protected:
     const WaitablesIterable & waitables
   )
   {
+    // The ready entities of the previous wait are outdated
+    ready_entities_valid_ = false;
     bool was_resized = false;
     // Resize the wait set, but only if it needs to be.
     if (needs_resize_) {
@@ -405,11 +408,123 @@ protected:
     needs_resize_ = true;
   }
 
+  /// Return the entities which are ready after the last wait, collecting them once.
+  /**
+   * The entities must be given in the order they were added to the rcl wait set by
+   * storage_rebuild_rcl_wait_set_with_sets(), and they must be owned by the storage,
+   * e.g. between storage_acquire_ownerships() and storage_release_ownerships().
+   */
+  template<
+    class SubscriptionsIterable,
+    class GuardConditionsIterable,
+    class TimersIterable,
+    class ClientsIterable,
+    class ServicesIterable,
+    class WaitablesIterable
+  >
+  const rclcpp::WaitSetReadyEntities &
+  storage_get_ready_entities_from_sets(
+    const SubscriptionsIterable & subscriptions,
+    const GuardConditionsIterable & guard_conditions,
+    const TimersIterable & timers,
+    const ClientsIterable & clients,
+    const ServicesIterable & services,
+    const WaitablesIterable & waitables)
+  {
+    if (ready_entities_valid_) {
+      return ready_entities_;
+    }
+    // The entities which were added are the non null ones, in the same order.
+    auto collect =
+      [](const auto & entities, auto get_entity, auto rcl_entities, size_t rcl_size,
+        auto & ready_entities)
+      {
+        ready_entities.clear();
+        size_t rcl_index = 0;
+        for (const auto & entry : entities) {
+          if (rcl_index >= rcl_size) {
+            break;
+          }
+          auto entity = to_shared_pointer(get_entity(entry));
+          if (nullptr == entity) {
+            continue;
+          }
+          if (nullptr != rcl_entities[rcl_index++]) {
+            ready_entities.push_back(std::move(entity));
+          }
+        }
+      };
+    auto get_self = [](const auto & entity) -> const auto & {return entity;};
+    collect(
+      subscriptions,
+      [](const auto & entry) -> const auto & {return entry.subscription;},
+      rcl_wait_set_.subscriptions, rcl_wait_set_.size_of_subscriptions,
+      ready_entities_.subscriptions);
+    collect(
+      guard_conditions, get_self,
+      rcl_wait_set_.guard_conditions, rcl_wait_set_.size_of_guard_conditions,
+      ready_entities_.guard_conditions);
+    collect(
+      timers, get_self,
+      rcl_wait_set_.timers, rcl_wait_set_.size_of_timers,
+      ready_entities_.timers);
+    collect(
+      clients, get_self,
+      rcl_wait_set_.clients, rcl_wait_set_.size_of_clients,
+      ready_entities_.clients);
+    collect(
+      services, get_self,
+      rcl_wait_set_.services, rcl_wait_set_.size_of_services,
+      ready_entities_.services);
+
+    ready_entities_.waitables.clear();
+    for (const auto & waitable_entry : waitables) {
+      auto waitable = to_shared_pointer(waitable_entry.waitable);
+      if (waitable && waitable->is_ready(&rcl_wait_set_)) {
+        ready_entities_.waitables.push_back(std::move(waitable));
+      }
+    }
+    ready_entities_valid_ = true;
+    return ready_entities_;
+  }
+
+  /// Release the ready entities, keeping the capacity of their vectors for the next wait.
+  void
+  storage_clear_ready_entities()
+  {
+    ready_entities_.subscriptions.clear();
+    ready_entities_.guard_conditions.clear();
+    ready_entities_.timers.clear();
+    ready_entities_.clients.clear();
+    ready_entities_.services.clear();
+    ready_entities_.waitables.clear();
+    ready_entities_valid_ = false;
+  }
+
+  template<class EntityT>
+  static
+  std::shared_ptr<EntityT>
+  to_shared_pointer(const std::shared_ptr<EntityT> & shared_pointer)
+  {
+    return shared_pointer;
+  }
+
+  template<class EntityT>
+  static
+  std::shared_ptr<EntityT>
+  to_shared_pointer(const std::weak_ptr<EntityT> & weak_pointer)
+  {
+    return weak_pointer.lock();
+  }
+
   rcl_wait_set_t rcl_wait_set_;
   rclcpp::Context::SharedPtr context_;
 
   bool needs_pruning_ = false;
   bool needs_resize_ = false;
+
+  rclcpp::WaitSetReadyEntities ready_entities_;
+  bool ready_entities_valid_ = false;
 };
 
 }  // namespace detail
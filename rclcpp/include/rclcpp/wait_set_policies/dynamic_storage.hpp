@@ -15,8 +15,9 @@
 #ifndef RCLCPP__WAIT_SET_POLICIES__DYNAMIC_STORAGE_HPP_
 #define RCLCPP__WAIT_SET_POLICIES__DYNAMIC_STORAGE_HPP_
 
-#include <algorithm>
 #include <memory>
+#include <stdexcept>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -36,7 +37,29 @@ namespace rclcpp
 namespace wait_set_policies
 {
 
+/// Slots of the entities of a DynamicStorage wait set which are ready after waiting.
+/**
+ * \sa rclcpp::WaitSetTemplate::get_ready_indices()
+ */
+struct ReadyEntityIndices
+{
+  std::vector<size_t> subscriptions;
+  std::vector<size_t> guard_conditions;
+  std::vector<size_t> timers;
+  std::vector<size_t> clients;
+  std::vector<size_t> services;
+  std::vector<size_t> waitables;
+};
+
 /// WaitSet policy that provides dynamically sized storage.
+/**
+ * Each entity is stored in a slot, whose index doesn't change until the entity
+ * is removed, and the slots of the removed entities are reused by the entities
+ * added afterwards.
+ * So adding and removing entities only patches their slots, and the rcl wait set
+ * is only resized when more slots are needed, or when all the entities of a kind
+ * were removed, as their slots are then released.
+ */
 class DynamicStorage : public rclcpp::wait_set_policies::detail::StoragePolicyCommon<false>
 {
 protected:
@@ -70,6 +93,9 @@ public:
     std::weak_ptr<rclcpp::SubscriptionBase> subscription;
     rclcpp::SubscriptionWaitSetMask mask;
 
+    /// Construct the entry of a free slot.
+    WeakSubscriptionEntry() = default;
+
     explicit WeakSubscriptionEntry(
       const std::shared_ptr<rclcpp::SubscriptionBase> & subscription_in,
       const rclcpp::SubscriptionWaitSetMask & mask_in) noexcept
@@ -136,6 +162,9 @@ public:
     std::weak_ptr<rclcpp::Waitable> waitable;
     std::weak_ptr<void> associated_entity;
 
+    /// Construct the entry of a free slot.
+    WeakWaitableEntry() = default;
+
     explicit WeakWaitableEntry(
       const std::shared_ptr<rclcpp::Waitable> & waitable_in,
       const std::shared_ptr<void> & associated_entity_in) noexcept
@@ -196,7 +225,14 @@ public:
     shared_services_(services_.size()),
     waitables_(waitables.cbegin(), waitables.cend()),
     shared_waitables_(waitables_.size())
-  {}
+  {
+    storage_index_slots(subscriptions_, subscription_slots_);
+    storage_index_slots(guard_conditions_, guard_condition_slots_);
+    storage_index_slots(timers_, timer_slots_);
+    storage_index_slots(clients_, client_slots_);
+    storage_index_slots(services_, service_slots_);
+    storage_index_slots(waitables_, waitable_slots_);
+  }
 
   ~DynamicStorage() = default;
 
@@ -213,134 +249,245 @@ public:
       services_,
       waitables_
     );
+    // The free slots hold empty entries, which are flagged for pruning by the rebuild even
+    // though there is nothing to prune, so only keep the flag for the deleted entities.
+    if (this->needs_pruning_ && this->storage_has_free_slots()) {
+      this->needs_pruning_ = this->storage_has_deleted_entities();
+    }
+  }
+
+  /// Bookkeeping of the slots of a sequence of entities.
+  struct SlotIndex
+  {
+    /// Slot of each entity, by address.
+    std::unordered_map<const void *, size_t> slots;
+    /// Address of the entity of each slot, nullptr for the free slots.
+    std::vector<const void *> addresses;
+    /// Free slots, reused before adding new ones.
+    std::vector<size_t> free_slots;
+  };
+
+  template<class SequenceOfEntitiesT>
+  static
+  void
+  storage_index_slots(const SequenceOfEntitiesT & entities, SlotIndex & index)
+  {
+    index.addresses.resize(entities.size(), nullptr);
+    index.free_slots.reserve(entities.size());
+    for (size_t slot = 0; slot < entities.size(); ++slot) {
+      const void * address = entities[slot].lock().get();
+      if (nullptr == address || !index.slots.emplace(address, slot).second) {
+        index.free_slots.push_back(slot);
+        continue;
+      }
+      index.addresses[slot] = address;
+    }
   }
 
   template<class EntityT, class SequenceOfEntitiesT>
   static
   bool
-  storage_has_entity(const EntityT & entity, const SequenceOfEntitiesT & entities)
+  storage_find_slot(
+    const EntityT & entity,
+    const SequenceOfEntitiesT & entities,
+    const SlotIndex & index,
+    size_t & slot)
+  {
+    auto it = index.slots.find(&entity);
+    // The slot may belong to a deleted entity which had the same address.
+    if (index.slots.end() == it || &entity != entities[it->second].lock().get()) {
+      return false;
+    }
+    slot = it->second;
+    return true;
+  }
+
+  template<class EntryT, class SequenceOfEntitiesT>
+  void
+  storage_add_to_slot(
+    const void * address,
+    EntryT && entry,
+    SequenceOfEntitiesT & entities,
+    SlotIndex & index)
   {
-    return std::any_of(
-      entities.cbegin(),
-      entities.cend(),
-      [&entity](const auto & inner) {return &entity == inner.lock().get();});
+    auto it = index.slots.find(address);
+    if (index.slots.end() != it) {
+      // A deleted entity, not pruned yet, had the same address.
+      this->storage_free_slot(it->second, entities, index);
+    }
+    size_t slot;
+    if (!index.free_slots.empty()) {
+      slot = index.free_slots.back();
+      index.free_slots.pop_back();
+      entities[slot] = std::forward<EntryT>(entry);
+      index.addresses[slot] = address;
+    } else {
+      slot = entities.size();
+      entities.push_back(std::forward<EntryT>(entry));
+      index.addresses.push_back(address);
+      // So that freeing slots never needs to allocate.
+      index.free_slots.reserve(entities.size());
+      this->storage_flag_for_resize();
+    }
+    index.slots.emplace(address, slot);
+  }
+
+  template<class SequenceOfEntitiesT>
+  void
+  storage_free_slot(size_t slot, SequenceOfEntitiesT & entities, SlotIndex & index)
+  {
+    index.slots.erase(index.addresses[slot]);
+    index.addresses[slot] = nullptr;
+    entities[slot] = typename SequenceOfEntitiesT::value_type();
+    index.free_slots.push_back(slot);
+    if (index.slots.empty()) {
+      // Release all the slots, so that a wait set without entities is empty.
+      entities.clear();
+      index.addresses.clear();
+      index.free_slots.clear();
+      this->storage_flag_for_resize();
+    }
+  }
+
+  bool
+  storage_has_free_slots() const
+  {
+    return
+      !subscription_slots_.free_slots.empty() ||
+      !guard_condition_slots_.free_slots.empty() ||
+      !timer_slots_.free_slots.empty() ||
+      !client_slots_.free_slots.empty() ||
+      !service_slots_.free_slots.empty() ||
+      !waitable_slots_.free_slots.empty();
+  }
+
+  bool
+  storage_has_deleted_entities() const
+  {
+    auto has_deleted =
+      [](const auto & entities, const SlotIndex & index) {
+        for (size_t slot = 0; slot < entities.size(); ++slot) {
+          if (nullptr != index.addresses[slot] && entities[slot].expired()) {
+            return true;
+          }
+        }
+        return false;
+      };
+    return
+      has_deleted(subscriptions_, subscription_slots_) ||
+      has_deleted(guard_conditions_, guard_condition_slots_) ||
+      has_deleted(timers_, timer_slots_) ||
+      has_deleted(clients_, client_slots_) ||
+      has_deleted(services_, service_slots_) ||
+      has_deleted(waitables_, waitable_slots_);
   }
 
   template<class EntityT, class SequenceOfEntitiesT>
-  static
-  auto
-  storage_find_entity(const EntityT & entity, const SequenceOfEntitiesT & entities)
+  void
+  storage_remove_from_slot(
+    const EntityT & entity,
+    SequenceOfEntitiesT & entities,
+    SlotIndex & index,
+    const char * not_found_message)
   {
-    return std::find_if(
-      entities.cbegin(),
-      entities.cend(),
-      [&entity](const auto & inner) {return &entity == inner.lock().get();});
+    size_t slot;
+    if (!this->storage_find_slot(entity, entities, index, slot)) {
+      throw std::runtime_error(not_found_message);
+    }
+    this->storage_free_slot(slot, entities, index);
   }
 
   void
   storage_add_subscription(std::shared_ptr<rclcpp::SubscriptionBase> && subscription)
   {
-    if (this->storage_has_entity(*subscription, subscriptions_)) {
+    size_t slot;
+    if (this->storage_find_slot(*subscription, subscriptions_, subscription_slots_, slot)) {
       throw std::runtime_error("subscription already in wait set");
     }
+    const void * address = subscription.get();
     WeakSubscriptionEntry weak_entry{std::move(subscription), {}};
-    subscriptions_.push_back(std::move(weak_entry));
-    this->storage_flag_for_resize();
+    this->storage_add_to_slot(address, std::move(weak_entry), subscriptions_, subscription_slots_);
   }
 
   void
   storage_remove_subscription(std::shared_ptr<rclcpp::SubscriptionBase> && subscription)
   {
-    auto it = this->storage_find_entity(*subscription, subscriptions_);
-    if (subscriptions_.cend() == it) {
-      throw std::runtime_error("subscription not in wait set");
-    }
-    subscriptions_.erase(it);
-    this->storage_flag_for_resize();
+    this->storage_remove_from_slot(
+      *subscription, subscriptions_, subscription_slots_, "subscription not in wait set");
   }
 
   void
   storage_add_guard_condition(std::shared_ptr<rclcpp::GuardCondition> && guard_condition)
   {
-    if (this->storage_has_entity(*guard_condition, guard_conditions_)) {
+    size_t slot;
+    if (
+      this->storage_find_slot(*guard_condition, guard_conditions_, guard_condition_slots_, slot))
+    {
       throw std::runtime_error("guard_condition already in wait set");
     }
-    guard_conditions_.push_back(std::move(guard_condition));
-    this->storage_flag_for_resize();
+    const void * address = guard_condition.get();
+    this->storage_add_to_slot(
+      address, std::move(guard_condition), guard_conditions_, guard_condition_slots_);
   }
 
   void
   storage_remove_guard_condition(std::shared_ptr<rclcpp::GuardCondition> && guard_condition)
   {
-    auto it = this->storage_find_entity(*guard_condition, guard_conditions_);
-    if (guard_conditions_.cend() == it) {
-      throw std::runtime_error("guard_condition not in wait set");
-    }
-    guard_conditions_.erase(it);
-    this->storage_flag_for_resize();
+    this->storage_remove_from_slot(
+      *guard_condition, guard_conditions_, guard_condition_slots_,
+      "guard_condition not in wait set");
   }
 
   void
   storage_add_timer(std::shared_ptr<rclcpp::TimerBase> && timer)
   {
-    if (this->storage_has_entity(*timer, timers_)) {
+    size_t slot;
+    if (this->storage_find_slot(*timer, timers_, timer_slots_, slot)) {
       throw std::runtime_error("timer already in wait set");
     }
-    timers_.push_back(std::move(timer));
-    this->storage_flag_for_resize();
+    const void * address = timer.get();
+    this->storage_add_to_slot(address, std::move(timer), timers_, timer_slots_);
   }
 
   void
   storage_remove_timer(std::shared_ptr<rclcpp::TimerBase> && timer)
   {
-    auto it = this->storage_find_entity(*timer, timers_);
-    if (timers_.cend() == it) {
-      throw std::runtime_error("timer not in wait set");
-    }
-    timers_.erase(it);
-    this->storage_flag_for_resize();
+    this->storage_remove_from_slot(*timer, timers_, timer_slots_, "timer not in wait set");
   }
 
   void
   storage_add_client(std::shared_ptr<rclcpp::ClientBase> && client)
   {
-    if (this->storage_has_entity(*client, clients_)) {
+    size_t slot;
+    if (this->storage_find_slot(*client, clients_, client_slots_, slot)) {
       throw std::runtime_error("client already in wait set");
     }
-    clients_.push_back(std::move(client));
-    this->storage_flag_for_resize();
+    const void * address = client.get();
+    this->storage_add_to_slot(address, std::move(client), clients_, client_slots_);
   }
 
   void
   storage_remove_client(std::shared_ptr<rclcpp::ClientBase> && client)
   {
-    auto it = this->storage_find_entity(*client, clients_);
-    if (clients_.cend() == it) {
-      throw std::runtime_error("client not in wait set");
-    }
-    clients_.erase(it);
-    this->storage_flag_for_resize();
+    this->storage_remove_from_slot(*client, clients_, client_slots_, "client not in wait set");
   }
 
   void
   storage_add_service(std::shared_ptr<rclcpp::ServiceBase> && service)
   {
-    if (this->storage_has_entity(*service, services_)) {
+    size_t slot;
+    if (this->storage_find_slot(*service, services_, service_slots_, slot)) {
       throw std::runtime_error("service already in wait set");
     }
-    services_.push_back(std::move(service));
-    this->storage_flag_for_resize();
+    const void * address = service.get();
+    this->storage_add_to_slot(address, std::move(service), services_, service_slots_);
   }
 
   void
   storage_remove_service(std::shared_ptr<rclcpp::ServiceBase> && service)
   {
-    auto it = this->storage_find_entity(*service, services_);
-    if (services_.cend() == it) {
-      throw std::runtime_error("service not in wait set");
-    }
-    services_.erase(it);
-    this->storage_flag_for_resize();
+    this->storage_remove_from_slot(
+      *service, services_, service_slots_, "service not in wait set");
   }
 
   void
@@ -348,47 +495,157 @@ public:
     std::shared_ptr<rclcpp::Waitable> && waitable,
     std::shared_ptr<void> && associated_entity)
   {
-    if (this->storage_has_entity(*waitable, waitables_)) {
+    size_t slot;
+    if (this->storage_find_slot(*waitable, waitables_, waitable_slots_, slot)) {
       throw std::runtime_error("waitable already in wait set");
     }
+    const void * address = waitable.get();
     WeakWaitableEntry weak_entry(std::move(waitable), std::move(associated_entity));
-    waitables_.push_back(std::move(weak_entry));
+    this->storage_add_to_slot(address, std::move(weak_entry), waitables_, waitable_slots_);
+    // The waitables may not have the same number of entities as the one of the reused slot.
     this->storage_flag_for_resize();
   }
 
   void
   storage_remove_waitable(std::shared_ptr<rclcpp::Waitable> && waitable)
   {
-    auto it = this->storage_find_entity(*waitable, waitables_);
-    if (waitables_.cend() == it) {
-      throw std::runtime_error("waitable not in wait set");
-    }
-    waitables_.erase(it);
-    this->storage_flag_for_resize();
+    this->storage_remove_from_slot(
+      *waitable, waitables_, waitable_slots_, "waitable not in wait set");
   }
 
-  // this is noexcept because:
-  //   - std::weak_ptr::expired is noexcept
-  //   - the erase-remove idiom is noexcept, since we're not using the ExecutionPolicy version
-  //   - std::vector::erase is noexcept if the assignment operator of T is also
-  //     - and, the operator= for std::weak_ptr is noexcept
+  /// Free the slots of the entities which have been deleted.
   void
   storage_prune_deleted_entities() noexcept
   {
-    // reusable (templated) lambda for removal predicate
-    auto p =
-      [](const auto & weak_ptr) {
-        // remove entries which have expired
-        return weak_ptr.expired();
+    auto prune =
+      [this](auto & entities, SlotIndex & index) {
+        // Freeing the last slot releases all of them.
+        for (size_t slot = 0; slot < entities.size(); ++slot) {
+          if (nullptr != index.addresses[slot] && entities[slot].expired()) {
+            this->storage_free_slot(slot, entities, index);
+          }
+        }
+      };
+    prune(subscriptions_, subscription_slots_);
+    prune(guard_conditions_, guard_condition_slots_);
+    prune(timers_, timer_slots_);
+    prune(clients_, client_slots_);
+    prune(services_, service_slots_);
+    prune(waitables_, waitable_slots_);
+    this->needs_pruning_ = false;
+  }
+
+  /// Get the slots of the entities which are ready, after waiting.
+  /**
+   * This must be called while having the ownership of the entities, i.e. while
+   * holding the WaitResult of the wait.
+   * Waitable::is_ready() is called on each waitable to know if it is ready.
+   */
+  const ReadyEntityIndices &
+  storage_get_ready_indices()
+  {
+    // The live entities were added to the rcl wait set in the order of their slots.
+    auto collect =
+      [](const auto & shared_entities, auto is_live, auto rcl_entities, size_t rcl_size,
+        std::vector<size_t> & ready_slots)
+      {
+        ready_slots.clear();
+        size_t rcl_index = 0;
+        for (size_t slot = 0; slot < shared_entities.size() && rcl_index < rcl_size; ++slot) {
+          if (!is_live(shared_entities[slot])) {
+            continue;
+          }
+          if (nullptr != rcl_entities[rcl_index++]) {
+            ready_slots.push_back(slot);
+          }
+        }
       };
-    // remove guard conditions which have been deleted
-    guard_conditions_.erase(
-      std::remove_if(guard_conditions_.begin(), guard_conditions_.end(), p),
-      guard_conditions_.end());
-    timers_.erase(std::remove_if(timers_.begin(), timers_.end(), p), timers_.end());
-    clients_.erase(std::remove_if(clients_.begin(), clients_.end(), p), clients_.end());
-    services_.erase(std::remove_if(services_.begin(), services_.end(), p), services_.end());
-    waitables_.erase(std::remove_if(waitables_.begin(), waitables_.end(), p), waitables_.end());
+    auto is_live = [](const auto & shared_ptr) {return nullptr != shared_ptr;};
+    collect(
+      shared_subscriptions_,
+      [](const SubscriptionEntry & entry) {return nullptr != entry.subscription;},
+      rcl_wait_set_.subscriptions, rcl_wait_set_.size_of_subscriptions,
+      ready_indices_.subscriptions);
+    collect(
+      shared_guard_conditions_, is_live,
+      rcl_wait_set_.guard_conditions, rcl_wait_set_.size_of_guard_conditions,
+      ready_indices_.guard_conditions);
+    collect(
+      shared_timers_, is_live,
+      rcl_wait_set_.timers, rcl_wait_set_.size_of_timers,
+      ready_indices_.timers);
+    collect(
+      shared_clients_, is_live,
+      rcl_wait_set_.clients, rcl_wait_set_.size_of_clients,
+      ready_indices_.clients);
+    collect(
+      shared_services_, is_live,
+      rcl_wait_set_.services, rcl_wait_set_.size_of_services,
+      ready_indices_.services);
+
+    ready_indices_.waitables.clear();
+    for (size_t slot = 0; slot < shared_waitables_.size(); ++slot) {
+      const auto & waitable = shared_waitables_[slot].waitable;
+      if (waitable && waitable->is_ready(&rcl_wait_set_)) {
+        ready_indices_.waitables.push_back(slot);
+      }
+    }
+    return ready_indices_;
+  }
+
+  /// Get the entities which are ready, after waiting.
+  /**
+   * Like storage_get_ready_indices(), this must be called while having the ownership of
+   * the entities.
+   */
+  const rclcpp::WaitSetReadyEntities &
+  storage_get_ready_entities()
+  {
+    // The same sequences as the ones added to the rcl wait set, for the indices to match
+    return this->storage_get_ready_entities_from_sets(
+      subscriptions_,
+      guard_conditions_,
+      timers_,
+      clients_,
+      services_,
+      waitables_
+    );
+  }
+
+  std::shared_ptr<rclcpp::SubscriptionBase>
+  storage_get_subscription(size_t slot) const
+  {
+    return subscriptions_.at(slot).lock();
+  }
+
+  std::shared_ptr<rclcpp::GuardCondition>
+  storage_get_guard_condition(size_t slot) const
+  {
+    return guard_conditions_.at(slot).lock();
+  }
+
+  std::shared_ptr<rclcpp::TimerBase>
+  storage_get_timer(size_t slot) const
+  {
+    return timers_.at(slot).lock();
+  }
+
+  std::shared_ptr<rclcpp::ClientBase>
+  storage_get_client(size_t slot) const
+  {
+    return clients_.at(slot).lock();
+  }
+
+  std::shared_ptr<rclcpp::ServiceBase>
+  storage_get_service(size_t slot) const
+  {
+    return services_.at(slot).lock();
+  }
+
+  std::shared_ptr<rclcpp::Waitable>
+  storage_get_waitable(size_t slot) const
+  {
+    return waitables_.at(slot).lock();
   }
 
   void
@@ -407,6 +664,12 @@ public:
         }
       };
     // Lock all the weak pointers and hold them until released.
+    shared_subscriptions_.resize(subscriptions_.size());
+    for (size_t index = 0; index < subscriptions_.size(); ++index) {
+      shared_subscriptions_[index] = SubscriptionEntry{
+        subscriptions_[index].lock(),
+        subscriptions_[index].mask};
+    }
     lock_all(guard_conditions_, shared_guard_conditions_);
     lock_all(timers_, shared_timers_);
     lock_all(clients_, shared_clients_);
@@ -438,6 +701,7 @@ public:
           shared_ptr.reset();
         }
       };
+    reset_all(shared_subscriptions_);
     reset_all(shared_guard_conditions_);
     reset_all(shared_timers_);
     reset_all(shared_clients_);
@@ -449,21 +713,29 @@ public:
 
   SequenceOfWeakSubscriptions subscriptions_;
   SubscriptionsIterable shared_subscriptions_;
+  SlotIndex subscription_slots_;
 
   SequenceOfWeakGuardConditions guard_conditions_;
   GuardConditionsIterable shared_guard_conditions_;
+  SlotIndex guard_condition_slots_;
 
   SequenceOfWeakTimers timers_;
   TimersIterable shared_timers_;
+  SlotIndex timer_slots_;
 
   SequenceOfWeakClients clients_;
   ClientsIterable shared_clients_;
+  SlotIndex client_slots_;
 
   SequenceOfWeakServices services_;
   ServicesIterable shared_services_;
+  SlotIndex service_slots_;
 
   SequenceOfWeakWaitables waitables_;
   WaitablesIterable shared_waitables_;
+  SlotIndex waitable_slots_;
+
+  ReadyEntityIndices ready_indices_;
 };
 
 }  // namespace wait_set_policies
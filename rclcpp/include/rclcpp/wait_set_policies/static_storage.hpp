@@ -176,6 +176,19 @@ public:
   // storage_remove_waitable() explicitly not declared here
   // storage_prune_deleted_entities() explicitly not declared here
 
+  const rclcpp::WaitSetReadyEntities &
+  storage_get_ready_entities()
+  {
+    return this->storage_get_ready_entities_from_sets(
+      subscriptions_,
+      guard_conditions_,
+      timers_,
+      clients_,
+      services_,
+      waitables_
+    );
+  }
+
   void
   storage_acquire_ownerships()
   {
@@ -15,9 +15,11 @@
 #ifndef RCLCPP__WAIT_SET_POLICIES__THREAD_SAFE_SYNCHRONIZATION_HPP_
 #define RCLCPP__WAIT_SET_POLICIES__THREAD_SAFE_SYNCHRONIZATION_HPP_
 
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <stdexcept>
 #include <utility>
 
 #include "rclcpp/client.hpp"
@@ -63,6 +65,10 @@ namespace wait_set_policies
  * The write activities will try to interrupt the wait() method by triggering
  * a guard condition, but they have no way of causing the WaitResult to release
  * its lock.
+ *
+ * When the entities are added and removed often, interrupting the wait() for
+ * each of them can be avoided by batching the modifications, see
+ * sync_set_max_modification_delay().
  */
 class ThreadSafeSynchronization : public detail::SynchronizationPolicyCommon
 {
@@ -87,13 +93,48 @@ protected:
   /// Interrupt any waiting wait set.
   /**
    * Used to interrupt the wait set when adding or removing items.
+   * When the modifications are batched, the wait set isn't interrupted, they
+   * are applied the next time it wakes up instead.
    */
   void
   interrupt_waiting_wait_set()
   {
+    if (max_modification_delay_ns_.load() > 0) {
+      return;
+    }
+    extra_guard_conditions_[0]->trigger();
+  }
+
+  /// Set the maximum delay before the added and removed entities are waited on.
+  /**
+   * By default, the delay is 0 and each modification interrupts the wait(), so that
+   * it is applied right away.
+   * With a positive delay, the modifications don't interrupt the wait(), they are
+   * applied the next time it wakes up, because an entity is ready or because it
+   * waited for the delay, so that frequent modifications are batched together.
+   * The wait() then wakes up at least once per delay, even if nothing is ready.
+   *
+   * \param[in] max_delay maximum delay before the modifications are applied.
+   * \throws std::invalid_argument if max_delay is negative.
+   */
+  void
+  sync_set_max_modification_delay(std::chrono::nanoseconds max_delay)
+  {
+    if (max_delay < std::chrono::nanoseconds(0)) {
+      throw std::invalid_argument("the maximum modification delay can't be negative");
+    }
+    max_modification_delay_ns_.store(max_delay.count());
+    // A waiting wait set is interrupted to apply the new delay and the pending modifications
     extra_guard_conditions_[0]->trigger();
   }
 
+  /// Return the maximum delay before the added and removed entities are waited on.
+  std::chrono::nanoseconds
+  sync_get_max_modification_delay() const
+  {
+    return std::chrono::nanoseconds(max_modification_delay_ns_.load());
+  }
+
   /// Add subscription.
   void
   sync_add_subscription(
@@ -291,6 +332,17 @@ protected:
 
       // Calculate how much time there is left to wait, unless blocking indefinitely.
       auto time_left_to_wait_ns = this->calculate_time_left_to_wait(time_to_wait_ns, start);
+      // When the modifications are batched, wake up at least once per delay to apply them.
+      const std::chrono::nanoseconds max_modification_delay = sync_get_max_modification_delay();
+      bool wait_is_bounded_by_delay = false;
+      if (
+        max_modification_delay > std::chrono::nanoseconds(0) &&
+        (time_left_to_wait_ns < std::chrono::nanoseconds(0) ||
+        time_left_to_wait_ns > max_modification_delay))
+      {
+        time_left_to_wait_ns = max_modification_delay;
+        wait_is_bounded_by_delay = true;
+      }
 
       // Then wait for entities to become ready.
 
@@ -341,6 +393,10 @@ protected:
         // So we will loop and it will re-acquire the lock and rebuild the
         // rcl wait set.
       } else if (RCL_RET_TIMEOUT == ret) {
+        if (wait_is_bounded_by_delay) {
+          // Only the delay of the modifications expired, loop to apply them, if any.
+          continue;
+        }
         // The wait set timed out, exit the loop.
         break;
       } else if (RCL_RET_WAIT_SET_EMPTY == ret) {
@@ -370,6 +426,7 @@ protected:
 
 protected:
   std::array<std::shared_ptr<rclcpp::GuardCondition>, 1> extra_guard_conditions_;
+  std::atomic<int64_t> max_modification_delay_ns_{0};
   rclcpp::wait_set_policies::detail::WritePreferringReadWriteLock wprw_lock_;
 };
 
@@ -0,0 +1,47 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__WAIT_SET_READY_ENTITIES_HPP_
+#define RCLCPP__WAIT_SET_READY_ENTITIES_HPP_
+
+#include <memory>
+#include <vector>
+
+#include "rclcpp/client.hpp"
+#include "rclcpp/guard_condition.hpp"
+#include "rclcpp/service.hpp"
+#include "rclcpp/subscription_base.hpp"
+#include "rclcpp/timer.hpp"
+#include "rclcpp/waitable.hpp"
+
+namespace rclcpp
+{
+
+/// Entities of a wait set which are ready after waiting, in the order they were added.
+/**
+ * \sa rclcpp::WaitResult::get_ready_entities()
+ */
+struct WaitSetReadyEntities
+{
+  std::vector<std::shared_ptr<rclcpp::SubscriptionBase>> subscriptions;
+  std::vector<std::shared_ptr<rclcpp::GuardCondition>> guard_conditions;
+  std::vector<std::shared_ptr<rclcpp::TimerBase>> timers;
+  std::vector<std::shared_ptr<rclcpp::ClientBase>> clients;
+  std::vector<std::shared_ptr<rclcpp::ServiceBase>> services;
+  std::vector<std::shared_ptr<rclcpp::Waitable>> waitables;
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__WAIT_SET_READY_ENTITIES_HPP_
@@ -103,6 +103,30 @@ public:
     return this->storage_get_rcl_wait_set();
   }
 
+  /// Set the maximum delay before the added and removed entities are waited on.
+  /**
+   * This is only available with the ThreadSafeSynchronization policy, where
+   * adding or removing an entity otherwise interrupts the wait() right away.
+   *
+   * \sa rclcpp::wait_set_policies::ThreadSafeSynchronization::sync_set_max_modification_delay()
+   * \param[in] max_delay maximum delay before the modifications are applied, 0 to not delay them.
+   * \throws std::invalid_argument if max_delay is negative.
+   */
+  void
+  set_max_modification_delay(std::chrono::nanoseconds max_delay)
+  {
+    // this method comes from the SynchronizationPolicy
+    this->sync_set_max_modification_delay(max_delay);
+  }
+
+  /// Return the maximum delay before the added and removed entities are waited on.
+  std::chrono::nanoseconds
+  get_max_modification_delay() const
+  {
+    // this method comes from the SynchronizationPolicy
+    return this->sync_get_max_modification_delay();
+  }
+
   /// Add a subscription to this wait set.
   /**
    * \sa add_guard_condition() for details of how this method works.
@@ -609,6 +633,86 @@ public:
       });
   }
 
+  /// Return the slots of the entities which are ready, after waiting.
+  /**
+   * This may only be called while holding a WaitResult whose kind is Ready,
+   * and the returned indices are only valid until the next call to wait().
+   * The entity of each slot can be retrieved with get_subscription(),
+   * get_guard_condition(), get_timer(), get_client(), get_service() and
+   * get_waitable(), which avoids checking every entity of the wait set.
+   *
+   * Like prune_deleted_entities(), only storage policies which keep the slot
+   * of each entity provide this function.
+   *
+   * \throws exceptions based on the policies used.
+   */
+  const auto &
+  get_ready_indices()
+  {
+    // This method comes from the StoragePolicy, and it may not exist for all of them.
+    return this->storage_get_ready_indices();
+  }
+
+  /// Return the subscription of a slot, or nullptr if there's none.
+  /**
+   * \throws std::out_of_range if the slot doesn't exist.
+   */
+  std::shared_ptr<rclcpp::SubscriptionBase>
+  get_subscription(size_t slot) const
+  {
+    return this->storage_get_subscription(slot);
+  }
+
+  /// Return the guard condition of a slot, or nullptr if there's none.
+  /**
+   * \throws std::out_of_range if the slot doesn't exist.
+   */
+  std::shared_ptr<rclcpp::GuardCondition>
+  get_guard_condition(size_t slot) const
+  {
+    return this->storage_get_guard_condition(slot);
+  }
+
+  /// Return the timer of a slot, or nullptr if there's none.
+  /**
+   * \throws std::out_of_range if the slot doesn't exist.
+   */
+  std::shared_ptr<rclcpp::TimerBase>
+  get_timer(size_t slot) const
+  {
+    return this->storage_get_timer(slot);
+  }
+
+  /// Return the client of a slot, or nullptr if there's none.
+  /**
+   * \throws std::out_of_range if the slot doesn't exist.
+   */
+  std::shared_ptr<rclcpp::ClientBase>
+  get_client(size_t slot) const
+  {
+    return this->storage_get_client(slot);
+  }
+
+  /// Return the service of a slot, or nullptr if there's none.
+  /**
+   * \throws std::out_of_range if the slot doesn't exist.
+   */
+  std::shared_ptr<rclcpp::ServiceBase>
+  get_service(size_t slot) const
+  {
+    return this->storage_get_service(slot);
+  }
+
+  /// Return the waitable of a slot, or nullptr if there's none.
+  /**
+   * \throws std::out_of_range if the slot doesn't exist.
+   */
+  std::shared_ptr<rclcpp::Waitable>
+  get_waitable(size_t slot) const
+  {
+    return this->storage_get_waitable(slot);
+  }
+
   /// Wait for any of the entities in the wait set to be ready, or a period of time to pass.
   /**
    * This function will return when either one of the entities within this wait
@@ -727,6 +831,14 @@ private:
    *
    * \throws std::runtime_error If called before wait_result_acquire().
    */
+  /// Called by the WaitResult to get the ready entities, which are collected once per wait.
+  const rclcpp::WaitSetReadyEntities &
+  get_ready_entities()
+  {
+    // this method comes from the StoragePolicy
+    return this->storage_get_ready_entities();
+  }
+
   void
   wait_result_release()
   {
@@ -734,6 +846,8 @@ private:
       throw std::runtime_error("wait_result_release() called while not holding");
     }
     wait_result_holding_ = false;
+    // The ready entities mustn't keep the entities alive after the result
+    this->storage_clear_ready_entities();
     // this method comes from the StoragePolicy
     this->storage_release_ownerships();
     // this method comes from the SynchronizationPolicy
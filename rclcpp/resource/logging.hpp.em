@@ -115,6 +115,9 @@ def get_rclcpp_suffix_from_features(features):
 @[ if 'stream' not in feature_combination]@
  * \param ... The format string, followed by the variable arguments for the format string.
 @[ end if]@
+ *
+ * The level of the logger is cached, so after changing it with rcutils directly,
+ * `rclcpp::Logger::invalidate_cached_levels()` has to be called for the macro to see it.
  */
 @{params = rclcpp_feature_combinations[feature_combination].params.keys()}@
 #define RCLCPP_@(severity)@(suffix)(logger@(''.join([', ' + p for p in params]))@
@@ -127,6 +130,13 @@ def get_rclcpp_suffix_from_features(features):
       ::std::is_same<typename std::remove_cv_t<typename std::remove_reference_t<decltype(logger)>>, \
       typename ::rclcpp::Logger>::value, \
       "First argument to logging macros must be an rclcpp::Logger"); \
+    const ::rclcpp::Logger & rclcpp_logging_macro_logger_ = (logger); \
+    /* The cached level of the logger is checked before building the message */ \
+    if (!rclcpp_logging_macro_logger_.is_enabled_for( \
+        ::rclcpp::Logger::Level::@(severity.capitalize()))) \
+    { \
+      break; \
+    } \
 @[ if 'throttle' in feature_combination]@ \
     auto get_time_point = [&c=clock](rcutils_time_point_value_t * time_point) -> rcutils_ret_t { \
       try { \
@@ -148,7 +158,7 @@ def get_rclcpp_suffix_from_features(features):
 @[ if params]@
 @(''.join(['      ' + p + ', \\\n' for p in params if p != stream_arg]))@
 @[ end if]@
-      (logger).get_name(), \
+      rclcpp_logging_macro_logger_.get_name(), \
 @[ if 'stream' not in feature_combination]@
       __VA_ARGS__); \
 @[ else]@
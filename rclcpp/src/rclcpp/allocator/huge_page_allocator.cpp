@@ -0,0 +1,136 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp/allocator/huge_page_allocator.hpp"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace rclcpp
+{
+namespace allocator
+{
+
+#ifdef __linux__
+namespace
+{
+
+// The size of the huge pages of the most common architectures, x86-64 and aarch64
+constexpr size_t huge_page_size = 2u * 1024u * 1024u;
+
+/// Prefer the NUMA node of the current thread for the pages of a mapping.
+void
+prefer_local_numa_node(void * address, size_t size) noexcept
+{
+#if defined(SYS_getcpu) && defined(SYS_mbind)
+  // Not using libnuma, which isn't a dependency, so with the constants of <linux/mempolicy.h>
+  constexpr int mpol_preferred = 1;
+  constexpr size_t bits_per_word = std::numeric_limits<unsigned long>::digits;  // NOLINT
+  unsigned int cpu = 0;
+  unsigned int node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+    return;
+  }
+  unsigned long nodemask[16] = {};  // NOLINT
+  if (node >= sizeof(nodemask) * 8u) {
+    return;
+  }
+  nodemask[node / bits_per_word] = 1ul << (node % bits_per_word);
+  // It fails without NUMA support, in which case there is only one node anyway
+  (void)syscall(
+    SYS_mbind, address, size, mpol_preferred, nodemask, sizeof(nodemask) * 8u + 1u, 0u);
+#else
+  (void)address;
+  (void)size;
+#endif
+}
+
+}  // namespace
+#endif
+
+void *
+map_huge_pages(size_t size, const HugePageOptions & options, size_t & mapped_size) noexcept
+{
+#ifdef __linux__
+  if (size > std::numeric_limits<size_t>::max() - 2u * huge_page_size) {
+    return nullptr;
+  }
+  const size_t rounded_size = (size + huge_page_size - 1u) / huge_page_size * huge_page_size;
+  const int protection = PROT_READ | PROT_WRITE;
+  const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+  void * address = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  if (HugePagePolicy::Explicit == options.policy) {
+    // This fails when no huge page is reserved, and transparent ones are used instead
+    address = mmap(nullptr, rounded_size, protection, flags | MAP_HUGETLB, -1, 0);
+  }
+#endif
+  if (MAP_FAILED == address) {
+    // One more huge page is mapped, so that the mapping can be aligned on a huge page
+    char * unaligned = static_cast<char *>(
+      mmap(nullptr, rounded_size + huge_page_size, protection, flags, -1, 0));
+    if (MAP_FAILED == unaligned) {
+      return nullptr;
+    }
+    const auto unaligned_address = reinterpret_cast<uintptr_t>(unaligned);
+    const size_t head = (huge_page_size - unaligned_address % huge_page_size) % huge_page_size;
+    if (head > 0u) {
+      munmap(unaligned, head);
+    }
+    if (head < huge_page_size) {
+      munmap(unaligned + head + rounded_size, huge_page_size - head);
+    }
+    address = unaligned + head;
+#ifdef MADV_HUGEPAGE
+    (void)madvise(address, rounded_size, MADV_HUGEPAGE);
+#endif
+  }
+
+  if (options.numa_local) {
+    prefer_local_numa_node(address, rounded_size);
+  }
+  mapped_size = rounded_size;
+  return address;
+#else
+  (void)size;
+  (void)options;
+  mapped_size = 0u;
+  return nullptr;
+#endif
+}
+
+void
+unmap_huge_pages(void * address, size_t mapped_size) noexcept
+{
+#ifdef __linux__
+  if (address) {
+    munmap(address, mapped_size);
+  }
+#else
+  (void)address;
+  (void)mapped_size;
+#endif
+}
+
+}  // namespace allocator
+}  // namespace rclcpp
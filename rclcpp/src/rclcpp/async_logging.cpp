@@ -0,0 +1,403 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "./async_logging.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "rcl/logging.h"
+
+#include "./logging_mutex.hpp"
+#include "./shared_rosout.hpp"
+
+namespace
+{
+
+constexpr size_t kMaxNameLength = 128u;
+constexpr size_t kMaxMessageLength = 512u;
+// Longest time a queued message waits for the writer thread
+constexpr std::chrono::milliseconds kMaxWriteDelay(10);
+
+struct LogRecord
+{
+  // The names of the function and file are kept, as the logging macros use literals.
+  rcutils_log_location_t location;
+  bool has_location;
+  int severity;
+  rcutils_time_point_value_t timestamp;
+  char name[kMaxNameLength];
+  char message[kMaxMessageLength];
+};
+
+/// Ring buffer of log records, with a single producer and a single consumer.
+class RecordRing
+{
+public:
+  explicit RecordRing(size_t capacity)
+  : records_(capacity)
+  {
+  }
+
+  /// Return the record to fill before push(), or nullptr if the ring is full.
+  LogRecord *
+  get_free_record()
+  {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == records_.size()) {
+      return nullptr;
+    }
+    return &records_[tail % records_.size()];
+  }
+
+  void
+  push()
+  {
+    tail_.store(tail_.load(std::memory_order_relaxed) + 1u, std::memory_order_release);
+  }
+
+  /// Return the number of records to pop, for the consumer.
+  size_t
+  size() const
+  {
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_relaxed);
+  }
+
+  LogRecord &
+  at(size_t index)
+  {
+    return records_[(head_.load(std::memory_order_relaxed) + index) % records_.size()];
+  }
+
+  void
+  pop(size_t number_of_records)
+  {
+    head_.store(
+      head_.load(std::memory_order_relaxed) + number_of_records, std::memory_order_release);
+  }
+
+  std::atomic<size_t> number_of_dropped_records{0u};
+
+private:
+  std::vector<LogRecord> records_;
+  std::atomic<size_t> head_{0u};
+  std::atomic<size_t> tail_{0u};
+};
+
+void
+output_log_message(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  rclcpp::detail::publish_to_shared_rosout(location, severity, name, timestamp, format, &args);
+  rcl_logging_multiple_output_handler(location, severity, name, timestamp, format, &args);
+  va_end(args);
+}
+
+class AsyncLogging
+{
+public:
+  ~AsyncLogging()
+  {
+    stop();
+  }
+
+  void
+  start(size_t queue_size)
+  {
+    if (0u == queue_size) {
+      throw std::invalid_argument("the queue of the asynchronous logging can't be empty");
+    }
+    std::lock_guard<std::mutex> lock(start_mutex_);
+    if (started_.load()) {
+      return;
+    }
+    logging_mutex_ = get_global_logging_mutex();
+    {
+      std::lock_guard<std::mutex> rings_lock(rings_mutex_);
+      rings_.clear();
+    }
+    stop_requested_ = false;
+    queue_size_.store(queue_size);
+    // The rings of the threads are created again, with the new queue size.
+    generation_.fetch_add(1u);
+    writer_ = std::thread(&AsyncLogging::run, this);
+    started_.store(true);
+  }
+
+  void
+  stop()
+  {
+    std::lock_guard<std::mutex> lock(start_mutex_);
+    if (!started_.exchange(false)) {
+      return;
+    }
+    // The messages being queued are written before the writer thread stops.
+    while (active_producers_.load() != 0u) {
+      std::this_thread::yield();
+    }
+    {
+      std::lock_guard<std::mutex> wake_lock(wake_mutex_);
+      stop_requested_ = true;
+    }
+    wake_cv_.notify_one();
+    writer_.join();
+  }
+
+  bool
+  is_started() const
+  {
+    return started_.load();
+  }
+
+  bool
+  log(
+    const rcutils_log_location_t * location,
+    int severity, const char * name, rcutils_time_point_value_t timestamp,
+    const char * format, va_list * args)
+  {
+    if (severity >= RCUTILS_LOG_SEVERITY_FATAL) {
+      return false;
+    }
+    ActiveProducer active_producer(active_producers_);
+    if (!started_.load()) {
+      return false;
+    }
+
+    RecordRing & ring = get_thread_ring();
+    LogRecord * record = ring.get_free_record();
+    if (!record) {
+      ring.number_of_dropped_records.fetch_add(1u, std::memory_order_relaxed);
+      return true;
+    }
+    const size_t name_length = std::strlen(name);
+    if (name_length >= kMaxNameLength) {
+      return false;
+    }
+    va_list args_copy;
+    va_copy(args_copy, *args);
+    const int message_length =
+      std::vsnprintf(record->message, kMaxMessageLength, format, args_copy);
+    va_end(args_copy);
+    if (message_length < 0 || static_cast<size_t>(message_length) >= kMaxMessageLength) {
+      return false;
+    }
+    record->has_location = location != nullptr;
+    if (location) {
+      record->location = *location;
+    }
+    record->severity = severity;
+    record->timestamp = timestamp;
+    std::memcpy(record->name, name, name_length + 1u);
+    ring.push();
+
+    // The writer thread may miss this notification, as the wake mutex isn't locked,
+    // and then writes the message after waiting for kMaxWriteDelay.
+    if (!wake_requested_.exchange(true)) {
+      wake_cv_.notify_one();
+    }
+    return true;
+  }
+
+private:
+  class ActiveProducer
+  {
+  public:
+    explicit ActiveProducer(std::atomic<size_t> & active_producers)
+    : active_producers_(active_producers)
+    {
+      active_producers_.fetch_add(1u);
+    }
+
+    ~ActiveProducer()
+    {
+      active_producers_.fetch_sub(1u);
+    }
+
+  private:
+    std::atomic<size_t> & active_producers_;
+  };
+
+  struct ThreadRing
+  {
+    std::shared_ptr<RecordRing> ring;
+    uint64_t generation = 0u;
+  };
+
+  RecordRing &
+  get_thread_ring()
+  {
+    thread_local ThreadRing thread_ring;
+    const uint64_t generation = generation_.load();
+    if (!thread_ring.ring || thread_ring.generation != generation) {
+      thread_ring.ring = std::make_shared<RecordRing>(queue_size_.load());
+      thread_ring.generation = generation;
+      std::lock_guard<std::mutex> lock(rings_mutex_);
+      rings_.push_back(thread_ring.ring);
+    }
+    return *thread_ring.ring;
+  }
+
+  void
+  run()
+  {
+    bool stopping = false;
+    while (!stopping) {
+      {
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_cv_.wait_for(
+          lock, kMaxWriteDelay, [this]() {return stop_requested_ || wake_requested_.load();});
+        stopping = stop_requested_;
+      }
+      wake_requested_.store(false);
+      write_queued_records();
+    }
+  }
+
+  void
+  write_queued_records()
+  {
+    {
+      std::lock_guard<std::mutex> lock(rings_mutex_);
+      // The rings only referenced here belong to threads which exited.
+      rings_.erase(
+        std::remove_if(
+          rings_.begin(), rings_.end(),
+          [](const std::shared_ptr<RecordRing> & ring) {
+            return ring.use_count() == 1 && ring->size() == 0u &&
+            ring->number_of_dropped_records.load() == 0u;
+          }),
+        rings_.end());
+      rings_to_write_ = rings_;
+    }
+
+    records_to_write_.clear();
+    number_of_records_to_pop_.clear();
+    size_t number_of_dropped_records = 0u;
+    for (const auto & ring : rings_to_write_) {
+      const size_t number_of_records = ring->size();
+      for (size_t i = 0u; i < number_of_records; ++i) {
+        records_to_write_.push_back(&ring->at(i));
+      }
+      number_of_records_to_pop_.push_back(number_of_records);
+      number_of_dropped_records += ring->number_of_dropped_records.exchange(0u);
+    }
+    std::stable_sort(
+      records_to_write_.begin(), records_to_write_.end(),
+      [](const LogRecord * lhs, const LogRecord * rhs) {
+        return lhs->timestamp < rhs->timestamp;
+      });
+
+    if (!records_to_write_.empty() || number_of_dropped_records > 0u) {
+      std::lock_guard<std::recursive_mutex> guard(*logging_mutex_);
+      for (const LogRecord * record : records_to_write_) {
+        output_log_message(
+          record->has_location ? &record->location : nullptr, record->severity,
+          record->name, record->timestamp, "%s", record->message);
+      }
+      if (number_of_dropped_records > 0u) {
+        rcutils_time_point_value_t now = 0;
+        rcutils_system_time_now(&now);
+        output_log_message(
+          nullptr, RCUTILS_LOG_SEVERITY_WARN, "rclcpp", now,
+          "%zu log messages were dropped, as the asynchronous logging queue was full",
+          number_of_dropped_records);
+      }
+    }
+
+    for (size_t i = 0u; i < rings_to_write_.size(); ++i) {
+      rings_to_write_[i]->pop(number_of_records_to_pop_[i]);
+    }
+    rings_to_write_.clear();
+  }
+
+  std::mutex start_mutex_;
+  std::atomic<bool> started_{false};
+  std::atomic<size_t> active_producers_{0u};
+  std::atomic<size_t> queue_size_{0u};
+  std::atomic<uint64_t> generation_{0u};
+  std::thread writer_;
+  std::shared_ptr<std::recursive_mutex> logging_mutex_;
+
+  std::mutex rings_mutex_;
+  std::vector<std::shared_ptr<RecordRing>> rings_;
+
+  std::mutex wake_mutex_;
+  std::condition_variable wake_cv_;
+  std::atomic<bool> wake_requested_{false};
+  bool stop_requested_ = false;
+
+  // Only used by the writer thread, and kept to reuse their memory
+  std::vector<std::shared_ptr<RecordRing>> rings_to_write_;
+  std::vector<const LogRecord *> records_to_write_;
+  std::vector<size_t> number_of_records_to_pop_;
+};
+
+AsyncLogging &
+get_async_logging()
+{
+  static AsyncLogging async_logging;
+  return async_logging;
+}
+
+}  // namespace
+
+namespace rclcpp
+{
+namespace detail
+{
+
+void
+start_async_logging(size_t queue_size)
+{
+  get_async_logging().start(queue_size);
+}
+
+void
+stop_async_logging()
+{
+  get_async_logging().stop();
+}
+
+bool
+is_async_logging_started()
+{
+  return get_async_logging().is_started();
+}
+
+bool
+async_log(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args)
+{
+  return get_async_logging().log(location, severity, name, timestamp, format, args);
+}
+
+}  // namespace detail
+}  // namespace rclcpp
@@ -0,0 +1,80 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__ASYNC_LOGGING_HPP_
+#define RCLCPP__ASYNC_LOGGING_HPP_
+
+#include <cstdarg>
+#include <cstddef>
+
+#include "rcutils/logging.h"
+#include "rcutils/time.h"
+
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Start the thread writing the log messages queued by async_log().
+/**
+ * Each thread queues its log messages in its own ring buffer, without locking, and
+ * the writer thread outputs them in batches with rcl_logging_multiple_output_handler(),
+ * holding the global logging mutex once for each batch.
+ * The messages logged while the ring buffer of their thread is full are dropped,
+ * and the number of dropped messages is then logged by the writer thread.
+ *
+ * Nothing is done if the writer thread is already started.
+ *
+ * \param[in] queue_size number of messages queued by each thread.
+ * \throws std::invalid_argument if queue_size is 0.
+ */
+RCLCPP_LOCAL
+void
+start_async_logging(size_t queue_size);
+
+/// Output the queued log messages and stop the writer thread.
+/**
+ * The global logging mutex mustn't be held by the calling thread.
+ */
+RCLCPP_LOCAL
+void
+stop_async_logging();
+
+/// Return true if the writer thread is started.
+RCLCPP_LOCAL
+bool
+is_async_logging_started();
+
+/// Format a log message and queue it for the writer thread.
+/**
+ * The log messages aren't queued, and false returned, if the writer thread isn't started,
+ * if they are fatal, or if they are too long to fit in the ring buffers.
+ * These messages have to be output synchronously instead.
+ *
+ * \return true if the message was queued or dropped.
+ */
+RCLCPP_LOCAL
+bool
+async_log(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args);
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__ASYNC_LOGGING_HPP_
@@ -0,0 +1,107 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp/async_publish_writer.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "rclcpp/logging.hpp"
+
+using rclcpp::AsyncPublishWriter;
+
+AsyncPublishWriter::AsyncPublishWriter()
+: thread_(&AsyncPublishWriter::run, this)
+{}
+
+AsyncPublishWriter::~AsyncPublishWriter()
+{
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    stopped_ = true;
+  }
+  wake_condition_.notify_one();
+  thread_.join();
+}
+
+void
+AsyncPublishWriter::add_queue(std::shared_ptr<QueueBase> queue)
+{
+  if (!queue) {
+    throw std::invalid_argument("the queue added to the publish writer is null");
+  }
+  std::lock_guard<std::mutex> lock(queues_mutex_);
+  queues_.push_back(std::move(queue));
+}
+
+void
+AsyncPublishWriter::remove_queue(const QueueBase * queue)
+{
+  std::lock_guard<std::mutex> lock(queues_mutex_);
+  queues_.erase(
+    std::remove_if(
+      queues_.begin(), queues_.end(),
+      [queue](const std::shared_ptr<QueueBase> & element) {return element.get() == queue;}),
+    queues_.end());
+}
+
+void
+AsyncPublishWriter::notify()
+{
+  if (notified_.exchange(true, std::memory_order_acq_rel)) {
+    // The writer wasn't woken up since the previous notification.
+    return;
+  }
+  {
+    // Not being held by the writer between checking the flag and waiting, no wake up is lost.
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+  }
+  wake_condition_.notify_one();
+}
+
+void
+AsyncPublishWriter::run()
+{
+  while (true) {
+    notified_.store(false, std::memory_order_release);
+    size_t number_of_messages = 0;
+    {
+      std::lock_guard<std::mutex> lock(queues_mutex_);
+      for (const auto & queue : queues_) {
+        try {
+          number_of_messages += queue->publish_queued();
+        } catch (const std::exception & exception) {
+          RCLCPP_ERROR(
+            rclcpp::get_logger("rclcpp"),
+            "the publish writer failed to publish a message: %s", exception.what());
+          // The messages queued after it are published by the next iteration.
+          ++number_of_messages;
+        }
+      }
+    }
+    if (number_of_messages > 0) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    if (stopped_) {
+      return;
+    }
+    wake_condition_.wait(
+      lock, [this]() {return stopped_ || notified_.load(std::memory_order_acquire);});
+  }
+}
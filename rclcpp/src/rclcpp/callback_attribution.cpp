@@ -0,0 +1,137 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/callback_attribution.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <string>
+
+#include "rcutils/env.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define RCLCPP_HAS_USDT_PROBES
+#endif
+#endif
+#endif
+
+namespace
+{
+
+constexpr size_t thread_name_size = 16u;
+
+bool
+is_enabled_by_environment()
+{
+  const char * value = nullptr;
+  if (rcutils_get_env("RCLCPP_CALLBACK_ATTRIBUTION", &value) != nullptr || value == nullptr) {
+    return false;
+  }
+  return std::strcmp(value, "1") == 0;
+}
+
+std::atomic<bool> &
+get_enabled()
+{
+  static std::atomic<bool> enabled{is_enabled_by_environment()};
+  return enabled;
+}
+
+// Name of the calling thread as last set, to restore it without a system call
+thread_local char thread_name[thread_name_size] = {};
+thread_local bool thread_name_known = false;
+
+/// Copy the last characters of a name which fit in a thread name.
+void
+copy_thread_name(const char * name, char * thread_name_buffer) noexcept
+{
+  const size_t length = std::strlen(name);
+  const size_t start = length < thread_name_size ? 0u : length - (thread_name_size - 1u);
+  std::memcpy(thread_name_buffer, name + start, length - start);
+  thread_name_buffer[length - start] = '\0';
+}
+
+void
+apply_thread_name(const char * name) noexcept
+{
+  copy_thread_name(name, thread_name);
+  thread_name_known = true;
+#if defined(__linux__)
+  pthread_setname_np(pthread_self(), thread_name);
+#endif
+}
+
+void
+get_thread_name(char * thread_name_buffer) noexcept
+{
+  if (!thread_name_known) {
+#if defined(__linux__)
+    if (pthread_getname_np(pthread_self(), thread_name, thread_name_size) != 0) {
+      thread_name[0] = '\0';
+    }
+#endif
+    thread_name_known = true;
+  }
+  std::memcpy(thread_name_buffer, thread_name, thread_name_size);
+}
+
+}  // namespace
+
+void
+rclcpp::callback_attribution::enable()
+{
+  get_enabled().store(true);
+}
+
+void
+rclcpp::callback_attribution::disable()
+{
+  get_enabled().store(false);
+}
+
+bool
+rclcpp::callback_attribution::is_enabled() noexcept
+{
+  return get_enabled().load(std::memory_order_relaxed);
+}
+
+void
+rclcpp::callback_attribution::set_thread_name(const std::string & name) noexcept
+{
+  apply_thread_name(name.c_str());
+}
+
+void
+rclcpp::callback_attribution::ScopedCallback::start() noexcept
+{
+  get_thread_name(previous_thread_name_);
+  const char * name = name_ ? name_ : "callback";
+#if defined(RCLCPP_HAS_USDT_PROBES)
+  DTRACE_PROBE2(rclcpp, callback_start, entity_, name);
+#endif
+  apply_thread_name(name);
+}
+
+void
+rclcpp::callback_attribution::ScopedCallback::end() noexcept
+{
+#if defined(RCLCPP_HAS_USDT_PROBES)
+  DTRACE_PROBE2(rclcpp, callback_end, entity_, name_ ? name_ : "callback");
+#endif
+  apply_thread_name(previous_thread_name_);
+}
@@ -14,10 +14,14 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "rclcpp/callback_group.hpp"
 #include "rclcpp/client.hpp"
@@ -61,37 +65,37 @@ void CallbackGroup::collect_all_ptrs(
   std::function<void(const rclcpp::TimerBase::SharedPtr &)> timer_func,
   std::function<void(const rclcpp::Waitable::SharedPtr &)> waitable_func) const
 {
-  std::lock_guard<std::mutex> lock(mutex_);
+  const auto entities = get_entities();
 
-  for (const rclcpp::SubscriptionBase::WeakPtr & weak_ptr : subscription_ptrs_) {
+  for (const rclcpp::SubscriptionBase::WeakPtr & weak_ptr : entities->subscriptions) {
     rclcpp::SubscriptionBase::SharedPtr ref_ptr = weak_ptr.lock();
     if (ref_ptr) {
       sub_func(ref_ptr);
     }
   }
 
-  for (const rclcpp::ServiceBase::WeakPtr & weak_ptr : service_ptrs_) {
+  for (const rclcpp::ServiceBase::WeakPtr & weak_ptr : entities->services) {
     rclcpp::ServiceBase::SharedPtr ref_ptr = weak_ptr.lock();
     if (ref_ptr) {
       service_func(ref_ptr);
     }
   }
 
-  for (const rclcpp::ClientBase::WeakPtr & weak_ptr : client_ptrs_) {
+  for (const rclcpp::ClientBase::WeakPtr & weak_ptr : entities->clients) {
     rclcpp::ClientBase::SharedPtr ref_ptr = weak_ptr.lock();
     if (ref_ptr) {
       client_func(ref_ptr);
     }
   }
 
-  for (const rclcpp::TimerBase::WeakPtr & weak_ptr : timer_ptrs_) {
+  for (const rclcpp::TimerBase::WeakPtr & weak_ptr : entities->timers) {
     rclcpp::TimerBase::SharedPtr ref_ptr = weak_ptr.lock();
     if (ref_ptr) {
       timer_func(ref_ptr);
     }
   }
 
-  for (const rclcpp::Waitable::WeakPtr & weak_ptr : waitable_ptrs_) {
+  for (const rclcpp::Waitable::WeakPtr & weak_ptr : entities->waitables) {
     rclcpp::Waitable::SharedPtr ref_ptr = weak_ptr.lock();
     if (ref_ptr) {
       waitable_func(ref_ptr);
@@ -99,6 +103,47 @@ void CallbackGroup::collect_all_ptrs(
   }
 }
 
+template<typename WeakPtrT>
+static
+std::vector<WeakPtrT>
+copy_unexpired(const std::vector<WeakPtrT> & weak_ptrs)
+{
+  std::vector<WeakPtrT> copy;
+  copy.reserve(weak_ptrs.size());
+  for (const auto & weak_ptr : weak_ptrs) {
+    if (!weak_ptr.expired()) {
+      copy.push_back(weak_ptr);
+    }
+  }
+  return copy;
+}
+
+std::shared_ptr<const rclcpp::CallbackGroupEntities>
+CallbackGroup::get_entities() const
+{
+  auto entities = std::atomic_load(&entities_);
+  if (entities && entities->generation == generation_.load()) {
+    return entities;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Another thread may have copied the entities while waiting for the mutex
+  entities = std::atomic_load(&entities_);
+  if (entities && entities->generation == generation_.load()) {
+    return entities;
+  }
+  auto new_entities = std::make_shared<CallbackGroupEntities>();
+  new_entities->generation = generation_.load();
+  new_entities->subscriptions = copy_unexpired(subscription_ptrs_);
+  new_entities->timers = copy_unexpired(timer_ptrs_);
+  new_entities->services = copy_unexpired(service_ptrs_);
+  new_entities->clients = copy_unexpired(client_ptrs_);
+  new_entities->waitables = copy_unexpired(waitable_ptrs_);
+  entities = std::move(new_entities);
+  std::atomic_store(&entities_, entities);
+  return entities;
+}
+
 std::atomic_bool &
 CallbackGroup::get_associated_with_executor_atomic()
 {
@@ -111,6 +156,146 @@ CallbackGroup::automatically_add_to_executor_with_node() const
   return automatically_add_to_executor_with_node_;
 }
 
+void
+CallbackGroup::set_priority(int priority)
+{
+  priority_.store(priority);
+}
+
+int
+CallbackGroup::get_priority() const
+{
+  return priority_.load();
+}
+
+void
+CallbackGroup::set_deadline(std::chrono::nanoseconds deadline)
+{
+  deadline_ns_.store(std::max<int64_t>(deadline.count(), 0));
+}
+
+std::chrono::nanoseconds
+CallbackGroup::get_deadline() const
+{
+  return std::chrono::nanoseconds(deadline_ns_.load());
+}
+
+void
+CallbackGroup::enable_cpu_accounting(std::chrono::nanoseconds budget)
+{
+  if (budget < std::chrono::nanoseconds::zero()) {
+    throw std::invalid_argument("the CPU time budget of a callback group can't be negative");
+  }
+  cpu_budget_ns_.store(budget.count());
+  cpu_accounting_enabled_.store(true);
+}
+
+void
+CallbackGroup::disable_cpu_accounting()
+{
+  cpu_accounting_enabled_.store(false);
+}
+
+bool
+CallbackGroup::is_cpu_accounting_enabled() const
+{
+  return cpu_accounting_enabled_.load(std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds
+CallbackGroup::get_cpu_budget() const
+{
+  return std::chrono::nanoseconds(cpu_budget_ns_.load());
+}
+
+rclcpp::CallbackGroupCpuStatistics
+CallbackGroup::get_cpu_statistics() const
+{
+  CallbackGroupCpuStatistics statistics;
+  statistics.executions = cpu_executions_.load();
+  statistics.cpu_time = std::chrono::nanoseconds(cpu_time_ns_.load());
+  statistics.max_cpu_time = std::chrono::nanoseconds(max_cpu_time_ns_.load());
+  statistics.overruns = cpu_overruns_.load();
+  return statistics;
+}
+
+void
+CallbackGroup::reset_cpu_statistics()
+{
+  cpu_executions_.store(0u);
+  cpu_time_ns_.store(0);
+  max_cpu_time_ns_.store(0);
+  cpu_overruns_.store(0u);
+}
+
+void
+CallbackGroup::record_cpu_time(std::chrono::nanoseconds cpu_time)
+{
+  const int64_t cpu_time_ns = cpu_time.count();
+  cpu_executions_.fetch_add(1u, std::memory_order_relaxed);
+  cpu_time_ns_.fetch_add(cpu_time_ns, std::memory_order_relaxed);
+  int64_t max_cpu_time_ns = max_cpu_time_ns_.load(std::memory_order_relaxed);
+  while (cpu_time_ns > max_cpu_time_ns &&
+    !max_cpu_time_ns_.compare_exchange_weak(
+      max_cpu_time_ns, cpu_time_ns, std::memory_order_relaxed))
+  {
+  }
+  const int64_t budget_ns = cpu_budget_ns_.load(std::memory_order_relaxed);
+  if (budget_ns > 0 && cpu_time_ns > budget_ns) {
+    cpu_overruns_.fetch_add(1u, std::memory_order_relaxed);
+  }
+}
+
+void
+CallbackGroup::begin_execution()
+{
+  executions_in_progress_.fetch_add(1u);
+}
+
+void
+CallbackGroup::end_execution()
+{
+  executions_in_progress_.fetch_sub(1u);
+}
+
+bool
+CallbackGroup::wait_for_idle(std::chrono::nanoseconds timeout) const
+{
+  const auto start = std::chrono::steady_clock::now();
+  while (executions_in_progress_.load() > 0u || !can_be_taken_from_.load()) {
+    if (timeout >= std::chrono::nanoseconds::zero() &&
+      std::chrono::steady_clock::now() - start >= timeout)
+    {
+      return false;
+    }
+    // Executions are short compared to a migration, so polling is cheap enough here.
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+  return true;
+}
+
+bool
+CallbackGroup::set_enabled(bool enabled)
+{
+  if (enabled_.exchange(enabled) == enabled) {
+    return false;
+  }
+  trigger_notify_guard_condition();
+  return true;
+}
+
+bool
+CallbackGroup::is_enabled() const
+{
+  return enabled_.load();
+}
+
+uint64_t
+CallbackGroup::get_generation() const
+{
+  return generation_.load();
+}
+
 rclcpp::GuardCondition::SharedPtr
 CallbackGroup::get_notify_guard_condition(const rclcpp::Context::SharedPtr context_ptr)
 {
@@ -150,6 +335,7 @@ CallbackGroup::add_subscription(
       subscription_ptrs_.end(),
       [](rclcpp::SubscriptionBase::WeakPtr x) {return x.expired();}),
     subscription_ptrs_.end());
+  generation_++;
 }
 
 void
@@ -163,6 +349,7 @@ CallbackGroup::add_timer(const rclcpp::TimerBase::SharedPtr timer_ptr)
       timer_ptrs_.end(),
       [](rclcpp::TimerBase::WeakPtr x) {return x.expired();}),
     timer_ptrs_.end());
+  generation_++;
 }
 
 void
@@ -176,6 +363,7 @@ CallbackGroup::add_service(const rclcpp::ServiceBase::SharedPtr service_ptr)
       service_ptrs_.end(),
       [](rclcpp::ServiceBase::WeakPtr x) {return x.expired();}),
     service_ptrs_.end());
+  generation_++;
 }
 
 void
@@ -189,6 +377,7 @@ CallbackGroup::add_client(const rclcpp::ClientBase::SharedPtr client_ptr)
       client_ptrs_.end(),
       [](rclcpp::ClientBase::WeakPtr x) {return x.expired();}),
     client_ptrs_.end());
+  generation_++;
 }
 
 void
@@ -202,6 +391,7 @@ CallbackGroup::add_waitable(const rclcpp::Waitable::SharedPtr waitable_ptr)
       waitable_ptrs_.end(),
       [](rclcpp::Waitable::WeakPtr x) {return x.expired();}),
     waitable_ptrs_.end());
+  generation_++;
 }
 
 void
@@ -212,6 +402,7 @@ CallbackGroup::remove_waitable(const rclcpp::Waitable::SharedPtr waitable_ptr) n
     const auto shared_ptr = iter->lock();
     if (shared_ptr.get() == waitable_ptr.get()) {
       waitable_ptrs_.erase(iter);
+      generation_++;
       break;
     }
   }
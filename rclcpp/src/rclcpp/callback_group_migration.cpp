@@ -0,0 +1,194 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp/callback_group_migration.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+bool
+rclcpp::move_callback_group(
+  rclcpp::CallbackGroup::SharedPtr group,
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node,
+  rclcpp::Executor & source,
+  rclcpp::Executor & target,
+  std::chrono::nanoseconds timeout)
+{
+  if (!group) {
+    throw std::invalid_argument("callback group cannot be nullptr");
+  }
+  if (!node) {
+    throw std::invalid_argument("node cannot be nullptr");
+  }
+  if (&source == &target) {
+    throw std::invalid_argument("source and target executors must be different");
+  }
+  // No new execution of the group starts on the source executor once it's removed.
+  source.remove_callback_group(group);
+  if (!group->wait_for_idle(timeout)) {
+    source.add_callback_group(group, node);
+    return false;
+  }
+  target.add_callback_group(group, node);
+  return true;
+}
+
+rclcpp::CallbackGroupBalancer::CallbackGroupBalancer(
+  std::vector<rclcpp::Executor::SharedPtr> executors,
+  const CallbackGroupBalancerOptions & options)
+: executors_(std::move(executors)), options_(options)
+{
+  if (executors_.empty()) {
+    throw std::invalid_argument("at least one executor is required");
+  }
+  for (const auto & executor : executors_) {
+    if (!executor) {
+      throw std::invalid_argument("executor cannot be nullptr");
+    }
+  }
+  if (!(options_.min_imbalance_ratio >= 0.0 && options_.min_imbalance_ratio <= 1.0)) {
+    throw std::invalid_argument("min_imbalance_ratio must be between 0 and 1");
+  }
+}
+
+void
+rclcpp::CallbackGroupBalancer::add_callback_group(
+  rclcpp::CallbackGroup::SharedPtr group,
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node,
+  size_t executor_index)
+{
+  if (!group) {
+    throw std::invalid_argument("callback group cannot be nullptr");
+  }
+  if (!node) {
+    throw std::invalid_argument("node cannot be nullptr");
+  }
+  if (executor_index >= executors_.size()) {
+    throw std::invalid_argument("executor index out of range");
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto & balanced : groups_) {
+    if (balanced.group.lock() == group) {
+      throw std::invalid_argument("callback group is already balanced");
+    }
+  }
+  if (!group->is_cpu_accounting_enabled()) {
+    group->enable_cpu_accounting();
+  }
+  executors_[executor_index]->add_callback_group(group, node);
+  groups_.push_back({group, node, executor_index, group->get_cpu_statistics().cpu_time});
+}
+
+void
+rclcpp::CallbackGroupBalancer::remove_callback_group(rclcpp::CallbackGroup::SharedPtr group)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = std::find_if(
+    groups_.begin(), groups_.end(),
+    [&group](const BalancedCallbackGroup & balanced) {return balanced.group.lock() == group;});
+  if (!group || it == groups_.end()) {
+    throw std::invalid_argument("callback group is not balanced");
+  }
+  const size_t executor_index = it->executor_index;
+  groups_.erase(it);
+  executors_[executor_index]->remove_callback_group(group);
+}
+
+size_t
+rclcpp::CallbackGroupBalancer::get_executor_index(rclcpp::CallbackGroup::SharedPtr group) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto & balanced : groups_) {
+    if (group && balanced.group.lock() == group) {
+      return balanced.executor_index;
+    }
+  }
+  throw std::invalid_argument("callback group is not balanced");
+}
+
+bool
+rclcpp::CallbackGroupBalancer::rebalance()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // CPU time used by each group, and by each executor, since the previous call.
+  std::vector<int64_t> executor_loads(executors_.size(), 0);
+  std::vector<int64_t> group_loads;
+  group_loads.reserve(groups_.size());
+  for (auto it = groups_.begin(); it != groups_.end(); ) {
+    auto group = it->group.lock();
+    if (!group) {
+      it = groups_.erase(it);
+      continue;
+    }
+    const auto cpu_time = group->get_cpu_statistics().cpu_time;
+    // The statistics may have been reset in between.
+    const auto load = cpu_time >= it->last_cpu_time ? cpu_time - it->last_cpu_time : cpu_time;
+    it->last_cpu_time = cpu_time;
+    group_loads.push_back(load.count());
+    executor_loads[it->executor_index] += load.count();
+    ++it;
+  }
+
+  const auto minmax = std::minmax_element(executor_loads.begin(), executor_loads.end());
+  const int64_t max_load = *minmax.second;
+  const int64_t difference = max_load - *minmax.first;
+  if (max_load <= 0 ||
+    static_cast<double>(difference) <= options_.min_imbalance_ratio * static_cast<double>(max_load))
+  {
+    return false;
+  }
+  const auto busiest = static_cast<size_t>(minmax.second - executor_loads.begin());
+  const auto idlest = static_cast<size_t>(minmax.first - executor_loads.begin());
+
+  // Moving a group of load l gets the difference to |difference - 2 l|, which is the
+  // smallest for the group closest to half of it, and only shrinks if 0 < l < difference.
+  size_t best = groups_.size();
+  int64_t best_distance = 0;
+  for (size_t i = 0; i < groups_.size(); ++i) {
+    const int64_t load = group_loads[i];
+    if (groups_[i].executor_index != busiest || load <= 0 || load >= difference) {
+      continue;
+    }
+    const int64_t distance = std::abs(difference - 2 * load);
+    if (best == groups_.size() || distance < best_distance) {
+      best = i;
+      best_distance = distance;
+    }
+  }
+  if (best == groups_.size()) {
+    return false;
+  }
+
+  auto group = groups_[best].group.lock();
+  auto node = groups_[best].node.lock();
+  if (!group || !node) {
+    return false;
+  }
+  if (!rclcpp::move_callback_group(
+      group, node, *executors_[busiest], *executors_[idlest], options_.move_timeout))
+  {
+    return false;
+  }
+  groups_[best].executor_index = idlest;
+  return true;
+}
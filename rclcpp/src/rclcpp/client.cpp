@@ -17,8 +17,13 @@
 #include <algorithm>
 #include <chrono>
 #include <cstdio>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "rcl/graph.h"
 #include "rcl/node.h"
@@ -65,6 +70,53 @@ ClientBase::ClientBase(
     });
 }
 
+ClientBase::~ClientBase()
+{
+  if (intra_process_services_) {
+    intra_process_services_->remove_client(intra_process_client_id_);
+  }
+}
+
+bool
+ClientBase::setup_intra_process(const std::shared_ptr<ClientBase> & self)
+{
+  if (intra_process_queue_) {
+    return true;
+  }
+  if (!get_intra_process_type_support()) {
+    return false;
+  }
+  std::weak_ptr<ClientBase> weak_self = self;
+  intra_process_queue_ = std::make_shared<experimental::IntraProcessServiceQueue>(
+    context_,
+    [weak_self](std::shared_ptr<rmw_request_id_t> request_header, std::shared_ptr<void> response)
+    {
+      auto client = weak_self.lock();
+      if (client) {
+        client->handle_response(std::move(request_header), std::move(response));
+      }
+    });
+  intra_process_services_ = context_->get_sub_context<experimental::IntraProcessServices>();
+  intra_process_client_id_ = intra_process_services_->add_client(intra_process_queue_);
+  return true;
+}
+
+rclcpp::Waitable::SharedPtr
+ClientBase::get_intra_process_waitable() const
+{
+  return intra_process_queue_;
+}
+
+rclcpp::experimental::IntraProcessServiceQueue::SharedPtr
+ClientBase::get_intra_process_service_queue() const
+{
+  if (!intra_process_services_) {
+    return nullptr;
+  }
+  return intra_process_services_->get_service(
+    get_service_name(), get_intra_process_type_support());
+}
+
 bool
 ClientBase::take_type_erased_response(void * response_out, rmw_request_id_t & request_header_out)
 {
@@ -119,6 +171,108 @@ ClientBase::service_is_ready() const
   return is_ready;
 }
 
+struct ClientBase::ServiceAvailability
+{
+  /// Return true if the service is available, completing the future if it is.
+  bool
+  check()
+  {
+    bool is_ready = false;
+    rcl_ret_t ret = rcl_service_server_is_available(
+      node_handle.get(), client_handle.get(), &is_ready);
+    if (RCL_RET_OK != ret) {
+      // Checked again on the next graph change.
+      rcl_reset_error();
+      return false;
+    }
+    if (!is_ready) {
+      return false;
+    }
+    std::vector<std::function<void()>> callbacks_to_call;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (available) {
+        return true;
+      }
+      available = true;
+      callbacks_to_call.swap(callbacks);
+      // Nothing to check anymore, the graph event is released.
+      event.reset();
+    }
+    promise.set_value();
+    for (const auto & callback : callbacks_to_call) {
+      callback();
+    }
+    return true;
+  }
+
+  std::shared_ptr<rcl_node_t> node_handle;
+  std::shared_ptr<rcl_client_t> client_handle;
+
+  std::mutex mutex;
+  bool available{false};
+  std::vector<std::function<void()>> callbacks;
+  rclcpp::Event::SharedPtr event;
+  std::promise<void> promise;
+  std::shared_future<void> future{promise.get_future().share()};
+};
+
+std::shared_future<void>
+ClientBase::async_wait_for_service(std::function<void()> callback)
+{
+  auto node_ptr = node_graph_.lock();
+  if (!node_ptr) {
+    throw InvalidNodeError();
+  }
+
+  std::shared_ptr<ServiceAvailability> availability;
+  bool created = false;
+  {
+    std::lock_guard<std::mutex> lock(service_availability_mutex_);
+    if (service_availability_) {
+      std::lock_guard<std::mutex> availability_lock(service_availability_->mutex);
+      if (service_availability_->available) {
+        service_availability_.reset();
+      } else if (callback) {
+        service_availability_->callbacks.push_back(std::move(callback));
+      }
+    }
+    if (!service_availability_) {
+      service_availability_ = std::make_shared<ServiceAvailability>();
+      service_availability_->node_handle = node_handle_;
+      service_availability_->client_handle = client_handle_;
+      if (callback) {
+        service_availability_->callbacks.push_back(std::move(callback));
+      }
+      created = true;
+    }
+    availability = service_availability_;
+  }
+
+  if (created) {
+    // The filter doesn't own the state, which is released with the client.
+    std::weak_ptr<ServiceAvailability> weak_availability = availability;
+    auto event = node_ptr->get_filtered_graph_event(
+      [weak_availability]() {
+        auto availability = weak_availability.lock();
+        if (availability) {
+          availability->check();
+        }
+        // The event isn't waited on, the state is completed by the filter.
+        return false;
+      });
+    {
+      std::lock_guard<std::mutex> availability_lock(availability->mutex);
+      if (!availability->available) {
+        availability->event = std::move(event);
+      }
+    }
+    // Checked after registering the filter, so a server appearing in between isn't missed.
+    availability->check();
+  }
+  return availability->future;
+}
+
 bool
 ClientBase::wait_for_service_nanoseconds(std::chrono::nanoseconds timeout)
 {
@@ -136,7 +290,19 @@ ClientBase::wait_for_service_nanoseconds(std::chrono::nanoseconds timeout)
     // check was non-blocking, return immediately
     return false;
   }
-  auto event = node_ptr->get_graph_event();
+  // Only woken up by the graph changes making the service available.
+  auto event = node_ptr->get_filtered_graph_event(
+    [node_handle = node_handle_, client_handle = client_handle_]() {
+      bool is_ready = false;
+      rcl_ret_t ret = rcl_service_server_is_available(
+        node_handle.get(), client_handle.get(), &is_ready);
+      if (RCL_RET_OK != ret) {
+        rcl_reset_error();
+        // Let the waiting thread check it again.
+        return true;
+      }
+      return is_ready;
+    });
   // update the time even on the first loop to account for time spent in the first call
   // to this->server_is_ready()
   std::chrono::nanoseconds time_to_wait =
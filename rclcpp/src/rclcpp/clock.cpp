@@ -14,13 +14,16 @@
 
 #include "rclcpp/clock.hpp"
 
+#include <atomic>
 #include <condition_variable>
+#include <map>
 #include <memory>
 #include <thread>
 
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/utilities.hpp"
 
+#include "rcl/error_handling.h"
 #include "rcpputils/scope_exit.hpp"
 #include "rcutils/logging_macros.h"
 
@@ -37,6 +40,19 @@ public:
     if (ret != RCL_RET_OK) {
       exceptions::throw_from_rcl_error(ret, "failed to initialize rcl clock");
     }
+    if (RCL_ROS_TIME == clock_type) {
+      // Registered first, so that the cache is updated before the other callbacks are called.
+      rcl_jump_threshold_t threshold;
+      threshold.on_clock_change = true;
+      // 0 is disable, so -1 and 1 are smallest possible time changes
+      threshold.min_backward.nanoseconds = -1;
+      threshold.min_forward.nanoseconds = 1;
+      ret = rcl_clock_add_jump_callback(&rcl_clock_, threshold, on_ros_time_override, this);
+      if (ret != RCL_RET_OK) {
+        rcl_clock_fini(&rcl_clock_);
+        exceptions::throw_from_rcl_error(ret, "failed to add cache callback to rcl clock");
+      }
+    }
   }
 
   ~Impl()
@@ -47,9 +63,84 @@ public:
     }
   }
 
+  /// Update the cache of the overridden ROS time, once rcl changed it.
+  static void
+  on_ros_time_override(const rcl_time_jump_t * time_jump, bool before_jump, void * user_data)
+  {
+    if (before_jump) {
+      return;
+    }
+    auto impl = static_cast<Impl *>(user_data);
+    if (RCL_ROS_TIME_DEACTIVATED == time_jump->clock_change) {
+      impl->ros_time_override_active_.store(false, std::memory_order_release);
+      impl->wake_all_sleepers();
+      return;
+    }
+    rcl_time_point_value_t now;
+    if (RCL_RET_OK != rcl_clock_get_now(&impl->rcl_clock_, &now)) {
+      rcl_reset_error();
+      impl->ros_time_override_active_.store(false, std::memory_order_release);
+      impl->wake_all_sleepers();
+      return;
+    }
+    impl->ros_time_override_.store(now, std::memory_order_relaxed);
+    impl->ros_time_override_active_.store(true, std::memory_order_release);
+    if (RCL_ROS_TIME_NO_CHANGE != time_jump->clock_change) {
+      impl->wake_all_sleepers();
+    } else {
+      impl->wake_sleepers_until(now);
+    }
+  }
+
+  /// Thread sleeping until a ROS time, in the queue of the sleepers of the clock.
+  struct Sleeper
+  {
+    std::condition_variable * cv;
+    /// Cleared by the thread waking the sleeper, once it removed it from the queue.
+    bool queued{true};
+    bool time_source_changed{false};
+  };
+
+  /// Wake the sleepers whose deadline is reached by the new ROS time.
+  void
+  wake_sleepers_until(rcl_time_point_value_t now)
+  {
+    std::lock_guard<std::mutex> guard(sleepers_mutex_);
+    auto end = sleepers_.upper_bound(now);
+    for (auto it = sleepers_.begin(); it != end; ++it) {
+      it->second->queued = false;
+      it->second->cv->notify_one();
+    }
+    sleepers_.erase(sleepers_.begin(), end);
+  }
+
+  /// Wake all the sleepers, as the ROS time was enabled or disabled.
+  void
+  wake_all_sleepers()
+  {
+    std::lock_guard<std::mutex> guard(sleepers_mutex_);
+    for (auto & deadline_and_sleeper : sleepers_) {
+      deadline_and_sleeper.second->queued = false;
+      deadline_and_sleeper.second->time_source_changed = true;
+      deadline_and_sleeper.second->cv->notify_one();
+    }
+    sleepers_.clear();
+  }
+
   rcl_clock_t rcl_clock_;
   rcl_allocator_t allocator_;
   std::mutex clock_mutex_;
+
+  /// Copy of the overridden ROS time, read by now() without calling rcl.
+  std::atomic<rcl_time_point_value_t> ros_time_override_{0};
+  std::atomic_bool ros_time_override_active_{false};
+
+  /// Threads sleeping until a ROS time, indexed by their deadline.
+  /**
+   * It has its own mutex, since the jump callbacks may be called with clock_mutex_ locked.
+   */
+  std::mutex sleepers_mutex_;
+  std::multimap<rcl_time_point_value_t, Sleeper *> sleepers_;
 };
 
 JumpHandler::JumpHandler(
@@ -71,6 +162,12 @@ Clock::now() const
 {
   Time now(0, 0, impl_->rcl_clock_.type);
 
+  // Set when the ROS time is overridden, by a TimeSource for instance.
+  if (impl_->ros_time_override_active_.load(std::memory_order_acquire)) {
+    now.rcl_time_.nanoseconds = impl_->ros_time_override_.load(std::memory_order_relaxed);
+    return now;
+  }
+
   auto ret = rcl_clock_get_now(&impl_->rcl_clock_, &now.rcl_time_.nanoseconds);
   if (ret != RCL_RET_OK) {
     exceptions::throw_from_rcl_error(ret, "could not get current time stamp");
@@ -129,44 +226,36 @@ Clock::sleep_until(Time until, Context::SharedPtr context)
       cv.wait_until(lock, system_time);
     }
   } else if (this_clock_type == RCL_ROS_TIME) {
-    // Install jump handler for any amount of time change, for two purposes:
-    // - if ROS time is active, check if time reached on each new clock sample
-    // - Trigger via on_clock_change to detect if time source changes, to invalidate sleep
-    rcl_jump_threshold_t threshold;
-    threshold.on_clock_change = true;
-    // 0 is disable, so -1 and 1 are smallest possible time changes
-    threshold.min_backward.nanoseconds = -1;
-    threshold.min_forward.nanoseconds = 1;
-    auto clock_handler = create_jump_callback(
-      nullptr,
-      [&cv, &time_source_changed](const rcl_time_jump_t & jump) {
-        if (jump.clock_change != RCL_ROS_TIME_NO_CHANGE) {
-          time_source_changed = true;
-        }
-        cv.notify_one();
-      },
-      threshold);
-
-    if (!ros_time_is_active()) {
+    // Queued by deadline, so that a new clock sample only wakes the threads it concerns.
+    // All of them are woken if the time source changes, which invalidates the sleep.
+    std::unique_lock lock(impl_->sleepers_mutex_);
+    Impl::Sleeper sleeper{&cv};
+    auto sleeper_it = impl_->sleepers_.emplace(until.nanoseconds(), &sleeper);
+    RCPPUTILS_SCOPE_EXIT(
+    {
+      if (sleeper.queued) {
+        impl_->sleepers_.erase(sleeper_it);
+      }
+    });
+
+    if (!impl_->ros_time_override_active_.load(std::memory_order_acquire)) {
       auto system_time = std::chrono::system_clock::time_point(
         // Cast because system clock resolution is too big for nanoseconds on some systems
         std::chrono::duration_cast<std::chrono::system_clock::duration>(
           std::chrono::nanoseconds(until.nanoseconds())));
 
       // loop over spurious wakeups but notice shutdown or time source change
-      std::unique_lock lock(impl_->clock_mutex_);
-      while (now() < until && context->is_valid() && !time_source_changed) {
+      while (now() < until && context->is_valid() && !sleeper.time_source_changed) {
         cv.wait_until(lock, system_time);
       }
     } else {
       // RCL_ROS_TIME with ros_time_is_active.
-      // Just wait without "until" because installed
-      // jump callbacks wake the cv on every new sample.
-      std::unique_lock lock(impl_->clock_mutex_);
-      while (now() < until && context->is_valid() && !time_source_changed) {
+      // Just wait without "until" because the sleeper is woken once its deadline is reached.
+      while (now() < until && context->is_valid() && !sleeper.time_source_changed) {
         cv.wait(lock);
       }
     }
+    time_source_changed = sleeper.time_source_changed;
   }
 
   if (!context->is_valid() || time_source_changed) {
@@ -14,10 +14,15 @@
 
 #include "rclcpp/context.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 #include <unordered_set>
 #include <utility>
@@ -32,7 +37,9 @@
 #include "rcutils/error_handling.h"
 #include "rcutils/macros.h"
 
+#include "./async_logging.hpp"
 #include "./logging_mutex.hpp"
+#include "./shared_rosout.hpp"
 
 using rclcpp::Context;
 
@@ -118,6 +125,58 @@ get_logging_reference_count()
   return ref_count;
 }
 
+/// Call the shutdown callbacks, concurrently if more than one thread is asked for.
+template<typename CallbacksT>
+static
+void
+call_shutdown_callbacks(const CallbacksT & callbacks, size_t number_of_threads)
+{
+  if (0u == number_of_threads) {
+    number_of_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  number_of_threads = std::min(number_of_threads, callbacks.size());
+  if (number_of_threads <= 1u) {
+    for (const auto & callback : callbacks) {
+      (*callback)();
+    }
+    return;
+  }
+
+  const std::vector<typename CallbacksT::value_type> callbacks_to_call(
+    callbacks.begin(), callbacks.end());
+  std::atomic<size_t> next_callback{0u};
+  auto call_callbacks =
+    [&callbacks_to_call, &next_callback]() {
+      for (size_t i = next_callback++; i < callbacks_to_call.size(); i = next_callback++) {
+        (*callbacks_to_call[i])();
+      }
+    };
+  std::vector<std::future<void>> futures;
+  for (size_t i = 1u; i < number_of_threads; ++i) {
+    futures.push_back(std::async(std::launch::async, call_callbacks));
+  }
+  // The thread shutting down the context calls callbacks too, but it has to wait for the
+  // other threads before returning, even if a callback throws.
+  std::exception_ptr exception;
+  try {
+    call_callbacks();
+  } catch (...) {
+    exception = std::current_exception();
+  }
+  for (auto & future : futures) {
+    try {
+      future.get();
+    } catch (...) {
+      if (!exception) {
+        exception = std::current_exception();
+      }
+    }
+  }
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
 extern "C"
 {
 static
@@ -131,6 +190,7 @@ rclcpp_logging_output_handler(
     std::shared_ptr<std::recursive_mutex> logging_mutex;
     logging_mutex = get_global_logging_mutex();
     std::lock_guard<std::recursive_mutex> guard(*logging_mutex);
+    rclcpp::detail::publish_to_shared_rosout(location, severity, name, timestamp, format, args);
     return rcl_logging_multiple_output_handler(
       location, severity, name, timestamp, format, args);
   } catch (std::exception & ex) {
@@ -140,6 +200,23 @@ rclcpp_logging_output_handler(
     RCUTILS_SAFE_FWRITE_TO_STDERR("failed to take global rclcpp logging mutex\n");
   }
 }
+
+static
+void
+rclcpp_async_logging_output_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args)
+{
+  try {
+    if (rclcpp::detail::async_log(location, severity, name, timestamp, format, args)) {
+      return;
+    }
+  } catch (...) {
+    // The message is output synchronously instead.
+  }
+  rclcpp_logging_output_handler(location, severity, name, timestamp, format, args);
+}
 }  // extern "C"
 
 Context::Context()
@@ -217,14 +294,22 @@ Context::init(
     std::lock_guard<std::recursive_mutex> guard(*logging_mutex_);
     size_t & count = get_logging_reference_count();
     if (0u == count) {
+      rcutils_logging_output_handler_t output_handler = rclcpp_logging_output_handler;
+      if (init_options.asynchronous_logging()) {
+        detail::start_async_logging(init_options.asynchronous_logging_queue_size());
+        output_handler = rclcpp_async_logging_output_handler;
+      }
       ret = rcl_logging_configure_with_output_handler(
         &rcl_context_->global_arguments,
         rcl_init_options_get_allocator(init_options_.get_rcl_init_options()),
-        rclcpp_logging_output_handler);
+        output_handler);
       if (RCL_RET_OK != ret) {
         rcl_context_.reset();
+        detail::stop_async_logging();
         rclcpp::exceptions::throw_from_rcl_error(ret, "failed to configure logging");
       }
+      // The levels of the loggers may have been given as arguments
+      rclcpp::Logger::invalidate_cached_levels();
     } else {
       RCLCPP_WARN(
         rclcpp::get_logger("rclcpp"),
@@ -327,9 +412,7 @@ Context::shutdown(const std::string & reason)
   // call each shutdown callback
   {
     std::lock_guard<std::mutex> lock(on_shutdown_callbacks_mutex_);
-    for (const auto & callback : on_shutdown_callbacks_) {
-      (*callback)();
-    }
+    call_shutdown_callbacks(on_shutdown_callbacks_, init_options_.shutdown_callback_threads());
   }
 
   // interrupt all blocking sleep_for() and all blocking executors or wait sets
@@ -339,9 +422,15 @@ Context::shutdown(const std::string & reason)
   // shutdown logger
   if (logging_mutex_) {
     // logging was initialized by this context
-    std::lock_guard<std::recursive_mutex> guard(*logging_mutex_);
+    std::unique_lock<std::recursive_mutex> guard(*logging_mutex_);
     size_t & count = get_logging_reference_count();
-    if (0u == --count) {
+    if (0u == --count && detail::is_async_logging_started()) {
+      // The writer thread of the asynchronous logging locks the logging mutex.
+      guard.unlock();
+      detail::stop_async_logging();
+      guard.lock();
+    }
+    if (0u == count) {
       rcl_ret_t rcl_ret = rcl_logging_fini();
       if (RCL_RET_OK != rcl_ret) {
         RCUTILS_SAFE_FWRITE_TO_STDERR(
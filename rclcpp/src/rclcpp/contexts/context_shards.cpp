@@ -0,0 +1,106 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp/contexts/context_shards.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using rclcpp::contexts::ContextShards;
+
+ContextShards::ContextShards(
+  size_t number_of_shards,
+  int argc,
+  char const * const * argv,
+  const rclcpp::InitOptions & init_options)
+{
+  if (0u == number_of_shards) {
+    number_of_shards = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+  rclcpp::InitOptions shard_init_options = init_options;
+  shard_init_options.share_intra_process_manager(true);
+
+  contexts_.reserve(number_of_shards);
+  for (size_t i = 0; i < number_of_shards; ++i) {
+    auto context = std::make_shared<rclcpp::Context>();
+    // The contexts initialized before are shut down by their destructor if this throws
+    context->init(argc, argv, shard_init_options);
+    contexts_.push_back(std::move(context));
+  }
+}
+
+ContextShards::~ContextShards()
+{
+  shutdown("context shards destroyed");
+}
+
+size_t
+ContextShards::size() const
+{
+  return contexts_.size();
+}
+
+const std::vector<rclcpp::Context::SharedPtr> &
+ContextShards::get_contexts() const
+{
+  return contexts_;
+}
+
+rclcpp::Context::SharedPtr
+ContextShards::get_context(size_t index) const
+{
+  if (index >= contexts_.size()) {
+    throw std::out_of_range("there is no context shard " + std::to_string(index));
+  }
+  return contexts_[index];
+}
+
+rclcpp::Context::SharedPtr
+ContextShards::get_context_for_node(
+  const std::string & node_name,
+  const std::string & namespace_) const
+{
+  const size_t hash = std::hash<std::string>{}(namespace_ + "/" + node_name);
+  return contexts_[hash % contexts_.size()];
+}
+
+rclcpp::NodeOptions
+ContextShards::node_options(
+  const std::string & node_name,
+  const std::string & namespace_,
+  rclcpp::NodeOptions options) const
+{
+  options.context(get_context_for_node(node_name, namespace_));
+  return options;
+}
+
+bool
+ContextShards::shutdown(const std::string & reason)
+{
+  bool all_shut_down = true;
+  for (const auto & context : contexts_) {
+    if (context->is_valid()) {
+      all_shut_down &= context->shutdown(reason);
+    } else {
+      all_shut_down = false;
+    }
+  }
+  return all_shut_down;
+}
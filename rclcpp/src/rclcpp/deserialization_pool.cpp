@@ -0,0 +1,94 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp/deserialization_pool.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+#include "rclcpp/logging.hpp"
+
+using rclcpp::DeserializationPool;
+
+DeserializationPool::DeserializationPool(size_t number_of_threads)
+{
+  if (number_of_threads == 0) {
+    number_of_threads = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+  threads_.reserve(number_of_threads);
+  for (size_t i = 0; i < number_of_threads; ++i) {
+    threads_.emplace_back(&DeserializationPool::run, this);
+  }
+}
+
+DeserializationPool::~DeserializationPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  condition_.notify_all();
+  for (auto & thread : threads_) {
+    thread.join();
+  }
+}
+
+void
+DeserializationPool::submit(std::function<void()> task)
+{
+  if (!task) {
+    throw std::invalid_argument("the task submitted to the deserialization pool is empty");
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+  condition_.notify_one();
+}
+
+size_t
+DeserializationPool::get_number_of_threads() const
+{
+  return threads_.size();
+}
+
+void
+DeserializationPool::run()
+{
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [this]() {return stopped_ || !tasks_.empty();});
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    try {
+      task();
+    } catch (const std::exception & exception) {
+      RCLCPP_ERROR(
+        rclcpp::get_logger("rclcpp"),
+        "a task of the deserialization pool failed: %s", exception.what());
+    } catch (...) {
+      RCLCPP_ERROR(
+        rclcpp::get_logger("rclcpp"), "a task of the deserialization pool failed");
+    }
+  }
+}
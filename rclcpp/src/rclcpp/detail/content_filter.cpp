@@ -0,0 +1,1034 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp/detail/content_filter.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "rcutils/error_handling.h"
+#include "rosidl_typesupport_introspection_cpp/field_types.hpp"
+#include "rosidl_typesupport_introspection_cpp/identifier.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_introspection.hpp"
+
+#include "./plain_cdr.hpp"
+
+using rclcpp::detail::ContentFilter;
+using rosidl_typesupport_introspection_cpp::MessageMember;
+using rosidl_typesupport_introspection_cpp::MessageMembers;
+namespace plain_cdr = rclcpp::detail::plain_cdr;
+
+namespace
+{
+
+/// Value of a field or of a literal.
+struct Value
+{
+  enum class Kind {Signed, Unsigned, Float, String};
+
+  Kind kind = Kind::Signed;
+  int64_t signed_value = 0;
+  uint64_t unsigned_value = 0;
+  double float_value = 0.;
+  const std::string * string_value = nullptr;
+};
+
+enum class Ordering {Less, Equal, Greater, Unordered};
+
+enum class RelationalOperator {Equal, NotEqual, Less, LessOrEqual, Greater, GreaterOrEqual};
+
+template<typename T>
+Ordering
+compare_values(const T & lhs, const T & rhs)
+{
+  if (lhs < rhs) {
+    return Ordering::Less;
+  }
+  if (rhs < lhs) {
+    return Ordering::Greater;
+  }
+  // Only NaN isn't equal to itself.
+  return lhs == rhs ? Ordering::Equal : Ordering::Unordered;
+}
+
+double
+to_double(const Value & value)
+{
+  switch (value.kind) {
+    case Value::Kind::Signed:
+      return static_cast<double>(value.signed_value);
+    case Value::Kind::Unsigned:
+      return static_cast<double>(value.unsigned_value);
+    default:
+      return value.float_value;
+  }
+}
+
+/// Compare two values, whose kinds are both strings or both numbers.
+Ordering
+compare(const Value & lhs, const Value & rhs)
+{
+  if (lhs.kind == Value::Kind::String) {
+    return compare_values(*lhs.string_value, *rhs.string_value);
+  }
+  if (lhs.kind == Value::Kind::Float || rhs.kind == Value::Kind::Float) {
+    return compare_values(to_double(lhs), to_double(rhs));
+  }
+  if (lhs.kind == rhs.kind) {
+    if (lhs.kind == Value::Kind::Signed) {
+      return compare_values(lhs.signed_value, rhs.signed_value);
+    }
+    return compare_values(lhs.unsigned_value, rhs.unsigned_value);
+  }
+  // A negative value is less than any unsigned one.
+  if (lhs.kind == Value::Kind::Signed) {
+    if (lhs.signed_value < 0) {
+      return Ordering::Less;
+    }
+    return compare_values(static_cast<uint64_t>(lhs.signed_value), rhs.unsigned_value);
+  }
+  if (rhs.signed_value < 0) {
+    return Ordering::Greater;
+  }
+  return compare_values(lhs.unsigned_value, static_cast<uint64_t>(rhs.signed_value));
+}
+
+bool
+holds(RelationalOperator op, Ordering ordering)
+{
+  switch (op) {
+    case RelationalOperator::Equal:
+      return ordering == Ordering::Equal;
+    case RelationalOperator::NotEqual:
+      return ordering != Ordering::Equal;
+    case RelationalOperator::Less:
+      return ordering == Ordering::Less;
+    case RelationalOperator::LessOrEqual:
+      return ordering == Ordering::Less || ordering == Ordering::Equal;
+    case RelationalOperator::Greater:
+      return ordering == Ordering::Greater;
+    default:
+      return ordering == Ordering::Greater || ordering == Ordering::Equal;
+  }
+}
+
+/// Return true if a string matches a LIKE pattern.
+bool
+matches_pattern(const std::string & string, const std::string & pattern)
+{
+  size_t s = 0;
+  size_t p = 0;
+  // Position of the last '%' of the pattern, and of the string when it was reached
+  size_t any_p = std::string::npos;
+  size_t any_s = 0;
+  while (s < string.size()) {
+    if (p < pattern.size() && (pattern[p] == '_' || pattern[p] == string[s])) {
+      ++s;
+      ++p;
+    } else if (p < pattern.size() && pattern[p] == '%') {
+      any_p = p++;
+      any_s = s;
+    } else if (any_p != std::string::npos) {
+      p = any_p + 1;
+      s = ++any_s;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '%') {
+    ++p;
+  }
+  return p == pattern.size();
+}
+
+template<typename T>
+void
+read_number(const void * data, Value & value)
+{
+  const T number = *static_cast<const T *>(data);
+  if constexpr (std::is_floating_point<T>::value) {
+    value.kind = Value::Kind::Float;
+    value.float_value = static_cast<double>(number);
+  } else if constexpr (std::is_signed<T>::value) {
+    value.kind = Value::Kind::Signed;
+    value.signed_value = static_cast<int64_t>(number);
+  } else {
+    value.kind = Value::Kind::Unsigned;
+    value.unsigned_value = static_cast<uint64_t>(number);
+  }
+}
+
+/// Call a function with a null pointer to the C++ type of a numeric field.
+template<typename FunctionT>
+void
+dispatch_number_type(uint8_t type_id, FunctionT && function)
+{
+  namespace introspection = rosidl_typesupport_introspection_cpp;
+  switch (type_id) {
+    case introspection::ROS_TYPE_FLOAT:
+      function(static_cast<float *>(nullptr));
+      break;
+    case introspection::ROS_TYPE_DOUBLE:
+      function(static_cast<double *>(nullptr));
+      break;
+    case introspection::ROS_TYPE_LONG_DOUBLE:
+      function(static_cast<long double *>(nullptr));
+      break;
+    case introspection::ROS_TYPE_BOOLEAN:
+      function(static_cast<bool *>(nullptr));
+      break;
+    case introspection::ROS_TYPE_CHAR:
+    case introspection::ROS_TYPE_OCTET:
+    case introspection::ROS_TYPE_UINT8:
+      function(static_cast<uint8_t *>(nullptr));
+      break;
+    case introspection::ROS_TYPE_WCHAR:
+    case introspection::ROS_TYPE_UINT16:
+      function(static_cast<uint16_t *>(nullptr));
+      break;
+    case introspection::ROS_TYPE_INT8:
+      function(static_cast<int8_t *>(nullptr));
+      break;
+    case introspection::ROS_TYPE_INT16:
+      function(static_cast<int16_t *>(nullptr));
+      break;
+    case introspection::ROS_TYPE_UINT32:
+      function(static_cast<uint32_t *>(nullptr));
+      break;
+    case introspection::ROS_TYPE_INT32:
+      function(static_cast<int32_t *>(nullptr));
+      break;
+    case introspection::ROS_TYPE_UINT64:
+      function(static_cast<uint64_t *>(nullptr));
+      break;
+    default:
+      function(static_cast<int64_t *>(nullptr));
+      break;
+  }
+}
+
+template<typename T>
+void
+read_serialized_number(const plain_cdr::Payload & payload, size_t offset, Value & value)
+{
+  T number;
+  plain_cdr::copy_primitives(payload, offset, sizeof(T), 1u, &number);
+  read_number<T>(&number, value);
+}
+
+bool
+skip_serialized_message(const MessageMembers * members, size_t & offset);
+
+/// Advance the offset past a member of fixed size, or return false if it has none.
+bool
+skip_serialized_member(const MessageMember & member, size_t & offset)
+{
+  size_t count = 1;
+  if (member.is_array_) {
+    if (member.array_size_ == 0 || member.is_upper_bound_) {
+      return false;
+    }
+    count = member.array_size_;
+  }
+  if (member.type_id_ == rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE) {
+    const auto * members = static_cast<const MessageMembers *>(member.members_->data);
+    for (size_t i = 0; i < count; ++i) {
+      if (!skip_serialized_message(members, offset)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  const size_t size = plain_cdr::get_size(member.type_id_);
+  if (size == 0) {
+    return false;
+  }
+  offset = plain_cdr::align(offset, size) + size * count;
+  return true;
+}
+
+bool
+skip_serialized_message(const MessageMembers * members, size_t & offset)
+{
+  for (uint32_t i = 0; i < members->member_count_; ++i) {
+    if (!skip_serialized_member(members->members_[i], offset)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// A field of the messages, or an element of one of their arrays.
+class Field
+{
+public:
+  Field(const MessageMembers * members, const std::string & path)
+  {
+    namespace introspection = rosidl_typesupport_introspection_cpp;
+    // The offset of the field in the serialized messages, while its steps are fixed
+    size_t serialized_offset = 0;
+    bool is_serialized_offset_fixed = true;
+    size_t begin = 0;
+    while (true) {
+      const size_t end = path.find('.', begin);
+      const std::string component = path.substr(begin, end - begin);
+      Step step;
+      const size_t bracket = component.find('[');
+      const std::string name = component.substr(0, bracket);
+      if (bracket != std::string::npos) {
+        const std::string digits = component.substr(bracket + 1, component.size() - bracket - 2);
+        if (component.back() != ']' || digits.empty() || digits.size() > 9 ||
+          digits.find_first_not_of("0123456789") != std::string::npos)
+        {
+          throw std::invalid_argument("the index of the field '" + path + "' is invalid");
+        }
+        step.has_index = true;
+        step.index = std::stoul(digits);
+      }
+      for (uint32_t i = 0; i < members->member_count_ && !step.member; ++i) {
+        if (name == members->members_[i].name_) {
+          step.member = &members->members_[i];
+        } else if (is_serialized_offset_fixed) {
+          is_serialized_offset_fixed =
+            skip_serialized_member(members->members_[i], serialized_offset);
+        }
+      }
+      if (!step.member) {
+        throw std::invalid_argument("the messages have no field '" + path + "'");
+      }
+      if (step.member->is_array_ != step.has_index) {
+        throw std::invalid_argument(
+                step.has_index ?
+                "the field '" + name + "' isn't an array" :
+                "the array '" + name + "' can only be compared by element");
+      }
+      if (step.has_index &&
+        (step.member->size_function == nullptr ||
+        (step.member->type_id_ == introspection::ROS_TYPE_BOOLEAN ?
+        step.member->fetch_function == nullptr : step.member->get_const_function == nullptr)))
+      {
+        throw std::invalid_argument("the elements of the array '" + name + "' can't be read");
+      }
+      steps_.push_back(step);
+
+      const bool is_message = step.member->type_id_ == introspection::ROS_TYPE_MESSAGE;
+      if (step.has_index && is_serialized_offset_fixed) {
+        // Only the elements of the arrays of fixed size have fixed offsets.
+        const MessageMember & member = *step.member;
+        is_serialized_offset_fixed = member.array_size_ > 0 && !member.is_upper_bound_ &&
+          step.index < member.array_size_;
+        for (size_t i = 0; is_message && is_serialized_offset_fixed && i < step.index; ++i) {
+          is_serialized_offset_fixed = skip_serialized_message(
+            static_cast<const MessageMembers *>(member.members_->data), serialized_offset);
+        }
+        const size_t size = plain_cdr::get_size(member.type_id_);
+        if (!is_message) {
+          is_serialized_offset_fixed &= size > 0;
+          serialized_offset =
+            size > 0 ? plain_cdr::align(serialized_offset, size) + size * step.index : 0;
+        }
+      }
+      if (end == std::string::npos) {
+        if (is_message || step.member->type_id_ == introspection::ROS_TYPE_WSTRING) {
+          throw std::invalid_argument("the field '" + path + "' can't be compared");
+        }
+        // The strings are preceded by their length and end with a null character.
+        const size_t size = is_string() ? 4u : plain_cdr::get_size(step.member->type_id_);
+        if (is_serialized_offset_fixed && size > 0) {
+          serialized_offset_ = plain_cdr::align(serialized_offset, size);
+          serialized_end_ = serialized_offset_ + size;
+        }
+        break;
+      }
+      if (!is_message) {
+        throw std::invalid_argument("the field '" + name + "' isn't a message");
+      }
+      members = static_cast<const MessageMembers *>(step.member->members_->data);
+      begin = end + 1;
+    }
+  }
+
+  /// Read the field of a message, returning false if it's past the end of a sequence.
+  bool
+  read(const void * message, Value & value) const
+  {
+    namespace introspection = rosidl_typesupport_introspection_cpp;
+    const void * data = message;
+    bool boolean_element = false;
+    for (const Step & step : steps_) {
+      const void * field = static_cast<const uint8_t *>(data) + step.member->offset_;
+      if (!step.has_index) {
+        data = field;
+        continue;
+      }
+      if (step.index >= step.member->size_function(field)) {
+        return false;
+      }
+      if (step.member->type_id_ == introspection::ROS_TYPE_BOOLEAN) {
+        // The elements of the sequences of booleans have no address.
+        step.member->fetch_function(field, step.index, &boolean_element);
+        data = &boolean_element;
+      } else {
+        data = step.member->get_const_function(field, step.index);
+      }
+    }
+
+    if (is_string()) {
+      value.kind = Value::Kind::String;
+      value.string_value = static_cast<const std::string *>(data);
+      return true;
+    }
+    dispatch_number_type(
+      steps_.back().member->type_id_, [data, &value](auto * type) {
+        read_number<std::remove_pointer_t<decltype(type)>>(data, value);
+      });
+    return true;
+  }
+
+  /// Read the field of a serialized message, whose size is at least get_serialized_end().
+  /**
+   * \param[in] payload payload of the message.
+   * \param[out] value value of the field.
+   * \param[out] storage string the value of a string field is copied to.
+   * \return false if the length of a string field exceeds the message.
+   */
+  bool
+  read_serialized(const plain_cdr::Payload & payload, Value & value, std::string & storage) const
+  {
+    const uint8_t type_id = steps_.back().member->type_id_;
+    if (type_id == rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOLEAN) {
+      value.kind = Value::Kind::Unsigned;
+      value.unsigned_value = payload.data[serialized_offset_] != 0 ? 1u : 0u;
+      return true;
+    }
+    if (!is_string()) {
+      dispatch_number_type(
+        type_id, [this, &payload, &value](auto * type) {
+          read_serialized_number<std::remove_pointer_t<decltype(type)>>(
+            payload, serialized_offset_, value);
+        });
+      return true;
+    }
+    Value length;
+    read_serialized_number<uint32_t>(payload, serialized_offset_, length);
+    if (length.unsigned_value == 0 || length.unsigned_value > payload.size - serialized_end_) {
+      return false;
+    }
+    storage.assign(
+      reinterpret_cast<const char *>(payload.data + serialized_end_),
+      static_cast<size_t>(length.unsigned_value - 1));
+    value.kind = Value::Kind::String;
+    value.string_value = &storage;
+    return true;
+  }
+
+  bool
+  is_string() const
+  {
+    return steps_.back().member->type_id_ == rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING;
+  }
+
+  /// Return true if the field has the same offset in all the serialized messages.
+  bool
+  has_serialized_offset() const
+  {
+    return serialized_end_ > 0;
+  }
+
+  /// Return the minimum size of the serialized messages containing the field.
+  size_t
+  get_serialized_end() const
+  {
+    return serialized_end_;
+  }
+
+private:
+  struct Step
+  {
+    const MessageMember * member = nullptr;
+    bool has_index = false;
+    size_t index = 0;
+  };
+
+  std::vector<Step> steps_;
+  // Offset of the field, or of the length of a string field, in the serialized messages
+  size_t serialized_offset_ = 0;
+  size_t serialized_end_ = 0;
+};
+
+/// A field or a literal compared by a condition.
+struct Operand
+{
+  bool
+  read(const void * message, Value & value) const
+  {
+    if (field) {
+      return field->read(message, value);
+    }
+    value = literal;
+    value.string_value = &string;
+    return true;
+  }
+
+  bool
+  read_serialized(const plain_cdr::Payload & payload, Value & value, std::string & storage) const
+  {
+    if (field) {
+      return field->read_serialized(payload, value, storage);
+    }
+    value = literal;
+    value.string_value = &string;
+    return true;
+  }
+
+  bool
+  is_string() const
+  {
+    return field ? field->is_string() : literal.kind == Value::Kind::String;
+  }
+
+  std::unique_ptr<Field> field;
+  Value literal;
+  std::string string;
+};
+
+struct Token
+{
+  enum class Type
+  {
+    End, Identifier, Number, String, Parameter, Operator, LeftParenthesis, RightParenthesis
+  };
+
+  Type type;
+  std::string text;
+};
+
+bool
+is_identifier_character(char c)
+{
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.' || c == '[' ||
+         c == ']';
+}
+
+std::vector<Token>
+tokenize(const std::string & text)
+{
+  auto is_digit = [](char c) {return std::isdigit(static_cast<unsigned char>(c)) != 0;};
+  std::vector<Token> tokens;
+  size_t i = 0;
+  while (i < text.size()) {
+    const char c = text[i];
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      ++i;
+    } else if (c == '(' || c == ')') {
+      tokens.push_back(
+        {c == '(' ? Token::Type::LeftParenthesis : Token::Type::RightParenthesis, {c}});
+      ++i;
+    } else if (c == '\'') {
+      const size_t end = text.find('\'', i + 1);
+      if (end == std::string::npos) {
+        throw std::invalid_argument("a string of the filter expression isn't terminated");
+      }
+      tokens.push_back({Token::Type::String, text.substr(i + 1, end - i - 1)});
+      i = end + 1;
+    } else if (c == '%') {
+      size_t end = i + 1;
+      while (end < text.size() && is_digit(text[end])) {
+        ++end;
+      }
+      if (end == i + 1 || end - i - 1 > 2) {
+        throw std::invalid_argument("a parameter of the filter expression is invalid");
+      }
+      tokens.push_back({Token::Type::Parameter, text.substr(i + 1, end - i - 1)});
+      i = end;
+    } else if (is_digit(c) || ((c == '-' || c == '+' || c == '.') && i + 1 < text.size() &&
+      (is_digit(text[i + 1]) || text[i + 1] == '.')))
+    {
+      size_t end = i + 1;
+      while (end < text.size() &&
+        (std::isalnum(static_cast<unsigned char>(text[end])) || text[end] == '.' ||
+        ((text[end] == '-' || text[end] == '+') &&
+        (text[end - 1] == 'e' || text[end - 1] == 'E'))))
+      {
+        ++end;
+      }
+      tokens.push_back({Token::Type::Number, text.substr(i, end - i)});
+      i = end;
+    } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+      size_t end = i + 1;
+      while (end < text.size() && is_identifier_character(text[end])) {
+        ++end;
+      }
+      tokens.push_back({Token::Type::Identifier, text.substr(i, end - i)});
+      i = end;
+    } else {
+      size_t length = 1;
+      const std::string two = text.substr(i, 2);
+      if (two == "<=" || two == ">=" || two == "<>" || two == "!=") {
+        length = 2;
+      } else if (c != '=' && c != '<' && c != '>') {
+        throw std::invalid_argument(
+                std::string("the filter expression has an unexpected character '") + c + "'");
+      }
+      tokens.push_back({Token::Type::Operator, text.substr(i, length)});
+      i += length;
+    }
+  }
+  tokens.push_back({Token::Type::End, ""});
+  return tokens;
+}
+
+bool
+is_keyword(const Token & token, const char * keyword)
+{
+  if (token.type != Token::Type::Identifier) {
+    return false;
+  }
+  size_t i = 0;
+  for (; keyword[i] != '\0'; ++i) {
+    if (i >= token.text.size() ||
+      std::toupper(static_cast<unsigned char>(token.text[i])) != keyword[i])
+    {
+      return false;
+    }
+  }
+  return i == token.text.size();
+}
+
+bool
+is_any_keyword(const Token & token)
+{
+  for (const char * keyword : {"AND", "OR", "NOT", "BETWEEN", "LIKE"}) {
+    if (is_keyword(token, keyword)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Parse a literal token, returning false if it isn't one.
+bool
+parse_literal(const Token & token, Operand & operand)
+{
+  if (token.type == Token::Type::String) {
+    operand.literal.kind = Value::Kind::String;
+    operand.string = token.text;
+    return true;
+  }
+  if (is_keyword(token, "TRUE") || is_keyword(token, "FALSE")) {
+    operand.literal.kind = Value::Kind::Unsigned;
+    operand.literal.unsigned_value = is_keyword(token, "TRUE") ? 1u : 0u;
+    return true;
+  }
+  if (token.type != Token::Type::Number) {
+    return false;
+  }
+
+  const std::string & text = token.text;
+  const char * begin = text.c_str();
+  char * end = nullptr;
+  errno = 0;
+  const size_t digits = (text[0] == '-' || text[0] == '+') ? 1u : 0u;
+  const bool is_hexadecimal =
+    text.size() > digits + 1 && text[digits] == '0' &&
+    (text[digits + 1] == 'x' || text[digits + 1] == 'X');
+  if (!is_hexadecimal && text.find_first_of(".eE") != std::string::npos) {
+    operand.literal.kind = Value::Kind::Float;
+    operand.literal.float_value = std::strtod(begin, &end);
+  } else if (text[0] == '-') {
+    operand.literal.kind = Value::Kind::Signed;
+    operand.literal.signed_value = std::strtoll(begin, &end, 0);
+  } else {
+    operand.literal.kind = Value::Kind::Unsigned;
+    operand.literal.unsigned_value = std::strtoull(begin, &end, 0);
+  }
+  if (errno != 0 || end != begin + text.size()) {
+    throw std::invalid_argument("the number '" + text + "' of the filter expression is invalid");
+  }
+  return true;
+}
+
+class Parser
+{
+public:
+  using Condition = ContentFilter::Condition;
+
+  Parser(
+    const MessageMembers * members,
+    const std::string & expression,
+    const std::vector<std::string> & parameters)
+  : members_(members), tokens_(tokenize(expression)), parameters_(parameters)
+  {}
+
+  std::unique_ptr<const Condition>
+  parse();
+
+  /// Return the fields of the parsed expression.
+  const std::vector<const Field *> &
+  get_fields() const
+  {
+    return fields_;
+  }
+
+private:
+  const Token &
+  peek() const
+  {
+    return tokens_[position_];
+  }
+
+  const Token &
+  next()
+  {
+    const Token & token = tokens_[position_];
+    if (token.type != Token::Type::End) {
+      ++position_;
+    }
+    return token;
+  }
+
+  bool
+  accept_keyword(const char * keyword)
+  {
+    if (!is_keyword(peek(), keyword)) {
+      return false;
+    }
+    next();
+    return true;
+  }
+
+  [[noreturn]] void
+  throw_unexpected(const Token & token) const
+  {
+    if (token.type == Token::Type::End) {
+      throw std::invalid_argument("the filter expression ends unexpectedly");
+    }
+    throw std::invalid_argument(
+            "the filter expression has an unexpected '" + token.text + "'");
+  }
+
+  std::unique_ptr<const Condition>
+  parse_or();
+
+  std::unique_ptr<const Condition>
+  parse_and();
+
+  std::unique_ptr<const Condition>
+  parse_not();
+
+  std::unique_ptr<const Condition>
+  parse_predicate();
+
+  std::unique_ptr<const Condition>
+  parse_between(Operand value);
+
+  Operand
+  parse_operand();
+
+  const MessageMembers * members_;
+  std::vector<Token> tokens_;
+  size_t position_ = 0;
+  const std::vector<std::string> & parameters_;
+  std::vector<const Field *> fields_;
+};
+
+}  // namespace
+
+struct ContentFilter::Condition
+{
+  enum class Type {And, Or, Not, Compare, Like, Between};
+
+  static std::unique_ptr<const Condition>
+  make_logical(
+    Type type,
+    std::unique_ptr<const Condition> lhs,
+    std::unique_ptr<const Condition> rhs = nullptr)
+  {
+    auto condition = std::make_unique<Condition>();
+    condition->type = type;
+    condition->lhs = std::move(lhs);
+    condition->rhs = std::move(rhs);
+    return condition;
+  }
+
+  /// Evaluate the condition, given a function reading the value of an operand.
+  template<typename ReadOperandT>
+  bool
+  evaluate(const ReadOperandT & read_operand) const
+  {
+    switch (type) {
+      case Type::And:
+        return lhs->evaluate(read_operand) && rhs->evaluate(read_operand);
+      case Type::Or:
+        return lhs->evaluate(read_operand) || rhs->evaluate(read_operand);
+      case Type::Not:
+        return !lhs->evaluate(read_operand);
+      default:
+        break;
+    }
+
+    Value values[3];
+    std::string strings[3];
+    for (size_t i = 0; i < operands.size(); ++i) {
+      if (!read_operand(operands[i], values[i], strings[i])) {
+        return false;
+      }
+    }
+    switch (type) {
+      case Type::Compare:
+        return holds(op, compare(values[0], values[1]));
+      case Type::Like:
+        return matches_pattern(*values[0].string_value, *values[1].string_value);
+      default:
+        return holds(RelationalOperator::GreaterOrEqual, compare(values[0], values[1])) &&
+               holds(RelationalOperator::LessOrEqual, compare(values[0], values[2]));
+    }
+  }
+
+  Type type = Type::Compare;
+  std::unique_ptr<const Condition> lhs;
+  std::unique_ptr<const Condition> rhs;
+  RelationalOperator op = RelationalOperator::Equal;
+  std::vector<Operand> operands;
+};
+
+namespace
+{
+
+void
+check_comparable(const Operand & lhs, const Operand & rhs)
+{
+  if (lhs.is_string() != rhs.is_string()) {
+    throw std::invalid_argument("the filter expression compares a string with a number");
+  }
+}
+
+std::unique_ptr<const Parser::Condition>
+Parser::parse()
+{
+  auto condition = parse_or();
+  if (peek().type != Token::Type::End) {
+    throw_unexpected(peek());
+  }
+  return condition;
+}
+
+std::unique_ptr<const Parser::Condition>
+Parser::parse_or()
+{
+  auto condition = parse_and();
+  while (accept_keyword("OR")) {
+    condition = Condition::make_logical(Condition::Type::Or, std::move(condition), parse_and());
+  }
+  return condition;
+}
+
+std::unique_ptr<const Parser::Condition>
+Parser::parse_and()
+{
+  auto condition = parse_not();
+  while (accept_keyword("AND")) {
+    condition = Condition::make_logical(Condition::Type::And, std::move(condition), parse_not());
+  }
+  return condition;
+}
+
+std::unique_ptr<const Parser::Condition>
+Parser::parse_not()
+{
+  if (accept_keyword("NOT")) {
+    return Condition::make_logical(Condition::Type::Not, parse_not());
+  }
+  if (peek().type == Token::Type::LeftParenthesis) {
+    next();
+    auto condition = parse_or();
+    if (peek().type != Token::Type::RightParenthesis) {
+      throw_unexpected(peek());
+    }
+    next();
+    return condition;
+  }
+  return parse_predicate();
+}
+
+std::unique_ptr<const Parser::Condition>
+Parser::parse_predicate()
+{
+  Operand lhs = parse_operand();
+  if (accept_keyword("NOT")) {
+    if (!accept_keyword("BETWEEN")) {
+      throw_unexpected(peek());
+    }
+    return Condition::make_logical(Condition::Type::Not, parse_between(std::move(lhs)));
+  }
+  if (accept_keyword("BETWEEN")) {
+    return parse_between(std::move(lhs));
+  }
+
+  auto condition = std::make_unique<Condition>();
+  if (accept_keyword("LIKE")) {
+    condition->type = Condition::Type::Like;
+    Operand rhs = parse_operand();
+    if (!lhs.is_string() || !rhs.is_string()) {
+      throw std::invalid_argument("the filter expression matches a number with LIKE");
+    }
+    condition->operands.push_back(std::move(lhs));
+    condition->operands.push_back(std::move(rhs));
+    return condition;
+  }
+
+  const Token & token = next();
+  if (token.type != Token::Type::Operator) {
+    throw_unexpected(token);
+  }
+  if (token.text == "=") {
+    condition->op = RelationalOperator::Equal;
+  } else if (token.text == "<>" || token.text == "!=") {
+    condition->op = RelationalOperator::NotEqual;
+  } else if (token.text == "<") {
+    condition->op = RelationalOperator::Less;
+  } else if (token.text == "<=") {
+    condition->op = RelationalOperator::LessOrEqual;
+  } else if (token.text == ">") {
+    condition->op = RelationalOperator::Greater;
+  } else {
+    condition->op = RelationalOperator::GreaterOrEqual;
+  }
+  Operand rhs = parse_operand();
+  check_comparable(lhs, rhs);
+  condition->operands.push_back(std::move(lhs));
+  condition->operands.push_back(std::move(rhs));
+  return condition;
+}
+
+std::unique_ptr<const Parser::Condition>
+Parser::parse_between(Operand value)
+{
+  auto condition = std::make_unique<Condition>();
+  condition->type = Condition::Type::Between;
+  Operand low = parse_operand();
+  if (!accept_keyword("AND")) {
+    throw_unexpected(peek());
+  }
+  Operand high = parse_operand();
+  check_comparable(value, low);
+  check_comparable(value, high);
+  condition->operands.push_back(std::move(value));
+  condition->operands.push_back(std::move(low));
+  condition->operands.push_back(std::move(high));
+  return condition;
+}
+
+Operand
+Parser::parse_operand()
+{
+  const Token & token = next();
+  Operand operand;
+  if (token.type == Token::Type::Parameter) {
+    const size_t index = std::stoul(token.text);
+    if (index >= parameters_.size()) {
+      throw std::invalid_argument(
+              "the filter expression has no value for the parameter %" + token.text);
+    }
+    auto parameter_tokens = tokenize(parameters_[index]);
+    if (parameter_tokens.size() != 2u || !parse_literal(parameter_tokens[0], operand)) {
+      throw std::invalid_argument(
+              "the value '" + parameters_[index] + "' of the parameter %" + token.text +
+              " isn't a literal");
+    }
+    return operand;
+  }
+  if (parse_literal(token, operand)) {
+    return operand;
+  }
+  if (token.type != Token::Type::Identifier || is_any_keyword(token)) {
+    throw_unexpected(token);
+  }
+  operand.field = std::make_unique<Field>(members_, token.text);
+  fields_.push_back(operand.field.get());
+  return operand;
+}
+
+}  // namespace
+
+ContentFilter::ContentFilter(
+  const rosidl_message_type_support_t & type_support,
+  const std::string & filter_expression,
+  const std::vector<std::string> & expression_parameters)
+{
+  const rosidl_message_type_support_t * introspection_type_support =
+    get_message_typesupport_handle(
+    &type_support, rosidl_typesupport_introspection_cpp::typesupport_identifier);
+  if (!introspection_type_support) {
+    rcutils_reset_error();
+    throw std::invalid_argument(
+            "the introspection type support of the messages of the filter isn't available");
+  }
+  const auto * members =
+    static_cast<const MessageMembers *>(introspection_type_support->data);
+  Parser parser(members, filter_expression, expression_parameters);
+  condition_ = parser.parse();
+
+  can_evaluate_serialized_ = true;
+  for (const Field * field : parser.get_fields()) {
+    can_evaluate_serialized_ &= field->has_serialized_offset();
+    min_serialized_size_ = std::max(min_serialized_size_, field->get_serialized_end());
+  }
+}
+
+ContentFilter::~ContentFilter() = default;
+
+bool
+ContentFilter::evaluate(const void * ros_message) const
+{
+  return condition_->evaluate(
+    [ros_message](const Operand & operand, Value & value, std::string &) {
+      return operand.read(ros_message, value);
+    });
+}
+
+bool
+ContentFilter::can_evaluate_serialized() const
+{
+  return can_evaluate_serialized_;
+}
+
+bool
+ContentFilter::evaluate_serialized(
+  const rcl_serialized_message_t & serialized_message,
+  bool & matches) const
+{
+  plain_cdr::Payload payload;
+  if (!can_evaluate_serialized_ ||
+    !plain_cdr::get_payload(serialized_message, min_serialized_size_, payload))
+  {
+    return false;
+  }
+  matches = condition_->evaluate(
+    [&payload](const Operand & operand, Value & value, std::string & storage) {
+      return operand.read_serialized(payload, value, storage);
+    });
+  return true;
+}
@@ -0,0 +1,198 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp/detail/deserialized_message_queue.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "rmw/impl/cpp/demangle.hpp"
+
+#include "rclcpp/detail/add_guard_condition_to_rcl_wait_set.hpp"
+#include "rclcpp/logging.hpp"
+
+using rclcpp::detail::DeserializedMessageQueue;
+
+DeserializedMessageQueue::DeserializedMessageQueue(
+  rclcpp::Context::SharedPtr context,
+  Handler handler)
+: handler_(std::move(handler)), gc_(context)
+{}
+
+std::shared_ptr<DeserializedMessageQueue::Entry>
+DeserializedMessageQueue::create_entry()
+{
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    if (!recycled_entries_.empty()) {
+      auto entry = std::move(recycled_entries_.back());
+      recycled_entries_.pop_back();
+      return entry;
+    }
+  }
+  return std::make_shared<Entry>();
+}
+
+void
+DeserializedMessageQueue::recycle_entry(std::shared_ptr<Entry> entry)
+{
+  // Only the buffer of the serialized message is kept.
+  entry->message.reset();
+  entry->message_info = rclcpp::MessageInfo();
+  entry->content_filter_evaluated = true;
+  entry->deserialized = false;
+  entry->ready = false;
+  std::lock_guard<std::mutex> lock(queue_mutex_);
+  if (recycled_entries_.size() < kMaxRecycledEntries) {
+    recycled_entries_.push_back(std::move(entry));
+  }
+}
+
+void
+DeserializedMessageQueue::push(std::shared_ptr<Entry> entry)
+{
+  std::lock_guard<std::mutex> lock(queue_mutex_);
+  queue_.push_back(std::move(entry));
+}
+
+void
+DeserializedMessageQueue::set_ready(const std::shared_ptr<Entry> & entry)
+{
+  size_t number_of_events = 0;
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    entry->ready = true;
+    // The entries are handled in order, so only the ready ones at the front are signaled.
+    size_t ready_count = signaled_count_;
+    while (ready_count < queue_.size() && queue_[ready_count]->ready) {
+      ++ready_count;
+    }
+    number_of_events = ready_count - signaled_count_;
+    signaled_count_ = ready_count;
+  }
+  if (number_of_events == 0) {
+    return;
+  }
+  gc_.trigger();
+
+  std::lock_guard<std::recursive_mutex> lock(callback_mutex_);
+  if (on_ready_callback_) {
+    on_ready_callback_(number_of_events);
+  } else {
+    unread_count_ += number_of_events;
+  }
+}
+
+bool
+DeserializedMessageQueue::empty() const
+{
+  std::lock_guard<std::mutex> lock(queue_mutex_);
+  return queue_.empty();
+}
+
+void
+DeserializedMessageQueue::add_to_wait_set(rcl_wait_set_t * wait_set)
+{
+  rclcpp::detail::add_guard_condition_to_rcl_wait_set(*wait_set, gc_);
+}
+
+bool
+DeserializedMessageQueue::is_ready(rcl_wait_set_t * wait_set)
+{
+  (void)wait_set;
+  std::lock_guard<std::mutex> lock(queue_mutex_);
+  return signaled_count_ > 0;
+}
+
+std::shared_ptr<void>
+DeserializedMessageQueue::take_data()
+{
+  std::lock_guard<std::mutex> lock(queue_mutex_);
+  if (signaled_count_ == 0) {
+    return nullptr;
+  }
+  auto entry = std::move(queue_.front());
+  queue_.pop_front();
+  if (--signaled_count_ > 0) {
+    // The guard condition is only triggered once for all the entries ready before a wait.
+    gc_.trigger();
+  }
+  return entry;
+}
+
+std::shared_ptr<void>
+DeserializedMessageQueue::take_data_by_entity_id(size_t id)
+{
+  (void)id;
+  return take_data();
+}
+
+void
+DeserializedMessageQueue::execute(std::shared_ptr<void> & data)
+{
+  if (!data) {
+    return;
+  }
+  auto entry = std::static_pointer_cast<Entry>(data);
+  data.reset();
+  handler_(*entry);
+  recycle_entry(std::move(entry));
+}
+
+void
+DeserializedMessageQueue::set_on_ready_callback(std::function<void(size_t, int)> callback)
+{
+  if (!callback) {
+    throw std::invalid_argument(
+            "The callback passed to set_on_ready_callback "
+            "is not callable.");
+  }
+
+  auto new_callback =
+    [callback, this](size_t number_of_events) {
+      try {
+        callback(number_of_events, static_cast<int>(EntityType::Queue));
+      } catch (const std::exception & exception) {
+        RCLCPP_ERROR_STREAM(
+          rclcpp::get_logger("rclcpp"),
+          "rclcpp::detail::DeserializedMessageQueue@" << this <<
+            " caught " << rmw::impl::cpp::demangle(exception) <<
+            " exception in user-provided callback for the 'on ready' callback: " <<
+            exception.what());
+      } catch (...) {
+        RCLCPP_ERROR_STREAM(
+          rclcpp::get_logger("rclcpp"),
+          "rclcpp::detail::DeserializedMessageQueue@" << this <<
+            " caught unhandled exception in user-provided callback " <<
+            "for the 'on ready' callback");
+      }
+    };
+
+  std::lock_guard<std::recursive_mutex> lock(callback_mutex_);
+  on_ready_callback_ = new_callback;
+
+  if (unread_count_ > 0) {
+    on_ready_callback_(unread_count_);
+    unread_count_ = 0;
+  }
+}
+
+void
+DeserializedMessageQueue::clear_on_ready_callback()
+{
+  std::lock_guard<std::recursive_mutex> lock(callback_mutex_);
+  on_ready_callback_ = nullptr;
+}
@@ -0,0 +1,86 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp/detail/future_waiters.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+struct FutureWaiters
+{
+  std::atomic<size_t> size{0};
+  std::mutex mutex;
+  std::vector<std::pair<std::thread::id, rclcpp::GuardCondition *>> guard_conditions;
+};
+
+FutureWaiters &
+get_future_waiters()
+{
+  // Never destroyed, so that the clients can notify it until the end of the process.
+  static FutureWaiters * future_waiters = new FutureWaiters;
+  return *future_waiters;
+}
+
+}  // namespace
+
+void
+rclcpp::detail::notify_future_waiters()
+{
+  FutureWaiters & future_waiters = get_future_waiters();
+  if (future_waiters.size.load() == 0) {
+    return;
+  }
+  const auto this_thread_id = std::this_thread::get_id();
+  // The lock keeps the guard conditions from being unregistered while they're triggered.
+  std::lock_guard<std::mutex> lock(future_waiters.mutex);
+  for (const auto & thread_id_and_guard_condition : future_waiters.guard_conditions) {
+    // The executor of this thread checks its future once the current callback returns.
+    if (thread_id_and_guard_condition.first != this_thread_id) {
+      thread_id_and_guard_condition.second->trigger();
+    }
+  }
+}
+
+rclcpp::detail::FutureWaiter::FutureWaiter(rclcpp::GuardCondition & guard_condition)
+: guard_condition_(guard_condition)
+{
+  FutureWaiters & future_waiters = get_future_waiters();
+  std::lock_guard<std::mutex> lock(future_waiters.mutex);
+  future_waiters.guard_conditions.emplace_back(std::this_thread::get_id(), &guard_condition_);
+  future_waiters.size.store(future_waiters.guard_conditions.size());
+}
+
+rclcpp::detail::FutureWaiter::~FutureWaiter()
+{
+  FutureWaiters & future_waiters = get_future_waiters();
+  std::lock_guard<std::mutex> lock(future_waiters.mutex);
+  auto & guard_conditions = future_waiters.guard_conditions;
+  auto it = std::find_if(
+    guard_conditions.begin(), guard_conditions.end(),
+    [this](const std::pair<std::thread::id, rclcpp::GuardCondition *> & thread_id_and_gc) {
+      return thread_id_and_gc.second == &guard_condition_;
+    });
+  if (it != guard_conditions.end()) {
+    guard_conditions.erase(it);
+  }
+  future_waiters.size.store(guard_conditions.size());
+}
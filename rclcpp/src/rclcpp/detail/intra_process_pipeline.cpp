@@ -0,0 +1,70 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp/detail/intra_process_pipeline.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "rclcpp/experimental/subscription_intra_process_base.hpp"
+
+using rclcpp::detail::IntraProcessPipeline;
+
+namespace
+{
+
+thread_local IntraProcessPipeline * current_pipeline = nullptr;
+
+}  // namespace
+
+IntraProcessPipeline::IntraProcessPipeline()
+{
+  if (current_pipeline) {
+    throw std::logic_error("the thread already has an intra-process pipeline");
+  }
+  current_pipeline = this;
+}
+
+IntraProcessPipeline::~IntraProcessPipeline()
+{
+  current_pipeline = nullptr;
+}
+
+bool
+IntraProcessPipeline::is_active()
+{
+  return current_pipeline != nullptr;
+}
+
+void
+IntraProcessPipeline::enqueue(
+  std::shared_ptr<rclcpp::experimental::SubscriptionIntraProcessBase> subscription)
+{
+  if (current_pipeline && subscription) {
+    current_pipeline->subscriptions_.push_back(std::move(subscription));
+  }
+}
+
+std::shared_ptr<rclcpp::experimental::SubscriptionIntraProcessBase>
+IntraProcessPipeline::pop()
+{
+  if (subscriptions_.empty()) {
+    return nullptr;
+  }
+  auto subscription = std::move(subscriptions_.front());
+  subscriptions_.pop_front();
+  return subscription;
+}
@@ -0,0 +1,132 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__DETAIL__PLAIN_CDR_HPP_
+#define RCLCPP__DETAIL__PLAIN_CDR_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "rcl/types.h"
+#include "rosidl_typesupport_introspection_cpp/field_types.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+/// \internal Helpers reading the messages serialized with plain CDR, without deserializing them.
+namespace plain_cdr
+{
+
+/// Payload of a message serialized with plain CDR, after its encapsulation header.
+struct Payload
+{
+  const uint8_t * data;
+  size_t size;
+  // True if the byte order of the message isn't the one of the host.
+  bool swap;
+};
+
+/// Get the payload of a message, or return false if it isn't plain CDR or is too short.
+/**
+ * \param[in] message serialized message.
+ * \param[in] min_size minimal size of the payload.
+ * \param[out] payload payload of the message.
+ */
+inline
+bool
+get_payload(const rcl_serialized_message_t & message, size_t min_size, Payload & payload)
+{
+  // The encapsulation header of plain CDR is 0x0000 in big endian and 0x0001 in little endian.
+  constexpr size_t header_size = 4u;
+  if (message.buffer_length < header_size + min_size ||
+    message.buffer[0] != 0u || message.buffer[1] > 1u)
+  {
+    return false;
+  }
+  const uint16_t one = 1u;
+  uint8_t host_is_little_endian = 0u;
+  std::memcpy(&host_is_little_endian, &one, 1u);
+  payload = {
+    message.buffer + header_size,
+    message.buffer_length - header_size,
+    message.buffer[1] != host_is_little_endian};
+  return true;
+}
+
+/// Return the size of a primitive type, or 0 if it has no fixed size.
+inline
+size_t
+get_size(uint8_t type_id)
+{
+  namespace introspection = rosidl_typesupport_introspection_cpp;
+  switch (type_id) {
+    case introspection::ROS_TYPE_BOOLEAN:
+    case introspection::ROS_TYPE_CHAR:
+    case introspection::ROS_TYPE_OCTET:
+    case introspection::ROS_TYPE_UINT8:
+    case introspection::ROS_TYPE_INT8:
+      return 1u;
+    case introspection::ROS_TYPE_UINT16:
+    case introspection::ROS_TYPE_INT16:
+      return 2u;
+    case introspection::ROS_TYPE_FLOAT:
+    case introspection::ROS_TYPE_UINT32:
+    case introspection::ROS_TYPE_INT32:
+      return 4u;
+    case introspection::ROS_TYPE_DOUBLE:
+    case introspection::ROS_TYPE_UINT64:
+    case introspection::ROS_TYPE_INT64:
+      return 8u;
+    default:
+      // The wide characters and the long doubles aren't serialized the same by all the
+      // middlewares, and the strings and messages have no primitive size.
+      return 0u;
+  }
+}
+
+/// Align an offset of the payload on the size of a primitive, which is a power of 2.
+inline
+size_t
+align(size_t offset, size_t alignment)
+{
+  return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+/// Copy contiguous primitives from the payload, in the byte order of the host.
+/**
+ * The caller checks that the payload has `size * count` bytes at `offset`.
+ */
+inline
+void
+copy_primitives(
+  const Payload & payload, size_t offset, size_t size, size_t count, void * destination)
+{
+  auto * bytes = static_cast<uint8_t *>(destination);
+  std::memcpy(bytes, payload.data + offset, size * count);
+  if (payload.swap) {
+    for (size_t i = 0; i < count; ++i) {
+      std::reverse(bytes + i * size, bytes + (i + 1u) * size);
+    }
+  }
+}
+
+}  // namespace plain_cdr
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__PLAIN_CDR_HPP_
@@ -14,53 +14,122 @@
 
 #include "resolve_parameter_overrides.hpp"
 
-#include <string>
+#include <algorithm>
 #include <map>
+#include <memory>
+#include <regex>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "rcl_yaml_param_parser/parser.h"
+#include "rcpputils/find_and_replace.hpp"
 #include "rcpputils/scope_exit.hpp"
 
+#include "rclcpp/exceptions.hpp"
 #include "rclcpp/parameter_map.hpp"
 
+using rclcpp::exceptions::InvalidParametersException;
+
+rclcpp::detail::ParameterOverridesIndex::ParameterOverridesIndex(const rcl_arguments_t * args)
+{
+  if (!args) {
+    return;
+  }
+  rcl_params_t * params = NULL;
+  rcl_ret_t ret = rcl_arguments_get_param_overrides(args, &params);
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(ret);
+  }
+  if (!params) {
+    return;
+  }
+  auto cleanup_params = rcpputils::make_scope_exit(
+    [params]() {
+      rcl_yaml_node_struct_fini(params);
+    });
+  if (NULL == params->node_names) {
+    throw InvalidParametersException("node names array is NULL");
+  } else if (NULL == params->params) {
+    throw InvalidParametersException("node params array is NULL");
+  }
+
+  node_parameters_.resize(params->num_nodes);
+  for (size_t n = 0; n < params->num_nodes; ++n) {
+    const char * c_node_name = params->node_names[n];
+    if (NULL == c_node_name) {
+      throw InvalidParametersException("Node name at index " + std::to_string(n) + " is NULL");
+    }
+    // make sure there is a leading slash on the fully qualified node name
+    std::string node_name("/");
+    if ('/' != c_node_name[0]) {
+      node_name += c_node_name;
+    } else {
+      node_name = c_node_name;
+    }
+    // Same matching as rclcpp::parameter_map_from(), without compiling a regex per node.
+    if (std::string::npos == node_name.find_first_of("*.?+[](){}|\\^$")) {
+      exact_names_[node_name].push_back(n);
+    } else {
+      std::string regex = rcpputils::find_and_replace(node_name, "/*", "(/\\w+)");
+      wildcard_names_.emplace_back(std::regex(regex), n);
+    }
+
+    const rcl_node_params_t * const c_params_node = &(params->params[n]);
+    auto & parameters = node_parameters_[n];
+    parameters.reserve(c_params_node->num_params);
+    for (size_t p = 0; p < c_params_node->num_params; ++p) {
+      const char * const c_param_name = c_params_node->parameter_names[p];
+      if (NULL == c_param_name) {
+        throw InvalidParametersException(
+                "At node " + std::to_string(n) + " parameter " + std::to_string(p) +
+                " name is NULL");
+      }
+      parameters.emplace_back(
+        c_param_name, rclcpp::parameter_value_from(&(c_params_node->parameter_values[p])));
+    }
+  }
+}
+
+void
+rclcpp::detail::ParameterOverridesIndex::get_overrides(
+  const std::string & node_fqn,
+  std::map<std::string, rclcpp::ParameterValue> & overrides) const
+{
+  std::vector<size_t> positions;
+  auto it = exact_names_.find(node_fqn);
+  if (it != exact_names_.end()) {
+    positions = it->second;
+  }
+  for (const auto & wildcard_name : wildcard_names_) {
+    if (std::regex_match(node_fqn, wildcard_name.first)) {
+      positions.push_back(wildcard_name.second);
+    }
+  }
+  std::sort(positions.begin(), positions.end());
+
+  for (size_t position : positions) {
+    for (const auto & parameter : node_parameters_[position]) {
+      overrides[parameter.first] = parameter.second;
+    }
+  }
+}
+
 std::map<std::string, rclcpp::ParameterValue>
 rclcpp::detail::resolve_parameter_overrides(
   const std::string & node_fqn,
   const std::vector<rclcpp::Parameter> & parameter_overrides,
   const rcl_arguments_t * local_args,
-  const rcl_arguments_t * global_args)
+  const ParameterOverridesIndex * global_overrides)
 {
   std::map<std::string, rclcpp::ParameterValue> result;
 
   // global before local so that local overwrites global
-  std::array<const rcl_arguments_t *, 2> argument_sources = {global_args, local_args};
-
-  // Get fully qualified node name post-remapping to use to find node's params in yaml files
-
-  for (const rcl_arguments_t * source : argument_sources) {
-    if (!source) {
-      continue;
-    }
-    rcl_params_t * params = NULL;
-    rcl_ret_t ret = rcl_arguments_get_param_overrides(source, &params);
-    if (RCL_RET_OK != ret) {
-      rclcpp::exceptions::throw_from_rcl_error(ret);
-    }
-    if (params) {
-      auto cleanup_params = rcpputils::make_scope_exit(
-        [params]() {
-          rcl_yaml_node_struct_fini(params);
-        });
-      rclcpp::ParameterMap initial_map = rclcpp::parameter_map_from(params, node_fqn.c_str());
-
-      if (initial_map.count(node_fqn) > 0) {
-        // Combine parameter yaml files, overwriting values in older ones
-        for (const rclcpp::Parameter & param : initial_map.at(node_fqn)) {
-          result[param.get_name()] =
-            rclcpp::ParameterValue(param.get_value_message());
-        }
-      }
-    }
+  if (global_overrides) {
+    global_overrides->get_overrides(node_fqn, result);
+  }
+  if (local_args) {
+    ParameterOverridesIndex(local_args).get_overrides(node_fqn, result);
   }
 
   // parameter overrides passed to constructor will overwrite overrides from yaml file sources
@@ -70,3 +139,27 @@ rclcpp::detail::resolve_parameter_overrides(
   }
   return result;
 }
+
+namespace
+{
+
+/// Overrides of the global arguments of a context, kept as a sub context.
+class GlobalParameterOverrides
+{
+public:
+  explicit GlobalParameterOverrides(rclcpp::Context & context)
+  : overrides(
+      std::make_shared<const rclcpp::detail::ParameterOverridesIndex>(
+        &context.get_rcl_context()->global_arguments))
+  {}
+
+  const std::shared_ptr<const rclcpp::detail::ParameterOverridesIndex> overrides;
+};
+
+}  // namespace
+
+std::shared_ptr<const rclcpp::detail::ParameterOverridesIndex>
+rclcpp::detail::get_global_parameter_overrides(rclcpp::Context & context)
+{
+  return context.get_sub_context<GlobalParameterOverrides>(context)->overrides;
+}
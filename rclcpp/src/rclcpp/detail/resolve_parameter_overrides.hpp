@@ -15,12 +15,17 @@
 #ifndef RCLCPP__DETAIL__RESOLVE_PARAMETER_OVERRIDES_HPP_
 #define RCLCPP__DETAIL__RESOLVE_PARAMETER_OVERRIDES_HPP_
 
-#include <string>
 #include <map>
+#include <memory>
+#include <regex>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "rcl/arguments.h"
 
+#include "rclcpp/context.hpp"
 #include "rclcpp/parameter.hpp"
 #include "rclcpp/parameter_value.hpp"
 #include "rclcpp/visibility_control.hpp"
@@ -29,14 +34,56 @@ namespace rclcpp
 {
 namespace detail
 {
+/// \internal Parameter overrides of arguments, parsed once and indexed by node name.
+/**
+ * The overrides of a node are found with a lookup of its name, and by
+ * matching the node names with wildcards, instead of converting all the
+ * parameters of the arguments for each node.
+ */
+class ParameterOverridesIndex
+{
+public:
+  /// Parse the parameter overrides of the arguments, which can be nullptr.
+  RCLCPP_LOCAL
+  explicit ParameterOverridesIndex(const rcl_arguments_t * args);
+
+  /// Set the overrides of a node, overwriting the ones already set.
+  /**
+   * The overrides are set in the order of the arguments, so the later ones
+   * win over the former ones, as in the parameter files.
+   */
+  RCLCPP_LOCAL
+  void
+  get_overrides(
+    const std::string & node_fqn,
+    std::map<std::string, rclcpp::ParameterValue> & overrides) const;
+
+private:
+  /// Parameters of each node name of the arguments, in the order of the arguments.
+  std::vector<std::vector<std::pair<std::string, rclcpp::ParameterValue>>> node_parameters_;
+  /// Positions in node_parameters_ of the node names without wildcards.
+  std::unordered_map<std::string, std::vector<size_t>> exact_names_;
+  /// Node names with wildcards, with their position in node_parameters_.
+  std::vector<std::pair<std::regex, size_t>> wildcard_names_;
+};
+
 /// \internal Get the parameter overrides from the arguments.
+/**
+ * \param[in] global_overrides The overrides of the global arguments, which can
+ *   be nullptr if they aren't used, see get_global_parameter_overrides().
+ */
 RCLCPP_LOCAL
 std::map<std::string, rclcpp::ParameterValue>
 resolve_parameter_overrides(
   const std::string & node_name,
   const std::vector<rclcpp::Parameter> & parameter_overrides,
   const rcl_arguments_t * local_args,
-  const rcl_arguments_t * global_args);
+  const ParameterOverridesIndex * global_overrides);
+
+/// \internal Get the overrides of the global arguments of a context, parsed once per context.
+RCLCPP_LOCAL
+std::shared_ptr<const ParameterOverridesIndex>
+get_global_parameter_overrides(rclcpp::Context & context);
 
 }  // namespace detail
 }  // namespace rclcpp
@@ -0,0 +1,89 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp/detail/serialized_message_fan_out.hpp"
+
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace rclcpp
+{
+namespace detail
+{
+
+SerializedMessageFanOut::SerializedMessageFanOut(size_t max_messages_per_topic)
+: max_messages_per_topic_(max_messages_per_topic)
+{
+  if (max_messages_per_topic == 0) {
+    throw std::invalid_argument("the serialized message fan out must remember messages");
+  }
+}
+
+std::shared_ptr<const rclcpp::SerializedMessage>
+SerializedMessageFanOut::share(
+  const std::string & topic_name,
+  const rmw_message_info_t & message_info,
+  std::shared_ptr<const rclcpp::SerializedMessage> message)
+{
+  const auto sequence_number = message_info.publication_sequence_number;
+  if (RMW_MESSAGE_INFO_SEQUENCE_NUMBER_UNSUPPORTED == sequence_number) {
+    return message;
+  }
+  const auto & publisher_gid = message_info.publisher_gid;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto & shared_messages = topics_[topic_name];
+  // Most recent first, as the subscriptions take the same messages at about the same time
+  for (auto it = shared_messages.rbegin(); it != shared_messages.rend(); ++it) {
+    if (it->sequence_number == sequence_number &&
+      std::memcmp(it->publisher_gid.data, publisher_gid.data, RMW_GID_STORAGE_SIZE) == 0)
+    {
+      auto shared_message = it->message.lock();
+      if (shared_message) {
+        return shared_message;
+      }
+      // Nobody holds it anymore, so this copy is shared instead.
+      it->message = message;
+      return message;
+    }
+  }
+
+  while (!shared_messages.empty() &&
+    (shared_messages.size() >= max_messages_per_topic_ ||
+    shared_messages.front().message.expired()))
+  {
+    shared_messages.pop_front();
+  }
+  shared_messages.push_back({publisher_gid, sequence_number, message});
+  return message;
+}
+
+size_t
+SerializedMessageFanOut::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t size = 0;
+  for (const auto & topic_and_messages : topics_) {
+    size += topic_and_messages.second.size();
+  }
+  return size;
+}
+
+}  // namespace detail
+}  // namespace rclcpp
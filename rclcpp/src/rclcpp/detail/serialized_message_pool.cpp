@@ -0,0 +1,81 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/detail/serialized_message_pool.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+using rclcpp::detail::SerializedMessagePool;
+
+SerializedMessagePool::SerializedMessagePool(
+  size_t max_size,
+  const rcl_allocator_t & allocator)
+: pool_(max_size), allocator_(allocator)
+{
+  if (max_size == 0) {
+    throw std::invalid_argument("the pool of serialized messages can't be empty");
+  }
+}
+
+SerializedMessagePool::~SerializedMessagePool() {}
+
+std::shared_ptr<rclcpp::SerializedMessage>
+SerializedMessagePool::borrow_message(size_t capacity)
+{
+  const size_t initial_capacity = std::max(capacity, high_water_mark_.load());
+  auto create = [this, initial_capacity]() {
+      return std::make_shared<rclcpp::SerializedMessage>(initial_capacity, allocator_);
+    };
+  auto message = pool_.borrow(
+    create,
+    [capacity](rclcpp::SerializedMessage & reused_message) {
+      reused_message.get_rcl_serialized_message().buffer_length = 0;
+      if (reused_message.capacity() < capacity) {
+        reused_message.reserve(capacity);
+      }
+    });
+  if (!message) {
+    message = create();
+  }
+  return message;
+}
+
+void
+SerializedMessagePool::return_message(std::shared_ptr<rclcpp::SerializedMessage> & message)
+{
+  if (!message) {
+    return;
+  }
+  const size_t size = message->size();
+  size_t high_water_mark = high_water_mark_.load(std::memory_order_relaxed);
+  while (size > high_water_mark &&
+    !high_water_mark_.compare_exchange_weak(high_water_mark, size, std::memory_order_relaxed))
+  {
+  }
+  message.reset();
+}
+
+size_t
+SerializedMessagePool::get_high_water_mark() const
+{
+  return high_water_mark_.load();
+}
+
+size_t
+SerializedMessagePool::get_number_of_pooled_messages() const
+{
+  return pool_.size();
+}
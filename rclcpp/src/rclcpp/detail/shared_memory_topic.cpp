@@ -0,0 +1,565 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp/detail/shared_memory_topic.hpp"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+using rclcpp::detail::SharedMemoryTopic;
+using rclcpp::detail::SharedMemoryTopicReader;
+
+namespace
+{
+
+constexpr size_t cache_line_size = 64;
+
+/// Header at the start of the segment, written once by the process creating it.
+struct SegmentHeader
+{
+  static constexpr uint32_t expected_magic = 0x52434c54;  // "RCLT"
+  static constexpr uint32_t current_version = 1;
+
+  std::atomic<uint32_t> magic;
+  uint32_t version;
+  uint64_t type_hash;
+  uint64_t max_subscriptions;
+  uint64_t depth;
+  uint64_t max_message_size;
+};
+
+static_assert(
+  std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+  "the slots must be lock-free to be shared between processes");
+
+size_t
+align_to_cache_line(size_t size)
+{
+  return (size + cache_line_size - 1u) / cache_line_size * cache_line_size;
+}
+
+/// FNV-1a hash, which is the same in all the processes, unlike std::hash.
+uint64_t
+hash(const std::string & value)
+{
+  uint64_t result = 14695981039346656037ull;
+  for (unsigned char c : value) {
+    result = (result ^ c) * 1099511628211ull;
+  }
+  return result;
+}
+
+// The state of a slot holds the pid of its subscription, 0 if it's free, and a generation
+// incremented by each subscription using it, which names its notification socket.
+constexpr uint64_t pid_mask = 0xffffffffu;
+
+uint32_t
+get_generation(uint64_t state)
+{
+  return static_cast<uint32_t>(state >> 32);
+}
+
+uint32_t
+get_pid(uint64_t state)
+{
+  return static_cast<uint32_t>(state & pid_mask);
+}
+
+#ifdef __linux__
+/// Return the abstract socket address of the subscription of a slot.
+socklen_t
+get_notification_address(
+  const std::string & segment_name, size_t index, uint32_t generation, sockaddr_un & address)
+{
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  // The first byte stays 0 for an abstract address, which doesn't need to be removed
+  const int length = std::snprintf(
+    address.sun_path + 1, sizeof(address.sun_path) - 1u, "%s_%zu_%u",
+    segment_name.c_str() + 1, index, generation);
+  return static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1u + static_cast<size_t>(length));
+}
+
+bool
+is_process_alive(uint32_t pid)
+{
+  return kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH;
+}
+
+std::runtime_error
+make_error(const std::string & message, const std::string & segment_name, int error)
+{
+  return std::runtime_error(
+    message + " '" + segment_name + "': " + std::strerror(error));
+}
+#endif
+
+}  // namespace
+
+constexpr uint32_t SegmentHeader::expected_magic;
+constexpr uint32_t SegmentHeader::current_version;
+
+struct alignas(cache_line_size) SharedMemoryTopic::SlotHeader
+{
+  std::atomic<uint64_t> state;
+  /// Ticket of the next message written, the cell is the ticket modulo the depth.
+  std::atomic<uint64_t> head;
+  /// Set once a notification was sent, until the subscription clears its notifications.
+  std::atomic<uint32_t> notified;
+};
+
+struct alignas(cache_line_size) SharedMemoryTopic::CellHeader
+{
+  /// 2 * ticket + 1 while the message of a ticket is written, 2 * ticket + 2 once written.
+  std::atomic<uint64_t> sequence;
+  std::atomic<uint64_t> size;
+};
+
+SharedMemoryTopic::SharedMemoryTopic(
+  const std::string & segment_name,
+  const std::string & type_name,
+  size_t max_subscriptions,
+  size_t depth,
+  size_t max_message_size)
+: segment_name_(segment_name), max_subscriptions_(max_subscriptions), depth_(depth),
+  max_message_size_(max_message_size)
+{
+  if (0u == max_subscriptions || 0u == depth || 0u == max_message_size) {
+    throw std::invalid_argument(
+            "the maximum number of subscriptions, the depth and the maximum message size of a "
+            "shared memory topic can't be 0");
+  }
+  cell_size_ = sizeof(CellHeader) + align_to_cache_line(max_message_size);
+  if (depth > (std::numeric_limits<size_t>::max() - sizeof(SlotHeader)) / cell_size_) {
+    throw std::invalid_argument("the depth of the shared memory topic is too big");
+  }
+  slot_size_ = sizeof(SlotHeader) + depth * cell_size_;
+  const size_t header_size = align_to_cache_line(sizeof(SegmentHeader));
+  if (max_subscriptions > (std::numeric_limits<size_t>::max() - header_size) / slot_size_) {
+    throw std::invalid_argument("the shared memory topic has too many subscriptions");
+  }
+  mapping_size_ = header_size + max_subscriptions * slot_size_;
+#ifndef __linux__
+  (void)type_name;
+  throw std::runtime_error("shared memory topics are only supported on Linux");
+#else
+  const uint64_t type_hash = hash(type_name);
+  // The segment is locked exclusively by its only user to be initialized, and then shared
+  // as long as it's used, so that the last user knows when it can remove it.
+  while (true) {
+    const int fd = shm_open(segment_name_.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+      throw make_error("couldn't open the shared memory segment", segment_name_, errno);
+    }
+    auto is_current_segment = [this, fd]() {
+        // The last user may have removed the segment before it was locked
+        const int name_fd = shm_open(segment_name_.c_str(), O_RDWR | O_CLOEXEC, 0);
+        if (name_fd < 0) {
+          return false;
+        }
+        struct stat fd_stat;
+        struct stat name_stat;
+        const bool same = fstat(fd, &fd_stat) == 0 && fstat(name_fd, &name_stat) == 0 &&
+          fd_stat.st_dev == name_stat.st_dev && fd_stat.st_ino == name_stat.st_ino;
+        close(name_fd);
+        return same;
+      };
+    auto fail = [this, fd](const char * message, int error) {
+        if (mapping_) {
+          munmap(mapping_, mapping_size_);
+          mapping_ = nullptr;
+        }
+        close(fd);
+        return make_error(message, segment_name_, error);
+      };
+    const bool exclusive = flock(fd, LOCK_EX | LOCK_NB) == 0;
+    if (!exclusive && EWOULDBLOCK != errno) {
+      throw fail("couldn't lock the shared memory segment", errno);
+    }
+    // The other users only wait while the segment is initialized
+    if (!exclusive && flock(fd, LOCK_SH) != 0) {
+      throw fail("couldn't lock the shared memory segment", errno);
+    }
+    if (!is_current_segment()) {
+      close(fd);
+      continue;
+    }
+
+    struct stat fd_stat;
+    if (fstat(fd, &fd_stat) != 0) {
+      throw fail("couldn't get the size of the shared memory segment", errno);
+    }
+    if (0 == fd_stat.st_size && !exclusive) {
+      // The creator of the segment died before sizing it, or hasn't locked it yet
+      close(fd);
+      std::this_thread::yield();
+      continue;
+    }
+    if (0 == fd_stat.st_size && ftruncate(fd, static_cast<off_t>(mapping_size_)) != 0) {
+      throw fail("couldn't size the shared memory segment", errno);
+    }
+    if (0 != fd_stat.st_size && static_cast<size_t>(fd_stat.st_size) != mapping_size_) {
+      close(fd);
+      throw std::runtime_error(
+              "the shared memory segment '" + segment_name_ +
+              "' is used with another depth, message size or number of subscriptions");
+    }
+    void * mapping = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == mapping) {
+      throw fail("couldn't map the shared memory segment", errno);
+    }
+    mapping_ = static_cast<unsigned char *>(mapping);
+
+    auto header = reinterpret_cast<SegmentHeader *>(mapping_);
+    const bool initialized =
+      header->magic.load(std::memory_order_acquire) == SegmentHeader::expected_magic;
+    if (!initialized && !exclusive) {
+      // A process died while initializing the segment, leaving its magic number at 0
+      munmap(mapping_, mapping_size_);
+      mapping_ = nullptr;
+      close(fd);
+      std::this_thread::yield();
+      continue;
+    }
+    if (!initialized) {
+      header = new (mapping_) SegmentHeader();
+      header->version = SegmentHeader::current_version;
+      header->type_hash = type_hash;
+      header->max_subscriptions = max_subscriptions_;
+      header->depth = depth_;
+      header->max_message_size = max_message_size_;
+      for (size_t i = 0; i < max_subscriptions_; ++i) {
+        SlotHeader * slot = new (mapping_ + header_size + i * slot_size_) SlotHeader();
+        for (uint64_t ticket = 0; ticket < depth_; ++ticket) {
+          new (&get_cell(*slot, ticket)) CellHeader();
+        }
+      }
+      header->magic.store(SegmentHeader::expected_magic, std::memory_order_release);
+    } else if (header->version != SegmentHeader::current_version ||  // NOLINT
+      header->type_hash != type_hash || header->max_subscriptions != max_subscriptions_ ||
+      header->depth != depth_ || header->max_message_size != max_message_size_)
+    {
+      munmap(mapping_, mapping_size_);
+      mapping_ = nullptr;
+      close(fd);
+      throw std::runtime_error(
+              "the shared memory segment '" + segment_name_ +
+              "' is used with another type, depth, message size or number of subscriptions");
+    }
+
+    if (exclusive) {
+      if (flock(fd, LOCK_SH) != 0) {
+        throw fail("couldn't lock the shared memory segment", errno);
+      }
+      // The lock isn't converted atomically, so the segment may have been removed meanwhile
+      if (!is_current_segment()) {
+        munmap(mapping_, mapping_size_);
+        mapping_ = nullptr;
+        close(fd);
+        continue;
+      }
+    }
+    fd_ = fd;
+    break;
+  }
+
+  notification_fd_ = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (notification_fd_ < 0) {
+    const int error = errno;
+    munmap(mapping_, mapping_size_);
+    close(fd_);
+    throw make_error("couldn't create the notification socket of", segment_name_, error);
+  }
+#endif
+}
+
+SharedMemoryTopic::~SharedMemoryTopic()
+{
+#ifdef __linux__
+  close(notification_fd_);
+  munmap(mapping_, mapping_size_);
+  // Only the last user of the segment can lock it exclusively
+  if (flock(fd_, LOCK_EX | LOCK_NB) == 0) {
+    shm_unlink(segment_name_.c_str());
+  }
+  close(fd_);
+#endif
+}
+
+std::string
+SharedMemoryTopic::get_segment_name(size_t domain_id, const std::string & topic_name)
+{
+  char hash_string[17];
+  std::snprintf(
+    hash_string, sizeof(hash_string), "%016llx",
+    static_cast<unsigned long long>(hash(topic_name)));  // NOLINT(runtime/int)
+  return "/rclcpp_topic_" + std::to_string(domain_id) + "_" + hash_string;
+}
+
+size_t
+SharedMemoryTopic::write(const void * data, size_t size)
+{
+  if (size > max_message_size_) {
+    throw std::invalid_argument(
+            "the message of " + std::to_string(size) + " bytes is bigger than the maximum " +
+            "message size of the shared memory topic, " + std::to_string(max_message_size_));
+  }
+  size_t number_of_subscriptions = 0;
+  for (size_t i = 0; i < max_subscriptions_; ++i) {
+    SlotHeader & slot = get_slot(i);
+    const uint64_t state = slot.state.load(std::memory_order_acquire);
+    if (0u == get_pid(state)) {
+      continue;
+    }
+    ++number_of_subscriptions;
+    const uint64_t ticket = slot.head.fetch_add(1u, std::memory_order_acq_rel);
+    CellHeader & cell = get_cell(slot, ticket);
+    const uint64_t writing = 2u * ticket + 1u;
+    uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+    bool claimed = false;
+    while (sequence < writing) {
+      // The writer of the previous lap is left to finish, unless it's still writing a lap
+      // later, in which case it presumably died.
+      if ((sequence & 1u) && (sequence - 1u) / 2u + depth_ >= ticket) {
+        break;
+      }
+      if (cell.sequence.compare_exchange_weak(
+          sequence, writing, std::memory_order_acq_rel, std::memory_order_acquire))
+      {
+        claimed = true;
+        break;
+      }
+    }
+    // Otherwise a newer message was already written in the cell, this one is dropped
+    if (claimed) {
+      std::atomic_thread_fence(std::memory_order_release);
+      std::memcpy(reinterpret_cast<unsigned char *>(&cell) + sizeof(CellHeader), data, size);
+      cell.size.store(size, std::memory_order_relaxed);
+      uint64_t expected = writing;
+      cell.sequence.compare_exchange_strong(
+        expected, writing + 1u, std::memory_order_release, std::memory_order_relaxed);
+    }
+    if (0u == slot.notified.exchange(1u, std::memory_order_acq_rel)) {
+      notify(i, get_generation(state));
+    }
+  }
+  return number_of_subscriptions;
+}
+
+size_t
+SharedMemoryTopic::get_subscription_count() const
+{
+  size_t count = 0;
+  for (size_t i = 0; i < max_subscriptions_; ++i) {
+    if (0u != get_pid(get_slot(i).state.load(std::memory_order_relaxed))) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+size_t
+SharedMemoryTopic::get_max_message_size() const
+{
+  return max_message_size_;
+}
+
+const std::string &
+SharedMemoryTopic::get_segment_name() const
+{
+  return segment_name_;
+}
+
+SharedMemoryTopic::SlotHeader &
+SharedMemoryTopic::get_slot(size_t index) const
+{
+  return *reinterpret_cast<SlotHeader *>(
+    mapping_ + align_to_cache_line(sizeof(SegmentHeader)) + index * slot_size_);
+}
+
+SharedMemoryTopic::CellHeader &
+SharedMemoryTopic::get_cell(const SlotHeader & slot, uint64_t ticket) const
+{
+  auto cells = reinterpret_cast<unsigned char *>(const_cast<SlotHeader *>(&slot) + 1);
+  return *reinterpret_cast<CellHeader *>(cells + static_cast<size_t>(ticket % depth_) * cell_size_);
+}
+
+void
+SharedMemoryTopic::notify(size_t index, uint32_t generation) const
+{
+#ifdef __linux__
+  sockaddr_un address;
+  const socklen_t address_length =
+    get_notification_address(segment_name_, index, generation, address);
+  const char notification = 0;
+  if (sendto(
+      notification_fd_, &notification, sizeof(notification), MSG_DONTWAIT | MSG_NOSIGNAL,
+      reinterpret_cast<const sockaddr *>(&address), address_length) < 0 &&
+    EAGAIN != errno && EWOULDBLOCK != errno)
+  {
+    // Not received, so the next message sends another notification
+    get_slot(index).notified.store(0u, std::memory_order_release);
+  }
+#else
+  (void)index;
+  (void)generation;
+#endif
+}
+
+SharedMemoryTopicReader::SharedMemoryTopicReader(std::shared_ptr<SharedMemoryTopic> topic)
+: topic_(std::move(topic))
+{
+  if (!topic_) {
+    throw std::invalid_argument("the topic of a shared memory reader can't be null");
+  }
+#ifdef __linux__
+  const auto pid = static_cast<uint32_t>(getpid());
+  for (size_t i = 0; i < topic_->max_subscriptions_ && 0u == state_; ++i) {
+    auto & slot = topic_->get_slot(i);
+    uint64_t state = slot.state.load(std::memory_order_acquire);
+    while (0u == get_pid(state) || !is_process_alive(get_pid(state))) {
+      const uint64_t new_state = (static_cast<uint64_t>(get_generation(state) + 1u) << 32) | pid;
+      if (slot.state.compare_exchange_weak(
+          state, new_state, std::memory_order_acq_rel, std::memory_order_acquire))
+      {
+        index_ = i;
+        state_ = new_state;
+        break;
+      }
+    }
+  }
+  if (0u == state_) {
+    throw std::runtime_error(
+            "the shared memory segment '" + topic_->get_segment_name() +
+            "' has no free slot for another subscription");
+  }
+  auto & slot = topic_->get_slot(index_);
+  next_ticket_ = slot.head.load(std::memory_order_acquire);
+
+  fd_ = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  sockaddr_un address;
+  const socklen_t address_length = get_notification_address(
+    topic_->get_segment_name(), index_, get_generation(state_), address);
+  if (fd_ < 0 || bind(fd_, reinterpret_cast<const sockaddr *>(&address), address_length) != 0) {
+    const int error = errno;
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+    slot.state.store(state_ & ~pid_mask, std::memory_order_release);
+    throw make_error(
+            "couldn't create the notification socket of", topic_->get_segment_name(), error);
+  }
+  // The messages written before the socket was bound weren't notified
+  slot.notified.store(1u, std::memory_order_release);
+  topic_->notify(index_, get_generation(state_));
+#endif
+}
+
+SharedMemoryTopicReader::~SharedMemoryTopicReader()
+{
+#ifdef __linux__
+  uint64_t state = state_;
+  topic_->get_slot(index_).state.compare_exchange_strong(
+    state, state_ & ~pid_mask, std::memory_order_acq_rel);
+  close(fd_);
+#endif
+}
+
+int
+SharedMemoryTopicReader::get_file_descriptor() const
+{
+  return fd_;
+}
+
+void
+SharedMemoryTopicReader::clear_notifications()
+{
+#ifdef __linux__
+  // Cleared before the messages are read, so that the ones written afterwards are notified
+  topic_->get_slot(index_).notified.exchange(0u, std::memory_order_acq_rel);
+  char notifications[64];
+  while (recv(fd_, notifications, sizeof(notifications), MSG_DONTWAIT) > 0) {
+  }
+#endif
+}
+
+bool
+SharedMemoryTopicReader::read(void * buffer, size_t & size)
+{
+  const auto & slot = topic_->get_slot(index_);
+  const uint64_t depth = topic_->depth_;
+  while (true) {
+    auto & cell = topic_->get_cell(slot, next_ticket_);
+    const uint64_t written = 2u * next_ticket_ + 2u;
+    const uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+    if (sequence < written) {
+      // The message isn't written yet, unless its writer died and the ring went past it
+      if (slot.head.load(std::memory_order_acquire) <= next_ticket_ + depth) {
+        return false;
+      }
+      ++number_of_dropped_messages_;
+      ++next_ticket_;
+      continue;
+    }
+    if (sequence == written) {
+      size = static_cast<size_t>(cell.size.load(std::memory_order_relaxed));
+      if (size <= topic_->max_message_size_) {
+        std::memcpy(buffer, reinterpret_cast<const unsigned char *>(&cell) + sizeof(cell), size);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (cell.sequence.load(std::memory_order_relaxed) == sequence &&
+        size <= topic_->max_message_size_)
+      {
+        ++next_ticket_;
+        return true;
+      }
+      // Overwritten while it was read
+      continue;
+    }
+    // The writers went past the messages not read yet, so they were overwritten
+    const uint64_t head = slot.head.load(std::memory_order_acquire);
+    const uint64_t oldest = head > depth ? head - depth : 0u;
+    const uint64_t next_ticket = oldest > next_ticket_ ? oldest : next_ticket_ + 1u;
+    number_of_dropped_messages_ += next_ticket - next_ticket_;
+    next_ticket_ = next_ticket;
+  }
+}
+
+uint64_t
+SharedMemoryTopicReader::get_number_of_dropped_messages() const
+{
+  return number_of_dropped_messages_;
+}
@@ -13,8 +13,11 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <chrono>
+#include <ctime>
 #include <memory>
 #include <map>
+#include <optional>  // NOLINT
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -24,11 +27,14 @@
 #include "rcl/error_handling.h"
 #include "rcpputils/scope_exit.hpp"
 
+#include "rclcpp/callback_attribution.hpp"
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/executor.hpp"
+#include "rclcpp/experimental/subscription_intra_process_base.hpp"
 #include "rclcpp/guard_condition.hpp"
 #include "rclcpp/memory_strategy.hpp"
 #include "rclcpp/node.hpp"
+#include "rclcpp/trace_recorder.hpp"
 #include "rclcpp/utilities.hpp"
 
 #include "rcutils/logging_macros.h"
@@ -47,7 +53,10 @@ Executor::Executor(const rclcpp::ExecutorOptions & options)
 : spinning(false),
   interrupt_guard_condition_(options.context),
   shutdown_guard_condition_(std::make_shared<rclcpp::GuardCondition>(options.context)),
-  memory_strategy_(options.memory_strategy)
+  memory_strategy_(options.memory_strategy),
+  scheduling_policy_(options.scheduling_policy),
+  run_intra_process_consumers_inline_(options.run_intra_process_consumers_inline),
+  statistics_(options.statistics)
 {
   // Store the context for later use.
   context_ = options.context;
@@ -106,6 +115,7 @@ Executor::~Executor()
   weak_groups_associated_with_executor_to_nodes_.clear();
   weak_groups_to_nodes_associated_with_executor_.clear();
   weak_groups_to_nodes_.clear();
+  weak_nodes_to_number_of_callback_groups_.clear();
   for (const auto & pair : weak_groups_to_guard_conditions_) {
     auto guard_condition = pair.second;
     memory_strategy_->remove_guard_condition(guard_condition);
@@ -174,8 +184,9 @@ Executor::add_callback_groups_from_nodes_associated_to_executor()
   for (auto & weak_node : weak_nodes_) {
     auto node = weak_node.lock();
     if (node) {
+      // Capture the node by reference, so the std::function doesn't allocate.
       node->for_each_callback_group(
-        [this, node](rclcpp::CallbackGroup::SharedPtr shared_group_ptr)
+        [this, &node](rclcpp::CallbackGroup::SharedPtr shared_group_ptr)
         {
           if (
             shared_group_ptr->automatically_add_to_executor_with_node() &&
@@ -214,6 +225,7 @@ Executor::add_callback_group_to_map(
   }
   // Also add to the map that contains all callback groups
   weak_groups_to_nodes_.insert(std::make_pair(weak_group_ptr, node_ptr));
+  ++weak_nodes_to_number_of_callback_groups_[node_ptr];
 
   if (node_ptr->get_context()->is_valid()) {
     auto callback_group_guard_condition =
@@ -299,9 +311,7 @@ Executor::remove_callback_group_from_map(
     throw std::runtime_error("Callback group needs to be associated with executor.");
   }
   // If the node was matched and removed, interrupt waiting.
-  if (!has_node(node_ptr, weak_groups_to_nodes_associated_with_executor_) &&
-    !has_node(node_ptr, weak_groups_associated_with_executor_to_nodes_))
-  {
+  if (!remove_callback_group_of_node(node_ptr)) {
     auto iter = weak_groups_to_guard_conditions_.find(weak_group_ptr);
     if (iter != weak_groups_to_guard_conditions_.end()) {
       memory_strategy_->remove_guard_condition(iter->second);
@@ -505,32 +515,103 @@ Executor::set_memory_strategy(rclcpp::memory_strategy::MemoryStrategy::SharedPtr
   memory_strategy_ = memory_strategy;
 }
 
+/// Return the CPU time used by the calling thread, or zero if it isn't known.
+static
+std::chrono::nanoseconds
+get_thread_cpu_time()
+{
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+  struct timespec time;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) == 0) {
+    return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+  }
+#endif
+  return std::chrono::nanoseconds::zero();
+}
+
 void
 Executor::execute_any_executable(AnyExecutable & any_exec)
 {
   if (!spinning.load()) {
     return;
   }
+  // Lets rclcpp::CallbackGroup::wait_for_idle() know the group is being executed.
+  any_exec.callback_group->begin_execution();
+  RCPPUTILS_SCOPE_EXIT(any_exec.callback_group->end_execution(); );
+  // The subscriptions executed from the pipeline queue theirs in it too.
+  std::optional<rclcpp::detail::IntraProcessPipeline> pipeline;
+  if (run_intra_process_consumers_inline_ && !rclcpp::detail::IntraProcessPipeline::is_active()) {
+    pipeline.emplace();
+  }
+  const auto execution_start = statistics_ ?
+    std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+  const bool cpu_accounting = any_exec.callback_group->is_cpu_accounting_enabled();
+  const auto cpu_time_start =
+    cpu_accounting ? get_thread_cpu_time() : std::chrono::nanoseconds::zero();
   if (any_exec.timer) {
     TRACEPOINT(
       rclcpp_executor_execute,
       static_cast<const void *>(any_exec.timer->get_timer_handle().get()));
-    execute_timer(any_exec.timer);
+    RCLCPP_TRACE_RECORD(CallbackStart, any_exec.timer.get(), "timer");
+    {
+      rclcpp::callback_attribution::ScopedCallback attribution(any_exec.timer.get(), "timer");
+      execute_timer(any_exec.timer);
+    }
+    RCLCPP_TRACE_RECORD(CallbackEnd, any_exec.timer.get(), "timer");
   }
   if (any_exec.subscription) {
     TRACEPOINT(
       rclcpp_executor_execute,
       static_cast<const void *>(any_exec.subscription->get_subscription_handle().get()));
-    execute_subscription(any_exec.subscription);
+    RCLCPP_TRACE_RECORD(
+      CallbackStart, any_exec.subscription.get(), any_exec.subscription->get_topic_name());
+    {
+      rclcpp::callback_attribution::ScopedCallback attribution(
+        any_exec.subscription.get(), any_exec.subscription->get_topic_name());
+      execute_subscription(any_exec.subscription);
+    }
+    RCLCPP_TRACE_RECORD(
+      CallbackEnd, any_exec.subscription.get(), any_exec.subscription->get_topic_name());
   }
   if (any_exec.service) {
-    execute_service(any_exec.service);
+    RCLCPP_TRACE_RECORD(
+      CallbackStart, any_exec.service.get(), any_exec.service->get_service_name());
+    {
+      rclcpp::callback_attribution::ScopedCallback attribution(
+        any_exec.service.get(), any_exec.service->get_service_name());
+      execute_service(any_exec.service);
+    }
+    RCLCPP_TRACE_RECORD(CallbackEnd, any_exec.service.get(), any_exec.service->get_service_name());
   }
   if (any_exec.client) {
-    execute_client(any_exec.client);
+    RCLCPP_TRACE_RECORD(CallbackStart, any_exec.client.get(), any_exec.client->get_service_name());
+    {
+      rclcpp::callback_attribution::ScopedCallback attribution(
+        any_exec.client.get(), any_exec.client->get_service_name());
+      execute_client(any_exec.client);
+    }
+    RCLCPP_TRACE_RECORD(CallbackEnd, any_exec.client.get(), any_exec.client->get_service_name());
   }
   if (any_exec.waitable) {
-    any_exec.waitable->execute(any_exec.data);
+    RCLCPP_TRACE_RECORD(CallbackStart, any_exec.waitable.get(), "waitable");
+    {
+      rclcpp::callback_attribution::ScopedCallback attribution(
+        any_exec.waitable.get(), "waitable");
+      any_exec.waitable->execute(any_exec.data);
+    }
+    RCLCPP_TRACE_RECORD(CallbackEnd, any_exec.waitable.get(), "waitable");
+  }
+  if (cpu_accounting) {
+    any_exec.callback_group->record_cpu_time(get_thread_cpu_time() - cpu_time_start);
+  }
+  if (statistics_) {
+    const auto execution_end = std::chrono::steady_clock::now();
+    const std::chrono::steady_clock::time_point wait_end(
+      std::chrono::steady_clock::duration(last_wait_end_.load(std::memory_order_relaxed)));
+    statistics_->record_execution(
+      any_exec,
+      std::max(execution_start - wait_end, std::chrono::steady_clock::duration::zero()),
+      execution_end - execution_start);
   }
   // Reset the callback_group, regardless of type
   any_exec.callback_group->can_be_taken_from().store(true);
@@ -543,15 +624,53 @@ Executor::execute_any_executable(AnyExecutable & any_exec)
             std::string(
               "Failed to trigger guard condition from execute_any_executable: ") + ex.what());
   }
+  if (pipeline) {
+    execute_pipelined_subscriptions(*pipeline);
+  }
 }
 
-static
 void
+Executor::execute_pipelined_subscriptions(rclcpp::detail::IntraProcessPipeline & pipeline)
+{
+  while (auto subscription = pipeline.pop()) {
+    AnyExecutable any_exec;
+    {
+      std::lock_guard<std::mutex> guard{mutex_};
+      any_exec.callback_group = memory_strategy::MemoryStrategy::get_group_by_waitable(
+        subscription, weak_groups_to_nodes_);
+      if (!any_exec.callback_group) {
+        // It belongs to another executor, which executes it when it wakes up.
+        continue;
+      }
+      any_exec.node_base = get_node_by_group(weak_groups_to_nodes_, any_exec.callback_group);
+    }
+    auto & can_be_taken_from = any_exec.callback_group->can_be_taken_from();
+    if (any_exec.callback_group->type() == rclcpp::CallbackGroupType::MutuallyExclusive &&
+      !can_be_taken_from.exchange(false))
+    {
+      continue;
+    }
+    // The message may have been taken by another thread already. The buffer is checked,
+    // as the wait set of the executor is only used by the thread waiting with it.
+    if (!subscription->has_data()) {
+      can_be_taken_from.store(true);
+      continue;
+    }
+    any_exec.waitable = std::move(subscription);
+    any_exec.data = any_exec.waitable->take_data();
+    execute_any_executable(any_exec);
+  }
+}
+
+// The actions are template parameters, as std::function could allocate for each message.
+template<typename TakeActionT, typename HandleActionT>
+static
+bool
 take_and_do_error_handling(
   const char * action_description,
   const char * topic_or_service_name,
-  std::function<bool()> take_action,
-  std::function<void()> handle_action)
+  TakeActionT take_action,
+  HandleActionT handle_action)
 {
   bool taken = false;
   try {
@@ -579,11 +698,15 @@ take_and_do_error_handling(
       action_description,
       topic_or_service_name);
   }
+  return taken;
 }
 
-void
-Executor::execute_subscription(rclcpp::SubscriptionBase::SharedPtr subscription)
+/// Take a message from the subscription and handle it, returning false if none was taken.
+static
+bool
+take_and_handle_message(const rclcpp::SubscriptionBase::SharedPtr & subscription)
 {
+  bool taken = false;
   rclcpp::MessageInfo message_info;
   message_info.get_rmw_message_info().from_intra_process = false;
 
@@ -591,7 +714,7 @@ Executor::execute_subscription(rclcpp::SubscriptionBase::SharedPtr subscription)
     // This is the case where a copy of the serialized message is taken from
     // the middleware via inter-process communication.
     std::shared_ptr<SerializedMessage> serialized_msg = subscription->create_serialized_message();
-    take_and_do_error_handling(
+    taken = take_and_do_error_handling(
       "taking a serialized message from topic",
       subscription->get_topic_name(),
       [&]() {return subscription->take_serialized(*serialized_msg.get(), message_info);},
@@ -600,6 +723,21 @@ Executor::execute_subscription(rclcpp::SubscriptionBase::SharedPtr subscription)
         subscription->handle_serialized_message(serialized_msg, message_info);
       });
     subscription->return_serialized_message(serialized_msg);
+  } else if (subscription->uses_deserialization_pool()) {
+    // The large messages are deserialized by the pool, and then handled by the deserialization
+    // waitable of the subscription, so only the small messages may be handled here.
+    std::shared_ptr<void> message;
+    taken = take_and_do_error_handling(
+      "taking a message to deserialize from topic",
+      subscription->get_topic_name(),
+      [&]() {return subscription->take_for_deserialization_pool(message, message_info);},
+      [&]()
+      {
+        if (message) {
+          subscription->handle_message(message, message_info);
+          subscription->return_message(message);
+        }
+      });
   } else if (subscription->can_loan_messages()) {
     // This is the case where a loaned message is taken from the middleware via
     // inter-process communication, given to the user for their callback,
@@ -607,7 +745,7 @@ Executor::execute_subscription(rclcpp::SubscriptionBase::SharedPtr subscription)
     void * loaned_msg = nullptr;
     // TODO(wjwwood): refactor this into methods on subscription when LoanedMessage
     //   is extened to support subscriptions as well.
-    take_and_do_error_handling(
+    taken = take_and_do_error_handling(
       "taking a loaned message from topic",
       subscription->get_topic_name(),
       [&]()
@@ -641,13 +779,56 @@ Executor::execute_subscription(rclcpp::SubscriptionBase::SharedPtr subscription)
     // This case is taking a copy of the message data from the middleware via
     // inter-process communication.
     std::shared_ptr<void> message = subscription->create_message();
-    take_and_do_error_handling(
+    taken = take_and_do_error_handling(
       "taking a message from topic",
       subscription->get_topic_name(),
       [&]() {return subscription->take_type_erased(message.get(), message_info);},
       [&]() {subscription->handle_message(message, message_info);});
     subscription->return_message(message);
   }
+  return taken;
+}
+
+/// Take up to max_messages messages from the subscription at once, and handle them together.
+static
+void
+take_and_handle_messages(
+  const rclcpp::SubscriptionBase::SharedPtr & subscription,
+  size_t max_messages)
+{
+  std::vector<std::shared_ptr<void>> messages;
+  messages.reserve(max_messages);
+  for (size_t i = 0; i < max_messages; ++i) {
+    messages.push_back(subscription->create_message());
+  }
+  std::vector<rclcpp::MessageInfo> message_infos;
+  take_and_do_error_handling(
+    "taking messages from topic",
+    subscription->get_topic_name(),
+    [&]() {return subscription->take_type_erased_sequence(messages, message_infos);},
+    [&]() {subscription->handle_messages(messages, message_infos);});
+  for (auto & message : messages) {
+    subscription->return_message(message);
+  }
+}
+
+void
+Executor::execute_subscription(rclcpp::SubscriptionBase::SharedPtr subscription)
+{
+  const size_t max_messages = subscription->get_max_messages_per_wakeup();
+  // The loaned messages and the ones deserialized in a pool are still taken one at a time,
+  // and given to a batch callback as batches of one message, as the intra-process ones are.
+  if (max_messages > 1u && subscription->has_batch_callback() &&
+    !subscription->uses_deserialization_pool() && !subscription->can_loan_messages())
+  {
+    take_and_handle_messages(subscription, max_messages);
+    return;
+  }
+  for (size_t i = 0; i < max_messages; ++i) {
+    if (!take_and_handle_message(subscription)) {
+      break;
+    }
+  }
 }
 
 void
@@ -685,6 +866,9 @@ void
 Executor::wait_for_work(std::chrono::nanoseconds timeout)
 {
   TRACEPOINT(rclcpp_executor_wait_for_work, timeout.count());
+  const auto collection_start = statistics_ ?
+    std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+  size_t wait_set_size = 0;
   {
     std::lock_guard<std::mutex> guard(mutex_);
 
@@ -700,17 +884,19 @@ Executor::wait_for_work(std::chrono::nanoseconds timeout)
       memory_strategy_->collect_entities(weak_groups_to_nodes_);
 
     if (has_invalid_weak_groups_or_nodes) {
-      std::vector<rclcpp::CallbackGroup::WeakPtr> invalid_group_ptrs;
+      std::vector<WeakCallbackGroupsToNodesMap::value_type> invalid_group_ptrs;
       for (auto pair : weak_groups_to_nodes_) {
         auto weak_group_ptr = pair.first;
         auto weak_node_ptr = pair.second;
         if (weak_group_ptr.expired() || weak_node_ptr.expired()) {
-          invalid_group_ptrs.push_back(weak_group_ptr);
+          invalid_group_ptrs.push_back(pair);
         }
       }
       std::for_each(
         invalid_group_ptrs.begin(), invalid_group_ptrs.end(),
-        [this](rclcpp::CallbackGroup::WeakPtr group_ptr) {
+        [this](const WeakCallbackGroupsToNodesMap::value_type & group_and_node) {
+          const rclcpp::CallbackGroup::WeakPtr & group_ptr = group_and_node.first;
+          remove_callback_group_of_node(group_and_node.second);
           if (weak_groups_to_nodes_associated_with_executor_.find(group_ptr) !=
           weak_groups_to_nodes_associated_with_executor_.end())
           {
@@ -738,13 +924,29 @@ Executor::wait_for_work(std::chrono::nanoseconds timeout)
     }
 
     // The size of waitables are accounted for in size of the other entities
-    ret = rcl_wait_set_resize(
-      &wait_set_, memory_strategy_->number_of_ready_subscriptions(),
-      memory_strategy_->number_of_guard_conditions(), memory_strategy_->number_of_ready_timers(),
-      memory_strategy_->number_of_ready_clients(), memory_strategy_->number_of_ready_services(),
-      memory_strategy_->number_of_ready_events());
-    if (RCL_RET_OK != ret) {
-      throw_from_rcl_error(ret, "Couldn't resize the wait set");
+    const size_t number_of_subscriptions = memory_strategy_->number_of_ready_subscriptions();
+    const size_t number_of_guard_conditions = memory_strategy_->number_of_guard_conditions();
+    const size_t number_of_timers = memory_strategy_->number_of_ready_timers();
+    const size_t number_of_clients = memory_strategy_->number_of_ready_clients();
+    const size_t number_of_services = memory_strategy_->number_of_ready_services();
+    const size_t number_of_events = memory_strategy_->number_of_ready_events();
+    wait_set_size = number_of_subscriptions + number_of_guard_conditions + number_of_timers +
+      number_of_clients + number_of_services + number_of_events;
+    // Resizing reallocates the wait set, which is only needed when the sizes changed.
+    if (
+      wait_set_.size_of_subscriptions != number_of_subscriptions ||
+      wait_set_.size_of_guard_conditions != number_of_guard_conditions ||
+      wait_set_.size_of_timers != number_of_timers ||
+      wait_set_.size_of_clients != number_of_clients ||
+      wait_set_.size_of_services != number_of_services ||
+      wait_set_.size_of_events != number_of_events)
+    {
+      ret = rcl_wait_set_resize(
+        &wait_set_, number_of_subscriptions, number_of_guard_conditions, number_of_timers,
+        number_of_clients, number_of_services, number_of_events);
+      if (RCL_RET_OK != ret) {
+        throw_from_rcl_error(ret, "Couldn't resize the wait set");
+      }
     }
 
     if (!memory_strategy_->add_handles_to_wait_set(&wait_set_)) {
@@ -752,8 +954,20 @@ Executor::wait_for_work(std::chrono::nanoseconds timeout)
     }
   }
 
+  const auto wait_start = statistics_ ?
+    std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+  if (statistics_) {
+    statistics_->record_collection(wait_start - collection_start, wait_set_size);
+  }
+  RCLCPP_TRACE_RECORD(WaitStart, this, "wait");
   rcl_ret_t status =
     rcl_wait(&wait_set_, std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count());
+  RCLCPP_TRACE_RECORD(WaitEnd, this, "wait");
+  if (statistics_) {
+    const auto wait_end = std::chrono::steady_clock::now();
+    statistics_->record_wait(wait_end - wait_start);
+    last_wait_end_.store(wait_end.time_since_epoch().count(), std::memory_order_relaxed);
+  }
   if (status == RCL_RET_WAIT_SET_EMPTY) {
     RCUTILS_LOG_WARN_NAMED(
       "rclcpp",
@@ -828,6 +1042,26 @@ Executor::get_next_ready_executable(AnyExecutable & any_executable)
   return success;
 }
 
+static
+bool
+has_higher_priority(const rclcpp::CallbackGroup & group, const rclcpp::CallbackGroup & other)
+{
+  return group.get_priority() > other.get_priority();
+}
+
+static
+bool
+has_earlier_deadline(const rclcpp::CallbackGroup & group, const rclcpp::CallbackGroup & other)
+{
+  const auto deadline = group.get_deadline();
+  const auto other_deadline = other.get_deadline();
+  if (deadline != other_deadline) {
+    // Groups without a deadline go last.
+    return deadline.count() != 0 && (other_deadline.count() == 0 || deadline < other_deadline);
+  }
+  return has_higher_priority(group, other);
+}
+
 bool
 Executor::get_next_ready_executable_from_map(
   AnyExecutable & any_executable,
@@ -837,38 +1071,50 @@ Executor::get_next_ready_executable_from_map(
   TRACEPOINT(rclcpp_executor_get_next_ready);
   bool success = false;
   std::lock_guard<std::mutex> guard{mutex_};
-  // Check the timers to see if there are any that are ready
-  memory_strategy_->get_next_timer(any_executable, weak_groups_to_nodes);
-  if (any_executable.timer) {
-    success = true;
-  }
-  if (!success) {
-    // Check the subscriptions to see if there are any that are ready
-    memory_strategy_->get_next_subscription(any_executable, weak_groups_to_nodes);
-    if (any_executable.subscription) {
-      success = true;
+  if (scheduling_policy_ != ExecutorSchedulingPolicy::FixedOrder) {
+    memory_strategy_->get_next_executable_by_precedence(
+      any_executable, weak_groups_to_nodes,
+      scheduling_policy_ == ExecutorSchedulingPolicy::Priority ?
+      has_higher_priority : has_earlier_deadline);
+    success = any_executable.timer || any_executable.subscription || any_executable.service ||
+      any_executable.client || any_executable.waitable;
+    if (any_executable.waitable) {
+      any_executable.data = any_executable.waitable->take_data();
     }
-  }
-  if (!success) {
-    // Check the services to see if there are any that are ready
-    memory_strategy_->get_next_service(any_executable, weak_groups_to_nodes);
-    if (any_executable.service) {
+  } else {
+    // Check the timers to see if there are any that are ready
+    memory_strategy_->get_next_timer(any_executable, weak_groups_to_nodes);
+    if (any_executable.timer) {
       success = true;
     }
-  }
-  if (!success) {
-    // Check the clients to see if there are any that are ready
-    memory_strategy_->get_next_client(any_executable, weak_groups_to_nodes);
-    if (any_executable.client) {
-      success = true;
+    if (!success) {
+      // Check the subscriptions to see if there are any that are ready
+      memory_strategy_->get_next_subscription(any_executable, weak_groups_to_nodes);
+      if (any_executable.subscription) {
+        success = true;
+      }
     }
-  }
-  if (!success) {
-    // Check the waitables to see if there are any that are ready
-    memory_strategy_->get_next_waitable(any_executable, weak_groups_to_nodes);
-    if (any_executable.waitable) {
-      any_executable.data = any_executable.waitable->take_data();
-      success = true;
+    if (!success) {
+      // Check the services to see if there are any that are ready
+      memory_strategy_->get_next_service(any_executable, weak_groups_to_nodes);
+      if (any_executable.service) {
+        success = true;
+      }
+    }
+    if (!success) {
+      // Check the clients to see if there are any that are ready
+      memory_strategy_->get_next_client(any_executable, weak_groups_to_nodes);
+      if (any_executable.client) {
+        success = true;
+      }
+    }
+    if (!success) {
+      // Check the waitables to see if there are any that are ready
+      memory_strategy_->get_next_waitable(any_executable, weak_groups_to_nodes);
+      if (any_executable.waitable) {
+        any_executable.data = any_executable.waitable->take_data();
+        success = true;
+      }
     }
   }
   // At this point any_executable should be valid with either a valid subscription
@@ -919,6 +1165,21 @@ Executor::get_next_executable(AnyExecutable & any_executable, std::chrono::nanos
   return success;
 }
 
+bool
+Executor::remove_callback_group_of_node(
+  const rclcpp::node_interfaces::NodeBaseInterface::WeakPtr & weak_node_ptr)
+{
+  auto iter = weak_nodes_to_number_of_callback_groups_.find(weak_node_ptr);
+  if (iter == weak_nodes_to_number_of_callback_groups_.end()) {
+    return false;
+  }
+  if (--iter->second == 0u) {
+    weak_nodes_to_number_of_callback_groups_.erase(iter);
+    return false;
+  }
+  return true;
+}
+
 // Returns true iff the weak_groups_to_nodes map has node_ptr as the value in any of its entry.
 bool
 Executor::has_node(
@@ -0,0 +1,373 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/executor_statistics.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+using rclcpp::ExecutorLoopStatistics;
+using rclcpp::ExecutorStatistics;
+using rclcpp::LatencyHistogram;
+using rclcpp::LatencyHistogramSnapshot;
+
+namespace
+{
+
+size_t
+get_bucket_index(std::chrono::nanoseconds duration)
+{
+  auto microseconds = static_cast<uint64_t>(
+    std::max<int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(duration).count(), 0));
+  size_t index = 0;
+  while (microseconds > 0 && index < LatencyHistogramSnapshot::number_of_buckets - 1) {
+    microseconds >>= 1;
+    ++index;
+  }
+  return index;
+}
+
+double
+to_milliseconds(std::chrono::nanoseconds duration)
+{
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void
+add_to_counter(std::atomic<uint64_t> * counter, std::chrono::nanoseconds duration)
+{
+  counter->fetch_add(
+    static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0)), std::memory_order_relaxed);
+}
+
+}  // namespace
+
+constexpr size_t LatencyHistogramSnapshot::number_of_buckets;
+
+std::chrono::nanoseconds
+LatencyHistogramSnapshot::mean() const
+{
+  if (count == 0) {
+    return std::chrono::nanoseconds(0);
+  }
+  return total / count;
+}
+
+std::chrono::nanoseconds
+LatencyHistogramSnapshot::percentile(double percentile) const
+{
+  const double rank = std::min(std::max(percentile, 0.0), 100.0) / 100.0 * count;
+  uint64_t cumulative_count = 0;
+  for (size_t i = 0; i < number_of_buckets - 1; ++i) {
+    cumulative_count += buckets[i];
+    if (cumulative_count > 0 && cumulative_count >= rank) {
+      return std::min<std::chrono::nanoseconds>(std::chrono::microseconds(1ull << i), max);
+    }
+  }
+  return max;
+}
+
+void
+LatencyHistogram::record(std::chrono::nanoseconds duration)
+{
+  count_.fetch_add(1, std::memory_order_relaxed);
+  total_ns_.fetch_add(duration.count(), std::memory_order_relaxed);
+  int64_t max_ns = max_ns_.load(std::memory_order_relaxed);
+  while (duration.count() > max_ns &&
+    !max_ns_.compare_exchange_weak(max_ns, duration.count(), std::memory_order_relaxed))
+  {
+  }
+  buckets_[get_bucket_index(duration)].fetch_add(1, std::memory_order_relaxed);
+}
+
+LatencyHistogramSnapshot
+LatencyHistogram::get_snapshot() const
+{
+  LatencyHistogramSnapshot snapshot;
+  snapshot.count = count_.load(std::memory_order_relaxed);
+  snapshot.total = std::chrono::nanoseconds(total_ns_.load(std::memory_order_relaxed));
+  snapshot.max = std::chrono::nanoseconds(max_ns_.load(std::memory_order_relaxed));
+  for (size_t i = 0; i < buckets_.size(); ++i) {
+    snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+void
+LatencyHistogram::reset()
+{
+  count_.store(0, std::memory_order_relaxed);
+  total_ns_.store(0, std::memory_order_relaxed);
+  max_ns_.store(0, std::memory_order_relaxed);
+  for (auto & bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+ExecutorStatistics::ExecutorStatistics()
+: execution_duration_(true),
+  loop_window_start_(std::chrono::steady_clock::now().time_since_epoch().count())
+{
+}
+
+void
+ExecutorStatistics::record_collection(std::chrono::nanoseconds duration, size_t wait_set_size)
+{
+  collection_duration_.add_sample(to_milliseconds(duration));
+  wait_set_size_.add_sample(static_cast<double>(wait_set_size));
+  if (exported_counters_) {
+    add_to_counter(exported_counters_->collection_ns, duration);
+    exported_counters_->wait_set_size->store(wait_set_size, std::memory_order_relaxed);
+  }
+}
+
+void
+ExecutorStatistics::record_wait(std::chrono::nanoseconds duration)
+{
+  wait_time_.record(duration);
+  wait_duration_.add_sample(to_milliseconds(duration));
+  get_thread_statistics().idle_ns.fetch_add(duration.count(), std::memory_order_relaxed);
+  if (exported_counters_) {
+    exported_counters_->wakeups->fetch_add(1u, std::memory_order_relaxed);
+    add_to_counter(exported_counters_->wait_ns, duration);
+  }
+}
+
+void
+ExecutorStatistics::record_execution(
+  const rclcpp::AnyExecutable & any_exec,
+  std::chrono::nanoseconds dispatch_latency,
+  std::chrono::nanoseconds callback_duration)
+{
+  const void * entity = nullptr;
+  const char * kind = nullptr;
+  const char * name = nullptr;
+  if (any_exec.timer) {
+    entity = any_exec.timer.get();
+    kind = "timer";
+  } else if (any_exec.subscription) {
+    entity = any_exec.subscription.get();
+    kind = "subscription";
+    name = any_exec.subscription->get_topic_name();
+  } else if (any_exec.service) {
+    entity = any_exec.service.get();
+    kind = "service";
+    name = any_exec.service->get_service_name();
+  } else if (any_exec.client) {
+    entity = any_exec.client.get();
+    kind = "client";
+    name = any_exec.client->get_service_name();
+  } else if (any_exec.waitable) {
+    entity = any_exec.waitable.get();
+    kind = "waitable";
+  } else {
+    return;
+  }
+
+  execution_duration_.add_sample(to_milliseconds(callback_duration));
+  get_thread_statistics().busy_ns.fetch_add(callback_duration.count(), std::memory_order_relaxed);
+  if (exported_counters_) {
+    exported_counters_->executions->fetch_add(1u, std::memory_order_relaxed);
+    add_to_counter(exported_counters_->execution_ns, callback_duration);
+  }
+
+  auto & entity_statistics = get_executable_statistics(entities_, entity, kind, name);
+  entity_statistics.dispatch_latency.record(dispatch_latency);
+  entity_statistics.callback_duration.record(callback_duration);
+
+  if (any_exec.callback_group) {
+    auto & group_statistics = get_executable_statistics(
+      callback_groups_, any_exec.callback_group.get(), "callback_group", nullptr);
+    group_statistics.dispatch_latency.record(dispatch_latency);
+    group_statistics.callback_duration.record(callback_duration);
+  }
+}
+
+void
+ExecutorStatistics::record_thread_pool_size(size_t size)
+{
+  thread_pool_size_.store(size, std::memory_order_relaxed);
+  if (exported_counters_) {
+    exported_counters_->thread_pool_size->store(size, std::memory_order_relaxed);
+  }
+}
+
+size_t
+ExecutorStatistics::get_thread_pool_size() const
+{
+  return thread_pool_size_.load(std::memory_order_relaxed);
+}
+
+LatencyHistogramSnapshot
+ExecutorStatistics::get_wait_time() const
+{
+  return wait_time_.get_snapshot();
+}
+
+std::unordered_map<const void *, rclcpp::ExecutableStatisticsSnapshot>
+ExecutorStatistics::get_entity_statistics() const
+{
+  std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+  return get_snapshots(entities_);
+}
+
+std::unordered_map<const void *, rclcpp::ExecutableStatisticsSnapshot>
+ExecutorStatistics::get_callback_group_statistics() const
+{
+  std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+  return get_snapshots(callback_groups_);
+}
+
+ExecutorLoopStatistics
+ExecutorStatistics::take_loop_statistics()
+{
+  const auto now = std::chrono::steady_clock::now();
+  const std::chrono::steady_clock::time_point window_start(
+    std::chrono::steady_clock::duration(
+      loop_window_start_.exchange(now.time_since_epoch().count())));
+
+  ExecutorLoopStatistics statistics;
+  statistics.window_duration = now - window_start;
+  statistics.wait_set_size = wait_set_size_.take_statistics();
+  statistics.wait_duration = wait_duration_.take_statistics();
+  statistics.collection_duration = collection_duration_.take_statistics();
+  statistics.execution_duration =
+    execution_duration_.take_statistics(statistics.execution_duration_percentiles);
+  statistics.thread_pool_size = get_thread_pool_size();
+
+  rclcpp::topic_statistics::StatisticsAccumulator idle_ratio;
+  {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+    for (auto & pair : threads_) {
+      const int64_t idle_ns = pair.second->idle_ns.exchange(0, std::memory_order_relaxed);
+      const int64_t busy_ns = pair.second->busy_ns.exchange(0, std::memory_order_relaxed);
+      if ((idle_ns == 0 && busy_ns == 0) || statistics.window_duration.count() <= 0) {
+        continue;
+      }
+      idle_ratio.add_sample(
+        std::min(
+          static_cast<double>(idle_ns) / static_cast<double>(statistics.window_duration.count()),
+          1.0));
+    }
+  }
+  statistics.idle_ratio = idle_ratio.take_statistics();
+  return statistics;
+}
+
+void
+ExecutorStatistics::reset()
+{
+  wait_time_.reset();
+  take_loop_statistics();
+
+  // The entries are kept, as they may be being recorded to concurrently.
+  std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+  for (auto map : {&entities_, &callback_groups_}) {
+    for (auto & pair : *map) {
+      pair.second->dispatch_latency.reset();
+      pair.second->callback_duration.reset();
+    }
+  }
+}
+
+ExecutorStatistics::ExecutableStatistics &
+ExecutorStatistics::get_executable_statistics(
+  ExecutableStatisticsMap & map,
+  const void * key,
+  const char * kind,
+  const char * name)
+{
+  {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+    auto it = map.find(key);
+    if (it != map.end()) {
+      return *it->second;
+    }
+  }
+
+  std::unique_lock<std::shared_timed_mutex> lock(mutex_);
+  auto & statistics = map[key];
+  if (!statistics) {
+    statistics = std::make_unique<ExecutableStatistics>();
+    statistics->description = kind;
+    if (name) {
+      statistics->description += std::string(" ") + name;
+    }
+  }
+  return *statistics;
+}
+
+void
+ExecutorStatistics::export_counters(
+  rclcpp::SharedMemoryCounters::SharedPtr counters,
+  const std::string & prefix)
+{
+  if (!counters) {
+    throw std::invalid_argument("the shared memory counters of executor statistics are null");
+  }
+  if (exported_counters_) {
+    throw std::runtime_error("the executor statistics are already exported");
+  }
+  auto exported_counters = std::make_unique<ExportedCounters>();
+  exported_counters->wakeups = &counters->add_counter(prefix + ".wakeups");
+  exported_counters->wait_ns = &counters->add_counter(prefix + ".wait_ns");
+  exported_counters->collection_ns = &counters->add_counter(prefix + ".collection_ns");
+  exported_counters->wait_set_size = &counters->add_counter(prefix + ".wait_set_size");
+  exported_counters->executions = &counters->add_counter(prefix + ".executions");
+  exported_counters->execution_ns = &counters->add_counter(prefix + ".execution_ns");
+  exported_counters->thread_pool_size = &counters->add_counter(prefix + ".thread_pool_size");
+  exported_counters->thread_pool_size->store(get_thread_pool_size(), std::memory_order_relaxed);
+  exported_counters->counters = std::move(counters);
+  exported_counters_ = std::move(exported_counters);
+}
+
+ExecutorStatistics::ThreadStatistics &
+ExecutorStatistics::get_thread_statistics()
+{
+  const auto thread_id = std::this_thread::get_id();
+  {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+    auto it = threads_.find(thread_id);
+    if (it != threads_.end()) {
+      return *it->second;
+    }
+  }
+
+  std::unique_lock<std::shared_timed_mutex> lock(mutex_);
+  auto & statistics = threads_[thread_id];
+  if (!statistics) {
+    statistics = std::make_unique<ThreadStatistics>();
+  }
+  return *statistics;
+}
+
+std::unordered_map<const void *, rclcpp::ExecutableStatisticsSnapshot>
+ExecutorStatistics::get_snapshots(const ExecutableStatisticsMap & map)
+{
+  std::unordered_map<const void *, ExecutableStatisticsSnapshot> snapshots;
+  for (const auto & pair : map) {
+    auto & snapshot = snapshots[pair.first];
+    snapshot.description = pair.second->description;
+    snapshot.dispatch_latency = pair.second->dispatch_latency.get_snapshot();
+    snapshot.callback_duration = pair.second->callback_duration.get_snapshot();
+  }
+  return snapshots;
+}
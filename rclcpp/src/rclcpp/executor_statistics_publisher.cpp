@@ -0,0 +1,190 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/executor_statistics_publisher.hpp"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "libstatistics_collector/collector/generate_statistics_message.hpp"
+#include "libstatistics_collector/topic_statistics_collector/constants.hpp"
+
+#include "rclcpp/topic_statistics/percentile_histogram.hpp"
+
+using rclcpp::ExecutorStatisticsPublisher;
+
+namespace
+{
+
+constexpr const char kCountUnitName[]{"count"};
+constexpr const char kHertzUnitName[]{"Hz"};
+constexpr const char kRatioUnitName[]{"ratio"};
+
+int64_t
+get_current_nanoseconds_since_epoch()
+{
+  const auto now = std::chrono::system_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+}
+
+/// Return the statistics of a single value measured for a whole window.
+rclcpp::ExecutorLoopStatistics::StatisticData
+make_single_value(double value)
+{
+  rclcpp::ExecutorLoopStatistics::StatisticData data;
+  data.average = value;
+  data.min = value;
+  data.max = value;
+  data.standard_deviation = 0.;
+  data.sample_count = 1u;
+  return data;
+}
+
+}  // namespace
+
+ExecutorStatisticsPublisher::ExecutorStatisticsPublisher(
+  const std::string & source_name,
+  rclcpp::ExecutorStatistics::SharedPtr statistics,
+  std::shared_ptr<StatisticsPublisher> publisher)
+: source_name_(source_name),
+  statistics_(std::move(statistics)),
+  publisher_(std::move(publisher)),
+  window_start_(get_current_nanoseconds_since_epoch())
+{
+  if (nullptr == statistics_) {
+    throw std::invalid_argument("statistics pointer is nullptr");
+  }
+  if (nullptr == publisher_) {
+    throw std::invalid_argument("publisher pointer is nullptr");
+  }
+  // The first window starts now
+  statistics_->take_loop_statistics();
+}
+
+ExecutorStatisticsPublisher::~ExecutorStatisticsPublisher()
+{
+  if (publisher_timer_) {
+    publisher_timer_->cancel();
+    publisher_timer_.reset();
+  }
+  publisher_.reset();
+}
+
+void
+ExecutorStatisticsPublisher::set_publisher_timer(rclcpp::TimerBase::SharedPtr publisher_timer)
+{
+  publisher_timer_ = std::move(publisher_timer);
+}
+
+void
+ExecutorStatisticsPublisher::add_callback_group(
+  const std::string & name,
+  rclcpp::CallbackGroup::SharedPtr callback_group)
+{
+  if (nullptr == callback_group) {
+    throw std::invalid_argument("callback group pointer is nullptr");
+  }
+  std::lock_guard<std::mutex> lock(callback_groups_mutex_);
+  callback_groups_.push_back(
+    {source_name_ + "/" + name, callback_group, callback_group->get_cpu_statistics()});
+}
+
+void
+ExecutorStatisticsPublisher::publish_callback_groups(const rclcpp::Time & window_end)
+{
+  using libstatistics_collector::collector::GenerateStatisticMessage;
+
+  const double window_ns = static_cast<double>((window_end - window_start_).nanoseconds());
+  std::lock_guard<std::mutex> lock(callback_groups_mutex_);
+  auto it = callback_groups_.begin();
+  while (it != callback_groups_.end()) {
+    auto callback_group = it->callback_group.lock();
+    if (!callback_group) {
+      it = callback_groups_.erase(it);
+      continue;
+    }
+    const auto statistics = callback_group->get_cpu_statistics();
+    // The statistics may have been reset during the window
+    const auto & previous = it->previous_statistics;
+    const bool reset = statistics.executions < previous.executions;
+    const double cpu_time_ns = static_cast<double>(
+      (reset ? statistics.cpu_time : statistics.cpu_time - previous.cpu_time).count());
+    const uint64_t executions =
+      reset ? statistics.executions : statistics.executions - previous.executions;
+    const uint64_t overruns =
+      reset ? statistics.overruns : statistics.overruns - previous.overruns;
+    it->previous_statistics = statistics;
+
+    publisher_->publish(
+      GenerateStatisticMessage(
+        it->source_name, kCallbackGroupCpuUsageStatName, kRatioUnitName, window_start_,
+        window_end, make_single_value(window_ns > 0. ? cpu_time_ns / window_ns : 0.)));
+    publisher_->publish(
+      GenerateStatisticMessage(
+        it->source_name, kCallbackGroupExecutionsStatName, kCountUnitName, window_start_,
+        window_end, make_single_value(static_cast<double>(executions))));
+    publisher_->publish(
+      GenerateStatisticMessage(
+        it->source_name, kCallbackGroupOverrunsStatName, kCountUnitName, window_start_,
+        window_end, make_single_value(static_cast<double>(overruns))));
+    ++it;
+  }
+}
+
+void
+ExecutorStatisticsPublisher::publish_message_and_reset_measurements()
+{
+  using libstatistics_collector::collector::GenerateStatisticMessage;
+  using libstatistics_collector::topic_statistics_collector::topic_statistics_constants::
+    kMillisecondUnitName;
+
+  const rclcpp::Time window_end{get_current_nanoseconds_since_epoch()};
+  const auto statistics = statistics_->take_loop_statistics();
+
+  // The rate is a single value for the whole window
+  const auto wakeups = make_single_value(statistics.wakeups_per_second());
+
+  publisher_->publish(
+    GenerateStatisticMessage(
+      source_name_, kExecutorWaitSetSizeStatName, kCountUnitName, window_start_, window_end,
+      statistics.wait_set_size));
+  publisher_->publish(
+    GenerateStatisticMessage(
+      source_name_, kExecutorWakeupsStatName, kHertzUnitName, window_start_, window_end,
+      wakeups));
+  publisher_->publish(
+    GenerateStatisticMessage(
+      source_name_, kExecutorWaitDurationStatName, kMillisecondUnitName, window_start_,
+      window_end, statistics.wait_duration));
+  publisher_->publish(
+    GenerateStatisticMessage(
+      source_name_, kExecutorCollectionDurationStatName, kMillisecondUnitName, window_start_,
+      window_end, statistics.collection_duration));
+  auto execution_duration = GenerateStatisticMessage(
+    source_name_, kExecutorExecutionDurationStatName, kMillisecondUnitName, window_start_,
+    window_end, statistics.execution_duration);
+  rclcpp::topic_statistics::add_percentiles_to_message(
+    execution_duration, statistics.execution_duration_percentiles);
+  publisher_->publish(execution_duration);
+  publisher_->publish(
+    GenerateStatisticMessage(
+      source_name_, kExecutorIdleRatioStatName, kRatioUnitName, window_start_, window_end,
+      statistics.idle_ratio));
+  publish_callback_groups(window_end);
+  window_start_ = window_end;
+}
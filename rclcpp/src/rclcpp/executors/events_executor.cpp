@@ -0,0 +1,555 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/executors/events_executor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "rcpputils/scope_exit.hpp"
+
+#include "rclcpp/exceptions.hpp"
+#include "rclcpp/logging.hpp"
+
+using namespace std::chrono_literals;
+
+using rclcpp::executors::EventsExecutor;
+using rclcpp::executors::ExecutorEvent;
+using rclcpp::executors::ExecutorEventType;
+
+namespace
+{
+
+/// Unregister the entities of current missing from next, register the ones new in next.
+template<typename MapT, typename RegisterT, typename UnregisterT>
+void
+update_entities(MapT & current, MapT && next, RegisterT register_entity, UnregisterT unregister)
+{
+  for (const auto & pair : current) {
+    auto entity = pair.second.lock();
+    if (!entity) {
+      continue;
+    }
+    auto next_it = next.find(pair.first);
+    if (next_it == next.end() || next_it->second.lock() != entity) {
+      unregister(entity);
+    }
+  }
+  for (const auto & pair : next) {
+    auto entity = pair.second.lock();
+    if (!entity) {
+      continue;
+    }
+    auto current_it = current.find(pair.first);
+    // Compare the objects too, as the address of a destroyed entity may have been reused.
+    if (current_it == current.end() || current_it->second.lock() != entity) {
+      register_entity(entity);
+    }
+  }
+  current = std::move(next);
+}
+
+}  // namespace
+
+EventsExecutor::EventsExecutor(
+  rclcpp::experimental::buffers::EventsQueue::UniquePtr events_queue,
+  const rclcpp::ExecutorOptions & options)
+: rclcpp::Executor(options),
+  events_queue_(std::move(events_queue))
+{
+  if (!events_queue_) {
+    throw std::invalid_argument("events_queue can't be a null pointer");
+  }
+
+  timers_manager_ = std::make_shared<rclcpp::experimental::TimersManager>(
+    context_,
+    [this](const rclcpp::TimerBase * timer) {
+      ExecutorEvent event = {timer, -1, ExecutorEventType::TIMER_EVENT, 1};
+      this->events_queue_->enqueue(event);
+    });
+
+  // The interrupt guard condition is triggered on cancel and when entities are added or
+  // removed, while the shutdown one is triggered when the context is shut down.
+  // In both cases the executor must wake up and check its state.
+  interrupt_guard_condition_.set_on_trigger_callback(create_notify_callback());
+  shutdown_guard_condition_->set_on_trigger_callback(create_notify_callback());
+}
+
+EventsExecutor::~EventsExecutor()
+{
+  timers_manager_->stop();
+  interrupt_guard_condition_.set_on_trigger_callback(nullptr);
+  shutdown_guard_condition_->set_on_trigger_callback(nullptr);
+
+  std::lock_guard<std::mutex> guard{mutex_};
+  clear_entities();
+}
+
+void
+EventsExecutor::spin()
+{
+  if (spinning.exchange(true)) {
+    throw std::runtime_error("spin() called while already spinning");
+  }
+  RCPPUTILS_SCOPE_EXIT(this->spinning.store(false); );
+
+  timers_manager_->start();
+  RCPPUTILS_SCOPE_EXIT(this->timers_manager_->stop(); );
+
+  while (rclcpp::ok(context_) && spinning.load()) {
+    ExecutorEvent event;
+    // Block until an event is available, cancel() and shutdown also push one.
+    if (events_queue_->dequeue(event)) {
+      execute_event(event);
+    }
+  }
+}
+
+void
+EventsExecutor::spin_some(std::chrono::nanoseconds max_duration)
+{
+  return this->spin_some_impl(max_duration, false);
+}
+
+void
+EventsExecutor::spin_all(std::chrono::nanoseconds max_duration)
+{
+  if (max_duration < 0ns) {
+    throw std::invalid_argument("max_duration must be greater than or equal to 0");
+  }
+  return this->spin_some_impl(max_duration, true);
+}
+
+void
+EventsExecutor::spin_some_impl(std::chrono::nanoseconds max_duration, bool exhaustive)
+{
+  if (spinning.exchange(true)) {
+    throw std::runtime_error("spin_some() called while already spinning");
+  }
+  RCPPUTILS_SCOPE_EXIT(this->spinning.store(false); );
+
+  auto start = std::chrono::steady_clock::now();
+  auto max_duration_not_elapsed = [max_duration, start]() {
+      if (std::chrono::nanoseconds(0) == max_duration) {
+        // told to spin forever if need be
+        return true;
+      } else if (std::chrono::steady_clock::now() - start < max_duration) {
+        // told to spin only for some maximum amount of time
+        return true;
+      }
+      // spun too long
+      return false;
+    };
+
+  timers_manager_->trigger_ready_timers();
+
+  // When not exhaustive, only the events which are ready now are executed.
+  size_t ready_events = events_queue_->size();
+
+  while (rclcpp::ok(context_) && spinning.load() && max_duration_not_elapsed()) {
+    if (!exhaustive && ready_events == 0) {
+      break;
+    }
+    ExecutorEvent event;
+    if (!events_queue_->dequeue(event, 0ns)) {
+      // Timers are not monitored by a thread here, so look for new ready ones.
+      if (!exhaustive || timers_manager_->trigger_ready_timers() == 0) {
+        break;
+      }
+      continue;
+    }
+    execute_event(event);
+    if (!exhaustive) {
+      --ready_events;
+    }
+  }
+}
+
+void
+EventsExecutor::spin_once_impl(std::chrono::nanoseconds timeout)
+{
+  // In this context a negative input timeout means no timeout
+  if (timeout < 0ns) {
+    timeout = std::chrono::nanoseconds::max();
+  }
+
+  timers_manager_->trigger_ready_timers();
+
+  ExecutorEvent event;
+  bool has_event = events_queue_->dequeue(event, 0ns);
+  if (!has_event) {
+    // Wait for an event for at most the time until the next timer is ready.
+    auto head_timeout = std::max(timers_manager_->get_head_timeout(), 0ns);
+    has_event = events_queue_->dequeue(event, std::min(timeout, head_timeout));
+    if (!has_event && timers_manager_->trigger_ready_timers() > 0) {
+      has_event = events_queue_->dequeue(event, 0ns);
+    }
+  }
+
+  if (has_event) {
+    execute_event(event);
+  }
+}
+
+std::chrono::nanoseconds
+EventsExecutor::get_time_until_next_timer()
+{
+  return timers_manager_->get_head_timeout();
+}
+
+void
+EventsExecutor::add_callback_group(
+  rclcpp::CallbackGroup::SharedPtr group_ptr,
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_ptr,
+  bool notify)
+{
+  rclcpp::Executor::add_callback_group(group_ptr, node_ptr, notify);
+  refresh_entities();
+}
+
+void
+EventsExecutor::remove_callback_group(
+  rclcpp::CallbackGroup::SharedPtr group_ptr,
+  bool notify)
+{
+  rclcpp::Executor::remove_callback_group(group_ptr, notify);
+  refresh_entities();
+  // The callbacks of the group aren't registered anymore, but one may still be executing.
+  std::lock_guard<std::recursive_mutex> guard{execution_mutex_};
+}
+
+void
+EventsExecutor::add_node(
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_ptr, bool notify)
+{
+  rclcpp::Executor::add_node(node_ptr, notify);
+  refresh_entities();
+}
+
+void
+EventsExecutor::add_node(std::shared_ptr<rclcpp::Node> node_ptr, bool notify)
+{
+  this->add_node(node_ptr->get_node_base_interface(), notify);
+}
+
+void
+EventsExecutor::remove_node(
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_ptr, bool notify)
+{
+  rclcpp::Executor::remove_node(node_ptr, notify);
+  refresh_entities();
+}
+
+void
+EventsExecutor::remove_node(std::shared_ptr<rclcpp::Node> node_ptr, bool notify)
+{
+  this->remove_node(node_ptr->get_node_base_interface(), notify);
+}
+
+void
+EventsExecutor::execute_event(const ExecutorEvent & event)
+{
+  std::lock_guard<std::recursive_mutex> execution_guard{execution_mutex_};
+  switch (event.type) {
+    case ExecutorEventType::CLIENT_EVENT:
+      {
+        auto client = retrieve_entity(event.exec_entity_id, clients_);
+        if (client) {
+          for (size_t i = 0; i < event.num_events; i++) {
+            execute_client(client);
+          }
+        }
+        break;
+      }
+    case ExecutorEventType::SUBSCRIPTION_EVENT:
+      {
+        auto subscription = retrieve_entity(event.exec_entity_id, subscriptions_);
+        if (subscription) {
+          for (size_t i = 0; i < event.num_events; i++) {
+            execute_subscription(subscription);
+          }
+        }
+        break;
+      }
+    case ExecutorEventType::SERVICE_EVENT:
+      {
+        auto service = retrieve_entity(event.exec_entity_id, services_);
+        if (service) {
+          for (size_t i = 0; i < event.num_events; i++) {
+            execute_service(service);
+          }
+        }
+        break;
+      }
+    case ExecutorEventType::TIMER_EVENT:
+      {
+        auto timer = retrieve_entity(event.exec_entity_id, timers_);
+        if (timer) {
+          // The timers manager already called rclcpp::TimerBase::call() on the timer.
+          execute_timer(timer);
+        }
+        break;
+      }
+    case ExecutorEventType::WAITABLE_EVENT:
+      {
+        auto waitable = retrieve_entity(event.exec_entity_id, waitables_);
+        if (waitable) {
+          for (size_t i = 0; i < event.num_events; i++) {
+            auto data = waitable->take_data_by_entity_id(event.gen_entity_id);
+            waitable->execute(data);
+          }
+        }
+        break;
+      }
+    case ExecutorEventType::ENTITIES_CHANGED_EVENT:
+      {
+        refresh_entities();
+        break;
+      }
+  }
+}
+
+void
+EventsExecutor::refresh_entities()
+{
+  // Set first, so notifications received while refreshing are not lost.
+  entities_need_refresh_.store(false);
+
+  std::lock_guard<std::mutex> guard{mutex_};
+
+  // Take ownership of callback groups created after their node was added.
+  add_callback_groups_from_nodes_associated_to_executor();
+
+  EntitiesMap<rclcpp::SubscriptionBase> subscriptions;
+  EntitiesMap<rclcpp::ServiceBase> services;
+  EntitiesMap<rclcpp::ClientBase> clients;
+  EntitiesMap<rclcpp::TimerBase> timers;
+  EntitiesMap<rclcpp::Waitable> waitables;
+  EntitiesMap<rclcpp::GuardCondition> notify_guard_conditions;
+  EntitiesMap<rclcpp::node_interfaces::NodeBaseInterface> notify_nodes;
+
+  for (const auto & weak_node : weak_nodes_) {
+    auto node = weak_node.lock();
+    if (node) {
+      notify_nodes.emplace(node.get(), node);
+    }
+  }
+
+  for (const auto & pair : weak_groups_to_nodes_) {
+    auto group = pair.first.lock();
+    auto node = pair.second.lock();
+    if (!group || !node) {
+      continue;
+    }
+    if (node->get_context()->is_valid()) {
+      auto guard_condition = group->get_notify_guard_condition(node->get_context());
+      notify_guard_conditions.emplace(guard_condition.get(), guard_condition);
+    }
+    // The entities of disabled groups are removed, so their events are only reported
+    // once the group is enabled again.
+    if (!group->is_enabled()) {
+      continue;
+    }
+    group->collect_all_ptrs(
+      [&subscriptions](const rclcpp::SubscriptionBase::SharedPtr & subscription) {
+        subscriptions.emplace(subscription.get(), subscription);
+      },
+      [&services](const rclcpp::ServiceBase::SharedPtr & service) {
+        services.emplace(service.get(), service);
+      },
+      [&clients](const rclcpp::ClientBase::SharedPtr & client) {
+        clients.emplace(client.get(), client);
+      },
+      [&timers](const rclcpp::TimerBase::SharedPtr & timer) {
+        timers.emplace(timer.get(), timer);
+      },
+      [&waitables](const rclcpp::Waitable::SharedPtr & waitable) {
+        waitables.emplace(waitable.get(), waitable);
+      });
+  }
+
+  update_entities(
+    subscriptions_, std::move(subscriptions),
+    [this](const rclcpp::SubscriptionBase::SharedPtr & subscription) {
+      subscription->set_on_new_message_callback(
+        create_entity_callback(subscription.get(), ExecutorEventType::SUBSCRIPTION_EVENT));
+    },
+    [](const rclcpp::SubscriptionBase::SharedPtr & subscription) {
+      subscription->clear_on_new_message_callback();
+    });
+
+  update_entities(
+    services_, std::move(services),
+    [this](const rclcpp::ServiceBase::SharedPtr & service) {
+      service->set_on_new_request_callback(
+        create_entity_callback(service.get(), ExecutorEventType::SERVICE_EVENT));
+    },
+    [](const rclcpp::ServiceBase::SharedPtr & service) {
+      service->clear_on_new_request_callback();
+    });
+
+  update_entities(
+    clients_, std::move(clients),
+    [this](const rclcpp::ClientBase::SharedPtr & client) {
+      client->set_on_new_response_callback(
+        create_entity_callback(client.get(), ExecutorEventType::CLIENT_EVENT));
+    },
+    [](const rclcpp::ClientBase::SharedPtr & client) {
+      client->clear_on_new_response_callback();
+    });
+
+  update_entities(
+    timers_, std::move(timers),
+    [this](const rclcpp::TimerBase::SharedPtr & timer) {
+      timers_manager_->add_timer(timer);
+    },
+    [this](const rclcpp::TimerBase::SharedPtr & timer) {
+      timers_manager_->remove_timer(timer);
+    });
+
+  update_entities(
+    waitables_, std::move(waitables),
+    [this](const rclcpp::Waitable::SharedPtr & waitable) {
+      try {
+        waitable->set_on_ready_callback(create_waitable_callback(waitable.get()));
+      } catch (const std::runtime_error & e) {
+        RCLCPP_WARN(
+          rclcpp::get_logger("rclcpp"),
+          "EventsExecutor can't execute waitable %p, it will be ignored: %s",
+          static_cast<const void *>(waitable.get()), e.what());
+      }
+    },
+    [](const rclcpp::Waitable::SharedPtr & waitable) {
+      try {
+        waitable->clear_on_ready_callback();
+      } catch (const std::runtime_error &) {
+        // The callback could not be set in the first place.
+      }
+    });
+
+  update_entities(
+    notify_guard_conditions_, std::move(notify_guard_conditions),
+    [this](const rclcpp::GuardCondition::SharedPtr & guard_condition) {
+      guard_condition->set_on_trigger_callback(create_notify_callback());
+    },
+    [](const rclcpp::GuardCondition::SharedPtr & guard_condition) {
+      guard_condition->set_on_trigger_callback(nullptr);
+    });
+
+  update_entities(
+    notify_nodes_, std::move(notify_nodes),
+    [this](const rclcpp::node_interfaces::NodeBaseInterface::SharedPtr & node) {
+      node->get_notify_guard_condition().set_on_trigger_callback(create_notify_callback());
+    },
+    [](const rclcpp::node_interfaces::NodeBaseInterface::SharedPtr & node) {
+      try {
+        node->get_notify_guard_condition().set_on_trigger_callback(nullptr);
+      } catch (const std::runtime_error &) {
+        // The node is being destroyed, so is its guard condition.
+      }
+    });
+}
+
+void
+EventsExecutor::clear_entities()
+{
+  for (const auto & pair : subscriptions_) {
+    auto subscription = pair.second.lock();
+    if (subscription) {
+      subscription->clear_on_new_message_callback();
+    }
+  }
+  for (const auto & pair : services_) {
+    auto service = pair.second.lock();
+    if (service) {
+      service->clear_on_new_request_callback();
+    }
+  }
+  for (const auto & pair : clients_) {
+    auto client = pair.second.lock();
+    if (client) {
+      client->clear_on_new_response_callback();
+    }
+  }
+  for (const auto & pair : waitables_) {
+    auto waitable = pair.second.lock();
+    if (waitable) {
+      try {
+        waitable->clear_on_ready_callback();
+      } catch (const std::runtime_error &) {
+        // The callback could not be set in the first place.
+      }
+    }
+  }
+  for (const auto & pair : notify_guard_conditions_) {
+    auto guard_condition = pair.second.lock();
+    if (guard_condition) {
+      guard_condition->set_on_trigger_callback(nullptr);
+    }
+  }
+  for (const auto & pair : notify_nodes_) {
+    auto node = pair.second.lock();
+    if (node) {
+      try {
+        node->get_notify_guard_condition().set_on_trigger_callback(nullptr);
+      } catch (const std::runtime_error &) {
+        // The node is being destroyed, so is its guard condition.
+      }
+    }
+  }
+  timers_manager_->clear();
+
+  subscriptions_.clear();
+  services_.clear();
+  clients_.clear();
+  timers_.clear();
+  waitables_.clear();
+  notify_guard_conditions_.clear();
+  notify_nodes_.clear();
+}
+
+std::function<void(size_t)>
+EventsExecutor::create_entity_callback(const void * entity_key, ExecutorEventType type)
+{
+  return [this, entity_key, type](size_t num_events) {
+           ExecutorEvent event = {entity_key, -1, type, num_events};
+           this->events_queue_->enqueue(event);
+         };
+}
+
+std::function<void(size_t, int)>
+EventsExecutor::create_waitable_callback(const rclcpp::Waitable * waitable)
+{
+  return [this, waitable](size_t num_events, int gen_entity_id) {
+           ExecutorEvent event =
+           {waitable, gen_entity_id, ExecutorEventType::WAITABLE_EVENT, num_events};
+           this->events_queue_->enqueue(event);
+         };
+}
+
+std::function<void(size_t)>
+EventsExecutor::create_notify_callback()
+{
+  return [this](size_t num_events) {
+           (void)num_events;
+           // Coalesce notifications, a single refresh handles all of them.
+           if (!this->entities_need_refresh_.exchange(true)) {
+             ExecutorEvent event = {nullptr, -1, ExecutorEventType::ENTITIES_CHANGED_EVENT, 1};
+             this->events_queue_->enqueue(event);
+           }
+         };
+}
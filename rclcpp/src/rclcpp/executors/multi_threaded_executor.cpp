@@ -14,13 +14,21 @@
 
 #include "rclcpp/executors/multi_threaded_executor.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <functional>
+#include <list>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "rcpputils/scope_exit.hpp"
 
+#include "rclcpp/callback_attribution.hpp"
 #include "rclcpp/logging.hpp"
 #include "rclcpp/utilities.hpp"
 
@@ -33,7 +41,8 @@ MultiThreadedExecutor::MultiThreadedExecutor(
   std::chrono::nanoseconds next_exec_timeout)
 : rclcpp::Executor(options),
   yield_before_execute_(yield_before_execute),
-  next_exec_timeout_(next_exec_timeout)
+  next_exec_timeout_(next_exec_timeout),
+  thread_attributes_(options.thread_attributes)
 {
   number_of_threads_ = number_of_threads > 0 ?
     number_of_threads :
@@ -56,20 +65,55 @@ MultiThreadedExecutor::spin()
     throw std::runtime_error("spin() called while already spinning");
   }
   RCPPUTILS_SCOPE_EXIT(this->spinning.store(false); );
+
+  struct DedicatedThread
+  {
+    rclcpp::executors::SingleThreadedExecutor::SharedPtr executor;
+    std::thread thread;
+  };
+
   std::vector<std::thread> threads;
+  std::vector<DedicatedThread> dedicated_threads;
+  // The thread calling spin() only takes part in the pool when it needs no configuration,
+  // and it watches the load of an elastic pool instead.
+  const bool run_in_calling_thread =
+    thread_attributes_.empty() && dedicated_executors_.count(number_of_threads_ - 1) == 0 &&
+    max_number_of_threads_ == 0;
+  const size_t number_of_created_threads =
+    run_in_calling_thread ? number_of_threads_ - 1 : number_of_threads_;
   size_t thread_id = 0;
   {
     std::lock_guard wait_lock{wait_mutex_};
-    for (; thread_id < number_of_threads_ - 1; ++thread_id) {
+    for (; thread_id < number_of_created_threads; ++thread_id) {
+      auto dedicated_it = dedicated_executors_.find(thread_id);
+      if (dedicated_it != dedicated_executors_.end()) {
+        auto executor = dedicated_it->second;
+        std::thread thread(
+          [this, thread_id, executor]() {
+            this->run_dedicated(thread_id, executor);
+          });
+        dedicated_threads.push_back({executor, std::move(thread)});
+        continue;
+      }
       auto func = std::bind(&MultiThreadedExecutor::run, this, thread_id);
       threads.emplace_back(func);
     }
   }
 
-  run(thread_id);
+  if (run_in_calling_thread) {
+    run(thread_id);
+  } else if (max_number_of_threads_ > 0) {
+    grow_elastic_thread_pool();
+  }
   for (auto & thread : threads) {
     thread.join();
   }
+
+  // The dedicated executors spin while this one does, so interrupting their wait stops them.
+  for (auto & dedicated_thread : dedicated_threads) {
+    dedicated_thread.executor->cancel();
+    dedicated_thread.thread.join();
+  }
 }
 
 size_t
@@ -78,10 +122,196 @@ MultiThreadedExecutor::get_number_of_threads()
   return number_of_threads_;
 }
 
+void
+MultiThreadedExecutor::set_elastic_thread_pool(
+  size_t max_number_of_threads,
+  std::chrono::nanoseconds grow_after,
+  std::chrono::nanoseconds shrink_after)
+{
+  if (spinning.load()) {
+    throw std::runtime_error("set_elastic_thread_pool() called while spinning");
+  }
+  if (max_number_of_threads < number_of_threads_) {
+    throw std::invalid_argument(
+      "the maximum number of threads can't be lower than the number of threads");
+  }
+  if (grow_after <= std::chrono::nanoseconds::zero() ||
+    shrink_after <= std::chrono::nanoseconds::zero())
+  {
+    throw std::invalid_argument("the durations of an elastic thread pool must be positive");
+  }
+  max_number_of_threads_ = max_number_of_threads;
+  grow_after_ = grow_after;
+  shrink_after_ = shrink_after;
+}
+
+void
+MultiThreadedExecutor::add_callback_group_to_thread(
+  rclcpp::CallbackGroup::SharedPtr group_ptr,
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_ptr,
+  size_t thread_number)
+{
+  if (spinning.load()) {
+    throw std::runtime_error("add_callback_group_to_thread() called while spinning");
+  }
+  if (thread_number >= number_of_threads_) {
+    throw std::invalid_argument("thread_number must be lower than the number of threads");
+  }
+  if (dedicated_executors_.count(thread_number) == 0 &&
+    dedicated_executors_.size() + 1 >= number_of_threads_)
+  {
+    throw std::invalid_argument("at least one thread must not be dedicated to callback groups");
+  }
+
+  for (const auto & weak_group : get_all_callback_groups()) {
+    if (weak_group.lock() == group_ptr) {
+      remove_callback_group(group_ptr, false);
+      break;
+    }
+  }
+
+  auto & executor = dedicated_executors_[thread_number];
+  if (!executor) {
+    rclcpp::ExecutorOptions options;
+    options.context = context_;
+    executor = std::make_shared<rclcpp::executors::SingleThreadedExecutor>(options);
+  }
+  executor->add_callback_group(group_ptr, node_ptr, false);
+}
+
+void
+MultiThreadedExecutor::apply_attributes_to_thread(size_t this_thread_number)
+{
+  if (this_thread_number >= thread_attributes_.size()) {
+    return;
+  }
+  try {
+    rclcpp::apply_thread_attributes(thread_attributes_[this_thread_number]);
+  } catch (const std::runtime_error & e) {
+    RCLCPP_ERROR(
+      rclcpp::get_logger("rclcpp"),
+      "Failed to apply the attributes of MultiThreadedExecutor thread %zu: %s",
+      this_thread_number, e.what());
+  }
+}
+
+void
+MultiThreadedExecutor::grow_elastic_thread_pool()
+{
+  struct ElasticThread
+  {
+    size_t thread_number;
+    std::shared_ptr<std::atomic_bool> done;
+    std::thread thread;
+  };
+
+  std::list<ElasticThread> elastic_threads;
+  const std::chrono::nanoseconds poll_period = std::clamp<std::chrono::nanoseconds>(
+    grow_after_ / 4, std::chrono::milliseconds(1), std::chrono::milliseconds(100));
+  bool all_busy = false;
+  std::chrono::steady_clock::time_point busy_since;
+  while (rclcpp::ok(this->context_) && spinning.load()) {
+    std::this_thread::sleep_for(poll_period);
+
+    // Join the threads which exited after being idle, freeing their numbers
+    for (auto it = elastic_threads.begin(); it != elastic_threads.end(); ) {
+      if (it->done->load()) {
+        it->thread.join();
+        it = elastic_threads.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    const size_t number_of_running_threads = number_of_running_threads_.load();
+    if (number_of_running_threads == 0 ||
+      number_of_busy_threads_.load() < number_of_running_threads)
+    {
+      all_busy = false;
+      continue;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (!all_busy) {
+      all_busy = true;
+      busy_since = now;
+      continue;
+    }
+    if (now - busy_since < grow_after_ ||
+      number_of_threads_ + elastic_threads.size() >= max_number_of_threads_)
+    {
+      continue;
+    }
+
+    size_t thread_number = number_of_threads_;
+    while (std::any_of(
+        elastic_threads.begin(), elastic_threads.end(),
+        [thread_number](const ElasticThread & elastic_thread) {
+          return elastic_thread.thread_number == thread_number;
+        }))
+    {
+      ++thread_number;
+    }
+    auto done = std::make_shared<std::atomic_bool>(false);
+    std::thread thread(
+      [this, thread_number, done]() {
+        RCPPUTILS_SCOPE_EXIT(done->store(true); );
+        this->run(thread_number);
+      });
+    elastic_threads.push_back({thread_number, done, std::move(thread)});
+    // The added thread needs some time to take work, so wait as long again before the next one
+    busy_since = now;
+  }
+
+  for (auto & elastic_thread : elastic_threads) {
+    elastic_thread.thread.join();
+  }
+}
+
+void
+MultiThreadedExecutor::record_thread_pool_size(size_t number_of_running_threads)
+{
+  if (statistics_) {
+    statistics_->record_thread_pool_size(number_of_running_threads + dedicated_executors_.size());
+  }
+}
+
+void
+MultiThreadedExecutor::run_dedicated(
+  size_t this_thread_number,
+  rclcpp::executors::SingleThreadedExecutor::SharedPtr executor)
+{
+  apply_attributes_to_thread(this_thread_number);
+  if (rclcpp::callback_attribution::is_enabled()) {
+    rclcpp::callback_attribution::set_thread_name(
+      "rclcpp_exec_" + std::to_string(this_thread_number));
+  }
+  // A wait interrupted before it started returns at once, as the guard condition stays
+  // triggered, whereas a call to cancel() before spin() would be lost.
+  while (rclcpp::ok(this->context_) && spinning.load()) {
+    executor->spin_once();
+  }
+}
+
 void
 MultiThreadedExecutor::run(size_t this_thread_number)
 {
-  (void)this_thread_number;
+  apply_attributes_to_thread(this_thread_number);
+  if (rclcpp::callback_attribution::is_enabled()) {
+    rclcpp::callback_attribution::set_thread_name(
+      "rclcpp_exec_" + std::to_string(this_thread_number));
+  }
+  record_thread_pool_size(number_of_running_threads_.fetch_add(1u) + 1u);
+  RCPPUTILS_SCOPE_EXIT(record_thread_pool_size(number_of_running_threads_.fetch_sub(1u) - 1u); );
+
+  // The threads added to an elastic pool exit once idle, so they must not wait for too long
+  const bool exit_when_idle = this_thread_number >= number_of_threads_;
+  std::chrono::nanoseconds timeout = next_exec_timeout_;
+  if (max_number_of_threads_ > 0 &&
+    (timeout < std::chrono::nanoseconds::zero() || timeout > shrink_after_))
+  {
+    timeout = shrink_after_;
+  }
+  auto last_execution_time = std::chrono::steady_clock::now();
   while (rclcpp::ok(this->context_) && spinning.load()) {
     rclcpp::AnyExecutable any_exec;
     {
@@ -89,7 +319,12 @@ MultiThreadedExecutor::run(size_t this_thread_number)
       if (!rclcpp::ok(this->context_) || !spinning.load()) {
         return;
       }
-      if (!get_next_executable(any_exec, next_exec_timeout_)) {
+      if (!get_next_executable(any_exec, timeout)) {
+        if (exit_when_idle &&
+          std::chrono::steady_clock::now() - last_execution_time >= shrink_after_)
+        {
+          return;
+        }
         continue;
       }
     }
@@ -97,7 +332,12 @@ MultiThreadedExecutor::run(size_t this_thread_number)
       std::this_thread::yield();
     }
 
+    number_of_busy_threads_++;
     execute_any_executable(any_exec);
+    number_of_busy_threads_--;
+    if (exit_when_idle) {
+      last_execution_time = std::chrono::steady_clock::now();
+    }
 
     // Clear the callback_group to prevent the AnyExecutable destructor from
     // resetting the callback group `can_be_taken_from`
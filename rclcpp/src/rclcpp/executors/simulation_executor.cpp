@@ -0,0 +1,105 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp/executors/simulation_executor.hpp"
+
+#include <chrono>
+#include <optional>  // NOLINT
+#include <stdexcept>
+#include <utility>
+
+#include "rcpputils/scope_exit.hpp"
+
+#include "rclcpp/any_executable.hpp"
+#include "rclcpp/utilities.hpp"
+
+using rclcpp::executors::SimulationExecutor;
+
+SimulationExecutor::SimulationExecutor(
+  rclcpp::Clock::SharedPtr clock,
+  const rclcpp::ExecutorOptions & options)
+: SingleThreadedExecutor(options), clock_(std::move(clock))
+{
+  if (!clock_) {
+    throw std::invalid_argument("the clock of a simulation executor is null");
+  }
+}
+
+SimulationExecutor::~SimulationExecutor() {}
+
+void
+SimulationExecutor::set_idle_callback(IdleCallback callback)
+{
+  std::lock_guard<std::mutex> lock(idle_callback_mutex_);
+  idle_callback_ = std::move(callback);
+}
+
+void
+SimulationExecutor::spin()
+{
+  if (spinning.exchange(true)) {
+    throw std::runtime_error("spin() called while already spinning");
+  }
+  RCPPUTILS_SCOPE_EXIT(this->spinning.store(false); );
+
+  std::optional<rclcpp::Time> last_idle_time;
+  while (rclcpp::ok(this->context_) && spinning.load()) {
+    const rclcpp::Time idle_time = execute_until_idle();
+    if (!rclcpp::ok(this->context_) || !spinning.load()) {
+      return;
+    }
+    if (!last_idle_time || idle_time != *last_idle_time) {
+      last_idle_time = idle_time;
+      std::lock_guard<std::mutex> lock(idle_callback_mutex_);
+      if (idle_callback_) {
+        idle_callback_(idle_time);
+      }
+    }
+
+    // Block until more work is ready, typically when the simulation advances the time.
+    rclcpp::AnyExecutable any_executable;
+    if (get_next_executable(any_executable)) {
+      execute_any_executable(any_executable);
+    }
+  }
+}
+
+rclcpp::Time
+SimulationExecutor::spin_until_idle()
+{
+  if (spinning.exchange(true)) {
+    throw std::runtime_error("spin_until_idle() called while already spinning");
+  }
+  RCPPUTILS_SCOPE_EXIT(this->spinning.store(false); );
+  return execute_until_idle();
+}
+
+rclcpp::Time
+SimulationExecutor::execute_until_idle()
+{
+  while (rclcpp::ok(this->context_) && spinning.load()) {
+    const rclcpp::Time time = clock_->now();
+    rclcpp::AnyExecutable any_executable;
+    if (get_next_executable(any_executable, std::chrono::nanoseconds::zero())) {
+      execute_any_executable(any_executable);
+      continue;
+    }
+    // The timers due at a time set during the check may not have been seen ready yet.
+    if (clock_->now() == time) {
+      return time;
+    }
+  }
+  return clock_->now();
+}
@@ -179,7 +179,7 @@ StaticExecutorEntitiesCollector::fill_executable_list_from_map(
   for (const auto & pair : weak_groups_to_nodes) {
     auto group = pair.first.lock();
     auto node = pair.second.lock();
-    if (!node || !group || !group->can_be_taken_from().load()) {
+    if (!node || !group || !group->can_be_taken_from().load() || !group->is_enabled()) {
       continue;
     }
     group->find_timer_ptrs_if(
@@ -0,0 +1,281 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/executors/static_multi_threaded_executor.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "rcpputils/scope_exit.hpp"
+
+#include "rclcpp/utilities.hpp"
+
+using rclcpp::executors::StaticMultiThreadedExecutor;
+
+StaticMultiThreadedExecutor::StaticMultiThreadedExecutor(
+  const rclcpp::ExecutorOptions & options,
+  size_t number_of_threads)
+: StaticSingleThreadedExecutor(options)
+{
+  number_of_threads_ = number_of_threads > 0 ?
+    number_of_threads :
+    std::max(std::thread::hardware_concurrency(), 2U);
+}
+
+StaticMultiThreadedExecutor::~StaticMultiThreadedExecutor() {}
+
+void
+StaticMultiThreadedExecutor::spin()
+{
+  if (spinning.exchange(true)) {
+    throw std::runtime_error("spin() called while already spinning");
+  }
+  RCPPUTILS_SCOPE_EXIT(this->spinning.store(false); );
+
+  // Set memory_strategy_ and exec_list_ based on weak_nodes_
+  // Prepare wait_set_ based on memory_strategy_
+  entities_collector_->init(&wait_set_, memory_strategy_);
+  update_entity_groups();
+
+  {
+    std::lock_guard<std::mutex> lock{work_mutex_};
+    workers_running_ = true;
+  }
+  // The thread calling spin() executes work too.
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < number_of_threads_; ++i) {
+    threads.emplace_back([this]() {run();});
+  }
+  RCPPUTILS_SCOPE_EXIT(
+  {
+    {
+      std::lock_guard<std::mutex> lock{this->work_mutex_};
+      this->workers_running_ = false;
+      this->work_queue_.clear();
+      this->outstanding_work_ = 0;
+    }
+    this->work_available_cv_.notify_all();
+    for (auto & thread : threads) {
+      thread.join();
+    }
+  });
+
+  while (rclcpp::ok(this->context_) && spinning.load()) {
+    entities_collector_->refresh_wait_set();
+    const bool entities_changed = dispatch_ready_executables();
+    // The ready entities must have been executed before waiting again,
+    // otherwise the ones not taken yet would be found ready once more.
+    execute_work_until_done();
+    if (entities_changed) {
+      auto data = entities_collector_->take_data();
+      entities_collector_->execute(data);
+      update_entity_groups();
+    }
+  }
+}
+
+size_t
+StaticMultiThreadedExecutor::get_number_of_threads()
+{
+  return number_of_threads_;
+}
+
+bool
+StaticMultiThreadedExecutor::dispatch_ready_executables()
+{
+  bool entities_changed = false;
+
+  for (size_t i = 0; i < wait_set_.size_of_subscriptions; ++i) {
+    if (i < entities_collector_->get_number_of_subscriptions() && wait_set_.subscriptions[i]) {
+      auto subscription = entities_collector_->get_subscription(i);
+      add_work(
+        subscription.get(), [subscription]() {execute_subscription(subscription);});
+    }
+  }
+  for (size_t i = 0; i < wait_set_.size_of_timers; ++i) {
+    if (i < entities_collector_->get_number_of_timers() && wait_set_.timers[i]) {
+      auto timer = entities_collector_->get_timer(i);
+      // Called here, so the timer is not found ready again by the next wait.
+      if (timer->is_ready() && timer->call()) {
+        add_work(timer.get(), [timer]() {execute_timer(timer);});
+      }
+    }
+  }
+  for (size_t i = 0; i < wait_set_.size_of_services; ++i) {
+    if (i < entities_collector_->get_number_of_services() && wait_set_.services[i]) {
+      auto service = entities_collector_->get_service(i);
+      add_work(service.get(), [service]() {execute_service(service);});
+    }
+  }
+  for (size_t i = 0; i < wait_set_.size_of_clients; ++i) {
+    if (i < entities_collector_->get_number_of_clients() && wait_set_.clients[i]) {
+      auto client = entities_collector_->get_client(i);
+      add_work(client.get(), [client]() {execute_client(client);});
+    }
+  }
+  for (size_t i = 0; i < entities_collector_->get_number_of_waitables(); ++i) {
+    auto waitable = entities_collector_->get_waitable(i);
+    if (!waitable->is_ready(&wait_set_)) {
+      continue;
+    }
+    if (waitable == entities_collector_) {
+      // Executed once the other work is done, as it rebuilds the entities.
+      entities_changed = true;
+      continue;
+    }
+    auto data = waitable->take_data();
+    add_work(
+      waitable.get(), [waitable, data]() mutable {waitable->execute(data);});
+  }
+
+  // The work of each mutually exclusive group is executed sequentially.
+  std::vector<Work> work_to_queue;
+  for (auto & pair : exclusive_work_) {
+    if (pair.second.empty()) {
+      continue;
+    }
+    if (pair.second.size() == 1) {
+      work_to_queue.push_back(std::move(pair.second.front()));
+    } else {
+      work_to_queue.push_back(
+        [group_work = std::move(pair.second)]() {
+          for (const auto & work : group_work) {
+            work();
+          }
+        });
+    }
+    pair.second.clear();
+  }
+  if (!work_to_queue.empty()) {
+    {
+      std::lock_guard<std::mutex> lock{work_mutex_};
+      for (auto & work : work_to_queue) {
+        work_queue_.push_back(std::move(work));
+        outstanding_work_++;
+      }
+    }
+    work_available_cv_.notify_all();
+  }
+
+  return entities_changed;
+}
+
+void
+StaticMultiThreadedExecutor::execute_work_until_done()
+{
+  Work work;
+  while (take_work(work, false)) {
+    work();
+    work = nullptr;
+    std::lock_guard<std::mutex> lock{work_mutex_};
+    outstanding_work_--;
+  }
+
+  std::unique_lock<std::mutex> lock{work_mutex_};
+  work_done_cv_.wait(lock, [this]() {return outstanding_work_ == 0 || !workers_running_;});
+}
+
+void
+StaticMultiThreadedExecutor::run()
+{
+  Work work;
+  while (take_work(work, true)) {
+    work();
+    work = nullptr;
+    bool done;
+    {
+      std::lock_guard<std::mutex> lock{work_mutex_};
+      done = --outstanding_work_ == 0;
+    }
+    if (done) {
+      work_done_cv_.notify_all();
+    }
+  }
+}
+
+void
+StaticMultiThreadedExecutor::update_entity_groups()
+{
+  entity_groups_.clear();
+  exclusive_work_.clear();
+  for (const auto & weak_group : entities_collector_->get_all_callback_groups()) {
+    auto group = weak_group.lock();
+    if (!group) {
+      continue;
+    }
+    auto add_entity = [this, &weak_group](const void * entity) {
+        entity_groups_[entity] = weak_group;
+        return false;
+      };
+    group->find_subscription_ptrs_if(
+      [&add_entity](const rclcpp::SubscriptionBase::SharedPtr & subscription) {
+        return add_entity(subscription.get());
+      });
+    group->find_timer_ptrs_if(
+      [&add_entity](const rclcpp::TimerBase::SharedPtr & timer) {
+        return add_entity(timer.get());
+      });
+    group->find_service_ptrs_if(
+      [&add_entity](const rclcpp::ServiceBase::SharedPtr & service) {
+        return add_entity(service.get());
+      });
+    group->find_client_ptrs_if(
+      [&add_entity](const rclcpp::ClientBase::SharedPtr & client) {
+        return add_entity(client.get());
+      });
+    group->find_waitable_ptrs_if(
+      [&add_entity](const rclcpp::Waitable::SharedPtr & waitable) {
+        return add_entity(waitable.get());
+      });
+  }
+}
+
+void
+StaticMultiThreadedExecutor::add_work(const void * entity, Work work)
+{
+  rclcpp::CallbackGroup::SharedPtr group;
+  auto it = entity_groups_.find(entity);
+  if (it != entity_groups_.end()) {
+    group = it->second.lock();
+  }
+  if (group && group->type() == rclcpp::CallbackGroupType::MutuallyExclusive) {
+    exclusive_work_[group.get()].push_back(std::move(work));
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock{work_mutex_};
+    work_queue_.push_back(std::move(work));
+    outstanding_work_++;
+  }
+  work_available_cv_.notify_one();
+}
+
+bool
+StaticMultiThreadedExecutor::take_work(Work & work, bool wait)
+{
+  std::unique_lock<std::mutex> lock{work_mutex_};
+  if (wait) {
+    work_available_cv_.wait(lock, [this]() {return !work_queue_.empty() || !workers_running_;});
+  }
+  if (!workers_running_ || work_queue_.empty()) {
+    return false;
+  }
+  work = std::move(work_queue_.front());
+  work_queue_.pop_front();
+  return true;
+}
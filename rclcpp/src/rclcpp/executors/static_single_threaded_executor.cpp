@@ -21,12 +21,16 @@
 
 #include "rcpputils/scope_exit.hpp"
 
+#include "rclcpp/thread_attributes.hpp"
+
 using rclcpp::executors::StaticSingleThreadedExecutor;
 using rclcpp::experimental::ExecutableList;
 
 StaticSingleThreadedExecutor::StaticSingleThreadedExecutor(
   const rclcpp::ExecutorOptions & options)
-: rclcpp::Executor(options)
+: rclcpp::Executor(options),
+  busy_polling_duration_(options.busy_polling_duration),
+  thread_attributes_(options.thread_attributes)
 {
   entities_collector_ = std::make_shared<StaticExecutorEntitiesCollector>();
 }
@@ -50,6 +54,24 @@ StaticSingleThreadedExecutor::spin()
   // Prepare wait_set_ based on memory_strategy_
   entities_collector_->init(&wait_set_, memory_strategy_);
 
+  if (busy_polling_duration_ > std::chrono::nanoseconds::zero()) {
+    if (!thread_attributes_.empty()) {
+      rclcpp::apply_thread_attributes(thread_attributes_.front());
+    }
+    auto last_work_time = std::chrono::steady_clock::now();
+    while (rclcpp::ok(this->context_) && spinning.load()) {
+      // Poll while work came in recently, and block again once idle for long enough
+      const bool polling =
+        std::chrono::steady_clock::now() - last_work_time < busy_polling_duration_;
+      entities_collector_->refresh_wait_set(
+        polling ? std::chrono::nanoseconds::zero() : std::chrono::nanoseconds(-1));
+      if (execute_ready_executables()) {
+        last_work_time = std::chrono::steady_clock::now();
+      }
+    }
+    return;
+  }
+
   while (rclcpp::ok(this->context_) && spinning.load()) {
     // Refresh wait set and wait for work
     entities_collector_->refresh_wait_set();
@@ -231,7 +253,10 @@ StaticSingleThreadedExecutor::execute_ready_executables(bool spin_once)
     if (i < entities_collector_->get_number_of_timers()) {
       if (wait_set_.timers[i] && entities_collector_->get_timer(i)->is_ready()) {
         auto timer = entities_collector_->get_timer(i);
-        timer->call();
+        if (!timer->call()) {
+          // Canceled, or skipped because of missed periods.
+          continue;
+        }
         execute_timer(std::move(timer));
         if (spin_once) {
           return true;
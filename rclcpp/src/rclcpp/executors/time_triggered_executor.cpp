@@ -0,0 +1,223 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp/executors/time_triggered_executor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "rcpputils/scope_exit.hpp"
+
+using rclcpp::executors::TimeTriggeredExecutor;
+
+TimeTriggeredExecutor::TimeTriggeredExecutor(
+  std::chrono::nanoseconds cycle_period,
+  const rclcpp::ExecutorOptions & options)
+: StaticSingleThreadedExecutor(options), cycle_period_(cycle_period)
+{
+  if (cycle_period <= std::chrono::nanoseconds::zero()) {
+    throw std::invalid_argument("the cycle period of a time-triggered executor must be positive");
+  }
+}
+
+TimeTriggeredExecutor::~TimeTriggeredExecutor() {}
+
+void
+TimeTriggeredExecutor::add_slot(
+  rclcpp::CallbackGroup::SharedPtr group,
+  std::chrono::nanoseconds offset)
+{
+  if (!group) {
+    throw std::invalid_argument("the callback group of a slot is null");
+  }
+  if (offset < std::chrono::nanoseconds::zero() || offset >= cycle_period_) {
+    throw std::invalid_argument("the offset of a slot must be within the cycle period");
+  }
+  if (spinning.load()) {
+    throw std::runtime_error("add_slot() called while spinning");
+  }
+  std::lock_guard<std::mutex> lock(schedule_mutex_);
+  // The slots with the same offset are kept in the order they were added.
+  auto it = std::upper_bound(
+    slots_.begin(), slots_.end(), offset,
+    [](std::chrono::nanoseconds slot_offset, const Slot & slot) {
+      return slot_offset < slot.offset;
+    });
+  slots_.insert(it, Slot{group, offset});
+}
+
+void
+TimeTriggeredExecutor::set_overrun_callback(OverrunCallback callback)
+{
+  std::lock_guard<std::mutex> lock(schedule_mutex_);
+  overrun_callback_ = std::move(callback);
+}
+
+uint64_t
+TimeTriggeredExecutor::get_number_of_overruns() const
+{
+  return number_of_overruns_.load();
+}
+
+void
+TimeTriggeredExecutor::spin()
+{
+  if (spinning.exchange(true)) {
+    throw std::runtime_error("spin() called while already spinning");
+  }
+  RCPPUTILS_SCOPE_EXIT(this->spinning.store(false); );
+  spin_schedule(0u);
+}
+
+void
+TimeTriggeredExecutor::spin_cycles(uint64_t number_of_cycles)
+{
+  if (spinning.exchange(true)) {
+    throw std::runtime_error("spin_cycles() called while already spinning");
+  }
+  RCPPUTILS_SCOPE_EXIT(this->spinning.store(false); );
+  if (number_of_cycles > 0u) {
+    spin_schedule(number_of_cycles);
+  }
+}
+
+void
+TimeTriggeredExecutor::spin_schedule(uint64_t number_of_cycles)
+{
+  if (!entities_collector_->is_init()) {
+    entities_collector_->init(&wait_set_, memory_strategy_);
+  }
+
+  std::vector<Slot> slots;
+  {
+    std::lock_guard<std::mutex> lock(schedule_mutex_);
+    slots = slots_;
+  }
+
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now();
+  uint64_t cycle = 0u;
+  // Sleep until a deadline, returning false if the executor should stop.
+  auto sleep_until = [this](Clock::time_point deadline) {
+      const auto now = Clock::now();
+      if (deadline > now) {
+        context_->sleep_for(deadline - now);
+      }
+      return rclcpp::ok(context_) && spinning.load();
+    };
+
+  while (rclcpp::ok(context_) && spinning.load()) {
+    const auto cycle_start = start + static_cast<int64_t>(cycle) * cycle_period_;
+
+    // Entities added to or removed from the nodes are collected at the start of each cycle.
+    entities_collector_->refresh_wait_set(std::chrono::nanoseconds::zero());
+    if (entities_collector_->is_ready(&wait_set_)) {
+      auto data = entities_collector_->take_data();
+      entities_collector_->execute(data);
+    }
+
+    for (size_t i = 0; i < slots.size(); ++i) {
+      if (!sleep_until(cycle_start + slots[i].offset)) {
+        return;
+      }
+      execute_slot(slots[i]);
+
+      const auto slot_end = i + 1 < slots.size() ?
+        cycle_start + slots[i + 1].offset : cycle_start + cycle_period_;
+      const auto now = Clock::now();
+      if (now > slot_end) {
+        report_overrun(i, cycle, now - slot_end);
+      }
+    }
+
+    if (number_of_cycles != 0u && cycle + 1u >= number_of_cycles) {
+      return;
+    }
+    // The cycles which were entirely missed by an overrun are skipped.
+    const auto next_cycle = static_cast<uint64_t>((Clock::now() - start) / cycle_period_);
+    cycle = std::max(cycle + 1u, next_cycle);
+    if (number_of_cycles != 0u && cycle >= number_of_cycles) {
+      return;
+    }
+    if (!sleep_until(start + static_cast<int64_t>(cycle) * cycle_period_)) {
+      return;
+    }
+  }
+}
+
+void
+TimeTriggeredExecutor::execute_slot(const Slot & slot)
+{
+  auto group = slot.group.lock();
+  if (!group) {
+    return;
+  }
+  auto entities = group->get_entities();
+
+  // The subscriptions, services and clients which have nothing to take don't execute.
+  for (const auto & weak_subscription : entities->subscriptions) {
+    if (auto subscription = weak_subscription.lock()) {
+      execute_subscription(std::move(subscription));
+    }
+  }
+  for (const auto & weak_timer : entities->timers) {
+    auto timer = weak_timer.lock();
+    if (timer && timer->is_ready() && timer->call()) {
+      execute_timer(std::move(timer));
+    }
+  }
+  for (const auto & weak_service : entities->services) {
+    if (auto service = weak_service.lock()) {
+      execute_service(std::move(service));
+    }
+  }
+  for (const auto & weak_client : entities->clients) {
+    if (auto client = weak_client.lock()) {
+      execute_client(std::move(client));
+    }
+  }
+  if (entities->waitables.empty()) {
+    return;
+  }
+  // The waitables are only ready in the wait set, which is refreshed without blocking.
+  entities_collector_->refresh_wait_set(std::chrono::nanoseconds::zero());
+  for (const auto & weak_waitable : entities->waitables) {
+    auto waitable = weak_waitable.lock();
+    if (waitable && waitable->is_ready(&wait_set_)) {
+      auto data = waitable->take_data();
+      waitable->execute(data);
+    }
+  }
+}
+
+void
+TimeTriggeredExecutor::report_overrun(
+  size_t slot, uint64_t cycle, std::chrono::nanoseconds lateness)
+{
+  ++number_of_overruns_;
+  OverrunCallback callback;
+  {
+    std::lock_guard<std::mutex> lock(schedule_mutex_);
+    callback = overrun_callback_;
+  }
+  if (callback) {
+    callback(Overrun{slot, cycle, lateness});
+  }
+}
@@ -0,0 +1,182 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/executors/work_stealing_multi_threaded_executor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "rcpputils/scope_exit.hpp"
+
+#include "rclcpp/utilities.hpp"
+
+using rclcpp::executors::WorkStealingMultiThreadedExecutor;
+
+WorkStealingMultiThreadedExecutor::WorkStealingMultiThreadedExecutor(
+  const rclcpp::ExecutorOptions & options,
+  size_t number_of_threads,
+  std::chrono::nanoseconds next_exec_timeout)
+: rclcpp::Executor(options),
+  next_exec_timeout_(next_exec_timeout)
+{
+  number_of_threads_ = number_of_threads > 0 ?
+    number_of_threads :
+    std::max(std::thread::hardware_concurrency(), 2U);
+
+  for (size_t i = 0; i < number_of_threads_; ++i) {
+    run_queues_.emplace_back(std::make_unique<RunQueue>());
+  }
+}
+
+WorkStealingMultiThreadedExecutor::~WorkStealingMultiThreadedExecutor() {}
+
+void
+WorkStealingMultiThreadedExecutor::spin()
+{
+  if (spinning.exchange(true)) {
+    throw std::runtime_error("spin() called while already spinning");
+  }
+  RCPPUTILS_SCOPE_EXIT(this->spinning.store(false); );
+
+  workers_running_.store(true);
+  std::vector<std::thread> threads;
+  for (size_t thread_id = 0; thread_id < number_of_threads_; ++thread_id) {
+    auto func = std::bind(&WorkStealingMultiThreadedExecutor::run, this, thread_id);
+    threads.emplace_back(func);
+  }
+  RCPPUTILS_SCOPE_EXIT(
+  {
+    {
+      std::lock_guard<std::mutex> idle_lock{this->idle_mutex_};
+      this->workers_running_.store(false);
+    }
+    this->work_available_cv_.notify_all();
+    for (auto & thread : threads) {
+      thread.join();
+    }
+    // Discarding the work left releases the callback groups it was taken from.
+    for (auto & run_queue : this->run_queues_) {
+      run_queue->executables.clear();
+    }
+    this->pending_work_.store(0);
+  });
+
+  dispatch();
+}
+
+void
+WorkStealingMultiThreadedExecutor::cancel()
+{
+  rclcpp::Executor::cancel();
+  {
+    // Synchronize with the dispatching thread checking spinning before it goes to sleep.
+    std::lock_guard<std::mutex> idle_lock{idle_mutex_};
+  }
+  work_taken_cv_.notify_all();
+}
+
+size_t
+WorkStealingMultiThreadedExecutor::get_number_of_threads()
+{
+  return number_of_threads_;
+}
+
+void
+WorkStealingMultiThreadedExecutor::dispatch()
+{
+  while (rclcpp::ok(this->context_) && spinning.load()) {
+    auto any_exec = std::make_shared<rclcpp::AnyExecutable>();
+    if (!get_next_ready_executable(*any_exec)) {
+      // Wait for the dispatched work to be taken before waiting again, otherwise the entities
+      // which have not been executed yet would still be ready and dispatched once more.
+      {
+        std::unique_lock<std::mutex> idle_lock{idle_mutex_};
+        work_taken_cv_.wait(
+          idle_lock, [this]() {
+            return pending_work_.load() == 0 || !spinning.load();
+          });
+      }
+      wait_for_work(next_exec_timeout_);
+      continue;
+    }
+
+    // Counted before being pushed, so it can't be decremented by a worker first.
+    pending_work_++;
+    auto & run_queue = *run_queues_[next_run_queue_];
+    next_run_queue_ = (next_run_queue_ + 1) % run_queues_.size();
+    {
+      std::lock_guard<std::mutex> queue_lock{run_queue.mutex};
+      run_queue.executables.push_back(std::move(any_exec));
+    }
+    {
+      // Synchronize with a worker checking for pending work before it goes to sleep.
+      std::lock_guard<std::mutex> idle_lock{idle_mutex_};
+    }
+    work_available_cv_.notify_one();
+  }
+}
+
+void
+WorkStealingMultiThreadedExecutor::run(size_t this_thread_number)
+{
+  while (workers_running_.load()) {
+    auto any_exec = take_work(this_thread_number);
+    if (!any_exec) {
+      std::unique_lock<std::mutex> idle_lock{idle_mutex_};
+      work_available_cv_.wait(
+        idle_lock, [this]() {
+          return pending_work_.load() > 0 || !workers_running_.load();
+        });
+      continue;
+    }
+
+    execute_any_executable(*any_exec);
+
+    // Clear the callback_group to prevent the AnyExecutable destructor from
+    // resetting the callback group `can_be_taken_from`
+    any_exec->callback_group.reset();
+  }
+}
+
+WorkStealingMultiThreadedExecutor::AnyExecutableSharedPtr
+WorkStealingMultiThreadedExecutor::take_work(size_t this_thread_number)
+{
+  AnyExecutableSharedPtr any_exec;
+  for (size_t i = 0; i < run_queues_.size() && !any_exec; ++i) {
+    auto & run_queue = *run_queues_[(this_thread_number + i) % run_queues_.size()];
+    std::lock_guard<std::mutex> queue_lock{run_queue.mutex};
+    if (run_queue.executables.empty()) {
+      continue;
+    }
+    if (i == 0) {
+      any_exec = std::move(run_queue.executables.front());
+      run_queue.executables.pop_front();
+    } else {
+      // Steal from the back, the end the owner is not working on.
+      any_exec = std::move(run_queue.executables.back());
+      run_queue.executables.pop_back();
+    }
+  }
+  if (any_exec && pending_work_.fetch_sub(1) == 1) {
+    {
+      std::lock_guard<std::mutex> idle_lock{idle_mutex_};
+    }
+    work_taken_cv_.notify_one();
+  }
+  return any_exec;
+}
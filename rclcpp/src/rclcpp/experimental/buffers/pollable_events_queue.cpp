@@ -0,0 +1,163 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/experimental/buffers/pollable_events_queue.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+#include <system_error>
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#include <unistd.h>
+#elif !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using rclcpp::experimental::buffers::PollableEventsQueue;
+
+namespace
+{
+
+[[noreturn]] void
+throw_from_errno(const char * what)
+{
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+}  // namespace
+
+PollableEventsQueue::PollableEventsQueue()
+{
+#if defined(__linux__)
+  read_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (read_fd_ < 0) {
+    throw_from_errno("failed to create the eventfd of a PollableEventsQueue");
+  }
+  write_fd_ = read_fd_;
+#elif !defined(_WIN32)
+  int fds[2];
+  if (pipe(fds) != 0) {
+    throw_from_errno("failed to create the pipe of a PollableEventsQueue");
+  }
+  read_fd_ = fds[0];
+  write_fd_ = fds[1];
+  for (int fd : fds) {
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  }
+#else
+  throw std::runtime_error("PollableEventsQueue is not supported on this platform");
+#endif
+}
+
+PollableEventsQueue::~PollableEventsQueue()
+{
+#if !defined(_WIN32)
+  close(read_fd_);
+  if (write_fd_ != read_fd_) {
+    close(write_fd_);
+  }
+#endif
+}
+
+void
+PollableEventsQueue::enqueue(const rclcpp::executors::ExecutorEvent & event)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (event_queue_.empty()) {
+      signal();
+    }
+    event_queue_.push(event);
+  }
+  events_queue_cv_.notify_one();
+}
+
+bool
+PollableEventsQueue::dequeue(
+  rclcpp::executors::ExecutorEvent & event,
+  std::chrono::nanoseconds timeout)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  auto has_data_predicate = [this]() {return !event_queue_.empty();};
+  if (timeout == std::chrono::nanoseconds::max()) {
+    // Avoid overflowing the clock arithmetic of wait_for.
+    events_queue_cv_.wait(lock, has_data_predicate);
+  } else if (!events_queue_cv_.wait_for(lock, timeout, has_data_predicate)) {
+    return false;
+  }
+
+  event = event_queue_.front();
+  event_queue_.pop();
+  if (event_queue_.empty()) {
+    clear_signal();
+  }
+  return true;
+}
+
+bool
+PollableEventsQueue::empty() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return event_queue_.empty();
+}
+
+size_t
+PollableEventsQueue::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return event_queue_.size();
+}
+
+int
+PollableEventsQueue::get_fd() const
+{
+  return read_fd_;
+}
+
+void
+PollableEventsQueue::signal()
+{
+#if !defined(_WIN32)
+  // Only written when the queue becomes non empty, so neither end can fill up.
+  uint64_t value = 1;
+  ssize_t ret;
+  do {
+    ret = write(write_fd_, &value, write_fd_ == read_fd_ ? sizeof(value) : 1);
+  } while (ret < 0 && errno == EINTR);
+  if (ret < 0) {
+    throw_from_errno("failed to signal the file descriptor of a PollableEventsQueue");
+  }
+#endif
+}
+
+void
+PollableEventsQueue::clear_signal()
+{
+#if !defined(_WIN32)
+  // Reading an eventfd resets it, and the pipe holds one byte at most.
+  uint64_t value;
+  ssize_t ret;
+  do {
+    ret = read(read_fd_, &value, read_fd_ == write_fd_ ? sizeof(value) : 1);
+  } while (ret < 0 && errno == EINTR);
+  if (ret < 0 && errno != EAGAIN) {
+    throw_from_errno("failed to clear the file descriptor of a PollableEventsQueue");
+  }
+#endif
+}
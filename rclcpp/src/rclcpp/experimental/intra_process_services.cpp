@@ -0,0 +1,251 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/experimental/intra_process_services.hpp"
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "rmw/impl/cpp/demangle.hpp"
+
+#include "rclcpp/detail/add_guard_condition_to_rcl_wait_set.hpp"
+#include "rclcpp/logging.hpp"
+
+using rclcpp::experimental::IntraProcessServiceQueue;
+using rclcpp::experimental::IntraProcessServices;
+
+namespace
+{
+
+// Written in the writer guid of the intra-process requests, followed by the id of the client.
+constexpr char kIntraProcessMarker[8] = {'r', 'c', 'l', 'c', 'p', 'p', 'I', 'P'};
+
+static_assert(
+  sizeof(kIntraProcessMarker) + sizeof(uint64_t) <= sizeof(rmw_request_id_t::writer_guid),
+  "the writer guid can't hold the intra-process client id");
+
+}  // namespace
+
+IntraProcessServiceQueue::IntraProcessServiceQueue(
+  rclcpp::Context::SharedPtr context,
+  Handler handler)
+: handler_(std::move(handler)), gc_(context)
+{}
+
+void
+IntraProcessServiceQueue::push(const rmw_request_id_t & request_id, std::shared_ptr<void> data)
+{
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    queue_.push_back({std::make_shared<rmw_request_id_t>(request_id), std::move(data)});
+  }
+  gc_.trigger();
+
+  std::lock_guard<std::recursive_mutex> lock(callback_mutex_);
+  if (on_ready_callback_) {
+    on_ready_callback_(1);
+  } else {
+    unread_count_++;
+  }
+}
+
+void
+IntraProcessServiceQueue::add_to_wait_set(rcl_wait_set_t * wait_set)
+{
+  rclcpp::detail::add_guard_condition_to_rcl_wait_set(*wait_set, gc_);
+}
+
+bool
+IntraProcessServiceQueue::is_ready(rcl_wait_set_t * wait_set)
+{
+  (void)wait_set;
+  std::lock_guard<std::mutex> lock(queue_mutex_);
+  return !queue_.empty();
+}
+
+std::shared_ptr<void>
+IntraProcessServiceQueue::take_data()
+{
+  std::lock_guard<std::mutex> lock(queue_mutex_);
+  if (queue_.empty()) {
+    return nullptr;
+  }
+  auto item = std::make_shared<Item>(std::move(queue_.front()));
+  queue_.pop_front();
+  if (!queue_.empty()) {
+    // The guard condition is only triggered once for all the items pushed before a wait.
+    gc_.trigger();
+  }
+  return item;
+}
+
+std::shared_ptr<void>
+IntraProcessServiceQueue::take_data_by_entity_id(size_t id)
+{
+  (void)id;
+  return take_data();
+}
+
+void
+IntraProcessServiceQueue::execute(std::shared_ptr<void> & data)
+{
+  if (!data) {
+    return;
+  }
+  auto item = std::static_pointer_cast<Item>(data);
+  handler_(std::move(item->request_id), std::move(item->data));
+}
+
+void
+IntraProcessServiceQueue::set_on_ready_callback(std::function<void(size_t, int)> callback)
+{
+  if (!callback) {
+    throw std::invalid_argument(
+            "The callback passed to set_on_ready_callback "
+            "is not callable.");
+  }
+
+  auto new_callback =
+    [callback, this](size_t number_of_events) {
+      try {
+        callback(number_of_events, static_cast<int>(EntityType::Queue));
+      } catch (const std::exception & exception) {
+        RCLCPP_ERROR_STREAM(
+          rclcpp::get_logger("rclcpp"),
+          "rclcpp::experimental::IntraProcessServiceQueue@" << this <<
+            " caught " << rmw::impl::cpp::demangle(exception) <<
+            " exception in user-provided callback for the 'on ready' callback: " <<
+            exception.what());
+      } catch (...) {
+        RCLCPP_ERROR_STREAM(
+          rclcpp::get_logger("rclcpp"),
+          "rclcpp::experimental::IntraProcessServiceQueue@" << this <<
+            " caught unhandled exception in user-provided callback " <<
+            "for the 'on ready' callback");
+      }
+    };
+
+  std::lock_guard<std::recursive_mutex> lock(callback_mutex_);
+  on_ready_callback_ = new_callback;
+
+  if (unread_count_ > 0) {
+    on_ready_callback_(unread_count_);
+    unread_count_ = 0;
+  }
+}
+
+void
+IntraProcessServiceQueue::clear_on_ready_callback()
+{
+  std::lock_guard<std::recursive_mutex> lock(callback_mutex_);
+  on_ready_callback_ = nullptr;
+}
+
+uint64_t
+IntraProcessServices::add_service(
+  const std::string & service_name,
+  const void * type_support,
+  IntraProcessServiceQueue::WeakPtr queue)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  const uint64_t id = next_id_++;
+  services_.emplace(service_name, ServiceInfo{id, type_support, std::move(queue)});
+  return id;
+}
+
+void
+IntraProcessServices::remove_service(uint64_t service_id)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = services_.begin(); it != services_.end(); ++it) {
+    if (it->second.id == service_id) {
+      services_.erase(it);
+      return;
+    }
+  }
+}
+
+IntraProcessServiceQueue::SharedPtr
+IntraProcessServices::get_service(
+  const std::string & service_name,
+  const void * type_support) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto range = services_.equal_range(service_name);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.type_support != type_support) {
+      continue;
+    }
+    auto queue = it->second.queue.lock();
+    if (queue) {
+      return queue;
+    }
+  }
+  return nullptr;
+}
+
+uint64_t
+IntraProcessServices::add_client(IntraProcessServiceQueue::WeakPtr queue)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  const uint64_t id = next_id_++;
+  clients_.emplace(id, std::move(queue));
+  return id;
+}
+
+void
+IntraProcessServices::remove_client(uint64_t client_id)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  clients_.erase(client_id);
+}
+
+IntraProcessServiceQueue::SharedPtr
+IntraProcessServices::get_client(uint64_t client_id) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = clients_.find(client_id);
+  if (it == clients_.end()) {
+    return nullptr;
+  }
+  return it->second.lock();
+}
+
+rmw_request_id_t
+IntraProcessServices::make_request_id(uint64_t client_id, int64_t sequence_number)
+{
+  rmw_request_id_t request_id{};
+  std::memcpy(request_id.writer_guid, kIntraProcessMarker, sizeof(kIntraProcessMarker));
+  std::memcpy(
+    request_id.writer_guid + sizeof(kIntraProcessMarker), &client_id, sizeof(client_id));
+  request_id.sequence_number = sequence_number;
+  return request_id;
+}
+
+bool
+IntraProcessServices::get_client_id(const rmw_request_id_t & request_id, uint64_t & client_id)
+{
+  // The sequence numbers of the intra-process requests are negative, unlike the middleware ones.
+  if (request_id.sequence_number >= 0 ||
+    std::memcmp(request_id.writer_guid, kIntraProcessMarker, sizeof(kIntraProcessMarker)) != 0)
+  {
+    return false;
+  }
+  std::memcpy(
+    &client_id, request_id.writer_guid + sizeof(kIntraProcessMarker), sizeof(client_id));
+  return true;
+}
@@ -0,0 +1,126 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp/experimental/shared_memory_transport.hpp"
+
+#ifdef __linux__
+#include <poll.h>
+#endif
+
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using rclcpp::experimental::SharedMemorySubscriptionBase;
+
+SharedMemorySubscriptionBase::SharedMemorySubscriptionBase(
+  rclcpp::Context::SharedPtr context,
+  const std::string & topic_name,
+  const std::string & type_name,
+  const SharedMemoryTransportOptions & options,
+  size_t max_message_size)
+: topic_name_(topic_name), buffer_(max_message_size)
+{
+#ifdef __linux__
+  auto topic = std::make_shared<rclcpp::detail::SharedMemoryTopic>(
+    rclcpp::detail::SharedMemoryTopic::get_segment_name(context->get_domain_id(), topic_name),
+    type_name, options.max_subscriptions, options.depth, max_message_size);
+  reader_ = std::make_unique<rclcpp::detail::SharedMemoryTopicReader>(std::move(topic));
+  waitable_ = std::make_shared<rclcpp::FileDescriptorWaitable>(
+    reader_->get_file_descriptor(),
+    [this](int, int) {
+      read_messages();
+    },
+    POLLIN, std::move(context));
+#else
+  (void)context;
+  (void)type_name;
+  (void)options;
+  throw std::runtime_error("shared memory subscriptions are only supported on Linux");
+#endif
+}
+
+SharedMemorySubscriptionBase::~SharedMemorySubscriptionBase()
+{
+  // The waitable watches the socket of the reader, so it's destroyed first.
+  waitable_.reset();
+  reader_.reset();
+}
+
+const std::string &
+SharedMemorySubscriptionBase::get_topic_name() const
+{
+  return topic_name_;
+}
+
+uint64_t
+SharedMemorySubscriptionBase::get_number_of_dropped_messages() const
+{
+  return number_of_dropped_messages_.load();
+}
+
+size_t
+SharedMemorySubscriptionBase::get_number_of_ready_guard_conditions()
+{
+  return waitable_->get_number_of_ready_guard_conditions();
+}
+
+void
+SharedMemorySubscriptionBase::add_to_wait_set(rcl_wait_set_t * wait_set)
+{
+  waitable_->add_to_wait_set(wait_set);
+}
+
+bool
+SharedMemorySubscriptionBase::is_ready(rcl_wait_set_t * wait_set)
+{
+  return waitable_->is_ready(wait_set);
+}
+
+std::shared_ptr<void>
+SharedMemorySubscriptionBase::take_data()
+{
+  return waitable_->take_data();
+}
+
+std::shared_ptr<void>
+SharedMemorySubscriptionBase::take_data_by_entity_id(size_t id)
+{
+  return waitable_->take_data_by_entity_id(id);
+}
+
+void
+SharedMemorySubscriptionBase::execute(std::shared_ptr<void> & data)
+{
+  waitable_->execute(data);
+}
+
+void
+SharedMemorySubscriptionBase::read_messages()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  // The notifications are cleared first, so that the messages written while reading
+  // notify the socket again.
+  reader_->clear_notifications();
+  auto & rcl_buffer = buffer_.get_rcl_serialized_message();
+  size_t size = 0;
+  while (reader_->read(rcl_buffer.buffer, size)) {
+    number_of_dropped_messages_ = reader_->get_number_of_dropped_messages();
+    rcl_buffer.buffer_length = size;
+    handle_message(buffer_);
+  }
+}
@@ -0,0 +1,358 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/experimental/timers_manager.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "rclcpp/utilities.hpp"
+
+using rclcpp::experimental::TimersManager;
+
+TimersManager::TimersManager(
+  rclcpp::Context::SharedPtr context,
+  std::function<void(const rclcpp::TimerBase *)> on_ready_callback)
+: context_(context), on_ready_callback_(std::move(on_ready_callback))
+{
+  if (!on_ready_callback_) {
+    throw std::invalid_argument("on_ready_callback must be callable");
+  }
+}
+
+TimersManager::~TimersManager()
+{
+  this->stop();
+  this->clear();
+}
+
+void
+TimersManager::add_timer(rclcpp::TimerBase::SharedPtr timer)
+{
+  if (!timer) {
+    throw std::invalid_argument("TimersManager::add_timer() trying to add nullptr timer");
+  }
+  {
+    std::lock_guard<std::mutex> lock(timers_mutex_);
+    auto it = timers_.find(timer.get());
+    if (it != timers_.end()) {
+      if (it->second.timer.lock() == timer) {
+        return;
+      }
+      // The address of a destroyed timer was reused, its entries are outdated.
+      timers_.erase(it);
+    }
+    TimerInfo info{timer, 0};
+    if (timer->is_steady()) {
+      push_heap_entry(timer, info, std::chrono::steady_clock::now());
+    } else {
+      unsteady_timers_.push_back({timer, timer.get(), Deadline::max(), 0});
+    }
+    timers_.emplace(timer.get(), std::move(info));
+    timers_updated_ = true;
+  }
+  const rclcpp::TimerBase * timer_key = timer.get();
+  timer->set_on_reset_callback([this, timer_key]() {this->on_timer_reset(timer_key);});
+  // Wake the monitoring thread, the new timer may be the closest one.
+  timers_cv_.notify_one();
+}
+
+void
+TimersManager::remove_timer(rclcpp::TimerBase::SharedPtr timer)
+{
+  bool removed = false;
+  {
+    std::lock_guard<std::mutex> lock(timers_mutex_);
+    auto it = timers_.find(timer.get());
+    if (it != timers_.end() && it->second.timer.lock() == timer) {
+      timers_.erase(it);
+      removed = true;
+    }
+    unsteady_timers_.erase(
+      std::remove_if(
+        unsteady_timers_.begin(), unsteady_timers_.end(),
+        [&timer](const HeapEntry & entry) {
+          auto shared_timer = entry.timer.lock();
+          return !shared_timer || shared_timer == timer;
+        }),
+      unsteady_timers_.end());
+    compact_heap();
+    timers_updated_ = true;
+  }
+  if (removed) {
+    timer->clear_on_reset_callback();
+  }
+  timers_cv_.notify_one();
+}
+
+void
+TimersManager::clear()
+{
+  std::vector<rclcpp::TimerBase::SharedPtr> timers;
+  {
+    std::lock_guard<std::mutex> lock(timers_mutex_);
+    timers = take_all_timers();
+    timers_updated_ = true;
+  }
+  // Not done while holding timers_mutex_, which the on reset callbacks lock.
+  for (const auto & timer : timers) {
+    timer->clear_on_reset_callback();
+  }
+  timers_cv_.notify_one();
+}
+
+void
+TimersManager::start()
+{
+  if (running_.load()) {
+    throw std::runtime_error("TimersManager::start() can't start timers thread as already running");
+  }
+  // The previous thread may have returned on its own because of shutdown.
+  if (timers_thread_.joinable()) {
+    timers_thread_.join();
+  }
+  running_ = true;
+  timers_thread_ = std::thread(&TimersManager::run_timers, this);
+}
+
+void
+TimersManager::stop()
+{
+  running_ = false;
+  {
+    std::lock_guard<std::mutex> lock(timers_mutex_);
+    timers_updated_ = true;
+  }
+  timers_cv_.notify_one();
+  if (timers_thread_.joinable()) {
+    timers_thread_.join();
+  }
+}
+
+size_t
+TimersManager::trigger_ready_timers()
+{
+  std::lock_guard<std::mutex> lock(timers_mutex_);
+  size_t ready_timers = 0;
+  trigger_ready_timers_unsafe(ready_timers);
+  return ready_timers;
+}
+
+std::chrono::nanoseconds
+TimersManager::get_head_timeout()
+{
+  std::lock_guard<std::mutex> lock(timers_mutex_);
+  return get_head_timeout_unsafe();
+}
+
+size_t
+TimersManager::size() const
+{
+  std::lock_guard<std::mutex> lock(timers_mutex_);
+  return timers_.size();
+}
+
+TimersManager::Deadline
+TimersManager::get_deadline(Deadline now, const rclcpp::TimerBase::SharedPtr & timer)
+{
+  const auto time_until_trigger = timer->time_until_trigger();
+  if (time_until_trigger == std::chrono::nanoseconds::max()) {
+    // Canceled timer.
+    return Deadline::max();
+  }
+  const auto slack = timer->get_slack();
+  if (slack > max_slack_) {
+    max_slack_ = slack;
+  }
+  return now + std::chrono::duration_cast<Deadline::duration>(time_until_trigger + slack);
+}
+
+void
+TimersManager::push_heap_entry(
+  const rclcpp::TimerBase::SharedPtr & timer, TimerInfo & info, Deadline now)
+{
+  info.generation = next_generation_++;
+  timers_heap_.push_back({timer, timer.get(), get_deadline(now, timer), info.generation});
+  std::push_heap(timers_heap_.begin(), timers_heap_.end(), std::greater<HeapEntry>());
+}
+
+void
+TimersManager::compact_heap()
+{
+  // Outdated entries are dropped once they reach the top of the heap, but the
+  // ones of canceled or removed timers may never do so.
+  if (timers_heap_.size() <= 2 * timers_.size() + 16) {
+    return;
+  }
+  timers_heap_.erase(
+    std::remove_if(
+      timers_heap_.begin(), timers_heap_.end(),
+      [this](const HeapEntry & entry) {
+        auto it = timers_.find(entry.timer_key);
+        return it == timers_.end() || it->second.generation != entry.generation;
+      }),
+    timers_heap_.end());
+  std::make_heap(timers_heap_.begin(), timers_heap_.end(), std::greater<HeapEntry>());
+}
+
+std::vector<rclcpp::TimerBase::SharedPtr>
+TimersManager::take_all_timers()
+{
+  std::vector<rclcpp::TimerBase::SharedPtr> timers;
+  timers.reserve(timers_.size());
+  for (const auto & pair : timers_) {
+    auto timer = pair.second.timer.lock();
+    if (timer) {
+      timers.push_back(std::move(timer));
+    }
+  }
+  timers_.clear();
+  timers_heap_.clear();
+  unsteady_timers_.clear();
+  return timers;
+}
+
+void
+TimersManager::on_timer_reset(const rclcpp::TimerBase * timer_key)
+{
+  {
+    std::lock_guard<std::mutex> lock(timers_mutex_);
+    auto it = timers_.find(timer_key);
+    // The timers not using a steady clock are checked every time anyway.
+    if (it == timers_.end() || it->second.generation == 0) {
+      return;
+    }
+    auto timer = it->second.timer.lock();
+    if (!timer) {
+      return;
+    }
+    // The previous deadline is outdated, it may have been the one of a canceled timer.
+    push_heap_entry(timer, it->second, std::chrono::steady_clock::now());
+    compact_heap();
+    timers_updated_ = true;
+  }
+  timers_cv_.notify_one();
+}
+
+std::chrono::nanoseconds
+TimersManager::trigger_ready_timers_unsafe(size_t & ready_timers)
+{
+  const auto now = std::chrono::steady_clock::now();
+  const std::greater<HeapEntry> later{};
+
+  // Only the timers whose deadline passed are checked, as well as the ones
+  // which may be notified early because of their slack.
+  const auto max_deadline = now + std::chrono::duration_cast<Deadline::duration>(max_slack_);
+  while (!timers_heap_.empty() && timers_heap_.front().deadline <= max_deadline) {
+    std::pop_heap(timers_heap_.begin(), timers_heap_.end(), later);
+    HeapEntry entry = std::move(timers_heap_.back());
+    timers_heap_.pop_back();
+    auto it = timers_.find(entry.timer_key);
+    if (it == timers_.end() || it->second.generation != entry.generation) {
+      // Outdated entry, the timer was removed or reset.
+      continue;
+    }
+    auto timer = entry.timer.lock();
+    if (!timer) {
+      timers_.erase(it);
+      continue;
+    }
+    // call() updates the last call time of the timer, so that it is notified once per period.
+    if (timer->is_ready() && timer->call()) {
+      on_ready_callback_(timer.get());
+      ++ready_timers;
+    }
+    // The deadline may also not have been reached yet, if it isn't exactly the one of rcl.
+    entry.deadline = get_deadline(now, timer);
+    due_timers_.push_back(std::move(entry));
+  }
+  for (auto & entry : due_timers_) {
+    timers_heap_.push_back(std::move(entry));
+    std::push_heap(timers_heap_.begin(), timers_heap_.end(), later);
+  }
+  due_timers_.clear();
+
+  for (auto it = unsteady_timers_.begin(); it != unsteady_timers_.end(); ) {
+    auto timer = it->timer.lock();
+    if (!timer) {
+      auto info = timers_.find(it->timer_key);
+      if (info != timers_.end() && info->second.timer.expired()) {
+        timers_.erase(info);
+      }
+      it = unsteady_timers_.erase(it);
+      continue;
+    }
+    if (timer->is_ready() && timer->call()) {
+      on_ready_callback_(timer.get());
+      ++ready_timers;
+    }
+    ++it;
+  }
+  return get_head_timeout_unsafe();
+}
+
+std::chrono::nanoseconds
+TimersManager::get_head_timeout_unsafe()
+{
+  const std::greater<HeapEntry> later{};
+  while (!timers_heap_.empty()) {
+    const HeapEntry & head = timers_heap_.front();
+    auto it = timers_.find(head.timer_key);
+    if (it != timers_.end() && it->second.generation == head.generation) {
+      break;
+    }
+    // The timer was removed or reset.
+    std::pop_heap(timers_heap_.begin(), timers_heap_.end(), later);
+    timers_heap_.pop_back();
+  }
+
+  auto head_timeout = std::chrono::nanoseconds::max();
+  if (!timers_heap_.empty() && timers_heap_.front().deadline != Deadline::max()) {
+    head_timeout = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      timers_heap_.front().deadline - std::chrono::steady_clock::now());
+  }
+  for (const auto & entry : unsteady_timers_) {
+    auto timer = entry.timer.lock();
+    if (timer) {
+      head_timeout = std::min(head_timeout, timer->time_until_trigger());
+    }
+  }
+  return head_timeout;
+}
+
+void
+TimersManager::run_timers()
+{
+  std::unique_lock<std::mutex> lock(timers_mutex_);
+  while (rclcpp::ok(context_) && running_) {
+    size_t ready_timers = 0;
+    auto time_to_sleep = trigger_ready_timers_unsafe(ready_timers);
+    timers_updated_ = false;
+
+    auto wake_up_predicate = [this]() {return timers_updated_ || !running_;};
+    if (time_to_sleep == std::chrono::nanoseconds::max()) {
+      // No timer can become ready, wait until the timers change.
+      timers_cv_.wait(lock, wake_up_predicate);
+    } else {
+      timers_cv_.wait_for(lock, time_to_sleep, wake_up_predicate);
+    }
+  }
+  // Make sure the thread can be started again after returning because of shutdown.
+  running_ = false;
+}
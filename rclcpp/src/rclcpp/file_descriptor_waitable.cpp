@@ -0,0 +1,306 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp/file_descriptor_waitable.hpp"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "rclcpp/detail/add_guard_condition_to_rcl_wait_set.hpp"
+
+using rclcpp::FileDescriptorWaitable;
+
+namespace rclcpp
+{
+namespace detail
+{
+
+#ifdef __linux__
+/// Thread triggering the guard conditions of file descriptors when they are ready.
+/**
+ * The file descriptors are watched with epoll, in one shot mode, so that each one only
+ * triggers its guard condition once per wait of its executor.
+ */
+class FileDescriptorWatcher
+{
+public:
+  /// Return the watcher of the process, creating it if there is none.
+  static
+  std::shared_ptr<FileDescriptorWatcher>
+  get_instance()
+  {
+    static std::mutex instance_mutex;
+    static std::weak_ptr<FileDescriptorWatcher> weak_instance;
+    std::lock_guard<std::mutex> lock(instance_mutex);
+    auto instance = weak_instance.lock();
+    if (!instance) {
+      instance = std::make_shared<FileDescriptorWatcher>();
+      weak_instance = instance;
+    }
+    return instance;
+  }
+
+  FileDescriptorWatcher()
+  {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+      throw std::system_error(errno, std::generic_category(), "failed to create epoll instance");
+    }
+    stop_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (stop_fd_ < 0) {
+      const int error = errno;
+      close(epoll_fd_);
+      throw std::system_error(error, std::generic_category(), "failed to create eventfd");
+    }
+    // The id 0 is the one of the eventfd stopping the thread.
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = 0u;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, stop_fd_, &event) != 0) {
+      const int error = errno;
+      close(stop_fd_);
+      close(epoll_fd_);
+      throw std::system_error(error, std::generic_category(), "failed to watch eventfd");
+    }
+    thread_ = std::thread([this]() {run();});
+  }
+
+  ~FileDescriptorWatcher()
+  {
+    const uint64_t value = 1u;
+    if (write(stop_fd_, &value, sizeof(value)) == sizeof(value)) {
+      thread_.join();
+    } else {
+      thread_.detach();
+    }
+    close(stop_fd_);
+    close(epoll_fd_);
+  }
+
+  /// Start watching a file descriptor, which isn't armed yet, and return its id.
+  uint64_t
+  add(int fd, std::weak_ptr<rclcpp::GuardCondition> guard_condition)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint64_t id = next_id_++;
+    epoll_event event{};
+    event.events = EPOLLONESHOT;
+    event.data.u64 = id;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+      throw std::system_error(errno, std::generic_category(), "failed to watch file descriptor");
+    }
+    guard_conditions_.emplace(id, std::move(guard_condition));
+    return id;
+  }
+
+  /// Trigger the guard condition of a file descriptor once, when it's ready.
+  void
+  arm(int fd, uint64_t id, int events)
+  {
+    epoll_event event{};
+    event.events = static_cast<uint32_t>(events) | EPOLLONESHOT;
+    event.data.u64 = id;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event) != 0) {
+      throw std::system_error(errno, std::generic_category(), "failed to watch file descriptor");
+    }
+  }
+
+  /// Stop watching a file descriptor.
+  void
+  remove(int fd, uint64_t id)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // This fails if the file descriptor was already closed, which also stopped watching it.
+    (void)epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    guard_conditions_.erase(id);
+  }
+
+private:
+  void
+  run()
+  {
+    constexpr int max_events = 16;
+    epoll_event events[max_events];
+    while (true) {
+      const int number_of_events = epoll_wait(epoll_fd_, events, max_events, -1);
+      if (number_of_events < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return;
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (int i = 0; i < number_of_events; ++i) {
+        if (0u == events[i].data.u64) {
+          return;
+        }
+        auto it = guard_conditions_.find(events[i].data.u64);
+        if (it == guard_conditions_.end()) {
+          continue;
+        }
+        auto guard_condition = it->second.lock();
+        if (!guard_condition) {
+          continue;
+        }
+        try {
+          guard_condition->trigger();
+        } catch (...) {
+          // The context of the guard condition was shut down, so nothing waits on it anymore.
+        }
+      }
+    }
+  }
+
+  int epoll_fd_ = -1;
+  int stop_fd_ = -1;
+  std::mutex mutex_;
+  std::unordered_map<uint64_t, std::weak_ptr<rclcpp::GuardCondition>> guard_conditions_;
+  uint64_t next_id_ = 1u;
+  std::thread thread_;
+};
+#else
+class FileDescriptorWatcher
+{
+};
+#endif
+
+}  // namespace detail
+}  // namespace rclcpp
+
+FileDescriptorWaitable::FileDescriptorWaitable(
+  int fd,
+  HandlerType handler,
+  int events,
+  rclcpp::Context::SharedPtr context)
+: fd_(fd), events_(events), handler_(std::move(handler))
+{
+  if (fd < 0) {
+    throw std::invalid_argument("the file descriptor of a waitable can't be negative");
+  }
+  if (!handler_) {
+    throw std::invalid_argument("the handler of a file descriptor waitable is empty");
+  }
+  if (0 == events) {
+    throw std::invalid_argument("a file descriptor waitable has to wait for events");
+  }
+#ifdef __linux__
+  gc_ = std::make_shared<rclcpp::GuardCondition>(context);
+  watcher_ = detail::FileDescriptorWatcher::get_instance();
+  watch_id_ = watcher_->add(fd_, gc_);
+#else
+  (void)context;
+  throw std::runtime_error("file descriptor waitables are only supported on Linux");
+#endif
+}
+
+FileDescriptorWaitable::~FileDescriptorWaitable()
+{
+#ifdef __linux__
+  watcher_->remove(fd_, watch_id_);
+#endif
+}
+
+int
+FileDescriptorWaitable::get_file_descriptor() const
+{
+  return fd_;
+}
+
+size_t
+FileDescriptorWaitable::get_number_of_ready_guard_conditions()
+{
+  return 1u;
+}
+
+void
+FileDescriptorWaitable::add_to_wait_set(rcl_wait_set_t * wait_set)
+{
+  rclcpp::detail::add_guard_condition_to_rcl_wait_set(*wait_set, *gc_);
+#ifdef __linux__
+  if (0 != poll_file_descriptor()) {
+    // The wait returns right away, without waking up the watcher thread
+    gc_->trigger();
+  } else {
+    watcher_->arm(fd_, watch_id_, events_);
+  }
+#endif
+}
+
+bool
+FileDescriptorWaitable::is_ready(rcl_wait_set_t * wait_set)
+{
+  (void)wait_set;
+  const int revents = poll_file_descriptor();
+  revents_.store(revents);
+  return 0 != revents;
+}
+
+std::shared_ptr<void>
+FileDescriptorWaitable::take_data()
+{
+  int revents = revents_.exchange(0);
+  if (0 == revents) {
+    revents = poll_file_descriptor();
+    if (0 == revents) {
+      return nullptr;
+    }
+  }
+  return std::make_shared<int>(revents);
+}
+
+std::shared_ptr<void>
+FileDescriptorWaitable::take_data_by_entity_id(size_t id)
+{
+  (void)id;
+  return take_data();
+}
+
+void
+FileDescriptorWaitable::execute(std::shared_ptr<void> & data)
+{
+  if (!data) {
+    return;
+  }
+  handler_(fd_, *std::static_pointer_cast<int>(data));
+}
+
+int
+FileDescriptorWaitable::poll_file_descriptor() const
+{
+#ifdef __linux__
+  pollfd poll_fd{};
+  poll_fd.fd = fd_;
+  poll_fd.events = static_cast<int16_t>(events_);
+  if (poll(&poll_fd, 1, 0) <= 0) {
+    return 0;
+  }
+  return poll_fd.revents;
+#else
+  return 0;
+#endif
+}
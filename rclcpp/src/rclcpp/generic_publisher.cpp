@@ -15,16 +15,92 @@
 
 #include "rclcpp/generic_publisher.hpp"
 
+#include <cstring>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <utility>
+
+#include "rclcpp/experimental/intra_process_manager.hpp"
 
 namespace rclcpp
 {
 
 void GenericPublisher::publish(const rclcpp::SerializedMessage & message)
+{
+  if (!intra_process_is_enabled_ || get_intra_process_subscription_count() == 0) {
+    do_inter_process_publish(message.get_rcl_serialized_message());
+    return;
+  }
+  publish(std::make_unique<rclcpp::SerializedMessage>(message));
+}
+
+void GenericPublisher::publish(const rcl_serialized_message_t & message)
+{
+  if (!intra_process_is_enabled_ || get_intra_process_subscription_count() == 0) {
+    do_inter_process_publish(message);
+    return;
+  }
+  // The buffer isn't owned, only its content is copied.
+  auto copy = std::make_unique<rclcpp::SerializedMessage>(message.buffer_length);
+  auto & rcl_copy = copy->get_rcl_serialized_message();
+  if (message.buffer_length > 0u) {
+    std::memcpy(rcl_copy.buffer, message.buffer, message.buffer_length);
+  }
+  rcl_copy.buffer_length = message.buffer_length;
+  publish(std::move(copy));
+}
+
+void GenericPublisher::publish(std::unique_ptr<rclcpp::SerializedMessage> message)
+{
+  if (!message) {
+    throw std::invalid_argument("cannot publish a null serialized message");
+  }
+  if (!intra_process_is_enabled_) {
+    do_inter_process_publish(message->get_rcl_serialized_message());
+    return;
+  }
+  auto ipm = weak_ipm_.lock();
+  if (!ipm) {
+    throw std::runtime_error(
+            "intra process publish called after destruction of intra process manager");
+  }
+  bool inter_process_publish_needed =
+    get_subscription_count() > get_intra_process_subscription_count();
+
+  std::shared_ptr<const rclcpp::SerializedMessage> shared_message = std::move(message);
+  ipm->do_serialized_intra_process_publish(intra_process_publisher_id_, shared_message);
+  intra_process_publish_counters_.record(shared_message->size());
+  if (inter_process_publish_needed) {
+    do_inter_process_publish(shared_message->get_rcl_serialized_message());
+  }
+}
+
+void GenericPublisher::setup_serialized_intra_process(
+  rclcpp::Context::SharedPtr context,
+  bool required)
+{
+  auto qos = get_actual_qos();
+  if (qos.history() != rclcpp::HistoryPolicy::KeepLast || qos.depth() == 0 ||
+    qos.durability() != rclcpp::DurabilityPolicy::Volatile)
+  {
+    if (!required) {
+      // Only the middleware is used, as it may be for instance a transient local recording.
+      return;
+    }
+    throw std::invalid_argument(
+            "intraprocess communication allowed only with keep last history qos policy, "
+            "a non zero history depth value and volatile durability");
+  }
+  auto ipm = rclcpp::experimental::get_intra_process_manager(*context);
+  uint64_t intra_process_publisher_id = ipm->add_publisher(shared_from_this(), true);
+  setup_intra_process(intra_process_publisher_id, ipm);
+}
+
+void GenericPublisher::do_inter_process_publish(const rcl_serialized_message_t & message)
 {
   auto return_code = rcl_publish_serialized_message(
-    get_publisher_handle().get(), &message.get_rcl_serialized_message(), NULL);
+    get_publisher_handle().get(), &message, NULL);
 
   if (return_code != RCL_RET_OK) {
     rclcpp::exceptions::throw_from_rcl_error(return_code, "failed to publish serialized message");
@@ -16,11 +16,15 @@
 #include "rclcpp/generic_subscription.hpp"
 
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <utility>
 
 #include "rcl/subscription.h"
 
 #include "rclcpp/exceptions.hpp"
+#include "rclcpp/experimental/intra_process_manager.hpp"
+#include "rclcpp/experimental/subscription_serialized_intra_process.hpp"
 
 namespace rclcpp
 {
@@ -32,6 +36,9 @@ std::shared_ptr<void> GenericSubscription::create_message()
 
 std::shared_ptr<rclcpp::SerializedMessage> GenericSubscription::create_serialized_message()
 {
+  if (serialized_message_pool_) {
+    return serialized_message_pool_->borrow_message();
+  }
   return std::make_shared<rclcpp::SerializedMessage>(0);
 }
 
@@ -46,9 +53,16 @@ void GenericSubscription::handle_message(
 void
 GenericSubscription::handle_serialized_message(
   const std::shared_ptr<rclcpp::SerializedMessage> & message,
-  const rclcpp::MessageInfo &)
+  const rclcpp::MessageInfo & message_info)
 {
-  callback_(message);
+  if (!serialized_message_fan_out_) {
+    callback_(message);
+    return;
+  }
+  auto shared_message = serialized_message_fan_out_->share(
+    get_topic_name(), message_info.get_rmw_message_info(), message);
+  // The message may be shared with the other subscriptions, which don't modify it either.
+  callback_(std::const_pointer_cast<rclcpp::SerializedMessage>(shared_message));
 }
 
 void GenericSubscription::handle_loaned_message(
@@ -63,13 +77,69 @@ void GenericSubscription::handle_loaned_message(
 void GenericSubscription::return_message(std::shared_ptr<void> & message)
 {
   auto typed_message = std::static_pointer_cast<rclcpp::SerializedMessage>(message);
+  message.reset();
   return_serialized_message(typed_message);
 }
 
 void GenericSubscription::return_serialized_message(
   std::shared_ptr<rclcpp::SerializedMessage> & message)
 {
+  if (serialized_message_pool_) {
+    serialized_message_pool_->return_message(message);
+    return;
+  }
   message.reset();
 }
 
+SerializedMessageField::SharedPtr
+GenericSubscription::create_field(const std::string & field_path) const
+{
+  // The introspection type support is loaded by the library of the subscription, which stays
+  // loaded for the process.
+  return std::make_shared<SerializedMessageField>(get_message_type_support_handle(), field_path);
+}
+
+void GenericSubscription::setup_serialized_intra_process(
+  rclcpp::Context::SharedPtr context,
+  const rclcpp::SubscriptionOptionsBase & options)
+{
+  auto qos = get_actual_qos();
+  if (qos.history() != rclcpp::HistoryPolicy::KeepLast || qos.depth() == 0 ||
+    qos.durability() != rclcpp::DurabilityPolicy::Volatile)
+  {
+    if (options.use_intra_process_comm != rclcpp::IntraProcessSetting::Enable) {
+      // Only the middleware is used, as it may be for instance a transient local recording.
+      return;
+    }
+    throw std::invalid_argument(
+            "intraprocess communication allowed only with keep last history qos policy, "
+            "a non zero history depth value and volatile durability");
+  }
+
+  using rclcpp::experimental::SubscriptionSerializedIntraProcess;
+  // The callback is copied, as the intra-process subscription may outlive this one.
+  auto callback = [callback = callback_](
+    SubscriptionSerializedIntraProcess::ConstMessageSharedPtr message) {
+      if (message.use_count() == 1) {
+        // Nobody else can get a reference to the message, so the callback may modify it.
+        callback(std::const_pointer_cast<rclcpp::SerializedMessage>(std::move(message)));
+        return;
+      }
+      // The message is shared with other intra-process subscriptions or the publisher, and
+      // the callback may modify it, so it's given a copy.
+      callback(std::make_shared<rclcpp::SerializedMessage>(*message));
+    };
+  subscription_intra_process_ = std::make_shared<SubscriptionSerializedIntraProcess>(
+    callback,
+    context,
+    get_topic_name(),
+    qos,
+    options.intra_process_buffer_implementation,
+    options.intra_process_buffer_max_depth);
+
+  auto ipm = rclcpp::experimental::get_intra_process_manager(*context);
+  uint64_t intra_process_subscription_id = ipm->add_subscription(subscription_intra_process_);
+  setup_intra_process(intra_process_subscription_id, ipm);
+}
+
 }  // namespace rclcpp
@@ -14,6 +14,8 @@
 
 #include "rclcpp/init_options.hpp"
 
+#include <stdexcept>
+
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/logging.hpp"
 
@@ -45,6 +47,11 @@ InitOptions::InitOptions(const InitOptions & other)
 {
   shutdown_on_signal = other.shutdown_on_signal;
   initialize_logging_ = other.initialize_logging_;
+  asynchronous_logging_ = other.asynchronous_logging_;
+  asynchronous_logging_queue_size_ = other.asynchronous_logging_queue_size_;
+  shutdown_callback_threads_ = other.shutdown_callback_threads_;
+  share_intra_process_manager_ = other.share_intra_process_manager_;
+  share_rosout_publisher_ = other.share_rosout_publisher_;
 }
 
 bool
@@ -60,6 +67,74 @@ InitOptions::auto_initialize_logging(bool initialize_logging)
   return *this;
 }
 
+bool
+InitOptions::asynchronous_logging() const
+{
+  return asynchronous_logging_;
+}
+
+InitOptions &
+InitOptions::asynchronous_logging(bool asynchronous_logging)
+{
+  asynchronous_logging_ = asynchronous_logging;
+  return *this;
+}
+
+size_t
+InitOptions::asynchronous_logging_queue_size() const
+{
+  return asynchronous_logging_queue_size_;
+}
+
+InitOptions &
+InitOptions::asynchronous_logging_queue_size(size_t queue_size)
+{
+  if (0u == queue_size) {
+    throw std::invalid_argument("the queue of the asynchronous logging can't be empty");
+  }
+  asynchronous_logging_queue_size_ = queue_size;
+  return *this;
+}
+
+size_t
+InitOptions::shutdown_callback_threads() const
+{
+  return shutdown_callback_threads_;
+}
+
+InitOptions &
+InitOptions::shutdown_callback_threads(size_t number_of_threads)
+{
+  shutdown_callback_threads_ = number_of_threads;
+  return *this;
+}
+
+bool
+InitOptions::share_intra_process_manager() const
+{
+  return share_intra_process_manager_;
+}
+
+InitOptions &
+InitOptions::share_intra_process_manager(bool share_intra_process_manager)
+{
+  share_intra_process_manager_ = share_intra_process_manager;
+  return *this;
+}
+
+bool
+InitOptions::share_rosout_publisher() const
+{
+  return share_rosout_publisher_;
+}
+
+InitOptions &
+InitOptions::share_rosout_publisher(bool share_rosout_publisher)
+{
+  share_rosout_publisher_ = share_rosout_publisher;
+  return *this;
+}
+
 InitOptions &
 InitOptions::operator=(const InitOptions & other)
 {
@@ -72,6 +147,11 @@ InitOptions::operator=(const InitOptions & other)
     }
     this->shutdown_on_signal = other.shutdown_on_signal;
     this->initialize_logging_ = other.initialize_logging_;
+    this->asynchronous_logging_ = other.asynchronous_logging_;
+    this->asynchronous_logging_queue_size_ = other.asynchronous_logging_queue_size_;
+    this->shutdown_callback_threads_ = other.shutdown_callback_threads_;
+    this->share_intra_process_manager_ = other.share_intra_process_manager_;
+    this->share_rosout_publisher_ = other.share_rosout_publisher_;
   }
   return *this;
 }
@@ -17,6 +17,9 @@
 #include <atomic>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace rclcpp
 {
@@ -32,16 +35,25 @@ IntraProcessManager::~IntraProcessManager()
 {}
 
 uint64_t
-IntraProcessManager::add_publisher(rclcpp::PublisherBase::SharedPtr publisher)
+IntraProcessManager::add_publisher(
+  rclcpp::PublisherBase::SharedPtr publisher,
+  bool is_serialized)
 {
   std::unique_lock<std::shared_timed_mutex> lock(mutex_);
 
   uint64_t pub_id = IntraProcessManager::get_next_unique_id();
 
   publishers_[pub_id] = publisher;
+  if (is_serialized) {
+    serialized_publishers_.insert(pub_id);
+  }
 
   // Initialize the subscriptions storage for this publisher.
   pub_to_subs_[pub_id] = SplittedSubscriptions();
+  auto qos = publisher->get_actual_qos();
+  if (!is_serialized && qos.durability() == rclcpp::DurabilityPolicy::TransientLocal) {
+    pub_to_subs_[pub_id].history = std::make_shared<TransientLocalHistory>(qos.depth());
+  }
 
   // create an entry for the publisher id and populate with already existing subscriptions
   for (auto & pair : subscriptions_) {
@@ -49,7 +61,7 @@ IntraProcessManager::add_publisher(rclcpp::PublisherBase::SharedPtr publisher)
     if (!subscription) {
       continue;
     }
-    if (can_communicate(publisher, subscription)) {
+    if (can_communicate(publisher, is_serialized, subscription)) {
       uint64_t sub_id = pair.first;
       insert_sub_id_for_pub(sub_id, pub_id, subscription->use_take_shared_method());
     }
@@ -67,15 +79,23 @@ IntraProcessManager::add_subscription(SubscriptionIntraProcessBase::SharedPtr su
 
   subscriptions_[sub_id] = subscription;
 
+  const bool is_transient_local =
+    subscription->get_actual_qos().durability() == rclcpp::DurabilityPolicy::TransientLocal;
+
   // adds the subscription id to all the matchable publishers
   for (auto & pair : publishers_) {
     auto publisher = pair.second.lock();
     if (!publisher) {
       continue;
     }
-    if (can_communicate(publisher, subscription)) {
-      uint64_t pub_id = pair.first;
+    uint64_t pub_id = pair.first;
+    if (can_communicate(publisher, serialized_publishers_.count(pub_id) != 0, subscription)) {
       insert_sub_id_for_pub(sub_id, pub_id, subscription->use_take_shared_method());
+      // The late joining subscriptions get the last messages, as with the middleware.
+      auto & history = pub_to_subs_[pub_id].history;
+      if (is_transient_local && history) {
+        replay_history(*history, subscription);
+      }
     }
   }
 
@@ -103,6 +123,9 @@ IntraProcessManager::remove_subscription(uint64_t intra_process_subscription_id)
         pair.second.take_ownership_subscriptions.end(),
         intra_process_subscription_id),
       pair.second.take_ownership_subscriptions.end());
+
+    // The dispatch table may hold the last reference to the subscription.
+    pair.second.dispatch_table.reset();
   }
 }
 
@@ -112,15 +135,52 @@ IntraProcessManager::remove_publisher(uint64_t intra_process_publisher_id)
   std::unique_lock<std::shared_timed_mutex> lock(mutex_);
 
   publishers_.erase(intra_process_publisher_id);
+  serialized_publishers_.erase(intra_process_publisher_id);
   pub_to_subs_.erase(intra_process_publisher_id);
 }
 
+void
+IntraProcessManager::do_serialized_intra_process_publish(
+  uint64_t intra_process_publisher_id,
+  std::shared_ptr<const rclcpp::SerializedMessage> message)
+{
+  std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+
+  auto publisher_it = pub_to_subs_.find(intra_process_publisher_id);
+  if (publisher_it == pub_to_subs_.end()) {
+    // Publisher is either invalid or no longer exists.
+    RCLCPP_WARN(
+      rclcpp::get_logger("rclcpp"),
+      "Calling do_serialized_intra_process_publish for invalid or no longer existing "
+      "publisher id");
+    return;
+  }
+
+  // Serialized subscriptions always share the messages.
+  for (auto id : publisher_it->second.take_shared_subscriptions) {
+    auto subscription_it = subscriptions_.find(id);
+    if (subscription_it == subscriptions_.end()) {
+      throw std::runtime_error("subscription has unexpectedly gone out of scope");
+    }
+    auto subscription_base = subscription_it->second.lock();
+    if (subscription_base == nullptr) {
+      continue;
+    }
+    auto subscription =
+      std::static_pointer_cast<SubscriptionSerializedIntraProcess>(subscription_base);
+    subscription->provide_intra_process_message(message);
+  }
+}
+
 bool
-IntraProcessManager::matches_any_publishers(const rmw_gid_t * id) const
+IntraProcessManager::matches_any_publishers(const rmw_gid_t * id, bool is_serialized) const
 {
   std::shared_lock<std::shared_timed_mutex> lock(mutex_);
 
   for (auto & publisher_pair : publishers_) {
+    if ((serialized_publishers_.count(publisher_pair.first) != 0) != is_serialized) {
+      continue;
+    }
     auto publisher = publisher_pair.second.lock();
     if (!publisher) {
       continue;
@@ -153,6 +213,21 @@ IntraProcessManager::get_subscription_count(uint64_t intra_process_publisher_id)
   return count;
 }
 
+std::vector<rclcpp::PublisherBase::SharedPtr>
+IntraProcessManager::get_publishers() const
+{
+  std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+
+  std::vector<rclcpp::PublisherBase::SharedPtr> publishers;
+  publishers.reserve(publishers_.size());
+  for (const auto & id_and_publisher : publishers_) {
+    if (auto publisher = id_and_publisher.second.lock()) {
+      publishers.push_back(std::move(publisher));
+    }
+  }
+  return publishers;
+}
+
 SubscriptionIntraProcessBase::SharedPtr
 IntraProcessManager::get_subscription_intra_process(uint64_t intra_process_subscription_id)
 {
@@ -205,13 +280,31 @@ IntraProcessManager::insert_sub_id_for_pub(
   } else {
     pub_to_subs_[pub_id].take_ownership_subscriptions.push_back(sub_id);
   }
+  pub_to_subs_[pub_id].dispatch_table.reset();
+}
+
+void
+IntraProcessManager::replay_history(
+  TransientLocalHistory & history,
+  const SubscriptionIntraProcessBase::SharedPtr & subscription)
+{
+  std::lock_guard<std::mutex> history_lock(history.mutex);
+  for (const auto & entry : history.messages) {
+    entry.replay(*this, entry.message, subscription);
+  }
 }
 
 bool
 IntraProcessManager::can_communicate(
   rclcpp::PublisherBase::SharedPtr pub,
+  bool pub_is_serialized,
   rclcpp::experimental::SubscriptionIntraProcessBase::SharedPtr sub) const
 {
+  // serialized messages are only exchanged between serialized publishers and subscriptions
+  if (pub_is_serialized != sub->is_serialized()) {
+    return false;
+  }
+
   // publisher and subscription must be on the same topic
   if (strcmp(pub->get_topic_name(), sub->get_topic_name()) != 0) {
     return false;
@@ -225,5 +318,46 @@ IntraProcessManager::can_communicate(
   return true;
 }
 
+namespace
+{
+
+/// Sub context keeping the shared intra process manager of its domain alive.
+struct SharedIntraProcessManager
+{
+  explicit SharedIntraProcessManager(size_t domain_id)
+  {
+    // The managers are only kept alive by the contexts using them
+    static std::mutex mutex;
+    static std::unordered_map<size_t, std::weak_ptr<IntraProcessManager>> managers;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = managers.begin(); it != managers.end(); ) {
+      if (it->second.expired()) {
+        it = managers.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    auto & weak_ipm = managers[domain_id];
+    ipm = weak_ipm.lock();
+    if (!ipm) {
+      ipm = std::make_shared<IntraProcessManager>();
+      weak_ipm = ipm;
+    }
+  }
+
+  IntraProcessManager::SharedPtr ipm;
+};
+
+}  // namespace
+
+IntraProcessManager::SharedPtr
+get_intra_process_manager(rclcpp::Context & context)
+{
+  if (!context.get_init_options().share_intra_process_manager()) {
+    return context.get_sub_context<IntraProcessManager>();
+  }
+  return context.get_sub_context<SharedIntraProcessManager>(context.get_domain_id())->ipm;
+}
+
 }  // namespace experimental
 }  // namespace rclcpp
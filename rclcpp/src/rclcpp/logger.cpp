@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 
 #include "rcl_logging_interface/rcl_logging_interface.h"
@@ -23,6 +25,14 @@
 namespace rclcpp
 {
 
+namespace detail
+{
+
+// 0 is the generation of the levels which were never looked up.
+std::atomic<uint64_t> g_logger_levels_generation{1u};
+
+}  // namespace detail
+
 Logger
 get_logger(const std::string & name)
 {
@@ -78,6 +88,32 @@ Logger::set_level(Level level)
       RCL_RET_ERROR, "Couldn't set logger level",
       rcutils_get_error_state(), rcutils_reset_error);
   }
+  // The level of this logger changes the effective level of its descendants too
+  invalidate_cached_levels();
+}
+
+bool
+Logger::is_enabled_for_uncached(Level severity, uint64_t generation) const
+{
+  RCUTILS_LOGGING_AUTOINIT;
+  // Read before looking up the level, so that a change meanwhile invalidates the cache again
+  const int default_level = g_rcutils_logging_default_logger_level;
+  const int effective_level = rcutils_logging_get_logger_effective_level(state_->name.c_str());
+  if (effective_level < 0) {
+    // Like rcutils_logging_logger_is_enabled_for(), nothing is logged if it failed
+    rcutils_reset_error();
+    return false;
+  }
+  state_->effective_level.store(effective_level, std::memory_order_relaxed);
+  state_->default_level.store(default_level, std::memory_order_relaxed);
+  state_->generation.store(generation, std::memory_order_release);
+  return static_cast<int>(severity) >= effective_level;
+}
+
+void
+Logger::invalidate_cached_levels()
+{
+  detail::g_logger_levels_generation.fetch_add(1u, std::memory_order_acq_rel);
 }
 
 }  // namespace rclcpp
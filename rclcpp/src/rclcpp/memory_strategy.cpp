@@ -17,6 +17,32 @@
 
 using rclcpp::memory_strategy::MemoryStrategy;
 
+void
+MemoryStrategy::get_next_executable_by_precedence(
+  rclcpp::AnyExecutable & any_exec,
+  const WeakCallbackGroupsToNodesMap & weak_groups_to_nodes,
+  const CallbackGroupPrecedence & has_precedence)
+{
+  (void)has_precedence;
+  get_next_timer(any_exec, weak_groups_to_nodes);
+  if (any_exec.timer) {
+    return;
+  }
+  get_next_subscription(any_exec, weak_groups_to_nodes);
+  if (any_exec.subscription) {
+    return;
+  }
+  get_next_service(any_exec, weak_groups_to_nodes);
+  if (any_exec.service) {
+    return;
+  }
+  get_next_client(any_exec, weak_groups_to_nodes);
+  if (any_exec.client) {
+    return;
+  }
+  get_next_waitable(any_exec, weak_groups_to_nodes);
+}
+
 rclcpp::SubscriptionBase::SharedPtr
 MemoryStrategy::get_subscription_by_handle(
   const std::shared_ptr<const rcl_subscription_t> & subscriber_handle,
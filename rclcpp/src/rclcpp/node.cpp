@@ -123,18 +123,18 @@ get_parameter_events_qos(
   const rclcpp::NodeOptions & options)
 {
   auto final_qos = options.parameter_event_qos();
-  const rcl_arguments_t * global_args = nullptr;
+  std::shared_ptr<const rclcpp::detail::ParameterOverridesIndex> global_overrides;
   auto * rcl_options = options.get_rcl_node_options();
   if (rcl_options->use_global_arguments) {
-    auto context_ptr = node_base.get_context()->get_rcl_context();
-    global_args = &(context_ptr->global_arguments);
+    global_overrides =
+      rclcpp::detail::get_global_parameter_overrides(*node_base.get_context());
   }
 
   auto parameter_overrides = rclcpp::detail::resolve_parameter_overrides(
     node_base.get_fully_qualified_name(),
     options.parameter_overrides(),
     &rcl_options->arguments,
-    global_args);
+    global_overrides.get());
 
   auto final_topic_name = node_base.resolve_topic_or_service_name("/parameter_events", false);
   auto prefix = "qos_overrides." + final_topic_name + ".";
@@ -166,7 +166,8 @@ Node::Node(
       *(options.get_rcl_node_options()),
       options.use_intra_process_comms(),
       options.enable_topic_statistics())),
-  node_graph_(new rclcpp::node_interfaces::NodeGraph(node_base_.get())),
+  node_graph_(
+    new rclcpp::node_interfaces::NodeGraph(node_base_.get(), options.cache_graph_queries())),
   node_logging_(new rclcpp::node_interfaces::NodeLogging(node_base_.get())),
   node_timers_(new rclcpp::node_interfaces::NodeTimers(node_base_.get())),
   node_topics_(new rclcpp::node_interfaces::NodeTopics(node_base_.get(), node_timers_.get())),
@@ -204,7 +205,8 @@ Node::Node(
       node_clock_,
       node_parameters_,
       options.clock_qos(),
-      options.use_clock_thread()
+      options.use_clock_thread(),
+      options.use_shared_clock_subscription()
     )),
   node_waitables_(new rclcpp::node_interfaces::NodeWaitables(node_base_.get())),
   node_options_(options),
@@ -339,6 +341,14 @@ Node::declare_parameter(
     ignore_override);
 }
 
+std::vector<rclcpp::ParameterValue>
+Node::declare_parameters_bulk(
+  const rclcpp::node_interfaces::NodeParametersInterface::ParameterDeclarations & parameters,
+  bool ignore_overrides)
+{
+  return this->node_parameters_->declare_parameters_bulk(parameters, ignore_overrides);
+}
+
 void
 Node::undeclare_parameter(const std::string & name)
 {
@@ -0,0 +1,147 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/node_interfaces/detail/parameter_name_index.hpp"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using rclcpp::node_interfaces::detail::ParameterNameIndex;
+
+namespace
+{
+
+/// Call visit with each '.' separated segment of name, until it returns false.
+template<typename VisitorT>
+bool
+for_each_segment(const std::string & name, VisitorT visit)
+{
+  size_t start = 0;
+  while (true) {
+    size_t end = name.find('.', start);
+    if (std::string::npos == end) {
+      return visit(name.substr(start));
+    }
+    if (!visit(name.substr(start, end - start))) {
+      return false;
+    }
+    start = end + 1;
+  }
+}
+
+}  // namespace
+
+constexpr size_t ParameterNameIndex::unlimited_segments;
+
+ParameterNameIndex::ParameterNameIndex() = default;
+
+ParameterNameIndex::~ParameterNameIndex() = default;
+
+void
+ParameterNameIndex::insert(const std::string & name)
+{
+  Node * node = &root_;
+  for_each_segment(
+    name, [&node](std::string segment) {
+      auto & child = node->children[std::move(segment)];
+      if (!child) {
+        child = std::make_unique<Node>();
+      }
+      node = child.get();
+      return true;
+    });
+  if (!node->is_name) {
+    node->is_name = true;
+    node->name = name;
+  }
+}
+
+void
+ParameterNameIndex::erase(const std::string & name)
+{
+  // Nodes leading to the name, to remove the ones which don't lead to any name anymore.
+  std::vector<std::pair<Node *, std::string>> path;
+  Node * node = &root_;
+  bool found = for_each_segment(
+    name, [&node, &path](std::string segment) {
+      auto it = node->children.find(segment);
+      if (node->children.end() == it) {
+        return false;
+      }
+      path.emplace_back(node, std::move(segment));
+      node = it->second.get();
+      return true;
+    });
+  if (!found || !node->is_name) {
+    return;
+  }
+  node->is_name = false;
+  node->name.clear();
+  for (auto it = path.rbegin(); it != path.rend(); ++it) {
+    auto child = it->first->children.find(it->second);
+    if (child->second->is_name || !child->second->children.empty()) {
+      break;
+    }
+    it->first->children.erase(child);
+  }
+}
+
+void
+ParameterNameIndex::collect(size_t max_segments, std::vector<std::string> & names) const
+{
+  collect(root_, 0, 1, max_segments, names);
+}
+
+void
+ParameterNameIndex::collect(
+  const std::string & prefix,
+  size_t min_more_segments,
+  size_t max_more_segments,
+  std::vector<std::string> & names) const
+{
+  const Node * node = &root_;
+  bool found = for_each_segment(
+    prefix, [&node](const std::string & segment) {
+      auto it = node->children.find(segment);
+      if (node->children.end() == it) {
+        return false;
+      }
+      node = it->second.get();
+      return true;
+    });
+  if (found) {
+    collect(*node, 0, min_more_segments, max_more_segments, names);
+  }
+}
+
+void
+ParameterNameIndex::collect(
+  const Node & node,
+  size_t depth,
+  size_t min_depth,
+  size_t max_depth,
+  std::vector<std::string> & names)
+{
+  if (node.is_name && depth >= min_depth) {
+    names.push_back(node.name);
+  }
+  if (depth >= max_depth) {
+    return;
+  }
+  for (const auto & child : node.children) {
+    collect(*child.second, depth + 1, min_depth, max_depth, names);
+  }
+}
@@ -15,6 +15,8 @@
 #include <string>
 #include <limits>
 #include <memory>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 #include "rclcpp/node_interfaces/node_base.hpp"
@@ -26,6 +28,7 @@
 #include "rmw/validate_node_name.h"
 
 #include "../logging_mutex.hpp"
+#include "../shared_rosout.hpp"
 
 using rclcpp::exceptions::throw_from_rcl_error;
 
@@ -53,9 +56,18 @@ NodeBase::NodeBase(
 
   std::shared_ptr<std::recursive_mutex> logging_mutex = get_global_logging_mutex();
 
+  // The shared rosout publisher is used instead of the one rcl creates for the node
+  rcl_node_options_t node_options = rcl_node_options;
+  std::shared_ptr<rclcpp::detail::SharedRosoutPublisher> shared_rosout;
+
   rcl_ret_t ret;
   {
     std::lock_guard<std::recursive_mutex> guard(*logging_mutex);
+    if (node_options.enable_rosout && context_->get_init_options().share_rosout_publisher()) {
+      shared_rosout = context_->get_sub_context<rclcpp::detail::SharedRosoutPublisher>(
+        context_->get_rcl_context(), node_options.rosout_qos);
+      node_options.enable_rosout = false;
+    }
     // TODO(ivanpauno): /rosout Qos should be reconfigurable.
     // TODO(ivanpauno): Instead of mutually excluding rcl_node_init with the global logger mutex,
     // rcl_logging_rosout_init_publisher_for_node could be decoupled from there and be called
@@ -63,7 +75,10 @@ NodeBase::NodeBase(
     ret = rcl_node_init(
       rcl_node.get(),
       node_name.c_str(), namespace_.c_str(),
-      context_->get_rcl_context().get(), &rcl_node_options);
+      context_->get_rcl_context().get(), &node_options);
+    if (RCL_RET_OK == ret && shared_rosout) {
+      shared_rosout->add_logger(rcl_node_get_logger_name(rcl_node.get()));
+    }
   }
   if (ret != RCL_RET_OK) {
     if (ret == RCL_RET_NODE_INVALID_NAME) {
@@ -116,8 +131,11 @@ NodeBase::NodeBase(
 
   node_handle_.reset(
     rcl_node.release(),
-    [logging_mutex](rcl_node_t * node) -> void {
+    [logging_mutex, shared_rosout](rcl_node_t * node) -> void {
       std::lock_guard<std::recursive_mutex> guard(*logging_mutex);
+      if (shared_rosout) {
+        shared_rosout->remove_logger(rcl_node_get_logger_name(node));
+      }
       // TODO(ivanpauno): Instead of mutually excluding rcl_node_fini with the global logger mutex,
       // rcl_logging_rosout_fini_publisher_for_node could be decoupled from there and be called
       // here directly.
@@ -256,6 +274,64 @@ NodeBase::get_notify_guard_condition()
   return notify_guard_condition_;
 }
 
+void
+NodeBase::trigger_notify_guard_condition(rclcpp::CallbackGroup::SharedPtr group)
+{
+  std::lock_guard<std::recursive_mutex> notify_condition_lock(notify_guard_condition_mutex_);
+  if (!notify_guard_condition_is_valid_) {
+    throw std::runtime_error("failed to trigger notify guard condition because it is invalid");
+  }
+  if (batch_modification_depth_ == 0u) {
+    notify_guard_condition_.trigger();
+    if (group) {
+      group->trigger_notify_guard_condition();
+    }
+    return;
+  }
+  batch_notify_pending_ = true;
+  if (!group) {
+    return;
+  }
+  for (const auto & weak_group : batch_callback_groups_) {
+    if (weak_group.lock() == group) {
+      return;
+    }
+  }
+  batch_callback_groups_.push_back(group);
+}
+
+void
+NodeBase::begin_batch_modification()
+{
+  std::lock_guard<std::recursive_mutex> notify_condition_lock(notify_guard_condition_mutex_);
+  ++batch_modification_depth_;
+}
+
+void
+NodeBase::end_batch_modification()
+{
+  std::lock_guard<std::recursive_mutex> notify_condition_lock(notify_guard_condition_mutex_);
+  if (batch_modification_depth_ == 0u) {
+    throw std::runtime_error("end_batch_modification() called without a batch modification");
+  }
+  if (--batch_modification_depth_ > 0u || !batch_notify_pending_) {
+    return;
+  }
+  batch_notify_pending_ = false;
+  std::vector<rclcpp::CallbackGroup::WeakPtr> groups;
+  groups.swap(batch_callback_groups_);
+  if (!notify_guard_condition_is_valid_) {
+    return;
+  }
+  notify_guard_condition_.trigger();
+  for (const auto & weak_group : groups) {
+    auto group = weak_group.lock();
+    if (group) {
+      group->trigger_notify_guard_condition();
+    }
+  }
+}
+
 bool
 NodeBase::get_use_intra_process_default() const
 {
@@ -272,19 +348,44 @@ std::string
 NodeBase::resolve_topic_or_service_name(
   const std::string & name, bool is_service, bool only_expand) const
 {
-  char * output_cstr = NULL;
-  auto allocator = rcl_get_default_allocator();
-  rcl_ret_t ret = rcl_node_resolve_name(
-    node_handle_.get(),
-    name.c_str(),
-    allocator,
-    is_service,
-    only_expand,
-    &output_cstr);
-  if (RCL_RET_OK != ret) {
-    throw_from_rcl_error(ret, "failed to resolve name", rcl_get_error_state());
+  const char kind = static_cast<char>((is_service ? 1 : 0) | (only_expand ? 2 : 0));
+  return resolved_names_.get(
+    name, kind, [this, &name, is_service, only_expand]() {
+      char * output_cstr = NULL;
+      auto allocator = rcl_get_default_allocator();
+      rcl_ret_t ret = rcl_node_resolve_name(
+        node_handle_.get(),
+        name.c_str(),
+        allocator,
+        is_service,
+        only_expand,
+        &output_cstr);
+      if (RCL_RET_OK != ret) {
+        throw_from_rcl_error(ret, "failed to resolve name", rcl_get_error_state());
+      }
+      std::string output{output_cstr};
+      allocator.deallocate(output_cstr, allocator.state);
+      return output;
+    });
+}
+
+rclcpp::node_interfaces::BatchModification::BatchModification(
+  std::shared_ptr<NodeBaseInterface> node_base)
+: node_base_(std::move(node_base))
+{
+  if (!node_base_) {
+    throw std::invalid_argument("the node of a batch modification is nullptr");
+  }
+  node_base_->begin_batch_modification();
+}
+
+rclcpp::node_interfaces::BatchModification::~BatchModification()
+{
+  try {
+    node_base_->end_batch_modification();
+  } catch (const std::exception & ex) {
+    RCUTILS_LOG_ERROR_NAMED(
+      "rclcpp", "failed to notify the executors at the end of a batch modification: %s",
+      ex.what());
   }
-  std::string output{output_cstr};
-  allocator.deallocate(output_cstr, allocator.state);
-  return output;
 }
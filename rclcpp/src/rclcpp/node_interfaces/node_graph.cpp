@@ -15,9 +15,14 @@
 #include "rclcpp/node_interfaces/node_graph.hpp"
 
 #include <algorithm>
+#include <functional>
 #include <map>
+#include <memory>
+#include <optional>  // NOLINT, cpplint doesn't think this is a cpp std header
+#include <stdexcept>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -34,14 +39,47 @@ using rclcpp::node_interfaces::NodeGraph;
 using rclcpp::exceptions::throw_from_rcl_error;
 using rclcpp::graph_listener::GraphListener;
 
-NodeGraph::NodeGraph(rclcpp::node_interfaces::NodeBaseInterface * node_base)
+struct NodeGraph::GraphCache
+{
+  void
+  clear()
+  {
+    for (auto & entry : topic_names_and_types) {
+      entry.reset();
+    }
+    service_names_and_types.reset();
+    node_names_and_namespaces.reset();
+    publisher_counts.clear();
+    subscriber_counts.clear();
+  }
+
+  std::mutex mutex;
+  /// Graph version when the results below were queried.
+  uint64_t version{0};
+  /// Indexed by the no_demangle flag.
+  std::optional<std::map<std::string, std::vector<std::string>>> topic_names_and_types[2];
+  std::optional<std::map<std::string, std::vector<std::string>>> service_names_and_types;
+  std::optional<std::vector<std::pair<std::string, std::string>>> node_names_and_namespaces;
+  std::unordered_map<std::string, size_t> publisher_counts;
+  std::unordered_map<std::string, size_t> subscriber_counts;
+};
+
+NodeGraph::NodeGraph(
+  rclcpp::node_interfaces::NodeBaseInterface * node_base,
+  bool cache_graph_queries)
 : node_base_(node_base),
   graph_listener_(
     node_base->get_context()->get_sub_context<GraphListener>(node_base->get_context())
   ),
   should_add_to_graph_listener_(true),
   graph_users_count_(0)
-{}
+{
+  if (cache_graph_queries) {
+    graph_cache_ = std::make_unique<GraphCache>();
+    // The cache is only valid while the graph listener notifies the graph changes.
+    graph_cache_event_ = get_graph_event();
+  }
+}
 
 NodeGraph::~NodeGraph()
 {
@@ -54,8 +92,93 @@ NodeGraph::~NodeGraph()
   }
 }
 
+NodeGraph::GraphCache &
+NodeGraph::lock_graph_cache(std::unique_lock<std::mutex> & lock) const
+{
+  lock = std::unique_lock<std::mutex>(graph_cache_->mutex);
+  // Read before querying, so a change notified during a query invalidates its result.
+  const uint64_t version = graph_version_.load();
+  if (graph_cache_->version != version) {
+    graph_cache_->clear();
+    graph_cache_->version = version;
+  }
+  return *graph_cache_;
+}
+
 std::map<std::string, std::vector<std::string>>
 NodeGraph::get_topic_names_and_types(bool no_demangle) const
+{
+  if (!graph_cache_) {
+    return query_topic_names_and_types(no_demangle);
+  }
+  std::unique_lock<std::mutex> lock;
+  auto & entry = lock_graph_cache(lock).topic_names_and_types[no_demangle ? 1 : 0];
+  if (!entry) {
+    entry = query_topic_names_and_types(no_demangle);
+  }
+  return *entry;
+}
+
+std::map<std::string, std::vector<std::string>>
+NodeGraph::get_service_names_and_types() const
+{
+  if (!graph_cache_) {
+    return query_service_names_and_types();
+  }
+  std::unique_lock<std::mutex> lock;
+  auto & entry = lock_graph_cache(lock).service_names_and_types;
+  if (!entry) {
+    entry = query_service_names_and_types();
+  }
+  return *entry;
+}
+
+std::vector<std::pair<std::string, std::string>>
+NodeGraph::get_node_names_and_namespaces() const
+{
+  if (!graph_cache_) {
+    return query_node_names_and_namespaces();
+  }
+  std::unique_lock<std::mutex> lock;
+  auto & entry = lock_graph_cache(lock).node_names_and_namespaces;
+  if (!entry) {
+    entry = query_node_names_and_namespaces();
+  }
+  return *entry;
+}
+
+size_t
+NodeGraph::count_publishers(const std::string & topic_name) const
+{
+  if (!graph_cache_) {
+    return query_count_publishers(topic_name);
+  }
+  std::unique_lock<std::mutex> lock;
+  auto & counts = lock_graph_cache(lock).publisher_counts;
+  auto it = counts.find(topic_name);
+  if (it == counts.end()) {
+    it = counts.emplace(topic_name, query_count_publishers(topic_name)).first;
+  }
+  return it->second;
+}
+
+size_t
+NodeGraph::count_subscribers(const std::string & topic_name) const
+{
+  if (!graph_cache_) {
+    return query_count_subscribers(topic_name);
+  }
+  std::unique_lock<std::mutex> lock;
+  auto & counts = lock_graph_cache(lock).subscriber_counts;
+  auto it = counts.find(topic_name);
+  if (it == counts.end()) {
+    it = counts.emplace(topic_name, query_count_subscribers(topic_name)).first;
+  }
+  return it->second;
+}
+
+std::map<std::string, std::vector<std::string>>
+NodeGraph::query_topic_names_and_types(bool no_demangle) const
 {
   rcl_names_and_types_t topic_names_and_types = rcl_get_zero_initialized_names_and_types();
 
@@ -97,7 +220,7 @@ NodeGraph::get_topic_names_and_types(bool no_demangle) const
 }
 
 std::map<std::string, std::vector<std::string>>
-NodeGraph::get_service_names_and_types() const
+NodeGraph::query_service_names_and_types() const
 {
   rcl_names_and_types_t service_names_and_types = rcl_get_zero_initialized_names_and_types();
 
@@ -393,7 +516,7 @@ NodeGraph::get_node_names_with_enclaves() const
 }
 
 std::vector<std::pair<std::string, std::string>>
-NodeGraph::get_node_names_and_namespaces() const
+NodeGraph::query_node_names_and_namespaces() const
 {
   rcutils_string_array_t node_names_c =
     rcutils_get_zero_initialized_string_array();
@@ -455,15 +578,18 @@ NodeGraph::get_node_names_and_namespaces() const
 }
 
 size_t
-NodeGraph::count_publishers(const std::string & topic_name) const
+NodeGraph::query_count_publishers(const std::string & topic_name) const
 {
   auto rcl_node_handle = node_base_->get_rcl_node_handle();
 
-  auto fqdn = rclcpp::expand_topic_or_service_name(
-    topic_name,
-    rcl_node_get_name(rcl_node_handle),
-    rcl_node_get_namespace(rcl_node_handle),
-    false);    // false = not a service
+  auto fqdn = resolved_topic_names_.get(
+    topic_name, 'e', [rcl_node_handle, &topic_name]() {
+      return rclcpp::expand_topic_or_service_name(
+        topic_name,
+        rcl_node_get_name(rcl_node_handle),
+        rcl_node_get_namespace(rcl_node_handle),
+        false);    // false = not a service
+    });
 
   size_t count;
   auto ret = rcl_count_publishers(rcl_node_handle, fqdn.c_str(), &count);
@@ -477,15 +603,18 @@ NodeGraph::count_publishers(const std::string & topic_name) const
 }
 
 size_t
-NodeGraph::count_subscribers(const std::string & topic_name) const
+NodeGraph::query_count_subscribers(const std::string & topic_name) const
 {
   auto rcl_node_handle = node_base_->get_rcl_node_handle();
 
-  auto fqdn = rclcpp::expand_topic_or_service_name(
-    topic_name,
-    rcl_node_get_name(rcl_node_handle),
-    rcl_node_get_namespace(rcl_node_handle),
-    false);    // false = not a service
+  auto fqdn = resolved_topic_names_.get(
+    topic_name, 'e', [rcl_node_handle, &topic_name]() {
+      return rclcpp::expand_topic_or_service_name(
+        topic_name,
+        rcl_node_get_name(rcl_node_handle),
+        rcl_node_get_namespace(rcl_node_handle),
+        false);    // false = not a service
+    });
 
   size_t count;
   auto ret = rcl_count_subscribers(rcl_node_handle, fqdn.c_str(), &count);
@@ -507,6 +636,8 @@ NodeGraph::get_graph_guard_condition() const
 void
 NodeGraph::notify_graph_change()
 {
+  graph_version_++;
+  std::vector<std::pair<rclcpp::Event::SharedPtr, std::function<bool()>>> filtered_events;
   {
     std::lock_guard<std::mutex> graph_changed_lock(graph_mutex_);
     bool bad_ptr_encountered = false;
@@ -518,6 +649,14 @@ NodeGraph::notify_graph_change()
         bad_ptr_encountered = true;
       }
     }
+    for (auto & filtered_event : filtered_graph_events_) {
+      auto event_ptr = filtered_event.first.lock();
+      if (event_ptr) {
+        filtered_events.emplace_back(std::move(event_ptr), filtered_event.second);
+      } else {
+        bad_ptr_encountered = true;
+      }
+    }
     if (bad_ptr_encountered) {
       // remove invalid pointers with the erase-remove idiom
       graph_events_.erase(
@@ -528,8 +667,37 @@ NodeGraph::notify_graph_change()
             return wptr.expired();
           }),
         graph_events_.end());
+      filtered_graph_events_.erase(
+        std::remove_if(
+          filtered_graph_events_.begin(),
+          filtered_graph_events_.end(),
+          [](const std::pair<rclcpp::Event::WeakPtr, std::function<bool()>> & filtered_event) {
+            return filtered_event.first.expired();
+          }),
+        filtered_graph_events_.end());
       // update graph_users_count_
-      graph_users_count_.store(graph_events_.size());
+      graph_users_count_.store(graph_events_.size() + filtered_graph_events_.size());
+    }
+  }
+  // The filters may query the graph, so they are called without holding the lock.
+  for (auto & filtered_event : filtered_events) {
+    bool passed = true;
+    try {
+      passed = filtered_event.second();
+    } catch (...) {
+      // Considered passed, the waiting threads check the graph themselves.
+    }
+    if (!passed) {
+      filtered_event.first.reset();
+    }
+  }
+  {
+    // Set while holding the lock, so the threads about to wait don't miss them.
+    std::lock_guard<std::mutex> graph_changed_lock(graph_mutex_);
+    for (auto & filtered_event : filtered_events) {
+      if (filtered_event.first) {
+        filtered_event.first->set();
+      }
     }
   }
   graph_cv_.notify_all();
@@ -566,6 +734,26 @@ NodeGraph::get_graph_event()
   return event;
 }
 
+rclcpp::Event::SharedPtr
+NodeGraph::get_filtered_graph_event(std::function<bool()> filter)
+{
+  if (!filter) {
+    throw std::invalid_argument("the filter of a graph event must be callable");
+  }
+  auto event = rclcpp::Event::make_shared();
+  {
+    std::lock_guard<std::mutex> graph_changed_lock(graph_mutex_);
+    filtered_graph_events_.emplace_back(event, std::move(filter));
+    graph_users_count_++;
+  }
+  // on first call, add node to graph_listener_
+  if (should_add_to_graph_listener_.exchange(false)) {
+    graph_listener_->add_node(this);
+    graph_listener_->start_if_not_started();
+  }
+  return event;
+}
+
 void
 NodeGraph::wait_for_graph_change(
   rclcpp::Event::SharedPtr event,
@@ -585,6 +773,12 @@ NodeGraph::wait_for_graph_change(
         break;
       }
     }
+    for (const auto & filtered_event : filtered_graph_events_) {
+      if (event_in_graph_events) {
+        break;
+      }
+      event_in_graph_events = event == filtered_event.first.lock();
+    }
     if (!event_in_graph_events) {
       throw EventNotRegisteredError();
     }
@@ -598,70 +792,117 @@ NodeGraph::wait_for_graph_change(
   }
 }
 
+uint64_t
+NodeGraph::get_graph_version() const
+{
+  return graph_version_.load();
+}
+
 size_t
 NodeGraph::count_graph_users() const
 {
   return graph_users_count_.load();
 }
 
+/// Copy the endpoints info, reusing the elements of the list and the memory of their strings.
 static
-std::vector<rclcpp::TopicEndpointInfo>
-convert_to_topic_info_list(const rcl_topic_endpoint_info_array_t & info_array)
+void
+copy_to_topic_info_list(
+  const rcl_topic_endpoint_info_array_t & info_array,
+  std::vector<rclcpp::TopicEndpointInfo> & topic_info_list)
 {
-  std::vector<rclcpp::TopicEndpointInfo> topic_info_list;
-  for (size_t i = 0; i < info_array.size; ++i) {
+  const size_t reused = std::min(info_array.size, topic_info_list.size());
+  for (size_t i = 0; i < reused; ++i) {
+    const rcl_topic_endpoint_info_t & info = info_array.info_array[i];
+    rclcpp::TopicEndpointInfo & topic_info = topic_info_list[i];
+    topic_info.node_name() = info.node_name;
+    topic_info.node_namespace() = info.node_namespace;
+    topic_info.topic_type() = info.topic_type;
+    topic_info.endpoint_type() = static_cast<rclcpp::EndpointType>(info.endpoint_type);
+    std::copy(
+      info.endpoint_gid, info.endpoint_gid + RMW_GID_STORAGE_SIZE,
+      topic_info.endpoint_gid().begin());
+    topic_info.qos_profile() =
+      rclcpp::QoS({info.qos_profile.history, info.qos_profile.depth}, info.qos_profile);
+  }
+  topic_info_list.erase(
+    topic_info_list.begin() + static_cast<std::ptrdiff_t>(reused), topic_info_list.end());
+  for (size_t i = reused; i < info_array.size; ++i) {
     topic_info_list.push_back(rclcpp::TopicEndpointInfo(info_array.info_array[i]));
   }
-  return topic_info_list;
 }
 
-template<const char * EndpointType, typename FunctionT>
-static std::vector<rclcpp::TopicEndpointInfo>
-get_info_by_topic(
-  rclcpp::node_interfaces::NodeBaseInterface * node_base,
+/// Return the fully qualified and remapped name of a topic, unless no_mangle is true.
+static
+std::string
+resolve_topic_name(
+  const rcl_node_t * rcl_node_handle,
   const std::string & topic_name,
-  bool no_mangle,
-  FunctionT rcl_get_info_by_topic)
+  bool no_mangle)
 {
-  std::string fqdn;
-  auto rcl_node_handle = node_base->get_rcl_node_handle();
-
   if (no_mangle) {
-    fqdn = topic_name;
-  } else {
-    fqdn = rclcpp::expand_topic_or_service_name(
-      topic_name,
-      rcl_node_get_name(rcl_node_handle),
-      rcl_node_get_namespace(rcl_node_handle),
-      false);    // false = not a service
-
-    // Get the node options
-    const rcl_node_options_t * node_options = rcl_node_get_options(rcl_node_handle);
-    if (nullptr == node_options) {
-      throw std::runtime_error("Need valid node options in get_info_by_topic()");
-    }
-    const rcl_arguments_t * global_args = nullptr;
-    if (node_options->use_global_arguments) {
-      global_args = &(rcl_node_handle->context->global_arguments);
-    }
+    return topic_name;
+  }
+  std::string fqdn = rclcpp::expand_topic_or_service_name(
+    topic_name,
+    rcl_node_get_name(rcl_node_handle),
+    rcl_node_get_namespace(rcl_node_handle),
+    false);    // false = not a service
 
-    char * remapped_topic_name = nullptr;
-    rcl_ret_t ret = rcl_remap_topic_name(
-      &(node_options->arguments),
-      global_args,
-      fqdn.c_str(),
-      rcl_node_get_name(rcl_node_handle),
-      rcl_node_get_namespace(rcl_node_handle),
-      node_options->allocator,
-      &remapped_topic_name);
-    if (RCL_RET_OK != ret) {
-      throw_from_rcl_error(ret, std::string("Failed to remap topic name ") + fqdn);
-    } else if (nullptr != remapped_topic_name) {
-      fqdn = remapped_topic_name;
-      node_options->allocator.deallocate(remapped_topic_name, node_options->allocator.state);
-    }
+  // Get the node options
+  const rcl_node_options_t * node_options = rcl_node_get_options(rcl_node_handle);
+  if (nullptr == node_options) {
+    throw std::runtime_error("Need valid node options in get_info_by_topic()");
+  }
+  const rcl_arguments_t * global_args = nullptr;
+  if (node_options->use_global_arguments) {
+    global_args = &(rcl_node_handle->context->global_arguments);
+  }
+
+  char * remapped_topic_name = nullptr;
+  rcl_ret_t ret = rcl_remap_topic_name(
+    &(node_options->arguments),
+    global_args,
+    fqdn.c_str(),
+    rcl_node_get_name(rcl_node_handle),
+    rcl_node_get_namespace(rcl_node_handle),
+    node_options->allocator,
+    &remapped_topic_name);
+  if (RCL_RET_OK != ret) {
+    throw_from_rcl_error(ret, std::string("Failed to remap topic name ") + fqdn);
+  } else if (nullptr != remapped_topic_name) {
+    fqdn = remapped_topic_name;
+    node_options->allocator.deallocate(remapped_topic_name, node_options->allocator.state);
   }
+  return fqdn;
+}
 
+static
+std::string
+resolve_cached_topic_name(
+  rclcpp::detail::ResolvedNameCache & resolved_topic_names,
+  const rcl_node_t * rcl_node_handle,
+  const std::string & topic_name,
+  bool no_mangle)
+{
+  if (no_mangle) {
+    return topic_name;
+  }
+  return resolved_topic_names.get(
+    topic_name, 'r', [rcl_node_handle, &topic_name]() {
+      return resolve_topic_name(rcl_node_handle, topic_name, false);
+    });
+}
+
+template<const char * EndpointType, typename FunctionT>
+static void
+get_info_by_topic(
+  const rcl_node_t * rcl_node_handle,
+  const std::string & fqdn,
+  bool no_mangle,
+  FunctionT rcl_get_info_by_topic,
+  std::vector<rclcpp::TopicEndpointInfo> & topic_info_list)
+{
   rcutils_allocator_t allocator = rcutils_get_default_allocator();
   rcl_topic_endpoint_info_array_t info_array = rcl_get_zero_initialized_topic_endpoint_info_array();
   rcl_ret_t ret =
@@ -683,13 +924,11 @@ get_info_by_topic(
     throw_from_rcl_error(ret, error_msg);
   }
 
-  std::vector<rclcpp::TopicEndpointInfo> topic_info_list = convert_to_topic_info_list(info_array);
+  copy_to_topic_info_list(info_array, topic_info_list);
   ret = rcl_topic_endpoint_info_array_fini(&info_array, &allocator);
   if (RCL_RET_OK != ret) {
     throw_from_rcl_error(ret, "rcl_topic_info_array_fini failed.");
   }
-
-  return topic_info_list;
 }
 
 static constexpr char kPublisherEndpointTypeName[] = "publishers";
@@ -698,11 +937,15 @@ NodeGraph::get_publishers_info_by_topic(
   const std::string & topic_name,
   bool no_mangle) const
 {
-  return get_info_by_topic<kPublisherEndpointTypeName>(
-    node_base_,
-    topic_name,
+  auto rcl_node_handle = node_base_->get_rcl_node_handle();
+  std::vector<rclcpp::TopicEndpointInfo> topic_info_list;
+  get_info_by_topic<kPublisherEndpointTypeName>(
+    rcl_node_handle,
+    resolve_cached_topic_name(resolved_topic_names_, rcl_node_handle, topic_name, no_mangle),
     no_mangle,
-    rcl_get_publishers_info_by_topic);
+    rcl_get_publishers_info_by_topic,
+    topic_info_list);
+  return topic_info_list;
 }
 
 static constexpr char kSubscriptionEndpointTypeName[] = "subscriptions";
@@ -711,11 +954,38 @@ NodeGraph::get_subscriptions_info_by_topic(
   const std::string & topic_name,
   bool no_mangle) const
 {
-  return get_info_by_topic<kSubscriptionEndpointTypeName>(
-    node_base_,
-    topic_name,
+  auto rcl_node_handle = node_base_->get_rcl_node_handle();
+  std::vector<rclcpp::TopicEndpointInfo> topic_info_list;
+  get_info_by_topic<kSubscriptionEndpointTypeName>(
+    rcl_node_handle,
+    resolve_cached_topic_name(resolved_topic_names_, rcl_node_handle, topic_name, no_mangle),
     no_mangle,
-    rcl_get_subscriptions_info_by_topic);
+    rcl_get_subscriptions_info_by_topic,
+    topic_info_list);
+  return topic_info_list;
+}
+
+void
+NodeGraph::get_endpoints_info_by_topics(
+  const std::vector<std::string> & topic_names,
+  std::vector<rclcpp::TopicEndpointsInfo> & endpoints_info,
+  bool no_mangle) const
+{
+  auto rcl_node_handle = node_base_->get_rcl_node_handle();
+  // Only growing, so the endpoints of the previous queries are reused.
+  if (endpoints_info.size() < topic_names.size()) {
+    endpoints_info.resize(topic_names.size());
+  }
+  for (size_t i = 0; i < topic_names.size(); ++i) {
+    const std::string fqdn = resolve_cached_topic_name(
+      resolved_topic_names_, rcl_node_handle, topic_names[i], no_mangle);
+    get_info_by_topic<kPublisherEndpointTypeName>(
+      rcl_node_handle, fqdn, no_mangle, rcl_get_publishers_info_by_topic,
+      endpoints_info[i].publishers);
+    get_info_by_topic<kSubscriptionEndpointTypeName>(
+      rcl_node_handle, fqdn, no_mangle, rcl_get_subscriptions_info_by_topic,
+      endpoints_info[i].subscriptions);
+  }
 }
 
 std::string &
@@ -16,6 +16,7 @@
 
 #include <rcl_yaml_param_parser/parser.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstdlib>
@@ -26,6 +27,7 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -113,20 +115,22 @@ NodeParameters::NodeParameters(
     throw std::runtime_error("Need valid node options in NodeParameters");
   }
 
-  const rcl_arguments_t * global_args = nullptr;
+  // The global arguments are the same for all the nodes of the context, so they are parsed once.
+  std::shared_ptr<const rclcpp::detail::ParameterOverridesIndex> global_overrides;
   if (options->use_global_arguments) {
-    auto context_ptr = node_base->get_context()->get_rcl_context();
-    global_args = &(context_ptr->global_arguments);
+    global_overrides = rclcpp::detail::get_global_parameter_overrides(*node_base->get_context());
   }
   combined_name_ = node_base->get_fully_qualified_name();
 
   parameter_overrides_ = rclcpp::detail::resolve_parameter_overrides(
-    combined_name_, parameter_overrides, &options->arguments, global_args);
+    combined_name_, parameter_overrides, &options->arguments, global_overrides.get());
 
   // If asked, initialize any parameters that ended up in the initial parameter values,
   // but did not get declared explcitily by this point.
   if (automatically_declare_parameters_from_overrides) {
     using namespace std::placeholders;
+    // A single event is published for all of them.
+    ParameterEventBatch batch(*this);
     local_perform_automatically_declare_parameters_from_overrides(
       this->get_parameter_overrides(),
       std::bind(&NodeParameters::has_parameter, this, _1),
@@ -146,6 +150,7 @@ NodeParameters::NodeParameters(
 void
 NodeParameters::perform_automatically_declare_parameters_from_overrides()
 {
+  ParameterEventBatch batch(*this);
   local_perform_automatically_declare_parameters_from_overrides(
     this->get_parameter_overrides(),
     [this](const std::string & name) {
@@ -169,7 +174,7 @@ NodeParameters::~NodeParameters()
 RCLCPP_LOCAL
 bool
 __lockless_has_parameter(
-  const std::map<std::string, rclcpp::node_interfaces::ParameterInfo> & parameters,
+  const rclcpp::node_interfaces::ParameterInfos & parameters,
   const std::string & name)
 {
   return parameters.find(name) != parameters.end();
@@ -264,7 +269,7 @@ format_type_reason(
 RCLCPP_LOCAL
 rcl_interfaces::msg::SetParametersResult
 __check_parameters(
-  std::map<std::string, rclcpp::node_interfaces::ParameterInfo> & parameter_infos,
+  rclcpp::node_interfaces::ParameterInfos & parameter_infos,
   const std::vector<rclcpp::Parameter> & parameters,
   bool allow_undeclared)
 {
@@ -397,7 +402,7 @@ RCLCPP_LOCAL
 rcl_interfaces::msg::SetParametersResult
 __set_parameters_atomically_common(
   const std::vector<rclcpp::Parameter> & parameters,
-  std::map<std::string, rclcpp::node_interfaces::ParameterInfo> & parameter_infos,
+  rclcpp::node_interfaces::ParameterInfos & parameter_infos,
   OnSetCallbacksHandleContainer & on_set_callback_container,
   PostSetCallbacksHandleContainer & post_set_callback_container,
   bool allow_undeclared = false)
@@ -436,16 +441,15 @@ __declare_parameter_common(
   const std::string & name,
   const rclcpp::ParameterValue & default_value,
   const rcl_interfaces::msg::ParameterDescriptor & parameter_descriptor,
-  std::map<std::string, rclcpp::node_interfaces::ParameterInfo> & parameters_out,
+  rclcpp::node_interfaces::ParameterInfos & parameters_out,
   const std::map<std::string, rclcpp::ParameterValue> & overrides,
   OnSetCallbacksHandleContainer & on_set_callback_container,
   PostSetCallbacksHandleContainer & post_set_callback_container,
   rcl_interfaces::msg::ParameterEvent * parameter_event_out,
   bool ignore_override = false)
 {
-  using rclcpp::node_interfaces::ParameterInfo;
-  std::map<std::string, ParameterInfo> parameter_infos {{name, ParameterInfo()}};
-  parameter_infos.at(name).descriptor = parameter_descriptor;
+  rclcpp::node_interfaces::ParameterInfos parameter_infos;
+  parameter_infos[name].descriptor = parameter_descriptor;
 
   // Use the value from the overrides if available, otherwise use the default.
   const rclcpp::ParameterValue * initial_value = &default_value;
@@ -494,6 +498,26 @@ __declare_parameter_common(
   return result;
 }
 
+[[noreturn]]
+static
+void
+throw_declaration_failure(
+  const std::string & name,
+  const rcl_interfaces::msg::SetParametersResult & result)
+{
+  constexpr const char type_error_msg_start[] = "Wrong parameter type";
+  if (
+    0u == std::strncmp(
+      result.reason.c_str(), type_error_msg_start, sizeof(type_error_msg_start) - 1))
+  {
+    // TODO(ivanpauno): Refactor the logic so we don't need the above `strncmp` and we can
+    // detect between both exceptions more elegantly.
+    throw rclcpp::exceptions::InvalidParameterTypeException(name, result.reason);
+  }
+  throw rclcpp::exceptions::InvalidParameterValueException(
+          "parameter '" + name + "' could not be set: " + result.reason);
+}
+
 static
 const rclcpp::ParameterValue &
 declare_parameter_helper(
@@ -502,13 +526,11 @@ declare_parameter_helper(
   const rclcpp::ParameterValue & default_value,
   rcl_interfaces::msg::ParameterDescriptor parameter_descriptor,
   bool ignore_override,
-  std::map<std::string, rclcpp::node_interfaces::ParameterInfo> & parameters,
+  rclcpp::node_interfaces::ParameterInfos & parameters,
   const std::map<std::string, rclcpp::ParameterValue> & overrides,
   OnSetCallbacksHandleContainer & on_set_callback_container,
   PostSetCallbacksHandleContainer & post_set_callback_container,
-  rclcpp::Publisher<rcl_interfaces::msg::ParameterEvent> * events_publisher,
-  const std::string & combined_name,
-  rclcpp::node_interfaces::NodeClockInterface & node_clock)
+  rcl_interfaces::msg::ParameterEvent & parameter_event)
 {
   // TODO(sloretz) parameter name validation
   if (name.empty()) {
@@ -534,7 +556,6 @@ declare_parameter_helper(
     parameter_descriptor.type = static_cast<uint8_t>(type);
   }
 
-  rcl_interfaces::msg::ParameterEvent parameter_event;
   auto result = __declare_parameter_common(
     name,
     default_value,
@@ -548,24 +569,7 @@ declare_parameter_helper(
 
   // If it failed to be set, then throw an exception.
   if (!result.successful) {
-    constexpr const char type_error_msg_start[] = "Wrong parameter type";
-    if (
-      0u == std::strncmp(
-        result.reason.c_str(), type_error_msg_start, sizeof(type_error_msg_start) - 1))
-    {
-      // TODO(ivanpauno): Refactor the logic so we don't need the above `strncmp` and we can
-      // detect between both exceptions more elegantly.
-      throw rclcpp::exceptions::InvalidParameterTypeException(name, result.reason);
-    }
-    throw rclcpp::exceptions::InvalidParameterValueException(
-            "parameter '" + name + "' could not be set: " + result.reason);
-  }
-
-  // Publish if events_publisher_ is not nullptr, which may be if disabled in the constructor.
-  if (nullptr != events_publisher) {
-    parameter_event.node = combined_name;
-    parameter_event.stamp = node_clock.get_clock()->now();
-    events_publisher->publish(parameter_event);
+    throw_declaration_failure(name, result);
   }
 
   return parameters.at(name).value;
@@ -581,7 +585,8 @@ NodeParameters::declare_parameter(
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   ParameterMutationRecursionGuard guard(parameter_modification_enabled_);
 
-  return declare_parameter_helper(
+  rcl_interfaces::msg::ParameterEvent parameter_event;
+  const rclcpp::ParameterValue & value = declare_parameter_helper(
     name,
     rclcpp::PARAMETER_NOT_SET,
     default_value,
@@ -591,9 +596,9 @@ NodeParameters::declare_parameter(
     parameter_overrides_,
     on_set_parameters_callback_container_,
     post_set_parameters_callback_container_,
-    events_publisher_.get(),
-    combined_name_,
-    *node_clock_);
+    parameter_event);
+  publish_parameter_event(parameter_event);
+  return value;
 }
 
 const rclcpp::ParameterValue &
@@ -617,7 +622,8 @@ NodeParameters::declare_parameter(
             "with `dynamic_typing=true`"};
   }
 
-  return declare_parameter_helper(
+  rcl_interfaces::msg::ParameterEvent parameter_event;
+  const rclcpp::ParameterValue & value = declare_parameter_helper(
     name,
     type,
     rclcpp::ParameterValue{},
@@ -627,9 +633,102 @@ NodeParameters::declare_parameter(
     parameter_overrides_,
     on_set_parameters_callback_container_,
     post_set_parameters_callback_container_,
-    events_publisher_.get(),
-    combined_name_,
-    *node_clock_);
+    parameter_event);
+  publish_parameter_event(parameter_event);
+  return value;
+}
+
+std::vector<rclcpp::ParameterValue>
+NodeParameters::declare_parameters_bulk(
+  const ParameterDeclarations & parameters,
+  bool ignore_overrides)
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  ParameterMutationRecursionGuard guard(parameter_modification_enabled_);
+
+  // Check all the declarations before declaring any of them, so that none is on failure.
+  rclcpp::node_interfaces::ParameterInfos parameter_infos;
+  std::vector<rclcpp::Parameter> initial_parameters;
+  initial_parameters.reserve(parameters.size());
+  for (const auto & parameter_and_descriptor : parameters) {
+    const rclcpp::Parameter & parameter = parameter_and_descriptor.first;
+    const std::string & name = parameter.get_name();
+    if (name.empty()) {
+      throw rclcpp::exceptions::InvalidParametersException("parameter name must not be empty");
+    }
+    if (__lockless_has_parameter(parameters_, name) ||
+      __lockless_has_parameter(parameter_infos, name))
+    {
+      throw rclcpp::exceptions::ParameterAlreadyDeclaredException(
+              "parameter '" + name + "' has already been declared");
+    }
+
+    auto & descriptor = parameter_infos[name].descriptor;
+    descriptor = parameter_and_descriptor.second;
+    descriptor.name = name;
+    if (!descriptor.dynamic_typing) {
+      // Without a default value, the type is the one of the descriptor.
+      if (rclcpp::PARAMETER_NOT_SET != parameter.get_type()) {
+        descriptor.type = static_cast<uint8_t>(parameter.get_type());
+      }
+      if (rclcpp::PARAMETER_NOT_SET == descriptor.type) {
+        throw rclcpp::exceptions::InvalidParameterTypeException{
+                name,
+                "cannot declare a statically typed parameter with an uninitialized value"
+        };
+      }
+    } else {
+      descriptor.type = rclcpp::PARAMETER_NOT_SET;
+    }
+
+    // Use the value from the overrides if available, otherwise use the default.
+    const rclcpp::ParameterValue * initial_value = &parameter.get_parameter_value();
+    auto overrides_it = parameter_overrides_.find(name);
+    if (!ignore_overrides && overrides_it != parameter_overrides_.end()) {
+      initial_value = &overrides_it->second;
+    }
+    if (initial_value->get_type() != rclcpp::PARAMETER_NOT_SET) {
+      initial_parameters.emplace_back(name, *initial_value);
+      auto result = __check_parameters(parameter_infos, {initial_parameters.back()}, false);
+      if (!result.successful) {
+        throw_declaration_failure(name, result);
+      }
+    }
+  }
+
+  // The callbacks are called once, with all the initial values.
+  if (!initial_parameters.empty()) {
+    auto result = __call_on_set_parameters_callbacks(
+      initial_parameters, on_set_parameters_callback_container_);
+    if (!result.successful) {
+      throw rclcpp::exceptions::InvalidParameterValueException(
+              "parameters could not be declared: " + result.reason);
+    }
+    for (const auto & parameter : initial_parameters) {
+      auto & parameter_info = parameter_infos[parameter.get_name()];
+      parameter_info.descriptor.type = parameter.get_type();
+      parameter_info.value = parameter.get_parameter_value();
+    }
+    __call_post_set_parameters_callbacks(
+      initial_parameters, post_set_parameters_callback_container_);
+  }
+
+  std::vector<rclcpp::ParameterValue> values;
+  values.reserve(parameters.size());
+  for (const auto & parameter_and_descriptor : parameters) {
+    const std::string & name = parameter_and_descriptor.first.get_name();
+    auto & parameter_info = parameters_[name];
+    parameter_info = std::move(parameter_infos[name]);
+    values.push_back(parameter_info.value);
+  }
+
+  rcl_interfaces::msg::ParameterEvent parameter_event;
+  parameter_event.new_parameters.reserve(initial_parameters.size());
+  for (const auto & parameter : initial_parameters) {
+    parameter_event.new_parameters.push_back(parameter.to_parameter_msg());
+  }
+  publish_parameter_event(parameter_event);
+  return values;
 }
 
 void
@@ -757,9 +856,8 @@ NodeParameters::set_parameters_atomically(const std::vector<rclcpp::Parameter> &
   // We will use the staged changes as input to the "set atomically" action.
   // We explicitly avoid calling the user callbacks here, so that it may be called once, with
   // all the other parameters to be set (already declared parameters).
-  std::map<std::string, rclcpp::node_interfaces::ParameterInfo> staged_parameter_changes;
+  rclcpp::node_interfaces::ParameterInfos staged_parameter_changes;
   rcl_interfaces::msg::ParameterEvent parameter_event_msg;
-  parameter_event_msg.node = combined_name_;
   OnSetCallbacksHandleContainer empty_on_set_callback_container;
   PostSetCallbacksHandleContainer empty_post_set_callback_container;
 
@@ -893,11 +991,7 @@ NodeParameters::set_parameters_atomically(const std::vector<rclcpp::Parameter> &
     parameter_event_msg.changed_parameters.push_back(parameter.to_parameter_msg());
   }
 
-  // Publish if events_publisher_ is not nullptr, which may be if disabled in the constructor.
-  if (nullptr != events_publisher_) {
-    parameter_event_msg.stamp = node_clock_->get_clock()->now();
-    events_publisher_->publish(parameter_event_msg);
-  }
+  publish_parameter_event(parameter_event_msg);
   return result;
 }
 
@@ -964,10 +1058,18 @@ NodeParameters::get_parameters_by_prefix(
   std::string prefix_with_dot = prefix.empty() ? prefix : prefix + ".";
   bool ret = false;
 
-  for (const auto & param : parameters_) {
-    if (param.first.find(prefix_with_dot) == 0 && param.first.length() > prefix_with_dot.length()) {
+  using rclcpp::node_interfaces::detail::ParameterNameIndex;
+  std::vector<std::string> names;
+  if (prefix.empty()) {
+    parameters_.get_name_index().collect(ParameterNameIndex::unlimited_segments, names);
+  } else {
+    parameters_.get_name_index().collect(
+      prefix, 1, ParameterNameIndex::unlimited_segments, names);
+  }
+  for (const auto & name : names) {
+    if (name.length() > prefix_with_dot.length()) {
       // Found one!
-      parameters[param.first.substr(prefix_with_dot.length())] = rclcpp::Parameter(param.second);
+      parameters[name.substr(prefix_with_dot.length())] = rclcpp::Parameter(parameters_.at(name));
       ret = true;
     }
   }
@@ -1037,38 +1139,41 @@ NodeParameters::list_parameters(const std::vector<std::string> & prefixes, uint6
 
   // TODO(mikaelarguedas) define parameter separator different from "/" to avoid ambiguity
   // using "." for now
-  const char * separator = ".";
-  for (auto & kv : parameters_) {
-    bool get_all = (prefixes.size() == 0) &&
-      ((depth == rcl_interfaces::srv::ListParameters::Request::DEPTH_RECURSIVE) ||
-      (static_cast<uint64_t>(std::count(kv.first.begin(), kv.first.end(), *separator)) < depth));
-    bool prefix_matches = std::any_of(
-      prefixes.cbegin(), prefixes.cend(),
-      [&kv, &depth, &separator](const std::string & prefix) {
-        if (kv.first == prefix) {
-          return true;
-        } else if (kv.first.find(prefix + separator) == 0) {
-          size_t length = prefix.length();
-          std::string substr = kv.first.substr(length);
-          // Cast as unsigned integer to avoid warning
-          return (depth == rcl_interfaces::srv::ListParameters::Request::DEPTH_RECURSIVE) ||
-          (static_cast<uint64_t>(std::count(substr.begin(), substr.end(), *separator)) < depth);
-        }
-        return false;
-      });
-    if (get_all || prefix_matches) {
-      result.names.push_back(kv.first);
-      size_t last_separator = kv.first.find_last_of(separator);
-      if (std::string::npos != last_separator) {
-        std::string prefix = kv.first.substr(0, last_separator);
-        if (
-          std::find(result.prefixes.cbegin(), result.prefixes.cend(), prefix) ==
-          result.prefixes.cend())
-        {
-          result.prefixes.push_back(prefix);
-        }
+  const char separator = '.';
+
+  // The names are found in the prefix tree of the names, so that only the
+  // parameters listed are visited.
+  using rclcpp::node_interfaces::detail::ParameterNameIndex;
+  const bool recursive = depth == rcl_interfaces::srv::ListParameters::Request::DEPTH_RECURSIVE;
+  std::vector<std::string> names;
+  if (prefixes.empty()) {
+    // The names with less than depth separators.
+    parameters_.get_name_index().collect(
+      recursive ? ParameterNameIndex::unlimited_segments : static_cast<size_t>(depth), names);
+  } else {
+    for (const auto & prefix : prefixes) {
+      // The prefix itself, and the names with less than depth separators after the prefix.
+      parameters_.get_name_index().collect(
+        prefix, 0,
+        recursive ? ParameterNameIndex::unlimited_segments : static_cast<size_t>(depth - 1),
+        names);
+    }
+  }
+  // Listed in the order of the names, as they were when stored in a std::map.
+  std::sort(names.begin(), names.end());
+  // A name may have multiple of the prefixes.
+  names.erase(std::unique(names.begin(), names.end()), names.end());
+
+  std::unordered_set<std::string> listed_prefixes;
+  for (auto & name : names) {
+    size_t last_separator = name.find_last_of(separator);
+    if (std::string::npos != last_separator) {
+      std::string prefix = name.substr(0, last_separator);
+      if (listed_prefixes.insert(prefix).second) {
+        result.prefixes.push_back(std::move(prefix));
       }
     }
+    result.names.push_back(std::move(name));
   }
   return result;
 }
@@ -1178,3 +1283,100 @@ NodeParameters::get_parameter_overrides() const
 {
   return parameter_overrides_;
 }
+
+void
+NodeParameters::begin_parameter_event_batch()
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  parameter_event_batch_depth_++;
+}
+
+void
+NodeParameters::end_parameter_event_batch()
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  if (0u == parameter_event_batch_depth_) {
+    throw std::runtime_error("no parameter event batch was started");
+  }
+  if (0u != --parameter_event_batch_depth_) {
+    return;
+  }
+
+  rcl_interfaces::msg::ParameterEvent parameter_event;
+  for (const auto & name : pending_parameter_names_) {
+    // Names are listed again if they were changed after being dropped.
+    auto it = pending_parameter_changes_.find(name);
+    if (pending_parameter_changes_.end() == it) {
+      continue;
+    }
+    switch (it->second.first) {
+      case ParameterChange::New:
+        parameter_event.new_parameters.push_back(std::move(it->second.second));
+        break;
+      case ParameterChange::Changed:
+        parameter_event.changed_parameters.push_back(std::move(it->second.second));
+        break;
+      case ParameterChange::Deleted:
+        parameter_event.deleted_parameters.push_back(std::move(it->second.second));
+        break;
+    }
+    pending_parameter_changes_.erase(it);
+  }
+  pending_parameter_names_.clear();
+  if (
+    !parameter_event.new_parameters.empty() || !parameter_event.changed_parameters.empty() ||
+    !parameter_event.deleted_parameters.empty())
+  {
+    publish_parameter_event(parameter_event);
+  }
+}
+
+void
+NodeParameters::publish_parameter_event(rcl_interfaces::msg::ParameterEvent & parameter_event)
+{
+  // Publish if events_publisher_ is not nullptr, which may be if disabled in the constructor.
+  if (nullptr == events_publisher_) {
+    return;
+  }
+  if (0u != parameter_event_batch_depth_) {
+    for (const auto & parameter : parameter_event.new_parameters) {
+      add_pending_parameter_change(ParameterChange::New, parameter);
+    }
+    for (const auto & parameter : parameter_event.changed_parameters) {
+      add_pending_parameter_change(ParameterChange::Changed, parameter);
+    }
+    for (const auto & parameter : parameter_event.deleted_parameters) {
+      add_pending_parameter_change(ParameterChange::Deleted, parameter);
+    }
+    return;
+  }
+  parameter_event.node = combined_name_;
+  parameter_event.stamp = node_clock_->get_clock()->now();
+  events_publisher_->publish(parameter_event);
+}
+
+void
+NodeParameters::add_pending_parameter_change(
+  ParameterChange change,
+  const rcl_interfaces::msg::Parameter & parameter)
+{
+  auto it = pending_parameter_changes_.find(parameter.name);
+  if (pending_parameter_changes_.end() == it) {
+    pending_parameter_changes_.emplace(parameter.name, std::make_pair(change, parameter));
+    pending_parameter_names_.push_back(parameter.name);
+    return;
+  }
+  ParameterChange & pending_change = it->second.first;
+  if (ParameterChange::New == pending_change && ParameterChange::Deleted == change) {
+    // Declared and undeclared during the batch, so it was never seen by the subscribers.
+    pending_parameter_changes_.erase(it);
+    return;
+  }
+  if (ParameterChange::Deleted == pending_change && ParameterChange::New == change) {
+    // Undeclared and declared again, the subscribers only see its new value.
+    pending_change = ParameterChange::Changed;
+  } else if (ParameterChange::New != pending_change) {
+    pending_change = change;
+  }
+  it->second.second = parameter;
+}
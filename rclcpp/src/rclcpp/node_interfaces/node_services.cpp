@@ -40,12 +40,15 @@ NodeServices::add_service(
   }
 
   group->add_service(service_base_ptr);
+  if (node_base_->get_use_intra_process_default() &&
+    service_base_ptr->setup_intra_process(service_base_ptr, node_base_->get_context()))
+  {
+    group->add_waitable(service_base_ptr->get_intra_process_waitable());
+  }
 
   // Notify the executor that a new service was created using the parent Node.
-  auto & node_gc = node_base_->get_notify_guard_condition();
   try {
-    node_gc.trigger();
-    group->trigger_notify_guard_condition();
+    node_base_->trigger_notify_guard_condition(group);
   } catch (const rclcpp::exceptions::RCLError & ex) {
     throw std::runtime_error(
             std::string("failed to notify wait set on service creation: ") + ex.what());
@@ -67,12 +70,15 @@ NodeServices::add_client(
   }
 
   group->add_client(client_base_ptr);
+  if (node_base_->get_use_intra_process_default() &&
+    client_base_ptr->setup_intra_process(client_base_ptr))
+  {
+    group->add_waitable(client_base_ptr->get_intra_process_waitable());
+  }
 
   // Notify the executor that a new client was created using the parent Node.
-  auto & node_gc = node_base_->get_notify_guard_condition();
   try {
-    node_gc.trigger();
-    group->trigger_notify_guard_condition();
+    node_base_->trigger_notify_guard_condition(group);
   } catch (const rclcpp::exceptions::RCLError & ex) {
     throw std::runtime_error(
             std::string("failed to notify wait set on client creation: ") + ex.what());
@@ -23,6 +23,7 @@
 #include "rclcpp/node_interfaces/node_timers_interface.hpp"
 #include "rclcpp/publisher_base.hpp"
 #include "rclcpp/publisher_factory.hpp"
+#include "rclcpp/qos_event_handler_group.hpp"
 #include "rclcpp/subscription_base.hpp"
 #include "rclcpp/subscription_factory.hpp"
 #include "rclcpp/qos.hpp"
@@ -64,16 +65,19 @@ NodeTopics::add_publisher(
     callback_group = node_base_->get_default_callback_group();
   }
 
+  auto event_handler_group = publisher->get_event_handler_group();
   for (auto & key_event_pair : publisher->get_event_handlers()) {
     auto publisher_event = key_event_pair.second;
-    callback_group->add_waitable(publisher_event);
+    if (event_handler_group) {
+      event_handler_group->add(publisher_event);
+    } else {
+      callback_group->add_waitable(publisher_event);
+    }
   }
 
   // Notify the executor that a new publisher was created using the parent Node.
-  auto & node_gc = node_base_->get_notify_guard_condition();
   try {
-    node_gc.trigger();
-    callback_group->trigger_notify_guard_condition();
+    node_base_->trigger_notify_guard_condition(callback_group);
   } catch (const rclcpp::exceptions::RCLError & ex) {
     throw std::runtime_error(
             std::string("failed to notify wait set on publisher creation: ") + ex.what());
@@ -107,9 +111,14 @@ NodeTopics::add_subscription(
 
   callback_group->add_subscription(subscription);
 
+  auto event_handler_group = subscription->get_event_handler_group();
   for (auto & key_event_pair : subscription->get_event_handlers()) {
     auto subscription_event = key_event_pair.second;
-    callback_group->add_waitable(subscription_event);
+    if (event_handler_group) {
+      event_handler_group->add(subscription_event);
+    } else {
+      callback_group->add_waitable(subscription_event);
+    }
   }
 
   auto intra_process_waitable = subscription->get_intra_process_waitable();
@@ -118,11 +127,15 @@ NodeTopics::add_subscription(
     callback_group->add_waitable(intra_process_waitable);
   }
 
+  auto deserialization_waitable = subscription->get_deserialization_waitable();
+  if (nullptr != deserialization_waitable) {
+    // Add to the callback group to handle the messages deserialized by the pool.
+    callback_group->add_waitable(deserialization_waitable);
+  }
+
   // Notify the executor that a new subscription was created using the parent Node.
-  auto & node_gc = node_base_->get_notify_guard_condition();
   try {
-    node_gc.trigger();
-    callback_group->trigger_notify_guard_condition();
+    node_base_->trigger_notify_guard_condition(callback_group);
   } catch (const rclcpp::exceptions::RCLError & ex) {
     throw std::runtime_error(
             std::string("failed to notify wait set on subscription creation: ") + ex.what());
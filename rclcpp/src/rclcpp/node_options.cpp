@@ -80,6 +80,8 @@ NodeOptions::operator=(const NodeOptions & other)
     this->clock_type_ = other.clock_type_;
     this->clock_qos_ = other.clock_qos_;
     this->use_clock_thread_ = other.use_clock_thread_;
+    this->use_shared_clock_subscription_ = other.use_shared_clock_subscription_;
+    this->cache_graph_queries_ = other.cache_graph_queries_;
     this->parameter_event_qos_ = other.parameter_event_qos_;
     this->rosout_qos_ = other.rosout_qos_;
     this->parameter_event_publisher_options_ = other.parameter_event_publisher_options_;
@@ -91,6 +93,16 @@ NodeOptions::operator=(const NodeOptions & other)
   return *this;
 }
 
+NodeOptions
+NodeOptions::minimal(rcl_allocator_t allocator)
+{
+  NodeOptions options(allocator);
+  options.start_parameter_services(false);
+  options.start_parameter_event_publisher(false);
+  options.enable_rosout(false);
+  return options;
+}
+
 const rcl_node_options_t *
 NodeOptions::get_rcl_node_options() const
 {
@@ -300,6 +312,32 @@ NodeOptions::use_clock_thread(bool use_clock_thread)
   return *this;
 }
 
+bool
+NodeOptions::use_shared_clock_subscription() const
+{
+  return this->use_shared_clock_subscription_;
+}
+
+NodeOptions &
+NodeOptions::use_shared_clock_subscription(bool use_shared_clock_subscription)
+{
+  this->use_shared_clock_subscription_ = use_shared_clock_subscription;
+  return *this;
+}
+
+bool
+NodeOptions::cache_graph_queries() const
+{
+  return this->cache_graph_queries_;
+}
+
+NodeOptions &
+NodeOptions::cache_graph_queries(bool cache_graph_queries)
+{
+  this->cache_graph_queries_ = cache_graph_queries;
+  return *this;
+}
+
 const rclcpp::QoS &
 NodeOptions::parameter_event_qos() const
 {
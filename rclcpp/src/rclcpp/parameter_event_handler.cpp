@@ -68,8 +68,13 @@ ParameterEventHandler::add_parameter_callback(
   handle->callback = callback;
   handle->parameter_name = parameter_name;
   handle->node_name = full_node_name;
+  auto & node_callbacks = callbacks_->parameter_callbacks_[full_node_name];
+  const bool new_node = node_callbacks.empty();
   // the last callback registered is executed first.
-  callbacks_->parameter_callbacks_[{parameter_name, full_node_name}].emplace_front(handle);
+  node_callbacks[parameter_name].emplace_front(handle);
+  if (new_node) {
+    update_node_content_filter();
+  }
 
   return handle;
 }
@@ -80,21 +85,33 @@ ParameterEventHandler::remove_parameter_callback(
 {
   std::lock_guard<std::recursive_mutex> lock(callbacks_->mutex_);
   auto handle = callback_handle.get();
-  auto & container = callbacks_->parameter_callbacks_[{handle->parameter_name, handle->node_name}];
+  auto node_it = callbacks_->parameter_callbacks_.find(handle->node_name);
+  if (node_it == callbacks_->parameter_callbacks_.end()) {
+    throw std::runtime_error("Callback doesn't exist");
+  }
+  auto & node_callbacks = node_it->second;
+  auto container_it = node_callbacks.find(handle->parameter_name);
+  if (container_it == node_callbacks.end()) {
+    throw std::runtime_error("Callback doesn't exist");
+  }
+  auto & container = container_it->second;
   auto it = std::find_if(
     container.begin(),
     container.end(),
     [handle](const auto & weak_handle) {
       return handle == weak_handle.lock().get();
     });
-  if (it != container.end()) {
-    container.erase(it);
-    if (container.empty()) {
-      callbacks_->parameter_callbacks_.erase({handle->parameter_name, handle->node_name});
-    }
-  } else {
+  if (it == container.end()) {
     throw std::runtime_error("Callback doesn't exist");
   }
+  container.erase(it);
+  if (container.empty()) {
+    node_callbacks.erase(container_it);
+    if (node_callbacks.empty()) {
+      callbacks_->parameter_callbacks_.erase(node_it);
+      update_node_content_filter();
+    }
+  }
 }
 
 bool
@@ -166,24 +183,39 @@ ParameterEventHandler::Callbacks::event_callback(const rcl_interfaces::msg::Para
 {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
 
-  for (auto it = parameter_callbacks_.begin(); it != parameter_callbacks_.end(); ++it) {
-    rclcpp::Parameter p;
-    if (get_parameter_from_event(event, p, it->first.first, it->first.second)) {
-      for (auto cb = it->second.begin(); cb != it->second.end(); ++cb) {
-        auto shared_handle = cb->lock();
-        if (nullptr != shared_handle) {
-          shared_handle->callback(p);
-        } else {
-          cb = it->second.erase(cb);
+  auto node_it = parameter_callbacks_.find(event.node);
+  if (node_it != parameter_callbacks_.end()) {
+    auto & node_callbacks = node_it->second;
+    auto call_parameter_callbacks =
+      [&node_callbacks](const rcl_interfaces::msg::Parameter & parameter) {
+        auto it = node_callbacks.find(parameter.name);
+        if (it == node_callbacks.end()) {
+          return;
         }
-      }
+        rclcpp::Parameter p = rclcpp::Parameter::from_parameter_msg(parameter);
+        for (auto cb = it->second.begin(); cb != it->second.end(); ) {
+          auto shared_handle = cb->lock();
+          if (nullptr != shared_handle) {
+            shared_handle->callback(p);
+            ++cb;
+          } else {
+            cb = it->second.erase(cb);
+          }
+        }
+      };
+    for (const auto & new_parameter : event.new_parameters) {
+      call_parameter_callbacks(new_parameter);
+    }
+    for (const auto & changed_parameter : event.changed_parameters) {
+      call_parameter_callbacks(changed_parameter);
     }
   }
 
-  for (auto event_cb = event_callbacks_.begin(); event_cb != event_callbacks_.end(); ++event_cb) {
+  for (auto event_cb = event_callbacks_.begin(); event_cb != event_callbacks_.end(); ) {
     auto shared_event_handle = event_cb->lock();
     if (nullptr != shared_event_handle) {
       shared_event_handle->callback(event);
+      ++event_cb;
     } else {
       event_cb = event_callbacks_.erase(event_cb);
     }
@@ -209,4 +241,38 @@ ParameterEventHandler::resolve_path(const std::string & path)
   return full_path;
 }
 
+rclcpp::ContentFilterOptions
+ParameterEventHandler::get_node_content_filter(const std::vector<std::string> & node_names)
+{
+  rclcpp::ContentFilterOptions options;
+  const std::string own_node_name = node_base_->get_fully_qualified_name();
+  options.filter_expression = "node = %0";
+  options.expression_parameters.push_back("'" + own_node_name + "'");
+  for (const auto & node_name : node_names) {
+    if (node_name == own_node_name) {
+      continue;
+    }
+    options.filter_expression +=
+      " OR node = %" + std::to_string(options.expression_parameters.size());
+    options.expression_parameters.push_back("'" + node_name + "'");
+  }
+  return options;
+}
+
+void
+ParameterEventHandler::update_node_content_filter()
+{
+  if (!filter_by_node_) {
+    return;
+  }
+  std::vector<std::string> node_names;
+  node_names.reserve(callbacks_->parameter_callbacks_.size());
+  for (const auto & pair : callbacks_->parameter_callbacks_) {
+    node_names.push_back(pair.first);
+  }
+  auto options = get_node_content_filter(node_names);
+  event_subscription_->set_content_filter(
+    options.filter_expression, options.expression_parameters);
+}
+
 }  // namespace rclcpp
@@ -12,8 +12,21 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <string>
 #include <regex>
+#include <utility>
 #include <vector>
 
 #include "rcpputils/find_and_replace.hpp"
@@ -161,6 +174,359 @@ rclcpp::parameter_map_from_yaml_file(const std::string & yaml_filename, const ch
   return rclcpp::parameter_map_from(rcl_parameters, node_fqn);
 }
 
+namespace
+{
+
+constexpr char snapshot_magic[] = {'R', 'C', 'L', 'P', 'S', 'N', 'A', 'P'};
+constexpr uint32_t snapshot_byte_order_mark = 0x01020304;
+constexpr uint32_t snapshot_version = 1;
+
+class SnapshotWriter
+{
+public:
+  template<typename T>
+  void
+  write(T value)
+  {
+    buffer_.append(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  void
+  write_size(size_t size)
+  {
+    if (size > UINT32_MAX) {
+      throw InvalidParametersException("parameter snapshot entry is too large");
+    }
+    write(static_cast<uint32_t>(size));
+  }
+
+  void
+  write_string(const std::string & value)
+  {
+    write_size(value.size());
+    buffer_.append(value);
+  }
+
+  template<typename T>
+  void
+  write_array(const std::vector<T> & values)
+  {
+    write_size(values.size());
+    for (const auto & value : values) {
+      write<T>(value);
+    }
+  }
+
+  void
+  write_value(const ParameterValue & value)
+  {
+    write(static_cast<uint8_t>(value.get_type()));
+    switch (value.get_type()) {
+      case rclcpp::PARAMETER_NOT_SET:
+        break;
+      case rclcpp::PARAMETER_BOOL:
+        write<uint8_t>(value.get<bool>() ? 1 : 0);
+        break;
+      case rclcpp::PARAMETER_INTEGER:
+        write<int64_t>(value.get<int64_t>());
+        break;
+      case rclcpp::PARAMETER_DOUBLE:
+        write<double>(value.get<double>());
+        break;
+      case rclcpp::PARAMETER_STRING:
+        write_string(value.get<std::string>());
+        break;
+      case rclcpp::PARAMETER_BYTE_ARRAY:
+        write_array(value.get<std::vector<uint8_t>>());
+        break;
+      case rclcpp::PARAMETER_BOOL_ARRAY:
+        {
+          const auto & bools = value.get<std::vector<bool>>();
+          write_size(bools.size());
+          for (bool b : bools) {
+            write<uint8_t>(b ? 1 : 0);
+          }
+          break;
+        }
+      case rclcpp::PARAMETER_INTEGER_ARRAY:
+        write_array(value.get<std::vector<int64_t>>());
+        break;
+      case rclcpp::PARAMETER_DOUBLE_ARRAY:
+        write_array(value.get<std::vector<double>>());
+        break;
+      case rclcpp::PARAMETER_STRING_ARRAY:
+        {
+          const auto & strings = value.get<std::vector<std::string>>();
+          write_size(strings.size());
+          for (const auto & string : strings) {
+            write_string(string);
+          }
+          break;
+        }
+      default:
+        throw InvalidParameterValueException("unknown parameter type in parameter snapshot");
+    }
+  }
+
+  const std::string &
+  buffer() const
+  {
+    return buffer_;
+  }
+
+private:
+  std::string buffer_;
+};
+
+class SnapshotReader
+{
+public:
+  SnapshotReader(const char * data, size_t size)
+  : data_(data), size_(size)
+  {}
+
+  template<typename T>
+  T
+  read()
+  {
+    T value;
+    std::memcpy(&value, consume(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  size_t
+  read_size()
+  {
+    return read<uint32_t>();
+  }
+
+  std::string
+  read_string()
+  {
+    const size_t size = read_size();
+    return std::string(consume(size), size);
+  }
+
+  template<typename T, typename StoredT = T>
+  std::vector<T>
+  read_array()
+  {
+    const size_t size = read_size();
+    // The size is checked first, so that a corrupted one doesn't allocate a huge vector
+    const char * values = consume(size * sizeof(StoredT));
+    std::vector<T> result;
+    result.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+      StoredT value;
+      std::memcpy(&value, values + i * sizeof(StoredT), sizeof(StoredT));
+      result.push_back(static_cast<T>(value));
+    }
+    return result;
+  }
+
+  ParameterValue
+  read_value()
+  {
+    switch (read<uint8_t>()) {
+      case rclcpp::PARAMETER_NOT_SET:
+        return ParameterValue();
+      case rclcpp::PARAMETER_BOOL:
+        return ParameterValue(read<uint8_t>() != 0);
+      case rclcpp::PARAMETER_INTEGER:
+        return ParameterValue(read<int64_t>());
+      case rclcpp::PARAMETER_DOUBLE:
+        return ParameterValue(read<double>());
+      case rclcpp::PARAMETER_STRING:
+        return ParameterValue(read_string());
+      case rclcpp::PARAMETER_BYTE_ARRAY:
+        return ParameterValue(read_array<uint8_t>());
+      case rclcpp::PARAMETER_BOOL_ARRAY:
+        return ParameterValue(read_array<bool, uint8_t>());
+      case rclcpp::PARAMETER_INTEGER_ARRAY:
+        return ParameterValue(read_array<int64_t>());
+      case rclcpp::PARAMETER_DOUBLE_ARRAY:
+        return ParameterValue(read_array<double>());
+      case rclcpp::PARAMETER_STRING_ARRAY:
+        {
+          const size_t size = read_size();
+          std::vector<std::string> strings;
+          // Each string is at least its size
+          strings.reserve(std::min(size, remaining() / sizeof(uint32_t)));
+          for (size_t i = 0; i < size; ++i) {
+            strings.push_back(read_string());
+          }
+          return ParameterValue(strings);
+        }
+      default:
+        throw InvalidParametersException("unknown parameter type in parameter snapshot");
+    }
+  }
+
+  const char *
+  consume(size_t size)
+  {
+    if (size > remaining()) {
+      throw InvalidParametersException("parameter snapshot is truncated");
+    }
+    const char * data = data_ + position_;
+    position_ += size;
+    return data;
+  }
+
+  size_t
+  remaining() const
+  {
+    return size_ - position_;
+  }
+
+private:
+  const char * data_;
+  size_t size_;
+  size_t position_ = 0;
+};
+
+/// Contents of a snapshot file, memory-mapped where possible.
+class SnapshotFile
+{
+public:
+  explicit SnapshotFile(const std::string & filename)
+  {
+#ifndef _WIN32
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw InvalidParametersException("failed to open parameter snapshot '" + filename + "'");
+    }
+    RCPPUTILS_SCOPE_EXIT(close(fd); );
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+      throw InvalidParametersException("failed to stat parameter snapshot '" + filename + "'");
+    }
+    size_ = static_cast<size_t>(file_stat.st_size);
+    if (size_ == 0) {
+      return;
+    }
+    void * mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == mapped) {
+      throw InvalidParametersException("failed to map parameter snapshot '" + filename + "'");
+    }
+    mapped_ = mapped;
+    data_ = static_cast<const char *>(mapped);
+#else
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+      throw InvalidParametersException("failed to open parameter snapshot '" + filename + "'");
+    }
+    buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+  }
+
+  ~SnapshotFile()
+  {
+#ifndef _WIN32
+    if (mapped_) {
+      munmap(mapped_, size_);
+    }
+#endif
+  }
+
+  SnapshotFile(const SnapshotFile &) = delete;
+  SnapshotFile & operator=(const SnapshotFile &) = delete;
+
+  const char * data() const {return data_;}
+  size_t size() const {return size_;}
+
+private:
+  const char * data_ = nullptr;
+  size_t size_ = 0;
+#ifndef _WIN32
+  void * mapped_ = nullptr;
+#else
+  std::string buffer_;
+#endif
+};
+
+}  // namespace
+
+void
+rclcpp::parameter_map_to_snapshot_file(
+  const ParameterMap & parameter_map, const std::string & snapshot_filename)
+{
+  SnapshotWriter writer;
+  for (char c : snapshot_magic) {
+    writer.write(c);
+  }
+  writer.write(snapshot_byte_order_mark);
+  writer.write(snapshot_version);
+  writer.write_size(parameter_map.size());
+  for (const auto & [node_name, node_parameters] : parameter_map) {
+    writer.write_string(node_name);
+    writer.write_size(node_parameters.size());
+    for (const auto & parameter : node_parameters) {
+      writer.write_string(parameter.get_name());
+      writer.write_value(parameter.get_parameter_value());
+    }
+  }
+
+  std::ofstream file(snapshot_filename, std::ios::binary | std::ios::trunc);
+  file.write(writer.buffer().data(), static_cast<std::streamsize>(writer.buffer().size()));
+  file.close();
+  if (!file) {
+    throw InvalidParametersException(
+            "failed to write parameter snapshot '" + snapshot_filename + "'");
+  }
+}
+
+ParameterMap
+rclcpp::parameter_map_from_snapshot_file(
+  const std::string & snapshot_filename, const char * node_fqn)
+{
+  SnapshotFile file(snapshot_filename);
+  SnapshotReader reader(file.data(), file.size());
+
+  if (reader.remaining() < sizeof(snapshot_magic) ||
+    std::memcmp(reader.consume(sizeof(snapshot_magic)), snapshot_magic, sizeof(snapshot_magic)))
+  {
+    throw InvalidParametersException("'" + snapshot_filename + "' isn't a parameter snapshot");
+  }
+  if (reader.read<uint32_t>() != snapshot_byte_order_mark) {
+    throw InvalidParametersException(
+            "parameter snapshot '" + snapshot_filename + "' has a different byte order");
+  }
+  if (reader.read<uint32_t>() != snapshot_version) {
+    throw InvalidParametersException(
+            "parameter snapshot '" + snapshot_filename + "' has an unsupported version");
+  }
+
+  ParameterMap parameters;
+  const size_t num_nodes = reader.read_size();
+  for (size_t n = 0; n < num_nodes; ++n) {
+    std::string node_name = reader.read_string();
+    const size_t num_params = reader.read_size();
+    const bool skipped = node_fqn && !is_node_name_matched(node_name, node_fqn);
+    if (node_fqn && !skipped) {
+      node_name = node_fqn;
+    }
+
+    std::vector<Parameter> * params_node = skipped ? nullptr : &parameters[node_name];
+    for (size_t p = 0; p < num_params; ++p) {
+      // The parameters of the other nodes are still read, to find the next node
+      std::string param_name = reader.read_string();
+      ParameterValue param_value = reader.read_value();
+      if (params_node) {
+        params_node->emplace_back(std::move(param_name), std::move(param_value));
+      }
+    }
+  }
+  if (reader.remaining() != 0) {
+    throw InvalidParametersException(
+            "parameter snapshot '" + snapshot_filename + "' has trailing data");
+  }
+
+  return parameters;
+}
+
 std::vector<rclcpp::Parameter>
 rclcpp::parameters_from_map(const ParameterMap & parameter_map, const char * node_fqn)
 {
@@ -0,0 +1,330 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp/parameter_service_multiplexer.hpp"
+
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rclcpp/create_service.hpp"
+#include "rclcpp/exceptions.hpp"
+#include "rclcpp/logging.hpp"
+#include "rclcpp/parameter.hpp"
+
+#include "./parameter_service_names.hpp"
+
+using rclcpp::ParameterServiceMultiplexer;
+using rclcpp::node_interfaces::NodeParametersInterface;
+
+namespace
+{
+
+constexpr char node_separator = ':';
+
+std::string
+make_not_served_reason(const std::string & name)
+{
+  return "parameter '" + name + "' isn't named after a node served by the multiplexer";
+}
+
+}  // namespace
+
+ParameterServiceMultiplexer::ParameterServiceMultiplexer(
+  const std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> node_base,
+  const std::shared_ptr<rclcpp::node_interfaces::NodeServicesInterface> node_services,
+  const rclcpp::QoS & qos_profile)
+{
+  const std::string node_name = node_base->get_name();
+
+  get_parameters_service_ = create_service<rcl_interfaces::srv::GetParameters>(
+    node_base, node_services,
+    node_name + "/" + parameter_service_names::get_parameters,
+    [this](
+      const std::shared_ptr<rmw_request_id_t>,
+      const std::shared_ptr<rcl_interfaces::srv::GetParameters::Request> request,
+      std::shared_ptr<rcl_interfaces::srv::GetParameters::Response> response)
+    {
+      // Like with the parameter services of a node, no value is returned if one fails.
+      for (const auto & name : request->names) {
+        std::string node_name;
+        std::string parameter_name;
+        auto node_params = resolve(name, node_name, parameter_name);
+        try {
+          if (!node_params) {
+            throw rclcpp::exceptions::ParameterNotDeclaredException(make_not_served_reason(name));
+          }
+          auto parameters = node_params->get_parameters({parameter_name});
+          response->values.push_back(parameters.at(0).get_value_message());
+        } catch (const rclcpp::exceptions::ParameterNotDeclaredException & ex) {
+          RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "Failed to get parameters: %s", ex.what());
+          response->values.clear();
+          return;
+        } catch (const rclcpp::exceptions::ParameterUninitializedException & ex) {
+          RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "Failed to get parameters: %s", ex.what());
+          response->values.clear();
+          return;
+        }
+      }
+    },
+    qos_profile, nullptr);
+
+  get_parameter_types_service_ = create_service<rcl_interfaces::srv::GetParameterTypes>(
+    node_base, node_services,
+    node_name + "/" + parameter_service_names::get_parameter_types,
+    [this](
+      const std::shared_ptr<rmw_request_id_t>,
+      const std::shared_ptr<rcl_interfaces::srv::GetParameterTypes::Request> request,
+      std::shared_ptr<rcl_interfaces::srv::GetParameterTypes::Response> response)
+    {
+      for (const auto & name : request->names) {
+        std::string node_name;
+        std::string parameter_name;
+        auto node_params = resolve(name, node_name, parameter_name);
+        try {
+          if (!node_params) {
+            throw rclcpp::exceptions::ParameterNotDeclaredException(make_not_served_reason(name));
+          }
+          response->types.push_back(node_params->get_parameter_types({parameter_name}).at(0));
+        } catch (const rclcpp::exceptions::ParameterNotDeclaredException & ex) {
+          RCLCPP_DEBUG(
+            rclcpp::get_logger("rclcpp"), "Failed to get parameter types: %s", ex.what());
+          response->types.clear();
+          return;
+        }
+      }
+    },
+    qos_profile, nullptr);
+
+  set_parameters_service_ = create_service<rcl_interfaces::srv::SetParameters>(
+    node_base, node_services,
+    node_name + "/" + parameter_service_names::set_parameters,
+    [this](
+      const std::shared_ptr<rmw_request_id_t>,
+      const std::shared_ptr<rcl_interfaces::srv::SetParameters::Request> request,
+      std::shared_ptr<rcl_interfaces::srv::SetParameters::Response> response)
+    {
+      // Set parameters one-by-one, since there's no way to return a partial result if
+      // set_parameters() fails.
+      for (const auto & p : request->parameters) {
+        auto result = rcl_interfaces::msg::SetParametersResult();
+        std::string node_name;
+        std::string parameter_name;
+        auto node_params = resolve(p.name, node_name, parameter_name);
+        try {
+          if (!node_params) {
+            throw rclcpp::exceptions::ParameterNotDeclaredException(
+                    make_not_served_reason(p.name));
+          }
+          result = node_params->set_parameters_atomically(
+            {rclcpp::Parameter(parameter_name, rclcpp::ParameterValue(p.value))});
+        } catch (const rclcpp::exceptions::ParameterNotDeclaredException & ex) {
+          RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "Failed to set parameter: %s", ex.what());
+          result.successful = false;
+          result.reason = ex.what();
+        }
+        response->results.push_back(result);
+      }
+    },
+    qos_profile, nullptr);
+
+  set_parameters_atomically_service_ = create_service<rcl_interfaces::srv::SetParametersAtomically>(
+    node_base, node_services,
+    node_name + "/" + parameter_service_names::set_parameters_atomically,
+    [this](
+      const std::shared_ptr<rmw_request_id_t>,
+      const std::shared_ptr<rcl_interfaces::srv::SetParametersAtomically::Request> request,
+      std::shared_ptr<rcl_interfaces::srv::SetParametersAtomically::Response> response)
+    {
+      std::shared_ptr<NodeParametersInterface> node_params;
+      std::string node_name;
+      std::vector<rclcpp::Parameter> pvariants;
+      for (const auto & p : request->parameters) {
+        std::string parameter_node_name;
+        std::string parameter_name;
+        auto parameter_node_params = resolve(p.name, parameter_node_name, parameter_name);
+        if (!parameter_node_params) {
+          response->result.successful = false;
+          response->result.reason = make_not_served_reason(p.name);
+          return;
+        }
+        if (node_params && parameter_node_name != node_name) {
+          response->result.successful = false;
+          response->result.reason =
+            "parameters of several nodes can't be set atomically by the multiplexer";
+          return;
+        }
+        node_params = std::move(parameter_node_params);
+        node_name = std::move(parameter_node_name);
+        pvariants.emplace_back(parameter_name, rclcpp::ParameterValue(p.value));
+      }
+      if (!node_params) {
+        response->result.successful = true;
+        return;
+      }
+      try {
+        response->result = node_params->set_parameters_atomically(pvariants);
+      } catch (const rclcpp::exceptions::ParameterNotDeclaredException & ex) {
+        RCLCPP_DEBUG(
+          rclcpp::get_logger("rclcpp"), "Failed to set parameters atomically: %s", ex.what());
+        response->result.successful = false;
+        response->result.reason = "One or more parameters were not declared before setting";
+      }
+    },
+    qos_profile, nullptr);
+
+  describe_parameters_service_ = create_service<rcl_interfaces::srv::DescribeParameters>(
+    node_base, node_services,
+    node_name + "/" + parameter_service_names::describe_parameters,
+    [this](
+      const std::shared_ptr<rmw_request_id_t>,
+      const std::shared_ptr<rcl_interfaces::srv::DescribeParameters::Request> request,
+      std::shared_ptr<rcl_interfaces::srv::DescribeParameters::Response> response)
+    {
+      for (const auto & name : request->names) {
+        std::string node_name;
+        std::string parameter_name;
+        auto node_params = resolve(name, node_name, parameter_name);
+        try {
+          if (!node_params) {
+            throw rclcpp::exceptions::ParameterNotDeclaredException(make_not_served_reason(name));
+          }
+          auto descriptor = node_params->describe_parameters({parameter_name}).at(0);
+          descriptor.name = name;
+          response->descriptors.push_back(std::move(descriptor));
+        } catch (const rclcpp::exceptions::ParameterNotDeclaredException & ex) {
+          RCLCPP_DEBUG(
+            rclcpp::get_logger("rclcpp"), "Failed to describe parameters: %s", ex.what());
+          response->descriptors.clear();
+          return;
+        }
+      }
+    },
+    qos_profile, nullptr);
+
+  list_parameters_service_ = create_service<rcl_interfaces::srv::ListParameters>(
+    node_base, node_services,
+    node_name + "/" + parameter_service_names::list_parameters,
+    [this](
+      const std::shared_ptr<rmw_request_id_t>,
+      const std::shared_ptr<rcl_interfaces::srv::ListParameters::Request> request,
+      std::shared_ptr<rcl_interfaces::srv::ListParameters::Response> response)
+    {
+      // The prefixes of each node, where no prefix lists all of its parameters
+      std::map<
+        std::string,
+        std::pair<std::shared_ptr<NodeParametersInterface>, std::vector<std::string>>
+      > prefixes_by_node;
+      if (request->prefixes.empty()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto & name_and_node : nodes_) {
+          auto node_params = name_and_node.second.lock();
+          if (node_params) {
+            prefixes_by_node[name_and_node.first].first = std::move(node_params);
+          }
+        }
+      }
+      std::vector<std::string> nodes_listed_entirely;
+      for (const auto & prefix : request->prefixes) {
+        std::string node_name;
+        std::string parameter_prefix;
+        auto node_params = resolve(prefix, node_name, parameter_prefix);
+        if (!node_params) {
+          continue;
+        }
+        auto & node_prefixes = prefixes_by_node[node_name];
+        node_prefixes.first = std::move(node_params);
+        if (parameter_prefix.empty()) {
+          nodes_listed_entirely.push_back(node_name);
+        } else {
+          node_prefixes.second.push_back(std::move(parameter_prefix));
+        }
+      }
+      for (const auto & node_name : nodes_listed_entirely) {
+        prefixes_by_node[node_name].second.clear();
+      }
+
+      for (const auto & node_and_prefixes : prefixes_by_node) {
+        const auto & node_params = node_and_prefixes.second.first;
+        auto result = node_params->list_parameters(
+          node_and_prefixes.second.second, request->depth);
+        for (const auto & name : result.names) {
+          response->result.names.push_back(make_parameter_name(node_and_prefixes.first, name));
+        }
+        for (const auto & prefix : result.prefixes) {
+          response->result.prefixes.push_back(
+            make_parameter_name(node_and_prefixes.first, prefix));
+        }
+      }
+    },
+    qos_profile, nullptr);
+}
+
+void
+ParameterServiceMultiplexer::add_node(
+  const std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> node_base,
+  const std::shared_ptr<NodeParametersInterface> node_parameters)
+{
+  if (!node_base || !node_parameters) {
+    throw std::invalid_argument("the node added to a parameter service multiplexer is null");
+  }
+  std::string fully_qualified_name = node_base->get_fully_qualified_name();
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = nodes_.find(fully_qualified_name);
+  if (it != nodes_.end() && !it->second.expired()) {
+    throw std::invalid_argument(
+            "the node '" + fully_qualified_name +
+            "' was already added to the parameter service multiplexer");
+  }
+  nodes_[std::move(fully_qualified_name)] = node_parameters;
+}
+
+bool
+ParameterServiceMultiplexer::remove_node(const std::string & fully_qualified_name)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return nodes_.erase(fully_qualified_name) > 0;
+}
+
+std::string
+ParameterServiceMultiplexer::make_parameter_name(
+  const std::string & fully_qualified_node_name,
+  const std::string & parameter_name)
+{
+  return fully_qualified_node_name + node_separator + parameter_name;
+}
+
+std::shared_ptr<NodeParametersInterface>
+ParameterServiceMultiplexer::resolve(
+  const std::string & name,
+  std::string & node_name,
+  std::string & parameter_name) const
+{
+  const size_t separator_position = name.find(node_separator);
+  if (separator_position == std::string::npos) {
+    return nullptr;
+  }
+  node_name = name.substr(0, separator_position);
+  parameter_name = name.substr(separator_position + 1);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = nodes_.find(node_name);
+  if (it == nodes_.end()) {
+    return nullptr;
+  }
+  return it->second.lock();
+}
@@ -14,7 +14,11 @@
 
 #include "rclcpp/parameter_value.hpp"
 
+#include <memory>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>  // NOLINT
 #include <vector>
 
 using rclcpp::ParameterType;
@@ -109,23 +113,38 @@ rclcpp::to_string(const ParameterValue & value)
 }
 
 ParameterValue::ParameterValue()
-{
-  value_.type = rcl_interfaces::msg::ParameterType::PARAMETER_NOT_SET;
-}
+{}
 
 ParameterValue::ParameterValue(const rcl_interfaces::msg::ParameterValue & value)
 {
-  value_ = value;
   switch (value.type) {
     case PARAMETER_BOOL:
+      value_ = value.bool_value;
+      break;
     case PARAMETER_INTEGER:
+      value_ = value.integer_value;
+      break;
     case PARAMETER_DOUBLE:
+      value_ = value.double_value;
+      break;
     case PARAMETER_STRING:
+      value_ = std::make_shared<const std::string>(value.string_value);
+      break;
     case PARAMETER_BYTE_ARRAY:
+      value_ = std::make_shared<const std::vector<uint8_t>>(value.byte_array_value);
+      break;
     case PARAMETER_BOOL_ARRAY:
+      value_ = std::make_shared<const std::vector<bool>>(value.bool_array_value);
+      break;
     case PARAMETER_INTEGER_ARRAY:
+      value_ = std::make_shared<const std::vector<int64_t>>(value.integer_array_value);
+      break;
     case PARAMETER_DOUBLE_ARRAY:
+      value_ = std::make_shared<const std::vector<double>>(value.double_array_value);
+      break;
     case PARAMETER_STRING_ARRAY:
+      value_ = std::make_shared<const std::vector<std::string>>(value.string_array_value);
+      break;
     case PARAMETER_NOT_SET:
       break;
     default:
@@ -135,107 +154,133 @@ ParameterValue::ParameterValue(const rcl_interfaces::msg::ParameterValue & value
 }
 
 ParameterValue::ParameterValue(const bool bool_value)
-{
-  value_.bool_value = bool_value;
-  value_.type = rcl_interfaces::msg::ParameterType::PARAMETER_BOOL;
-}
+: value_(bool_value)
+{}
 
 ParameterValue::ParameterValue(const int int_value)
-{
-  value_.integer_value = int_value;
-  value_.type = rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER;
-}
+: value_(static_cast<int64_t>(int_value))
+{}
 
 ParameterValue::ParameterValue(const int64_t int_value)
-{
-  value_.integer_value = int_value;
-  value_.type = rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER;
-}
+: value_(int_value)
+{}
 
 ParameterValue::ParameterValue(const float double_value)
-{
-  value_.double_value = static_cast<double>(double_value);
-  value_.type = rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE;
-}
+: value_(static_cast<double>(double_value))
+{}
 
 ParameterValue::ParameterValue(const double double_value)
-{
-  value_.double_value = double_value;
-  value_.type = rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE;
-}
+: value_(double_value)
+{}
 
 ParameterValue::ParameterValue(const std::string & string_value)
-{
-  value_.string_value = string_value;
-  value_.type = rcl_interfaces::msg::ParameterType::PARAMETER_STRING;
-}
+: value_(std::make_shared<const std::string>(string_value))
+{}
 
 ParameterValue::ParameterValue(const char * string_value)
 : ParameterValue(std::string(string_value))
 {}
 
 ParameterValue::ParameterValue(const std::vector<uint8_t> & byte_array_value)
-{
-  value_.byte_array_value = byte_array_value;
-  value_.type = rcl_interfaces::msg::ParameterType::PARAMETER_BYTE_ARRAY;
-}
+: value_(std::make_shared<const std::vector<uint8_t>>(byte_array_value))
+{}
 
 ParameterValue::ParameterValue(const std::vector<bool> & bool_array_value)
-{
-  value_.bool_array_value = bool_array_value;
-  value_.type = rcl_interfaces::msg::ParameterType::PARAMETER_BOOL_ARRAY;
-}
+: value_(std::make_shared<const std::vector<bool>>(bool_array_value))
+{}
 
 ParameterValue::ParameterValue(const std::vector<int> & int_array_value)
-{
-  value_.integer_array_value.assign(int_array_value.cbegin(), int_array_value.cend());
-  value_.type = rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER_ARRAY;
-}
+: value_(
+    std::make_shared<const std::vector<int64_t>>(
+      int_array_value.cbegin(), int_array_value.cend()))
+{}
 
 ParameterValue::ParameterValue(const std::vector<int64_t> & int_array_value)
-{
-  value_.integer_array_value = int_array_value;
-  value_.type = rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER_ARRAY;
-}
+: value_(std::make_shared<const std::vector<int64_t>>(int_array_value))
+{}
 
 ParameterValue::ParameterValue(const std::vector<float> & float_array_value)
-{
-  value_.double_array_value.assign(float_array_value.cbegin(), float_array_value.cend());
-  value_.type = rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE_ARRAY;
-}
+: value_(
+    std::make_shared<const std::vector<double>>(
+      float_array_value.cbegin(), float_array_value.cend()))
+{}
 
 ParameterValue::ParameterValue(const std::vector<double> & double_array_value)
-{
-  value_.double_array_value = double_array_value;
-  value_.type = rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE_ARRAY;
-}
+: value_(std::make_shared<const std::vector<double>>(double_array_value))
+{}
 
 ParameterValue::ParameterValue(const std::vector<std::string> & string_array_value)
-{
-  value_.string_array_value = string_array_value;
-  value_.type = rcl_interfaces::msg::ParameterType::PARAMETER_STRING_ARRAY;
-}
+: value_(std::make_shared<const std::vector<std::string>>(string_array_value))
+{}
 
 ParameterType
 ParameterValue::get_type() const
 {
-  return static_cast<ParameterType>(value_.type);
+  return static_cast<ParameterType>(value_.index());
 }
 
 rcl_interfaces::msg::ParameterValue
 ParameterValue::to_value_msg() const
 {
-  return value_;
+  rcl_interfaces::msg::ParameterValue value;
+  value.type = get_type();
+  switch (get_type()) {
+    case PARAMETER_BOOL:
+      value.bool_value = get<PARAMETER_BOOL>();
+      break;
+    case PARAMETER_INTEGER:
+      value.integer_value = get<PARAMETER_INTEGER>();
+      break;
+    case PARAMETER_DOUBLE:
+      value.double_value = get<PARAMETER_DOUBLE>();
+      break;
+    case PARAMETER_STRING:
+      value.string_value = get<PARAMETER_STRING>();
+      break;
+    case PARAMETER_BYTE_ARRAY:
+      value.byte_array_value = get<PARAMETER_BYTE_ARRAY>();
+      break;
+    case PARAMETER_BOOL_ARRAY:
+      value.bool_array_value = get<PARAMETER_BOOL_ARRAY>();
+      break;
+    case PARAMETER_INTEGER_ARRAY:
+      value.integer_array_value = get<PARAMETER_INTEGER_ARRAY>();
+      break;
+    case PARAMETER_DOUBLE_ARRAY:
+      value.double_array_value = get<PARAMETER_DOUBLE_ARRAY>();
+      break;
+    case PARAMETER_STRING_ARRAY:
+      value.string_array_value = get<PARAMETER_STRING_ARRAY>();
+      break;
+    case PARAMETER_NOT_SET:
+      break;
+  }
+  return value;
 }
 
 bool
 ParameterValue::operator==(const ParameterValue & rhs) const
 {
-  return this->value_ == rhs.value_;
+  if (value_.index() != rhs.value_.index()) {
+    return false;
+  }
+  // The shared values are compared by their content, unless they are the same.
+  return std::visit(
+    [&rhs](const auto & value) {
+      using StoredT = std::decay_t<decltype(value)>;
+      if constexpr (std::is_same_v<StoredT, std::monostate>) {
+        return true;
+      } else if constexpr (std::is_scalar_v<StoredT>) {
+        return value == std::get<StoredT>(rhs.value_);
+      } else {
+        const auto & rhs_value = std::get<StoredT>(rhs.value_);
+        return value == rhs_value || *value == *rhs_value;
+      }
+    }, value_);
 }
 
 bool
 ParameterValue::operator!=(const ParameterValue & rhs) const
 {
-  return this->value_ != rhs.value_;
+  return !(*this == rhs);
 }
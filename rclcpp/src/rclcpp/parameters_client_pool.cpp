@@ -0,0 +1,285 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp/parameters_client_pool.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "./parameter_service_names.hpp"
+
+using rclcpp::ParametersClientPool;
+
+ParametersClientPool::ParametersClientPool(
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base_interface,
+  rclcpp::node_interfaces::NodeGraphInterface::SharedPtr node_graph_interface,
+  rclcpp::node_interfaces::NodeServicesInterface::SharedPtr node_services_interface,
+  const rclcpp::QoS & qos_profile,
+  rclcpp::CallbackGroup::SharedPtr group)
+: node_base_interface_(std::move(node_base_interface)),
+  node_graph_interface_(std::move(node_graph_interface)),
+  node_services_interface_(std::move(node_services_interface)),
+  client_options_(rcl_client_get_default_options()),
+  group_(std::move(group))
+{
+  client_options_.qos = qos_profile.get_rmw_qos_profile();
+}
+
+template<typename ServiceT>
+typename rclcpp::Client<ServiceT>::SharedPtr
+ParametersClientPool::get_client(
+  const std::string & remote_node_name,
+  typename rclcpp::Client<ServiceT>::SharedPtr RemoteNode::* client_member,
+  const char * service_name)
+{
+  if (remote_node_name.empty()) {
+    throw std::invalid_argument("the name of the remote node of a parameter request is empty");
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto & client = remote_nodes_[remote_node_name].*client_member;
+  if (!client) {
+    client = rclcpp::Client<ServiceT>::make_shared(
+      node_base_interface_.get(),
+      node_graph_interface_,
+      remote_node_name + "/" + service_name,
+      client_options_);
+    node_services_interface_->add_client(client, group_);
+  }
+  return client;
+}
+
+template<typename ServiceT, typename ResultT, typename ConvertT>
+std::shared_future<ResultT>
+ParametersClientPool::send_request(
+  const typename rclcpp::Client<ServiceT>::SharedPtr & client,
+  typename ServiceT::Request::SharedPtr request,
+  ConvertT convert,
+  std::function<void(std::shared_future<ResultT>)> callback)
+{
+  auto promise_result = std::make_shared<std::promise<ResultT>>();
+  auto future_result = promise_result->get_future().share();
+
+  client->async_send_request(
+    request,
+    [request, promise_result, future_result, convert, callback](
+      typename rclcpp::Client<ServiceT>::SharedFuture cb_f)
+    {
+      promise_result->set_value(convert(*request, *cb_f.get()));
+      if (callback != nullptr) {
+        callback(future_result);
+      }
+    });
+
+  return future_result;
+}
+
+std::shared_future<std::vector<rclcpp::Parameter>>
+ParametersClientPool::get_parameters(
+  const std::string & remote_node_name,
+  const std::vector<std::string> & names,
+  std::function<
+    void(std::shared_future<std::vector<rclcpp::Parameter>>)
+  > callback)
+{
+  using ServiceT = rcl_interfaces::srv::GetParameters;
+  auto client = get_client<ServiceT>(
+    remote_node_name, &RemoteNode::get_parameters, parameter_service_names::get_parameters);
+  auto request = std::make_shared<ServiceT::Request>();
+  request->names = names;
+  return send_request<ServiceT, std::vector<rclcpp::Parameter>>(
+    client, std::move(request),
+    [](const ServiceT::Request & request, const ServiceT::Response & response) {
+      std::vector<rclcpp::Parameter> parameters;
+      const size_t size = std::min(request.names.size(), response.values.size());
+      parameters.reserve(size);
+      for (size_t i = 0; i < size; ++i) {
+        rcl_interfaces::msg::Parameter parameter;
+        parameter.name = request.names[i];
+        parameter.value = response.values[i];
+        parameters.push_back(rclcpp::Parameter::from_parameter_msg(parameter));
+      }
+      return parameters;
+    },
+    std::move(callback));
+}
+
+std::shared_future<std::vector<rcl_interfaces::msg::ParameterDescriptor>>
+ParametersClientPool::describe_parameters(
+  const std::string & remote_node_name,
+  const std::vector<std::string> & names,
+  std::function<
+    void(std::shared_future<std::vector<rcl_interfaces::msg::ParameterDescriptor>>)
+  > callback)
+{
+  using ServiceT = rcl_interfaces::srv::DescribeParameters;
+  auto client = get_client<ServiceT>(
+    remote_node_name, &RemoteNode::describe_parameters,
+    parameter_service_names::describe_parameters);
+  auto request = std::make_shared<ServiceT::Request>();
+  request->names = names;
+  return send_request<ServiceT, std::vector<rcl_interfaces::msg::ParameterDescriptor>>(
+    client, std::move(request),
+    [](const ServiceT::Request &, const ServiceT::Response & response) {
+      return response.descriptors;
+    },
+    std::move(callback));
+}
+
+std::shared_future<std::vector<rclcpp::ParameterType>>
+ParametersClientPool::get_parameter_types(
+  const std::string & remote_node_name,
+  const std::vector<std::string> & names,
+  std::function<
+    void(std::shared_future<std::vector<rclcpp::ParameterType>>)
+  > callback)
+{
+  using ServiceT = rcl_interfaces::srv::GetParameterTypes;
+  auto client = get_client<ServiceT>(
+    remote_node_name, &RemoteNode::get_parameter_types,
+    parameter_service_names::get_parameter_types);
+  auto request = std::make_shared<ServiceT::Request>();
+  request->names = names;
+  return send_request<ServiceT, std::vector<rclcpp::ParameterType>>(
+    client, std::move(request),
+    [](const ServiceT::Request &, const ServiceT::Response & response) {
+      std::vector<rclcpp::ParameterType> types;
+      types.reserve(response.types.size());
+      for (auto type : response.types) {
+        types.push_back(static_cast<rclcpp::ParameterType>(type));
+      }
+      return types;
+    },
+    std::move(callback));
+}
+
+std::shared_future<std::vector<rcl_interfaces::msg::SetParametersResult>>
+ParametersClientPool::set_parameters(
+  const std::string & remote_node_name,
+  const std::vector<rclcpp::Parameter> & parameters,
+  std::function<
+    void(std::shared_future<std::vector<rcl_interfaces::msg::SetParametersResult>>)
+  > callback)
+{
+  using ServiceT = rcl_interfaces::srv::SetParameters;
+  auto client = get_client<ServiceT>(
+    remote_node_name, &RemoteNode::set_parameters, parameter_service_names::set_parameters);
+  auto request = std::make_shared<ServiceT::Request>();
+  std::transform(
+    parameters.begin(), parameters.end(), std::back_inserter(request->parameters),
+    [](const rclcpp::Parameter & p) {return p.to_parameter_msg();});
+  return send_request<ServiceT, std::vector<rcl_interfaces::msg::SetParametersResult>>(
+    client, std::move(request),
+    [](const ServiceT::Request &, const ServiceT::Response & response) {
+      return response.results;
+    },
+    std::move(callback));
+}
+
+std::shared_future<rcl_interfaces::msg::SetParametersResult>
+ParametersClientPool::set_parameters_atomically(
+  const std::string & remote_node_name,
+  const std::vector<rclcpp::Parameter> & parameters,
+  std::function<
+    void(std::shared_future<rcl_interfaces::msg::SetParametersResult>)
+  > callback)
+{
+  using ServiceT = rcl_interfaces::srv::SetParametersAtomically;
+  auto client = get_client<ServiceT>(
+    remote_node_name, &RemoteNode::set_parameters_atomically,
+    parameter_service_names::set_parameters_atomically);
+  auto request = std::make_shared<ServiceT::Request>();
+  std::transform(
+    parameters.begin(), parameters.end(), std::back_inserter(request->parameters),
+    [](const rclcpp::Parameter & p) {return p.to_parameter_msg();});
+  return send_request<ServiceT, rcl_interfaces::msg::SetParametersResult>(
+    client, std::move(request),
+    [](const ServiceT::Request &, const ServiceT::Response & response) {
+      return response.result;
+    },
+    std::move(callback));
+}
+
+std::shared_future<rcl_interfaces::msg::ListParametersResult>
+ParametersClientPool::list_parameters(
+  const std::string & remote_node_name,
+  const std::vector<std::string> & prefixes,
+  uint64_t depth,
+  std::function<
+    void(std::shared_future<rcl_interfaces::msg::ListParametersResult>)
+  > callback)
+{
+  using ServiceT = rcl_interfaces::srv::ListParameters;
+  auto client = get_client<ServiceT>(
+    remote_node_name, &RemoteNode::list_parameters, parameter_service_names::list_parameters);
+  auto request = std::make_shared<ServiceT::Request>();
+  request->prefixes = prefixes;
+  request->depth = depth;
+  return send_request<ServiceT, rcl_interfaces::msg::ListParametersResult>(
+    client, std::move(request),
+    [](const ServiceT::Request &, const ServiceT::Response & response) {
+      return response.result;
+    },
+    std::move(callback));
+}
+
+bool
+ParametersClientPool::remove(const std::string & remote_node_name)
+{
+  RemoteNode remote_node;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = remote_nodes_.find(remote_node_name);
+    if (it == remote_nodes_.end()) {
+      return false;
+    }
+    remote_node = std::move(it->second);
+    remote_nodes_.erase(it);
+  }
+  // The clients are destroyed out of the lock.
+  return true;
+}
+
+size_t
+ParametersClientPool::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return remote_nodes_.size();
+}
+
+size_t
+ParametersClientPool::get_number_of_clients() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t number_of_clients = 0;
+  for (const auto & name_and_remote_node : remote_nodes_) {
+    const RemoteNode & remote_node = name_and_remote_node.second;
+    number_of_clients +=
+      (remote_node.get_parameters ? 1u : 0u) +
+      (remote_node.get_parameter_types ? 1u : 0u) +
+      (remote_node.set_parameters ? 1u : 0u) +
+      (remote_node.set_parameters_atomically ? 1u : 0u) +
+      (remote_node.list_parameters ? 1u : 0u) +
+      (remote_node.describe_parameters ? 1u : 0u);
+  }
+  return number_of_clients;
+}
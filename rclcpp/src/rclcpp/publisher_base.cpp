@@ -23,6 +23,7 @@
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "rcutils/logging_macros.h"
@@ -201,6 +202,12 @@ PublisherBase::get_event_handlers() const
   return event_handlers_;
 }
 
+std::shared_ptr<rclcpp::QOSEventHandlerGroup>
+PublisherBase::get_event_handler_group() const
+{
+  return event_handler_group_;
+}
+
 size_t
 PublisherBase::get_subscription_count() const
 {
@@ -226,6 +233,18 @@ PublisherBase::get_subscription_count() const
   return inter_process_subscription_count;
 }
 
+rclcpp::IntraProcessCounters
+PublisherBase::get_intra_process_publish_counters() const
+{
+  return intra_process_publish_counters_.get();
+}
+
+std::shared_ptr<const rcl_node_t>
+PublisherBase::get_rcl_node_handle() const
+{
+  return rcl_node_handle_;
+}
+
 size_t
 PublisherBase::get_intra_process_subscription_count() const
 {
@@ -243,6 +262,22 @@ PublisherBase::get_intra_process_subscription_count() const
   return ipm->get_subscription_count(intra_process_publisher_id_);
 }
 
+bool
+PublisherBase::has_subscriptions() const
+{
+  if (intra_process_is_enabled_ && get_intra_process_subscription_count() > 0u) {
+    return true;
+  }
+  return get_subscription_count() > 0u;
+}
+
+void
+PublisherBase::set_topic_statistics(
+  std::shared_ptr<rclcpp::topic_statistics::PublisherTopicStatistics> topic_statistics)
+{
+  publisher_topic_statistics_ = std::move(topic_statistics);
+}
+
 rclcpp::QoS
 PublisherBase::get_actual_qos() const
 {
@@ -0,0 +1,198 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp/qos_event_handler_group.hpp"
+
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include "rclcpp/detail/add_guard_condition_to_rcl_wait_set.hpp"
+
+using rclcpp::QOSEventHandlerGroup;
+
+QOSEventHandlerGroup::QOSEventHandlerGroup(rclcpp::Context::SharedPtr context)
+: gc_(context)
+{}
+
+QOSEventHandlerGroup::~QOSEventHandlerGroup()
+{
+  std::unordered_map<uint64_t, std::weak_ptr<QOSEventHandlerBase>> members;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    members.swap(members_);
+  }
+  for (auto & id_and_member : members) {
+    auto handler = id_and_member.second.lock();
+    if (handler) {
+      handler->clear_on_ready_callback();
+    }
+  }
+}
+
+void
+QOSEventHandlerGroup::add(const std::shared_ptr<QOSEventHandlerBase> & handler)
+{
+  if (!handler) {
+    throw std::invalid_argument("the QoS event handler added to a group is null");
+  }
+  uint64_t member_id;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = members_.begin(); it != members_.end(); ) {
+      auto member = it->second.lock();
+      if (member == handler) {
+        throw std::invalid_argument("the QoS event handler is already in the group");
+      }
+      // The handlers which were destroyed are removed when another one is added.
+      if (!member) {
+        it = members_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    member_id = next_member_id_++;
+    members_.emplace(member_id, handler);
+  }
+  // The events received before are reported right away, which locks the mutex.
+  handler->set_on_ready_callback(
+    [this, member_id](size_t number_of_events, int) {
+      on_ready(member_id, number_of_events);
+    });
+}
+
+bool
+QOSEventHandlerGroup::remove(const std::shared_ptr<QOSEventHandlerBase> & handler)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = members_.begin();
+    while (it != members_.end() && it->second.lock() != handler) {
+      ++it;
+    }
+    if (it == members_.end()) {
+      return false;
+    }
+    const uint64_t member_id = it->first;
+    members_.erase(it);
+    for (auto ready_it = ready_handlers_.begin(); ready_it != ready_handlers_.end(); ) {
+      if (ready_it->member_id == member_id) {
+        ready_it = ready_handlers_.erase(ready_it);
+      } else {
+        ++ready_it;
+      }
+    }
+  }
+  // The events reported until then are ignored, since the member is gone.
+  handler->clear_on_ready_callback();
+  return true;
+}
+
+size_t
+QOSEventHandlerGroup::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return members_.size();
+}
+
+void
+QOSEventHandlerGroup::on_ready(uint64_t member_id, size_t number_of_events)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (members_.find(member_id) == members_.end()) {
+      return;
+    }
+    if (!ready_handlers_.empty() && ready_handlers_.back().member_id == member_id) {
+      ready_handlers_.back().number_of_events += number_of_events;
+    } else {
+      ready_handlers_.push_back({member_id, number_of_events});
+    }
+  }
+  gc_.trigger();
+}
+
+size_t
+QOSEventHandlerGroup::get_number_of_ready_guard_conditions()
+{
+  return 1u;
+}
+
+void
+QOSEventHandlerGroup::add_to_wait_set(rcl_wait_set_t * wait_set)
+{
+  rclcpp::detail::add_guard_condition_to_rcl_wait_set(*wait_set, gc_);
+}
+
+bool
+QOSEventHandlerGroup::is_ready(rcl_wait_set_t * wait_set)
+{
+  (void)wait_set;
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !ready_handlers_.empty();
+}
+
+std::shared_ptr<void>
+QOSEventHandlerGroup::take_data()
+{
+  std::shared_ptr<QOSEventHandlerBase> handler;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (!handler && !ready_handlers_.empty()) {
+      ReadyHandler & ready_handler = ready_handlers_.front();
+      auto it = members_.find(ready_handler.member_id);
+      if (it != members_.end()) {
+        handler = it->second.lock();
+        if (!handler) {
+          members_.erase(it);
+        }
+      }
+      if (!handler || --ready_handler.number_of_events == 0) {
+        ready_handlers_.pop_front();
+      }
+    }
+    if (!ready_handlers_.empty()) {
+      // The guard condition is only triggered once for all the events reported before a wait.
+      gc_.trigger();
+    }
+  }
+  if (!handler) {
+    return nullptr;
+  }
+  auto data = handler->take_data();
+  if (!data) {
+    return nullptr;
+  }
+  return std::make_shared<TakenData>(TakenData{std::move(handler), std::move(data)});
+}
+
+std::shared_ptr<void>
+QOSEventHandlerGroup::take_data_by_entity_id(size_t id)
+{
+  (void)id;
+  return take_data();
+}
+
+void
+QOSEventHandlerGroup::execute(std::shared_ptr<void> & data)
+{
+  if (!data) {
+    return;
+  }
+  auto taken_data = std::static_pointer_cast<TakenData>(data);
+  taken_data->handler->execute(taken_data->data);
+}
@@ -0,0 +1,180 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/rate.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <stdexcept>
+#include <system_error>
+
+#ifdef __linux__
+#include <time.h>
+#endif
+
+using rclcpp::DeadlineRate;
+
+namespace
+{
+
+std::chrono::nanoseconds
+period_from_rate(double rate)
+{
+  if (!(rate > 0.0)) {
+    throw std::invalid_argument("rate must be positive");
+  }
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::duration<double>(1.0 / rate));
+}
+
+#ifdef __linux__
+// Shutdown doesn't interrupt clock_nanosleep(), so longer sleeps are split.
+constexpr int64_t max_uninterrupted_sleep_ns = 100 * 1000 * 1000;
+#endif
+
+}  // namespace
+
+DeadlineRate::DeadlineRate(
+  std::chrono::nanoseconds period,
+  rclcpp::Clock::SharedPtr clock,
+  rclcpp::Context::SharedPtr context)
+: period_(period), clock_(clock), context_(context)
+{
+  if (period <= std::chrono::nanoseconds::zero()) {
+    throw std::invalid_argument("period must be positive");
+  }
+  if (!clock_) {
+    throw std::invalid_argument("clock must not be nullptr");
+  }
+  if (!context_) {
+    throw std::invalid_argument("context must not be nullptr");
+  }
+  reset();
+}
+
+DeadlineRate::DeadlineRate(
+  double rate,
+  rclcpp::Clock::SharedPtr clock,
+  rclcpp::Context::SharedPtr context)
+: DeadlineRate(period_from_rate(rate), clock, context)
+{}
+
+DeadlineRate::~DeadlineRate() {}
+
+bool
+DeadlineRate::sleep()
+{
+  rclcpp::Time deadline = next_deadline_;
+  const rclcpp::Time now = clock_->now();
+  statistics_.number_of_deadlines++;
+
+  if (now + period_ < deadline) {
+    // The time jumped backward, the deadlines restart from now.
+    deadline = now + period_;
+  } else if (now >= deadline) {
+    statistics_.number_of_overruns++;
+    record_lateness(deadline, now);
+    // Skip the deadlines of the missed periods, without drifting.
+    const int64_t missed_periods = (now - deadline).nanoseconds() / period_.nanoseconds();
+    statistics_.number_of_missed_periods += static_cast<size_t>(missed_periods);
+    next_deadline_ = deadline + rclcpp::Duration(
+      std::chrono::nanoseconds(period_.nanoseconds() * (missed_periods + 1)));
+    return false;
+  }
+
+  next_deadline_ = deadline + period_;
+  if (!sleep_until(deadline)) {
+    // Shutdown or change of time source.
+    next_deadline_ = clock_->now() + period_;
+    return false;
+  }
+  record_lateness(deadline, clock_->now());
+  return true;
+}
+
+bool
+DeadlineRate::is_steady() const
+{
+  return clock_->get_clock_type() == RCL_STEADY_TIME;
+}
+
+void
+DeadlineRate::reset()
+{
+  next_deadline_ = clock_->now() + period_;
+}
+
+std::chrono::nanoseconds
+DeadlineRate::period() const
+{
+  return std::chrono::nanoseconds(period_.nanoseconds());
+}
+
+rclcpp::Time
+DeadlineRate::get_next_deadline() const
+{
+  return next_deadline_;
+}
+
+const DeadlineRate::Statistics &
+DeadlineRate::get_statistics() const
+{
+  return statistics_;
+}
+
+void
+DeadlineRate::reset_statistics()
+{
+  statistics_ = Statistics();
+}
+
+bool
+DeadlineRate::sleep_until(const rclcpp::Time & deadline)
+{
+  if (!context_->is_valid()) {
+    return false;
+  }
+#ifdef __linux__
+  // The steady clock of rcl is CLOCK_MONOTONIC.
+  if (clock_->get_clock_type() == RCL_STEADY_TIME) {
+    const int64_t deadline_ns = deadline.nanoseconds();
+    while (context_->is_valid()) {
+      const int64_t now_ns = clock_->now().nanoseconds();
+      if (now_ns >= deadline_ns) {
+        return true;
+      }
+      const int64_t wake_up_ns = std::min(deadline_ns, now_ns + max_uninterrupted_sleep_ns);
+      timespec wake_up;
+      wake_up.tv_sec = static_cast<time_t>(wake_up_ns / 1000000000);
+      wake_up.tv_nsec = static_cast<long>(wake_up_ns % 1000000000);  // NOLINT(runtime/int)
+      const int ret = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake_up, nullptr);
+      if (ret != 0 && ret != EINTR) {
+        throw std::system_error(ret, std::generic_category(), "clock_nanosleep() failed");
+      }
+    }
+    return false;
+  }
+#endif
+  return clock_->sleep_until(deadline, context_);
+}
+
+void
+DeadlineRate::record_lateness(const rclcpp::Time & deadline, const rclcpp::Time & now)
+{
+  const std::chrono::nanoseconds lateness((now - deadline).nanoseconds());
+  statistics_.last_lateness = lateness;
+  statistics_.max_lateness = std::max(statistics_.max_lateness, lateness);
+  statistics_.total_lateness += lateness;
+}
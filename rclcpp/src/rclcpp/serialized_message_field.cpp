@@ -0,0 +1,735 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp/serialized_message_field.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rcutils/error_handling.h"
+#include "rosidl_typesupport_introspection_cpp/field_types.hpp"
+#include "rosidl_typesupport_introspection_cpp/identifier.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_introspection.hpp"
+
+#include "rclcpp/typesupport_helpers.hpp"
+
+#include "./detail/plain_cdr.hpp"
+
+using rclcpp::SerializedMessageField;
+using rosidl_typesupport_introspection_cpp::MessageMember;
+using rosidl_typesupport_introspection_cpp::MessageMembers;
+namespace plain_cdr = rclcpp::detail::plain_cdr;
+
+/// Step skipping fields of the serialized messages.
+struct SerializedMessageField::Step
+{
+  enum class Type
+  {
+    // `count` primitives of `size` bytes
+    Primitives,
+    // `count` strings
+    Strings,
+    // `count` messages, whose fields are skipped by `element_steps`
+    Messages,
+    // A sequence, whose elements are skipped by `element_steps`
+    Sequence,
+    // The first `count` elements of a sequence, which must have more elements
+    SequenceElements,
+  };
+
+  Type type = Type::Primitives;
+  size_t size = 0;
+  size_t count = 1;
+  std::vector<Step> element_steps;
+};
+
+namespace
+{
+
+using Step = SerializedMessageField::Step;
+using rclcpp::detail::plain_cdr::Payload;
+
+bool
+is_supported(uint8_t type_id)
+{
+  namespace introspection = rosidl_typesupport_introspection_cpp;
+  // The middlewares don't serialize them the same.
+  return type_id != introspection::ROS_TYPE_WCHAR &&
+         type_id != introspection::ROS_TYPE_WSTRING &&
+         type_id != introspection::ROS_TYPE_LONG_DOUBLE;
+}
+
+const MessageMembers *
+get_members(const MessageMember & member)
+{
+  return static_cast<const MessageMembers *>(member.members_->data);
+}
+
+bool
+is_fixed_array(const MessageMember & member)
+{
+  return member.is_array_ && member.array_size_ > 0 && !member.is_upper_bound_;
+}
+
+/// Append a step, merged with the previous one if they skip primitives of the same size.
+void
+append_step(std::vector<Step> & steps, Step step)
+{
+  if (step.count == 0u) {
+    return;
+  }
+  if (step.type == Step::Type::Primitives && !steps.empty() &&
+    steps.back().type == Step::Type::Primitives && steps.back().size == step.size)
+  {
+    steps.back().count += step.count;
+    return;
+  }
+  steps.push_back(std::move(step));
+}
+
+void
+append_message_steps(const MessageMembers * members, std::vector<Step> & steps);
+
+/// Return the steps skipping one element of a member, or the member if it isn't an array.
+std::vector<Step>
+get_element_steps(const MessageMember & member)
+{
+  namespace introspection = rosidl_typesupport_introspection_cpp;
+  std::vector<Step> steps;
+  if (!is_supported(member.type_id_)) {
+    throw std::invalid_argument(
+            "the field '" + std::string(member.name_) +
+            "' has wide characters or long doubles, which can't be skipped");
+  }
+  if (member.type_id_ == introspection::ROS_TYPE_MESSAGE) {
+    append_message_steps(get_members(member), steps);
+  } else if (member.type_id_ == introspection::ROS_TYPE_STRING) {
+    steps.push_back({Step::Type::Strings, 0u, 1u, {}});
+  } else {
+    steps.push_back({Step::Type::Primitives, plain_cdr::get_size(member.type_id_), 1u, {}});
+  }
+  return steps;
+}
+
+/// Append the steps skipping the first elements of an array, or the member if it isn't one.
+void
+append_elements_steps(const MessageMember & member, size_t count, std::vector<Step> & steps)
+{
+  std::vector<Step> element_steps = get_element_steps(member);
+  if (member.is_array_ && !is_fixed_array(member)) {
+    steps.push_back({Step::Type::SequenceElements, 0u, count, std::move(element_steps)});
+    return;
+  }
+  if (element_steps.size() == 1u &&
+    (element_steps[0].type == Step::Type::Primitives ||
+    element_steps[0].type == Step::Type::Strings))
+  {
+    // The elements are skipped at once, including the messages skipped by one step.
+    element_steps[0].count *= count;
+    append_step(steps, std::move(element_steps[0]));
+  } else if (count == 1u) {
+    for (auto & step : element_steps) {
+      append_step(steps, std::move(step));
+    }
+  } else if (count > 1u) {
+    steps.push_back({Step::Type::Messages, 0u, count, std::move(element_steps)});
+  }
+}
+
+/// Append the steps skipping a whole member.
+void
+append_member_steps(const MessageMember & member, std::vector<Step> & steps)
+{
+  if (!member.is_array_ || is_fixed_array(member)) {
+    append_elements_steps(member, member.is_array_ ? member.array_size_ : 1u, steps);
+    return;
+  }
+  steps.push_back({Step::Type::Sequence, 0u, 1u, get_element_steps(member)});
+}
+
+void
+append_message_steps(const MessageMembers * members, std::vector<Step> & steps)
+{
+  for (uint32_t i = 0; i < members->member_count_; ++i) {
+    append_member_steps(members->members_[i], steps);
+  }
+}
+
+/// Advance the offset past a step of fixed size, or return false if it has none.
+bool
+skip_fixed(const Step & step, size_t & offset)
+{
+  switch (step.type) {
+    case Step::Type::Primitives:
+      offset = plain_cdr::align(offset, step.size) + step.size * step.count;
+      return true;
+    case Step::Type::Messages:
+      for (size_t i = 0; i < step.count; ++i) {
+        for (const Step & element_step : step.element_steps) {
+          if (!skip_fixed(element_step, offset)) {
+            return false;
+          }
+        }
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
+/// Check that the fields of a message can be read, recursively.
+void
+check_readable(const MessageMembers * members)
+{
+  namespace introspection = rosidl_typesupport_introspection_cpp;
+  for (uint32_t i = 0; i < members->member_count_; ++i) {
+    const MessageMember & member = members->members_[i];
+    if (!is_supported(member.type_id_)) {
+      throw std::invalid_argument(
+              "the field '" + std::string(member.name_) +
+              "' has wide characters or long doubles, which can't be read");
+    }
+    if (member.is_array_ &&
+      (member.get_function == nullptr ||
+      (member.type_id_ == introspection::ROS_TYPE_BOOLEAN && member.assign_function == nullptr) ||
+      (!is_fixed_array(member) && member.resize_function == nullptr)))
+    {
+      throw std::invalid_argument(
+              "the elements of the array '" + std::string(member.name_) + "' can't be read");
+    }
+    if (member.type_id_ == introspection::ROS_TYPE_MESSAGE) {
+      check_readable(get_members(member));
+    }
+  }
+}
+
+bool
+read_length(const Payload & payload, size_t & offset, uint32_t & length)
+{
+  offset = plain_cdr::align(offset, 4u);
+  if (payload.size < 4u || offset > payload.size - 4u) {
+    return false;
+  }
+  plain_cdr::copy_primitives(payload, offset, 4u, 1u, &length);
+  offset += 4u;
+  return true;
+}
+
+/// Advance the offset past a string, which is preceded by its length and ends with a null.
+bool
+skip_string(const Payload & payload, size_t & offset, size_t * length = nullptr)
+{
+  uint32_t string_length = 0;
+  if (!read_length(payload, offset, string_length) || string_length == 0u ||
+    string_length > payload.size - offset)
+  {
+    return false;
+  }
+  if (length) {
+    *length = string_length - 1u;
+  }
+  offset += string_length;
+  return true;
+}
+
+bool
+skip(const std::vector<Step> & steps, const Payload & payload, size_t & offset);
+
+/// Advance the offset past the elements of a sequence.
+bool
+skip_elements(
+  const std::vector<Step> & element_steps, size_t count, const Payload & payload,
+  size_t & offset)
+{
+  // Each element has at least one byte, and the empty sequences have no alignment.
+  if (count > payload.size - offset) {
+    return false;
+  }
+  if (count == 0u) {
+    return true;
+  }
+  if (element_steps.size() == 1u && element_steps[0].type == Step::Type::Primitives) {
+    const size_t size = element_steps[0].size * element_steps[0].count;
+    offset = plain_cdr::align(offset, element_steps[0].size);
+    if (offset > payload.size || count > (payload.size - offset) / size) {
+      return false;
+    }
+    offset += size * count;
+    return true;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    if (!skip(element_steps, payload, offset)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool
+skip(const std::vector<Step> & steps, const Payload & payload, size_t & offset)
+{
+  for (const Step & step : steps) {
+    switch (step.type) {
+      case Step::Type::Primitives:
+        offset = plain_cdr::align(offset, step.size) + step.size * step.count;
+        if (offset > payload.size) {
+          return false;
+        }
+        break;
+      case Step::Type::Strings:
+        for (size_t i = 0; i < step.count; ++i) {
+          if (!skip_string(payload, offset)) {
+            return false;
+          }
+        }
+        break;
+      case Step::Type::Messages:
+        for (size_t i = 0; i < step.count; ++i) {
+          if (!skip(step.element_steps, payload, offset)) {
+            return false;
+          }
+        }
+        break;
+      default:
+        {
+          uint32_t length = 0;
+          if (!read_length(payload, offset, length)) {
+            return false;
+          }
+          size_t count = length;
+          if (step.type == Step::Type::SequenceElements) {
+            if (step.count >= length) {
+              return false;
+            }
+            count = step.count;
+          }
+          if (!skip_elements(step.element_steps, count, payload, offset)) {
+            return false;
+          }
+          break;
+        }
+    }
+  }
+  return true;
+}
+
+/// Copy a primitive from the payload, in the byte order of the host.
+bool
+read_primitive(const Payload & payload, size_t size, size_t & offset, void * value)
+{
+  offset = plain_cdr::align(offset, size);
+  if (offset > payload.size || size > payload.size - offset) {
+    return false;
+  }
+  plain_cdr::copy_primitives(payload, offset, size, 1u, value);
+  offset += size;
+  return true;
+}
+
+bool
+read_message_members(
+  const MessageMembers * members, const Payload & payload, size_t & offset, void * message);
+
+/// Read a value, which isn't an array, into its C++ type.
+bool
+read_value(
+  const MessageMember & member, const Payload & payload, size_t & offset, void * value)
+{
+  namespace introspection = rosidl_typesupport_introspection_cpp;
+  switch (member.type_id_) {
+    case introspection::ROS_TYPE_MESSAGE:
+      return read_message_members(get_members(member), payload, offset, value);
+    case introspection::ROS_TYPE_STRING:
+      {
+        size_t length = 0;
+        if (!skip_string(payload, offset, &length)) {
+          return false;
+        }
+        static_cast<std::string *>(value)->assign(
+          reinterpret_cast<const char *>(payload.data + offset - length - 1u), length);
+        return true;
+      }
+    case introspection::ROS_TYPE_BOOLEAN:
+      {
+        uint8_t byte = 0;
+        if (!read_primitive(payload, 1u, offset, &byte)) {
+          return false;
+        }
+        *static_cast<bool *>(value) = byte != 0u;
+        return true;
+      }
+    default:
+      return read_primitive(payload, plain_cdr::get_size(member.type_id_), offset, value);
+  }
+}
+
+/// Read a member of a message into its C++ type.
+bool
+read_member(const MessageMember & member, const Payload & payload, size_t & offset, void * field)
+{
+  namespace introspection = rosidl_typesupport_introspection_cpp;
+  if (!member.is_array_) {
+    return read_value(member, payload, offset, field);
+  }
+  size_t count = member.array_size_;
+  if (!is_fixed_array(member)) {
+    uint32_t length = 0;
+    if (!read_length(payload, offset, length) || length > payload.size - offset ||
+      (member.is_upper_bound_ && length > member.array_size_))
+    {
+      return false;
+    }
+    count = length;
+    member.resize_function(field, count);
+  }
+  if (count == 0u) {
+    return true;
+  }
+  if (member.type_id_ == introspection::ROS_TYPE_BOOLEAN) {
+    // The elements of the sequences of booleans have no address.
+    for (size_t i = 0; i < count; ++i) {
+      bool value = false;
+      if (!read_value(member, payload, offset, &value)) {
+        return false;
+      }
+      member.assign_function(field, i, &value);
+    }
+    return true;
+  }
+  const size_t size = plain_cdr::get_size(member.type_id_);
+  if (size > 0u) {
+    // The elements of the arrays of primitives are contiguous.
+    offset = plain_cdr::align(offset, size);
+    if (offset > payload.size || count > (payload.size - offset) / size) {
+      return false;
+    }
+    plain_cdr::copy_primitives(payload, offset, size, count, member.get_function(field, 0u));
+    offset += size * count;
+    return true;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    if (!read_value(member, payload, offset, member.get_function(field, i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool
+read_message_members(
+  const MessageMembers * members, const Payload & payload, size_t & offset, void * message)
+{
+  for (uint32_t i = 0; i < members->member_count_; ++i) {
+    const MessageMember & member = members->members_[i];
+    if (!read_member(member, payload, offset, static_cast<uint8_t *>(message) + member.offset_)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Find the field in a message, returning false if it doesn't have it.
+bool
+find_field(
+  const rcl_serialized_message_t & message,
+  size_t fixed_offset,
+  const std::vector<Step> & steps,
+  Payload & payload,
+  size_t & offset)
+{
+  if (!plain_cdr::get_payload(message, fixed_offset, payload)) {
+    return false;
+  }
+  offset = fixed_offset;
+  return skip(steps, payload, offset);
+}
+
+}  // namespace
+
+SerializedMessageField::SerializedMessageField(
+  const std::string & type,
+  const std::string & field_path)
+: path_(field_path),
+  library_(
+    get_typesupport_library(type, rosidl_typesupport_introspection_cpp::typesupport_identifier))
+{
+  compile(
+    *get_typesupport_handle(
+      type, rosidl_typesupport_introspection_cpp::typesupport_identifier, *library_));
+}
+
+SerializedMessageField::SerializedMessageField(
+  const rosidl_message_type_support_t & type_support,
+  const std::string & field_path)
+: path_(field_path)
+{
+  compile(type_support);
+}
+
+SerializedMessageField::~SerializedMessageField() = default;
+
+void
+SerializedMessageField::compile(const rosidl_message_type_support_t & type_support)
+{
+  namespace introspection = rosidl_typesupport_introspection_cpp;
+  const rosidl_message_type_support_t * introspection_type_support =
+    get_message_typesupport_handle(&type_support, introspection::typesupport_identifier);
+  if (!introspection_type_support) {
+    rcutils_reset_error();
+    throw std::invalid_argument(
+            "the introspection type support of the messages of the field isn't available");
+  }
+  const auto * members = static_cast<const MessageMembers *>(introspection_type_support->data);
+
+  size_t begin = 0;
+  while (true) {
+    const size_t end = path_.find('.', begin);
+    const std::string component = path_.substr(begin, end - begin);
+    const size_t bracket = component.find('[');
+    const std::string name = component.substr(0, bracket);
+    bool has_index = false;
+    size_t index = 0;
+    if (bracket != std::string::npos) {
+      const std::string digits = component.substr(bracket + 1, component.size() - bracket - 2);
+      if (component.back() != ']' || digits.empty() || digits.size() > 9 ||
+        digits.find_first_not_of("0123456789") != std::string::npos)
+      {
+        throw std::invalid_argument("the index of the field '" + path_ + "' is invalid");
+      }
+      has_index = true;
+      index = std::stoul(digits);
+    }
+
+    const MessageMember * member = nullptr;
+    for (uint32_t i = 0; i < members->member_count_ && !member; ++i) {
+      if (name == members->members_[i].name_) {
+        member = &members->members_[i];
+      } else {
+        append_member_steps(members->members_[i], steps_);
+      }
+    }
+    if (!member) {
+      throw std::invalid_argument("the messages have no field '" + path_ + "'");
+    }
+    if (member->is_array_ != has_index) {
+      throw std::invalid_argument(
+              has_index ?
+              "the field '" + name + "' isn't an array" :
+              "the array '" + name + "' can only be read by element");
+    }
+    if (has_index) {
+      if ((is_fixed_array(*member) || member->is_upper_bound_) && index >= member->array_size_) {
+        throw std::invalid_argument("the index of the field '" + path_ + "' is out of range");
+      }
+      append_elements_steps(*member, index, steps_);
+    }
+    if (!is_supported(member->type_id_)) {
+      throw std::invalid_argument(
+              "the field '" + path_ + "' has wide characters or long doubles, which can't be read");
+    }
+
+    const bool is_message = member->type_id_ == introspection::ROS_TYPE_MESSAGE;
+    if (end == std::string::npos) {
+      type_id_ = member->type_id_;
+      if (is_message) {
+        members_ = get_members(*member);
+        check_readable(get_members(*member));
+      }
+      break;
+    }
+    if (!is_message) {
+      throw std::invalid_argument("the field '" + name + "' isn't a message");
+    }
+    members = get_members(*member);
+    begin = end + 1;
+  }
+
+  // The steps of fixed size at the start of the messages are replaced by their offset.
+  auto it = steps_.begin();
+  while (it != steps_.end()) {
+    size_t offset = fixed_offset_;
+    if (!skip_fixed(*it, offset)) {
+      break;
+    }
+    fixed_offset_ = offset;
+    ++it;
+  }
+  steps_.erase(steps_.begin(), it);
+}
+
+const std::string &
+SerializedMessageField::get_path() const
+{
+  return path_;
+}
+
+uint8_t
+SerializedMessageField::get_type_id() const
+{
+  return type_id_;
+}
+
+bool
+SerializedMessageField::read(const rclcpp::SerializedMessage & message, std::string & value) const
+{
+  if (type_id_ != rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING) {
+    throw std::invalid_argument("the field '" + path_ + "' isn't a string");
+  }
+  Payload payload;
+  size_t offset = 0;
+  size_t length = 0;
+  if (!find_field(message.get_rcl_serialized_message(), fixed_offset_, steps_, payload, offset) ||
+    !skip_string(payload, offset, &length))
+  {
+    return false;
+  }
+  value.assign(reinterpret_cast<const char *>(payload.data + offset - length - 1u), length);
+  return true;
+}
+
+bool
+SerializedMessageField::read_number(
+  const rcl_serialized_message_t & message,
+  Number & number) const
+{
+  namespace introspection = rosidl_typesupport_introspection_cpp;
+  const size_t size = plain_cdr::get_size(type_id_);
+  if (size == 0u) {
+    throw std::invalid_argument("the field '" + path_ + "' isn't a number");
+  }
+  Payload payload;
+  size_t offset = 0;
+  if (!find_field(message, fixed_offset_, steps_, payload, offset)) {
+    return false;
+  }
+  uint8_t bytes[8] = {};
+  if (!read_primitive(payload, size, offset, bytes)) {
+    return false;
+  }
+  auto read = [&bytes](auto & value) {
+      std::memcpy(&value, bytes, sizeof(value));
+      return value;
+    };
+  switch (type_id_) {
+    case introspection::ROS_TYPE_FLOAT:
+      {
+        float value;
+        number.kind = Number::Kind::Float;
+        number.float_value = static_cast<double>(read(value));
+        break;
+      }
+    case introspection::ROS_TYPE_DOUBLE:
+      {
+        double value;
+        number.kind = Number::Kind::Float;
+        number.float_value = read(value);
+        break;
+      }
+    case introspection::ROS_TYPE_BOOLEAN:
+      number.kind = Number::Kind::Unsigned;
+      number.unsigned_value = bytes[0] != 0u ? 1u : 0u;
+      break;
+    case introspection::ROS_TYPE_INT8:
+      {
+        int8_t value;
+        number.kind = Number::Kind::Signed;
+        number.signed_value = read(value);
+        break;
+      }
+    case introspection::ROS_TYPE_INT16:
+      {
+        int16_t value;
+        number.kind = Number::Kind::Signed;
+        number.signed_value = read(value);
+        break;
+      }
+    case introspection::ROS_TYPE_INT32:
+      {
+        int32_t value;
+        number.kind = Number::Kind::Signed;
+        number.signed_value = read(value);
+        break;
+      }
+    case introspection::ROS_TYPE_INT64:
+      {
+        int64_t value;
+        number.kind = Number::Kind::Signed;
+        number.signed_value = read(value);
+        break;
+      }
+    case introspection::ROS_TYPE_UINT16:
+      {
+        uint16_t value;
+        number.kind = Number::Kind::Unsigned;
+        number.unsigned_value = read(value);
+        break;
+      }
+    case introspection::ROS_TYPE_UINT32:
+      {
+        uint32_t value;
+        number.kind = Number::Kind::Unsigned;
+        number.unsigned_value = read(value);
+        break;
+      }
+    case introspection::ROS_TYPE_UINT64:
+      {
+        uint64_t value;
+        number.kind = Number::Kind::Unsigned;
+        number.unsigned_value = read(value);
+        break;
+      }
+    default:
+      // The characters, the octets and the uint8.
+      number.kind = Number::Kind::Unsigned;
+      number.unsigned_value = bytes[0];
+      break;
+  }
+  return true;
+}
+
+bool
+SerializedMessageField::read_message(
+  const rcl_serialized_message_t & message,
+  const rosidl_message_type_support_t & type_support,
+  void * ros_message) const
+{
+  namespace introspection = rosidl_typesupport_introspection_cpp;
+  const rosidl_message_type_support_t * introspection_type_support =
+    get_message_typesupport_handle(&type_support, introspection::typesupport_identifier);
+  if (!introspection_type_support) {
+    rcutils_reset_error();
+    throw std::invalid_argument(
+            "the introspection type support of the message read isn't available");
+  }
+  const auto * members = static_cast<const MessageMembers *>(introspection_type_support->data);
+  const auto * field_members = static_cast<const MessageMembers *>(members_);
+  if (!field_members ||
+    (members != field_members &&
+    (std::strcmp(members->message_namespace_, field_members->message_namespace_) != 0 ||
+    std::strcmp(members->message_name_, field_members->message_name_) != 0)))
+  {
+    throw std::invalid_argument(
+            "the field '" + path_ + "' isn't a message of the type " +
+            members->message_namespace_ + "::" + members->message_name_);
+  }
+  Payload payload;
+  size_t offset = 0;
+  return find_field(message, fixed_offset_, steps_, payload, offset) &&
+         read_message_members(field_members, payload, offset, ros_message);
+}
@@ -0,0 +1,72 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/serializer.hpp"
+
+#include "rcpputils/asserts.hpp"
+
+namespace rclcpp
+{
+
+SerializerBase::SerializerBase(
+  const rosidl_message_type_support_t * type_support,
+  size_t initial_capacity,
+  const rcl_allocator_t & allocator)
+: serialization_(type_support),
+  serialized_message_(initial_capacity, allocator)
+{}
+
+const SerializedMessage &
+SerializerBase::serialize_message(const void * ros_message)
+{
+  rcpputils::check_true(nullptr != ros_message, "ROS message is nullpointer.");
+
+  const size_t capacity = serialized_message_.capacity();
+  serialization_.serialize_message(ros_message, &serialized_message_);
+  if (serialized_message_.capacity() != capacity) {
+    // The buffer was grown to fit the message exactly, leave room for larger ones.
+    const size_t size = serialized_message_.size();
+    serialized_message_.reserve(size + size / 2u);
+    ++number_of_allocations_;
+  }
+  return serialized_message_;
+}
+
+const SerializedMessage &
+SerializerBase::get_serialized_message() const
+{
+  return serialized_message_;
+}
+
+void
+SerializerBase::reserve(size_t capacity)
+{
+  if (capacity > serialized_message_.capacity()) {
+    serialized_message_.reserve(capacity);
+  }
+}
+
+size_t
+SerializerBase::capacity() const
+{
+  return serialized_message_.capacity();
+}
+
+size_t
+SerializerBase::get_number_of_allocations() const
+{
+  return number_of_allocations_;
+}
+
+}  // namespace rclcpp
@@ -19,6 +19,7 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
 
 #include "rclcpp/any_service_callback.hpp"
 #include "rclcpp/macros.hpp"
@@ -32,6 +33,12 @@ ServiceBase::ServiceBase(std::shared_ptr<rcl_node_t> node_handle)
   node_logger_(rclcpp::get_node_logger(node_handle_.get()))
 {}
 
+ServiceBase::~ServiceBase()
+{
+  if (intra_process_services_) {
+    intra_process_services_->remove_service(intra_process_service_id_);
+  }
+}
 
 bool
 ServiceBase::take_type_erased_request(void * request_out, rmw_request_id_t & request_id_out)
@@ -48,6 +55,57 @@ ServiceBase::take_type_erased_request(void * request_out, rmw_request_id_t & req
   return true;
 }
 
+bool
+ServiceBase::setup_intra_process(
+  const std::shared_ptr<ServiceBase> & self,
+  rclcpp::Context::SharedPtr context)
+{
+  if (intra_process_queue_) {
+    return true;
+  }
+  const rosidl_service_type_support_t * type_support = get_intra_process_type_support();
+  if (!type_support) {
+    return false;
+  }
+  std::weak_ptr<ServiceBase> weak_self = self;
+  intra_process_queue_ = std::make_shared<experimental::IntraProcessServiceQueue>(
+    context,
+    [weak_self](std::shared_ptr<rmw_request_id_t> request_header, std::shared_ptr<void> request)
+    {
+      auto service = weak_self.lock();
+      if (service) {
+        service->handle_request(std::move(request_header), std::move(request));
+      }
+    });
+  intra_process_services_ = context->get_sub_context<experimental::IntraProcessServices>();
+  intra_process_service_id_ = intra_process_services_->add_service(
+    get_service_name(), type_support, intra_process_queue_);
+  return true;
+}
+
+rclcpp::Waitable::SharedPtr
+ServiceBase::get_intra_process_waitable() const
+{
+  return intra_process_queue_;
+}
+
+void
+ServiceBase::send_intra_process_response(
+  const rmw_request_id_t & request_id,
+  std::shared_ptr<void> response)
+{
+  uint64_t client_id;
+  if (!experimental::IntraProcessServices::get_client_id(request_id, client_id)) {
+    return;
+  }
+  auto client_queue = intra_process_services_->get_client(client_id);
+  if (!client_queue) {
+    RCLCPP_DEBUG(node_logger_, "intra-process client gone, dropping the response");
+    return;
+  }
+  client_queue->push(request_id, std::move(response));
+}
+
 const char *
 ServiceBase::get_service_name()
 {
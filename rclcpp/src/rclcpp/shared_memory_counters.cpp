@@ -0,0 +1,141 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/shared_memory_counters.hpp"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+using rclcpp::SharedMemoryCounters;
+
+constexpr uint32_t rclcpp::SharedMemoryCountersHeader::expected_magic;
+constexpr uint32_t rclcpp::SharedMemoryCountersHeader::current_version;
+constexpr size_t rclcpp::SharedMemoryCounterSlot::name_size;
+
+SharedMemoryCounters::SharedMemoryCounters(const std::string & segment_name, size_t capacity)
+: segment_name_(segment_name)
+{
+  if (capacity == 0) {
+    throw std::invalid_argument("the shared memory counters must have a capacity");
+  }
+#if defined(_WIN32)
+  throw std::runtime_error("shared memory counters are not supported on this platform");
+#else
+  if (segment_name_.empty()) {
+    segment_name_ = "/rclcpp_counters_" + std::to_string(getpid());
+  }
+  mapping_size_ = sizeof(SharedMemoryCountersHeader) + capacity * sizeof(SharedMemoryCounterSlot);
+
+  // A segment left by a previous process with the same pid is replaced
+  shm_unlink(segment_name_.c_str());
+  int fd = shm_open(segment_name_.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    throw std::runtime_error(
+            "couldn't create the shared memory segment '" + segment_name_ + "': " +
+            std::strerror(errno));
+  }
+  if (ftruncate(fd, static_cast<off_t>(mapping_size_)) != 0) {
+    const int error = errno;
+    close(fd);
+    shm_unlink(segment_name_.c_str());
+    throw std::runtime_error(
+            "couldn't size the shared memory segment '" + segment_name_ + "': " +
+            std::strerror(error));
+  }
+  mapping_ = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  const int error = errno;
+  close(fd);
+  if (mapping_ == MAP_FAILED) {
+    mapping_ = nullptr;
+    shm_unlink(segment_name_.c_str());
+    throw std::runtime_error(
+            "couldn't map the shared memory segment '" + segment_name_ + "': " +
+            std::strerror(error));
+  }
+
+  // The segment is zero-filled, the slots are constructed when their counter is added
+  header_ = new (mapping_) SharedMemoryCountersHeader();
+  slots_ = reinterpret_cast<SharedMemoryCounterSlot *>(header_ + 1);
+  header_->version = SharedMemoryCountersHeader::current_version;
+  header_->capacity = static_cast<uint32_t>(capacity);
+  header_->size.store(0u, std::memory_order_relaxed);
+  header_->pid = static_cast<uint64_t>(getpid());
+  // The magic number is written last, once the header is valid
+  std::atomic_thread_fence(std::memory_order_release);
+  header_->magic = SharedMemoryCountersHeader::expected_magic;
+#endif
+}
+
+SharedMemoryCounters::~SharedMemoryCounters()
+{
+#if !defined(_WIN32)
+  if (mapping_) {
+    munmap(mapping_, mapping_size_);
+    shm_unlink(segment_name_.c_str());
+  }
+#endif
+}
+
+std::atomic<uint64_t> &
+SharedMemoryCounters::add_counter(const std::string & name)
+{
+  if (name.empty() || name.size() >= SharedMemoryCounterSlot::name_size) {
+    throw std::invalid_argument(
+            "the name of a shared memory counter must have between 1 and " +
+            std::to_string(SharedMemoryCounterSlot::name_size - 1) + " characters: '" +
+            name + "'");
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  const uint32_t index = header_->size.load(std::memory_order_relaxed);
+  if (index >= header_->capacity) {
+    throw std::runtime_error(
+            "the shared memory segment '" + segment_name_ + "' is full, can't add counter '" +
+            name + "'");
+  }
+  SharedMemoryCounterSlot * slot = new (&slots_[index]) SharedMemoryCounterSlot();
+  std::memcpy(slot->name, name.c_str(), name.size() + 1);
+  slot->value.store(0u, std::memory_order_relaxed);
+  // Readers see the name of the slot once they see the new size
+  header_->size.store(index + 1u, std::memory_order_release);
+  return slot->value;
+}
+
+const std::string &
+SharedMemoryCounters::get_segment_name() const
+{
+  return segment_name_;
+}
+
+size_t
+SharedMemoryCounters::size() const
+{
+  return header_->size.load(std::memory_order_relaxed);
+}
+
+size_t
+SharedMemoryCounters::capacity() const
+{
+  return header_->capacity;
+}
@@ -0,0 +1,203 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "./shared_rosout.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "rcl/error_handling.h"
+#include "rcl/logging.h"
+#include "rcl/time.h"
+#include "rcl_interfaces/msg/log.hpp"
+#include "rcutils/logging_macros.h"
+#include "rosidl_typesupport_cpp/message_type_support.hpp"
+
+#include "rclcpp/exceptions.hpp"
+
+using rclcpp::detail::SharedRosoutPublisher;
+
+namespace
+{
+
+struct RegisteredLogger
+{
+  // Number of nodes of this logger
+  size_t count;
+  rcl_publisher_t * publisher;
+};
+
+std::mutex g_loggers_mutex;
+std::unordered_map<std::string, RegisteredLogger> g_loggers;
+// Checked without locking, so that nothing is done when no node shares a publisher
+std::atomic<size_t> g_number_of_loggers{0u};
+// Set while publishing, so that the log messages of rcl itself aren't published again
+thread_local bool t_publishing = false;
+
+std::string
+format_message(const char * format, va_list * args)
+{
+  va_list args_copy;
+  va_copy(args_copy, *args);
+  const int length = std::vsnprintf(nullptr, 0, format, args_copy);
+  va_end(args_copy);
+  if (length <= 0) {
+    return std::string();
+  }
+  std::string message(static_cast<size_t>(length), '\0');
+  va_copy(args_copy, *args);
+  std::vsnprintf(&message[0], message.size() + 1u, format, args_copy);
+  va_end(args_copy);
+  return message;
+}
+
+}  // namespace
+
+SharedRosoutPublisher::SharedRosoutPublisher(
+  std::shared_ptr<rcl_context_t> rcl_context,
+  const rmw_qos_profile_t & qos)
+: rcl_context_(std::move(rcl_context)),
+  node_(rcl_get_zero_initialized_node()),
+  publisher_(rcl_get_zero_initialized_publisher())
+{
+  static std::atomic<size_t> next_node_id{0u};
+  const std::string node_name = "_rclcpp_rosout_" + std::to_string(next_node_id++);
+  rcl_node_options_t node_options = rcl_node_get_default_options();
+  node_options.use_global_arguments = false;
+  node_options.enable_rosout = false;
+  rcl_ret_t ret = rcl_node_init(
+    &node_, node_name.c_str(), "/", rcl_context_.get(), &node_options);
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(
+      ret, "failed to create the node of the shared rosout publisher");
+  }
+
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  publisher_options.qos = qos;
+  ret = rcl_publisher_init(
+    &publisher_, &node_,
+    rosidl_typesupport_cpp::get_message_type_support_handle<rcl_interfaces::msg::Log>(),
+    "/rosout", &publisher_options);
+  if (RCL_RET_OK != ret) {
+    // The error state is copied, since finalizing the node may set another one
+    const rcl_error_state_t error_state = *rcl_get_error_state();
+    rcl_reset_error();
+    if (RCL_RET_OK != rcl_node_fini(&node_)) {
+      rcl_reset_error();
+    }
+    rclcpp::exceptions::throw_from_rcl_error(
+      ret, "failed to create the shared rosout publisher", &error_state, nullptr);
+  }
+}
+
+SharedRosoutPublisher::~SharedRosoutPublisher()
+{
+  {
+    std::lock_guard<std::mutex> lock(g_loggers_mutex);
+    for (auto it = g_loggers.begin(); it != g_loggers.end(); ) {
+      if (it->second.publisher == &publisher_) {
+        it = g_loggers.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    g_number_of_loggers = g_loggers.size();
+  }
+  if (RCL_RET_OK != rcl_publisher_fini(&publisher_, &node_)) {
+    RCUTILS_LOG_ERROR_NAMED(
+      "rclcpp",
+      "Error in destruction of the shared rosout publisher: %s", rcl_get_error_string().str);
+    rcl_reset_error();
+  }
+  if (RCL_RET_OK != rcl_node_fini(&node_)) {
+    RCUTILS_LOG_ERROR_NAMED(
+      "rclcpp",
+      "Error in destruction of the shared rosout node: %s", rcl_get_error_string().str);
+    rcl_reset_error();
+  }
+}
+
+void
+SharedRosoutPublisher::add_logger(const std::string & logger_name)
+{
+  std::lock_guard<std::mutex> lock(g_loggers_mutex);
+  auto & logger = g_loggers[logger_name];
+  if (0u == logger.count) {
+    logger.publisher = &publisher_;
+  }
+  ++logger.count;
+  g_number_of_loggers = g_loggers.size();
+}
+
+void
+SharedRosoutPublisher::remove_logger(const std::string & logger_name)
+{
+  std::lock_guard<std::mutex> lock(g_loggers_mutex);
+  auto it = g_loggers.find(logger_name);
+  if (it != g_loggers.end() && 0u == --it->second.count) {
+    g_loggers.erase(it);
+  }
+  g_number_of_loggers = g_loggers.size();
+}
+
+void
+rclcpp::detail::publish_to_shared_rosout(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args)
+{
+  if (0u == g_number_of_loggers.load(std::memory_order_relaxed) || t_publishing ||
+    nullptr == name || !rcl_logging_rosout_enabled())
+  {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(g_loggers_mutex);
+  // The child loggers of a node are published with the publisher of the node
+  std::string logger_name(name);
+  auto it = g_loggers.find(logger_name);
+  while (it == g_loggers.end()) {
+    const size_t separator = logger_name.rfind('.');
+    if (std::string::npos == separator) {
+      return;
+    }
+    logger_name.resize(separator);
+    it = g_loggers.find(logger_name);
+  }
+
+  rcl_interfaces::msg::Log log_message;
+  log_message.stamp.sec = static_cast<int32_t>(RCL_NS_TO_S(timestamp));
+  log_message.stamp.nanosec = static_cast<uint32_t>(timestamp % (1000LL * 1000LL * 1000LL));
+  log_message.level = static_cast<uint8_t>(severity);
+  log_message.name = name;
+  log_message.msg = format_message(format, args);
+  if (location) {
+    log_message.file = location->file_name;
+    log_message.function = location->function_name;
+    log_message.line = static_cast<uint32_t>(location->line_number);
+  }
+  t_publishing = true;
+  if (RCL_RET_OK != rcl_publish(it->second.publisher, &log_message, nullptr)) {
+    // The context may have been shut down, and the log message was output anyway
+    rcl_reset_error();
+  }
+  t_publishing = false;
+}
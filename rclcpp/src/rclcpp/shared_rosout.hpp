@@ -0,0 +1,96 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP__SHARED_ROSOUT_HPP_
+#define RCLCPP__SHARED_ROSOUT_HPP_
+
+#include <cstdarg>
+#include <memory>
+#include <string>
+
+#include "rcl/context.h"
+#include "rcl/node.h"
+#include "rcl/publisher.h"
+#include "rcutils/logging.h"
+#include "rcutils/time.h"
+#include "rmw/types.h"
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Publisher on /rosout shared by all the nodes of a context.
+/**
+ * Instead of rcl creating a rosout publisher for each node, the nodes of a context whose
+ * init options set rclcpp::InitOptions::share_rosout_publisher() register their logger
+ * with this sub context, and their log messages are published by its hidden node.
+ * The log messages keep the name of their logger, as with the publishers of rcl.
+ * The loggers of the nodes are registered while holding the global logging mutex.
+ */
+class SharedRosoutPublisher
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(SharedRosoutPublisher)
+
+  /// Create the hidden node and its publisher.
+  /**
+   * \param[in] rcl_context initialized context of the nodes, kept alive by the publisher.
+   * \param[in] qos QoS of the publisher, the one of the first node using it.
+   * \throws anything rclcpp::exceptions::throw_from_rcl_error can throw.
+   */
+  RCLCPP_LOCAL
+  SharedRosoutPublisher(std::shared_ptr<rcl_context_t> rcl_context, const rmw_qos_profile_t & qos);
+
+  RCLCPP_LOCAL
+  ~SharedRosoutPublisher();
+
+  /// Publish the log messages of a logger, until it's removed as many times as it's added.
+  RCLCPP_LOCAL
+  void
+  add_logger(const std::string & logger_name);
+
+  /// Stop publishing the log messages of a logger added before.
+  RCLCPP_LOCAL
+  void
+  remove_logger(const std::string & logger_name);
+
+private:
+  RCLCPP_DISABLE_COPY(SharedRosoutPublisher)
+
+  std::shared_ptr<rcl_context_t> rcl_context_;
+  rcl_node_t node_;
+  rcl_publisher_t publisher_;
+};
+
+/// Publish a log message with the shared rosout publisher of its logger, if it has one.
+/**
+ * The log messages of the child loggers of a node are published too.
+ * It must be called with the global logging mutex held, by the output handlers of rclcpp.
+ */
+RCLCPP_LOCAL
+void
+publish_to_shared_rosout(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args);
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__SHARED_ROSOUT_HPP_
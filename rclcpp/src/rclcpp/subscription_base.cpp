@@ -16,24 +16,37 @@
 
 #include <cstdio>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "rcpputils/scope_exit.hpp"
 
+#include "rclcpp/deserialization_pool.hpp"
+#include "rclcpp/detail/content_filter.hpp"
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/expand_topic_or_service_name.hpp"
 #include "rclcpp/experimental/intra_process_manager.hpp"
 #include "rclcpp/logging.hpp"
 #include "rclcpp/node_interfaces/node_base_interface.hpp"
 #include "rclcpp/qos_event.hpp"
+#include "rclcpp/trace_recorder.hpp"
 
 #include "rmw/error_handling.h"
+#include "rmw/message_sequence.h"
 #include "rmw/rmw.h"
 
 using rclcpp::SubscriptionBase;
 
+struct SubscriptionBase::LocalContentFilter
+{
+  rclcpp::ContentFilterOptions options;
+  // Null if the expression is empty
+  std::unique_ptr<const rclcpp::detail::ContentFilter> filter;
+};
+
 SubscriptionBase::SubscriptionBase(
   rclcpp::node_interfaces::NodeBaseInterface * node_base,
   const rosidl_message_type_support_t & type_support_handle,
@@ -167,6 +180,12 @@ SubscriptionBase::get_event_handlers() const
   return event_handlers_;
 }
 
+std::shared_ptr<rclcpp::QOSEventHandlerGroup>
+SubscriptionBase::get_event_handler_group() const
+{
+  return event_handler_group_;
+}
+
 rclcpp::QoS
 SubscriptionBase::get_actual_qos() const
 {
@@ -183,26 +202,111 @@ SubscriptionBase::get_actual_qos() const
 bool
 SubscriptionBase::take_type_erased(void * message_out, rclcpp::MessageInfo & message_info_out)
 {
-  rcl_ret_t ret = rcl_take(
-    this->get_subscription_handle().get(),
-    message_out,
-    &message_info_out.get_rmw_message_info(),
-    nullptr  // rmw_subscription_allocation_t is unused here
-  );
-  TRACEPOINT(rclcpp_take, static_cast<const void *>(message_out));
-  if (RCL_RET_SUBSCRIPTION_TAKE_FAILED == ret) {
-    return false;
-  } else if (RCL_RET_OK != ret) {
-    rclcpp::exceptions::throw_from_rcl_error(ret);
+  const auto local_content_filter = std::atomic_load(&local_content_filter_);
+  const rclcpp::detail::ContentFilter * content_filter =
+    local_content_filter ? local_content_filter->filter.get() : nullptr;
+  // The messages are taken serialized when some are dropped without being deserialized.
+  if (take_only_latest_ || (content_filter && content_filter->can_evaluate_serialized())) {
+    return take_and_deserialize(message_out, message_info_out, content_filter);
   }
-  if (
-    matches_any_intra_process_publishers(&message_info_out.get_rmw_message_info().publisher_gid))
+
+  // The messages not matching the filter are dropped, until one matches or none is left.
+  while (true) {
+    rcl_ret_t ret = rcl_take(
+      this->get_subscription_handle().get(),
+      message_out,
+      &message_info_out.get_rmw_message_info(),
+      nullptr  // rmw_subscription_allocation_t is unused here
+    );
+    TRACEPOINT(rclcpp_take, static_cast<const void *>(message_out));
+    if (RCL_RET_SUBSCRIPTION_TAKE_FAILED == ret) {
+      return false;
+    } else if (RCL_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(ret);
+    }
+    RCLCPP_TRACE_RECORD(Take, this, this->get_topic_name());
+    if (
+      matches_any_intra_process_publishers(&message_info_out.get_rmw_message_info().publisher_gid))
+    {
+      // In this case, the message will be delivered via intra-process and
+      // we should ignore this copy of the message.
+      return false;
+    }
+    if (!content_filter || content_filter->evaluate(message_out)) {
+      return true;
+    }
+  }
+}
+
+bool
+SubscriptionBase::take_type_erased_sequence(
+  std::vector<std::shared_ptr<void>> & messages,
+  std::vector<rclcpp::MessageInfo> & message_infos)
+{
+  message_infos.resize(messages.size());
+  size_t taken = 0;
+  const auto local_content_filter = std::atomic_load(&local_content_filter_);
+  if (take_only_latest_ || (local_content_filter && local_content_filter->filter) ||
+    !take_sequence_supported_.load())
   {
-    // In this case, the message will be delivered via intra-process and
-    // we should ignore this copy of the message.
-    return false;
+    while (taken < messages.size() && take_type_erased(messages[taken].get(), message_infos[taken]))
+    {
+      ++taken;
+    }
+  } else {
+    rcl_allocator_t allocator = rcl_get_default_allocator();
+    rmw_message_sequence_t message_sequence = rmw_get_zero_initialized_message_sequence();
+    rmw_ret_t ret = rmw_message_sequence_init(&message_sequence, messages.size(), &allocator);
+    if (RMW_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(ret, "failed to initialize the message sequence");
+    }
+    RCPPUTILS_SCOPE_EXIT((void)rmw_message_sequence_fini(&message_sequence); );
+    rmw_message_info_sequence_t message_info_sequence =
+      rmw_get_zero_initialized_message_info_sequence();
+    ret = rmw_message_info_sequence_init(&message_info_sequence, messages.size(), &allocator);
+    if (RMW_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(
+        ret, "failed to initialize the message info sequence");
+    }
+    RCPPUTILS_SCOPE_EXIT((void)rmw_message_info_sequence_fini(&message_info_sequence); );
+    for (size_t i = 0; i < messages.size(); ++i) {
+      message_sequence.data[i] = messages[i].get();
+    }
+
+    rcl_ret_t take_ret = rcl_take_sequence(
+      this->get_subscription_handle().get(),
+      messages.size(),
+      &message_sequence,
+      &message_info_sequence,
+      nullptr  // rmw_subscription_allocation_t is unused here
+    );
+    if (RCL_RET_UNSUPPORTED == take_ret) {
+      // Taken one at a time from now on.
+      rcl_reset_error();
+      take_sequence_supported_.store(false);
+      return take_type_erased_sequence(messages, message_infos);
+    } else if (RCL_RET_OK == take_ret) {
+      // The intra-process messages are moved out of the ones kept, to be returned.
+      for (size_t i = 0; i < message_sequence.size; ++i) {
+        const rmw_message_info_t & message_info = message_info_sequence.data[i];
+        if (!matches_any_intra_process_publishers(&message_info.publisher_gid)) {
+          std::swap(messages[taken], messages[i]);
+          message_infos[taken] = rclcpp::MessageInfo(message_info);
+          ++taken;
+        }
+      }
+      RCLCPP_TRACE_RECORD(Take, this, this->get_topic_name());
+    } else if (RCL_RET_SUBSCRIPTION_TAKE_FAILED != take_ret) {
+      rclcpp::exceptions::throw_from_rcl_error(take_ret);
+    }
   }
-  return true;
+
+  for (size_t i = taken; i < messages.size(); ++i) {
+    return_message(messages[i]);
+  }
+  messages.resize(taken);
+  message_infos.resize(taken);
+  return taken > 0u;
 }
 
 bool
@@ -210,25 +314,122 @@ SubscriptionBase::take_serialized(
   rclcpp::SerializedMessage & message_out,
   rclcpp::MessageInfo & message_info_out)
 {
-  rcl_ret_t ret = rcl_take_serialized_message(
-    this->get_subscription_handle().get(),
-    &message_out.get_rcl_serialized_message(),
-    &message_info_out.get_rmw_message_info(),
-    nullptr);
-  if (RCL_RET_SUBSCRIPTION_TAKE_FAILED == ret) {
+  const auto local_content_filter = std::atomic_load(&local_content_filter_);
+  const rclcpp::detail::ContentFilter * content_filter =
+    local_content_filter ? local_content_filter->filter.get() : nullptr;
+  // The serialized messages are only filtered if they don't have to be deserialized for it.
+  bool evaluated = false;
+  if (!take_next_serialized_message(
+      message_out.get_rcl_serialized_message(), message_info_out.get_rmw_message_info(),
+      content_filter, evaluated))
+  {
     return false;
-  } else if (RCL_RET_OK != ret) {
-    rclcpp::exceptions::throw_from_rcl_error(ret);
   }
+  if (take_only_latest_) {
+    take_newer_serialized_messages(
+      message_out.get_rcl_serialized_message(), message_info_out.get_rmw_message_info(),
+      content_filter, evaluated);
+  }
+  RCLCPP_TRACE_RECORD(Take, this, this->get_topic_name());
   return true;
 }
 
+bool
+SubscriptionBase::take_next_serialized_message(
+  rcl_serialized_message_t & message_out,
+  rmw_message_info_t & message_info_out,
+  const rclcpp::detail::ContentFilter * content_filter,
+  bool & evaluated)
+{
+  while (true) {
+    rcl_ret_t ret = rcl_take_serialized_message(
+      subscription_handle_.get(), &message_out, &message_info_out, nullptr);
+    if (RCL_RET_SUBSCRIPTION_TAKE_FAILED == ret) {
+      return false;
+    } else if (RCL_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(ret);
+    }
+    if (matches_any_intra_process_publishers(&message_info_out.publisher_gid)) {
+      // It's delivered via intra-process.
+      continue;
+    }
+    bool matches = true;
+    evaluated = content_filter && content_filter->evaluate_serialized(message_out, matches);
+    if (matches) {
+      return true;
+    }
+  }
+}
+
+void
+SubscriptionBase::take_newer_serialized_messages(
+  rcl_serialized_message_t & message,
+  rmw_message_info_t & message_info,
+  const rclcpp::detail::ContentFilter * content_filter,
+  bool & evaluated)
+{
+  // Shared by the subscriptions of the thread, its buffer is exchanged with the newer messages.
+  thread_local rclcpp::SerializedMessage next_message;
+  rmw_message_info_t next_message_info = rmw_get_zero_initialized_message_info();
+  bool next_evaluated = false;
+  while (take_next_serialized_message(
+      next_message.get_rcl_serialized_message(), next_message_info, content_filter,
+      next_evaluated))
+  {
+    std::swap(message, next_message.get_rcl_serialized_message());
+    message_info = next_message_info;
+    evaluated = next_evaluated;
+  }
+}
+
+bool
+SubscriptionBase::take_and_deserialize(
+  void * message_out,
+  rclcpp::MessageInfo & message_info_out,
+  const rclcpp::detail::ContentFilter * content_filter)
+{
+  // Shared by the subscriptions of the thread, so that its buffer is reused by all the takes.
+  thread_local rclcpp::SerializedMessage serialized_message;
+  rcl_serialized_message_t & rcl_serialized_message =
+    serialized_message.get_rcl_serialized_message();
+  rmw_message_info_t & rmw_message_info = message_info_out.get_rmw_message_info();
+  bool evaluated = false;
+  while (take_next_serialized_message(
+      rcl_serialized_message, rmw_message_info, content_filter, evaluated))
+  {
+    if (take_only_latest_) {
+      take_newer_serialized_messages(
+        rcl_serialized_message, rmw_message_info, content_filter, evaluated);
+    }
+    rmw_ret_t ret = rmw_deserialize(&rcl_serialized_message, &type_support_, message_out);
+    if (RMW_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(ret, "failed to deserialize the message");
+    }
+    if (!content_filter || evaluated || content_filter->evaluate(message_out)) {
+      TRACEPOINT(rclcpp_take, static_cast<const void *>(message_out));
+      RCLCPP_TRACE_RECORD(Take, this, this->get_topic_name());
+      return true;
+    }
+  }
+  return false;
+}
+
 const rosidl_message_type_support_t &
 SubscriptionBase::get_message_type_support_handle() const
 {
   return type_support_;
 }
 
+void
+SubscriptionBase::handle_messages(
+  std::vector<std::shared_ptr<void>> & messages,
+  const std::vector<rclcpp::MessageInfo> & message_infos)
+{
+  for (size_t i = 0; i < messages.size(); ++i) {
+    handle_message(messages[i], message_infos[i]);
+  }
+}
+
 bool
 SubscriptionBase::is_serialized() const
 {
@@ -263,9 +464,28 @@ SubscriptionBase::setup_intra_process(
 bool
 SubscriptionBase::can_loan_messages() const
 {
+  // The loaned messages aren't filtered, and are taken one at a time.
+  const auto local_content_filter = std::atomic_load(&local_content_filter_);
+  if (take_only_latest_ || deserialization_pool_ ||
+    (local_content_filter && local_content_filter->filter))
+  {
+    return false;
+  }
   return rcl_subscription_can_loan_messages(subscription_handle_.get());
 }
 
+size_t
+SubscriptionBase::get_max_messages_per_wakeup() const
+{
+  return max_messages_per_wakeup_;
+}
+
+bool
+SubscriptionBase::has_batch_callback() const
+{
+  return batch_callback_;
+}
+
 rclcpp::Waitable::SharedPtr
 SubscriptionBase::get_intra_process_waitable() const
 {
@@ -285,6 +505,154 @@ SubscriptionBase::get_intra_process_waitable() const
   return ipm->get_subscription_intra_process(intra_process_subscription_id_);
 }
 
+bool
+SubscriptionBase::uses_deserialization_pool() const
+{
+  return deserialization_pool_ != nullptr;
+}
+
+rclcpp::Waitable::SharedPtr
+SubscriptionBase::get_deserialization_waitable() const
+{
+  return deserialized_message_queue_;
+}
+
+void
+SubscriptionBase::enable_deserialization_pool(
+  std::shared_ptr<rclcpp::DeserializationPool> deserialization_pool,
+  size_t min_size)
+{
+  if (!deserialization_pool) {
+    throw std::invalid_argument("the deserialization pool of the subscription is null");
+  }
+  std::weak_ptr<SubscriptionBase> weak_this = shared_from_this();
+  deserialized_message_queue_ = std::make_shared<rclcpp::detail::DeserializedMessageQueue>(
+    node_base_->get_context(),
+    [weak_this](rclcpp::detail::DeserializedMessageQueue::Entry & entry) {
+      auto subscription = weak_this.lock();
+      if (subscription) {
+        subscription->handle_deserialized_message(entry);
+      }
+    });
+  deserialization_pool_ = std::move(deserialization_pool);
+  deserialization_pool_min_size_ = min_size;
+}
+
+bool
+SubscriptionBase::take_for_deserialization_pool(
+  std::shared_ptr<void> & message_out,
+  rclcpp::MessageInfo & message_info_out)
+{
+  message_out.reset();
+  const auto local_content_filter = std::atomic_load(&local_content_filter_);
+  const rclcpp::detail::ContentFilter * content_filter =
+    local_content_filter ? local_content_filter->filter.get() : nullptr;
+
+  auto entry = deserialized_message_queue_->create_entry();
+  rcl_serialized_message_t & rcl_serialized_message =
+    entry->serialized_message.get_rcl_serialized_message();
+  rmw_message_info_t & rmw_message_info = entry->message_info.get_rmw_message_info();
+  bool evaluated = false;
+  if (!take_next_serialized_message(
+      rcl_serialized_message, rmw_message_info, content_filter, evaluated))
+  {
+    deserialized_message_queue_->recycle_entry(std::move(entry));
+    return false;
+  }
+  if (take_only_latest_) {
+    take_newer_serialized_messages(
+      rcl_serialized_message, rmw_message_info, content_filter, evaluated);
+  }
+  RCLCPP_TRACE_RECORD(Take, this, this->get_topic_name());
+  entry->message = create_message();
+  entry->content_filter_evaluated = !content_filter || evaluated;
+
+  if (rcl_serialized_message.buffer_length < deserialization_pool_min_size_ &&
+    deserialized_message_queue_->empty())
+  {
+    // No older message is waiting, so it's deserialized and handled right away.
+    rmw_ret_t ret = rmw_deserialize(&rcl_serialized_message, &type_support_, entry->message.get());
+    if (RMW_RET_OK == ret &&
+      (entry->content_filter_evaluated || content_filter->evaluate(entry->message.get())))
+    {
+      message_out = std::move(entry->message);
+      message_info_out = entry->message_info;
+    } else {
+      return_message(entry->message);
+    }
+    deserialized_message_queue_->recycle_entry(std::move(entry));
+    if (RMW_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(ret, "failed to deserialize the message");
+    }
+    return true;
+  }
+
+  deserialized_message_queue_->push(entry);
+  if (rcl_serialized_message.buffer_length < deserialization_pool_min_size_) {
+    // It's deserialized here too, but handled after the messages taken before it.
+    entry->deserialized =
+      RMW_RET_OK == rmw_deserialize(&rcl_serialized_message, &type_support_, entry->message.get());
+    if (!entry->deserialized) {
+      rmw_reset_error();
+    }
+    deserialized_message_queue_->set_ready(entry);
+    return true;
+  }
+  deserialization_pool_->submit(
+    [type_support = type_support_, entry, queue = deserialized_message_queue_]() {
+      entry->deserialized = RMW_RET_OK == rmw_deserialize(
+        &entry->serialized_message.get_rcl_serialized_message(), &type_support,
+        entry->message.get());
+      if (!entry->deserialized) {
+        rmw_reset_error();
+      }
+      queue->set_ready(entry);
+    });
+  return true;
+}
+
+void
+SubscriptionBase::handle_deserialized_message(
+  rclcpp::detail::DeserializedMessageQueue::Entry & entry)
+{
+  if (!entry.deserialized) {
+    RCLCPP_ERROR(
+      node_logger_,
+      "failed to deserialize a message of topic '%s', it's dropped", get_topic_name());
+    return_message(entry.message);
+    return;
+  }
+  if (!entry.content_filter_evaluated) {
+    const auto local_content_filter = std::atomic_load(&local_content_filter_);
+    if (local_content_filter && local_content_filter->filter &&
+      !local_content_filter->filter->evaluate(entry.message.get()))
+    {
+      return_message(entry.message);
+      return;
+    }
+  }
+  handle_message(entry.message, entry.message_info);
+  return_message(entry.message);
+}
+
+rclcpp::experimental::buffers::BufferCounters
+SubscriptionBase::get_intra_process_buffer_counters() const
+{
+  if (!use_intra_process_ || !subscription_intra_process_) {
+    return rclcpp::experimental::buffers::BufferCounters();
+  }
+  return subscription_intra_process_->get_buffer_counters();
+}
+
+rclcpp::IntraProcessCounters
+SubscriptionBase::get_intra_process_receive_counters() const
+{
+  if (!use_intra_process_ || !subscription_intra_process_) {
+    return rclcpp::IntraProcessCounters();
+  }
+  return subscription_intra_process_->get_received_counters();
+}
+
 void
 SubscriptionBase::default_incompatible_qos_callback(
   rclcpp::QOSRequestedIncompatibleQoSInfo & event) const
@@ -311,7 +679,10 @@ SubscriptionBase::matches_any_intra_process_publishers(const rmw_gid_t * sender_
             "intra process publisher check called "
             "after destruction of intra process manager");
   }
-  return ipm->matches_any_publishers(sender_gid);
+  // Only the publishers of the same kind of messages publish intra-process to this subscription.
+  const bool is_serialized =
+    subscription_intra_process_ && subscription_intra_process_->is_serialized();
+  return ipm->matches_any_publishers(sender_gid, is_serialized);
 }
 
 bool
@@ -402,6 +773,12 @@ SubscriptionBase::set_content_filter(
   const std::string & filter_expression,
   const std::vector<std::string> & expression_parameters)
 {
+  if (local_content_filter_enabled_ && !is_cft_enabled()) {
+    set_local_content_filter(filter_expression, expression_parameters);
+    set_intra_process_content_filter(filter_expression, expression_parameters);
+    return;
+  }
+
   rcl_subscription_content_filter_options_t options =
     rcl_get_zero_initialized_subscription_content_filter_options();
 
@@ -437,11 +814,77 @@ SubscriptionBase::set_content_filter(
   if (RCL_RET_OK != ret) {
     rclcpp::exceptions::throw_from_rcl_error(ret, "failed to set cft expression parameters");
   }
+  set_intra_process_content_filter(filter_expression, expression_parameters);
+}
+
+void
+SubscriptionBase::set_intra_process_content_filter(
+  const std::string & filter_expression,
+  const std::vector<std::string> & expression_parameters)
+{
+  // The serialized messages would have to be deserialized to be filtered.
+  if (!subscription_intra_process_ || subscription_intra_process_->is_serialized()) {
+    return;
+  }
+  std::shared_ptr<const rclcpp::detail::ContentFilter> content_filter;
+  if (!filter_expression.empty()) {
+    try {
+      content_filter = std::make_shared<rclcpp::detail::ContentFilter>(
+        type_support_, filter_expression, expression_parameters);
+    } catch (const std::invalid_argument & exception) {
+      RCLCPP_WARN(
+        node_logger_,
+        "the content filter of the subscription on '%s' isn't applied to the "
+        "intra-process messages: %s", get_topic_name(), exception.what());
+    }
+  }
+  subscription_intra_process_->set_content_filter(std::move(content_filter));
+}
+
+void
+SubscriptionBase::enable_local_content_filter(
+  const rclcpp::ContentFilterOptions & content_filter_options)
+{
+  local_content_filter_enabled_ = true;
+  if (is_cft_enabled()) {
+    return;
+  }
+  try {
+    set_local_content_filter(
+      content_filter_options.filter_expression, content_filter_options.expression_parameters);
+  } catch (const std::invalid_argument & exception) {
+    RCLCPP_WARN(
+      node_logger_,
+      "the content filter of the subscription on '%s' isn't applied in the process: %s",
+      get_topic_name(), exception.what());
+  }
+}
+
+void
+SubscriptionBase::set_local_content_filter(
+  const std::string & filter_expression,
+  const std::vector<std::string> & expression_parameters)
+{
+  auto local_content_filter = std::make_shared<LocalContentFilter>();
+  local_content_filter->options.filter_expression = filter_expression;
+  local_content_filter->options.expression_parameters = expression_parameters;
+  if (!filter_expression.empty()) {
+    local_content_filter->filter = std::make_unique<rclcpp::detail::ContentFilter>(
+      type_support_, filter_expression, expression_parameters);
+  }
+  std::atomic_store(
+    &local_content_filter_,
+    std::shared_ptr<const LocalContentFilter>(std::move(local_content_filter)));
 }
 
 rclcpp::ContentFilterOptions
 SubscriptionBase::get_content_filter() const
 {
+  if (local_content_filter_enabled_ && !is_cft_enabled()) {
+    const auto local_content_filter = std::atomic_load(&local_content_filter_);
+    return local_content_filter ? local_content_filter->options : rclcpp::ContentFilterOptions();
+  }
+
   rclcpp::ContentFilterOptions ret_options;
   rcl_subscription_content_filter_options_t options =
     rcl_get_zero_initialized_subscription_content_filter_options();
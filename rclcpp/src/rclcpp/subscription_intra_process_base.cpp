@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <memory>
+#include <utility>
+
 #include "rclcpp/experimental/subscription_intra_process_base.hpp"
 #include "rclcpp/detail/add_guard_condition_to_rcl_wait_set.hpp"
 
@@ -34,3 +37,22 @@ SubscriptionIntraProcessBase::get_actual_qos() const
 {
   return qos_profile_;
 }
+
+void
+SubscriptionIntraProcessBase::set_content_filter(
+  std::shared_ptr<const rclcpp::detail::ContentFilter> content_filter)
+{
+  const bool has_content_filter = content_filter != nullptr;
+  std::atomic_store(&content_filter_, std::move(content_filter));
+  has_content_filter_.store(has_content_filter);
+}
+
+bool
+SubscriptionIntraProcessBase::matches_content_filter(const void * ros_message) const
+{
+  if (!has_content_filter_.load()) {
+    return true;
+  }
+  auto content_filter = std::atomic_load(&content_filter_);
+  return !content_filter || content_filter->evaluate(ros_message);
+}
@@ -0,0 +1,110 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/experimental/subscription_serialized_intra_process.hpp"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "rclcpp/experimental/create_intra_process_buffer.hpp"
+
+using rclcpp::experimental::SubscriptionSerializedIntraProcess;
+
+SubscriptionSerializedIntraProcess::SubscriptionSerializedIntraProcess(
+  CallbackT callback,
+  rclcpp::Context::SharedPtr context,
+  const std::string & topic_name,
+  const rclcpp::QoS & qos_profile,
+  rclcpp::IntraProcessBufferImplementation buffer_implementation,
+  size_t max_buffer_depth)
+: SubscriptionIntraProcessBase(context, topic_name, qos_profile),
+  callback_(std::move(callback))
+{
+  buffer_ = rclcpp::experimental::create_intra_process_buffer<rclcpp::SerializedMessage>(
+    rclcpp::IntraProcessBufferType::SharedPtr,
+    qos_profile,
+    std::make_shared<std::allocator<void>>(),
+    buffer_implementation,
+    max_buffer_depth);
+}
+
+SubscriptionSerializedIntraProcess::~SubscriptionSerializedIntraProcess() {}
+
+bool
+SubscriptionSerializedIntraProcess::is_ready(rcl_wait_set_t * wait_set)
+{
+  (void) wait_set;
+  return buffer_->has_data();
+}
+
+bool
+SubscriptionSerializedIntraProcess::has_data() const
+{
+  return buffer_->has_data();
+}
+
+std::shared_ptr<void>
+SubscriptionSerializedIntraProcess::take_data()
+{
+  ConstMessageSharedPtr message = buffer_->consume_shared();
+  if (!message) {
+    return nullptr;
+  }
+  return taken_data_slot_.make(std::move(message));
+}
+
+void
+SubscriptionSerializedIntraProcess::execute(std::shared_ptr<void> & data)
+{
+  if (!data) {
+    return;
+  }
+  auto message = std::static_pointer_cast<ConstMessageSharedPtr>(data);
+  received_counters_.record((*message)->size());
+  // Moved, so that the callback can tell whether the message is shared.
+  callback_(std::move(*message));
+}
+
+bool
+SubscriptionSerializedIntraProcess::use_take_shared_method() const
+{
+  return true;
+}
+
+bool
+SubscriptionSerializedIntraProcess::is_serialized() const
+{
+  return true;
+}
+
+rclcpp::experimental::buffers::BufferCounters
+SubscriptionSerializedIntraProcess::get_buffer_counters() const
+{
+  return buffer_->get_counters();
+}
+
+void
+SubscriptionSerializedIntraProcess::provide_intra_process_message(ConstMessageSharedPtr message)
+{
+  buffer_->add_shared(std::move(message));
+  trigger_guard_condition();
+  this->invoke_on_new_message();
+}
+
+void
+SubscriptionSerializedIntraProcess::trigger_guard_condition()
+{
+  this->gc_.trigger();
+}
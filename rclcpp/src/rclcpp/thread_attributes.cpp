@@ -0,0 +1,121 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/thread_attributes.hpp"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+
+#ifdef __linux__
+std::set<size_t>
+get_numa_node_cpus(int numa_node)
+{
+  const std::string path =
+    "/sys/devices/system/node/node" + std::to_string(numa_node) + "/cpulist";
+  std::ifstream file(path);
+  std::string cpu_list;
+  if (!file || !std::getline(file, cpu_list)) {
+    throw std::runtime_error(
+            "failed to read the CPUs of NUMA node " + std::to_string(numa_node) +
+            " from '" + path + "'");
+  }
+
+  // The list has the form "0-3,8-11".
+  std::set<size_t> cpus;
+  std::stringstream cpu_list_stream(cpu_list);
+  std::string range;
+  while (std::getline(cpu_list_stream, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+    const auto dash = range.find('-');
+    const size_t first = std::stoul(range.substr(0, dash));
+    const size_t last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+    for (size_t cpu = first; cpu <= last; ++cpu) {
+      cpus.insert(cpu);
+    }
+  }
+  return cpus;
+}
+#endif
+
+}  // namespace
+
+void
+rclcpp::apply_thread_attributes(const ThreadAttributes & attributes)
+{
+#ifdef __linux__
+  std::set<size_t> cpus(attributes.cpu_affinity.begin(), attributes.cpu_affinity.end());
+  if (attributes.numa_node >= 0) {
+    const auto numa_cpus = get_numa_node_cpus(attributes.numa_node);
+    if (cpus.empty()) {
+      cpus = numa_cpus;
+    } else {
+      for (auto it = cpus.begin(); it != cpus.end(); ) {
+        it = numa_cpus.count(*it) ? std::next(it) : cpus.erase(it);
+      }
+    }
+    if (cpus.empty()) {
+      throw std::runtime_error(
+              "no CPU to pin the thread to on NUMA node " + std::to_string(attributes.numa_node));
+    }
+  }
+
+  if (!cpus.empty()) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (const size_t cpu : cpus) {
+      if (cpu >= CPU_SETSIZE) {
+        throw std::runtime_error("invalid CPU index " + std::to_string(cpu));
+      }
+      CPU_SET(cpu, &cpu_set);
+    }
+    const int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    if (ret != 0) {
+      throw std::runtime_error(
+              std::string("failed to set the thread CPU affinity: ") + std::strerror(ret));
+    }
+  }
+
+  if (attributes.realtime_priority != 0) {
+    sched_param param;
+    param.sched_priority = attributes.realtime_priority;
+    const int ret = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (ret != 0) {
+      throw std::runtime_error(
+              std::string("failed to set the thread SCHED_FIFO priority: ") + std::strerror(ret));
+    }
+  }
+#else
+  if (!attributes.cpu_affinity.empty() ||
+    attributes.numa_node >= 0 ||
+    attributes.realtime_priority != 0)
+  {
+    throw std::runtime_error("thread attributes are not supported on this platform");
+  }
+#endif
+}
@@ -12,8 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -202,6 +207,127 @@ private:
   std::shared_ptr<const rosgraph_msgs::msg::Clock> last_msg_set_;
 };
 
+// Subscription to the clock topic shared by the time sources of the nodes of a context.
+class SharedClockSubscription final
+{
+public:
+  using ClockCallback = std::function<void (std::shared_ptr<const rosgraph_msgs::msg::Clock>)>;
+
+  explicit SharedClockSubscription(rclcpp::Context::SharedPtr context)
+  : context_(context)
+  {
+  }
+
+  ~SharedClockSubscription()
+  {
+    std::unique_ptr<Spinner> spinner;
+    {
+      std::lock_guard<std::mutex> guard(listeners_lock_);
+      spinner = std::move(spinner_);
+    }
+    stop(std::move(spinner));
+  }
+
+  // Add a callback called with each clock message, identified by its owner.
+  // It is also called with the last received message, if any.
+  void add_listener(const void * owner, ClockCallback callback)
+  {
+    std::lock_guard<std::mutex> guard(listeners_lock_);
+    if (!spinner_) {
+      spinner_ = start();
+    }
+    if (last_msg_) {
+      callback(last_msg_);
+    }
+    listeners_.emplace_back(owner, std::move(callback));
+  }
+
+  // Remove the callback of an owner, the subscription is destroyed with the last one.
+  void remove_listener(const void * owner)
+  {
+    std::unique_ptr<Spinner> spinner;
+    {
+      std::lock_guard<std::mutex> guard(listeners_lock_);
+      auto it = std::find_if(
+        listeners_.begin(), listeners_.end(),
+        [owner](const auto & listener) {return listener.first == owner;});
+      if (it != listeners_.end()) {
+        listeners_.erase(it);
+      }
+      if (listeners_.empty()) {
+        spinner = std::move(spinner_);
+        last_msg_.reset();
+      }
+    }
+    // Outside of the lock, as the clock callback may be waiting for it.
+    stop(std::move(spinner));
+  }
+
+private:
+  // Hidden node with the subscription, and the thread spinning it.
+  struct Spinner
+  {
+    rclcpp::Node::SharedPtr node;
+    rclcpp::Subscription<rosgraph_msgs::msg::Clock>::SharedPtr subscription;
+    rclcpp::executors::SingleThreadedExecutor::SharedPtr executor;
+    std::promise<void> cancel_promise;
+    std::thread thread;
+  };
+
+  std::unique_ptr<Spinner> start()
+  {
+    auto context = context_.lock();
+    if (!context) {
+      throw std::runtime_error("context of the shared clock subscription was destroyed");
+    }
+    auto spinner = std::make_unique<Spinner>();
+    rclcpp::NodeOptions options;
+    options.context(context)
+    .start_parameter_services(false)
+    .start_parameter_event_publisher(false)
+    // Its own time source mustn't subscribe to the clock, whatever the global overrides are.
+    .parameter_overrides({rclcpp::Parameter("use_sim_time", false)});
+    spinner->node = std::make_shared<rclcpp::Node>("_shared_clock_subscription", options);
+    spinner->subscription = spinner->node->create_subscription<rosgraph_msgs::msg::Clock>(
+      "/clock",
+      rclcpp::ClockQoS(),
+      [this](std::shared_ptr<const rosgraph_msgs::msg::Clock> msg) {
+        std::lock_guard<std::mutex> guard(listeners_lock_);
+        last_msg_ = msg;
+        for (const auto & listener : listeners_) {
+          listener.second(msg);
+        }
+      });
+    rclcpp::ExecutorOptions exec_options;
+    exec_options.context = context;
+    spinner->executor = std::make_shared<rclcpp::executors::SingleThreadedExecutor>(exec_options);
+    spinner->executor->add_node(spinner->node);
+    auto future = spinner->cancel_promise.get_future();
+    spinner->thread = std::thread(
+      [executor = spinner->executor, future = std::move(future)]() {
+        executor->spin_until_future_complete(future);
+      });
+    return spinner;
+  }
+
+  static void stop(std::unique_ptr<Spinner> spinner)
+  {
+    if (!spinner) {
+      return;
+    }
+    spinner->cancel_promise.set_value();
+    spinner->executor->cancel();
+    spinner->thread.join();
+  }
+
+  std::weak_ptr<rclcpp::Context> context_;
+
+  std::mutex listeners_lock_;
+  std::vector<std::pair<const void *, ClockCallback>> listeners_;
+  std::shared_ptr<const rosgraph_msgs::msg::Clock> last_msg_;
+  std::unique_ptr<Spinner> spinner_;
+};
+
 class TimeSource::NodeState final
 {
 public:
@@ -240,6 +366,18 @@ public:
     return clock_executor_thread_.joinable();
   }
 
+  // Check if the clock subscription shared by the nodes of the context is used
+  bool get_use_shared_clock_subscription()
+  {
+    return use_shared_clock_subscription_;
+  }
+
+  // Set whether the clock subscription shared by the nodes of the context is used
+  void set_use_shared_clock_subscription(bool use_shared_clock_subscription)
+  {
+    use_shared_clock_subscription_ = use_shared_clock_subscription;
+  }
+
   // Attach a node to this time source
   void attachNode(
     rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base_interface,
@@ -340,6 +478,10 @@ private:
   bool use_clock_thread_;
   std::thread clock_executor_thread_;
 
+  // Subscription of the context used instead of one of this node, if set.
+  bool use_shared_clock_subscription_{false};
+  std::shared_ptr<SharedClockSubscription> shared_clock_subscription_;
+
   // Preserve the node reference
   rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base_{nullptr};
   rclcpp::node_interfaces::NodeTopicsInterface::SharedPtr node_topics_{nullptr};
@@ -387,6 +529,23 @@ private:
       return;
     }
 
+    if (use_shared_clock_subscription_) {
+      if (shared_clock_subscription_) {
+        return;
+      }
+      shared_clock_subscription_ =
+        node_base_->get_context()->get_sub_context<SharedClockSubscription>(
+        node_base_->get_context());
+      shared_clock_subscription_->add_listener(
+        this,
+        [this](std::shared_ptr<const rosgraph_msgs::msg::Clock> msg) {
+          if (node_base_ != nullptr) {
+            clock_cb(msg);
+          }
+        });
+      return;
+    }
+
     rclcpp::SubscriptionOptions options;
     options.qos_overriding_options = rclcpp::QosOverridingOptions(
       {
@@ -438,6 +597,10 @@ private:
   void destroy_clock_sub()
   {
     std::lock_guard<std::mutex> guard(clock_sub_lock_);
+    if (shared_clock_subscription_) {
+      shared_clock_subscription_->remove_listener(this);
+      shared_clock_subscription_.reset();
+    }
     if (clock_executor_thread_.joinable()) {
       cancel_clock_executor_promise_.set_value();
       clock_executor_->cancel();
@@ -537,6 +700,8 @@ TimeSource::TimeSource(
 void TimeSource::attachNode(rclcpp::Node::SharedPtr node)
 {
   node_state_->set_use_clock_thread(node->get_node_options().use_clock_thread());
+  node_state_->set_use_shared_clock_subscription(
+    node->get_node_options().use_shared_clock_subscription());
   attachNode(
     node->get_node_base_interface(),
     node->get_node_topics_interface(),
@@ -568,10 +733,12 @@ void TimeSource::attachNode(
 
 void TimeSource::detachNode()
 {
+  const bool use_shared_clock_subscription = node_state_->get_use_shared_clock_subscription();
   node_state_.reset();
   node_state_ = std::make_shared<NodeState>(
     constructed_qos_,
     constructed_use_clock_thread_);
+  node_state_->set_use_shared_clock_subscription(use_shared_clock_subscription);
 }
 
 void TimeSource::attachClock(std::shared_ptr<rclcpp::Clock> clock)
@@ -599,6 +766,16 @@ bool TimeSource::clock_thread_is_joinable()
   return node_state_->clock_thread_is_joinable();
 }
 
+bool TimeSource::get_use_shared_clock_subscription()
+{
+  return node_state_->get_use_shared_clock_subscription();
+}
+
+void TimeSource::set_use_shared_clock_subscription(bool use_shared_clock_subscription)
+{
+  node_state_->set_use_shared_clock_subscription(use_shared_clock_subscription);
+}
+
 TimeSource::~TimeSource()
 {
 }
@@ -15,9 +15,11 @@
 #include "rclcpp/timer.hpp"
 
 #include <chrono>
+#include <stdexcept>
 #include <string>
 #include <memory>
 #include <thread>
+#include <utility>
 
 #include "rclcpp/contexts/default_context.hpp"
 #include "rclcpp/exceptions.hpp"
@@ -100,6 +102,79 @@ TimerBase::reset()
   if (ret != RCL_RET_OK) {
     rclcpp::exceptions::throw_from_rcl_error(ret, "Couldn't reset timer");
   }
+  std::lock_guard<std::mutex> lock(on_reset_callback_mutex_);
+  if (on_reset_callback_) {
+    on_reset_callback_();
+  }
+}
+
+void
+TimerBase::set_on_reset_callback(std::function<void()> callback)
+{
+  std::lock_guard<std::mutex> lock(on_reset_callback_mutex_);
+  on_reset_callback_ = std::move(callback);
+}
+
+void
+TimerBase::clear_on_reset_callback()
+{
+  std::lock_guard<std::mutex> lock(on_reset_callback_mutex_);
+  on_reset_callback_ = nullptr;
+}
+
+void
+TimerBase::set_missed_periods_policy(rclcpp::MissedPeriodsPolicy policy)
+{
+  missed_periods_policy_.store(policy);
+}
+
+rclcpp::MissedPeriodsPolicy
+TimerBase::get_missed_periods_policy() const
+{
+  return missed_periods_policy_.load();
+}
+
+size_t
+TimerBase::get_number_of_missed_periods() const
+{
+  return number_of_missed_periods_.load();
+}
+
+void
+TimerBase::set_slack(std::chrono::nanoseconds slack)
+{
+  if (slack < std::chrono::nanoseconds::zero()) {
+    throw std::invalid_argument("timer slack must not be negative");
+  }
+  slack_.store(slack.count());
+}
+
+std::chrono::nanoseconds
+TimerBase::get_slack() const
+{
+  return std::chrono::nanoseconds(slack_.load());
+}
+
+bool
+TimerBase::update_missed_periods()
+{
+  int64_t time_until_next_call = 0;
+  int64_t period = 0;
+  size_t missed_periods = 0;
+  if (rcl_timer_get_time_until_next_call(timer_handle_.get(), &time_until_next_call) ==
+    RCL_RET_OK &&
+    rcl_timer_get_period(timer_handle_.get(), &period) == RCL_RET_OK)
+  {
+    // The deadlines which passed after the one the timer is called for.
+    if (period > 0 && time_until_next_call < 0) {
+      missed_periods = static_cast<size_t>(-time_until_next_call / period);
+    }
+  } else {
+    // Canceled, which rcl_timer_call() reports.
+    rcl_reset_error();
+  }
+  number_of_missed_periods_.store(missed_periods);
+  return missed_periods > 0 && missed_periods_policy_.load() == MissedPeriodsPolicy::Skip;
 }
 
 bool
@@ -0,0 +1,169 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp/topic_statistics/publisher_topic_statistics.hpp"
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "libstatistics_collector/collector/generate_statistics_message.hpp"
+#include "libstatistics_collector/topic_statistics_collector/constants.hpp"
+
+#include "rclcpp/publisher.hpp"
+
+using rclcpp::topic_statistics::PublishMeasurement;
+using rclcpp::topic_statistics::PublisherTopicStatistics;
+
+namespace
+{
+
+constexpr const char kByteUnitName[]{"B"};
+constexpr const char kCountUnitName[]{"count"};
+
+int64_t
+get_current_nanoseconds_since_epoch()
+{
+  const auto now = std::chrono::system_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+}
+
+thread_local bool measuring_publish = false;
+
+}  // namespace
+
+PublisherTopicStatistics::PublisherTopicStatistics(
+  const std::string & node_name,
+  std::shared_ptr<StatisticsPublisher> publisher)
+: node_name_(node_name),
+  publisher_(std::move(publisher)),
+  window_start_(get_current_nanoseconds_since_epoch())
+{
+  if (nullptr == publisher_) {
+    throw std::invalid_argument("publisher pointer is nullptr");
+  }
+}
+
+PublisherTopicStatistics::~PublisherTopicStatistics()
+{
+  if (publisher_timer_) {
+    publisher_timer_->cancel();
+    publisher_timer_.reset();
+  }
+  publisher_.reset();
+}
+
+void
+PublisherTopicStatistics::handle_publish(
+  std::chrono::steady_clock::time_point start,
+  std::chrono::nanoseconds duration) noexcept
+{
+  const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    start.time_since_epoch()).count();
+  const int64_t last_time = last_publish_time_.exchange(now);
+  if (last_time != kNoPublishTime) {
+    const std::chrono::nanoseconds period{now - last_time};
+    publish_period_.add_sample(std::chrono::duration<double, std::milli>(period).count());
+  }
+  publish_duration_.add_sample(std::chrono::duration<double, std::milli>(duration).count());
+}
+
+void
+PublisherTopicStatistics::handle_intra_process_publish() noexcept
+{
+  intra_process_publish_.add_sample(1.);
+}
+
+void
+PublisherTopicStatistics::handle_inter_process_publish(size_t serialized_size) noexcept
+{
+  inter_process_publish_.add_sample(1.);
+  if (serialized_size > 0u) {
+    published_message_size_.add_sample(static_cast<double>(serialized_size));
+  }
+}
+
+void
+PublisherTopicStatistics::set_publisher_timer(rclcpp::TimerBase::SharedPtr publisher_timer)
+{
+  publisher_timer_ = std::move(publisher_timer);
+}
+
+void
+PublisherTopicStatistics::publish_message_and_reset_measurements()
+{
+  using libstatistics_collector::collector::GenerateStatisticMessage;
+  using libstatistics_collector::topic_statistics_collector::topic_statistics_constants::
+    kMillisecondUnitName;
+
+  const rclcpp::Time window_end{get_current_nanoseconds_since_epoch()};
+  const auto publish_period = publish_period_.take_statistics();
+  const auto publish_duration = publish_duration_.take_statistics();
+  const auto published_message_size = published_message_size_.take_statistics();
+  const auto intra_process_publish = intra_process_publish_.take_statistics();
+  const auto inter_process_publish = inter_process_publish_.take_statistics();
+
+  publisher_->publish(
+    GenerateStatisticMessage(
+      node_name_, kPublishPeriodStatName, kMillisecondUnitName, window_start_, window_end,
+      publish_period));
+  publisher_->publish(
+    GenerateStatisticMessage(
+      node_name_, kPublishDurationStatName, kMillisecondUnitName, window_start_, window_end,
+      publish_duration));
+  publisher_->publish(
+    GenerateStatisticMessage(
+      node_name_, kPublishedMessageSizeStatName, kByteUnitName, window_start_, window_end,
+      published_message_size));
+  publisher_->publish(
+    GenerateStatisticMessage(
+      node_name_, kIntraProcessPublishStatName, kCountUnitName, window_start_, window_end,
+      intra_process_publish));
+  publisher_->publish(
+    GenerateStatisticMessage(
+      node_name_, kInterProcessPublishStatName, kCountUnitName, window_start_, window_end,
+      inter_process_publish));
+  window_start_ = window_end;
+}
+
+std::vector<PublisherTopicStatistics::StatisticData>
+PublisherTopicStatistics::get_current_collector_data() const
+{
+  return {
+    publish_period_.get_statistics(),
+    publish_duration_.get_statistics(),
+    published_message_size_.get_statistics(),
+    intra_process_publish_.get_statistics(),
+    inter_process_publish_.get_statistics()};
+}
+
+bool
+PublishMeasurement::enter() noexcept
+{
+  if (measuring_publish) {
+    return false;
+  }
+  measuring_publish = true;
+  return true;
+}
+
+void
+PublishMeasurement::exit() noexcept
+{
+  measuring_publish = false;
+}
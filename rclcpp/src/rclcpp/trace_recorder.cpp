@@ -0,0 +1,263 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/trace_recorder.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rcutils/process.h"
+
+using rclcpp::trace_recorder::EventType;
+
+namespace
+{
+
+struct Event
+{
+  static constexpr size_t name_size = 47;
+
+  int64_t timestamp_ns;
+  const void * entity;
+  EventType type;
+  char name[name_size];
+};
+
+/// Events of a thread, only written by this thread.
+struct Ring
+{
+  Ring(size_t capacity, size_t thread_index)
+  : events(capacity), thread_index(thread_index)
+  {}
+
+  std::vector<Event> events;
+  /// Number of events recorded, the next one is written at its modulo
+  std::atomic<uint64_t> number_of_events{0u};
+  const size_t thread_index;
+};
+
+struct Recorder
+{
+  std::atomic<bool> enabled{false};
+  std::atomic<size_t> events_per_thread{1u << 16};
+  // Incremented by clear(), so that the threads create new rings
+  std::atomic<uint64_t> generation{0u};
+
+  std::mutex mutex;
+  std::vector<std::shared_ptr<Ring>> rings;
+  size_t next_thread_index = 0u;
+};
+
+Recorder &
+get_recorder()
+{
+  static Recorder recorder;
+  return recorder;
+}
+
+struct ThreadRing
+{
+  std::shared_ptr<Ring> ring;
+  uint64_t generation = std::numeric_limits<uint64_t>::max();
+};
+
+thread_local ThreadRing thread_ring;
+
+/// Return the ring of the calling thread, creating it if needed, or nullptr on failure.
+Ring *
+get_thread_ring() noexcept
+{
+  Recorder & recorder = get_recorder();
+  if (thread_ring.ring &&
+    thread_ring.generation == recorder.generation.load(std::memory_order_acquire))
+  {
+    return thread_ring.ring.get();
+  }
+  // Only allocates once per thread, until the next clear()
+  try {
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    auto ring = std::make_shared<Ring>(
+      recorder.events_per_thread.load(), recorder.next_thread_index++);
+    recorder.rings.push_back(ring);
+    thread_ring.ring = std::move(ring);
+    thread_ring.generation = recorder.generation.load();
+  } catch (...) {
+    return nullptr;
+  }
+  return thread_ring.ring.get();
+}
+
+void
+write_escaped(std::ostream & stream, const char * string)
+{
+  for (const char * c = string; *c != '\0'; ++c) {
+    if (*c == '"' || *c == '\\') {
+      stream << '\\' << *c;
+    } else if (static_cast<unsigned char>(*c) < 0x20) {
+      stream << ' ';
+    } else {
+      stream << *c;
+    }
+  }
+}
+
+void
+write_event(std::ostream & stream, const Event & event, size_t thread_index, int pid)
+{
+  const char * phase = "i";
+  const char * prefix = "";
+  const char * name = event.name;
+  switch (event.type) {
+    case EventType::Publish:
+      prefix = "publish ";
+      break;
+    case EventType::Take:
+      prefix = "take ";
+      break;
+    case EventType::CallbackStart:
+      phase = "B";
+      if (name[0] == '\0') {
+        name = "callback";
+      }
+      break;
+    case EventType::WaitStart:
+      phase = "B";
+      name = "wait";
+      break;
+    case EventType::CallbackEnd:
+    case EventType::WaitEnd:
+      phase = "E";
+      break;
+  }
+  char timestamp[32];
+  std::snprintf(
+    timestamp, sizeof(timestamp), "%" PRId64 ".%03" PRId64,
+    event.timestamp_ns / 1000, event.timestamp_ns % 1000);
+  char entity[32];
+  std::snprintf(entity, sizeof(entity), "%p", event.entity);
+
+  stream << "{\"name\":\"" << prefix;
+  write_escaped(stream, name);
+  stream << "\",\"cat\":\"rclcpp\",\"ph\":\"" << phase << "\",\"ts\":" << timestamp <<
+    ",\"pid\":" << pid << ",\"tid\":" << thread_index;
+  if (phase[0] == 'i') {
+    stream << ",\"s\":\"t\"";
+  }
+  stream << ",\"args\":{\"entity\":\"" << entity << "\"}}";
+}
+
+}  // namespace
+
+void
+rclcpp::trace_recorder::enable(size_t events_per_thread)
+{
+  if (events_per_thread == 0u) {
+    throw std::invalid_argument("the trace recorder needs to record at least one event");
+  }
+  Recorder & recorder = get_recorder();
+  recorder.events_per_thread.store(events_per_thread);
+  recorder.enabled.store(true);
+}
+
+void
+rclcpp::trace_recorder::disable()
+{
+  get_recorder().enabled.store(false);
+}
+
+bool
+rclcpp::trace_recorder::is_enabled() noexcept
+{
+  return get_recorder().enabled.load(std::memory_order_relaxed);
+}
+
+void
+rclcpp::trace_recorder::record(EventType type, const void * entity, const char * name) noexcept
+{
+  if (!is_enabled()) {
+    return;
+  }
+  Ring * ring = get_thread_ring();
+  if (!ring) {
+    return;
+  }
+  const uint64_t index = ring->number_of_events.load(std::memory_order_relaxed);
+  Event & event = ring->events[index % ring->events.size()];
+  event.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+  event.entity = entity;
+  event.type = type;
+  size_t length = 0u;
+  if (name) {
+    while (length < Event::name_size - 1u && name[length] != '\0') {
+      event.name[length] = name[length];
+      ++length;
+    }
+  }
+  event.name[length] = '\0';
+  ring->number_of_events.store(index + 1u, std::memory_order_release);
+}
+
+void
+rclcpp::trace_recorder::dump(const std::string & path)
+{
+  std::vector<std::shared_ptr<Ring>> rings;
+  {
+    Recorder & recorder = get_recorder();
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    rings = recorder.rings;
+  }
+
+  std::ofstream stream(path, std::ios::out | std::ios::trunc);
+  if (!stream) {
+    throw std::runtime_error("couldn't open the trace file '" + path + "'");
+  }
+  const int pid = rcutils_get_pid();
+  stream << "{\"traceEvents\":[";
+  bool first = true;
+  for (const auto & ring : rings) {
+    const uint64_t end = ring->number_of_events.load(std::memory_order_acquire);
+    const uint64_t size = ring->events.size();
+    // The oldest events were overwritten
+    for (uint64_t index = end - std::min(end, size); index < end; ++index) {
+      stream << (first ? "\n" : ",\n");
+      first = false;
+      write_event(stream, ring->events[index % size], ring->thread_index, pid);
+    }
+  }
+  stream << "\n],\"displayTimeUnit\":\"ns\"}\n";
+  if (!stream) {
+    throw std::runtime_error("couldn't write the trace file '" + path + "'");
+  }
+}
+
+void
+rclcpp::trace_recorder::clear()
+{
+  Recorder & recorder = get_recorder();
+  std::lock_guard<std::mutex> lock(recorder.mutex);
+  recorder.rings.clear();
+  recorder.next_thread_index = 0u;
+  recorder.generation.fetch_add(1u, std::memory_order_release);
+}
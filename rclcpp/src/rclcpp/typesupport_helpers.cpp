@@ -16,11 +16,14 @@
 #include "rclcpp/typesupport_helpers.hpp"
 
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
 
 #include "ament_index_cpp/get_package_prefix.hpp"
@@ -91,14 +94,45 @@ extract_type_identifier(const std::string & full_type)
   return std::make_tuple(package_name, middle_module, type_name);
 }
 
+/// A typesupport library loaded once for the process, with the handles found in it.
+struct CachedTypesupportLibrary
+{
+  std::shared_ptr<rcpputils::SharedLibrary> library;
+  std::unordered_map<std::string, const rosidl_message_type_support_t *> handles;
+};
+
+/// The loaded libraries, keyed by package name and typesupport identifier.
+using TypesupportLibraryCache =
+  std::map<std::pair<std::string, std::string>, CachedTypesupportLibrary>;
+
+std::mutex typesupport_library_cache_mutex;
+
+// Never destroyed, so that the libraries stay loaded for the static objects using them.
+TypesupportLibraryCache & get_typesupport_library_cache()
+{
+  static auto * cache = new TypesupportLibraryCache();
+  return *cache;
+}
+
 }  // anonymous namespace
 
 std::shared_ptr<rcpputils::SharedLibrary>
 get_typesupport_library(const std::string & type, const std::string & typesupport_identifier)
 {
   auto package_name = std::get<0>(extract_type_identifier(type));
+  auto key = std::make_pair(package_name, typesupport_identifier);
+
+  std::lock_guard<std::mutex> lock(typesupport_library_cache_mutex);
+  auto & cache = get_typesupport_library_cache();
+  auto cache_it = cache.find(key);
+  if (cache_it != cache.end()) {
+    return cache_it->second.library;
+  }
+  // Looking for the library and loading it is only done once, the failures aren't cached.
   auto library_path = get_typesupport_library_path(package_name, typesupport_identifier);
-  return std::make_shared<rcpputils::SharedLibrary>(library_path);
+  auto library = std::make_shared<rcpputils::SharedLibrary>(library_path);
+  cache.emplace(std::move(key), CachedTypesupportLibrary{library, {}});
+  return library;
 }
 
 const rosidl_message_type_support_t *
@@ -120,6 +154,20 @@ get_typesupport_handle(
       return rcutils_dynamic_loading_error.str();
     };
 
+  std::lock_guard<std::mutex> lock(typesupport_library_cache_mutex);
+  // The handles are only cached for the libraries of the cache, which are never unloaded.
+  std::unordered_map<std::string, const rosidl_message_type_support_t *> * cached_handles =
+    nullptr;
+  auto & cache = get_typesupport_library_cache();
+  auto cache_it = cache.find(std::make_pair(package_name, typesupport_identifier));
+  if (cache_it != cache.end() && cache_it->second.library.get() == &library) {
+    cached_handles = &cache_it->second.handles;
+    auto handle_it = cached_handles->find(type);
+    if (handle_it != cached_handles->end()) {
+      return handle_it->second;
+    }
+  }
+
   try {
     std::string symbol_name = typesupport_identifier + "__get_message_type_support_handle__" +
       package_name + "__" + (middle_module.empty() ? "msg" : middle_module) + "__" + type_name;
@@ -127,7 +175,11 @@ get_typesupport_handle(
     const rosidl_message_type_support_t * (* get_ts)() = nullptr;
     // This will throw runtime_error if the symbol was not found.
     get_ts = reinterpret_cast<decltype(get_ts)>(library.get_symbol(symbol_name));
-    return get_ts();
+    const rosidl_message_type_support_t * handle = get_ts();
+    if (cached_handles) {
+      cached_handles->emplace(type, handle);
+    }
+    return handle;
   } catch (std::runtime_error &) {
     throw std::runtime_error{mk_error("Library could not be found.")};
   }
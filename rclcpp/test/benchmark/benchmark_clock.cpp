@@ -0,0 +1,60 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+
+#include "rclcpp/rclcpp.hpp"
+
+using performance_test_fixture::PerformanceTest;
+
+BENCHMARK_F(PerformanceTest, clock_now_system_time)(benchmark::State & state)
+{
+  rclcpp::Clock clock(RCL_SYSTEM_TIME);
+
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    benchmark::DoNotOptimize(clock.now());
+  }
+}
+
+BENCHMARK_F(PerformanceTest, clock_now_ros_time)(benchmark::State & state)
+{
+  rclcpp::Clock clock(RCL_ROS_TIME);
+
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    benchmark::DoNotOptimize(clock.now());
+  }
+}
+
+BENCHMARK_F(PerformanceTest, clock_now_sim_time)(benchmark::State & state)
+{
+  rclcpp::Clock clock(RCL_ROS_TIME);
+  if (RCL_RET_OK != rcl_enable_ros_time_override(clock.get_clock_handle())) {
+    state.SkipWithError(rcl_get_error_string().str);
+    return;
+  }
+  if (RCL_RET_OK != rcl_set_ros_time_override(clock.get_clock_handle(), RCUTILS_S_TO_NS(42))) {
+    state.SkipWithError(rcl_get_error_string().str);
+    return;
+  }
+
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    benchmark::DoNotOptimize(clock.now());
+  }
+}
@@ -0,0 +1,177 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+
+#include "rclcpp/rclcpp.hpp"
+#include "test_msgs/msg/empty.hpp"
+#include "test_msgs/srv/empty.hpp"
+
+#include "./process_memory.hpp"
+
+using namespace std::chrono_literals;
+using performance_test_fixture::PerformanceTest;
+
+namespace
+{
+
+enum class EntityKind : int64_t
+{
+  Node = 0,
+  Publisher = 1,
+  Subscription = 2,
+  IntraProcessSubscription = 3,
+  StatisticsSubscription = 4,
+  Service = 5,
+  Client = 6,
+  Timer = 7,
+};
+
+}  // namespace
+
+/// Creation of N entities of a kind, reporting the memory used by each of them.
+/**
+ * The first benchmark argument is the kind of the entities, the second one their number.
+ * The entities are created in one node, except for the nodes themselves, and the
+ * subscriptions of the intra-process kind are created in a node using intra-process
+ * communication.
+ * Besides the time and the heap allocations counted by the fixture, the benchmark
+ * reports the heap bytes and the resident memory used by each entity.
+ * The heap bytes are measured with the allocator of glibc, and include the memory
+ * allocated by rcl and the middleware, while the resident memory also includes the
+ * memory mapped by the middleware, which is rounded up to whole pages.
+ */
+class EntityFootprintPerformanceTest : public PerformanceTest
+{
+public:
+  void SetUp(benchmark::State & state)
+  {
+    rclcpp::init(0, nullptr);
+    const auto kind = static_cast<EntityKind>(state.range(0));
+    node = std::make_shared<rclcpp::Node>(
+      "footprint_node", rclcpp::NodeOptions().use_intra_process_comms(
+        kind == EntityKind::IntraProcessSubscription));
+    // The first entity of a kind may initialize things shared by the other ones
+    create_entities(kind, 1u);
+    entities.clear();
+
+    PerformanceTest::SetUp(state);
+  }
+
+  void TearDown(benchmark::State & state)
+  {
+    PerformanceTest::TearDown(state);
+    entities.clear();
+    node.reset();
+    rclcpp::shutdown();
+  }
+
+protected:
+  void create_entities(EntityKind kind, size_t number_of_entities)
+  {
+    rclcpp::SubscriptionOptions statistics_options;
+    statistics_options.topic_stats_options.state = rclcpp::TopicStatisticsState::Enable;
+    auto callback = [](test_msgs::msg::Empty::ConstSharedPtr) {};
+
+    for (size_t i = 0u; i < number_of_entities; ++i) {
+      const std::string name = "entity_" + std::to_string(i);
+      switch (kind) {
+        case EntityKind::Node:
+          entities.push_back(std::make_shared<rclcpp::Node>(name));
+          break;
+        case EntityKind::Publisher:
+          entities.push_back(
+            node->create_publisher<test_msgs::msg::Empty>(name, rclcpp::QoS(10)));
+          break;
+        case EntityKind::Subscription:
+        case EntityKind::IntraProcessSubscription:
+          entities.push_back(
+            node->create_subscription<test_msgs::msg::Empty>(name, rclcpp::QoS(10), callback));
+          break;
+        case EntityKind::StatisticsSubscription:
+          statistics_options.topic_stats_options.publish_topic = name + "/statistics";
+          entities.push_back(
+            node->create_subscription<test_msgs::msg::Empty>(
+              name, rclcpp::QoS(10), callback, statistics_options));
+          break;
+        case EntityKind::Service:
+          entities.push_back(
+            node->create_service<test_msgs::srv::Empty>(
+              name,
+              [](
+                const test_msgs::srv::Empty::Request::SharedPtr,
+                test_msgs::srv::Empty::Response::SharedPtr) {}));
+          break;
+        case EntityKind::Client:
+          entities.push_back(node->create_client<test_msgs::srv::Empty>(name));
+          break;
+        case EntityKind::Timer:
+          entities.push_back(node->create_wall_timer(1s, []() {}));
+          break;
+      }
+    }
+  }
+
+  rclcpp::Node::SharedPtr node;
+  std::vector<std::shared_ptr<void>> entities;
+};
+
+static void footprint_arguments(benchmark::internal::Benchmark * benchmark)
+{
+  for (int64_t kind = 0; kind <= static_cast<int64_t>(EntityKind::Timer); ++kind) {
+    for (int64_t number_of_entities : {10, 100}) {
+      benchmark->Args({kind, number_of_entities});
+    }
+  }
+  benchmark->ArgNames({"kind", "entities"});
+}
+
+BENCHMARK_DEFINE_F(EntityFootprintPerformanceTest, create_entities)(benchmark::State & state)
+{
+  const auto kind = static_cast<EntityKind>(state.range(0));
+  const auto number_of_entities = static_cast<size_t>(state.range(1));
+  double heap_bytes = 0.;
+  double rss_kib = 0.;
+
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    state.PauseTiming();
+    const double heap_bytes_before = get_heap_bytes();
+    const double rss_kib_before = get_rss_kib();
+    state.ResumeTiming();
+
+    create_entities(kind, number_of_entities);
+
+    state.PauseTiming();
+    heap_bytes = get_heap_bytes() - heap_bytes_before;
+    // The pages freed by the previous iterations are reused, so the largest increase is kept
+    rss_kib = std::max(rss_kib, get_rss_kib() - rss_kib_before);
+    entities.clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+  state.counters["heap_bytes_per_entity"] = heap_bytes / static_cast<double>(number_of_entities);
+  state.counters["rss_kib_per_entity"] = rss_kib / static_cast<double>(number_of_entities);
+}
+BENCHMARK_REGISTER_F(EntityFootprintPerformanceTest, create_entities)
+  ->Apply(footprint_arguments)->UseRealTime();
@@ -0,0 +1,250 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+
+#include "rclcpp/rclcpp.hpp"
+#include "test_msgs/msg/empty.hpp"
+
+using namespace std::chrono_literals;
+using performance_test_fixture::PerformanceTest;
+
+namespace
+{
+
+enum class EntityKind : int64_t
+{
+  Timers = 0,
+  Subscriptions = 1,
+};
+
+enum class ExecutorKind : int64_t
+{
+  SingleThreaded = 0,
+  StaticSingleThreaded = 1,
+  Events = 2,
+  MultiThreaded = 3,
+  StaticMultiThreaded = 4,
+  WorkStealingMultiThreaded = 5,
+};
+
+rclcpp::Executor::SharedPtr
+make_executor(ExecutorKind kind, size_t number_of_threads)
+{
+  switch (kind) {
+    case ExecutorKind::SingleThreaded:
+      return std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+    case ExecutorKind::StaticSingleThreaded:
+      return std::make_shared<rclcpp::executors::StaticSingleThreadedExecutor>();
+    case ExecutorKind::Events:
+      return std::make_shared<rclcpp::executors::EventsExecutor>();
+    case ExecutorKind::MultiThreaded:
+      return std::make_shared<rclcpp::executors::MultiThreadedExecutor>(
+        rclcpp::ExecutorOptions(), number_of_threads);
+    case ExecutorKind::StaticMultiThreaded:
+      return std::make_shared<rclcpp::executors::StaticMultiThreadedExecutor>(
+        rclcpp::ExecutorOptions(), number_of_threads);
+    case ExecutorKind::WorkStealingMultiThreaded:
+      return std::make_shared<rclcpp::executors::WorkStealingMultiThreadedExecutor>(
+        rclcpp::ExecutorOptions(), number_of_threads);
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+/// A node with N timers or subscriptions, a fraction of which are ready at each iteration.
+/**
+ * The ready timers have a period of 0, so that they're always ready, while the other
+ * ones never expire during the benchmark.
+ * The ready subscriptions share a topic, a message is published on it before each
+ * iteration, while the other subscriptions are on a topic nothing is published on.
+ * The entities are in a reentrant callback group, so that the threads of the
+ * multi-threaded executors only contend on the executor itself.
+ */
+class ExecutorScalingPerformanceTest : public PerformanceTest
+{
+public:
+  void SetUp(benchmark::State & state)
+  {
+    rclcpp::init(0, nullptr);
+    node = std::make_shared<rclcpp::Node>("executor_scaling_node");
+    callback_group = node->create_callback_group(
+      rclcpp::CallbackGroupType::Reentrant, false);
+
+    const auto kind = static_cast<EntityKind>(state.range(0));
+    const auto number_of_entities = static_cast<size_t>(state.range(1));
+    number_of_ready_entities = number_of_entities * static_cast<size_t>(state.range(2)) / 100u;
+    callback_count = 0u;
+
+    rclcpp::SubscriptionOptions subscription_options;
+    subscription_options.callback_group = callback_group;
+    for (size_t i = 0u; i < number_of_entities; ++i) {
+      const bool ready = i < number_of_ready_entities;
+      if (EntityKind::Timers == kind) {
+        timers.push_back(
+          node->create_wall_timer(
+            ready ? 0ns : std::chrono::nanoseconds(24h),
+            [this]() {callback_count++;}, callback_group));
+      } else {
+        subscriptions.push_back(
+          node->create_subscription<test_msgs::msg::Empty>(
+            ready ? "ready_topic" : "idle_topic", rclcpp::QoS(1),
+            [this](test_msgs::msg::Empty::ConstSharedPtr) {callback_count++;},
+            subscription_options));
+      }
+    }
+    if (EntityKind::Subscriptions == kind) {
+      publisher = node->create_publisher<test_msgs::msg::Empty>("ready_topic", rclcpp::QoS(1));
+    }
+
+    PerformanceTest::SetUp(state);
+  }
+
+  void TearDown(benchmark::State & state)
+  {
+    PerformanceTest::TearDown(state);
+    publisher.reset();
+    subscriptions.clear();
+    timers.clear();
+    callback_group.reset();
+    node.reset();
+    rclcpp::shutdown();
+  }
+
+protected:
+  /// Publish on the topic of the ready subscriptions, if there are some.
+  void make_subscriptions_ready()
+  {
+    if (publisher) {
+      publisher->publish(test_msgs::msg::Empty());
+    }
+  }
+
+  /// Report the rate of the callbacks over the iterations, and skip if there were none.
+  void report_callbacks(benchmark::State & state, uint64_t number_of_callbacks)
+  {
+    state.counters["callbacks_per_second"] = benchmark::Counter(
+      static_cast<double>(number_of_callbacks), benchmark::Counter::kIsRate);
+    if (number_of_ready_entities > 0u && number_of_callbacks == 0u) {
+      state.SkipWithError("no callback was executed");
+    }
+  }
+
+  rclcpp::Node::SharedPtr node;
+  rclcpp::CallbackGroup::SharedPtr callback_group;
+  std::vector<rclcpp::TimerBase::SharedPtr> timers;
+  std::vector<rclcpp::Subscription<test_msgs::msg::Empty>::SharedPtr> subscriptions;
+  rclcpp::Publisher<test_msgs::msg::Empty>::SharedPtr publisher;
+  size_t number_of_ready_entities = 0u;
+  std::atomic<uint64_t> callback_count{0u};
+};
+
+static void spin_some_arguments(benchmark::internal::Benchmark * benchmark)
+{
+  for (int64_t executor_kind : {0, 1, 2}) {
+    for (int64_t ready_percent : {0, 10, 100}) {
+      for (int64_t entities : {10, 100, 1000, 10000}) {
+        benchmark->Args({0, entities, ready_percent, executor_kind});
+      }
+      // Each subscription creates middleware entities, so there are less of them.
+      for (int64_t entities : {10, 100, 1000}) {
+        benchmark->Args({1, entities, ready_percent, executor_kind});
+      }
+    }
+  }
+  benchmark->ArgNames({"subscriptions", "entities", "ready_percent", "executor"});
+}
+
+/// One spin_some() of a single-threaded executor, which is its overhead when nothing is ready.
+BENCHMARK_DEFINE_F(ExecutorScalingPerformanceTest, spin_some)(benchmark::State & state)
+{
+  auto executor = make_executor(static_cast<ExecutorKind>(state.range(3)), 1u);
+  executor->add_callback_group(callback_group, node->get_node_base_interface());
+  // Collect the entities once, as the static executors then reuse them
+  make_subscriptions_ready();
+  executor->spin_some(100ms);
+
+  const uint64_t initial_callback_count = callback_count.load();
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    state.PauseTiming();
+    make_subscriptions_ready();
+    state.ResumeTiming();
+
+    executor->spin_some(100ms);
+  }
+  report_callbacks(state, callback_count.load() - initial_callback_count);
+}
+BENCHMARK_REGISTER_F(ExecutorScalingPerformanceTest, spin_some)
+  ->Apply(spin_some_arguments)->UseRealTime();
+
+static void spin_threads_arguments(benchmark::internal::Benchmark * benchmark)
+{
+  for (int64_t executor_kind : {3, 4, 5}) {
+    for (int64_t threads : {2, 4, 8}) {
+      for (int64_t entities : {10, 100, 1000, 10000}) {
+        for (int64_t ready_percent : {10, 100}) {
+          benchmark->Args({0, entities, ready_percent, executor_kind, threads});
+        }
+      }
+    }
+  }
+  benchmark->ArgNames({"subscriptions", "entities", "ready_percent", "executor", "threads"});
+}
+
+/// Time for a multi-threaded executor spinning with N threads to execute 1000 callbacks.
+/**
+ * The ready timers stay ready, so the threads never run out of work, and the time is
+ * spent in the callbacks, collecting the entities and waiting for the executor's lock.
+ */
+BENCHMARK_DEFINE_F(ExecutorScalingPerformanceTest, spin_threads)(benchmark::State & state)
+{
+  constexpr uint64_t callbacks_per_iteration = 1000u;
+  auto executor = make_executor(
+    static_cast<ExecutorKind>(state.range(3)), static_cast<size_t>(state.range(4)));
+  executor->add_callback_group(callback_group, node->get_node_base_interface());
+  std::thread spinner([&executor]() {executor->spin();});
+
+  const uint64_t initial_callback_count = callback_count.load();
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    const uint64_t target = callback_count.load() + callbacks_per_iteration;
+    const auto start = std::chrono::steady_clock::now();
+    while (callback_count.load() < target) {
+      if (std::chrono::steady_clock::now() - start > 10s) {
+        state.SkipWithError("the callbacks weren't executed");
+        break;
+      }
+      std::this_thread::yield();
+    }
+  }
+  executor->cancel();
+  spinner.join();
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(callbacks_per_iteration));
+  report_callbacks(state, callback_count.load() - initial_callback_count);
+}
+BENCHMARK_REGISTER_F(ExecutorScalingPerformanceTest, spin_threads)
+  ->Apply(spin_threads_arguments)->UseRealTime();
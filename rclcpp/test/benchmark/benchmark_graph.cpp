@@ -0,0 +1,290 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "test_msgs/msg/empty.hpp"
+#include "test_msgs/srv/empty.hpp"
+
+using performance_test_fixture::PerformanceTest;
+using namespace std::chrono_literals;
+
+constexpr std::chrono::seconds discovery_timeout = 10s;
+
+/// N nodes with M publishers each, on M topics shared by the nodes.
+/**
+ * The first benchmark argument is the number of nodes, the second one the number
+ * of publishers of each node.
+ * The graph is queried by another node, which caches the graph queries or not.
+ */
+class GraphPerformanceTest : public PerformanceTest
+{
+public:
+  void SetUp(benchmark::State & state)
+  {
+    rclcpp::init(0, nullptr);
+    const auto number_of_nodes = static_cast<size_t>(state.range(0));
+    const auto number_of_topics = static_cast<size_t>(state.range(1));
+    for (size_t i = 0; i < number_of_nodes; ++i) {
+      auto node = std::make_shared<rclcpp::Node>("node_" + std::to_string(i), "ns");
+      for (size_t j = 0; j < number_of_topics; ++j) {
+        publishers.push_back(
+          node->create_publisher<test_msgs::msg::Empty>(topic_name(j), 10));
+      }
+      nodes.push_back(node);
+    }
+    query_node = std::make_shared<rclcpp::Node>(
+      "query_node", "ns", rclcpp::NodeOptions().cache_graph_queries(cache_graph_queries()));
+
+    // Wait for the last endpoint to be discovered, so all the benchmarks see the same graph.
+    if (!wait_for_graph(
+        [this, number_of_nodes, number_of_topics]() {
+          return number_of_topics == 0 ||
+          query_node->count_publishers(topic_name(number_of_topics - 1)) == number_of_nodes;
+        }))
+    {
+      state.SkipWithError("the endpoints weren't discovered");
+    }
+
+    performance_test_fixture::PerformanceTest::SetUp(state);
+  }
+
+  void TearDown(benchmark::State & state)
+  {
+    performance_test_fixture::PerformanceTest::TearDown(state);
+    query_node.reset();
+    publishers.clear();
+    nodes.clear();
+    rclcpp::shutdown();
+  }
+
+protected:
+  virtual bool cache_graph_queries() const {return false;}
+
+  static std::string topic_name(size_t index)
+  {
+    return "topic_" + std::to_string(index);
+  }
+
+  /// Wait for a graph change until the predicate is true, returning false on timeout.
+  template<typename PredicateT>
+  bool wait_for_graph(PredicateT && predicate)
+  {
+    const auto end = std::chrono::steady_clock::now() + discovery_timeout;
+    auto event = query_node->get_graph_event();
+    while (!predicate()) {
+      if (std::chrono::steady_clock::now() >= end) {
+        return false;
+      }
+      query_node->wait_for_graph_change(event, 10ms);
+      event->check_and_clear();
+    }
+    return true;
+  }
+
+  std::vector<rclcpp::Node::SharedPtr> nodes;
+  std::vector<rclcpp::PublisherBase::SharedPtr> publishers;
+  rclcpp::Node::SharedPtr query_node;
+};
+
+class CachedGraphPerformanceTest : public GraphPerformanceTest
+{
+protected:
+  bool cache_graph_queries() const override {return true;}
+};
+
+static void graph_sizes(benchmark::internal::Benchmark * benchmark)
+{
+  for (int64_t number_of_nodes : {1, 10, 50}) {
+    for (int64_t number_of_topics : {1, 10, 50}) {
+      benchmark->Args({number_of_nodes, number_of_topics});
+    }
+  }
+  benchmark->ArgNames({"nodes", "topics"});
+}
+
+BENCHMARK_DEFINE_F(GraphPerformanceTest, get_topic_names_and_types)(benchmark::State & state)
+{
+  // Prime cache
+  (void)query_node->get_topic_names_and_types();
+
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    auto topic_names_and_types = query_node->get_topic_names_and_types();
+    benchmark::DoNotOptimize(topic_names_and_types);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK_REGISTER_F(GraphPerformanceTest, get_topic_names_and_types)->Apply(graph_sizes);
+
+BENCHMARK_DEFINE_F(CachedGraphPerformanceTest, get_topic_names_and_types)(
+  benchmark::State & state)
+{
+  // Prime cache
+  (void)query_node->get_topic_names_and_types();
+
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    auto topic_names_and_types = query_node->get_topic_names_and_types();
+    benchmark::DoNotOptimize(topic_names_and_types);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK_REGISTER_F(CachedGraphPerformanceTest, get_topic_names_and_types)->Apply(graph_sizes);
+
+BENCHMARK_DEFINE_F(GraphPerformanceTest, get_node_names)(benchmark::State & state)
+{
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    auto node_names = query_node->get_node_names();
+    benchmark::DoNotOptimize(node_names);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK_REGISTER_F(GraphPerformanceTest, get_node_names)->Apply(graph_sizes);
+
+BENCHMARK_DEFINE_F(CachedGraphPerformanceTest, get_node_names)(benchmark::State & state)
+{
+  // Prime cache
+  (void)query_node->get_node_names();
+
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    auto node_names = query_node->get_node_names();
+    benchmark::DoNotOptimize(node_names);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK_REGISTER_F(CachedGraphPerformanceTest, get_node_names)->Apply(graph_sizes);
+
+BENCHMARK_DEFINE_F(GraphPerformanceTest, count_publishers)(benchmark::State & state)
+{
+  const std::string topic = topic_name(0);
+
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    size_t count = query_node->count_publishers(topic);
+    benchmark::DoNotOptimize(count);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK_REGISTER_F(GraphPerformanceTest, count_publishers)->Apply(graph_sizes);
+
+BENCHMARK_DEFINE_F(GraphPerformanceTest, get_publishers_info_by_topic)(benchmark::State & state)
+{
+  const std::string topic = topic_name(0);
+
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    auto publishers_info = query_node->get_publishers_info_by_topic(topic);
+    benchmark::DoNotOptimize(publishers_info);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK_REGISTER_F(GraphPerformanceTest, get_publishers_info_by_topic)->Apply(graph_sizes);
+
+BENCHMARK_DEFINE_F(GraphPerformanceTest, get_endpoints_info_by_topics)(benchmark::State & state)
+{
+  std::vector<std::string> topic_names;
+  for (int64_t i = 0; i < state.range(1); ++i) {
+    topic_names.push_back(topic_name(static_cast<size_t>(i)));
+  }
+  std::vector<rclcpp::TopicEndpointsInfo> endpoints_info;
+  // Prime the storage
+  query_node->get_node_graph_interface()->get_endpoints_info_by_topics(
+    topic_names, endpoints_info);
+
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    query_node->get_node_graph_interface()->get_endpoints_info_by_topics(
+      topic_names, endpoints_info);
+    benchmark::DoNotOptimize(endpoints_info);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK_REGISTER_F(GraphPerformanceTest, get_endpoints_info_by_topics)->Apply(graph_sizes);
+
+/// Time from the creation of a publisher to its discovery through a graph event.
+BENCHMARK_DEFINE_F(GraphPerformanceTest, graph_event_propagation)(benchmark::State & state)
+{
+  auto node = nodes.front();
+  const std::string topic = "propagation_topic";
+
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    auto publisher = node->create_publisher<test_msgs::msg::Empty>(topic, 10);
+    if (!wait_for_graph([this, &topic]() {return query_node->count_publishers(topic) == 1u;})) {
+      state.SkipWithError("the publisher wasn't discovered");
+      break;
+    }
+
+    state.PauseTiming();
+    publisher.reset();
+    if (!wait_for_graph([this, &topic]() {return query_node->count_publishers(topic) == 0u;})) {
+      state.SkipWithError("the publisher removal wasn't discovered");
+      break;
+    }
+    state.ResumeTiming();
+  }
+}
+BENCHMARK_REGISTER_F(GraphPerformanceTest, graph_event_propagation)
+  ->Apply(graph_sizes)->UseRealTime();
+
+/// Time for a new client to see a service which already exists.
+BENCHMARK_DEFINE_F(GraphPerformanceTest, wait_for_service)(benchmark::State & state)
+{
+  auto service = nodes.back()->create_service<test_msgs::srv::Empty>(
+    "empty_service",
+    [](
+      const test_msgs::srv::Empty::Request::SharedPtr,
+      test_msgs::srv::Empty::Response::SharedPtr) {});
+  // Wait for the service to be discovered, so only the client side is measured
+  auto outer_client = query_node->create_client<test_msgs::srv::Empty>("empty_service");
+  if (!outer_client->wait_for_service(discovery_timeout)) {
+    state.SkipWithError("the service wasn't discovered");
+    return;
+  }
+  outer_client.reset();
+
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    state.PauseTiming();
+    auto client = query_node->create_client<test_msgs::srv::Empty>("empty_service");
+    state.ResumeTiming();
+
+    if (!client->wait_for_service(discovery_timeout)) {
+      state.SkipWithError("the service wasn't available");
+      break;
+    }
+
+    state.PauseTiming();
+    client.reset();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK_REGISTER_F(GraphPerformanceTest, wait_for_service)->Apply(graph_sizes)->UseRealTime();
@@ -12,6 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "performance_test_fixture/performance_test_fixture.hpp"
 
 #include "rclcpp/rclcpp.hpp"
@@ -53,3 +58,47 @@ BENCHMARK_F(PerformanceTest, rclcpp_shutdown)(benchmark::State & state)
     benchmark::ClobberMemory();
   }
 }
+
+/// Shutdown and destruction of N nodes with their executor.
+/**
+ * The first argument is the number of nodes, the second one the number of threads
+ * calling the on shutdown callbacks, which include one for each executor.
+ */
+static void shutdown_sizes(benchmark::internal::Benchmark * benchmark)
+{
+  for (int64_t number_of_nodes : {1, 10, 100}) {
+    for (int64_t number_of_threads : {1, 4}) {
+      benchmark->Args({number_of_nodes, number_of_threads});
+    }
+  }
+  benchmark->ArgNames({"nodes", "threads"});
+}
+
+BENCHMARK_DEFINE_F(PerformanceTest, rclcpp_shutdown_nodes)(benchmark::State & state)
+{
+  const auto number_of_nodes = static_cast<size_t>(state.range(0));
+  rclcpp::InitOptions init_options;
+  init_options.shutdown_callback_threads(static_cast<size_t>(state.range(1)));
+  std::vector<rclcpp::Node::SharedPtr> nodes;
+  std::vector<std::shared_ptr<rclcpp::executors::SingleThreadedExecutor>> executors;
+
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    state.PauseTiming();
+    rclcpp::init(0, nullptr, init_options);
+    for (size_t i = 0; i < number_of_nodes; ++i) {
+      nodes.push_back(std::make_shared<rclcpp::Node>("node_" + std::to_string(i)));
+      executors.push_back(std::make_shared<rclcpp::executors::SingleThreadedExecutor>());
+      executors.back()->add_node(nodes.back());
+    }
+    state.ResumeTiming();
+
+    rclcpp::shutdown();
+    executors.clear();
+    nodes.clear();
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK_REGISTER_F(PerformanceTest, rclcpp_shutdown_nodes)
+  ->Apply(shutdown_sizes)->UseRealTime();
@@ -0,0 +1,225 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+
+#include "rclcpp/rclcpp.hpp"
+#include "test_msgs/msg/strings.hpp"
+
+using namespace std::chrono_literals;
+using performance_test_fixture::PerformanceTest;
+
+constexpr size_t kPayloadSize = 1024;
+
+namespace rclcpp
+{
+
+template<>
+struct TypeAdapter<std::string, test_msgs::msg::Strings>
+{
+  using is_specialized = std::true_type;
+  using custom_type = std::string;
+  using ros_message_type = test_msgs::msg::Strings;
+
+  static void
+  convert_to_ros_message(const custom_type & source, ros_message_type & destination)
+  {
+    destination.string_value = source;
+  }
+
+  static void
+  convert_to_custom(const ros_message_type & source, custom_type & destination)
+  {
+    destination = source.string_value;
+  }
+};
+
+}  // namespace rclcpp
+
+using AdaptedString = rclcpp::TypeAdapter<std::string, test_msgs::msg::Strings>;
+
+/*
+   Each iteration publishes one message and executes the subscriptions.
+   The time between the publication and each callback is recorded to report
+   the latency percentiles, in microseconds, next to the message rate.
+   The benchmarks take the number of subscriptions and the depth of the
+   intra-process buffers as arguments.
+ */
+class PerformanceTestIntraProcess : public PerformanceTest
+{
+public:
+  void SetUp(benchmark::State & st)
+  {
+    rclcpp::init(0, nullptr);
+    node = std::make_shared<rclcpp::Node>(
+      "intra_process_node", rclcpp::NodeOptions().use_intra_process_comms(true));
+    executor = std::make_unique<rclcpp::executors::SingleThreadedExecutor>();
+    executor->add_node(node);
+    latencies.clear();
+    latencies.reserve(1000000);
+
+    PerformanceTest::SetUp(st);
+  }
+
+  void TearDown(benchmark::State & st)
+  {
+    PerformanceTest::TearDown(st);
+    executor.reset();
+    node.reset();
+    rclcpp::shutdown();
+  }
+
+  void record_latency()
+  {
+    latencies.push_back(std::chrono::steady_clock::now() - publish_time);
+  }
+
+  template<typename MessageT, typename CallbackT>
+  std::vector<std::shared_ptr<rclcpp::SubscriptionBase>>
+  create_subscriptions(size_t count, size_t depth, CallbackT callback)
+  {
+    std::vector<std::shared_ptr<rclcpp::SubscriptionBase>> subscriptions;
+    for (size_t i = 0; i < count; ++i) {
+      subscriptions.push_back(
+        node->create_subscription<MessageT>("intra_process_topic", depth, callback));
+    }
+    return subscriptions;
+  }
+
+  template<typename PublishFunctionT>
+  void run(benchmark::State & st, PublishFunctionT publish)
+  {
+    // Warm up the buffers and the executor.
+    publish_time = std::chrono::steady_clock::now();
+    publish();
+    executor->spin_some();
+    latencies.clear();
+    reset_heap_counters();
+
+    for (auto _ : st) {
+      (void)_;
+      publish_time = std::chrono::steady_clock::now();
+      publish();
+      executor->spin_some();
+    }
+
+    if (latencies.empty()) {
+      st.SkipWithError("No message was received");
+      return;
+    }
+    st.SetItemsProcessed(static_cast<int64_t>(latencies.size()));
+    std::sort(latencies.begin(), latencies.end());
+    for (const auto & percentile : {50, 90, 99}) {
+      const auto index = (latencies.size() - 1) * percentile / 100;
+      st.counters["p" + std::to_string(percentile) + "_us"] =
+        std::chrono::duration<double, std::micro>(latencies[index]).count();
+    }
+  }
+
+  rclcpp::Node::SharedPtr node;
+  std::unique_ptr<rclcpp::executors::SingleThreadedExecutor> executor;
+  std::chrono::steady_clock::time_point publish_time;
+  std::vector<std::chrono::steady_clock::duration> latencies;
+};
+
+BENCHMARK_DEFINE_F(
+  PerformanceTestIntraProcess, publish_unique_ptr_take_unique_ptr)(benchmark::State & st)
+{
+  auto subscriptions = create_subscriptions<test_msgs::msg::Strings>(
+    st.range(0), st.range(1),
+    [this](std::unique_ptr<test_msgs::msg::Strings>) {record_latency();});
+  auto publisher = node->create_publisher<test_msgs::msg::Strings>(
+    "intra_process_topic", st.range(1));
+  const std::string payload(kPayloadSize, 'a');
+
+  run(
+    st, [&]() {
+      auto msg = std::make_unique<test_msgs::msg::Strings>();
+      msg->string_value = payload;
+      publisher->publish(std::move(msg));
+    });
+}
+BENCHMARK_REGISTER_F(PerformanceTestIntraProcess, publish_unique_ptr_take_unique_ptr)
+->ArgsProduct({{1, 2, 8}, {1, 10, 100}});
+
+BENCHMARK_DEFINE_F(
+  PerformanceTestIntraProcess, publish_unique_ptr_take_shared_ptr)(benchmark::State & st)
+{
+  auto subscriptions = create_subscriptions<test_msgs::msg::Strings>(
+    st.range(0), st.range(1),
+    [this](test_msgs::msg::Strings::ConstSharedPtr) {record_latency();});
+  auto publisher = node->create_publisher<test_msgs::msg::Strings>(
+    "intra_process_topic", st.range(1));
+  const std::string payload(kPayloadSize, 'a');
+
+  run(
+    st, [&]() {
+      auto msg = std::make_unique<test_msgs::msg::Strings>();
+      msg->string_value = payload;
+      publisher->publish(std::move(msg));
+    });
+}
+BENCHMARK_REGISTER_F(PerformanceTestIntraProcess, publish_unique_ptr_take_shared_ptr)
+->ArgsProduct({{1, 2, 8}, {1, 10, 100}});
+
+BENCHMARK_DEFINE_F(
+  PerformanceTestIntraProcess, publish_const_ref_take_shared_ptr)(benchmark::State & st)
+{
+  auto subscriptions = create_subscriptions<test_msgs::msg::Strings>(
+    st.range(0), st.range(1),
+    [this](test_msgs::msg::Strings::ConstSharedPtr) {record_latency();});
+  auto publisher = node->create_publisher<test_msgs::msg::Strings>(
+    "intra_process_topic", st.range(1));
+  test_msgs::msg::Strings msg;
+  msg.string_value = std::string(kPayloadSize, 'a');
+
+  run(st, [&]() {publisher->publish(msg);});
+}
+BENCHMARK_REGISTER_F(PerformanceTestIntraProcess, publish_const_ref_take_shared_ptr)
+->ArgsProduct({{1, 2, 8}, {1, 10, 100}});
+
+BENCHMARK_DEFINE_F(
+  PerformanceTestIntraProcess, publish_adapted_take_adapted)(benchmark::State & st)
+{
+  auto subscriptions = create_subscriptions<AdaptedString>(
+    st.range(0), st.range(1),
+    [this](std::shared_ptr<const std::string>) {record_latency();});
+  auto publisher = node->create_publisher<AdaptedString>("intra_process_topic", st.range(1));
+  const std::string payload(kPayloadSize, 'a');
+
+  run(st, [&]() {publisher->publish(std::make_unique<std::string>(payload));});
+}
+BENCHMARK_REGISTER_F(PerformanceTestIntraProcess, publish_adapted_take_adapted)
+->ArgsProduct({{1, 2, 8}, {10}});
+
+BENCHMARK_DEFINE_F(
+  PerformanceTestIntraProcess, publish_adapted_take_ros_message)(benchmark::State & st)
+{
+  auto subscriptions = create_subscriptions<test_msgs::msg::Strings>(
+    st.range(0), st.range(1),
+    [this](test_msgs::msg::Strings::ConstSharedPtr) {record_latency();});
+  auto publisher = node->create_publisher<AdaptedString>("intra_process_topic", st.range(1));
+  const std::string payload(kPayloadSize, 'a');
+
+  run(st, [&]() {publisher->publish(std::make_unique<std::string>(payload));});
+}
+BENCHMARK_REGISTER_F(PerformanceTestIntraProcess, publish_adapted_take_ros_message)
+->ArgsProduct({{1, 2, 8}, {10}});
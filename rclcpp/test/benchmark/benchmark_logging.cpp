@@ -0,0 +1,146 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <cinttypes>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "benchmark/benchmark.h"
+
+#include "rclcpp/rclcpp.hpp"
+
+/// Log calls of the benchmark thread while other threads log concurrently.
+/**
+ * The benchmark arguments are the number of contending threads, whether the node publishes
+ * its logs on rosout, and whether the logs are written asynchronously.
+ * The contending threads log as fast as they can, so the time of a log call includes the
+ * time waiting for the global logging mutex, and their throughput is reported as a counter.
+ * The console output is discarded while measuring, so that the terminal isn't measured.
+ */
+class LoggingPerformanceTest : public benchmark::Fixture
+{
+public:
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Woverloaded-virtual"
+#endif
+  void SetUp(benchmark::State & state)
+  {
+#ifndef _WIN32
+    stderr_fd = dup(STDERR_FILENO);
+    const int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd >= 0) {
+      dup2(null_fd, STDERR_FILENO);
+      close(null_fd);
+    }
+#endif
+    context = std::make_shared<rclcpp::Context>();
+    context->init(0, nullptr, rclcpp::InitOptions().asynchronous_logging(state.range(2) != 0));
+    node = std::make_shared<rclcpp::Node>(
+      "benchmark_logging",
+      rclcpp::NodeOptions().context(context).enable_rosout(state.range(1) != 0));
+
+    stop = false;
+    contending_logs = 0u;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      contending_threads.emplace_back(
+        [this]() {
+          const auto logger = node->get_logger();
+          uint64_t count = 0u;
+          while (!stop.load(std::memory_order_relaxed)) {
+            RCLCPP_INFO(logger, "contending message %" PRIu64, count);
+            ++count;
+            contending_logs.fetch_add(1u, std::memory_order_relaxed);
+          }
+        });
+    }
+  }
+
+  void TearDown(benchmark::State &)
+  {
+    stop = true;
+    for (auto & thread : contending_threads) {
+      thread.join();
+    }
+    contending_threads.clear();
+    node.reset();
+    context->shutdown("Benchmark is complete");
+    context.reset();
+#ifndef _WIN32
+    if (stderr_fd >= 0) {
+      dup2(stderr_fd, STDERR_FILENO);
+      close(stderr_fd);
+    }
+#endif
+  }
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+
+protected:
+  rclcpp::Context::SharedPtr context;
+  rclcpp::Node::SharedPtr node;
+  std::vector<std::thread> contending_threads;
+  std::atomic_bool stop{false};
+  std::atomic<uint64_t> contending_logs{0u};
+  int stderr_fd = -1;
+};
+
+static void logging_configurations(benchmark::internal::Benchmark * benchmark)
+{
+  for (int64_t contending_threads : {0, 1, 3, 7}) {
+    for (int64_t rosout : {0, 1}) {
+      for (int64_t asynchronous : {0, 1}) {
+        benchmark->Args({contending_threads, rosout, asynchronous});
+      }
+    }
+  }
+  benchmark->ArgNames({"contending_threads", "rosout", "async"});
+}
+
+BENCHMARK_DEFINE_F(LoggingPerformanceTest, log_info)(benchmark::State & state)
+{
+  const auto logger = node->get_logger();
+  const uint64_t contending_logs_start = contending_logs.load();
+  for (auto _ : state) {
+    (void)_;
+    RCLCPP_INFO(logger, "benchmark message %d", 42);
+  }
+  state.counters["contending_logs"] = benchmark::Counter(
+    static_cast<double>(contending_logs.load() - contending_logs_start),
+    benchmark::Counter::kIsRate);
+}
+BENCHMARK_REGISTER_F(LoggingPerformanceTest, log_info)
+  ->Apply(logging_configurations)->UseRealTime();
+
+/// Log calls below the level of the logger, which return before locking the logging mutex.
+BENCHMARK_DEFINE_F(LoggingPerformanceTest, log_debug_disabled)(benchmark::State & state)
+{
+  const auto logger = node->get_logger();
+  for (auto _ : state) {
+    (void)_;
+    RCLCPP_DEBUG(logger, "benchmark message %d", 42);
+  }
+}
+BENCHMARK_REGISTER_F(LoggingPerformanceTest, log_debug_disabled)
+  ->Args({0, 1, 0})->Args({3, 1, 0})->ArgNames({"contending_threads", "rosout", "async"})
+  ->UseRealTime();
@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "performance_test_fixture/performance_test_fixture.hpp"
 #include "rclcpp/rclcpp.hpp"
@@ -81,3 +82,55 @@ BENCHMARK_F(NodePerformanceTest, destroy_node)(benchmark::State & state)
     node.reset();
   }
 }
+
+/// Creation of a minimal node, without parameter services, parameter events and rosout.
+BENCHMARK_F(NodePerformanceTest, create_minimal_node)(benchmark::State & state)
+{
+  // Warmup and prime caches
+  auto outer_node = std::make_shared<rclcpp::Node>("node", rclcpp::NodeOptions::minimal());
+  outer_node.reset();
+
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    // Using pointer to separate construction and destruction in timing
+    auto node = std::make_shared<rclcpp::Node>("node", rclcpp::NodeOptions::minimal());
+#ifndef __clang_analyzer__
+    benchmark::DoNotOptimize(node);
+#endif
+    benchmark::ClobberMemory();
+
+    // Ensure destruction of node is not counted toward timing
+    state.PauseTiming();
+    node.reset();
+    state.ResumeTiming();
+  }
+}
+
+/// Creation of many helper nodes in one process, with the default or minimal options.
+/**
+ * The argument selects the options: 0 for the default ones, 1 for the minimal ones.
+ */
+BENCHMARK_DEFINE_F(NodePerformanceTest, create_many_nodes)(benchmark::State & state)
+{
+  constexpr size_t number_of_nodes = 150;
+  const rclcpp::NodeOptions options =
+    0 == state.range(0) ? rclcpp::NodeOptions() : rclcpp::NodeOptions::minimal();
+  std::vector<std::shared_ptr<rclcpp::Node>> nodes;
+  nodes.reserve(number_of_nodes);
+
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    for (size_t i = 0; i < number_of_nodes; ++i) {
+      nodes.push_back(std::make_shared<rclcpp::Node>("node_" + std::to_string(i), options));
+    }
+
+    state.PauseTiming();
+    nodes.clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(number_of_nodes));
+}
+BENCHMARK_REGISTER_F(NodePerformanceTest, create_many_nodes)
+  ->Arg(0)->Arg(1)->ArgName("minimal")->UseRealTime();
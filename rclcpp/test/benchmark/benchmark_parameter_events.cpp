@@ -0,0 +1,182 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+
+#include "rclcpp/rclcpp.hpp"
+#include "rcl_interfaces/msg/parameter_event.hpp"
+
+using namespace std::chrono_literals;
+using performance_test_fixture::PerformanceTest;
+
+constexpr std::chrono::seconds kEventsTimeout = 10s;
+
+/// N nodes with P parameters each, and H parameter event handlers on another node.
+/**
+ * The benchmark arguments are the number of nodes, of parameters per node and of
+ * handlers.
+ * Each handler has a callback for each parameter of each node, so that the lookup of
+ * the callbacks grows with the number of parameters, as in a system-wide monitor.
+ */
+class ParameterEventsPerformanceTest : public PerformanceTest
+{
+public:
+  void SetUp(benchmark::State & state)
+  {
+    rclcpp::init(0, nullptr);
+    const auto number_of_nodes = static_cast<size_t>(state.range(0));
+    number_of_parameters = static_cast<size_t>(state.range(1));
+    const auto number_of_handlers = static_cast<size_t>(state.range(2));
+
+    for (size_t node_index = 0u; node_index < number_of_nodes; ++node_index) {
+      auto node = std::make_shared<rclcpp::Node>("parameters_node_" + std::to_string(node_index));
+      for (size_t i = 0u; i < number_of_parameters; ++i) {
+        node->declare_parameter("parameter_" + std::to_string(i), int64_t{0});
+      }
+      nodes.push_back(node);
+    }
+
+    callback_count = 0u;
+    handler_node = std::make_shared<rclcpp::Node>(
+      "handler_node", rclcpp::NodeOptions().start_parameter_event_publisher(false));
+    for (size_t handler_index = 0u; handler_index < number_of_handlers; ++handler_index) {
+      auto handler = std::make_shared<rclcpp::ParameterEventHandler>(handler_node);
+      for (const auto & node : nodes) {
+        for (size_t i = 0u; i < number_of_parameters; ++i) {
+          callback_handles.push_back(
+            handler->add_parameter_callback(
+              "parameter_" + std::to_string(i),
+              [this](const rclcpp::Parameter &) {callback_count++;},
+              node->get_fully_qualified_name()));
+        }
+      }
+      handlers.push_back(handler);
+    }
+    executor = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+    executor->add_node(handler_node);
+
+    PerformanceTest::SetUp(state);
+  }
+
+  void TearDown(benchmark::State & state)
+  {
+    PerformanceTest::TearDown(state);
+    executor.reset();
+    callback_handles.clear();
+    handlers.clear();
+    handler_node.reset();
+    nodes.clear();
+    rclcpp::shutdown();
+  }
+
+protected:
+  /// Set the parameters of each node at once, with one event per node.
+  void set_parameters(int64_t value)
+  {
+    std::vector<rclcpp::Parameter> parameters;
+    for (size_t i = 0u; i < number_of_parameters; ++i) {
+      parameters.emplace_back("parameter_" + std::to_string(i), value);
+    }
+    for (const auto & node : nodes) {
+      node->set_parameters_atomically(parameters);
+    }
+  }
+
+  /// Spin until the handlers called back the given number of times, returning false on timeout.
+  bool wait_for_callbacks(uint64_t expected_callback_count)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    while (callback_count < expected_callback_count) {
+      if (std::chrono::steady_clock::now() - start > kEventsTimeout) {
+        return false;
+      }
+      executor->spin_some(10ms);
+    }
+    return true;
+  }
+
+  std::vector<rclcpp::Node::SharedPtr> nodes;
+  rclcpp::Node::SharedPtr handler_node;
+  std::vector<std::shared_ptr<rclcpp::ParameterEventHandler>> handlers;
+  std::vector<rclcpp::ParameterCallbackHandle::SharedPtr> callback_handles;
+  rclcpp::Executor::SharedPtr executor;
+  size_t number_of_parameters = 0u;
+  uint64_t callback_count = 0u;
+};
+
+static void parameter_events_arguments(benchmark::internal::Benchmark * benchmark)
+{
+  for (int64_t nodes : {1, 10}) {
+    for (int64_t parameters : {1, 10, 100}) {
+      for (int64_t handlers : {1, 10}) {
+        benchmark->Args({nodes, parameters, handlers});
+      }
+    }
+  }
+  benchmark->ArgNames({"nodes", "parameters", "handlers"});
+}
+
+/// Setting the parameters of each node, until each handler called back for each of them.
+/**
+ * This includes publishing the parameter events, taking them once per handler, and
+ * looking up and calling the callbacks of the handlers.
+ */
+BENCHMARK_DEFINE_F(ParameterEventsPerformanceTest, set_and_handle)(benchmark::State & state)
+{
+  int64_t value = 0;
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    const uint64_t expected_callback_count = callback_count + callback_handles.size();
+    set_parameters(++value);
+    if (!wait_for_callbacks(expected_callback_count)) {
+      state.SkipWithError("the parameter events weren't all handled");
+      break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_REGISTER_F(ParameterEventsPerformanceTest, set_and_handle)
+  ->Apply(parameter_events_arguments)->UseRealTime();
+
+/// Filtering a parameter event with P changed parameters, for half of them.
+static void filter_parameter_event(benchmark::State & state)
+{
+  const auto number_of_parameters = static_cast<size_t>(state.range(0));
+  auto event = std::make_shared<rcl_interfaces::msg::ParameterEvent>();
+  std::vector<std::string> names;
+  for (size_t i = 0u; i < number_of_parameters; ++i) {
+    const std::string name = "parameter_" + std::to_string(i);
+    event->changed_parameters.push_back(rclcpp::Parameter(name, int64_t{1}).to_parameter_msg());
+    if (i % 2u == 0u) {
+      names.push_back(name);
+    }
+  }
+
+  for (auto _ : state) {
+    (void)_;
+    rclcpp::ParameterEventsFilter filter(
+      event, names, {rclcpp::ParameterEventsFilter::EventType::CHANGED});
+    benchmark::DoNotOptimize(filter.get_events().size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(filter_parameter_event)->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->ArgName("parameters");
@@ -0,0 +1,265 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+
+#include "rclcpp/rclcpp.hpp"
+#include "test_msgs/msg/strings.hpp"
+
+using namespace std::chrono_literals;
+using performance_test_fixture::PerformanceTest;
+
+namespace rclcpp
+{
+
+template<>
+struct TypeAdapter<std::string, test_msgs::msg::Strings>
+{
+  using is_specialized = std::true_type;
+  using custom_type = std::string;
+  using ros_message_type = test_msgs::msg::Strings;
+
+  static void
+  convert_to_ros_message(const custom_type & source, ros_message_type & destination)
+  {
+    destination.string_value = source;
+  }
+
+  static void
+  convert_to_custom(const ros_message_type & source, custom_type & destination)
+  {
+    destination = source.string_value;
+  }
+};
+
+}  // namespace rclcpp
+
+using AdaptedString = rclcpp::TypeAdapter<std::string, test_msgs::msg::Strings>;
+
+constexpr char kTopicName[] = "publish_take_topic";
+
+/*
+   The publications and takes go through the middleware, without intra-process
+   communication. The benchmarks take the size of the payload of the messages
+   as argument, from 8 B to 8 MiB.
+   Each iteration handles one message, so the time of an iteration and the
+   heap counters of the fixture are per message.
+ */
+class PerformanceTestPublishTake : public PerformanceTest
+{
+public:
+  void SetUp(benchmark::State & st)
+  {
+    rclcpp::init(0, nullptr);
+    node = std::make_shared<rclcpp::Node>("publish_take_node");
+    payload = std::string(static_cast<size_t>(st.range(0)), 'a');
+    message.string_value = payload;
+
+    // The messages are only sent once a subscription is matched.
+    subscription = node->create_subscription<test_msgs::msg::Strings>(
+      kTopicName, rclcpp::QoS(1), [](test_msgs::msg::Strings::ConstSharedPtr) {});
+    publisher = node->create_publisher<test_msgs::msg::Strings>(kTopicName, rclcpp::QoS(1));
+    if (!wait_for_match(*publisher)) {
+      st.SkipWithError("the subscription wasn't matched");
+    }
+
+    PerformanceTest::SetUp(st);
+  }
+
+  void TearDown(benchmark::State & st)
+  {
+    PerformanceTest::TearDown(st);
+    publisher.reset();
+    subscription.reset();
+    node.reset();
+    rclcpp::shutdown();
+  }
+
+  bool wait_for_match(const rclcpp::PublisherBase & pub)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    while (pub.get_subscription_count() == 0u) {
+      if (std::chrono::steady_clock::now() - start > 10s) {
+        return false;
+      }
+      std::this_thread::sleep_for(10ms);
+    }
+    return true;
+  }
+
+  /// Publish the message and wait until the subscription can take it, without timing it.
+  bool publish_and_wait(benchmark::State & st, rclcpp::WaitSet & wait_set)
+  {
+    st.PauseTiming();
+    publisher->publish(message);
+    const bool ready = wait_set.wait(10s).kind() == rclcpp::WaitResultKind::Ready;
+    st.ResumeTiming();
+    if (!ready) {
+      st.SkipWithError("the message wasn't received");
+    }
+    return ready;
+  }
+
+  rclcpp::Node::SharedPtr node;
+  rclcpp::Subscription<test_msgs::msg::Strings>::SharedPtr subscription;
+  rclcpp::Publisher<test_msgs::msg::Strings>::SharedPtr publisher;
+  std::string payload;
+  test_msgs::msg::Strings message;
+};
+
+static void message_sizes(benchmark::internal::Benchmark * benchmark)
+{
+  benchmark->RangeMultiplier(8)->Range(8, 8 << 20)->ArgName("bytes");
+}
+
+BENCHMARK_DEFINE_F(PerformanceTestPublishTake, publish_const_ref)(benchmark::State & st)
+{
+  reset_heap_counters();
+  for (auto _ : st) {
+    (void)_;
+    publisher->publish(message);
+  }
+  st.SetBytesProcessed(st.iterations() * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTestPublishTake, publish_const_ref)->Apply(message_sizes);
+
+BENCHMARK_DEFINE_F(PerformanceTestPublishTake, publish_unique_ptr)(benchmark::State & st)
+{
+  reset_heap_counters();
+  for (auto _ : st) {
+    (void)_;
+    // Building the message is part of the cost of this overload.
+    auto unique_message = std::make_unique<test_msgs::msg::Strings>();
+    unique_message->string_value = payload;
+    publisher->publish(std::move(unique_message));
+  }
+  st.SetBytesProcessed(st.iterations() * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTestPublishTake, publish_unique_ptr)->Apply(message_sizes);
+
+BENCHMARK_DEFINE_F(PerformanceTestPublishTake, publish_loaned)(benchmark::State & st)
+{
+  reset_heap_counters();
+  for (auto _ : st) {
+    (void)_;
+    auto loaned_message = publisher->borrow_loaned_message();
+    loaned_message.get().string_value = payload;
+    publisher->publish(std::move(loaned_message));
+  }
+  st.SetBytesProcessed(st.iterations() * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTestPublishTake, publish_loaned)->Apply(message_sizes);
+
+BENCHMARK_DEFINE_F(PerformanceTestPublishTake, publish_serialized)(benchmark::State & st)
+{
+  rclcpp::SerializedMessage serialized_message;
+  rclcpp::Serialization<test_msgs::msg::Strings>().serialize_message(
+    &message, &serialized_message);
+
+  reset_heap_counters();
+  for (auto _ : st) {
+    (void)_;
+    publisher->publish(serialized_message);
+  }
+  st.SetBytesProcessed(st.iterations() * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTestPublishTake, publish_serialized)->Apply(message_sizes);
+
+BENCHMARK_DEFINE_F(PerformanceTestPublishTake, publish_type_adapted)(benchmark::State & st)
+{
+  auto adapted_publisher = node->create_publisher<AdaptedString>(kTopicName, rclcpp::QoS(1));
+  if (!wait_for_match(*adapted_publisher)) {
+    st.SkipWithError("the subscription wasn't matched");
+    return;
+  }
+
+  reset_heap_counters();
+  for (auto _ : st) {
+    (void)_;
+    adapted_publisher->publish(payload);
+  }
+  st.SetBytesProcessed(st.iterations() * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTestPublishTake, publish_type_adapted)->Apply(message_sizes);
+
+BENCHMARK_DEFINE_F(PerformanceTestPublishTake, take)(benchmark::State & st)
+{
+  rclcpp::WaitSet wait_set({{subscription}});
+  test_msgs::msg::Strings taken_message;
+  rclcpp::MessageInfo message_info;
+
+  reset_heap_counters();
+  for (auto _ : st) {
+    (void)_;
+    if (!publish_and_wait(st, wait_set)) {
+      break;
+    }
+    if (!subscription->take(taken_message, message_info)) {
+      st.SkipWithError("the message wasn't taken");
+      break;
+    }
+  }
+  st.SetBytesProcessed(st.iterations() * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTestPublishTake, take)->Apply(message_sizes);
+
+BENCHMARK_DEFINE_F(PerformanceTestPublishTake, take_serialized)(benchmark::State & st)
+{
+  rclcpp::WaitSet wait_set({{subscription}});
+  rclcpp::SerializedMessage serialized_message;
+  rclcpp::MessageInfo message_info;
+
+  reset_heap_counters();
+  for (auto _ : st) {
+    (void)_;
+    if (!publish_and_wait(st, wait_set)) {
+      break;
+    }
+    if (!subscription->take_serialized(serialized_message, message_info)) {
+      st.SkipWithError("the message wasn't taken");
+      break;
+    }
+  }
+  st.SetBytesProcessed(st.iterations() * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTestPublishTake, take_serialized)->Apply(message_sizes);
+
+BENCHMARK_DEFINE_F(PerformanceTestPublishTake, dispatch)(benchmark::State & st)
+{
+  size_t received_bytes = 0u;
+  auto dispatch_subscription = node->create_subscription<test_msgs::msg::Strings>(
+    "dispatch_topic", rclcpp::QoS(1),
+    [&received_bytes](const test_msgs::msg::Strings & msg) {
+      received_bytes += msg.string_value.size();
+    });
+  std::shared_ptr<void> type_erased_message =
+    std::make_shared<test_msgs::msg::Strings>(message);
+  rclcpp::MessageInfo message_info;
+
+  reset_heap_counters();
+  for (auto _ : st) {
+    (void)_;
+    dispatch_subscription->handle_message(type_erased_message, message_info);
+  }
+  benchmark::DoNotOptimize(received_bytes);
+  st.SetBytesProcessed(st.iterations() * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTestPublishTake, dispatch)->Apply(message_sizes);
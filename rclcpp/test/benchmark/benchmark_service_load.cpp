@@ -0,0 +1,248 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+
+#include "rclcpp/rclcpp.hpp"
+#include "test_msgs/srv/empty.hpp"
+
+#include "./executor_helpers.hpp"
+
+using namespace std::chrono_literals;
+using performance_test_fixture::PerformanceTest;
+
+namespace
+{
+
+constexpr char load_service_name[] = "load_service";
+constexpr size_t server_threads = 4u;
+
+}  // namespace
+
+/// A service spun by an executor in a thread, loaded by concurrent clients.
+/**
+ * Each client keeps a fixed number of requests in flight, sending a new one from the
+ * callback of each response, so that the server is never idle while the clients wait.
+ * The clients are spun by their own single-threaded executor, in another thread.
+ * The service is in a mutually exclusive or a reentrant callback group, and its callback
+ * busy waits for a given time, to tell the dispatch of the requests from their handling.
+ */
+class ServiceLoadPerformanceTest : public PerformanceTest
+{
+public:
+  void SetUp(benchmark::State & state)
+  {
+    rclcpp::init(0, nullptr);
+    server_node = std::make_shared<rclcpp::Node>("service_load_server");
+    client_node = std::make_shared<rclcpp::Node>("service_load_client");
+
+    const auto number_of_clients = static_cast<size_t>(state.range(0));
+    requests_in_flight = static_cast<size_t>(state.range(1));
+    const auto executor_kind = static_cast<ExecutorKind>(state.range(2));
+    const bool reentrant = state.range(3) != 0;
+    const auto work = std::chrono::microseconds(state.range(4));
+
+    callback_group = server_node->create_callback_group(
+      reentrant ? rclcpp::CallbackGroupType::Reentrant :
+      rclcpp::CallbackGroupType::MutuallyExclusive, false);
+    service = server_node->create_service<test_msgs::srv::Empty>(
+      load_service_name,
+      [work](
+        const test_msgs::srv::Empty::Request::SharedPtr,
+        test_msgs::srv::Empty::Response::SharedPtr)
+      {
+        const auto end = std::chrono::steady_clock::now() + work;
+        while (std::chrono::steady_clock::now() < end) {
+        }
+      },
+      rclcpp::ServicesQoS(), callback_group);
+
+    latencies_us.reserve(1u << 16);
+
+    for (size_t i = 0u; i < number_of_clients; ++i) {
+      clients.push_back(client_node->create_client<test_msgs::srv::Empty>(load_service_name));
+    }
+
+    server_executor = make_executor(executor_kind, server_threads);
+    server_executor->add_callback_group(callback_group, server_node->get_node_base_interface());
+    client_executor = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+    client_executor->add_node(client_node);
+    server_spinner = std::thread([this]() {server_executor->spin();});
+    client_spinner = std::thread([this]() {client_executor->spin();});
+
+    for (const auto & client : clients) {
+      if (!client->wait_for_service(5s)) {
+        state.SkipWithError("the service wasn't discovered");
+        break;
+      }
+    }
+
+    PerformanceTest::SetUp(state);
+  }
+
+  void TearDown(benchmark::State & state)
+  {
+    PerformanceTest::TearDown(state);
+    client_executor->cancel();
+    server_executor->cancel();
+    client_spinner.join();
+    server_spinner.join();
+    client_executor.reset();
+    server_executor.reset();
+    clients.clear();
+    service.reset();
+    callback_group.reset();
+    client_node.reset();
+    server_node.reset();
+    rclcpp::shutdown();
+  }
+
+protected:
+  /// Send a request from a client, and another one from the callback of its response.
+  void send_request(size_t client_index)
+  {
+    const auto sent = std::chrono::steady_clock::now();
+    outstanding_requests++;
+    clients[client_index]->async_send_request(
+      request,
+      [this, client_index, sent](rclcpp::Client<test_msgs::srv::Empty>::SharedFuture) {
+        const auto latency = std::chrono::steady_clock::now() - sent;
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          latencies_us.push_back(
+            std::chrono::duration<double, std::micro>(latency).count());
+        }
+        response_count++;
+        if (sending.load()) {
+          send_request(client_index);
+        }
+        outstanding_requests--;
+      });
+  }
+
+  /// Stop sending requests and wait for the responses of the ones in flight.
+  bool stop_sending()
+  {
+    sending = false;
+    const auto start = std::chrono::steady_clock::now();
+    while (outstanding_requests.load() > 0u) {
+      if (std::chrono::steady_clock::now() - start > 10s) {
+        return false;
+      }
+      std::this_thread::sleep_for(1ms);
+    }
+    return true;
+  }
+
+  /// Report the rate of the responses and the percentiles of their latency.
+  void report_responses(benchmark::State & state, uint64_t number_of_responses)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::sort(latencies_us.begin(), latencies_us.end());
+    state.counters["requests_per_second"] = benchmark::Counter(
+      static_cast<double>(number_of_responses), benchmark::Counter::kIsRate);
+    state.counters["latency_p50_us"] = get_percentile(latencies_us, 50.);
+    state.counters["latency_p90_us"] = get_percentile(latencies_us, 90.);
+    state.counters["latency_p99_us"] = get_percentile(latencies_us, 99.);
+    state.counters["latency_max_us"] = latencies_us.empty() ? 0. : latencies_us.back();
+  }
+
+  rclcpp::Node::SharedPtr server_node;
+  rclcpp::Node::SharedPtr client_node;
+  rclcpp::CallbackGroup::SharedPtr callback_group;
+  rclcpp::Service<test_msgs::srv::Empty>::SharedPtr service;
+  std::vector<rclcpp::Client<test_msgs::srv::Empty>::SharedPtr> clients;
+  rclcpp::Executor::SharedPtr server_executor;
+  rclcpp::Executor::SharedPtr client_executor;
+  std::thread server_spinner;
+  std::thread client_spinner;
+  const test_msgs::srv::Empty::Request::SharedPtr request =
+    std::make_shared<test_msgs::srv::Empty::Request>();
+  size_t requests_in_flight = 1u;
+  std::atomic<bool> sending{false};
+  std::atomic<uint64_t> response_count{0u};
+  std::atomic<size_t> outstanding_requests{0u};
+  std::mutex mutex;
+  std::vector<double> latencies_us;
+};
+
+static void concurrent_clients_arguments(benchmark::internal::Benchmark * benchmark)
+{
+  constexpr auto single_threaded = static_cast<int64_t>(ExecutorKind::SingleThreaded);
+  constexpr auto multi_threaded = static_cast<int64_t>(ExecutorKind::MultiThreaded);
+  constexpr auto events = static_cast<int64_t>(ExecutorKind::Events);
+  for (int64_t work_us : {0, 50}) {
+    for (int64_t clients : {1, 4, 16}) {
+      for (int64_t in_flight : {1, 8}) {
+        benchmark->Args({clients, in_flight, single_threaded, 0, work_us});
+        benchmark->Args({clients, in_flight, events, 0, work_us});
+        // The callback group only matters when several threads can execute the service.
+        benchmark->Args({clients, in_flight, multi_threaded, 0, work_us});
+        benchmark->Args({clients, in_flight, multi_threaded, 1, work_us});
+      }
+    }
+  }
+  benchmark->ArgNames({"clients", "in_flight", "executor", "reentrant", "work_us"});
+}
+
+/// Time for the clients, each keeping a number of requests in flight, to get 1000 responses.
+/**
+ * The responses of all the clients are counted, so a server whose throughput doesn't
+ * grow with the number of clients or of requests in flight shows up as a constant rate
+ * and a growing latency.
+ */
+BENCHMARK_DEFINE_F(ServiceLoadPerformanceTest, concurrent_clients)(benchmark::State & state)
+{
+  constexpr uint64_t responses_per_iteration = 1000u;
+
+  sending = true;
+  for (size_t i = 0u; i < clients.size(); ++i) {
+    for (size_t j = 0u; j < requests_in_flight; ++j) {
+      send_request(i);
+    }
+  }
+
+  const uint64_t initial_response_count = response_count.load();
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    const uint64_t target = response_count.load() + responses_per_iteration;
+    const auto start = std::chrono::steady_clock::now();
+    while (response_count.load() < target) {
+      if (std::chrono::steady_clock::now() - start > 10s) {
+        state.SkipWithError("the responses weren't received");
+        break;
+      }
+      std::this_thread::yield();
+    }
+  }
+  const uint64_t number_of_responses = response_count.load() - initial_response_count;
+  if (!stop_sending()) {
+    state.SkipWithError("the requests in flight weren't answered");
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(responses_per_iteration));
+  report_responses(state, number_of_responses);
+}
+BENCHMARK_REGISTER_F(ServiceLoadPerformanceTest, concurrent_clients)
+  ->Apply(concurrent_clients_arguments)->UseRealTime();
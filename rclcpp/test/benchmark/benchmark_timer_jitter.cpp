@@ -0,0 +1,180 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+
+#include "rclcpp/rclcpp.hpp"
+#include "test_msgs/msg/empty.hpp"
+
+#include "./executor_helpers.hpp"
+
+using namespace std::chrono_literals;
+using performance_test_fixture::PerformanceTest;
+
+/// A timer spun by an executor in a thread, with subscriptions receiving messages meanwhile.
+/**
+ * The first benchmark argument is the frequency of the timer in Hz, the second one the
+ * number of subscriptions of the background load, and the last one the executor:
+ * 0 for a SingleThreadedExecutor, 1 for a MultiThreadedExecutor with 2 threads and
+ * 2 for a StaticSingleThreadedExecutor.
+ * When there are subscriptions, a thread publishes messages to them as fast as it can,
+ * so that the executor has other callbacks to execute.
+ *
+ * The lateness of each call is measured by the timer itself: it's the time elapsed since
+ * the deadline the timer was called for, which is one period before the next one.
+ */
+class TimerJitterPerformanceTest : public PerformanceTest
+{
+public:
+  void SetUp(benchmark::State & state)
+  {
+    rclcpp::init(0, nullptr);
+    node = std::make_shared<rclcpp::Node>("timer_jitter_node");
+    period = std::chrono::nanoseconds(std::chrono::seconds(1)) / state.range(0);
+    const auto number_of_subscriptions = static_cast<size_t>(state.range(1));
+    for (size_t i = 0u; i < number_of_subscriptions; ++i) {
+      subscriptions.push_back(
+        node->create_subscription<test_msgs::msg::Empty>(
+          "load_topic", rclcpp::QoS(10), [](test_msgs::msg::Empty::ConstSharedPtr) {}));
+    }
+    if (number_of_subscriptions > 0u) {
+      publisher = node->create_publisher<test_msgs::msg::Empty>("load_topic", rclcpp::QoS(10));
+    }
+
+    lateness_us.clear();
+    number_of_calls = 0u;
+    number_of_missed_periods = 0u;
+    timer = node->create_wall_timer(
+      period, [this](rclcpp::TimerBase & called_timer) {
+        const auto lateness = period - called_timer.time_until_trigger();
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          lateness_us.push_back(static_cast<double>(lateness.count()) / 1000.);
+          number_of_missed_periods += called_timer.get_number_of_missed_periods();
+          ++number_of_calls;
+        }
+        called.notify_one();
+      });
+
+    PerformanceTest::SetUp(state);
+  }
+
+  void TearDown(benchmark::State & state)
+  {
+    PerformanceTest::TearDown(state);
+    timer.reset();
+    publisher.reset();
+    subscriptions.clear();
+    node.reset();
+    rclcpp::shutdown();
+  }
+
+protected:
+  /// Report the percentiles of the lateness of the calls, and the missed periods.
+  void report_lateness(benchmark::State & state)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::sort(lateness_us.begin(), lateness_us.end());
+    state.counters["lateness_p50_us"] = get_percentile(lateness_us, 50.);
+    state.counters["lateness_p90_us"] = get_percentile(lateness_us, 90.);
+    state.counters["lateness_p99_us"] = get_percentile(lateness_us, 99.);
+    state.counters["lateness_max_us"] = lateness_us.empty() ? 0. : lateness_us.back();
+    state.counters["missed_periods"] = static_cast<double>(number_of_missed_periods);
+    state.counters["missed_periods_per_call"] = number_of_calls == 0u ? 0. :
+      static_cast<double>(number_of_missed_periods) / static_cast<double>(number_of_calls);
+  }
+
+  rclcpp::Node::SharedPtr node;
+  std::vector<rclcpp::Subscription<test_msgs::msg::Empty>::SharedPtr> subscriptions;
+  rclcpp::Publisher<test_msgs::msg::Empty>::SharedPtr publisher;
+  rclcpp::TimerBase::SharedPtr timer;
+  std::chrono::nanoseconds period{0};
+
+  std::mutex mutex;
+  std::condition_variable called;
+  std::vector<double> lateness_us;
+  size_t number_of_calls = 0u;
+  size_t number_of_missed_periods = 0u;
+};
+
+static void timer_jitter_arguments(benchmark::internal::Benchmark * benchmark)
+{
+  for (int64_t executor_kind : {0, 1, 2}) {
+    for (int64_t frequency : {100, 1000, 10000}) {
+      for (int64_t subscriptions : {0, 10}) {
+        benchmark->Args({frequency, subscriptions, executor_kind});
+      }
+    }
+  }
+  benchmark->ArgNames({"frequency_hz", "subscriptions", "executor"});
+}
+
+/// The calls of the timer, one per iteration.
+BENCHMARK_DEFINE_F(TimerJitterPerformanceTest, timer_lateness)(benchmark::State & state)
+{
+  auto executor = make_executor(static_cast<ExecutorKind>(state.range(2)), 2u);
+  executor->add_node(node);
+  std::thread spinner([&executor]() {executor->spin();});
+
+  std::atomic<bool> publishing{publisher != nullptr};
+  std::thread load_publisher([this, &publishing]() {
+      while (publishing.load()) {
+        publisher->publish(test_msgs::msg::Empty());
+        std::this_thread::yield();
+      }
+    });
+
+  // The calls before the first iteration aren't reported
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    called.wait_for(lock, 1s, [this]() {return number_of_calls > 0u;});
+    lateness_us.clear();
+    number_of_calls = 0u;
+    number_of_missed_periods = 0u;
+  }
+
+  for (auto _ : state) {
+    (void)_;
+    std::unique_lock<std::mutex> lock(mutex);
+    const size_t previous_number_of_calls = number_of_calls;
+    if (!called.wait_for(
+        lock, 1s, [this, previous_number_of_calls]() {
+          return number_of_calls > previous_number_of_calls;
+        }))
+    {
+      state.SkipWithError("the timer wasn't called");
+      break;
+    }
+  }
+
+  publishing = false;
+  load_publisher.join();
+  executor->cancel();
+  spinner.join();
+  report_lateness(state);
+}
+BENCHMARK_REGISTER_F(TimerJitterPerformanceTest, timer_lateness)
+  ->Apply(timer_jitter_arguments)->UseRealTime()->MinTime(1.);
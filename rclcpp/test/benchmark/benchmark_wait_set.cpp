@@ -0,0 +1,232 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+
+#include "rclcpp/rclcpp.hpp"
+
+using namespace std::chrono_literals;
+using performance_test_fixture::PerformanceTest;
+
+namespace
+{
+
+enum class WaitSetKind : int64_t
+{
+  Dynamic = 0,
+  ThreadSafe = 1,
+  Static = 2,
+};
+
+template<size_t NumberOfTimers>
+using StaticTimersWaitSet = rclcpp::StaticWaitSet<0, 0, NumberOfTimers, 0, 0, 0>;
+
+template<size_t NumberOfTimers, typename FunctorT>
+void
+with_static_wait_set(const std::vector<rclcpp::TimerBase::SharedPtr> & timers, FunctorT && functor)
+{
+  std::array<rclcpp::TimerBase::SharedPtr, NumberOfTimers> timers_array;
+  for (size_t i = 0u; i < NumberOfTimers; ++i) {
+    timers_array[i] = timers[i];
+  }
+  StaticTimersWaitSet<NumberOfTimers> wait_set({}, {}, timers_array);
+  functor(wait_set);
+}
+
+/// Call a functor with a wait set of the given kind, holding the timers.
+/**
+ * The number of entities of the static storage being a template argument, it's only
+ * provided for the numbers of timers used by the benchmarks, and false is returned
+ * otherwise.
+ */
+template<typename FunctorT>
+bool
+with_wait_set(
+  WaitSetKind kind, const std::vector<rclcpp::TimerBase::SharedPtr> & timers,
+  FunctorT && functor)
+{
+  switch (kind) {
+    case WaitSetKind::Dynamic:
+      {
+        rclcpp::WaitSet wait_set({}, {}, timers);
+        functor(wait_set);
+        return true;
+      }
+    case WaitSetKind::ThreadSafe:
+      {
+        rclcpp::ThreadSafeWaitSet wait_set({}, {}, timers);
+        functor(wait_set);
+        return true;
+      }
+    case WaitSetKind::Static:
+      switch (timers.size()) {
+        case 10u:
+          with_static_wait_set<10u>(timers, functor);
+          return true;
+        case 100u:
+          with_static_wait_set<100u>(timers, functor);
+          return true;
+        case 1000u:
+          with_static_wait_set<1000u>(timers, functor);
+          return true;
+        default:
+          return false;
+      }
+  }
+  return false;
+}
+
+}  // namespace
+
+/// N timers, a fraction of which are ready, in wait sets of each policy.
+/**
+ * Timers are used as they need no middleware entity: the ready ones have a period of 0,
+ * so they stay ready, while the other ones never expire during the benchmark.
+ * The first benchmark argument is the number of timers, the second one the percentage
+ * of them which is ready, and the last one the kind of wait set: 0 for a WaitSet,
+ * 1 for a ThreadSafeWaitSet and 2 for a StaticWaitSet.
+ */
+class WaitSetPerformanceTest : public PerformanceTest
+{
+public:
+  void SetUp(benchmark::State & state)
+  {
+    rclcpp::init(0, nullptr);
+    const auto number_of_timers = static_cast<size_t>(state.range(0));
+    number_of_ready_timers = number_of_timers * static_cast<size_t>(state.range(1)) / 100u;
+    for (size_t i = 0u; i < number_of_timers; ++i) {
+      timers.push_back(
+        std::make_shared<rclcpp::WallTimer<rclcpp::VoidCallbackType>>(
+          i < number_of_ready_timers ? 0ns : std::chrono::nanoseconds(24h), []() {},
+          rclcpp::contexts::get_global_default_context()));
+    }
+
+    PerformanceTest::SetUp(state);
+  }
+
+  void TearDown(benchmark::State & state)
+  {
+    PerformanceTest::TearDown(state);
+    timers.clear();
+    rclcpp::shutdown();
+  }
+
+protected:
+  std::vector<rclcpp::TimerBase::SharedPtr> timers;
+  size_t number_of_ready_timers = 0u;
+};
+
+static void wait_set_arguments(benchmark::internal::Benchmark * benchmark)
+{
+  for (int64_t kind : {0, 1, 2}) {
+    for (int64_t timers : {10, 100, 1000}) {
+      for (int64_t ready_percent : {0, 10, 100}) {
+        benchmark->Args({timers, ready_percent, kind});
+      }
+    }
+  }
+  benchmark->ArgNames({"timers", "ready_percent", "kind"});
+}
+
+/// Removing and adding back each timer, which the static storage doesn't allow.
+BENCHMARK_DEFINE_F(WaitSetPerformanceTest, add_remove_timers)(benchmark::State & state)
+{
+  auto add_remove = [this, &state](auto & wait_set) {
+      reset_heap_counters();
+      for (auto _ : state) {
+        (void)_;
+        for (const auto & timer : timers) {
+          wait_set.remove_timer(timer);
+        }
+        for (const auto & timer : timers) {
+          wait_set.add_timer(timer);
+        }
+      }
+    };
+  if (static_cast<WaitSetKind>(state.range(2)) == WaitSetKind::Dynamic) {
+    rclcpp::WaitSet wait_set({}, {}, timers);
+    add_remove(wait_set);
+  } else {
+    rclcpp::ThreadSafeWaitSet wait_set({}, {}, timers);
+    add_remove(wait_set);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_REGISTER_F(WaitSetPerformanceTest, add_remove_timers)
+  ->ArgNames({"timers", "ready_percent", "kind"})
+  ->Args({10, 0, 0})->Args({100, 0, 0})->Args({1000, 0, 0})
+  ->Args({10, 0, 1})->Args({100, 0, 1})->Args({1000, 0, 1});
+
+/// A wait which doesn't block, without looking at the result.
+/**
+ * This is the cost of setting up the rcl wait set from the storage, and of rcl_wait()
+ * checking the timers.
+ */
+BENCHMARK_DEFINE_F(WaitSetPerformanceTest, wait)(benchmark::State & state)
+{
+  const bool supported = with_wait_set(
+    static_cast<WaitSetKind>(state.range(2)), timers,
+    [this, &state](auto & wait_set) {
+      reset_heap_counters();
+      for (auto _ : state) {
+        (void)_;
+        auto wait_result = wait_set.wait(0ns);
+        benchmark::DoNotOptimize(wait_result.kind());
+      }
+    });
+  if (!supported) {
+    state.SkipWithError("no static wait set for this number of timers");
+  }
+}
+BENCHMARK_REGISTER_F(WaitSetPerformanceTest, wait)->Apply(wait_set_arguments);
+
+/// A wait which doesn't block, followed by the iteration of its ready timers.
+BENCHMARK_DEFINE_F(WaitSetPerformanceTest, wait_and_iterate)(benchmark::State & state)
+{
+  size_t number_of_ready_entities = 0u;
+  const bool supported = with_wait_set(
+    static_cast<WaitSetKind>(state.range(2)), timers,
+    [this, &state, &number_of_ready_entities](auto & wait_set) {
+      reset_heap_counters();
+      for (auto _ : state) {
+        (void)_;
+        auto wait_result = wait_set.wait(0ns);
+        if (wait_result.kind() != rclcpp::WaitResultKind::Ready) {
+          continue;
+        }
+        for (const auto & timer : wait_result.get_ready_entities().timers) {
+          benchmark::DoNotOptimize(timer.get());
+          ++number_of_ready_entities;
+        }
+      }
+    });
+  if (!supported) {
+    state.SkipWithError("no static wait set for this number of timers");
+    return;
+  }
+  if (number_of_ready_entities !=
+    static_cast<size_t>(state.iterations()) * number_of_ready_timers)
+  {
+    state.SkipWithError("the ready timers weren't all returned");
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(number_of_ready_entities));
+}
+BENCHMARK_REGISTER_F(WaitSetPerformanceTest, wait_and_iterate)->Apply(wait_set_arguments);
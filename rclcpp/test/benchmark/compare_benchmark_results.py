@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+# Copyright 2022 Open Source Robotics Foundation, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Aggregate the results of the benchmarks and compare them with a baseline.
+
+The benchmarks of rclcpp, rclcpp_action, rclcpp_lifecycle and rclcpp_components are
+registered with ament_add_google_benchmark, directly or through add_performance_test,
+which writes the results of each target as google benchmark JSON in the test results
+directory, for example build/rclcpp/test_results/rclcpp/*.google_benchmark.json.
+
+The export command converts the results to a common schema, one entry per benchmark:
+
+    {"run": "ExecutorScalingPerformanceTest/spin_some/entities:10/real_time",
+     "name": "ExecutorScalingPerformanceTest/spin_some", "params": {"entities": "10"},
+     "ns_per_op": 1234.5, "allocations_per_op": 2.0, "repetitions": 1}
+
+where allocations_per_op is null for the benchmarks which don't count allocations.
+
+The compare command compares results with a baseline exported before, and exits
+with 1 if a benchmark is slower, or allocates more, than allowed by the thresholds:
+
+    compare_benchmark_results.py export build/*/test_results -o baseline.json
+    compare_benchmark_results.py compare baseline.json build/*/test_results
+"""
+
+import argparse
+import json
+import os
+import sys
+
+TIME_UNIT_TO_NS = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+
+# Counter of the performance_test_fixture, averaged over the iterations
+ALLOCATIONS_COUNTER = 'heap_allocations'
+
+
+def find_result_files(paths):
+    for path in paths:
+        if os.path.isfile(path):
+            yield path
+            continue
+        for directory, _, file_names in os.walk(path):
+            for file_name in sorted(file_names):
+                if file_name.endswith('.google_benchmark.json'):
+                    yield os.path.join(directory, file_name)
+
+
+def split_benchmark_name(run_name):
+    """Split the name of a run into the name of the benchmark and its arguments."""
+    name_parts = []
+    params = {}
+    for index, part in enumerate(run_name.split('/')):
+        if ':' in part:
+            key, value = part.split(':', 1)
+            params[key] = value
+        elif index >= 1 and part.lstrip('-').isdigit():
+            params['arg%d' % len(params)] = part
+        elif part not in ('real_time', 'manual_time'):
+            name_parts.append(part)
+    return '/'.join(name_parts), params
+
+
+def load_results(paths):
+    """Return the results of the benchmarks in the common schema, keyed on their runs."""
+    results = {}
+    for path in find_result_files(paths):
+        with open(path) as f:
+            data = json.load(f)
+        if isinstance(data, list):
+            # Already in the common schema
+            for entry in data:
+                results[entry['run']] = entry
+            continue
+        for benchmark in data.get('benchmarks', []):
+            if benchmark.get('run_type', 'iteration') != 'iteration':
+                continue
+            if benchmark.get('error_occurred'):
+                continue
+            run = benchmark.get('run_name', benchmark['name'])
+            name, params = split_benchmark_name(run)
+            unit = TIME_UNIT_TO_NS[benchmark.get('time_unit', 'ns')]
+            allocations = benchmark.get(ALLOCATIONS_COUNTER)
+            entry = results.setdefault(run, {
+                'run': run,
+                'name': name,
+                'params': params,
+                'ns_per_op': 0.0,
+                'allocations_per_op': allocations,
+                'repetitions': 0,
+            })
+            # The repetitions of a run are averaged
+            repetitions = entry['repetitions']
+            entry['ns_per_op'] = (
+                entry['ns_per_op'] * repetitions + benchmark['real_time'] * unit
+            ) / (repetitions + 1)
+            entry['repetitions'] = repetitions + 1
+    return results
+
+
+def export(args):
+    results = sorted(load_results(args.results).values(), key=lambda entry: entry['run'])
+    output = open(args.output, 'w') if args.output else sys.stdout
+    try:
+        json.dump(results, output, indent=2)
+        output.write('\n')
+    finally:
+        if args.output:
+            output.close()
+    return 0
+
+
+def compare(args):
+    baseline = load_results([args.baseline])
+    results = load_results(args.results)
+    regressions = 0
+    for run, entry in sorted(results.items()):
+        base = baseline.get(run)
+        if base is None:
+            print('new: %s (%.1f ns/op)' % (run, entry['ns_per_op']))
+            continue
+        messages = []
+        if base['ns_per_op'] > 0.0:
+            ratio = entry['ns_per_op'] / base['ns_per_op'] - 1.0
+            if ratio > args.time_threshold:
+                messages.append('time %.1f -> %.1f ns/op (%+.0f%%)' % (
+                    base['ns_per_op'], entry['ns_per_op'], ratio * 100.0))
+        base_allocations = base.get('allocations_per_op')
+        allocations = entry.get('allocations_per_op')
+        if base_allocations is not None and allocations is not None and \
+                allocations > base_allocations + args.allocations_threshold:
+            messages.append('allocations %.1f -> %.1f per op' % (base_allocations, allocations))
+        if messages:
+            regressions += 1
+            print('regression: %s: %s' % (run, ', '.join(messages)))
+        elif args.verbose:
+            print('ok: %s' % run)
+    for run in sorted(set(baseline) - set(results)):
+        print('missing: %s' % run)
+    print('%d benchmarks compared, %d regressions' % (len(results), regressions))
+    return 1 if regressions else 0
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    subparsers = parser.add_subparsers(dest='command')
+    subparsers.required = True
+
+    export_parser = subparsers.add_parser(
+        'export', help='convert benchmark results to the common schema')
+    export_parser.add_argument(
+        'results', nargs='+', help='google benchmark JSON files, or directories of them')
+    export_parser.add_argument(
+        '-o', '--output', help='output file, the standard output by default')
+    export_parser.set_defaults(function=export)
+
+    compare_parser = subparsers.add_parser(
+        'compare', help='compare benchmark results with a baseline')
+    compare_parser.add_argument('baseline', help='baseline, exported or google benchmark JSON')
+    compare_parser.add_argument(
+        'results', nargs='+', help='google benchmark JSON files, or directories of them')
+    compare_parser.add_argument(
+        '--time-threshold', type=float, default=0.1,
+        help='allowed relative increase of the time per operation, 0.1 by default')
+    compare_parser.add_argument(
+        '--allocations-threshold', type=float, default=0.0,
+        help='allowed increase of the allocations per operation, 0 by default')
+    compare_parser.add_argument('-v', '--verbose', action='store_true')
+    compare_parser.set_defaults(function=compare)
+
+    args = parser.parse_args(argv)
+    return args.function(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
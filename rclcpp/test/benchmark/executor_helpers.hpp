@@ -0,0 +1,67 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef BENCHMARK__EXECUTOR_HELPERS_HPP_
+#define BENCHMARK__EXECUTOR_HELPERS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "rclcpp/executors.hpp"
+
+/// The executors the benchmarks are run with, passed as a benchmark argument.
+enum class ExecutorKind : int64_t
+{
+  SingleThreaded = 0,
+  MultiThreaded = 1,
+  StaticSingleThreaded = 2,
+  Events = 3,
+};
+
+/// Make an executor of a kind, the multi-threaded ones having a number of threads.
+inline
+rclcpp::Executor::SharedPtr
+make_executor(ExecutorKind kind, size_t number_of_threads)
+{
+  switch (kind) {
+    case ExecutorKind::SingleThreaded:
+      return std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+    case ExecutorKind::MultiThreaded:
+      return std::make_shared<rclcpp::executors::MultiThreadedExecutor>(
+        rclcpp::ExecutorOptions(), number_of_threads);
+    case ExecutorKind::StaticSingleThreaded:
+      return std::make_shared<rclcpp::executors::StaticSingleThreadedExecutor>();
+    case ExecutorKind::Events:
+      return std::make_shared<rclcpp::executors::EventsExecutor>();
+  }
+  return nullptr;
+}
+
+/// Return the value of a sorted vector at a percentile.
+inline
+double
+get_percentile(const std::vector<double> & sorted_values, double percentile)
+{
+  if (sorted_values.empty()) {
+    return 0.;
+  }
+  const auto index = static_cast<size_t>(
+    percentile / 100. * static_cast<double>(sorted_values.size() - 1u));
+  return sorted_values[index];
+}
+
+#endif  // BENCHMARK__EXECUTOR_HELPERS_HPP_
@@ -0,0 +1,348 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+/// End-to-end latency harness: a publisher, a chain of relays and a subscriber.
+/**
+ * The publisher timestamps each message with the steady clock, which is shared by the
+ * processes of a host, each relay republishes the messages it receives, and the
+ * subscriber computes the latency at the entry of its callback.
+ * When done, the subscriber prints the percentiles and a histogram of the latencies.
+ *
+ * The harness is configured with parameters, for example with two relays:
+ *
+ * ```
+ * latency_harness --ros-args -p role:=subscriber -p relays:=2
+ * latency_harness --ros-args -p role:=relay -p index:=0
+ * latency_harness --ros-args -p role:=relay -p index:=1
+ * latency_harness --ros-args -p role:=publisher -p message_size:=65536 -p rate_hz:=100
+ * ```
+ *
+ * The role "all" runs the publisher, the relays and the subscriber in one process,
+ * communicating intra-process, with an executor spinning all their nodes.
+ *
+ * Parameters:
+ *  - role: publisher, relay, subscriber or all.
+ *  - relays: number of relays between the publisher and the subscriber, 0 by default.
+ *  - index: index of a relay in the chain.
+ *  - message_size: number of bytes of the payload of the messages, 1024 by default.
+ *  - count: number of messages published, 1000 by default.
+ *  - rate_hz: frequency of the publisher, 100 by default.
+ *  - reliability: reliable or best_effort.
+ *  - depth: depth of the history of the QoS, 10 by default.
+ *  - executor: single_threaded, multi_threaded, static_single_threaded or events.
+ *  - timeout_s: time the subscriber waits for a message before reporting, 5 by default.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "test_msgs/msg/unbounded_sequences.hpp"
+
+using namespace std::chrono_literals;
+
+using Message = test_msgs::msg::UnboundedSequences;
+
+namespace
+{
+
+// The timestamp and the sequence number are the first values of int64_values
+constexpr size_t kTimestampIndex = 0u;
+constexpr size_t kSequenceNumberIndex = 1u;
+
+int64_t
+now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::string
+get_topic_name(int64_t index)
+{
+  return "latency_harness_" + std::to_string(index);
+}
+
+struct HarnessOptions
+{
+  std::string role;
+  int64_t relays;
+  int64_t index;
+  int64_t message_size;
+  int64_t count;
+  int64_t rate_hz;
+  rclcpp::QoS qos{10};
+  std::string executor;
+  std::chrono::seconds timeout;
+};
+
+HarnessOptions
+declare_options(rclcpp::Node & node)
+{
+  HarnessOptions options;
+  options.role = node.declare_parameter("role", std::string("all"));
+  options.relays = node.declare_parameter("relays", int64_t{0});
+  options.index = node.declare_parameter("index", int64_t{0});
+  options.message_size = node.declare_parameter("message_size", int64_t{1024});
+  options.count = node.declare_parameter("count", int64_t{1000});
+  options.rate_hz = node.declare_parameter("rate_hz", int64_t{100});
+  const auto reliability = node.declare_parameter("reliability", std::string("reliable"));
+  const auto depth = node.declare_parameter("depth", int64_t{10});
+  options.executor = node.declare_parameter("executor", std::string("single_threaded"));
+  options.timeout = std::chrono::seconds(node.declare_parameter("timeout_s", int64_t{5}));
+
+  if (options.relays < 0 || options.message_size < 0 || options.count <= 0 ||
+    options.rate_hz <= 0 || depth <= 0)
+  {
+    throw std::invalid_argument("the numbers of the latency harness parameters must be positive");
+  }
+  options.qos = rclcpp::QoS(static_cast<size_t>(depth));
+  if (reliability == "best_effort") {
+    options.qos.best_effort();
+  } else if (reliability != "reliable") {
+    throw std::invalid_argument("unknown reliability '" + reliability + "'");
+  }
+  return options;
+}
+
+rclcpp::Executor::SharedPtr
+make_executor(const std::string & executor)
+{
+  if (executor == "single_threaded") {
+    return std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+  }
+  if (executor == "multi_threaded") {
+    return std::make_shared<rclcpp::executors::MultiThreadedExecutor>();
+  }
+  if (executor == "static_single_threaded") {
+    return std::make_shared<rclcpp::executors::StaticSingleThreadedExecutor>();
+  }
+  if (executor == "events") {
+    return std::make_shared<rclcpp::executors::EventsExecutor>();
+  }
+  throw std::invalid_argument("unknown executor '" + executor + "'");
+}
+
+/// Publish the messages at a fixed rate, once the subscriber of the first topic is matched.
+class LatencyPublisher : public rclcpp::Node
+{
+public:
+  LatencyPublisher(const HarnessOptions & options, const rclcpp::NodeOptions & node_options)
+  : rclcpp::Node("latency_publisher", node_options), options_(options)
+  {
+    publisher_ = create_publisher<Message>(get_topic_name(0), options.qos);
+    timer_ = create_wall_timer(
+      std::chrono::nanoseconds(std::chrono::seconds(1)) / options.rate_hz,
+      [this]() {publish();});
+  }
+
+private:
+  void publish()
+  {
+    if (publisher_->get_subscription_count() == 0u && sequence_number_ == 0) {
+      return;
+    }
+    if (sequence_number_ >= options_.count) {
+      timer_->cancel();
+      return;
+    }
+    auto message = std::make_unique<Message>();
+    message->uint8_values.resize(static_cast<size_t>(options_.message_size));
+    message->int64_values.resize(2u);
+    message->int64_values[kSequenceNumberIndex] = sequence_number_++;
+    // The timestamp is taken last, so that it doesn't include filling the message
+    message->int64_values[kTimestampIndex] = now_ns();
+    publisher_->publish(std::move(message));
+  }
+
+  const HarnessOptions options_;
+  rclcpp::Publisher<Message>::SharedPtr publisher_;
+  rclcpp::TimerBase::SharedPtr timer_;
+  int64_t sequence_number_ = 0;
+};
+
+/// Republish the messages of a topic of the chain on the next one.
+class LatencyRelay : public rclcpp::Node
+{
+public:
+  LatencyRelay(
+    int64_t index, const HarnessOptions & options,
+    const rclcpp::NodeOptions & node_options)
+  : rclcpp::Node("latency_relay_" + std::to_string(index), node_options)
+  {
+    publisher_ = create_publisher<Message>(get_topic_name(index + 1), options.qos);
+    subscription_ = create_subscription<Message>(
+      get_topic_name(index), options.qos,
+      [this](std::unique_ptr<Message> message) {publisher_->publish(std::move(message));});
+  }
+
+private:
+  rclcpp::Publisher<Message>::SharedPtr publisher_;
+  rclcpp::Subscription<Message>::SharedPtr subscription_;
+};
+
+/// Compute the latencies of the messages received at the end of the chain, and report them.
+class LatencySubscriber : public rclcpp::Node
+{
+public:
+  LatencySubscriber(const HarnessOptions & options, const rclcpp::NodeOptions & node_options)
+  : rclcpp::Node("latency_subscriber", node_options), options_(options)
+  {
+    latencies_us_.reserve(static_cast<size_t>(options.count));
+    subscription_ = create_subscription<Message>(
+      get_topic_name(options.relays), options.qos,
+      [this](Message::ConstSharedPtr message) {on_message(*message);});
+  }
+
+  /// Return true once all the messages were received, or none was for the timeout.
+  bool
+  is_done() const
+  {
+    const auto last_time = latencies_us_.empty() ? start_time_ : last_message_time_;
+    return static_cast<int64_t>(latencies_us_.size()) >= options_.count ||
+           std::chrono::steady_clock::now() - last_time > options_.timeout;
+  }
+
+  /// Print the percentiles of the latencies, then a histogram with power of two buckets.
+  void
+  report() const
+  {
+    std::vector<double> latencies_us = latencies_us_;
+    std::sort(latencies_us.begin(), latencies_us.end());
+    const auto received = static_cast<int64_t>(latencies_us.size());
+    std::cout << "executor: " << options_.executor << ", relays: " << options_.relays <<
+      ", message size: " << options_.message_size << " bytes, depth: " <<
+      options_.qos.depth() << ", reliable: " <<
+      (options_.qos.reliability() == rclcpp::ReliabilityPolicy::Reliable ? "yes" : "no") <<
+      std::endl;
+    std::cout << "received: " << received << ", lost: " << options_.count - received <<
+      ", out of order: " << out_of_order_ << std::endl;
+    if (latencies_us.empty()) {
+      return;
+    }
+    auto percentile = [&latencies_us](double p) {
+        return latencies_us[static_cast<size_t>(p / 100. * (latencies_us.size() - 1u))];
+      };
+    std::cout << std::fixed << std::setprecision(1) << "latency (us): min " <<
+      latencies_us.front() << ", p50 " << percentile(50.) << ", p90 " << percentile(90.) <<
+      ", p99 " << percentile(99.) << ", p99.9 " << percentile(99.9) << ", max " <<
+      latencies_us.back() << std::endl;
+
+    std::cout << std::setprecision(0) << "histogram, upper bound (us), count:" << std::endl;
+    double upper_bound_us = 1.;
+    auto it = latencies_us.begin();
+    while (it != latencies_us.end()) {
+      const auto bucket_end = std::upper_bound(it, latencies_us.end(), upper_bound_us);
+      if (bucket_end != it) {
+        std::cout << upper_bound_us << ", " << bucket_end - it << std::endl;
+      }
+      it = bucket_end;
+      upper_bound_us *= 2.;
+    }
+  }
+
+private:
+  void on_message(const Message & message)
+  {
+    const int64_t receive_time_ns = now_ns();
+    last_message_time_ = std::chrono::steady_clock::now();
+    if (message.int64_values.size() < 2u) {
+      return;
+    }
+    latencies_us_.push_back(
+      static_cast<double>(receive_time_ns - message.int64_values[kTimestampIndex]) / 1000.);
+    const int64_t sequence_number = message.int64_values[kSequenceNumberIndex];
+    if (sequence_number < next_sequence_number_) {
+      ++out_of_order_;
+    } else {
+      next_sequence_number_ = sequence_number + 1;
+    }
+  }
+
+  const HarnessOptions options_;
+  rclcpp::Subscription<Message>::SharedPtr subscription_;
+  std::vector<double> latencies_us_;
+  int64_t next_sequence_number_ = 0;
+  int64_t out_of_order_ = 0;
+  const std::chrono::steady_clock::time_point start_time_ = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point last_message_time_;
+};
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  HarnessOptions options;
+  {
+    auto parameters_node = std::make_shared<rclcpp::Node>("latency_harness");
+    options = declare_options(*parameters_node);
+  }
+  auto executor = make_executor(options.executor);
+
+  rclcpp::NodeOptions node_options;
+  node_options.use_intra_process_comms(options.role == "all");
+
+  std::vector<rclcpp::Node::SharedPtr> nodes;
+  std::shared_ptr<LatencySubscriber> subscriber;
+  if (options.role == "subscriber" || options.role == "all") {
+    subscriber = std::make_shared<LatencySubscriber>(options, node_options);
+    nodes.push_back(subscriber);
+  }
+  if (options.role == "relay") {
+    nodes.push_back(std::make_shared<LatencyRelay>(options.index, options, node_options));
+  }
+  if (options.role == "all") {
+    for (int64_t index = 0; index < options.relays; ++index) {
+      nodes.push_back(std::make_shared<LatencyRelay>(index, options, node_options));
+    }
+  }
+  if (options.role == "publisher" || options.role == "all") {
+    nodes.push_back(std::make_shared<LatencyPublisher>(options, node_options));
+  }
+  if (nodes.empty()) {
+    throw std::invalid_argument("unknown role '" + options.role + "'");
+  }
+  for (const auto & node : nodes) {
+    executor->add_node(node);
+  }
+
+  if (!subscriber) {
+    // The publisher and the relays run until they are interrupted
+    executor->spin();
+  } else {
+    auto done_timer = subscriber->create_wall_timer(
+      100ms, [&subscriber, &executor]() {
+        if (subscriber->is_done()) {
+          executor->cancel();
+        }
+      });
+    executor->spin();
+    subscriber->report();
+  }
+
+  nodes.clear();
+  subscriber.reset();
+  rclcpp::shutdown();
+  return 0;
+}
@@ -0,0 +1,75 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef BENCHMARK__PROCESS_MEMORY_HPP_
+#define BENCHMARK__PROCESS_MEMORY_HPP_
+
+#ifdef __linux__
+#include <malloc.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include <cstdint>
+#include <fstream>
+
+/// Return the number of bytes allocated on the heap, or 0 if it isn't known.
+/**
+ * It's measured with the allocator of glibc, and includes the memory allocated by rcl and
+ * the middleware.
+ */
+inline
+double
+get_heap_bytes()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  const struct mallinfo2 info = mallinfo2();
+  return static_cast<double>(info.uordblks + info.hblkhd);
+#else
+  return 0.;
+#endif
+}
+
+/// Return the resident set size of the process in KiB, or 0 if it isn't known.
+inline
+double
+get_rss_kib()
+{
+#ifdef __linux__
+  std::ifstream statm("/proc/self/statm");
+  uint64_t size = 0;
+  uint64_t resident = 0;
+  if (statm >> size >> resident) {
+    return static_cast<double>(resident) * static_cast<double>(sysconf(_SC_PAGESIZE)) / 1024.;
+  }
+#endif
+  return 0.;
+}
+
+/// Return the peak resident set size of the process in KiB, or 0 if it isn't known.
+inline
+double
+get_peak_rss_kib()
+{
+#ifdef __linux__
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    return static_cast<double>(usage.ru_maxrss);
+  }
+#endif
+  return 0.;
+}
+
+#endif  // BENCHMARK__PROCESS_MEMORY_HPP_
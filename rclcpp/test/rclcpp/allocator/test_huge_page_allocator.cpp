@@ -0,0 +1,131 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "rclcpp/allocator/allocator_common.hpp"
+#include "rclcpp/allocator/huge_page_allocator.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "test_msgs/msg/basic_types.hpp"
+
+using rclcpp::allocator::HugePageAllocator;
+using rclcpp::allocator::HugePageOptions;
+using rclcpp::allocator::HugePagePolicy;
+
+namespace
+{
+
+HugePageOptions
+make_options(size_t threshold, HugePagePolicy policy = HugePagePolicy::Transparent)
+{
+  HugePageOptions options;
+  options.threshold = threshold;
+  options.policy = policy;
+  return options;
+}
+
+}  // namespace
+
+TEST(TestHugePageAllocator, small_allocations) {
+  HugePageAllocator<int> allocator(make_options(1024u));
+  int * values = allocator.allocate(16u);
+  ASSERT_TRUE(nullptr != values);
+  EXPECT_FALSE(HugePageAllocator<int>::is_mapped(values));
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(values) % alignof(std::max_align_t));
+  values[15] = 42;
+  allocator.deallocate(values, 16u);
+}
+
+TEST(TestHugePageAllocator, large_allocations) {
+  for (auto policy : {HugePagePolicy::Transparent, HugePagePolicy::Explicit}) {
+    HugePageAllocator<char> allocator(make_options(1024u, policy));
+    const size_t size = 3u * 1024u * 1024u;
+    char * buffer = allocator.allocate(size);
+    ASSERT_TRUE(nullptr != buffer);
+#ifdef __linux__
+    EXPECT_TRUE(HugePageAllocator<char>::is_mapped(buffer));
+#endif
+    std::memset(buffer, 1, size);
+    EXPECT_EQ(1, buffer[size - 1u]);
+    // The size given to deallocate() isn't used to unmap the memory.
+    allocator.deallocate(buffer, 1u);
+  }
+  EXPECT_NO_THROW(HugePageAllocator<char>().deallocate(nullptr, 0u));
+}
+
+TEST(TestHugePageAllocator, rebind_and_copy) {
+  HugePageAllocator<void> allocator(make_options(4096u));
+  HugePageAllocator<double, std::allocator<double>> rebound_allocator(allocator);
+  EXPECT_EQ(4096u, rebound_allocator.get_options().threshold);
+  EXPECT_TRUE(allocator == rebound_allocator);
+  EXPECT_FALSE(allocator != rebound_allocator);
+  EXPECT_TRUE(HugePageAllocator<void>() == allocator);
+
+  std::vector<double, HugePageAllocator<double>> values(rebound_allocator);
+  values.resize(16u);
+  EXPECT_FALSE(HugePageAllocator<double>::is_mapped(values.data()));
+  values.resize(4096u);
+#ifdef __linux__
+  EXPECT_TRUE(HugePageAllocator<double>::is_mapped(values.data()));
+#endif
+}
+
+TEST(TestHugePageAllocator, rcl_allocator) {
+  HugePageAllocator<char> allocator(make_options(1024u));
+  rcl_allocator_t rcl_allocator = rclcpp::allocator::get_rcl_allocator<char>(allocator);
+  const size_t size = 4u * 1024u * 1024u;
+  auto memory = static_cast<char *>(rcl_allocator.zero_allocate(size, 1u, rcl_allocator.state));
+  ASSERT_TRUE(nullptr != memory);
+  EXPECT_EQ(0, memory[size - 1u]);
+  rcl_allocator.deallocate(memory, rcl_allocator.state);
+}
+
+TEST(TestHugePageAllocator, publisher_and_subscription) {
+  rclcpp::init(0, nullptr);
+  {
+    auto node = std::make_shared<rclcpp::Node>("huge_page_allocator_node");
+    using Allocator = HugePageAllocator<void>;
+    // All the allocations are backed by huge pages
+    const auto allocator = std::make_shared<Allocator>(make_options(0u));
+
+    rclcpp::PublisherOptionsWithAllocator<Allocator> publisher_options;
+    publisher_options.allocator = allocator;
+    publisher_options.use_intra_process_comm = rclcpp::IntraProcessSetting::Enable;
+    auto publisher = node->create_publisher<test_msgs::msg::BasicTypes>(
+      "topic", 10, publisher_options);
+
+    rclcpp::SubscriptionOptionsWithAllocator<Allocator> subscription_options;
+    subscription_options.allocator = allocator;
+    subscription_options.use_intra_process_comm = rclcpp::IntraProcessSetting::Enable;
+    int32_t received = 0;
+    auto subscription = node->create_subscription<test_msgs::msg::BasicTypes>(
+      "topic", 10,
+      [&received](const test_msgs::msg::BasicTypes & message) {received = message.int32_value;},
+      subscription_options);
+
+    test_msgs::msg::BasicTypes message;
+    message.int32_value = 42;
+    publisher->publish(message);
+    rclcpp::spin_some(node);
+    EXPECT_EQ(42, received);
+  }
+  rclcpp::shutdown();
+}
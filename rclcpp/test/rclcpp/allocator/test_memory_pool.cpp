@@ -0,0 +1,120 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>  // NOLINT
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/allocator/memory_pool.hpp"
+
+using rclcpp::allocator::MemoryPool;
+
+TEST(TestMemoryPool, construction) {
+  EXPECT_THROW(MemoryPool(0u, 1u), std::invalid_argument);
+  EXPECT_THROW(MemoryPool(64u, 0u), std::invalid_argument);
+  EXPECT_THROW(MemoryPool(64u, 1u, true, nullptr), std::invalid_argument);
+
+  MemoryPool pool(100u, 4u);
+  EXPECT_EQ(128u, pool.get_max_block_size());
+  EXPECT_EQ(4u, pool.get_number_of_free_blocks(1u));
+  EXPECT_EQ(4u, pool.get_number_of_free_blocks(128u));
+  EXPECT_EQ(0u, pool.get_number_of_free_blocks(129u));
+  const size_t number_of_size_classes = pool.get_number_of_upstream_allocations();
+  EXPECT_LE(1u, number_of_size_classes);
+}
+
+TEST(TestMemoryPool, allocate_and_deallocate) {
+  MemoryPool pool(256u, 2u, false);
+  const size_t upstream_allocations = pool.get_number_of_upstream_allocations();
+
+  void * first = pool.allocate(100u);
+  void * second = pool.allocate(128u);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(first) % alignof(std::max_align_t));
+  EXPECT_EQ(0u, pool.get_number_of_free_blocks(100u));
+  EXPECT_EQ(2u, pool.get_number_of_free_blocks(256u));
+  EXPECT_THROW((void)pool.allocate(120u), std::bad_alloc);
+
+  // The last block given back is the first one given again
+  pool.deallocate(first, 100u);
+  EXPECT_EQ(1u, pool.get_number_of_free_blocks(100u));
+  EXPECT_EQ(first, pool.allocate(128u));
+  pool.deallocate(first, 128u);
+  pool.deallocate(second, 128u);
+  EXPECT_EQ(2u, pool.get_number_of_free_blocks(128u));
+  EXPECT_EQ(upstream_allocations, pool.get_number_of_upstream_allocations());
+
+  // The bigger allocations are forwarded to the upstream resource
+  void * big = pool.allocate(1000u);
+  EXPECT_EQ(upstream_allocations + 1u, pool.get_number_of_upstream_allocations());
+  pool.deallocate(big, 1000u);
+}
+
+TEST(TestMemoryPool, growth) {
+  MemoryPool pool(64u, 1u, true);
+  const size_t upstream_allocations = pool.get_number_of_upstream_allocations();
+  void * first = pool.allocate(64u);
+  void * second = pool.allocate(64u);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(upstream_allocations + 1u, pool.get_number_of_upstream_allocations());
+  pool.deallocate(first, 64u);
+  pool.deallocate(second, 64u);
+  EXPECT_EQ(2u, pool.get_number_of_free_blocks(64u));
+}
+
+TEST(TestMemoryPool, pmr_containers) {
+  MemoryPool pool(1024u, 8u, false);
+  {
+    std::pmr::vector<int> values(&pool);
+    values.reserve(100u);
+    values.assign(100u, 1);
+    EXPECT_EQ(7u, pool.get_number_of_free_blocks(100u * sizeof(int)));
+  }
+  EXPECT_EQ(8u, pool.get_number_of_free_blocks(100u * sizeof(int)));
+  EXPECT_TRUE(pool.is_equal(pool));
+  MemoryPool other_pool(64u, 1u);
+  EXPECT_FALSE(pool.is_equal(other_pool));
+}
+
+TEST(TestMemoryPool, concurrent_allocations) {
+  MemoryPool pool(64u, 16u, true);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 4u; ++i) {
+    threads.emplace_back(
+      [&pool]() {
+        std::vector<void *> blocks;
+        for (size_t iteration = 0; iteration < 1000u; ++iteration) {
+          for (size_t j = 0; j < 8u; ++j) {
+            blocks.push_back(pool.allocate(32u));
+          }
+          for (void * block : blocks) {
+            pool.deallocate(block, 32u);
+          }
+          blocks.clear();
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0u, pool.get_number_of_free_blocks(32u) % 16u);
+  EXPECT_LE(16u, pool.get_number_of_free_blocks(32u));
+}
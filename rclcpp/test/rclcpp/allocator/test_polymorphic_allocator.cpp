@@ -0,0 +1,130 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>  // NOLINT
+#include <stdexcept>
+#include <vector>
+
+#include "rclcpp/allocator/allocator_common.hpp"
+#include "rclcpp/allocator/memory_pool.hpp"
+#include "rclcpp/allocator/polymorphic_allocator.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/strategies/allocator_memory_strategy.hpp"
+
+#include "test_msgs/msg/empty.hpp"
+
+using rclcpp::allocator::MemoryPool;
+using rclcpp::allocator::PolymorphicAllocator;
+
+TEST(TestPolymorphicAllocator, construction) {
+  EXPECT_EQ(std::pmr::get_default_resource(), PolymorphicAllocator<int>().resource());
+  EXPECT_THROW(
+    PolymorphicAllocator<int>(static_cast<std::pmr::memory_resource *>(nullptr)),
+    std::invalid_argument);
+  EXPECT_THROW(
+    PolymorphicAllocator<int>(std::shared_ptr<std::pmr::memory_resource>()),
+    std::invalid_argument);
+
+  MemoryPool pool;
+  PolymorphicAllocator<void> allocator(&pool);
+  PolymorphicAllocator<double> rebound_allocator(allocator);
+  EXPECT_EQ(&pool, rebound_allocator.resource());
+  EXPECT_TRUE(allocator == rebound_allocator);
+  EXPECT_FALSE(allocator != rebound_allocator);
+  EXPECT_TRUE(PolymorphicAllocator<void>() != allocator);
+}
+
+TEST(TestPolymorphicAllocator, allocate_from_pool) {
+  auto pool = std::make_shared<MemoryPool>(256u, 4u, false);
+  // Each block is prefixed with its size
+  const size_t bytes = 6u * sizeof(double) + sizeof(std::max_align_t);
+  const size_t free_blocks = pool->get_number_of_free_blocks(bytes);
+  PolymorphicAllocator<double> allocator(pool);
+  pool.reset();
+  // The allocator keeps the pool alive
+  MemoryPool * resource = static_cast<MemoryPool *>(allocator.resource());
+
+  {
+    std::vector<double, PolymorphicAllocator<double>> values(allocator);
+    values.reserve(6u);
+    EXPECT_EQ(free_blocks - 1u, resource->get_number_of_free_blocks(bytes));
+  }
+  EXPECT_EQ(free_blocks, resource->get_number_of_free_blocks(bytes));
+}
+
+TEST(TestPolymorphicAllocator, rcl_allocator) {
+  MemoryPool pool(256u, 4u, false);
+  PolymorphicAllocator<char> allocator(&pool);
+  rcl_allocator_t rcl_allocator = rclcpp::allocator::get_rcl_allocator<char>(allocator);
+  void * memory = rcl_allocator.zero_allocate(8u, 4u, rcl_allocator.state);
+  ASSERT_TRUE(nullptr != memory);
+#ifndef _WIN32
+  EXPECT_EQ(3u, pool.get_number_of_free_blocks(32u + sizeof(std::max_align_t)));
+#endif
+  // The size given to deallocate() by rcl isn't the allocated one
+  rcl_allocator.deallocate(memory, rcl_allocator.state);
+  EXPECT_EQ(4u, pool.get_number_of_free_blocks(32u + sizeof(std::max_align_t)));
+}
+
+TEST(TestPolymorphicAllocator, entities) {
+  rclcpp::init(0, nullptr);
+  {
+    auto pool = std::make_shared<MemoryPool>();
+    using Allocator = PolymorphicAllocator<void>;
+    auto allocator = std::make_shared<Allocator>(pool);
+    auto node = std::make_shared<rclcpp::Node>("polymorphic_allocator_node");
+
+    rclcpp::PublisherOptionsWithAllocator<Allocator> publisher_options;
+    publisher_options.allocator = allocator;
+    auto publisher = node->create_publisher<test_msgs::msg::Empty>(
+      "topic", 10, publisher_options);
+    EXPECT_EQ(pool.get(), publisher->get_published_type_allocator().resource());
+
+    size_t number_of_messages = 0;
+    rclcpp::SubscriptionOptionsWithAllocator<Allocator> subscription_options;
+    subscription_options.allocator = allocator;
+    auto msg_mem_strat = std::make_shared<
+      rclcpp::message_memory_strategy::MessageMemoryStrategy<test_msgs::msg::Empty, Allocator>>(
+      allocator);
+    auto subscription = node->create_subscription<test_msgs::msg::Empty>(
+      "topic", 10,
+      [&number_of_messages](std::shared_ptr<const test_msgs::msg::Empty>) {
+        ++number_of_messages;
+      },
+      subscription_options, msg_mem_strat);
+
+    rclcpp::ExecutorOptions executor_options;
+    executor_options.memory_strategy = std::make_shared<
+      rclcpp::memory_strategies::allocator_memory_strategy::AllocatorMemoryStrategy<Allocator>>(
+      allocator);
+    rclcpp::executors::SingleThreadedExecutor executor(executor_options);
+    executor.add_node(node);
+
+    publisher->publish(test_msgs::msg::Empty());
+    const auto start = std::chrono::steady_clock::now();
+    while (number_of_messages == 0u &&
+      std::chrono::steady_clock::now() - start < std::chrono::seconds(10))
+    {
+      executor.spin_some(std::chrono::milliseconds(100));
+    }
+    EXPECT_EQ(1u, number_of_messages);
+  }
+  rclcpp::shutdown();
+}
@@ -0,0 +1,140 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rclcpp/allocator/recycling_allocator.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "test_msgs/msg/unbounded_sequences.hpp"
+
+using rclcpp::allocator::RecyclingAllocator;
+using test_msgs::msg::UnboundedSequences;
+
+TEST(TestRecyclingAllocator, recycle_messages) {
+  RecyclingAllocator<UnboundedSequences, UnboundedSequences> allocator(2u);
+  const auto & pool = allocator.get_pool();
+  using Traits = std::allocator_traits<decltype(allocator)>;
+
+  UnboundedSequences * message = Traits::allocate(allocator, 1u);
+  Traits::construct(allocator, message);
+  EXPECT_TRUE(pool->owns(message));
+  EXPECT_EQ(1u, pool->get_number_of_available_messages());
+  message->int32_values.resize(128u);
+  const auto capacity = message->int32_values.capacity();
+  Traits::destroy(allocator, message);
+  Traits::deallocate(allocator, message, 1u);
+  EXPECT_EQ(2u, pool->get_number_of_available_messages());
+
+  // The message is reused with the memory of its sequences.
+  UnboundedSequences * recycled_message = Traits::allocate(allocator, 1u);
+  Traits::construct(allocator, recycled_message);
+  EXPECT_EQ(message, recycled_message);
+  EXPECT_EQ(capacity, recycled_message->int32_values.capacity());
+
+  // Copies are assigned to the recycled messages.
+  UnboundedSequences original;
+  original.int32_values = {1, 2, 3};
+  UnboundedSequences * copy = Traits::allocate(allocator, 1u);
+  Traits::construct(allocator, copy, original);
+  EXPECT_TRUE(pool->owns(copy));
+  EXPECT_EQ(original, *copy);
+
+  // The pool is empty, so the message is allocated.
+  UnboundedSequences * allocated_message = Traits::allocate(allocator, 1u);
+  Traits::construct(allocator, allocated_message, original);
+  EXPECT_FALSE(pool->owns(allocated_message));
+  EXPECT_EQ(original, *allocated_message);
+
+  for (UnboundedSequences * m : {recycled_message, copy, allocated_message}) {
+    Traits::destroy(allocator, m);
+    Traits::deallocate(allocator, m, 1u);
+  }
+  EXPECT_EQ(2u, pool->get_number_of_available_messages());
+}
+
+TEST(TestRecyclingAllocator, rebind_and_copy) {
+  using Allocator = RecyclingAllocator<void, UnboundedSequences>;
+  Allocator allocator(4u);
+  RecyclingAllocator<UnboundedSequences, UnboundedSequences> message_allocator(allocator);
+  EXPECT_EQ(allocator.get_pool(), message_allocator.get_pool());
+  EXPECT_TRUE(allocator == message_allocator);
+  EXPECT_TRUE(allocator != Allocator(4u));
+
+  // The other types are allocated as usual, as are the shared messages.
+  std::vector<std::string, RecyclingAllocator<std::string, UnboundedSequences>> strings(
+    allocator);
+  strings.resize(32u, "recycling");
+  EXPECT_EQ("recycling", strings.back());
+  auto shared_message = std::allocate_shared<UnboundedSequences>(message_allocator);
+  EXPECT_FALSE(message_allocator.get_pool()->owns(shared_message.get()));
+  EXPECT_EQ(4u, allocator.get_pool()->get_number_of_available_messages());
+
+  EXPECT_THROW(Allocator(0u), std::invalid_argument);
+  EXPECT_THROW(Allocator(nullptr), std::invalid_argument);
+}
+
+TEST(TestRecyclingAllocator, intra_process_publisher_and_subscription) {
+  rclcpp::init(0, nullptr);
+  {
+    auto node = std::make_shared<rclcpp::Node>("recycling_allocator_node");
+    using Allocator = RecyclingAllocator<void, UnboundedSequences>;
+    using MessageDeleter = rclcpp::allocator::Deleter<
+      RecyclingAllocator<UnboundedSequences, UnboundedSequences>, UnboundedSequences>;
+    const auto allocator = std::make_shared<Allocator>(4u);
+    const auto & pool = allocator->get_pool();
+
+    rclcpp::PublisherOptionsWithAllocator<Allocator> publisher_options;
+    publisher_options.allocator = allocator;
+    publisher_options.use_intra_process_comm = rclcpp::IntraProcessSetting::Enable;
+    auto publisher = node->create_publisher<UnboundedSequences>(
+      "topic", 10, publisher_options);
+
+    rclcpp::SubscriptionOptionsWithAllocator<Allocator> subscription_options;
+    subscription_options.allocator = allocator;
+    subscription_options.use_intra_process_comm = rclcpp::IntraProcessSetting::Enable;
+    const UnboundedSequences * received = nullptr;
+    size_t received_size = 0u;
+    auto subscription = node->create_subscription<UnboundedSequences>(
+      "topic", 10,
+      [&received, &received_size](std::unique_ptr<UnboundedSequences, MessageDeleter> message) {
+        received = message.get();
+        received_size = message->int32_values.size();
+      },
+      subscription_options);
+
+    const size_t available_messages = pool->get_number_of_available_messages();
+    auto message = publisher->borrow_message();
+    const UnboundedSequences * sent = message.get();
+    EXPECT_TRUE(pool->owns(sent));
+    message->int32_values.resize(64u);
+    publisher->publish(std::move(message));
+    rclcpp::spin_some(node);
+
+    EXPECT_EQ(sent, received);
+    EXPECT_EQ(64u, received_size);
+    // The subscription gave the message back once its callback returned.
+    EXPECT_EQ(available_messages, pool->get_number_of_available_messages());
+    auto next_message = publisher->borrow_message();
+    EXPECT_EQ(sent, next_message.get());
+    EXPECT_LE(64u, next_message->int32_values.capacity());
+  }
+  rclcpp::shutdown();
+}
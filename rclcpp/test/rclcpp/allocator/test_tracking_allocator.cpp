@@ -0,0 +1,132 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "rclcpp/allocator/allocator_common.hpp"
+#include "rclcpp/allocator/tracking_allocator.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "test_msgs/msg/empty.hpp"
+
+using rclcpp::allocator::AllocationStatistics;
+using rclcpp::allocator::TrackingAllocator;
+
+TEST(TestTrackingAllocator, allocate_and_deallocate) {
+  TrackingAllocator<int> allocator;
+  const auto & statistics = allocator.get_statistics();
+  ASSERT_NE(nullptr, statistics);
+
+  int * first = allocator.allocate(4u);
+  int * second = allocator.allocate(2u);
+  ASSERT_TRUE(nullptr != first);
+  ASSERT_TRUE(nullptr != second);
+  auto counters = statistics->get_counters();
+  EXPECT_EQ(2u, counters.number_of_allocations);
+  EXPECT_EQ(0u, counters.number_of_deallocations);
+  EXPECT_EQ(6u * sizeof(int), counters.bytes_allocated);
+  EXPECT_EQ(6u * sizeof(int), counters.bytes_in_use);
+  EXPECT_EQ(6u * sizeof(int), counters.peak_bytes_in_use);
+
+  allocator.deallocate(first, 4u);
+  counters = statistics->get_counters();
+  EXPECT_EQ(1u, counters.number_of_deallocations);
+  EXPECT_EQ(2u * sizeof(int), counters.bytes_in_use);
+  EXPECT_EQ(6u * sizeof(int), counters.peak_bytes_in_use);
+
+  // The size given to deallocate() isn't used to track the bytes in use.
+  allocator.deallocate(second, 1u);
+  counters = statistics->get_counters();
+  EXPECT_EQ(2u, counters.number_of_deallocations);
+  EXPECT_EQ(0u, counters.bytes_in_use);
+}
+
+TEST(TestTrackingAllocator, reset) {
+  TrackingAllocator<char> allocator;
+  const auto & statistics = allocator.get_statistics();
+  char * first = allocator.allocate(10u);
+  char * second = allocator.allocate(20u);
+  allocator.deallocate(second, 20u);
+
+  statistics->reset();
+  auto counters = statistics->get_counters();
+  EXPECT_EQ(0u, counters.number_of_allocations);
+  EXPECT_EQ(0u, counters.number_of_deallocations);
+  EXPECT_EQ(0u, counters.bytes_allocated);
+  EXPECT_EQ(10u, counters.bytes_in_use);
+  EXPECT_EQ(10u, counters.peak_bytes_in_use);
+
+  allocator.deallocate(first, 10u);
+  counters = statistics->get_counters();
+  EXPECT_EQ(1u, counters.number_of_deallocations);
+  EXPECT_EQ(0u, counters.bytes_in_use);
+  EXPECT_EQ(10u, counters.peak_bytes_in_use);
+}
+
+TEST(TestTrackingAllocator, copies_share_statistics) {
+  auto statistics = std::make_shared<AllocationStatistics>();
+  TrackingAllocator<void> allocator(statistics);
+  TrackingAllocator<double, std::allocator<double>> rebound_allocator(allocator);
+  EXPECT_EQ(statistics, rebound_allocator.get_statistics());
+  EXPECT_TRUE(allocator == rebound_allocator);
+  EXPECT_FALSE(allocator != rebound_allocator);
+  EXPECT_TRUE(TrackingAllocator<void>() != allocator);
+
+  {
+    std::vector<double, TrackingAllocator<double>> values(rebound_allocator);
+    values.resize(100u);
+    EXPECT_LE(1u, statistics->get_counters().number_of_allocations);
+    EXPECT_LE(100u * sizeof(double), statistics->get_counters().bytes_in_use);
+  }
+  EXPECT_EQ(0u, statistics->get_counters().bytes_in_use);
+
+  EXPECT_THROW(TrackingAllocator<void>{nullptr}, std::invalid_argument);
+}
+
+TEST(TestTrackingAllocator, rcl_allocator) {
+  TrackingAllocator<char> allocator;
+  rcl_allocator_t rcl_allocator = rclcpp::allocator::get_rcl_allocator<char>(allocator);
+  void * memory = rcl_allocator.zero_allocate(8u, 4u, rcl_allocator.state);
+  ASSERT_TRUE(nullptr != memory);
+  rcl_allocator.deallocate(memory, rcl_allocator.state);
+  const auto counters = allocator.get_statistics()->get_counters();
+#ifndef _WIN32
+  EXPECT_EQ(1u, counters.number_of_allocations);
+  EXPECT_EQ(32u, counters.peak_bytes_in_use);
+#endif
+  EXPECT_EQ(0u, counters.bytes_in_use);
+}
+
+TEST(TestTrackingAllocator, publisher_allocations) {
+  rclcpp::init(0, nullptr);
+  {
+    auto node = std::make_shared<rclcpp::Node>("tracking_allocator_node");
+    using Allocator = TrackingAllocator<void>;
+    rclcpp::PublisherOptionsWithAllocator<Allocator> options;
+    options.allocator = std::make_shared<Allocator>();
+    const auto statistics = options.allocator->get_statistics();
+
+    auto publisher = node->create_publisher<test_msgs::msg::Empty>("topic", 10, options);
+    EXPECT_EQ(statistics, publisher->get_published_type_allocator().get_statistics());
+    publisher->publish(test_msgs::msg::Empty());
+    publisher.reset();
+    options = rclcpp::PublisherOptionsWithAllocator<Allocator>();
+    EXPECT_EQ(0u, statistics->get_counters().bytes_in_use);
+  }
+  rclcpp::shutdown();
+}
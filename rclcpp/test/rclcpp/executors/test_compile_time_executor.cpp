@@ -0,0 +1,133 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/executors/compile_time_executor.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "test_msgs/msg/basic_types.hpp"
+
+using namespace std::chrono_literals;
+
+using BasicTypes = test_msgs::msg::BasicTypes;
+
+class TestCompileTimeExecutor : public ::testing::Test
+{
+public:
+  void SetUp()
+  {
+    rclcpp::init(0, nullptr);
+    node = std::make_shared<rclcpp::Node>("node", "ns");
+  }
+
+  void TearDown()
+  {
+    node.reset();
+    rclcpp::shutdown();
+  }
+
+protected:
+  std::shared_ptr<rclcpp::Subscription<BasicTypes>> create_subscription(const std::string & topic)
+  {
+    return node->create_subscription<BasicTypes>(topic, 10, [](BasicTypes::ConstSharedPtr) {});
+  }
+
+  rclcpp::Node::SharedPtr node;
+};
+
+TEST_F(TestCompileTimeExecutor, execute_handlers) {
+  using rclcpp::executors::CompileTimeExecutor;
+  using rclcpp::executors::CompileTimeSubscription;
+  using rclcpp::executors::CompileTimeTimer;
+
+  std::vector<int> calls;
+  auto publisher = node->create_publisher<BasicTypes>("topic", 10);
+  CompileTimeExecutor executor(
+    node->get_node_base_interface()->get_context(),
+    CompileTimeSubscription(
+      create_subscription("topic"),
+      [&calls](const BasicTypes & msg) {calls.push_back(msg.int32_value);}),
+    CompileTimeTimer(1ms, [&calls]() {calls.push_back(-1);}),
+    CompileTimeSubscription(
+      create_subscription("topic"),
+      [&calls](const BasicTypes & msg, const rclcpp::MessageInfo &) {
+        calls.push_back(msg.int32_value + 100);
+      }));
+  static_assert(decltype(executor)::number_of_subscriptions == 2u, "two subscriptions expected");
+  static_assert(decltype(executor)::number_of_timers == 1u, "one timer expected");
+
+  // Wait for the publisher to match the subscriptions, then for the timer to be called once
+  const auto start = std::chrono::steady_clock::now();
+  while (publisher->get_subscription_count() < 2u &&
+    std::chrono::steady_clock::now() - start < 10s)
+  {
+    std::this_thread::sleep_for(1ms);
+  }
+  ASSERT_EQ(2u, publisher->get_subscription_count());
+  executor.get_handler<1>().get_timer()->cancel();
+  EXPECT_EQ(0u, executor.spin_once(0ns));
+
+  BasicTypes msg;
+  msg.int32_value = 1;
+  publisher->publish(msg);
+  size_t number_of_callbacks = 0u;
+  while (number_of_callbacks < 2u && std::chrono::steady_clock::now() - start < 10s) {
+    number_of_callbacks += executor.spin_once(10ms);
+  }
+  // Both subscriptions may not receive the message in the same wait
+  std::sort(calls.begin(), calls.end());
+  EXPECT_EQ(std::vector<int>({1, 101}), calls);
+
+  calls.clear();
+  executor.get_handler<1>().get_timer()->reset();
+  while (calls.empty() && std::chrono::steady_clock::now() - start < 10s) {
+    executor.spin_once(10ms);
+  }
+  EXPECT_EQ(std::vector<int>({-1}), calls);
+}
+
+TEST_F(TestCompileTimeExecutor, spin_until_canceled) {
+  using rclcpp::executors::CompileTimeExecutor;
+  using rclcpp::executors::CompileTimeTimer;
+
+  size_t timer_count = 0u;
+  std::function<void()> cancel;
+  CompileTimeExecutor executor(
+    node->get_node_base_interface()->get_context(),
+    CompileTimeTimer(
+      1ms, [&timer_count, &cancel]() {
+        if (++timer_count == 3u) {
+          cancel();
+        }
+      }));
+  cancel = [&executor]() {executor.cancel();};
+  executor.spin();
+  EXPECT_EQ(3u, timer_count);
+
+  // Spinning is interrupted on shutdown too
+  std::thread spinner([&executor]() {executor.spin();});
+  std::this_thread::sleep_for(10ms);
+  rclcpp::shutdown();
+  spinner.join();
+}
@@ -0,0 +1,365 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <poll.h>
+#endif
+
+#include "rclcpp/executors/events_executor.hpp"
+#include "rclcpp/experimental/buffers/pollable_events_queue.hpp"
+#include "rclcpp/experimental/buffers/simple_events_queue.hpp"
+#include "rclcpp/experimental/timers_manager.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "test_msgs/msg/empty.hpp"
+#include "test_msgs/srv/empty.hpp"
+
+using namespace std::chrono_literals;
+
+using rclcpp::executors::EventsExecutor;
+using rclcpp::executors::ExecutorEvent;
+using rclcpp::executors::ExecutorEventType;
+
+class TestEventsExecutor : public ::testing::Test
+{
+public:
+  void SetUp()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  void TearDown()
+  {
+    rclcpp::shutdown();
+  }
+};
+
+TEST_F(TestEventsExecutor, simple_events_queue)
+{
+  rclcpp::experimental::buffers::SimpleEventsQueue queue;
+  EXPECT_TRUE(queue.empty());
+
+  ExecutorEvent event;
+  EXPECT_FALSE(queue.dequeue(event, 0ns));
+  EXPECT_FALSE(queue.dequeue(event, 10ms));
+
+  int entity = 0;
+  queue.enqueue({&entity, -1, ExecutorEventType::SUBSCRIPTION_EVENT, 3});
+  queue.enqueue({nullptr, 2, ExecutorEventType::WAITABLE_EVENT, 1});
+  EXPECT_EQ(2u, queue.size());
+
+  ASSERT_TRUE(queue.dequeue(event, 0ns));
+  EXPECT_EQ(&entity, event.exec_entity_id);
+  EXPECT_EQ(ExecutorEventType::SUBSCRIPTION_EVENT, event.type);
+  EXPECT_EQ(3u, event.num_events);
+  ASSERT_TRUE(queue.dequeue(event));
+  EXPECT_EQ(2, event.gen_entity_id);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(TestEventsExecutor, null_events_queue)
+{
+  EXPECT_THROW(EventsExecutor executor(nullptr), std::invalid_argument);
+}
+
+TEST_F(TestEventsExecutor, timers_manager)
+{
+  EXPECT_THROW(
+    rclcpp::experimental::TimersManager(rclcpp::contexts::get_global_default_context(), nullptr),
+    std::invalid_argument);
+
+  std::atomic<size_t> ready_count{0};
+  rclcpp::experimental::TimersManager timers_manager(
+    rclcpp::contexts::get_global_default_context(),
+    [&ready_count](const rclcpp::TimerBase *) {ready_count++;});
+
+  auto node = std::make_shared<rclcpp::Node>("node");
+  auto timer = node->create_wall_timer(1ms, []() {});
+  timers_manager.add_timer(timer);
+  timers_manager.add_timer(timer);
+  EXPECT_EQ(1u, timers_manager.size());
+  EXPECT_LE(timers_manager.get_head_timeout(), 1ms);
+
+  std::this_thread::sleep_for(2ms);
+  EXPECT_EQ(1u, timers_manager.trigger_ready_timers());
+  EXPECT_EQ(1u, ready_count.load());
+
+  timers_manager.start();
+  EXPECT_THROW(timers_manager.start(), std::runtime_error);
+  auto start = std::chrono::steady_clock::now();
+  while (ready_count.load() < 5 && std::chrono::steady_clock::now() - start < 1s) {
+    std::this_thread::sleep_for(1ms);
+  }
+  timers_manager.stop();
+  EXPECT_LE(5u, ready_count.load());
+
+  timers_manager.remove_timer(timer);
+  EXPECT_EQ(0u, timers_manager.size());
+}
+
+TEST_F(TestEventsExecutor, timers_manager_many_timers)
+{
+  std::vector<const rclcpp::TimerBase *> ready_timers;
+  rclcpp::experimental::TimersManager timers_manager(
+    rclcpp::contexts::get_global_default_context(),
+    [&ready_timers](const rclcpp::TimerBase * timer) {ready_timers.push_back(timer);});
+
+  auto node = std::make_shared<rclcpp::Node>("node");
+  std::vector<rclcpp::TimerBase::SharedPtr> timers;
+  for (int i = 0; i < 500; ++i) {
+    timers.push_back(node->create_wall_timer(100s, []() {}));
+  }
+  auto fast_timer = node->create_wall_timer(1ms, []() {});
+  timers.push_back(fast_timer);
+  for (const auto & timer : timers) {
+    timers_manager.add_timer(timer);
+  }
+  EXPECT_EQ(501u, timers_manager.size());
+  EXPECT_LE(timers_manager.get_head_timeout(), 1ms);
+
+  std::this_thread::sleep_for(2ms);
+  EXPECT_EQ(1u, timers_manager.trigger_ready_timers());
+  ASSERT_EQ(1u, ready_timers.size());
+  EXPECT_EQ(fast_timer.get(), ready_timers[0]);
+
+  // A canceled timer isn't notified anymore, until it is reset.
+  fast_timer->cancel();
+  std::this_thread::sleep_for(2ms);
+  EXPECT_EQ(0u, timers_manager.trigger_ready_timers());
+  EXPECT_GT(timers_manager.get_head_timeout(), 1s);
+  fast_timer->reset();
+  EXPECT_LE(timers_manager.get_head_timeout(), 1ms);
+  std::this_thread::sleep_for(2ms);
+  EXPECT_EQ(1u, timers_manager.trigger_ready_timers());
+
+  timers_manager.remove_timer(fast_timer);
+  EXPECT_EQ(500u, timers_manager.size());
+  EXPECT_GT(timers_manager.get_head_timeout(), 1s);
+
+  timers_manager.clear();
+  EXPECT_EQ(0u, timers_manager.size());
+  EXPECT_EQ(std::chrono::nanoseconds::max(), timers_manager.get_head_timeout());
+}
+
+TEST_F(TestEventsExecutor, timers_manager_slack)
+{
+  std::vector<const rclcpp::TimerBase *> ready_timers;
+  rclcpp::experimental::TimersManager timers_manager(
+    rclcpp::contexts::get_global_default_context(),
+    [&ready_timers](const rclcpp::TimerBase * timer) {ready_timers.push_back(timer);});
+
+  auto node = std::make_shared<rclcpp::Node>("node");
+  auto timer = node->create_wall_timer(2s, []() {});
+  auto slack_timer = node->create_wall_timer(1s, []() {});
+  slack_timer->set_slack(2s);
+  timers_manager.add_timer(timer);
+  timers_manager.add_timer(slack_timer);
+  // The timer with a slack doesn't wake up the thread before the other one.
+  EXPECT_GT(timers_manager.get_head_timeout(), 1s);
+
+  // But it is notified when its deadline passed, even though its slack didn't.
+  auto fast_slack_timer = node->create_wall_timer(1ms, []() {});
+  fast_slack_timer->set_slack(10s);
+  timers_manager.add_timer(fast_slack_timer);
+  EXPECT_GT(timers_manager.get_head_timeout(), 1s);
+  std::this_thread::sleep_for(2ms);
+  EXPECT_EQ(1u, timers_manager.trigger_ready_timers());
+  ASSERT_EQ(1u, ready_timers.size());
+  EXPECT_EQ(fast_slack_timer.get(), ready_timers[0]);
+}
+
+#ifndef _WIN32
+namespace
+{
+
+bool
+is_readable(int fd, int timeout_ms = 0)
+{
+  pollfd poll_fd = {fd, POLLIN, 0};
+  return poll(&poll_fd, 1, timeout_ms) == 1 && (poll_fd.revents & POLLIN);
+}
+
+}  // namespace
+
+TEST_F(TestEventsExecutor, pollable_events_queue)
+{
+  rclcpp::experimental::buffers::PollableEventsQueue queue;
+  const int fd = queue.get_fd();
+  ASSERT_LE(0, fd);
+  EXPECT_FALSE(is_readable(fd));
+
+  int entity = 0;
+  queue.enqueue({&entity, -1, ExecutorEventType::SUBSCRIPTION_EVENT, 1});
+  queue.enqueue({&entity, -1, ExecutorEventType::SUBSCRIPTION_EVENT, 1});
+  EXPECT_TRUE(is_readable(fd));
+
+  // Only cleared once all the events were dequeued.
+  ExecutorEvent event;
+  ASSERT_TRUE(queue.dequeue(event, 0ns));
+  EXPECT_TRUE(is_readable(fd));
+  ASSERT_TRUE(queue.dequeue(event, 0ns));
+  EXPECT_FALSE(is_readable(fd));
+  EXPECT_FALSE(queue.dequeue(event, 0ns));
+
+  queue.enqueue({&entity, -1, ExecutorEventType::SUBSCRIPTION_EVENT, 1});
+  EXPECT_TRUE(is_readable(fd));
+}
+
+TEST_F(TestEventsExecutor, external_event_loop)
+{
+  auto node = std::make_shared<rclcpp::Node>("node");
+  size_t callback_count = 0;
+  auto subscription = node->create_subscription<test_msgs::msg::Empty>(
+    "topic", rclcpp::QoS(10),
+    [&callback_count](test_msgs::msg::Empty::ConstSharedPtr) {callback_count++;});
+  auto publisher = node->create_publisher<test_msgs::msg::Empty>("topic", rclcpp::QoS(10));
+  bool timer_called = false;
+  auto timer = node->create_wall_timer(10ms, [&timer_called]() {timer_called = true;});
+
+  auto queue = std::make_unique<rclcpp::experimental::buffers::PollableEventsQueue>();
+  const int fd = queue->get_fd();
+  EventsExecutor executor(std::move(queue));
+  executor.add_node(node);
+  EXPECT_LE(executor.get_time_until_next_timer(), 10ms);
+
+  // Poll the file descriptor, until the next timer at most, then dispatch.
+  auto start = std::chrono::steady_clock::now();
+  while ((callback_count == 0u || !timer_called) && std::chrono::steady_clock::now() - start < 1s) {
+    publisher->publish(test_msgs::msg::Empty());
+    auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::max(executor.get_time_until_next_timer(), 0ns));
+    is_readable(fd, static_cast<int>(std::min(timeout, 100ms).count()));
+    executor.spin_some();
+  }
+  EXPECT_LE(1u, callback_count);
+  EXPECT_TRUE(timer_called);
+}
+#endif
+
+TEST_F(TestEventsExecutor, spin_some_subscription)
+{
+  auto node = std::make_shared<rclcpp::Node>("node");
+  size_t callback_count = 0;
+  auto subscription = node->create_subscription<test_msgs::msg::Empty>(
+    "topic", rclcpp::QoS(10),
+    [&callback_count](test_msgs::msg::Empty::ConstSharedPtr) {callback_count++;});
+  auto publisher = node->create_publisher<test_msgs::msg::Empty>("topic", rclcpp::QoS(10));
+
+  EventsExecutor executor;
+  executor.add_node(node);
+
+  auto start = std::chrono::steady_clock::now();
+  while (callback_count < 2u && std::chrono::steady_clock::now() - start < 1s) {
+    publisher->publish(test_msgs::msg::Empty());
+    std::this_thread::sleep_for(1ms);
+    executor.spin_some();
+  }
+  EXPECT_LE(2u, callback_count);
+
+  // Entities created after the node was added are picked up too.
+  bool timer_called = false;
+  auto timer = node->create_wall_timer(1ms, [&timer_called]() {timer_called = true;});
+  start = std::chrono::steady_clock::now();
+  while (!timer_called && std::chrono::steady_clock::now() - start < 1s) {
+    std::this_thread::sleep_for(1ms);
+    executor.spin_some();
+  }
+  EXPECT_TRUE(timer_called);
+}
+
+TEST_F(TestEventsExecutor, spin_with_timer_and_service)
+{
+  auto node = std::make_shared<rclcpp::Node>("node");
+
+  auto service = node->create_service<test_msgs::srv::Empty>(
+    "service",
+    [](
+      const test_msgs::srv::Empty::Request::SharedPtr,
+      test_msgs::srv::Empty::Response::SharedPtr) {});
+  auto client = node->create_client<test_msgs::srv::Empty>("service");
+
+  std::atomic<size_t> timer_count{0};
+  auto timer = node->create_wall_timer(1ms, [&timer_count]() {timer_count++;});
+
+  EventsExecutor executor;
+  executor.add_node(node);
+
+  std::thread spinner([&executor]() {executor.spin();});
+
+  auto future = client->async_send_request(std::make_shared<test_msgs::srv::Empty::Request>());
+  EXPECT_EQ(std::future_status::ready, future.wait_for(5s));
+
+  auto start = std::chrono::steady_clock::now();
+  while (timer_count.load() < 5u && std::chrono::steady_clock::now() - start < 1s) {
+    std::this_thread::sleep_for(1ms);
+  }
+  EXPECT_LE(5u, timer_count.load());
+
+  EXPECT_THROW(executor.spin(), std::runtime_error);
+
+  executor.cancel();
+  spinner.join();
+}
+
+TEST_F(TestEventsExecutor, spin_until_future_complete)
+{
+  auto node = std::make_shared<rclcpp::Node>("node");
+  std::promise<bool> promise;
+  bool promise_set = false;
+  auto timer = node->create_wall_timer(
+    1ms, [&promise, &promise_set]() {
+      if (!promise_set) {
+        promise.set_value(true);
+        promise_set = true;
+      }
+    });
+
+  EventsExecutor executor;
+  executor.add_node(node);
+  auto future = promise.get_future();
+  EXPECT_EQ(
+    rclcpp::FutureReturnCode::SUCCESS,
+    executor.spin_until_future_complete(future, 1s));
+  timer->cancel();
+}
+
+TEST_F(TestEventsExecutor, shutdown_stops_spin)
+{
+  auto node = std::make_shared<rclcpp::Node>("node");
+  EventsExecutor executor;
+  executor.add_node(node);
+
+  std::atomic_bool spin_exited{false};
+  std::thread spinner([&executor, &spin_exited]() {
+      executor.spin();
+      spin_exited = true;
+    });
+
+  std::this_thread::sleep_for(10ms);
+  rclcpp::shutdown();
+  spinner.join();
+  EXPECT_TRUE(spin_exited.load());
+}
@@ -0,0 +1,169 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/executors.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+
+// Only the allocations made by the thread counting them are counted.
+thread_local bool counting_allocations = false;
+std::atomic_size_t number_of_allocations{0};
+
+}  // namespace
+
+void *
+operator new(std::size_t size)
+{
+  if (counting_allocations) {
+    number_of_allocations++;
+  }
+  void * ptr = std::malloc(size == 0 ? 1 : size);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void *
+operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void
+operator delete(void * ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void
+operator delete[](void * ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void
+operator delete(void * ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void
+operator delete[](void * ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+/*
+   Executor doing what spin_some() does, but only counting the allocations made by rclcpp,
+   as the rmw implementation may allocate memory in rcl_wait().
+ */
+class CountingExecutor : public rclcpp::executors::SingleThreadedExecutor
+{
+public:
+  size_t
+  spin_some_and_count_allocations()
+  {
+    spinning.store(true);
+    const size_t start = number_of_allocations.load();
+
+    // Collecting the entities is done again in wait_for_work(), but not counted there.
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      counting_allocations = true;
+      memory_strategy_->clear_handles();
+      memory_strategy_->collect_entities(weak_groups_to_nodes_);
+      counting_allocations = false;
+    }
+
+    wait_for_work(0ns);
+
+    counting_allocations = true;
+    while (true) {
+      rclcpp::AnyExecutable any_exec;
+      if (!get_next_ready_executable(any_exec)) {
+        break;
+      }
+      execute_any_executable(any_exec);
+    }
+    counting_allocations = false;
+
+    spinning.store(false);
+    return number_of_allocations.load() - start;
+  }
+};
+
+class TestExecutorAllocations : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+};
+
+TEST_F(TestExecutorAllocations, counter_counts) {
+  const size_t start = number_of_allocations.load();
+  counting_allocations = true;
+  // Calling operator new directly, as new expressions may be optimized out.
+  void * ptr = ::operator new(sizeof(int));
+  counting_allocations = false;
+  ::operator delete(ptr);
+  EXPECT_EQ(start + 1, number_of_allocations.load());
+}
+
+TEST_F(TestExecutorAllocations, timers_steady_state) {
+  auto node = std::make_shared<rclcpp::Node>("test_executor_allocations");
+  size_t count = 0;
+  std::vector<rclcpp::TimerBase::SharedPtr> timers;
+  for (int i = 0; i < 3; ++i) {
+    timers.push_back(node->create_wall_timer(1ms, [&count]() {count++;}));
+  }
+
+  CountingExecutor executor;
+  executor.add_node(node);
+  // The first spin collects the entities and sizes the wait set.
+  executor.spin_some();
+  executor.spin_some();
+
+  const size_t count_before = count;
+  size_t allocations = 0;
+  auto start = std::chrono::steady_clock::now();
+  while (count < count_before + 20 && std::chrono::steady_clock::now() - start < 5s) {
+    allocations += executor.spin_some_and_count_allocations();
+    std::this_thread::sleep_for(1ms);
+  }
+  EXPECT_LE(count_before + 20, count);
+  EXPECT_EQ(0u, allocations);
+}
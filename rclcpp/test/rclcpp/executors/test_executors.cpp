@@ -20,12 +20,15 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <limits>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include "rcl/error_handling.h"
 #include "rcl/time.h"
@@ -35,6 +38,7 @@
 #include "rclcpp/guard_condition.hpp"
 #include "rclcpp/rclcpp.hpp"
 
+#include "test_msgs/msg/basic_types.hpp"
 #include "test_msgs/msg/empty.hpp"
 
 using namespace std::chrono_literals;
@@ -92,7 +96,9 @@ using ExecutorTypes =
   ::testing::Types<
   rclcpp::executors::SingleThreadedExecutor,
   rclcpp::executors::MultiThreadedExecutor,
-  rclcpp::executors::StaticSingleThreadedExecutor>;
+  rclcpp::executors::StaticSingleThreadedExecutor,
+  rclcpp::executors::StaticMultiThreadedExecutor,
+  rclcpp::executors::WorkStealingMultiThreadedExecutor>;
 
 class ExecutorTypeNames
 {
@@ -113,6 +119,14 @@ public:
       return "StaticSingleThreadedExecutor";
     }
 
+    if (std::is_same<T, rclcpp::executors::StaticMultiThreadedExecutor>()) {
+      return "StaticMultiThreadedExecutor";
+    }
+
+    if (std::is_same<T, rclcpp::executors::WorkStealingMultiThreadedExecutor>()) {
+      return "WorkStealingMultiThreadedExecutor";
+    }
+
     return "";
   }
 };
@@ -121,12 +135,13 @@ public:
 // is updated.
 TYPED_TEST_SUITE(TestExecutors, ExecutorTypes, ExecutorTypeNames);
 
-// StaticSingleThreadedExecutor is not included in these tests for now, due to:
+// The static executors are not included in these tests for now, due to:
 // https://github.com/ros2/rclcpp/issues/1219
 using StandardExecutors =
   ::testing::Types<
   rclcpp::executors::SingleThreadedExecutor,
-  rclcpp::executors::MultiThreadedExecutor>;
+  rclcpp::executors::MultiThreadedExecutor,
+  rclcpp::executors::WorkStealingMultiThreadedExecutor>;
 TYPED_TEST_SUITE(TestExecutorsStable, StandardExecutors, ExecutorTypeNames);
 
 // Make sure that executors detach from nodes when destructing
@@ -196,6 +211,38 @@ TYPED_TEST(TestExecutors, spinWithTimer) {
   executor.remove_node(this->node, true);
 }
 
+// Check that the entities of a disabled callback group aren't executed
+TYPED_TEST(TestExecutors, spinWithDisabledCallbackGroup) {
+  using ExecutorType = TypeParam;
+  ExecutorType executor;
+
+  auto group = this->node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+  EXPECT_TRUE(group->is_enabled());
+  EXPECT_TRUE(group->set_enabled(false));
+  EXPECT_FALSE(group->set_enabled(false));
+  EXPECT_FALSE(group->is_enabled());
+  std::atomic<size_t> timer_count{0};
+  auto timer = this->node->create_wall_timer(1ms, [&]() {timer_count++;}, group);
+  executor.add_node(this->node);
+
+  std::thread spinner([&]() {executor.spin();});
+
+  std::this_thread::sleep_for(50ms);
+  EXPECT_EQ(0u, timer_count.load());
+
+  EXPECT_TRUE(group->set_enabled(true));
+  this->node->get_node_base_interface()->get_notify_guard_condition().trigger();
+  auto start = std::chrono::steady_clock::now();
+  while (timer_count.load() == 0u && (std::chrono::steady_clock::now() - start) < 10s) {
+    std::this_thread::sleep_for(1ms);
+  }
+  EXPECT_LT(0u, timer_count.load());
+
+  executor.cancel();
+  spinner.join();
+  executor.remove_node(this->node, true);
+}
+
 TYPED_TEST(TestExecutors, spinWhileAlreadySpinning) {
   using ExecutorType = TypeParam;
   ExecutorType executor;
@@ -593,3 +640,121 @@ TEST(TestExecutors, testSpinUntilFutureCompleteNodePtr) {
 
   rclcpp::shutdown();
 }
+
+// Check that the intra-process subscriptions run right after the callbacks publishing to them
+TEST(TestExecutors, runIntraProcessConsumersInline) {
+  rclcpp::init(0, nullptr);
+
+  {
+    rclcpp::ExecutorOptions options;
+    options.run_intra_process_consumers_inline = true;
+    rclcpp::executors::SingleThreadedExecutor executor(options);
+    auto node = std::make_shared<rclcpp::Node>(
+      "node", rclcpp::NodeOptions().use_intra_process_comms(true));
+
+    int timer_count = 0;
+    int rectify_count = 0;
+    int detect_count = 0;
+    auto rectified_publisher = node->create_publisher<test_msgs::msg::Empty>("rectified", 10);
+    auto raw_publisher = node->create_publisher<test_msgs::msg::Empty>("raw", 10);
+    auto detect_subscription = node->create_subscription<test_msgs::msg::Empty>(
+      "rectified", 10,
+      [&detect_count](test_msgs::msg::Empty::ConstSharedPtr) {++detect_count;});
+    auto rectify_subscription = node->create_subscription<test_msgs::msg::Empty>(
+      "raw", 10,
+      [&rectify_count, &rectified_publisher](test_msgs::msg::Empty::ConstSharedPtr) {
+        ++rectify_count;
+        rectified_publisher->publish(test_msgs::msg::Empty());
+      });
+    auto timer = node->create_wall_timer(
+      1ms, [&timer_count, &raw_publisher]() {
+        ++timer_count;
+        raw_publisher->publish(test_msgs::msg::Empty());
+      });
+    executor.add_node(node);
+
+    const auto start = std::chrono::steady_clock::now();
+    while (timer_count == 0 && std::chrono::steady_clock::now() - start < 1s) {
+      executor.spin_once(10ms);
+    }
+    // The spin executing the timer also executed the pipeline it started
+    ASSERT_EQ(1, timer_count);
+    EXPECT_EQ(1, rectify_count);
+    EXPECT_EQ(1, detect_count);
+  }
+
+  rclcpp::shutdown();
+}
+
+// Check that no message is lost or executed twice when the threads of a multi-threaded executor
+// run chains of intra-process subscriptions inline, while the others wait for them
+TEST(TestExecutors, runIntraProcessConsumersInlineMultiThreaded) {
+  rclcpp::init(0, nullptr);
+
+  {
+    rclcpp::ExecutorOptions options;
+    options.run_intra_process_consumers_inline = true;
+    rclcpp::executors::MultiThreadedExecutor executor(options, 4);
+    auto node = std::make_shared<rclcpp::Node>(
+      "node", rclcpp::NodeOptions().use_intra_process_comms(true));
+
+    using test_msgs::msg::BasicTypes;
+    constexpr int32_t message_count = 100;
+    const auto qos = rclcpp::QoS(rclcpp::KeepAll());
+    auto make_options = [&node]() {
+        rclcpp::SubscriptionOptions subscription_options;
+        subscription_options.callback_group =
+          node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+        return subscription_options;
+      };
+
+    std::vector<int32_t> rectified;
+    std::vector<int32_t> detected;
+    std::atomic<int32_t> detect_count {0};
+    auto rectified_publisher = node->create_publisher<BasicTypes>("rectified", qos);
+    auto raw_publisher = node->create_publisher<BasicTypes>("raw", qos);
+    auto detect_subscription = node->create_subscription<BasicTypes>(
+      "rectified", qos,
+      [&detected, &detect_count](BasicTypes::ConstSharedPtr message) {
+        detected.push_back(message->int32_value);
+        ++detect_count;
+      },
+      make_options());
+    auto rectify_subscription = node->create_subscription<BasicTypes>(
+      "raw", qos,
+      [&rectified, &rectified_publisher](BasicTypes::ConstSharedPtr message) {
+        rectified.push_back(message->int32_value);
+        rectified_publisher->publish(*message);
+      },
+      make_options());
+    int32_t published = 0;
+    rclcpp::TimerBase::SharedPtr timer;
+    timer = node->create_wall_timer(
+      1ms, [&published, &raw_publisher, &timer]() {
+        BasicTypes message;
+        message.int32_value = published;
+        raw_publisher->publish(message);
+        if (++published == message_count) {
+          timer->cancel();
+        }
+      });
+    executor.add_node(node);
+
+    std::thread spinner([&executor]() {executor.spin();});
+    const auto start = std::chrono::steady_clock::now();
+    while (detect_count < message_count && std::chrono::steady_clock::now() - start < 10s) {
+      std::this_thread::sleep_for(1ms);
+    }
+    // Give a message executed twice the time to show up
+    std::this_thread::sleep_for(50ms);
+    executor.cancel();
+    spinner.join();
+
+    std::vector<int32_t> expected(message_count);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_EQ(expected, rectified);
+    EXPECT_EQ(expected, detected);
+  }
+
+  rclcpp::shutdown();
+}
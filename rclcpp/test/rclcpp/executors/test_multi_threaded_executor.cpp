@@ -14,9 +14,17 @@
 
 #include <gtest/gtest.h>
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include <atomic>
 #include <chrono>
+#include <mutex>
+#include <set>
 #include <string>
 #include <memory>
+#include <thread>
 
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/node.hpp"
@@ -97,3 +105,166 @@ TEST_F(TestMultiThreadedExecutor, timer_over_take) {
   executor.add_node(node);
   executor.spin();
 }
+
+/*
+   Test that the callback groups assigned to a thread are only executed by it.
+ */
+TEST_F(TestMultiThreadedExecutor, add_callback_group_to_thread) {
+  rclcpp::executors::MultiThreadedExecutor executor(rclcpp::ExecutorOptions(), 3u);
+
+  std::shared_ptr<rclcpp::Node> node =
+    std::make_shared<rclcpp::Node>("test_multi_threaded_executor_dedicated_thread");
+  auto node_base = node->get_node_base_interface();
+
+  auto dedicated_cbg = node->create_callback_group(
+    rclcpp::CallbackGroupType::MutuallyExclusive, false);
+  auto other_cbg = node->create_callback_group(
+    rclcpp::CallbackGroupType::MutuallyExclusive, false);
+
+  EXPECT_THROW(
+    executor.add_callback_group_to_thread(dedicated_cbg, node_base, 3u),
+    std::invalid_argument);
+
+  executor.add_callback_group_to_thread(dedicated_cbg, node_base, 0u);
+  executor.add_callback_group_to_thread(other_cbg, node_base, 1u);
+  // The last thread not dedicated to callback groups can't be assigned.
+  EXPECT_THROW(
+    executor.add_callback_group_to_thread(other_cbg, node_base, 2u),
+    std::invalid_argument);
+
+  std::mutex thread_ids_mutex;
+  std::set<std::thread::id> dedicated_thread_ids;
+  std::set<std::thread::id> other_thread_ids;
+  std::atomic_int dedicated_count{0};
+
+  auto dedicated_timer = node->create_wall_timer(
+    1ms, [&]() {
+      std::lock_guard<std::mutex> lock(thread_ids_mutex);
+      dedicated_thread_ids.insert(std::this_thread::get_id());
+      if (++dedicated_count > 10) {
+        executor.cancel();
+      }
+    }, dedicated_cbg);
+  auto other_timer = node->create_wall_timer(
+    1ms, [&]() {
+      std::lock_guard<std::mutex> lock(thread_ids_mutex);
+      other_thread_ids.insert(std::this_thread::get_id());
+    }, other_cbg);
+
+  executor.add_node(node);
+  executor.spin();
+
+  std::lock_guard<std::mutex> lock(thread_ids_mutex);
+  ASSERT_EQ(1u, dedicated_thread_ids.size());
+  ASSERT_EQ(1u, other_thread_ids.size());
+  EXPECT_NE(*dedicated_thread_ids.begin(), *other_thread_ids.begin());
+  EXPECT_NE(std::this_thread::get_id(), *dedicated_thread_ids.begin());
+}
+
+/*
+   Test that canceling stops the dedicated threads, even before they started spinning.
+ */
+TEST_F(TestMultiThreadedExecutor, cancel_dedicated_threads) {
+  rclcpp::executors::MultiThreadedExecutor executor(rclcpp::ExecutorOptions(), 3u);
+
+  std::shared_ptr<rclcpp::Node> node =
+    std::make_shared<rclcpp::Node>("test_multi_threaded_executor_cancel_dedicated_threads");
+  auto dedicated_cbg = node->create_callback_group(
+    rclcpp::CallbackGroupType::MutuallyExclusive, false);
+  executor.add_callback_group_to_thread(dedicated_cbg, node->get_node_base_interface(), 0u);
+  executor.add_node(node);
+
+  for (int i = 0; i < 20; ++i) {
+    std::thread spinner([&executor]() {executor.spin();});
+    while (!executor.is_spinning()) {
+      std::this_thread::yield();
+    }
+    executor.cancel();
+    spinner.join();
+  }
+}
+
+/*
+   Test that the thread attributes are applied to the threads of the pool.
+ */
+TEST_F(TestMultiThreadedExecutor, thread_attributes) {
+#ifdef __linux__
+  rclcpp::ExecutorOptions options;
+  rclcpp::ThreadAttributes attributes;
+  attributes.cpu_affinity = {0u};
+  options.thread_attributes = {attributes, attributes};
+  rclcpp::executors::MultiThreadedExecutor executor(options, 2u);
+
+  std::shared_ptr<rclcpp::Node> node =
+    std::make_shared<rclcpp::Node>("test_multi_threaded_executor_thread_attributes");
+
+  std::atomic_bool pinned{true};
+  std::atomic_int timer_count{0};
+  auto timer = node->create_wall_timer(
+    1ms, [&]() {
+      if (sched_getcpu() != 0) {
+        pinned = false;
+      }
+      if (++timer_count > 5) {
+        executor.cancel();
+      }
+    });
+
+  executor.add_node(node);
+  executor.spin();
+  EXPECT_TRUE(pinned.load());
+#endif
+}
+
+/*
+   Test that an elastic pool grows while its threads are blocked, and shrinks back when idle.
+ */
+TEST_F(TestMultiThreadedExecutor, elastic_thread_pool) {
+  rclcpp::ExecutorOptions options;
+  options.statistics = std::make_shared<rclcpp::ExecutorStatistics>();
+  rclcpp::executors::MultiThreadedExecutor executor(options, 2u);
+  EXPECT_THROW(executor.set_elastic_thread_pool(1u), std::invalid_argument);
+  EXPECT_THROW(executor.set_elastic_thread_pool(4u, 0ms), std::invalid_argument);
+  executor.set_elastic_thread_pool(4u, 10ms, 100ms);
+
+  std::shared_ptr<rclcpp::Node> node =
+    std::make_shared<rclcpp::Node>("test_multi_threaded_executor_elastic_thread_pool");
+  auto callback_group = node->create_callback_group(rclcpp::CallbackGroupType::Reentrant);
+
+  std::atomic_bool blocked{true};
+  std::mutex thread_ids_mutex;
+  std::set<std::thread::id> thread_ids;
+  auto timer = node->create_wall_timer(
+    1ms, [&]() {
+      {
+        std::lock_guard<std::mutex> lock(thread_ids_mutex);
+        thread_ids.insert(std::this_thread::get_id());
+      }
+      while (blocked.load()) {
+        std::this_thread::sleep_for(1ms);
+      }
+    }, callback_group);
+
+  executor.add_node(node);
+  std::thread spinner([&executor]() {executor.spin();});
+
+  auto wait_for_pool_size = [&options](size_t size) {
+      const auto start = std::chrono::steady_clock::now();
+      while (options.statistics->get_thread_pool_size() != size &&
+        std::chrono::steady_clock::now() - start < 10s)
+      {
+        std::this_thread::sleep_for(1ms);
+      }
+      return options.statistics->get_thread_pool_size();
+    };
+  EXPECT_EQ(4u, wait_for_pool_size(4u));
+  timer->cancel();
+  blocked = false;
+  EXPECT_EQ(2u, wait_for_pool_size(2u));
+  EXPECT_EQ(2u, options.statistics->take_loop_statistics().thread_pool_size);
+
+  executor.cancel();
+  spinner.join();
+  EXPECT_EQ(0u, options.statistics->get_thread_pool_size());
+  EXPECT_EQ(4u, thread_ids.size());
+}
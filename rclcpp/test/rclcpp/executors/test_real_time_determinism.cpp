@@ -0,0 +1,297 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#ifdef __linux__
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#endif
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+#include "rclcpp/executors.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/strategies/message_pool_memory_strategy.hpp"
+
+#include "test_msgs/msg/basic_types.hpp"
+
+using namespace std::chrono_literals;
+
+using MessageT = test_msgs::msg::BasicTypes;
+using MessagePoolMemoryStrategy =
+  rclcpp::strategies::message_pool_memory_strategy::MessagePoolMemoryStrategy<MessageT, 1>;
+
+namespace
+{
+
+// Only the allocations made by the thread counting them are counted.
+thread_local bool counting_allocations = false;
+std::atomic_size_t number_of_allocations{0};
+
+constexpr size_t kWarmUpIterations = 100u;
+constexpr size_t kMeasuredIterations = 500u;
+
+}  // namespace
+
+void *
+operator new(std::size_t size)
+{
+  if (counting_allocations) {
+    number_of_allocations++;
+  }
+  void * ptr = std::malloc(size == 0 ? 1 : size);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void *
+operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void
+operator delete(void * ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void
+operator delete[](void * ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void
+operator delete(void * ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void
+operator delete[](void * ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+/*
+   Executor doing what spin_once() does, but only counting the allocations made by rclcpp,
+   as the rmw implementation may allocate memory in rcl_wait() and when publishing.
+ */
+class CountingExecutor : public rclcpp::executors::SingleThreadedExecutor
+{
+public:
+  size_t
+  spin_and_count_allocations(std::chrono::nanoseconds timeout)
+  {
+    spinning.store(true);
+    const size_t start = number_of_allocations.load();
+
+    // Collecting the entities is done again in wait_for_work(), but not counted there.
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      counting_allocations = true;
+      memory_strategy_->clear_handles();
+      memory_strategy_->collect_entities(weak_groups_to_nodes_);
+      counting_allocations = false;
+    }
+
+    wait_for_work(timeout);
+
+    counting_allocations = true;
+    while (true) {
+      rclcpp::AnyExecutable any_exec;
+      if (!get_next_ready_executable(any_exec)) {
+        break;
+      }
+      execute_any_executable(any_exec);
+    }
+    counting_allocations = false;
+
+    spinning.store(false);
+    return number_of_allocations.load() - start;
+  }
+};
+
+#ifdef __linux__
+
+struct ThreadCounters
+{
+  long minor_page_faults;  // NOLINT(runtime/int)
+  long major_page_faults;  // NOLINT(runtime/int)
+  long involuntary_context_switches;  // NOLINT(runtime/int)
+};
+
+ThreadCounters
+get_thread_counters()
+{
+  struct rusage usage;
+  if (getrusage(RUSAGE_THREAD, &usage) != 0) {
+    throw std::runtime_error(std::string("getrusage() failed: ") + std::strerror(errno));
+  }
+  return {usage.ru_minflt, usage.ru_majflt, usage.ru_nivcsw};
+}
+
+/*
+   The configuration of a real-time deployment: the memory of the process is locked, the
+   heap is never given back to the system, and the spinning thread is scheduled with
+   SCHED_FIFO while it's measured, so that the threads of the middleware aren't.
+   This needs privileges, which are often missing when testing, so the test which needs
+   them is skipped without them.
+ */
+class TestRealTimeDeterminism : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+#ifdef __GLIBC__
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+#endif
+    memory_locked = mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+  }
+
+  static void TearDownTestCase()
+  {
+    if (memory_locked) {
+      munlockall();
+    }
+    rclcpp::shutdown();
+  }
+
+  void SetUp() override
+  {
+    node = std::make_shared<rclcpp::Node>("test_real_time_determinism");
+    // A fixed size message, published by a timer to a subscription taking it from a pool
+    publisher = node->create_publisher<MessageT>("real_time_topic", rclcpp::QoS(1));
+    subscription = node->create_subscription<MessageT>(
+      "real_time_topic", rclcpp::QoS(1),
+      [this](MessageT::ConstSharedPtr message) {
+        received_value += message->int64_value;
+      },
+      rclcpp::SubscriptionOptions(), std::make_shared<MessagePoolMemoryStrategy>());
+    timer = node->create_wall_timer(
+      1ms, [this]() {
+        message.int64_value = 1;
+        publisher->publish(message);
+        timer_count++;
+      });
+    executor.add_node(node);
+
+    // The stack which may be used by the iterations is faulted in before they start
+    volatile char stack[256 * 1024];
+    std::memset(const_cast<char *>(stack), 0, sizeof(stack));
+  }
+
+  void TearDown() override
+  {
+    executor.remove_node(node);
+    timer.reset();
+    subscription.reset();
+    publisher.reset();
+    node.reset();
+  }
+
+  /// Spin until the timer was called and its message received, returning the allocations.
+  size_t
+  spin_iterations(size_t number_of_iterations)
+  {
+    size_t allocations = 0u;
+    const auto start = std::chrono::steady_clock::now();
+    const size_t target_count = timer_count + number_of_iterations;
+    while (timer_count < target_count && std::chrono::steady_clock::now() - start < 10s) {
+      allocations += executor.spin_and_count_allocations(10ms);
+    }
+    EXPECT_LE(target_count, timer_count);
+    return allocations;
+  }
+
+  /// Schedule the calling thread with SCHED_FIFO, returning false if it isn't permitted.
+  bool
+  begin_real_time_scheduling()
+  {
+    pthread_getschedparam(pthread_self(), &original_policy, &original_param);
+    struct sched_param param;
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 1;
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+  }
+
+  void
+  end_real_time_scheduling()
+  {
+    pthread_setschedparam(pthread_self(), original_policy, &original_param);
+  }
+
+  static bool memory_locked;
+
+  rclcpp::Node::SharedPtr node;
+  rclcpp::Publisher<MessageT>::SharedPtr publisher;
+  rclcpp::Subscription<MessageT>::SharedPtr subscription;
+  rclcpp::TimerBase::SharedPtr timer;
+  CountingExecutor executor;
+  MessageT message;
+  size_t timer_count = 0u;
+  int64_t received_value = 0;
+  int original_policy = SCHED_OTHER;
+  struct sched_param original_param = {};
+};
+
+bool TestRealTimeDeterminism::memory_locked = false;
+
+TEST_F(TestRealTimeDeterminism, no_allocations_in_steady_state) {
+  spin_iterations(kWarmUpIterations);
+
+  const int64_t received_before = received_value;
+  const size_t allocations = spin_iterations(kMeasuredIterations);
+  EXPECT_LT(received_before, received_value);
+  EXPECT_EQ(0u, allocations) << allocations << " allocations in " << kMeasuredIterations <<
+    " iterations of the timer";
+}
+
+TEST_F(TestRealTimeDeterminism, no_page_faults_nor_preemptions_in_steady_state) {
+  if (!memory_locked) {
+    GTEST_SKIP() << "mlockall() isn't permitted";
+  }
+  if (!begin_real_time_scheduling()) {
+    GTEST_SKIP() << "SCHED_FIFO isn't permitted";
+  }
+  spin_iterations(kWarmUpIterations);
+
+  const ThreadCounters before = get_thread_counters();
+  spin_iterations(kMeasuredIterations);
+  const ThreadCounters after = get_thread_counters();
+  end_real_time_scheduling();
+  EXPECT_EQ(0, after.minor_page_faults - before.minor_page_faults);
+  EXPECT_EQ(0, after.major_page_faults - before.major_page_faults);
+  EXPECT_EQ(0, after.involuntary_context_switches - before.involuntary_context_switches);
+}
+
+#endif  // __linux__
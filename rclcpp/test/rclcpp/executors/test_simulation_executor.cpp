@@ -0,0 +1,110 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "rcl/time.h"
+
+#include "rclcpp/executors/simulation_executor.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+using namespace std::chrono_literals;
+
+class TestSimulationExecutor : public ::testing::Test
+{
+public:
+  void SetUp()
+  {
+    rclcpp::init(0, nullptr);
+    node = std::make_shared<rclcpp::Node>("node", "ns");
+    clock = std::make_shared<rclcpp::Clock>(RCL_ROS_TIME);
+    ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(clock->get_clock_handle()));
+  }
+
+  void TearDown()
+  {
+    clock.reset();
+    node.reset();
+    rclcpp::shutdown();
+  }
+
+protected:
+  void set_time(std::chrono::nanoseconds time)
+  {
+    ASSERT_EQ(
+      RCL_RET_OK, rcl_set_ros_time_override(clock->get_clock_handle(), time.count()));
+  }
+
+  rclcpp::Node::SharedPtr node;
+  rclcpp::Clock::SharedPtr clock;
+};
+
+TEST_F(TestSimulationExecutor, null_clock) {
+  EXPECT_THROW(rclcpp::executors::SimulationExecutor(nullptr), std::invalid_argument);
+}
+
+TEST_F(TestSimulationExecutor, spin_until_idle) {
+  rclcpp::executors::SimulationExecutor executor(clock);
+  size_t timer_count = 0u;
+  auto timer = rclcpp::create_timer(node, clock, 100ms, [&timer_count]() {timer_count++;});
+  executor.add_node(node);
+
+  EXPECT_EQ(rclcpp::Time(0, 0, RCL_ROS_TIME), executor.spin_until_idle());
+  EXPECT_EQ(0u, timer_count);
+
+  set_time(100ms);
+  EXPECT_EQ(rclcpp::Time(0, 100000000, RCL_ROS_TIME), executor.spin_until_idle());
+  EXPECT_EQ(1u, timer_count);
+
+  set_time(150ms);
+  executor.spin_until_idle();
+  EXPECT_EQ(1u, timer_count);
+
+  set_time(200ms);
+  executor.spin_until_idle();
+  EXPECT_EQ(2u, timer_count);
+}
+
+TEST_F(TestSimulationExecutor, spin_in_lockstep) {
+  rclcpp::executors::SimulationExecutor executor(clock);
+  size_t timer_count = 0u;
+  auto timer = rclcpp::create_timer(node, clock, 100ms, [&timer_count]() {timer_count++;});
+  executor.add_node(node);
+
+  // The simulation advances as soon as the executor is idle, much faster than the wall clock
+  std::vector<int64_t> idle_times;
+  executor.set_idle_callback(
+    [&](const rclcpp::Time & time) {
+      idle_times.push_back(time.nanoseconds());
+      if (time.nanoseconds() >= RCUTILS_S_TO_NS(100)) {
+        executor.cancel();
+        return;
+      }
+      set_time(std::chrono::nanoseconds(time.nanoseconds()) + 100ms);
+    });
+  const auto start = std::chrono::steady_clock::now();
+  executor.spin();
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 100s);
+
+  EXPECT_EQ(1000u, timer_count);
+  ASSERT_EQ(1001u, idle_times.size());
+  for (size_t i = 0; i < idle_times.size(); ++i) {
+    EXPECT_EQ(static_cast<int64_t>(i) * RCUTILS_MS_TO_NS(100), idle_times[i]);
+  }
+}
@@ -0,0 +1,108 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/executors.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+using namespace std::chrono_literals;
+
+class TestStaticMultiThreadedExecutor : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+};
+
+TEST_F(TestStaticMultiThreadedExecutor, number_of_threads) {
+  rclcpp::executors::StaticMultiThreadedExecutor executor(rclcpp::ExecutorOptions(), 3u);
+  EXPECT_EQ(3u, executor.get_number_of_threads());
+
+  rclcpp::executors::StaticMultiThreadedExecutor default_executor;
+  EXPECT_LE(2u, default_executor.get_number_of_threads());
+}
+
+/*
+   Test that callbacks of a mutually exclusive group never run concurrently,
+   while the ones of a reentrant group do.
+ */
+TEST_F(TestStaticMultiThreadedExecutor, callback_group_semantics) {
+  rclcpp::executors::StaticMultiThreadedExecutor executor(rclcpp::ExecutorOptions(), 4u);
+  auto node = std::make_shared<rclcpp::Node>("test_static_multi_threaded_callback_groups");
+
+  auto exclusive_group = node->create_callback_group(
+    rclcpp::CallbackGroupType::MutuallyExclusive);
+  auto reentrant_group = node->create_callback_group(rclcpp::CallbackGroupType::Reentrant);
+
+  std::atomic_int exclusive_running{0};
+  std::atomic_int exclusive_max_running{0};
+  std::atomic_int reentrant_running{0};
+  std::atomic_int reentrant_max_running{0};
+  std::atomic_int exclusive_count{0};
+
+  auto make_callback = [](std::atomic_int & running, std::atomic_int & max_running) {
+      return [&running, &max_running]() {
+               int now_running = ++running;
+               int previous_max = max_running.load();
+               while (now_running > previous_max &&
+                 !max_running.compare_exchange_weak(previous_max, now_running))
+               {
+               }
+               std::this_thread::sleep_for(5ms);
+               --running;
+             };
+    };
+
+  std::vector<rclcpp::TimerBase::SharedPtr> timers;
+  for (int i = 0; i < 3; ++i) {
+    auto exclusive_callback = make_callback(exclusive_running, exclusive_max_running);
+    timers.push_back(
+      node->create_wall_timer(
+        1ms, [exclusive_callback, &exclusive_count]() {
+          exclusive_callback();
+          exclusive_count++;
+        }, exclusive_group));
+    timers.push_back(
+      node->create_wall_timer(
+        1ms, make_callback(reentrant_running, reentrant_max_running), reentrant_group));
+  }
+
+  executor.add_node(node);
+  std::thread spinner([&executor]() {executor.spin();});
+
+  auto start = std::chrono::steady_clock::now();
+  while (exclusive_count.load() < 20 && std::chrono::steady_clock::now() - start < 5s) {
+    std::this_thread::sleep_for(1ms);
+  }
+  executor.cancel();
+  spinner.join();
+
+  EXPECT_LE(20, exclusive_count.load());
+  EXPECT_EQ(1, exclusive_max_running.load());
+  EXPECT_LT(1, reentrant_max_running.load());
+}
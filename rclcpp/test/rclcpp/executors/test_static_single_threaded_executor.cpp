@@ -14,10 +14,12 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <chrono>
 #include <future>
 #include <memory>
 #include <stdexcept>
+#include <thread>
 
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/node.hpp"
@@ -140,3 +142,24 @@ TEST_F(TestStaticSingleThreadedExecutor, execute_service) {
   executor.remove_node(node);
   executor.spin_until_future_complete(future, std::chrono::milliseconds(1));
 }
+
+TEST_F(TestStaticSingleThreadedExecutor, spin_busy_polling) {
+  rclcpp::ExecutorOptions options;
+  options.busy_polling_duration = 10ms;
+  rclcpp::executors::StaticSingleThreadedExecutor executor(options);
+  auto node = std::make_shared<rclcpp::Node>("node", "ns");
+
+  // The executor blocks again between the timer calls, and is woken up by the next one
+  std::atomic<size_t> timer_count{0};
+  auto timer = node->create_wall_timer(50ms, [&timer_count]() {timer_count++;});
+  executor.add_node(node);
+
+  std::thread spinner([&executor]() {executor.spin();});
+  const auto start = std::chrono::steady_clock::now();
+  while (timer_count.load() < 3u && std::chrono::steady_clock::now() - start < 10s) {
+    std::this_thread::sleep_for(1ms);
+  }
+  executor.cancel();
+  spinner.join();
+  EXPECT_GE(timer_count.load(), 3u);
+}
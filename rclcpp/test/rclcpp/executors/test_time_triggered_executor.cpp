@@ -0,0 +1,134 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "rclcpp/executors.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+using namespace std::chrono_literals;
+
+using rclcpp::executors::TimeTriggeredExecutor;
+
+class TestTimeTriggeredExecutor : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+};
+
+TEST_F(TestTimeTriggeredExecutor, invalid_schedule) {
+  EXPECT_THROW(TimeTriggeredExecutor(0ns), std::invalid_argument);
+
+  TimeTriggeredExecutor executor(10ms);
+  auto node = std::make_shared<rclcpp::Node>("test_time_triggered_invalid_schedule");
+  auto group = node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+  EXPECT_THROW(executor.add_slot(nullptr, 0ms), std::invalid_argument);
+  EXPECT_THROW(executor.add_slot(group, -1ms), std::invalid_argument);
+  EXPECT_THROW(executor.add_slot(group, 10ms), std::invalid_argument);
+  EXPECT_NO_THROW(executor.add_slot(group, 9ms));
+}
+
+/*
+   Test that the groups are executed in the order of their slots, and only them.
+ */
+TEST_F(TestTimeTriggeredExecutor, slots_order) {
+  TimeTriggeredExecutor executor(20ms);
+  auto node = std::make_shared<rclcpp::Node>("test_time_triggered_slots_order");
+  std::vector<std::string> calls;
+  auto create_group_with_timer = [&](const std::string & name) {
+      auto group = node->create_callback_group(
+        rclcpp::CallbackGroupType::MutuallyExclusive);
+      auto timer = node->create_wall_timer(
+        1ns, [&calls, name]() {calls.push_back(name);}, group);
+      return std::make_pair(group, timer);
+    };
+  auto first = create_group_with_timer("first");
+  auto second = create_group_with_timer("second");
+  auto unscheduled = create_group_with_timer("unscheduled");
+  executor.add_node(node);
+  executor.add_slot(second.first, 10ms);
+  executor.add_slot(first.first, 0ms);
+
+  const auto start = std::chrono::steady_clock::now();
+  executor.spin_cycles(3u);
+  EXPECT_GE(std::chrono::steady_clock::now() - start, 50ms);
+
+  const std::vector<std::string> expected_calls =
+  {"first", "second", "first", "second", "first", "second"};
+  EXPECT_EQ(expected_calls, calls);
+  EXPECT_EQ(0u, executor.get_number_of_overruns());
+}
+
+/*
+   Test that a slot executing past the next one is reported as an overrun.
+ */
+TEST_F(TestTimeTriggeredExecutor, overrun) {
+  TimeTriggeredExecutor executor(20ms);
+  auto node = std::make_shared<rclcpp::Node>("test_time_triggered_overrun");
+  auto slow_group = node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+  auto fast_group = node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+  auto slow_timer = node->create_wall_timer(
+    1ns, []() {std::this_thread::sleep_for(15ms);}, slow_group);
+  int fast_count = 0;
+  auto fast_timer = node->create_wall_timer(1ns, [&fast_count]() {++fast_count;}, fast_group);
+  executor.add_node(node);
+  executor.add_slot(slow_group, 0ms);
+  executor.add_slot(fast_group, 5ms);
+
+  std::vector<TimeTriggeredExecutor::Overrun> overruns;
+  executor.set_overrun_callback(
+    [&overruns](const TimeTriggeredExecutor::Overrun & overrun) {
+      overruns.push_back(overrun);
+    });
+  executor.spin_cycles(2u);
+
+  EXPECT_EQ(2, fast_count);
+  ASSERT_EQ(2u, overruns.size());
+  EXPECT_EQ(2u, executor.get_number_of_overruns());
+  for (uint64_t cycle = 0u; cycle < overruns.size(); ++cycle) {
+    EXPECT_EQ(0u, overruns[cycle].slot);
+    EXPECT_EQ(cycle, overruns[cycle].cycle);
+    EXPECT_GE(overruns[cycle].lateness, 10ms);
+  }
+}
+
+TEST_F(TestTimeTriggeredExecutor, cancel) {
+  TimeTriggeredExecutor executor(5ms);
+  auto node = std::make_shared<rclcpp::Node>("test_time_triggered_cancel");
+  auto group = node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+  auto timer = node->create_wall_timer(1ns, [&executor]() {executor.cancel();}, group);
+  executor.add_node(node);
+  executor.add_slot(group, 0ms);
+
+  executor.spin();
+  EXPECT_FALSE(executor.is_spinning());
+}
@@ -0,0 +1,91 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "rclcpp/node_interfaces/detail/parameter_name_index.hpp"
+
+using rclcpp::node_interfaces::detail::ParameterNameIndex;
+
+namespace
+{
+
+std::vector<std::string>
+sorted(std::vector<std::string> names)
+{
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+}  // namespace
+
+TEST(TestParameterNameIndex, collect) {
+  ParameterNameIndex index;
+  for (const std::string name : {"a", "a.b", "a.b.c", "a.d", "b", "", ".e", "a."}) {
+    index.insert(name);
+  }
+  index.insert("a.b");
+
+  std::vector<std::string> names;
+  index.collect(ParameterNameIndex::unlimited_segments, names);
+  EXPECT_EQ(
+    (std::vector<std::string>{"", ".e", "a", "a.", "a.b", "a.b.c", "a.d", "b"}), sorted(names));
+
+  names.clear();
+  index.collect(1, names);
+  EXPECT_EQ((std::vector<std::string>{"", "a", "b"}), sorted(names));
+
+  names.clear();
+  index.collect("a", 0, 1, names);
+  EXPECT_EQ((std::vector<std::string>{"a", "a.", "a.b", "a.d"}), sorted(names));
+
+  names.clear();
+  index.collect("a.b", 1, ParameterNameIndex::unlimited_segments, names);
+  EXPECT_EQ((std::vector<std::string>{"a.b.c"}), names);
+
+  names.clear();
+  index.collect("", 0, ParameterNameIndex::unlimited_segments, names);
+  EXPECT_EQ((std::vector<std::string>{"", ".e"}), sorted(names));
+
+  names.clear();
+  index.collect("c", 0, ParameterNameIndex::unlimited_segments, names);
+  EXPECT_TRUE(names.empty());
+}
+
+TEST(TestParameterNameIndex, erase) {
+  ParameterNameIndex index;
+  index.insert("a.b.c");
+  index.insert("a.b");
+
+  // Only the name is removed, not the ones it prefixes.
+  index.erase("a.b");
+  index.erase("a.x");
+  index.erase("a");
+  std::vector<std::string> names;
+  index.collect(ParameterNameIndex::unlimited_segments, names);
+  EXPECT_EQ((std::vector<std::string>{"a.b.c"}), names);
+
+  index.erase("a.b.c");
+  names.clear();
+  index.collect(ParameterNameIndex::unlimited_segments, names);
+  EXPECT_TRUE(names.empty());
+
+  index.insert("a.b");
+  index.collect("a", 1, 1, names);
+  EXPECT_EQ((std::vector<std::string>{"a.b"}), names);
+}
@@ -14,10 +14,14 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "rcl/node_options.h"
+#include "rclcpp/detail/resolved_name_cache.hpp"
 #include "rclcpp/node.hpp"
 #include "rclcpp/node_interfaces/node_base.hpp"
 #include "rclcpp/rclcpp.hpp"
@@ -191,3 +195,98 @@ TEST_F(TestNodeBase, construct_destruct_rcl_guard_condition_fini_error) {
 
   EXPECT_NO_THROW(std::make_shared<rclcpp::Node>("node", "ns").reset());
 }
+
+TEST_F(TestNodeBase, batch_modification) {
+  auto node = std::make_shared<rclcpp::Node>("node", "ns");
+  auto node_base = node->get_node_base_interface();
+  size_t node_triggers = 0u;
+  node_base->get_notify_guard_condition().set_on_trigger_callback(
+    [&node_triggers](size_t count) {node_triggers += count;});
+  auto group = node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+  auto gc = group->get_notify_guard_condition(node->get_node_base_interface()->get_context());
+  size_t group_triggers = 0u;
+  gc->set_on_trigger_callback([&group_triggers](size_t count) {group_triggers += count;});
+  // The callbacks are called for the triggers which happened before they were set
+  node_triggers = 0u;
+  group_triggers = 0u;
+
+  std::vector<rclcpp::TimerBase::SharedPtr> timers;
+  {
+    rclcpp::node_interfaces::BatchModification batch(node_base);
+    {
+      // Nested batches only notify at the end of the outermost one
+      rclcpp::node_interfaces::BatchModification nested_batch(node_base);
+      for (size_t i = 0u; i < 10u; ++i) {
+        timers.push_back(node->create_wall_timer(std::chrono::seconds(1), []() {}, group));
+      }
+    }
+    timers.push_back(node->create_wall_timer(std::chrono::seconds(1), []() {}));
+    EXPECT_EQ(0u, node_triggers);
+    EXPECT_EQ(0u, group_triggers);
+  }
+  EXPECT_EQ(1u, node_triggers);
+  EXPECT_EQ(1u, group_triggers);
+
+  // Without a batch, each entity notifies the executors
+  timers.push_back(node->create_wall_timer(std::chrono::seconds(1), []() {}, group));
+  timers.push_back(node->create_wall_timer(std::chrono::seconds(1), []() {}, group));
+  EXPECT_EQ(3u, node_triggers);
+  EXPECT_EQ(3u, group_triggers);
+
+  // A batch without changes doesn't notify
+  {
+    rclcpp::node_interfaces::BatchModification batch(node_base);
+  }
+  EXPECT_EQ(3u, node_triggers);
+
+  EXPECT_THROW(node_base->end_batch_modification(), std::runtime_error);
+  EXPECT_THROW(rclcpp::node_interfaces::BatchModification(nullptr), std::invalid_argument);
+}
+
+TEST_F(TestNodeBase, resolve_topic_or_service_name) {
+  auto node = std::make_shared<rclcpp::Node>(
+    "node", "ns", rclcpp::NodeOptions().arguments({"--ros-args", "-r", "foo:=bar"}));
+  auto node_base = node->get_node_base_interface();
+
+  // The cached names don't depend on the flags of other calls
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ("/ns/bar", node_base->resolve_topic_or_service_name("foo", false));
+    EXPECT_EQ("/ns/foo", node_base->resolve_topic_or_service_name("foo", false, true));
+    EXPECT_EQ("/ns/bar", node_base->resolve_topic_or_service_name("foo", true));
+    EXPECT_EQ("/ns/foo", node_base->resolve_topic_or_service_name("foo", true, true));
+    EXPECT_EQ("/ns/node/baz", node_base->resolve_topic_or_service_name("~/baz", false));
+    EXPECT_THROW(
+      node_base->resolve_topic_or_service_name("invalid topic", false),
+      rclcpp::exceptions::RCLError);
+  }
+  EXPECT_EQ("/ns/bar", node->get_node_topics_interface()->resolve_topic_name("foo"));
+}
+
+TEST(TestResolvedNameCache, get) {
+  rclcpp::detail::ResolvedNameCache cache(2u);
+  size_t number_of_resolutions = 0u;
+  auto resolve = [&number_of_resolutions](const std::string & name) {
+      return [&number_of_resolutions, name]() {
+               ++number_of_resolutions;
+               return "/" + name;
+             };
+    };
+  EXPECT_EQ("/a", cache.get("a", 0, resolve("a")));
+  EXPECT_EQ("/a", cache.get("a", 0, resolve("a")));
+  EXPECT_EQ(1u, number_of_resolutions);
+  EXPECT_EQ("/a", cache.get("a", 1, resolve("a")));
+  EXPECT_EQ(2u, number_of_resolutions);
+  EXPECT_EQ(2u, cache.size());
+
+  // The names failing to resolve aren't cached
+  EXPECT_THROW(
+    cache.get("b", 0, []() -> std::string {throw std::runtime_error("invalid name");}),
+    std::runtime_error);
+  EXPECT_EQ(2u, cache.size());
+
+  // A full cache is cleared
+  EXPECT_EQ("/b", cache.get("b", 0, resolve("b")));
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ("/a", cache.get("a", 0, resolve("a")));
+  EXPECT_EQ(4u, number_of_resolutions);
+}
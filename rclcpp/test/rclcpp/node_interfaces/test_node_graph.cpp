@@ -17,6 +17,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -695,3 +696,121 @@ TEST_F(TestNodeGraph, get_info_by_topic_endpoint_info_array_fini_error)
     node_graph()->get_publishers_info_by_topic("topic", false),
     rclcpp::exceptions::RCLError);
 }
+
+TEST_F(TestNodeGraph, get_endpoints_info_by_topics)
+{
+  auto publisher = node()->create_publisher<test_msgs::msg::Empty>("topic", 1);
+  auto other_publisher = node()->create_publisher<test_msgs::msg::Empty>("other_topic", 1);
+  auto subscription = node()->create_subscription<test_msgs::msg::Empty>(
+    "other_topic", 10, [](test_msgs::msg::Empty::ConstSharedPtr) {});
+
+  const std::vector<std::string> topic_names{"topic", "other_topic", "no_topic"};
+  std::vector<rclcpp::TopicEndpointsInfo> endpoints_info;
+  get_num_graph_things(
+    [this, &topic_names, &endpoints_info]() -> size_t {
+      node_graph()->get_endpoints_info_by_topics(topic_names, endpoints_info);
+      return endpoints_info[0].publishers.size() + endpoints_info[1].publishers.size() +
+             endpoints_info[1].subscriptions.size() == 3u;
+    });
+  ASSERT_EQ(3u, endpoints_info.size());
+  ASSERT_EQ(1u, endpoints_info[0].publishers.size());
+  ASSERT_EQ(1u, endpoints_info[1].publishers.size());
+  ASSERT_EQ(1u, endpoints_info[1].subscriptions.size());
+  EXPECT_EQ(0u, endpoints_info[0].subscriptions.size());
+  EXPECT_EQ(0u, endpoints_info[2].publishers.size());
+  EXPECT_EQ(0u, endpoints_info[2].subscriptions.size());
+  EXPECT_EQ("test_msgs/msg/Empty", endpoints_info[1].subscriptions[0].topic_type());
+  EXPECT_EQ(
+    rclcpp::EndpointType::Subscription, endpoints_info[1].subscriptions[0].endpoint_type());
+
+  // The same as the queries of a single topic
+  auto publishers = node_graph()->get_publishers_info_by_topic("topic");
+  ASSERT_EQ(1u, publishers.size());
+  EXPECT_EQ(publishers[0].endpoint_gid(), endpoints_info[0].publishers[0].endpoint_gid());
+  EXPECT_EQ(publishers[0].node_name(), endpoints_info[0].publishers[0].node_name());
+  EXPECT_EQ(publishers[0].node_namespace(), endpoints_info[0].publishers[0].node_namespace());
+
+  // The storage is reused, and the endpoints which went away are removed.
+  const rclcpp::TopicEndpointInfo * reused_info = &endpoints_info[0].publishers[0];
+  other_publisher.reset();
+  get_num_graph_things(
+    [this, &topic_names, &endpoints_info]() -> size_t {
+      node_graph()->get_endpoints_info_by_topics(topic_names, endpoints_info);
+      return endpoints_info[1].publishers.empty();
+    });
+  EXPECT_EQ(0u, endpoints_info[1].publishers.size());
+  ASSERT_EQ(1u, endpoints_info[0].publishers.size());
+  EXPECT_EQ(reused_info, &endpoints_info[0].publishers[0]);
+  EXPECT_EQ(1u, endpoints_info[1].subscriptions.size());
+
+  auto mock = mocking_utils::patch_and_return(
+    "lib:rclcpp", rcl_get_subscriptions_info_by_topic, RCL_RET_ERROR);
+  EXPECT_THROW(
+    node_graph()->get_endpoints_info_by_topics(topic_names, endpoints_info),
+    rclcpp::exceptions::RCLError);
+}
+
+TEST_F(TestNodeGraph, cached_graph_queries)
+{
+  auto caching_node = std::make_shared<rclcpp::Node>(
+    "caching_node", node_namespace, rclcpp::NodeOptions().cache_graph_queries(true));
+  auto caching_graph = caching_node->get_node_graph_interface();
+  auto node_graph_impl =
+    dynamic_cast<rclcpp::node_interfaces::NodeGraph *>(caching_graph.get());
+  ASSERT_NE(nullptr, node_graph_impl);
+
+  // Unchanged graph, the cached count is returned without querying rcl.
+  bool cached = false;
+  for (size_t tries = 0; tries < 10 && !cached; ++tries) {
+    const uint64_t version = node_graph_impl->get_graph_version();
+    EXPECT_EQ(0u, caching_graph->count_publishers("cached_topic"));
+    auto mock = mocking_utils::patch_and_return(
+      "lib:rclcpp", rcl_count_publishers, RCL_RET_ERROR);
+    try {
+      EXPECT_EQ(0u, caching_graph->count_publishers("cached_topic"));
+      cached = true;
+    } catch (const std::runtime_error &) {
+      // The graph changed in between, refreshing the cache.
+      EXPECT_NE(version, node_graph_impl->get_graph_version());
+    }
+  }
+  EXPECT_TRUE(cached);
+
+  // The graph change notified by the graph listener refreshes the cache.
+  const uint64_t version = node_graph_impl->get_graph_version();
+  auto publisher = node()->create_publisher<test_msgs::msg::Empty>("cached_topic", 1);
+  size_t count = 0;
+  auto start = std::chrono::steady_clock::now();
+  while (count == 0 && std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+    count = caching_graph->count_publishers("cached_topic");
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(1u, count);
+  EXPECT_LT(version, node_graph_impl->get_graph_version());
+}
+
+TEST_F(TestNodeGraph, filtered_graph_event)
+{
+  auto node_graph_interface = node()->get_node_graph_interface();
+  auto topic_event = node_graph_interface->get_topic_graph_event("filtered_topic");
+  auto any_event = node_graph_interface->get_graph_event();
+  EXPECT_THROW(node_graph_interface->get_filtered_graph_event(nullptr), std::invalid_argument);
+
+  auto wait_for_event = [&node_graph_interface](rclcpp::Event::SharedPtr event) {
+      auto start = std::chrono::steady_clock::now();
+      while (!event->check() &&
+        std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+      {
+        node_graph_interface->wait_for_graph_change(event, std::chrono::milliseconds(100));
+      }
+      return event->check_and_clear();
+    };
+
+  // An unrelated graph change only sets the unfiltered event.
+  auto other_publisher = node()->create_publisher<test_msgs::msg::Empty>("other_topic", 1);
+  EXPECT_TRUE(wait_for_event(any_event));
+  EXPECT_FALSE(topic_event->check());
+
+  auto publisher = node()->create_publisher<test_msgs::msg::Empty>("filtered_topic", 1);
+  EXPECT_TRUE(wait_for_event(topic_event));
+}
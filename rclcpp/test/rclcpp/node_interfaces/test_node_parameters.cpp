@@ -21,10 +21,14 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <chrono>
+#include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "rclcpp/executors.hpp"
 #include "rclcpp/node.hpp"
 #include "rclcpp/node_interfaces/node_parameters.hpp"
 
@@ -118,6 +122,53 @@ TEST_F(TestNodeParameters, list_parameters)
     list_result4.names.end());
 }
 
+TEST_F(TestNodeParameters, list_parameters_by_prefix_and_depth)
+{
+  const rcl_interfaces::msg::ParameterDescriptor descriptor;
+  for (const std::string name : {"a.b.c", "a.b", "a-c", "a.d", "b.e", "a.b.f.g"}) {
+    node_parameters->declare_parameter(name, rclcpp::ParameterValue(1), descriptor, false);
+  }
+
+  auto list_result = node_parameters->list_parameters({"a"}, 0u);
+  EXPECT_EQ(
+    (std::vector<std::string>{"a.b", "a.b.c", "a.b.f.g", "a.d"}), list_result.names);
+  EXPECT_EQ((std::vector<std::string>{"a", "a.b", "a.b.f"}), list_result.prefixes);
+
+  list_result = node_parameters->list_parameters({"a.b"}, 2u);
+  EXPECT_EQ((std::vector<std::string>{"a.b", "a.b.c"}), list_result.names);
+
+  // The names having both prefixes are only listed once.
+  list_result = node_parameters->list_parameters({"a", "a.b", "b"}, 0u);
+  EXPECT_EQ(
+    (std::vector<std::string>{"a.b", "a.b.c", "a.b.f.g", "a.d", "b.e"}), list_result.names);
+
+  list_result = node_parameters->list_parameters({}, 2u);
+  EXPECT_NE(
+    std::find(list_result.names.begin(), list_result.names.end(), "a-c"), list_result.names.end());
+  EXPECT_EQ(
+    std::find(list_result.names.begin(), list_result.names.end(), "a.b.c"),
+    list_result.names.end());
+  EXPECT_TRUE(std::is_sorted(list_result.names.begin(), list_result.names.end()));
+
+  std::map<std::string, rclcpp::Parameter> parameters;
+  EXPECT_TRUE(node_parameters->get_parameters_by_prefix("a.b", parameters));
+  EXPECT_EQ(2u, parameters.size());
+  EXPECT_EQ(1u, parameters.count("c"));
+  EXPECT_EQ(1u, parameters.count("f.g"));
+
+  parameters.clear();
+  EXPECT_FALSE(node_parameters->get_parameters_by_prefix("b.e", parameters));
+
+  // Implicitly declared parameters are listed, until they are undeclared.
+  node_parameters->set_parameters_atomically({rclcpp::Parameter("a.b.h", 2)});
+  list_result = node_parameters->list_parameters({"a.b"}, 0u);
+  EXPECT_EQ(
+    (std::vector<std::string>{"a.b", "a.b.c", "a.b.f.g", "a.b.h"}), list_result.names);
+  node_parameters->undeclare_parameter("a.b.h");
+  list_result = node_parameters->list_parameters({"a.b"}, 0u);
+  EXPECT_EQ((std::vector<std::string>{"a.b", "a.b.c", "a.b.f.g"}), list_result.names);
+}
+
 TEST_F(TestNodeParameters, parameter_overrides)
 {
   rclcpp::NodeOptions node_options;
@@ -175,6 +226,59 @@ TEST_F(TestNodeParameters, set_parameters) {
   EXPECT_TRUE(result[0].successful);
 }
 
+TEST_F(TestNodeParameters, parameter_event_batch) {
+  std::vector<rcl_interfaces::msg::ParameterEvent> events;
+  auto subscription = node->create_subscription<rcl_interfaces::msg::ParameterEvent>(
+    "/parameter_events", rclcpp::ParameterEventsQoS(),
+    [&events](const rcl_interfaces::msg::ParameterEvent & event) {
+      if ("/ns/node" == event.node) {
+        events.push_back(event);
+      }
+    });
+  auto start = std::chrono::steady_clock::now();
+  while (0u == subscription->get_publisher_count() &&
+    std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_LT(0u, subscription->get_publisher_count());
+
+  {
+    rclcpp::node_interfaces::ParameterEventBatch batch(*node_parameters);
+    {
+      // Nested batches are published when the outermost one ends.
+      rclcpp::node_interfaces::ParameterEventBatch nested_batch(*node_parameters);
+      node_parameters->declare_parameter("batched.a", rclcpp::ParameterValue(1));
+    }
+    node_parameters->declare_parameter("batched.b", rclcpp::ParameterValue(2));
+    node_parameters->set_parameters({rclcpp::Parameter("batched.a", 3)});
+    // Declared and undeclared during the batch, so not published at all.
+    node_parameters->set_parameters({rclcpp::Parameter("batched.c", 4)});
+    node_parameters->set_parameters({rclcpp::Parameter("batched.c")});
+  }
+  node_parameters->set_parameters({rclcpp::Parameter("batched.b", 5)});
+
+  start = std::chrono::steady_clock::now();
+  while (events.size() < 2u &&
+    std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+  {
+    rclcpp::spin_some(node);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_EQ(2u, events.size());
+  ASSERT_EQ(2u, events[0].new_parameters.size());
+  EXPECT_EQ("batched.a", events[0].new_parameters[0].name);
+  EXPECT_EQ(3, events[0].new_parameters[0].value.integer_value);
+  EXPECT_EQ("batched.b", events[0].new_parameters[1].name);
+  EXPECT_TRUE(events[0].changed_parameters.empty());
+  EXPECT_TRUE(events[0].deleted_parameters.empty());
+  EXPECT_TRUE(events[1].new_parameters.empty());
+  ASSERT_EQ(1u, events[1].changed_parameters.size());
+  EXPECT_EQ("batched.b", events[1].changed_parameters[0].name);
+
+  EXPECT_THROW(node_parameters->end_parameter_event_batch(), std::runtime_error);
+}
+
 TEST_F(TestNodeParameters, add_remove_on_set_parameters_callback) {
   rcl_interfaces::msg::ParameterDescriptor bool_descriptor;
   bool_descriptor.name = "bool_parameter";
@@ -355,6 +459,35 @@ TEST_F(TestNodeParameters, wildcard_with_namespace)
   EXPECT_EQ(parameter_overrides.count("should_not_appear"), 0u);
 }
 
+TEST_F(TestNodeParameters, wildcards_from_global_arguments)
+{
+  const std::string params_file = (test_resources_path / "wildcards.yaml").string();
+  const char * const argv[] = {"test", "--ros-args", "--params-file", params_file.c_str()};
+  auto context = std::make_shared<rclcpp::Context>();
+  context->init(4, argv);
+  rclcpp::NodeOptions opts;
+  opts.context(context);
+
+  // The global arguments are parsed once, the overrides of each node are still its own ones.
+  for (int i = 0; i < 2; ++i) {
+    auto node = std::make_shared<rclcpp::Node>("node2", "ns", opts);
+    const auto & parameter_overrides =
+      node->get_node_parameters_interface()->get_parameter_overrides();
+    EXPECT_EQ(7u, parameter_overrides.size());
+    EXPECT_EQ(parameter_overrides.at("explicit_in_ns").get<std::string>(), "explicit_in_ns");
+    EXPECT_EQ(parameter_overrides.count("should_not_appear"), 0u);
+
+    auto other_node = std::make_shared<rclcpp::Node>("node2", opts);
+    const auto & other_parameter_overrides =
+      other_node->get_node_parameters_interface()->get_parameter_overrides();
+    EXPECT_EQ(5u, other_parameter_overrides.size());
+    EXPECT_EQ(
+      other_parameter_overrides.at("explicit_no_ns").get<std::string>(), "explicit_no_ns");
+    EXPECT_EQ(other_parameter_overrides.count("explicit_in_ns"), 0u);
+  }
+  context->shutdown("test done");
+}
+
 TEST_F(TestNodeParameters, wildcard_no_namespace)
 {
   rclcpp::NodeOptions opts;
@@ -447,3 +580,70 @@ TEST_F(TestNodeParameters, complicated_wildcards)
     EXPECT_EQ(0u, parameter_overrides.size());
   }
 }
+
+TEST_F(TestNodeParameters, declare_parameters_bulk)
+{
+  size_t on_set_calls = 0u;
+  size_t post_set_calls = 0u;
+  size_t last_number_of_parameters = 0u;
+  bool reject = false;
+  auto on_set_handle = node_parameters->add_on_set_parameters_callback(
+    [&](const std::vector<rclcpp::Parameter> & parameters) {
+      on_set_calls++;
+      last_number_of_parameters = parameters.size();
+      rcl_interfaces::msg::SetParametersResult result;
+      result.successful = !reject;
+      result.reason = reject ? "rejected" : "";
+      return result;
+    });
+  auto post_set_handle = node_parameters->add_post_set_parameters_callback(
+    [&](const std::vector<rclcpp::Parameter> &) {post_set_calls++;});
+
+  rcl_interfaces::msg::ParameterDescriptor typed_descriptor;
+  typed_descriptor.type = rclcpp::PARAMETER_STRING;
+  rcl_interfaces::msg::ParameterDescriptor dynamic_descriptor;
+  dynamic_descriptor.dynamic_typing = true;
+  const rcl_interfaces::msg::ParameterDescriptor descriptor;
+  auto values = node_parameters->declare_parameters_bulk(
+    {
+      {rclcpp::Parameter("bulk.int", 42), descriptor},
+      {rclcpp::Parameter("bulk.double", 1.5), descriptor},
+      {rclcpp::Parameter("bulk.typed"), typed_descriptor},
+      {rclcpp::Parameter("bulk.dynamic"), dynamic_descriptor},
+    });
+  ASSERT_EQ(4u, values.size());
+  EXPECT_EQ(42, values[0].get<int64_t>());
+  EXPECT_EQ(1.5, values[1].get<double>());
+  EXPECT_EQ(rclcpp::PARAMETER_NOT_SET, values[2].get_type());
+  EXPECT_EQ(rclcpp::PARAMETER_NOT_SET, values[3].get_type());
+  EXPECT_EQ(1u, on_set_calls);
+  EXPECT_EQ(1u, post_set_calls);
+  EXPECT_EQ(2u, last_number_of_parameters);
+  EXPECT_EQ(42, node_parameters->get_parameter("bulk.int").get_value<int64_t>());
+  EXPECT_EQ(
+    rclcpp::PARAMETER_STRING,
+    node_parameters->describe_parameters({"bulk.typed"})[0].type);
+  EXPECT_FALSE(
+    node_parameters->set_parameters_atomically({rclcpp::Parameter("bulk.typed", 1)}).successful);
+
+  // Nothing is declared when a declaration fails
+  const rclcpp::Parameter new_parameter("bulk.new", 1);
+  EXPECT_THROW(
+    node_parameters->declare_parameters_bulk(
+      {{new_parameter, descriptor}, {rclcpp::Parameter("bulk.int", 1), descriptor}}),
+    rclcpp::exceptions::ParameterAlreadyDeclaredException);
+  EXPECT_THROW(
+    node_parameters->declare_parameters_bulk(
+      {{new_parameter, descriptor}, {new_parameter, descriptor}}),
+    rclcpp::exceptions::ParameterAlreadyDeclaredException);
+  EXPECT_THROW(
+    node_parameters->declare_parameters_bulk({{rclcpp::Parameter("bulk.new"), descriptor}}),
+    rclcpp::exceptions::InvalidParameterTypeException);
+  reject = true;
+  EXPECT_THROW(
+    node_parameters->declare_parameters_bulk({{new_parameter, descriptor}}),
+    rclcpp::exceptions::InvalidParameterValueException);
+  EXPECT_FALSE(node_parameters->has_parameter("bulk.new"));
+  EXPECT_EQ(2u, on_set_calls);
+  EXPECT_EQ(1u, post_set_calls);
+}
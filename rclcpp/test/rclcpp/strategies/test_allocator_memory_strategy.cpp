@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <chrono>
 #include <list>
 #include <map>
 #include <memory>
@@ -524,6 +525,48 @@ TEST_F(TestAllocatorMemoryStrategy, number_of_entities_with_timer) {
   EXPECT_TRUE(TestNumberOfEntitiesAfterCollection(node_with_timer, expected_sizes));
 }
 
+TEST_F(TestAllocatorMemoryStrategy, collect_entities_after_changes) {
+  auto node = std::make_shared<rclcpp::Node>("node", "ns");
+  auto callback_group = node->get_node_base_interface()->get_default_callback_group();
+  WeakCallbackGroupsToNodesMap weak_groups_to_nodes;
+  weak_groups_to_nodes.insert(
+    std::pair<rclcpp::CallbackGroup::WeakPtr,
+    rclcpp::node_interfaces::NodeBaseInterface::WeakPtr>(
+      callback_group, node->get_node_base_interface()));
+  auto collect = [this, &weak_groups_to_nodes]() {
+      allocator_memory_strategy()->clear_handles();
+      allocator_memory_strategy()->collect_entities(weak_groups_to_nodes);
+    };
+
+  auto timer1 = node->create_wall_timer(std::chrono::seconds(10), []() {});
+  collect();
+  EXPECT_EQ(1u, allocator_memory_strategy()->number_of_ready_timers());
+  collect();
+  EXPECT_EQ(1u, allocator_memory_strategy()->number_of_ready_timers());
+
+  // Adding an entity changes the generation of the group.
+  const auto generation = callback_group->get_generation();
+  auto timer2 = node->create_wall_timer(std::chrono::seconds(10), []() {});
+  EXPECT_NE(generation, callback_group->get_generation());
+  collect();
+  EXPECT_EQ(2u, allocator_memory_strategy()->number_of_ready_timers());
+
+  // Destroyed entities aren't collected anymore.
+  timer1.reset();
+  collect();
+  EXPECT_EQ(1u, allocator_memory_strategy()->number_of_ready_timers());
+  collect();
+  EXPECT_EQ(1u, allocator_memory_strategy()->number_of_ready_timers());
+
+  // Neither are the entities of a group that can't be taken from.
+  callback_group->can_be_taken_from() = false;
+  collect();
+  EXPECT_EQ(0u, allocator_memory_strategy()->number_of_ready_timers());
+  callback_group->can_be_taken_from() = true;
+  collect();
+  EXPECT_EQ(1u, allocator_memory_strategy()->number_of_ready_timers());
+}
+
 TEST_F(TestAllocatorMemoryStrategy, add_handles_to_wait_set_bad_arguments) {
   auto node = create_node_with_subscription("subscription_node");
   WeakCallbackGroupsToNodesMap weak_groups_to_nodes;
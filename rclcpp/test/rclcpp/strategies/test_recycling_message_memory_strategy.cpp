@@ -0,0 +1,139 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/strategies/recycling_message_memory_strategy.hpp"
+#include "test_msgs/msg/strings.hpp"
+
+using rclcpp::strategies::recycling_message_memory_strategy::RecyclingMessageMemoryStrategy;
+using MessageT = test_msgs::msg::Strings;
+
+TEST(TestRecyclingMessageMemoryStrategy, construct_destruct) {
+  EXPECT_THROW(RecyclingMessageMemoryStrategy<MessageT>(0), std::invalid_argument);
+  RecyclingMessageMemoryStrategy<MessageT> strategy(2);
+  EXPECT_EQ(0u, strategy.get_number_of_pooled_messages());
+}
+
+TEST(TestRecyclingMessageMemoryStrategy, borrow_return) {
+  RecyclingMessageMemoryStrategy<MessageT> strategy(2);
+
+  auto message = strategy.borrow_message();
+  ASSERT_NE(nullptr, message);
+  message->string_value = "reused";
+  const MessageT * address = message.get();
+  strategy.return_message(message);
+  EXPECT_EQ(nullptr, message);
+
+  // The message is reused as is.
+  message = strategy.borrow_message();
+  EXPECT_EQ(address, message.get());
+  EXPECT_EQ("reused", message->string_value);
+  strategy.return_message(message);
+  EXPECT_EQ(1u, strategy.get_number_of_pooled_messages());
+}
+
+TEST(TestRecyclingMessageMemoryStrategy, message_still_used) {
+  RecyclingMessageMemoryStrategy<MessageT> strategy(2);
+
+  auto message = strategy.borrow_message();
+  // Kept by a callback for instance.
+  auto kept_message = message;
+  strategy.return_message(message);
+
+  auto other_message = strategy.borrow_message();
+  EXPECT_NE(kept_message, other_message);
+  EXPECT_EQ(2u, strategy.get_number_of_pooled_messages());
+
+  // The pool is full, the message is allocated.
+  auto allocated_message = strategy.borrow_message();
+  ASSERT_NE(nullptr, allocated_message);
+  EXPECT_NE(kept_message, allocated_message);
+  EXPECT_NE(other_message, allocated_message);
+  EXPECT_EQ(2u, strategy.get_number_of_pooled_messages());
+  strategy.return_message(allocated_message);
+  strategy.return_message(other_message);
+
+  const MessageT * address = kept_message.get();
+  kept_message.reset();
+  auto first_message = strategy.borrow_message();
+  EXPECT_EQ(address, first_message.get());
+}
+
+TEST(TestRecyclingMessageMemoryStrategy, preallocate) {
+  size_t number_of_initialized_messages = 0;
+  RecyclingMessageMemoryStrategy<MessageT> strategy(
+    3, [&number_of_initialized_messages](MessageT & message) {
+      message.string_value.reserve(1000u);
+      ++number_of_initialized_messages;
+    });
+  EXPECT_EQ(0u, strategy.get_number_of_pooled_messages());
+
+  EXPECT_EQ(2u, strategy.preallocate(2));
+  EXPECT_EQ(2u, number_of_initialized_messages);
+  auto message = strategy.borrow_message();
+  ASSERT_NE(nullptr, message);
+  EXPECT_LE(1000u, message->string_value.capacity());
+  EXPECT_EQ(2u, strategy.get_number_of_pooled_messages());
+
+  // The messages in use and already allocated are left as is.
+  EXPECT_EQ(3u, strategy.preallocate(5));
+  EXPECT_EQ(3u, number_of_initialized_messages);
+  strategy.return_message(message);
+
+  // The messages allocated when the pool is full aren't initialized.
+  std::vector<std::shared_ptr<MessageT>> messages;
+  for (size_t i = 0; i < 4u; ++i) {
+    messages.push_back(strategy.borrow_message());
+  }
+  EXPECT_EQ(3u, number_of_initialized_messages);
+  for (auto & borrowed_message : messages) {
+    strategy.return_message(borrowed_message);
+  }
+
+  RecyclingMessageMemoryStrategy<MessageT> throwing_strategy(
+    1, [](MessageT &) {throw std::runtime_error("initialization failed");});
+  EXPECT_THROW(throwing_strategy.borrow_message(), std::runtime_error);
+  // The slot of the message can be used again.
+  EXPECT_THROW(throwing_strategy.preallocate(1), std::runtime_error);
+  EXPECT_EQ(0u, throwing_strategy.get_number_of_pooled_messages());
+}
+
+TEST(TestRecyclingMessageMemoryStrategy, subscription_option) {
+  rclcpp::init(0, nullptr);
+  {
+    auto node = std::make_shared<rclcpp::Node>("test_recycling_message_memory_strategy");
+    auto callback = [](MessageT::ConstSharedPtr) {};
+    rclcpp::SubscriptionOptions options;
+    options.message_pool_size = 2;
+    auto subscription = node->create_subscription<MessageT>("topic", 10, callback, options);
+    // The messages taken from the middleware are recycled.
+    auto message = subscription->create_message();
+    const void * address = message.get();
+    subscription->return_message(message);
+    EXPECT_EQ(address, subscription->create_message().get());
+
+    struct CustomStrategy : rclcpp::message_memory_strategy::MessageMemoryStrategy<MessageT> {};
+    EXPECT_THROW(
+      node->create_subscription<MessageT>(
+        "topic", 10, callback, options, std::make_shared<CustomStrategy>()),
+      std::invalid_argument);
+  }
+  rclcpp::shutdown();
+}
@@ -18,6 +18,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 // TODO(aprotyas): Figure out better way to suppress deprecation warnings.
 #define RCLCPP_AVOID_DEPRECATIONS_FOR_UNIT_TESTS 1
@@ -210,6 +211,50 @@ TEST_F(TestAnySubscriptionCallback, unset_dispatch_throw) {
     std::runtime_error);
 }
 
+TEST_F(TestAnySubscriptionCallback, dispatch_with_callback_type) {
+  size_t calls = 0;
+  any_subscription_callback_.set(
+    [&calls](const test_msgs::msg::Empty &, const rclcpp::MessageInfo &) {++calls;});
+  // The copies call the same callback, without visiting the variant.
+  auto asc_copy = any_subscription_callback_;
+  any_subscription_callback_.dispatch(msg_shared_ptr_, message_info_);
+  asc_copy.dispatch(msg_shared_ptr_, message_info_);
+  EXPECT_EQ(2u, calls);
+
+  // The callback is dispatched through the variant once it may have been modified.
+  any_subscription_callback_.get_variant() =
+    std::function<void(std::shared_ptr<const test_msgs::msg::Empty>)>(
+    [&calls](std::shared_ptr<const test_msgs::msg::Empty>) {calls += 10;});
+  any_subscription_callback_.dispatch(msg_shared_ptr_, message_info_);
+  EXPECT_EQ(12u, calls);
+
+  // Setting the callback again replaces the previous one.
+  any_subscription_callback_.set([&calls](std::unique_ptr<test_msgs::msg::Empty> msg) {
+      EXPECT_NE(nullptr, msg);
+      calls += 100;
+    });
+  any_subscription_callback_.dispatch(msg_shared_ptr_, message_info_);
+  EXPECT_EQ(112u, calls);
+}
+
+TEST_F(TestAnySubscriptionCallback, stateful_callback_shared_by_dispatches) {
+  std::vector<size_t> calls;
+  any_subscription_callback_.set(
+    [count = size_t(0), &calls](const test_msgs::msg::Empty &) mutable {
+      calls.push_back(++count);
+    });
+  // The ROS messages and the intra-process ones call the same callback object.
+  any_subscription_callback_.dispatch(msg_shared_ptr_, message_info_);
+  any_subscription_callback_.dispatch_intra_process(msg_shared_ptr_, message_info_);
+  any_subscription_callback_.dispatch_intra_process(get_unique_ptr_msg(), message_info_);
+  // And so do the copies.
+  auto asc_copy = any_subscription_callback_;
+  asc_copy.dispatch_intra_process(msg_shared_ptr_, message_info_);
+  asc_copy.dispatch(msg_shared_ptr_, message_info_);
+  any_subscription_callback_.dispatch(msg_shared_ptr_, message_info_);
+  EXPECT_EQ((std::vector<size_t>{1u, 2u, 3u, 4u, 5u, 6u}), calls);
+}
+
 //
 // Parameterized test to test across all callback types and dispatch types.
 //
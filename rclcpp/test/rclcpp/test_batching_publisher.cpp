@@ -0,0 +1,127 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "rclcpp/experimental/batching_publisher.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "test_msgs/msg/basic_types.hpp"
+#include "test_msgs/msg/unbounded_sequences.hpp"
+
+using test_msgs::msg::BasicTypes;
+using test_msgs::msg::UnboundedSequences;
+using namespace std::chrono_literals;
+
+class TestBatchingPublisher : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    rclcpp::init(0, nullptr);
+    node = std::make_shared<rclcpp::Node>("test_batching_publisher");
+  }
+
+  void TearDown() override
+  {
+    node.reset();
+    rclcpp::shutdown();
+  }
+
+  rclcpp::Node::SharedPtr node;
+};
+
+TEST_F(TestBatchingPublisher, invalid_options) {
+  rclcpp::experimental::BatchingOptions options;
+  options.max_batch_size = 0u;
+  EXPECT_THROW(
+    rclcpp::experimental::create_batching_publisher(
+      node, "topic", 10, &UnboundedSequences::basic_types_values, options),
+    std::invalid_argument);
+  options.max_batch_size = 10u;
+  options.max_delay = 0ns;
+  EXPECT_THROW(
+    rclcpp::experimental::create_batching_publisher(
+      node, "topic", 10, &UnboundedSequences::basic_types_values, options),
+    std::invalid_argument);
+}
+
+TEST_F(TestBatchingPublisher, publish_batches) {
+  std::vector<UnboundedSequences> envelopes;
+  auto envelope_subscription = node->create_subscription<UnboundedSequences>(
+    "batches", 10, [&envelopes](const UnboundedSequences & envelope) {
+      envelopes.push_back(envelope);
+    });
+  std::vector<int32_t> received_values;
+  auto subscription = rclcpp::experimental::create_batched_subscription(
+    node, "batches", 10, &UnboundedSequences::basic_types_values,
+    [&received_values](const BasicTypes & message) {
+      received_values.push_back(message.int32_value);
+    });
+
+  rclcpp::experimental::BatchingOptions options;
+  options.max_batch_size = 3u;
+  options.max_delay = 1h;
+  auto publisher = rclcpp::experimental::create_batching_publisher(
+    node, "batches", 10, &UnboundedSequences::basic_types_values, options);
+
+  BasicTypes message;
+  for (int32_t i = 0; i < 4; ++i) {
+    message.int32_value = i;
+    publisher->publish(message);
+  }
+  // The first batch is full, the last message waits for the next one
+  EXPECT_EQ(1u, publisher->get_number_of_pending_messages());
+  publisher->flush();
+  EXPECT_EQ(0u, publisher->get_number_of_pending_messages());
+
+  const auto start = std::chrono::steady_clock::now();
+  while (received_values.size() < 4u && std::chrono::steady_clock::now() - start < 10s) {
+    rclcpp::spin_some(node);
+  }
+  // The messages were published in two envelopes, and unbatched in order
+  ASSERT_EQ(2u, envelopes.size());
+  EXPECT_EQ(3u, envelopes[0].basic_types_values.size());
+  EXPECT_EQ(1u, envelopes[1].basic_types_values.size());
+  EXPECT_EQ((std::vector<int32_t>{0, 1, 2, 3}), received_values);
+}
+
+TEST_F(TestBatchingPublisher, publish_after_delay) {
+  size_t number_of_messages = 0u;
+  auto subscription = rclcpp::experimental::create_batched_subscription(
+    node, "delayed_batches", 10, &UnboundedSequences::basic_types_values,
+    [&number_of_messages](const BasicTypes &) {++number_of_messages;});
+
+  rclcpp::experimental::BatchingOptions options;
+  options.max_delay = 10ms;
+  auto publisher = rclcpp::experimental::create_batching_publisher(
+    node, "delayed_batches", 10, &UnboundedSequences::basic_types_values, options);
+  publisher->publish(std::make_unique<BasicTypes>());
+  publisher->publish(std::make_unique<BasicTypes>());
+  EXPECT_EQ(2u, publisher->get_number_of_pending_messages());
+
+  // The timer of the batch publishes it once the node is spun
+  const auto start = std::chrono::steady_clock::now();
+  while (number_of_messages < 2u && std::chrono::steady_clock::now() - start < 10s) {
+    rclcpp::spin_some(node);
+  }
+  EXPECT_EQ(2u, number_of_messages);
+  EXPECT_EQ(0u, publisher->get_number_of_pending_messages());
+}
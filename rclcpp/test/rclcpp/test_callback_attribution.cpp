@@ -0,0 +1,119 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "rclcpp/callback_attribution.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+namespace callback_attribution = rclcpp::callback_attribution;
+
+#if defined(__linux__)
+
+namespace
+{
+
+std::string
+get_thread_name()
+{
+  char name[16] = {};
+  pthread_getname_np(pthread_self(), name, sizeof(name));
+  return name;
+}
+
+}  // namespace
+
+class TestCallbackAttribution : public ::testing::Test
+{
+protected:
+  void TearDown() override
+  {
+    callback_attribution::disable();
+  }
+};
+
+TEST_F(TestCallbackAttribution, disabled) {
+  callback_attribution::disable();
+  EXPECT_FALSE(callback_attribution::is_enabled());
+  std::thread(
+    []() {
+      callback_attribution::set_thread_name("worker");
+      {
+        callback_attribution::ScopedCallback attribution(nullptr, "/topic");
+        EXPECT_EQ("worker", get_thread_name());
+      }
+    }).join();
+}
+
+TEST_F(TestCallbackAttribution, thread_renamed_during_callback) {
+  callback_attribution::enable();
+  EXPECT_TRUE(callback_attribution::is_enabled());
+  std::thread(
+    []() {
+      callback_attribution::set_thread_name("worker");
+      EXPECT_EQ("worker", get_thread_name());
+      {
+        callback_attribution::ScopedCallback attribution(nullptr, "/topic");
+        EXPECT_EQ("/topic", get_thread_name());
+        {
+          callback_attribution::ScopedCallback nested(nullptr, nullptr);
+          EXPECT_EQ("callback", get_thread_name());
+        }
+        EXPECT_EQ("/topic", get_thread_name());
+      }
+      EXPECT_EQ("worker", get_thread_name());
+    }).join();
+}
+
+TEST_F(TestCallbackAttribution, long_names_keep_their_end) {
+  callback_attribution::enable();
+  std::thread(
+    []() {
+      callback_attribution::ScopedCallback attribution(nullptr, "/robot/camera/image_raw");
+      EXPECT_EQ("amera/image_raw", get_thread_name());
+    }).join();
+}
+
+TEST_F(TestCallbackAttribution, executor_callbacks) {
+  rclcpp::init(0, nullptr);
+  auto node = std::make_shared<rclcpp::Node>("test_callback_attribution");
+  callback_attribution::enable();
+
+  std::string timer_thread_name;
+  rclcpp::executors::SingleThreadedExecutor executor;
+  auto timer = node->create_wall_timer(
+    std::chrono::milliseconds(1),
+    [&timer_thread_name, &executor]() {
+      timer_thread_name = get_thread_name();
+      executor.cancel();
+    });
+  executor.add_node(node);
+  const std::string thread_name = get_thread_name();
+  executor.spin();
+
+  EXPECT_EQ("timer", timer_thread_name);
+  EXPECT_EQ(thread_name, get_thread_name());
+  rclcpp::shutdown();
+}
+
+#endif  // defined(__linux__)
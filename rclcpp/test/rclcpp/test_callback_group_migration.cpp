@@ -0,0 +1,216 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/callback_group_migration.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+using namespace std::chrono_literals;
+
+class TestCallbackGroupMigration : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+
+  template<typename ConditionT>
+  static bool wait_for(ConditionT condition)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    while (!condition()) {
+      if (std::chrono::steady_clock::now() - start > 5s) {
+        return false;
+      }
+      std::this_thread::sleep_for(1ms);
+    }
+    return true;
+  }
+};
+
+TEST_F(TestCallbackGroupMigration, move_callback_group_invalid_arguments) {
+  auto node = std::make_shared<rclcpp::Node>("test_move_callback_group_invalid_arguments");
+  auto group = node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive, false);
+  rclcpp::executors::SingleThreadedExecutor source;
+  rclcpp::executors::SingleThreadedExecutor target;
+
+  EXPECT_THROW(
+    rclcpp::move_callback_group(nullptr, node->get_node_base_interface(), source, target),
+    std::invalid_argument);
+  EXPECT_THROW(
+    rclcpp::move_callback_group(group, nullptr, source, target), std::invalid_argument);
+  EXPECT_THROW(
+    rclcpp::move_callback_group(group, node->get_node_base_interface(), source, source),
+    std::invalid_argument);
+  // The group wasn't added to the source executor.
+  EXPECT_THROW(
+    rclcpp::move_callback_group(group, node->get_node_base_interface(), source, target),
+    std::runtime_error);
+}
+
+TEST_F(TestCallbackGroupMigration, move_callback_group_while_spinning) {
+  auto node = std::make_shared<rclcpp::Node>("test_move_callback_group_while_spinning");
+  auto group = node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive, false);
+  std::atomic_bool in_callback{false};
+  std::atomic_bool overlapped{false};
+  std::atomic<std::thread::id> last_thread{std::thread::id()};
+  auto timer = node->create_wall_timer(
+    1ms, [&]() {
+      if (in_callback.exchange(true)) {
+        overlapped.store(true);
+      }
+      last_thread.store(std::this_thread::get_id());
+      std::this_thread::sleep_for(1ms);
+      in_callback.store(false);
+    }, group);
+
+  auto source = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+  auto target = std::make_shared<rclcpp::executors::MultiThreadedExecutor>(
+    rclcpp::ExecutorOptions(), 2u);
+  source->add_callback_group(group, node->get_node_base_interface());
+  std::thread source_thread([source]() {source->spin();});
+  std::thread target_thread([target]() {target->spin();});
+  const auto source_id = source_thread.get_id();
+
+  ASSERT_TRUE(wait_for([&]() {return last_thread.load() == source_id;}));
+  ASSERT_TRUE(
+    rclcpp::move_callback_group(group, node->get_node_base_interface(), *source, *target));
+  EXPECT_FALSE(in_callback.load());
+  EXPECT_TRUE(wait_for([&]() {return last_thread.load() != source_id;}));
+  // The source executor doesn't execute the group anymore.
+  std::this_thread::sleep_for(20ms);
+  EXPECT_NE(source_id, last_thread.load());
+  EXPECT_FALSE(overlapped.load());
+
+  source->cancel();
+  target->cancel();
+  source_thread.join();
+  target_thread.join();
+}
+
+TEST_F(TestCallbackGroupMigration, move_callback_group_timeout) {
+  auto node = std::make_shared<rclcpp::Node>("test_move_callback_group_timeout");
+  auto group = node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive, false);
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  std::atomic_int count{0};
+  auto timer = node->create_wall_timer(
+    1ms, [&count, released]() {
+      count++;
+      released.wait();
+    }, group);
+
+  auto source = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+  rclcpp::executors::SingleThreadedExecutor target;
+  source->add_callback_group(group, node->get_node_base_interface());
+  std::thread source_thread([source]() {source->spin();});
+
+  ASSERT_TRUE(wait_for([&count]() {return count.load() == 1;}));
+  EXPECT_FALSE(group->wait_for_idle(10ms));
+  EXPECT_FALSE(
+    rclcpp::move_callback_group(group, node->get_node_base_interface(), *source, target, 10ms));
+  release.set_value();
+  // The group was added back to the source executor.
+  EXPECT_TRUE(wait_for([&count]() {return count.load() > 2;}));
+
+  source->cancel();
+  source_thread.join();
+  EXPECT_TRUE(group->wait_for_idle(0ns));
+}
+
+TEST_F(TestCallbackGroupMigration, balancer_invalid_arguments) {
+  auto executor = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+  EXPECT_THROW(rclcpp::CallbackGroupBalancer({}), std::invalid_argument);
+  EXPECT_THROW(rclcpp::CallbackGroupBalancer({executor, nullptr}), std::invalid_argument);
+  rclcpp::CallbackGroupBalancerOptions options;
+  options.min_imbalance_ratio = 2.0;
+  EXPECT_THROW(rclcpp::CallbackGroupBalancer({executor}, options), std::invalid_argument);
+
+  rclcpp::CallbackGroupBalancer balancer({executor});
+  auto node = std::make_shared<rclcpp::Node>("test_balancer_invalid_arguments");
+  auto group = node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive, false);
+  EXPECT_THROW(
+    balancer.add_callback_group(group, node->get_node_base_interface(), 1u),
+    std::invalid_argument);
+  EXPECT_THROW(balancer.get_executor_index(group), std::invalid_argument);
+  EXPECT_THROW(balancer.remove_callback_group(group), std::invalid_argument);
+
+  balancer.add_callback_group(group, node->get_node_base_interface(), 0u);
+  EXPECT_TRUE(group->is_cpu_accounting_enabled());
+  EXPECT_EQ(0u, balancer.get_executor_index(group));
+  EXPECT_THROW(
+    balancer.add_callback_group(group, node->get_node_base_interface(), 0u),
+    std::invalid_argument);
+  // A single executor is never imbalanced.
+  EXPECT_FALSE(balancer.rebalance());
+  balancer.remove_callback_group(group);
+  EXPECT_THROW(balancer.get_executor_index(group), std::invalid_argument);
+}
+
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+TEST_F(TestCallbackGroupMigration, balancer_moves_hot_group) {
+  auto busy = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+  auto idle = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+  rclcpp::CallbackGroupBalancer balancer({busy, idle});
+
+  auto node = std::make_shared<rclcpp::Node>("test_balancer_moves_hot_group");
+  std::vector<rclcpp::CallbackGroup::SharedPtr> groups;
+  std::vector<rclcpp::TimerBase::SharedPtr> timers;
+  std::atomic_int count{0};
+  for (int i = 0; i < 2; ++i) {
+    auto group = node->create_callback_group(
+      rclcpp::CallbackGroupType::MutuallyExclusive, false);
+    // The callbacks keep the CPU busy, unlike a sleep
+    timers.push_back(
+      node->create_wall_timer(
+        2ms, [&count]() {
+          const auto start = std::chrono::steady_clock::now();
+          while (std::chrono::steady_clock::now() - start < 1ms) {
+          }
+          count++;
+        }, group));
+    balancer.add_callback_group(group, node->get_node_base_interface(), 0u);
+    groups.push_back(group);
+  }
+
+  std::thread busy_thread([busy]() {busy->spin();});
+  std::thread idle_thread([idle]() {idle->spin();});
+  ASSERT_TRUE(wait_for([&count]() {return count.load() >= 20;}));
+
+  EXPECT_TRUE(balancer.rebalance());
+  EXPECT_EQ(1u, balancer.get_executor_index(groups[0]) + balancer.get_executor_index(groups[1]));
+
+  busy->cancel();
+  idle->cancel();
+  busy_thread.join();
+  idle_thread.join();
+}
+#endif
@@ -14,9 +14,12 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <future>
 #include <string>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/rclcpp.hpp"
@@ -205,6 +208,27 @@ TEST_F(TestClient, wait_for_service) {
 /*
    Testing client construction and destruction for subnodes.
  */
+TEST_F(TestClient, async_wait_for_service) {
+  using test_msgs::srv::Empty;
+  auto client = node->create_client<Empty>("async_wait_service");
+
+  std::atomic<size_t> callback_calls{0};
+  auto future = client->async_wait_for_service([&callback_calls]() {callback_calls++;});
+  EXPECT_EQ(std::future_status::timeout, future.wait_for(0s));
+
+  auto service = node->create_service<Empty>(
+    "async_wait_service",
+    [](const Empty::Request::SharedPtr, Empty::Response::SharedPtr) {});
+  ASSERT_EQ(std::future_status::ready, future.wait_for(5s));
+  EXPECT_EQ(1u, callback_calls.load());
+  EXPECT_TRUE(client->service_is_ready());
+
+  // Already available, completed right away.
+  future = client->async_wait_for_service([&callback_calls]() {callback_calls++;});
+  EXPECT_EQ(std::future_status::ready, future.wait_for(0s));
+  EXPECT_EQ(2u, callback_calls.load());
+}
+
 TEST_F(TestClientSub, construction_and_destruction) {
   using rcl_interfaces::srv::ListParameters;
   {
@@ -319,6 +343,120 @@ TEST_F(TestClientWithServer, async_send_request_callback_with_request) {
   EXPECT_FALSE(client->remove_pending_request(req_id));
 }
 
+TEST_F(TestClientWithServer, async_send_request_callback_with_response) {
+  using SharedResponse = rclcpp::Client<test_msgs::srv::Empty>::SharedResponse;
+
+  auto client = node->create_client<test_msgs::srv::Empty>(service_name);
+  ASSERT_TRUE(client->wait_for_service(std::chrono::seconds(1)));
+
+  test_msgs::srv::Empty::Request request;
+  size_t received_responses = 0;
+  auto callback = [&received_responses](SharedResponse response) {
+      EXPECT_NE(nullptr, response);
+      received_responses++;
+    };
+  // More requests than the initial number of slots of the pending requests.
+  std::vector<int64_t> req_ids;
+  for (size_t i = 0; i < 20; ++i) {
+    req_ids.push_back(client->async_send_request(request, callback));
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  while (received_responses < req_ids.size() &&
+    (std::chrono::steady_clock::now() - start) < std::chrono::seconds(5))
+  {
+    rclcpp::spin_some(node);
+  }
+  EXPECT_EQ(req_ids.size(), received_responses);
+  for (int64_t req_id : req_ids) {
+    EXPECT_FALSE(client->remove_pending_request(req_id));
+  }
+}
+
+TEST_F(TestClientWithServer, async_send_requests) {
+  using test_msgs::srv::Empty;
+
+  auto client = node->create_client<Empty>(service_name);
+  ASSERT_TRUE(client->wait_for_service(std::chrono::seconds(1)));
+
+  std::vector<Empty::Request::SharedPtr> requests;
+  for (size_t i = 0; i < 5; ++i) {
+    requests.push_back(std::make_shared<Empty::Request>());
+  }
+  std::vector<size_t> received_indexes;
+  auto batch = client->async_send_requests(
+    requests, requests.size(),
+    [&received_indexes](size_t index, Empty::Response::SharedPtr response) {
+      EXPECT_NE(nullptr, response);
+      received_indexes.push_back(index);
+    });
+  ASSERT_EQ(requests.size(), batch.request_ids.size());
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  ASSERT_EQ(
+    rclcpp::FutureReturnCode::SUCCESS,
+    executor.spin_until_future_complete(batch.future, std::chrono::seconds(5)));
+  for (const auto & response : batch.future.get()) {
+    EXPECT_NE(nullptr, response);
+  }
+  EXPECT_EQ(requests.size(), received_indexes.size());
+  EXPECT_EQ(0u, client->remove_pending_requests(batch));
+
+  // Completed by the first response.
+  auto any_batch = client->async_send_requests(requests, 1);
+  ASSERT_EQ(
+    rclcpp::FutureReturnCode::SUCCESS,
+    executor.spin_until_future_complete(any_batch.future, std::chrono::seconds(5)));
+  client->remove_pending_requests(any_batch);
+
+  EXPECT_THROW(
+    client->async_send_requests(requests, requests.size() + 1), std::invalid_argument);
+}
+
+TEST_F(TestClient, intra_process_request) {
+  using test_msgs::srv::Empty;
+
+  auto intra_process_node = std::make_shared<rclcpp::Node>(
+    "intra_process_node", "/ns", rclcpp::NodeOptions().use_intra_process_comms(true));
+  Empty::Request::SharedPtr received_request;
+  Empty::Response::SharedPtr sent_response;
+  auto service = intra_process_node->create_service<Empty>(
+    "intra_process_service",
+    [&received_request, &sent_response](
+      const Empty::Request::SharedPtr request, Empty::Response::SharedPtr response)
+    {
+      received_request = request;
+      sent_response = response;
+    });
+  ASSERT_NE(nullptr, service->get_intra_process_waitable());
+  auto client = intra_process_node->create_client<Empty>("intra_process_service");
+  ASSERT_NE(nullptr, client->get_intra_process_waitable());
+
+  auto request = std::make_shared<Empty::Request>();
+  Empty::Response::SharedPtr received_response;
+  const int64_t req_id = client->async_send_request(
+    request, [&received_response](Empty::Response::SharedPtr response) {
+      received_response = response;
+    });
+  // The middleware sequence numbers are positive.
+  EXPECT_GT(0, req_id);
+
+  auto start = std::chrono::steady_clock::now();
+  while (!received_response && (std::chrono::steady_clock::now() - start) < 5s) {
+    rclcpp::spin_some(intra_process_node);
+  }
+  // Neither the request nor the response has been copied.
+  EXPECT_EQ(request, received_request);
+  ASSERT_NE(nullptr, received_response);
+  EXPECT_EQ(sent_response, received_response);
+  EXPECT_FALSE(client->remove_pending_request(req_id));
+
+  // The requests of a client of a node not using intra-process go through the middleware.
+  auto inter_process_client = node->create_client<Empty>("intra_process_service");
+  EXPECT_EQ(nullptr, inter_process_client->get_intra_process_waitable());
+}
+
 TEST_F(TestClientWithServer, test_client_remove_pending_request) {
   auto client = node->create_client<test_msgs::srv::Empty>("no_service_server_available_here");
   auto request = std::make_shared<test_msgs::srv::Empty::Request>();
@@ -348,6 +486,58 @@ TEST_F(TestClientWithServer, prune_requests_older_than_with_pruned) {
   EXPECT_EQ(future.request_id, pruned_requests[0]);
 }
 
+TEST_F(TestClientWithServer, expire_timed_out_requests) {
+  using test_msgs::srv::Empty;
+
+  // No server answers these requests.
+  auto client = node->create_client<Empty>("no_service_server_available_here");
+  auto request = std::make_shared<Empty::Request>();
+  auto future = client->async_send_request(request, 0ms);
+  auto untimed_future = client->async_send_request(request);
+  auto later_future = client->async_send_request(request, 1h);
+  bool callback_timed_out = false;
+  client->async_send_request(
+    request, [&callback_timed_out](Empty::Response::SharedPtr response) {
+      callback_timed_out = (nullptr == response);
+    }, 0ms);
+
+  EXPECT_EQ(2u, client->expire_timed_out_requests());
+  EXPECT_TRUE(callback_timed_out);
+  ASSERT_EQ(std::future_status::ready, future.wait_for(0s));
+  EXPECT_THROW(future.get(), rclcpp::exceptions::RequestTimeoutError);
+  EXPECT_FALSE(client->remove_pending_request(future));
+  EXPECT_EQ(0u, client->expire_timed_out_requests());
+  EXPECT_TRUE(client->remove_pending_request(untimed_future));
+  EXPECT_TRUE(client->remove_pending_request(later_future));
+}
+
+TEST_F(TestClientWithServer, request_timeout_timer) {
+  using test_msgs::srv::Empty;
+
+  auto client = node->create_client<Empty>("no_service_server_available_here");
+  auto timer = rclcpp::create_request_timeout_timer<Empty>(node, client, 1ms);
+  auto request = std::make_shared<Empty::Request>();
+  auto future = client->async_send_request(request, 10ms);
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  ASSERT_EQ(
+    rclcpp::FutureReturnCode::SUCCESS,
+    executor.spin_until_future_complete(future.future, std::chrono::seconds(5)));
+  EXPECT_THROW(future.get(), rclcpp::exceptions::RequestTimeoutError);
+
+  // The requests answered before their timeout complete as usual.
+  auto answered_client = node->create_client<Empty>(service_name);
+  ASSERT_TRUE(answered_client->wait_for_service(std::chrono::seconds(1)));
+  auto answered_timer = rclcpp::create_request_timeout_timer<Empty>(node, answered_client, 1ms);
+  auto answered_future = answered_client->async_send_request(request, 5s);
+  ASSERT_EQ(
+    rclcpp::FutureReturnCode::SUCCESS,
+    executor.spin_until_future_complete(answered_future.future, std::chrono::seconds(5)));
+  EXPECT_NE(nullptr, answered_future.get());
+  EXPECT_EQ(0u, answered_client->expire_timed_out_requests());
+}
+
 TEST_F(TestClientWithServer, async_send_request_rcl_send_request_error) {
   // Checking rcl_send_request in rclcpp::Client::async_send_request()
   auto mock = mocking_utils::patch_and_return("lib:rclcpp", rcl_send_request, RCL_RET_ERROR);
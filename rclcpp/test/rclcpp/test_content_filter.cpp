@@ -0,0 +1,170 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rclcpp/detail/content_filter.hpp"
+#include "rclcpp/serialization.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rosidl_typesupport_cpp/message_type_support.hpp"
+
+#include "test_msgs/msg/arrays.hpp"
+#include "test_msgs/msg/basic_types.hpp"
+#include "test_msgs/msg/nested.hpp"
+#include "test_msgs/msg/strings.hpp"
+#include "test_msgs/msg/unbounded_sequences.hpp"
+
+using rclcpp::detail::ContentFilter;
+
+template<typename MessageT>
+bool
+evaluate(
+  const MessageT & message,
+  const std::string & expression,
+  const std::vector<std::string> & parameters = {})
+{
+  ContentFilter filter(
+    *rosidl_typesupport_cpp::get_message_type_support_handle<MessageT>(), expression, parameters);
+  return filter.evaluate(&message);
+}
+
+/// Evaluate a filter on a serialized message, returning false if it has to be deserialized.
+template<typename MessageT>
+bool
+evaluate_serialized(
+  const MessageT & message,
+  const std::string & expression,
+  bool & matches)
+{
+  ContentFilter filter(
+    *rosidl_typesupport_cpp::get_message_type_support_handle<MessageT>(), expression, {});
+  rclcpp::Serialization<MessageT> serialization;
+  rclcpp::SerializedMessage serialized_message;
+  serialization.serialize_message(&message, &serialized_message);
+  const bool evaluated =
+    filter.evaluate_serialized(serialized_message.get_rcl_serialized_message(), matches);
+  EXPECT_EQ(filter.can_evaluate_serialized(), evaluated);
+  EXPECT_TRUE(!evaluated || filter.evaluate(&message) == matches) << expression;
+  return evaluated;
+}
+
+TEST(TestContentFilter, numbers) {
+  test_msgs::msg::BasicTypes message;
+  message.int32_value = -3;
+  message.uint8_value = 200;
+  message.float64_value = 2.5;
+  message.bool_value = true;
+
+  EXPECT_TRUE(evaluate(message, "int32_value = -3"));
+  EXPECT_FALSE(evaluate(message, "int32_value <> -3"));
+  EXPECT_TRUE(evaluate(message, "int32_value < 0 AND uint8_value >= 200"));
+  EXPECT_TRUE(evaluate(message, "int32_value > 0 or uint8_value > 100"));
+  EXPECT_FALSE(evaluate(message, "NOT (int32_value = -3 OR uint8_value = 0)"));
+  EXPECT_TRUE(evaluate(message, "uint8_value > -1"));
+  EXPECT_TRUE(evaluate(message, "uint8_value = 0xC8"));
+  EXPECT_TRUE(evaluate(message, "float64_value BETWEEN 2 AND 3"));
+  EXPECT_FALSE(evaluate(message, "float64_value NOT BETWEEN 2 AND 3"));
+  EXPECT_TRUE(evaluate(message, "float64_value > 2.25e0"));
+  EXPECT_TRUE(evaluate(message, "bool_value = TRUE"));
+  EXPECT_TRUE(evaluate(message, "int32_value = %0 AND uint8_value != %1", {"-3", "1"}));
+}
+
+TEST(TestContentFilter, strings) {
+  test_msgs::msg::Strings message;
+  message.string_value = "base_link";
+
+  EXPECT_TRUE(evaluate(message, "string_value = 'base_link'"));
+  EXPECT_TRUE(evaluate(message, "string_value = %0", {"'base_link'"}));
+  EXPECT_TRUE(evaluate(message, "string_value < 'c'"));
+  EXPECT_TRUE(evaluate(message, "string_value LIKE 'base%'"));
+  EXPECT_TRUE(evaluate(message, "string_value LIKE '%_link'"));
+  EXPECT_FALSE(evaluate(message, "string_value LIKE 'b_se'"));
+}
+
+TEST(TestContentFilter, nested_fields_and_sequences) {
+  test_msgs::msg::Nested nested;
+  nested.basic_types_value.int16_value = 7;
+  EXPECT_TRUE(evaluate(nested, "basic_types_value.int16_value = 7"));
+
+  test_msgs::msg::UnboundedSequences sequences;
+  sequences.int32_values = {1, 2};
+  sequences.bool_values = {false, true};
+  EXPECT_TRUE(evaluate(sequences, "int32_values[1] = 2"));
+  EXPECT_TRUE(evaluate(sequences, "bool_values[1] = TRUE AND bool_values[0] = FALSE"));
+  // The elements past the end of a sequence match no comparison.
+  EXPECT_FALSE(evaluate(sequences, "int32_values[2] = 0"));
+  EXPECT_FALSE(evaluate(sequences, "int32_values[2] <> 0"));
+}
+
+TEST(TestContentFilter, invalid_expressions) {
+  test_msgs::msg::BasicTypes message;
+  for (const char * expression : {
+      "", "int32_value", "int32_value =", "int32_value = 1 )", "(int32_value = 1",
+      "int32_value = 'a'", "int32_value LIKE 'a'", "int32_value # 1", "int32_value = 1.2.3",
+      "int32_value[0] = 1", "unknown_value = 1", "int32_value = 'a"})
+  {
+    EXPECT_THROW(evaluate(message, expression), std::invalid_argument) << expression;
+  }
+  EXPECT_THROW(evaluate(message, "int32_value = %0"), std::invalid_argument);
+  EXPECT_THROW(evaluate(message, "int32_value = %0", {"1 2"}), std::invalid_argument);
+
+  test_msgs::msg::Nested nested;
+  EXPECT_THROW(evaluate(nested, "basic_types_value = 1"), std::invalid_argument);
+  test_msgs::msg::UnboundedSequences sequences;
+  EXPECT_THROW(evaluate(sequences, "int32_values = 1"), std::invalid_argument);
+}
+
+TEST(TestContentFilter, serialized_messages) {
+  bool matches = false;
+  test_msgs::msg::BasicTypes basic_types;
+  basic_types.int32_value = -3;
+  basic_types.float64_value = 2.5;
+  basic_types.bool_value = true;
+  EXPECT_TRUE(evaluate_serialized(basic_types, "int32_value = -3 AND float64_value > 2", matches));
+  EXPECT_TRUE(matches);
+  EXPECT_TRUE(evaluate_serialized(basic_types, "bool_value = FALSE OR uint64_value > 0", matches));
+  EXPECT_FALSE(matches);
+
+  test_msgs::msg::Arrays arrays;
+  arrays.float32_values = {1.f, 2.f, 3.f};
+  arrays.int64_values = {0, 0, -7};
+  arrays.basic_types_values[1].uint16_value = 12;
+  EXPECT_TRUE(
+    evaluate_serialized(arrays, "float32_values[2] = 3 AND int64_values[2] < 0", matches));
+  EXPECT_TRUE(matches);
+  // The array of strings precedes the array of messages.
+  EXPECT_FALSE(evaluate_serialized(arrays, "basic_types_values[1].uint16_value = 12", matches));
+
+  test_msgs::msg::Nested nested;
+  nested.basic_types_value.int16_value = 7;
+  EXPECT_TRUE(evaluate_serialized(nested, "basic_types_value.int16_value = 6", matches));
+  EXPECT_FALSE(matches);
+
+  // A string field is read if it's only preceded by fields of fixed size, unlike the following.
+  test_msgs::msg::Strings strings;
+  strings.string_value = "base_link";
+  strings.string_value_default1 = "a";
+  EXPECT_TRUE(evaluate_serialized(strings, "string_value LIKE 'base%'", matches));
+  EXPECT_TRUE(matches);
+  EXPECT_FALSE(evaluate_serialized(strings, "string_value_default1 = 'a'", matches));
+
+  test_msgs::msg::UnboundedSequences sequences;
+  sequences.int32_values = {1};
+  EXPECT_FALSE(evaluate_serialized(sequences, "int32_values[0] = 1", matches));
+}
@@ -0,0 +1,103 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+#include "rclcpp/contexts/context_shards.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "test_msgs/msg/empty.hpp"
+
+using rclcpp::contexts::ContextShards;
+
+namespace
+{
+
+rclcpp::InitOptions
+make_init_options()
+{
+  return rclcpp::InitOptions().auto_initialize_logging(false);
+}
+
+}  // namespace
+
+TEST(TestContextShards, contexts) {
+  ContextShards shards(3u, 0, nullptr, make_init_options());
+  ASSERT_EQ(3u, shards.size());
+  std::set<rclcpp::Context::SharedPtr> contexts;
+  for (size_t i = 0; i < shards.size(); ++i) {
+    auto context = shards.get_context(i);
+    ASSERT_TRUE(context);
+    EXPECT_TRUE(context->is_valid());
+    EXPECT_TRUE(context->get_init_options().share_intra_process_manager());
+    contexts.insert(context);
+  }
+  EXPECT_EQ(3u, contexts.size());
+  EXPECT_THROW(shards.get_context(3u), std::out_of_range);
+
+  // A node always gets the same context
+  auto context = shards.get_context_for_node("node", "/ns");
+  EXPECT_EQ(1u, contexts.count(context));
+  EXPECT_EQ(context, shards.get_context_for_node("node", "/ns"));
+  EXPECT_EQ(context, shards.node_options("node", "/ns").context());
+
+  EXPECT_TRUE(shards.shutdown("test"));
+  for (const auto & shard_context : shards.get_contexts()) {
+    EXPECT_FALSE(shard_context->is_valid());
+  }
+  EXPECT_FALSE(shards.shutdown("test"));
+}
+
+TEST(TestContextShards, one_per_hardware_thread) {
+  ContextShards shards(0u, 0, nullptr, make_init_options());
+  EXPECT_LE(1u, shards.size());
+}
+
+TEST(TestContextShards, intra_process_across_shards) {
+  ContextShards shards(2u, 0, nullptr, make_init_options());
+  auto options = rclcpp::NodeOptions().use_intra_process_comms(true);
+  auto publisher_node = std::make_shared<rclcpp::Node>(
+    "publisher_node", "/ns",
+    rclcpp::NodeOptions(options).context(shards.get_context(0u)));
+  auto subscription_node = std::make_shared<rclcpp::Node>(
+    "subscription_node", "/ns",
+    rclcpp::NodeOptions(options).context(shards.get_context(1u)));
+
+  bool received = false;
+  auto subscription = subscription_node->create_subscription<test_msgs::msg::Empty>(
+    "topic", 10,
+    [&received](test_msgs::msg::Empty::ConstSharedPtr) {
+      received = true;
+    });
+  auto publisher = publisher_node->create_publisher<test_msgs::msg::Empty>("topic", 10);
+  EXPECT_EQ(1u, publisher->get_intra_process_subscription_count());
+
+  publisher->publish(test_msgs::msg::Empty());
+  rclcpp::ExecutorOptions executor_options;
+  executor_options.context = shards.get_context(1u);
+  rclcpp::executors::SingleThreadedExecutor executor(executor_options);
+  executor.add_node(subscription_node);
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!received && std::chrono::steady_clock::now() < deadline) {
+    executor.spin_some();
+  }
+  EXPECT_TRUE(received);
+}
@@ -0,0 +1,146 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/experimental/coroutines.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "test_msgs/msg/strings.hpp"
+#include "test_msgs/srv/basic_types.hpp"
+
+#ifdef RCLCPP_HAS_COROUTINES
+
+using namespace std::chrono_literals;
+
+class TestCoroutines : public ::testing::Test
+{
+protected:
+  void SetUp()
+  {
+    rclcpp::init(0, nullptr);
+    node = std::make_shared<rclcpp::Node>("test_coroutines", "/ns");
+  }
+
+  void TearDown()
+  {
+    node.reset();
+    rclcpp::shutdown();
+  }
+
+  rclcpp::Node::SharedPtr node;
+};
+
+TEST_F(TestCoroutines, callback_awaiter) {
+  rclcpp::experimental::CallbackAwaiter<int> completed_awaiter;
+  completed_awaiter.get_completer()(1);
+  rclcpp::experimental::CallbackAwaiter<int> awaiter;
+  std::vector<int> values;
+
+  auto coroutine = [&]() -> rclcpp::experimental::Task {
+      // The first awaiter is already completed, so it doesn't suspend the coroutine.
+      values.push_back(co_await completed_awaiter);
+      values.push_back(co_await awaiter);
+    };
+  coroutine();
+  EXPECT_EQ(std::vector<int>({1}), values);
+  awaiter.get_completer()(2);
+  EXPECT_EQ(std::vector<int>({1, 2}), values);
+}
+
+TEST_F(TestCoroutines, service_calls_and_sleep) {
+  using ServiceT = test_msgs::srv::BasicTypes;
+  auto service = node->create_service<ServiceT>(
+    "service",
+    [](const ServiceT::Request::SharedPtr request, ServiceT::Response::SharedPtr response) {
+      response->int64_value = request->int64_value + 1;
+    });
+  auto client = node->create_client<ServiceT>("service");
+  ASSERT_TRUE(client->wait_for_service(5s));
+
+  bool done = false;
+  int64_t value = 0;
+  auto coroutine = [&]() -> rclcpp::experimental::Task {
+      // The calls are chained, each one being sent once the previous response is received.
+      for (int i = 0; i < 3; ++i) {
+        auto request = std::make_shared<ServiceT::Request>();
+        request->int64_value = value;
+        auto response = co_await rclcpp::experimental::async_send_request<ServiceT>(
+          client, request);
+        value = response->int64_value;
+      }
+      const auto start = std::chrono::steady_clock::now();
+      co_await rclcpp::experimental::sleep_for(node, 10ms);
+      EXPECT_GE(std::chrono::steady_clock::now() - start, 10ms);
+      done = true;
+    };
+  coroutine();
+  EXPECT_FALSE(done);
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  const auto end = std::chrono::steady_clock::now() + 10s;
+  while (!done && std::chrono::steady_clock::now() < end) {
+    executor.spin_once(10ms);
+  }
+  EXPECT_TRUE(done);
+  EXPECT_EQ(3, value);
+}
+
+TEST_F(TestCoroutines, message_stream) {
+  rclcpp::experimental::MessageStream<test_msgs::msg::Strings> stream(
+    node, "topic", rclcpp::QoS(2));
+  auto publisher = node->create_publisher<test_msgs::msg::Strings>("topic", 10);
+
+  std::vector<std::string> received;
+  auto coroutine = [&]() -> rclcpp::experimental::Task {
+      for (int i = 0; i < 2; ++i) {
+        auto message = co_await stream.next();
+        received.push_back(message->string_value);
+      }
+    };
+  coroutine();
+  EXPECT_THROW(stream.next(), std::logic_error);
+
+  auto end = std::chrono::steady_clock::now() + 10s;
+  while (publisher->get_subscription_count() == 0u && std::chrono::steady_clock::now() < end) {
+    std::this_thread::sleep_for(10ms);
+  }
+  ASSERT_EQ(1u, publisher->get_subscription_count());
+  for (const std::string & string_value : {"0", "1"}) {
+    test_msgs::msg::Strings message;
+    message.string_value = string_value;
+    publisher->publish(message);
+  }
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  end = std::chrono::steady_clock::now() + 10s;
+  while (received.size() < 2u && std::chrono::steady_clock::now() < end) {
+    executor.spin_once(10ms);
+  }
+  ASSERT_EQ(2u, received.size());
+  EXPECT_EQ("0", received[0]);
+  EXPECT_EQ("1", received[1]);
+}
+
+#endif  // RCLCPP_HAS_COROUTINES
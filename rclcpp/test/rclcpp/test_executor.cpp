@@ -15,10 +15,15 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <functional>
+#include <future>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "rclcpp/detail/future_waiters.hpp"
 #include "rclcpp/executor.hpp"
 #include "rclcpp/memory_strategy.hpp"
 #include "rclcpp/executors/single_threaded_executor.hpp"
@@ -189,6 +194,37 @@ TEST_F(TestExecutor, remove_callback_group_failed_trigger_guard_condition) {
       "Failed to trigger guard condition on callback group remove: error not set"));
 }
 
+TEST_F(TestExecutor, add_remove_many_callback_groups_of_node) {
+  DummyExecutor dummy;
+  auto node = std::make_shared<rclcpp::Node>("node", "ns");
+  std::vector<rclcpp::CallbackGroup::SharedPtr> cb_groups;
+  for (size_t i = 0; i < 10u; ++i) {
+    cb_groups.push_back(
+      node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive, false));
+    dummy.add_callback_group(cb_groups.back(), node->get_node_base_interface(), false);
+  }
+  EXPECT_EQ(10u, dummy.get_manually_added_callback_groups().size());
+
+  // Removing the groups in another order than they were added
+  for (size_t i = 0; i < cb_groups.size(); i += 2) {
+    dummy.remove_callback_group(cb_groups[i], false);
+  }
+  EXPECT_EQ(5u, dummy.get_manually_added_callback_groups().size());
+  for (size_t i = 1; i < cb_groups.size(); i += 2) {
+    dummy.remove_callback_group(cb_groups[i], false);
+  }
+  EXPECT_TRUE(dummy.get_manually_added_callback_groups().empty());
+
+  // The groups can be added again, to this executor or to another one
+  DummyExecutor other_dummy;
+  dummy.add_callback_group(cb_groups[0], node->get_node_base_interface(), false);
+  other_dummy.add_callback_group(cb_groups[1], node->get_node_base_interface(), false);
+  EXPECT_EQ(1u, dummy.get_manually_added_callback_groups().size());
+  EXPECT_EQ(1u, other_dummy.get_manually_added_callback_groups().size());
+  dummy.remove_callback_group(cb_groups[0], false);
+  other_dummy.remove_callback_group(cb_groups[1], false);
+}
+
 TEST_F(TestExecutor, remove_node_not_associated) {
   DummyExecutor dummy;
   auto node = std::make_shared<rclcpp::Node>("node", "ns");
@@ -482,6 +518,48 @@ TEST_F(TestExecutor, get_group_by_timer_add_callback_group) {
   ASSERT_EQ(cb_group.get(), dummy.local_get_group_by_timer(timer).get());
 }
 
+TEST_F(TestExecutor, callback_group_entities) {
+  auto node = std::make_shared<rclcpp::Node>("node", "ns");
+  rclcpp::CallbackGroup::SharedPtr cb_group = node->create_callback_group(
+    rclcpp::CallbackGroupType::MutuallyExclusive);
+  auto timer =
+    node->create_wall_timer(std::chrono::milliseconds(1), [&]() {}, cb_group);
+
+  auto entities = cb_group->get_entities();
+  EXPECT_EQ(cb_group->get_generation(), entities->generation);
+  ASSERT_EQ(1u, entities->timers.size());
+  EXPECT_EQ(timer, entities->timers[0].lock());
+  // The copy is shared until the group changes
+  EXPECT_EQ(entities, cb_group->get_entities());
+
+  auto other_timer =
+    node->create_wall_timer(std::chrono::milliseconds(1), [&]() {}, cb_group);
+  auto new_entities = cb_group->get_entities();
+  EXPECT_NE(entities, new_entities);
+  EXPECT_EQ(cb_group->get_generation(), new_entities->generation);
+  EXPECT_EQ(2u, new_entities->timers.size());
+  // The previous copy is unchanged
+  EXPECT_EQ(1u, entities->timers.size());
+
+  // The entities can be found while iterating them
+  size_t number_of_timers = 0u;
+  cb_group->collect_all_ptrs(
+    [](const rclcpp::SubscriptionBase::SharedPtr &) {},
+    [](const rclcpp::ServiceBase::SharedPtr &) {},
+    [](const rclcpp::ClientBase::SharedPtr &) {},
+    [&number_of_timers, &cb_group](const rclcpp::TimerBase::SharedPtr & timer_ptr) {
+      ++number_of_timers;
+      EXPECT_EQ(
+        timer_ptr,
+        cb_group->find_timer_ptrs_if(
+          [&timer_ptr](const rclcpp::TimerBase::SharedPtr & other) {
+            return other == timer_ptr;
+          }));
+    },
+    [](const rclcpp::Waitable::SharedPtr &) {});
+  EXPECT_EQ(2u, number_of_timers);
+}
+
 TEST_F(TestExecutor, spin_until_future_complete_in_spin_until_future_complete) {
   DummyExecutor dummy;
   auto node = std::make_shared<rclcpp::Node>("node", "ns");
@@ -557,6 +635,27 @@ TEST_F(TestExecutor, spin_until_future_complete_future_already_complete) {
     dummy.spin_until_future_complete(future, std::chrono::milliseconds(1)));
 }
 
+TEST_F(TestExecutor, spin_until_future_complete_notified_by_other_thread) {
+  DummyExecutor dummy;
+  auto node = std::make_shared<rclcpp::Node>("node", "ns");
+  dummy.add_node(node);
+  std::promise<void> promise;
+  std::future<void> future = promise.get_future();
+  std::thread thread([&promise]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      promise.set_value();
+      rclcpp::detail::notify_future_waiters();
+    });
+
+  // Nothing else wakes up the executor before the timeout.
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(
+    rclcpp::FutureReturnCode::SUCCESS,
+    dummy.spin_until_future_complete(future, std::chrono::seconds(10)));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+  thread.join();
+}
+
 TEST_F(TestExecutor, is_spinning) {
   DummyExecutor dummy;
   ASSERT_FALSE(dummy.is_spinning());
@@ -577,3 +676,62 @@ TEST_F(TestExecutor, is_spinning) {
 
   ASSERT_TRUE(timer_called);
 }
+
+TEST_F(TestExecutor, scheduling_policies) {
+  auto run_ready_timers = [](
+    rclcpp::ExecutorSchedulingPolicy scheduling_policy,
+    std::function<void(rclcpp::CallbackGroup &, rclcpp::CallbackGroup &)> configure)
+    {
+      rclcpp::ExecutorOptions options;
+      options.scheduling_policy = scheduling_policy;
+      rclcpp::executors::SingleThreadedExecutor executor(options);
+
+      auto node = std::make_shared<rclcpp::Node>("node", "ns");
+      auto first_group = node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+      auto second_group = node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+      configure(*first_group, *second_group);
+
+      std::vector<std::string> order;
+      auto first_timer = node->create_wall_timer(
+        std::chrono::milliseconds(1), [&order]() {order.push_back("first");}, first_group);
+      auto second_timer = node->create_wall_timer(
+        std::chrono::milliseconds(1), [&order]() {order.push_back("second");}, second_group);
+
+      executor.add_node(node);
+      // Wait for both wall timers to have expired.
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      executor.spin_some();
+      return order;
+    };
+
+  auto order = run_ready_timers(
+    rclcpp::ExecutorSchedulingPolicy::Priority,
+    [](rclcpp::CallbackGroup & first, rclcpp::CallbackGroup & second) {
+      first.set_priority(1);
+      second.set_priority(2);
+    });
+  EXPECT_EQ((std::vector<std::string>{"second", "first"}), order);
+
+  order = run_ready_timers(
+    rclcpp::ExecutorSchedulingPolicy::Priority,
+    [](rclcpp::CallbackGroup & first, rclcpp::CallbackGroup & second) {
+      first.set_priority(3);
+      second.set_priority(-1);
+    });
+  EXPECT_EQ((std::vector<std::string>{"first", "second"}), order);
+
+  order = run_ready_timers(
+    rclcpp::ExecutorSchedulingPolicy::EarliestDeadlineFirst,
+    [](rclcpp::CallbackGroup & first, rclcpp::CallbackGroup & second) {
+      first.set_deadline(std::chrono::milliseconds(10));
+      second.set_deadline(std::chrono::milliseconds(5));
+    });
+  EXPECT_EQ((std::vector<std::string>{"second", "first"}), order);
+
+  order = run_ready_timers(
+    rclcpp::ExecutorSchedulingPolicy::EarliestDeadlineFirst,
+    [](rclcpp::CallbackGroup & first, rclcpp::CallbackGroup &) {
+      first.set_deadline(std::chrono::milliseconds(10));
+    });
+  EXPECT_EQ((std::vector<std::string>{"first", "second"}), order);
+}
@@ -0,0 +1,297 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "rclcpp/executor_statistics.hpp"
+#include "rclcpp/executor_statistics_publisher.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "statistics_msgs/msg/metrics_message.hpp"
+
+using namespace std::chrono_literals;
+
+class TestExecutorStatistics : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+};
+
+TEST_F(TestExecutorStatistics, histogram) {
+  rclcpp::LatencyHistogram histogram;
+  histogram.record(500ns);
+  histogram.record(3us);
+  histogram.record(3us);
+  histogram.record(1s);
+
+  auto snapshot = histogram.get_snapshot();
+  EXPECT_EQ(4u, snapshot.count);
+  EXPECT_EQ(std::chrono::nanoseconds(1s), snapshot.max);
+  EXPECT_EQ(snapshot.total / 4, snapshot.mean());
+  EXPECT_EQ(1u, snapshot.buckets[0]);
+  // 3 microseconds are in [2, 4).
+  EXPECT_EQ(2u, snapshot.buckets[2]);
+  EXPECT_EQ(std::chrono::nanoseconds(4us), snapshot.percentile(50.0));
+  EXPECT_EQ(std::chrono::nanoseconds(1s), snapshot.percentile(100.0));
+
+  histogram.reset();
+  snapshot = histogram.get_snapshot();
+  EXPECT_EQ(0u, snapshot.count);
+  EXPECT_EQ(0u, snapshot.buckets[2]);
+  EXPECT_EQ(std::chrono::nanoseconds(0), snapshot.mean());
+}
+
+TEST_F(TestExecutorStatistics, timer_statistics) {
+  auto statistics = std::make_shared<rclcpp::ExecutorStatistics>();
+  rclcpp::ExecutorOptions options;
+  options.statistics = statistics;
+  rclcpp::executors::SingleThreadedExecutor executor(options);
+
+  auto node = std::make_shared<rclcpp::Node>("test_executor_statistics");
+  int count = 0;
+  auto timer = node->create_wall_timer(
+    1ms, [&count]() {
+      std::this_thread::sleep_for(2ms);
+      count++;
+    });
+  executor.add_node(node);
+
+  auto start = std::chrono::steady_clock::now();
+  while (count < 3 && std::chrono::steady_clock::now() - start < 5s) {
+    executor.spin_once(10ms);
+  }
+  ASSERT_EQ(3, count);
+
+  EXPECT_LT(0u, statistics->get_wait_time().count);
+
+  auto entity_statistics = statistics->get_entity_statistics();
+  ASSERT_EQ(1u, entity_statistics.count(timer.get()));
+  const auto & timer_statistics = entity_statistics[timer.get()];
+  EXPECT_EQ("timer", timer_statistics.description);
+  EXPECT_EQ(3u, timer_statistics.callback_duration.count);
+  EXPECT_EQ(3u, timer_statistics.dispatch_latency.count);
+  EXPECT_LE(std::chrono::nanoseconds(2ms), timer_statistics.callback_duration.max);
+
+  auto group_statistics = statistics->get_callback_group_statistics();
+  auto group = node->get_node_base_interface()->get_default_callback_group();
+  ASSERT_EQ(1u, group_statistics.count(group.get()));
+  EXPECT_EQ(3u, group_statistics[group.get()].callback_duration.count);
+
+  statistics->reset();
+  EXPECT_EQ(0u, statistics->get_entity_statistics()[timer.get()].callback_duration.count);
+}
+
+TEST_F(TestExecutorStatistics, loop_statistics) {
+  auto statistics = std::make_shared<rclcpp::ExecutorStatistics>();
+  rclcpp::ExecutorOptions options;
+  options.statistics = statistics;
+  rclcpp::executors::SingleThreadedExecutor executor(options);
+
+  auto node = std::make_shared<rclcpp::Node>("test_executor_loop_statistics");
+  int count = 0;
+  auto timer = node->create_wall_timer(
+    1ms, [&count]() {
+      std::this_thread::sleep_for(2ms);
+      count++;
+    });
+  executor.add_node(node);
+
+  // Measure the first window from here
+  statistics->take_loop_statistics();
+  auto start = std::chrono::steady_clock::now();
+  while (count < 3 && std::chrono::steady_clock::now() - start < 5s) {
+    executor.spin_once(10ms);
+  }
+  ASSERT_EQ(3, count);
+
+  const auto loop_statistics = statistics->take_loop_statistics();
+  EXPECT_LT(std::chrono::nanoseconds::zero(), loop_statistics.window_duration);
+  EXPECT_LE(3u, loop_statistics.wait_duration.sample_count);
+  EXPECT_LT(0., loop_statistics.wakeups_per_second());
+  EXPECT_EQ(loop_statistics.wait_duration.sample_count, loop_statistics.wait_set_size.sample_count);
+  // The timer and the guard conditions of the executor and the node are waited on
+  EXPECT_LE(2., loop_statistics.wait_set_size.min);
+  EXPECT_EQ(
+    loop_statistics.wait_duration.sample_count,
+    loop_statistics.collection_duration.sample_count);
+  EXPECT_EQ(3u, loop_statistics.execution_duration.sample_count);
+  EXPECT_LE(2., loop_statistics.execution_duration.min);
+  EXPECT_LE(
+    loop_statistics.execution_duration.min, loop_statistics.execution_duration_percentiles.p50);
+  EXPECT_LE(
+    loop_statistics.execution_duration_percentiles.p50,
+    loop_statistics.execution_duration_percentiles.p999);
+  EXPECT_GE(
+    loop_statistics.execution_duration.max, loop_statistics.execution_duration_percentiles.p999);
+  // Only the thread of the test spun the executor
+  EXPECT_EQ(1u, loop_statistics.idle_ratio.sample_count);
+  EXPECT_LE(0., loop_statistics.idle_ratio.min);
+  EXPECT_GE(1., loop_statistics.idle_ratio.max);
+
+  const auto empty_loop_statistics = statistics->take_loop_statistics();
+  EXPECT_EQ(0u, empty_loop_statistics.wait_duration.sample_count);
+  EXPECT_EQ(0u, empty_loop_statistics.execution_duration.sample_count);
+  EXPECT_TRUE(std::isnan(empty_loop_statistics.execution_duration_percentiles.p50));
+  EXPECT_EQ(0u, empty_loop_statistics.idle_ratio.sample_count);
+}
+
+TEST_F(TestExecutorStatistics, statistics_publisher) {
+  auto statistics = std::make_shared<rclcpp::ExecutorStatistics>();
+  rclcpp::ExecutorOptions options;
+  options.statistics = statistics;
+  rclcpp::executors::SingleThreadedExecutor executor(options);
+
+  auto node = std::make_shared<rclcpp::Node>("test_executor_statistics_publisher");
+  EXPECT_THROW(
+    rclcpp::create_executor_statistics_publisher(node, statistics, 0ms), std::invalid_argument);
+  EXPECT_THROW(
+    rclcpp::create_executor_statistics_publisher(node, nullptr), std::invalid_argument);
+
+  auto statistics_publisher = rclcpp::create_executor_statistics_publisher(
+    node, statistics, 10ms, "/test_executor_statistics_topic");
+
+  std::set<std::string> received_metrics;
+  auto subscription = node->create_subscription<statistics_msgs::msg::MetricsMessage>(
+    "/test_executor_statistics_topic", 10,
+    [&received_metrics](statistics_msgs::msg::MetricsMessage::UniquePtr msg) {
+      EXPECT_EQ("test_executor_statistics_publisher", msg->measurement_source_name);
+      received_metrics.insert(msg->metrics_source);
+    });
+  executor.add_node(node);
+
+  auto start = std::chrono::steady_clock::now();
+  while (received_metrics.size() < 6u && std::chrono::steady_clock::now() - start < 5s) {
+    executor.spin_once(10ms);
+  }
+  EXPECT_EQ(1u, received_metrics.count(rclcpp::kExecutorWaitSetSizeStatName));
+  EXPECT_EQ(1u, received_metrics.count(rclcpp::kExecutorWakeupsStatName));
+  EXPECT_EQ(1u, received_metrics.count(rclcpp::kExecutorWaitDurationStatName));
+  EXPECT_EQ(1u, received_metrics.count(rclcpp::kExecutorCollectionDurationStatName));
+  EXPECT_EQ(1u, received_metrics.count(rclcpp::kExecutorExecutionDurationStatName));
+  EXPECT_EQ(1u, received_metrics.count(rclcpp::kExecutorIdleRatioStatName));
+}
+
+TEST_F(TestExecutorStatistics, callback_group_cpu_accounting) {
+  auto group = std::make_shared<rclcpp::CallbackGroup>(
+    rclcpp::CallbackGroupType::MutuallyExclusive);
+  EXPECT_FALSE(group->is_cpu_accounting_enabled());
+  EXPECT_THROW(group->enable_cpu_accounting(-1ms), std::invalid_argument);
+
+  group->enable_cpu_accounting(2ms);
+  EXPECT_TRUE(group->is_cpu_accounting_enabled());
+  EXPECT_EQ(std::chrono::nanoseconds(2ms), group->get_cpu_budget());
+  group->record_cpu_time(1ms);
+  group->record_cpu_time(3ms);
+  auto cpu_statistics = group->get_cpu_statistics();
+  EXPECT_EQ(2u, cpu_statistics.executions);
+  EXPECT_EQ(std::chrono::nanoseconds(4ms), cpu_statistics.cpu_time);
+  EXPECT_EQ(std::chrono::nanoseconds(3ms), cpu_statistics.max_cpu_time);
+  EXPECT_EQ(1u, cpu_statistics.overruns);
+
+  group->reset_cpu_statistics();
+  cpu_statistics = group->get_cpu_statistics();
+  EXPECT_EQ(0u, cpu_statistics.executions);
+  EXPECT_EQ(std::chrono::nanoseconds::zero(), cpu_statistics.cpu_time);
+  EXPECT_EQ(0u, cpu_statistics.overruns);
+}
+
+TEST_F(TestExecutorStatistics, callback_group_cpu_time_of_executions) {
+  rclcpp::executors::SingleThreadedExecutor executor;
+  auto node = std::make_shared<rclcpp::Node>("test_callback_group_cpu_time");
+  auto group = node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+  group->enable_cpu_accounting(1ms);
+  int count = 0;
+  // The callback keeps the CPU busy, unlike a sleep
+  auto timer = node->create_wall_timer(
+    1ms, [&count]() {
+      const auto start = std::chrono::steady_clock::now();
+      while (std::chrono::steady_clock::now() - start < 3ms) {
+      }
+      count++;
+    }, group);
+  executor.add_node(node);
+
+  auto start = std::chrono::steady_clock::now();
+  while (count < 3 && std::chrono::steady_clock::now() - start < 5s) {
+    executor.spin_once(10ms);
+  }
+  ASSERT_EQ(3, count);
+
+  const auto cpu_statistics = group->get_cpu_statistics();
+  EXPECT_EQ(3u, cpu_statistics.executions);
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+  EXPECT_LT(std::chrono::nanoseconds(1ms), cpu_statistics.max_cpu_time);
+  EXPECT_LE(cpu_statistics.max_cpu_time, cpu_statistics.cpu_time);
+  EXPECT_LE(1u, cpu_statistics.overruns);
+#endif
+
+  group->disable_cpu_accounting();
+  count = 0;
+  start = std::chrono::steady_clock::now();
+  while (count < 1 && std::chrono::steady_clock::now() - start < 5s) {
+    executor.spin_once(10ms);
+  }
+  EXPECT_EQ(3u, group->get_cpu_statistics().executions);
+}
+
+TEST_F(TestExecutorStatistics, statistics_publisher_callback_groups) {
+  auto statistics = std::make_shared<rclcpp::ExecutorStatistics>();
+  rclcpp::ExecutorOptions options;
+  options.statistics = statistics;
+  rclcpp::executors::SingleThreadedExecutor executor(options);
+
+  auto node = std::make_shared<rclcpp::Node>("test_callback_group_statistics_publisher");
+  auto group = node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+  group->enable_cpu_accounting();
+  auto statistics_publisher = rclcpp::create_executor_statistics_publisher(
+    node, statistics, 10ms, "/test_callback_group_statistics_topic");
+  EXPECT_THROW(
+    statistics_publisher->add_callback_group("null", nullptr), std::invalid_argument);
+  statistics_publisher->add_callback_group("team_a", group);
+
+  std::set<std::string> received_metrics;
+  auto subscription = node->create_subscription<statistics_msgs::msg::MetricsMessage>(
+    "/test_callback_group_statistics_topic", 10,
+    [&received_metrics](statistics_msgs::msg::MetricsMessage::UniquePtr msg) {
+      if (msg->measurement_source_name == "test_callback_group_statistics_publisher/team_a") {
+        received_metrics.insert(msg->metrics_source);
+      }
+    });
+  executor.add_node(node);
+
+  auto start = std::chrono::steady_clock::now();
+  while (received_metrics.size() < 3u && std::chrono::steady_clock::now() - start < 5s) {
+    executor.spin_once(10ms);
+  }
+  EXPECT_EQ(1u, received_metrics.count(rclcpp::kCallbackGroupCpuUsageStatName));
+  EXPECT_EQ(1u, received_metrics.count(rclcpp::kCallbackGroupExecutionsStatName));
+  EXPECT_EQ(1u, received_metrics.count(rclcpp::kCallbackGroupOverrunsStatName));
+}
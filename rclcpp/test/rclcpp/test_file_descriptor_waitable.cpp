@@ -0,0 +1,143 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "rclcpp/file_descriptor_waitable.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "../utils/rclcpp_gtest_macros.hpp"
+
+#if defined(__linux__)
+
+class TestFileDescriptorWaitable : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+
+  void SetUp()
+  {
+    ASSERT_EQ(0, pipe(pipe_fds));
+  }
+
+  void TearDown()
+  {
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+  }
+
+  int pipe_fds[2] = {-1, -1};
+};
+
+TEST_F(TestFileDescriptorWaitable, construction_errors) {
+  auto handler = [](int, int) {};
+  RCLCPP_EXPECT_THROW_EQ(
+    rclcpp::FileDescriptorWaitable(-1, handler, POLLIN),
+    std::invalid_argument("the file descriptor of a waitable can't be negative"));
+  RCLCPP_EXPECT_THROW_EQ(
+    rclcpp::FileDescriptorWaitable(pipe_fds[0], nullptr, POLLIN),
+    std::invalid_argument("the handler of a file descriptor waitable is empty"));
+  RCLCPP_EXPECT_THROW_EQ(
+    rclcpp::FileDescriptorWaitable(pipe_fds[0], handler, 0),
+    std::invalid_argument("a file descriptor waitable has to wait for events"));
+}
+
+TEST_F(TestFileDescriptorWaitable, wait_set) {
+  std::string received;
+  auto waitable = std::make_shared<rclcpp::FileDescriptorWaitable>(
+    pipe_fds[0],
+    [&received](int fd, int revents) {
+      EXPECT_NE(0, revents & POLLIN);
+      char buffer[16];
+      const ssize_t size = read(fd, buffer, sizeof(buffer));
+      ASSERT_GT(size, 0);
+      received.append(buffer, static_cast<size_t>(size));
+    }, POLLIN);
+  EXPECT_EQ(pipe_fds[0], waitable->get_file_descriptor());
+
+  rclcpp::WaitSet wait_set;
+  wait_set.add_waitable(waitable);
+  EXPECT_EQ(rclcpp::WaitResultKind::Timeout, wait_set.wait(std::chrono::milliseconds(10)).kind());
+
+  // Written while waiting, the watcher thread wakes up the wait
+  std::thread writer(
+    [this]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      ASSERT_EQ(1, write(pipe_fds[1], "a", 1));
+    });
+  {
+    auto wait_result = wait_set.wait(std::chrono::seconds(5));
+    ASSERT_EQ(rclcpp::WaitResultKind::Ready, wait_result.kind());
+    ASSERT_TRUE(waitable->is_ready(nullptr));
+    auto data = waitable->take_data();
+    waitable->execute(data);
+  }
+  writer.join();
+  EXPECT_EQ("a", received);
+
+  // Already readable when waiting, the wait returns right away
+  ASSERT_EQ(1, write(pipe_fds[1], "b", 1));
+  {
+    auto wait_result = wait_set.wait(std::chrono::seconds(5));
+    ASSERT_EQ(rclcpp::WaitResultKind::Ready, wait_result.kind());
+    auto data = waitable->take_data();
+    waitable->execute(data);
+  }
+  EXPECT_EQ("ab", received);
+  EXPECT_EQ(nullptr, waitable->take_data());
+}
+
+TEST_F(TestFileDescriptorWaitable, executor) {
+  auto node = std::make_shared<rclcpp::Node>("test_file_descriptor_waitable");
+  rclcpp::executors::SingleThreadedExecutor executor;
+  std::promise<void> handled;
+  auto waitable = std::make_shared<rclcpp::FileDescriptorWaitable>(
+    pipe_fds[0],
+    [&handled](int fd, int) {
+      char buffer;
+      ASSERT_EQ(1, read(fd, &buffer, 1));
+      handled.set_value();
+    }, POLLIN);
+  node->get_node_waitables_interface()->add_waitable(waitable, nullptr);
+  executor.add_node(node);
+
+  ASSERT_EQ(1, write(pipe_fds[1], "a", 1));
+  EXPECT_EQ(
+    rclcpp::FutureReturnCode::SUCCESS,
+    executor.spin_until_future_complete(handled.get_future(), std::chrono::seconds(5)));
+  node->get_node_waitables_interface()->remove_waitable(waitable, nullptr);
+}
+
+#endif  // defined(__linux__)
@@ -15,9 +15,12 @@
 
 #include <gmock/gmock.h>
 
+#include <chrono>
 #include <future>
 #include <memory>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "test_msgs/message_fixtures.hpp"
@@ -263,3 +266,127 @@ TEST_F(RclcppGenericNodeFixture, generic_publisher_uses_qos)
   // It normally takes < 20ms, 5s chosen as "a very long time"
   ASSERT_TRUE(wait_for(connected, 5s));
 }
+
+TEST_F(RclcppGenericNodeFixture, intra_process_serialized_messages)
+{
+  using namespace std::chrono_literals;
+  std::string topic_name = "/intra_process_string_topic";
+  std::string topic_type = "test_msgs/msg/Strings";
+  rclcpp::PublisherOptions publisher_options;
+  publisher_options.use_intra_process_comm = rclcpp::IntraProcessSetting::Enable;
+  rclcpp::SubscriptionOptions subscription_options;
+  subscription_options.use_intra_process_comm = rclcpp::IntraProcessSetting::Enable;
+
+  std::vector<std::shared_ptr<rclcpp::SerializedMessage>> received_messages;
+  auto callback = [&received_messages](std::shared_ptr<rclcpp::SerializedMessage> message) {
+      received_messages.push_back(message);
+    };
+  auto subscription1 = node_->create_generic_subscription(
+    topic_name, topic_type, rclcpp::QoS(10), callback, subscription_options);
+  auto subscription2 = node_->create_generic_subscription(
+    topic_name, topic_type, rclcpp::QoS(10), callback, subscription_options);
+  auto publisher = node_->create_generic_publisher(
+    topic_name, topic_type, rclcpp::QoS(10), publisher_options);
+  EXPECT_EQ(2u, publisher->get_intra_process_subscription_count());
+
+  auto message = std::make_unique<rclcpp::SerializedMessage>(
+    serialize_message<std::string, test_msgs::msg::Strings>("Hello World"));
+  const auto * published_message = message.get();
+  publisher->publish(std::move(message));
+
+  ASSERT_TRUE(wait_for([&received_messages]() {return received_messages.size() >= 2;}, 5s));
+  // The callbacks may modify the messages, so the first one got a copy of the message, and
+  // the last one the published message, which was not copied.
+  ASSERT_EQ(2u, received_messages.size());
+  EXPECT_NE(published_message, received_messages[0].get());
+  EXPECT_EQ(published_message, received_messages[1].get());
+  for (const auto & received_message : received_messages) {
+    test_msgs::msg::Strings deserialized_message;
+    rclcpp::Serialization<test_msgs::msg::Strings>().deserialize_message(
+      received_message.get(), &deserialized_message);
+    EXPECT_EQ("Hello World", deserialized_message.string_value);
+  }
+
+  // Messages published intra-process are not received again through the middleware.
+  std::this_thread::sleep_for(100ms);
+  rclcpp::spin_some(node_);
+  EXPECT_EQ(2u, received_messages.size());
+}
+
+TEST_F(RclcppGenericNodeFixture, publish_serialized_message_view)
+{
+  using namespace std::chrono_literals;
+  std::string topic_name = "/view_string_topic";
+  std::string topic_type = "test_msgs/msg/Strings";
+  rclcpp::PublisherOptions publisher_options;
+  publisher_options.use_intra_process_comm = rclcpp::IntraProcessSetting::Enable;
+  rclcpp::SubscriptionOptions subscription_options;
+  subscription_options.use_intra_process_comm = rclcpp::IntraProcessSetting::Enable;
+
+  std::vector<std::shared_ptr<rclcpp::SerializedMessage>> received_messages;
+  auto subscription = node_->create_generic_subscription(
+    topic_name, topic_type, rclcpp::QoS(10),
+    [&received_messages](std::shared_ptr<rclcpp::SerializedMessage> message) {
+      received_messages.push_back(message);
+    }, subscription_options);
+  auto publisher = node_->create_generic_publisher(
+    topic_name, topic_type, rclcpp::QoS(10), publisher_options);
+
+  // The buffer of the view isn't owned by a serialized message, as for a memory-mapped file
+  auto serialized_message = serialize_message<std::string, test_msgs::msg::Strings>("Hello");
+  const auto & rcl_serialized_message = serialized_message.get_rcl_serialized_message();
+  std::vector<uint8_t> buffer(
+    rcl_serialized_message.buffer,
+    rcl_serialized_message.buffer + rcl_serialized_message.buffer_length);
+  rcl_serialized_message_t view = rmw_get_zero_initialized_serialized_message();
+  view.buffer = buffer.data();
+  view.buffer_length = buffer.size();
+  view.buffer_capacity = buffer.size();
+  publisher->publish(view);
+  buffer.assign(buffer.size(), 0u);
+
+  ASSERT_TRUE(wait_for([&received_messages]() {return !received_messages.empty();}, 5s));
+  test_msgs::msg::Strings received_message;
+  rclcpp::Serialization<test_msgs::msg::Strings>().deserialize_message(
+    received_messages[0].get(), &received_message);
+  EXPECT_EQ("Hello", received_message.string_value);
+}
+
+TEST_F(RclcppGenericNodeFixture, intra_process_requires_compatible_qos)
+{
+  std::string topic_name = "/intra_process_string_topic";
+  std::string topic_type = "test_msgs/msg/Strings";
+  rclcpp::QoS qos = rclcpp::QoS(1).transient_local();
+
+  // With the node default, the middleware is used.
+  EXPECT_NO_THROW(node_->create_generic_publisher(topic_name, topic_type, qos));
+
+  rclcpp::PublisherOptions publisher_options;
+  publisher_options.use_intra_process_comm = rclcpp::IntraProcessSetting::Enable;
+  EXPECT_THROW(
+    node_->create_generic_publisher(topic_name, topic_type, qos, publisher_options),
+    std::invalid_argument);
+
+  rclcpp::SubscriptionOptions subscription_options;
+  subscription_options.use_intra_process_comm = rclcpp::IntraProcessSetting::Enable;
+  EXPECT_THROW(
+    node_->create_generic_subscription(
+      topic_name, topic_type, qos,
+      [](std::shared_ptr<rclcpp::SerializedMessage>/* message */) {}, subscription_options),
+    std::invalid_argument);
+}
+
+TEST_F(RclcppGenericNodeFixture, read_fields_of_serialized_messages)
+{
+  auto subscription = node_->create_generic_subscription(
+    "/field_topic", "test_msgs/msg/BasicTypes", rclcpp::QoS(1),
+    [](std::shared_ptr<rclcpp::SerializedMessage>/* message */) {});
+  auto field = subscription->create_field("int64_value");
+  EXPECT_EQ("int64_value", field->get_path());
+  EXPECT_THROW(subscription->create_field("string_value"), std::invalid_argument);
+
+  auto message = serialize_message<int64_t, test_msgs::msg::BasicTypes>(-42);
+  int64_t value = 0;
+  ASSERT_TRUE(field->read(message, value));
+  EXPECT_EQ(-42, value);
+}
@@ -16,6 +16,7 @@
 
 #include <memory>
 
+#include "rclcpp/detail/add_guard_condition_to_rcl_wait_set.hpp"
 #include "rclcpp/rclcpp.hpp"
 
 #include "../mocking_utils/patch.hpp"
@@ -182,3 +183,52 @@ TEST_F(TestGuardCondition, callback_and_waitset) {
   EXPECT_EQ(rclcpp::WaitResultKind::Ready, wait_set.wait(std::chrono::seconds(1)).kind());
   EXPECT_EQ(c1.load(), 1u);
 }
+
+/*
+ * Testing that a trigger after a wait, before adding the guard condition again, isn't lost
+ */
+TEST_F(TestGuardCondition, trigger_after_wait_before_add) {
+  auto gc = std::make_shared<rclcpp::GuardCondition>();
+  {
+    size_t rcl_triggers = 0;
+    auto mock = mocking_utils::patch(
+      "lib:rclcpp", rcl_trigger_guard_condition, [&rcl_triggers](const rcl_guard_condition_t *)
+      {
+        ++rcl_triggers;
+        return RCL_RET_OK;
+      });
+    gc->trigger();
+    gc->trigger();
+    EXPECT_EQ(2u, rcl_triggers);
+  }
+
+  rclcpp::WaitSet wait_set;
+  wait_set.add_guard_condition(gc);
+  gc->trigger();
+  // The wait consumes the trigger
+  EXPECT_EQ(rclcpp::WaitResultKind::Ready, wait_set.wait(std::chrono::seconds(1)).kind());
+  EXPECT_EQ(rclcpp::WaitResultKind::Timeout, wait_set.wait(std::chrono::seconds(0)).kind());
+
+  // Triggered after the wait returned, before the guard condition is added to a wait set again
+  gc->trigger();
+  wait_set.remove_guard_condition(gc);
+  wait_set.add_guard_condition(gc);
+  EXPECT_EQ(rclcpp::WaitResultKind::Ready, wait_set.wait(std::chrono::seconds(1)).kind());
+
+  rcl_wait_set_t rcl_wait_set = rcl_get_zero_initialized_wait_set();
+  ASSERT_EQ(
+    RCL_RET_OK,
+    rcl_wait_set_init(
+      &rcl_wait_set, 0, 1, 0, 0, 0, 0,
+      gc->get_context()->get_rcl_context().get(), rcl_get_default_allocator()));
+  gc->trigger();
+  rclcpp::detail::add_guard_condition_to_rcl_wait_set(rcl_wait_set, *gc);
+  EXPECT_EQ(RCL_RET_OK, rcl_wait(&rcl_wait_set, 0));
+  // Triggered after the wait, before clearing the wait set and adding the guard condition again
+  gc->trigger();
+  ASSERT_EQ(RCL_RET_OK, rcl_wait_set_clear(&rcl_wait_set));
+  rclcpp::detail::add_guard_condition_to_rcl_wait_set(rcl_wait_set, *gc);
+  EXPECT_EQ(RCL_RET_OK, rcl_wait(&rcl_wait_set, 0));
+  EXPECT_NE(nullptr, rcl_wait_set.guard_conditions[0]);
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&rcl_wait_set));
+}
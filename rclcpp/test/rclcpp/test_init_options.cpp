@@ -14,14 +14,23 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "rcl/allocator.h"
 #include "rcl/domain_id.h"
 
+#include "rclcpp/context.hpp"
+#include "rclcpp/experimental/intra_process_manager.hpp"
 #include "rclcpp/init_options.hpp"
+#include "rclcpp/logging.hpp"
 
 #include "../mocking_utils/patch.hpp"
 #include "../utils/rclcpp_gtest_macros.hpp"
@@ -65,6 +74,104 @@ TEST(TestInitOptions, test_initialize_logging) {
   }
 }
 
+TEST(TestInitOptions, test_asynchronous_logging) {
+  auto options = rclcpp::InitOptions();
+  EXPECT_FALSE(options.asynchronous_logging());
+  EXPECT_EQ(256u, options.asynchronous_logging_queue_size());
+
+  options.asynchronous_logging(true).asynchronous_logging_queue_size(8u);
+  EXPECT_TRUE(options.asynchronous_logging());
+  EXPECT_EQ(8u, options.asynchronous_logging_queue_size());
+  EXPECT_THROW(options.asynchronous_logging_queue_size(0u), std::invalid_argument);
+
+  auto options_copy = rclcpp::InitOptions(options);
+  EXPECT_TRUE(options_copy.asynchronous_logging());
+  EXPECT_EQ(8u, options_copy.asynchronous_logging_queue_size());
+
+  // Log from several threads, some of their messages being dropped.
+  auto context = std::make_shared<rclcpp::Context>();
+  context->init(0, nullptr, options);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back(
+      [i]() {
+        for (int j = 0; j < 100; ++j) {
+          RCLCPP_INFO(rclcpp::get_logger("test_asynchronous_logging"), "message %d.%d", i, j);
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  RCLCPP_INFO(
+    rclcpp::get_logger("test_asynchronous_logging"), "%s", std::string(1000u, 'a').c_str());
+  EXPECT_TRUE(context->shutdown("test is complete"));
+}
+
+TEST(TestInitOptions, test_shutdown_callback_threads) {
+  auto options = rclcpp::InitOptions();
+  EXPECT_EQ(1u, options.shutdown_callback_threads());
+  options.shutdown_callback_threads(4u);
+  EXPECT_EQ(4u, rclcpp::InitOptions(options).shutdown_callback_threads());
+
+  // Each callback is called once, concurrently
+  auto context = std::make_shared<rclcpp::Context>();
+  context->init(0, nullptr, options);
+  std::atomic<size_t> number_of_calls{0u};
+  std::mutex threads_mutex;
+  std::set<std::thread::id> threads;
+  for (int i = 0; i < 16; ++i) {
+    context->add_on_shutdown_callback(
+      [&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        ++number_of_calls;
+        std::lock_guard<std::mutex> lock(threads_mutex);
+        threads.insert(std::this_thread::get_id());
+      });
+  }
+  EXPECT_TRUE(context->shutdown("test is complete"));
+  EXPECT_EQ(16u, number_of_calls.load());
+  EXPECT_LE(threads.size(), 4u);
+  EXPECT_GT(threads.size(), 1u);
+}
+
+TEST(TestInitOptions, test_share_intra_process_manager) {
+  EXPECT_FALSE(rclcpp::InitOptions().share_intra_process_manager());
+  auto make_context = [](size_t domain_id, bool share_intra_process_manager) {
+      auto options = rclcpp::InitOptions().auto_initialize_logging(false);
+      options.set_domain_id(domain_id);
+      options.share_intra_process_manager(share_intra_process_manager);
+      EXPECT_EQ(
+        share_intra_process_manager,
+        rclcpp::InitOptions(options).share_intra_process_manager());
+      auto context = std::make_shared<rclcpp::Context>();
+      context->init(0, nullptr, options);
+      return context;
+    };
+  using rclcpp::experimental::get_intra_process_manager;
+  auto context = make_context(42u, true);
+  auto same_domain_context = make_context(42u, true);
+  auto other_domain_context = make_context(43u, true);
+  auto unshared_context = make_context(42u, false);
+
+  auto ipm = get_intra_process_manager(*context);
+  EXPECT_EQ(ipm, get_intra_process_manager(*context));
+  EXPECT_EQ(ipm, get_intra_process_manager(*same_domain_context));
+  EXPECT_NE(ipm, get_intra_process_manager(*other_domain_context));
+  EXPECT_NE(ipm, get_intra_process_manager(*unshared_context));
+  EXPECT_EQ(
+    unshared_context->get_sub_context<rclcpp::experimental::IntraProcessManager>(),
+    get_intra_process_manager(*unshared_context));
+
+  // The shared instance is released by the last context using it
+  std::weak_ptr<rclcpp::experimental::IntraProcessManager> weak_ipm = ipm;
+  ipm.reset();
+  context.reset();
+  EXPECT_FALSE(weak_ipm.expired());
+  same_domain_context.reset();
+  EXPECT_TRUE(weak_ipm.expired());
+}
+
 TEST(TestInitOptions, test_domain_id) {
   rcl_allocator_t allocator = rcl_get_default_allocator();
   auto options = rclcpp::InitOptions(allocator);
@@ -25,6 +25,7 @@
 #include "rclcpp/context.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/qos.hpp"
+#include "rclcpp/serialized_message.hpp"
 #include "rmw/types.h"
 #include "rmw/qos_profiles.h"
 
@@ -209,6 +210,12 @@ public:
   virtual bool
   use_take_shared_method() const = 0;
 
+  virtual bool
+  is_serialized() const
+  {
+    return false;
+  }
+
   QoS
   get_actual_qos()
   {
@@ -304,29 +311,92 @@ public:
   }
 };
 
+class SubscriptionSerializedIntraProcess : public SubscriptionIntraProcessBase
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(SubscriptionSerializedIntraProcess)
+
+  explicit SubscriptionSerializedIntraProcess(rclcpp::QoS qos = rclcpp::QoS(10))
+  : SubscriptionIntraProcessBase(nullptr, "topic", qos)
+  {
+  }
+
+  void
+  provide_intra_process_message(std::shared_ptr<const rclcpp::SerializedMessage> msg)
+  {
+    messages.push_back(msg);
+  }
+
+  bool
+  use_take_shared_method() const override
+  {
+    return true;
+  }
+
+  bool
+  is_serialized() const override
+  {
+    return true;
+  }
+
+  std::vector<std::shared_ptr<const rclcpp::SerializedMessage>> messages;
+};
+
 }  // namespace mock
 }  // namespace experimental
+
+namespace detail
+{
+namespace mock
+{
+
+// No callback of an executor runs in these tests, so there is never a pipeline.
+class IntraProcessPipeline
+{
+public:
+  static bool
+  is_active()
+  {
+    return false;
+  }
+
+  template<typename SubscriptionT>
+  static void
+  enqueue(SubscriptionT subscription)
+  {
+    (void)subscription;
+  }
+};
+
+}  // namespace mock
+}  // namespace detail
 }  // namespace rclcpp
 
 // Prevent the header files of the mocked classes to be included
+#define RCLCPP__DETAIL__INTRA_PROCESS_PIPELINE_HPP_
 #define RCLCPP__PUBLISHER_HPP_
 #define RCLCPP__PUBLISHER_BASE_HPP_
 #define RCLCPP__EXPERIMENTAL__SUBSCRIPTION_INTRA_PROCESS_HPP_
 #define RCLCPP__EXPERIMENTAL__SUBSCRIPTION_INTRA_PROCESS_BUFFER_HPP_
 #define RCLCPP__EXPERIMENTAL__SUBSCRIPTION_INTRA_PROCESS_BASE_HPP_
+#define RCLCPP__EXPERIMENTAL__SUBSCRIPTION_SERIALIZED_INTRA_PROCESS_HPP_
 // Force ipm to use our mock publisher class.
+#define IntraProcessPipeline mock::IntraProcessPipeline
 #define Publisher mock::Publisher
 #define PublisherBase mock::PublisherBase
 #define IntraProcessBuffer mock::IntraProcessBuffer
 #define SubscriptionIntraProcessBase mock::SubscriptionIntraProcessBase
 #define SubscriptionIntraProcessBuffer mock::SubscriptionIntraProcessBuffer
 #define SubscriptionIntraProcess mock::SubscriptionIntraProcess
+#define SubscriptionSerializedIntraProcess mock::SubscriptionSerializedIntraProcess
 #include "../src/rclcpp/intra_process_manager.cpp"  // NOLINT
+#undef IntraProcessPipeline
 #undef Publisher
 #undef PublisherBase
 #undef IntraProcessBuffer
 #undef SubscriptionIntraProcessBase
 #undef SubscriptionIntraProcess
+#undef SubscriptionSerializedIntraProcess
 
 using ::testing::_;
 using ::testing::UnorderedElementsAre;
@@ -357,6 +427,99 @@ void Publisher<T, Alloc>::publish(MessageUniquePtr msg)
 }  // namespace mock
 }  // namespace rclcpp
 
+namespace rclcpp
+{
+namespace experimental
+{
+namespace mock
+{
+
+/// Allocator of another type than the one of the publishers.
+template<typename T>
+struct OtherAllocator
+{
+  using value_type = T;
+
+  OtherAllocator() = default;
+
+  template<typename U>
+  OtherAllocator(const OtherAllocator<U> &) {}
+
+  T *
+  allocate(size_t size)
+  {
+    return std::allocator<T>().allocate(size);
+  }
+
+  void
+  deallocate(T * ptr, size_t size)
+  {
+    std::allocator<T>().deallocate(ptr, size);
+  }
+
+  template<typename U>
+  bool
+  operator==(const OtherAllocator<U> &) const
+  {
+    return true;
+  }
+
+  template<typename U>
+  bool
+  operator!=(const OtherAllocator<U> &) const
+  {
+    return false;
+  }
+};
+
+template<typename MessageT>
+class SubscriptionOtherAllocator : public SubscriptionROSMsgIntraProcessBuffer<
+    MessageT, OtherAllocator<MessageT>>
+{
+public:
+  using Base = SubscriptionROSMsgIntraProcessBuffer<MessageT, OtherAllocator<MessageT>>;
+
+  RCLCPP_SMART_PTR_DEFINITIONS(SubscriptionOtherAllocator)
+
+  SubscriptionOtherAllocator()
+  : Base(nullptr, "topic", rclcpp::QoS(10)), take_shared_method(false)
+  {}
+
+  void
+  provide_intra_process_message(typename Base::ConstMessageSharedPtr msg) override
+  {
+    shared_msg = msg;
+  }
+
+  void
+  provide_intra_process_message(typename Base::MessageUniquePtr msg) override
+  {
+    (void)msg;
+    throw std::runtime_error("unexpected message of the allocator of the subscription");
+  }
+
+  void
+  provide_intra_process_message_copy(const MessageT & msg) override
+  {
+    copied_msg = std::make_unique<MessageT>(msg);
+  }
+
+  bool
+  use_take_shared_method() const override
+  {
+    return take_shared_method;
+  }
+
+  bool take_shared_method;
+
+  std::shared_ptr<const MessageT> shared_msg;
+  std::unique_ptr<MessageT> copied_msg;
+};
+
+}  // namespace mock
+}  // namespace experimental
+}  // namespace rclcpp
+
 /*
    This tests how the class connects and disconnects publishers and subscriptions:
    - Creates 2 publishers on different topics and a subscription to one of them.
@@ -421,6 +584,11 @@ TEST(TestIntraProcessManager, add_pub_sub) {
   ASSERT_EQ(1u, p1_subs);
   ASSERT_EQ(0u, p2_subs);
   ASSERT_EQ(1u, p3_subs);
+
+  // The publishers destroyed without being removed aren't returned.
+  ASSERT_EQ(3u, ipm->get_publishers().size());
+  p2.reset();
+  ASSERT_EQ(2u, ipm->get_publishers().size());
 }
 
 /*
@@ -712,3 +880,131 @@ TEST(TestIntraProcessManager, multiple_subscriptions_different_type) {
   EXPECT_EQ(original_message_pointer, received_message_pointer_10);
   EXPECT_NE(original_message_pointer, received_message_pointer_11);
 }
+
+/*
+   This tests the publishers of serialized messages:
+   - Creates a typed and a serialized publisher, and a typed and two serialized subscriptions.
+   - The publishers are expected to only be matched with the subscriptions of the same kind.
+   - Publishes a serialized message.
+   - Both serialized subscriptions are expected to share the message, without copying it.
+ */
+TEST(TestIntraProcessManager, serialized_publisher) {
+  using IntraProcessManagerT = rclcpp::experimental::IntraProcessManager;
+  using MessageT = rcl_interfaces::msg::Log;
+  using PublisherT = rclcpp::mock::Publisher<MessageT>;
+  using SubscriptionIntraProcessT = rclcpp::experimental::mock::SubscriptionIntraProcess<MessageT>;
+  using SerializedSubscriptionT = rclcpp::experimental::mock::SubscriptionSerializedIntraProcess;
+
+  auto ipm = std::make_shared<IntraProcessManagerT>();
+
+  auto typed_publisher = std::make_shared<PublisherT>();
+  auto serialized_publisher = std::make_shared<rclcpp::mock::PublisherBase>();
+  auto typed_subscription = std::make_shared<SubscriptionIntraProcessT>();
+  auto serialized_subscription1 = std::make_shared<SerializedSubscriptionT>();
+
+  auto typed_publisher_id = ipm->add_publisher(typed_publisher);
+  auto serialized_publisher_id = ipm->add_publisher(serialized_publisher, true);
+  ipm->add_subscription(typed_subscription);
+  ipm->add_subscription(serialized_subscription1);
+  auto serialized_subscription2 = std::make_shared<SerializedSubscriptionT>();
+  ipm->add_subscription(serialized_subscription2);
+
+  EXPECT_EQ(1u, ipm->get_subscription_count(typed_publisher_id));
+  EXPECT_EQ(2u, ipm->get_subscription_count(serialized_publisher_id));
+
+  auto message = std::make_shared<const rclcpp::SerializedMessage>(16u);
+  ipm->do_serialized_intra_process_publish(serialized_publisher_id, message);
+
+  ASSERT_EQ(1u, serialized_subscription1->messages.size());
+  ASSERT_EQ(1u, serialized_subscription2->messages.size());
+  EXPECT_EQ(message, serialized_subscription1->messages[0]);
+  EXPECT_EQ(message, serialized_subscription2->messages[0]);
+}
+
+/*
+   This tests the transient local publishers:
+   - Creates a transient local publisher, keeping the last 2 messages, and publishes 3 messages.
+   - Adds a transient local subscription not requesting ownership.
+   - It is expected to get the published messages, the last one being shared.
+   - Adds a transient local subscription requesting ownership.
+   - It is expected to get the last message too, which its buffer would copy.
+   - Adds a volatile subscription, which is expected to get no message.
+ */
+TEST(TestIntraProcessManager, transient_local_publisher) {
+  using IntraProcessManagerT = rclcpp::experimental::IntraProcessManager;
+  using MessageT = rcl_interfaces::msg::Log;
+  using PublisherT = rclcpp::mock::Publisher<MessageT>;
+  using SubscriptionIntraProcessT = rclcpp::experimental::mock::SubscriptionIntraProcess<MessageT>;
+
+  auto ipm = std::make_shared<IntraProcessManagerT>();
+
+  auto p1 = std::make_shared<PublisherT>(rclcpp::QoS(2).transient_local());
+  auto p1_id = ipm->add_publisher(p1);
+  p1->set_intra_process_manager(p1_id, ipm);
+
+  std::uintptr_t original_message_pointer = 0;
+  for (size_t i = 0; i < 3u; ++i) {
+    auto unique_msg = std::make_unique<MessageT>();
+    original_message_pointer = reinterpret_cast<std::uintptr_t>(unique_msg.get());
+    p1->publish(std::move(unique_msg));
+  }
+
+  auto s1 = std::make_shared<SubscriptionIntraProcessT>(rclcpp::QoS(10).transient_local());
+  s1->take_shared_method = true;
+  ipm->add_subscription(s1);
+  EXPECT_EQ(original_message_pointer, s1->pop());
+
+  auto s2 = std::make_shared<SubscriptionIntraProcessT>(rclcpp::QoS(10).transient_local());
+  s2->take_shared_method = false;
+  ipm->add_subscription(s2);
+  EXPECT_EQ(original_message_pointer, s2->pop());
+
+  auto s3 = std::make_shared<SubscriptionIntraProcessT>(rclcpp::QoS(10));
+  ipm->add_subscription(s3);
+  EXPECT_EQ(nullptr, s3->buffer->shared_msg);
+  EXPECT_EQ(nullptr, s3->buffer->unique_msg);
+}
+
+/*
+   This tests the subscriptions using another allocator type than the publisher:
+   - Publishes a unique_ptr message with a subscription not requesting ownership.
+   - The received message is expected to be the published one.
+   - Publishes a unique_ptr message with a subscription requesting ownership.
+   - The received message is expected to be a copy of the published one.
+ */
+TEST(TestIntraProcessManager, subscription_other_allocator) {
+  using IntraProcessManagerT = rclcpp::experimental::IntraProcessManager;
+  using MessageT = rcl_interfaces::msg::Log;
+  using PublisherT = rclcpp::mock::Publisher<MessageT>;
+  using SubscriptionOtherAllocatorT =
+    rclcpp::experimental::mock::SubscriptionOtherAllocator<MessageT>;
+
+  auto ipm = std::make_shared<IntraProcessManagerT>();
+
+  auto p1 = std::make_shared<PublisherT>();
+  auto p1_id = ipm->add_publisher(p1);
+  p1->set_intra_process_manager(p1_id, ipm);
+
+  auto s1 = std::make_shared<SubscriptionOtherAllocatorT>();
+  s1->take_shared_method = true;
+  auto s1_id = ipm->add_subscription(s1);
+
+  auto unique_msg = std::make_unique<MessageT>();
+  unique_msg->name = "shared";
+  auto original_message = unique_msg.get();
+  p1->publish(std::move(unique_msg));
+  EXPECT_EQ(original_message, s1->shared_msg.get());
+
+  ipm->remove_subscription(s1_id);
+  auto s2 = std::make_shared<SubscriptionOtherAllocatorT>();
+  s2->take_shared_method = false;
+  ipm->add_subscription(s2);
+
+  unique_msg = std::make_unique<MessageT>();
+  unique_msg->name = "copied";
+  original_message = unique_msg.get();
+  p1->publish(std::move(unique_msg));
+  ASSERT_NE(nullptr, s2->copied_msg);
+  EXPECT_NE(original_message, s2->copied_msg.get());
+  EXPECT_EQ("copied", s2->copied_msg->name);
+}
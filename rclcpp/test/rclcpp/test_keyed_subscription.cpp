@@ -0,0 +1,152 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/experimental/keyed_subscription.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "test_msgs/msg/basic_types.hpp"
+
+using test_msgs::msg::BasicTypes;
+using namespace std::chrono_literals;
+
+class TestKeyedSubscription : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    rclcpp::init(0, nullptr);
+    node = std::make_shared<rclcpp::Node>("test_keyed_subscription");
+  }
+
+  void TearDown() override
+  {
+    node.reset();
+    rclcpp::shutdown();
+  }
+
+  rclcpp::Node::SharedPtr node;
+};
+
+TEST_F(TestKeyedSubscription, invalid_arguments) {
+  auto key_extractor = [](const BasicTypes & message) {return message.int32_value;};
+  auto callback = [](std::shared_ptr<const BasicTypes>) {};
+  EXPECT_THROW(
+    (rclcpp::experimental::create_keyed_subscription<BasicTypes, int32_t>(
+      node, "topic", 10, nullptr, callback)),
+    std::invalid_argument);
+  EXPECT_THROW(
+    (rclcpp::experimental::create_keyed_subscription<BasicTypes, int32_t>(
+      node, "topic", 10, key_extractor, nullptr)),
+    std::invalid_argument);
+
+  rclcpp::SubscriptionOptions options;
+  options.callback_group = node->create_callback_group(rclcpp::CallbackGroupType::Reentrant);
+  EXPECT_THROW(
+    (rclcpp::experimental::create_keyed_subscription<BasicTypes, int32_t>(
+      node, "topic", 10, key_extractor, callback, options)),
+    std::invalid_argument);
+}
+
+/*
+   Test that the messages of each key are executed in order, one at a time,
+   while the ones of different keys are executed by several threads.
+ */
+TEST_F(TestKeyedSubscription, order_per_key) {
+  constexpr int32_t number_of_keys = 4;
+  constexpr int64_t messages_per_key = 5;
+
+  std::mutex mutex;
+  std::map<int32_t, std::vector<int64_t>> received;
+  std::map<int32_t, int> executing;
+  int max_executing_keys = 0;
+  bool concurrent_messages_of_a_key = false;
+  std::atomic<int64_t> number_of_received{0};
+
+  auto keyed_subscription = rclcpp::experimental::create_keyed_subscription<BasicTypes, int32_t>(
+    node, "objects", rclcpp::QoS(100).reliable(),
+    [](const BasicTypes & message) {return message.int32_value;},
+    [&](std::shared_ptr<const BasicTypes> message) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (++executing[message->int32_value] > 1) {
+          concurrent_messages_of_a_key = true;
+        }
+        int executing_keys = 0;
+        for (const auto & key_and_count : executing) {
+          executing_keys += key_and_count.second > 0 ? 1 : 0;
+        }
+        max_executing_keys = std::max(max_executing_keys, executing_keys);
+      }
+      std::this_thread::sleep_for(5ms);
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        --executing[message->int32_value];
+        received[message->int32_value].push_back(message->int64_value);
+      }
+      ++number_of_received;
+    });
+  ASSERT_NE(nullptr, keyed_subscription->get_subscription());
+  ASSERT_NE(nullptr, keyed_subscription->get_callback_group());
+
+  auto publisher = node->create_publisher<BasicTypes>("objects", rclcpp::QoS(100).reliable());
+  const auto start = std::chrono::steady_clock::now();
+  while (publisher->get_subscription_count() == 0u &&
+    std::chrono::steady_clock::now() - start < 5s)
+  {
+    std::this_thread::sleep_for(10ms);
+  }
+  ASSERT_EQ(1u, publisher->get_subscription_count());
+  for (int64_t sequence = 0; sequence < messages_per_key; ++sequence) {
+    for (int32_t key = 0; key < number_of_keys; ++key) {
+      BasicTypes message;
+      message.int32_value = key;
+      message.int64_value = sequence;
+      publisher->publish(message);
+    }
+  }
+
+  rclcpp::executors::MultiThreadedExecutor executor(rclcpp::ExecutorOptions(), 4u);
+  executor.add_node(node);
+  std::thread spinner([&executor]() {executor.spin();});
+  while (number_of_received.load() < number_of_keys * messages_per_key &&
+    std::chrono::steady_clock::now() - start < 10s)
+  {
+    std::this_thread::sleep_for(10ms);
+  }
+  executor.cancel();
+  spinner.join();
+
+  ASSERT_EQ(number_of_keys * messages_per_key, number_of_received.load());
+  EXPECT_EQ(0u, keyed_subscription->get_number_of_pending_messages());
+  EXPECT_FALSE(concurrent_messages_of_a_key);
+  EXPECT_GT(max_executing_keys, 1);
+  for (int32_t key = 0; key < number_of_keys; ++key) {
+    const std::vector<int64_t> expected_sequences = {0, 1, 2, 3, 4};
+    EXPECT_EQ(expected_sequences, received[key]);
+  }
+}
@@ -0,0 +1,141 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include "rclcpp/experimental/latest_message_cache.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "test_msgs/msg/basic_types.hpp"
+
+using test_msgs::msg::BasicTypes;
+using namespace std::chrono_literals;
+
+TEST(TestLatestMessageCache, store_and_get_latest) {
+  rclcpp::experimental::LatestMessageCache<BasicTypes> cache;
+  auto latest = cache.get_latest();
+  EXPECT_EQ(nullptr, latest.message);
+  EXPECT_EQ(0u, latest.sequence);
+
+  BasicTypes message;
+  message.int32_value = 1;
+  cache.store(message);
+  latest = cache.get_latest();
+  ASSERT_NE(nullptr, latest.message);
+  EXPECT_EQ(1, latest.message->int32_value);
+  EXPECT_EQ(1u, latest.sequence);
+
+  // Without a new message, the same one is returned.
+  latest = cache.get_latest();
+  ASSERT_NE(nullptr, latest.message);
+  EXPECT_EQ(1, latest.message->int32_value);
+  EXPECT_EQ(1u, latest.sequence);
+
+  // Only the latest of the messages stored between two polls is returned.
+  for (int32_t i = 2; i <= 5; ++i) {
+    message.int32_value = i;
+    cache.store(message);
+  }
+  latest = cache.get_latest();
+  ASSERT_NE(nullptr, latest.message);
+  EXPECT_EQ(5, latest.message->int32_value);
+  EXPECT_EQ(5u, latest.sequence);
+}
+
+TEST(TestLatestMessageCache, concurrent_store_and_get_latest) {
+  rclcpp::experimental::LatestMessageCache<BasicTypes> cache;
+  constexpr int64_t number_of_messages = 100000;
+
+  std::thread writer([&cache]() {
+      BasicTypes message;
+      for (int64_t i = 1; i <= number_of_messages; ++i) {
+        message.int64_value = i;
+        message.uint64_value = static_cast<uint64_t>(i);
+        cache.store(message);
+      }
+    });
+
+  uint64_t last_sequence = 0;
+  while (last_sequence < static_cast<uint64_t>(number_of_messages)) {
+    auto latest = cache.get_latest();
+    if (!latest.message) {
+      continue;
+    }
+    // The message is never torn, and matches its sequence number.
+    ASSERT_EQ(latest.message->uint64_value, static_cast<uint64_t>(latest.message->int64_value));
+    ASSERT_EQ(latest.sequence, latest.message->uint64_value);
+    ASSERT_GE(latest.sequence, last_sequence);
+    last_sequence = latest.sequence;
+  }
+  writer.join();
+  EXPECT_EQ(static_cast<uint64_t>(number_of_messages), last_sequence);
+}
+
+class TestLatestMessageCacheSubscription : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    rclcpp::init(0, nullptr);
+    node = std::make_shared<rclcpp::Node>("test_latest_message_cache");
+  }
+
+  void TearDown() override
+  {
+    node.reset();
+    rclcpp::shutdown();
+  }
+
+  rclcpp::Node::SharedPtr node;
+};
+
+TEST_F(TestLatestMessageCacheSubscription, reentrant_callback_group) {
+  rclcpp::SubscriptionOptions options;
+  options.callback_group = node->create_callback_group(rclcpp::CallbackGroupType::Reentrant);
+  EXPECT_THROW(
+    rclcpp::experimental::create_latest_message_cache<BasicTypes>(node, "topic", 10, options),
+    std::invalid_argument);
+}
+
+TEST_F(TestLatestMessageCacheSubscription, received_messages) {
+  auto cache = rclcpp::experimental::create_latest_message_cache<BasicTypes>(
+    node, "topic", rclcpp::QoS(10));
+  ASSERT_NE(nullptr, cache->get_subscription());
+  auto publisher = node->create_publisher<BasicTypes>("topic", rclcpp::QoS(10));
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+
+  BasicTypes message;
+  message.int32_value = 42;
+  uint64_t sequence = 0;
+  const auto deadline = std::chrono::steady_clock::now() + 10s;
+  while (sequence == 0 && std::chrono::steady_clock::now() < deadline) {
+    publisher->publish(message);
+    executor.spin_some(100ms);
+    sequence = cache->get_latest().sequence;
+  }
+  auto latest = cache->get_latest();
+  ASSERT_NE(nullptr, latest.message);
+  EXPECT_EQ(42, latest.message->int32_value);
+  EXPECT_GE(latest.sequence, 1u);
+}
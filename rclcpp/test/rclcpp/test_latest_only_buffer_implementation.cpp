@@ -0,0 +1,161 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "rclcpp/experimental/buffers/latest_only_buffer_implementation.hpp"
+#include "rclcpp/experimental/create_intra_process_buffer.hpp"
+
+using rclcpp::experimental::buffers::LatestOnlyBufferImplementation;
+
+TEST(TestLatestOnlyBufferImplementation, basic_usage) {
+  LatestOnlyBufferImplementation<char> buffer;
+  EXPECT_FALSE(buffer.has_data());
+  EXPECT_EQ(0, buffer.dequeue());
+
+  buffer.enqueue('a');
+  EXPECT_TRUE(buffer.has_data());
+  buffer.enqueue('b');
+  buffer.enqueue('c');
+  EXPECT_EQ('c', buffer.dequeue());
+  EXPECT_FALSE(buffer.has_data());
+
+  buffer.enqueue('d');
+  buffer.clear();
+  EXPECT_FALSE(buffer.has_data());
+}
+
+TEST(TestLatestOnlyBufferImplementation, unique_ptr) {
+  LatestOnlyBufferImplementation<std::unique_ptr<int>> buffer;
+  auto first = std::make_unique<int>(1);
+  auto second = std::make_unique<int>(2);
+  const int * second_address = second.get();
+
+  buffer.enqueue(std::move(first));
+  buffer.enqueue(std::move(second));
+  auto element = buffer.dequeue();
+  ASSERT_NE(nullptr, element);
+  EXPECT_EQ(second_address, element.get());
+  EXPECT_EQ(nullptr, buffer.dequeue());
+}
+
+TEST(TestLatestOnlyBufferImplementation, release_replaced_elements) {
+  LatestOnlyBufferImplementation<std::shared_ptr<int>> buffer;
+  auto element = std::make_shared<int>(1);
+  buffer.enqueue(element);
+  EXPECT_EQ(2, element.use_count());
+  buffer.enqueue(std::make_shared<int>(2));
+  EXPECT_EQ(1, element.use_count());
+  buffer.dequeue();
+  buffer.enqueue(element);
+  buffer.clear();
+  EXPECT_EQ(1, element.use_count());
+}
+
+/*
+   Elements published concurrently are only received newer than the ones before
+ */
+TEST(TestLatestOnlyBufferImplementation, multiple_producers) {
+  constexpr size_t number_of_producers = 4;
+  constexpr int elements_per_producer = 10000;
+  LatestOnlyBufferImplementation<std::shared_ptr<std::pair<size_t, int>>> buffer;
+
+  std::atomic_bool producers_done{false};
+  std::vector<int> last_received(number_of_producers, -1);
+  size_t received = 0;
+  bool in_order = true;
+
+  std::thread consumer([&]() {
+      while (!producers_done.load() || buffer.has_data()) {
+        auto element = buffer.dequeue();
+        if (!element) {
+          continue;
+        }
+        if (element->second <= last_received[element->first]) {
+          in_order = false;
+        }
+        last_received[element->first] = element->second;
+        received++;
+      }
+    });
+
+  std::vector<std::thread> producers;
+  for (size_t producer = 0; producer < number_of_producers; ++producer) {
+    producers.emplace_back(
+      [&buffer, producer]() {
+        for (int i = 0; i < elements_per_producer; ++i) {
+          buffer.enqueue(std::make_shared<std::pair<size_t, int>>(producer, i));
+        }
+      });
+  }
+  for (auto & producer : producers) {
+    producer.join();
+  }
+  producers_done.store(true);
+  consumer.join();
+
+  EXPECT_TRUE(in_order);
+  EXPECT_GT(received, 0u);
+  EXPECT_EQ(
+    number_of_producers * elements_per_producer,
+    received + buffer.get_counters().dropped);
+  EXPECT_FALSE(buffer.has_data());
+}
+
+TEST(TestLatestOnlyBufferImplementation, counters) {
+  LatestOnlyBufferImplementation<char> buffer;
+
+  auto counters = buffer.get_counters();
+  EXPECT_EQ(1u, counters.capacity);
+  EXPECT_EQ(0u, counters.depth);
+  EXPECT_EQ(0u, counters.high_water_mark);
+  EXPECT_EQ(0u, counters.dropped);
+
+  buffer.enqueue('a');
+  buffer.enqueue('b');
+  buffer.enqueue('c');
+  counters = buffer.get_counters();
+  EXPECT_EQ(1u, counters.depth);
+  EXPECT_EQ(1u, counters.high_water_mark);
+  EXPECT_EQ(2u, counters.dropped);
+
+  buffer.dequeue();
+  EXPECT_EQ(0u, buffer.get_counters().depth);
+}
+
+/*
+   Selection through IntraProcessBufferImplementation, whatever the depth
+ */
+TEST(TestLatestOnlyBufferImplementation, create_intra_process_buffer) {
+  auto buffer = rclcpp::experimental::create_intra_process_buffer<char>(
+    rclcpp::IntraProcessBufferType::SharedPtr,
+    rclcpp::QoS(10),
+    std::make_shared<std::allocator<void>>(),
+    rclcpp::IntraProcessBufferImplementation::LatestOnly);
+
+  EXPECT_FALSE(buffer->has_data());
+  buffer->add_shared(std::make_shared<char>('a'));
+  buffer->add_shared(std::make_shared<char>('b'));
+  auto v = buffer->consume_shared();
+  ASSERT_NE(nullptr, v);
+  EXPECT_EQ('b', *v);
+  EXPECT_FALSE(buffer->has_data());
+}
@@ -0,0 +1,96 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "rclcpp/lazy_message.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/serialization.hpp"
+
+#include "test_msgs/msg/strings.hpp"
+
+using test_msgs::msg::Strings;
+using namespace std::chrono_literals;
+
+std::shared_ptr<rclcpp::SerializedMessage>
+serialize(const std::string & value)
+{
+  Strings message;
+  message.string_value = value;
+  auto serialized_message = std::make_shared<rclcpp::SerializedMessage>();
+  rclcpp::Serialization<Strings>().serialize_message(&message, serialized_message.get());
+  return serialized_message;
+}
+
+TEST(TestLazyMessage, null_serialized_message) {
+  EXPECT_THROW(rclcpp::LazyMessage<Strings>(nullptr), std::invalid_argument);
+}
+
+TEST(TestLazyMessage, deserialize_on_demand) {
+  auto serialized_message = serialize("hello");
+  rclcpp::LazyMessage<Strings> lazy_message(serialized_message);
+  EXPECT_EQ(serialized_message.get(), &lazy_message.get_serialized_message());
+  EXPECT_FALSE(lazy_message.is_deserialized());
+
+  Strings message;
+  lazy_message.deserialize(message);
+  EXPECT_EQ("hello", message.string_value);
+  EXPECT_FALSE(lazy_message.is_deserialized());
+
+  // The message is deserialized once, and shared by the copies
+  auto copy = lazy_message;
+  auto deserialized_message = lazy_message.get();
+  ASSERT_NE(nullptr, deserialized_message);
+  EXPECT_EQ("hello", deserialized_message->string_value);
+  EXPECT_TRUE(copy.is_deserialized());
+  EXPECT_EQ(deserialized_message, copy.get());
+}
+
+TEST(TestLazyMessage, subscription) {
+  rclcpp::init(0, nullptr);
+  {
+    auto node = std::make_shared<rclcpp::Node>("test_lazy_message");
+    size_t number_of_messages = 0;
+    size_t number_of_deserialized_messages = 0;
+    auto subscription = node->create_subscription<Strings>(
+      "lazy_topic", 10, rclcpp::make_lazy_message_callback<Strings>(
+        [&](const rclcpp::LazyMessage<Strings> & message, const rclcpp::MessageInfo &) {
+          EXPECT_FALSE(message.is_deserialized());
+          // Only every other message is deserialized
+          if (number_of_messages++ % 2 == 0) {
+            EXPECT_EQ("hello", message.get()->string_value);
+            ++number_of_deserialized_messages;
+          }
+        }));
+    auto publisher = node->create_publisher<Strings>("lazy_topic", 10);
+
+    Strings message;
+    message.string_value = "hello";
+    const auto start = std::chrono::steady_clock::now();
+    while (number_of_messages < 4 && std::chrono::steady_clock::now() - start < 10s) {
+      publisher->publish(message);
+      rclcpp::spin_some(node);
+      std::this_thread::sleep_for(10ms);
+    }
+    EXPECT_GE(number_of_messages, 4u);
+    EXPECT_EQ((number_of_messages + 1) / 2, number_of_deserialized_messages);
+  }
+  rclcpp::shutdown();
+}
@@ -192,3 +192,41 @@ TEST_F(TestLoanedMessage, move_loaned_message) {
   ASSERT_EQ(42.0f, loaned_msg_moved_to.get().float32_value);
   SUCCEED();
 }
+
+TEST_F(TestLoanedMessage, loan_from_message_pool) {
+  auto node = std::make_shared<rclcpp::Node>("loaned_message_test_node");
+  // The pool is only used when the middleware can't loan messages.
+  auto mock_can_loan = mocking_utils::patch_and_return(
+    "lib:rclcpp", rcl_publisher_can_loan_messages, false);
+  rclcpp::PublisherOptions options;
+  options.loaned_message_pool_size = 2;
+  auto pub = node->create_publisher<MessageT>("loaned_message_test_topic", 1, options);
+
+  MessageT * first_message = nullptr;
+  {
+    auto loaned_msg1 = pub->borrow_loaned_message();
+    auto loaned_msg2 = pub->borrow_loaned_message();
+    // Allocated with the allocator, as the pool is empty.
+    auto loaned_msg3 = pub->borrow_loaned_message();
+    ASSERT_TRUE(loaned_msg1.is_valid());
+    ASSERT_TRUE(loaned_msg2.is_valid());
+    ASSERT_TRUE(loaned_msg3.is_valid());
+    first_message = &loaned_msg1.get();
+    loaned_msg1.get().float64_value = 42.0;
+    EXPECT_NO_THROW(pub->publish(std::move(loaned_msg1)));
+  }
+
+  // The messages are reused and reset.
+  auto loaned_msg = pub->borrow_loaned_message();
+  auto other_loaned_msg = pub->borrow_loaned_message();
+  EXPECT_TRUE(&loaned_msg.get() == first_message || &other_loaned_msg.get() == first_message);
+  EXPECT_EQ(0.0, loaned_msg.get().float64_value);
+  EXPECT_EQ(0.0, other_loaned_msg.get().float64_value);
+
+  // Released messages go back to the pool once deleted.
+  auto released_msg = loaned_msg.release();
+  MessageT * released_message = released_msg.get();
+  released_msg.reset();
+  auto reused_loaned_msg = pub->borrow_loaned_message();
+  EXPECT_EQ(released_message, &reused_loaned_msg.get());
+}
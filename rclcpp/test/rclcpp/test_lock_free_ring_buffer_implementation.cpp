@@ -0,0 +1,212 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "rclcpp/experimental/buffers/buffer_implementation_base.hpp"
+#include "rclcpp/experimental/buffers/lock_free_ring_buffer_implementation.hpp"
+#include "rclcpp/experimental/create_intra_process_buffer.hpp"
+
+using rclcpp::experimental::buffers::LockFreeRingBufferImplementation;
+
+/*
+   Constructor
+ */
+TEST(TestLockFreeRingBufferImplementation, constructor) {
+  // Cannot create a buffer of size zero.
+  EXPECT_THROW(
+    LockFreeRingBufferImplementation<char> rb(0),
+    std::invalid_argument);
+
+  LockFreeRingBufferImplementation<char> rb(1);
+
+  EXPECT_EQ(false, rb.has_data());
+  EXPECT_EQ(false, rb.is_full());
+}
+
+/*
+   Basic usage
+   - insert data and check that it has data
+   - extract data
+   - overwrite old data writing over the buffer capacity
+ */
+TEST(TestLockFreeRingBufferImplementation, basic_usage) {
+  LockFreeRingBufferImplementation<char> rb(2);
+
+  rb.enqueue('a');
+
+  EXPECT_EQ(true, rb.has_data());
+  EXPECT_EQ(false, rb.is_full());
+
+  char v = rb.dequeue();
+
+  EXPECT_EQ('a', v);
+  EXPECT_EQ(false, rb.has_data());
+  EXPECT_EQ(false, rb.is_full());
+
+  rb.enqueue('b');
+  rb.enqueue('c');
+
+  EXPECT_EQ(true, rb.has_data());
+  EXPECT_EQ(true, rb.is_full());
+
+  rb.enqueue('d');
+
+  EXPECT_EQ(true, rb.has_data());
+  EXPECT_EQ(true, rb.is_full());
+
+  v = rb.dequeue();
+
+  EXPECT_EQ('c', v);
+  EXPECT_EQ(true, rb.has_data());
+  EXPECT_EQ(false, rb.is_full());
+
+  v = rb.dequeue();
+
+  EXPECT_EQ('d', v);
+  EXPECT_EQ(false, rb.has_data());
+  EXPECT_EQ(false, rb.is_full());
+
+  rb.enqueue('e');
+  rb.clear();
+  EXPECT_EQ(false, rb.has_data());
+}
+
+/*
+   Move only elements, as used by the intra-process buffers
+ */
+TEST(TestLockFreeRingBufferImplementation, unique_ptr) {
+  LockFreeRingBufferImplementation<std::unique_ptr<int>> rb(2);
+
+  rb.enqueue(std::make_unique<int>(1));
+  rb.enqueue(std::make_unique<int>(2));
+  rb.enqueue(std::make_unique<int>(3));
+
+  auto v = rb.dequeue();
+  ASSERT_NE(nullptr, v);
+  EXPECT_EQ(2, *v);
+  v = rb.dequeue();
+  ASSERT_NE(nullptr, v);
+  EXPECT_EQ(3, *v);
+  EXPECT_EQ(nullptr, rb.dequeue());
+}
+
+/*
+   Concurrent producers and consumer
+   - every element is either received once or dropped as the oldest one
+   - the elements of each producer are received in order
+ */
+TEST(TestLockFreeRingBufferImplementation, multiple_producers) {
+  constexpr size_t number_of_producers = 4;
+  constexpr int elements_per_producer = 10000;
+  LockFreeRingBufferImplementation<std::shared_ptr<std::pair<size_t, int>>, true> rb(16);
+
+  std::atomic_bool producers_done{false};
+  std::vector<int> last_received(number_of_producers, -1);
+  size_t received = 0;
+  bool in_order = true;
+
+  std::thread consumer([&]() {
+      while (!producers_done.load() || rb.has_data()) {
+        auto element = rb.dequeue();
+        if (!element) {
+          continue;
+        }
+        if (element->second <= last_received[element->first]) {
+          in_order = false;
+        }
+        last_received[element->first] = element->second;
+        received++;
+      }
+    });
+
+  std::vector<std::thread> producers;
+  for (size_t producer = 0; producer < number_of_producers; ++producer) {
+    producers.emplace_back(
+      [&rb, producer]() {
+        for (int i = 0; i < elements_per_producer; ++i) {
+          rb.enqueue(std::make_shared<std::pair<size_t, int>>(producer, i));
+        }
+      });
+  }
+  for (auto & producer : producers) {
+    producer.join();
+  }
+  producers_done.store(true);
+  consumer.join();
+
+  EXPECT_TRUE(in_order);
+  EXPECT_GT(received, 0u);
+  EXPECT_LE(received, number_of_producers * elements_per_producer);
+  EXPECT_FALSE(rb.has_data());
+}
+
+/*
+   Selection through IntraProcessBufferImplementation
+ */
+TEST(TestLockFreeRingBufferImplementation, create_intra_process_buffer) {
+  auto buffer = rclcpp::experimental::create_intra_process_buffer<char>(
+    rclcpp::IntraProcessBufferType::UniquePtr,
+    rclcpp::QoS(2),
+    std::make_shared<std::allocator<void>>(),
+    rclcpp::IntraProcessBufferImplementation::LockFreeSingleProducer);
+
+  EXPECT_FALSE(buffer->has_data());
+  buffer->add_unique(std::make_unique<char>('a'));
+  EXPECT_TRUE(buffer->has_data());
+  auto v = buffer->consume_unique();
+  ASSERT_NE(nullptr, v);
+  EXPECT_EQ('a', *v);
+  EXPECT_FALSE(buffer->has_data());
+}
+
+TEST(TestLockFreeRingBufferImplementation, counters) {
+  LockFreeRingBufferImplementation<char> rb(2);
+
+  auto counters = rb.get_counters();
+  EXPECT_EQ(2u, counters.capacity);
+  EXPECT_EQ(0u, counters.depth);
+  EXPECT_EQ(0u, counters.high_water_mark);
+  EXPECT_EQ(0u, counters.dropped);
+
+  rb.enqueue('a');
+  rb.enqueue('b');
+  rb.enqueue('c');
+  rb.enqueue('d');
+  rb.dequeue();
+
+  counters = rb.get_counters();
+  EXPECT_EQ(1u, counters.depth);
+  EXPECT_EQ(2u, counters.high_water_mark);
+  EXPECT_EQ(2u, counters.dropped);
+
+  // The counters are forwarded by the intra-process buffers
+  auto buffer = rclcpp::experimental::create_intra_process_buffer<char>(
+    rclcpp::IntraProcessBufferType::UniquePtr,
+    rclcpp::QoS(1),
+    std::make_shared<std::allocator<void>>(),
+    rclcpp::IntraProcessBufferImplementation::LockFreeSingleProducer);
+  buffer->add_unique(std::make_unique<char>('a'));
+  buffer->add_unique(std::make_unique<char>('b'));
+  counters = buffer->get_counters();
+  EXPECT_EQ(1u, counters.capacity);
+  EXPECT_EQ(1u, counters.depth);
+  EXPECT_EQ(1u, counters.dropped);
+}
@@ -160,6 +160,42 @@ TEST(TestLogger, set_level) {
   EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
 }
 
+TEST(TestLogger, cached_level) {
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+  using Level = rclcpp::Logger::Level;
+
+  rclcpp::Logger logger = rclcpp::get_logger("test_cached_level");
+  rclcpp::Logger child = logger.get_child("child");
+  EXPECT_FALSE(child.is_enabled_for(Level::Debug));
+  EXPECT_TRUE(child.is_enabled_for(Level::Info));
+
+  // The level of the parent changes the effective level of the child
+  logger.set_level(Level::Debug);
+  EXPECT_TRUE(child.is_enabled_for(Level::Debug));
+  EXPECT_TRUE(rclcpp::Logger(child).is_enabled_for(Level::Debug));
+  logger.set_level(Level::Error);
+  EXPECT_FALSE(child.is_enabled_for(Level::Warn));
+  EXPECT_TRUE(child.is_enabled_for(Level::Error));
+
+  // The default level of rcutils is checked along with the cache
+  logger.set_level(Level::Unset);
+  EXPECT_TRUE(child.is_enabled_for(Level::Info));
+  rcutils_logging_set_default_logger_level(RCUTILS_LOG_SEVERITY_WARN);
+  EXPECT_FALSE(child.is_enabled_for(Level::Info));
+  rcutils_logging_set_default_logger_level(RCUTILS_LOG_SEVERITY_INFO);
+  EXPECT_TRUE(child.is_enabled_for(Level::Info));
+
+  // The levels set with rcutils directly need the caches to be invalidated
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_logging_set_logger_level("test_cached_level.child", RCUTILS_LOG_SEVERITY_FATAL));
+  rclcpp::Logger::invalidate_cached_levels();
+  EXPECT_FALSE(child.is_enabled_for(Level::Error));
+  EXPECT_TRUE(child.is_enabled_for(Level::Fatal));
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+}
+
 TEST(TestLogger, get_logging_directory) {
   ASSERT_EQ(true, rcutils_set_env("HOME", "/fake_home_dir"));
   ASSERT_EQ(true, rcutils_set_env("USERPROFILE", nullptr));
@@ -172,6 +172,23 @@ TEST(TestNodeOptions, enable_rosout) {
   }
 }
 
+TEST(TestNodeOptions, minimal) {
+  auto options = rclcpp::NodeOptions::minimal();
+  EXPECT_FALSE(options.start_parameter_services());
+  EXPECT_FALSE(options.start_parameter_event_publisher());
+  EXPECT_FALSE(options.enable_rosout());
+  EXPECT_FALSE(options.get_rcl_node_options()->enable_rosout);
+  // The other options are the default ones
+  rclcpp::NodeOptions default_options;
+  EXPECT_EQ(default_options.use_global_arguments(), options.use_global_arguments());
+  EXPECT_EQ(default_options.use_clock_thread(), options.use_clock_thread());
+  EXPECT_EQ(
+    default_options.allow_undeclared_parameters(), options.allow_undeclared_parameters());
+
+  options.start_parameter_services(true);
+  EXPECT_TRUE(options.start_parameter_services());
+}
+
 TEST(TestNodeOptions, copy) {
   std::vector<std::string> expected_args{"--unknown-flag", "arg"};
   auto options = rclcpp::NodeOptions().arguments(expected_args).use_global_arguments(false);
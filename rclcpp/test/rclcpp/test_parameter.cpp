@@ -947,3 +947,29 @@ TEST_F(TestParameter, parameter_vector_stringification) {
     "\"string_param\": {\"type\": \"string\", \"value\": \"I'm a string\"}}",
     ss.str());
 }
+
+TEST_F(TestParameter, copies_share_storage) {
+  const std::vector<std::string> TEST_VALUE {"R", "O", "S2"};
+  rclcpp::ParameterValue value(TEST_VALUE);
+  rclcpp::ParameterValue copy = value;
+  EXPECT_EQ(value, copy);
+  // The strings and arrays aren't copied, and the scalars are stored inline.
+  EXPECT_EQ(
+    &value.get<rclcpp::ParameterType::PARAMETER_STRING_ARRAY>(),
+    &copy.get<rclcpp::ParameterType::PARAMETER_STRING_ARRAY>());
+  EXPECT_LT(sizeof(rclcpp::ParameterValue), sizeof(rcl_interfaces::msg::ParameterValue));
+
+  // The values from messages are compared by content.
+  rclcpp::ParameterValue from_msg(value.to_value_msg());
+  EXPECT_NE(
+    &value.get<rclcpp::ParameterType::PARAMETER_STRING_ARRAY>(),
+    &from_msg.get<rclcpp::ParameterType::PARAMETER_STRING_ARRAY>());
+  EXPECT_EQ(value, from_msg);
+  EXPECT_NE(value, rclcpp::ParameterValue(std::vector<std::string>{"R", "O"}));
+  EXPECT_NE(value, rclcpp::ParameterValue(std::string("R")));
+
+  copy = rclcpp::ParameterValue(42);
+  EXPECT_EQ(42, copy.get<int64_t>());
+  EXPECT_EQ(TEST_VALUE, value.get<std::vector<std::string>>());
+  EXPECT_EQ(rclcpp::ParameterValue(), rclcpp::ParameterValue());
+}
@@ -1101,3 +1101,57 @@ TEST_F(TestParameterClient, async_parameter_load_from_map_no_valid_parameter) {
     asynchronous_client->load_parameters(parameter_map),
     rclcpp::exceptions::InvalidParametersException);
 }
+
+/*
+  Coverage for the pool of parameter clients of several remote nodes
+ */
+TEST_F(TestParameterClient, parameters_client_pool) {
+  auto pool = std::make_shared<rclcpp::ParametersClientPool>(node);
+  EXPECT_EQ(0u, pool->size());
+  EXPECT_THROW(pool->get_parameters("", {"foo"}), std::invalid_argument);
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  executor.add_node(node_with_option);
+
+  bool callback_called = false;
+  auto future = pool->get_parameters(
+    node_with_option->get_fully_qualified_name(), {"foo"},
+    [&callback_called](std::shared_future<std::vector<rclcpp::Parameter>> result) {
+      callback_called = result.valid() && result.get().size() == 1;
+    });
+  // Only the client of the requested service is created.
+  EXPECT_EQ(1u, pool->size());
+  EXPECT_EQ(1u, pool->get_number_of_clients());
+  ASSERT_EQ(
+    rclcpp::FutureReturnCode::SUCCESS,
+    executor.spin_until_future_complete(future, std::chrono::seconds(5)));
+  EXPECT_TRUE(callback_called);
+  EXPECT_EQ("foo", future.get()[0].get_name());
+
+  auto list_future = pool->list_parameters(node->get_fully_qualified_name(), {}, 0);
+  auto types_future = pool->get_parameter_types(
+    node_with_option->get_fully_qualified_name(), {"foo"});
+  EXPECT_EQ(2u, pool->size());
+  EXPECT_EQ(3u, pool->get_number_of_clients());
+  ASSERT_EQ(
+    rclcpp::FutureReturnCode::SUCCESS,
+    executor.spin_until_future_complete(list_future, std::chrono::seconds(5)));
+  ASSERT_EQ(
+    rclcpp::FutureReturnCode::SUCCESS,
+    executor.spin_until_future_complete(types_future, std::chrono::seconds(5)));
+  ASSERT_EQ(1u, types_future.get().size());
+  EXPECT_EQ(rclcpp::ParameterType::PARAMETER_NOT_SET, types_future.get()[0]);
+
+  // The clients are reused by the next requests.
+  auto get_future = pool->get_parameters(node_with_option->get_fully_qualified_name(), {"bar"});
+  EXPECT_EQ(3u, pool->get_number_of_clients());
+  ASSERT_EQ(
+    rclcpp::FutureReturnCode::SUCCESS,
+    executor.spin_until_future_complete(get_future, std::chrono::seconds(5)));
+
+  EXPECT_TRUE(pool->remove(node_with_option->get_fully_qualified_name()));
+  EXPECT_FALSE(pool->remove(node_with_option->get_fully_qualified_name()));
+  EXPECT_EQ(1u, pool->size());
+  EXPECT_EQ(1u, pool->get_number_of_clients());
+}
@@ -16,6 +16,7 @@
 #include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "rclcpp/rclcpp.hpp"
@@ -27,6 +28,18 @@ public:
   : ParameterEventHandler(node)
   {}
 
+  TestParameterEventHandler(rclcpp::Node::SharedPtr node, bool filter_by_node)
+  : ParameterEventHandler(
+      node,
+      rclcpp::QoS(rclcpp::QoSInitialization::from_rmw(rmw_qos_profile_parameter_events)),
+      filter_by_node)
+  {}
+
+  rclcpp::Subscription<rcl_interfaces::msg::ParameterEvent>::SharedPtr get_subscription()
+  {
+    return event_subscription_;
+  }
+
   void test_event(rcl_interfaces::msg::ParameterEvent::ConstSharedPtr event)
   {
     callbacks_->event_callback(*event);
@@ -39,7 +52,11 @@ public:
 
   size_t num_parameter_callbacks()
   {
-    return callbacks_->parameter_callbacks_.size();
+    size_t count = 0;
+    for (const auto & node_callbacks : callbacks_->parameter_callbacks_) {
+      count += node_callbacks.second.size();
+    }
+    return count;
   }
 };
 
@@ -179,6 +196,49 @@ TEST_F(TestNode, SameParameterDifferentNode)
   EXPECT_EQ(param_handler->num_parameter_callbacks(), 0UL);
 }
 
+TEST_F(TestNode, ExpiredParameterCallbacks)
+{
+  int calls = 0;
+  auto cb = [&calls](const rclcpp::Parameter &) {calls++;};
+
+  auto h1 = param_handler->add_parameter_callback("my_int", cb);
+  auto h2 = param_handler->add_parameter_callback("my_int", cb);
+  auto h3 = param_handler->add_parameter_callback("my_int", cb);
+  h2.reset();
+
+  param_handler->test_event(same_node_int);
+  EXPECT_EQ(2, calls);
+  // Events of other nodes don't call the callbacks of this node.
+  param_handler->test_event(diff_node_int);
+  EXPECT_EQ(2, calls);
+}
+
+TEST_F(TestNode, FilterByNode)
+{
+  auto handler = std::make_shared<TestParameterEventHandler>(node, true);
+  bool received = false;
+  auto cb = [&received](const rclcpp::Parameter &) {received = true;};
+  auto h1 = handler->add_parameter_callback("my_string", cb, remote_node_name);
+  handler->test_event(remote_node_string);
+  EXPECT_TRUE(received);
+
+  auto subscription = handler->get_subscription();
+  if (!subscription->is_cft_enabled()) {
+    // The middleware doesn't support content filtering.
+    return;
+  }
+  auto filter = subscription->get_content_filter();
+  EXPECT_EQ("node = %0 OR node = %1", filter.filter_expression);
+  EXPECT_EQ(
+    (std::vector<std::string>{
+    "'" + std::string(node->get_fully_qualified_name()) + "'", "'" + remote_node_name + "'"}),
+    filter.expression_parameters);
+
+  handler->remove_parameter_callback(h1);
+  filter = subscription->get_content_filter();
+  EXPECT_EQ("node = %0", filter.filter_expression);
+}
+
 TEST_F(TestNode, GetParameterFromEvent)
 {
   using rclcpp::ParameterEventHandler;
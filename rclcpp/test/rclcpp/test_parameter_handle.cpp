@@ -0,0 +1,102 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rclcpp/parameter_handle.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+class TestParameterHandle : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+
+  void SetUp()
+  {
+    node = std::make_shared<rclcpp::Node>("test_parameter_handle");
+  }
+
+  rclcpp::Node::SharedPtr node;
+};
+
+TEST_F(TestParameterHandle, arithmetic_value) {
+  node->declare_parameter("kp", 1.5);
+  auto handle = node->get_parameter_handle<double>("kp");
+  EXPECT_EQ("kp", handle->get_name());
+  EXPECT_DOUBLE_EQ(1.5, handle->get());
+
+  node->set_parameter(rclcpp::Parameter("kp", 2.5));
+  EXPECT_DOUBLE_EQ(2.5, handle->get());
+
+  // Other parameters don't change the value.
+  node->declare_parameter("ki", 0.5);
+  node->set_parameter(rclcpp::Parameter("ki", 3.5));
+  EXPECT_DOUBLE_EQ(2.5, handle->get());
+
+  // A rejected value isn't cached.
+  auto callback_handle = node->add_on_set_parameters_callback(
+    [](const std::vector<rclcpp::Parameter> &) {
+      rcl_interfaces::msg::SetParametersResult result;
+      result.successful = false;
+      return result;
+    });
+  EXPECT_FALSE(node->set_parameter(rclcpp::Parameter("kp", 4.5)).successful);
+  EXPECT_DOUBLE_EQ(2.5, handle->get());
+}
+
+TEST_F(TestParameterHandle, shared_value) {
+  node->declare_parameter("frame", std::string("base_link"));
+  auto handle = node->get_parameter_handle<std::string>("frame");
+  std::shared_ptr<const std::string> frame = handle->get();
+  EXPECT_EQ("base_link", *frame);
+
+  node->set_parameter(rclcpp::Parameter("frame", "odom"));
+  EXPECT_EQ("odom", *handle->get());
+  // The previous value stays valid.
+  EXPECT_EQ("base_link", *frame);
+}
+
+TEST_F(TestParameterHandle, invalid_parameter) {
+  EXPECT_THROW(
+    node->get_parameter_handle<double>("not_declared"),
+    rclcpp::exceptions::ParameterNotDeclaredException);
+
+  node->declare_parameter("count", 1);
+  EXPECT_THROW(node->get_parameter_handle<double>("count"), rclcpp::ParameterTypeException);
+  auto handle = node->get_parameter_handle<int64_t>("count");
+  EXPECT_EQ(1, handle->get());
+}
+
+TEST_F(TestParameterHandle, destroyed_handle) {
+  node->declare_parameter("kp", 1.0);
+  {
+    auto handle = node->get_parameter_handle<double>("kp");
+    EXPECT_DOUBLE_EQ(1.0, handle->get());
+  }
+  // The callback of the destroyed handle isn't called anymore.
+  EXPECT_TRUE(node->set_parameter(rclcpp::Parameter("kp", 2.0)).successful);
+  EXPECT_DOUBLE_EQ(2.0, node->get_parameter_handle<double>("kp")->get());
+}
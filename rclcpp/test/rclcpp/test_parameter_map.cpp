@@ -18,10 +18,15 @@
 #include <rcutils/strdup.h>
 
 #include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "rcpputils/filesystem_helper.hpp"
+
 #include "rclcpp/parameter_map.hpp"
 
 rcl_params_t *
@@ -483,3 +488,93 @@ TEST(Test_parameter_map_from, multi_nodes_diff_param_name_by_node_fqn)
   delete[] c_hello_world;
   rcl_yaml_node_struct_fini(c_params);
 }
+
+TEST(Test_parameter_map_snapshot, round_trip)
+{
+  const std::string filename =
+    (rcpputils::fs::temp_directory_path() / "test_parameter_map_round_trip.snapshot").string();
+  rclcpp::ParameterMap map;
+  map["/ns/node"] = {
+    rclcpp::Parameter("bool", true),
+    rclcpp::Parameter("integer", 42),
+    rclcpp::Parameter("double", 1.5),
+    rclcpp::Parameter("string", "hello"),
+    rclcpp::Parameter("bytes", std::vector<uint8_t>{0, 255}),
+    rclcpp::Parameter("bools", std::vector<bool>{true, false, true}),
+    rclcpp::Parameter("integers", std::vector<int64_t>{-1, 2}),
+    rclcpp::Parameter("doubles", std::vector<double>{0.5, -3.0}),
+    rclcpp::Parameter("strings", std::vector<std::string>{"a", ""}),
+    rclcpp::Parameter("not_set"),
+  };
+  map["/other_node"] = {rclcpp::Parameter("integer", 1)};
+
+  rclcpp::parameter_map_to_snapshot_file(map, filename);
+  rclcpp::ParameterMap loaded = rclcpp::parameter_map_from_snapshot_file(filename);
+  EXPECT_EQ(map, loaded);
+
+  loaded = rclcpp::parameter_map_from_snapshot_file(filename, "/ns/node");
+  ASSERT_EQ(1u, loaded.size());
+  EXPECT_EQ(map.at("/ns/node"), loaded.at("/ns/node"));
+  EXPECT_EQ(map.at("/ns/node"), rclcpp::parameters_from_map(loaded, "/ns/node"));
+
+  rclcpp::parameter_map_to_snapshot_file({}, filename);
+  EXPECT_TRUE(rclcpp::parameter_map_from_snapshot_file(filename).empty());
+  rcpputils::fs::remove(filename);
+}
+
+TEST(Test_parameter_map_snapshot, wildcard_node_name)
+{
+  const std::string filename =
+    (rcpputils::fs::temp_directory_path() / "test_parameter_map_wildcard.snapshot").string();
+  rclcpp::ParameterMap map;
+  map["/**"] = {rclcpp::Parameter("integer", 1)};
+  map["/ns/other_node"] = {rclcpp::Parameter("integer", 2)};
+  rclcpp::parameter_map_to_snapshot_file(map, filename);
+
+  rclcpp::ParameterMap loaded = rclcpp::parameter_map_from_snapshot_file(filename, "/ns/node");
+  ASSERT_EQ(1u, loaded.size());
+  EXPECT_EQ(map.at("/**"), loaded.at("/ns/node"));
+  rcpputils::fs::remove(filename);
+}
+
+TEST(Test_parameter_map_snapshot, invalid_snapshot)
+{
+  const std::string filename =
+    (rcpputils::fs::temp_directory_path() / "test_parameter_map_invalid.snapshot").string();
+  const std::string truncated_filename = filename + ".truncated";
+  EXPECT_THROW(
+    rclcpp::parameter_map_from_snapshot_file(filename + ".missing"),
+    rclcpp::exceptions::InvalidParametersException);
+
+  rclcpp::ParameterMap map;
+  map["/ns/node"] = {
+    rclcpp::Parameter("string", "hello"),
+    rclcpp::Parameter("strings", std::vector<std::string>{"a"}),
+  };
+  rclcpp::parameter_map_to_snapshot_file(map, filename);
+  std::ifstream file(filename, std::ios::binary);
+  const std::string contents{
+    std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+  // Every truncation of the snapshot is detected
+  for (size_t size = 0; size < contents.size(); ++size) {
+    {
+      std::ofstream truncated(truncated_filename, std::ios::binary | std::ios::trunc);
+      truncated.write(contents.data(), static_cast<std::streamsize>(size));
+    }
+    EXPECT_THROW(
+      rclcpp::parameter_map_from_snapshot_file(truncated_filename),
+      rclcpp::exceptions::InvalidParametersException) << "size " << size;
+  }
+
+  {
+    std::ofstream yaml(truncated_filename, std::ios::trunc);
+    yaml << "/ns/node:\n  ros__parameters:\n    string: hello\n";
+  }
+  EXPECT_THROW(
+    rclcpp::parameter_map_from_snapshot_file(truncated_filename),
+    rclcpp::exceptions::InvalidParametersException);
+
+  rcpputils::fs::remove(truncated_filename);
+  rcpputils::fs::remove(filename);
+}
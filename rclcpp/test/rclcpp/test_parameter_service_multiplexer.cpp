@@ -0,0 +1,146 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rclcpp/parameter_service_multiplexer.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "../utils/rclcpp_gtest_macros.hpp"
+
+using namespace std::chrono_literals;
+using rclcpp::ParameterServiceMultiplexer;
+
+class TestParameterServiceMultiplexer : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+
+  void SetUp()
+  {
+    const auto options = rclcpp::NodeOptions().start_parameter_services(false);
+    host = std::make_shared<rclcpp::Node>("host", "/ns", options);
+    node1 = std::make_shared<rclcpp::Node>("node1", "/ns", options);
+    node2 = std::make_shared<rclcpp::Node>("node2", "/ns", options);
+    node1->declare_parameter("parameter", 1);
+    node2->declare_parameter("parameter", 2);
+
+    multiplexer = std::make_shared<ParameterServiceMultiplexer>(
+      host->get_node_base_interface(), host->get_node_services_interface());
+    multiplexer->add_node(node1);
+    multiplexer->add_node(node2);
+
+    client = std::make_shared<rclcpp::SyncParametersClient>(host);
+    ASSERT_TRUE(client->wait_for_service(std::chrono::seconds(1)));
+  }
+
+  rclcpp::Node::SharedPtr host;
+  rclcpp::Node::SharedPtr node1;
+  rclcpp::Node::SharedPtr node2;
+  ParameterServiceMultiplexer::SharedPtr multiplexer;
+  rclcpp::SyncParametersClient::SharedPtr client;
+};
+
+TEST_F(TestParameterServiceMultiplexer, add_remove_node) {
+  EXPECT_EQ(
+    "/ns/node1:parameter",
+    ParameterServiceMultiplexer::make_parameter_name("/ns/node1", "parameter"));
+  RCLCPP_EXPECT_THROW_EQ(
+    multiplexer->add_node(node1),
+    std::invalid_argument(
+      "the node '/ns/node1' was already added to the parameter service multiplexer"));
+  RCLCPP_EXPECT_THROW_EQ(
+    multiplexer->add_node(nullptr, node1->get_node_parameters_interface()),
+    std::invalid_argument("the node added to a parameter service multiplexer is null"));
+
+  EXPECT_TRUE(multiplexer->remove_node("/ns/node1"));
+  EXPECT_FALSE(multiplexer->remove_node("/ns/node1"));
+  EXPECT_EQ(-1, client->get_parameter("/ns/node1:parameter", -1));
+  EXPECT_EQ(2, client->get_parameter("/ns/node2:parameter", -1));
+}
+
+TEST_F(TestParameterServiceMultiplexer, get_parameters) {
+  EXPECT_EQ(1, client->get_parameter("/ns/node1:parameter", 0));
+  EXPECT_EQ(2, client->get_parameter("/ns/node2:parameter", 0));
+  EXPECT_EQ(-1, client->get_parameter("/ns/node1:undeclared_parameter", -1));
+  EXPECT_EQ(-1, client->get_parameter("/ns/unknown_node:parameter", -1));
+  EXPECT_EQ(-1, client->get_parameter("parameter", -1));
+
+  const auto types = client->get_parameter_types({"/ns/node1:parameter"}, 10s);
+  ASSERT_EQ(1u, types.size());
+  EXPECT_EQ(rclcpp::ParameterType::PARAMETER_INTEGER, types[0]);
+
+  const auto descriptors = client->describe_parameters({"/ns/node2:parameter"}, 10s);
+  ASSERT_EQ(1u, descriptors.size());
+  EXPECT_EQ("/ns/node2:parameter", descriptors[0].name);
+}
+
+TEST_F(TestParameterServiceMultiplexer, set_parameters) {
+  auto results = client->set_parameters(
+    {
+      rclcpp::Parameter("/ns/node1:parameter", 10),
+      rclcpp::Parameter("/ns/unknown_node:parameter", 10),
+    }, 10s);
+  ASSERT_EQ(2u, results.size());
+  EXPECT_TRUE(results[0].successful);
+  EXPECT_FALSE(results[1].successful);
+  EXPECT_EQ(10, node1->get_parameter("parameter").as_int());
+
+  auto result = client->set_parameters_atomically(
+    {rclcpp::Parameter("/ns/node2:parameter", 20)}, 10s);
+  EXPECT_TRUE(result.successful);
+  EXPECT_EQ(20, node2->get_parameter("parameter").as_int());
+
+  // The parameters of several nodes can't be set atomically
+  result = client->set_parameters_atomically(
+    {
+      rclcpp::Parameter("/ns/node1:parameter", 30),
+      rclcpp::Parameter("/ns/node2:parameter", 30),
+    }, 10s);
+  EXPECT_FALSE(result.successful);
+  EXPECT_EQ(10, node1->get_parameter("parameter").as_int());
+  EXPECT_EQ(20, node2->get_parameter("parameter").as_int());
+}
+
+TEST_F(TestParameterServiceMultiplexer, list_parameters) {
+  auto all_parameters = client->list_parameters({}, 1, 10s).names;
+  EXPECT_NE(
+    std::find(all_parameters.begin(), all_parameters.end(), "/ns/node1:parameter"),
+    all_parameters.end());
+  EXPECT_NE(
+    std::find(all_parameters.begin(), all_parameters.end(), "/ns/node2:parameter"),
+    all_parameters.end());
+
+  auto node1_parameters = client->list_parameters({"/ns/node1:"}, 1, 10s).names;
+  EXPECT_NE(
+    std::find(node1_parameters.begin(), node1_parameters.end(), "/ns/node1:parameter"),
+    node1_parameters.end());
+  for (const auto & name : node1_parameters) {
+    EXPECT_EQ(0u, name.find("/ns/node1:")) << name;
+  }
+}
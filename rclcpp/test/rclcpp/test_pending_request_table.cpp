@@ -0,0 +1,134 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "rclcpp/detail/pending_request_table.hpp"
+
+using rclcpp::detail::PendingRequestTable;
+
+TEST(TestPendingRequestTable, emplace_take_erase) {
+  PendingRequestTable<std::unique_ptr<int>> table(3);
+  EXPECT_EQ(4u, table.capacity());
+  const auto now = std::chrono::system_clock::now();
+
+  EXPECT_TRUE(table.emplace(1, now, std::make_unique<int>(1)));
+  EXPECT_FALSE(table.emplace(1, now, std::make_unique<int>(1)));
+  EXPECT_TRUE(table.emplace(2, now, std::make_unique<int>(2)));
+  EXPECT_EQ(2u, table.size());
+
+  auto value = table.take(1);
+  ASSERT_TRUE(value);
+  EXPECT_EQ(1, **value);
+  EXPECT_FALSE(table.take(1));
+  // Same slot, but another sequence number.
+  EXPECT_FALSE(table.take(6));
+  EXPECT_FALSE(table.erase(6));
+  EXPECT_TRUE(table.erase(2));
+  EXPECT_EQ(0u, table.size());
+}
+
+TEST(TestPendingRequestTable, slots_are_reused) {
+  PendingRequestTable<int> table(4);
+  const auto now = std::chrono::system_clock::now();
+  for (int64_t sequence_number = 1; sequence_number <= 100; ++sequence_number) {
+    ASSERT_TRUE(table.emplace(sequence_number, now, static_cast<int>(sequence_number)));
+    if (sequence_number > 2) {
+      auto value = table.take(sequence_number - 2);
+      ASSERT_TRUE(value);
+      EXPECT_EQ(sequence_number - 2, *value);
+    }
+  }
+  EXPECT_EQ(2u, table.size());
+  EXPECT_EQ(4u, table.capacity());
+}
+
+TEST(TestPendingRequestTable, grow) {
+  PendingRequestTable<int> table(4);
+  const auto now = std::chrono::system_clock::now();
+  // Colliding with 1 when half of the slots are used, so the slots double.
+  ASSERT_TRUE(table.emplace(1, now, 1));
+  ASSERT_TRUE(table.emplace(2, now, 2));
+  ASSERT_TRUE(table.emplace(5, now, 5));
+  EXPECT_EQ(8u, table.capacity());
+  // Colliding with 1 again when less than half of the slots are used, so 1 is kept out of them.
+  ASSERT_TRUE(table.emplace(9, now + std::chrono::seconds(1), 9));
+  EXPECT_FALSE(table.emplace(1, now, 1));
+  EXPECT_EQ(8u, table.capacity());
+  EXPECT_EQ(4u, table.size());
+  for (int64_t sequence_number : {1, 2, 5, 9}) {
+    auto value = table.take(sequence_number);
+    ASSERT_TRUE(value);
+    EXPECT_EQ(sequence_number, *value);
+  }
+  EXPECT_EQ(0u, table.size());
+}
+
+TEST(TestPendingRequestTable, straggler_does_not_grow_the_slots) {
+  PendingRequestTable<int> table(4);
+  const auto now = std::chrono::system_clock::now();
+  // A request which never gets its response.
+  ASSERT_TRUE(table.emplace(1, now, 1));
+  for (int64_t sequence_number = 2; sequence_number <= 1000; ++sequence_number) {
+    ASSERT_TRUE(table.emplace(sequence_number, now, static_cast<int>(sequence_number)));
+    ASSERT_TRUE(table.take(sequence_number));
+  }
+  // The intra-process requests of a client count down from -1.
+  for (int64_t sequence_number = -1; sequence_number >= -1000; --sequence_number) {
+    ASSERT_TRUE(table.emplace(sequence_number, now, static_cast<int>(sequence_number)));
+    ASSERT_TRUE(table.emplace(-sequence_number + 1000, now, 0));
+    ASSERT_TRUE(table.erase(sequence_number));
+    ASSERT_TRUE(table.erase(-sequence_number + 1000));
+  }
+  // Sized for the three requests pending at the same time.
+  EXPECT_EQ(8u, table.capacity());
+  EXPECT_EQ(1u, table.size());
+  EXPECT_EQ(
+    1u, table.erase_if(
+      [](int64_t sequence_number, std::chrono::system_clock::time_point) {
+        return sequence_number == 1;
+      }));
+  EXPECT_EQ(0u, table.size());
+}
+
+TEST(TestPendingRequestTable, erase_if_and_clear) {
+  PendingRequestTable<int> table;
+  const auto now = std::chrono::system_clock::now();
+  for (int64_t sequence_number = 1; sequence_number <= 4; ++sequence_number) {
+    ASSERT_TRUE(
+      table.emplace(
+        sequence_number, now + std::chrono::seconds(sequence_number),
+        static_cast<int>(sequence_number)));
+  }
+  std::vector<int64_t> erased;
+  EXPECT_EQ(
+    2u, table.erase_if(
+      [now, &erased](int64_t sequence_number, std::chrono::system_clock::time_point time) {
+        if (time > now + std::chrono::seconds(2)) {
+          return false;
+        }
+        erased.push_back(sequence_number);
+        return true;
+      }));
+  EXPECT_EQ((std::vector<int64_t>{1, 2}), erased);
+  EXPECT_EQ(2u, table.size());
+  EXPECT_EQ(2u, table.clear());
+  EXPECT_EQ(0u, table.size());
+  EXPECT_FALSE(table.take(3));
+}
@@ -196,11 +196,7 @@ static std::vector<TestParameters> invalid_qos_profiles()
 {
   std::vector<TestParameters> parameters;
 
-  parameters.reserve(2);
-  parameters.push_back(
-    TestParameters(
-      rclcpp::QoS(rclcpp::KeepLast(10)).transient_local(),
-      "transient_local_qos"));
+  parameters.reserve(1);
   parameters.push_back(
     TestParameters(
       rclcpp::QoS(rclcpp::KeepAll()),
@@ -409,9 +405,7 @@ TEST_F(TestPublisher, intra_process_publish_failures) {
   std::allocator<void> allocator;
   {
     rclcpp::LoanedMessage<test_msgs::msg::Empty> loaned_msg(*publisher, allocator);
-    RCLCPP_EXPECT_THROW_EQ(
-      publisher->publish(std::move(loaned_msg)),
-      std::runtime_error("storing loaned messages in intra process is not supported yet"));
+    EXPECT_NO_THROW(publisher->publish(std::move(loaned_msg)));
   }
 
   {
@@ -436,6 +430,149 @@ TEST_F(TestPublisher, intra_process_publish_failures) {
       "intraprocess communication is not allowed with a zero qos history depth value"));
 }
 
+TEST_F(TestPublisher, intra_process_transient_local) {
+  initialize(rclcpp::NodeOptions().use_intra_process_comms(true));
+  const auto qos = rclcpp::QoS(2).transient_local();
+  auto publisher = node->create_publisher<test_msgs::msg::Strings>("topic", qos);
+  for (const char * data : {"first", "second", "third"}) {
+    auto msg = std::make_unique<test_msgs::msg::Strings>();
+    msg->string_value = data;
+    publisher->publish(std::move(msg));
+  }
+
+  // The late joining subscription gets the 2 last messages, without the middleware
+  std::vector<std::string> received;
+  auto subscription = node->create_subscription<test_msgs::msg::Strings>(
+    "topic", qos,
+    [&received](test_msgs::msg::Strings::ConstSharedPtr msg) {
+      received.push_back(msg->string_value);
+    });
+  EXPECT_EQ(1u, publisher->get_intra_process_subscription_count());
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (received.size() < 2u && std::chrono::steady_clock::now() < deadline) {
+    executor.spin_some();
+  }
+  EXPECT_EQ((std::vector<std::string>{"second", "third"}), received);
+}
+
+TEST_F(TestPublisher, async_publish_writer) {
+  initialize(rclcpp::NodeOptions().use_intra_process_comms(false));
+  rclcpp::PublisherOptions options;
+  options.async_publish_writer = std::make_shared<rclcpp::AsyncPublishWriter>();
+  options.async_publish_queue_size = 32;
+  auto publisher = node->create_publisher<test_msgs::msg::Strings>("topic", 32, options);
+
+  std::vector<std::string> received;
+  auto subscription = node->create_subscription<test_msgs::msg::Strings>(
+    "topic", 32,
+    [&received](test_msgs::msg::Strings::ConstSharedPtr msg) {
+      received.push_back(msg->string_value);
+    });
+  const std::vector<std::string> published{"first", "second", "third"};
+  test_msgs::msg::Strings msg;
+  msg.string_value = published[0];
+  publisher->publish(msg);
+  auto borrowed_msg = publisher->borrow_message();
+  borrowed_msg->string_value = published[1];
+  publisher->publish(std::move(borrowed_msg));
+  msg.string_value = published[2];
+  publisher->publish(msg);
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (received.size() < published.size() && std::chrono::steady_clock::now() < deadline) {
+    executor.spin_some(std::chrono::milliseconds(100));
+  }
+  EXPECT_EQ(published, received);
+  const auto counters = publisher->get_async_publish_queue_counters();
+  EXPECT_EQ(32u, counters.capacity);
+  EXPECT_EQ(0u, counters.depth);
+  EXPECT_EQ(0u, counters.dropped);
+}
+
+TEST_F(TestPublisher, intra_process_loaned_messages) {
+  initialize(rclcpp::NodeOptions().use_intra_process_comms(true));
+  std::vector<std::string> received;
+  auto subscription = node->create_subscription<test_msgs::msg::Strings>(
+    "topic", 10,
+    [&received](test_msgs::msg::Strings::ConstSharedPtr msg) {
+      received.push_back(msg->string_value);
+    });
+  for (size_t loaned_message_pool_size : {0u, 1u}) {
+    rclcpp::PublisherOptions options;
+    options.loaned_message_pool_size = loaned_message_pool_size;
+    auto publisher = node->create_publisher<test_msgs::msg::Strings>("topic", 10, options);
+    EXPECT_EQ(1u, publisher->get_intra_process_subscription_count());
+    for (const char * data : {"first", "second"}) {
+      auto loaned_msg = publisher->borrow_loaned_message();
+      loaned_msg.get().string_value = data;
+      publisher->publish(std::move(loaned_msg));
+    }
+  }
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (received.size() < 4u && std::chrono::steady_clock::now() < deadline) {
+    executor.spin_some();
+  }
+  EXPECT_EQ((std::vector<std::string>{"first", "second", "first", "second"}), received);
+}
+
+TEST_F(TestPublisher, intra_process_across_contexts) {
+  auto make_context = [](size_t domain_id) {
+      auto init_options = rclcpp::InitOptions().auto_initialize_logging(false);
+      init_options.set_domain_id(domain_id);
+      init_options.share_intra_process_manager(true);
+      auto context = std::make_shared<rclcpp::Context>();
+      context->init(0, nullptr, init_options);
+      return context;
+    };
+  auto publisher_context = make_context(42u);
+  auto subscription_context = make_context(42u);
+  auto options = rclcpp::NodeOptions().use_intra_process_comms(true);
+  auto publisher_node = std::make_shared<rclcpp::Node>(
+    "publisher_node", "/ns", rclcpp::NodeOptions(options).context(publisher_context));
+  auto subscription_node = std::make_shared<rclcpp::Node>(
+    "subscription_node", "/ns", rclcpp::NodeOptions(options).context(subscription_context));
+
+  const test_msgs::msg::Strings * received = nullptr;
+  auto subscription = subscription_node->create_subscription<test_msgs::msg::Strings>(
+    "topic", 10,
+    [&received](test_msgs::msg::Strings::UniquePtr msg) {
+      received = msg.get();
+    });
+  auto publisher = publisher_node->create_publisher<test_msgs::msg::Strings>("topic", 10);
+  EXPECT_EQ(1u, publisher->get_intra_process_subscription_count());
+
+  // The subscription is the only one, so it receives the published message itself
+  auto msg = std::make_unique<test_msgs::msg::Strings>();
+  const test_msgs::msg::Strings * published = msg.get();
+  publisher->publish(std::move(msg));
+  {
+    rclcpp::ExecutorOptions executor_options;
+    executor_options.context = subscription_context;
+    rclcpp::executors::SingleThreadedExecutor executor(executor_options);
+    executor.add_node(subscription_node);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!received && std::chrono::steady_clock::now() < deadline) {
+      executor.spin_some();
+    }
+  }
+  EXPECT_EQ(published, received);
+
+  // The intra process manager outlives the context destroyed first
+  subscription.reset();
+  subscription_node.reset();
+  subscription_context.reset();
+  EXPECT_EQ(0u, publisher->get_intra_process_subscription_count());
+  EXPECT_NO_THROW(publisher->publish(test_msgs::msg::Strings()));
+}
+
 TEST_F(TestPublisher, inter_process_publish_failures) {
   initialize();
   rclcpp::PublisherOptionsWithAllocator<std::allocator<void>> options;
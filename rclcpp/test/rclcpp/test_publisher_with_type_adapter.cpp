@@ -20,13 +20,18 @@
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/loaned_message.hpp"
 #include "rclcpp/rclcpp.hpp"
+#include "rclcpp/serialization.hpp"
+#include "rclcpp/serialized_message.hpp"
 
 #include "rclcpp/msg/string.hpp"
 
+#include "../mocking_utils/patch.hpp"
+
 
 using namespace std::chrono_literals;
 
@@ -105,6 +110,48 @@ struct TypeAdapter<int, rclcpp::msg::String>
   }
 };
 
+// Serializes itself, and throws in conversion
+struct SerializableString
+{
+  std::string data;
+};
+
+template<>
+struct TypeAdapter<SerializableString, rclcpp::msg::String>
+{
+  using is_specialized = std::true_type;
+  using custom_type = SerializableString;
+  using ros_message_type = rclcpp::msg::String;
+
+  static void
+  convert_to_ros_message(
+    const custom_type & source,
+    ros_message_type & destination)
+  {
+    (void) source;
+    (void) destination;
+    throw std::runtime_error("This should not happen");
+  }
+
+  static void
+  convert_to_custom(
+    const ros_message_type & source,
+    custom_type & destination)
+  {
+    destination.data = source.data;
+  }
+
+  static void
+  convert_to_serialized_message(
+    const custom_type & source,
+    rclcpp::SerializedMessage & destination)
+  {
+    ros_message_type message;
+    message.data = source.data;
+    rclcpp::Serialization<ros_message_type>().serialize_message(&message, &destination);
+  }
+};
+
 }  // namespace rclcpp
 
 /*
@@ -152,6 +199,32 @@ TEST_F(TestPublisher, conversion_exception_is_passed_up) {
   }
 }
 
+TEST_F(TestPublisher, skip_publish_without_subscriptions) {
+  using BadStringTypeAdapter = rclcpp::TypeAdapter<int, rclcpp::msg::String>;
+  for (auto is_intra_process : {true, false}) {
+    rclcpp::NodeOptions options;
+    options.use_intra_process_comms(is_intra_process);
+    auto node = std::make_shared<rclcpp::Node>("my_node", "/ns", options);
+
+    rclcpp::PublisherOptions publisher_options;
+    publisher_options.skip_publish_without_subscriptions = true;
+    auto pub = node->create_publisher<BadStringTypeAdapter>(
+      "skipped_topic", 1, publisher_options);
+    EXPECT_FALSE(pub->has_subscriptions());
+    // The message isn't converted, since nobody would receive it.
+    EXPECT_NO_THROW(pub->publish(1));
+    EXPECT_NO_THROW(pub->publish(std::make_unique<int>(1)));
+
+    auto sub = node->create_subscription<rclcpp::msg::String>(
+      "skipped_topic", 1, [](const rclcpp::msg::String &) {});
+    for (int i = 0; i < g_max_loops && !pub->has_subscriptions(); ++i) {
+      std::this_thread::sleep_for(g_sleep_per_loop);
+    }
+    EXPECT_TRUE(pub->has_subscriptions());
+    EXPECT_THROW(pub->publish(1), std::runtime_error);
+  }
+}
+
 /*
  * Testing that publisher sends type adapted types and ROS message types with intra proccess communications.
  */
@@ -307,3 +380,79 @@ TEST_F(TestPublisher, check_type_adapted_message_is_sent_and_received) {
     assert_message_was_received();
   }
 }
+
+/*
+ * Testing that a custom type is serialized by its type adapter for inter process communications.
+ */
+TEST_F(TestPublisher, type_adapted_message_is_serialized_by_its_adapter) {
+  using SerializableStringTypeAdapter =
+    rclcpp::TypeAdapter<rclcpp::SerializableString, rclcpp::msg::String>;
+  static_assert(
+    rclcpp::detail::has_convert_to_serialized_message<SerializableStringTypeAdapter>::value,
+    "the type adapter should serialize its custom type");
+
+  auto node = std::make_shared<rclcpp::Node>("my_node", "/ns", rclcpp::NodeOptions());
+  const std::string topic_name = "serialized_topic_name";
+  auto pub = node->create_publisher<SerializableStringTypeAdapter>(topic_name, 10);
+  auto sub = node->create_subscription<rclcpp::msg::String>(
+    topic_name, 10, [](std::shared_ptr<const rclcpp::msg::String>) {FAIL();});
+
+  auto assert_message_was_received = [sub](const std::string & message_data) {
+      rclcpp::msg::String msg;
+      rclcpp::MessageInfo msg_info;
+      bool message_received = false;
+      auto start = std::chrono::steady_clock::now();
+      do {
+        message_received = sub->take(msg, msg_info);
+        std::this_thread::sleep_for(100ms);
+      } while (!message_received && std::chrono::steady_clock::now() - start < 10s);
+      EXPECT_TRUE(message_received);
+      EXPECT_EQ(message_data, msg.data);
+    };
+
+  // The ROS message isn't converted from the custom type, which would throw
+  EXPECT_NO_THROW(pub->publish(rclcpp::SerializableString{"by reference"}));
+  assert_message_was_received("by reference");
+  EXPECT_NO_THROW(
+    pub->publish(std::make_unique<rclcpp::SerializableString>(
+      rclcpp::SerializableString{"unique pointer"})));
+  assert_message_was_received("unique pointer");
+}
+
+/*
+ * Testing that a custom type is converted into a message loaned by the middleware.
+ */
+TEST_F(TestPublisher, type_adapted_message_is_converted_into_loaned_message) {
+  using StringTypeAdapter = rclcpp::TypeAdapter<std::string, rclcpp::msg::String>;
+
+  auto node = std::make_shared<rclcpp::Node>("my_node", "/ns", rclcpp::NodeOptions());
+  auto pub = node->create_publisher<StringTypeAdapter>("loaned_topic_name", 10);
+
+  auto mock_can_loan = mocking_utils::patch_and_return(
+    "lib:rclcpp", rcl_publisher_can_loan_messages, true);
+  rclcpp::msg::String loaned_message;
+  auto mock_borrow_loaned = mocking_utils::patch(
+    "self", rcl_borrow_loaned_message,
+    [&loaned_message](
+      const rcl_publisher_t *, const rosidl_message_type_support_t *, void ** ros_message) {
+      *ros_message = &loaned_message;
+      return RCL_RET_OK;
+    });
+  std::vector<std::string> published_data;
+  auto mock_publish_loaned = mocking_utils::patch(
+    "self", rcl_publish_loaned_message,
+    [&loaned_message, &published_data](
+      const rcl_publisher_t *, void * ros_message, rmw_publisher_allocation_t *) {
+      EXPECT_EQ(&loaned_message, ros_message);
+      published_data.push_back(static_cast<rclcpp::msg::String *>(ros_message)->data);
+      return RCL_RET_OK;
+    });
+  // The converted message isn't copied by the middleware.
+  auto mock_publish = mocking_utils::patch_and_return("self", rcl_publish, RCL_RET_ERROR);
+
+  EXPECT_NO_THROW(pub->publish(std::string("by reference")));
+  EXPECT_NO_THROW(pub->publish(std::make_unique<std::string>("unique pointer")));
+  ASSERT_EQ(2u, published_data.size());
+  EXPECT_EQ("by reference", published_data[0]);
+  EXPECT_EQ("unique pointer", published_data[1]);
+}
@@ -20,6 +20,7 @@
 #include <memory>
 #include <string>
 
+#include "rclcpp/qos_event_handler_group.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "rcutils/logging.h"
 #include "rmw/rmw.h"
@@ -413,3 +414,70 @@ TEST_F(TestQosEvent, test_invalid_on_new_event_callback)
     pub->set_on_new_qos_event_callback(invalid_cb, RCL_PUBLISHER_OFFERED_DEADLINE_MISSED),
     std::invalid_argument);
 }
+
+TEST_F(TestQosEvent, test_event_handler_group)
+{
+  auto group = std::make_shared<rclcpp::QOSEventHandlerGroup>(
+    node->get_node_base_interface()->get_context());
+  node->get_node_waitables_interface()->add_waitable(group, nullptr);
+
+  std::promise<void> publisher_deadline_promise;
+  std::promise<void> subscription_deadline_promise;
+  bool publisher_deadline_missed = false;
+  bool subscription_deadline_missed = false;
+
+  rclcpp::QoS qos_profile(10);
+  qos_profile.deadline(rclcpp::Duration(std::chrono::milliseconds(1)));
+  rclcpp::PublisherOptions pub_options;
+  pub_options.event_handler_group = group;
+  pub_options.event_callbacks.deadline_callback =
+    [&](rclcpp::QOSDeadlineOfferedInfo &) {
+      if (!publisher_deadline_missed) {
+        publisher_deadline_missed = true;
+        publisher_deadline_promise.set_value();
+      }
+    };
+  auto publisher = node->create_publisher<test_msgs::msg::Empty>(
+    topic_name, qos_profile, pub_options);
+
+  rclcpp::SubscriptionOptions sub_options;
+  sub_options.event_handler_group = group;
+  sub_options.event_callbacks.deadline_callback =
+    [&](rclcpp::QOSDeadlineRequestedInfo &) {
+      if (!subscription_deadline_missed) {
+        subscription_deadline_missed = true;
+        subscription_deadline_promise.set_value();
+      }
+    };
+  auto subscription = node->create_subscription<test_msgs::msg::Empty>(
+    topic_name, qos_profile, message_callback, sub_options);
+
+  // The handlers are in the group, instead of being waited on by themselves
+  EXPECT_EQ(
+    publisher->get_event_handlers().size() + subscription->get_event_handlers().size(),
+    group->size());
+  auto default_callback_group = node->get_node_base_interface()->get_default_callback_group();
+  for (const auto & key_event_pair : subscription->get_event_handlers()) {
+    EXPECT_EQ(
+      nullptr,
+      default_callback_group->find_waitable_ptrs_if(
+        [&key_event_pair](const rclcpp::Waitable::SharedPtr & waitable) {
+          return waitable == key_event_pair.second;
+        }));
+  }
+
+  publisher->publish(test_msgs::msg::Empty());
+
+  rclcpp::executors::SingleThreadedExecutor ex;
+  ex.add_node(node->get_node_base_interface());
+  EXPECT_EQ(
+    rclcpp::FutureReturnCode::SUCCESS,
+    ex.spin_until_future_complete(publisher_deadline_promise.get_future(), 10s));
+  EXPECT_EQ(
+    rclcpp::FutureReturnCode::SUCCESS,
+    ex.spin_until_future_complete(subscription_deadline_promise.get_future(), 10s));
+
+  ex.remove_node(node->get_node_base_interface());
+  EXPECT_TRUE(group->remove(publisher->get_event_handlers().begin()->second));
+  EXPECT_FALSE(group->remove(publisher->get_event_handlers().begin()->second));
+}
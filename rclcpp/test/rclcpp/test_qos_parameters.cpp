@@ -210,6 +210,59 @@ TEST(TestQosParameters, declare_with_id) {
   rclcpp::shutdown();
 }
 
+TEST(TestQosParameters, read_overrides_without_declaring) {
+  rclcpp::init(0, nullptr);
+  auto node = std::make_shared<rclcpp::Node>(
+    "my_node", "/ns", rclcpp::NodeOptions().parameter_overrides(
+  {
+    rclcpp::Parameter(
+      "qos_overrides./my/fully/qualified/topic_name.publisher.reliability", "best_effort"),
+    rclcpp::Parameter("qos_overrides./my/fully/qualified/topic_name.publisher.depth", 5),
+    rclcpp::Parameter(
+      "qos_overrides./my/fully/qualified/topic_name.subscription.depth", "not_an_integer"),
+  }));
+
+  rclcpp::QoS qos{rclcpp::KeepLast(10)};
+  qos = rclcpp::detail::declare_qos_parameters(
+    rclcpp::QosOverridingOptions::with_default_policies().declare_parameters(false),
+    node,
+    "/my/fully/qualified/topic_name",
+    qos,
+    rclcpp::detail::PublisherQosParametersTraits{});
+  EXPECT_EQ(RMW_QOS_POLICY_HISTORY_KEEP_LAST, qos.get_rmw_qos_profile().history);
+  EXPECT_EQ(RMW_QOS_POLICY_RELIABILITY_BEST_EFFORT, qos.get_rmw_qos_profile().reliability);
+  EXPECT_EQ(5u, qos.get_rmw_qos_profile().depth);
+
+  std::map<std::string, rclcpp::Parameter> qos_params;
+  EXPECT_FALSE(
+    node->get_node_parameters_interface()->get_parameters_by_prefix(
+      "qos_overrides./my/fully/qualified/topic_name.publisher", qos_params));
+
+  // The parameters declared by another entity are used, like when declaring them
+  node->declare_parameter(
+    "qos_overrides./my/fully/qualified/topic_name.publisher_my_id.depth", 20);
+  qos = rclcpp::detail::declare_qos_parameters(
+    rclcpp::QosOverridingOptions::with_default_policies(nullptr, "my_id")
+    .declare_parameters(false),
+    node,
+    "/my/fully/qualified/topic_name",
+    rclcpp::QoS{rclcpp::KeepLast(10)},
+    rclcpp::detail::PublisherQosParametersTraits{});
+  EXPECT_EQ(20u, qos.get_rmw_qos_profile().depth);
+  EXPECT_EQ(RMW_QOS_POLICY_RELIABILITY_RELIABLE, qos.get_rmw_qos_profile().reliability);
+
+  EXPECT_THROW(
+    rclcpp::detail::declare_qos_parameters(
+      rclcpp::QosOverridingOptions::with_default_policies().declare_parameters(false),
+      node,
+      "/my/fully/qualified/topic_name",
+      rclcpp::QoS{rclcpp::KeepLast(10)},
+      rclcpp::detail::SubscriptionQosParametersTraits{}),
+    rclcpp::exceptions::InvalidParameterTypeException);
+
+  rclcpp::shutdown();
+}
+
 TEST(TestQosParameters, declare_no_parameters_interface) {
   rclcpp::init(0, nullptr);
   auto node = std::make_shared<rclcpp::Node>("my_node", "/ns");
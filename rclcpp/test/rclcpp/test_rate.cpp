@@ -14,9 +14,16 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <thread>
 
+#include "rcl/time.h"
 #include "rclcpp/rate.hpp"
+#include "rclcpp/utilities.hpp"
 
 /*
    Basic tests for the Rate and WallRate classes.
@@ -119,3 +126,82 @@ TEST(TestRate, from_double) {
     EXPECT_EQ(std::chrono::milliseconds(250), rate.period());
   }
 }
+
+class TestDeadlineRate : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  void TearDown() override
+  {
+    rclcpp::shutdown();
+  }
+};
+
+TEST_F(TestDeadlineRate, bad_arguments) {
+  EXPECT_THROW(rclcpp::DeadlineRate(std::chrono::nanoseconds(0)), std::invalid_argument);
+  EXPECT_THROW(rclcpp::DeadlineRate(0.0), std::invalid_argument);
+  EXPECT_THROW(
+    rclcpp::DeadlineRate(std::chrono::milliseconds(1), nullptr), std::invalid_argument);
+  rclcpp::DeadlineRate rate(1000.0);
+  EXPECT_EQ(std::chrono::milliseconds(1), rate.period());
+  EXPECT_TRUE(rate.is_steady());
+}
+
+TEST_F(TestDeadlineRate, steady_deadlines) {
+  const auto period = std::chrono::milliseconds(10);
+  rclcpp::DeadlineRate rate(period);
+  rclcpp::Clock steady_clock(RCL_STEADY_TIME);
+  const auto first_deadline = rate.get_next_deadline();
+  for (int i = 0; i < 5; ++i) {
+    const auto deadline = rate.get_next_deadline();
+    EXPECT_TRUE(rate.sleep());
+    EXPECT_LE(deadline, steady_clock.now());
+  }
+  // The deadlines don't drift.
+  EXPECT_EQ(first_deadline + rclcpp::Duration(period * 5), rate.get_next_deadline());
+  EXPECT_EQ(5u, rate.get_statistics().number_of_deadlines);
+  EXPECT_EQ(0u, rate.get_statistics().number_of_overruns);
+  EXPECT_LE(rate.get_statistics().last_lateness, rate.get_statistics().max_lateness);
+  EXPECT_LE(rate.get_statistics().max_lateness, rate.get_statistics().total_lateness);
+
+  // The missed periods are skipped, keeping the phase of the deadlines.
+  std::this_thread::sleep_for(4 * period);
+  EXPECT_FALSE(rate.sleep());
+  EXPECT_EQ(1u, rate.get_statistics().number_of_overruns);
+  EXPECT_LE(2u, rate.get_statistics().number_of_missed_periods);
+  EXPECT_EQ(0, (rate.get_next_deadline() - first_deadline).nanoseconds() % period.count());
+  EXPECT_TRUE(rate.sleep());
+
+  rate.reset_statistics();
+  EXPECT_EQ(0u, rate.get_statistics().number_of_deadlines);
+}
+
+TEST_F(TestDeadlineRate, ros_time_deadlines) {
+  auto clock = std::make_shared<rclcpp::Clock>(RCL_ROS_TIME);
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(clock->get_clock_handle()));
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(clock->get_clock_handle(), 1000));
+
+  rclcpp::DeadlineRate rate(std::chrono::seconds(1), clock);
+  EXPECT_FALSE(rate.is_steady());
+  EXPECT_EQ(rclcpp::Time(1000 + 1000000000, RCL_ROS_TIME), rate.get_next_deadline());
+
+  std::atomic_bool sleep_returned{false};
+  bool sleep_succeeded = false;
+  std::thread sleep_thread([&]() {
+      sleep_succeeded = rate.sleep();
+      sleep_returned = true;
+    });
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT_FALSE(sleep_returned.load());
+
+  // Woken by the simulated time, not the wall time.
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_set_ros_time_override(clock->get_clock_handle(), 1000 + 1000000000));
+  sleep_thread.join();
+  EXPECT_TRUE(sleep_succeeded);
+  EXPECT_EQ(std::chrono::nanoseconds(0), rate.get_statistics().last_lateness);
+}
@@ -0,0 +1,115 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/detail/recycling_pool.hpp"
+#include "rclcpp/detail/shared_message_pool.hpp"
+
+using rclcpp::detail::RecyclingPool;
+
+namespace
+{
+auto create_int = []() {return std::make_shared<int>(0);};
+auto keep = [](int &) {};
+}  // namespace
+
+TEST(TestRecyclingPool, reuse_released_objects) {
+  RecyclingPool<int> pool(2);
+  EXPECT_EQ(0u, pool.size());
+  EXPECT_EQ(2u, pool.max_size());
+
+  auto object = pool.borrow(create_int, keep);
+  ASSERT_NE(nullptr, object);
+  *object = 42;
+  const int * address = object.get();
+  // Still used, so another object is created.
+  auto other_object = pool.borrow(create_int, keep);
+  ASSERT_NE(nullptr, other_object);
+  EXPECT_NE(address, other_object.get());
+  EXPECT_EQ(2u, pool.size());
+  // All the objects of the full pool are used.
+  EXPECT_EQ(nullptr, pool.borrow(create_int, keep));
+
+  object.reset();
+  size_t reused = 0;
+  object = pool.borrow(create_int, [&reused](int & value) {value = 0; ++reused;});
+  EXPECT_EQ(address, object.get());
+  EXPECT_EQ(0, *object);
+  EXPECT_EQ(1u, reused);
+  EXPECT_EQ(2u, pool.size());
+}
+
+TEST(TestRecyclingPool, preallocate_and_throwing_creation) {
+  RecyclingPool<int> pool(3);
+  EXPECT_EQ(2u, pool.preallocate(2, create_int));
+  EXPECT_EQ(3u, pool.preallocate(5, create_int));
+
+  RecyclingPool<int> throwing_pool(1);
+  auto throwing_create = []() -> std::shared_ptr<int> {throw std::runtime_error("failed");};
+  EXPECT_THROW(throwing_pool.borrow(throwing_create, keep), std::runtime_error);
+  EXPECT_THROW(throwing_pool.preallocate(1, throwing_create), std::runtime_error);
+  // The slot isn't left in use.
+  EXPECT_NE(nullptr, throwing_pool.borrow(create_int, keep));
+  EXPECT_EQ(1u, throwing_pool.size());
+}
+
+TEST(TestRecyclingPool, concurrent_borrows) {
+  RecyclingPool<int> pool(4);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back(
+      [&pool]() {
+        for (int j = 0; j < 1000; ++j) {
+          auto object = pool.borrow(create_int, keep);
+          if (object) {
+            // Nobody else uses the object at the same time.
+            EXPECT_EQ(0, *object);
+            *object = 1;
+            *object = 0;
+          }
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  EXPECT_LE(pool.size(), 4u);
+}
+
+TEST(TestSharedMessagePool, borrow_message) {
+  rclcpp::detail::SharedMessagePool<std::vector<int>> pool(1);
+  auto message = pool.borrow_message(true);
+  message->push_back(1);
+  const auto * address = message.get();
+  // Allocated without being pooled when the pool is full.
+  auto other_message = pool.borrow_message(true);
+  EXPECT_NE(address, other_message.get());
+  EXPECT_EQ(1u, pool.get_number_of_pooled_messages());
+
+  message.reset();
+  message = pool.borrow_message(false);
+  EXPECT_EQ(address, message.get());
+  EXPECT_EQ(1u, message->size());
+  message.reset();
+  message = pool.borrow_message(true);
+  EXPECT_EQ(address, message.get());
+  EXPECT_TRUE(message->empty());
+}
@@ -79,3 +79,75 @@ TEST(TestRingBufferImplementation, basic_usage) {
   EXPECT_EQ(false, rb.has_data());
   EXPECT_EQ(false, rb.is_full());
 }
+
+/*
+   Occupancy counters
+   - count the maximum depth and the overwritten data
+ */
+TEST(TestRingBufferImplementation, counters) {
+  rclcpp::experimental::buffers::RingBufferImplementation<char> rb(2);
+
+  auto counters = rb.get_counters();
+  EXPECT_EQ(2u, counters.capacity);
+  EXPECT_EQ(0u, counters.depth);
+  EXPECT_EQ(0u, counters.high_water_mark);
+  EXPECT_EQ(0u, counters.dropped);
+
+  rb.enqueue('a');
+  rb.enqueue('b');
+  rb.enqueue('c');
+  rb.enqueue('d');
+  rb.dequeue();
+
+  counters = rb.get_counters();
+  EXPECT_EQ(1u, counters.depth);
+  EXPECT_EQ(2u, counters.high_water_mark);
+  EXPECT_EQ(2u, counters.dropped);
+}
+
+/*
+   Adaptive capacity
+   - grow instead of overwriting up to the maximum capacity
+   - shrink back to the initial capacity once underused
+ */
+TEST(TestRingBufferImplementation, adaptive_capacity) {
+  rclcpp::experimental::buffers::RingBufferImplementation<char> rb(2, 8);
+
+  for (char c = 'a'; c < 'j'; ++c) {
+    rb.enqueue(c);
+  }
+
+  auto counters = rb.get_counters();
+  EXPECT_EQ(8u, counters.capacity);
+  EXPECT_EQ(8u, counters.depth);
+  EXPECT_EQ(1u, counters.dropped);
+  EXPECT_EQ(2u, counters.resizes);
+
+  // The elements are kept in order through the resizes.
+  for (char c = 'b'; c < 'j'; ++c) {
+    EXPECT_EQ(c, rb.dequeue());
+  }
+  EXPECT_FALSE(rb.has_data());
+
+  // Enqueue and dequeue one element at a time until the capacity is back to the initial one.
+  for (size_t i = 0; i < 128; ++i) {
+    rb.enqueue('x');
+    EXPECT_EQ('x', rb.dequeue());
+  }
+
+  counters = rb.get_counters();
+  EXPECT_EQ(2u, counters.capacity);
+  EXPECT_EQ(0u, counters.depth);
+  EXPECT_EQ(8u, counters.high_water_mark);
+  EXPECT_EQ(4u, counters.resizes);
+
+  // A buffer without a larger maximum capacity keeps its capacity.
+  rclcpp::experimental::buffers::RingBufferImplementation<char> fixed(2, 1);
+  fixed.enqueue('a');
+  fixed.enqueue('b');
+  fixed.enqueue('c');
+  counters = fixed.get_counters();
+  EXPECT_EQ(2u, counters.capacity);
+  EXPECT_EQ(1u, counters.dropped);
+  EXPECT_EQ(0u, counters.resizes);
+}
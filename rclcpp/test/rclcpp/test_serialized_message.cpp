@@ -21,12 +21,14 @@
 
 #include "rclcpp/serialization.hpp"
 #include "rclcpp/serialized_message.hpp"
+#include "rclcpp/serializer.hpp"
 #include "rclcpp/rclcpp.hpp"
 
 #include "rcpputils/asserts.hpp"
 
 #include "test_msgs/message_fixtures.hpp"
 #include "test_msgs/msg/basic_types.hpp"
+#include "test_msgs/msg/strings.hpp"
 
 TEST(TestSerializedMessage, empty_initialize) {
   rclcpp::SerializedMessage serialized_message;
@@ -173,6 +175,49 @@ TEST(TestSerializedMessage, serialization) {
   }
 }
 
+TEST(TestSerializedMessage, serializer) {
+  using MessageT = test_msgs::msg::BasicTypes;
+
+  rclcpp::Serializer<MessageT> serializer;
+  rclcpp::Serialization<MessageT> serialization;
+
+  auto basic_type_ros_msgs = get_messages_basic_types();
+  for (const auto & ros_msg : basic_type_ros_msgs) {
+    const auto & serialized_msg = serializer.serialize_message(*ros_msg);
+    EXPECT_EQ(&serialized_msg, &serializer.get_serialized_message());
+
+    MessageT deserialized_ros_msg;
+    serialization.deserialize_message(&serialized_msg, &deserialized_ros_msg);
+    EXPECT_EQ(*ros_msg, deserialized_ros_msg);
+  }
+  // The messages have the same size, so the buffer is only allocated once
+  EXPECT_EQ(1u, serializer.get_number_of_allocations());
+}
+
+TEST(TestSerializedMessage, serializer_growing_messages) {
+  using MessageT = test_msgs::msg::Strings;
+
+  rclcpp::Serializer<MessageT> serializer;
+  MessageT ros_msg;
+  constexpr size_t number_of_messages = 100u;
+  for (size_t i = 0; i < number_of_messages; ++i) {
+    ros_msg.string_value.push_back('a');
+    const auto & serialized_msg = serializer.serialize_message(ros_msg);
+    EXPECT_LE(serialized_msg.size(), serializer.capacity());
+  }
+  // The buffer keeps some headroom, so it isn't allocated for each larger message
+  EXPECT_LT(serializer.get_number_of_allocations(), number_of_messages / 5u);
+
+  // Once reserved, the buffer isn't allocated anymore
+  const size_t number_of_allocations = serializer.get_number_of_allocations();
+  serializer.reserve(serializer.capacity() + 1000u);
+  for (size_t i = 0; i < number_of_messages; ++i) {
+    ros_msg.string_value.push_back('a');
+    serializer.serialize_message(ros_msg);
+  }
+  EXPECT_EQ(number_of_allocations, serializer.get_number_of_allocations());
+}
+
 TEST(TestSerializedMessage, assignment_operators) {
   const std::string content = "Hello World";
   const auto content_size = content.size() + 1;  // accounting for null terminator
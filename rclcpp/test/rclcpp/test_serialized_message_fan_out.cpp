@@ -0,0 +1,101 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+
+#include "rclcpp/detail/serialized_message_fan_out.hpp"
+
+using rclcpp::detail::SerializedMessageFanOut;
+
+namespace
+{
+
+rmw_message_info_t
+make_message_info(uint8_t publisher, uint64_t sequence_number)
+{
+  rmw_message_info_t message_info = rmw_get_zero_initialized_message_info();
+  message_info.publisher_gid.data[0] = publisher;
+  message_info.publication_sequence_number = sequence_number;
+  return message_info;
+}
+
+}  // namespace
+
+TEST(TestSerializedMessageFanOut, construct_destruct) {
+  EXPECT_THROW(SerializedMessageFanOut(0), std::invalid_argument);
+  SerializedMessageFanOut fan_out;
+  EXPECT_EQ(0u, fan_out.size());
+}
+
+TEST(TestSerializedMessageFanOut, share_same_message) {
+  SerializedMessageFanOut fan_out;
+  auto first = std::make_shared<rclcpp::SerializedMessage>(8);
+  auto second = std::make_shared<rclcpp::SerializedMessage>(8);
+
+  EXPECT_EQ(first, fan_out.share("/topic", make_message_info(1, 1), first));
+  EXPECT_EQ(first, fan_out.share("/topic", make_message_info(1, 1), second));
+  EXPECT_EQ(1u, fan_out.size());
+
+  // Another sequence number, publisher or topic is another message
+  EXPECT_EQ(second, fan_out.share("/topic", make_message_info(1, 2), second));
+  auto third = std::make_shared<rclcpp::SerializedMessage>(8);
+  EXPECT_EQ(third, fan_out.share("/topic", make_message_info(2, 1), third));
+  auto fourth = std::make_shared<rclcpp::SerializedMessage>(8);
+  EXPECT_EQ(fourth, fan_out.share("/other_topic", make_message_info(1, 1), fourth));
+  EXPECT_EQ(4u, fan_out.size());
+}
+
+TEST(TestSerializedMessageFanOut, sequence_number_unsupported) {
+  SerializedMessageFanOut fan_out;
+  auto first = std::make_shared<rclcpp::SerializedMessage>(8);
+  auto second = std::make_shared<rclcpp::SerializedMessage>(8);
+  const auto message_info = make_message_info(1, RMW_MESSAGE_INFO_SEQUENCE_NUMBER_UNSUPPORTED);
+
+  EXPECT_EQ(first, fan_out.share("/topic", message_info, first));
+  EXPECT_EQ(second, fan_out.share("/topic", message_info, second));
+  EXPECT_EQ(0u, fan_out.size());
+}
+
+TEST(TestSerializedMessageFanOut, messages_not_held) {
+  SerializedMessageFanOut fan_out;
+  auto first = std::make_shared<rclcpp::SerializedMessage>(8);
+  fan_out.share("/topic", make_message_info(1, 1), first);
+  first.reset();
+
+  // The first message isn't kept alive, so the second one is shared instead
+  auto second = std::make_shared<rclcpp::SerializedMessage>(8);
+  EXPECT_EQ(second, fan_out.share("/topic", make_message_info(1, 1), second));
+  auto third = std::make_shared<rclcpp::SerializedMessage>(8);
+  EXPECT_EQ(second, fan_out.share("/topic", make_message_info(1, 1), third));
+}
+
+TEST(TestSerializedMessageFanOut, max_messages_per_topic) {
+  SerializedMessageFanOut fan_out(2);
+  auto first = std::make_shared<rclcpp::SerializedMessage>(8);
+  auto second = std::make_shared<rclcpp::SerializedMessage>(8);
+  auto third = std::make_shared<rclcpp::SerializedMessage>(8);
+  fan_out.share("/topic", make_message_info(1, 1), first);
+  fan_out.share("/topic", make_message_info(1, 2), second);
+  fan_out.share("/topic", make_message_info(1, 3), third);
+  EXPECT_EQ(2u, fan_out.size());
+
+  // The oldest message was forgotten
+  auto copy = std::make_shared<rclcpp::SerializedMessage>(8);
+  EXPECT_EQ(copy, fan_out.share("/topic", make_message_info(1, 1), copy));
+  EXPECT_EQ(third, fan_out.share("/topic", make_message_info(1, 3), copy));
+}
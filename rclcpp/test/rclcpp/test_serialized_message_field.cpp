@@ -0,0 +1,238 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "builtin_interfaces/msg/time.hpp"
+#include "rclcpp/serialization.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/serialized_message_field.hpp"
+#include "rosidl_typesupport_cpp/message_type_support.hpp"
+#include "rosidl_typesupport_introspection_cpp/field_types.hpp"
+
+#include "test_msgs/msg/arrays.hpp"
+#include "test_msgs/msg/basic_types.hpp"
+#include "test_msgs/msg/builtins.hpp"
+#include "test_msgs/msg/multi_nested.hpp"
+#include "test_msgs/msg/nested.hpp"
+#include "test_msgs/msg/strings.hpp"
+#include "test_msgs/msg/unbounded_sequences.hpp"
+#include "test_msgs/msg/w_strings.hpp"
+
+using rclcpp::SerializedMessageField;
+
+template<typename MessageT>
+rclcpp::SerializedMessage
+serialize(const MessageT & message)
+{
+  rclcpp::SerializedMessage serialized_message;
+  rclcpp::Serialization<MessageT>().serialize_message(&message, &serialized_message);
+  return serialized_message;
+}
+
+template<typename MessageT>
+SerializedMessageField
+make_field(const std::string & path)
+{
+  return SerializedMessageField(
+    *rosidl_typesupport_cpp::get_message_type_support_handle<MessageT>(), path);
+}
+
+TEST(TestSerializedMessageField, numbers) {
+  test_msgs::msg::BasicTypes message;
+  message.bool_value = true;
+  message.uint8_value = 200;
+  message.int16_value = -300;
+  message.float32_value = 1.5f;
+  message.float64_value = -2.25;
+  message.uint64_value = 0xFFFFFFFFFFFFull;
+  const auto serialized_message = serialize(message);
+
+  bool bool_value = false;
+  EXPECT_TRUE(make_field<test_msgs::msg::BasicTypes>("bool_value").read(
+      serialized_message, bool_value));
+  EXPECT_TRUE(bool_value);
+  int uint8_value = 0;
+  EXPECT_TRUE(make_field<test_msgs::msg::BasicTypes>("uint8_value").read(
+      serialized_message, uint8_value));
+  EXPECT_EQ(200, uint8_value);
+  int64_t int16_value = 0;
+  EXPECT_TRUE(make_field<test_msgs::msg::BasicTypes>("int16_value").read(
+      serialized_message, int16_value));
+  EXPECT_EQ(-300, int16_value);
+  double float32_value = 0.;
+  EXPECT_TRUE(make_field<test_msgs::msg::BasicTypes>("float32_value").read(
+      serialized_message, float32_value));
+  EXPECT_EQ(1.5, float32_value);
+  float float64_value = 0.f;
+  EXPECT_TRUE(make_field<test_msgs::msg::BasicTypes>("float64_value").read(
+      serialized_message, float64_value));
+  EXPECT_EQ(-2.25f, float64_value);
+  uint64_t uint64_value = 0;
+  const auto uint64_field = make_field<test_msgs::msg::BasicTypes>("uint64_value");
+  EXPECT_EQ(rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64, uint64_field.get_type_id());
+  EXPECT_TRUE(uint64_field.read(serialized_message, uint64_value));
+  EXPECT_EQ(message.uint64_value, uint64_value);
+
+  std::string string;
+  EXPECT_THROW(uint64_field.read(serialized_message, string), std::invalid_argument);
+  test_msgs::msg::BasicTypes nested_message;
+  EXPECT_THROW(uint64_field.read(serialized_message, nested_message), std::invalid_argument);
+}
+
+TEST(TestSerializedMessageField, fields_after_sequences) {
+  test_msgs::msg::UnboundedSequences message;
+  message.bool_values = {true, false, true};
+  message.byte_values = {1};
+  message.int32_values = {1, -2, 3};
+  message.string_values = {"a", "bcd", "efghij"};
+  message.basic_types_values.resize(2);
+  message.basic_types_values[1].uint16_value = 12;
+  message.basic_types_values[1].float64_value = 0.5;
+  message.alignment_check = -7;
+  const auto serialized_message = serialize(message);
+
+  int32_t int32_value = 0;
+  EXPECT_TRUE(make_field<test_msgs::msg::UnboundedSequences>("alignment_check").read(
+      serialized_message, int32_value));
+  EXPECT_EQ(-7, int32_value);
+  EXPECT_TRUE(make_field<test_msgs::msg::UnboundedSequences>("int32_values[1]").read(
+      serialized_message, int32_value));
+  EXPECT_EQ(-2, int32_value);
+  bool bool_value = true;
+  EXPECT_TRUE(make_field<test_msgs::msg::UnboundedSequences>("bool_values[1]").read(
+      serialized_message, bool_value));
+  EXPECT_FALSE(bool_value);
+  std::string string_value;
+  EXPECT_TRUE(make_field<test_msgs::msg::UnboundedSequences>("string_values[2]").read(
+      serialized_message, string_value));
+  EXPECT_EQ("efghij", string_value);
+  double float64_value = 0.;
+  EXPECT_TRUE(
+    make_field<test_msgs::msg::UnboundedSequences>("basic_types_values[1].float64_value").read(
+      serialized_message, float64_value));
+  EXPECT_EQ(0.5, float64_value);
+  test_msgs::msg::BasicTypes basic_types;
+  EXPECT_TRUE(make_field<test_msgs::msg::UnboundedSequences>("basic_types_values[1]").read(
+      serialized_message, basic_types));
+  EXPECT_EQ(message.basic_types_values[1], basic_types);
+
+  // The elements past the end of the sequences aren't in the message
+  EXPECT_FALSE(make_field<test_msgs::msg::UnboundedSequences>("int32_values[3]").read(
+      serialized_message, int32_value));
+  EXPECT_FALSE(make_field<test_msgs::msg::UnboundedSequences>("int64_values[0]").read(
+      serialized_message, int32_value));
+}
+
+TEST(TestSerializedMessageField, arrays) {
+  test_msgs::msg::Arrays message;
+  message.string_values = {"x", "yz", "w"};
+  message.basic_types_values[2].int64_value = -9;
+  message.alignment_check = 5;
+  const auto serialized_message = serialize(message);
+
+  int32_t alignment_check = 0;
+  EXPECT_TRUE(make_field<test_msgs::msg::Arrays>("alignment_check").read(
+      serialized_message, alignment_check));
+  EXPECT_EQ(5, alignment_check);
+  std::string string_value;
+  EXPECT_TRUE(make_field<test_msgs::msg::Arrays>("string_values[1]").read(
+      serialized_message, string_value));
+  EXPECT_EQ("yz", string_value);
+  int64_t int64_value = 0;
+  EXPECT_TRUE(make_field<test_msgs::msg::Arrays>("basic_types_values[2].int64_value").read(
+      serialized_message, int64_value));
+  EXPECT_EQ(-9, int64_value);
+}
+
+TEST(TestSerializedMessageField, messages) {
+  test_msgs::msg::Builtins builtins;
+  builtins.duration_value.sec = 3;
+  builtins.time_value.sec = 1234;
+  builtins.time_value.nanosec = 5678u;
+  builtin_interfaces::msg::Time time;
+  const auto time_field = make_field<test_msgs::msg::Builtins>("time_value");
+  EXPECT_EQ(rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE, time_field.get_type_id());
+  EXPECT_TRUE(time_field.read(serialize(builtins), time));
+  EXPECT_EQ(builtins.time_value, time);
+  test_msgs::msg::BasicTypes other_message;
+  EXPECT_THROW(time_field.read(serialize(builtins), other_message), std::invalid_argument);
+  int32_t number = 0;
+  EXPECT_THROW(time_field.read(serialize(builtins), number), std::invalid_argument);
+
+  test_msgs::msg::MultiNested multi_nested;
+  multi_nested.unbounded_sequence_of_unbounded_sequences.resize(2);
+  auto & sequences = multi_nested.unbounded_sequence_of_unbounded_sequences[1];
+  sequences.bool_values = {false, true};
+  sequences.float64_values = {1., 2., 3.};
+  sequences.string_values = {"string"};
+  sequences.basic_types_values.resize(1);
+  sequences.basic_types_values[0].int8_value = -1;
+  sequences.alignment_check = 17;
+  test_msgs::msg::UnboundedSequences read_sequences;
+  EXPECT_TRUE(
+    make_field<test_msgs::msg::MultiNested>("unbounded_sequence_of_unbounded_sequences[1]").read(
+      serialize(multi_nested), read_sequences));
+  EXPECT_EQ(sequences, read_sequences);
+}
+
+TEST(TestSerializedMessageField, type_name) {
+  test_msgs::msg::Strings message;
+  message.string_value = "first";
+  message.bounded_string_value = "bounded";
+  SerializedMessageField field("test_msgs/msg/Strings", "bounded_string_value");
+  std::string value;
+  EXPECT_TRUE(field.read(serialize(message), value));
+  EXPECT_EQ("bounded", value);
+
+  EXPECT_THROW(SerializedMessageField("test_msgs/msg/NotAType", "value"), std::runtime_error);
+}
+
+TEST(TestSerializedMessageField, invalid_fields) {
+  using test_msgs::msg::Arrays;
+  using test_msgs::msg::Nested;
+  EXPECT_THROW(make_field<Nested>("not_a_field"), std::invalid_argument);
+  EXPECT_THROW(make_field<Nested>("basic_types_value[0]"), std::invalid_argument);
+  EXPECT_THROW(make_field<Nested>("basic_types_value.bool_value.x"), std::invalid_argument);
+  EXPECT_THROW(make_field<Arrays>("int32_values"), std::invalid_argument);
+  EXPECT_THROW(make_field<Arrays>("int32_values[3]"), std::invalid_argument);
+  EXPECT_THROW(make_field<Arrays>("int32_values[x]"), std::invalid_argument);
+  EXPECT_THROW(make_field<test_msgs::msg::WStrings>("wstring_value"), std::invalid_argument);
+}
+
+TEST(TestSerializedMessageField, truncated_messages) {
+  test_msgs::msg::UnboundedSequences message;
+  message.string_values = {"a string which is truncated"};
+  message.alignment_check = 1;
+  auto serialized_message = serialize(message);
+  const auto field = make_field<test_msgs::msg::UnboundedSequences>("alignment_check");
+  int32_t value = 0;
+  ASSERT_TRUE(field.read(serialized_message, value));
+
+  auto & rcl_serialized_message = serialized_message.get_rcl_serialized_message();
+  const size_t length = rcl_serialized_message.buffer_length;
+  rcl_serialized_message.buffer_length = length - 4u;
+  EXPECT_FALSE(field.read(serialized_message, value));
+  rcl_serialized_message.buffer_length = 3u;
+  EXPECT_FALSE(field.read(serialized_message, value));
+  // Only plain CDR is read
+  rcl_serialized_message.buffer_length = length;
+  rcl_serialized_message.buffer[1] = 0x07;
+  EXPECT_FALSE(field.read(serialized_message, value));
+}
@@ -0,0 +1,76 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+
+#include "rclcpp/detail/serialized_message_pool.hpp"
+
+using rclcpp::detail::SerializedMessagePool;
+
+TEST(TestSerializedMessagePool, construct_destruct) {
+  EXPECT_THROW(SerializedMessagePool(0), std::invalid_argument);
+  SerializedMessagePool pool(2);
+  EXPECT_EQ(0u, pool.get_number_of_pooled_messages());
+  EXPECT_EQ(0u, pool.get_high_water_mark());
+}
+
+TEST(TestSerializedMessagePool, reuse_buffers) {
+  SerializedMessagePool pool(2);
+
+  auto message = pool.borrow_message();
+  ASSERT_NE(nullptr, message);
+  message->reserve(64);
+  message->get_rcl_serialized_message().buffer_length = 32;
+  const auto * address = message.get();
+  pool.return_message(message);
+  EXPECT_EQ(nullptr, message);
+  EXPECT_EQ(32u, pool.get_high_water_mark());
+
+  // The message is reused with its buffer.
+  message = pool.borrow_message();
+  EXPECT_EQ(address, message.get());
+  EXPECT_EQ(0u, message->size());
+  EXPECT_LE(64u, message->capacity());
+
+  // It is still borrowed, so a new one is created, sized by the high water mark.
+  auto other_message = pool.borrow_message();
+  EXPECT_NE(address, other_message.get());
+  EXPECT_LE(32u, other_message->capacity());
+  EXPECT_EQ(2u, pool.get_number_of_pooled_messages());
+
+  // Messages of a full pool are allocated, with the requested capacity.
+  auto allocated_message = pool.borrow_message(128);
+  EXPECT_LE(128u, allocated_message->capacity());
+  EXPECT_EQ(2u, pool.get_number_of_pooled_messages());
+}
+
+TEST(TestSerializedMessagePool, message_still_used) {
+  SerializedMessagePool pool(1);
+
+  auto message = pool.borrow_message();
+  // Kept by a callback for instance.
+  auto kept_message = message;
+  pool.return_message(message);
+
+  auto other_message = pool.borrow_message();
+  EXPECT_NE(kept_message, other_message);
+  pool.return_message(other_message);
+
+  const auto * address = kept_message.get();
+  kept_message.reset();
+  EXPECT_EQ(address, pool.borrow_message().get());
+}
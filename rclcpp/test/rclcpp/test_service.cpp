@@ -14,9 +14,12 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <string>
 #include <memory>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/rclcpp.hpp"
@@ -25,6 +28,7 @@
 #include "../utils/rclcpp_gtest_macros.hpp"
 
 #include "rcl_interfaces/srv/list_parameters.hpp"
+#include "test_msgs/srv/basic_types.hpp"
 #include "test_msgs/srv/empty.hpp"
 #include "test_msgs/srv/empty.h"
 
@@ -239,6 +243,104 @@ TEST_F(TestService, send_response) {
   }
 }
 
+TEST_F(TestService, message_pool) {
+  using test_msgs::srv::BasicTypes;
+  auto callback =
+    [](const BasicTypes::Request::SharedPtr, BasicTypes::Response::SharedPtr) {};
+  auto server = node->create_service<BasicTypes>("service", callback);
+  server->set_message_pool_size(1);
+
+  auto request = server->create_request();
+  const void * pooled_request = request.get();
+  // Still referenced, so not reused.
+  auto other_request = server->create_request();
+  EXPECT_NE(pooled_request, other_request.get());
+  request.reset();
+  other_request.reset();
+  EXPECT_EQ(pooled_request, server->create_request().get());
+
+  auto response = server->borrow_response();
+  const void * pooled_response = response.get();
+  response->bool_value = true;
+  response.reset();
+  response = server->borrow_response();
+  EXPECT_EQ(pooled_response, response.get());
+  // The reused responses are reset.
+  EXPECT_FALSE(response->bool_value);
+}
+
+TEST_F(TestService, send_responses) {
+  using test_msgs::srv::Empty;
+  auto callback =
+    [](const std::shared_ptr<rmw_request_id_t>, const Empty::Request::SharedPtr) {};
+  auto server = node->create_service<Empty>("service", callback);
+
+  std::vector<std::pair<std::shared_ptr<rmw_request_id_t>, Empty::Response::SharedPtr>> responses;
+  for (size_t i = 0; i < 3; ++i) {
+    responses.emplace_back(server->create_request_header(), server->borrow_response());
+  }
+  {
+    auto mock = mocking_utils::patch_and_return("lib:rclcpp", rcl_send_response, RCL_RET_OK);
+    EXPECT_NO_THROW(server->send_responses(responses));
+  }
+  {
+    auto mock = mocking_utils::patch_and_return("lib:rclcpp", rcl_send_response, RCL_RET_ERROR);
+    EXPECT_THROW(server->send_responses(responses), rclcpp::exceptions::RCLError);
+  }
+}
+
+TEST_F(TestService, response_cache) {
+  using test_msgs::srv::BasicTypes;
+  size_t calls = 0;
+  auto callback =
+    [&calls](const BasicTypes::Request::SharedPtr request, BasicTypes::Response::SharedPtr response)
+    {
+      ++calls;
+      response->int32_value = request->int32_value;
+    };
+  auto server = node->create_service<BasicTypes>("service", callback);
+  EXPECT_EQ(0u, server->get_number_of_cached_responses());
+  EXPECT_THROW(server->enable_response_cache(std::chrono::seconds(10), 0), std::invalid_argument);
+  server->enable_response_cache(std::chrono::seconds(10), 2);
+
+  auto handle_request = [&server](int32_t value) {
+      auto request = std::make_shared<BasicTypes::Request>();
+      request->int32_value = value;
+      server->handle_request(server->create_request_header(), request);
+    };
+  auto mock = mocking_utils::patch_and_return("lib:rclcpp", rcl_send_response, RCL_RET_OK);
+  handle_request(1);
+  handle_request(1);
+  EXPECT_EQ(1u, calls);
+  EXPECT_EQ(1u, server->get_number_of_cached_responses());
+  handle_request(2);
+  EXPECT_EQ(2u, calls);
+
+  // Full, the oldest response is removed.
+  handle_request(3);
+  EXPECT_EQ(3u, calls);
+  EXPECT_EQ(2u, server->get_number_of_cached_responses());
+  handle_request(1);
+  EXPECT_EQ(4u, calls);
+
+  server->invalidate_response_cache();
+  EXPECT_EQ(0u, server->get_number_of_cached_responses());
+  handle_request(1);
+  EXPECT_EQ(5u, calls);
+
+  // Expired right away.
+  server->enable_response_cache(std::chrono::nanoseconds(0));
+  handle_request(1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  handle_request(1);
+  EXPECT_EQ(7u, calls);
+
+  server->disable_response_cache();
+  handle_request(1);
+  EXPECT_EQ(8u, calls);
+  EXPECT_EQ(0u, server->get_number_of_cached_responses());
+}
+
 /*
    Testing on_new_request callbacks.
  */
@@ -0,0 +1,167 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "rclcpp/executor_statistics.hpp"
+#include "rclcpp/shared_memory_counters.hpp"
+
+#if !defined(_WIN32)
+
+namespace
+{
+
+/// View of a shared memory counters segment, as mapped by an external monitor.
+class SegmentReader
+{
+public:
+  explicit SegmentReader(const std::string & segment_name)
+  {
+    int fd = shm_open(segment_name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+      return;
+    }
+    struct stat segment_stat;
+    if (fstat(fd, &segment_stat) == 0) {
+      size_ = static_cast<size_t>(segment_stat.st_size);
+      mapping_ = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+      if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+      }
+    }
+    close(fd);
+  }
+
+  ~SegmentReader()
+  {
+    if (mapping_) {
+      munmap(mapping_, size_);
+    }
+  }
+
+  const rclcpp::SharedMemoryCountersHeader *
+  header() const
+  {
+    return static_cast<const rclcpp::SharedMemoryCountersHeader *>(mapping_);
+  }
+
+  const rclcpp::SharedMemoryCounterSlot *
+  slots() const
+  {
+    return reinterpret_cast<const rclcpp::SharedMemoryCounterSlot *>(header() + 1);
+  }
+
+private:
+  void * mapping_ = nullptr;
+  size_t size_ = 0;
+};
+
+}  // namespace
+
+TEST(TestSharedMemoryCounters, invalid_arguments) {
+  EXPECT_THROW(
+    rclcpp::SharedMemoryCounters("/test_rclcpp_counters_invalid", 0u), std::invalid_argument);
+
+  rclcpp::SharedMemoryCounters counters("/test_rclcpp_counters_invalid", 1u);
+  EXPECT_THROW(counters.add_counter(""), std::invalid_argument);
+  EXPECT_THROW(
+    counters.add_counter(std::string(rclcpp::SharedMemoryCounterSlot::name_size, 'a')),
+    std::invalid_argument);
+  EXPECT_NO_THROW(counters.add_counter("counter"));
+  EXPECT_THROW(counters.add_counter("other_counter"), std::runtime_error);
+}
+
+TEST(TestSharedMemoryCounters, read_from_segment) {
+  rclcpp::SharedMemoryCounters counters("/test_rclcpp_counters", 4u);
+  EXPECT_EQ("/test_rclcpp_counters", counters.get_segment_name());
+  EXPECT_EQ(4u, counters.capacity());
+
+  auto & first = counters.add_counter("first");
+  auto & second = counters.add_counter("second");
+  EXPECT_EQ(2u, counters.size());
+  first.fetch_add(3u);
+  second.store(42u);
+
+  SegmentReader reader(counters.get_segment_name());
+  ASSERT_NE(nullptr, reader.header());
+  EXPECT_EQ(rclcpp::SharedMemoryCountersHeader::expected_magic, reader.header()->magic);
+  EXPECT_EQ(rclcpp::SharedMemoryCountersHeader::current_version, reader.header()->version);
+  EXPECT_EQ(4u, reader.header()->capacity);
+  EXPECT_EQ(static_cast<uint64_t>(getpid()), reader.header()->pid);
+  ASSERT_EQ(2u, reader.header()->size.load());
+  EXPECT_STREQ("first", reader.slots()[0].name);
+  EXPECT_EQ(3u, reader.slots()[0].value.load());
+  EXPECT_STREQ("second", reader.slots()[1].name);
+  EXPECT_EQ(42u, reader.slots()[1].value.load());
+
+  // The values are read in place
+  first.fetch_add(1u);
+  EXPECT_EQ(4u, reader.slots()[0].value.load());
+}
+
+TEST(TestSharedMemoryCounters, segment_removed_on_destruction) {
+  std::string segment_name;
+  {
+    rclcpp::SharedMemoryCounters counters;
+    segment_name = counters.get_segment_name();
+    EXPECT_EQ("/rclcpp_counters_" + std::to_string(getpid()), segment_name);
+  }
+  int fd = shm_open(segment_name.c_str(), O_RDONLY, 0);
+  EXPECT_GT(0, fd);
+  if (fd >= 0) {
+    close(fd);
+  }
+}
+
+TEST(TestSharedMemoryCounters, export_executor_statistics) {
+  auto counters = std::make_shared<rclcpp::SharedMemoryCounters>("/test_rclcpp_counters", 8u);
+  rclcpp::ExecutorStatistics statistics;
+  EXPECT_THROW(statistics.export_counters(nullptr), std::invalid_argument);
+  statistics.export_counters(counters, "test_executor");
+  EXPECT_THROW(statistics.export_counters(counters), std::runtime_error);
+  EXPECT_EQ(6u, counters->size());
+
+  statistics.record_collection(std::chrono::microseconds(2), 5u);
+  statistics.record_wait(std::chrono::microseconds(10));
+  statistics.record_wait(std::chrono::microseconds(20));
+
+  SegmentReader reader(counters->get_segment_name());
+  ASSERT_NE(nullptr, reader.header());
+  ASSERT_EQ(6u, reader.header()->size.load());
+  EXPECT_STREQ("test_executor.wakeups", reader.slots()[0].name);
+  EXPECT_EQ(2u, reader.slots()[0].value.load());
+  EXPECT_STREQ("test_executor.wait_ns", reader.slots()[1].name);
+  EXPECT_EQ(30000u, reader.slots()[1].value.load());
+  EXPECT_STREQ("test_executor.collection_ns", reader.slots()[2].name);
+  EXPECT_EQ(2000u, reader.slots()[2].value.load());
+  EXPECT_STREQ("test_executor.wait_set_size", reader.slots()[3].name);
+  EXPECT_EQ(5u, reader.slots()[3].value.load());
+  EXPECT_STREQ("test_executor.executions", reader.slots()[4].name);
+  EXPECT_EQ(0u, reader.slots()[4].value.load());
+}
+
+#endif
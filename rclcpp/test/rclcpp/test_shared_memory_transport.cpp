@@ -0,0 +1,224 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rclcpp/detail/shared_memory_topic.hpp"
+#include "rclcpp/experimental/shared_memory_transport.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "test_msgs/msg/basic_types.hpp"
+#include "test_msgs/msg/strings.hpp"
+
+#ifdef __linux__
+
+using rclcpp::detail::SharedMemoryTopic;
+using rclcpp::detail::SharedMemoryTopicReader;
+
+namespace
+{
+
+std::string
+get_unique_segment_name(const std::string & test_name)
+{
+  return SharedMemoryTopic::get_segment_name(
+    0u, "/test_shared_memory_transport/" + test_name + "/" +
+    std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+}
+
+}  // namespace
+
+TEST(TestSharedMemoryTopic, write_and_read) {
+  auto topic = std::make_shared<SharedMemoryTopic>(
+    get_unique_segment_name("write_and_read"), "test", 2u, 4u, 64u);
+  EXPECT_EQ(0u, topic->get_subscription_count());
+  EXPECT_EQ(0u, topic->write("lost", 4u));
+
+  SharedMemoryTopicReader reader(topic);
+  EXPECT_EQ(1u, topic->get_subscription_count());
+  EXPECT_GE(reader.get_file_descriptor(), 0);
+
+  std::vector<char> buffer(64u);
+  size_t size = 0;
+  EXPECT_FALSE(reader.read(buffer.data(), size));
+
+  EXPECT_EQ(1u, topic->write("first", 5u));
+  EXPECT_EQ(1u, topic->write("second", 6u));
+  reader.clear_notifications();
+  ASSERT_TRUE(reader.read(buffer.data(), size));
+  EXPECT_EQ("first", std::string(buffer.data(), size));
+  ASSERT_TRUE(reader.read(buffer.data(), size));
+  EXPECT_EQ("second", std::string(buffer.data(), size));
+  EXPECT_FALSE(reader.read(buffer.data(), size));
+  EXPECT_EQ(0u, reader.get_number_of_dropped_messages());
+
+  EXPECT_THROW(topic->write(buffer.data(), 65u), std::invalid_argument);
+}
+
+TEST(TestSharedMemoryTopic, overflow_drops_oldest_messages) {
+  auto topic = std::make_shared<SharedMemoryTopic>(
+    get_unique_segment_name("overflow"), "test", 1u, 2u, sizeof(uint32_t));
+  SharedMemoryTopicReader reader(topic);
+  for (uint32_t i = 0; i < 5u; ++i) {
+    EXPECT_EQ(1u, topic->write(&i, sizeof(i)));
+  }
+
+  uint32_t value = 0;
+  size_t size = 0;
+  ASSERT_TRUE(reader.read(&value, size));
+  EXPECT_EQ(3u, value);
+  ASSERT_TRUE(reader.read(&value, size));
+  EXPECT_EQ(4u, value);
+  EXPECT_FALSE(reader.read(&value, size));
+  EXPECT_EQ(3u, reader.get_number_of_dropped_messages());
+}
+
+TEST(TestSharedMemoryTopic, slots_are_limited_and_released) {
+  auto topic = std::make_shared<SharedMemoryTopic>(
+    get_unique_segment_name("slots"), "test", 1u, 2u, 8u);
+  {
+    SharedMemoryTopicReader reader(topic);
+    EXPECT_THROW(SharedMemoryTopicReader{topic}, std::runtime_error);
+  }
+  EXPECT_EQ(0u, topic->get_subscription_count());
+  EXPECT_NO_THROW(SharedMemoryTopicReader{topic});
+}
+
+TEST(TestSharedMemoryTopic, segment_is_shared_with_same_geometry) {
+  const std::string segment_name = get_unique_segment_name("geometry");
+  auto topic = std::make_shared<SharedMemoryTopic>(segment_name, "test", 2u, 2u, 8u);
+  auto other_topic = std::make_shared<SharedMemoryTopic>(segment_name, "test", 2u, 2u, 8u);
+  SharedMemoryTopicReader reader(other_topic);
+  EXPECT_EQ(1u, topic->get_subscription_count());
+
+  EXPECT_THROW(SharedMemoryTopic(segment_name, "other", 2u, 2u, 8u), std::runtime_error);
+  EXPECT_THROW(SharedMemoryTopic(segment_name, "test", 3u, 2u, 8u), std::runtime_error);
+  EXPECT_THROW(SharedMemoryTopic(segment_name, "test", 2u, 2u, 16u), std::runtime_error);
+}
+
+class TestSharedMemoryTransport : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+
+  void SetUp() override
+  {
+    node = std::make_shared<rclcpp::Node>(
+      "test_shared_memory_transport",
+      "ns_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+  }
+
+  template<typename FutureT>
+  void spin_until(FutureT & future)
+  {
+    rclcpp::executors::SingleThreadedExecutor executor;
+    executor.add_node(node);
+    ASSERT_EQ(
+      rclcpp::FutureReturnCode::SUCCESS,
+      executor.spin_until_future_complete(future, std::chrono::seconds(10)));
+  }
+
+  rclcpp::Node::SharedPtr node;
+};
+
+TEST_F(TestSharedMemoryTransport, plain_old_data_messages) {
+  using MessageT = test_msgs::msg::BasicTypes;
+  static_assert(
+    rclcpp::experimental::detail::is_plain_old_data<MessageT>::value,
+    "the basic types message has fixed size fields only");
+
+  std::promise<MessageT> promise;
+  auto future = promise.get_future();
+  auto subscription = rclcpp::experimental::create_shared_memory_subscription<MessageT>(
+    node, "topic", [&promise](std::shared_ptr<MessageT> msg) {
+      promise.set_value(*msg);
+    });
+  EXPECT_EQ(std::string(node->get_namespace()) + "/topic", subscription->get_topic_name());
+
+  auto publisher = rclcpp::experimental::create_shared_memory_publisher<MessageT>(node, "topic");
+  EXPECT_EQ(subscription->get_topic_name(), publisher->get_topic_name());
+  EXPECT_EQ(1u, publisher->get_subscription_count());
+
+  MessageT msg;
+  msg.int32_value = 42;
+  msg.float64_value = 1.5;
+  publisher->publish(msg);
+  spin_until(future);
+  auto received_msg = future.get();
+  EXPECT_EQ(42, received_msg.int32_value);
+  EXPECT_EQ(1.5, received_msg.float64_value);
+}
+
+TEST_F(TestSharedMemoryTransport, serialized_messages) {
+  using MessageT = test_msgs::msg::Strings;
+  std::vector<std::string> received;
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  auto subscription = rclcpp::experimental::create_shared_memory_subscription<MessageT>(
+    node, "topic", [&](std::shared_ptr<MessageT> msg) {
+      received.push_back(msg->string_value);
+      if (received.size() == 2u) {
+        promise.set_value();
+      }
+    });
+  auto publisher = rclcpp::experimental::create_shared_memory_publisher<MessageT>(node, "topic");
+
+  MessageT msg;
+  msg.string_value = "first";
+  publisher->publish(msg);
+  msg.string_value = "second";
+  publisher->publish(msg);
+  spin_until(future);
+  EXPECT_EQ((std::vector<std::string>{"first", "second"}), received);
+  EXPECT_EQ(0u, subscription->get_number_of_dropped_messages());
+
+  const rclcpp::experimental::SharedMemoryTransportOptions options;
+  msg.string_value = std::string(options.max_message_size, 'a');
+  EXPECT_THROW(publisher->publish(msg), std::invalid_argument);
+}
+
+TEST_F(TestSharedMemoryTransport, options_must_match) {
+  using MessageT = test_msgs::msg::Strings;
+  auto publisher = rclcpp::experimental::create_shared_memory_publisher<MessageT>(node, "topic");
+  rclcpp::experimental::SharedMemoryTransportOptions options;
+  options.depth = 1u;
+  EXPECT_THROW(
+    rclcpp::experimental::create_shared_memory_subscription<MessageT>(
+      node, "topic", [](std::shared_ptr<MessageT>) {}, options),
+    std::runtime_error);
+  EXPECT_THROW(
+    rclcpp::experimental::create_shared_memory_publisher<test_msgs::msg::BasicTypes>(
+      node, "topic"),
+    std::runtime_error);
+}
+
+#endif  // __linux__
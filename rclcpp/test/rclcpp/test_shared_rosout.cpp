@@ -0,0 +1,122 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "rcl_interfaces/msg/log.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+using namespace std::chrono_literals;
+
+class TestSharedRosout : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    context = std::make_shared<rclcpp::Context>();
+    context->init(0, nullptr, rclcpp::InitOptions().share_rosout_publisher(true));
+    observer = std::make_shared<rclcpp::Node>(
+      "observer", "/test_shared_rosout",
+      rclcpp::NodeOptions().context(context).enable_rosout(false));
+  }
+
+  void TearDown() override
+  {
+    observer.reset();
+    context->shutdown("test is complete");
+    context.reset();
+  }
+
+  /// Wait until the number of publishers on /rosout is the expected one.
+  bool wait_for_rosout_publishers(size_t expected)
+  {
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (observer->count_publishers("/rosout") != expected) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        return false;
+      }
+      std::this_thread::sleep_for(10ms);
+    }
+    return true;
+  }
+
+  rclcpp::Context::SharedPtr context;
+  rclcpp::Node::SharedPtr observer;
+};
+
+TEST_F(TestSharedRosout, one_publisher_for_all_nodes) {
+  EXPECT_FALSE(rclcpp::InitOptions().share_rosout_publisher());
+  EXPECT_TRUE(rclcpp::InitOptions(context->get_init_options()).share_rosout_publisher());
+  const size_t number_of_publishers = observer->count_publishers("/rosout");
+
+  auto options = rclcpp::NodeOptions().context(context);
+  auto first_node = std::make_shared<rclcpp::Node>("first", "/test_shared_rosout", options);
+  auto second_node = std::make_shared<rclcpp::Node>("second", "/test_shared_rosout", options);
+  EXPECT_TRUE(wait_for_rosout_publishers(number_of_publishers + 1u));
+
+  second_node.reset();
+  auto third_node = std::make_shared<rclcpp::Node>("third", "/test_shared_rosout", options);
+  EXPECT_TRUE(wait_for_rosout_publishers(number_of_publishers + 1u));
+}
+
+TEST_F(TestSharedRosout, log_messages_keep_their_logger_name) {
+  auto options = rclcpp::NodeOptions().context(context);
+  auto first_node = std::make_shared<rclcpp::Node>("first", "/test_shared_rosout", options);
+  auto second_node = std::make_shared<rclcpp::Node>("second", "/test_shared_rosout", options);
+  auto unshared_node = std::make_shared<rclcpp::Node>(
+    "unshared", "/test_shared_rosout", rclcpp::NodeOptions(options).enable_rosout(false));
+
+  std::mutex mutex;
+  std::set<std::string> received;
+  auto subscription = observer->create_subscription<rcl_interfaces::msg::Log>(
+    "/rosout", rclcpp::RosoutQoS(),
+    [&](rcl_interfaces::msg::Log::ConstSharedPtr msg) {
+      std::lock_guard<std::mutex> lock(mutex);
+      received.insert(msg->name + ": " + msg->msg);
+    });
+  const std::set<std::string> expected{
+    "test_shared_rosout.first: first message",
+    "test_shared_rosout.second: second message",
+    "test_shared_rosout.second.child: child message",
+  };
+  rclcpp::ExecutorOptions executor_options;
+  executor_options.context = context;
+  rclcpp::executors::SingleThreadedExecutor executor(executor_options);
+  executor.add_node(observer);
+  const auto deadline = std::chrono::steady_clock::now() + 10s;
+  while (std::chrono::steady_clock::now() < deadline) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (received.size() >= expected.size()) {
+        break;
+      }
+    }
+    // The subscription may not be matched yet, so the messages are logged again
+    RCLCPP_INFO(first_node->get_logger(), "first message");
+    RCLCPP_INFO(second_node->get_logger(), "second message");
+    RCLCPP_INFO(second_node->get_logger().get_child("child"), "child message");
+    RCLCPP_INFO(unshared_node->get_logger(), "unshared message");
+    executor.spin_some(100ms);
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_EQ(expected, received);
+}
@@ -21,13 +21,16 @@
 #include <thread>
 #include <vector>
 
+#include "rclcpp/deserialization_pool.hpp"
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/rclcpp.hpp"
 
 #include "../mocking_utils/patch.hpp"
 #include "../utils/rclcpp_gtest_macros.hpp"
 
+#include "test_msgs/msg/basic_types.hpp"
 #include "test_msgs/msg/empty.hpp"
+#include "test_msgs/msg/unbounded_sequences.hpp"
 
 using namespace std::chrono_literals;
 
@@ -169,6 +172,18 @@ TEST_F(TestSubscription, construction_and_destruction) {
     EXPECT_EQ(depth, sub->get_actual_qos().get_rmw_qos_profile().depth);
   }
 
+  {
+    // The const reference callbacks don't take ownership, so they share intra-process messages
+    auto sub = node->create_subscription<Empty>("topic", 10u, [](const Empty &) {});
+    EXPECT_TRUE(sub->use_take_shared_method());
+    auto sub_with_info = node->create_subscription<Empty>(
+      "topic", 10u, [](const Empty &, const rclcpp::MessageInfo &) {});
+    EXPECT_TRUE(sub_with_info->use_take_shared_method());
+    auto owning_sub = node->create_subscription<Empty>(
+      "topic", 10u, [](std::unique_ptr<Empty>) {});
+    EXPECT_FALSE(owning_sub->use_take_shared_method());
+  }
+
   {
     ASSERT_THROW(
     {
@@ -510,6 +525,233 @@ TEST_F(TestSubscription, on_new_message_callback) {
   EXPECT_THROW(sub->set_on_new_message_callback(invalid_cb), std::invalid_argument);
 }
 
+/*
+   Testing that several messages are taken per wake up with max_messages_per_wakeup.
+ */
+TEST_F(TestSubscription, max_messages_per_wakeup) {
+  initialize(rclcpp::NodeOptions().use_intra_process_comms(false));
+  using test_msgs::msg::Empty;
+
+  rclcpp::SubscriptionOptions options;
+  options.max_messages_per_wakeup = 0;
+  auto do_nothing = [](std::shared_ptr<const test_msgs::msg::Empty>) {};
+  EXPECT_THROW(
+    node->create_subscription<Empty>("~/test_take", 10, do_nothing, options),
+    std::invalid_argument);
+
+  size_t received = 0;
+  options.max_messages_per_wakeup = 3;
+  auto sub = node->create_subscription<Empty>(
+    "~/test_take", 10, [&received](std::shared_ptr<const Empty>) {received++;}, options);
+  EXPECT_EQ(3u, sub->get_max_messages_per_wakeup());
+
+  std::atomic<size_t> available {0};
+  sub->set_on_new_message_callback([&available](size_t count_msgs) {available += count_msgs;});
+
+  auto pub = node->create_publisher<Empty>("~/test_take", 10);
+  for (int i = 0; i < 4; ++i) {
+    pub->publish(Empty());
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  while (available < 4 && std::chrono::steady_clock::now() - start < 10s) {
+    std::this_thread::sleep_for(10ms);
+  }
+  ASSERT_EQ(4u, available.load());
+  sub->clear_on_new_message_callback();
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  executor.spin_once(1s);
+  EXPECT_EQ(3u, received);
+  executor.spin_once(1s);
+  EXPECT_EQ(4u, received);
+}
+
+/*
+   Testing that the messages taken at once are given to a batch callback in a single call.
+ */
+TEST_F(TestSubscription, batch_callback) {
+  initialize(rclcpp::NodeOptions().use_intra_process_comms(false));
+  using test_msgs::msg::BasicTypes;
+
+  auto expect_batches = [this](const std::string & topic_name) {
+      std::vector<std::vector<int32_t>> batches;
+      rclcpp::SubscriptionOptions options;
+      options.max_messages_per_wakeup = 3;
+      auto sub = node->create_subscription<BasicTypes>(
+        topic_name, 10,
+        [&batches](
+          const std::vector<std::shared_ptr<const BasicTypes>> & messages,
+          const std::vector<rclcpp::MessageInfo> & message_infos)
+        {
+          EXPECT_EQ(messages.size(), message_infos.size());
+          std::vector<int32_t> batch;
+          for (const auto & message : messages) {
+            batch.push_back(message->int32_value);
+          }
+          batches.push_back(batch);
+        },
+        options);
+      EXPECT_TRUE(sub->has_batch_callback());
+
+      std::atomic<size_t> available {0};
+      sub->set_on_new_message_callback(
+        [&available](size_t count_msgs) {available += count_msgs;});
+
+      auto pub = node->create_publisher<BasicTypes>(topic_name, 10);
+      for (int32_t i = 0; i < 4; ++i) {
+        BasicTypes message;
+        message.int32_value = i;
+        pub->publish(message);
+      }
+
+      auto start = std::chrono::steady_clock::now();
+      while (available < 4 && std::chrono::steady_clock::now() - start < 10s) {
+        std::this_thread::sleep_for(10ms);
+      }
+      ASSERT_EQ(4u, available.load());
+      sub->clear_on_new_message_callback();
+
+      rclcpp::executors::SingleThreadedExecutor executor;
+      executor.add_node(node);
+      executor.spin_once(1s);
+      executor.spin_once(1s);
+      EXPECT_EQ((std::vector<std::vector<int32_t>>{{0, 1, 2}, {3}}), batches);
+    };
+
+  {
+    SCOPED_TRACE("rcl_take_sequence");
+    expect_batches("~/test_batch");
+  }
+  {
+    // The messages are taken one at a time, and still given to the callback as a batch.
+    SCOPED_TRACE("rcl_take");
+    auto mock = mocking_utils::patch_and_return(
+      "lib:rclcpp", rcl_take_sequence, RCL_RET_UNSUPPORTED);
+    expect_batches("~/test_batch_unsupported");
+  }
+}
+
+/*
+   Testing that the intra-process messages are given to a batch callback one at a time.
+ */
+TEST_F(TestSubscription, batch_callback_intra_process) {
+  initialize(rclcpp::NodeOptions().use_intra_process_comms(true));
+  using test_msgs::msg::BasicTypes;
+
+  std::vector<size_t> batch_sizes;
+  rclcpp::SubscriptionOptions options;
+  options.max_messages_per_wakeup = 3;
+  auto sub = node->create_subscription<BasicTypes>(
+    "~/test_batch", 10,
+    [&batch_sizes](const std::vector<std::shared_ptr<const BasicTypes>> & messages) {
+      batch_sizes.push_back(messages.size());
+    },
+    options);
+
+  auto pub = node->create_publisher<BasicTypes>("~/test_batch", 10);
+  pub->publish(BasicTypes());
+  pub->publish(BasicTypes());
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  executor.spin_some();
+  EXPECT_EQ((std::vector<size_t>{1u, 1u}), batch_sizes);
+}
+
+/*
+   Testing that only the newest message is given to the callback with take_only_latest.
+ */
+TEST_F(TestSubscription, take_only_latest) {
+  initialize(rclcpp::NodeOptions().use_intra_process_comms(false));
+  using test_msgs::msg::BasicTypes;
+
+  rclcpp::SubscriptionOptions options;
+  options.take_only_latest = true;
+  std::vector<int32_t> received_values;
+  auto sub = node->create_subscription<BasicTypes>(
+    "~/test_take_only_latest", 10,
+    [&received_values](std::shared_ptr<const BasicTypes> msg) {
+      received_values.push_back(msg->int32_value);
+    }, options);
+  EXPECT_FALSE(sub->can_loan_messages());
+
+  std::atomic<size_t> available {0};
+  sub->set_on_new_message_callback([&available](size_t count_msgs) {available += count_msgs;});
+
+  auto pub = node->create_publisher<BasicTypes>("~/test_take_only_latest", 10);
+  BasicTypes msg;
+  for (int32_t i = 1; i <= 4; ++i) {
+    msg.int32_value = i;
+    pub->publish(msg);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  while (available < 4 && std::chrono::steady_clock::now() - start < 10s) {
+    std::this_thread::sleep_for(10ms);
+  }
+  ASSERT_EQ(4u, available.load());
+  sub->clear_on_new_message_callback();
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  executor.spin_once(1s);
+  EXPECT_EQ(std::vector<int32_t>({4}), received_values);
+  // The older messages were dropped.
+  BasicTypes taken_msg;
+  rclcpp::MessageInfo message_info;
+  EXPECT_FALSE(sub->take(taken_msg, message_info));
+}
+
+/*
+   Testing that the messages deserialized by a pool are given in order to the callback.
+ */
+TEST_F(TestSubscription, deserialization_pool) {
+  initialize(rclcpp::NodeOptions().use_intra_process_comms(false));
+  using test_msgs::msg::UnboundedSequences;
+
+  rclcpp::SubscriptionOptions options;
+  options.deserialization_pool = std::make_shared<rclcpp::DeserializationPool>(2u);
+  // Only the messages with values are deserialized by the pool.
+  options.deserialization_pool_min_size = 1024;
+  std::vector<int32_t> received_values;
+  const auto executor_thread_id = std::this_thread::get_id();
+  bool called_by_executor = true;
+  auto sub = node->create_subscription<UnboundedSequences>(
+    "~/test_deserialization_pool", 100,
+    [&](std::shared_ptr<const UnboundedSequences> msg) {
+      received_values.push_back(msg->alignment_check);
+      called_by_executor &= std::this_thread::get_id() == executor_thread_id;
+    }, options);
+  EXPECT_TRUE(sub->uses_deserialization_pool());
+  EXPECT_NE(nullptr, sub->get_deserialization_waitable());
+  EXPECT_FALSE(sub->can_loan_messages());
+
+  auto pub = node->create_publisher<UnboundedSequences>("~/test_deserialization_pool", 100);
+  std::vector<int32_t> published_values;
+  for (int32_t i = 1; i <= 20; ++i) {
+    UnboundedSequences msg;
+    msg.alignment_check = i;
+    if (i % 3 != 0) {
+      msg.int32_values.resize(1000u, i);
+    }
+    pub->publish(msg);
+    published_values.push_back(i);
+  }
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  auto start = std::chrono::steady_clock::now();
+  while (received_values.size() < published_values.size() &&
+    std::chrono::steady_clock::now() - start < 10s)
+  {
+    executor.spin_some(100ms);
+  }
+  EXPECT_EQ(published_values, received_values);
+  EXPECT_TRUE(called_by_executor);
+}
+
 /*
    Testing on_new_intra_process_message callbacks.
  */
@@ -580,6 +822,69 @@ TEST_F(TestSubscription, on_new_intra_process_message_callback) {
   EXPECT_THROW(sub->set_on_new_intra_process_message_callback(invalid_cb), std::invalid_argument);
 }
 
+/*
+   Testing the occupancy counters of the intra-process buffer.
+ */
+TEST_F(TestSubscription, intra_process_buffer_counters) {
+  initialize(rclcpp::NodeOptions().use_intra_process_comms(true));
+  using test_msgs::msg::Empty;
+
+  auto do_nothing = [](std::shared_ptr<const test_msgs::msg::Empty>) {};
+  auto sub = node->create_subscription<test_msgs::msg::Empty>("~/test_counters", 2, do_nothing);
+  auto pub = node->create_publisher<test_msgs::msg::Empty>("~/test_counters", 1);
+
+  auto counters = sub->get_intra_process_buffer_counters();
+  EXPECT_EQ(2u, counters.capacity);
+  EXPECT_EQ(0u, counters.depth);
+
+  // The messages are stored when they are published, and the oldest ones are overwritten
+  for (int i = 0; i < 5; ++i) {
+    pub->publish(test_msgs::msg::Empty());
+  }
+  counters = sub->get_intra_process_buffer_counters();
+  EXPECT_EQ(2u, counters.depth);
+  EXPECT_EQ(2u, counters.high_water_mark);
+  EXPECT_EQ(3u, counters.dropped);
+
+  rclcpp::SubscriptionOptions options;
+  options.use_intra_process_comm = rclcpp::IntraProcessSetting::Disable;
+  auto inter_process_sub = node->create_subscription<test_msgs::msg::Empty>(
+    "~/test_counters", 2, do_nothing, options);
+  EXPECT_EQ(0u, inter_process_sub->get_intra_process_buffer_counters().capacity);
+}
+
+/*
+   Testing the counters of the messages passed within the process.
+ */
+TEST_F(TestSubscription, intra_process_message_counters) {
+  initialize(rclcpp::NodeOptions().use_intra_process_comms(true));
+  using test_msgs::msg::BasicTypes;
+
+  auto do_nothing = [](std::shared_ptr<const BasicTypes>) {};
+  auto sub = node->create_subscription<BasicTypes>("~/test_message_counters", 10, do_nothing);
+  auto pub = node->create_publisher<BasicTypes>("~/test_message_counters", 10);
+  EXPECT_EQ(0u, pub->get_intra_process_publish_counters().messages);
+  EXPECT_EQ(0u, sub->get_intra_process_receive_counters().messages);
+  EXPECT_EQ(
+    node->get_node_base_interface()->get_rcl_node_handle(), pub->get_rcl_node_handle().get());
+
+  for (int i = 0; i < 3; ++i) {
+    pub->publish(BasicTypes());
+  }
+  auto publish_counters = pub->get_intra_process_publish_counters();
+  EXPECT_EQ(3u, publish_counters.messages);
+  EXPECT_EQ(3u * sizeof(BasicTypes), publish_counters.bytes);
+
+  // The messages are counted once given to the callback.
+  EXPECT_EQ(0u, sub->get_intra_process_receive_counters().messages);
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  executor.spin_some();
+  auto receive_counters = sub->get_intra_process_receive_counters();
+  EXPECT_EQ(3u, receive_counters.messages);
+  EXPECT_EQ(3u * sizeof(BasicTypes), receive_counters.bytes);
+}
+
 /*
    Testing subscription with intraprocess enabled and invalid QoS
  */
@@ -310,3 +310,101 @@ TEST_F(CLASSNAME(TestContentFilterSubscription, RMW_IMPLEMENTATION), content_fil
     }
   }
 }
+
+TEST_F(CLASSNAME(TestContentFilterSubscription, RMW_IMPLEMENTATION), content_filter_intra_process) {
+  using namespace std::chrono_literals;
+  auto ipc_node = std::make_shared<rclcpp::Node>(
+    "test_content_filter_ipc_node", "/ns", rclcpp::NodeOptions().use_intra_process_comms(true));
+
+  auto options = rclcpp::SubscriptionOptions();
+  options.content_filter_options.filter_expression = filter_expression_init;
+  options.content_filter_options.expression_parameters = expression_parameters_1;
+
+  std::vector<int32_t> received_values;
+  auto callback = [&received_values](std::shared_ptr<const test_msgs::msg::BasicTypes> msg) {
+      received_values.push_back(msg->int32_value);
+    };
+  auto ipc_sub = ipc_node->create_subscription<test_msgs::msg::BasicTypes>(
+    "content_filter_ipc_topic", rclcpp::KeepLast(10), callback, options);
+  auto pub = ipc_node->create_publisher<test_msgs::msg::BasicTypes>(
+    "content_filter_ipc_topic", rclcpp::KeepLast(10));
+
+  // The messages not matching the filter aren't delivered by the intra-process manager.
+  test_msgs::msg::BasicTypes msg;
+  msg.int32_value = 4;
+  pub->publish(msg);
+  msg.int32_value = 3;
+  pub->publish(msg);
+
+  auto start = std::chrono::steady_clock::now();
+  while (received_values.empty() && std::chrono::steady_clock::now() - start < 10s) {
+    rclcpp::spin_some(ipc_node);
+  }
+  EXPECT_EQ(std::vector<int32_t>({3}), received_values);
+
+  if (ipc_sub->is_cft_enabled()) {
+    EXPECT_NO_THROW(
+      ipc_sub->set_content_filter(filter_expression_init, expression_parameters_2));
+    received_values.clear();
+    msg.int32_value = 3;
+    pub->publish(msg);
+    msg.int32_value = 4;
+    pub->publish(msg);
+
+    start = std::chrono::steady_clock::now();
+    while (received_values.empty() && std::chrono::steady_clock::now() - start < 10s) {
+      rclcpp::spin_some(ipc_node);
+    }
+    EXPECT_EQ(std::vector<int32_t>({4}), received_values);
+  }
+}
+
+TEST_F(
+  CLASSNAME(TestContentFilterSubscription, RMW_IMPLEMENTATION), filter_in_process_if_unsupported)
+{
+  using namespace std::chrono_literals;
+  auto options = rclcpp::SubscriptionOptions();
+  options.content_filter_options.filter_expression = filter_expression_init;
+  options.content_filter_options.expression_parameters = expression_parameters_1;
+  options.content_filter_options.filter_in_process_if_unsupported = true;
+
+  std::vector<int32_t> received_values;
+  auto callback = [&received_values](std::shared_ptr<const test_msgs::msg::BasicTypes> msg) {
+      received_values.push_back(msg->int32_value);
+    };
+  auto local_sub = node->create_subscription<test_msgs::msg::BasicTypes>(
+    "content_filter_local_topic", qos, callback, options);
+  auto pub = node->create_publisher<test_msgs::msg::BasicTypes>(
+    "content_filter_local_topic", qos);
+  auto connected = [pub, local_sub]() -> bool {
+      return pub->get_subscription_count() && local_sub->get_publisher_count();
+    };
+  ASSERT_TRUE(wait_for(connected, 10s));
+
+  // Whether the middleware or the subscription filters them, only the matching ones arrive.
+  test_msgs::msg::BasicTypes msg;
+  for (int32_t value : {4, 3, 5, 3}) {
+    msg.int32_value = value;
+    pub->publish(msg);
+  }
+  auto received_two = [&received_values]() {return received_values.size() >= 2u;};
+  EXPECT_TRUE(wait_for(received_two, 10s));
+  EXPECT_EQ(std::vector<int32_t>({3, 3}), received_values);
+
+  if (!local_sub->is_cft_enabled()) {
+    EXPECT_NO_THROW(local_sub->set_content_filter(filter_expression_init, expression_parameters_2));
+    auto content_filter_options = local_sub->get_content_filter();
+    EXPECT_EQ(filter_expression_init, content_filter_options.filter_expression);
+    EXPECT_EQ(expression_parameters_2, content_filter_options.expression_parameters);
+    EXPECT_THROW(local_sub->set_content_filter("int32_value LIKE 'a'"), std::invalid_argument);
+
+    received_values.clear();
+    for (int32_t value : {3, 4}) {
+      msg.int32_value = value;
+      pub->publish(msg);
+    }
+    auto received_one = [&received_values]() {return !received_values.empty();};
+    EXPECT_TRUE(wait_for(received_one, 10s));
+    EXPECT_EQ(std::vector<int32_t>({4}), received_values);
+  }
+}
@@ -0,0 +1,202 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "rclcpp/experimental/synchronized_subscription.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "test_msgs/msg/basic_types.hpp"
+#include "test_msgs/msg/builtins.hpp"
+
+using test_msgs::msg::BasicTypes;
+using test_msgs::msg::Builtins;
+using namespace std::chrono_literals;
+
+namespace rclcpp
+{
+namespace experimental
+{
+// The stamps of the basic types are their 64 bits integer, and the ones of the builtins
+// their time.
+template<>
+struct MessageStamp<BasicTypes>
+{
+  static int64_t
+  get(const BasicTypes & message)
+  {
+    return message.int64_value;
+  }
+};
+
+template<>
+struct MessageStamp<Builtins>
+{
+  static int64_t
+  get(const Builtins & message)
+  {
+    return rclcpp::Time(message.time_value).nanoseconds();
+  }
+};
+}  // namespace experimental
+}  // namespace rclcpp
+
+namespace
+{
+
+std::shared_ptr<const BasicTypes>
+make_basic_types(int64_t stamp)
+{
+  auto message = std::make_shared<BasicTypes>();
+  message->int64_value = stamp;
+  return message;
+}
+
+std::shared_ptr<const Builtins>
+make_builtins(int64_t stamp)
+{
+  auto message = std::make_shared<Builtins>();
+  message->time_value = rclcpp::Time(stamp);
+  return message;
+}
+
+}  // namespace
+
+class TestSynchronizedSubscription : public ::testing::Test
+{
+protected:
+  using SynchronizedSubscription =
+    rclcpp::experimental::SynchronizedSubscription<BasicTypes, Builtins>;
+
+  void SetUp() override
+  {
+    rclcpp::init(0, nullptr);
+    node = std::make_shared<rclcpp::Node>("test_synchronized_subscription");
+  }
+
+  void TearDown() override
+  {
+    node.reset();
+    rclcpp::shutdown();
+  }
+
+  SynchronizedSubscription::Callback
+  make_callback()
+  {
+    return [this](
+      std::shared_ptr<const BasicTypes> basic_types, std::shared_ptr<const Builtins> builtins)
+           {
+             matched_stamps.emplace_back(
+               basic_types->int64_value, rclcpp::Time(builtins->time_value).nanoseconds());
+           };
+  }
+
+  rclcpp::Node::SharedPtr node;
+  std::vector<std::tuple<int64_t, int64_t>> matched_stamps;
+};
+
+TEST_F(TestSynchronizedSubscription, invalid_arguments) {
+  EXPECT_THROW(SynchronizedSubscription(0u, 0ns, make_callback()), std::invalid_argument);
+  EXPECT_THROW(SynchronizedSubscription(10u, -1ns, make_callback()), std::invalid_argument);
+  EXPECT_THROW(SynchronizedSubscription(10u, 0ns, nullptr), std::invalid_argument);
+
+  rclcpp::SubscriptionOptions options;
+  options.callback_group = node->create_callback_group(rclcpp::CallbackGroupType::Reentrant);
+  EXPECT_THROW(
+    (rclcpp::experimental::create_synchronized_subscription<BasicTypes, Builtins>(
+      node, {"basic_types", "builtins"}, 10, 10u, 0ns, make_callback(), options)),
+    std::invalid_argument);
+}
+
+TEST_F(TestSynchronizedSubscription, exact_time) {
+  SynchronizedSubscription subscription(3u, 0ns, make_callback());
+  subscription.add_message<0>(make_basic_types(1));
+  subscription.add_message<0>(make_basic_types(2));
+  EXPECT_TRUE(matched_stamps.empty());
+  subscription.add_message<1>(make_builtins(2));
+  // The oldest message can't be matched anymore.
+  ASSERT_EQ(1u, matched_stamps.size());
+  EXPECT_EQ(std::make_tuple(int64_t{2}, int64_t{2}), matched_stamps[0]);
+  EXPECT_EQ(1u, subscription.get_number_of_dropped_messages());
+  EXPECT_EQ(0u, subscription.get_number_of_pending_messages());
+
+  // The messages older than the last one of their topic are dropped.
+  subscription.add_message<1>(make_builtins(5));
+  subscription.add_message<1>(make_builtins(4));
+  EXPECT_EQ(2u, subscription.get_number_of_dropped_messages());
+  // The oldest messages of a full ring are dropped.
+  for (int64_t stamp = 6; stamp < 9; ++stamp) {
+    subscription.add_message<1>(make_builtins(stamp));
+  }
+  EXPECT_EQ(3u, subscription.get_number_of_dropped_messages());
+  EXPECT_EQ(3u, subscription.get_number_of_pending_messages());
+  subscription.add_message<0>(make_basic_types(7));
+  ASSERT_EQ(2u, matched_stamps.size());
+  EXPECT_EQ(std::make_tuple(int64_t{7}, int64_t{7}), matched_stamps[1]);
+}
+
+TEST_F(TestSynchronizedSubscription, approximate_time) {
+  SynchronizedSubscription subscription(10u, 10ns, make_callback());
+  subscription.add_message<0>(make_basic_types(100));
+  subscription.add_message<0>(make_basic_types(200));
+  subscription.add_message<1>(make_builtins(195));
+  subscription.add_message<1>(make_builtins(215));
+  subscription.add_message<0>(make_basic_types(220));
+  ASSERT_EQ(2u, matched_stamps.size());
+  EXPECT_EQ(std::make_tuple(int64_t{200}, int64_t{195}), matched_stamps[0]);
+  EXPECT_EQ(std::make_tuple(int64_t{220}, int64_t{215}), matched_stamps[1]);
+  EXPECT_EQ(1u, subscription.get_number_of_dropped_messages());
+}
+
+TEST_F(TestSynchronizedSubscription, intra_process_subscriptions) {
+  auto ipc_node = std::make_shared<rclcpp::Node>(
+    "test_synchronized_subscription_ipc", rclcpp::NodeOptions().use_intra_process_comms(true));
+  const void * published_basic_types = nullptr;
+  const void * received_basic_types = nullptr;
+  auto subscription = rclcpp::experimental::create_synchronized_subscription<BasicTypes, Builtins>(
+    ipc_node, {"basic_types", "builtins"}, 10, 10u, 0ns,
+    [&](std::shared_ptr<const BasicTypes> basic_types, std::shared_ptr<const Builtins> builtins) {
+      received_basic_types = basic_types.get();
+      matched_stamps.emplace_back(
+        basic_types->int64_value, rclcpp::Time(builtins->time_value).nanoseconds());
+    });
+  EXPECT_EQ("/basic_types", std::string(subscription->get_subscription<0>()->get_topic_name()));
+  EXPECT_EQ("/builtins", std::string(subscription->get_subscription<1>()->get_topic_name()));
+  auto basic_types_publisher = ipc_node->create_publisher<BasicTypes>("basic_types", 10);
+  auto builtins_publisher = ipc_node->create_publisher<Builtins>("builtins", 10);
+
+  auto basic_types = std::make_unique<BasicTypes>();
+  basic_types->int64_value = 42;
+  published_basic_types = basic_types.get();
+  basic_types_publisher->publish(std::move(basic_types));
+  builtins_publisher->publish(*make_builtins(42));
+
+  auto start = std::chrono::steady_clock::now();
+  while (matched_stamps.empty() && std::chrono::steady_clock::now() - start < 10s) {
+    rclcpp::spin_some(ipc_node);
+  }
+  ASSERT_EQ(1u, matched_stamps.size());
+  EXPECT_EQ(std::make_tuple(int64_t{42}, int64_t{42}), matched_stamps[0]);
+  // The message published by the unique pointer is the one given to the callback.
+  EXPECT_EQ(published_basic_types, received_basic_types);
+}
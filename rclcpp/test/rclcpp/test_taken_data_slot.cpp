@@ -0,0 +1,69 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "rclcpp/detail/taken_data_slot.hpp"
+
+using rclcpp::detail::TakenDataSlot;
+
+using TakenData = std::pair<std::shared_ptr<const std::string>, std::unique_ptr<std::string>>;
+
+TEST(TestTakenDataSlot, reuse_storage) {
+  TakenDataSlot<TakenData> slot;
+  auto message = std::make_shared<const std::string>("message");
+
+  std::shared_ptr<void> data = slot.make(message, std::make_unique<std::string>("unique"));
+  ASSERT_NE(nullptr, data);
+  EXPECT_TRUE(slot.in_use());
+  const void * address = data.get();
+  auto taken_data = std::static_pointer_cast<TakenData>(data);
+  EXPECT_EQ(message, taken_data->first);
+  EXPECT_EQ("unique", *taken_data->second);
+  taken_data.reset();
+  data.reset();
+  // The data are destroyed when they are released
+  EXPECT_FALSE(slot.in_use());
+  EXPECT_EQ(1, message.use_count());
+
+  data = slot.make(message, nullptr);
+  EXPECT_EQ(address, data.get());
+}
+
+TEST(TestTakenDataSlot, allocate_when_in_use) {
+  TakenDataSlot<TakenData> slot;
+  std::shared_ptr<void> data = slot.make(nullptr, nullptr);
+  std::shared_ptr<void> other_data = slot.make(nullptr, nullptr);
+  ASSERT_NE(nullptr, other_data);
+  EXPECT_NE(data.get(), other_data.get());
+
+  data.reset();
+  EXPECT_FALSE(slot.in_use());
+  other_data.reset();
+  EXPECT_FALSE(slot.in_use());
+}
+
+TEST(TestTakenDataSlot, outlive_slot) {
+  std::shared_ptr<void> data;
+  {
+    TakenDataSlot<TakenData> slot;
+    data = slot.make(std::make_shared<const std::string>("message"), nullptr);
+  }
+  EXPECT_EQ("message", *std::static_pointer_cast<TakenData>(data)->first);
+}
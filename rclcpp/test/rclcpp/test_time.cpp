@@ -15,11 +15,13 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <limits>
 #include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "rcl/error_handling.h"
 #include "rcl/time.h"
@@ -99,6 +101,42 @@ static const int64_t HALF_SEC_IN_NS = RCUTILS_MS_TO_NS(500);
 static const int64_t ONE_SEC_IN_NS = RCUTILS_MS_TO_NS(1000);
 static const int64_t ONE_AND_HALF_SEC_IN_NS = 3 * HALF_SEC_IN_NS;
 
+TEST_F(TestTime, ros_time_override) {
+  rclcpp::Clock ros_clock(RCL_ROS_TIME);
+  rcl_clock_t * rcl_clock = ros_clock.get_clock_handle();
+
+  // The time seen by the jump callbacks is the new one.
+  int64_t time_in_callback = 0;
+  rcl_jump_threshold_t threshold;
+  threshold.on_clock_change = true;
+  threshold.min_backward.nanoseconds = -1;
+  threshold.min_forward.nanoseconds = 1;
+  auto handler = ros_clock.create_jump_callback(
+    nullptr,
+    [&ros_clock, &time_in_callback](const rcl_time_jump_t &) {
+      time_in_callback = ros_clock.now().nanoseconds();
+    },
+    threshold);
+
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(rcl_clock, ONE_SEC_IN_NS));
+  EXPECT_NE(ONE_SEC_IN_NS, ros_clock.now().nanoseconds());
+
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(rcl_clock));
+  EXPECT_EQ(ONE_SEC_IN_NS, ros_clock.now().nanoseconds());
+  EXPECT_EQ(ONE_SEC_IN_NS, time_in_callback);
+
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(rcl_clock, 2 * ONE_SEC_IN_NS));
+  EXPECT_EQ(2 * ONE_SEC_IN_NS, ros_clock.now().nanoseconds());
+  EXPECT_EQ(2 * ONE_SEC_IN_NS, time_in_callback);
+  EXPECT_EQ(RCL_ROS_TIME, ros_clock.now().get_clock_type());
+
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(rcl_clock, ONE_SEC_IN_NS));
+  EXPECT_EQ(ONE_SEC_IN_NS, ros_clock.now().nanoseconds());
+
+  ASSERT_EQ(RCL_RET_OK, rcl_disable_ros_time_override(rcl_clock));
+  EXPECT_LT(2 * ONE_SEC_IN_NS, ros_clock.now().nanoseconds());
+}
+
 TEST_F(TestTime, conversions) {
   rclcpp::Clock system_clock(RCL_SYSTEM_TIME);
 
@@ -671,6 +709,45 @@ TEST_F(TestClockSleep, sleep_until_basic_ros) {
   EXPECT_TRUE(sleep_succeeded);
 }
 
+TEST_F(TestClockSleep, sleep_until_ros_wakes_reached_deadlines) {
+  rclcpp::Clock clock(RCL_ROS_TIME);
+  rcl_clock_t * rcl_clock = clock.get_clock_handle();
+
+  const rcl_time_point_value_t start_time = 1337;
+  ASSERT_EQ(RCL_RET_OK, rcl_enable_ros_time_override(rcl_clock));
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(rcl_clock, start_time));
+
+  // Sleeping until start_time + 1, start_time + 2 and start_time + 3
+  constexpr size_t number_of_sleepers = 3;
+  std::atomic_size_t number_of_woken_sleepers{0};
+  std::atomic_bool sleep_succeeded[number_of_sleepers] = {};
+  std::vector<std::thread> sleep_threads;
+  for (size_t i = 0; i < number_of_sleepers; ++i) {
+    const auto until = rclcpp::Time(start_time + static_cast<int64_t>(i) + 1, RCL_ROS_TIME);
+    sleep_threads.emplace_back(
+      [&clock, until, &sleep_succeeded, &number_of_woken_sleepers, i]() {
+        sleep_succeeded[i] = clock.sleep_until(until);
+        number_of_woken_sleepers++;
+      });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT_EQ(0u, number_of_woken_sleepers.load());
+
+  // Only the sleepers whose deadline is reached return
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(rcl_clock, start_time + 2));
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT_EQ(2u, number_of_woken_sleepers.load());
+  EXPECT_TRUE(sleep_succeeded[0]);
+  EXPECT_TRUE(sleep_succeeded[1]);
+
+  ASSERT_EQ(RCL_RET_OK, rcl_set_ros_time_override(rcl_clock, start_time + 3));
+  for (auto & sleep_thread : sleep_threads) {
+    sleep_thread.join();
+  }
+  EXPECT_EQ(number_of_sleepers, number_of_woken_sleepers.load());
+  EXPECT_TRUE(sleep_succeeded[2]);
+}
+
 TEST_F(TestClockSleep, sleep_for_invalid_context) {
   rclcpp::Clock clock(RCL_SYSTEM_TIME);
   auto rel_time = rclcpp::Duration(1, 0u);
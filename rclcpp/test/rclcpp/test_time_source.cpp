@@ -19,6 +19,7 @@
 #include <limits>
 #include <memory>
 #include <string>
+#include <thread>
 
 #include "rcl/error_handling.h"
 #include "rcl/time.h"
@@ -822,3 +823,35 @@ TEST_F(TestTimeSource, clock_sleep_until_with_ros_time_basic) {
   auto until = now + rclcpp::Duration(0, 500);
   EXPECT_TRUE(clock->sleep_until(until));
 }
+
+TEST_F(TestTimeSource, shared_clock_subscription) {
+  SimClockPublisherNode pub_node;
+  pub_node.SpinNode();
+
+  rclcpp::NodeOptions options;
+  options.use_shared_clock_subscription(true);
+  options.parameter_overrides({{"use_sim_time", true}});
+  auto first_node = std::make_shared<rclcpp::Node>("first_shared_clock_node", options);
+  auto second_node = std::make_shared<rclcpp::Node>("second_shared_clock_node", options);
+
+  // Neither node spins, the clocks are updated by the shared subscription.
+  auto start = std::chrono::steady_clock::now();
+  while ((first_node->now().nanoseconds() == 0 || second_node->now().nanoseconds() == 0) &&
+    std::chrono::steady_clock::now() - start < 5s)
+  {
+    std::this_thread::sleep_for(1ms);
+  }
+  EXPECT_NE(0, first_node->now().nanoseconds());
+  EXPECT_NE(0, second_node->now().nanoseconds());
+
+  // Leaving the shared subscription stops updating the clock.
+  first_node->set_parameter({"use_sim_time", false});
+  EXPECT_FALSE(first_node->get_clock()->ros_time_is_active());
+  second_node.reset();
+  first_node->set_parameter({"use_sim_time", true});
+  start = std::chrono::steady_clock::now();
+  while (first_node->now().nanoseconds() == 0 && std::chrono::steady_clock::now() - start < 5s) {
+    std::this_thread::sleep_for(1ms);
+  }
+  EXPECT_NE(0, first_node->now().nanoseconds());
+}
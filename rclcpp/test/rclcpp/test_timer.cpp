@@ -18,6 +18,8 @@
 #include <chrono>
 #include <exception>
 #include <memory>
+#include <stdexcept>
+#include <thread>
 #include <utility>
 
 #include "rcl/timer.h"
@@ -261,6 +263,48 @@ TEST_P(TestTimer, callback_with_period_zero) {
   EXPECT_TRUE(timer_ptr->is_ready());
 }
 
+TEST_P(TestTimer, missed_periods) {
+  size_t number_of_calls = 0;
+  size_t number_of_missed_periods = 0;
+  auto timer_callback = [&](rclcpp::TimerBase & timer) {
+      number_of_calls++;
+      number_of_missed_periods = timer.get_number_of_missed_periods();
+    };
+  switch (timer_type) {
+    case TimerType::WALL_TIMER:
+      timer = test_node->create_wall_timer(10ms, timer_callback);
+      break;
+    case TimerType::GENERIC_TIMER:
+      timer = test_node->create_timer(10ms, timer_callback);
+      break;
+  }
+  EXPECT_EQ(rclcpp::MissedPeriodsPolicy::CallOnce, timer->get_missed_periods_policy());
+  EXPECT_THROW(timer->set_slack(-1ms), std::invalid_argument);
+  timer->set_slack(5ms);
+  EXPECT_EQ(5ms, timer->get_slack());
+
+  // Called once for all the missed periods.
+  std::this_thread::sleep_for(35ms);
+  executor->spin_once(0ms);
+  EXPECT_EQ(1u, number_of_calls);
+  EXPECT_LE(2u, number_of_missed_periods);
+  EXPECT_FALSE(timer->is_ready());
+
+  // Not called at all.
+  timer->set_missed_periods_policy(rclcpp::MissedPeriodsPolicy::Skip);
+  std::this_thread::sleep_for(35ms);
+  executor->spin_once(0ms);
+  EXPECT_EQ(1u, number_of_calls);
+  EXPECT_FALSE(timer->is_ready());
+
+  // Called again at the next deadline.
+  auto start = std::chrono::steady_clock::now();
+  while (number_of_calls < 2 && std::chrono::steady_clock::now() - start < 1s) {
+    executor->spin_once(10ms);
+  }
+  EXPECT_EQ(2u, number_of_calls);
+}
+
 /// Test internal failures using mocks
 TEST_P(TestTimer, test_failures_with_exceptions)
 {
@@ -0,0 +1,145 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "rclcpp/trace_recorder.hpp"
+
+namespace trace_recorder = rclcpp::trace_recorder;
+
+class TestTraceRecorder : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    path = "test_trace_recorder.json";
+    trace_recorder::clear();
+  }
+
+  void TearDown() override
+  {
+    trace_recorder::disable();
+    trace_recorder::clear();
+    std::remove(path.c_str());
+  }
+
+  std::string
+  dump_and_read()
+  {
+    trace_recorder::dump(path);
+    std::ifstream stream(path);
+    std::stringstream content;
+    content << stream.rdbuf();
+    return content.str();
+  }
+
+  size_t
+  count(const std::string & content, const std::string & pattern)
+  {
+    size_t number = 0u;
+    for (size_t pos = content.find(pattern); pos != std::string::npos;
+      pos = content.find(pattern, pos + 1u))
+    {
+      ++number;
+    }
+    return number;
+  }
+
+  std::string path;
+};
+
+TEST_F(TestTraceRecorder, disabled_by_default) {
+  EXPECT_FALSE(trace_recorder::is_enabled());
+  int entity = 0;
+  RCLCPP_TRACE_RECORD(Publish, &entity, "/topic");
+  const std::string content = dump_and_read();
+  EXPECT_NE(std::string::npos, content.find("\"traceEvents\""));
+  EXPECT_EQ(std::string::npos, content.find("/topic"));
+}
+
+TEST_F(TestTraceRecorder, invalid_size) {
+  EXPECT_THROW(trace_recorder::enable(0u), std::invalid_argument);
+  EXPECT_FALSE(trace_recorder::is_enabled());
+}
+
+TEST_F(TestTraceRecorder, record_and_dump) {
+  trace_recorder::enable();
+  EXPECT_TRUE(trace_recorder::is_enabled());
+  int entity = 0;
+  RCLCPP_TRACE_RECORD(WaitStart, &entity, nullptr);
+  RCLCPP_TRACE_RECORD(WaitEnd, &entity, nullptr);
+  RCLCPP_TRACE_RECORD(CallbackStart, &entity, "my_\"callback\"");
+  RCLCPP_TRACE_RECORD(Publish, &entity, "/topic");
+  RCLCPP_TRACE_RECORD(CallbackEnd, &entity, nullptr);
+  std::thread([&entity]() {RCLCPP_TRACE_RECORD(Take, &entity, "/topic");}).join();
+
+  const std::string content = dump_and_read();
+  EXPECT_NE(std::string::npos, content.find("\"traceEvents\""));
+  EXPECT_NE(std::string::npos, content.find("\"name\":\"wait\""));
+  EXPECT_NE(std::string::npos, content.find("\"name\":\"my_\\\"callback\\\"\""));
+  EXPECT_NE(std::string::npos, content.find("\"name\":\"publish /topic\""));
+  EXPECT_NE(std::string::npos, content.find("\"name\":\"take /topic\""));
+  EXPECT_EQ(2u, count(content, "\"ph\":\"B\""));
+  EXPECT_EQ(2u, count(content, "\"ph\":\"E\""));
+  EXPECT_EQ(2u, count(content, "\"ph\":\"i\""));
+  // The take was recorded by another thread
+  EXPECT_NE(std::string::npos, content.find("\"tid\":1"));
+}
+
+TEST_F(TestTraceRecorder, oldest_events_overwritten) {
+  trace_recorder::enable(2u);
+  int entity = 0;
+  RCLCPP_TRACE_RECORD(Publish, &entity, "first");
+  RCLCPP_TRACE_RECORD(Publish, &entity, "second");
+  RCLCPP_TRACE_RECORD(Publish, &entity, "third");
+
+  const std::string content = dump_and_read();
+  EXPECT_EQ(std::string::npos, content.find("publish first"));
+  EXPECT_NE(std::string::npos, content.find("publish second"));
+  EXPECT_NE(std::string::npos, content.find("publish third"));
+}
+
+TEST_F(TestTraceRecorder, long_names_truncated) {
+  trace_recorder::enable();
+  int entity = 0;
+  const std::string name(100u, 'a');
+  RCLCPP_TRACE_RECORD(Publish, &entity, name.c_str());
+
+  const std::string content = dump_and_read();
+  EXPECT_NE(std::string::npos, content.find(name.substr(0u, 46u)));
+  EXPECT_EQ(std::string::npos, content.find(name.substr(0u, 47u)));
+}
+
+TEST_F(TestTraceRecorder, clear) {
+  trace_recorder::enable();
+  int entity = 0;
+  RCLCPP_TRACE_RECORD(Publish, &entity, "/topic");
+  trace_recorder::clear();
+  EXPECT_EQ(std::string::npos, dump_and_read().find("/topic"));
+
+  // The thread records again after clearing
+  RCLCPP_TRACE_RECORD(Publish, &entity, "/other_topic");
+  EXPECT_NE(std::string::npos, dump_and_read().find("/other_topic"));
+}
+
+TEST_F(TestTraceRecorder, invalid_path) {
+  EXPECT_THROW(trace_recorder::dump("/nonexistent_directory/trace.json"), std::runtime_error);
+}
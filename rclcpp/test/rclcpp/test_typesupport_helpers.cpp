@@ -75,3 +75,26 @@ TEST(TypesupportHelpersTest, returns_c_type_info_for_valid_library) {
     FAIL() << e.what();
   }
 }
+
+TEST(TypesupportHelpersTest, caches_libraries_and_handles) {
+  try {
+    auto library = rclcpp::get_typesupport_library(
+      "test_msgs/msg/BasicTypes", "rosidl_typesupport_cpp");
+    // The libraries are loaded once for each package
+    EXPECT_EQ(
+      library,
+      rclcpp::get_typesupport_library("test_msgs/msg/Strings", "rosidl_typesupport_cpp"));
+
+    auto basic_types_typesupport = rclcpp::get_typesupport_handle(
+      "test_msgs/msg/BasicTypes", "rosidl_typesupport_cpp", *library);
+    auto strings_typesupport = rclcpp::get_typesupport_handle(
+      "test_msgs/msg/Strings", "rosidl_typesupport_cpp", *library);
+    EXPECT_NE(basic_types_typesupport, strings_typesupport);
+    EXPECT_EQ(
+      basic_types_typesupport,
+      rclcpp::get_typesupport_handle(
+        "test_msgs/msg/BasicTypes", "rosidl_typesupport_cpp", *library));
+  } catch (const std::runtime_error & e) {
+    FAIL() << e.what();
+  }
+}
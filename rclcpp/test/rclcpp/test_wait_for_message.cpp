@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -107,3 +108,37 @@ TEST(TestUtilities, wait_for_message_twice_one_sub) {
 
   rclcpp::shutdown();
 }
+
+TEST(TestUtilities, message_sampler) {
+  rclcpp::init(0, nullptr);
+
+  auto node = std::make_shared<rclcpp::Node>("wait_for_message_node4");
+
+  using MsgT = test_msgs::msg::Strings;
+  auto pub = node->create_publisher<MsgT>("wait_for_message_topic", 10);
+  rclcpp::MessageSampler<MsgT> sampler(node, "wait_for_message_topic");
+  ASSERT_NE(nullptr, sampler.get_subscription());
+
+  std::atomic<size_t> number_of_received{0};
+  auto wait = std::async(
+    [&]() {
+      for (size_t i = 0; i < 3u; ++i) {
+        MsgT out;
+        ASSERT_TRUE(sampler.wait_for_next(out, 5s));
+        EXPECT_EQ(out, *get_messages_strings()[0]);
+        ++number_of_received;
+      }
+    });
+
+  for (auto i = 0u; i < 30 && number_of_received < 3u; ++i) {
+    pub->publish(*get_messages_strings()[0]);
+    std::this_thread::sleep_for(100ms);
+  }
+  ASSERT_NO_THROW(wait.get());
+  EXPECT_EQ(3u, number_of_received);
+
+  // Nothing is received once the context is shut down
+  rclcpp::shutdown();
+  MsgT out;
+  EXPECT_FALSE(sampler.wait_for_next(out, 1s));
+}
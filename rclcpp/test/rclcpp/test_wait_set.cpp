@@ -359,3 +359,54 @@ TEST_F(TestWaitSet, get_result_from_wait_result_not_ready_error) {
     const_result.get_wait_set(),
     std::runtime_error("cannot access wait set when the result was not ready"));
 }
+
+/*
+ * Get the ready entities from the result, only the triggered ones are listed.
+ */
+TEST_F(TestWaitSet, get_ready_entities_from_wait_result) {
+  auto triggered_guard_condition = std::make_shared<rclcpp::GuardCondition>();
+  auto guard_condition = std::make_shared<rclcpp::GuardCondition>();
+  rclcpp::WaitSet wait_set({}, {guard_condition, triggered_guard_condition});
+  triggered_guard_condition->trigger();
+
+  {
+    auto result = wait_set.wait();
+    ASSERT_EQ(rclcpp::WaitResultKind::Ready, result.kind());
+    const auto & ready_entities = result.get_ready_entities();
+    ASSERT_EQ(1u, ready_entities.guard_conditions.size());
+    EXPECT_EQ(triggered_guard_condition, ready_entities.guard_conditions[0]);
+    EXPECT_TRUE(ready_entities.subscriptions.empty());
+    EXPECT_TRUE(ready_entities.timers.empty());
+    // They are computed once per wait
+    EXPECT_EQ(&ready_entities, &result.get_ready_entities());
+  }
+
+  guard_condition->trigger();
+  {
+    auto result = wait_set.wait();
+    ASSERT_EQ(rclcpp::WaitResultKind::Ready, result.kind());
+    const auto & ready_entities = result.get_ready_entities();
+    ASSERT_EQ(1u, ready_entities.guard_conditions.size());
+    EXPECT_EQ(guard_condition, ready_entities.guard_conditions[0]);
+  }
+
+  auto result = wait_set.wait(std::chrono::milliseconds(10));
+  ASSERT_EQ(rclcpp::WaitResultKind::Timeout, result.kind());
+  RCLCPP_EXPECT_THROW_EQ(
+    result.get_ready_entities(),
+    std::runtime_error("cannot access wait set when the result was not ready"));
+}
+
+TEST_F(TestWaitSet, get_ready_entities_from_static_wait_set) {
+  auto guard_condition = std::make_shared<rclcpp::GuardCondition>();
+  auto node = std::make_shared<rclcpp::Node>("get_ready_entities_from_static_wait_set");
+  auto timer = node->create_wall_timer(std::chrono::milliseconds(1), []() {});
+  rclcpp::StaticWaitSet<0, 1, 1, 0, 0, 0> wait_set({}, {{guard_condition}}, {{timer}});
+
+  auto result = wait_set.wait();
+  ASSERT_EQ(rclcpp::WaitResultKind::Ready, result.kind());
+  const auto & ready_entities = result.get_ready_entities();
+  EXPECT_TRUE(ready_entities.guard_conditions.empty());
+  ASSERT_EQ(1u, ready_entities.timers.size());
+  EXPECT_EQ(timer, ready_entities.timers[0]);
+}
@@ -0,0 +1,198 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "libstatistics_collector/moving_average_statistics/types.hpp"
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/topic_statistics/publisher_topic_statistics.hpp"
+
+#include "statistics_msgs/msg/metrics_message.hpp"
+
+#include "test_msgs/msg/empty.hpp"
+
+#include "test_topic_stats_utils.hpp"
+
+namespace
+{
+constexpr const char kTestPubNodeName[]{"test_pub_stats_node"};
+constexpr const char kTestPubStatsTopic[]{"/test_pub_stats_topic"};
+constexpr const char kTestTopicStatisticsTopic[]{"/test_pub_topic_statistics_topic"};
+constexpr const std::chrono::seconds kTestTimeout{10};
+constexpr const uint64_t kNumExpectedMessages{12};
+}  // namespace
+
+using rclcpp::topic_statistics::PublisherTopicStatistics;
+using statistics_msgs::msg::MetricsMessage;
+using test_msgs::msg::Empty;
+using libstatistics_collector::moving_average_statistics::StatisticData;
+
+/**
+ * Wrapper class to test and expose parts of the PublisherTopicStatistics class.
+ */
+class TestPublisherTopicStatistics : public PublisherTopicStatistics
+{
+public:
+  using PublisherTopicStatistics::PublisherTopicStatistics;
+
+  std::vector<StatisticData> get_current_collector_data() const
+  {
+    return PublisherTopicStatistics::get_current_collector_data();
+  }
+};
+
+/**
+ * Test fixture to bring up and teardown rclcpp
+ */
+class TestPublisherTopicStatisticsFixture : public ::testing::Test
+{
+protected:
+  void SetUp()
+  {
+    rclcpp::init(0 /* argc */, nullptr /* argv */);
+  }
+
+  void TearDown()
+  {
+    rclcpp::shutdown();
+  }
+};
+
+TEST_F(TestPublisherTopicStatisticsFixture, test_manual_construction)
+{
+  auto node = std::make_shared<rclcpp::Node>(kTestPubNodeName);
+  auto statistics_publisher = node->create_publisher<MetricsMessage>(
+    kTestTopicStatisticsTopic, 10);
+
+  auto publisher_topic_statistics = std::make_shared<TestPublisherTopicStatistics>(
+    node->get_name(), statistics_publisher);
+
+  const auto collected_data = publisher_topic_statistics->get_current_collector_data();
+  ASSERT_EQ(5u, collected_data.size());
+  for (const auto & data : collected_data) {
+    EXPECT_EQ(0u, data.sample_count);
+  }
+
+  EXPECT_THROW(
+    PublisherTopicStatistics(node->get_name(), nullptr), std::invalid_argument);
+}
+
+TEST_F(TestPublisherTopicStatisticsFixture, test_measurements)
+{
+  auto node = std::make_shared<rclcpp::Node>(kTestPubNodeName);
+  auto statistics_publisher = node->create_publisher<MetricsMessage>(
+    kTestTopicStatisticsTopic, 10);
+
+  auto publisher_topic_statistics = std::make_shared<TestPublisherTopicStatistics>(
+    node->get_name(), statistics_publisher);
+
+  const auto start = std::chrono::steady_clock::now();
+  publisher_topic_statistics->handle_publish(start, std::chrono::milliseconds(2));
+  publisher_topic_statistics->handle_inter_process_publish(100u);
+  publisher_topic_statistics->handle_publish(
+    start + std::chrono::milliseconds(10), std::chrono::milliseconds(4));
+  publisher_topic_statistics->handle_intra_process_publish();
+  publisher_topic_statistics->handle_inter_process_publish();
+
+  const auto collected_data = publisher_topic_statistics->get_current_collector_data();
+  ASSERT_EQ(5u, collected_data.size());
+
+  // The period is only known from the second publication
+  const auto & publish_period = collected_data[0];
+  EXPECT_EQ(1u, publish_period.sample_count);
+  EXPECT_DOUBLE_EQ(10.0, publish_period.average);
+
+  const auto & publish_duration = collected_data[1];
+  EXPECT_EQ(2u, publish_duration.sample_count);
+  EXPECT_DOUBLE_EQ(3.0, publish_duration.average);
+  EXPECT_DOUBLE_EQ(2.0, publish_duration.min);
+  EXPECT_DOUBLE_EQ(4.0, publish_duration.max);
+
+  // The size of the messages is only known when it isn't 0
+  const auto & published_message_size = collected_data[2];
+  EXPECT_EQ(1u, published_message_size.sample_count);
+  EXPECT_DOUBLE_EQ(100.0, published_message_size.average);
+
+  EXPECT_EQ(1u, collected_data[3].sample_count);
+  EXPECT_EQ(2u, collected_data[4].sample_count);
+
+  publisher_topic_statistics->publish_message_and_reset_measurements();
+  for (const auto & data : publisher_topic_statistics->get_current_collector_data()) {
+    EXPECT_EQ(0u, data.sample_count);
+  }
+}
+
+TEST_F(TestPublisherTopicStatisticsFixture, test_invalid_publish_period)
+{
+  auto node = std::make_shared<rclcpp::Node>(kTestPubNodeName);
+
+  auto options = rclcpp::PublisherOptions();
+  options.topic_stats_options.state = rclcpp::TopicStatisticsState::Enable;
+  options.topic_stats_options.publish_period = std::chrono::milliseconds(0);
+
+  EXPECT_THROW(
+    node->create_publisher<Empty>(kTestPubStatsTopic, 10, options), std::invalid_argument);
+}
+
+TEST_F(TestPublisherTopicStatisticsFixture, test_receive_publisher_and_latency_statistics)
+{
+  auto node = std::make_shared<rclcpp::Node>(kTestPubNodeName);
+
+  auto publisher_options = rclcpp::PublisherOptions();
+  publisher_options.topic_stats_options.state = rclcpp::TopicStatisticsState::Enable;
+  publisher_options.topic_stats_options.publish_topic = kTestTopicStatisticsTopic;
+  publisher_options.topic_stats_options.publish_period = std::chrono::milliseconds(100);
+  auto publisher = node->create_publisher<Empty>(kTestPubStatsTopic, 10, publisher_options);
+
+  auto subscription_options = rclcpp::SubscriptionOptions();
+  subscription_options.topic_stats_options.state = rclcpp::TopicStatisticsState::Enable;
+  subscription_options.topic_stats_options.publish_topic = kTestTopicStatisticsTopic;
+  subscription_options.topic_stats_options.publish_period = std::chrono::milliseconds(100);
+  subscription_options.topic_stats_options.publish_message_latency = true;
+  auto subscription = node->create_subscription<Empty>(
+    kTestPubStatsTopic, 10, [](Empty::UniquePtr) {}, subscription_options);
+
+  auto statistics_listener = std::make_shared<rclcpp::topic_statistics::MetricsMessageSubscriber>(
+    "test_receive_publisher_statistics_listener",
+    kTestTopicStatisticsTopic,
+    kNumExpectedMessages);
+
+  auto publish_timer = node->create_wall_timer(
+    std::chrono::milliseconds(10), [publisher]() {publisher->publish(Empty());});
+
+  rclcpp::executors::SingleThreadedExecutor ex;
+  ex.add_node(node);
+  ex.add_node(statistics_listener);
+
+  ex.spin_until_future_complete(statistics_listener->GetFuture(), kTestTimeout);
+
+  std::set<std::string> received_metrics;
+  for (const auto & msg : statistics_listener->GetReceivedMessages()) {
+    received_metrics.insert(msg.metrics_source);
+  }
+  EXPECT_EQ(1u, received_metrics.count(rclcpp::topic_statistics::kPublishPeriodStatName));
+  EXPECT_EQ(1u, received_metrics.count(rclcpp::topic_statistics::kPublishDurationStatName));
+  EXPECT_EQ(
+    1u, received_metrics.count(rclcpp::topic_statistics::kPublishedMessageSizeStatName));
+  EXPECT_EQ(1u, received_metrics.count(rclcpp::topic_statistics::kIntraProcessPublishStatName));
+  EXPECT_EQ(1u, received_metrics.count(rclcpp::topic_statistics::kInterProcessPublishStatName));
+  EXPECT_EQ(1u, received_metrics.count(rclcpp::topic_statistics::kMessageLatencyStatName));
+}
@@ -22,6 +22,7 @@
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "libstatistics_collector/moving_average_statistics/types.hpp"
@@ -33,6 +34,8 @@
 #include "rclcpp/rclcpp.hpp"
 #include "rclcpp/subscription_options.hpp"
 
+#include "rclcpp/topic_statistics/percentile_histogram.hpp"
+#include "rclcpp/topic_statistics/statistics_accumulator.hpp"
 #include "rclcpp/topic_statistics/subscription_topic_statistics.hpp"
 
 #include "statistics_msgs/msg/metrics_message.hpp"
@@ -345,6 +348,115 @@ void check_if_statistic_message_is_populated(const MetricsMessage & message_to_c
   }
 }
 
+/**
+ * Test the statistics accumulated by concurrent threads and reset when they are taken.
+ */
+TEST(TestSubscriptionTopicStatistics, test_statistics_accumulator)
+{
+  rclcpp::topic_statistics::StatisticsAccumulator accumulator;
+  EXPECT_TRUE(std::isnan(accumulator.get_statistics().average));
+  EXPECT_EQ(kNoSamples, accumulator.get_statistics().sample_count);
+
+  accumulator.add_sample(1.);
+  accumulator.add_sample(3.);
+  auto statistics = accumulator.get_statistics();
+  EXPECT_DOUBLE_EQ(2., statistics.average);
+  EXPECT_DOUBLE_EQ(1., statistics.min);
+  EXPECT_DOUBLE_EQ(3., statistics.max);
+  EXPECT_DOUBLE_EQ(1., statistics.standard_deviation);
+  EXPECT_EQ(2u, statistics.sample_count);
+
+  statistics = accumulator.take_statistics();
+  EXPECT_EQ(2u, statistics.sample_count);
+  EXPECT_EQ(kNoSamples, accumulator.get_statistics().sample_count);
+
+  constexpr uint64_t kNumThreads = 4;
+  constexpr uint64_t kNumSamplesPerThread = 10000;
+  std::atomic<bool> done{false};
+  uint64_t taken_sample_count = 0;
+  std::thread taker(
+    [&]() {
+      while (!done.load()) {
+        taken_sample_count += accumulator.take_statistics().sample_count;
+      }
+    });
+  std::vector<std::thread> threads;
+  for (uint64_t i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back(
+      [&accumulator]() {
+        for (uint64_t j = 0; j < kNumSamplesPerThread; ++j) {
+          accumulator.add_sample(5.);
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  done.store(true);
+  taker.join();
+  statistics = accumulator.take_statistics();
+  EXPECT_EQ(kNumThreads * kNumSamplesPerThread, taken_sample_count + statistics.sample_count);
+  if (statistics.sample_count > 0u) {
+    EXPECT_DOUBLE_EQ(5., statistics.average);
+    EXPECT_DOUBLE_EQ(0., statistics.standard_deviation);
+  }
+}
+
+/**
+ * Test the percentiles of the samples, known within the width of their buckets.
+ */
+TEST(TestSubscriptionTopicStatistics, test_percentiles)
+{
+  rclcpp::topic_statistics::PercentileHistogram histogram;
+  EXPECT_TRUE(std::isnan(histogram.get_percentile(50.)));
+
+  // The samples from 1 to 1000, with an outlier
+  for (int i = 1; i <= 1000; ++i) {
+    histogram.add_sample(static_cast<double>(i));
+  }
+  histogram.add_sample(1e9);
+  EXPECT_EQ(1001u, histogram.get_sample_count());
+  const auto percentiles = histogram.get_percentiles();
+  constexpr double kRelativeError = 1. / 32.;
+  EXPECT_NEAR(501., percentiles.p50, 501. * kRelativeError);
+  EXPECT_NEAR(901., percentiles.p90, 901. * kRelativeError);
+  EXPECT_NEAR(991., percentiles.p99, 991. * kRelativeError);
+  EXPECT_NEAR(1000., percentiles.p999, 1000. * kRelativeError);
+  EXPECT_LT(1e6, histogram.get_percentile(100.));
+  EXPECT_NEAR(1., histogram.get_percentile(0.), kRelativeError);
+
+  histogram.add_sample(-1.);
+  EXPECT_EQ(0., histogram.get_percentile(0.));
+  histogram.clear();
+  EXPECT_EQ(0u, histogram.get_sample_count());
+  EXPECT_TRUE(std::isnan(histogram.get_percentiles().p99));
+
+  // The percentiles of an accumulator are clamped to the range of the samples
+  rclcpp::topic_statistics::StatisticsAccumulator accumulator(true);
+  EXPECT_TRUE(accumulator.collects_percentiles());
+  accumulator.add_sample(3.);
+  rclcpp::topic_statistics::PercentileStatistics taken_percentiles;
+  EXPECT_EQ(1u, accumulator.take_statistics(taken_percentiles).sample_count);
+  EXPECT_DOUBLE_EQ(3., taken_percentiles.p50);
+  EXPECT_DOUBLE_EQ(3., taken_percentiles.p999);
+  accumulator.take_statistics(taken_percentiles);
+  EXPECT_TRUE(std::isnan(taken_percentiles.p50));
+
+  EXPECT_FALSE(rclcpp::topic_statistics::StatisticsAccumulator().collects_percentiles());
+
+  statistics_msgs::msg::MetricsMessage message;
+  rclcpp::topic_statistics::add_percentiles_to_message(message, taken_percentiles);
+  EXPECT_TRUE(message.statistics.empty());
+  rclcpp::topic_statistics::add_percentiles_to_message(message, percentiles);
+  ASSERT_EQ(4u, message.statistics.size());
+  EXPECT_EQ(rclcpp::topic_statistics::kStatisticsDataTypePercentile50,
+    message.statistics[0].data_type);
+  EXPECT_DOUBLE_EQ(percentiles.p50, message.statistics[0].data);
+  EXPECT_EQ(rclcpp::topic_statistics::kStatisticsDataTypePercentile999,
+    message.statistics[3].data_type);
+  EXPECT_DOUBLE_EQ(percentiles.p999, message.statistics[3].data);
+}
+
 /**
  * Test an invalid argument is thrown for a bad input publish period.
  */
@@ -300,3 +300,85 @@ TEST_F(TestDynamicStorage, wait_waitable) {
     EXPECT_EQ(rclcpp::WaitResultKind::Empty, wait_result.kind());
   }
 }
+
+TEST_F(TestDynamicStorage, reuse_slots) {
+  rclcpp::WaitSet wait_set;
+
+  auto guard_condition1 = std::make_shared<rclcpp::GuardCondition>();
+  auto guard_condition2 = std::make_shared<rclcpp::GuardCondition>();
+  auto guard_condition3 = std::make_shared<rclcpp::GuardCondition>();
+  wait_set.add_guard_condition(guard_condition1);
+  wait_set.add_guard_condition(guard_condition2);
+  EXPECT_EQ(guard_condition1, wait_set.get_guard_condition(0));
+  EXPECT_EQ(guard_condition2, wait_set.get_guard_condition(1));
+
+  // The slot of the removed guard condition is reused.
+  wait_set.remove_guard_condition(guard_condition1);
+  EXPECT_EQ(nullptr, wait_set.get_guard_condition(0));
+  wait_set.add_guard_condition(guard_condition3);
+  EXPECT_EQ(guard_condition3, wait_set.get_guard_condition(0));
+  EXPECT_EQ(guard_condition2, wait_set.get_guard_condition(1));
+  EXPECT_THROW(wait_set.get_guard_condition(2), std::out_of_range);
+
+  RCLCPP_EXPECT_THROW_EQ(
+    wait_set.remove_guard_condition(guard_condition1),
+    std::runtime_error("guard_condition not in wait set"));
+
+  // Removing all of them releases the slots, so the wait set is empty.
+  wait_set.remove_guard_condition(guard_condition2);
+  wait_set.remove_guard_condition(guard_condition3);
+  EXPECT_EQ(rclcpp::WaitResultKind::Empty, wait_set.wait().kind());
+}
+
+TEST_F(TestDynamicStorage, prune_reused_slots) {
+  rclcpp::WaitSet wait_set;
+
+  auto guard_condition = std::make_shared<rclcpp::GuardCondition>();
+  auto timer = node->create_wall_timer(std::chrono::seconds(100), []() {});
+  wait_set.add_guard_condition(guard_condition);
+  wait_set.add_timer(timer);
+  {
+    auto deleted_guard_condition = std::make_shared<rclcpp::GuardCondition>();
+    wait_set.add_guard_condition(deleted_guard_condition);
+  }
+  wait_set.prune_deleted_entities();
+  EXPECT_EQ(guard_condition, wait_set.get_guard_condition(0));
+  EXPECT_EQ(nullptr, wait_set.get_guard_condition(1));
+
+  timer.reset();
+  wait_set.prune_deleted_entities();
+  EXPECT_THROW(wait_set.get_timer(0), std::out_of_range);
+}
+
+TEST_F(TestDynamicStorage, ready_indices) {
+  rclcpp::WaitSet wait_set;
+
+  auto guard_condition1 = std::make_shared<rclcpp::GuardCondition>();
+  auto guard_condition2 = std::make_shared<rclcpp::GuardCondition>();
+  auto guard_condition3 = std::make_shared<rclcpp::GuardCondition>();
+  auto waitable1 = std::make_shared<TestWaitable>();
+  auto waitable2 = std::make_shared<TestWaitable>();
+  wait_set.add_guard_condition(guard_condition1);
+  wait_set.add_guard_condition(guard_condition2);
+  wait_set.add_guard_condition(guard_condition3);
+  wait_set.add_waitable(waitable1);
+  wait_set.add_waitable(waitable2);
+  // The ready indices are the slots, which don't change when other entities are removed.
+  wait_set.remove_guard_condition(guard_condition1);
+
+  guard_condition3->trigger();
+  waitable2->set_is_ready(true);
+  {
+    auto wait_result = wait_set.wait(std::chrono::seconds(-1));
+    ASSERT_EQ(rclcpp::WaitResultKind::Ready, wait_result.kind());
+    const auto & ready_indices = wait_set.get_ready_indices();
+    EXPECT_EQ(std::vector<size_t>{2}, ready_indices.guard_conditions);
+    EXPECT_EQ(std::vector<size_t>{1}, ready_indices.waitables);
+    EXPECT_TRUE(ready_indices.subscriptions.empty());
+    EXPECT_TRUE(ready_indices.timers.empty());
+    EXPECT_TRUE(ready_indices.clients.empty());
+    EXPECT_TRUE(ready_indices.services.empty());
+    EXPECT_EQ(guard_condition3, wait_set.get_guard_condition(ready_indices.guard_conditions[0]));
+    EXPECT_EQ(waitable2, wait_set.get_waitable(ready_indices.waitables[0]));
+  }
+}
@@ -14,7 +14,10 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <future>
 #include <memory>
+#include <thread>
 #include <vector>
 
 #include "rclcpp/rclcpp.hpp"
@@ -304,3 +307,34 @@ TEST_F(TestThreadSafeStorage, wait_waitable) {
     EXPECT_EQ(rclcpp::WaitResultKind::Timeout, wait_result.kind());
   }
 }
+
+TEST_F(TestThreadSafeStorage, batched_modifications) {
+  rclcpp::ThreadSafeWaitSet wait_set;
+  EXPECT_EQ(std::chrono::nanoseconds(0), wait_set.get_max_modification_delay());
+  RCLCPP_EXPECT_THROW_EQ(
+    wait_set.set_max_modification_delay(std::chrono::nanoseconds(-1)),
+    std::invalid_argument("the maximum modification delay can't be negative"));
+
+  wait_set.set_max_modification_delay(std::chrono::milliseconds(50));
+  EXPECT_EQ(std::chrono::milliseconds(50), wait_set.get_max_modification_delay());
+  wait_set.add_guard_condition(std::make_shared<rclcpp::GuardCondition>());
+  {
+    // Waking up to apply the modifications isn't a timeout
+    auto wait_result = wait_set.wait(std::chrono::milliseconds(120));
+    EXPECT_EQ(rclcpp::WaitResultKind::Timeout, wait_result.kind());
+  }
+
+  // The guard condition added while waiting is waited on after the delay at most
+  auto future = std::async(
+    std::launch::async, [&wait_set]() {
+      return wait_set.wait(std::chrono::seconds(5)).kind();
+    });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  auto guard_condition = std::make_shared<rclcpp::GuardCondition>();
+  guard_condition->trigger();
+  const auto start = std::chrono::steady_clock::now();
+  wait_set.add_guard_condition(guard_condition);
+  ASSERT_EQ(std::future_status::ready, future.wait_for(std::chrono::seconds(4)));
+  EXPECT_EQ(rclcpp::WaitResultKind::Ready, future.get());
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
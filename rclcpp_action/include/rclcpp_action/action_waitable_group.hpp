@@ -0,0 +1,194 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP_ACTION__ACTION_WAITABLE_GROUP_HPP_
+#define RCLCPP_ACTION__ACTION_WAITABLE_GROUP_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "rclcpp/context.hpp"
+#include "rclcpp/guard_condition.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/timer.hpp"
+#include "rclcpp/waitable.hpp"
+
+#include "rclcpp_action/client.hpp"
+#include "rclcpp_action/server.hpp"
+#include "rclcpp_action/visibility_control.hpp"
+
+namespace rclcpp_action
+{
+
+/// Waitable grouping action servers and clients, so that they are waited on together.
+/**
+ * Instead of adding the services, clients, subscriptions and timers of each action
+ * to the wait set, the group only adds one guard condition and one timer.
+ * The entities of its actions report their events with their on ready callbacks,
+ * which the group sets, and it executes these events one at a time, in order.
+ * Its timer periodically expires the goals of its servers and publishes their
+ * delayed status changes, which are then handled at most one period later.
+ *
+ * The actions of a group mustn't be waited on anymore by themselves, so they have to be
+ * removed from their callback group, and the group added instead, for example:
+ *
+ * ```cpp
+ * auto group = std::make_shared<rclcpp_action::ActionWaitableGroup>(node->get_context());
+ * auto server = rclcpp_action::create_server<ActionT>(node, "action", ...);
+ * node->get_node_waitables_interface()->remove_waitable(server, nullptr);
+ * group->add(server);
+ * node->get_node_waitables_interface()->add_waitable(group, nullptr);
+ * ```
+ *
+ * The group uses the on ready callbacks of its actions, so it can't be used with an
+ * executor calling them, and it has no on ready callback itself.
+ * Adding and removing actions is thread-safe.
+ */
+class ActionWaitableGroup : public rclcpp::Waitable
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(ActionWaitableGroup)
+
+  /// Constructor.
+  /**
+   * \param[in] context context of the actions.
+   * \param[in] timer_period period at which the goals of the servers are expired
+   *   and their delayed statuses published.
+   * \throws std::invalid_argument if the timer period isn't positive.
+   */
+  RCLCPP_ACTION_PUBLIC
+  explicit ActionWaitableGroup(
+    rclcpp::Context::SharedPtr context,
+    std::chrono::nanoseconds timer_period = std::chrono::seconds(1));
+
+  RCLCPP_ACTION_PUBLIC
+  ~ActionWaitableGroup() override;
+
+  /// Add an action server to the group, which keeps it alive until it's removed.
+  RCLCPP_ACTION_PUBLIC
+  void
+  add(std::shared_ptr<ServerBase> server);
+
+  /// Add an action client to the group, which keeps it alive until it's removed.
+  RCLCPP_ACTION_PUBLIC
+  void
+  add(std::shared_ptr<ClientBase> client);
+
+  /// Remove an action server or client from the group, discarding its pending events.
+  /**
+   * \return true if the action was in the group.
+   */
+  RCLCPP_ACTION_PUBLIC
+  bool
+  remove(const rclcpp::Waitable::SharedPtr & action);
+
+  /// Return the number of actions in the group.
+  RCLCPP_ACTION_PUBLIC
+  size_t
+  size() const;
+
+  // -------------
+  // Waitables API
+
+  /// \internal
+  RCLCPP_ACTION_PUBLIC
+  size_t
+  get_number_of_ready_timers() override;
+
+  /// \internal
+  RCLCPP_ACTION_PUBLIC
+  size_t
+  get_number_of_ready_guard_conditions() override;
+
+  /// Add the guard condition and the timer of the group to a wait set.
+  /// \internal
+  RCLCPP_ACTION_PUBLIC
+  void
+  add_to_wait_set(rcl_wait_set_t * wait_set) override;
+
+  /// Return true if an action of the group has an event, or if the timer is ready.
+  /// \internal
+  RCLCPP_ACTION_PUBLIC
+  bool
+  is_ready(rcl_wait_set_t * wait_set) override;
+
+  /// Take the data of the oldest event of the actions.
+  /// \internal
+  RCLCPP_ACTION_PUBLIC
+  std::shared_ptr<void>
+  take_data() override;
+
+  /// \internal
+  RCLCPP_ACTION_PUBLIC
+  std::shared_ptr<void>
+  take_data_by_entity_id(size_t id) override;
+
+  /// Execute the event taken by take_data() with the action it belongs to.
+  /// \internal
+  RCLCPP_ACTION_PUBLIC
+  void
+  execute(std::shared_ptr<void> & data) override;
+
+  // End Waitables API
+  // -----------------
+
+private:
+  RCLCPP_DISABLE_COPY(ActionWaitableGroup)
+
+  struct Member
+  {
+    rclcpp::Waitable::SharedPtr waitable;
+    // Set for the servers, which the timer of the group is executed for
+    std::shared_ptr<ServerBase> server;
+  };
+
+  // Events of an entity of an action, in the order they were reported
+  struct ReadyEntity
+  {
+    uint64_t member_id;
+    int entity_type;
+    size_t number_of_events;
+  };
+
+  struct TakenData
+  {
+    rclcpp::Waitable::SharedPtr waitable;
+    std::shared_ptr<void> data;
+  };
+
+  void
+  add_member(rclcpp::Waitable::SharedPtr waitable, std::shared_ptr<ServerBase> server);
+
+  void
+  on_ready(uint64_t member_id, size_t number_of_events, int entity_type);
+
+  rclcpp::GuardCondition gc_;
+  rclcpp::TimerBase::SharedPtr timer_;
+  size_t timer_index_ = 0;
+  std::atomic<bool> timer_ready_{false};
+
+  mutable std::mutex mutex_;
+  std::unordered_map<uint64_t, Member> members_;
+  uint64_t next_member_id_ = 0;
+  std::deque<ReadyEntity> ready_entities_;
+};
+
+}  // namespace rclcpp_action
+
+#endif  // RCLCPP_ACTION__ACTION_WAITABLE_GROUP_HPP_
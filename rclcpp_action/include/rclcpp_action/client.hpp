@@ -19,7 +19,6 @@
 #include <chrono>
 #include <functional>
 #include <future>
-#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -28,6 +27,8 @@
 
 #include "rcl/event_callback.h"
 
+#include "rclcpp/detail/future_waiters.hpp"
+#include "rclcpp/detail/shared_message_pool.hpp"
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/node_interfaces/node_base_interface.hpp"
@@ -180,6 +181,33 @@ public:
   // End Waitables API
   // -----------------
 
+  /// Send the goals to the intra-process action server of the context, when there is one.
+  /**
+   * The goal, cancel and result requests are then handed over to the server as
+   * shared pointers, and the responses and the feedback of the goals come back
+   * through the waitable returned by get_intra_process_waitable(), which has to be
+   * added to the callback group of the client.
+   * The statuses are still received from the middleware, and so is the
+   * availability of the server.
+   *
+   * This is done by rclcpp_action::create_client() when the node uses
+   * intra-process communications.
+   *
+   * \param[in] self shared pointer to this client, the responses aren't handled anymore
+   *   once it is destroyed.
+   * \param[in] node_base node of the client, to resolve the name of the action.
+   */
+  RCLCPP_ACTION_PUBLIC
+  void
+  setup_intra_process(
+    const std::shared_ptr<ClientBase> & self,
+    rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base);
+
+  /// Return the waitable handling the intra-process responses, or nullptr if not set up.
+  RCLCPP_ACTION_PUBLIC
+  rclcpp::Waitable::SharedPtr
+  get_intra_process_waitable() const;
+
 protected:
   RCLCPP_ACTION_PUBLIC
   ClientBase(
@@ -312,6 +340,12 @@ protected:
 private:
   std::unique_ptr<ClientBaseImpl> pimpl_;
 
+  /// Dispatch a response or feedback pushed to the intra-process queue of the client
+  void
+  handle_intra_process_message(
+    const rmw_request_id_t & response_header,
+    std::shared_ptr<void> data);
+
   /// Set a std::function callback to be called when the specified entity is ready
   RCLCPP_ACTION_PUBLIC
   void
@@ -358,7 +392,8 @@ public:
     SendGoalOptions()
     : goal_response_callback(nullptr),
       feedback_callback(nullptr),
-      result_callback(nullptr)
+      result_callback(nullptr),
+      request_result_with_goal(false)
     {
     }
 
@@ -375,6 +410,17 @@ public:
 
     /// Function called when the result for the goal is received.
     ResultCallback result_callback;
+
+    /// Whether the result is requested right after the goal, without waiting for its response.
+    /**
+     * This saves the round trip of the result request once the goal is accepted, which
+     * matters for short goals.
+     * The result is then requested even without result callback, and async_get_result()
+     * doesn't request it again.
+     * If the server handles the result request before the goal one, it answers that the goal
+     * is unknown, and the result is requested again once the goal is accepted.
+     */
+    bool request_result_with_goal;
   };
 
   /// Construct an action client.
@@ -428,14 +474,20 @@ public:
     auto goal_request = std::make_shared<GoalRequest>();
     goal_request->goal_id.uuid = this->generate_goal_id();
     goal_request->goal = goal;
+    std::shared_ptr<PipelinedResult> pipelined_result;
+    if (options.request_result_with_goal) {
+      pipelined_result = std::make_shared<PipelinedResult>();
+    }
     this->send_goal_request(
       std::static_pointer_cast<void>(goal_request),
-      [this, goal_request, options, promise](std::shared_ptr<void> response) mutable
+      [this, goal_request, options, promise, pipelined_result](
+        std::shared_ptr<void> response) mutable
       {
         using GoalResponse = typename ActionT::Impl::SendGoalService::Response;
         auto goal_response = std::static_pointer_cast<GoalResponse>(response);
         if (!goal_response->accepted) {
           promise->set_value(nullptr);
+          rclcpp::detail::notify_future_waiters();
           if (options.goal_response_callback) {
             options.goal_response_callback(nullptr);
           }
@@ -447,19 +499,29 @@ public:
         // Do not use std::make_shared as friendship cannot be forwarded.
         std::shared_ptr<GoalHandle> goal_handle(
           new GoalHandle(goal_info, options.feedback_callback, options.result_callback));
+        if (pipelined_result) {
+          // The result was already requested, async_get_result() doesn't request it again.
+          goal_handle->set_result_awareness(true);
+        }
         {
           std::lock_guard<std::mutex> guard(goal_handles_mutex_);
           goal_handles_[goal_handle->get_goal_id()] = goal_handle;
         }
         promise->set_value(goal_handle);
+        rclcpp::detail::notify_future_waiters();
         if (options.goal_response_callback) {
           options.goal_response_callback(goal_handle);
         }
 
-        if (options.result_callback) {
+        if (pipelined_result) {
+          this->set_pipelined_goal_handle(*pipelined_result, goal_handle);
+        } else if (options.result_callback) {
           this->make_result_aware(goal_handle);
         }
       });
+    if (pipelined_result) {
+      this->send_pipelined_result_request(goal_request->goal_id.uuid, pipelined_result);
+    }
 
     // TODO(jacobperron): Encapsulate into it's own function and
     //                    consider exposing an option to disable this cleanup
@@ -629,8 +691,8 @@ private:
   std::shared_ptr<void>
   create_feedback_message() const override
   {
-    using FeedbackMessage = typename ActionT::Impl::FeedbackMessage;
-    return std::shared_ptr<void>(new FeedbackMessage());
+    // Taking the feedback overwrites all the fields of a reused message.
+    return feedback_message_pool_.borrow_message(false);
   }
 
   /// \internal
@@ -642,23 +704,24 @@ private:
     typename FeedbackMessage::SharedPtr feedback_message =
       std::static_pointer_cast<FeedbackMessage>(message);
     const GoalUUID & goal_id = feedback_message->goal_id.uuid;
-    if (goal_handles_.count(goal_id) == 0) {
+    auto it = goal_handles_.find(goal_id);
+    if (it == goal_handles_.end()) {
       RCLCPP_DEBUG(
         this->get_logger(),
         "Received feedback for unknown goal. Ignoring...");
       return;
     }
-    typename GoalHandle::SharedPtr goal_handle = goal_handles_[goal_id].lock();
+    typename GoalHandle::SharedPtr goal_handle = it->second.lock();
     // Forget about the goal if there are no more user references
     if (!goal_handle) {
       RCLCPP_DEBUG(
         this->get_logger(),
         "Dropping weak reference to goal handle during feedback callback");
-      goal_handles_.erase(goal_id);
+      goal_handles_.erase(it);
       return;
     }
-    auto feedback = std::make_shared<Feedback>();
-    *feedback = feedback_message->feedback;
+    // The feedback is given to the callback without being copied out of its message.
+    std::shared_ptr<const Feedback> feedback(feedback_message, &feedback_message->feedback);
     goal_handle->call_feedback_callback(goal_handle, feedback);
   }
 
@@ -677,21 +740,23 @@ private:
     std::lock_guard<std::mutex> guard(goal_handles_mutex_);
     using GoalStatusMessage = typename ActionT::Impl::GoalStatusMessage;
     auto status_message = std::static_pointer_cast<GoalStatusMessage>(message);
+    // The statuses of the goals of other clients are ignored
     for (const GoalStatus & status : status_message->status_list) {
+      if (goal_handles_.empty()) {
+        break;
+      }
       const GoalUUID & goal_id = status.goal_info.goal_id.uuid;
-      if (goal_handles_.count(goal_id) == 0) {
-        RCLCPP_DEBUG(
-          this->get_logger(),
-          "Received status for unknown goal. Ignoring...");
+      auto it = goal_handles_.find(goal_id);
+      if (it == goal_handles_.end()) {
         continue;
       }
-      typename GoalHandle::SharedPtr goal_handle = goal_handles_[goal_id].lock();
+      typename GoalHandle::SharedPtr goal_handle = it->second.lock();
       // Forget about the goal if there are no more user references
       if (!goal_handle) {
         RCLCPP_DEBUG(
           this->get_logger(),
           "Dropping weak reference to goal handle during status callback");
-        goal_handles_.erase(goal_id);
+        goal_handles_.erase(it);
         continue;
       }
       goal_handle->set_status(status.status);
@@ -706,6 +771,13 @@ private:
     if (goal_handle->set_result_awareness(true)) {
       return;
     }
+    send_goal_result_request(goal_handle);
+  }
+
+  /// \internal
+  void
+  send_goal_result_request(typename GoalHandle::SharedPtr goal_handle)
+  {
     using GoalResultRequest = typename ActionT::Impl::GetResultService::Request;
     auto goal_result_request = std::make_shared<GoalResultRequest>();
     goal_result_request->goal_id.uuid = goal_handle->get_goal_id();
@@ -714,17 +786,7 @@ private:
         std::static_pointer_cast<void>(goal_result_request),
         [goal_handle, this](std::shared_ptr<void> response) mutable
         {
-          // Wrap the response in a struct with the fields a user cares about
-          WrappedResult wrapped_result;
-          using GoalResultResponse = typename ActionT::Impl::GetResultService::Response;
-          auto result_response = std::static_pointer_cast<GoalResultResponse>(response);
-          wrapped_result.result = std::make_shared<typename ActionT::Result>();
-          *wrapped_result.result = result_response->result;
-          wrapped_result.goal_id = goal_handle->get_goal_id();
-          wrapped_result.code = static_cast<ResultCode>(result_response->status);
-          goal_handle->set_result(wrapped_result);
-          std::lock_guard<std::mutex> lock(goal_handles_mutex_);
-          goal_handles_.erase(goal_handle->get_goal_id());
+          set_goal_result(goal_handle, response);
         });
     } catch (rclcpp::exceptions::RCLError & ex) {
       // This will cause an exception when the user tries to access the result
@@ -732,6 +794,117 @@ private:
     }
   }
 
+  /// \internal
+  void
+  set_goal_result(
+    const typename GoalHandle::SharedPtr & goal_handle,
+    std::shared_ptr<void> response)
+  {
+    // Wrap the response in a struct with the fields a user cares about
+    WrappedResult wrapped_result;
+    using GoalResultResponse = typename ActionT::Impl::GetResultService::Response;
+    auto result_response = std::static_pointer_cast<GoalResultResponse>(response);
+    wrapped_result.result = std::make_shared<typename ActionT::Result>();
+    *wrapped_result.result = result_response->result;
+    wrapped_result.goal_id = goal_handle->get_goal_id();
+    wrapped_result.code = static_cast<ResultCode>(result_response->status);
+    goal_handle->set_result(wrapped_result);
+    std::lock_guard<std::mutex> lock(goal_handles_mutex_);
+    goal_handles_.erase(goal_handle->get_goal_id());
+  }
+
+  /// \internal
+  /// Result requested with its goal, whose response may be received before the goal one.
+  struct PipelinedResult
+  {
+    std::mutex mutex;
+    // Set once the goal is accepted, until the result response is received
+    typename GoalHandle::SharedPtr goal_handle;
+    // The result response received before the goal was accepted
+    std::shared_ptr<void> response;
+    // True if the result request couldn't be sent
+    bool failed = false;
+  };
+
+  /// \internal
+  void
+  send_pipelined_result_request(
+    const GoalUUID & goal_id,
+    const std::shared_ptr<PipelinedResult> & pipelined_result)
+  {
+    using GoalResultRequest = typename ActionT::Impl::GetResultService::Request;
+    auto goal_result_request = std::make_shared<GoalResultRequest>();
+    goal_result_request->goal_id.uuid = goal_id;
+    try {
+      this->send_result_request(
+        std::static_pointer_cast<void>(goal_result_request),
+        [pipelined_result, this](std::shared_ptr<void> response)
+        {
+          typename GoalHandle::SharedPtr goal_handle;
+          {
+            std::lock_guard<std::mutex> lock(pipelined_result->mutex);
+            if (!pipelined_result->goal_handle) {
+              // The goal response wasn't received yet, or the goal was rejected
+              pipelined_result->response = std::move(response);
+              return;
+            }
+            goal_handle = std::move(pipelined_result->goal_handle);
+          }
+          set_pipelined_result(goal_handle, std::move(response));
+        });
+    } catch (rclcpp::exceptions::RCLError &) {
+      typename GoalHandle::SharedPtr goal_handle;
+      {
+        std::lock_guard<std::mutex> lock(pipelined_result->mutex);
+        pipelined_result->failed = true;
+        goal_handle = std::move(pipelined_result->goal_handle);
+      }
+      // The goal was accepted in the meantime, so the result is requested as usual.
+      if (goal_handle) {
+        send_goal_result_request(goal_handle);
+      }
+    }
+  }
+
+  /// \internal
+  void
+  set_pipelined_goal_handle(
+    PipelinedResult & pipelined_result,
+    const typename GoalHandle::SharedPtr & goal_handle)
+  {
+    std::shared_ptr<void> response;
+    bool failed = false;
+    {
+      std::lock_guard<std::mutex> lock(pipelined_result.mutex);
+      response = std::move(pipelined_result.response);
+      failed = pipelined_result.failed;
+      if (!response && !failed) {
+        pipelined_result.goal_handle = goal_handle;
+      }
+    }
+    if (response) {
+      set_pipelined_result(goal_handle, std::move(response));
+    } else if (failed) {
+      send_goal_result_request(goal_handle);
+    }
+  }
+
+  /// \internal
+  void
+  set_pipelined_result(
+    const typename GoalHandle::SharedPtr & goal_handle,
+    std::shared_ptr<void> response)
+  {
+    using GoalResultResponse = typename ActionT::Impl::GetResultService::Response;
+    auto result_response = std::static_pointer_cast<GoalResultResponse>(response);
+    if (static_cast<ResultCode>(result_response->status) == ResultCode::UNKNOWN) {
+      // The server handled the result request before the goal one.
+      send_goal_result_request(goal_handle);
+      return;
+    }
+    set_goal_result(goal_handle, std::move(response));
+  }
+
   /// \internal
   std::shared_future<typename CancelResponse::SharedPtr>
   async_cancel(
@@ -747,6 +920,7 @@ private:
       {
         auto cancel_response = std::static_pointer_cast<CancelResponse>(response);
         promise->set_value(cancel_response);
+        rclcpp::detail::notify_future_waiters();
         if (cancel_callback) {
           cancel_callback(cancel_response);
         }
@@ -754,8 +928,12 @@ private:
     return future;
   }
 
-  std::map<GoalUUID, typename GoalHandle::WeakPtr> goal_handles_;
+  std::unordered_map<GoalUUID, typename GoalHandle::WeakPtr> goal_handles_;
   std::mutex goal_handles_mutex_;
+
+  /// Feedback messages reused once neither the client nor the feedback callbacks hold them.
+  mutable rclcpp::detail::SharedMessagePool<typename ActionT::Impl::FeedbackMessage>
+  feedback_message_pool_{8};
 };
 }  // namespace rclcpp_action
 
@@ -15,6 +15,7 @@
 #ifndef RCLCPP_ACTION__CLIENT_GOAL_HANDLE_HPP_
 #define RCLCPP_ACTION__CLIENT_GOAL_HANDLE_HPP_
 
+#include <atomic>
 #include <functional>
 #include <future>
 #include <memory>
@@ -91,14 +92,23 @@ public:
   get_goal_stamp() const;
 
   /// Get the goal status code.
+  /**
+   * It doesn't lock the goal handle, so that it can be polled often.
+   */
   int8_t
   get_status();
 
   /// Check if an action client has subscribed to feedback for the goal.
+  /**
+   * It doesn't lock the goal handle, so that it can be polled often.
+   */
   bool
   is_feedback_aware();
 
   /// Check if an action client has requested the result for the goal.
+  /**
+   * It doesn't lock the goal handle, so that it can be polled often.
+   */
   bool
   is_result_aware();
 
@@ -155,13 +165,17 @@ private:
 
   std::exception_ptr invalidate_exception_{nullptr};
 
-  bool is_result_aware_{false};
   std::promise<WrappedResult> result_promise_;
   std::shared_future<WrappedResult> result_future_;
 
   FeedbackCallback feedback_callback_{nullptr};
   ResultCallback result_callback_{nullptr};
-  int8_t status_{GoalStatus::STATUS_ACCEPTED};
+
+  // Written while holding handle_mutex_, to keep their order with the callbacks and the
+  // result promise, but read without it.
+  std::atomic<bool> is_result_aware_{false};
+  std::atomic<bool> is_feedback_aware_{false};
+  std::atomic<int8_t> status_{GoalStatus::STATUS_ACCEPTED};
 
   std::mutex handle_mutex_;
 };
@@ -19,6 +19,7 @@
 
 #include <memory>
 
+#include "rclcpp/detail/future_waiters.hpp"
 #include "rclcpp/logging.hpp"
 #include "rclcpp_action/client_goal_handle.hpp"
 #include "rclcpp_action/exceptions.hpp"
@@ -32,7 +33,8 @@ ClientGoalHandle<ActionT>::ClientGoalHandle(
 : info_(info),
   result_future_(result_promise_.get_future()),
   feedback_callback_(feedback_callback),
-  result_callback_(result_callback)
+  result_callback_(result_callback),
+  is_feedback_aware_(feedback_callback != nullptr)
 {
 }
 
@@ -73,6 +75,7 @@ ClientGoalHandle<ActionT>::set_result(const WrappedResult & wrapped_result)
   std::lock_guard<std::mutex> guard(handle_mutex_);
   status_ = static_cast<int8_t>(wrapped_result.code);
   result_promise_.set_value(wrapped_result);
+  rclcpp::detail::notify_future_waiters();
   if (result_callback_) {
     result_callback_(wrapped_result);
   }
@@ -84,6 +87,7 @@ ClientGoalHandle<ActionT>::set_feedback_callback(FeedbackCallback callback)
 {
   std::lock_guard<std::mutex> guard(handle_mutex_);
   feedback_callback_ = callback;
+  is_feedback_aware_ = feedback_callback_ != nullptr;
 }
 
 template<typename ActionT>
@@ -98,8 +102,7 @@ template<typename ActionT>
 int8_t
 ClientGoalHandle<ActionT>::get_status()
 {
-  std::lock_guard<std::mutex> guard(handle_mutex_);
-  return status_;
+  return status_.load();
 }
 
 template<typename ActionT>
@@ -114,16 +117,14 @@ template<typename ActionT>
 bool
 ClientGoalHandle<ActionT>::is_feedback_aware()
 {
-  std::lock_guard<std::mutex> guard(handle_mutex_);
-  return feedback_callback_ != nullptr;
+  return is_feedback_aware_.load();
 }
 
 template<typename ActionT>
 bool
 ClientGoalHandle<ActionT>::is_result_aware()
 {
-  std::lock_guard<std::mutex> guard(handle_mutex_);
-  return is_result_aware_;
+  return is_result_aware_.load();
 }
 
 template<typename ActionT>
@@ -131,9 +132,7 @@ bool
 ClientGoalHandle<ActionT>::set_result_awareness(bool awareness)
 {
   std::lock_guard<std::mutex> guard(handle_mutex_);
-  bool previous = is_result_aware_;
-  is_result_aware_ = awareness;
-  return previous;
+  return is_result_aware_.exchange(awareness);
 }
 
 template<typename ActionT>
@@ -149,6 +148,7 @@ ClientGoalHandle<ActionT>::invalidate(const exceptions::UnawareGoalHandleError &
   invalidate_exception_ = std::make_exception_ptr(ex);
   status_ = GoalStatus::STATUS_UNKNOWN;
   result_promise_.set_exception(invalidate_exception_);
+  rclcpp::detail::notify_future_waiters();
 }
 
 template<typename ActionT>
@@ -0,0 +1,89 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP_ACTION__COROUTINES_HPP_
+#define RCLCPP_ACTION__COROUTINES_HPP_
+
+#include "rclcpp/experimental/coroutines.hpp"
+
+#ifdef RCLCPP_HAS_COROUTINES
+
+#include <memory>
+#include <utility>
+
+#include "rclcpp_action/client.hpp"
+#include "rclcpp_action/client_goal_handle.hpp"
+
+namespace rclcpp_action
+{
+namespace experimental
+{
+
+/// Send a goal, returning an awaitable of its goal handle.
+/**
+ * Like Client::async_send_goal(), whose options are all called, and the coroutine is resumed
+ * by the executor of the client when the goal response is received.
+ * The goal handle is null if the goal was rejected.
+ */
+template<typename ActionT>
+rclcpp::experimental::CallbackAwaiter<typename ClientGoalHandle<ActionT>::SharedPtr>
+async_send_goal(
+  const typename Client<ActionT>::SharedPtr & client,
+  const typename ActionT::Goal & goal,
+  typename Client<ActionT>::SendGoalOptions options = typename Client<ActionT>::SendGoalOptions())
+{
+  using GoalHandleSharedPtr = typename ClientGoalHandle<ActionT>::SharedPtr;
+  rclcpp::experimental::CallbackAwaiter<GoalHandleSharedPtr> awaiter;
+  options.goal_response_callback =
+    [completer = awaiter.get_completer(), callback = std::move(options.goal_response_callback)](
+    GoalHandleSharedPtr goal_handle) {
+      if (callback) {
+        callback(goal_handle);
+      }
+      completer(std::move(goal_handle));
+    };
+  client->async_send_goal(goal, options);
+  return awaiter;
+}
+
+/// Request the result of a goal, returning an awaitable of it.
+/**
+ * Like Client::async_get_result(), and the coroutine is resumed by the executor of the client
+ * when the result is received.
+ * \throws exceptions::UnknownGoalHandleError If the goal is unknown or already reached a
+ *   terminal state.
+ */
+template<typename ActionT>
+rclcpp::experimental::CallbackAwaiter<typename ClientGoalHandle<ActionT>::WrappedResult>
+async_get_result(
+  const typename Client<ActionT>::SharedPtr & client,
+  typename ClientGoalHandle<ActionT>::SharedPtr goal_handle)
+{
+  using WrappedResult = typename ClientGoalHandle<ActionT>::WrappedResult;
+  rclcpp::experimental::CallbackAwaiter<WrappedResult> awaiter;
+  client->async_get_result(
+    std::move(goal_handle),
+    [completer = awaiter.get_completer()](const WrappedResult & result) {
+      completer(result);
+    });
+  return awaiter;
+}
+
+}  // namespace experimental
+}  // namespace rclcpp_action
+
+#endif  // RCLCPP_HAS_COROUTINES
+
+#endif  // RCLCPP_ACTION__COROUTINES_HPP_
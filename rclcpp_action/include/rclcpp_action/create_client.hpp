@@ -64,15 +64,22 @@ create_client(
       if (shared_node) {
         // API expects a shared pointer, give it one with a deleter that does nothing.
         std::shared_ptr<Client<ActionT>> fake_shared_ptr(ptr, [](Client<ActionT> *) {});
+        auto intra_process_waitable = ptr->get_intra_process_waitable();
 
         if (group_is_null) {
           // Was added to default group
           shared_node->remove_waitable(fake_shared_ptr, nullptr);
+          if (intra_process_waitable) {
+            shared_node->remove_waitable(intra_process_waitable, nullptr);
+          }
         } else {
           // Was added to a specific group
           auto shared_group = weak_group.lock();
           if (shared_group) {
             shared_node->remove_waitable(fake_shared_ptr, shared_group);
+            if (intra_process_waitable) {
+              shared_node->remove_waitable(intra_process_waitable, shared_group);
+            }
           }
         }
       }
@@ -89,6 +96,10 @@ create_client(
     deleter);
 
   node_waitables_interface->add_waitable(action_client, group);
+  if (node_base_interface->get_use_intra_process_default()) {
+    action_client->setup_intra_process(action_client, node_base_interface);
+    node_waitables_interface->add_waitable(action_client->get_intra_process_waitable(), group);
+  }
   return action_client;
 }
 
@@ -31,6 +31,65 @@
 
 namespace rclcpp_action
 {
+namespace detail
+{
+/// Take the ownership of an action server and add it to a node.
+/// \internal
+template<typename ActionT>
+typename Server<ActionT>::SharedPtr
+add_server_to_node(
+  Server<ActionT> * server,
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base_interface,
+  rclcpp::node_interfaces::NodeWaitablesInterface::SharedPtr node_waitables_interface,
+  rclcpp::CallbackGroup::SharedPtr group)
+{
+  std::weak_ptr<rclcpp::node_interfaces::NodeWaitablesInterface> weak_node =
+    node_waitables_interface;
+  std::weak_ptr<rclcpp::CallbackGroup> weak_group = group;
+  bool group_is_null = (nullptr == group.get());
+
+  auto deleter = [weak_node, weak_group, group_is_null](Server<ActionT> * ptr)
+    {
+      if (nullptr == ptr) {
+        return;
+      }
+      auto shared_node = weak_node.lock();
+      if (shared_node) {
+        // API expects a shared pointer, give it one with a deleter that does nothing.
+        std::shared_ptr<Server<ActionT>> fake_shared_ptr(ptr, [](Server<ActionT> *) {});
+        auto intra_process_waitable = ptr->get_intra_process_waitable();
+
+        if (group_is_null) {
+          // Was added to default group
+          shared_node->remove_waitable(fake_shared_ptr, nullptr);
+          if (intra_process_waitable) {
+            shared_node->remove_waitable(intra_process_waitable, nullptr);
+          }
+        } else {
+          // Was added to a specific group
+          auto shared_group = weak_group.lock();
+          if (shared_group) {
+            shared_node->remove_waitable(fake_shared_ptr, shared_group);
+            if (intra_process_waitable) {
+              shared_node->remove_waitable(intra_process_waitable, shared_group);
+            }
+          }
+        }
+      }
+      delete ptr;
+    };
+
+  std::shared_ptr<Server<ActionT>> action_server(server, deleter);
+
+  node_waitables_interface->add_waitable(action_server, group);
+  if (node_base_interface->get_use_intra_process_default()) {
+    action_server->setup_intra_process(action_server, node_base_interface);
+    node_waitables_interface->add_waitable(action_server->get_intra_process_waitable(), group);
+  }
+  return action_server;
+}
+}  // namespace detail
+
 /// Create an action server.
 /**
  * All provided callback functions must be non-blocking.
@@ -67,36 +126,8 @@ create_server(
   const rcl_action_server_options_t & options = rcl_action_server_get_default_options(),
   rclcpp::CallbackGroup::SharedPtr group = nullptr)
 {
-  std::weak_ptr<rclcpp::node_interfaces::NodeWaitablesInterface> weak_node =
-    node_waitables_interface;
-  std::weak_ptr<rclcpp::CallbackGroup> weak_group = group;
-  bool group_is_null = (nullptr == group.get());
-
-  auto deleter = [weak_node, weak_group, group_is_null](Server<ActionT> * ptr)
-    {
-      if (nullptr == ptr) {
-        return;
-      }
-      auto shared_node = weak_node.lock();
-      if (shared_node) {
-        // API expects a shared pointer, give it one with a deleter that does nothing.
-        std::shared_ptr<Server<ActionT>> fake_shared_ptr(ptr, [](Server<ActionT> *) {});
-
-        if (group_is_null) {
-          // Was added to default group
-          shared_node->remove_waitable(fake_shared_ptr, nullptr);
-        } else {
-          // Was added to a specific group
-          auto shared_group = weak_group.lock();
-          if (shared_group) {
-            shared_node->remove_waitable(fake_shared_ptr, shared_group);
-          }
-        }
-      }
-      delete ptr;
-    };
-
-  std::shared_ptr<Server<ActionT>> action_server(new Server<ActionT>(
+  return detail::add_server_to_node<ActionT>(
+    new Server<ActionT>(
       node_base_interface,
       node_clock_interface,
       node_logging_interface,
@@ -104,10 +135,55 @@ create_server(
       options,
       handle_goal,
       handle_cancel,
-      handle_accepted), deleter);
+      handle_accepted),
+    node_base_interface, node_waitables_interface, group);
+}
 
-  node_waitables_interface->add_waitable(action_server, group);
-  return action_server;
+/// Create an action server deciding on the goals asynchronously.
+/**
+ * The goal callback is given a responder, which it or any other thread calls later to
+ * accept or reject the goal, while the server keeps handling the other requests.
+ *
+ * \sa Server::Server() for more information.
+ *
+ * \param[in] node_base_interface The node base interface of the corresponding node.
+ * \param[in] node_clock_interface The node clock interface of the corresponding node.
+ * \param[in] node_logging_interface The node logging interface of the corresponding node.
+ * \param[in] node_waitables_interface The node waitables interface of the corresponding node.
+ * \param[in] name The action name.
+ * \param[in] handle_goal A callback that is given a goal and the responder to call once the
+ *   goal is accepted or rejected.
+ * \param[in] handle_cancel A callback that decides if a goal should be attempted to be canceled.
+ * \param[in] handle_accepted A callback that is called to give the user a handle to the goal.
+ * \param[in] options Options to pass to the underlying `rcl_action_server_t`.
+ * \param[in] group The action server will be added to this callback group.
+ *   If `nullptr`, then the action server is added to the default callback group.
+ */
+template<typename ActionT>
+typename Server<ActionT>::SharedPtr
+create_server(
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base_interface,
+  rclcpp::node_interfaces::NodeClockInterface::SharedPtr node_clock_interface,
+  rclcpp::node_interfaces::NodeLoggingInterface::SharedPtr node_logging_interface,
+  rclcpp::node_interfaces::NodeWaitablesInterface::SharedPtr node_waitables_interface,
+  const std::string & name,
+  typename Server<ActionT>::AsyncGoalCallback handle_goal,
+  typename Server<ActionT>::CancelCallback handle_cancel,
+  typename Server<ActionT>::AcceptedCallback handle_accepted,
+  const rcl_action_server_options_t & options = rcl_action_server_get_default_options(),
+  rclcpp::CallbackGroup::SharedPtr group = nullptr)
+{
+  return detail::add_server_to_node<ActionT>(
+    new Server<ActionT>(
+      node_base_interface,
+      node_clock_interface,
+      node_logging_interface,
+      name,
+      options,
+      handle_goal,
+      handle_cancel,
+      handle_accepted),
+    node_base_interface, node_waitables_interface, group);
 }
 
 /// Create an action server.
@@ -150,5 +226,43 @@ create_server(
     options,
     group);
 }
+
+/// Create an action server deciding on the goals asynchronously.
+/**
+ * \sa create_server() taking the node interfaces, and Server::Server() for more information.
+ *
+ * \param[in] node The action server will be added to this node.
+ * \param[in] name The action name.
+ * \param[in] handle_goal A callback that is given a goal and the responder to call once the
+ *   goal is accepted or rejected.
+ * \param[in] handle_cancel A callback that decides if a goal should be attempted to be canceled.
+ * \param[in] handle_accepted A callback that is called to give the user a handle to the goal.
+ * \param[in] options Options to pass to the underlying `rcl_action_server_t`.
+ * \param[in] group The action server will be added to this callback group.
+ *   If `nullptr`, then the action server is added to the default callback group.
+ */
+template<typename ActionT, typename NodeT>
+typename Server<ActionT>::SharedPtr
+create_server(
+  NodeT node,
+  const std::string & name,
+  typename Server<ActionT>::AsyncGoalCallback handle_goal,
+  typename Server<ActionT>::CancelCallback handle_cancel,
+  typename Server<ActionT>::AcceptedCallback handle_accepted,
+  const rcl_action_server_options_t & options = rcl_action_server_get_default_options(),
+  rclcpp::CallbackGroup::SharedPtr group = nullptr)
+{
+  return create_server<ActionT>(
+    node->get_node_base_interface(),
+    node->get_node_clock_interface(),
+    node->get_node_logging_interface(),
+    node->get_node_waitables_interface(),
+    name,
+    handle_goal,
+    handle_cancel,
+    handle_accepted,
+    options,
+    group);
+}
 }  // namespace rclcpp_action
 #endif  // RCLCPP_ACTION__CREATE_SERVER_HPP_
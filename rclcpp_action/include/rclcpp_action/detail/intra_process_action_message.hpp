@@ -0,0 +1,51 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP_ACTION__DETAIL__INTRA_PROCESS_ACTION_MESSAGE_HPP_
+#define RCLCPP_ACTION__DETAIL__INTRA_PROCESS_ACTION_MESSAGE_HPP_
+
+#include <memory>
+
+namespace rclcpp_action
+{
+namespace detail
+{
+
+/// A message of an action, pushed to the intra-process queue of a server or client.
+/**
+ * The queues are the ones of the intra-process services, the header pushed with
+ * a message identifying the intra-process client which sent the request or
+ * gets the response.
+ */
+struct IntraProcessActionMessage
+{
+  enum class Type
+  {
+    GoalRequest,
+    CancelRequest,
+    ResultRequest,
+    GoalResponse,
+    CancelResponse,
+    ResultResponse,
+    Feedback,
+  };
+
+  Type type;
+  std::shared_ptr<void> message;
+};
+
+}  // namespace detail
+}  // namespace rclcpp_action
+
+#endif  // RCLCPP_ACTION__DETAIL__INTRA_PROCESS_ACTION_MESSAGE_HPP_
@@ -25,6 +25,8 @@
  *   - rclcpp_action/server.hpp
  *   - rclcpp_action/create_server.hpp
  *   - rclcpp_action/server_goal_handle.hpp
+ * - Waiting on many actions together
+ *   - rclcpp_action/action_waitable_group.hpp
  */
 
 #ifndef RCLCPP_ACTION__RCLCPP_ACTION_HPP_
@@ -33,6 +35,7 @@
 #include <csignal>
 #include <memory>
 
+#include "rclcpp_action/action_waitable_group.hpp"
 #include "rclcpp_action/client.hpp"
 #include "rclcpp_action/client_goal_handle.hpp"
 #include "rclcpp_action/create_client.hpp"
@@ -15,9 +15,12 @@
 #ifndef RCLCPP_ACTION__SERVER_HPP_
 #define RCLCPP_ACTION__SERVER_HPP_
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -67,6 +70,11 @@ enum class CancelResponse : int8_t
  * Instead users should use `rclcpp_action::Server`.
  *
  * Internally, this class is responsible for interfacing with the `rcl_action` API.
+ *
+ * With a multithreaded executor, the goals can be handled in parallel:
+ * feedback, statuses and results of different goals are published and sent
+ * concurrently, and only accepting, canceling and expiring goals are serialized,
+ * because `rcl_action` keeps all the goals of the server together.
  */
 class ServerBase : public rclcpp::Waitable
 {
@@ -177,6 +185,79 @@ public:
   // End Waitables API
   // -----------------
 
+  /// Publish the goal statuses at most once per period.
+  /**
+   * The status changes happening within a period are published together once
+   * the period elapsed since the previous status message, so that a server
+   * whose goals change often doesn't publish the whole list of goals each time.
+   * The delayed status messages are published by a steady timer waited on by
+   * the executor of the server.
+   *
+   * It should be called before the server is added to an executor.
+   *
+   * \param[in] period minimum time between two status messages,
+   *   0 to publish them on every goal state change, which is the default.
+   * \throws std::invalid_argument if the period is negative.
+   */
+  RCLCPP_ACTION_PUBLIC
+  void
+  set_status_publish_period(std::chrono::nanoseconds period);
+
+  /// Retain the results of at most this number of goals, to bound the memory they use.
+  /**
+   * The results are retained until their goal expires, once the result timeout
+   * of the server elapsed after the goal terminated.
+   * Beyond this number, the results least recently sent or requested are dropped
+   * before their goal expires, and the requests of these results are answered
+   * with an unknown status, as if the goal had expired already.
+   *
+   * Only the results of the goals terminated once the maximum is set are counted.
+   *
+   * \param[in] max_results maximum number of retained results, 0 for no maximum,
+   *   which is the default.
+   */
+  RCLCPP_ACTION_PUBLIC
+  void
+  set_max_retained_results(size_t max_results);
+
+  /// Expire the goals and publish the delayed statuses, as the timers of the server would.
+  /**
+   * It's called periodically by rclcpp_action::ActionWaitableGroup for its servers,
+   * whose timers aren't waited on.
+   * \internal
+   */
+  RCLCPP_ACTION_PUBLIC
+  void
+  execute_timers();
+
+  /// Receive the goals of the intra-process action clients of the context.
+  /**
+   * The goal, cancel and result requests of the action clients created by nodes
+   * using intra-process communications are then handed over to the server as
+   * shared pointers, by the waitable returned by get_intra_process_waitable(),
+   * which has to be added to the callback group of the server.
+   * The responses and the feedback of their goals are handed back the same way,
+   * so the feedback of these goals isn't published by the middleware.
+   * The statuses are still published by the middleware for all the clients.
+   *
+   * This is done by rclcpp_action::create_server() when the node uses
+   * intra-process communications.
+   *
+   * \param[in] self shared pointer to this server, the requests aren't handled anymore
+   *   once it is destroyed.
+   * \param[in] node_base node of the server, to resolve the name of the action.
+   */
+  RCLCPP_ACTION_PUBLIC
+  void
+  setup_intra_process(
+    const std::shared_ptr<ServerBase> & self,
+    rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base);
+
+  /// Return the waitable handling the intra-process requests, or nullptr if not set up.
+  RCLCPP_ACTION_PUBLIC
+  rclcpp::Waitable::SharedPtr
+  get_intra_process_waitable() const;
+
 protected:
   RCLCPP_ACTION_PUBLIC
   ServerBase(
@@ -198,6 +279,29 @@ protected:
   std::pair<GoalResponse, std::shared_ptr<void>>
   call_handle_goal_callback(GoalUUID &, std::shared_ptr<void> request) = 0;
 
+  // ServerBase will call this function first when a goal request is received.
+  // The subclass returns false if it has no asynchronous callback, otherwise it calls it and
+  // the decision is given later to respond_to_goal_request().
+  /// \internal
+  RCLCPP_ACTION_PUBLIC
+  virtual
+  bool
+  call_async_handle_goal_callback(
+    const rmw_request_id_t & request_header, const GoalUUID & uuid,
+    std::shared_ptr<void> request);
+
+  /// Send the response to a goal request, and accept the goal if the response is to accept it.
+  /**
+   * It's thread-safe, so that the decision of an asynchronous callback can be given from any
+   * thread.
+   * \internal
+   */
+  RCLCPP_ACTION_PUBLIC
+  void
+  respond_to_goal_request(
+    const rmw_request_id_t & request_header, const GoalUUID & uuid,
+    std::shared_ptr<void> request, GoalResponse response, std::shared_ptr<void> ros_response);
+
   // ServerBase will determine which goal ids are being cancelled, and then call this function for
   // each goal id.
   // The subclass should look up a goal handle and call the user's callback.
@@ -251,11 +355,21 @@ protected:
   std::shared_ptr<void>
   create_result_response(decltype(action_msgs::msg::GoalStatus::status) status) = 0;
 
+  /// Publish the statuses of all the goals, read again from rcl_action.
   /// \internal
   RCLCPP_ACTION_PUBLIC
   void
   publish_status();
 
+  /// Publish the statuses of the goals, after the state of one of them changed.
+  /**
+   * Only the status of this goal is updated in the status message kept by the server.
+   * \internal
+   */
+  RCLCPP_ACTION_PUBLIC
+  void
+  publish_status(const GoalUUID & uuid);
+
   /// \internal
   RCLCPP_ACTION_PUBLIC
   void
@@ -271,6 +385,18 @@ protected:
   void
   publish_feedback(std::shared_ptr<void> feedback_msg);
 
+  /// Return true if the goal was sent by an intra-process client.
+  /// \internal
+  RCLCPP_ACTION_PUBLIC
+  bool
+  is_intra_process_goal(const GoalUUID & uuid);
+
+  /// Hand the feedback of a goal over to the intra-process client which sent it.
+  /// \internal
+  RCLCPP_ACTION_PUBLIC
+  void
+  publish_intra_process_feedback(const GoalUUID & uuid, std::shared_ptr<void> feedback_msg);
+
   // End API for communication between ServerBase and Server<>
   // ---------------------------------------------------------
 
@@ -281,18 +407,38 @@ private:
   void
   execute_goal_request_received(std::shared_ptr<void> & data);
 
+  /// Accept or reject a goal request, taken from the middleware or an intra-process client
+  /// \internal
+  void
+  handle_goal_request(const rmw_request_id_t & request_header, std::shared_ptr<void> message);
+
   /// Handle a request to cancel goals on the server
   /// \internal
   RCLCPP_ACTION_PUBLIC
   void
   execute_cancel_request_received(std::shared_ptr<void> & data);
 
+  /// Cancel the goals of a cancel request
+  /// \internal
+  void
+  handle_cancel_request(const rmw_request_id_t & request_header, std::shared_ptr<void> message);
+
   /// Handle a request to get the result of an action
   /// \internal
   RCLCPP_ACTION_PUBLIC
   void
   execute_result_request_received(std::shared_ptr<void> & data);
 
+  /// Send the result of a goal now, or once it is available
+  /// \internal
+  void
+  handle_result_request(const rmw_request_id_t & request_header, std::shared_ptr<void> message);
+
+  /// Dispatch a request pushed to the intra-process queue of the server
+  /// \internal
+  void
+  handle_intra_process_message(const rmw_request_id_t & request_header, std::shared_ptr<void> data);
+
   /// Handle a timeout indicating a completed goal should be forgotten by the server
   /// \internal
   RCLCPP_ACTION_PUBLIC
@@ -350,6 +496,11 @@ public:
   using CancelCallback = std::function<CancelResponse(std::shared_ptr<ServerGoalHandle<ActionT>>)>;
   /// Signature of a callback that is used to notify when the goal has been accepted.
   using AcceptedCallback = std::function<void (std::shared_ptr<ServerGoalHandle<ActionT>>)>;
+  /// Signature of the function an asynchronous goal callback gives its decision to.
+  using GoalResponder = std::function<void (GoalResponse)>;
+  /// Signature of a callback that accepts or rejects goal requests later, with a responder.
+  using AsyncGoalCallback = std::function<void (
+        const GoalUUID &, std::shared_ptr<const typename ActionT::Goal>, GoalResponder)>;
 
   /// Construct an action server.
   /**
@@ -400,8 +551,65 @@ public:
   {
   }
 
+  /// Construct an action server deciding on the goals asynchronously.
+  /**
+   * Instead of returning its decision, the goal callback is given a responder, which it or
+   * any other thread calls once the goal is accepted or rejected, for example after asking
+   * another node.
+   * Meanwhile, the server keeps handling the other goal, cancel and result requests.
+   * The responder can be called at most once, the calls after the first one are ignored, and
+   * the calls after the server is destroyed too.
+   * If the goal is accepted, the accepted callback is called by the thread calling the
+   * responder, which throws if the response can't be sent or the goal accepted.
+   * A goal which is never decided on gets no response, so the client waits until it gives up.
+   *
+   * \sa Server()
+   * \param[in] handle_goal a callback that is given the goal and a responder, which it or
+   *   another thread calls to accept or reject the goal.
+   */
+  Server(
+    rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base,
+    rclcpp::node_interfaces::NodeClockInterface::SharedPtr node_clock,
+    rclcpp::node_interfaces::NodeLoggingInterface::SharedPtr node_logging,
+    const std::string & name,
+    const rcl_action_server_options_t & options,
+    AsyncGoalCallback handle_goal,
+    CancelCallback handle_cancel,
+    AcceptedCallback handle_accepted
+  )
+  : ServerBase(
+      node_base,
+      node_clock,
+      node_logging,
+      name,
+      rosidl_typesupport_cpp::get_action_type_support_handle<ActionT>(),
+      options),
+    async_handle_goal_(handle_goal),
+    handle_cancel_(handle_cancel),
+    handle_accepted_(handle_accepted)
+  {
+  }
+
   virtual ~Server() = default;
 
+  /// Set the feedback publish period of the goals accepted from now on.
+  /**
+   * \sa ServerGoalHandle::set_feedback_publish_period()
+   *
+   * \param[in] period minimum time between two feedback messages of a goal,
+   *   0 to publish all of them, which is the default.
+   * \throws std::invalid_argument if the period is negative.
+   */
+  void
+  set_feedback_publish_period(std::chrono::nanoseconds period)
+  {
+    if (period < std::chrono::nanoseconds::zero()) {
+      throw std::invalid_argument("the feedback publish period can't be negative");
+    }
+    std::lock_guard<std::mutex> lock(goal_handles_mutex_);
+    feedback_publish_period_ = period;
+  }
+
 protected:
   // -----------------------------------------------------
   // API for communication between ServerBase and Server<>
@@ -414,11 +622,40 @@ protected:
       typename ActionT::Impl::SendGoalService::Request>(message);
     auto goal = std::shared_ptr<typename ActionT::Goal>(request, &request->goal);
     GoalResponse user_response = handle_goal_(uuid, goal);
+    return std::make_pair(user_response, create_goal_response(user_response));
+  }
 
-    auto ros_response = std::make_shared<typename ActionT::Impl::SendGoalService::Response>();
-    ros_response->accepted = GoalResponse::ACCEPT_AND_EXECUTE == user_response ||
-      GoalResponse::ACCEPT_AND_DEFER == user_response;
-    return std::make_pair(user_response, ros_response);
+  /// \internal
+  bool
+  call_async_handle_goal_callback(
+    const rmw_request_id_t & request_header, const GoalUUID & uuid,
+    std::shared_ptr<void> message) override
+  {
+    if (!async_handle_goal_) {
+      return false;
+    }
+    auto request = std::static_pointer_cast<
+      typename ActionT::Impl::SendGoalService::Request>(message);
+    auto goal = std::shared_ptr<typename ActionT::Goal>(request, &request->goal);
+
+    std::weak_ptr<Server<ActionT>> weak_this = this->shared_from_this();
+    auto responded = std::make_shared<std::atomic<bool>>(false);
+    GoalResponder responder =
+      [weak_this, responded, request_header, uuid, message](GoalResponse user_response)
+      {
+        if (responded->exchange(true)) {
+          return;
+        }
+        auto shared_this = weak_this.lock();
+        if (!shared_this) {
+          return;
+        }
+        shared_this->respond_to_goal_request(
+          request_header, uuid, message, user_response,
+          shared_this->create_goal_response(user_response));
+      };
+    async_handle_goal_(uuid, goal, std::move(responder));
+    return true;
   }
 
   /// \internal
@@ -470,7 +707,7 @@ protected:
         // Send result message to anyone that asked
         shared_this->publish_result(goal_uuid, result_message);
         // Publish a status message any time a goal handle changes state
-        shared_this->publish_status();
+        shared_this->publish_status(goal_uuid);
         // notify base so it can recalculate the expired goal timer
         shared_this->notify_goal_terminal_state();
         // Delete data now (ServerBase and rcl_action_server_t keep data until goal handle expires)
@@ -485,9 +722,8 @@ protected:
         if (!shared_this) {
           return;
         }
-        (void)goal_uuid;
         // Publish a status message any time a goal handle changes state
-        shared_this->publish_status();
+        shared_this->publish_status(goal_uuid);
       };
 
     std::function<void(std::shared_ptr<typename ActionT::Impl::FeedbackMessage>)> publish_feedback =
@@ -497,6 +733,14 @@ protected:
         if (!shared_this) {
           return;
         }
+        const GoalUUID & goal_uuid = feedback_msg->goal_id.uuid;
+        if (shared_this->is_intra_process_goal(goal_uuid)) {
+          // The goal handle reuses its feedback message, so the client gets its own copy.
+          shared_this->publish_intra_process_feedback(
+            goal_uuid,
+            std::make_shared<typename ActionT::Impl::FeedbackMessage>(*feedback_msg));
+          return;
+        }
         shared_this->publish_feedback(std::static_pointer_cast<void>(feedback_msg));
       };
 
@@ -509,6 +753,7 @@ protected:
     {
       std::lock_guard<std::mutex> lock(goal_handles_mutex_);
       goal_handles_[uuid] = goal_handle;
+      goal_handle->set_feedback_publish_period(feedback_publish_period_);
     }
     handle_accepted_(goal_handle);
   }
@@ -556,7 +801,17 @@ protected:
   // ---------------------------------------------------------
 
 private:
+  std::shared_ptr<void>
+  create_goal_response(GoalResponse user_response)
+  {
+    auto ros_response = std::make_shared<typename ActionT::Impl::SendGoalService::Response>();
+    ros_response->accepted = GoalResponse::ACCEPT_AND_EXECUTE == user_response ||
+      GoalResponse::ACCEPT_AND_DEFER == user_response;
+    return ros_response;
+  }
+
   GoalCallback handle_goal_;
+  AsyncGoalCallback async_handle_goal_;
   CancelCallback handle_cancel_;
   AcceptedCallback handle_accepted_;
 
@@ -565,6 +820,8 @@ private:
   /// This is used to provide a goal handle to handle_cancel.
   std::unordered_map<GoalUUID, GoalHandleWeakPtr> goal_handles_;
   std::mutex goal_handles_mutex_;
+  /// Feedback publish period of the new goals, protected by goal_handles_mutex_.
+  std::chrono::nanoseconds feedback_publish_period_{0};
 };
 }  // namespace rclcpp_action
 #endif  // RCLCPP_ACTION__SERVER_HPP_
@@ -15,6 +15,7 @@
 #ifndef RCLCPP_ACTION__SERVER_GOAL_HANDLE_HPP_
 #define RCLCPP_ACTION__SERVER_GOAL_HANDLE_HPP_
 
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -141,17 +142,59 @@ public:
    * If execution of a goal is deferred then `ServerGoalHandle::set_executing()` must be called
    * first.
    *
+   * The feedback is copied into a feedback message kept by the goal handle, which is reused
+   * for all its feedback, unless it is the feedback returned by borrow_feedback().
+   *
    * \throws std::runtime_error If the goal is in any state besides executing.
    *
    * \param[in] feedback_msg the message to publish to clients.
+   * \return false if the feedback was dropped, as the previous one was published less
+   *   than a feedback publish period ago, otherwise true.
    */
-  void
+  bool
   publish_feedback(std::shared_ptr<typename ActionT::Feedback> feedback_msg)
   {
-    auto feedback_message = std::make_shared<typename ActionT::Impl::FeedbackMessage>();
-    feedback_message->goal_id.uuid = uuid_;
-    feedback_message->feedback = *feedback_msg;
+    std::lock_guard<std::mutex> lock(feedback_mutex_);
+    if (feedback_publish_period_ > std::chrono::nanoseconds::zero()) {
+      const auto now = std::chrono::steady_clock::now();
+      if (now - last_feedback_time_ < feedback_publish_period_) {
+        return false;
+      }
+      last_feedback_time_ = now;
+    }
+    auto & feedback_message = get_feedback_message();
+    if (feedback_msg.get() != &feedback_message->feedback) {
+      feedback_message->feedback = *feedback_msg;
+    }
     publish_feedback_(feedback_message);
+    return true;
+  }
+
+  /// Return the feedback of the message kept by the goal handle, to be published without a copy.
+  /**
+   * The same feedback is returned on every call, keeping the values set before, so that
+   * filling it again doesn't allocate for feedback of a steady size.
+   * It shouldn't be modified while it is published by another thread.
+   */
+  std::shared_ptr<typename ActionT::Feedback>
+  borrow_feedback()
+  {
+    std::lock_guard<std::mutex> lock(feedback_mutex_);
+    auto & feedback_message = get_feedback_message();
+    return std::shared_ptr<typename ActionT::Feedback>(
+      feedback_message, &feedback_message->feedback);
+  }
+
+  /// Publish the feedback of this goal at most once per period, dropping the feedback in between.
+  /**
+   * \param[in] period minimum time between two feedback messages of the goal,
+   *   0 to publish all of them, which is the default.
+   */
+  void
+  set_feedback_publish_period(std::chrono::nanoseconds period)
+  {
+    std::lock_guard<std::mutex> lock(feedback_mutex_);
+    feedback_publish_period_ = period;
   }
 
   /// Indicate that a goal could not be reached and has been aborted.
@@ -278,6 +321,23 @@ protected:
   std::function<void(const GoalUUID &, std::shared_ptr<void>)> on_terminal_state_;
   std::function<void(const GoalUUID &)> on_executing_;
   std::function<void(std::shared_ptr<typename ActionT::Impl::FeedbackMessage>)> publish_feedback_;
+
+private:
+  /// feedback_mutex_ must be locked.
+  std::shared_ptr<typename ActionT::Impl::FeedbackMessage> &
+  get_feedback_message()
+  {
+    if (!feedback_message_) {
+      feedback_message_ = std::make_shared<typename ActionT::Impl::FeedbackMessage>();
+      feedback_message_->goal_id.uuid = uuid_;
+    }
+    return feedback_message_;
+  }
+
+  std::mutex feedback_mutex_;
+  std::shared_ptr<typename ActionT::Impl::FeedbackMessage> feedback_message_;
+  std::chrono::nanoseconds feedback_publish_period_{0};
+  std::chrono::steady_clock::time_point last_feedback_time_;
 };
 }  // namespace rclcpp_action
 
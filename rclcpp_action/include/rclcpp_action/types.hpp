@@ -16,7 +16,7 @@
 #define RCLCPP_ACTION__TYPES_HPP_
 
 #include <array>
-#include <climits>
+#include <cstdint>
 #include <functional>
 #include <string>
 
@@ -69,16 +69,13 @@ struct hash<rclcpp_action::GoalUUID>
 {
   size_t operator()(const rclcpp_action::GoalUUID & uuid) const noexcept
   {
-    // TODO(sloretz) Use someone else's hash function and cite it
-    size_t result = 0;
+    // 64-bit FNV-1a, so that every byte of the id changes all the bits of the hash
+    uint64_t result = 14695981039346656037ull;
     for (size_t i = 0; i < uuid.size(); ++i) {
-      for (size_t b = 0; b < sizeof(size_t); ++b) {
-        size_t part = uuid[i];
-        part <<= CHAR_BIT * b;
-        result ^= part;
-      }
+      result ^= uuid[i];
+      result *= 1099511628211ull;
     }
-    return result;
+    return static_cast<size_t>(result);
   }
 };
 }  // namespace std
@@ -0,0 +1,255 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp_action/action_waitable_group.hpp"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "rcl/wait.h"
+
+#include "rclcpp/detail/add_guard_condition_to_rcl_wait_set.hpp"
+#include "rclcpp/exceptions.hpp"
+
+using rclcpp_action::ActionWaitableGroup;
+
+ActionWaitableGroup::ActionWaitableGroup(
+  rclcpp::Context::SharedPtr context,
+  std::chrono::nanoseconds timer_period)
+: gc_(context)
+{
+  if (timer_period <= std::chrono::nanoseconds::zero()) {
+    throw std::invalid_argument("the timer period of an action waitable group must be positive");
+  }
+  timer_ = std::make_shared<rclcpp::WallTimer<rclcpp::VoidCallbackType>>(
+    timer_period, []() {}, context);
+}
+
+ActionWaitableGroup::~ActionWaitableGroup()
+{
+  std::unordered_map<uint64_t, Member> members;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    members.swap(members_);
+  }
+  for (auto & id_and_member : members) {
+    id_and_member.second.waitable->clear_on_ready_callback();
+  }
+}
+
+void
+ActionWaitableGroup::add(std::shared_ptr<ServerBase> server)
+{
+  if (!server) {
+    throw std::invalid_argument("the action server added to a waitable group is null");
+  }
+  add_member(server, server);
+}
+
+void
+ActionWaitableGroup::add(std::shared_ptr<ClientBase> client)
+{
+  if (!client) {
+    throw std::invalid_argument("the action client added to a waitable group is null");
+  }
+  add_member(std::move(client), nullptr);
+}
+
+void
+ActionWaitableGroup::add_member(
+  rclcpp::Waitable::SharedPtr waitable,
+  std::shared_ptr<ServerBase> server)
+{
+  uint64_t member_id;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto & id_and_member : members_) {
+      if (id_and_member.second.waitable == waitable) {
+        throw std::invalid_argument("the action is already in the waitable group");
+      }
+    }
+    member_id = next_member_id_++;
+    members_.emplace(member_id, Member{waitable, std::move(server)});
+  }
+  // The events received before are reported right away, which locks the mutex.
+  waitable->set_on_ready_callback(
+    [this, member_id](size_t number_of_events, int entity_type) {
+      on_ready(member_id, number_of_events, entity_type);
+    });
+}
+
+bool
+ActionWaitableGroup::remove(const rclcpp::Waitable::SharedPtr & action)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = members_.begin();
+    while (it != members_.end() && it->second.waitable != action) {
+      ++it;
+    }
+    if (it == members_.end()) {
+      return false;
+    }
+    const uint64_t member_id = it->first;
+    members_.erase(it);
+    for (auto ready_it = ready_entities_.begin(); ready_it != ready_entities_.end(); ) {
+      if (ready_it->member_id == member_id) {
+        ready_it = ready_entities_.erase(ready_it);
+      } else {
+        ++ready_it;
+      }
+    }
+  }
+  // The events reported until then are ignored, since the member is gone.
+  action->clear_on_ready_callback();
+  return true;
+}
+
+size_t
+ActionWaitableGroup::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return members_.size();
+}
+
+void
+ActionWaitableGroup::on_ready(uint64_t member_id, size_t number_of_events, int entity_type)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (members_.find(member_id) == members_.end()) {
+      return;
+    }
+    if (!ready_entities_.empty() && ready_entities_.back().member_id == member_id &&
+      ready_entities_.back().entity_type == entity_type)
+    {
+      ready_entities_.back().number_of_events += number_of_events;
+    } else {
+      ready_entities_.push_back({member_id, entity_type, number_of_events});
+    }
+  }
+  gc_.trigger();
+}
+
+size_t
+ActionWaitableGroup::get_number_of_ready_timers()
+{
+  return 1u;
+}
+
+size_t
+ActionWaitableGroup::get_number_of_ready_guard_conditions()
+{
+  return 1u;
+}
+
+void
+ActionWaitableGroup::add_to_wait_set(rcl_wait_set_t * wait_set)
+{
+  rclcpp::detail::add_guard_condition_to_rcl_wait_set(*wait_set, gc_);
+  rcl_ret_t ret = rcl_wait_set_add_timer(
+    wait_set, timer_->get_timer_handle().get(), &timer_index_);
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(
+      ret, "ActionWaitableGroup::add_to_wait_set() failed");
+  }
+}
+
+bool
+ActionWaitableGroup::is_ready(rcl_wait_set_t * wait_set)
+{
+  timer_ready_ = timer_index_ < wait_set->size_of_timers &&
+    wait_set->timers[timer_index_] == timer_->get_timer_handle().get();
+  if (timer_ready_.load()) {
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !ready_entities_.empty();
+}
+
+std::shared_ptr<void>
+ActionWaitableGroup::take_data()
+{
+  bool expected = true;
+  if (timer_ready_.compare_exchange_strong(expected, false)) {
+    if (timer_->call()) {
+      // The data of the timer has no waitable, it's executed for all the servers.
+      return std::make_shared<TakenData>();
+    }
+  }
+
+  rclcpp::Waitable::SharedPtr waitable;
+  int entity_type = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (!waitable && !ready_entities_.empty()) {
+      ReadyEntity & ready_entity = ready_entities_.front();
+      auto it = members_.find(ready_entity.member_id);
+      if (it != members_.end()) {
+        waitable = it->second.waitable;
+        entity_type = ready_entity.entity_type;
+      }
+      if (--ready_entity.number_of_events == 0) {
+        ready_entities_.pop_front();
+      }
+    }
+    if (!ready_entities_.empty()) {
+      // The guard condition is only triggered once for all the events reported before a wait.
+      gc_.trigger();
+    }
+  }
+  if (!waitable) {
+    return nullptr;
+  }
+  auto data = waitable->take_data_by_entity_id(static_cast<size_t>(entity_type));
+  return std::make_shared<TakenData>(TakenData{std::move(waitable), std::move(data)});
+}
+
+std::shared_ptr<void>
+ActionWaitableGroup::take_data_by_entity_id(size_t id)
+{
+  (void)id;
+  return take_data();
+}
+
+void
+ActionWaitableGroup::execute(std::shared_ptr<void> & data)
+{
+  if (!data) {
+    return;
+  }
+  auto taken_data = std::static_pointer_cast<TakenData>(data);
+  if (taken_data->waitable) {
+    taken_data->waitable->execute(taken_data->data);
+    return;
+  }
+
+  std::vector<std::shared_ptr<ServerBase>> servers;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    servers.reserve(members_.size());
+    for (const auto & id_and_member : members_) {
+      if (id_and_member.second.server) {
+        servers.push_back(id_and_member.second.server);
+      }
+    }
+  }
+  for (const auto & server : servers) {
+    server->execute_timers();
+  }
+}
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <atomic>
 #include <map>
 #include <memory>
 #include <random>
@@ -22,12 +23,19 @@
 
 #include "rcl_action/action_client.h"
 #include "rcl_action/wait.h"
+#include "rclcpp/expand_topic_or_service_name.hpp"
+#include "rclcpp/experimental/intra_process_services.hpp"
 #include "rclcpp/node_interfaces/node_base_interface.hpp"
 #include "rclcpp/node_interfaces/node_logging_interface.hpp"
 
 #include "rclcpp_action/client.hpp"
+#include "rclcpp_action/detail/intra_process_action_message.hpp"
 #include "rclcpp_action/exceptions.hpp"
 
+using rclcpp::experimental::IntraProcessServiceQueue;
+using rclcpp::experimental::IntraProcessServices;
+using rclcpp_action::detail::IntraProcessActionMessage;
+
 namespace rclcpp_action
 {
 
@@ -44,6 +52,7 @@ public:
   : node_graph_(node_graph),
     node_handle(node_base->get_shared_rcl_node_handle()),
     logger(node_logging->get_logger().get_child("rclcpp_action")),
+    action_type_support(type_support),
     random_bytes_generator(std::random_device{}())
   {
     std::weak_ptr<rcl_node_t> weak_node_handle(node_handle);
@@ -118,8 +127,46 @@ public:
   std::map<int64_t, ResponseCallback> pending_cancel_responses;
   std::mutex cancel_requests_mutex;
 
+  // Return the request queue of the intra-process server of the action, or nullptr if none.
+  IntraProcessServiceQueue::SharedPtr
+  get_intra_process_server() const
+  {
+    if (!intra_process_queue) {
+      return nullptr;
+    }
+    return intra_process_services->get_service(intra_process_action_name, action_type_support);
+  }
+
+  // Hand a request over to an intra-process server, returning its sequence number.
+  // The mutex of its pending responses must be locked, as the response may come back
+  // from another thread right away.
+  int64_t
+  send_intra_process_request(
+    const IntraProcessServiceQueue::SharedPtr & server_queue,
+    IntraProcessActionMessage::Type type,
+    std::shared_ptr<void> request)
+  {
+    // Negative, so they never collide with the sequence numbers of the middleware.
+    const int64_t sequence_number = next_intra_process_sequence_number--;
+    server_queue->push(
+      IntraProcessServices::make_request_id(intra_process_client_id, sequence_number),
+      std::make_shared<IntraProcessActionMessage>(
+        IntraProcessActionMessage{type, std::move(request)}));
+    return sequence_number;
+  }
+
+  const rosidl_action_type_support_t * action_type_support;
+
   std::independent_bits_engine<
     std::default_random_engine, 8, unsigned int> random_bytes_generator;
+
+  // Responses and feedback of the intra-process servers, registered in the services
+  // of the context
+  IntraProcessServices::SharedPtr intra_process_services;
+  IntraProcessServiceQueue::SharedPtr intra_process_queue;
+  uint64_t intra_process_client_id{0};
+  std::string intra_process_action_name;
+  std::atomic<int64_t> next_intra_process_sequence_number{-1};
 };
 
 ClientBase::ClientBase(
@@ -136,6 +183,67 @@ ClientBase::ClientBase(
 
 ClientBase::~ClientBase()
 {
+  if (pimpl_->intra_process_services) {
+    pimpl_->intra_process_services->remove_client(pimpl_->intra_process_client_id);
+  }
+}
+
+void
+ClientBase::setup_intra_process(
+  const std::shared_ptr<ClientBase> & self,
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base)
+{
+  if (pimpl_->intra_process_queue) {
+    return;
+  }
+  std::weak_ptr<ClientBase> weak_self = self;
+  pimpl_->intra_process_queue = std::make_shared<IntraProcessServiceQueue>(
+    node_base->get_context(),
+    [weak_self](std::shared_ptr<rmw_request_id_t> response_header, std::shared_ptr<void> data)
+    {
+      auto client = weak_self.lock();
+      if (client) {
+        client->handle_intra_process_message(*response_header, std::move(data));
+      }
+    });
+  pimpl_->intra_process_action_name = rclcpp::expand_topic_or_service_name(
+    rcl_action_client_get_action_name(pimpl_->client_handle.get()),
+    node_base->get_name(), node_base->get_namespace(), true);
+  pimpl_->intra_process_services =
+    node_base->get_context()->get_sub_context<IntraProcessServices>();
+  pimpl_->intra_process_client_id =
+    pimpl_->intra_process_services->add_client(pimpl_->intra_process_queue);
+}
+
+rclcpp::Waitable::SharedPtr
+ClientBase::get_intra_process_waitable() const
+{
+  return pimpl_->intra_process_queue;
+}
+
+void
+ClientBase::handle_intra_process_message(
+  const rmw_request_id_t & response_header,
+  std::shared_ptr<void> data)
+{
+  auto message = std::static_pointer_cast<IntraProcessActionMessage>(data);
+  switch (message->type) {
+    case IntraProcessActionMessage::Type::GoalResponse:
+      handle_goal_response(response_header, std::move(message->message));
+      break;
+    case IntraProcessActionMessage::Type::CancelResponse:
+      handle_cancel_response(response_header, std::move(message->message));
+      break;
+    case IntraProcessActionMessage::Type::ResultResponse:
+      handle_result_response(response_header, std::move(message->message));
+      break;
+    case IntraProcessActionMessage::Type::Feedback:
+      handle_feedback_message(std::move(message->message));
+      break;
+    default:
+      RCLCPP_ERROR(pimpl_->logger, "unexpected intra-process action message, ignoring...");
+      break;
+  }
 }
 
 bool
@@ -304,10 +412,16 @@ ClientBase::send_goal_request(std::shared_ptr<void> request, ResponseCallback ca
 {
   std::unique_lock<std::mutex> guard(pimpl_->goal_requests_mutex);
   int64_t sequence_number;
-  rcl_ret_t ret = rcl_action_send_goal_request(
-    pimpl_->client_handle.get(), request.get(), &sequence_number);
-  if (RCL_RET_OK != ret) {
-    rclcpp::exceptions::throw_from_rcl_error(ret, "failed to send goal request");
+  auto server_queue = pimpl_->get_intra_process_server();
+  if (server_queue) {
+    sequence_number = pimpl_->send_intra_process_request(
+      server_queue, IntraProcessActionMessage::Type::GoalRequest, std::move(request));
+  } else {
+    rcl_ret_t ret = rcl_action_send_goal_request(
+      pimpl_->client_handle.get(), request.get(), &sequence_number);
+    if (RCL_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(ret, "failed to send goal request");
+    }
   }
   assert(pimpl_->pending_goal_responses.count(sequence_number) == 0);
   pimpl_->pending_goal_responses[sequence_number] = callback;
@@ -333,10 +447,16 @@ ClientBase::send_result_request(std::shared_ptr<void> request, ResponseCallback
 {
   std::lock_guard<std::mutex> guard(pimpl_->result_requests_mutex);
   int64_t sequence_number;
-  rcl_ret_t ret = rcl_action_send_result_request(
-    pimpl_->client_handle.get(), request.get(), &sequence_number);
-  if (RCL_RET_OK != ret) {
-    rclcpp::exceptions::throw_from_rcl_error(ret, "failed to send result request");
+  auto server_queue = pimpl_->get_intra_process_server();
+  if (server_queue) {
+    sequence_number = pimpl_->send_intra_process_request(
+      server_queue, IntraProcessActionMessage::Type::ResultRequest, std::move(request));
+  } else {
+    rcl_ret_t ret = rcl_action_send_result_request(
+      pimpl_->client_handle.get(), request.get(), &sequence_number);
+    if (RCL_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(ret, "failed to send result request");
+    }
   }
   assert(pimpl_->pending_result_responses.count(sequence_number) == 0);
   pimpl_->pending_result_responses[sequence_number] = callback;
@@ -362,10 +482,16 @@ ClientBase::send_cancel_request(std::shared_ptr<void> request, ResponseCallback
 {
   std::lock_guard<std::mutex> guard(pimpl_->cancel_requests_mutex);
   int64_t sequence_number;
-  rcl_ret_t ret = rcl_action_send_cancel_request(
-    pimpl_->client_handle.get(), request.get(), &sequence_number);
-  if (RCL_RET_OK != ret) {
-    rclcpp::exceptions::throw_from_rcl_error(ret, "failed to send cancel request");
+  auto server_queue = pimpl_->get_intra_process_server();
+  if (server_queue) {
+    sequence_number = pimpl_->send_intra_process_request(
+      server_queue, IntraProcessActionMessage::Type::CancelRequest, std::move(request));
+  } else {
+    rcl_ret_t ret = rcl_action_send_cancel_request(
+      pimpl_->client_handle.get(), request.get(), &sequence_number);
+    if (RCL_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(ret, "failed to send cancel request");
+    }
   }
   assert(pimpl_->pending_cancel_responses.count(sequence_number) == 0);
   pimpl_->pending_cancel_responses[sequence_number] = callback;
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <chrono>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -28,10 +30,16 @@
 #include "action_msgs/msg/goal_status_array.hpp"
 #include "action_msgs/srv/cancel_goal.hpp"
 #include "rclcpp/exceptions.hpp"
+#include "rclcpp/expand_topic_or_service_name.hpp"
+#include "rclcpp/experimental/intra_process_services.hpp"
+#include "rclcpp/timer.hpp"
+#include "rclcpp_action/detail/intra_process_action_message.hpp"
 #include "rclcpp_action/server.hpp"
 
 using rclcpp_action::ServerBase;
 using rclcpp_action::GoalUUID;
+using rclcpp_action::detail::IntraProcessActionMessage;
+using rclcpp::experimental::IntraProcessServices;
 
 namespace rclcpp_action
 {
@@ -40,16 +48,254 @@ class ServerBaseImpl
 public:
   ServerBaseImpl(
     rclcpp::Clock::SharedPtr clock,
+    rclcpp::Context::SharedPtr context,
     rclcpp::Logger logger
   )
-  : clock_(clock), logger_(logger)
+  : clock_(clock), context_(context), logger_(logger)
   {
   }
 
-  // Lock for action_server_
+  // Publish the pending status changes, unless the previous status was published
+  // less than a period ago, in which case the status timer publishes them later.
+  // status_mutex_ must be locked.
+  void
+  publish_status_if_due()
+  {
+    const auto now = std::chrono::steady_clock::now();
+    if (status_publish_period_ > std::chrono::nanoseconds::zero() &&
+      now - last_status_publish_time_ < status_publish_period_)
+    {
+      if (status_timer_->is_canceled()) {
+        status_timer_->reset();
+      }
+      return;
+    }
+    publish_pending_status(now);
+  }
+
+  // status_mutex_ must be locked.
+  void
+  publish_pending_status(std::chrono::steady_clock::time_point now)
+  {
+    if (status_rebuild_pending_) {
+      rebuild_status();
+    } else {
+      {
+        std::lock_guard<std::recursive_mutex> lock(unordered_map_mutex_);
+        for (const GoalUUID & uuid : changed_goals_) {
+          auto it = goal_handles_.find(uuid);
+          changed_goal_handles_.emplace_back(
+            uuid, it != goal_handles_.end() ? it->second : nullptr);
+        }
+      }
+      RCPPUTILS_SCOPE_EXIT({changed_goal_handles_.clear();});
+      std::lock_guard<std::recursive_mutex> lock(action_server_reentrant_mutex_);
+      for (const auto & uuid_and_handle : changed_goal_handles_) {
+        update_status(uuid_and_handle.first, uuid_and_handle.second.get());
+      }
+    }
+    changed_goals_.clear();
+    status_rebuild_pending_ = false;
+    last_status_publish_time_ = now;
+    if (status_timer_) {
+      status_timer_->cancel();
+    }
+
+    // The publisher is thread-safe, and status_mutex_ guards the message.
+    rcl_ret_t ret = rcl_action_publish_status(action_server_.get(), &status_msg_);
+    if (RCL_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(ret);
+    }
+  }
+
+  // Retain the result of a goal as the most recently used one, and drop the least
+  // recently used ones beyond the maximum.
+  // unordered_map_mutex_ must be locked.
+  void
+  retain_result(const GoalUUID & uuid)
+  {
+    if (max_retained_results_ == 0) {
+      return;
+    }
+    auto it = retained_result_positions_.find(uuid);
+    if (it != retained_result_positions_.end()) {
+      retained_results_.splice(retained_results_.end(), retained_results_, it->second);
+      return;
+    }
+    retained_result_positions_.emplace(
+      uuid, retained_results_.insert(retained_results_.end(), uuid));
+    drop_results_beyond_maximum();
+  }
+
+  // Mark a retained result as the most recently used one, if it wasn't dropped.
+  // unordered_map_mutex_ must be locked.
+  void
+  use_result(const GoalUUID & uuid)
+  {
+    auto it = retained_result_positions_.find(uuid);
+    if (it != retained_result_positions_.end()) {
+      retained_results_.splice(retained_results_.end(), retained_results_, it->second);
+    }
+  }
+
+  // unordered_map_mutex_ must be locked.
+  void
+  forget_result(const GoalUUID & uuid)
+  {
+    auto it = retained_result_positions_.find(uuid);
+    if (it != retained_result_positions_.end()) {
+      retained_results_.erase(it->second);
+      retained_result_positions_.erase(it);
+    }
+  }
+
+  // unordered_map_mutex_ must be locked.
+  void
+  drop_results_beyond_maximum()
+  {
+    while (max_retained_results_ > 0 && retained_results_.size() > max_retained_results_) {
+      const GoalUUID & uuid = retained_results_.front();
+      // The goal is still known until it expires, but not its result anymore.
+      goal_results_[uuid] = dropped_result_response_;
+      retained_result_positions_.erase(uuid);
+      retained_results_.pop_front();
+    }
+  }
+
+  // Read the statuses of all the goals from rcl_action.
+  // status_mutex_ must be locked.
+  void
+  rebuild_status()
+  {
+    // We need to hold the lock across this entire method because
+    // rcl_action_get_goal_status_array() reads the internal goal data.
+    std::lock_guard<std::recursive_mutex> lock(action_server_reentrant_mutex_);
+
+    rcl_action_goal_status_array_t c_status_array =
+      rcl_action_get_zero_initialized_goal_status_array();
+    rcl_ret_t ret = rcl_action_get_goal_status_array(action_server_.get(), &c_status_array);
+    if (RCL_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(ret);
+    }
+
+    RCPPUTILS_SCOPE_EXIT(
+    {
+      ret = rcl_action_goal_status_array_fini(&c_status_array);
+      if (RCL_RET_OK != ret) {
+        RCLCPP_ERROR(logger_, "Failed to fini status array message");
+      }
+    });
+
+    // Populate the c++ status message with the goals and their statuses
+    auto & status_list = status_msg_.status_list;
+    status_list.resize(c_status_array.msg.status_list.size);
+    status_indices_.clear();
+    for (size_t i = 0; i < c_status_array.msg.status_list.size; ++i) {
+      auto & c_status_msg = c_status_array.msg.status_list.data[i];
+      auto & msg = status_list[i];
+      msg.status = c_status_msg.status;
+      // Convert C goal info to C++ goal info
+      convert(c_status_msg.goal_info, &msg.goal_info.goal_id.uuid);
+      msg.goal_info.stamp.sec = c_status_msg.goal_info.stamp.sec;
+      msg.goal_info.stamp.nanosec = c_status_msg.goal_info.stamp.nanosec;
+      status_indices_[msg.goal_info.goal_id.uuid] = i;
+    }
+  }
+
+  // Update the status of a goal in the status message, removing it if its handle expired.
+  // status_mutex_ and action_server_reentrant_mutex_ must be locked.
+  void
+  update_status(const GoalUUID & uuid, const rcl_action_goal_handle_t * handle)
+  {
+    auto & status_list = status_msg_.status_list;
+    auto it = status_indices_.find(uuid);
+    if (!handle) {
+      if (it == status_indices_.end()) {
+        return;
+      }
+      // The order of the goals doesn't matter, move the last one in place of the expired one.
+      const size_t index = it->second;
+      status_indices_.erase(it);
+      if (index + 1 != status_list.size()) {
+        status_list[index] = std::move(status_list.back());
+        status_indices_[status_list[index].goal_info.goal_id.uuid] = index;
+      }
+      status_list.pop_back();
+      return;
+    }
+
+    rcl_action_goal_state_t state;
+    rcl_ret_t ret = rcl_action_goal_handle_get_status(handle, &state);
+    if (RCL_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(ret);
+    }
+    if (it != status_indices_.end()) {
+      status_list[it->second].status = state;
+      return;
+    }
+
+    rcl_action_goal_info_t goal_info = rcl_action_get_zero_initialized_goal_info();
+    ret = rcl_action_goal_handle_get_info(handle, &goal_info);
+    if (RCL_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(ret);
+    }
+    status_list.emplace_back();
+    auto & msg = status_list.back();
+    msg.status = state;
+    msg.goal_info.goal_id.uuid = uuid;
+    msg.goal_info.stamp.sec = goal_info.stamp.sec;
+    msg.goal_info.stamp.nanosec = goal_info.stamp.nanosec;
+    status_indices_[uuid] = status_list.size() - 1;
+  }
+
+  // Send the response to a request, through the intra-process queue of its client if
+  // the request came from an intra-process client, or with the given rcl function.
+  template<typename SendT>
+  rcl_ret_t
+  send_response(
+    IntraProcessActionMessage::Type type,
+    SendT send,
+    rmw_request_id_t request_header,
+    std::shared_ptr<void> response)
+  {
+    uint64_t client_id;
+    if (intra_process_queue_ && IntraProcessServices::get_client_id(request_header, client_id)) {
+      push_to_intra_process_client(client_id, request_header, type, std::move(response));
+      return RCL_RET_OK;
+    }
+    return send(action_server_.get(), &request_header, response.get());
+  }
+
+  void
+  push_to_intra_process_client(
+    uint64_t client_id,
+    const rmw_request_id_t & header,
+    IntraProcessActionMessage::Type type,
+    std::shared_ptr<void> message)
+  {
+    auto client_queue = intra_process_services_->get_client(client_id);
+    if (!client_queue) {
+      RCLCPP_DEBUG(logger_, "intra-process action client gone, dropping the message");
+      return;
+    }
+    client_queue->push(
+      header,
+      std::make_shared<IntraProcessActionMessage>(
+        IntraProcessActionMessage{type, std::move(message)}));
+  }
+
+  /**
+  * Lock for the goals of action_server_, which rcl_action keeps in an array.
+  *
+  * It is only held to accept, find, cancel and expire goals, and to read their statuses.
+  * Taking requests, sending responses and publishing feedback, statuses and results
+  * don't take it, because the rcl services and publishers are thread-safe, so these can
+  * be done concurrently for different goals.
+  */
   std::recursive_mutex action_server_reentrant_mutex_;
 
   rclcpp::Clock::SharedPtr clock_;
+  rclcpp::Context::SharedPtr context_;
 
   // Do not declare this before clock_ as this depends on clock_(see #1526)
   std::shared_ptr<rcl_action_server_t> action_server_;
@@ -64,18 +310,64 @@ public:
   std::atomic<bool> cancel_request_ready_{false};
   std::atomic<bool> result_request_ready_{false};
   std::atomic<bool> goal_expired_{false};
-
-  // Lock for unordered_maps
+  std::atomic<bool> status_timer_ready_{false};
+
+  /**
+  * Lock for unordered_maps.
+  *
+  * Locking order: unordered_map_mutex_, then action_server_reentrant_mutex_.
+  * No rcl request is sent nor message published while holding it.
+  */
   std::recursive_mutex unordered_map_mutex_;
 
   // Results to be kept until the goal expires after reaching a terminal state
   std::unordered_map<GoalUUID, std::shared_ptr<void>> goal_results_;
   // Requests for results are kept until a result becomes available
   std::unordered_map<GoalUUID, std::vector<rmw_request_id_t>> result_requests_;
+  // Goals whose result is retained, least recently used first, if there is a maximum
+  size_t max_retained_results_ = 0;
+  std::list<GoalUUID> retained_results_;
+  std::unordered_map<GoalUUID, std::list<GoalUUID>::iterator> retained_result_positions_;
+  // Response with an unknown status, answered for the goals whose result was dropped
+  std::shared_ptr<void> dropped_result_response_;
   // rcl goal handles are kept so api to send result doesn't try to access freed memory
   std::unordered_map<GoalUUID, std::shared_ptr<rcl_action_goal_handle_t>> goal_handles_;
 
+  // Lock for the buffers of the expired goals, taken before the other locks
+  std::mutex expired_goals_mutex_;
+  // Reused to take the goals which expired together in batches
+  std::vector<rcl_action_goal_info_t> expired_goals_;
+  std::vector<GoalUUID> expired_uuids_;
+
+  /**
+  * Lock for the status message and the goals whose status changed.
+  *
+  * Locking order: status_mutex_, then unordered_map_mutex_ and action_server_reentrant_mutex_.
+  */
+  std::mutex status_mutex_;
+  // Status message patched as goals change, and the index of each goal in its list
+  action_msgs::msg::GoalStatusArray status_msg_;
+  std::unordered_map<GoalUUID, size_t> status_indices_;
+  // Goals whose status changed since the last status message
+  std::vector<GoalUUID> changed_goals_;
+  std::vector<std::pair<GoalUUID, std::shared_ptr<rcl_action_goal_handle_t>>> changed_goal_handles_;
+  // All the statuses are read again from rcl_action for the next status message
+  bool status_rebuild_pending_ = false;
+  std::chrono::nanoseconds status_publish_period_{0};
+  std::chrono::steady_clock::time_point last_status_publish_time_;
+  // Canceled unless status changes are waiting for the period to elapse
+  rclcpp::TimerBase::SharedPtr status_timer_;
+  size_t status_timer_index_ = 0;
+
   rclcpp::Logger logger_;
+
+  const rosidl_action_type_support_t * type_support_ = nullptr;
+  // Requests of the intra-process clients, registered in the services of the context
+  IntraProcessServices::SharedPtr intra_process_services_;
+  rclcpp::experimental::IntraProcessServiceQueue::SharedPtr intra_process_queue_;
+  uint64_t intra_process_server_id_{0};
+  // Intra-process client of the goals sent by one, protected by unordered_map_mutex_
+  std::unordered_map<GoalUUID, uint64_t> intra_process_goal_clients_;
 };
 }  // namespace rclcpp_action
 
@@ -88,7 +380,8 @@ ServerBase::ServerBase(
   const rcl_action_server_options_t & options
 )
 : pimpl_(new ServerBaseImpl(
-      node_clock->get_clock(), node_logging->get_logger().get_child("rclcpp_action")))
+      node_clock->get_clock(), node_base->get_context(),
+      node_logging->get_logger().get_child("rclcpp_action")))
 {
   auto deleter = [node_base](rcl_action_server_t * ptr)
     {
@@ -109,6 +402,7 @@ ServerBase::ServerBase(
 
   rcl_node_t * rcl_node = node_base->get_rcl_node_handle();
   rcl_clock_t * rcl_clock = pimpl_->clock_->get_clock_handle();
+  pimpl_->type_support_ = type_support;
 
   rcl_ret_t ret = rcl_action_server_init(
     pimpl_->action_server_.get(), rcl_node, rcl_clock, type_support, name.c_str(), &options);
@@ -132,6 +426,65 @@ ServerBase::ServerBase(
 
 ServerBase::~ServerBase()
 {
+  if (pimpl_->intra_process_services_) {
+    pimpl_->intra_process_services_->remove_service(pimpl_->intra_process_server_id_);
+  }
+}
+
+void
+ServerBase::setup_intra_process(
+  const std::shared_ptr<ServerBase> & self,
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base)
+{
+  if (pimpl_->intra_process_queue_) {
+    return;
+  }
+  std::weak_ptr<ServerBase> weak_self = self;
+  pimpl_->intra_process_queue_ = std::make_shared<rclcpp::experimental::IntraProcessServiceQueue>(
+    pimpl_->context_,
+    [weak_self](std::shared_ptr<rmw_request_id_t> request_header, std::shared_ptr<void> data)
+    {
+      auto server = weak_self.lock();
+      if (server) {
+        server->handle_intra_process_message(*request_header, std::move(data));
+      }
+    });
+  // The action type support tells the actions apart from the services of the same name.
+  const std::string action_name = rclcpp::expand_topic_or_service_name(
+    rcl_action_server_get_action_name(pimpl_->action_server_.get()),
+    node_base->get_name(), node_base->get_namespace(), true);
+  pimpl_->intra_process_services_ =
+    pimpl_->context_->get_sub_context<IntraProcessServices>();
+  pimpl_->intra_process_server_id_ = pimpl_->intra_process_services_->add_service(
+    action_name, pimpl_->type_support_, pimpl_->intra_process_queue_);
+}
+
+rclcpp::Waitable::SharedPtr
+ServerBase::get_intra_process_waitable() const
+{
+  return pimpl_->intra_process_queue_;
+}
+
+void
+ServerBase::handle_intra_process_message(
+  const rmw_request_id_t & request_header,
+  std::shared_ptr<void> data)
+{
+  auto message = std::static_pointer_cast<IntraProcessActionMessage>(data);
+  switch (message->type) {
+    case IntraProcessActionMessage::Type::GoalRequest:
+      handle_goal_request(request_header, std::move(message->message));
+      break;
+    case IntraProcessActionMessage::Type::CancelRequest:
+      handle_cancel_request(request_header, std::move(message->message));
+      break;
+    case IntraProcessActionMessage::Type::ResultRequest:
+      handle_result_request(request_header, std::move(message->message));
+      break;
+    default:
+      RCLCPP_ERROR(pimpl_->logger_, "unexpected intra-process action message, ignoring...");
+      break;
+  }
 }
 
 size_t
@@ -143,7 +496,8 @@ ServerBase::get_number_of_ready_subscriptions()
 size_t
 ServerBase::get_number_of_ready_timers()
 {
-  return pimpl_->num_timers_;
+  std::lock_guard<std::mutex> lock(pimpl_->status_mutex_);
+  return pimpl_->num_timers_ + (pimpl_->status_timer_ ? 1u : 0u);
 }
 
 size_t
@@ -173,6 +527,15 @@ ServerBase::add_to_wait_set(rcl_wait_set_t * wait_set)
   if (RCL_RET_OK != ret) {
     rclcpp::exceptions::throw_from_rcl_error(ret, "ServerBase::add_to_wait_set() failed");
   }
+
+  std::lock_guard<std::mutex> status_lock(pimpl_->status_mutex_);
+  if (pimpl_->status_timer_) {
+    ret = rcl_wait_set_add_timer(
+      wait_set, pimpl_->status_timer_->get_timer_handle().get(), &pimpl_->status_timer_index_);
+    if (RCL_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(ret, "ServerBase::add_to_wait_set() failed");
+    }
+  }
 }
 
 bool
@@ -203,10 +566,19 @@ ServerBase::is_ready(rcl_wait_set_t * wait_set)
     rclcpp::exceptions::throw_from_rcl_error(ret);
   }
 
+  {
+    std::lock_guard<std::mutex> lock(pimpl_->status_mutex_);
+    pimpl_->status_timer_ready_ =
+      pimpl_->status_timer_ && pimpl_->status_timer_index_ < wait_set->size_of_timers &&
+      wait_set->timers[pimpl_->status_timer_index_] ==
+      pimpl_->status_timer_->get_timer_handle().get();
+  }
+
   return pimpl_->goal_request_ready_.load() ||
          pimpl_->cancel_request_ready_.load() ||
          pimpl_->result_request_ready_.load() ||
-         pimpl_->goal_expired_.load();
+         pimpl_->goal_expired_.load() ||
+         pimpl_->status_timer_ready_.load();
 }
 
 std::shared_ptr<void>
@@ -217,8 +589,6 @@ ServerBase::take_data()
     rcl_action_goal_info_t goal_info = rcl_action_get_zero_initialized_goal_info();
     rmw_request_id_t request_header;
 
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->action_server_reentrant_mutex_);
-
     std::shared_ptr<void> message = create_goal_request();
     ret = rcl_action_take_goal_request(
       pimpl_->action_server_.get(),
@@ -238,7 +608,6 @@ ServerBase::take_data()
     // Initialize cancel request
     auto request = std::make_shared<action_msgs::srv::CancelGoal::Request>();
 
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->action_server_reentrant_mutex_);
     ret = rcl_action_take_cancel_request(
       pimpl_->action_server_.get(),
       &request_header,
@@ -253,7 +622,6 @@ ServerBase::take_data()
     // Get the result request message
     rmw_request_id_t request_header;
     std::shared_ptr<void> result_request = create_result_request();
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->action_server_reentrant_mutex_);
     ret = rcl_action_take_result_request(
       pimpl_->action_server_.get(), &request_header, result_request.get());
 
@@ -262,6 +630,8 @@ ServerBase::take_data()
         ret, result_request, request_header));
   } else if (pimpl_->goal_expired_.load()) {
     return nullptr;
+  } else if (pimpl_->status_timer_ready_.load()) {
+    return nullptr;
   } else {
     throw std::runtime_error("Taking data from action server but nothing is ready");
   }
@@ -289,7 +659,7 @@ ServerBase::take_data_by_entity_id(size_t id)
 void
 ServerBase::execute(std::shared_ptr<void> & data)
 {
-  if (!data && !pimpl_->goal_expired_.load()) {
+  if (!data && !pimpl_->goal_expired_.load() && !pimpl_->status_timer_ready_.load()) {
     throw std::runtime_error("'data' is empty");
   }
 
@@ -301,6 +671,12 @@ ServerBase::execute(std::shared_ptr<void> & data)
     execute_result_request_received(data);
   } else if (pimpl_->goal_expired_.load()) {
     execute_check_expired_goals();
+  } else if (pimpl_->status_timer_ready_.load()) {
+    pimpl_->status_timer_ready_ = false;
+    std::lock_guard<std::mutex> lock(pimpl_->status_mutex_);
+    if (pimpl_->status_timer_ && !pimpl_->status_timer_->is_canceled()) {
+      pimpl_->publish_pending_status(std::chrono::steady_clock::now());
+    }
   } else {
     throw std::runtime_error("Executing action server but nothing is ready");
   }
@@ -320,7 +696,6 @@ ServerBase::execute_goal_request_received(std::shared_ptr<void> & data)
   } else if (RCL_RET_OK != ret) {
     rclcpp::exceptions::throw_from_rcl_error(ret);
   }
-  rcl_action_goal_info_t goal_info = std::get<1>(*shared_ptr);
   rmw_request_id_t request_header = std::get<2>(*shared_ptr);
   std::shared_ptr<void> message = std::get<3>(*shared_ptr);
 
@@ -329,26 +704,54 @@ ServerBase::execute_goal_request_received(std::shared_ptr<void> & data)
     return;
   }
 
+  handle_goal_request(request_header, std::move(message));
+  data.reset();
+}
+
+void
+ServerBase::handle_goal_request(
+  const rmw_request_id_t & request_header,
+  std::shared_ptr<void> message)
+{
   GoalUUID uuid = get_goal_id_from_goal_request(message.get());
-  convert(uuid, &goal_info);
+
+  // An asynchronous callback responds later, maybe from another thread
+  if (call_async_handle_goal_callback(request_header, uuid, message)) {
+    return;
+  }
 
   // Call user's callback, getting the user's response and a ros message to send back
   auto response_pair = call_handle_goal_callback(uuid, message);
+  respond_to_goal_request(
+    request_header, uuid, std::move(message), response_pair.first, response_pair.second);
+}
 
-  {
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->action_server_reentrant_mutex_);
-    ret = rcl_action_send_goal_response(
-      pimpl_->action_server_.get(),
-      &request_header,
-      response_pair.second.get());
-  }
+bool
+ServerBase::call_async_handle_goal_callback(
+  const rmw_request_id_t &, const GoalUUID &, std::shared_ptr<void>)
+{
+  return false;
+}
+
+void
+ServerBase::respond_to_goal_request(
+  const rmw_request_id_t & request_header,
+  const GoalUUID & uuid,
+  std::shared_ptr<void> message,
+  GoalResponse status,
+  std::shared_ptr<void> ros_response)
+{
+  rcl_action_goal_info_t goal_info = rcl_action_get_zero_initialized_goal_info();
+  convert(uuid, &goal_info);
+
+  rcl_ret_t ret = pimpl_->send_response(
+    IntraProcessActionMessage::Type::GoalResponse, rcl_action_send_goal_response,
+    request_header, std::move(ros_response));
 
   if (RCL_RET_OK != ret) {
     rclcpp::exceptions::throw_from_rcl_error(ret);
   }
 
-  const auto status = response_pair.first;
-
   // if goal is accepted, create a goal handle, and store it
   if (GoalResponse::ACCEPT_AND_EXECUTE == status || GoalResponse::ACCEPT_AND_DEFER == status) {
     RCLCPP_DEBUG(pimpl_->logger_, "Accepted goal %s", to_string(uuid).c_str());
@@ -381,6 +784,13 @@ ServerBase::execute_goal_request_received(std::shared_ptr<void> & data)
     {
       std::lock_guard<std::recursive_mutex> lock(pimpl_->unordered_map_mutex_);
       pimpl_->goal_handles_[uuid] = handle;
+      // The feedback of the goal is handed over to its intra-process client
+      uint64_t client_id;
+      if (pimpl_->intra_process_queue_ &&
+        IntraProcessServices::get_client_id(request_header, client_id))
+      {
+        pimpl_->intra_process_goal_clients_[uuid] = client_id;
+      }
     }
 
     if (GoalResponse::ACCEPT_AND_EXECUTE == status) {
@@ -391,12 +801,11 @@ ServerBase::execute_goal_request_received(std::shared_ptr<void> & data)
       }
     }
     // publish status since a goal's state has changed (was accepted or has begun execution)
-    publish_status();
+    publish_status(uuid);
 
     // Tell user to start executing action
     call_goal_accepted_callback(handle, uuid, message);
   }
-  data.reset();
 }
 
 void
@@ -418,6 +827,17 @@ ServerBase::execute_cancel_request_received(std::shared_ptr<void> & data)
   auto request_header = std::get<2>(*shared_ptr);
   pimpl_->cancel_request_ready_ = false;
 
+  handle_cancel_request(request_header, std::move(request));
+  data.reset();
+}
+
+void
+ServerBase::handle_cancel_request(
+  const rmw_request_id_t & request_header,
+  std::shared_ptr<void> message)
+{
+  auto request = std::static_pointer_cast<action_msgs::srv::CancelGoal::Request>(message);
+
   // Convert c++ message to C message
   rcl_action_cancel_request_t cancel_request = rcl_action_get_zero_initialized_cancel_request();
   convert(request->goal_info.goal_id.uuid, &cancel_request.goal_info);
@@ -427,6 +847,7 @@ ServerBase::execute_cancel_request_received(std::shared_ptr<void> & data)
   // Get a list of goal info that should be attempted to be cancelled
   rcl_action_cancel_response_t cancel_response = rcl_action_get_zero_initialized_cancel_response();
 
+  rcl_ret_t ret;
   {
     std::lock_guard<std::recursive_mutex> lock(pimpl_->action_server_reentrant_mutex_);
     ret = rcl_action_process_cancel_request(
@@ -474,19 +895,20 @@ ServerBase::execute_cancel_request_received(std::shared_ptr<void> & data)
 
   if (!response->goals_canceling.empty()) {
     // at least one goal state changed, publish a new status message
-    publish_status();
+    std::lock_guard<std::mutex> lock(pimpl_->status_mutex_);
+    for (const auto & goal_info : response->goals_canceling) {
+      pimpl_->changed_goals_.push_back(goal_info.goal_id.uuid);
+    }
+    pimpl_->publish_status_if_due();
   }
 
-  {
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->action_server_reentrant_mutex_);
-    ret = rcl_action_send_cancel_response(
-      pimpl_->action_server_.get(), &request_header, response.get());
-  }
+  ret = pimpl_->send_response(
+    IntraProcessActionMessage::Type::CancelResponse, rcl_action_send_cancel_response,
+    request_header, response);
 
   if (RCL_RET_OK != ret) {
     rclcpp::exceptions::throw_from_rcl_error(ret);
   }
-  data.reset();
 }
 
 void
@@ -507,6 +929,16 @@ ServerBase::execute_result_request_received(std::shared_ptr<void> & data)
   auto request_header = std::get<2>(*shared_ptr);
 
   pimpl_->result_request_ready_ = false;
+
+  handle_result_request(request_header, std::move(result_request));
+  data.reset();
+}
+
+void
+ServerBase::handle_result_request(
+  const rmw_request_id_t & request_header,
+  std::shared_ptr<void> result_request)
+{
   std::shared_ptr<void> result_response;
 
   // check if the goal exists
@@ -527,6 +959,7 @@ ServerBase::execute_result_request_received(std::shared_ptr<void> & data)
     auto iter = pimpl_->goal_results_.find(uuid);
     if (iter != pimpl_->goal_results_.end()) {
       result_response = iter->second;
+      pimpl_->use_result(uuid);
     } else {
       // Store the request so it can be responded to later
       pimpl_->result_requests_[uuid].push_back(request_header);
@@ -535,102 +968,126 @@ ServerBase::execute_result_request_received(std::shared_ptr<void> & data)
 
   if (result_response) {
     // Send the result now
-    std::lock_guard<std::recursive_mutex> lock(pimpl_->action_server_reentrant_mutex_);
-    rcl_ret_t rcl_ret = rcl_action_send_result_response(
-      pimpl_->action_server_.get(), &request_header, result_response.get());
+    rcl_ret_t rcl_ret = pimpl_->send_response(
+      IntraProcessActionMessage::Type::ResultResponse, rcl_action_send_result_response,
+      request_header, result_response);
     if (RCL_RET_OK != rcl_ret) {
       rclcpp::exceptions::throw_from_rcl_error(rcl_ret);
     }
   }
-  data.reset();
 }
 
 void
 ServerBase::execute_check_expired_goals()
 {
-  // Allocate expecting only one goal to expire at a time
-  rcl_action_goal_info_t expired_goals[1];
-  size_t num_expired = 1;
-
-  // Loop in case more than 1 goal expired
-  while (num_expired > 0u) {
+  // Number of goals taken from rcl_action at once
+  constexpr size_t expired_goals_batch_size = 64u;
+
+  std::lock_guard<std::mutex> expired_goals_lock(pimpl_->expired_goals_mutex_);
+  auto & expired_goals = pimpl_->expired_goals_;
+  auto & expired_uuids = pimpl_->expired_uuids_;
+  expired_goals.resize(expired_goals_batch_size);
+  expired_uuids.clear();
+
+  // Loop in case more goals expired than fit in a batch
+  size_t num_expired = expired_goals.size();
+  while (num_expired == expired_goals.size()) {
     rcl_ret_t ret;
     {
       std::lock_guard<std::recursive_mutex> lock(pimpl_->action_server_reentrant_mutex_);
-      ret = rcl_action_expire_goals(pimpl_->action_server_.get(), expired_goals, 1, &num_expired);
+      ret = rcl_action_expire_goals(
+        pimpl_->action_server_.get(), expired_goals.data(), expired_goals.size(), &num_expired);
     }
     if (RCL_RET_OK != ret) {
       rclcpp::exceptions::throw_from_rcl_error(ret);
-    } else if (num_expired) {
-      // A goal expired!
+    }
+    for (size_t i = 0; i < num_expired; ++i) {
       GoalUUID uuid;
-      convert(expired_goals[0], &uuid);
+      convert(expired_goals[i], &uuid);
       RCLCPP_DEBUG(pimpl_->logger_, "Expired goal %s", to_string(uuid).c_str());
-      std::lock_guard<std::recursive_mutex> lock(pimpl_->unordered_map_mutex_);
+      expired_uuids.push_back(uuid);
+    }
+  }
+  if (expired_uuids.empty()) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->unordered_map_mutex_);
+    for (const GoalUUID & uuid : expired_uuids) {
       pimpl_->goal_results_.erase(uuid);
+      pimpl_->forget_result(uuid);
       pimpl_->result_requests_.erase(uuid);
       pimpl_->goal_handles_.erase(uuid);
+      pimpl_->intra_process_goal_clients_.erase(uuid);
     }
   }
+  // Removed from the next status message
+  std::lock_guard<std::mutex> lock(pimpl_->status_mutex_);
+  pimpl_->changed_goals_.insert(
+    pimpl_->changed_goals_.end(), expired_uuids.begin(), expired_uuids.end());
 }
 
 void
-ServerBase::publish_status()
+ServerBase::set_status_publish_period(std::chrono::nanoseconds period)
 {
-  rcl_ret_t ret;
-
-  // We need to hold the lock across this entire method because
-  // rcl_action_server_get_goal_handles() returns an internal pointer to the
-  // goal data.
-  std::lock_guard<std::recursive_mutex> lock(pimpl_->action_server_reentrant_mutex_);
-
-  // Get all goal handles known to C action server
-  rcl_action_goal_handle_t ** goal_handles = NULL;
-  size_t num_goals = 0;
-  ret = rcl_action_server_get_goal_handles(
-    pimpl_->action_server_.get(), &goal_handles, &num_goals);
-
-  if (RCL_RET_OK != ret) {
-    rclcpp::exceptions::throw_from_rcl_error(ret);
+  if (period < std::chrono::nanoseconds::zero()) {
+    throw std::invalid_argument("the status publish period can't be negative");
   }
-
-  auto status_msg = std::make_shared<action_msgs::msg::GoalStatusArray>();
-  status_msg->status_list.reserve(num_goals);
-  // Populate a c++ status message with the goals and their statuses
-  rcl_action_goal_status_array_t c_status_array =
-    rcl_action_get_zero_initialized_goal_status_array();
-  ret = rcl_action_get_goal_status_array(pimpl_->action_server_.get(), &c_status_array);
-  if (RCL_RET_OK != ret) {
-    rclcpp::exceptions::throw_from_rcl_error(ret);
+  std::lock_guard<std::mutex> lock(pimpl_->status_mutex_);
+  if (pimpl_->status_timer_ && !pimpl_->status_timer_->is_canceled()) {
+    // Don't delay the pending status changes more than the previous period.
+    pimpl_->publish_pending_status(std::chrono::steady_clock::now());
   }
+  pimpl_->status_publish_period_ = period;
+  if (period == std::chrono::nanoseconds::zero()) {
+    pimpl_->status_timer_.reset();
+    return;
+  }
+  pimpl_->status_timer_ = std::make_shared<rclcpp::WallTimer<rclcpp::VoidCallbackType>>(
+    period, []() {}, pimpl_->context_);
+  pimpl_->status_timer_->cancel();
+}
 
-  RCPPUTILS_SCOPE_EXIT(
-  {
-    ret = rcl_action_goal_status_array_fini(&c_status_array);
-    if (RCL_RET_OK != ret) {
-      RCLCPP_ERROR(pimpl_->logger_, "Failed to fini status array message");
-    }
-  });
-
-  for (size_t i = 0; i < c_status_array.msg.status_list.size; ++i) {
-    auto & c_status_msg = c_status_array.msg.status_list.data[i];
-
-    action_msgs::msg::GoalStatus msg;
-    msg.status = c_status_msg.status;
-    // Convert C goal info to C++ goal info
-    convert(c_status_msg.goal_info, &msg.goal_info.goal_id.uuid);
-    msg.goal_info.stamp.sec = c_status_msg.goal_info.stamp.sec;
-    msg.goal_info.stamp.nanosec = c_status_msg.goal_info.stamp.nanosec;
+void
+ServerBase::set_max_retained_results(size_t max_results)
+{
+  auto dropped_result_response =
+    create_result_response(action_msgs::msg::GoalStatus::STATUS_UNKNOWN);
+  std::lock_guard<std::recursive_mutex> lock(pimpl_->unordered_map_mutex_);
+  pimpl_->dropped_result_response_ = std::move(dropped_result_response);
+  if (max_results == 0) {
+    pimpl_->retained_results_.clear();
+    pimpl_->retained_result_positions_.clear();
+  }
+  pimpl_->max_retained_results_ = max_results;
+  pimpl_->drop_results_beyond_maximum();
+}
 
-    status_msg->status_list.push_back(msg);
+void
+ServerBase::execute_timers()
+{
+  execute_check_expired_goals();
+  std::lock_guard<std::mutex> lock(pimpl_->status_mutex_);
+  if (pimpl_->status_timer_ && !pimpl_->status_timer_->is_canceled()) {
+    pimpl_->publish_status_if_due();
   }
+}
 
-  // Publish the message through the status publisher
-  ret = rcl_action_publish_status(pimpl_->action_server_.get(), status_msg.get());
+void
+ServerBase::publish_status()
+{
+  std::lock_guard<std::mutex> lock(pimpl_->status_mutex_);
+  pimpl_->status_rebuild_pending_ = true;
+  pimpl_->publish_status_if_due();
+}
 
-  if (RCL_RET_OK != ret) {
-    rclcpp::exceptions::throw_from_rcl_error(ret);
-  }
+void
+ServerBase::publish_status(const GoalUUID & uuid)
+{
+  std::lock_guard<std::mutex> lock(pimpl_->status_mutex_);
+  pimpl_->changed_goals_.push_back(uuid);
+  pimpl_->publish_status_if_due();
 }
 
 void
@@ -649,32 +1106,28 @@ ServerBase::publish_result(const GoalUUID & uuid, std::shared_ptr<void> result_m
     throw std::runtime_error("Asked to publish result for goal that does not exist");
   }
 
+  // The clients who already asked for the result, to send it to them
+  std::vector<rmw_request_id_t> request_headers;
   {
-    /**
-    * NOTE: There is a potential deadlock issue if both unordered_map_mutex_ and
-    * action_server_reentrant_mutex_ locked in other block scopes. Unless using
-    * std::scoped_lock, locking order must be consistent with the current.
-    *
-    * Current locking order:
-    *
-    *   1. unordered_map_mutex_
-    *   2. action_server_reentrant_mutex_
-    *
-    */
     std::lock_guard<std::recursive_mutex> unordered_map_lock(pimpl_->unordered_map_mutex_);
     pimpl_->goal_results_[uuid] = result_msg;
+    pimpl_->retain_result(uuid);
 
-    // if there are clients who already asked for the result, send it to them
+    // Later requests are answered with the stored result
     auto iter = pimpl_->result_requests_.find(uuid);
     if (iter != pimpl_->result_requests_.end()) {
-      std::lock_guard<std::recursive_mutex> lock(pimpl_->action_server_reentrant_mutex_);
-      for (auto & request_header : iter->second) {
-        rcl_ret_t ret = rcl_action_send_result_response(
-          pimpl_->action_server_.get(), &request_header, result_msg.get());
-        if (RCL_RET_OK != ret) {
-          rclcpp::exceptions::throw_from_rcl_error(ret);
-        }
-      }
+      request_headers = std::move(iter->second);
+      pimpl_->result_requests_.erase(iter);
+    }
+  }
+
+  // Sent without holding any lock, so results of other goals can be sent meanwhile
+  for (const auto & request_header : request_headers) {
+    rcl_ret_t ret = pimpl_->send_response(
+      IntraProcessActionMessage::Type::ResultResponse, rcl_action_send_result_response,
+      request_header, result_msg);
+    if (RCL_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(ret);
     }
   }
 }
@@ -692,13 +1145,43 @@ ServerBase::notify_goal_terminal_state()
 void
 ServerBase::publish_feedback(std::shared_ptr<void> feedback_msg)
 {
-  std::lock_guard<std::recursive_mutex> lock(pimpl_->action_server_reentrant_mutex_);
+  // The publisher is thread-safe, so goals can publish feedback concurrently.
   rcl_ret_t ret = rcl_action_publish_feedback(pimpl_->action_server_.get(), feedback_msg.get());
   if (RCL_RET_OK != ret) {
     rclcpp::exceptions::throw_from_rcl_error(ret, "Failed to publish feedback");
   }
 }
 
+bool
+ServerBase::is_intra_process_goal(const GoalUUID & uuid)
+{
+  if (!pimpl_->intra_process_queue_) {
+    return false;
+  }
+  std::lock_guard<std::recursive_mutex> lock(pimpl_->unordered_map_mutex_);
+  return pimpl_->intra_process_goal_clients_.count(uuid) != 0;
+}
+
+void
+ServerBase::publish_intra_process_feedback(
+  const GoalUUID & uuid,
+  std::shared_ptr<void> feedback_msg)
+{
+  uint64_t client_id;
+  {
+    std::lock_guard<std::recursive_mutex> lock(pimpl_->unordered_map_mutex_);
+    auto it = pimpl_->intra_process_goal_clients_.find(uuid);
+    if (it == pimpl_->intra_process_goal_clients_.end()) {
+      return;
+    }
+    client_id = it->second;
+  }
+  // The feedback isn't a response, so its header only identifies the client.
+  pimpl_->push_to_intra_process_client(
+    client_id, IntraProcessServices::make_request_id(client_id, 0),
+    IntraProcessActionMessage::Type::Feedback, std::move(feedback_msg));
+}
+
 void
 ServerBase::set_on_ready_callback(std::function<void(size_t, int)> callback)
 {
@@ -0,0 +1,125 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "test_msgs/action/fibonacci.hpp"
+
+#include "./process_memory.hpp"
+
+using performance_test_fixture::PerformanceTest;
+
+using Fibonacci = test_msgs::action::Fibonacci;
+using GoalHandle = rclcpp_action::ServerGoalHandle<Fibonacci>;
+
+/// Creation of N action servers or clients, reporting the memory used by each of them.
+/**
+ * Like the entity footprint benchmark of rclcpp, it reports the heap bytes measured
+ * with the allocator of glibc and the resident memory used by each action.
+ */
+class ActionFootprintPerformanceTest : public PerformanceTest
+{
+public:
+  void SetUp(benchmark::State & state)
+  {
+    rclcpp::init(0, nullptr);
+    node = std::make_shared<rclcpp::Node>("footprint_node");
+    // The first action may initialize things shared by the other ones
+    create_actions(state.range(0) != 0, 1u);
+    actions.clear();
+
+    PerformanceTest::SetUp(state);
+  }
+
+  void TearDown(benchmark::State & state)
+  {
+    PerformanceTest::TearDown(state);
+    actions.clear();
+    node.reset();
+    rclcpp::shutdown();
+  }
+
+protected:
+  void create_actions(bool clients, size_t number_of_actions)
+  {
+    for (size_t i = 0u; i < number_of_actions; ++i) {
+      const std::string name = "action_" + std::to_string(i);
+      if (clients) {
+        actions.push_back(rclcpp_action::create_client<Fibonacci>(node, name));
+        continue;
+      }
+      actions.push_back(
+        rclcpp_action::create_server<Fibonacci>(
+          node, name,
+          [](const rclcpp_action::GoalUUID &, std::shared_ptr<const Fibonacci::Goal>) {
+            return rclcpp_action::GoalResponse::REJECT;
+          },
+          [](std::shared_ptr<GoalHandle>) {
+            return rclcpp_action::CancelResponse::REJECT;
+          },
+          [](std::shared_ptr<GoalHandle>) {}));
+    }
+  }
+
+  rclcpp::Node::SharedPtr node;
+  std::vector<std::shared_ptr<void>> actions;
+};
+
+static void footprint_arguments(benchmark::internal::Benchmark * benchmark)
+{
+  for (int64_t clients : {0, 1}) {
+    for (int64_t number_of_actions : {10, 100}) {
+      benchmark->Args({clients, number_of_actions});
+    }
+  }
+  benchmark->ArgNames({"clients", "actions"});
+}
+
+BENCHMARK_DEFINE_F(ActionFootprintPerformanceTest, create_actions)(benchmark::State & state)
+{
+  const auto number_of_actions = static_cast<size_t>(state.range(1));
+  double heap_bytes = 0.;
+  double rss_kib = 0.;
+
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    state.PauseTiming();
+    const double heap_bytes_before = get_heap_bytes();
+    const double rss_kib_before = get_rss_kib();
+    state.ResumeTiming();
+
+    create_actions(state.range(0) != 0, number_of_actions);
+
+    state.PauseTiming();
+    heap_bytes = get_heap_bytes() - heap_bytes_before;
+    // The pages freed by the previous iterations are reused, so the largest increase is kept
+    rss_kib = std::max(rss_kib, get_rss_kib() - rss_kib_before);
+    actions.clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+  state.counters["heap_bytes_per_action"] = heap_bytes / static_cast<double>(number_of_actions);
+  state.counters["rss_kib_per_action"] = rss_kib / static_cast<double>(number_of_actions);
+}
+BENCHMARK_REGISTER_F(ActionFootprintPerformanceTest, create_actions)
+  ->Apply(footprint_arguments)->UseRealTime();
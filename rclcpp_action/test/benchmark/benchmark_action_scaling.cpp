@@ -0,0 +1,250 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "test_msgs/action/fibonacci.hpp"
+
+using performance_test_fixture::PerformanceTest;
+using namespace std::chrono_literals;
+
+using Fibonacci = test_msgs::action::Fibonacci;
+using GoalHandle = rclcpp_action::ServerGoalHandle<Fibonacci>;
+using ClientGoalHandle = rclcpp_action::ClientGoalHandle<Fibonacci>;
+using GoalUUID = rclcpp_action::GoalUUID;
+
+constexpr char fibonacci_action_name[] = "fibonacci";
+constexpr std::chrono::seconds response_timeout = 10s;
+
+/// An action server and its client, handling the number of goals given as benchmark argument.
+/**
+ * The goals are accepted and deferred, and expire as soon as they are terminated, so that
+ * each benchmark iteration starts with the same number of goals in the server.
+ */
+class ActionScalingPerformanceTest : public PerformanceTest
+{
+public:
+  void SetUp(benchmark::State & state)
+  {
+    rclcpp::init(0, nullptr);
+    node = std::make_shared<rclcpp::Node>("node", "ns");
+
+    rcl_action_server_options_t options = rcl_action_server_get_default_options();
+    options.result_timeout.nanoseconds = 0;
+    action_server = rclcpp_action::create_server<Fibonacci>(
+      node, fibonacci_action_name,
+      [](const GoalUUID &, std::shared_ptr<const Fibonacci::Goal>) {
+        return rclcpp_action::GoalResponse::ACCEPT_AND_DEFER;
+      },
+      [](std::shared_ptr<GoalHandle>) {
+        return rclcpp_action::CancelResponse::ACCEPT;
+      },
+      [this](std::shared_ptr<GoalHandle> goal_handle) {
+        server_goal_handles.push_back(goal_handle);
+      },
+      options);
+    action_client = rclcpp_action::create_client<Fibonacci>(node, fibonacci_action_name);
+    if (!action_client->wait_for_action_server(response_timeout)) {
+      state.SkipWithError("the action server wasn't discovered");
+    }
+
+    performance_test_fixture::PerformanceTest::SetUp(state);
+  }
+
+  void TearDown(benchmark::State & state)
+  {
+    performance_test_fixture::PerformanceTest::TearDown(state);
+
+    server_goal_handles.clear();
+    action_client.reset();
+    action_server.reset();
+    node.reset();
+    rclcpp::shutdown();
+  }
+
+protected:
+  /// Send goals and wait until they are all accepted, returning false on timeout.
+  bool send_goals(size_t number_of_goals, std::vector<ClientGoalHandle::SharedPtr> & goal_handles)
+  {
+    Fibonacci::Goal goal;
+    goal.order = 1;
+    std::vector<std::shared_future<ClientGoalHandle::SharedPtr>> futures;
+    for (size_t i = 0; i < number_of_goals; ++i) {
+      futures.push_back(action_client->async_send_goal(goal));
+    }
+    for (auto & future : futures) {
+      if (rclcpp::spin_until_future_complete(node, future, response_timeout) !=
+        rclcpp::FutureReturnCode::SUCCESS || !future.get())
+      {
+        return false;
+      }
+      goal_handles.push_back(future.get());
+    }
+    return true;
+  }
+
+  /// Terminate the goals of the server, which are then expired by the next spin.
+  void succeed_goals()
+  {
+    auto result = std::make_shared<Fibonacci::Result>();
+    for (const auto & goal_handle : server_goal_handles) {
+      if (goal_handle->is_executing()) {
+        goal_handle->succeed(result);
+      } else if (goal_handle->is_active()) {
+        goal_handle->abort(result);
+      }
+    }
+    server_goal_handles.clear();
+  }
+
+  std::shared_ptr<rclcpp::Node> node;
+  std::shared_ptr<rclcpp_action::Server<Fibonacci>> action_server;
+  std::shared_ptr<rclcpp_action::Client<Fibonacci>> action_client;
+  std::vector<std::shared_ptr<GoalHandle>> server_goal_handles;
+};
+
+static void goal_counts(benchmark::internal::Benchmark * benchmark)
+{
+  benchmark->Arg(1)->Arg(10)->Arg(100)->ArgName("goals");
+}
+
+/// Round trip of N goals sent together: acceptance, execution and result.
+BENCHMARK_DEFINE_F(ActionScalingPerformanceTest, concurrent_goals)(benchmark::State & state)
+{
+  const auto number_of_goals = static_cast<size_t>(state.range(0));
+  std::vector<ClientGoalHandle::SharedPtr> goal_handles;
+  std::vector<std::shared_future<ClientGoalHandle::WrappedResult>> result_futures;
+
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    goal_handles.clear();
+    result_futures.clear();
+    if (!send_goals(number_of_goals, goal_handles)) {
+      state.SkipWithError("the goals weren't accepted");
+      break;
+    }
+    for (const auto & goal_handle : goal_handles) {
+      result_futures.push_back(action_client->async_get_result(goal_handle));
+    }
+    for (const auto & goal_handle : server_goal_handles) {
+      goal_handle->execute();
+    }
+    succeed_goals();
+    for (auto & future : result_futures) {
+      if (rclcpp::spin_until_future_complete(node, future, response_timeout) !=
+        rclcpp::FutureReturnCode::SUCCESS)
+      {
+        state.SkipWithError("the results weren't received");
+        return;
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_REGISTER_F(ActionScalingPerformanceTest, concurrent_goals)
+  ->Apply(goal_counts)->UseRealTime();
+
+/// Feedback published once for each of N executing goals.
+BENCHMARK_DEFINE_F(ActionScalingPerformanceTest, publish_feedback)(benchmark::State & state)
+{
+  std::vector<ClientGoalHandle::SharedPtr> goal_handles;
+  if (!send_goals(static_cast<size_t>(state.range(0)), goal_handles)) {
+    state.SkipWithError("the goals weren't accepted");
+    return;
+  }
+  for (const auto & goal_handle : server_goal_handles) {
+    goal_handle->execute();
+  }
+  auto feedback = std::make_shared<Fibonacci::Feedback>();
+  feedback->sequence = {0, 1, 1, 2, 3, 5, 8, 13};
+
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    for (const auto & goal_handle : server_goal_handles) {
+      goal_handle->publish_feedback(feedback);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  succeed_goals();
+}
+BENCHMARK_REGISTER_F(ActionScalingPerformanceTest, publish_feedback)->Apply(goal_counts);
+
+/// Status message published by a goal state change, with N other goals in the server.
+BENCHMARK_DEFINE_F(ActionScalingPerformanceTest, publish_status)(benchmark::State & state)
+{
+  std::vector<ClientGoalHandle::SharedPtr> goal_handles;
+  if (!send_goals(static_cast<size_t>(state.range(0)), goal_handles)) {
+    state.SkipWithError("the goals weren't accepted");
+    return;
+  }
+  // The retained goals are kept active so that they don't expire
+  const auto retained_goal_handles = server_goal_handles;
+  auto result = std::make_shared<Fibonacci::Result>();
+
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    state.PauseTiming();
+    server_goal_handles.clear();
+    goal_handles.clear();
+    if (!send_goals(1, goal_handles)) {
+      state.SkipWithError("the goal wasn't accepted");
+      break;
+    }
+    auto server_goal_handle = server_goal_handles.back();
+    state.ResumeTiming();
+
+    server_goal_handle->execute();
+
+    state.PauseTiming();
+    server_goal_handle->succeed(result);
+    state.ResumeTiming();
+  }
+  server_goal_handles = retained_goal_handles;
+  succeed_goals();
+}
+BENCHMARK_REGISTER_F(ActionScalingPerformanceTest, publish_status)->Apply(goal_counts);
+
+/// Expiration of N goals which terminated together.
+BENCHMARK_DEFINE_F(ActionScalingPerformanceTest, expire_goals)(benchmark::State & state)
+{
+  const auto number_of_goals = static_cast<size_t>(state.range(0));
+  std::vector<ClientGoalHandle::SharedPtr> goal_handles;
+
+  reset_heap_counters();
+  for (auto _ : state) {
+    (void)_;
+    state.PauseTiming();
+    goal_handles.clear();
+    if (!send_goals(number_of_goals, goal_handles)) {
+      state.SkipWithError("the goals weren't accepted");
+      break;
+    }
+    succeed_goals();
+    state.ResumeTiming();
+
+    // The goals expire immediately, so the expiration timer of the server is ready.
+    // This also includes taking the status messages and results received by the client.
+    rclcpp::spin_some(node);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_REGISTER_F(ActionScalingPerformanceTest, expire_goals)->Apply(goal_counts);
@@ -605,6 +605,30 @@ TEST_F(TestClientAgainstServer, async_send_goal_with_result_callback_wait_for_re
   EXPECT_EQ(3, wrapped_result.result->sequence.back());
 }
 
+TEST_F(TestClientAgainstServer, async_send_goal_with_result_requested_with_goal)
+{
+  auto action_client = rclcpp_action::create_client<ActionType>(client_node, action_name);
+  ASSERT_TRUE(action_client->wait_for_action_server(WAIT_FOR_SERVER_TIMEOUT));
+
+  ActionGoal goal;
+  goal.order = 4;
+  auto send_goal_ops = rclcpp_action::Client<ActionType>::SendGoalOptions();
+  send_goal_ops.request_result_with_goal = true;
+  auto future_goal_handle = action_client->async_send_goal(goal, send_goal_ops);
+  dual_spin_until_future_complete(future_goal_handle);
+  auto goal_handle = future_goal_handle.get();
+  ASSERT_NE(goal_handle, nullptr);
+  // The result was requested with the goal, even without result callback
+  EXPECT_TRUE(goal_handle->is_result_aware());
+  auto future_result = action_client->async_get_result(goal_handle);
+  dual_spin_until_future_complete(future_result);
+  auto wrapped_result = future_result.get();
+
+  EXPECT_EQ(rclcpp_action::ResultCode::SUCCEEDED, wrapped_result.code);
+  ASSERT_EQ(5u, wrapped_result.result->sequence.size());
+  EXPECT_EQ(3, wrapped_result.result->sequence.back());
+}
+
 TEST_F(TestClientAgainstServer, async_get_result_with_callback)
 {
   auto action_client = rclcpp_action::create_client<ActionType>(client_node, action_name);
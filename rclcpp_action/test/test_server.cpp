@@ -12,7 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <chrono>
+#include <future>
 #include <memory>
+#include <set>
+#include <thread>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -25,6 +29,8 @@
 
 #include "rcl_action/action_server.h"
 #include "rcl_action/wait.h"
+#include "rclcpp_action/action_waitable_group.hpp"
+#include "rclcpp_action/create_client.hpp"
 #include "rclcpp_action/create_server.hpp"
 #include "rclcpp_action/server.hpp"
 #include "mocking_utils/patch.hpp"
@@ -305,6 +311,117 @@ TEST_F(TestServer, handle_accepted_called)
   EXPECT_EQ(request->goal, *(received_handle->get_goal()));
 }
 
+TEST_F(TestServer, handle_goal_async)
+{
+  auto node = std::make_shared<rclcpp::Node>("handle_goal_async_node", "/rclcpp_action/async");
+  const GoalUUID deferred_uuid{{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16}};
+  const GoalUUID uuid{{2, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16}};
+
+  using GoalHandle = rclcpp_action::ServerGoalHandle<Fibonacci>;
+  using GoalResponder = rclcpp_action::Server<Fibonacci>::GoalResponder;
+
+  // The goals are decided on right away, except the deferred one
+  GoalResponder deferred_responder;
+  auto handle_goal = [&deferred_uuid, &deferred_responder](
+    const GoalUUID & goal_uuid, std::shared_ptr<const Fibonacci::Goal>, GoalResponder responder)
+    {
+      if (goal_uuid == deferred_uuid) {
+        deferred_responder = responder;
+        return;
+      }
+      responder(rclcpp_action::GoalResponse::ACCEPT_AND_EXECUTE);
+    };
+
+  std::vector<std::shared_ptr<GoalHandle>> received_handles;
+  auto handle_accepted = [&received_handles](std::shared_ptr<GoalHandle> handle)
+    {
+      received_handles.push_back(handle);
+    };
+
+  auto as = rclcpp_action::create_server<Fibonacci>(
+    node, "fibonacci",
+    handle_goal,
+    [](std::shared_ptr<GoalHandle>) {
+      return rclcpp_action::CancelResponse::REJECT;
+    },
+    handle_accepted);
+  (void)as;
+
+  auto client = node->create_client<Fibonacci::Impl::SendGoalService>(
+    "fibonacci/_action/send_goal");
+  ASSERT_TRUE(client->wait_for_service(std::chrono::seconds(20)));
+  auto deferred_request = std::make_shared<Fibonacci::Impl::SendGoalService::Request>();
+  deferred_request->goal_id.uuid = deferred_uuid;
+  auto deferred_future = client->async_send_request(deferred_request);
+
+  // The other goals are handled while the deferred one waits for its decision
+  send_goal_request(node, uuid);
+  ASSERT_TRUE(deferred_responder);
+  ASSERT_EQ(1u, received_handles.size());
+  EXPECT_EQ(uuid, received_handles[0]->get_goal_id());
+  EXPECT_EQ(
+    std::future_status::timeout, deferred_future.wait_for(std::chrono::seconds(0)));
+
+  std::thread responding_thread([&deferred_responder]() {
+      deferred_responder(rclcpp_action::GoalResponse::ACCEPT_AND_DEFER);
+      // Only the first decision counts
+      deferred_responder(rclcpp_action::GoalResponse::REJECT);
+    });
+  responding_thread.join();
+  ASSERT_EQ(
+    rclcpp::FutureReturnCode::SUCCESS,
+    rclcpp::spin_until_future_complete(node, deferred_future, std::chrono::seconds(20)));
+  EXPECT_TRUE(deferred_future.get()->accepted);
+  ASSERT_EQ(2u, received_handles.size());
+  EXPECT_EQ(deferred_uuid, received_handles[1]->get_goal_id());
+  EXPECT_TRUE(received_handles[1]->is_active());
+  EXPECT_FALSE(received_handles[1]->is_executing());
+}
+
+TEST_F(TestServer, handle_goal_async_reject)
+{
+  auto node = std::make_shared<rclcpp::Node>(
+    "handle_goal_async_reject_node", "/rclcpp_action/async_reject");
+
+  using GoalHandle = rclcpp_action::ServerGoalHandle<Fibonacci>;
+  using GoalResponder = rclcpp_action::Server<Fibonacci>::GoalResponder;
+
+  GoalResponder responder;
+  bool accepted_called = false;
+  auto as = rclcpp_action::create_server<Fibonacci>(
+    node, "fibonacci",
+    [&responder](const GoalUUID &, std::shared_ptr<const Fibonacci::Goal>, GoalResponder r) {
+      responder = r;
+    },
+    [](std::shared_ptr<GoalHandle>) {
+      return rclcpp_action::CancelResponse::REJECT;
+    },
+    [&accepted_called](std::shared_ptr<GoalHandle>) {accepted_called = true;});
+
+  auto client = node->create_client<Fibonacci::Impl::SendGoalService>(
+    "fibonacci/_action/send_goal");
+  ASSERT_TRUE(client->wait_for_service(std::chrono::seconds(20)));
+  auto request = std::make_shared<Fibonacci::Impl::SendGoalService::Request>();
+  request->goal_id.uuid = GoalUUID{{3, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16}};
+  auto future = client->async_send_request(request);
+  auto start = std::chrono::steady_clock::now();
+  while (!responder && std::chrono::steady_clock::now() - start < std::chrono::seconds(20)) {
+    rclcpp::spin_some(node);
+  }
+  ASSERT_TRUE(responder);
+
+  responder(rclcpp_action::GoalResponse::REJECT);
+  ASSERT_EQ(
+    rclcpp::FutureReturnCode::SUCCESS,
+    rclcpp::spin_until_future_complete(node, future, std::chrono::seconds(20)));
+  EXPECT_FALSE(future.get()->accepted);
+  EXPECT_FALSE(accepted_called);
+
+  // Deciding after the server is gone does nothing
+  as.reset();
+  EXPECT_NO_THROW(responder(rclcpp_action::GoalResponse::ACCEPT_AND_EXECUTE));
+}
+
 TEST_F(TestServer, handle_cancel_called)
 {
   auto node = std::make_shared<rclcpp::Node>("handle_cancel_node", "/rclcpp_action/handle_cancel");
@@ -710,6 +827,70 @@ TEST_F(TestServer, publish_status_succeeded)
   EXPECT_EQ(uuid, msg->status_list.at(0).goal_info.goal_id.uuid);
 }
 
+TEST_F(TestServer, publish_status_rate_limited)
+{
+  auto node = std::make_shared<rclcpp::Node>("status_rate", "/rclcpp_action/status_rate");
+  const GoalUUID uuid{{1, 2, 3, 40, 5, 6, 70, 8, 9, 1, 11, 120, 13, 140, 15, 160}};
+
+  auto handle_goal = [](
+    const GoalUUID &, std::shared_ptr<const Fibonacci::Goal>)
+    {
+      return rclcpp_action::GoalResponse::ACCEPT_AND_EXECUTE;
+    };
+
+  using GoalHandle = rclcpp_action::ServerGoalHandle<Fibonacci>;
+
+  auto handle_cancel = [](std::shared_ptr<GoalHandle>)
+    {
+      return rclcpp_action::CancelResponse::REJECT;
+    };
+
+  std::shared_ptr<GoalHandle> received_handle;
+  auto handle_accepted = [&received_handle](std::shared_ptr<GoalHandle> handle)
+    {
+      received_handle = handle;
+    };
+
+  auto as = rclcpp_action::create_server<Fibonacci>(
+    node, "fibonacci",
+    handle_goal,
+    handle_cancel,
+    handle_accepted);
+  EXPECT_THROW(
+    as->set_status_publish_period(std::chrono::milliseconds(-1)), std::invalid_argument);
+  as->set_status_publish_period(std::chrono::milliseconds(500));
+
+  // Subscribe to status messages
+  std::vector<action_msgs::msg::GoalStatusArray::ConstSharedPtr> received_msgs;
+  auto subscriber = node->create_subscription<action_msgs::msg::GoalStatusArray>(
+    "fibonacci/_action/status", 10,
+    [&received_msgs](action_msgs::msg::GoalStatusArray::ConstSharedPtr list)
+    {
+      received_msgs.push_back(list);
+    });
+
+  send_goal_request(node, uuid);
+  // Published within the period of the status published when the goal was accepted
+  received_handle->succeed(std::make_shared<Fibonacci::Result>());
+
+  // 10 seconds
+  const size_t max_tries = 10 * 1000 / 100;
+  auto succeeded = [&received_msgs]() {
+      return !received_msgs.empty() && 1u == received_msgs.back()->status_list.size() &&
+             action_msgs::msg::GoalStatus::STATUS_SUCCEEDED ==
+             received_msgs.back()->status_list.at(0).status;
+    };
+  for (size_t retry = 0; retry < max_tries && !succeeded(); ++retry) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    rclcpp::spin_some(node);
+  }
+
+  ASSERT_TRUE(succeeded());
+  EXPECT_EQ(uuid, received_msgs.back()->status_list.at(0).goal_info.goal_id.uuid);
+  // At most the executing status, then the succeeded one.
+  EXPECT_GE(2u, received_msgs.size());
+}
+
 TEST_F(TestServer, publish_status_aborted)
 {
   auto node = std::make_shared<rclcpp::Node>("status_aborted", "/rclcpp_action/status_aborted");
@@ -825,6 +1006,294 @@ TEST_F(TestServer, publish_feedback)
   ASSERT_EQ(sent_message->sequence, msg->feedback.sequence);
 }
 
+TEST_F(TestServer, publish_feedback_borrowed_and_throttled)
+{
+  auto node = std::make_shared<rclcpp::Node>(
+    "pub_feedback_throttled", "/rclcpp_action/pub_feedback_throttled");
+  const GoalUUID uuid{{1, 20, 30, 4, 5, 6, 70, 8, 9, 1, 11, 120, 13, 14, 15, 161}};
+
+  auto handle_goal = [](
+    const GoalUUID &, std::shared_ptr<const Fibonacci::Goal>)
+    {
+      return rclcpp_action::GoalResponse::ACCEPT_AND_EXECUTE;
+    };
+
+  using GoalHandle = rclcpp_action::ServerGoalHandle<Fibonacci>;
+
+  auto handle_cancel = [](std::shared_ptr<GoalHandle>)
+    {
+      return rclcpp_action::CancelResponse::REJECT;
+    };
+
+  std::shared_ptr<GoalHandle> received_handle;
+  auto handle_accepted = [&received_handle](std::shared_ptr<GoalHandle> handle)
+    {
+      received_handle = handle;
+    };
+
+  auto as = rclcpp_action::create_server<Fibonacci>(
+    node, "fibonacci",
+    handle_goal,
+    handle_cancel,
+    handle_accepted);
+  EXPECT_THROW(
+    as->set_feedback_publish_period(std::chrono::milliseconds(-1)), std::invalid_argument);
+  as->set_feedback_publish_period(std::chrono::hours(1));
+
+  // Subscribe to feedback messages
+  using FeedbackT = Fibonacci::Impl::FeedbackMessage;
+  std::vector<FeedbackT::ConstSharedPtr> received_msgs;
+  auto subscriber = node->create_subscription<FeedbackT>(
+    "fibonacci/_action/feedback", 10, [&received_msgs](FeedbackT::ConstSharedPtr msg)
+    {
+      received_msgs.push_back(msg);
+    });
+
+  send_goal_request(node, uuid);
+
+  auto feedback = received_handle->borrow_feedback();
+  EXPECT_EQ(feedback, received_handle->borrow_feedback());
+  feedback->sequence = {1, 1, 2, 3, 5};
+  EXPECT_TRUE(received_handle->publish_feedback(feedback));
+  // Within the period of the goal
+  EXPECT_FALSE(received_handle->publish_feedback(feedback));
+
+  // 10 seconds
+  const size_t max_tries = 10 * 1000 / 100;
+  for (size_t retry = 0; retry < max_tries && received_msgs.size() < 1u; ++retry) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    rclcpp::spin_some(node);
+  }
+
+  ASSERT_EQ(1u, received_msgs.size());
+  EXPECT_EQ(uuid, received_msgs.back()->goal_id.uuid);
+  EXPECT_EQ(feedback->sequence, received_msgs.back()->feedback.sequence);
+
+  received_handle->set_feedback_publish_period(std::chrono::nanoseconds(0));
+  EXPECT_TRUE(received_handle->publish_feedback(feedback));
+}
+
+TEST_F(TestServer, publish_feedback_and_succeed_concurrently)
+{
+  auto node = std::make_shared<rclcpp::Node>(
+    "pub_feedback_concurrently", "/rclcpp_action/pub_feedback_concurrently");
+  const std::vector<GoalUUID> uuids{
+    {{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 17}},
+    {{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 18}},
+    {{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 19}},
+    {{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 20}}};
+
+  auto handle_goal = [](
+    const GoalUUID &, std::shared_ptr<const Fibonacci::Goal>)
+    {
+      return rclcpp_action::GoalResponse::ACCEPT_AND_EXECUTE;
+    };
+
+  using GoalHandle = rclcpp_action::ServerGoalHandle<Fibonacci>;
+
+  auto handle_cancel = [](std::shared_ptr<GoalHandle>)
+    {
+      return rclcpp_action::CancelResponse::REJECT;
+    };
+
+  std::vector<std::shared_ptr<GoalHandle>> received_handles;
+  auto handle_accepted = [&received_handles](std::shared_ptr<GoalHandle> handle)
+    {
+      received_handles.push_back(handle);
+    };
+
+  auto as = rclcpp_action::create_server<Fibonacci>(
+    node, "fibonacci",
+    handle_goal,
+    handle_cancel,
+    handle_accepted);
+  (void)as;
+
+  // Subscribe to feedback messages
+  using FeedbackT = Fibonacci::Impl::FeedbackMessage;
+  std::set<GoalUUID> goals_with_feedback;
+  auto subscriber = node->create_subscription<FeedbackT>(
+    "fibonacci/_action/feedback", 100, [&goals_with_feedback](FeedbackT::ConstSharedPtr msg)
+    {
+      goals_with_feedback.insert(msg->goal_id.uuid);
+    });
+
+  for (const GoalUUID & uuid : uuids) {
+    send_goal_request(node, uuid);
+  }
+  ASSERT_EQ(uuids.size(), received_handles.size());
+
+  // Each goal is executed by its own thread
+  std::vector<std::thread> threads;
+  for (const auto & handle : received_handles) {
+    threads.emplace_back(
+      [handle]() {
+        auto feedback = std::make_shared<Fibonacci::Feedback>();
+        for (int i = 0; i < 10; ++i) {
+          feedback->sequence.push_back(i);
+          handle->publish_feedback(feedback);
+        }
+        handle->succeed(std::make_shared<Fibonacci::Result>());
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+
+  // 10 seconds
+  const size_t max_tries = 10 * 1000 / 100;
+  for (size_t retry = 0; retry < max_tries && goals_with_feedback.size() < uuids.size(); ++retry) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    rclcpp::spin_some(node);
+  }
+
+  EXPECT_EQ(uuids.size(), goals_with_feedback.size());
+  for (const auto & handle : received_handles) {
+    EXPECT_FALSE(handle->is_active());
+  }
+}
+
+TEST_F(TestServer, intra_process_goal)
+{
+  auto node = std::make_shared<rclcpp::Node>(
+    "intra_process_goal", "/rclcpp_action/intra_process_goal",
+    rclcpp::NodeOptions().use_intra_process_comms(true));
+
+  using GoalHandle = rclcpp_action::ServerGoalHandle<Fibonacci>;
+  std::shared_ptr<GoalHandle> received_handle;
+  auto as = rclcpp_action::create_server<Fibonacci>(
+    node, "fibonacci",
+    [](const GoalUUID &, std::shared_ptr<const Fibonacci::Goal>) {
+      return rclcpp_action::GoalResponse::ACCEPT_AND_EXECUTE;
+    },
+    [](std::shared_ptr<GoalHandle>) {
+      return rclcpp_action::CancelResponse::ACCEPT;
+    },
+    [&received_handle](std::shared_ptr<GoalHandle> handle) {
+      received_handle = handle;
+    });
+  ASSERT_NE(nullptr, as->get_intra_process_waitable());
+  auto ac = rclcpp_action::create_client<Fibonacci>(node, "fibonacci");
+  ASSERT_NE(nullptr, ac->get_intra_process_waitable());
+
+  // Nothing but the statuses goes through the middleware
+  auto send_goal_mock = mocking_utils::patch_and_return(
+    "lib:rclcpp_action", rcl_action_send_goal_request, RCL_RET_ERROR);
+  auto goal_response_mock = mocking_utils::patch_and_return(
+    "lib:rclcpp_action", rcl_action_send_goal_response, RCL_RET_ERROR);
+  auto send_result_mock = mocking_utils::patch_and_return(
+    "lib:rclcpp_action", rcl_action_send_result_request, RCL_RET_ERROR);
+  auto result_response_mock = mocking_utils::patch_and_return(
+    "lib:rclcpp_action", rcl_action_send_result_response, RCL_RET_ERROR);
+  auto feedback_mock = mocking_utils::patch_and_return(
+    "lib:rclcpp_action", rcl_action_publish_feedback, RCL_RET_ERROR);
+
+  std::vector<std::shared_ptr<const Fibonacci::Feedback>> received_feedback;
+  rclcpp_action::Client<Fibonacci>::SendGoalOptions options;
+  options.feedback_callback = [&received_feedback](
+    rclcpp_action::ClientGoalHandle<Fibonacci>::SharedPtr,
+    const std::shared_ptr<const Fibonacci::Feedback> feedback)
+    {
+      received_feedback.push_back(feedback);
+    };
+  Fibonacci::Goal goal;
+  goal.order = 5;
+  auto goal_future = ac->async_send_goal(goal, options);
+  ASSERT_EQ(
+    rclcpp::FutureReturnCode::SUCCESS,
+    rclcpp::spin_until_future_complete(node, goal_future, std::chrono::seconds(5)));
+  auto goal_handle = goal_future.get();
+  ASSERT_NE(nullptr, goal_handle);
+  ASSERT_NE(nullptr, received_handle);
+  EXPECT_EQ(5, received_handle->get_goal()->order);
+
+  auto feedback = std::make_shared<Fibonacci::Feedback>();
+  feedback->sequence = {0, 1, 1, 2};
+  received_handle->publish_feedback(feedback);
+  for (size_t retry = 0; retry < 50u && received_feedback.empty(); ++retry) {
+    rclcpp::spin_some(node);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  ASSERT_EQ(1u, received_feedback.size());
+  EXPECT_EQ(feedback->sequence, received_feedback.front()->sequence);
+
+  auto result = std::make_shared<Fibonacci::Result>();
+  result->sequence = {0, 1, 1, 2, 3, 5};
+  auto result_future = ac->async_get_result(goal_handle);
+  received_handle->succeed(result);
+  ASSERT_EQ(
+    rclcpp::FutureReturnCode::SUCCESS,
+    rclcpp::spin_until_future_complete(node, result_future, std::chrono::seconds(5)));
+  auto wrapped_result = result_future.get();
+  EXPECT_EQ(rclcpp_action::ResultCode::SUCCEEDED, wrapped_result.code);
+  EXPECT_EQ(result->sequence, wrapped_result.result->sequence);
+}
+
+TEST_F(TestServer, waitable_group)
+{
+  auto node = std::make_shared<rclcpp::Node>("waitable_group", "/rclcpp_action/waitable_group");
+
+  using GoalHandle = rclcpp_action::ServerGoalHandle<Fibonacci>;
+  std::vector<std::shared_ptr<GoalHandle>> received_handles;
+  auto group = std::make_shared<rclcpp_action::ActionWaitableGroup>(
+    node->get_node_base_interface()->get_context(), std::chrono::milliseconds(10));
+  auto waitables = node->get_node_waitables_interface();
+  std::vector<std::shared_ptr<rclcpp_action::Server<Fibonacci>>> servers;
+  std::vector<std::shared_ptr<rclcpp_action::Client<Fibonacci>>> clients;
+  for (const char * action_name : {"fibonacci_1", "fibonacci_2"}) {
+    auto as = rclcpp_action::create_server<Fibonacci>(
+      node, action_name,
+      [](const GoalUUID &, std::shared_ptr<const Fibonacci::Goal>) {
+        return rclcpp_action::GoalResponse::ACCEPT_AND_EXECUTE;
+      },
+      [](std::shared_ptr<GoalHandle>) {
+        return rclcpp_action::CancelResponse::ACCEPT;
+      },
+      [&received_handles](std::shared_ptr<GoalHandle> handle) {
+        received_handles.push_back(handle);
+      });
+    auto ac = rclcpp_action::create_client<Fibonacci>(node, action_name);
+    // Only the group is waited on
+    waitables->remove_waitable(as, nullptr);
+    waitables->remove_waitable(ac, nullptr);
+    group->add(as);
+    group->add(ac);
+    servers.push_back(as);
+    clients.push_back(ac);
+  }
+  EXPECT_THROW(group->add(servers.front()), std::invalid_argument);
+  EXPECT_EQ(4u, group->size());
+  waitables->add_waitable(group, nullptr);
+
+  Fibonacci::Goal goal;
+  goal.order = 5;
+  auto result = std::make_shared<Fibonacci::Result>();
+  result->sequence = {0, 1, 1, 2, 3, 5};
+  for (const auto & ac : clients) {
+    ASSERT_TRUE(ac->wait_for_action_server(std::chrono::seconds(5)));
+    received_handles.clear();
+    auto goal_future = ac->async_send_goal(goal);
+    ASSERT_EQ(
+      rclcpp::FutureReturnCode::SUCCESS,
+      rclcpp::spin_until_future_complete(node, goal_future, std::chrono::seconds(5)));
+    auto goal_handle = goal_future.get();
+    ASSERT_NE(nullptr, goal_handle);
+    ASSERT_EQ(1u, received_handles.size());
+
+    auto result_future = ac->async_get_result(goal_handle);
+    received_handles.front()->succeed(result);
+    ASSERT_EQ(
+      rclcpp::FutureReturnCode::SUCCESS,
+      rclcpp::spin_until_future_complete(node, result_future, std::chrono::seconds(5)));
+    EXPECT_EQ(rclcpp_action::ResultCode::SUCCEEDED, result_future.get().code);
+  }
+
+  EXPECT_TRUE(group->remove(servers.back()));
+  EXPECT_FALSE(group->remove(servers.back()));
+  EXPECT_EQ(3u, group->size());
+  waitables->remove_waitable(group, nullptr);
+}
+
 TEST_F(TestServer, get_result)
 {
   auto node = std::make_shared<rclcpp::Node>("get_result", "/rclcpp_action/get_result");
@@ -903,6 +1372,138 @@ TEST_F(TestServer, get_result)
   EXPECT_EQ(action_msgs::msg::GoalStatus::STATUS_UNKNOWN, response->status);
 }
 
+TEST_F(TestServer, max_retained_results)
+{
+  auto node = std::make_shared<rclcpp::Node>(
+    "max_retained_results", "/rclcpp_action/max_retained_results");
+  const GoalUUID uuid1{{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 161}};
+  const GoalUUID uuid2{{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 162}};
+  const GoalUUID uuid3{{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 163}};
+
+  using GoalHandle = rclcpp_action::ServerGoalHandle<Fibonacci>;
+  std::vector<std::shared_ptr<GoalHandle>> received_handles;
+  auto as = rclcpp_action::create_server<Fibonacci>(
+    node, "fibonacci",
+    [](const GoalUUID &, std::shared_ptr<const Fibonacci::Goal>) {
+      return rclcpp_action::GoalResponse::ACCEPT_AND_EXECUTE;
+    },
+    [](std::shared_ptr<GoalHandle>) {
+      return rclcpp_action::CancelResponse::REJECT;
+    },
+    [&received_handles](std::shared_ptr<GoalHandle> handle) {
+      received_handles.push_back(handle);
+    });
+  as->set_max_retained_results(2u);
+
+  auto result_client = node->create_client<Fibonacci::Impl::GetResultService>(
+    "fibonacci/_action/get_result");
+  if (!result_client->wait_for_service(std::chrono::seconds(20))) {
+    throw std::runtime_error("get result service didn't become available");
+  }
+  auto get_result_status = [&node, &result_client](const GoalUUID & uuid) {
+      auto request = std::make_shared<Fibonacci::Impl::GetResultService::Request>();
+      request->goal_id.uuid = uuid;
+      auto future = result_client->async_send_request(request);
+      if (rclcpp::spin_until_future_complete(node, future) != rclcpp::FutureReturnCode::SUCCESS) {
+        throw std::runtime_error("the result wasn't received");
+      }
+      return future.get()->status;
+    };
+
+  auto result = std::make_shared<Fibonacci::Result>();
+  result->sequence = {5, 8, 13, 21};
+  send_goal_request(node, uuid1);
+  send_goal_request(node, uuid2);
+  ASSERT_EQ(2u, received_handles.size());
+  received_handles[0]->succeed(result);
+  received_handles[1]->succeed(result);
+  // The first result is now the most recently used one
+  EXPECT_EQ(action_msgs::msg::GoalStatus::STATUS_SUCCEEDED, get_result_status(uuid1));
+
+  send_goal_request(node, uuid3);
+  ASSERT_EQ(3u, received_handles.size());
+  received_handles[2]->succeed(result);
+
+  // The second result was dropped, although its goal didn't expire
+  EXPECT_EQ(action_msgs::msg::GoalStatus::STATUS_UNKNOWN, get_result_status(uuid2));
+  EXPECT_EQ(action_msgs::msg::GoalStatus::STATUS_SUCCEEDED, get_result_status(uuid1));
+  EXPECT_EQ(action_msgs::msg::GoalStatus::STATUS_SUCCEEDED, get_result_status(uuid3));
+}
+
+TEST_F(TestServer, expire_goals_in_batches)
+{
+  auto node = std::make_shared<rclcpp::Node>("expire_goals", "/rclcpp_action/expire_goals");
+
+  auto handle_goal = [](
+    const GoalUUID &, std::shared_ptr<const Fibonacci::Goal>)
+    {
+      return rclcpp_action::GoalResponse::ACCEPT_AND_EXECUTE;
+    };
+
+  using GoalHandle = rclcpp_action::ServerGoalHandle<Fibonacci>;
+
+  auto handle_cancel = [](std::shared_ptr<GoalHandle>)
+    {
+      return rclcpp_action::CancelResponse::REJECT;
+    };
+
+  std::vector<std::shared_ptr<GoalHandle>> received_handles;
+  auto handle_accepted = [&received_handles](std::shared_ptr<GoalHandle> handle)
+    {
+      received_handles.push_back(handle);
+    };
+
+  const std::chrono::milliseconds result_timeout{50};
+
+  rcl_action_server_options_t options = rcl_action_server_get_default_options();
+  options.result_timeout.nanoseconds = RCL_MS_TO_NS(result_timeout.count());
+  auto as = rclcpp_action::create_server<Fibonacci>(
+    node, "fibonacci",
+    handle_goal,
+    handle_cancel,
+    handle_accepted,
+    options);
+  (void)as;
+
+  // More goals than expired in a single batch
+  constexpr uint8_t num_goals = 100;
+  auto goal_client = node->create_client<Fibonacci::Impl::SendGoalService>(
+    "fibonacci/_action/send_goal");
+  ASSERT_TRUE(goal_client->wait_for_service(std::chrono::seconds(20)));
+  for (uint8_t i = 0; i < num_goals; ++i) {
+    auto request = std::make_shared<Fibonacci::Impl::SendGoalService::Request>();
+    request->goal_id.uuid = GoalUUID{{i, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16}};
+    auto future = goal_client->async_send_request(request);
+    ASSERT_EQ(
+      rclcpp::FutureReturnCode::SUCCESS,
+      rclcpp::spin_until_future_complete(node, future));
+  }
+  ASSERT_EQ(static_cast<size_t>(num_goals), received_handles.size());
+  for (auto & handle : received_handles) {
+    handle->succeed(std::make_shared<Fibonacci::Result>());
+  }
+  received_handles.clear();
+
+  // Wait for goal expiration
+  rclcpp::sleep_for(2 * result_timeout);
+
+  // Allow for expiration to take place
+  rclcpp::spin_some(node);
+
+  auto result_client = node->create_client<Fibonacci::Impl::GetResultService>(
+    "fibonacci/_action/get_result");
+  ASSERT_TRUE(result_client->wait_for_service(std::chrono::seconds(20)));
+  for (uint8_t i : {uint8_t(0), uint8_t(num_goals - 1)}) {
+    auto request = std::make_shared<Fibonacci::Impl::GetResultService::Request>();
+    request->goal_id.uuid = GoalUUID{{i, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16}};
+    auto future = result_client->async_send_request(request);
+    ASSERT_EQ(
+      rclcpp::FutureReturnCode::SUCCESS,
+      rclcpp::spin_until_future_complete(node, future));
+    EXPECT_EQ(action_msgs::msg::GoalStatus::STATUS_UNKNOWN, future.get()->status);
+  }
+}
+
 TEST_F(TestServer, get_result_deferred)
 {
   auto node = std::make_shared<rclcpp::Node>("get_result", "/rclcpp_action/get_result");
@@ -1147,18 +1748,18 @@ TEST_F(TestGoalRequestServer, execute_goal_request_received_update_goal_state_er
   EXPECT_THROW(SendClientGoalRequest(), rclcpp::exceptions::RCLError);
 }
 
-TEST_F(TestGoalRequestServer, publish_status_server_get_goal_handles_errors)
+TEST_F(TestGoalRequestServer, publish_status_goal_handle_get_status_errors)
 {
   auto mock = mocking_utils::patch_and_return(
-    "lib:rclcpp_action", rcl_action_server_get_goal_handles, RCL_RET_ERROR);
+    "lib:rclcpp_action", rcl_action_goal_handle_get_status, RCL_RET_ERROR);
 
   EXPECT_THROW(SendClientGoalRequest(), rclcpp::exceptions::RCLError);
 }
 
-TEST_F(TestGoalRequestServer, publish_status_get_goal_status_array_errors)
+TEST_F(TestGoalRequestServer, publish_status_goal_handle_get_info_errors)
 {
   auto mock = mocking_utils::patch_and_return(
-    "lib:rclcpp_action", rcl_action_get_goal_status_array, RCL_RET_ERROR);
+    "lib:rclcpp_action", rcl_action_goal_handle_get_info, RCL_RET_ERROR);
 
   EXPECT_THROW(SendClientGoalRequest(), rclcpp::exceptions::RCLError);
 }
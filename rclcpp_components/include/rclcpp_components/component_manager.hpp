@@ -41,9 +41,11 @@
 #ifndef RCLCPP_COMPONENTS__COMPONENT_MANAGER_HPP__
 #define RCLCPP_COMPONENTS__COMPONENT_MANAGER_HPP__
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -51,13 +53,17 @@
 #include "composition_interfaces/srv/unload_node.hpp"
 #include "composition_interfaces/srv/list_nodes.hpp"
 
+#include "rclcpp/allocator/tracking_allocator.hpp"
 #include "rclcpp/executor.hpp"
+#include "rclcpp/intra_process_counters.hpp"
 #include "rclcpp/node_options.hpp"
 #include "rclcpp/rclcpp.hpp"
 
 #include "rclcpp_components/node_factory.hpp"
 #include "rclcpp_components/visibility_control.hpp"
 
+#include "statistics_msgs/msg/metrics_message.hpp"
+
 namespace class_loader
 {
 class ClassLoader;
@@ -66,6 +72,15 @@ class ClassLoader;
 namespace rclcpp_components
 {
 
+constexpr const char kComponentCpuUsageStatName[]{"component_cpu_usage"};
+constexpr const char kComponentCallbacksStatName[]{"component_callbacks"};
+constexpr const char kComponentIntraProcessBytesSentStatName[]{
+  "component_intra_process_bytes_sent"};
+constexpr const char kComponentIntraProcessBytesReceivedStatName[]{
+  "component_intra_process_bytes_received"};
+constexpr const char kComponentBytesAllocatedStatName[]{"component_bytes_allocated"};
+constexpr const char kComponentBytesInUseStatName[]{"component_bytes_in_use"};
+
 /// Thrown when an error happens in the component Manager class.
 class ComponentManagerException : public std::runtime_error
 {
@@ -75,6 +90,26 @@ public:
 };
 
 /// ComponentManager handles the services to load, unload, and get the list of loaded components.
+/**
+ * The components are spun by the executor of the component manager, unless they are
+ * placed in one of its executor groups by the `executor_group` extra argument of their
+ * request. Each group is a multi-threaded executor whose threads are pinned to a set of
+ * CPUs or to a NUMA node, so that related components share caches and local memory.
+ * The groups are set with the read-only parameters of the component manager:
+ *   - `executor_groups`: names of the groups.
+ *   - `executor_groups.<name>.thread_num`: number of threads of a group, 1 by default.
+ *   - `executor_groups.<name>.cpus`: CPUs the threads of a group are pinned to, if any.
+ *   - `executor_groups.<name>.numa_node`: NUMA node the threads of a group are pinned to,
+ *     -1 by default for none.
+ *
+ * The resources used by each component are accounted when the read-only
+ * `resource_accounting` parameter is true, see get_component_resource_usage(), and published
+ * every `resource_accounting_period_ms` milliseconds, 1000 by default, 0 to not publish them,
+ * as statistics_msgs/msg/MetricsMessage on `~/_container/component_statistics`.
+ * There is one message per component and metric, whose source is the fully qualified name of
+ * the node, with the CPU usage ratio, the number of callbacks executed, the intra-process
+ * bytes sent and received, and the bytes allocated during the period, and the bytes in use.
+ */
 class ComponentManager : public rclcpp::Node
 {
 public:
@@ -88,6 +123,35 @@ public:
    */
   using ComponentResource = std::pair<std::string, std::string>;
 
+  /// A publisher and a subscription of loaded components, on the same topic.
+  struct TopicConnection
+  {
+    std::string topic_name;
+    /// Fully qualified name of the node of the publisher
+    std::string publisher_node_name;
+    /// Fully qualified name of the node of the subscription
+    std::string subscription_node_name;
+    /// True if the messages are passed within the process, false if through the middleware.
+    bool intra_process;
+  };
+
+  /// Resources used by a loaded component since it was loaded.
+  struct ComponentResourceUsage
+  {
+    /// Fully qualified name of the node of the component
+    std::string full_node_name;
+    /// Number of callbacks of the node executed
+    uint64_t callbacks = 0u;
+    /// Thread CPU time of the callbacks of the node
+    std::chrono::nanoseconds cpu_time{0};
+    /// Messages published within the process by the publishers of the node
+    rclcpp::IntraProcessCounters intra_process_sent;
+    /// Messages given to the callbacks of the subscriptions of the node within the process
+    rclcpp::IntraProcessCounters intra_process_received;
+    /// Allocations made with the allocator of the node options of the component
+    rclcpp::allocator::AllocationCounters allocations;
+  };
+
   /// Default constructor
   /**
    * Initializes the component manager. It creates the services: load node, unload node
@@ -111,6 +175,8 @@ public:
 
   /// Return a list of valid loadable components in a given package.
   /**
+   * The resource index is read once for each package, and the resources cached.
+   *
    * \param package_name name of the package
    * \param resource_index name of the executable
    * \throws ComponentManagerException if the resource was not found or a invalid resource entry
@@ -124,6 +190,9 @@ public:
 
   /// Instantiate a component from a dynamic library.
   /**
+   * The library is loaded by the first call for one of its components, and the
+   * factory is cached, so that later calls for the same resource only return it.
+   *
    * \param resource a component resource (class name + library path)
    * \return a NodeFactory interface
    */
@@ -131,6 +200,73 @@ public:
   virtual std::shared_ptr<rclcpp_components::NodeFactory>
   create_component_factory(const ComponentResource & resource);
 
+  /// Load the libraries and the factories of all the components of the given packages.
+  /**
+   * The components of these packages are then loaded without reading the resource
+   * index nor loading libraries.
+   * It's done by the constructor for the packages of the `preload_packages` parameter.
+   * Failures are logged, the components that failed are loaded again on request.
+   *
+   * \param package_names names of the packages
+   */
+  RCLCPP_COMPONENTS_PUBLIC
+  virtual void
+  preload_components(const std::vector<std::string> & package_names);
+
+  /// Load several components, constructing their nodes concurrently.
+  /**
+   * The libraries of the components are loaded one at a time, then their nodes are
+   * constructed by a pool of threads, and finally added to the executor in the order
+   * of the requests, as on_load_node() would do for each request.
+   * The components mustn't depend on each other during their construction.
+   *
+   * \param requests information with the nodes to load.
+   * \param number_of_threads number of threads constructing the nodes, including the
+   *   calling one, 0 for one thread per hardware thread.
+   * \return the responses to the requests, in the same order.
+   * \throws std::overflow_error if node_id suffers an overflow.
+   */
+  RCLCPP_COMPONENTS_PUBLIC
+  virtual std::vector<std::shared_ptr<LoadNode::Response>>
+  load_nodes(
+    const std::vector<std::shared_ptr<LoadNode::Request>> & requests,
+    size_t number_of_threads = 0);
+
+  /// Return the connections between the publishers and subscriptions of the loaded components.
+  /**
+   * Their messages are passed within the process only if the nodes of both use
+   * intra-process communications, otherwise they go through the middleware.
+   * The connections are found in the ROS graph, so recently created publishers and
+   * subscriptions may be missing, and the rosout publishers aren't included, since they
+   * always use the middleware.
+   * Each connection is logged as well.
+   *
+   * \return the connections, ordered by topic name.
+   */
+  RCLCPP_COMPONENTS_PUBLIC
+  virtual std::vector<TopicConnection>
+  report_topic_connections();
+
+  /// Return the resources used by a loaded component.
+  /**
+   * The CPU time and the callbacks are accounted for the callback groups of the node with
+   * rclcpp::CallbackGroup::enable_cpu_accounting(), which the manager enables when the
+   * `resource_accounting` parameter is true, when the component is loaded and, for the groups
+   * created afterwards, from this call on.
+   * Only the executors executing through rclcpp::Executor::execute_any_executable account it.
+   * The intra-process messages are counted by the publishers and subscriptions of the node.
+   * The allocations are the ones made with the tracking allocator the manager sets in the
+   * node options of the component when `resource_accounting` is true, which rcl uses for the
+   * node, as can the component through NodeOptions::allocator().
+   *
+   * \param node_id unique id of the component
+   * \return the resources used by the component
+   * \throws ComponentManagerException if no component has this id
+   */
+  RCLCPP_COMPONENTS_PUBLIC
+  virtual ComponentResourceUsage
+  get_component_resource_usage(uint64_t node_id);
+
   /// Member function to set a executor in the component
   /**
    * \param executor executor to be set
@@ -142,6 +278,10 @@ public:
 protected:
   /// Create node options for loaded component
   /**
+   * The components use intra-process communications if the `use_intra_process_comms`
+   * parameter of the component manager is true, unless the request sets otherwise with
+   * its `use_intra_process_comms` extra argument.
+   *
    * \param request information with the node to load
    * \return node options
    */
@@ -151,6 +291,8 @@ protected:
 
   /// Add component node to executor model, it's invoked in on_load_node()
   /**
+   * The node is added to the executor of its executor group, if it's placed in one.
+   *
    * \param node_id  node_id of loaded component node in node_wrappers_
    */
   RCLCPP_COMPONENTS_PUBLIC
@@ -261,11 +403,45 @@ protected:
 
   uint64_t unique_id_ {1};
   std::map<std::string, std::unique_ptr<class_loader::ClassLoader>> loaders_;
+  // Lookups cached by get_component_resources() and create_component_factory()
+  mutable std::map<std::pair<std::string, std::string>, std::vector<ComponentResource>>
+  component_resources_;
+  std::map<std::string, std::vector<std::string>> library_classes_;
+  std::map<ComponentResource, std::shared_ptr<rclcpp_components::NodeFactory>> factories_;
+  // Declared before the nodes, so that it outlives them
+  std::map<uint64_t, std::shared_ptr<rclcpp::allocator::TrackingAllocator<char>>>
+  node_allocators_;
   std::map<uint64_t, rclcpp_components::NodeInstanceWrapper> node_wrappers_;
 
   rclcpp::Service<LoadNode>::SharedPtr loadNode_srv_;
   rclcpp::Service<UnloadNode>::SharedPtr unloadNode_srv_;
   rclcpp::Service<ListNodes>::SharedPtr listNodes_srv_;
+
+  /// Executor of an executor group, created once a component is placed in the group
+  struct ExecutorGroup
+  {
+    std::shared_ptr<rclcpp::Executor> executor;
+    std::thread thread;
+  };
+
+  std::map<std::string, ExecutorGroup> executor_groups_;
+  std::map<uint64_t, std::string> node_executor_groups_;
+
+  rclcpp::Publisher<statistics_msgs::msg::MetricsMessage>::SharedPtr
+  component_statistics_publisher_;
+  rclcpp::TimerBase::SharedPtr component_statistics_timer_;
+  // Resources used by the components at the start of the current period
+  std::map<uint64_t, ComponentResourceUsage> previous_resource_usage_;
+  rclcpp::Time resource_usage_period_start_;
+
+private:
+  /// Return the executor group of the given name, spinning its executor if not done yet.
+  ExecutorGroup &
+  get_executor_group(const std::string & name);
+
+  /// Publish the resources used by each component since the previous period.
+  void
+  publish_component_statistics();
 };
 
 }  // namespace rclcpp_components
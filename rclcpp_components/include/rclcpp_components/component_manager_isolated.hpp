@@ -19,6 +19,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 #include <unordered_map>
@@ -43,6 +44,9 @@ class ComponentManagerIsolated : public rclcpp_components::ComponentManager
 public:
   ~ComponentManagerIsolated()
   {
+    if (shared_executor_wrapper_.executor) {
+      cancel_executor(shared_executor_wrapper_);
+    }
     if (node_wrappers_.size()) {
       for (auto & executor_wrapper : dedicated_executor_wrappers_) {
         cancel_executor(executor_wrapper.second);
@@ -51,6 +55,34 @@ public:
     }
   }
 
+  /// Serve all the components with a bounded pool of threads, instead of a thread each.
+  /**
+   * The components are still isolated from each other and from the component manager,
+   * and each callback group of a component is executed by one thread at a time, as with
+   * its own executor. But the threads of a multi-threaded executor are shared by all the
+   * components, so that idle components don't keep a thread each.
+   *
+   * It has to be called before any component is loaded.
+   *
+   * \param number_of_threads number of threads of the pool, 0 for one per hardware thread.
+   * \throws ComponentManagerException if components were loaded already.
+   */
+  void
+  use_shared_thread_pool(size_t number_of_threads)
+  {
+    if (!node_wrappers_.empty() || shared_executor_wrapper_.executor) {
+      throw ComponentManagerException(
+              "the shared thread pool must be set before any component is loaded");
+    }
+    auto exec = std::make_shared<rclcpp::executors::MultiThreadedExecutor>(
+      rclcpp::ExecutorOptions(), number_of_threads);
+    shared_executor_wrapper_.executor = exec;
+    shared_executor_wrapper_.thread = std::thread(
+      [exec]() {
+        exec->spin();
+      });
+  }
+
 protected:
   /// Add component node to executor model, it's invoked in on_load_node()
   /**
@@ -59,6 +91,11 @@ protected:
   void
   add_node_to_executor(uint64_t node_id) override
   {
+    if (shared_executor_wrapper_.executor) {
+      shared_executor_wrapper_.executor->add_node(
+        node_wrappers_[node_id].get_node_base_interface(), true);
+      return;
+    }
     DedicatedExecutorWrapper executor_wrapper;
     auto exec = std::make_shared<ExecutorT>();
     exec->add_node(node_wrappers_[node_id].get_node_base_interface());
@@ -76,6 +113,11 @@ protected:
   void
   remove_node_from_executor(uint64_t node_id) override
   {
+    if (shared_executor_wrapper_.executor) {
+      shared_executor_wrapper_.executor->remove_node(
+        node_wrappers_[node_id].get_node_base_interface());
+      return;
+    }
     auto executor_wrapper = dedicated_executor_wrappers_.find(node_id);
     if (executor_wrapper != dedicated_executor_wrappers_.end()) {
       cancel_executor(executor_wrapper->second);
@@ -109,6 +151,8 @@ private:
   }
 
   std::unordered_map<uint64_t, DedicatedExecutorWrapper> dedicated_executor_wrappers_;
+  // Executor of all the components, if they share a thread pool
+  DedicatedExecutorWrapper shared_executor_wrapper_;
 };
 
 }  // namespace rclcpp_components
@@ -26,16 +26,27 @@ int main(int argc, char * argv[])
   rclcpp::init(argc, argv);
   // parse arguments
   bool use_multi_threaded_executor{false};
+  bool use_shared_thread_pool{false};
   std::vector<std::string> args = rclcpp::remove_ros_arguments(argc, argv);
   for (auto & arg : args) {
     if (arg == std::string("--use_multi_threaded_executor")) {
       use_multi_threaded_executor = true;
+    } else if (arg == std::string("--use_shared_thread_pool")) {
+      use_shared_thread_pool = true;
     }
   }
   // create executor and component manager
   auto exec = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
   rclcpp::Node::SharedPtr node;
-  if (use_multi_threaded_executor) {
+  if (use_shared_thread_pool) {
+    // The components share a pool of "thread_num" threads
+    using ComponentManagerIsolated =
+      rclcpp_components::ComponentManagerIsolated<rclcpp::executors::MultiThreadedExecutor>;
+    auto manager = std::make_shared<ComponentManagerIsolated>(exec);
+    manager->use_shared_thread_pool(
+      static_cast<size_t>(manager->get_parameter("thread_num").as_int()));
+    node = manager;
+  } else if (use_multi_threaded_executor) {
     using ComponentManagerIsolated =
       rclcpp_components::ComponentManagerIsolated<rclcpp::executors::MultiThreadedExecutor>;
     node = std::make_shared<ComponentManagerIsolated>(exec);
@@ -14,9 +14,14 @@
 
 #include "rclcpp_components/component_manager.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -25,6 +30,12 @@
 #include "rcpputils/filesystem_helper.hpp"
 #include "rcpputils/split.hpp"
 
+#include "rclcpp/allocator/allocator_common.hpp"
+#include "rclcpp/experimental/intra_process_manager.hpp"
+
+#include "statistics_msgs/msg/statistic_data_point.hpp"
+#include "statistics_msgs/msg/statistic_data_type.hpp"
+
 using namespace std::placeholders;
 
 namespace rclcpp_components
@@ -58,15 +69,86 @@ ComponentManager::ComponentManager(
     this->declare_parameter(
       "thread_num", static_cast<int64_t>(std::thread::hardware_concurrency()), desc);
   }
+  {
+    rcl_interfaces::msg::ParameterDescriptor desc{};
+    desc.description =
+      "Whether the loaded components use intra-process communications, "
+      "unless their request sets otherwise";
+    desc.read_only = true;
+    this->declare_parameter("use_intra_process_comms", false, desc);
+  }
+  {
+    rcl_interfaces::msg::ParameterDescriptor desc{};
+    desc.description = "Packages whose components are loaded when the container starts";
+    desc.read_only = true;
+    const auto package_names =
+      this->declare_parameter("preload_packages", std::vector<std::string>{}, desc);
+    // Not virtual while constructing
+    ComponentManager::preload_components(package_names);
+  }
+  {
+    rcl_interfaces::msg::ParameterDescriptor desc{};
+    desc.description = "Names of the executor groups the components can be placed in";
+    desc.read_only = true;
+    const auto group_names =
+      this->declare_parameter("executor_groups", std::vector<std::string>{}, desc);
+    for (const auto & group_name : group_names) {
+      rcl_interfaces::msg::ParameterDescriptor threads_desc{};
+      threads_desc.description = "Number of threads of the executor group";
+      threads_desc.read_only = true;
+      this->declare_parameter(
+        "executor_groups." + group_name + ".thread_num", static_cast<int64_t>(1), threads_desc);
+      rcl_interfaces::msg::ParameterDescriptor cpus_desc{};
+      cpus_desc.description = "CPUs the threads of the executor group are pinned to";
+      cpus_desc.read_only = true;
+      this->declare_parameter(
+        "executor_groups." + group_name + ".cpus", std::vector<int64_t>{}, cpus_desc);
+      rcl_interfaces::msg::ParameterDescriptor numa_desc{};
+      numa_desc.description = "NUMA node the threads of the executor group are pinned to";
+      numa_desc.read_only = true;
+      this->declare_parameter(
+        "executor_groups." + group_name + ".numa_node", static_cast<int64_t>(-1), numa_desc);
+    }
+  }
+  {
+    rcl_interfaces::msg::ParameterDescriptor desc{};
+    desc.description = "Whether the resources used by each component are accounted";
+    desc.read_only = true;
+    const bool resource_accounting = this->declare_parameter("resource_accounting", false, desc);
+    rcl_interfaces::msg::ParameterDescriptor period_desc{};
+    period_desc.description =
+      "Period of the publication of the resources used by the components, 0 to not publish";
+    period_desc.read_only = true;
+    const int64_t period_ms = this->declare_parameter(
+      "resource_accounting_period_ms", static_cast<int64_t>(1000), period_desc);
+    if (resource_accounting && period_ms > 0) {
+      component_statistics_publisher_ = create_publisher<statistics_msgs::msg::MetricsMessage>(
+        "~/_container/component_statistics", 10);
+      resource_usage_period_start_ = now();
+      component_statistics_timer_ = create_wall_timer(
+        std::chrono::milliseconds(period_ms), [this]() {publish_component_statistics();});
+    }
+  }
 }
 
 ComponentManager::~ComponentManager()
 {
+  for (auto & name_and_group : executor_groups_) {
+    auto & group = name_and_group.second;
+    // The executor has to be spinning to be canceled, which it does right after being created.
+    while (!group.executor->is_spinning()) {
+      rclcpp::sleep_for(std::chrono::milliseconds(1));
+    }
+    group.executor->cancel();
+    group.thread.join();
+  }
   if (node_wrappers_.size()) {
     RCLCPP_DEBUG(get_logger(), "Removing components from executor");
     if (auto exec = executor_.lock()) {
       for (auto & wrapper : node_wrappers_) {
-        exec->remove_node(wrapper.second.get_node_base_interface());
+        if (node_executor_groups_.count(wrapper.first) == 0) {
+          exec->remove_node(wrapper.second.get_node_base_interface());
+        }
       }
     }
   }
@@ -76,6 +158,11 @@ std::vector<ComponentManager::ComponentResource>
 ComponentManager::get_component_resources(
   const std::string & package_name, const std::string & resource_index) const
 {
+  auto cached = component_resources_.find({resource_index, package_name});
+  if (cached != component_resources_.end()) {
+    return cached->second;
+  }
+
   std::string content;
   std::string base_path;
   if (
@@ -99,12 +186,18 @@ ComponentManager::get_component_resources(
     }
     resources.push_back({parts[0], library_path});
   }
+  component_resources_[{resource_index, package_name}] = resources;
   return resources;
 }
 
 std::shared_ptr<rclcpp_components::NodeFactory>
 ComponentManager::create_component_factory(const ComponentResource & resource)
 {
+  auto cached_factory = factories_.find(resource);
+  if (cached_factory != factories_.end()) {
+    return cached_factory->second;
+  }
+
   std::string library_path = resource.second;
   std::string class_name = resource.first;
   std::string fq_class_name = "rclcpp_components::NodeFactoryTemplate<" + class_name + ">";
@@ -122,17 +215,44 @@ ComponentManager::create_component_factory(const ComponentResource & resource)
   }
   loader = loaders_[library_path].get();
 
-  auto classes = loader->getAvailableClasses<rclcpp_components::NodeFactory>();
-  for (const auto & clazz : classes) {
-    RCLCPP_INFO(get_logger(), "Found class: %s", clazz.c_str());
+  auto classes = library_classes_.find(library_path);
+  if (classes == library_classes_.end()) {
+    classes = library_classes_.emplace(
+      library_path, loader->getAvailableClasses<rclcpp_components::NodeFactory>()).first;
+    for (const auto & clazz : classes->second) {
+      RCLCPP_INFO(get_logger(), "Found class: %s", clazz.c_str());
+    }
+  }
+  for (const auto & clazz : classes->second) {
     if (clazz == class_name || clazz == fq_class_name) {
       RCLCPP_INFO(get_logger(), "Instantiate class: %s", clazz.c_str());
-      return loader->createInstance<rclcpp_components::NodeFactory>(clazz);
+      auto factory = loader->createInstance<rclcpp_components::NodeFactory>(clazz);
+      factories_[resource] = factory;
+      return factory;
     }
   }
   return {};
 }
 
+void
+ComponentManager::preload_components(const std::vector<std::string> & package_names)
+{
+  for (const auto & package_name : package_names) {
+    try {
+      for (const auto & resource : get_component_resources(package_name)) {
+        if (create_component_factory(resource) == nullptr) {
+          RCLCPP_WARN(
+            get_logger(), "Failed to preload class '%s'", resource.first.c_str());
+        }
+      }
+    } catch (const ComponentManagerException & ex) {
+      RCLCPP_WARN(
+        get_logger(), "Failed to preload the components of '%s': %s", package_name.c_str(),
+        ex.what());
+    }
+  }
+}
+
 rclcpp::NodeOptions
 ComponentManager::create_node_options(const std::shared_ptr<LoadNode::Request> request)
 {
@@ -162,7 +282,8 @@ ComponentManager::create_node_options(const std::shared_ptr<LoadNode::Request> r
   auto options = rclcpp::NodeOptions()
     .use_global_arguments(false)
     .parameter_overrides(parameters)
-    .arguments(remap_rules);
+    .arguments(remap_rules)
+    .use_intra_process_comms(get_parameter("use_intra_process_comms").as_bool());
 
   for (const auto & a : request->extra_arguments) {
     const rclcpp::Parameter extra_argument = rclcpp::Parameter::from_parameter_msg(a);
@@ -190,15 +311,237 @@ ComponentManager::create_node_options(const std::shared_ptr<LoadNode::Request> r
   return options;
 }
 
+std::vector<ComponentManager::TopicConnection>
+ComponentManager::report_topic_connections()
+{
+  auto fully_qualified_name = [](const std::string & node_namespace, const std::string & name) {
+      return node_namespace == "/" ? "/" + name : node_namespace + "/" + name;
+    };
+
+  std::map<std::string, bool> use_intra_process;
+  for (auto & wrapper : node_wrappers_) {
+    auto node = wrapper.second.get_node_base_interface();
+    use_intra_process[node->get_fully_qualified_name()] = node->get_use_intra_process_default();
+  }
+
+  std::map<std::string, std::vector<TopicConnection>> connections_by_topic;
+  auto graph = get_node_graph_interface();
+  for (auto & wrapper : node_wrappers_) {
+    auto node = wrapper.second.get_node_base_interface();
+    auto topics = graph->get_publisher_names_and_types_by_node(
+      node->get_name(), node->get_namespace());
+    for (const auto & topic : topics) {
+      if (topic.first == "/rosout" || connections_by_topic.count(topic.first) != 0) {
+        continue;
+      }
+      auto & connections = connections_by_topic[topic.first];
+      auto publishers = graph->get_publishers_info_by_topic(topic.first);
+      auto subscriptions = graph->get_subscriptions_info_by_topic(topic.first);
+      for (const auto & publisher : publishers) {
+        auto publisher_node = use_intra_process.find(
+          fully_qualified_name(publisher.node_namespace(), publisher.node_name()));
+        if (publisher_node == use_intra_process.end()) {
+          continue;
+        }
+        for (const auto & subscription : subscriptions) {
+          auto subscription_node = use_intra_process.find(
+            fully_qualified_name(subscription.node_namespace(), subscription.node_name()));
+          if (subscription_node == use_intra_process.end()) {
+            continue;
+          }
+          connections.push_back(
+            {topic.first, publisher_node->first, subscription_node->first,
+              publisher_node->second && subscription_node->second});
+        }
+      }
+    }
+  }
+
+  std::vector<TopicConnection> connections;
+  for (auto & topic_and_connections : connections_by_topic) {
+    for (auto & connection : topic_and_connections.second) {
+      RCLCPP_INFO(
+        get_logger(), "Topic '%s' from '%s' to '%s': %s", connection.topic_name.c_str(),
+        connection.publisher_node_name.c_str(), connection.subscription_node_name.c_str(),
+        connection.intra_process ? "intra-process" : "middleware");
+      connections.push_back(std::move(connection));
+    }
+  }
+  return connections;
+}
+
+ComponentManager::ComponentResourceUsage
+ComponentManager::get_component_resource_usage(uint64_t node_id)
+{
+  auto wrapper = node_wrappers_.find(node_id);
+  if (wrapper == node_wrappers_.end()) {
+    throw ComponentManagerException("No node found with unique_id: " + std::to_string(node_id));
+  }
+  auto node = wrapper->second.get_node_base_interface();
+
+  ComponentResourceUsage usage;
+  usage.full_node_name = node->get_fully_qualified_name();
+  const bool resource_accounting = get_parameter("resource_accounting").as_bool();
+  node->for_each_callback_group(
+    [&usage, resource_accounting](rclcpp::CallbackGroup::SharedPtr group) {
+      if (resource_accounting && !group->is_cpu_accounting_enabled()) {
+        group->enable_cpu_accounting();
+      }
+      const auto cpu_statistics = group->get_cpu_statistics();
+      usage.callbacks += cpu_statistics.executions;
+      usage.cpu_time += cpu_statistics.cpu_time;
+      for (const auto & weak_subscription : group->get_entities()->subscriptions) {
+        if (auto subscription = weak_subscription.lock()) {
+          const auto counters = subscription->get_intra_process_receive_counters();
+          usage.intra_process_received.messages += counters.messages;
+          usage.intra_process_received.bytes += counters.bytes;
+        }
+      }
+    });
+
+  // The publishers aren't tracked by the node, the intra-process ones are by the manager.
+  auto ipm = rclcpp::experimental::get_intra_process_manager(*node->get_context());
+  for (const auto & publisher : ipm->get_publishers()) {
+    if (publisher->get_rcl_node_handle().get() == node->get_rcl_node_handle()) {
+      const auto counters = publisher->get_intra_process_publish_counters();
+      usage.intra_process_sent.messages += counters.messages;
+      usage.intra_process_sent.bytes += counters.bytes;
+    }
+  }
+
+  auto allocator = node_allocators_.find(node_id);
+  if (allocator != node_allocators_.end()) {
+    usage.allocations = allocator->second->get_statistics()->get_counters();
+  }
+  return usage;
+}
+
+namespace
+{
+
+// Return a message with a single value measured for the whole period.
+statistics_msgs::msg::MetricsMessage
+make_metrics_message(
+  const std::string & source_name, const char * metrics_source, const char * unit,
+  const rclcpp::Time & window_start, const rclcpp::Time & window_stop, double value)
+{
+  using statistics_msgs::msg::StatisticDataType;
+  statistics_msgs::msg::MetricsMessage message;
+  message.measurement_source_name = source_name;
+  message.metrics_source = metrics_source;
+  message.unit = unit;
+  message.window_start = window_start;
+  message.window_stop = window_stop;
+  for (const auto data_type : {StatisticDataType::STATISTICS_DATA_TYPE_AVERAGE,
+      StatisticDataType::STATISTICS_DATA_TYPE_MINIMUM,
+      StatisticDataType::STATISTICS_DATA_TYPE_MAXIMUM})
+  {
+    statistics_msgs::msg::StatisticDataPoint point;
+    point.data_type = data_type;
+    point.data = value;
+    message.statistics.push_back(point);
+  }
+  statistics_msgs::msg::StatisticDataPoint sample_count;
+  sample_count.data_type = StatisticDataType::STATISTICS_DATA_TYPE_SAMPLE_COUNT;
+  sample_count.data = 1.;
+  message.statistics.push_back(sample_count);
+  return message;
+}
+
+}  // namespace
+
+void
+ComponentManager::publish_component_statistics()
+{
+  const rclcpp::Time period_end = now();
+  const double period_ns =
+    static_cast<double>((period_end - resource_usage_period_start_).nanoseconds());
+
+  std::map<uint64_t, ComponentResourceUsage> resource_usage;
+  for (const auto & wrapper : node_wrappers_) {
+    auto usage = get_component_resource_usage(wrapper.first);
+    // The components loaded during the period start with nothing used.
+    const ComponentResourceUsage & previous = previous_resource_usage_[wrapper.first];
+    const auto publish = [&](const char * metrics_source, const char * unit, double value) {
+        component_statistics_publisher_->publish(
+          make_metrics_message(
+            usage.full_node_name, metrics_source, unit, resource_usage_period_start_,
+            period_end, value));
+      };
+    const double cpu_time_ns = static_cast<double>((usage.cpu_time - previous.cpu_time).count());
+    publish(kComponentCpuUsageStatName, "ratio", period_ns > 0. ? cpu_time_ns / period_ns : 0.);
+    publish(
+      kComponentCallbacksStatName, "count",
+      static_cast<double>(usage.callbacks - previous.callbacks));
+    publish(
+      kComponentIntraProcessBytesSentStatName, "B",
+      static_cast<double>(usage.intra_process_sent.bytes - previous.intra_process_sent.bytes));
+    publish(
+      kComponentIntraProcessBytesReceivedStatName, "B",
+      static_cast<double>(
+        usage.intra_process_received.bytes - previous.intra_process_received.bytes));
+    publish(
+      kComponentBytesAllocatedStatName, "B",
+      static_cast<double>(
+        usage.allocations.bytes_allocated - previous.allocations.bytes_allocated));
+    publish(
+      kComponentBytesInUseStatName, "B", static_cast<double>(usage.allocations.bytes_in_use));
+    resource_usage.emplace(wrapper.first, std::move(usage));
+  }
+  // The unloaded components are forgotten.
+  previous_resource_usage_ = std::move(resource_usage);
+  resource_usage_period_start_ = period_end;
+}
+
 void
 ComponentManager::set_executor(const std::weak_ptr<rclcpp::Executor> executor)
 {
   executor_ = executor;
 }
 
+ComponentManager::ExecutorGroup &
+ComponentManager::get_executor_group(const std::string & name)
+{
+  auto it = executor_groups_.find(name);
+  if (it != executor_groups_.end()) {
+    return it->second;
+  }
+
+  const std::string prefix = "executor_groups." + name;
+  rclcpp::ThreadAttributes attributes;
+  for (int64_t cpu : get_parameter(prefix + ".cpus").as_integer_array()) {
+    attributes.cpu_affinity.push_back(static_cast<size_t>(cpu));
+  }
+  attributes.numa_node = static_cast<int>(get_parameter(prefix + ".numa_node").as_int());
+  const auto number_of_threads =
+    static_cast<size_t>(std::max<int64_t>(1, get_parameter(prefix + ".thread_num").as_int()));
+
+  rclcpp::ExecutorOptions options;
+  options.thread_attributes.assign(number_of_threads, attributes);
+  auto exec = std::make_shared<rclcpp::executors::MultiThreadedExecutor>(
+    options, number_of_threads);
+  RCLCPP_INFO(
+    get_logger(), "Created executor group '%s' with %zu threads", name.c_str(),
+    number_of_threads);
+
+  ExecutorGroup & group = executor_groups_[name];
+  group.executor = exec;
+  group.thread = std::thread(
+    [exec]() {
+      exec->spin();
+    });
+  return group;
+}
+
 void
 ComponentManager::add_node_to_executor(uint64_t node_id)
 {
+  auto group_name = node_executor_groups_.find(node_id);
+  if (group_name != node_executor_groups_.end()) {
+    get_executor_group(group_name->second).executor->add_node(
+      node_wrappers_[node_id].get_node_base_interface(), true);
+    return;
+  }
   if (auto exec = executor_.lock()) {
     exec->add_node(node_wrappers_[node_id].get_node_base_interface(), true);
   }
@@ -207,78 +550,215 @@ ComponentManager::add_node_to_executor(uint64_t node_id)
 void
 ComponentManager::remove_node_from_executor(uint64_t node_id)
 {
+  auto group_name = node_executor_groups_.find(node_id);
+  if (group_name != node_executor_groups_.end()) {
+    get_executor_group(group_name->second).executor->remove_node(
+      node_wrappers_[node_id].get_node_base_interface());
+    node_executor_groups_.erase(group_name);
+    return;
+  }
   if (auto exec = executor_.lock()) {
     exec->remove_node(node_wrappers_[node_id].get_node_base_interface());
   }
 }
 
-void
-ComponentManager::on_load_node(
-  const std::shared_ptr<rmw_request_id_t> request_header,
-  const std::shared_ptr<LoadNode::Request> request,
-  std::shared_ptr<LoadNode::Response> response)
+namespace
 {
-  (void) request_header;
 
-  try {
-    auto resources = get_component_resources(request->package_name);
+// A component of load_nodes(), whose node is constructed by the worker threads
+struct PendingComponent
+{
+  std::shared_ptr<rclcpp_components::NodeFactory> factory;
+  rclcpp::NodeOptions options;
+  rclcpp_components::NodeInstanceWrapper wrapper;
+  std::string executor_group;
+  std::string error_message;
+  // Set in the node options when the resources are accounted
+  std::shared_ptr<rclcpp::allocator::TrackingAllocator<char>> allocator;
+};
+
+// Return the executor group of the request, empty if there is none.
+std::string
+get_requested_executor_group(
+  const composition_interfaces::srv::LoadNode::Request & request,
+  const std::vector<std::string> & group_names)
+{
+  for (const auto & a : request.extra_arguments) {
+    const rclcpp::Parameter extra_argument = rclcpp::Parameter::from_parameter_msg(a);
+    if (extra_argument.get_name() != "executor_group") {
+      continue;
+    }
+    if (extra_argument.get_type() != rclcpp::ParameterType::PARAMETER_STRING) {
+      throw rclcpp_components::ComponentManagerException(
+              "Extra component argument 'executor_group' must be a string");
+    }
+    const std::string group_name = extra_argument.get_value<std::string>();
+    if (std::find(group_names.begin(), group_names.end(), group_name) == group_names.end()) {
+      throw rclcpp_components::ComponentManagerException(
+              "Unknown executor group '" + group_name + "'");
+    }
+    return group_name;
+  }
+  return {};
+}
 
-    for (const auto & resource : resources) {
-      if (resource.first != request->plugin_name) {
-        continue;
-      }
-      auto factory = create_component_factory(resource);
+}  // namespace
 
-      if (factory == nullptr) {
+std::vector<std::shared_ptr<ComponentManager::LoadNode::Response>>
+ComponentManager::load_nodes(
+  const std::vector<std::shared_ptr<LoadNode::Request>> & requests,
+  size_t number_of_threads)
+{
+  std::vector<std::shared_ptr<LoadNode::Response>> responses;
+  responses.reserve(requests.size());
+  std::vector<PendingComponent> components(requests.size());
+
+  // The libraries are loaded one at a time, since the class loaders aren't shared safely.
+  for (size_t i = 0; i < requests.size(); ++i) {
+    const auto & request = requests[i];
+    auto response = std::make_shared<LoadNode::Response>();
+    responses.push_back(response);
+    try {
+      auto resources = get_component_resources(request->package_name);
+      for (const auto & resource : resources) {
+        if (resource.first != request->plugin_name) {
+          continue;
+        }
+        components[i].factory = create_component_factory(resource);
+        if (components[i].factory != nullptr) {
+          break;
+        }
+      }
+      if (components[i].factory == nullptr) {
+        RCLCPP_ERROR(
+          get_logger(), "Failed to find class with the requested plugin name '%s' in "
+          "the loaded library",
+          request->plugin_name.c_str());
+        response->error_message = "Failed to find class with the requested plugin name.";
+        response->success = false;
         continue;
       }
-
-      auto options = create_node_options(request);
-      auto node_id = unique_id_++;
-
-      if (0 == node_id) {
-        // This puts a technical limit on the number of times you can add a component.
-        // But even if you could add (and remove) them at 1 kHz (very optimistic rate)
-        // it would still be a very long time before you could exhaust the pool of id's:
-        //   2^64 / 1000 times per sec / 60 sec / 60 min / 24 hours / 365 days = 584,942,417 years
-        // So around 585 million years. Even at 1 GHz, it would take 585 years.
-        // I think it's safe to avoid trying to handle overflow.
-        // If we roll over then it's most likely a bug.
-        throw std::overflow_error("exhausted the unique ids for components in this process");
+      components[i].options = create_node_options(request);
+      if (get_parameter("resource_accounting").as_bool()) {
+        components[i].allocator = std::make_shared<rclcpp::allocator::TrackingAllocator<char>>();
+        components[i].options.allocator(
+          rclcpp::allocator::get_rcl_allocator<char>(*components[i].allocator));
       }
+      components[i].executor_group = get_requested_executor_group(
+        *request, get_parameter("executor_groups").as_string_array());
+    } catch (const ComponentManagerException & ex) {
+      RCLCPP_ERROR(get_logger(), "%s", ex.what());
+      components[i].factory.reset();
+      response->error_message = ex.what();
+      response->success = false;
+    }
+  }
 
-      try {
-        node_wrappers_[node_id] = factory->create_node_instance(options);
-      } catch (const std::exception & ex) {
-        // In the case that the component constructor throws an exception,
-        // rethrow into the following catch block.
-        throw ComponentManagerException(
-                "Component constructor threw an exception: " + std::string(ex.what()));
-      } catch (...) {
-        // In the case that the component constructor throws an exception,
-        // rethrow into the following catch block.
-        throw ComponentManagerException("Component constructor threw an exception");
+  // The nodes of the components don't depend on each other, so they're constructed concurrently.
+  std::atomic<size_t> next_component{0};
+  auto construct_nodes = [&components, &next_component]() {
+      for (size_t i = next_component++; i < components.size(); i = next_component++) {
+        auto & component = components[i];
+        if (component.factory == nullptr) {
+          continue;
+        }
+        try {
+          component.wrapper = component.factory->create_node_instance(component.options);
+        } catch (const std::exception & ex) {
+          component.error_message =
+            "Component constructor threw an exception: " + std::string(ex.what());
+        } catch (...) {
+          component.error_message = "Component constructor threw an exception";
+        }
       }
+    };
+  if (number_of_threads == 0) {
+    number_of_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < std::min(number_of_threads, components.size()); ++i) {
+    workers.emplace_back(construct_nodes);
+  }
+  construct_nodes();
+  for (auto & worker : workers) {
+    worker.join();
+  }
 
-      add_node_to_executor(node_id);
+  // Messages between components with and without intra-process go through the middleware.
+  std::vector<bool> use_intra_process;
+  for (auto & wrapper : node_wrappers_) {
+    use_intra_process.push_back(
+      wrapper.second.get_node_base_interface()->get_use_intra_process_default());
+  }
 
-      auto node = node_wrappers_[node_id].get_node_base_interface();
-      response->full_node_name = node->get_fully_qualified_name();
-      response->unique_id = node_id;
-      response->success = true;
-      return;
+  // The nodes are added in the order of the requests.
+  for (size_t i = 0; i < components.size(); ++i) {
+    auto & component = components[i];
+    const auto & response = responses[i];
+    if (component.factory == nullptr) {
+      continue;
     }
-    RCLCPP_ERROR(
-      get_logger(), "Failed to find class with the requested plugin name '%s' in "
-      "the loaded library",
-      request->plugin_name.c_str());
-    response->error_message = "Failed to find class with the requested plugin name.";
-    response->success = false;
-  } catch (const ComponentManagerException & ex) {
-    RCLCPP_ERROR(get_logger(), "%s", ex.what());
-    response->error_message = ex.what();
-    response->success = false;
+    if (!component.error_message.empty()) {
+      RCLCPP_ERROR(get_logger(), "%s", component.error_message.c_str());
+      response->error_message = component.error_message;
+      response->success = false;
+      continue;
+    }
+
+    auto node_id = unique_id_++;
+    if (0 == node_id) {
+      // This puts a technical limit on the number of times you can add a component.
+      // But even if you could add (and remove) them at 1 kHz (very optimistic rate)
+      // it would still be a very long time before you could exhaust the pool of id's:
+      //   2^64 / 1000 times per sec / 60 sec / 60 min / 24 hours / 365 days = 584,942,417 years
+      // So around 585 million years. Even at 1 GHz, it would take 585 years.
+      // I think it's safe to avoid trying to handle overflow.
+      // If we roll over then it's most likely a bug.
+      throw std::overflow_error("exhausted the unique ids for components in this process");
+    }
+    node_wrappers_[node_id] = std::move(component.wrapper);
+    if (!component.executor_group.empty()) {
+      node_executor_groups_[node_id] = component.executor_group;
+    }
+    if (component.allocator) {
+      node_allocators_[node_id] = std::move(component.allocator);
+      node_wrappers_[node_id].get_node_base_interface()->for_each_callback_group(
+        [](rclcpp::CallbackGroup::SharedPtr group) {
+          if (!group->is_cpu_accounting_enabled()) {
+            group->enable_cpu_accounting();
+          }
+        });
+    }
+
+    add_node_to_executor(node_id);
+
+    auto node = node_wrappers_[node_id].get_node_base_interface();
+    const bool node_uses_intra_process = node->get_use_intra_process_default();
+    if (std::find(use_intra_process.begin(), use_intra_process.end(), !node_uses_intra_process) !=
+      use_intra_process.end())
+    {
+      RCLCPP_WARN(
+        get_logger(), "Component '%s' %s intra-process communications, unlike other "
+        "components of the container: the messages between them go through the middleware",
+        node->get_fully_qualified_name(), node_uses_intra_process ? "uses" : "doesn't use");
+    }
+    use_intra_process.push_back(node_uses_intra_process);
+    response->full_node_name = node->get_fully_qualified_name();
+    response->unique_id = node_id;
+    response->success = true;
   }
+  return responses;
+}
+
+void
+ComponentManager::on_load_node(
+  const std::shared_ptr<rmw_request_id_t> request_header,
+  const std::shared_ptr<LoadNode::Request> request,
+  std::shared_ptr<LoadNode::Response> response)
+{
+  (void) request_header;
+
+  *response = *load_nodes({request}, 1u).front();
 }
 
 void
@@ -299,7 +779,13 @@ ComponentManager::on_unload_node(
     RCLCPP_WARN(get_logger(), "%s", ss.str().c_str());
   } else {
     remove_node_from_executor(request->unique_id);
+    std::weak_ptr<rcl_node_t> rcl_node =
+      wrapper->second.get_node_base_interface()->get_shared_rcl_node_handle();
     node_wrappers_.erase(wrapper);
+    // The allocator is kept while something else, like a publisher, holds the rcl node.
+    if (rcl_node.expired()) {
+      node_allocators_.erase(request->unique_id);
+    }
     response->success = true;
   }
 }
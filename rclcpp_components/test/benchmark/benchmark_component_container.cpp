@@ -0,0 +1,254 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark/benchmark.h"
+
+#include <rcutils/logging.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rclcpp_components/component_manager.hpp"
+
+#include "./process_memory.hpp"
+
+using LoadNode = composition_interfaces::srv::LoadNode;
+using UnloadNode = composition_interfaces::srv::UnloadNode;
+
+namespace
+{
+
+class BenchmarkComponentManager : public rclcpp_components::ComponentManager
+{
+public:
+  using rclcpp_components::ComponentManager::ComponentManager;
+  using rclcpp_components::ComponentManager::on_unload_node;
+};
+
+}  // namespace
+
+/// A component container loading and unloading N synthetic components.
+/**
+ * The first benchmark argument is the number of components, the second one selects
+ * the executor of the container: 0 for a single-threaded one, 1 for a multi-threaded one.
+ * Besides the time, the benchmarks report the peak resident set size of the process and
+ * the memory used by each component.
+ */
+class ComponentContainerTest : public benchmark::Fixture
+{
+public:
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Woverloaded-virtual"
+#endif
+  void SetUp(benchmark::State & state) override
+  {
+    rcutils_logging_set_default_logger_level(RCUTILS_LOG_SEVERITY_WARN);
+
+    context = std::make_shared<rclcpp::Context>();
+    context->init(0, nullptr, rclcpp::InitOptions().auto_initialize_logging(false));
+
+    rclcpp::ExecutorOptions exec_options;
+    exec_options.context = context;
+    if (state.range(1) == 0) {
+      executor = std::make_shared<rclcpp::executors::SingleThreadedExecutor>(exec_options);
+    } else {
+      executor = std::make_shared<rclcpp::executors::MultiThreadedExecutor>(exec_options);
+    }
+
+    manager = std::make_shared<BenchmarkComponentManager>(
+      executor, "benchmark_manager", rclcpp::NodeOptions().context(context));
+    executor->add_node(manager);
+
+    const auto number_of_components = static_cast<size_t>(state.range(0));
+    requests.clear();
+    for (size_t i = 0; i < number_of_components; ++i) {
+      auto request = std::make_shared<LoadNode::Request>();
+      request->package_name = "rclcpp_components";
+      request->plugin_name = "test_rclcpp_components::TestComponentFoo";
+      request->node_name = "component_" + std::to_string(i);
+      requests.push_back(request);
+    }
+    // Load and unload the components once, so that loading the library isn't measured
+    unload_components(load_components(1u));
+  }
+
+  void TearDown(benchmark::State &) override
+  {
+    context->shutdown("Benchmark is complete");
+
+    manager.reset();
+    executor.reset();
+    context.reset();
+  }
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+
+protected:
+  /// Load the components, returning their ids, or an empty vector on failure.
+  std::vector<uint64_t>
+  load_components(size_t number_of_threads)
+  {
+    std::vector<uint64_t> unique_ids;
+    for (const auto & response : manager->load_nodes(requests, number_of_threads)) {
+      if (!response->success) {
+        return {};
+      }
+      unique_ids.push_back(response->unique_id);
+    }
+    return unique_ids;
+  }
+
+  /// Unload the components, returning false on failure.
+  bool
+  unload_components(const std::vector<uint64_t> & unique_ids)
+  {
+    bool success = true;
+    for (uint64_t unique_id : unique_ids) {
+      auto request = std::make_shared<UnloadNode::Request>();
+      request->unique_id = unique_id;
+      auto response = std::make_shared<UnloadNode::Response>();
+      manager->on_unload_node(nullptr, request, response);
+      success &= response->success;
+    }
+    return success;
+  }
+
+  /// Report the peak memory of the process and the memory used by each component.
+  void
+  report_memory(benchmark::State & state, double rss_before_kib, double rss_after_kib)
+  {
+    state.counters["peak_rss_kib"] = get_peak_rss_kib();
+    state.counters["rss_per_component_kib"] =
+      (rss_after_kib - rss_before_kib) / static_cast<double>(state.range(0));
+  }
+
+  rclcpp::Context::SharedPtr context;
+  rclcpp::Executor::SharedPtr executor;
+  std::shared_ptr<BenchmarkComponentManager> manager;
+  std::vector<std::shared_ptr<LoadNode::Request>> requests;
+};
+
+static void container_sizes(benchmark::internal::Benchmark * benchmark)
+{
+  for (int64_t number_of_components : {1, 10, 100}) {
+    for (int64_t executor_type : {0, 1}) {
+      benchmark->Args({number_of_components, executor_type});
+    }
+  }
+  benchmark->ArgNames({"components", "multi_threaded"});
+}
+
+/// Loading the components one at a time, as with the load node service.
+BENCHMARK_DEFINE_F(ComponentContainerTest, load_components)(benchmark::State & state)
+{
+  double rss_before_kib = 0.;
+  double rss_after_kib = 0.;
+  for (auto _ : state) {
+    (void)_;
+    state.PauseTiming();
+    rss_before_kib = get_rss_kib();
+    state.ResumeTiming();
+
+    auto unique_ids = load_components(1u);
+
+    state.PauseTiming();
+    rss_after_kib = get_rss_kib();
+    if (unique_ids.empty() || !unload_components(unique_ids)) {
+      state.SkipWithError("the components couldn't be loaded");
+      break;
+    }
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  report_memory(state, rss_before_kib, rss_after_kib);
+}
+BENCHMARK_REGISTER_F(ComponentContainerTest, load_components)
+  ->Apply(container_sizes)->UseRealTime();
+
+/// Loading the components with their nodes constructed by one thread per hardware thread.
+BENCHMARK_DEFINE_F(ComponentContainerTest, load_components_concurrently)(
+  benchmark::State & state)
+{
+  double rss_before_kib = 0.;
+  double rss_after_kib = 0.;
+  for (auto _ : state) {
+    (void)_;
+    state.PauseTiming();
+    rss_before_kib = get_rss_kib();
+    state.ResumeTiming();
+
+    auto unique_ids = load_components(0u);
+
+    state.PauseTiming();
+    rss_after_kib = get_rss_kib();
+    if (unique_ids.empty() || !unload_components(unique_ids)) {
+      state.SkipWithError("the components couldn't be loaded");
+      break;
+    }
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  report_memory(state, rss_before_kib, rss_after_kib);
+}
+BENCHMARK_REGISTER_F(ComponentContainerTest, load_components_concurrently)
+  ->Apply(container_sizes)->UseRealTime();
+
+BENCHMARK_DEFINE_F(ComponentContainerTest, unload_components)(benchmark::State & state)
+{
+  for (auto _ : state) {
+    (void)_;
+    state.PauseTiming();
+    auto unique_ids = load_components(1u);
+    if (unique_ids.empty()) {
+      state.SkipWithError("the components couldn't be loaded");
+      break;
+    }
+    state.ResumeTiming();
+
+    if (!unload_components(unique_ids)) {
+      state.SkipWithError("the components couldn't be unloaded");
+      break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["peak_rss_kib"] = get_peak_rss_kib();
+}
+BENCHMARK_REGISTER_F(ComponentContainerTest, unload_components)
+  ->Apply(container_sizes)->UseRealTime();
+
+/// One spin of the executor of the container, with N idle components.
+BENCHMARK_DEFINE_F(ComponentContainerTest, spin_idle_components)(benchmark::State & state)
+{
+  const double rss_before_kib = get_rss_kib();
+  auto unique_ids = load_components(1u);
+  if (unique_ids.empty()) {
+    state.SkipWithError("the components couldn't be loaded");
+    return;
+  }
+  const double rss_after_kib = get_rss_kib();
+  // Collect the entities of the components once, as the executor then reuses them
+  executor->spin_some();
+
+  for (auto _ : state) {
+    (void)_;
+    executor->spin_some();
+  }
+  report_memory(state, rss_before_kib, rss_after_kib);
+  unload_components(unique_ids);
+}
+BENCHMARK_REGISTER_F(ComponentContainerTest, spin_idle_components)->Apply(container_sizes);
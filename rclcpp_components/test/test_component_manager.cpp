@@ -15,6 +15,8 @@
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "rclcpp_components/component_manager.hpp"
 
@@ -95,3 +97,29 @@ TEST_F(TestComponentManager, create_component_factory_invalid)
     auto resources = manager->get_component_resources("invalid_rclcpp_components"),
     rclcpp_components::ComponentManagerException);
 }
+
+TEST_F(TestComponentManager, cached_component_factories)
+{
+  auto exec = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+  auto manager = std::make_shared<rclcpp_components::ComponentManager>(
+    exec, "ComponentManager",
+    rclcpp::NodeOptions()
+    .start_parameter_services(false)
+    .start_parameter_event_publisher(false)
+    .parameter_overrides(
+    {
+      rclcpp::Parameter(
+        "preload_packages", std::vector<std::string>{"rclcpp_components", "invalid_package"}),
+    }));
+
+  auto resources = manager->get_component_resources("rclcpp_components");
+  ASSERT_EQ(3u, resources.size());
+  EXPECT_EQ(resources, manager->get_component_resources("rclcpp_components"));
+
+  // The factories were created when preloading the package
+  for (const auto & resource : resources) {
+    auto factory = manager->create_component_factory(resource);
+    EXPECT_NE(nullptr, factory);
+    EXPECT_EQ(factory, manager->create_component_factory(resource));
+  }
+}
@@ -15,7 +15,9 @@
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "composition_interfaces/srv/load_node.hpp"
 #include "composition_interfaces/srv/unload_node.hpp"
@@ -24,6 +26,8 @@
 #include "rclcpp_components/component_manager.hpp"
 #include "rclcpp_components/component_manager_isolated.hpp"
 
+#include "statistics_msgs/msg/metrics_message.hpp"
+
 using namespace std::chrono_literals;
 
 class TestComponentManager : public ::testing::Test
@@ -37,7 +41,7 @@ protected:
 
 // TODO(hidmic): split up tests once Node bring up/tear down races
 //               are solved https://github.com/ros2/rclcpp/issues/863
-void test_components_api(bool use_dedicated_executor)
+void test_components_api(bool use_dedicated_executor, bool use_shared_thread_pool = false)
 {
   auto exec = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
   auto node = rclcpp::Node::make_shared("test_component_manager");
@@ -45,7 +49,11 @@ void test_components_api(bool use_dedicated_executor)
   if (use_dedicated_executor) {
     using ComponentManagerIsolated =
       rclcpp_components::ComponentManagerIsolated<rclcpp::executors::SingleThreadedExecutor>;
-    manager = std::make_shared<ComponentManagerIsolated>(exec);
+    auto isolated_manager = std::make_shared<ComponentManagerIsolated>(exec);
+    if (use_shared_thread_pool) {
+      isolated_manager->use_shared_thread_pool(2u);
+    }
+    manager = isolated_manager;
   } else {
     manager = std::make_shared<rclcpp_components::ComponentManager>(exec);
   }
@@ -387,4 +395,212 @@ TEST_F(TestComponentManager, components_api)
     SCOPED_TRACE("ComponentManagerIsolated");
     test_components_api(true);
   }
+  {
+    SCOPED_TRACE("ComponentManagerIsolated with a shared thread pool");
+    test_components_api(true, true);
+  }
+}
+
+TEST_F(TestComponentManager, load_nodes)
+{
+  auto exec = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+  auto manager = std::make_shared<rclcpp_components::ComponentManager>(exec);
+
+  std::vector<std::shared_ptr<composition_interfaces::srv::LoadNode::Request>> requests;
+  for (const char * plugin_name : {
+      "test_rclcpp_components::TestComponentFoo",
+      "test_rclcpp_components::TestComponent",
+      "test_rclcpp_components::TestComponentBar",
+      "test_rclcpp_components::TestComponentNoNode"})
+  {
+    auto request = std::make_shared<composition_interfaces::srv::LoadNode::Request>();
+    request->package_name = "rclcpp_components";
+    request->plugin_name = plugin_name;
+    requests.push_back(request);
+  }
+
+  auto responses = manager->load_nodes(requests, 3u);
+  ASSERT_EQ(4u, responses.size());
+  EXPECT_TRUE(responses[0]->success);
+  EXPECT_EQ("/test_component_foo", responses[0]->full_node_name);
+  EXPECT_EQ(1u, responses[0]->unique_id);
+  EXPECT_FALSE(responses[1]->success);
+  EXPECT_EQ("Failed to find class with the requested plugin name.", responses[1]->error_message);
+  EXPECT_EQ(0u, responses[1]->unique_id);
+  // The ids follow the order of the requests, whichever node is constructed first
+  EXPECT_TRUE(responses[2]->success);
+  EXPECT_EQ("/test_component_bar", responses[2]->full_node_name);
+  EXPECT_EQ(2u, responses[2]->unique_id);
+  EXPECT_TRUE(responses[3]->success);
+  EXPECT_EQ("/test_component_no_node", responses[3]->full_node_name);
+  EXPECT_EQ(3u, responses[3]->unique_id);
+}
+
+TEST_F(TestComponentManager, use_intra_process_comms_by_default)
+{
+  class IntraProcessComponentManager : public rclcpp_components::ComponentManager
+  {
+public:
+    using rclcpp_components::ComponentManager::ComponentManager;
+    using rclcpp_components::ComponentManager::create_node_options;
+  };
+
+  auto exec = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+  auto manager = std::make_shared<IntraProcessComponentManager>(
+    exec, "ComponentManager",
+    rclcpp::NodeOptions()
+    .start_parameter_services(false)
+    .start_parameter_event_publisher(false)
+    .parameter_overrides({rclcpp::Parameter("use_intra_process_comms", true)}));
+
+  auto request = std::make_shared<composition_interfaces::srv::LoadNode::Request>();
+  request->package_name = "rclcpp_components";
+  request->plugin_name = "test_rclcpp_components::TestComponentFoo";
+  EXPECT_TRUE(manager->create_node_options(request).use_intra_process_comms());
+
+  // The request still has the last word
+  rclcpp::Parameter use_intra_process_comms("use_intra_process_comms", false);
+  request->extra_arguments.push_back(use_intra_process_comms.to_parameter_msg());
+  EXPECT_FALSE(manager->create_node_options(request).use_intra_process_comms());
+
+  auto responses = manager->load_nodes({request});
+  ASSERT_EQ(1u, responses.size());
+  EXPECT_TRUE(responses[0]->success);
+  // Only the component itself may be connected to its parameter events, through the middleware
+  for (const auto & connection : manager->report_topic_connections()) {
+    EXPECT_EQ("/test_component_foo", connection.publisher_node_name);
+    EXPECT_EQ("/test_component_foo", connection.subscription_node_name);
+    EXPECT_FALSE(connection.intra_process);
+  }
+}
+
+TEST_F(TestComponentManager, executor_groups)
+{
+  auto exec = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+  auto manager = std::make_shared<rclcpp_components::ComponentManager>(
+    exec, "ComponentManager",
+    rclcpp::NodeOptions()
+    .start_parameter_services(false)
+    .start_parameter_event_publisher(false)
+    .parameter_overrides(
+    {
+      rclcpp::Parameter("executor_groups", std::vector<std::string>{"perception"}),
+      rclcpp::Parameter("executor_groups.perception.thread_num", 2),
+      rclcpp::Parameter("executor_groups.perception.cpus", std::vector<int64_t>{0}),
+    }));
+
+  auto make_request = [](const std::string & plugin_name, const std::string & executor_group) {
+      auto request = std::make_shared<composition_interfaces::srv::LoadNode::Request>();
+      request->package_name = "rclcpp_components";
+      request->plugin_name = plugin_name;
+      rclcpp::Parameter group("executor_group", executor_group);
+      request->extra_arguments.push_back(group.to_parameter_msg());
+      return request;
+    };
+  auto responses = manager->load_nodes(
+  {
+    make_request("test_rclcpp_components::TestComponentFoo", "perception"),
+    make_request("test_rclcpp_components::TestComponentBar", "planning"),
+  });
+  ASSERT_EQ(2u, responses.size());
+  EXPECT_TRUE(responses[0]->success);
+  EXPECT_FALSE(responses[1]->success);
+  EXPECT_EQ("Unknown executor group 'planning'", responses[1]->error_message);
+
+  // The component isn't spun by the executor of the manager
+  EXPECT_EQ(0u, exec->get_all_callback_groups().size());
+}
+
+TEST_F(TestComponentManager, resource_accounting)
+{
+  class AccountingComponentManager : public rclcpp_components::ComponentManager
+  {
+public:
+    using rclcpp_components::ComponentManager::ComponentManager;
+
+    rclcpp::Node::SharedPtr
+    get_node(uint64_t node_id)
+    {
+      return std::static_pointer_cast<rclcpp::Node>(
+        node_wrappers_.at(node_id).get_node_instance());
+    }
+  };
+
+  auto exec = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+  auto manager = std::make_shared<AccountingComponentManager>(
+    exec, "ComponentManager",
+    rclcpp::NodeOptions()
+    .start_parameter_services(false)
+    .start_parameter_event_publisher(false)
+    .parameter_overrides(
+    {
+      rclcpp::Parameter("use_intra_process_comms", true),
+      rclcpp::Parameter("resource_accounting", true),
+      rclcpp::Parameter("resource_accounting_period_ms", 10),
+    }));
+  exec->add_node(manager);
+  EXPECT_THROW(
+    manager->get_component_resource_usage(42u), rclcpp_components::ComponentManagerException);
+
+  auto request = std::make_shared<composition_interfaces::srv::LoadNode::Request>();
+  request->package_name = "rclcpp_components";
+  request->plugin_name = "test_rclcpp_components::TestComponentFoo";
+  auto responses = manager->load_nodes({request});
+  ASSERT_EQ(1u, responses.size());
+  ASSERT_TRUE(responses[0]->success);
+  const uint64_t node_id = responses[0]->unique_id;
+
+  // Messages passed within the component
+  using statistics_msgs::msg::MetricsMessage;
+  auto node = manager->get_node(node_id);
+  size_t received = 0u;
+  auto subscription = node->create_subscription<MetricsMessage>(
+    "~/test_topic", 10, [&received](MetricsMessage::ConstSharedPtr) {received++;});
+  auto publisher = node->create_publisher<MetricsMessage>("~/test_topic", 10);
+  publisher->publish(MetricsMessage());
+  publisher->publish(MetricsMessage());
+
+  // The statistics of the component are published by the manager
+  std::set<std::string> received_metrics;
+  auto listener = std::make_shared<rclcpp::Node>("test_resource_accounting_listener");
+  auto statistics_subscription = listener->create_subscription<MetricsMessage>(
+    "/ComponentManager/_container/component_statistics", 100,
+    [&received_metrics](MetricsMessage::ConstSharedPtr message) {
+      if (message->measurement_source_name == "/test_component_foo") {
+        received_metrics.insert(message->metrics_source);
+      }
+    });
+  exec->add_node(listener);
+
+  const auto start = std::chrono::steady_clock::now();
+  while ((received < 2u || received_metrics.size() < 6u) &&
+    std::chrono::steady_clock::now() - start < 5s)
+  {
+    exec->spin_some(10ms);
+  }
+  EXPECT_EQ(2u, received);
+  EXPECT_EQ(1u, received_metrics.count(rclcpp_components::kComponentCpuUsageStatName));
+  EXPECT_EQ(1u, received_metrics.count(rclcpp_components::kComponentCallbacksStatName));
+  EXPECT_EQ(
+    1u, received_metrics.count(rclcpp_components::kComponentIntraProcessBytesSentStatName));
+  EXPECT_EQ(
+    1u, received_metrics.count(rclcpp_components::kComponentIntraProcessBytesReceivedStatName));
+  EXPECT_EQ(1u, received_metrics.count(rclcpp_components::kComponentBytesAllocatedStatName));
+  EXPECT_EQ(1u, received_metrics.count(rclcpp_components::kComponentBytesInUseStatName));
+
+  const auto usage = manager->get_component_resource_usage(node_id);
+  EXPECT_EQ("/test_component_foo", usage.full_node_name);
+  EXPECT_LE(2u, usage.callbacks);
+  EXPECT_EQ(2u, usage.intra_process_sent.messages);
+  EXPECT_EQ(2u * sizeof(MetricsMessage), usage.intra_process_sent.bytes);
+  EXPECT_EQ(2u, usage.intra_process_received.messages);
+  node->for_each_callback_group(
+    [](rclcpp::CallbackGroup::SharedPtr group) {
+      EXPECT_TRUE(group->is_cpu_accounting_enabled());
+    });
+#ifndef _WIN32
+  // rcl allocates the node with the allocator of the node options
+  EXPECT_LT(0u, usage.allocations.bytes_allocated);
+#endif
+  exec->remove_node(listener);
 }
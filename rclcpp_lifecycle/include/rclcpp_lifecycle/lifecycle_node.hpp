@@ -194,6 +194,29 @@ public:
     rclcpp::CallbackGroupType group_type,
     bool automatically_add_to_executor_with_node = true);
 
+  /// Create and return a callback group whose entities are only executed while the node is active.
+  /**
+   * The group is disabled, see rclcpp::CallbackGroup::set_enabled(), whenever the node
+   * isn't in the active state, so that executors don't wait on its subscriptions, timers,
+   * services and clients then, and an inactive node costs nothing at runtime.
+   * The messages and requests received in the meantime are kept in their queues, and
+   * executed once the node is activated, within the limits of their depth.
+   *
+   * The lifecycle services of the node are in its default callback group, which is
+   * never disabled.
+   *
+   * \param[in] group_type callback group type to create by this method.
+   * \param[in] automatically_add_to_executor_with_node A boolean that
+   *   determines whether a callback group is automatically added to an executor
+   *   with the node with which it is associated.
+   * \return a callback group
+   */
+  RCLCPP_LIFECYCLE_PUBLIC
+  rclcpp::CallbackGroup::SharedPtr
+  create_managed_callback_group(
+    rclcpp::CallbackGroupType group_type,
+    bool automatically_add_to_executor_with_node = true);
+
   /// Iterate over the callback groups in the node, calling func on each valid one.
   RCLCPP_LIFECYCLE_PUBLIC
   void
@@ -426,6 +449,16 @@ public:
       std::pair<ParameterT, rcl_interfaces::msg::ParameterDescriptor>
     > & parameters);
 
+  /// Declare and initialize several parameters at once, from a table of declarations.
+  /**
+   * \sa rclcpp::Node::declare_parameters_bulk
+   */
+  RCLCPP_LIFECYCLE_PUBLIC
+  std::vector<rclcpp::ParameterValue>
+  declare_parameters_bulk(
+    const rclcpp::node_interfaces::NodeParametersInterface::ParameterDeclarations & parameters,
+    bool ignore_overrides = false);
+
   /// Undeclare a previously declared parameter.
   /**
    * \sa rclcpp::Node::undeclare_parameter
@@ -865,6 +898,23 @@ public:
   std::vector<Transition>
   get_transition_graph() const;
 
+  /// Create the lifecycle services and the transition event publisher of the node.
+  /**
+   * They're created with the node unless enable_communication_interface is false in its
+   * constructor, which makes its construction faster, and this creates them later,
+   * for example once all the nodes of a process are constructed, or only for the nodes
+   * which are managed remotely.
+   * The node keeps its current state.
+   * Nothing is done if they already exist.
+   *
+   * It mustn't be called during a transition.
+   *
+   * \throws std::runtime_error if the state machine couldn't be initialized again.
+   */
+  RCLCPP_LIFECYCLE_PUBLIC
+  void
+  enable_communication_interface();
+
   /// Trigger the specified transition.
   /*
    * \return the new state after this transition
@@ -1047,6 +1097,80 @@ public:
   bool
   register_on_error(std::function<LifecycleNodeInterface::CallbackReturn(const State &)> fcn);
 
+  /// Function an asynchronous transition callback calls once it's done, with its result.
+  using CompleteTransition = std::function<void (LifecycleNodeInterface::CallbackReturn)>;
+  /// Transition callback completing later, maybe from another thread.
+  using AsyncTransitionCallback = std::function<void (const State &, CompleteTransition)>;
+
+  /// Register a configure callback completing asynchronously.
+  /**
+   * Instead of returning its result, the callback is given a function to call once it's done,
+   * which it or any other thread calls at most once, for example after loading a large model.
+   * Meanwhile, the change state service doesn't block the executor, and responds once the
+   * transition is done.
+   * The rest of the transition, including the error processing, is done by the thread
+   * completing the callback, which must complete it before the node is destroyed.
+   * The transition methods of the node, like configure(), wait until the callback completes,
+   * so they mustn't be called by the thread in charge of completing it.
+   *
+   * The callback replaces the configure callback registered before, synchronous or not.
+   * \param[in] fcn callback function to call
+   * \return always true
+   */
+  RCLCPP_LIFECYCLE_PUBLIC
+  bool
+  register_async_on_configure(AsyncTransitionCallback fcn);
+
+  /// Register a cleanup callback completing asynchronously.
+  /**
+   * \sa register_async_on_configure()
+   * \param[in] fcn callback function to call
+   * \return always true
+   */
+  RCLCPP_LIFECYCLE_PUBLIC
+  bool
+  register_async_on_cleanup(AsyncTransitionCallback fcn);
+
+  /// Register a shutdown callback completing asynchronously.
+  /**
+   * \sa register_async_on_configure()
+   * \param[in] fcn callback function to call
+   * \return always true
+   */
+  RCLCPP_LIFECYCLE_PUBLIC
+  bool
+  register_async_on_shutdown(AsyncTransitionCallback fcn);
+
+  /// Register an activate callback completing asynchronously.
+  /**
+   * \sa register_async_on_configure()
+   * \param[in] fcn callback function to call
+   * \return always true
+   */
+  RCLCPP_LIFECYCLE_PUBLIC
+  bool
+  register_async_on_activate(AsyncTransitionCallback fcn);
+
+  /// Register a deactivate callback completing asynchronously.
+  /**
+   * \sa register_async_on_configure()
+   * \param[in] fcn callback function to call
+   * \return always true
+   */
+  RCLCPP_LIFECYCLE_PUBLIC
+  bool
+  register_async_on_deactivate(AsyncTransitionCallback fcn);
+
+  /// Register an error callback completing asynchronously.
+  /**
+   * \sa register_async_on_configure()
+   * \param[in] fcn callback function to call
+   * \return always true
+   */
+  RCLCPP_LIFECYCLE_PUBLIC
+  bool
+  register_async_on_error(AsyncTransitionCallback fcn);
+
   RCLCPP_LIFECYCLE_PUBLIC
   CallbackReturn
   on_activate(const State & previous_state) override;
@@ -17,13 +17,17 @@
 
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
 
+#include "rcutils/macros.h"
+
 #include "rclcpp/logging.hpp"
 #include "rclcpp/node_interfaces/node_base_interface.hpp"
 #include "rclcpp/publisher.hpp"
 #include "rclcpp/publisher_options.hpp"
 #include "rclcpp/qos.hpp"
+#include "rclcpp/type_adapter.hpp"
 
 #include "rclcpp_lifecycle/managed_entity.hpp"
 
@@ -46,6 +50,12 @@ public:
   using MessageDeleter = rclcpp::allocator::Deleter<MessageAlloc, MessageT>;
   using MessageUniquePtr = std::unique_ptr<MessageT, MessageDeleter>;
 
+  using PublishedType = typename rclcpp::Publisher<MessageT, Alloc>::PublishedType;
+  using PublishedTypeDeleter = typename rclcpp::Publisher<MessageT, Alloc>::PublishedTypeDeleter;
+  using ROSMessageType = typename rclcpp::Publisher<MessageT, Alloc>::ROSMessageType;
+  using ROSMessageTypeDeleter =
+    typename rclcpp::Publisher<MessageT, Alloc>::ROSMessageTypeDeleter;
+
   LifecyclePublisher(
     rclcpp::node_interfaces::NodeBaseInterface * node_base,
     const std::string & topic,
@@ -66,9 +76,9 @@ public:
    * to the actual rclcpp Publisher base class
    */
   virtual void
-  publish(std::unique_ptr<MessageT, MessageDeleter> msg)
+  publish(std::unique_ptr<ROSMessageType, ROSMessageTypeDeleter> msg)
   {
-    if (!this->is_activated()) {
+    if (RCUTILS_UNLIKELY(!this->is_activated())) {
       log_publisher_not_enabled();
       return;
     }
@@ -82,9 +92,47 @@ public:
    * to the actual rclcpp Publisher base class
    */
   virtual void
-  publish(const MessageT & msg)
+  publish(const ROSMessageType & msg)
+  {
+    if (RCUTILS_UNLIKELY(!this->is_activated())) {
+      log_publisher_not_enabled();
+      return;
+    }
+    rclcpp::Publisher<MessageT, Alloc>::publish(msg);
+  }
+
+  /// LifecyclePublisher publish function for the custom type of a TypeAdapter
+  /**
+   * The message is only converted to its ROS message type if the publisher is activated,
+   * it's dropped right away otherwise.
+   */
+  template<typename T>
+  typename std::enable_if_t<
+    rclcpp::TypeAdapter<MessageT>::is_specialized::value &&
+    std::is_same<T, PublishedType>::value
+  >
+  publish(std::unique_ptr<T, PublishedTypeDeleter> msg)
+  {
+    if (RCUTILS_UNLIKELY(!this->is_activated())) {
+      log_publisher_not_enabled();
+      return;
+    }
+    rclcpp::Publisher<MessageT, Alloc>::publish(std::move(msg));
+  }
+
+  /// LifecyclePublisher publish function for the custom type of a TypeAdapter
+  /**
+   * The message is only copied or converted to its ROS message type if the publisher
+   * is activated, it's dropped right away otherwise.
+   */
+  template<typename T>
+  typename std::enable_if_t<
+    rclcpp::TypeAdapter<MessageT>::is_specialized::value &&
+    std::is_same<T, PublishedType>::value
+  >
+  publish(const T & msg)
   {
-    if (!this->is_activated()) {
+    if (RCUTILS_UNLIKELY(!this->is_activated())) {
       log_publisher_not_enabled();
       return;
     }
@@ -56,9 +56,16 @@ public:
   void
   on_deactivate() override;
 
-  RCLCPP_LIFECYCLE_PUBLIC
+  /// Return true if the entity is activated.
+  /**
+   * It's read on every use of the entity, like the publications of a LifecyclePublisher,
+   * so it's inlined and only requires the atomicity of the flag, not its ordering.
+   */
   bool
-  is_activated() const;
+  is_activated() const
+  {
+    return activated_.load(std::memory_order_relaxed);
+  }
 
 private:
   std::atomic<bool> activated_ = false;
@@ -0,0 +1,73 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP_LIFECYCLE__TRIGGER_TRANSITIONS_HPP_
+#define RCLCPP_LIFECYCLE__TRIGGER_TRANSITIONS_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "rclcpp_lifecycle/lifecycle_node.hpp"
+#include "rclcpp_lifecycle/node_interfaces/lifecycle_node_interface.hpp"
+#include "rclcpp_lifecycle/state.hpp"
+#include "rclcpp_lifecycle/visibility_control.h"
+
+namespace rclcpp_lifecycle
+{
+
+/// Result of the transition of one of the nodes given to trigger_transitions().
+struct TransitionResult
+{
+  /// Fully qualified name of the node.
+  std::string node_name;
+  /// State of the node after the transition.
+  State state;
+  /// Return code of the transition callback, ERROR if the transition couldn't be started.
+  node_interfaces::LifecycleNodeInterface::CallbackReturn callback_return_code;
+  /// True if the transition callback succeeded.
+  bool success = false;
+  /// Message of the exception thrown by the transition, if any.
+  std::string error_message;
+};
+
+/// Trigger the same transition of several nodes concurrently.
+/**
+ * Each node is transitioned by one of the worker threads, as with trigger_transition(),
+ * so that the transition callbacks of different nodes run in parallel, while those of a node
+ * are still serialized by its state machine.
+ * The failure of a node doesn't stop the transitions of the others.
+ *
+ * \param[in] nodes the nodes to transition, which can't be null.
+ * \param[in] transition_id id of the transition, as in lifecycle_msgs::msg::Transition.
+ * \param[in] number_of_threads maximum number of worker threads, 0 to use as many as
+ *   hardware threads; the calling thread is used if there is only one.
+ * \return the results of the transitions, in the order of the nodes.
+ * \throws std::invalid_argument if a node is null.
+ */
+RCLCPP_LIFECYCLE_PUBLIC
+std::vector<TransitionResult>
+trigger_transitions(
+  const std::vector<LifecycleNode::SharedPtr> & nodes,
+  uint8_t transition_id,
+  size_t number_of_threads = 0);
+
+/// Return true if all the transitions succeeded.
+RCLCPP_LIFECYCLE_PUBLIC
+bool
+all_succeeded(const std::vector<TransitionResult> & results);
+
+}  // namespace rclcpp_lifecycle
+
+#endif  // RCLCPP_LIFECYCLE__TRIGGER_TRANSITIONS_HPP_
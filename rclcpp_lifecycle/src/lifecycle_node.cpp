@@ -75,7 +75,8 @@ LifecycleNode::LifecycleNode(
       *(options.get_rcl_node_options()),
       options.use_intra_process_comms(),
       options.enable_topic_statistics())),
-  node_graph_(new rclcpp::node_interfaces::NodeGraph(node_base_.get())),
+  node_graph_(
+    new rclcpp::node_interfaces::NodeGraph(node_base_.get(), options.cache_graph_queries())),
   node_logging_(new rclcpp::node_interfaces::NodeLogging(node_base_.get())),
   node_timers_(new rclcpp::node_interfaces::NodeTimers(node_base_.get())),
   node_topics_(new rclcpp::node_interfaces::NodeTopics(node_base_.get(), node_timers_.get())),
@@ -179,6 +180,17 @@ LifecycleNode::create_callback_group(
   return node_base_->create_callback_group(group_type, automatically_add_to_executor_with_node);
 }
 
+rclcpp::CallbackGroup::SharedPtr
+LifecycleNode::create_managed_callback_group(
+  rclcpp::CallbackGroupType group_type,
+  bool automatically_add_to_executor_with_node)
+{
+  auto group =
+    node_base_->create_callback_group(group_type, automatically_add_to_executor_with_node);
+  impl_->add_managed_callback_group(group);
+  return group;
+}
+
 const rclcpp::ParameterValue &
 LifecycleNode::declare_parameter(
   const std::string & name,
@@ -204,6 +216,14 @@ LifecycleNode::declare_parameter(
     ignore_override);
 }
 
+std::vector<rclcpp::ParameterValue>
+LifecycleNode::declare_parameters_bulk(
+  const rclcpp::node_interfaces::NodeParametersInterface::ParameterDeclarations & parameters,
+  bool ignore_overrides)
+{
+  return this->node_parameters_->declare_parameters_bulk(parameters, ignore_overrides);
+}
+
 void
 LifecycleNode::undeclare_parameter(const std::string & name)
 {
@@ -535,6 +555,48 @@ LifecycleNode::register_on_error(
     lifecycle_msgs::msg::State::TRANSITION_STATE_ERRORPROCESSING, fcn);
 }
 
+bool
+LifecycleNode::register_async_on_configure(AsyncTransitionCallback fcn)
+{
+  return impl_->register_async_callback(
+    lifecycle_msgs::msg::State::TRANSITION_STATE_CONFIGURING, std::move(fcn));
+}
+
+bool
+LifecycleNode::register_async_on_cleanup(AsyncTransitionCallback fcn)
+{
+  return impl_->register_async_callback(
+    lifecycle_msgs::msg::State::TRANSITION_STATE_CLEANINGUP, std::move(fcn));
+}
+
+bool
+LifecycleNode::register_async_on_shutdown(AsyncTransitionCallback fcn)
+{
+  return impl_->register_async_callback(
+    lifecycle_msgs::msg::State::TRANSITION_STATE_SHUTTINGDOWN, std::move(fcn));
+}
+
+bool
+LifecycleNode::register_async_on_activate(AsyncTransitionCallback fcn)
+{
+  return impl_->register_async_callback(
+    lifecycle_msgs::msg::State::TRANSITION_STATE_ACTIVATING, std::move(fcn));
+}
+
+bool
+LifecycleNode::register_async_on_deactivate(AsyncTransitionCallback fcn)
+{
+  return impl_->register_async_callback(
+    lifecycle_msgs::msg::State::TRANSITION_STATE_DEACTIVATING, std::move(fcn));
+}
+
+bool
+LifecycleNode::register_async_on_error(AsyncTransitionCallback fcn)
+{
+  return impl_->register_async_callback(
+    lifecycle_msgs::msg::State::TRANSITION_STATE_ERRORPROCESSING, std::move(fcn));
+}
+
 const State &
 LifecycleNode::get_current_state() const
 {
@@ -559,6 +621,12 @@ LifecycleNode::get_transition_graph() const
   return impl_->get_transition_graph();
 }
 
+void
+LifecycleNode::enable_communication_interface()
+{
+  impl_->enable_communication_interface();
+}
+
 const State &
 LifecycleNode::trigger_transition(const Transition & transition)
 {
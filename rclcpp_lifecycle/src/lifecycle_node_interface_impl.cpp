@@ -12,7 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
 #include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <stdexcept>
@@ -20,6 +22,7 @@
 #include <utility>
 #include <vector>
 
+#include "lifecycle_msgs/msg/state.hpp"
 #include "lifecycle_msgs/msg/transition_description.hpp"
 #include "lifecycle_msgs/msg/transition_event.h"  // for getting the c-typesupport
 #include "lifecycle_msgs/msg/transition_event.hpp"
@@ -48,6 +51,23 @@
 namespace rclcpp_lifecycle
 {
 
+namespace
+{
+
+const char *
+get_label_for_return_code(node_interfaces::LifecycleNodeInterface::CallbackReturn cb_return_code)
+{
+  auto cb_id = static_cast<uint8_t>(cb_return_code);
+  if (cb_id == lifecycle_msgs::msg::Transition::TRANSITION_CALLBACK_SUCCESS) {
+    return rcl_lifecycle_transition_success_label;
+  } else if (cb_id == lifecycle_msgs::msg::Transition::TRANSITION_CALLBACK_FAILURE) {
+    return rcl_lifecycle_transition_failure_label;
+  }
+  return rcl_lifecycle_transition_error_label;
+}
+
+}  // namespace
+
 LifecycleNode::LifecycleNodeInterfaceImpl::LifecycleNodeInterfaceImpl(
   std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> node_base_interface,
   std::shared_ptr<rclcpp::node_interfaces::NodeServicesInterface> node_services_interface)
@@ -73,6 +93,45 @@ LifecycleNode::LifecycleNodeInterfaceImpl::~LifecycleNodeInterfaceImpl()
 
 void
 LifecycleNode::LifecycleNodeInterfaceImpl::init(bool enable_communication_interface)
+{
+  std::lock_guard<std::recursive_mutex> lock(state_machine_mutex_);
+  init_state_machine(enable_communication_interface);
+  current_state_ = State(state_machine_.current_state);
+  if (enable_communication_interface) {
+    create_services();
+  }
+}
+
+void
+LifecycleNode::LifecycleNodeInterfaceImpl::enable_communication_interface()
+{
+  std::lock_guard<std::recursive_mutex> lock(state_machine_mutex_);
+  if (communication_interface_enabled_) {
+    return;
+  }
+  // rcl_lifecycle only creates the communication interface with the state machine,
+  // which is initialized again and then put back in its current state.
+  const auto current_state_id = state_machine_.current_state->id;
+  rcl_ret_t ret = rcl_lifecycle_state_machine_fini(
+    &state_machine_, node_base_interface_->get_rcl_node_handle());
+  if (ret != RCL_RET_OK) {
+    throw std::runtime_error(
+            std::string("Couldn't finalize state machine for node ") +
+            node_base_interface_->get_name());
+  }
+  init_state_machine(true);
+  const rcl_lifecycle_state_t * state =
+    rcl_lifecycle_get_state(&state_machine_.transition_map, current_state_id);
+  if (state) {
+    state_machine_.current_state = state;
+  }
+  current_state_ = State(state_machine_.current_state);
+  create_services();
+}
+
+void
+LifecycleNode::LifecycleNodeInterfaceImpl::init_state_machine(
+  bool enable_communication_interface)
 {
   rcl_node_t * node_handle = node_base_interface_->get_rcl_node_handle();
   const rcl_node_options_t * node_options =
@@ -87,7 +146,6 @@ LifecycleNode::LifecycleNodeInterfaceImpl::init(bool enable_communication_interf
   // The publisher takes a C-Typesupport since the publishing (i.e. creating
   // the message) is done fully in RCL.
   // Services are handled in C++, so that it needs a C++ typesupport structure.
-  std::lock_guard<std::recursive_mutex> lock(state_machine_mutex_);
   state_machine_ = rcl_lifecycle_get_zero_initialized_state_machine();
   rcl_ret_t ret = rcl_lifecycle_state_machine_init(
     &state_machine_,
@@ -104,91 +162,96 @@ LifecycleNode::LifecycleNodeInterfaceImpl::init(bool enable_communication_interf
             std::string("Couldn't initialize state machine for node ") +
             node_base_interface_->get_name());
   }
+  communication_interface_enabled_ = enable_communication_interface;
+}
 
-  current_state_ = State(state_machine_.current_state);
-
-  if (enable_communication_interface) {
-    { // change_state
-      auto cb = std::bind(
-        &LifecycleNode::LifecycleNodeInterfaceImpl::on_change_state, this,
-        std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
-      rclcpp::AnyServiceCallback<ChangeStateSrv> any_cb;
-      any_cb.set(std::move(cb));
-
-      srv_change_state_ = std::make_shared<rclcpp::Service<ChangeStateSrv>>(
-        node_base_interface_->get_shared_rcl_node_handle(),
-        &state_machine_.com_interface.srv_change_state,
-        any_cb);
-      node_services_interface_->add_service(
-        std::dynamic_pointer_cast<rclcpp::ServiceBase>(srv_change_state_),
-        nullptr);
-    }
+void
+LifecycleNode::LifecycleNodeInterfaceImpl::create_services()
+{
+  { // change_state
+    // The response is deferred until the transition is done
+    auto cb = [this](
+      const std::shared_ptr<rmw_request_id_t> header,
+      const std::shared_ptr<ChangeStateSrv::Request> req)
+      {
+        on_change_state(header, req);
+      };
+    rclcpp::AnyServiceCallback<ChangeStateSrv> any_cb;
+    any_cb.set(std::move(cb));
+
+    srv_change_state_ = std::make_shared<rclcpp::Service<ChangeStateSrv>>(
+      node_base_interface_->get_shared_rcl_node_handle(),
+      &state_machine_.com_interface.srv_change_state,
+      any_cb);
+    node_services_interface_->add_service(
+      std::dynamic_pointer_cast<rclcpp::ServiceBase>(srv_change_state_),
+      nullptr);
+  }
 
-    { // get_state
-      auto cb = std::bind(
-        &LifecycleNode::LifecycleNodeInterfaceImpl::on_get_state, this,
-        std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
-      rclcpp::AnyServiceCallback<GetStateSrv> any_cb;
-      any_cb.set(std::move(cb));
-
-      srv_get_state_ = std::make_shared<rclcpp::Service<GetStateSrv>>(
-        node_base_interface_->get_shared_rcl_node_handle(),
-        &state_machine_.com_interface.srv_get_state,
-        any_cb);
-      node_services_interface_->add_service(
-        std::dynamic_pointer_cast<rclcpp::ServiceBase>(srv_get_state_),
-        nullptr);
-    }
+  { // get_state
+    auto cb = std::bind(
+      &LifecycleNode::LifecycleNodeInterfaceImpl::on_get_state, this,
+      std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
+    rclcpp::AnyServiceCallback<GetStateSrv> any_cb;
+    any_cb.set(std::move(cb));
+
+    srv_get_state_ = std::make_shared<rclcpp::Service<GetStateSrv>>(
+      node_base_interface_->get_shared_rcl_node_handle(),
+      &state_machine_.com_interface.srv_get_state,
+      any_cb);
+    node_services_interface_->add_service(
+      std::dynamic_pointer_cast<rclcpp::ServiceBase>(srv_get_state_),
+      nullptr);
+  }
 
-    { // get_available_states
-      auto cb = std::bind(
-        &LifecycleNode::LifecycleNodeInterfaceImpl::on_get_available_states, this,
-        std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
-      rclcpp::AnyServiceCallback<GetAvailableStatesSrv> any_cb;
-      any_cb.set(std::move(cb));
-
-      srv_get_available_states_ = std::make_shared<rclcpp::Service<GetAvailableStatesSrv>>(
-        node_base_interface_->get_shared_rcl_node_handle(),
-        &state_machine_.com_interface.srv_get_available_states,
-        any_cb);
-      node_services_interface_->add_service(
-        std::dynamic_pointer_cast<rclcpp::ServiceBase>(srv_get_available_states_),
-        nullptr);
-    }
+  { // get_available_states
+    auto cb = std::bind(
+      &LifecycleNode::LifecycleNodeInterfaceImpl::on_get_available_states, this,
+      std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
+    rclcpp::AnyServiceCallback<GetAvailableStatesSrv> any_cb;
+    any_cb.set(std::move(cb));
+
+    srv_get_available_states_ = std::make_shared<rclcpp::Service<GetAvailableStatesSrv>>(
+      node_base_interface_->get_shared_rcl_node_handle(),
+      &state_machine_.com_interface.srv_get_available_states,
+      any_cb);
+    node_services_interface_->add_service(
+      std::dynamic_pointer_cast<rclcpp::ServiceBase>(srv_get_available_states_),
+      nullptr);
+  }
 
-    { // get_available_transitions
-      auto cb = std::bind(
-        &LifecycleNode::LifecycleNodeInterfaceImpl::on_get_available_transitions, this,
-        std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
-      rclcpp::AnyServiceCallback<GetAvailableTransitionsSrv> any_cb;
-      any_cb.set(std::move(cb));
-
-      srv_get_available_transitions_ =
-        std::make_shared<rclcpp::Service<GetAvailableTransitionsSrv>>(
-        node_base_interface_->get_shared_rcl_node_handle(),
-        &state_machine_.com_interface.srv_get_available_transitions,
-        any_cb);
-      node_services_interface_->add_service(
-        std::dynamic_pointer_cast<rclcpp::ServiceBase>(srv_get_available_transitions_),
-        nullptr);
-    }
+  { // get_available_transitions
+    auto cb = std::bind(
+      &LifecycleNode::LifecycleNodeInterfaceImpl::on_get_available_transitions, this,
+      std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
+    rclcpp::AnyServiceCallback<GetAvailableTransitionsSrv> any_cb;
+    any_cb.set(std::move(cb));
+
+    srv_get_available_transitions_ =
+      std::make_shared<rclcpp::Service<GetAvailableTransitionsSrv>>(
+      node_base_interface_->get_shared_rcl_node_handle(),
+      &state_machine_.com_interface.srv_get_available_transitions,
+      any_cb);
+    node_services_interface_->add_service(
+      std::dynamic_pointer_cast<rclcpp::ServiceBase>(srv_get_available_transitions_),
+      nullptr);
+  }
 
-    { // get_transition_graph
-      auto cb = std::bind(
-        &LifecycleNode::LifecycleNodeInterfaceImpl::on_get_transition_graph, this,
-        std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
-      rclcpp::AnyServiceCallback<GetAvailableTransitionsSrv> any_cb;
-      any_cb.set(std::move(cb));
-
-      srv_get_transition_graph_ =
-        std::make_shared<rclcpp::Service<GetAvailableTransitionsSrv>>(
-        node_base_interface_->get_shared_rcl_node_handle(),
-        &state_machine_.com_interface.srv_get_transition_graph,
-        any_cb);
-      node_services_interface_->add_service(
-        std::dynamic_pointer_cast<rclcpp::ServiceBase>(srv_get_transition_graph_),
-        nullptr);
-    }
+  { // get_transition_graph
+    auto cb = std::bind(
+      &LifecycleNode::LifecycleNodeInterfaceImpl::on_get_transition_graph, this,
+      std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
+    rclcpp::AnyServiceCallback<GetAvailableTransitionsSrv> any_cb;
+    any_cb.set(std::move(cb));
+
+    srv_get_transition_graph_ =
+      std::make_shared<rclcpp::Service<GetAvailableTransitionsSrv>>(
+      node_base_interface_->get_shared_rcl_node_handle(),
+      &state_machine_.com_interface.srv_get_transition_graph,
+      any_cb);
+    node_services_interface_->add_service(
+      std::dynamic_pointer_cast<rclcpp::ServiceBase>(srv_get_transition_graph_),
+      nullptr);
   }
 }
 
@@ -197,17 +260,27 @@ LifecycleNode::LifecycleNodeInterfaceImpl::register_callback(
   std::uint8_t lifecycle_transition,
   std::function<node_interfaces::LifecycleNodeInterface::CallbackReturn(const State &)> & cb)
 {
+  // The callback registered last replaces the other ones of the transition
+  async_cb_map_.erase(lifecycle_transition);
   cb_map_[lifecycle_transition] = cb;
   return true;
 }
 
+bool
+LifecycleNode::LifecycleNodeInterfaceImpl::register_async_callback(
+  std::uint8_t lifecycle_transition,
+  LifecycleNode::AsyncTransitionCallback cb)
+{
+  cb_map_.erase(lifecycle_transition);
+  async_cb_map_[lifecycle_transition] = std::move(cb);
+  return true;
+}
+
 void
 LifecycleNode::LifecycleNodeInterfaceImpl::on_change_state(
   const std::shared_ptr<rmw_request_id_t> header,
-  const std::shared_ptr<ChangeStateSrv::Request> req,
-  std::shared_ptr<ChangeStateSrv::Response> resp)
+  const std::shared_ptr<ChangeStateSrv::Request> req)
 {
-  (void)header;
   std::uint8_t transition_id;
   {
     std::lock_guard<std::recursive_mutex> lock(state_machine_mutex_);
@@ -228,21 +301,27 @@ LifecycleNode::LifecycleNodeInterfaceImpl::on_change_state(
       auto rcl_transition = rcl_lifecycle_get_transition_by_label(
         state_machine_.current_state, req->transition.label.c_str());
       if (rcl_transition == nullptr) {
-        resp->success = false;
+        ChangeStateSrv::Response resp;
+        resp.success = false;
+        srv_change_state_->send_response(*header, resp);
         return;
       }
       transition_id = static_cast<std::uint8_t>(rcl_transition->id);
     }
   }
 
-  node_interfaces::LifecycleNodeInterface::CallbackReturn cb_return_code;
-  auto ret = change_state(transition_id, cb_return_code);
-  (void) ret;
-  // TODO(karsten1987): Lifecycle msgs have to be extended to keep both returns
-  // 1. return is the actual transition
-  // 2. return is whether an error occurred or not
-  resp->success =
-    (cb_return_code == node_interfaces::LifecycleNodeInterface::CallbackReturn::SUCCESS);
+  // The response is sent once the transition is done, maybe by another thread
+  change_state_async(
+    transition_id,
+    [this, header](rcl_ret_t ret, node_interfaces::LifecycleNodeInterface::CallbackReturn code) {
+      (void) ret;
+      // TODO(karsten1987): Lifecycle msgs have to be extended to keep both returns
+      // 1. return is the actual transition
+      // 2. return is whether an error occurred or not
+      ChangeStateSrv::Response resp;
+      resp.success = (code == node_interfaces::LifecycleNodeInterface::CallbackReturn::SUCCESS);
+      srv_change_state_->send_response(*header, resp);
+    });
 }
 
 void
@@ -390,6 +469,25 @@ rcl_ret_t
 LifecycleNode::LifecycleNodeInterfaceImpl::change_state(
   std::uint8_t transition_id,
   node_interfaces::LifecycleNodeInterface::CallbackReturn & cb_return_code)
+{
+  // The asynchronous callbacks are waited for, so they must complete from another thread
+  auto result = std::make_shared<std::promise<
+        std::pair<rcl_ret_t, node_interfaces::LifecycleNodeInterface::CallbackReturn>>>();
+  auto future = result->get_future();
+  change_state_async(
+    transition_id,
+    [result](rcl_ret_t ret, node_interfaces::LifecycleNodeInterface::CallbackReturn code) {
+      result->set_value(std::make_pair(ret, code));
+    });
+  auto ret_and_code = future.get();
+  cb_return_code = ret_and_code.second;
+  return ret_and_code.first;
+}
+
+void
+LifecycleNode::LifecycleNodeInterfaceImpl::change_state_async(
+  std::uint8_t transition_id,
+  ChangeStateCallback on_done)
 {
   constexpr bool publish_update = true;
   State initial_state;
@@ -401,7 +499,8 @@ LifecycleNode::LifecycleNodeInterfaceImpl::change_state(
       RCUTILS_LOG_ERROR(
         "Unable to change state for state machine for %s: %s",
         node_base_interface_->get_name(), rcl_get_error_string().str);
-      return RCL_RET_ERROR;
+      on_done(RCL_RET_ERROR, node_interfaces::LifecycleNodeInterface::CallbackReturn::ERROR);
+      return;
     }
 
     // keep the initial state to pass to a transition callback
@@ -415,7 +514,8 @@ LifecycleNode::LifecycleNodeInterfaceImpl::change_state(
         "Unable to start transition %u from current state %s: %s",
         transition_id, state_machine_.current_state->label, rcl_get_error_string().str);
       rcutils_reset_error();
-      return RCL_RET_ERROR;
+      on_done(RCL_RET_ERROR, node_interfaces::LifecycleNodeInterface::CallbackReturn::ERROR);
+      return;
     }
     current_state_id = state_machine_.current_state->id;
   }
@@ -423,19 +523,25 @@ LifecycleNode::LifecycleNodeInterfaceImpl::change_state(
   // Update the internal current_state_
   current_state_ = State(state_machine_.current_state);
 
-  auto get_label_for_return_code =
-    [](node_interfaces::LifecycleNodeInterface::CallbackReturn cb_return_code) -> const char *{
-      auto cb_id = static_cast<uint8_t>(cb_return_code);
-      if (cb_id == lifecycle_msgs::msg::Transition::TRANSITION_CALLBACK_SUCCESS) {
-        return rcl_lifecycle_transition_success_label;
-      } else if (cb_id == lifecycle_msgs::msg::Transition::TRANSITION_CALLBACK_FAILURE) {
-        return rcl_lifecycle_transition_failure_label;
-      }
-      return rcl_lifecycle_transition_error_label;
-    };
+  execute_callback_async(
+    current_state_id, initial_state,
+    [this, transition_id, initial_state, on_done](
+      node_interfaces::LifecycleNodeInterface::CallbackReturn cb_return_code)
+    {
+      finish_transition(transition_id, initial_state, cb_return_code, on_done);
+    });
+}
 
-  cb_return_code = execute_callback(current_state_id, initial_state);
+void
+LifecycleNode::LifecycleNodeInterfaceImpl::finish_transition(
+  std::uint8_t transition_id,
+  const State & initial_state,
+  node_interfaces::LifecycleNodeInterface::CallbackReturn cb_return_code,
+  ChangeStateCallback on_done)
+{
+  constexpr bool publish_update = true;
   auto transition_label = get_label_for_return_code(cb_return_code);
+  unsigned int current_state_id;
 
   {
     std::lock_guard<std::recursive_mutex> lock(state_machine_mutex_);
@@ -447,7 +553,9 @@ LifecycleNode::LifecycleNodeInterfaceImpl::change_state(
         "Failed to finish transition %u. Current state is now: %s (%s)",
         transition_id, state_machine_.current_state->label, rcl_get_error_string().str);
       rcutils_reset_error();
-      return RCL_RET_ERROR;
+      update_managed_callback_groups();
+      on_done(RCL_RET_ERROR, cb_return_code);
+      return;
     }
     current_state_id = state_machine_.current_state->id;
   }
@@ -460,8 +568,32 @@ LifecycleNode::LifecycleNodeInterfaceImpl::change_state(
   if (cb_return_code == node_interfaces::LifecycleNodeInterface::CallbackReturn::ERROR) {
     RCUTILS_LOG_WARN("Error occurred while doing error handling.");
 
-    auto error_cb_code = execute_callback(current_state_id, initial_state);
-    auto error_cb_label = get_label_for_return_code(error_cb_code);
+    execute_callback_async(
+      current_state_id, initial_state,
+      [this, cb_return_code, on_done](
+        node_interfaces::LifecycleNodeInterface::CallbackReturn error_cb_code)
+      {
+        finish_error_processing(cb_return_code, error_cb_code, on_done);
+      });
+    return;
+  }
+
+  update_managed_callback_groups();
+  // This true holds in both cases where the actual callback
+  // was successful or not, since at this point we have a valid transistion
+  // to either a new primary state or error state
+  on_done(RCL_RET_OK, cb_return_code);
+}
+
+void
+LifecycleNode::LifecycleNodeInterfaceImpl::finish_error_processing(
+  node_interfaces::LifecycleNodeInterface::CallbackReturn cb_return_code,
+  node_interfaces::LifecycleNodeInterface::CallbackReturn error_cb_code,
+  ChangeStateCallback on_done)
+{
+  constexpr bool publish_update = true;
+  auto error_cb_label = get_label_for_return_code(error_cb_code);
+  {
     std::lock_guard<std::recursive_mutex> lock(state_machine_mutex_);
     if (
       rcl_lifecycle_trigger_transition_by_label(
@@ -469,17 +601,16 @@ LifecycleNode::LifecycleNodeInterfaceImpl::change_state(
     {
       RCUTILS_LOG_ERROR("Failed to call cleanup on error state: %s", rcl_get_error_string().str);
       rcutils_reset_error();
-      return RCL_RET_ERROR;
+      update_managed_callback_groups();
+      on_done(RCL_RET_ERROR, cb_return_code);
+      return;
     }
   }
 
   // Update the internal current_state_
   current_state_ = State(state_machine_.current_state);
-
-  // This true holds in both cases where the actual callback
-  // was successful or not, since at this point we have a valid transistion
-  // to either a new primary state or error state
-  return RCL_RET_OK;
+  update_managed_callback_groups();
+  on_done(RCL_RET_OK, cb_return_code);
 }
 
 node_interfaces::LifecycleNodeInterface::CallbackReturn
@@ -503,6 +634,37 @@ LifecycleNode::LifecycleNodeInterfaceImpl::execute_callback(
   return cb_success;
 }
 
+void
+LifecycleNode::LifecycleNodeInterfaceImpl::execute_callback_async(
+  unsigned int cb_id,
+  const State & previous_state,
+  std::function<void(node_interfaces::LifecycleNodeInterface::CallbackReturn)> on_done) const
+{
+  auto it = async_cb_map_.find(static_cast<uint8_t>(cb_id));
+  if (it == async_cb_map_.end()) {
+    on_done(execute_callback(cb_id, previous_state));
+    return;
+  }
+
+  // Only the first completion counts, the callback may still throw after completing
+  auto completed = std::make_shared<std::atomic<bool>>(false);
+  LifecycleNode::CompleteTransition complete =
+    [completed, on_done](node_interfaces::LifecycleNodeInterface::CallbackReturn cb_return_code)
+    {
+      if (!completed->exchange(true)) {
+        on_done(cb_return_code);
+      }
+    };
+  auto callback = it->second;
+  try {
+    callback(State(previous_state), complete);
+  } catch (const std::exception & e) {
+    RCUTILS_LOG_ERROR("Caught exception in callback for transition %d", it->first);
+    RCUTILS_LOG_ERROR("Original error: %s", e.what());
+    complete(node_interfaces::LifecycleNodeInterface::CallbackReturn::ERROR);
+  }
+}
+
 const State & LifecycleNode::LifecycleNodeInterfaceImpl::trigger_transition(
   const char * transition_label)
 {
@@ -559,6 +721,42 @@ LifecycleNode::LifecycleNodeInterfaceImpl::add_timer_handle(
   weak_timers_.push_back(timer);
 }
 
+void
+LifecycleNode::LifecycleNodeInterfaceImpl::add_managed_callback_group(
+  rclcpp::CallbackGroup::SharedPtr group)
+{
+  {
+    std::lock_guard<std::recursive_mutex> lock(state_machine_mutex_);
+    weak_managed_callback_groups_.push_back(group);
+  }
+  update_managed_callback_groups();
+}
+
+void
+LifecycleNode::LifecycleNodeInterfaceImpl::update_managed_callback_groups()
+{
+  bool changed = false;
+  {
+    std::lock_guard<std::recursive_mutex> lock(state_machine_mutex_);
+    const bool active = state_machine_.current_state &&
+      state_machine_.current_state->id == lifecycle_msgs::msg::State::PRIMARY_STATE_ACTIVE;
+    auto it = weak_managed_callback_groups_.begin();
+    while (it != weak_managed_callback_groups_.end()) {
+      auto group = it->lock();
+      if (!group) {
+        it = weak_managed_callback_groups_.erase(it);
+        continue;
+      }
+      changed |= group->set_enabled(active);
+      ++it;
+    }
+  }
+  // The static executors only wait on the notify guard condition of the node.
+  if (changed) {
+    node_base_interface_->get_notify_guard_condition().trigger();
+  }
+}
+
 void
 LifecycleNode::LifecycleNodeInterfaceImpl::on_activate() const
 {
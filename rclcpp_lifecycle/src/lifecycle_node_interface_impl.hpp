@@ -30,6 +30,7 @@
 
 #include "rcl_lifecycle/rcl_lifecycle.h"
 
+#include "rclcpp/callback_group.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/node_interfaces/node_base_interface.hpp"
 #include "rclcpp/node_interfaces/node_services_interface.hpp"
@@ -59,11 +60,19 @@ public:
   void
   init(bool enable_communication_interface = true);
 
+  void
+  enable_communication_interface();
+
   bool
   register_callback(
     std::uint8_t lifecycle_transition,
     std::function<node_interfaces::LifecycleNodeInterface::CallbackReturn(const State &)> & cb);
 
+  bool
+  register_async_callback(
+    std::uint8_t lifecycle_transition,
+    LifecycleNode::AsyncTransitionCallback cb);
+
   const State &
   get_current_state() const;
 
@@ -102,14 +111,20 @@ public:
   void
   add_timer_handle(std::shared_ptr<rclcpp::TimerBase> timer);
 
+  void
+  add_managed_callback_group(rclcpp::CallbackGroup::SharedPtr group);
+
 private:
   RCLCPP_DISABLE_COPY(LifecycleNodeInterfaceImpl)
 
+  // Called with the result of a transition, once its callbacks completed.
+  using ChangeStateCallback = std::function<
+    void (rcl_ret_t, node_interfaces::LifecycleNodeInterface::CallbackReturn)>;
+
   void
   on_change_state(
     const std::shared_ptr<rmw_request_id_t> header,
-    const std::shared_ptr<ChangeStateSrv::Request> req,
-    std::shared_ptr<ChangeStateSrv::Response> resp);
+    const std::shared_ptr<ChangeStateSrv::Request> req);
 
   void
   on_get_state(
@@ -135,20 +150,58 @@ private:
     const std::shared_ptr<GetAvailableTransitionsSrv::Request> req,
     std::shared_ptr<GetAvailableTransitionsSrv::Response> resp) const;
 
+  void
+  init_state_machine(bool enable_communication_interface);
+
+  void
+  create_services();
+
+  // Waits for the callbacks of the transition, even if they complete asynchronously.
   rcl_ret_t
   change_state(
     std::uint8_t transition_id,
     node_interfaces::LifecycleNodeInterface::CallbackReturn & cb_return_code);
 
+  // Starts the transition, the rest is done by the thread completing its callback.
+  void
+  change_state_async(std::uint8_t transition_id, ChangeStateCallback on_done);
+
+  void
+  finish_transition(
+    std::uint8_t transition_id,
+    const State & initial_state,
+    node_interfaces::LifecycleNodeInterface::CallbackReturn cb_return_code,
+    ChangeStateCallback on_done);
+
+  void
+  finish_error_processing(
+    node_interfaces::LifecycleNodeInterface::CallbackReturn cb_return_code,
+    node_interfaces::LifecycleNodeInterface::CallbackReturn error_cb_code,
+    ChangeStateCallback on_done);
+
   node_interfaces::LifecycleNodeInterface::CallbackReturn
   execute_callback(unsigned int cb_id, const State & previous_state) const;
 
+  // Calls on_done once the callback completed, right away if it isn't asynchronous.
+  void
+  execute_callback_async(
+    unsigned int cb_id,
+    const State & previous_state,
+    std::function<void(node_interfaces::LifecycleNodeInterface::CallbackReturn)> on_done) const;
+
+  // Enable the managed callback groups if the node is active, disable them otherwise.
+  void
+  update_managed_callback_groups();
+
   mutable std::recursive_mutex state_machine_mutex_;
   rcl_lifecycle_state_machine_t state_machine_;
+  bool communication_interface_enabled_ = false;
   State current_state_;
   std::map<
     std::uint8_t,
     std::function<node_interfaces::LifecycleNodeInterface::CallbackReturn(const State &)>> cb_map_;
+  // Asynchronous callbacks, a transition has either one here or one in cb_map_
+  std::map<std::uint8_t, LifecycleNode::AsyncTransitionCallback> async_cb_map_;
 
   using NodeBasePtr = std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface>;
   using NodeServicesPtr = std::shared_ptr<rclcpp::node_interfaces::NodeServicesInterface>;
@@ -172,6 +225,8 @@ private:
   // to controllable things
   std::vector<std::weak_ptr<rclcpp_lifecycle::ManagedEntityInterface>> weak_managed_entities_;
   std::vector<std::weak_ptr<rclcpp::TimerBase>> weak_timers_;
+  // guarded by state_machine_mutex_
+  std::vector<std::weak_ptr<rclcpp::CallbackGroup>> weak_managed_callback_groups_;
 };
 
 }  // namespace rclcpp_lifecycle
@@ -19,17 +19,12 @@ namespace rclcpp_lifecycle
 
 void SimpleManagedEntity::on_activate()
 {
-  activated_.store(true);
+  activated_.store(true, std::memory_order_relaxed);
 }
 
 void SimpleManagedEntity::on_deactivate()
 {
-  activated_.store(false);
-}
-
-bool SimpleManagedEntity::is_activated() const
-{
-  return activated_.load();
+  activated_.store(false, std::memory_order_relaxed);
 }
 
 }  // namespace rclcpp_lifecycle
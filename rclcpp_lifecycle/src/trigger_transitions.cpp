@@ -0,0 +1,100 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp_lifecycle/trigger_transitions.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rclcpp_lifecycle
+{
+
+namespace
+{
+
+void
+trigger_transition_of_node(
+  LifecycleNode & node, uint8_t transition_id, TransitionResult & result)
+{
+  using CallbackReturn = node_interfaces::LifecycleNodeInterface::CallbackReturn;
+  // The return code isn't set if the transition isn't available from the current state.
+  result.callback_return_code = CallbackReturn::ERROR;
+  try {
+    result.state = node.trigger_transition(transition_id, result.callback_return_code);
+  } catch (const std::exception & exception) {
+    result.callback_return_code = CallbackReturn::ERROR;
+    result.state = node.get_current_state();
+    result.error_message = exception.what();
+  }
+  result.success = result.callback_return_code == CallbackReturn::SUCCESS;
+}
+
+}  // namespace
+
+std::vector<TransitionResult>
+trigger_transitions(
+  const std::vector<LifecycleNode::SharedPtr> & nodes,
+  uint8_t transition_id,
+  size_t number_of_threads)
+{
+  std::vector<TransitionResult> results(nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (!nodes[i]) {
+      throw std::invalid_argument("a node to transition is null");
+    }
+    results[i].node_name = nodes[i]->get_node_base_interface()->get_fully_qualified_name();
+  }
+
+  if (number_of_threads == 0) {
+    number_of_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  number_of_threads = std::min(number_of_threads, nodes.size());
+
+  std::atomic<size_t> next_index{0};
+  auto transition_nodes =
+    [&nodes, &results, &next_index, transition_id]() {
+      size_t index;
+      while ((index = next_index.fetch_add(1)) < nodes.size()) {
+        trigger_transition_of_node(*nodes[index], transition_id, results[index]);
+      }
+    };
+  if (number_of_threads <= 1) {
+    transition_nodes();
+    return results;
+  }
+  std::vector<std::thread> threads;
+  threads.reserve(number_of_threads);
+  for (size_t i = 0; i < number_of_threads; ++i) {
+    threads.emplace_back(transition_nodes);
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  return results;
+}
+
+bool
+all_succeeded(const std::vector<TransitionResult> & results)
+{
+  return std::all_of(
+    results.begin(), results.end(),
+    [](const TransitionResult & result) {return result.success;});
+}
+
+}  // namespace rclcpp_lifecycle
@@ -59,6 +59,43 @@ BENCHMARK_F(BenchmarkLifecycleNodeConstruction, construct_lifecycle_node)(
   }
 }
 
+BENCHMARK_F(
+  BenchmarkLifecycleNodeConstruction,
+  construct_lifecycle_node_without_communication_interface)(benchmark::State & state)
+{
+  for (auto _ : state) {
+    (void)_;
+    auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>(
+      "node", "ns", rclcpp::NodeOptions(), false);
+    PERFORMANCE_TEST_FIXTURE_PAUSE_MEASUREMENTS(
+      state,
+    {
+      node.reset();
+    });
+  }
+}
+
+BENCHMARK_F(BenchmarkLifecycleNodeConstruction, enable_communication_interface)(
+  benchmark::State & state)
+{
+  for (auto _ : state) {
+    (void)_;
+    std::shared_ptr<rclcpp_lifecycle::LifecycleNode> node(nullptr);
+    PERFORMANCE_TEST_FIXTURE_PAUSE_MEASUREMENTS(
+      state,
+    {
+      node = std::make_shared<rclcpp_lifecycle::LifecycleNode>(
+        "node", "ns", rclcpp::NodeOptions(), false);
+    });
+    node->enable_communication_interface();
+    PERFORMANCE_TEST_FIXTURE_PAUSE_MEASUREMENTS(
+      state,
+    {
+      node.reset();
+    });
+  }
+}
+
 BENCHMARK_F(BenchmarkLifecycleNodeConstruction, destroy_lifecycle_node)(benchmark::State & state) {
   for (auto _ : state) {
     (void)_;
@@ -18,6 +18,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 #include <utility>
 
@@ -28,6 +29,7 @@
 
 #include "rclcpp/rclcpp.hpp"
 #include "rclcpp_lifecycle/lifecycle_node.hpp"
+#include "rclcpp_lifecycle/trigger_transitions.hpp"
 
 #include "./mocking_utils/patch.hpp"
 
@@ -413,6 +415,85 @@ TEST_F(TestDefaultStateMachine, bad_mood) {
   EXPECT_EQ(1u, test_node->number_of_callbacks);
 }
 
+TEST_F(TestDefaultStateMachine, trigger_transitions) {
+  using CallbackReturn = rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn;
+  std::vector<rclcpp_lifecycle::LifecycleNode::SharedPtr> nodes;
+  for (size_t i = 0; i < 8u; ++i) {
+    nodes.push_back(
+      std::make_shared<MoodyLifecycleNode<GoodMood>>("testnode_" + std::to_string(i)));
+  }
+  auto bad_node = std::make_shared<MoodyLifecycleNode<BadMood>>("bad_testnode");
+  nodes.push_back(bad_node);
+
+  auto results = rclcpp_lifecycle::trigger_transitions(
+    nodes, Transition::TRANSITION_CONFIGURE, 4u);
+  ASSERT_EQ(nodes.size(), results.size());
+  EXPECT_FALSE(rclcpp_lifecycle::all_succeeded(results));
+  for (size_t i = 0; i + 1 < nodes.size(); ++i) {
+    EXPECT_EQ("/testnode_" + std::to_string(i), results[i].node_name);
+    EXPECT_TRUE(results[i].success);
+    EXPECT_EQ(CallbackReturn::SUCCESS, results[i].callback_return_code);
+    EXPECT_EQ(State::PRIMARY_STATE_INACTIVE, results[i].state.id());
+    EXPECT_EQ(State::PRIMARY_STATE_INACTIVE, nodes[i]->get_current_state().id());
+  }
+  EXPECT_EQ("/bad_testnode", results.back().node_name);
+  EXPECT_FALSE(results.back().success);
+  EXPECT_EQ(CallbackReturn::FAILURE, results.back().callback_return_code);
+  EXPECT_EQ(State::PRIMARY_STATE_UNCONFIGURED, results.back().state.id());
+
+  // The nodes which failed to configure can't be activated
+  nodes.pop_back();
+  results = rclcpp_lifecycle::trigger_transitions(nodes, Transition::TRANSITION_ACTIVATE);
+  EXPECT_TRUE(rclcpp_lifecycle::all_succeeded(results));
+  results = rclcpp_lifecycle::trigger_transitions({bad_node}, Transition::TRANSITION_ACTIVATE);
+  ASSERT_EQ(1u, results.size());
+  EXPECT_FALSE(results[0].success);
+  EXPECT_EQ(CallbackReturn::ERROR, results[0].callback_return_code);
+  EXPECT_EQ(State::PRIMARY_STATE_UNCONFIGURED, results[0].state.id());
+
+  EXPECT_TRUE(rclcpp_lifecycle::trigger_transitions({}, Transition::TRANSITION_ACTIVATE).empty());
+  EXPECT_THROW(
+    rclcpp_lifecycle::trigger_transitions({nullptr}, Transition::TRANSITION_ACTIVATE),
+    std::invalid_argument);
+}
+
+TEST_F(TestDefaultStateMachine, managed_callback_group) {
+  auto test_node = std::make_shared<EmptyLifecycleNode>("testnode");
+  auto group = test_node->create_managed_callback_group(
+    rclcpp::CallbackGroupType::MutuallyExclusive);
+  size_t timer_count = 0;
+  auto timer = test_node->create_wall_timer(
+    std::chrono::milliseconds(1), [&timer_count]() {++timer_count;}, group);
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(test_node->get_node_base_interface());
+  auto spin = [&executor]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      executor.spin_some();
+    };
+
+  EXPECT_FALSE(group->is_enabled());
+  spin();
+  EXPECT_EQ(0u, timer_count);
+
+  test_node->configure();
+  EXPECT_FALSE(group->is_enabled());
+  test_node->activate();
+  EXPECT_TRUE(group->is_enabled());
+  spin();
+  EXPECT_LT(0u, timer_count);
+
+  test_node->deactivate();
+  EXPECT_FALSE(group->is_enabled());
+  timer_count = 0;
+  spin();
+  EXPECT_EQ(0u, timer_count);
+
+  // The default callback group, with the lifecycle services, is never disabled
+  EXPECT_TRUE(test_node->get_node_base_interface()->get_default_callback_group()->is_enabled());
+  test_node->shutdown();
+  EXPECT_FALSE(group->is_enabled());
+}
+
 TEST_F(TestDefaultStateMachine, lifecycle_subscriber) {
   auto test_node = std::make_shared<MoodyLifecycleNode<GoodMood>>("testnode");
 
@@ -657,6 +738,28 @@ TEST_F(TestDefaultStateMachine, test_graph_topics) {
   EXPECT_EQ(0u, subscriptions_info.size());
 }
 
+TEST_F(TestDefaultStateMachine, enable_communication_interface) {
+  auto test_node = std::make_shared<rclcpp_lifecycle::LifecycleNode>(
+    "testnode", rclcpp::NodeOptions(), false);
+  auto services = test_node->get_service_names_and_types_by_node("testnode", "/");
+  EXPECT_EQ(services.end(), services.find("/testnode/change_state"));
+  EXPECT_EQ(0u, test_node->count_publishers("/testnode/transition_event"));
+
+  EXPECT_EQ(State::PRIMARY_STATE_INACTIVE, test_node->configure().id());
+  test_node->enable_communication_interface();
+  // The node stays in its state, and its transitions still work
+  EXPECT_EQ(State::PRIMARY_STATE_INACTIVE, test_node->get_current_state().id());
+  ASSERT_TRUE(wait_for_service(test_node, "/testnode/change_state"));
+  ASSERT_TRUE(wait_for_service(test_node, "/testnode/get_state"));
+  ASSERT_TRUE(wait_for_service(test_node, "/testnode/get_transition_graph"));
+  EXPECT_EQ(1u, test_node->count_publishers("/testnode/transition_event"));
+  EXPECT_EQ(State::PRIMARY_STATE_ACTIVE, test_node->activate().id());
+
+  EXPECT_NO_THROW(test_node->enable_communication_interface());
+  EXPECT_EQ(State::PRIMARY_STATE_ACTIVE, test_node->get_current_state().id());
+  EXPECT_EQ(1u, test_node->count_publishers("/testnode/transition_event"));
+}
+
 TEST_F(TestDefaultStateMachine, test_graph_services) {
   auto test_node = std::make_shared<EmptyLifecycleNode>("testnode");
 
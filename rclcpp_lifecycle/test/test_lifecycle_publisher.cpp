@@ -22,6 +22,9 @@
 #include "lifecycle_msgs/msg/transition.hpp"
 
 #include "test_msgs/msg/empty.hpp"
+#include "test_msgs/msg/strings.hpp"
+
+#include "rclcpp/type_adapter.hpp"
 
 #include "rclcpp_lifecycle/lifecycle_node.hpp"
 #include "rclcpp_lifecycle/lifecycle_publisher.hpp"
@@ -42,6 +45,35 @@ protected:
   }
 };
 
+static size_t number_of_conversions = 0;
+
+namespace rclcpp
+{
+
+template<>
+struct TypeAdapter<std::string, test_msgs::msg::Strings>
+{
+  using is_specialized = std::true_type;
+  using custom_type = std::string;
+  using ros_message_type = test_msgs::msg::Strings;
+
+  static void
+  convert_to_ros_message(const custom_type & source, ros_message_type & destination)
+  {
+    ++number_of_conversions;
+    destination.string_value = source;
+  }
+
+  static void
+  convert_to_custom(const ros_message_type & source, custom_type & destination)
+  {
+    ++number_of_conversions;
+    destination = source.string_value;
+  }
+};
+
+}  // namespace rclcpp
+
 /// We want to test everything for both the wall and generic timer.
 enum class TimerType
 {
@@ -168,6 +200,33 @@ TEST_P(TestLifecyclePublisher, publish) {
   }
 }
 
+TEST_P(TestLifecyclePublisher, publish_type_adapted) {
+  using StringTypeAdapter = rclcpp::TypeAdapter<std::string, test_msgs::msg::Strings>;
+  rclcpp::PublisherOptionsWithAllocator<std::allocator<void>> options;
+  auto publisher = std::make_shared<rclcpp_lifecycle::LifecyclePublisher<StringTypeAdapter>>(
+    node_->get_node_base_interface().get(), std::string("string_topic"), rclcpp::QoS(10),
+    options);
+  const std::string msg = "message";
+
+  // The messages are dropped without being converted while the publisher is inactive
+  number_of_conversions = 0;
+  EXPECT_FALSE(publisher->is_activated());
+  EXPECT_NO_THROW(publisher->publish(msg));
+  EXPECT_NO_THROW(publisher->publish(std::make_unique<std::string>(msg)));
+  EXPECT_EQ(0u, number_of_conversions);
+
+  publisher->on_activate();
+  EXPECT_NO_THROW(publisher->publish(msg));
+  EXPECT_NO_THROW(publisher->publish(std::make_unique<std::string>(msg)));
+  EXPECT_EQ(2u, number_of_conversions);
+
+  test_msgs::msg::Strings ros_msg;
+  ros_msg.string_value = msg;
+  EXPECT_NO_THROW(publisher->publish(ros_msg));
+  EXPECT_NO_THROW(publisher->publish(std::make_unique<test_msgs::msg::Strings>(ros_msg)));
+  EXPECT_EQ(2u, number_of_conversions);
+}
+
 INSTANTIATE_TEST_SUITE_P(
   PerTimerType, TestLifecyclePublisher,
   ::testing::Values(TimerType::WALL_TIMER, TimerType::GENERIC_TIMER),
@@ -19,6 +19,7 @@
 
 #include <gtest/gtest.h>
 #include <chrono>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -366,6 +367,35 @@ TEST_F(TestLifecycleServiceClient, lifecycle_transitions) {
   EXPECT_EQ(transitions.size(), 0u);
 }
 
+TEST_F(TestLifecycleServiceClient, async_transition_callback) {
+  using CompleteTransition = rclcpp_lifecycle::LifecycleNode::CompleteTransition;
+  std::promise<CompleteTransition> complete_promise;
+  auto complete_future = complete_promise.get_future();
+  lifecycle_node()->register_async_on_configure(
+    [&complete_promise](const rclcpp_lifecycle::State &, CompleteTransition complete) {
+      complete_promise.set_value(complete);
+    });
+
+  auto change_state_future = std::async(
+    std::launch::async, [this]() {
+      return lifecycle_client()->change_state(
+        lifecycle_msgs::msg::Transition::TRANSITION_CONFIGURE, 10s);
+    });
+  ASSERT_EQ(std::future_status::ready, complete_future.wait_for(10s));
+
+  // The node keeps handling requests while it's configuring
+  EXPECT_EQ(
+    lifecycle_client()->get_state().id, lifecycle_msgs::msg::State::TRANSITION_STATE_CONFIGURING);
+  EXPECT_EQ(std::future_status::timeout, change_state_future.wait_for(0s));
+
+  // The response is sent once the callback completes
+  complete_future.get()(
+    rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn::SUCCESS);
+  EXPECT_TRUE(change_state_future.get());
+  EXPECT_EQ(
+    lifecycle_client()->get_state().id, lifecycle_msgs::msg::State::PRIMARY_STATE_INACTIVE);
+}
+
 TEST_F(TestLifecycleServiceClient, get_service_names_and_types_by_node)
 {
   auto node1 = std::make_shared<LifecycleServiceClient>("client1");
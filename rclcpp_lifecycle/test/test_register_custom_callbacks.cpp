@@ -15,7 +15,9 @@
 
 #include <gtest/gtest.h>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <utility>
 
 #include "lifecycle_msgs/msg/state.hpp"
@@ -178,3 +180,52 @@ TEST_F(TestRegisterCustomCallbacks, custom_callbacks) {
   // check if all callbacks were successfully overwritten
   EXPECT_EQ(5u, test_node->number_of_callbacks);
 }
+
+TEST_F(TestRegisterCustomCallbacks, async_callbacks) {
+  using CallbackReturn = rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn;
+  using CompleteTransition = rclcpp_lifecycle::LifecycleNode::CompleteTransition;
+  auto test_node = std::make_shared<CustomLifecycleNode>("testnode");
+
+  // The transition methods wait for the callbacks completing in another thread
+  std::thread completing_thread;
+  test_node->register_async_on_configure(
+    [&test_node, &completing_thread](
+      const rclcpp_lifecycle::State & previous_state, CompleteTransition complete)
+    {
+      EXPECT_EQ(State::PRIMARY_STATE_UNCONFIGURED, previous_state.id());
+      completing_thread = std::thread(
+        [&test_node, complete]() {
+          EXPECT_EQ(State::TRANSITION_STATE_CONFIGURING, test_node->get_current_state().id());
+          complete(CallbackReturn::SUCCESS);
+          // Only the first completion counts
+          complete(CallbackReturn::FAILURE);
+        });
+    });
+  CallbackReturn cb_return_code = CallbackReturn::ERROR;
+  EXPECT_EQ(State::PRIMARY_STATE_INACTIVE, test_node->configure(cb_return_code).id());
+  EXPECT_EQ(CallbackReturn::SUCCESS, cb_return_code);
+  completing_thread.join();
+
+  // The callbacks can also complete right away, and fail
+  test_node->register_async_on_activate(
+    [](const rclcpp_lifecycle::State &, CompleteTransition complete) {
+      complete(CallbackReturn::FAILURE);
+    });
+  EXPECT_EQ(State::PRIMARY_STATE_INACTIVE, test_node->activate(cb_return_code).id());
+  EXPECT_EQ(CallbackReturn::FAILURE, cb_return_code);
+
+  // An exception is an error
+  test_node->register_async_on_activate(
+    [](const rclcpp_lifecycle::State &, CompleteTransition) {
+      throw std::runtime_error("activation failed");
+    });
+  test_node->register_async_on_error(
+    [](const rclcpp_lifecycle::State &, CompleteTransition complete) {
+      complete(CallbackReturn::SUCCESS);
+    });
+  EXPECT_EQ(State::PRIMARY_STATE_UNCONFIGURED, test_node->activate(cb_return_code).id());
+  EXPECT_EQ(CallbackReturn::ERROR, cb_return_code);
+
+  // The virtual callbacks of the node, which fail the test, were replaced
+  EXPECT_EQ(0u, test_node->number_of_callbacks);
+}
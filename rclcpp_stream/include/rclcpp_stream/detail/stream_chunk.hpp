@@ -0,0 +1,87 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP_STREAM__DETAIL__STREAM_CHUNK_HPP_
+#define RCLCPP_STREAM__DETAIL__STREAM_CHUNK_HPP_
+
+#include <cstddef>
+#include <string>
+
+#include "rclcpp/qos.hpp"
+#include "rmw/types.h"
+
+namespace rclcpp_stream
+{
+namespace detail
+{
+
+/// Return the topic the acknowledgments of the chunks of a topic are sent on.
+inline
+std::string
+get_stream_ack_topic_name(const std::string & topic_name)
+{
+  return topic_name + "/_stream_ack";
+}
+
+/// Return the QoS of the chunks, of which the flow control bounds the number in flight.
+inline
+rclcpp::QoS
+get_stream_qos()
+{
+  return rclcpp::QoS(rclcpp::KeepAll()).reliable();
+}
+
+/// Return the QoS of the publishers of the acknowledgments.
+/**
+ * The acknowledgments are cumulative, so only the last one is kept, and it's given to the
+ * subscriptions matched after it was published, so that it isn't lost while they aren't.
+ */
+inline
+rclcpp::QoS
+get_stream_ack_publisher_qos()
+{
+  return rclcpp::QoS(1).reliable().transient_local();
+}
+
+/// Return the QoS of the subscriptions to the acknowledgments.
+/**
+ * All of them are kept, as they are sent by several stream subscriptions.
+ */
+inline
+rclcpp::QoS
+get_stream_ack_subscription_qos()
+{
+  return rclcpp::QoS(rclcpp::KeepAll()).reliable().transient_local();
+}
+
+/// Return the id of an endpoint of a stream in the messages, from its gid.
+inline
+std::string
+get_stream_endpoint_id(const rmw_gid_t & gid)
+{
+  constexpr char digits[] = "0123456789abcdef";
+  std::string id;
+  id.reserve(2u * RMW_GID_STORAGE_SIZE);
+  for (size_t i = 0u; i < RMW_GID_STORAGE_SIZE; ++i) {
+    id.push_back(digits[gid.data[i] >> 4]);
+    id.push_back(digits[gid.data[i] & 0x0f]);
+  }
+  return id;
+}
+
+}  // namespace detail
+}  // namespace rclcpp_stream
+
+#endif  // RCLCPP_STREAM__DETAIL__STREAM_CHUNK_HPP_
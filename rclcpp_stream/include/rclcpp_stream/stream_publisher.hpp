@@ -0,0 +1,214 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP_STREAM__STREAM_PUBLISHER_HPP_
+#define RCLCPP_STREAM__STREAM_PUBLISHER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "rclcpp/create_publisher.hpp"
+#include "rclcpp/create_subscription.hpp"
+#include "rclcpp_stream/detail/stream_chunk.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/publisher.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/subscription_base.hpp"
+#include "rclcpp_stream/visibility_control.hpp"
+
+#include "rclcpp_stream_msgs/msg/stream_ack.hpp"
+#include "rclcpp_stream_msgs/msg/stream_chunk.hpp"
+
+namespace rclcpp_stream
+{
+
+/// Options of a StreamPublisher.
+struct StreamPublisherOptions
+{
+  /// Maximum size, in bytes, of the chunks the payloads are split into.
+  size_t chunk_size = 1024u * 1024u;
+
+  /// Maximum number of chunks sent and not yet acknowledged by every subscription.
+  size_t max_chunks_in_flight = 4u;
+};
+
+/// Publisher of large serialized payloads, sent as a stream of chunks with flow control.
+/**
+ * A payload is split into chunks which are read one at a time when they are sent, so that
+ * it doesn't have to be held in one contiguous buffer, and only a few of them are in flight
+ * at once, so that sending it doesn't saturate the transport.
+ * The subscriptions acknowledge the chunks they received, and the next chunks are sent
+ * from the callback of the acknowledgments, which don't block the caller of publish().
+ * The payloads are sent one after the other, each one once the slowest subscription
+ * acknowledged all its chunks.
+ *
+ * The subscriptions of the topic must be StreamSubscription, as the other ones don't
+ * acknowledge the chunks.
+ * The chunks are rclcpp_stream_msgs/msg/StreamChunk messages, and the acknowledgments
+ * rclcpp_stream_msgs/msg/StreamAck messages.
+ *
+ * Use create_stream_publisher() to create it.
+ */
+class StreamPublisher
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(StreamPublisher)
+
+  using ChunkMessage = rclcpp_stream_msgs::msg::StreamChunk;
+  using AckMessage = rclcpp_stream_msgs::msg::StreamAck;
+  using ChunkPublisher = rclcpp::Publisher<ChunkMessage, std::allocator<void>>;
+
+  /// Function copying the bytes of a payload from an offset into a chunk.
+  using ChunkReader = std::function<void (size_t offset, uint8_t * data, size_t size)>;
+
+  /// Construct a StreamPublisher object.
+  /**
+   * \param publisher publisher of the chunks, with the QoS of detail::get_stream_qos()
+   * \param options size of the chunks and flow control
+   * \throws std::invalid_argument if publisher is nullptr, or if the chunk size or the
+   *   maximum number of chunks in flight is 0
+   */
+  RCLCPP_STREAM_PUBLIC
+  StreamPublisher(
+    std::shared_ptr<ChunkPublisher> publisher,
+    const StreamPublisherOptions & options = StreamPublisherOptions());
+
+  RCLCPP_STREAM_PUBLIC
+  virtual ~StreamPublisher();
+
+  /// Set the subscription the acknowledgments are received with.
+  RCLCPP_STREAM_PUBLIC
+  void
+  set_ack_subscription(rclcpp::SubscriptionBase::SharedPtr ack_subscription);
+
+  /// Publish a serialized payload, which is held until all its chunks are sent.
+  /**
+   * \param message the payload, which must not be modified until then
+   * \throws std::invalid_argument if message is nullptr
+   */
+  RCLCPP_STREAM_PUBLIC
+  void
+  publish(std::shared_ptr<const rclcpp::SerializedMessage> message);
+
+  /// Publish a payload read by chunks.
+  /**
+   * The first chunks are read and sent before returning, and the next ones from the
+   * callback of the acknowledgments.
+   * If no subscription is matched, the payload is dropped.
+   *
+   * \param size size of the payload, in bytes
+   * \param reader function copying the bytes of the chunks, until they are all sent
+   * \throws std::invalid_argument if reader is empty
+   */
+  RCLCPP_STREAM_PUBLIC
+  void
+  publish(size_t size, ChunkReader reader);
+
+  /// Handle an acknowledgment of chunks, sending the next ones the flow control allows.
+  RCLCPP_STREAM_PUBLIC
+  void
+  handle_ack(const AckMessage & ack);
+
+  /// Get the number of payloads not yet received by every subscription.
+  RCLCPP_STREAM_PUBLIC
+  size_t
+  get_number_of_pending_streams() const;
+
+  /// Get the number of subscriptions the chunks are sent to.
+  RCLCPP_STREAM_PUBLIC
+  size_t
+  get_subscription_count() const;
+
+  /// Get the fully qualified name of the topic.
+  RCLCPP_STREAM_PUBLIC
+  const char *
+  get_topic_name() const;
+
+private:
+  struct Stream
+  {
+    int64_t id;
+    size_t size;
+    size_t number_of_chunks;
+    ChunkReader reader;
+    size_t next_chunk = 0u;
+  };
+
+  void
+  send_chunks();
+
+  size_t
+  get_slowest_received_chunks(size_t number_of_subscriptions) const;
+
+  void
+  publish_chunk(Stream & stream);
+
+  const std::shared_ptr<ChunkPublisher> publisher_;
+  const StreamPublisherOptions options_;
+  const std::string id_;
+  rclcpp::SubscriptionBase::SharedPtr ack_subscription_;
+  mutable std::mutex mutex_;
+  std::deque<Stream> streams_;
+  int64_t last_stream_id_ = 0;
+  // Number of chunks of the first stream received, by id of the stream subscriptions.
+  std::map<std::string, size_t> received_chunks_;
+};
+
+/// Create a StreamPublisher publishing payloads on a topic of a node.
+/**
+ * The acknowledgments are received while the returned object and the node live, and when
+ * the node is spun.
+ *
+ * \param[in] node node publishing the payloads
+ * \param[in] topic_name topic the chunks are published on
+ * \param[in] options size of the chunks and flow control
+ * \throws std::invalid_argument if the chunk size or the maximum number of chunks in
+ *   flight is 0
+ */
+template<typename NodeT>
+StreamPublisher::SharedPtr
+create_stream_publisher(
+  NodeT && node,
+  const std::string & topic_name,
+  const StreamPublisherOptions & options = StreamPublisherOptions())
+{
+  auto chunk_publisher = rclcpp::create_publisher<StreamPublisher::ChunkMessage>(
+    node, topic_name, rclcpp_stream::detail::get_stream_qos());
+  auto stream_publisher = std::make_shared<StreamPublisher>(chunk_publisher, options);
+
+  std::weak_ptr<StreamPublisher> weak_stream_publisher(stream_publisher);
+  auto ack_subscription = rclcpp::create_subscription<StreamPublisher::AckMessage>(
+    node, rclcpp_stream::detail::get_stream_ack_topic_name(chunk_publisher->get_topic_name()),
+    rclcpp_stream::detail::get_stream_ack_subscription_qos(),
+    [weak_stream_publisher](const StreamPublisher::AckMessage & ack) {
+      auto stream_publisher = weak_stream_publisher.lock();
+      if (stream_publisher) {
+        stream_publisher->handle_ack(ack);
+      }
+    });
+  stream_publisher->set_ack_subscription(ack_subscription);
+
+  return stream_publisher;
+}
+
+}  // namespace rclcpp_stream
+
+#endif  // RCLCPP_STREAM__STREAM_PUBLISHER_HPP_
@@ -0,0 +1,156 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCLCPP_STREAM__STREAM_SUBSCRIPTION_HPP_
+#define RCLCPP_STREAM__STREAM_SUBSCRIPTION_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "rclcpp/create_publisher.hpp"
+#include "rclcpp/create_subscription.hpp"
+#include "rclcpp_stream/detail/stream_chunk.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/publisher.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/subscription_base.hpp"
+#include "rclcpp_stream/visibility_control.hpp"
+
+#include "rclcpp_stream_msgs/msg/stream_ack.hpp"
+#include "rclcpp_stream_msgs/msg/stream_chunk.hpp"
+
+namespace rclcpp_stream
+{
+
+/// Subscription to the payloads of StreamPublisher, reassembled from their chunks.
+/**
+ * The buffer of a payload is allocated when its first chunk is received, and each chunk
+ * is copied into it, so that only one copy of the payload is held while it's received.
+ * Each chunk received is acknowledged to its publisher.
+ * A payload whose first chunks were missed, because the subscription was matched while it
+ * was sent, is skipped, and acknowledged as received so that it doesn't hold back its
+ * publisher.
+ *
+ * Use create_stream_subscription() to create it.
+ */
+class StreamSubscription
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(StreamSubscription)
+
+  using ChunkMessage = rclcpp_stream_msgs::msg::StreamChunk;
+  using AckMessage = rclcpp_stream_msgs::msg::StreamAck;
+  using AckPublisher = rclcpp::Publisher<AckMessage, std::allocator<void>>;
+  using CallbackT = std::function<void (std::shared_ptr<rclcpp::SerializedMessage>)>;
+
+  /// Construct a StreamSubscription object.
+  /**
+   * \param callback function called with each payload once all its chunks are received
+   * \throws std::invalid_argument if callback is empty
+   */
+  RCLCPP_STREAM_PUBLIC
+  explicit StreamSubscription(CallbackT callback);
+
+  RCLCPP_STREAM_PUBLIC
+  virtual ~StreamSubscription();
+
+  /// Set the subscription to the chunks, and the publisher of the acknowledgments.
+  /**
+   * The chunks received before are ignored.
+   *
+   * \throws std::invalid_argument if ack_publisher is nullptr
+   */
+  RCLCPP_STREAM_PUBLIC
+  void
+  set_entities(
+    rclcpp::SubscriptionBase::SharedPtr chunk_subscription,
+    std::shared_ptr<AckPublisher> ack_publisher);
+
+  /// Handle a chunk, calling the callback if it completes its payload.
+  RCLCPP_STREAM_PUBLIC
+  void
+  handle_chunk(const ChunkMessage & chunk);
+
+  /// Get the number of payloads being received, one at most for each publisher.
+  RCLCPP_STREAM_PUBLIC
+  size_t
+  get_number_of_partial_streams() const;
+
+private:
+  struct Reassembly
+  {
+    int64_t stream_id;
+    size_t next_chunk;
+    size_t number_of_chunks;
+    size_t payload_size;
+    std::shared_ptr<rclcpp::SerializedMessage> message;
+  };
+
+  void
+  acknowledge(const std::string & publisher_id, int64_t stream_id, size_t received_chunks);
+
+  const CallbackT callback_;
+  rclcpp::SubscriptionBase::SharedPtr chunk_subscription_;
+  std::shared_ptr<AckPublisher> ack_publisher_;
+  std::string id_;
+  mutable std::mutex mutex_;
+  // Payloads being received, by id of their publisher.
+  std::unordered_map<std::string, Reassembly> streams_;
+};
+
+/// Create a StreamSubscription receiving the payloads of a topic of a node.
+/**
+ * The payloads are received while the returned object and the node live, and when the
+ * node is spun.
+ *
+ * \param[in] node node subscribing to the payloads
+ * \param[in] topic_name topic the chunks are published on
+ * \param[in] callback function called with each payload once all its chunks are received
+ * \throws std::invalid_argument if callback is empty
+ */
+template<typename NodeT>
+StreamSubscription::SharedPtr
+create_stream_subscription(
+  NodeT && node,
+  const std::string & topic_name,
+  StreamSubscription::CallbackT callback)
+{
+  auto stream_subscription = std::make_shared<StreamSubscription>(std::move(callback));
+
+  std::weak_ptr<StreamSubscription> weak_stream_subscription(stream_subscription);
+  auto chunk_subscription = rclcpp::create_subscription<StreamSubscription::ChunkMessage>(
+    node, topic_name, rclcpp_stream::detail::get_stream_qos(),
+    [weak_stream_subscription](const StreamSubscription::ChunkMessage & chunk) {
+      auto stream_subscription = weak_stream_subscription.lock();
+      if (stream_subscription) {
+        stream_subscription->handle_chunk(chunk);
+      }
+    });
+  auto ack_publisher = rclcpp::create_publisher<StreamSubscription::AckMessage>(
+    node, rclcpp_stream::detail::get_stream_ack_topic_name(chunk_subscription->get_topic_name()),
+    rclcpp_stream::detail::get_stream_ack_publisher_qos());
+  stream_subscription->set_entities(chunk_subscription, ack_publisher);
+
+  return stream_subscription;
+}
+
+}  // namespace rclcpp_stream
+
+#endif  // RCLCPP_STREAM__STREAM_SUBSCRIPTION_HPP_
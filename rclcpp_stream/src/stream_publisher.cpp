@@ -0,0 +1,192 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp_stream/stream_publisher.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using rclcpp_stream::StreamPublisher;
+
+StreamPublisher::StreamPublisher(
+  std::shared_ptr<ChunkPublisher> publisher,
+  const StreamPublisherOptions & options)
+: publisher_(std::move(publisher)),
+  options_(options),
+  id_(publisher_ ? rclcpp_stream::detail::get_stream_endpoint_id(publisher_->get_gid()) : "")
+{
+  if (!publisher_) {
+    throw std::invalid_argument("publisher cannot be nullptr");
+  }
+  if (options_.chunk_size == 0u) {
+    throw std::invalid_argument("the chunk size of a stream must be greater than 0");
+  }
+  if (options_.max_chunks_in_flight == 0u) {
+    throw std::invalid_argument("the maximum number of chunks in flight must be greater than 0");
+  }
+}
+
+StreamPublisher::~StreamPublisher() {}
+
+void
+StreamPublisher::set_ack_subscription(rclcpp::SubscriptionBase::SharedPtr ack_subscription)
+{
+  ack_subscription_ = std::move(ack_subscription);
+}
+
+void
+StreamPublisher::publish(std::shared_ptr<const rclcpp::SerializedMessage> message)
+{
+  if (!message) {
+    throw std::invalid_argument("message cannot be nullptr");
+  }
+  const size_t size = message->size();
+  publish(
+    size,
+    [message = std::move(message)](size_t offset, uint8_t * data, size_t chunk_size) {
+      std::memcpy(data, message->get_rcl_serialized_message().buffer + offset, chunk_size);
+    });
+}
+
+void
+StreamPublisher::publish(size_t size, ChunkReader reader)
+{
+  if (!reader) {
+    throw std::invalid_argument("reader cannot be empty");
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (publisher_->get_subscription_count() == 0u) {
+    return;
+  }
+  Stream stream;
+  stream.id = ++last_stream_id_;
+  stream.size = size;
+  // An empty payload is still sent, as one empty chunk.
+  stream.number_of_chunks = std::max<size_t>(1u, size / options_.chunk_size +
+      (size % options_.chunk_size != 0u ? 1u : 0u));
+  stream.reader = std::move(reader);
+  streams_.push_back(std::move(stream));
+  if (streams_.size() == 1u) {
+    send_chunks();
+  }
+}
+
+void
+StreamPublisher::handle_ack(const AckMessage & ack)
+{
+  // The acknowledgments are received by all the stream publishers of the topic.
+  if (ack.publisher_id != id_ || ack.subscription_id.empty()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // The acknowledgments of the previous streams are late, and ignored.
+  if (streams_.empty() || streams_.front().id != ack.stream_id) {
+    return;
+  }
+  size_t & received_chunks = received_chunks_[ack.subscription_id];
+  received_chunks = std::max(received_chunks, static_cast<size_t>(ack.received_chunks));
+  send_chunks();
+}
+
+size_t
+StreamPublisher::get_number_of_pending_streams() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return streams_.size();
+}
+
+size_t
+StreamPublisher::get_subscription_count() const
+{
+  return publisher_->get_subscription_count();
+}
+
+const char *
+StreamPublisher::get_topic_name() const
+{
+  return publisher_->get_topic_name();
+}
+
+void
+StreamPublisher::send_chunks()
+{
+  while (!streams_.empty()) {
+    Stream & stream = streams_.front();
+    const size_t number_of_subscriptions = publisher_->get_subscription_count();
+    const size_t received_chunks = get_slowest_received_chunks(number_of_subscriptions);
+    if (number_of_subscriptions == 0u || received_chunks >= stream.number_of_chunks) {
+      // Every subscription received or skipped the stream, or none is left to send it to.
+      streams_.pop_front();
+      received_chunks_.clear();
+      continue;
+    }
+    const size_t end_of_window = std::min(
+      stream.number_of_chunks, received_chunks + options_.max_chunks_in_flight);
+    while (stream.next_chunk < end_of_window) {
+      publish_chunk(stream);
+    }
+    return;
+  }
+}
+
+size_t
+StreamPublisher::get_slowest_received_chunks(size_t number_of_subscriptions) const
+{
+  // The subscriptions which didn't acknowledge anything yet haven't received any chunk.
+  if (number_of_subscriptions == 0u || received_chunks_.size() < number_of_subscriptions) {
+    return 0u;
+  }
+  // Only the most advanced ones are counted, in case a subscription left meanwhile.
+  std::vector<size_t> received_chunks;
+  received_chunks.reserve(received_chunks_.size());
+  for (const auto & subscription_received_chunks : received_chunks_) {
+    received_chunks.push_back(subscription_received_chunks.second);
+  }
+  auto slowest = received_chunks.begin() + static_cast<std::ptrdiff_t>(
+    number_of_subscriptions - 1u);
+  std::nth_element(
+    received_chunks.begin(), slowest, received_chunks.end(), std::greater<size_t>());
+  return *slowest;
+}
+
+void
+StreamPublisher::publish_chunk(Stream & stream)
+{
+  const size_t offset = stream.next_chunk * options_.chunk_size;
+  const size_t size = std::min(options_.chunk_size, stream.size - offset);
+
+  auto chunk = std::make_unique<ChunkMessage>();
+  chunk->publisher_id = id_;
+  chunk->stream_id = stream.id;
+  chunk->index = stream.next_chunk;
+  chunk->number_of_chunks = stream.number_of_chunks;
+  chunk->offset = offset;
+  chunk->payload_size = stream.size;
+  chunk->data.resize(size);
+  if (size > 0u) {
+    stream.reader(offset, chunk->data.data(), size);
+  }
+  stream.next_chunk++;
+  publisher_->publish(std::move(chunk));
+}
@@ -0,0 +1,122 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "rclcpp_stream/stream_subscription.hpp"
+
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using rclcpp_stream::StreamSubscription;
+
+StreamSubscription::StreamSubscription(CallbackT callback)
+: callback_(std::move(callback))
+{
+  if (!callback_) {
+    throw std::invalid_argument("callback cannot be empty");
+  }
+}
+
+StreamSubscription::~StreamSubscription() {}
+
+void
+StreamSubscription::set_entities(
+  rclcpp::SubscriptionBase::SharedPtr chunk_subscription,
+  std::shared_ptr<AckPublisher> ack_publisher)
+{
+  if (!ack_publisher) {
+    throw std::invalid_argument("ack_publisher cannot be nullptr");
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  chunk_subscription_ = std::move(chunk_subscription);
+  id_ = rclcpp_stream::detail::get_stream_endpoint_id(ack_publisher->get_gid());
+  ack_publisher_ = std::move(ack_publisher);
+}
+
+void
+StreamSubscription::handle_chunk(const ChunkMessage & chunk)
+{
+  const int64_t stream_id = chunk.stream_id;
+  const auto index = static_cast<size_t>(chunk.index);
+  const auto number_of_chunks = static_cast<size_t>(chunk.number_of_chunks);
+  const auto offset = static_cast<size_t>(chunk.offset);
+  const auto payload_size = static_cast<size_t>(chunk.payload_size);
+  const size_t size = chunk.data.size();
+
+  std::shared_ptr<rclcpp::SerializedMessage> message;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!ack_publisher_) {
+      return;
+    }
+    auto it = streams_.find(chunk.publisher_id);
+    if (index == 0u && offset == 0u && size <= payload_size) {
+      // A new stream replaces the one of the same publisher which wasn't completed.
+      Reassembly reassembly{stream_id, 0u, number_of_chunks, payload_size,
+        std::make_shared<rclcpp::SerializedMessage>(payload_size)};
+      it = streams_.insert_or_assign(chunk.publisher_id, std::move(reassembly)).first;
+    }
+    if (it == streams_.end() || it->second.stream_id != stream_id ||
+      it->second.next_chunk != index || it->second.number_of_chunks != number_of_chunks ||
+      it->second.payload_size != payload_size || offset > payload_size ||
+      size > payload_size - offset)
+    {
+      // The beginning of the stream was missed: skip it.
+      if (it != streams_.end()) {
+        streams_.erase(it);
+      }
+      acknowledge(chunk.publisher_id, stream_id, number_of_chunks);
+      return;
+    }
+
+    Reassembly & reassembly = it->second;
+    auto & serialized_message = reassembly.message->get_rcl_serialized_message();
+    if (size > 0u) {
+      std::memcpy(serialized_message.buffer + offset, chunk.data.data(), size);
+    }
+    reassembly.next_chunk++;
+    acknowledge(chunk.publisher_id, stream_id, reassembly.next_chunk);
+    if (reassembly.next_chunk == reassembly.number_of_chunks) {
+      serialized_message.buffer_length = payload_size;
+      message = std::move(reassembly.message);
+      streams_.erase(it);
+    }
+  }
+  if (message) {
+    callback_(std::move(message));
+  }
+}
+
+size_t
+StreamSubscription::get_number_of_partial_streams() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return streams_.size();
+}
+
+void
+StreamSubscription::acknowledge(
+  const std::string & publisher_id, int64_t stream_id, size_t received_chunks)
+{
+  auto ack = std::make_unique<AckMessage>();
+  ack->publisher_id = publisher_id;
+  ack->subscription_id = id_;
+  ack->stream_id = stream_id;
+  ack->received_chunks = received_chunks;
+  ack_publisher_->publish(std::move(ack));
+}
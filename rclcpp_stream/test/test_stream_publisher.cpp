@@ -0,0 +1,138 @@
+// Copyright 2022 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp_stream/stream_publisher.hpp"
+#include "rclcpp_stream/stream_subscription.hpp"
+
+using namespace std::chrono_literals;
+
+class TestStreamPublisher : public ::testing::Test
+{
+public:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+
+protected:
+  void SetUp()
+  {
+    node = std::make_shared<rclcpp::Node>("test_stream_publisher", "/ns");
+    executor.add_node(node);
+  }
+
+  /// Spin until a condition holds, or a timeout.
+  template<typename ConditionT>
+  bool spin_until(ConditionT condition)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    while (!condition()) {
+      if (std::chrono::steady_clock::now() - start > 10s) {
+        return false;
+      }
+      executor.spin_some(10ms);
+    }
+    return true;
+  }
+
+  rclcpp::Node::SharedPtr node;
+  rclcpp::executors::SingleThreadedExecutor executor;
+};
+
+TEST_F(TestStreamPublisher, construction) {
+  auto chunk_publisher = node->create_publisher<rclcpp_stream::StreamPublisher::ChunkMessage>(
+    "stream", rclcpp_stream::detail::get_stream_qos());
+  EXPECT_THROW(rclcpp_stream::StreamPublisher(nullptr), std::invalid_argument);
+  rclcpp_stream::StreamPublisherOptions options;
+  options.chunk_size = 0u;
+  EXPECT_THROW(rclcpp_stream::StreamPublisher(chunk_publisher, options), std::invalid_argument);
+  options.chunk_size = 1u;
+  options.max_chunks_in_flight = 0u;
+  EXPECT_THROW(rclcpp_stream::StreamPublisher(chunk_publisher, options), std::invalid_argument);
+  EXPECT_THROW(rclcpp_stream::StreamSubscription(nullptr), std::invalid_argument);
+
+  // Nothing is sent without a subscription.
+  auto stream_publisher = rclcpp_stream::create_stream_publisher(node, "stream");
+  EXPECT_STREQ("/ns/stream", stream_publisher->get_topic_name());
+  stream_publisher->publish(10u, [](size_t, uint8_t *, size_t) {});
+  EXPECT_EQ(0u, stream_publisher->get_number_of_pending_streams());
+}
+
+TEST_F(TestStreamPublisher, publish_and_reassemble) {
+  std::vector<std::shared_ptr<rclcpp::SerializedMessage>> payloads;
+  auto stream_subscription = rclcpp_stream::create_stream_subscription(
+    node, "stream",
+    [&payloads](std::shared_ptr<rclcpp::SerializedMessage> payload) {
+      payloads.push_back(payload);
+    });
+  rclcpp_stream::StreamPublisherOptions options;
+  options.chunk_size = 1000u;
+  options.max_chunks_in_flight = 2u;
+  auto stream_publisher = rclcpp_stream::create_stream_publisher(node, "stream", options);
+  ASSERT_TRUE(spin_until([&]() {return stream_publisher->get_subscription_count() == 1u;}));
+
+  // A serialized message of 11 chunks, the last one partial.
+  constexpr size_t payload_size = 10500u;
+  auto message = std::make_shared<rclcpp::SerializedMessage>(payload_size);
+  auto & serialized_message = message->get_rcl_serialized_message();
+  for (size_t i = 0u; i < payload_size; ++i) {
+    serialized_message.buffer[i] = static_cast<uint8_t>(i % 251u);
+  }
+  serialized_message.buffer_length = payload_size;
+  stream_publisher->publish(message);
+  // A payload read by chunks, sent after the first one.
+  std::vector<size_t> read_offsets;
+  stream_publisher->publish(
+    2500u,
+    [&read_offsets](size_t offset, uint8_t * data, size_t size) {
+      read_offsets.push_back(offset);
+      std::memset(data, 7, size);
+    });
+  // An empty payload.
+  stream_publisher->publish(std::make_shared<rclcpp::SerializedMessage>());
+  EXPECT_EQ(3u, stream_publisher->get_number_of_pending_streams());
+
+  ASSERT_TRUE(
+    spin_until(
+      [&]() {
+        return payloads.size() == 3u && stream_publisher->get_number_of_pending_streams() == 0u;
+      }));
+  EXPECT_EQ(0u, stream_subscription->get_number_of_partial_streams());
+
+  ASSERT_EQ(payload_size, payloads[0]->size());
+  EXPECT_EQ(
+    0, std::memcmp(payloads[0]->get_rcl_serialized_message().buffer,
+    serialized_message.buffer, payload_size));
+  ASSERT_EQ(2500u, payloads[1]->size());
+  EXPECT_EQ(7u, payloads[1]->get_rcl_serialized_message().buffer[2499]);
+  EXPECT_EQ((std::vector<size_t>{0u, 1000u, 2000u}), read_offsets);
+  EXPECT_EQ(0u, payloads[2]->size());
+}